@@ -12,22 +12,37 @@
 #include "base/message_loop/message_loop.h"
 #include "base/stl_util.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/navigation_entry.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/site_instance.h"
+#include "content/public/browser/storage_partition.h"
 #include "net/base/net_util.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "xwalk/application/browser/application_process_manager.h"
 #include "xwalk/application/browser/application_service.h"
 #include "xwalk/application/browser/application_system.h"
 #include "xwalk/application/common/application_storage.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 #include "xwalk/application/common/constants.h"
+#include "xwalk/application/common/manifest_handlers/prefetch_handler.h"
 #include "xwalk/application/common/manifest_handlers/warp_handler.h"
 #include "xwalk/runtime/browser/runtime.h"
+#include "xwalk/runtime/browser/runtime_cache_warmer.h"
 #include "xwalk/runtime/browser/runtime_context.h"
+#include "xwalk/runtime/browser/runtime_network_predictor.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
 
+#if !defined(DISABLE_NACL) && defined(OS_LINUX)
+#include "xwalk/application/common/manifest_handlers/nacl_handler.h"
+#include "xwalk/runtime/browser/nacl_host/nacl_warmup.h"
+#endif
+
 using content::RenderProcessHost;
 
 namespace xwalk {
@@ -43,6 +58,31 @@ const char* kDefaultWidgetEntryPage[] = {
 "index.xhtml",
 "index.xht"};
 
+// The urls to prefetch are fetched once the application had time to load
+// its start page, a couple at a time.
+const int kPrefetchDelaySeconds = 5;
+const size_t kMaxPrefetches = 2;
+
+// The extensions an application must ask for by name in its permissions.
+const char kExperimentalExtensionPrefix[] = "xwalk.experimental.";
+
+// A fresh entry, the site instance of the copied one belonged to the
+// process of the previous launch.
+content::NavigationEntry* CopyNavigationEntry(
+    const content::NavigationEntry& entry) {
+  content::NavigationEntry* copy = content::NavigationEntry::Create();
+  copy->SetURL(entry.GetURL());
+  copy->SetVirtualURL(entry.GetVirtualURL());
+  copy->SetReferrer(entry.GetReferrer());
+  copy->SetTitle(entry.GetTitle());
+  copy->SetPageState(entry.GetPageState());
+  copy->SetHasPostData(entry.GetHasPostData());
+  copy->SetOriginalRequestURL(entry.GetOriginalRequestURL());
+  copy->SetIsOverridingUserAgent(entry.GetIsOverridingUserAgent());
+  copy->SetTimestamp(entry.GetTimestamp());
+  return copy;
+}
+
 }  // namespace
 
 namespace application {
@@ -58,6 +98,9 @@ Application::Application(
       runtime_context_(runtime_context),
       observer_(observer),
       entry_point_used_(Default),
+      prefetch_pending_(false),
+      prefetched_(0),
+      prefetch_failed_(0),
       weak_factory_(this) {
   DCHECK(runtime_context_);
   DCHECK(data_.get());
@@ -83,14 +126,64 @@ bool Application::Launch(const LaunchParams& launch_params) {
   if (!url.is_valid())
     return false;
 
-  Runtime* runtime = Runtime::Create(
-      runtime_context_,
-      this, content::SiteInstance::CreateForURL(runtime_context_, url));
+  // Warms up the connections the start page is likely to need while its
+  // render process is being started.
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter(
+      content::BrowserContext::GetStoragePartitionForSite(
+          runtime_context_, url)->GetURLRequestContext());
+  runtime_context_->network_predictor()->PredictLaunch(
+      id(), request_context_getter);
+
+  const PrefetchInfo* prefetch_info = static_cast<PrefetchInfo*>(
+      data_->GetManifestData(keys::kXWalkPrefetchKey));
+  if (prefetch_info && !prefetch_info->urls().empty()) {
+    prefetch_pending_ = true;
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&Application::StartPrefetch, GetWeakPtr(),
+                   request_context_getter),
+        base::TimeDelta::FromSeconds(kPrefetchDelaySeconds));
+  }
+
+#if !defined(DISABLE_NACL) && defined(OS_LINUX)
+  const NaClInfo* nacl_info = static_cast<NaClInfo*>(
+      data_->GetManifestData(keys::kXWalkNaClKey));
+  if (nacl_info)
+    WarmUpNaCl(nacl_info->is_portable());
+#endif
+
+  scoped_refptr<content::SiteInstance> site_instance;
+  site_instance.swap(spare_site_instance_);
+  if (site_instance && site_instance->GetSiteURL() !=
+      content::SiteInstance::GetSiteForURL(runtime_context_, url)) {
+    // Nothing is hosted by the spare process yet, this shuts it down.
+    site_instance->GetProcess()->Cleanup();
+    site_instance = NULL;
+  }
+  if (!site_instance)
+    site_instance = content::SiteInstance::CreateForURL(runtime_context_, url);
+
+  Runtime* runtime = Runtime::Create(runtime_context_, this,
+                                     site_instance.get());
   render_process_host_ = runtime->GetRenderProcessHost();
   render_process_host_->AddObserver(this);
+  observer_->OnRenderProcessHostAttached(this);
   web_contents_ = runtime->web_contents();
   InitSecurityPolicy();
-  runtime->LoadURL(url);
+  if (saved_session_) {
+    for (size_t i = 0; i < saved_session_->entries.size(); ++i)
+      saved_session_->entries[i]->SetPageID(i);
+    content::NavigationController& controller =
+        web_contents_->GetController();
+    controller.Restore(
+        saved_session_->selected_entry,
+        content::NavigationController::RESTORE_LAST_SESSION_EXITED_CLEANLY,
+        &saved_session_->entries.get());
+    controller.LoadIfNecessary();
+    saved_session_.reset();
+  } else {
+    runtime->LoadURL(url);
+  }
 
   NativeAppWindow::CreateParams params;
   params.net_wm_pid = launch_params.launcher_pid;
@@ -213,6 +306,32 @@ GURL Application::GetAbsoluteURLFromKey(const std::string& key) {
   return GURL(source);
 }
 
+void Application::set_saved_session(scoped_ptr<ApplicationSession> session) {
+  saved_session_ = session.Pass();
+}
+
+scoped_ptr<ApplicationSession> Application::SaveSession() const {
+  scoped_ptr<ApplicationSession> session;
+  // |web_contents_| is only valid while its page is open.
+  for (std::set<Runtime*>::const_iterator it = runtimes_.begin();
+       it != runtimes_.end(); ++it) {
+    if ((*it)->web_contents() != web_contents_)
+      continue;
+    const content::NavigationController& controller =
+        web_contents_->GetController();
+    if (controller.GetLastCommittedEntryIndex() < 0)
+      break;
+    session.reset(new ApplicationSession);
+    for (int i = 0; i < controller.GetEntryCount(); ++i) {
+      session->entries.push_back(
+          CopyNavigationEntry(*controller.GetEntryAtIndex(i)));
+    }
+    session->selected_entry = controller.GetLastCommittedEntryIndex();
+    break;
+  }
+  return session.Pass();
+}
+
 void Application::Terminate() {
   std::set<Runtime*> to_be_closed(runtimes_);
   std::for_each(to_be_closed.begin(), to_be_closed.end(),
@@ -255,6 +374,7 @@ void Application::RenderProcessExited(RenderProcessHost* host,
 
 void Application::RenderProcessHostDestroyed(RenderProcessHost* host) {
   DCHECK(render_process_host_ == host);
+  observer_->OnRenderProcessHostDetached(this);
   render_process_host_ = NULL;
   web_contents_ = NULL;
 }
@@ -265,8 +385,13 @@ void Application::NotifyTermination() {
 }
 
 bool Application::UseExtension(const std::string& extension_name) const {
-  // TODO(Bai): Tells whether the application contains the specified extension
-  return true;
+  // The applications not declaring their permissions keep using every
+  // extension, as before permissions existed.
+  if (!data_->GetManifest()->HasKey(keys::kPermissionsKey))
+    return true;
+  if (!StartsWithASCII(extension_name, kExperimentalExtensionPrefix, true))
+    return true;
+  return ContainsKey(data_->GetManifestPermissions(), extension_name);
 }
 
 bool Application::RegisterPermissions(const std::string& extension_name,
@@ -311,6 +436,7 @@ bool Application::RegisterPermissions(const std::string& extension_name,
     }
   }
 
+  InvalidatePermissionCache();
   return true;
 }
 
@@ -345,15 +471,86 @@ bool Application::SetPermission(PermissionType type,
                                 StoredPermission perm) {
   if (type == SESSION_PERMISSION) {
     permission_map_[permission_name] = perm;
+    InvalidatePermissionCache();
+    return true;
+  }
+  if (type == PERSISTENT_PERMISSION) {
+    if (!data_->SetPermission(permission_name, perm))
+      return false;
+    InvalidatePermissionCache();
     return true;
   }
-  if (type == PERSISTENT_PERMISSION)
-    return data_->SetPermission(permission_name, perm);
 
   NOTREACHED();
   return false;
 }
 
+RuntimePermission Application::GetRuntimePermission(
+    const std::string& extension_name,
+    const std::string& api_name) {
+  const RuntimePermissionCache::key_type key(extension_name, api_name);
+  RuntimePermissionCache::const_iterator iter =
+      runtime_permission_cache_.find(key);
+  if (iter != runtime_permission_cache_.end())
+    return iter->second;
+
+  RuntimePermission perm = EvaluateRuntimePermission(extension_name, api_name);
+  // Undefined decisions may be resolved by a later registration or prompt.
+  if (perm != UNDEFINED_RUNTIME_PERM)
+    runtime_permission_cache_[key] = perm;
+  return perm;
+}
+
+RuntimePermission Application::EvaluateRuntimePermission(
+    const std::string& extension_name,
+    const std::string& api_name) const {
+  // Permission name should have been registered at extension initialization.
+  std::string permission_name =
+      GetRegisteredPermissionName(extension_name, api_name);
+  if (permission_name.empty()) {
+    LOG(ERROR) << "API: " << api_name << " of extension: "
+      << extension_name << " not registered!";
+    return UNDEFINED_RUNTIME_PERM;
+  }
+  // Okay, since we have the permission name, let's get down to the policies.
+  // First, find out whether the permission is stored for the current session.
+  StoredPermission perm = GetPermission(SESSION_PERMISSION, permission_name);
+  if (perm != UNDEFINED_STORED_PERM) {
+    // "PROMPT" should not be in the session storage.
+    DCHECK(perm != PROMPT);
+    if (perm == ALLOW)
+      return ALLOW_SESSION;
+    if (perm == DENY)
+      return DENY_SESSION;
+    NOTREACHED();
+  }
+  // Then, query the persistent policy storage.
+  perm = GetPermission(PERSISTENT_PERMISSION, permission_name);
+  // Permission not found in persistent permission table, normally this should
+  // not happen because all the permission needed by the application should be
+  // contained in its manifest, so it also means that the application is asking
+  // for something wasn't allowed.
+  if (perm == UNDEFINED_STORED_PERM)
+    return UNDEFINED_RUNTIME_PERM;
+  if (perm == PROMPT) {
+    // TODO(Bai): We needed to pop-up a dialog asking user to chose one from
+    // either allow/deny for session/one shot/forever. Then, we need to update
+    // the session and persistent policy accordingly.
+    return UNDEFINED_RUNTIME_PERM;
+  }
+  if (perm == ALLOW)
+    return ALLOW_ALWAYS;
+  if (perm == DENY)
+    return DENY_ALWAYS;
+  NOTREACHED();
+  return UNDEFINED_RUNTIME_PERM;
+}
+
+void Application::InvalidatePermissionCache() {
+  runtime_permission_cache_.clear();
+  observer_->OnPermissionsChanged(this);
+}
+
 void Application::InitSecurityPolicy() {
   // CSP policy takes precedence over WARP.
   if (data_->HasCSPDefined())
@@ -361,8 +558,10 @@ void Application::InitSecurityPolicy() {
   else if (data_->GetPackageType() == Package::WGT)
     security_policy_.reset(new SecurityPolicyWARP(this));
 
-  if (security_policy_)
+  if (security_policy_) {
     security_policy_->Enforce();
+    security_policy_->Register();
+  }
 }
 
 bool Application::CanRequestURL(const GURL& url) const {
@@ -371,6 +570,35 @@ bool Application::CanRequestURL(const GURL& url) const {
   return true;
 }
 
+void Application::WaitForPrefetch(const PrefetchCallback& callback) {
+  if (prefetch_pending_)
+    prefetch_callbacks_.push_back(callback);
+  else
+    callback.Run(prefetched_, prefetch_failed_);
+}
+
+void Application::StartPrefetch(
+    const scoped_refptr<net::URLRequestContextGetter>& getter) {
+  const PrefetchInfo* prefetch_info = static_cast<PrefetchInfo*>(
+      data_->GetManifestData(keys::kXWalkPrefetchKey));
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&RuntimeCacheWarmer::Start, getter, prefetch_info->urls(),
+                 kMaxPrefetches,
+                 base::Bind(&Application::OnPrefetchComplete, GetWeakPtr())));
+}
+
+void Application::OnPrefetchComplete(int fetched, int failed) {
+  prefetch_pending_ = false;
+  prefetched_ = fetched;
+  prefetch_failed_ = failed;
+
+  std::vector<PrefetchCallback> callbacks;
+  callbacks.swap(prefetch_callbacks_);
+  for (size_t i = 0; i < callbacks.size(); ++i)
+    callbacks[i].Run(fetched, failed);
+}
+
 base::FilePath Application::GetSplashScreenPath() {
   return base::FilePath();
 }
@@ -8,6 +8,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/callback.h"
@@ -17,6 +18,7 @@
 #include "base/memory/scoped_vector.h"
 #include "base/observer_list.h"
 #include "content/public/browser/render_process_host_observer.h"
+#include "content/public/browser/site_instance.h"
 #include "ui/base/ui_base_types.h"
 #include "xwalk/application/common/application_data.h"
 #include "xwalk/application/common/security_policy.h"
@@ -27,6 +29,10 @@ namespace content {
   class RenderProcessHost;
 }
 
+namespace net {
+  class URLRequestContextGetter;
+}
+
 namespace xwalk {
 
 class RuntimeContext;
@@ -34,6 +40,7 @@ class RuntimeContext;
 namespace application {
 
 class ApplicationHost;
+struct ApplicationSession;
 class Manifest;
 class SecurityPolicy;
 
@@ -53,6 +60,13 @@ class Application : public Runtime::Observer,
     // Invoked when application is terminated - all its pages (runtimes)
     // are closed.
     virtual void OnApplicationTerminated(Application* app) {}
+    // Invoked when the application gets its render process, before loading
+    // its start page, and when the render process host is destroyed.
+    virtual void OnRenderProcessHostAttached(Application* app) {}
+    virtual void OnRenderProcessHostDetached(Application* app) {}
+    // Invoked when the session or persistent permissions of the application
+    // are written, or an extension registers its permissions.
+    virtual void OnPermissionsChanged(Application* app) {}
 
    protected:
     virtual ~Observer() {}
@@ -104,7 +118,9 @@ class Application : public Runtime::Observer,
   const ApplicationData* data() const { return data_; }
   ApplicationData* data() { return data_; }
 
-  // Tells whether the application use the specified extension.
+  // Tells whether the application use the specified extension. The
+  // experimental extensions are only used by the applications listing their
+  // name in the "permissions" of their manifest, other extensions by all.
   bool UseExtension(const std::string& extension_name) const;
 
   // The runtime permission mapping is registered by extension which
@@ -122,8 +138,24 @@ class Application : public Runtime::Observer,
   bool SetPermission(PermissionType type,
                      const std::string& permission_name,
                      StoredPermission perm);
+  // Looks up the permission registered for |api_name| in the session, then
+  // in the persistent permissions. Session and persistent decisions are
+  // cached until the permissions change.
+  RuntimePermission GetRuntimePermission(const std::string& extension_name,
+                                         const std::string& api_name);
   bool CanRequestURL(const GURL& url) const;
 
+  // Run with how many of the "xwalk_prefetch" urls of the manifest made it
+  // to the HTTP cache, and how many failed to.
+  typedef base::Callback<void(int fetched, int failed)> PrefetchCallback;
+  // Runs |callback| once the prefetch started after the launch is over, or
+  // right away if there is nothing to prefetch or it is over already.
+  void WaitForPrefetch(const PrefetchCallback& callback);
+
+  // Copies the navigation history of the main page, to be restored by a
+  // later launch. NULL if nothing was committed.
+  scoped_ptr<ApplicationSession> SaveSession() const;
+
  protected:
   // We enforce ApplicationService ownership.
   friend class ApplicationService;
@@ -133,6 +165,16 @@ class Application : public Runtime::Observer,
   virtual bool Launch(const LaunchParams& launch_params);
   virtual void InitSecurityPolicy();
 
+  // A site instance whose render process was started before the launch, used
+  // by Launch() if the start page belongs to its site.
+  void set_spare_site_instance(
+      const scoped_refptr<content::SiteInstance>& site_instance) {
+    spare_site_instance_ = site_instance;
+  }
+
+  // Restored by Launch() instead of loading the start page.
+  void set_saved_session(scoped_ptr<ApplicationSession> session);
+
   // Get the path of splash screen image. Return empty path by default.
   // Sub class can override it to return a specific path.
   virtual base::FilePath GetSplashScreenPath();
@@ -171,6 +213,15 @@ class Application : public Runtime::Observer,
 
   void NotifyTermination();
 
+  void StartPrefetch(
+      const scoped_refptr<net::URLRequestContextGetter>& getter);
+  void OnPrefetchComplete(int fetched, int failed);
+
+  RuntimePermission EvaluateRuntimePermission(
+      const std::string& extension_name,
+      const std::string& api_name) const;
+  void InvalidatePermissionCache();
+
   RuntimeContext* runtime_context_;
   Observer* observer_;
   // The entry point used as part of Launch().
@@ -178,8 +229,18 @@ class Application : public Runtime::Observer,
   std::map<std::string, std::string> name_perm_map_;
   // Application's session permissions.
   StoredPermissionMap permission_map_;
+  // The decisions of GetRuntimePermission(), keyed by extension and API name.
+  typedef std::map<std::pair<std::string, std::string>, RuntimePermission>
+      RuntimePermissionCache;
+  RuntimePermissionCache runtime_permission_cache_;
   // Security policy.
   scoped_ptr<SecurityPolicy> security_policy_;
+  scoped_refptr<content::SiteInstance> spare_site_instance_;
+  scoped_ptr<ApplicationSession> saved_session_;
+  bool prefetch_pending_;
+  int prefetched_;
+  int prefetch_failed_;
+  std::vector<PrefetchCallback> prefetch_callbacks_;
   // WeakPtrFactory should be always declared the last.
   base::WeakPtrFactory<Application> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(Application);
@@ -0,0 +1,214 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/browser/application_memory_monitor.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_runner_util.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+#include "xwalk/application/browser/application.h"
+#include "xwalk/extensions/browser/xwalk_extension_service.h"
+#include "xwalk/runtime/browser/xwalk_runner.h"
+
+using content::BrowserThread;
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+// Reading the smaps of a big process takes a few milliseconds, sampling
+// more often would cost more than it tells.
+const int kSamplingIntervalSeconds = 30;
+
+base::DictionaryValue* ProcessMemoryUsageToValue(
+    const ProcessMemoryUsage& usage) {
+  base::DictionaryValue* value = new base::DictionaryValue;
+  value->SetDouble("pss", usage.pss);
+  value->SetDouble("uss", usage.uss);
+  return value;
+}
+
+void AddProcessMemoryUsage(const ProcessMemoryUsage& usage,
+                           ProcessMemoryUsage* total) {
+  total->pss += usage.pss;
+  total->uss += usage.uss;
+}
+
+}  // namespace
+
+ProcessMemoryUsage::ProcessMemoryUsage()
+    : pss(0),
+      uss(0) {
+}
+
+ApplicationMemoryUsage::ApplicationMemoryUsage() {
+}
+
+scoped_ptr<base::DictionaryValue> ApplicationMemoryUsage::ToValue() const {
+  scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue);
+  value->Set("renderer", ProcessMemoryUsageToValue(renderer));
+  value->Set("extensionProcess", ProcessMemoryUsageToValue(extension_process));
+  value->Set("total", ProcessMemoryUsageToValue(total));
+  value->SetDouble("ageMs",
+                   (base::TimeTicks::Now() - sample_time).InMillisecondsF());
+  return value.Pass();
+}
+
+ApplicationMemoryMonitor::ApplicationMemoryMonitor(
+    ApplicationService* service)
+    : service_(service),
+      sampling_(false),
+      weak_factory_(this) {
+  service_->AddObserver(this);
+}
+
+ApplicationMemoryMonitor::~ApplicationMemoryMonitor() {
+  service_->RemoveObserver(this);
+}
+
+void ApplicationMemoryMonitor::AddObserver(Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void ApplicationMemoryMonitor::RemoveObserver(Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
+bool ApplicationMemoryMonitor::GetMemoryUsage(
+    const std::string& app_id, ApplicationMemoryUsage* usage) const {
+  UsageMap::const_iterator it = usage_.find(app_id);
+  if (it == usage_.end())
+    return false;
+  *usage = it->second;
+  return true;
+}
+
+void ApplicationMemoryMonitor::SampleNow() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (sampling_)
+    return;
+
+  extensions::XWalkExtensionService* extension_service =
+      XWalkRunner::GetInstance()->extension_service();
+  TargetVector targets;
+  const ScopedVector<Application>& apps = service_->active_applications();
+  for (size_t i = 0; i < apps.size(); ++i) {
+    content::RenderProcessHost* host = apps[i]->render_process_host();
+    if (!host || !host->GetHandle())
+      continue;
+
+    Target target;
+    target.app_id = apps[i]->id();
+    target.renderer = base::GetProcId(host->GetHandle());
+    target.extension_process = base::kNullProcessId;
+    base::ProcessHandle extension_process =
+        extension_service->GetExtensionProcessHandle(host->GetID());
+    if (extension_process != base::kNullProcessHandle)
+      target.extension_process = base::GetProcId(extension_process);
+    targets.push_back(target);
+  }
+  if (targets.empty())
+    return;
+
+  sampling_ = true;
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetBlockingPool(), FROM_HERE,
+      base::Bind(&ApplicationMemoryMonitor::SampleTargets, targets),
+      base::Bind(&ApplicationMemoryMonitor::OnSampled,
+                 weak_factory_.GetWeakPtr()));
+}
+
+// static
+bool ApplicationMemoryMonitor::GetProcessMemoryUsage(
+    base::ProcessId pid, ProcessMemoryUsage* usage) {
+#if defined(OS_LINUX)
+  std::string smaps;
+  if (!base::ReadFileToString(
+          base::FilePath(base::StringPrintf("/proc/%d/smaps", pid)), &smaps))
+    return false;
+
+  // Sums the "Pss:", "Private_Clean:" and "Private_Dirty:" lines of all the
+  // mappings, e.g. "Pss:                 12 kB".
+  *usage = ProcessMemoryUsage();
+  std::vector<std::string> lines;
+  base::SplitString(smaps, '\n', &lines);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    int64* counter = NULL;
+    if (StartsWithASCII(lines[i], "Pss:", true))
+      counter = &usage->pss;
+    else if (StartsWithASCII(lines[i], "Private_", true))
+      counter = &usage->uss;
+    else
+      continue;
+
+    std::vector<std::string> fields;
+    base::SplitStringAlongWhitespace(lines[i], &fields);
+    int64 kb;
+    if (fields.size() >= 2 && base::StringToInt64(fields[1], &kb))
+      *counter += kb;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void ApplicationMemoryMonitor::DidLaunchApplication(Application* app) {
+  if (timer_.IsRunning())
+    return;
+  timer_.Start(FROM_HERE,
+               base::TimeDelta::FromSeconds(kSamplingIntervalSeconds),
+               this, &ApplicationMemoryMonitor::SampleNow);
+}
+
+void ApplicationMemoryMonitor::WillDestroyApplication(Application* app) {
+  usage_.erase(app->id());
+  // |app| is still in the active applications.
+  if (service_->active_applications().size() <= 1)
+    timer_.Stop();
+}
+
+// static
+scoped_ptr<ApplicationMemoryMonitor::UsageMap>
+ApplicationMemoryMonitor::SampleTargets(const TargetVector& targets) {
+  scoped_ptr<UsageMap> samples(new UsageMap);
+  for (size_t i = 0; i < targets.size(); ++i) {
+    ApplicationMemoryUsage usage;
+    if (!GetProcessMemoryUsage(targets[i].renderer, &usage.renderer))
+      continue;
+    if (targets[i].extension_process != base::kNullProcessId)
+      GetProcessMemoryUsage(targets[i].extension_process,
+                            &usage.extension_process);
+    AddProcessMemoryUsage(usage.renderer, &usage.total);
+    AddProcessMemoryUsage(usage.extension_process, &usage.total);
+    usage.sample_time = base::TimeTicks::Now();
+    (*samples)[targets[i].app_id] = usage;
+  }
+  return samples.Pass();
+}
+
+void ApplicationMemoryMonitor::OnSampled(scoped_ptr<UsageMap> samples) {
+  sampling_ = false;
+  for (UsageMap::const_iterator it = samples->begin();
+       it != samples->end(); ++it) {
+    // The application may have been terminated in the meantime.
+    Application* app = service_->GetApplicationByID(it->first);
+    if (!app)
+      continue;
+    usage_[it->first] = it->second;
+    FOR_EACH_OBSERVER(Observer, observers_,
+                      OnMemoryUsageSampled(app, it->second));
+  }
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,125 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_BROWSER_APPLICATION_MEMORY_MONITOR_H_
+#define XWALK_APPLICATION_BROWSER_APPLICATION_MEMORY_MONITOR_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/observer_list.h"
+#include "base/process/process_handle.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "xwalk/application/browser/application_service.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace xwalk {
+namespace application {
+
+class Application;
+
+// The memory of a process, in KB. The proportional set size counts the
+// pages shared with other processes divided by the number of processes
+// sharing them, the unique set size only the pages of this process alone.
+struct ProcessMemoryUsage {
+  ProcessMemoryUsage();
+
+  int64 pss;
+  int64 uss;
+};
+
+// The memory an application costs: its Render Process and the Extension
+// Process running its external extensions. The browser process is shared by
+// all the applications and isn't attributed to any.
+struct ApplicationMemoryUsage {
+  ApplicationMemoryUsage();
+
+  // e.g. {"renderer": {"pss": 51200, "uss": 40960},
+  //       "extensionProcess": {"pss": 4096, "uss": 2048},
+  //       "total": {"pss": 55296, "uss": 43008}, "ageMs": 1200}
+  scoped_ptr<base::DictionaryValue> ToValue() const;
+
+  ProcessMemoryUsage renderer;
+  ProcessMemoryUsage extension_process;
+  ProcessMemoryUsage total;
+  base::TimeTicks sample_time;
+};
+
+// Samples periodically the memory of the processes of each running
+// application, so per application budgets can be enforced on devices
+// running many applications. The samples are read through the
+// xwalk.app.runtime.getMemoryUsage() JS API and, in shared process mode,
+// the properties of the running application objects on D-Bus.
+//
+// The processes are measured on the blocking pool, everything else happens
+// on the UI thread. Only supported on Linux, where the kernel reports PSS
+// and USS.
+class ApplicationMemoryMonitor : public ApplicationService::Observer {
+ public:
+  class Observer {
+   public:
+    virtual void OnMemoryUsageSampled(Application* app,
+                                      const ApplicationMemoryUsage& usage) = 0;
+   protected:
+    virtual ~Observer() {}
+  };
+
+  explicit ApplicationMemoryMonitor(ApplicationService* service);
+  virtual ~ApplicationMemoryMonitor();
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+  // The last sample of |app_id|. Returns false if it wasn't sampled yet.
+  bool GetMemoryUsage(const std::string& app_id,
+                      ApplicationMemoryUsage* usage) const;
+
+  // Samples the running applications without waiting for the next period.
+  void SampleNow();
+
+  // Reads the memory of |pid|. Returns false if it is unknown, e.g. the
+  // process is gone. Blocks on file IO.
+  static bool GetProcessMemoryUsage(base::ProcessId pid,
+                                    ProcessMemoryUsage* usage);
+
+ private:
+  struct Target {
+    std::string app_id;
+    base::ProcessId renderer;
+    base::ProcessId extension_process;
+  };
+  typedef std::vector<Target> TargetVector;
+  typedef std::map<std::string, ApplicationMemoryUsage> UsageMap;
+
+  // ApplicationService::Observer implementation.
+  virtual void DidLaunchApplication(Application* app) OVERRIDE;
+  virtual void WillDestroyApplication(Application* app) OVERRIDE;
+
+  static scoped_ptr<UsageMap> SampleTargets(const TargetVector& targets);
+  void OnSampled(scoped_ptr<UsageMap> samples);
+
+  ApplicationService* service_;
+  base::RepeatingTimer<ApplicationMemoryMonitor> timer_;
+  // Samples are dropped while another one is in progress.
+  bool sampling_;
+  UsageMap usage_;
+  ObserverList<Observer> observers_;
+
+  base::WeakPtrFactory<ApplicationMemoryMonitor> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ApplicationMemoryMonitor);
+};
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_BROWSER_APPLICATION_MEMORY_MONITOR_H_
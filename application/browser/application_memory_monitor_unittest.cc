@@ -0,0 +1,52 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/browser/application_memory_monitor.h"
+
+#include "base/process/process_handle.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::application::ApplicationMemoryMonitor;
+using xwalk::application::ApplicationMemoryUsage;
+using xwalk::application::ProcessMemoryUsage;
+
+#if defined(OS_LINUX)
+TEST(ApplicationMemoryMonitorTest, MeasuresCurrentProcess) {
+  ProcessMemoryUsage usage;
+  ASSERT_TRUE(ApplicationMemoryMonitor::GetProcessMemoryUsage(
+      base::GetCurrentProcId(), &usage));
+  EXPECT_GT(usage.pss, 0);
+  EXPECT_GT(usage.uss, 0);
+  // The private pages are fully accounted in the proportional set size.
+  EXPECT_LE(usage.uss, usage.pss);
+}
+
+TEST(ApplicationMemoryMonitorTest, FailsForMissingProcess) {
+  ProcessMemoryUsage usage;
+  EXPECT_FALSE(ApplicationMemoryMonitor::GetProcessMemoryUsage(
+      base::kNullProcessId, &usage));
+}
+#endif
+
+TEST(ApplicationMemoryMonitorTest, UsageToValue) {
+  ApplicationMemoryUsage usage;
+  usage.renderer.pss = 300;
+  usage.renderer.uss = 200;
+  usage.total.pss = 300;
+  usage.total.uss = 200;
+  usage.sample_time = base::TimeTicks::Now();
+
+  scoped_ptr<base::DictionaryValue> value = usage.ToValue();
+  double kb;
+  EXPECT_TRUE(value->GetDouble("renderer.pss", &kb));
+  EXPECT_DOUBLE_EQ(300, kb);
+  EXPECT_TRUE(value->GetDouble("extensionProcess.uss", &kb));
+  EXPECT_DOUBLE_EQ(0, kb);
+  EXPECT_TRUE(value->GetDouble("total.uss", &kb));
+  EXPECT_DOUBLE_EQ(200, kb);
+  double age_ms;
+  EXPECT_TRUE(value->GetDouble("ageMs", &age_ms));
+  EXPECT_GE(age_ms, 0);
+}
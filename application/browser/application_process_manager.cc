@@ -0,0 +1,261 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/browser/application_process_manager.h"
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_source.h"
+#include "content/public/browser/notification_types.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_widget_host.h"
+#include "xwalk/application/browser/application.h"
+#include "xwalk/extensions/browser/xwalk_extension_service.h"
+#include "xwalk/runtime/browser/xwalk_runner.h"
+#include "xwalk/runtime/common/xwalk_common_messages.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
+
+using content::BrowserThread;
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+// How long a hibernated application may be shown again, and resumed as it
+// was, before being terminated.
+const int kEvictionDelaySeconds = 30;
+
+size_t GetProcessLimit(const char* switch_name) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switch_name))
+    return 0;
+  unsigned limit;
+  if (!base::StringToUint(command_line.GetSwitchValueASCII(switch_name),
+                          &limit)) {
+    LOG(WARNING) << "Invalid value of --" << switch_name;
+    return 0;
+  }
+  return limit;
+}
+
+}  // namespace
+
+ApplicationSession::ApplicationSession()
+    : selected_entry(-1) {
+}
+
+ApplicationSession::~ApplicationSession() {
+}
+
+ApplicationProcessManager::Candidate::Candidate()
+    : visible(false),
+      has_extension_process(false) {
+}
+
+ApplicationProcessManager::ApplicationProcessManager(
+    ApplicationService* service)
+    : service_(service),
+      max_render_processes_(GetProcessLimit(switches::kMaxRenderProcesses)),
+      max_extension_processes_(
+          GetProcessLimit(switches::kMaxExtensionProcesses)),
+      next_hibernation_id_(0),
+      weak_factory_(this) {
+  if (!max_render_processes_ && !max_extension_processes_)
+    return;
+  service_->AddObserver(this);
+  registrar_.Add(this, content::NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED,
+                 content::NotificationService::AllSources());
+}
+
+ApplicationProcessManager::~ApplicationProcessManager() {
+  if (max_render_processes_ || max_extension_processes_)
+    service_->RemoveObserver(this);
+}
+
+void ApplicationProcessManager::AddObserver(Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void ApplicationProcessManager::RemoveObserver(Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
+void ApplicationProcessManager::SaveSession(
+    const std::string& app_id, scoped_ptr<ApplicationSession> session) {
+  if (session)
+    saved_sessions_[app_id] = make_linked_ptr(session.release());
+  else
+    saved_sessions_.erase(app_id);
+}
+
+scoped_ptr<ApplicationSession> ApplicationProcessManager::TakeSavedSession(
+    const std::string& app_id) {
+  scoped_ptr<ApplicationSession> session;
+  SessionMap::iterator it = saved_sessions_.find(app_id);
+  if (it != saved_sessions_.end()) {
+    session.reset(it->second.release());
+    saved_sessions_.erase(it);
+  }
+  return session.Pass();
+}
+
+// static
+std::vector<std::string>
+ApplicationProcessManager::SelectApplicationsToHibernate(
+    const std::vector<Candidate>& candidates,
+    size_t max_render_processes,
+    size_t max_extension_processes) {
+  size_t render_processes = candidates.size();
+  size_t extension_processes = 0;
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (candidates[i].has_extension_process)
+      ++extension_processes;
+  }
+
+  std::vector<std::string> selected;
+  for (size_t i = candidates.size(); i > 1; --i) {
+    bool over_render_budget = max_render_processes &&
+        render_processes > max_render_processes;
+    bool over_extension_budget = max_extension_processes &&
+        extension_processes > max_extension_processes;
+    if (!over_render_budget && !over_extension_budget)
+      break;
+
+    const Candidate& candidate = candidates[i - 1];
+    if (candidate.visible)
+      continue;
+    // Over the Extension Process budget only, the applications without one
+    // are left running.
+    if (!over_render_budget && !candidate.has_extension_process)
+      continue;
+    selected.push_back(candidate.app_id);
+    --render_processes;
+    if (candidate.has_extension_process)
+      --extension_processes;
+  }
+  return selected;
+}
+
+void ApplicationProcessManager::DidLaunchApplication(Application* app) {
+  recently_visible_.remove(app->id());
+  recently_visible_.push_front(app->id());
+  EnforceBudget();
+}
+
+void ApplicationProcessManager::WillDestroyApplication(Application* app) {
+  recently_visible_.remove(app->id());
+  hibernated_.erase(app->id());
+}
+
+void ApplicationProcessManager::Observe(
+    int type,
+    const content::NotificationSource& source,
+    const content::NotificationDetails& details) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  DCHECK_EQ(content::NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED, type);
+  content::RenderProcessHost* host =
+      content::Source<content::RenderWidgetHost>(source)->GetProcess();
+  Application* app = service_->GetApplicationByRenderHostID(host->GetID());
+  if (!app)
+    return;
+
+  // It was visible until now when it is hidden, so it moves to the front in
+  // both cases.
+  recently_visible_.remove(app->id());
+  recently_visible_.push_front(app->id());
+  if (IsVisible(app)) {
+    if (hibernated_.count(app->id()))
+      Resume(app);
+    return;
+  }
+  EnforceBudget();
+}
+
+void ApplicationProcessManager::EnforceBudget() {
+  std::vector<Candidate> candidates;
+  for (std::list<std::string>::const_iterator it = recently_visible_.begin();
+       it != recently_visible_.end(); ++it) {
+    if (hibernated_.count(*it))
+      continue;
+    Application* app = service_->GetApplicationByID(*it);
+    if (!app || !app->render_process_host())
+      continue;
+    Candidate candidate;
+    candidate.app_id = *it;
+    candidate.visible = IsVisible(app);
+    candidate.has_extension_process = HasExtensionProcess(app);
+    candidates.push_back(candidate);
+  }
+
+  std::vector<std::string> selected = SelectApplicationsToHibernate(
+      candidates, max_render_processes_, max_extension_processes_);
+  for (size_t i = 0; i < selected.size(); ++i)
+    Hibernate(service_->GetApplicationByID(selected[i]));
+}
+
+void ApplicationProcessManager::Hibernate(Application* app) {
+  VLOG(1) << "Hibernating application " << app->id()
+          << " to stay within the process budget.";
+  app->render_process_host()->Send(new ViewMsg_SuspendJSEngine(true));
+  int hibernation_id = ++next_hibernation_id_;
+  hibernated_[app->id()] = hibernation_id;
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&ApplicationProcessManager::Evict,
+                 weak_factory_.GetWeakPtr(), app->id(), hibernation_id),
+      base::TimeDelta::FromSeconds(kEvictionDelaySeconds));
+  FOR_EACH_OBSERVER(Observer, observers_, OnApplicationHibernated(app));
+}
+
+void ApplicationProcessManager::Resume(Application* app) {
+  app->render_process_host()->Send(new ViewMsg_SuspendJSEngine(false));
+  hibernated_.erase(app->id());
+  FOR_EACH_OBSERVER(Observer, observers_, OnApplicationResumed(app));
+  // Counted again, another hidden application may have to make room.
+  EnforceBudget();
+}
+
+void ApplicationProcessManager::Evict(const std::string& app_id,
+                                      int hibernation_id) {
+  // Resumed, or terminated by itself, in the meantime.
+  HibernationMap::iterator it = hibernated_.find(app_id);
+  if (it == hibernated_.end() || it->second != hibernation_id)
+    return;
+  hibernated_.erase(it);
+  Application* app = service_->GetApplicationByID(app_id);
+  if (!app)
+    return;
+
+  VLOG(1) << "Terminating application " << app_id
+          << " to stay within the process budget.";
+  SaveSession(app_id, app->SaveSession());
+  FOR_EACH_OBSERVER(Observer, observers_, OnApplicationEvicted(app));
+  app->Terminate();
+}
+
+// static
+bool ApplicationProcessManager::IsVisible(Application* app) {
+  content::RenderProcessHost* host = app->render_process_host();
+  return host && host->VisibleWidgetCount() > 0;
+}
+
+// static
+bool ApplicationProcessManager::HasExtensionProcess(Application* app) {
+  content::RenderProcessHost* host = app->render_process_host();
+  if (!host)
+    return false;
+  return XWalkRunner::GetInstance()->extension_service()->
+      GetExtensionProcessHandle(host->GetID()) != base::kNullProcessHandle;
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,141 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_BROWSER_APPLICATION_PROCESS_MANAGER_H_
+#define XWALK_APPLICATION_BROWSER_APPLICATION_PROCESS_MANAGER_H_
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
+#include "base/observer_list.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
+#include "xwalk/application/browser/application_service.h"
+
+namespace content {
+class NavigationEntry;
+}
+
+namespace xwalk {
+namespace application {
+
+class Application;
+
+// The navigation history of the main page of an application, saved when it
+// is evicted and restored by its next launch.
+struct ApplicationSession {
+  ApplicationSession();
+  ~ApplicationSession();
+
+  ScopedVector<content::NavigationEntry> entries;
+  int selected_entry;
+};
+
+// Keeps the running applications within a process budget, set with
+// --max-render-processes and --max-extension-processes: each application
+// has its Render Process, and an Extension Process if it uses external
+// extensions. Once over budget, the application hidden for the longest time
+// is hibernated, see ViewMsg_SuspendJSEngine, then terminated a while later
+// unless it was shown meanwhile. Its navigation history is restored by its
+// next launch.
+//
+// The budget is a soft limit: a hibernated application stops being counted
+// right away, but keeps its processes until it is terminated, up to
+// kEvictionDelaySeconds later. It is counted again if it is shown before.
+//
+// Owned by ApplicationService, lives on the UI thread.
+class ApplicationProcessManager : public ApplicationService::Observer,
+                                  public content::NotificationObserver {
+ public:
+  class Observer {
+   public:
+    virtual void OnApplicationHibernated(Application* app) {}
+    // The hibernated |app| was shown before being terminated.
+    virtual void OnApplicationResumed(Application* app) {}
+    // |app| is about to be terminated.
+    virtual void OnApplicationEvicted(Application* app) {}
+   protected:
+    virtual ~Observer() {}
+  };
+
+  // A running application, as seen by the budget.
+  struct Candidate {
+    Candidate();
+
+    std::string app_id;
+    bool visible;
+    bool has_extension_process;
+  };
+
+  explicit ApplicationProcessManager(ApplicationService* service);
+  virtual ~ApplicationProcessManager();
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+  // Keeps |session| for the next launch of |app_id|.
+  void SaveSession(const std::string& app_id,
+                   scoped_ptr<ApplicationSession> session);
+  // The session saved when |app_id| was evicted, NULL if it wasn't.
+  scoped_ptr<ApplicationSession> TakeSavedSession(const std::string& app_id);
+
+  // The ids of the |candidates| to hibernate for the others to fit in the
+  // budget, least recently visible first. |candidates| are ordered from the
+  // most recently visible, the first one and the visible ones are kept. A
+  // limit of 0 means no limit.
+  static std::vector<std::string> SelectApplicationsToHibernate(
+      const std::vector<Candidate>& candidates,
+      size_t max_render_processes,
+      size_t max_extension_processes);
+
+ private:
+  // ApplicationService::Observer implementation.
+  virtual void DidLaunchApplication(Application* app) OVERRIDE;
+  virtual void WillDestroyApplication(Application* app) OVERRIDE;
+
+  // content::NotificationObserver implementation.
+  virtual void Observe(int type,
+                       const content::NotificationSource& source,
+                       const content::NotificationDetails& details) OVERRIDE;
+
+  void EnforceBudget();
+  void Hibernate(Application* app);
+  void Resume(Application* app);
+  void Evict(const std::string& app_id, int hibernation_id);
+
+  static bool IsVisible(Application* app);
+  static bool HasExtensionProcess(Application* app);
+
+  ApplicationService* service_;
+  size_t max_render_processes_;
+  size_t max_extension_processes_;
+  content::NotificationRegistrar registrar_;
+  // The running applications, most recently visible first.
+  std::list<std::string> recently_visible_;
+  // Hibernated and waiting to be terminated, they are no longer counted
+  // although their processes are still running.
+  // The id tells a hibernation from the previous ones of the application.
+  typedef std::map<std::string, int> HibernationMap;
+  HibernationMap hibernated_;
+  int next_hibernation_id_;
+  typedef std::map<std::string, linked_ptr<ApplicationSession> > SessionMap;
+  SessionMap saved_sessions_;
+  ObserverList<Observer> observers_;
+
+  base::WeakPtrFactory<ApplicationProcessManager> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ApplicationProcessManager);
+};
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_BROWSER_APPLICATION_PROCESS_MANAGER_H_
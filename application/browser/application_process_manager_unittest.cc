@@ -0,0 +1,87 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/browser/application_process_manager.h"
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::application::ApplicationProcessManager;
+
+namespace {
+
+typedef ApplicationProcessManager::Candidate Candidate;
+
+Candidate MakeCandidate(const std::string& app_id,
+                        bool visible,
+                        bool has_extension_process) {
+  Candidate candidate;
+  candidate.app_id = app_id;
+  candidate.visible = visible;
+  candidate.has_extension_process = has_extension_process;
+  return candidate;
+}
+
+}  // namespace
+
+TEST(ApplicationProcessManagerTest, WithinBudget) {
+  std::vector<Candidate> candidates;
+  candidates.push_back(MakeCandidate("a", true, true));
+  candidates.push_back(MakeCandidate("b", false, true));
+  EXPECT_TRUE(ApplicationProcessManager::SelectApplicationsToHibernate(
+      candidates, 2, 2).empty());
+  EXPECT_TRUE(ApplicationProcessManager::SelectApplicationsToHibernate(
+      candidates, 0, 0).empty());
+}
+
+// The least recently visible hidden applications go first.
+TEST(ApplicationProcessManagerTest, LeastRecentlyVisibleFirst) {
+  std::vector<Candidate> candidates;
+  candidates.push_back(MakeCandidate("a", true, false));
+  candidates.push_back(MakeCandidate("b", false, false));
+  candidates.push_back(MakeCandidate("c", true, false));
+  candidates.push_back(MakeCandidate("d", false, false));
+  candidates.push_back(MakeCandidate("e", false, false));
+
+  std::vector<std::string> selected =
+      ApplicationProcessManager::SelectApplicationsToHibernate(
+          candidates, 2, 0);
+  ASSERT_EQ(3u, selected.size());
+  EXPECT_EQ("e", selected[0]);
+  EXPECT_EQ("d", selected[1]);
+  EXPECT_EQ("b", selected[2]);
+}
+
+// The most recently visible application is kept even if it is hidden, e.g.
+// just launched and not shown yet.
+TEST(ApplicationProcessManagerTest, KeepsMostRecentlyVisible) {
+  std::vector<Candidate> candidates;
+  candidates.push_back(MakeCandidate("a", false, false));
+  candidates.push_back(MakeCandidate("b", false, false));
+
+  std::vector<std::string> selected =
+      ApplicationProcessManager::SelectApplicationsToHibernate(
+          candidates, 1, 0);
+  ASSERT_EQ(1u, selected.size());
+  EXPECT_EQ("b", selected[0]);
+
+  candidates.pop_back();
+  EXPECT_TRUE(ApplicationProcessManager::SelectApplicationsToHibernate(
+      candidates, 1, 0).empty());
+}
+
+TEST(ApplicationProcessManagerTest, ExtensionProcessBudget) {
+  std::vector<Candidate> candidates;
+  candidates.push_back(MakeCandidate("a", true, true));
+  candidates.push_back(MakeCandidate("b", false, true));
+  candidates.push_back(MakeCandidate("c", false, false));
+
+  std::vector<std::string> selected =
+      ApplicationProcessManager::SelectApplicationsToHibernate(
+          candidates, 0, 1);
+  ASSERT_EQ(1u, selected.size());
+  EXPECT_EQ("b", selected[0]);
+}
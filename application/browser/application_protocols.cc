@@ -11,27 +11,43 @@
 #include <utility>
 #include <vector>
 
+#include "base/file_util.h"
+#include "base/format_macros.h"
+#include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner_util.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/worker_pool.h"
 #include "base/threading/sequenced_worker_pool.h"
+#include "base/time/time.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/resource_request_info.h"
 #include "url/url_util.h"
+#include "net/base/io_buffer.h"
+#include "net/base/mime_util.h"
 #include "net/base/net_errors.h"
+#include "net/http/http_byte_range.h"
+#include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 #include "net/http/http_response_info.h"
+#include "net/http/http_util.h"
 #include "net/url_request/url_request_error_job.h"
 #include "net/url_request/url_request_file_job.h"
-#include "net/url_request/url_request_simple_job.h"
+#include "net/url_request/url_request_job.h"
 #include "xwalk/application/browser/application_service.h"
+#include "xwalk/application/common/application_archive.h"
 #include "xwalk/application/common/application_data.h"
 #include "xwalk/application/common/application_file_util.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 #include "xwalk/application/common/application_resource.h"
+#include "xwalk/application/common/application_resource_index.h"
 #include "xwalk/application/common/constants.h"
 #include "xwalk/application/common/manifest_handlers/csp_handler.h"
 #include "xwalk/runtime/common/xwalk_system_locale.h"
@@ -47,48 +63,223 @@ namespace application {
 
 namespace {
 
-net::HttpResponseHeaders* BuildHttpHeaders(
-    const std::string& content_security_policy,
-    const std::string& mime_type, const std::string& method,
-    const base::FilePath& file_path, const base::FilePath& relative_path,
-    bool is_authority_match) {
-  std::string raw_headers;
-  if (method == "GET") {
-    if (relative_path.empty())
-      raw_headers.append("HTTP/1.1 400 Bad Request");
-    else if (!is_authority_match)
-      raw_headers.append("HTTP/1.1 403 Forbidden");
-    else if (file_path.empty())
-      raw_headers.append("HTTP/1.1 404 Not Found");
-    else
-      raw_headers.append("HTTP/1.1 200 OK");
-  } else {
-    raw_headers.append("HTTP/1.1 501 Not Implemented");
+// Browsers only keep app:// resources in their memory cache, which doesn't
+// outlive the application, so the content can be considered immutable.
+const char kCacheControlHeader[] = "Cache-Control: max-age=31536000";
+
+enum ResponseKind {
+  RESPONSE_FULL,
+  RESPONSE_NOT_MODIFIED,
+  RESPONSE_PARTIAL,
+  RESPONSE_RANGE_NOT_SATISFIABLE
+};
+
+bool IsSupportedMethod(const std::string& method) {
+  return method == "GET" || method == "HEAD";
+}
+
+std::string GetStatusLine(const std::string& method,
+                          const base::FilePath& file_path,
+                          const base::FilePath& relative_path,
+                          bool is_authority_match,
+                          ResponseKind kind) {
+  if (!IsSupportedMethod(method))
+    return "HTTP/1.1 501 Not Implemented";
+  if (relative_path.empty())
+    return "HTTP/1.1 400 Bad Request";
+  if (!is_authority_match)
+    return "HTTP/1.1 403 Forbidden";
+  if (file_path.empty())
+    return "HTTP/1.1 404 Not Found";
+  switch (kind) {
+    case RESPONSE_NOT_MODIFIED:
+      return "HTTP/1.1 304 Not Modified";
+    case RESPONSE_PARTIAL:
+      return "HTTP/1.1 206 Partial Content";
+    case RESPONSE_RANGE_NOT_SATISFIABLE:
+      return "HTTP/1.1 416 Requested Range Not Satisfiable";
+    case RESPONSE_FULL:
+      break;
   }
+  return "HTTP/1.1 200 OK";
+}
 
-  if (!content_security_policy.empty()) {
-    raw_headers.append(1, '\0');
-    raw_headers.append("Content-Security-Policy: ");
-    raw_headers.append(content_security_policy);
+// Only single ranges are supported, as by URLRequestFileJob. Other requests
+// get the whole content.
+bool GetRequestedRange(const net::HttpRequestHeaders& headers,
+                       net::HttpByteRange* range) {
+  std::string value;
+  std::vector<net::HttpByteRange> ranges;
+  if (!headers.GetHeader(net::HttpRequestHeaders::kRange, &value) ||
+      !net::HttpUtil::ParseRangeHeader(value, &ranges) ||
+      ranges.size() != 1)
+    return false;
+  *range = ranges[0];
+  return true;
+}
+
+// Decides how a found resource of |size| bytes is answered. |range| is
+// bounded to the content on return.
+ResponseKind GetResponseKind(bool is_not_modified, bool has_range,
+                             int64 size, net::HttpByteRange* range) {
+  if (is_not_modified)
+    return RESPONSE_NOT_MODIFIED;
+  if (!has_range)
+    return RESPONSE_FULL;
+  return range->ComputeBounds(size) ?
+      RESPONSE_PARTIAL : RESPONSE_RANGE_NOT_SATISFIABLE;
+}
+
+// The headers depending on the requested range can't be shared.
+void AddRangeHeaders(ResponseKind kind, const net::HttpByteRange& range,
+                     int64 size, net::HttpResponseHeaders* headers) {
+  if (kind == RESPONSE_PARTIAL) {
+    headers->AddHeader(base::StringPrintf(
+        "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRId64,
+        range.first_byte_position(), range.last_byte_position(), size));
+    headers->AddHeader(base::StringPrintf(
+        "Content-Length: %" PRId64,
+        range.last_byte_position() - range.first_byte_position() + 1));
+  } else if (kind == RESPONSE_RANGE_NOT_SATISFIABLE) {
+    headers->AddHeader(
+        base::StringPrintf("Content-Range: bytes */%" PRId64, size));
+  }
+}
+
+std::string FormatHTTPDate(const base::Time& time) {
+  static const char* const kWeekDays[] =
+      { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+  static const char* const kMonths[] =
+      { "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+        "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+  base::Time::Exploded exploded;
+  time.UTCExplode(&exploded);
+  return base::StringPrintf("%s, %02d %s %04d %02d:%02d:%02d GMT",
+                            kWeekDays[exploded.day_of_week],
+                            exploded.day_of_month,
+                            kMonths[exploded.month - 1],
+                            exploded.year,
+                            exploded.hour,
+                            exploded.minute,
+                            exploded.second);
+}
+
+// Response headers of the resources of an application. The validators come
+// from the installed package, so they change whenever the application is
+// updated or reinstalled. The raw headers are only built once per status
+// and MIME type.
+class ApplicationResponseHeaders
+    : public base::RefCountedThreadSafe<ApplicationResponseHeaders> {
+ public:
+  explicit ApplicationResponseHeaders(const ApplicationData& application)
+      : last_modified_(application.install_time()) {
+    const char* csp_key = GetCSPKey(application.GetPackageType());
+    const CSPInfo* csp_info = static_cast<const CSPInfo*>(
+        application.GetManifestData(csp_key));
+    if (csp_info)
+      content_security_policy_ = csp_info->GetPolicyString();
+
+    etag_ = base::StringPrintf(
+        "\"%s-%s\"", application.VersionString().c_str(),
+        base::Int64ToString(last_modified_.ToInternalValue()).c_str());
+  }
+
+  // Whether the client already has the installed version of the resources.
+  bool IsNotModified(const net::HttpRequestHeaders& request_headers) const {
+    std::string value;
+    if (request_headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch,
+                                  &value)) {
+      std::vector<std::string> etags;
+      base::SplitString(value, ',', &etags);
+      for (size_t i = 0; i < etags.size(); ++i) {
+        if (etags[i] == "*" || etags[i] == etag_)
+          return true;
+      }
+      return false;
+    }
+
+    base::Time if_modified_since;
+    return request_headers.GetHeader(
+               net::HttpRequestHeaders::kIfModifiedSince, &value) &&
+        base::Time::FromString(value.c_str(), &if_modified_since) &&
+        // HTTP dates have a second granularity.
+        if_modified_since.ToTimeT() >= last_modified_.ToTimeT();
+  }
+
+  net::HttpResponseHeaders* Build(const std::string& status_line,
+                                  const std::string& mime_type) const {
+    const std::string key = status_line + '\n' + mime_type;
+    base::AutoLock lock(lock_);
+    std::map<std::string, std::string>::const_iterator it =
+        raw_headers_.find(key);
+    if (it == raw_headers_.end())
+      it = raw_headers_.insert(
+          std::make_pair(key, BuildRawHeaders(status_line, mime_type))).first;
+    return new net::HttpResponseHeaders(it->second);
   }
 
-  raw_headers.append(1, '\0');
-  raw_headers.append("Access-Control-Allow-Origin: *");
+ private:
+  friend class base::RefCountedThreadSafe<ApplicationResponseHeaders>;
+  ~ApplicationResponseHeaders() {}
+
+  std::string BuildRawHeaders(const std::string& status_line,
+                              const std::string& mime_type) const {
+    std::string raw_headers(status_line);
+    if (!content_security_policy_.empty()) {
+      raw_headers.append(1, '\0');
+      raw_headers.append("Content-Security-Policy: ");
+      raw_headers.append(content_security_policy_);
+    }
 
-  if (!mime_type.empty()) {
     raw_headers.append(1, '\0');
-    raw_headers.append("Content-Type: ");
-    raw_headers.append(mime_type);
+    raw_headers.append("Access-Control-Allow-Origin: *");
+
+    if (EndsWith(status_line, " 200 OK", true) ||
+        EndsWith(status_line, " 206 Partial Content", true) ||
+        EndsWith(status_line, " 304 Not Modified", true)) {
+      raw_headers.append(1, '\0');
+      raw_headers.append("Accept-Ranges: bytes");
+      raw_headers.append(1, '\0');
+      raw_headers.append("ETag: " + etag_);
+      raw_headers.append(1, '\0');
+      raw_headers.append("Last-Modified: " + FormatHTTPDate(last_modified_));
+      raw_headers.append(1, '\0');
+      raw_headers.append(kCacheControlHeader);
+    }
+
+    if (!mime_type.empty()) {
+      raw_headers.append(1, '\0');
+      raw_headers.append("Content-Type: ");
+      raw_headers.append(mime_type);
+    }
+
+    raw_headers.append(2, '\0');
+    return raw_headers;
   }
 
-  raw_headers.append(2, '\0');
-  return new net::HttpResponseHeaders(raw_headers);
-}
+  std::string content_security_policy_;
+  std::string etag_;
+  const base::Time last_modified_;
+
+  mutable base::Lock lock_;
+  mutable std::map<std::string, std::string> raw_headers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ApplicationResponseHeaders);
+};
+
+struct ResolvedFile {
+  ResolvedFile() : size(0) {}
+
+  base::FilePath path;
+  int64 size;
+};
 
 void ReadResourceFilePath(
     const ApplicationResource& resource,
-    base::FilePath* file_path) {
-  *file_path = resource.GetFilePath();
+    ResolvedFile* file) {
+  file->path = resource.GetFilePath();
+  if (!file->path.empty() && !base::GetFileSize(file->path, &file->size))
+    file->path.clear();
 }
 
 class URLRequestApplicationJob : public net::URLRequestFileJob {
@@ -100,40 +291,73 @@ class URLRequestApplicationJob : public net::URLRequestFileJob {
       const std::string& application_id,
       const base::FilePath& directory_path,
       const base::FilePath& relative_path,
-      const std::string& content_security_policy,
+      const scoped_refptr<ApplicationResponseHeaders>& headers,
       const std::list<std::string>& locales,
+      const scoped_refptr<ApplicationResourceIndex>& resource_index,
       bool is_authority_match)
       : net::URLRequestFileJob(
           request, network_delegate, base::FilePath(), file_task_runner),
         relative_path_(relative_path),
-        content_security_policy_(content_security_policy),
+        headers_(headers),
         is_authority_match_(is_authority_match),
+        response_kind_(RESPONSE_FULL),
+        has_range_(false),
+        file_size_(0),
         resource_(application_id, directory_path, relative_path),
         locales_(locales),
+        resource_index_(resource_index),
         weak_factory_(this) {
   }
 
+  virtual bool GetMimeType(std::string* mime_type) const OVERRIDE {
+    if (!mime_type_.empty()) {
+      *mime_type = mime_type_;
+      return true;
+    }
+    return net::URLRequestFileJob::GetMimeType(mime_type);
+  }
+
   virtual void GetResponseInfo(net::HttpResponseInfo* info) OVERRIDE {
     std::string mime_type;
     GetMimeType(&mime_type);
     std::string method = request()->method();
-    response_info_.headers = BuildHttpHeaders(
-        content_security_policy_, mime_type, method, file_path_,
-        relative_path_, is_authority_match_);
+    response_info_.headers = headers_->Build(
+        GetStatusLine(method, file_path_, relative_path_, is_authority_match_,
+                      response_kind_),
+        mime_type);
+    AddRangeHeaders(response_kind_, range_, file_size_,
+                    response_info_.headers.get());
     *info = response_info_;
   }
 
+  // URLRequestFileJob seeks to the requested range itself, this only keeps
+  // it to answer with the matching headers.
+  virtual void SetExtraRequestHeaders(
+      const net::HttpRequestHeaders& headers) OVERRIDE {
+    has_range_ = GetRequestedRange(headers, &range_);
+    net::URLRequestFileJob::SetExtraRequestHeaders(headers);
+  }
+
   virtual void Start() OVERRIDE {
-    base::FilePath* read_file_path = new base::FilePath;
+    // Resolved without touching the file system when the resource is in the
+    // index of the application.
+    if (resource_index_ &&
+        resource_index_->Lookup(relative_path_, locales_, &file_path_,
+                                &mime_type_, &file_size_)) {
+      StartWithFilePath();
+      return;
+    }
+
+    ResolvedFile* resolved_file = new ResolvedFile;
 
     resource_.SetLocales(locales_);
     bool posted = base::WorkerPool::PostTaskAndReply(
         FROM_HERE,
         base::Bind(&ReadResourceFilePath, resource_,
-                   base::Unretained(read_file_path)),
+                   base::Unretained(resolved_file)),
         base::Bind(&URLRequestApplicationJob::OnFilePathRead,
                    weak_factory_.GetWeakPtr(),
-                   base::Owned(read_file_path)),
+                   base::Owned(resolved_file)),
         true /* task is slow */);
     DCHECK(posted);
   }
@@ -141,9 +365,27 @@ class URLRequestApplicationJob : public net::URLRequestFileJob {
  private:
   virtual ~URLRequestApplicationJob() {}
 
-  void OnFilePathRead(base::FilePath* read_file_path) {
-    file_path_ = *read_file_path;
-    if (file_path_.empty())
+  void OnFilePathRead(ResolvedFile* resolved_file) {
+    file_path_ = resolved_file->path;
+    file_size_ = resolved_file->size;
+    StartWithFilePath();
+  }
+
+  void StartWithFilePath() {
+    const std::string& method = request()->method();
+    if (file_path_.empty() || !IsSupportedMethod(method) ||
+        !is_authority_match_) {
+      NotifyHeadersComplete();
+      return;
+    }
+
+    response_kind_ = GetResponseKind(
+        headers_->IsNotModified(request()->extra_request_headers()),
+        has_range_, file_size_, &range_);
+    // Not modified resources and HEAD requests are answered without even
+    // opening the file.
+    if (method == "HEAD" || response_kind_ == RESPONSE_NOT_MODIFIED ||
+        response_kind_ == RESPONSE_RANGE_NOT_SATISFIABLE)
       NotifyHeadersComplete();
     else
       URLRequestFileJob::Start();
@@ -151,13 +393,334 @@ class URLRequestApplicationJob : public net::URLRequestFileJob {
 
   net::HttpResponseInfo response_info_;
   base::FilePath relative_path_;
-  std::string content_security_policy_;
+  scoped_refptr<ApplicationResponseHeaders> headers_;
   bool is_authority_match_;
+  ResponseKind response_kind_;
+  bool has_range_;
+  net::HttpByteRange range_;
+  int64 file_size_;
   ApplicationResource resource_;
   std::list<std::string> locales_;
+  scoped_refptr<ApplicationResourceIndex> resource_index_;
+  std::string mime_type_;
   base::WeakPtrFactory<URLRequestApplicationJob> weak_factory_;
 };
 
+// Zip entries always use '/', and there's no file system to resolve "." or
+// ".." components.
+bool GetArchiveEntryName(const base::FilePath& relative_path,
+                         std::string* name) {
+  std::vector<base::FilePath::StringType> components;
+  relative_path.GetComponents(&components);
+  if (components.empty())
+    return false;
+
+  name->clear();
+  for (size_t i = 0; i < components.size(); ++i) {
+    if (components[i] == base::FilePath::kCurrentDirectory ||
+        components[i] == base::FilePath::kParentDirectory)
+      return false;
+    if (!name->empty())
+      name->append(1, '/');
+    name->append(base::FilePath(components[i]).AsUTF8Unsafe());
+  }
+  return true;
+}
+
+struct ArchiveRequest {
+  ArchiveRequest() : check_only(false), has_range(false) {}
+
+  // Set for HEAD and conditional requests, the entry data isn't read.
+  bool check_only;
+  bool has_range;
+  net::HttpByteRange range;
+};
+
+// The entry served by a URLRequestApplicationArchiveJob. It is looked up and
+// then read a chunk at a time on the worker pool, so a big entry is never
+// held in memory as a whole.
+class ArchiveEntryStream
+    : public base::RefCountedThreadSafe<ArchiveEntryStream> {
+ public:
+  ArchiveEntryStream()
+      : found_(false), size_(0), file_offset_(0), file_remaining_(0) {}
+
+  // Finds the entry, locale specific versions first as ApplicationResource
+  // does, and gets ready to read the requested range.
+  void Open(const scoped_refptr<ApplicationArchive>& archive,
+            const ApplicationResource& resource,
+            const std::list<std::string>& locales,
+            const ArchiveRequest& request) {
+    if (!archive->Open()) {
+      // Not a packed application, the request just came before the launch
+      // time probe completed.
+      OpenFile(resource.GetFilePath(), request);
+      return;
+    }
+
+    std::string name;
+    if (!GetArchiveEntryName(resource.relative_path(), &name))
+      return;
+
+    for (std::list<std::string>::const_iterator it = locales.begin();
+         it != locales.end(); ++it) {
+      const std::string locale_name = "locales/" + *it + "/" + name;
+      if (archive->HasEntry(locale_name)) {
+        OpenEntry(*archive, locale_name, request);
+        return;
+      }
+    }
+    OpenEntry(*archive, name, request);
+  }
+
+  // Reads the next chunk of the range into |buffer|. Returns the number of
+  // bytes read, 0 at the end of the range, or a net error.
+  int Read(const scoped_refptr<net::IOBuffer>& buffer, int size) {
+    if (reader_) {
+      const int result = reader_->Read(buffer->data(), size);
+      return result < 0 ? net::ERR_FAILED : result;
+    }
+    if (!file_.IsValid() || !file_remaining_)
+      return 0;
+
+    size = static_cast<int>(std::min<int64>(size, file_remaining_));
+    const int result = file_.Read(file_offset_, buffer->data(), size);
+    if (result <= 0)
+      return net::ERR_FAILED;
+    file_offset_ += result;
+    file_remaining_ -= result;
+    return result;
+  }
+
+  bool found() const { return found_; }
+  // Path of the entry in the archive, or of the file.
+  const base::FilePath& entry_path() const { return entry_path_; }
+  // Size of the whole entry.
+  int64 size() const { return size_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<ArchiveEntryStream>;
+  ~ArchiveEntryStream() {}
+
+  // Bounds the requested range to |size_|, returns false if there's nothing
+  // to read.
+  bool GetRange(const ArchiveRequest& request, int64* offset, int64* length) {
+    *offset = 0;
+    *length = size_;
+    if (request.check_only)
+      return false;
+    if (!request.has_range)
+      return true;
+    net::HttpByteRange range = request.range;
+    if (!range.ComputeBounds(size_))
+      return false;
+    *offset = range.first_byte_position();
+    *length = range.last_byte_position() - *offset + 1;
+    return true;
+  }
+
+  void OpenEntry(const ApplicationArchive& archive,
+                 const std::string& name,
+                 const ArchiveRequest& request) {
+    if (!archive.GetEntrySize(name, &size_))
+      return;
+    int64 offset, length;
+    if (GetRange(request, &offset, &length)) {
+      reader_ = archive.OpenEntry(name, offset, length);
+      if (!reader_)
+        return;
+    }
+    found_ = true;
+    entry_path_ = base::FilePath::FromUTF8Unsafe(name);
+  }
+
+  void OpenFile(const base::FilePath& path, const ArchiveRequest& request) {
+    if (path.empty() || !base::GetFileSize(path, &size_))
+      return;
+    int64 offset, length;
+    if (GetRange(request, &offset, &length)) {
+      file_.Initialize(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+      if (!file_.IsValid())
+        return;
+      file_offset_ = offset;
+      file_remaining_ = length;
+    }
+    found_ = true;
+    entry_path_ = path;
+  }
+
+  bool found_;
+  base::FilePath entry_path_;
+  int64 size_;
+  scoped_ptr<ApplicationArchive::EntryReader> reader_;
+  // Read instead of |reader_| when the application isn't packed.
+  base::File file_;
+  int64 file_offset_;
+  int64 file_remaining_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveEntryStream);
+};
+
+// Serves the resources of applications kept packed, see
+// PackageInstaller::set_keep_packed().
+class URLRequestApplicationArchiveJob : public net::URLRequestJob {
+ public:
+  URLRequestApplicationArchiveJob(
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate,
+      const scoped_refptr<ApplicationArchive>& archive,
+      const std::string& application_id,
+      const base::FilePath& directory_path,
+      const base::FilePath& relative_path,
+      const scoped_refptr<ApplicationResponseHeaders>& headers,
+      const std::list<std::string>& locales,
+      bool is_authority_match)
+      : net::URLRequestJob(request, network_delegate),
+        archive_(archive),
+        relative_path_(relative_path),
+        entry_size_(0),
+        headers_(headers),
+        is_authority_match_(is_authority_match),
+        is_not_modified_(false),
+        response_kind_(RESPONSE_FULL),
+        has_range_(false),
+        has_content_(false),
+        resource_(application_id, directory_path, relative_path),
+        locales_(locales),
+        weak_factory_(this) {
+    resource_.SetLocales(locales_);
+  }
+
+  virtual void Start() OVERRIDE {
+    if (!IsSupportedMethod(request()->method()) || relative_path_.empty() ||
+        !is_authority_match_) {
+      base::MessageLoop::current()->PostTask(
+          FROM_HERE,
+          base::Bind(&URLRequestApplicationArchiveJob::NotifyHeadersComplete,
+                     weak_factory_.GetWeakPtr()));
+      return;
+    }
+
+    is_not_modified_ =
+        headers_->IsNotModified(request()->extra_request_headers());
+    ArchiveRequest archive_request;
+    archive_request.check_only =
+        is_not_modified_ || request()->method() == "HEAD";
+    archive_request.has_range = has_range_;
+    archive_request.range = range_;
+    stream_ = new ArchiveEntryStream;
+    bool posted = base::WorkerPool::PostTaskAndReply(
+        FROM_HERE,
+        base::Bind(&ArchiveEntryStream::Open, stream_, archive_, resource_,
+                   locales_, archive_request),
+        base::Bind(&URLRequestApplicationArchiveJob::OnEntryOpened,
+                   weak_factory_.GetWeakPtr()),
+        true /* task is slow */);
+    DCHECK(posted);
+  }
+
+  virtual void Kill() OVERRIDE {
+    weak_factory_.InvalidateWeakPtrs();
+    net::URLRequestJob::Kill();
+  }
+
+  virtual bool ReadRawData(net::IOBuffer* buf, int buf_size,
+                           int* bytes_read) OVERRIDE {
+    if (!has_content_) {
+      *bytes_read = 0;
+      return true;
+    }
+
+    bool posted = base::PostTaskAndReplyWithResult(
+        base::WorkerPool::GetTaskRunner(true /* tasks are slow */).get(),
+        FROM_HERE,
+        base::Bind(&ArchiveEntryStream::Read, stream_,
+                   make_scoped_refptr(buf), buf_size),
+        base::Bind(&URLRequestApplicationArchiveJob::OnReadComplete,
+                   weak_factory_.GetWeakPtr()));
+    DCHECK(posted);
+    SetStatus(net::URLRequestStatus(net::URLRequestStatus::IO_PENDING, 0));
+    return false;
+  }
+
+  virtual bool GetMimeType(std::string* mime_type) const OVERRIDE {
+    *mime_type = mime_type_;
+    return !mime_type_.empty();
+  }
+
+  virtual void GetResponseInfo(net::HttpResponseInfo* info) OVERRIDE {
+    response_info_.headers = headers_->Build(
+        GetStatusLine(request()->method(), entry_path_, relative_path_,
+                      is_authority_match_, response_kind_),
+        mime_type_);
+    AddRangeHeaders(response_kind_, range_, entry_size_,
+                    response_info_.headers.get());
+    *info = response_info_;
+  }
+
+  // The range is read from the archive directly.
+  virtual void SetExtraRequestHeaders(
+      const net::HttpRequestHeaders& headers) OVERRIDE {
+    has_range_ = GetRequestedRange(headers, &range_);
+  }
+
+ private:
+  virtual ~URLRequestApplicationArchiveJob() {}
+
+  void OnEntryOpened() {
+    if (stream_->found()) {
+      entry_path_ = stream_->entry_path();
+      entry_size_ = stream_->size();
+      response_kind_ = GetResponseKind(is_not_modified_, has_range_,
+                                       entry_size_, &range_);
+      net::GetMimeTypeFromFile(entry_path_, &mime_type_);
+      // Nothing was opened for the responses without content.
+      has_content_ = request()->method() != "HEAD" &&
+          (response_kind_ == RESPONSE_FULL ||
+           response_kind_ == RESPONSE_PARTIAL);
+    }
+    NotifyHeadersComplete();
+  }
+
+  void OnReadComplete(int result) {
+    if (result < 0) {
+      NotifyDone(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                       result));
+      return;
+    }
+    SetStatus(net::URLRequestStatus());
+    NotifyReadComplete(result);
+  }
+
+  scoped_refptr<ApplicationArchive> archive_;
+  scoped_refptr<ArchiveEntryStream> stream_;
+  net::HttpResponseInfo response_info_;
+  base::FilePath relative_path_;
+  // Path of the entry served, empty if not found.
+  base::FilePath entry_path_;
+  int64 entry_size_;
+  std::string mime_type_;
+  scoped_refptr<ApplicationResponseHeaders> headers_;
+  bool is_authority_match_;
+  bool is_not_modified_;
+  ResponseKind response_kind_;
+  bool has_range_;
+  net::HttpByteRange range_;
+  // Whether the response has a body, read from |stream_|.
+  bool has_content_;
+  ApplicationResource resource_;
+  std::list<std::string> locales_;
+  base::WeakPtrFactory<URLRequestApplicationArchiveJob> weak_factory_;
+};
+
+// Finds out whether the application is packed, otherwise indexes its files.
+void PrepareApplicationResources(
+    const scoped_refptr<ApplicationArchive>& archive,
+    const scoped_refptr<ApplicationResourceIndex>& index) {
+  if (!archive->Open())
+    index->Build();
+}
+
 // This class is a thread-safe cache of active application's data.
 // This class is used by ApplicationProtocolHandler as it lives on IO thread
 // and hence cannot access ApplicationService directly.
@@ -174,19 +737,49 @@ class ApplicationDataCache : public ApplicationService::Observer {
     return NULL;
   }
 
+  struct ApplicationResources {
+    scoped_refptr<ApplicationResourceIndex> index;
+    scoped_refptr<ApplicationArchive> archive;
+    scoped_refptr<ApplicationResponseHeaders> headers;
+  };
+
+  ApplicationResources GetApplicationResources(
+      const std::string& application_id) const {
+    base::AutoLock lock(lock_);
+    ResourcesMap::const_iterator it = resources_.find(application_id);
+    if (it != resources_.end())
+      return it->second;
+    return ApplicationResources();
+  }
+
   virtual void DidLaunchApplication(Application* app) OVERRIDE {
+    ApplicationResources resources;
+    resources.index = new ApplicationResourceIndex(app->data()->Path());
+    resources.archive = new ApplicationArchive(
+        app->data()->Path().Append(kPackedResourcesFilename));
+    resources.headers = new ApplicationResponseHeaders(*app->data());
+    // Requests coming before this is done take the slow path.
+    BrowserThread::PostBlockingPoolTask(
+        FROM_HERE, base::Bind(&PrepareApplicationResources,
+                              resources.archive, resources.index));
+
     base::AutoLock lock(lock_);
     cache_.insert(std::pair<std::string, scoped_refptr<ApplicationData> >(
         app->id(), app->data()));
+    resources_[app->id()] = resources;
   }
 
   virtual void WillDestroyApplication(Application* app) OVERRIDE {
     base::AutoLock lock(lock_);
     cache_.erase(app->id());
+    resources_.erase(app->id());
   }
 
  private:
+  typedef std::map<std::string, ApplicationResources> ResourcesMap;
+
   ApplicationData::ApplicationDataMap cache_;
+  ResourcesMap resources_;
   mutable base::Lock lock_;
 };
 
@@ -240,27 +833,16 @@ ApplicationProtocolHandler::MaybeCreateJob(
     return new net::URLRequestErrorJob(
         request, network_delegate, net::ERR_FILE_NOT_FOUND);
 
+  // Destroyed in the meantime.
+  const ApplicationDataCache::ApplicationResources resources =
+      cache_.GetApplicationResources(application_id);
+  if (!resources.headers)
+    return new net::URLRequestErrorJob(
+        request, network_delegate, net::ERR_FILE_NOT_FOUND);
+
   base::FilePath relative_path =
       ApplicationURLToRelativeFilePath(request->url());
-  base::FilePath directory_path;
-  std::string content_security_policy;
-  if (application) {
-    directory_path = application->Path();
-
-    const char* csp_key = GetCSPKey(application->GetPackageType());
-    const CSPInfo* csp_info = static_cast<CSPInfo*>(
-          application->GetManifestData(csp_key));
-    if (csp_info) {
-      const std::map<std::string, std::vector<std::string> >& policies =
-          csp_info->GetDirectives();
-      std::map<std::string, std::vector<std::string> >::const_iterator it =
-          policies.begin();
-      for (; it != policies.end(); ++it) {
-        content_security_policy.append(
-            it->first + ' ' + JoinString(it->second, ' ') + ';');
-      }
-    }
-  }
+  base::FilePath directory_path = application->Path();
 
   const std::string& path = request->url().path();
 
@@ -270,6 +852,22 @@ ApplicationProtocolHandler::MaybeCreateJob(
     GetUserAgentLocales(application->GetManifest()->default_locale(), locales);
   }
 
+  // Until the launch time probe is done the archive job is used, it falls
+  // back to the file system if the application isn't packed.
+  if (resources.archive &&
+      (!resources.archive->is_opened() || resources.archive->is_valid())) {
+    return new URLRequestApplicationArchiveJob(
+        request,
+        network_delegate,
+        resources.archive,
+        application_id,
+        directory_path,
+        relative_path,
+        resources.headers,
+        locales,
+        application);
+  }
+
   return new URLRequestApplicationJob(
       request,
       network_delegate,
@@ -279,8 +877,9 @@ ApplicationProtocolHandler::MaybeCreateJob(
       application_id,
       directory_path,
       relative_path,
-      content_security_policy,
+      resources.headers,
       locales,
+      resources.index,
       application);
 }
 
@@ -4,28 +4,38 @@
 
 #include "xwalk/application/browser/application_service.h"
 
+#include <algorithm>
+#include <list>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "base/command_line.h"
 #include "base/containers/hash_tables.h"
 #include "base/files/file_enumerator.h"
 #include "base/file_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/site_instance.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "xwalk/application/browser/application.h"
+#include "xwalk/application/browser/application_process_manager.h"
 #include "xwalk/application/browser/application_system.h"
 #include "xwalk/application/common/application_storage.h"
 #include "xwalk/application/common/installer/package.h"
 #include "xwalk/application/common/installer/package_installer.h"
 #include "xwalk/application/common/application_file_util.h"
+#include "xwalk/application/common/id_util.h"
 #include "xwalk/runtime/browser/runtime_context.h"
 #include "xwalk/runtime/browser/runtime.h"
+#include "xwalk/runtime/browser/runtime_startup_timeline.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
 #include "xwalk/runtime/common/xwalk_paths.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
 
 #if defined(OS_TIZEN)
 #include "xwalk/application/browser/application_tizen.h"
@@ -50,10 +60,44 @@ base::FilePath GetStoragePartitionPath(
 #endif
 }
 
-void CollectUnusedStoragePartitions(RuntimeContext* context,
-                                    ApplicationStorage* storage) {
+}  // namespace
+
+ApplicationService::ApplicationService(RuntimeContext* runtime_context,
+                                       ApplicationStorage* app_storage)
+    : runtime_context_(runtime_context),
+      application_storage_(app_storage),
+      warm_pool_size_(0),
+      weak_factory_(this) {
+  process_manager_.reset(new ApplicationProcessManager(this));
+  // Not needed to launch the first application, so it doesn't wait for the
+  // storage to be opened.
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&ApplicationService::CollectUnusedStoragePartitions,
+                 weak_factory_.GetWeakPtr()));
+
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch(switches::kWarmRenderProcesses)) {
+    unsigned size;
+    if (base::StringToUint(command_line.GetSwitchValueASCII(
+            switches::kWarmRenderProcesses), &size)) {
+      warm_pool_size_ = size;
+      ScheduleFillWarmPool();
+    } else {
+      LOG(WARNING) << "Invalid value of --"
+                   << switches::kWarmRenderProcesses;
+    }
+  }
+}
+
+ApplicationService::~ApplicationService() {
+  while (!spare_site_instances_.empty())
+    DiscardSpareRenderProcess(spare_site_instances_.begin()->first);
+}
+
+void ApplicationService::CollectUnusedStoragePartitions() {
   std::vector<std::string> app_ids;
-  if (!storage->GetInstalledApplicationIDs(app_ids))
+  if (!application_storage_->GetInstalledApplicationIDs(app_ids))
     return;
 
   scoped_ptr<base::hash_set<base::FilePath> > active_paths(
@@ -61,23 +105,11 @@ void CollectUnusedStoragePartitions(RuntimeContext* context,
 
   for (unsigned i = 0; i < app_ids.size(); ++i) {
     active_paths->insert(
-        GetStoragePartitionPath(context->GetPath(), app_ids.at(i)));
+        GetStoragePartitionPath(runtime_context_->GetPath(), app_ids.at(i)));
   }
 
   content::BrowserContext::GarbageCollectStoragePartitions(
-      context, active_paths.Pass(), base::Bind(&base::DoNothing));
-}
-
-}  // namespace
-
-ApplicationService::ApplicationService(RuntimeContext* runtime_context,
-                                       ApplicationStorage* app_storage)
-    : runtime_context_(runtime_context),
-      application_storage_(app_storage) {
-  CollectUnusedStoragePartitions(runtime_context, app_storage);
-}
-
-ApplicationService::~ApplicationService() {
+      runtime_context_, active_paths.Pass(), base::Bind(&base::DoNothing));
 }
 
 Application* ApplicationService::Launch(
@@ -101,12 +133,24 @@ Application* ApplicationService::Launch(
 
   ScopedVector<Application>::iterator app_iter =
       applications_.insert(applications_.end(), application);
+  applications_by_id_[application_data->ID()] = application;
+
+  application->set_spare_site_instance(
+      TakeSpareSiteInstance(application_data->ID()));
+  application->set_saved_session(
+      process_manager_->TakeSavedSession(application_data->ID()));
+  recently_launched_.remove(application_data->ID());
+  recently_launched_.push_front(application_data->ID());
+  ScheduleFillWarmPool();
 
   if (!application->Launch(launch_params)) {
+    RemoveFromIndexes(application);
     applications_.erase(app_iter);
     return NULL;
   }
 
+  RuntimeStartupTimeline::GetInstance()->Record(
+      RuntimeStartupTimeline::MILESTONE_APPLICATION_LAUNCHED);
   FOR_EACH_OBSERVER(Observer, observers_,
                     DidLaunchApplication(application));
 
@@ -115,12 +159,16 @@ Application* ApplicationService::Launch(
 
 Application* ApplicationService::Launch(
     const std::string& id, const Application::LaunchParams& params) {
+  StartSpareRenderProcess(id);
   scoped_refptr<ApplicationData> application_data =
     application_storage_->GetApplicationData(id);
   if (!application_data) {
     LOG(ERROR) << "Application with id " << id << " is not installed.";
+    DiscardSpareRenderProcess(id);
     return NULL;
   }
+  RuntimeStartupTimeline::GetInstance()->Record(
+      RuntimeStartupTimeline::MILESTONE_APPLICATION_DATA_LOADED);
 
   return Launch(application_data, params);
 }
@@ -130,56 +178,52 @@ Application* ApplicationService::Launch(
   if (!base::DirectoryExists(path))
     return NULL;
 
+  // The id is the one of the path unless the manifest has its own.
+  const std::string expected_id = GenerateIdForPath(path);
+  StartSpareRenderProcess(expected_id);
   std::string error;
   scoped_refptr<ApplicationData> application_data =
       LoadApplication(path, Manifest::COMMAND_LINE, &error);
 
+  if (!application_data || application_data->ID() != expected_id)
+    DiscardSpareRenderProcess(expected_id);
   if (!application_data) {
     LOG(ERROR) << "Error occurred while trying to launch application: "
                << error;
     return NULL;
   }
+  RuntimeStartupTimeline::GetInstance()->Record(
+      RuntimeStartupTimeline::MILESTONE_APPLICATION_DATA_LOADED);
 
   return Launch(application_data, params);
 }
 
-namespace {
-
-struct ApplicationRenderHostIDComparator {
-    explicit ApplicationRenderHostIDComparator(int id) : id(id) { }
-    bool operator() (Application* application) {
-      return id == application->GetRenderProcessHostID();
-    }
-    int id;
-};
-
-struct ApplicationIDComparator {
-    explicit ApplicationIDComparator(const std::string& app_id)
-      : app_id(app_id) { }
-    bool operator() (Application* application) {
-      return app_id == application->id();
-    }
-    std::string app_id;
-};
-
-}  // namespace
-
 Application* ApplicationService::GetApplicationByRenderHostID(int id) const {
-  ApplicationRenderHostIDComparator comparator(id);
-  ScopedVector<Application>::const_iterator found = std::find_if(
-      applications_.begin(), applications_.end(), comparator);
-  if (found != applications_.end())
-    return *found;
+  base::hash_map<int, Application*>::const_iterator found =
+      applications_by_render_process_id_.find(id);
+  if (found != applications_by_render_process_id_.end())
+    return found->second;
   return NULL;
 }
 
+std::string ApplicationService::GetApplicationIDByRenderHostID(int id) const {
+  if (Application* application = GetApplicationByRenderHostID(id))
+    return application->id();
+  for (SpareSiteInstanceMap::const_iterator it =
+           spare_site_instances_.begin();
+       it != spare_site_instances_.end(); ++it) {
+    if (it->second->GetProcess()->GetID() == id)
+      return it->first;
+  }
+  return std::string();
+}
+
 Application* ApplicationService::GetApplicationByID(
     const std::string& app_id) const {
-  ApplicationIDComparator comparator(app_id);
-  ScopedVector<Application>::const_iterator found = std::find_if(
-      applications_.begin(), applications_.end(), comparator);
-  if (found != applications_.end())
-    return *found;
+  base::hash_map<std::string, Application*>::const_iterator found =
+      applications_by_id_.find(app_id);
+  if (found != applications_by_id_.end())
+    return found->second;
   return NULL;
 }
 
@@ -198,7 +242,10 @@ void ApplicationService::OnApplicationTerminated(
   CHECK(found != applications_.end());
   FOR_EACH_OBSERVER(Observer, observers_,
                     WillDestroyApplication(application));
+  RemoveFromIndexes(application);
   applications_.erase(found);
+  // Its render process can be warmed up again.
+  ScheduleFillWarmPool();
 #if !defined(SHARED_PROCESS_MODE)
   if (applications_.empty()) {
     base::MessageLoop::current()->PostTask(
@@ -207,6 +254,37 @@ void ApplicationService::OnApplicationTerminated(
 #endif
 }
 
+void ApplicationService::OnRenderProcessHostAttached(
+    Application* application) {
+  applications_by_render_process_id_[application->GetRenderProcessHostID()] =
+      application;
+}
+
+void ApplicationService::OnRenderProcessHostDetached(
+    Application* application) {
+  applications_by_render_process_id_.erase(
+      application->GetRenderProcessHostID());
+}
+
+void ApplicationService::OnPermissionsChanged(Application* application) {
+  FOR_EACH_OBSERVER(Observer, observers_,
+                    DidChangePermissions(application));
+}
+
+void ApplicationService::RemoveFromIndexes(Application* application) {
+  applications_by_id_.erase(application->id());
+  // The render process is usually detached already, so this is only done
+  // when the application terminates.
+  for (base::hash_map<int, Application*>::iterator it =
+           applications_by_render_process_id_.begin();
+       it != applications_by_render_process_id_.end(); ++it) {
+    if (it->second == application) {
+      applications_by_render_process_id_.erase(it);
+      return;
+    }
+  }
+}
+
 void ApplicationService::CheckAPIAccessControl(const std::string& app_id,
     const std::string& extension_name,
     const std::string& api_name, const PermissionCallback& callback) {
@@ -224,58 +302,7 @@ void ApplicationService::CheckAPIAccessControl(const std::string& app_id,
     callback.Run(UNDEFINED_RUNTIME_PERM);
     return;
   }
-  // Permission name should have been registered at extension initialization.
-  std::string permission_name =
-      app->GetRegisteredPermissionName(extension_name, api_name);
-  if (permission_name.empty()) {
-    LOG(ERROR) << "API: " << api_name << " of extension: "
-      << extension_name << " not registered!";
-    callback.Run(UNDEFINED_RUNTIME_PERM);
-    return;
-  }
-  // Okay, since we have the permission name, let's get down to the policies.
-  // First, find out whether the permission is stored for the current session.
-  StoredPermission perm = app->GetPermission(
-      SESSION_PERMISSION, permission_name);
-  if (perm != UNDEFINED_STORED_PERM) {
-    // "PROMPT" should not be in the session storage.
-    DCHECK(perm != PROMPT);
-    if (perm == ALLOW) {
-      callback.Run(ALLOW_SESSION);
-      return;
-    }
-    if (perm == DENY) {
-      callback.Run(DENY_SESSION);
-      return;
-    }
-    NOTREACHED();
-  }
-  // Then, query the persistent policy storage.
-  perm = app->GetPermission(PERSISTENT_PERMISSION, permission_name);
-  // Permission not found in persistent permission table, normally this should
-  // not happen because all the permission needed by the application should be
-  // contained in its manifest, so it also means that the application is asking
-  // for something wasn't allowed.
-  if (perm == UNDEFINED_STORED_PERM) {
-    callback.Run(UNDEFINED_RUNTIME_PERM);
-    return;
-  }
-  if (perm == PROMPT) {
-    // TODO(Bai): We needed to pop-up a dialog asking user to chose one from
-    // either allow/deny for session/one shot/forever. Then, we need to update
-    // the session and persistent policy accordingly.
-    callback.Run(UNDEFINED_RUNTIME_PERM);
-    return;
-  }
-  if (perm == ALLOW) {
-    callback.Run(ALLOW_ALWAYS);
-    return;
-  }
-  if (perm == DENY) {
-    callback.Run(DENY_ALWAYS);
-    return;
-  }
-  NOTREACHED();
+  callback.Run(app->GetRuntimePermission(extension_name, api_name));
 }
 
 bool ApplicationService::RegisterPermissions(const std::string& app_id,
@@ -295,5 +322,76 @@ bool ApplicationService::RegisterPermissions(const std::string& app_id,
   return app->RegisterPermissions(extension_name, perm_table);
 }
 
+void ApplicationService::StartSpareRenderProcess(const std::string& app_id) {
+  if (app_id.empty() || spare_site_instances_.count(app_id) ||
+      GetApplicationByID(app_id))
+    return;
+
+  // The site of the application selects its storage partition, see
+  // XWalkContentBrowserClient::GetStoragePartitionConfigForSite().
+  scoped_refptr<content::SiteInstance> site_instance =
+      content::SiteInstance::CreateForURL(
+          runtime_context_,
+          ApplicationData::GetBaseURLFromApplicationId(app_id));
+  spare_site_instances_[app_id] = site_instance;
+  site_instance->GetProcess()->Init();
+}
+
+scoped_refptr<content::SiteInstance> ApplicationService::TakeSpareSiteInstance(
+    const std::string& app_id) {
+  scoped_refptr<content::SiteInstance> site_instance;
+  SpareSiteInstanceMap::iterator it = spare_site_instances_.find(app_id);
+  if (it != spare_site_instances_.end()) {
+    site_instance = it->second;
+    spare_site_instances_.erase(it);
+  }
+  return site_instance;
+}
+
+void ApplicationService::DiscardSpareRenderProcess(const std::string& app_id) {
+  scoped_refptr<content::SiteInstance> site_instance =
+      TakeSpareSiteInstance(app_id);
+  // Nothing is hosted by the process yet, this shuts it down.
+  if (site_instance)
+    site_instance->GetProcess()->Cleanup();
+}
+
+void ApplicationService::ScheduleFillWarmPool() {
+  if (!warm_pool_size_)
+    return;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&ApplicationService::FillWarmPool,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void ApplicationService::FillWarmPool() {
+  if (spare_site_instances_.size() >= warm_pool_size_)
+    return;
+
+  std::vector<std::string> installed_ids;
+  if (!application_storage_->GetInstalledApplicationIDs(installed_ids))
+    return;
+
+  // The recently launched applications first, then the others in the order
+  // of the storage.
+  std::vector<std::string> app_ids;
+  for (std::list<std::string>::const_iterator it = recently_launched_.begin();
+       it != recently_launched_.end(); ++it) {
+    if (std::find(installed_ids.begin(), installed_ids.end(), *it) !=
+        installed_ids.end())
+      app_ids.push_back(*it);
+  }
+  for (size_t i = 0; i < installed_ids.size(); ++i) {
+    if (std::find(app_ids.begin(), app_ids.end(), installed_ids[i]) ==
+        app_ids.end())
+      app_ids.push_back(installed_ids[i]);
+  }
+
+  for (size_t i = 0; i < app_ids.size() &&
+           spare_site_instances_.size() < warm_pool_size_; ++i)
+    StartSpareRenderProcess(app_ids[i]);
+}
+
 }  // namespace application
 }  // namespace xwalk
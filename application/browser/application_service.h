@@ -5,22 +5,31 @@
 #ifndef XWALK_APPLICATION_BROWSER_APPLICATION_SERVICE_H_
 #define XWALK_APPLICATION_BROWSER_APPLICATION_SERVICE_H_
 
+#include <list>
+#include <map>
 #include <string>
+#include "base/containers/hash_tables.h"
 #include "base/files/file_path.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "xwalk/application/browser/application.h"
 #include "xwalk/application/common/permission_policy_manager.h"
 #include "xwalk/runtime/browser/runtime_context.h"
 #include "xwalk/application/common/application_data.h"
 
+namespace content {
+class SiteInstance;
+}
+
 namespace xwalk {
 
 class RuntimeContext;
 
 namespace application {
 
+class ApplicationProcessManager;
 class ApplicationStorage;
 class PackageInstaller;
 
@@ -34,6 +43,9 @@ class ApplicationService : public Application::Observer {
    public:
     virtual void DidLaunchApplication(Application* app) {}
     virtual void WillDestroyApplication(Application* app) {}
+    // The decisions cached for the application, by CheckAPIAccessControl()
+    // and its Extension Process, are no longer valid.
+    virtual void DidChangePermissions(Application* app) {}
    protected:
     virtual ~Observer() {}
   };
@@ -55,11 +67,17 @@ class ApplicationService : public Application::Observer {
       const Application::LaunchParams& params = Application::LaunchParams());
 
   Application* GetApplicationByRenderHostID(int id) const;
+  // Also knows the application a spare render process was started for.
+  std::string GetApplicationIDByRenderHostID(int id) const;
   Application* GetApplicationByID(const std::string& app_id) const;
 
   const ScopedVector<Application>& active_applications() const {
       return applications_; }
 
+  ApplicationProcessManager* process_manager() {
+    return process_manager_.get();
+  }
+
   void AddObserver(Observer* observer);
   void RemoveObserver(Observer* observer);
 
@@ -79,11 +97,47 @@ class ApplicationService : public Application::Observer {
  private:
   // Implementation of Application::Observer.
   virtual void OnApplicationTerminated(Application* app) OVERRIDE;
+  virtual void OnRenderProcessHostAttached(Application* app) OVERRIDE;
+  virtual void OnRenderProcessHostDetached(Application* app) OVERRIDE;
+  virtual void OnPermissionsChanged(Application* app) OVERRIDE;
+
+  void RemoveFromIndexes(Application* app);
+
+  // Deletes the storage partitions of the uninstalled applications.
+  void CollectUnusedStoragePartitions();
+
+  // Starts the render process of |app_id| ahead of its launch: while its
+  // data is being loaded, so the process launch overlaps with it, or in the
+  // warm pool. Launch() then hands it to the application.
+  void StartSpareRenderProcess(const std::string& app_id);
+  scoped_refptr<content::SiteInstance> TakeSpareSiteInstance(
+      const std::string& app_id);
+  void DiscardSpareRenderProcess(const std::string& app_id);
+
+  // With --warm-render-processes=N, the render processes, and with them the
+  // Extension Processes, of N installed applications that are not running
+  // are kept started, preferring the recently launched ones. The pool is
+  // refilled after each launch and termination.
+  void ScheduleFillWarmPool();
+  void FillWarmPool();
 
   xwalk::RuntimeContext* runtime_context_;
   ApplicationStorage* application_storage_;
   ScopedVector<Application> applications_;
+  // Indexes of |applications_|.
+  base::hash_map<std::string, Application*> applications_by_id_;
+  base::hash_map<int, Application*> applications_by_render_process_id_;
   ObserverList<Observer> observers_;
+  // Declared after |observers_|, it removes itself from them when
+  // destroyed.
+  scoped_ptr<ApplicationProcessManager> process_manager_;
+  typedef std::map<std::string, scoped_refptr<content::SiteInstance> >
+      SpareSiteInstanceMap;
+  SpareSiteInstanceMap spare_site_instances_;
+  size_t warm_pool_size_;
+  // Most recent first.
+  std::list<std::string> recently_launched_;
+  base::WeakPtrFactory<ApplicationService> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(ApplicationService);
 };
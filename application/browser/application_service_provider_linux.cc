@@ -18,10 +18,14 @@ namespace application {
 
 ApplicationServiceProviderLinux::ApplicationServiceProviderLinux(
     ApplicationService* app_service,
-    scoped_refptr<dbus::Bus> session_bus)
+    ApplicationMemoryMonitor* memory_monitor,
+    scoped_refptr<dbus::Bus> session_bus,
+    MethodDispatcher* method_dispatcher)
     : session_bus_(session_bus) {
   running_apps_.reset(new RunningApplicationsManager(session_bus_,
-                                                     app_service));
+                                                     method_dispatcher,
+                                                     app_service,
+                                                     memory_monitor));
 
   // TODO(cmarcelo): This is just a placeholder to test D-Bus is working, remove
   // once we exported proper objects.
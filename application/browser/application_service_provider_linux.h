@@ -14,9 +14,13 @@ class Bus;
 }
 
 namespace xwalk {
+
+class MethodDispatcher;
+
 namespace application {
 
 class Application;
+class ApplicationMemoryMonitor;
 class ApplicationService;
 class RunningApplicationObject;
 class RunningApplicationsManager;
@@ -26,7 +30,9 @@ class RunningApplicationsManager;
 class ApplicationServiceProviderLinux {
  public:
   ApplicationServiceProviderLinux(ApplicationService* app_service,
-                                  scoped_refptr<dbus::Bus> session_bus);
+                                  ApplicationMemoryMonitor* memory_monitor,
+                                  scoped_refptr<dbus::Bus> session_bus,
+                                  MethodDispatcher* method_dispatcher);
   virtual ~ApplicationServiceProviderLinux();
 
   RunningApplicationObject* GetRunningApplicationObject(const Application* app);
@@ -7,9 +7,11 @@
 #include <string>
 #include "base/command_line.h"
 #include "base/file_util.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_process_host.h"
 #include "net/base/filename_util.h"
 #include "xwalk/application/browser/application.h"
+#include "xwalk/application/browser/application_memory_monitor.h"
 #include "xwalk/application/browser/application_service.h"
 #include "xwalk/application/common/application_storage.h"
 #include "xwalk/application/common/application_manifest_constants.h"
@@ -26,12 +28,26 @@
 namespace xwalk {
 namespace application {
 
+namespace {
+
+// The database is opened while the browser main parts do the rest of the
+// startup on the UI thread, the first use of the storage waits for it.
+ApplicationStorage* CreateApplicationStorage(const base::FilePath& path) {
+  base::SequencedWorkerPool* pool = content::BrowserThread::GetBlockingPool();
+  return new ApplicationStorage(path, pool->GetTaskRunnerWithShutdownBehavior(
+      base::SequencedWorkerPool::BLOCK_SHUTDOWN));
+}
+
+}  // namespace
+
 ApplicationSystem::ApplicationSystem(RuntimeContext* runtime_context)
   : runtime_context_(runtime_context),
-    application_storage_(new ApplicationStorage(runtime_context->GetPath())),
+    application_storage_(CreateApplicationStorage(runtime_context->GetPath())),
     application_service_(new ApplicationService(
         runtime_context,
-        application_storage_.get())) {}
+        application_storage_.get())),
+    memory_monitor_(new ApplicationMemoryMonitor(
+        application_service_.get())) {}
 
 ApplicationSystem::~ApplicationSystem() {
 }
@@ -111,13 +127,14 @@ bool ApplicationSystem::LaunchFromCommandLine(
 void ApplicationSystem::CreateExtensions(
     content::RenderProcessHost* host,
     extensions::XWalkExtensionVector* extensions) {
-  Application* application =
-    application_service_->GetApplicationByRenderHostID(host->GetID());
-  if (!application)
+  if (application_service_->GetApplicationIDByRenderHostID(
+          host->GetID()).empty())
     return;  // We might be in browser mode.
 
-  extensions->push_back(new ApplicationRuntimeExtension(application));
-  extensions->push_back(new ApplicationWidgetExtension(application));
+  extensions->push_back(new ApplicationRuntimeExtension(
+      application_service_.get(), memory_monitor_.get(), host->GetID()));
+  extensions->push_back(new ApplicationWidgetExtension(
+      application_service_.get(), host->GetID()));
 }
 
 }  // namespace application
@@ -28,6 +28,7 @@ class RuntimeContext;
 namespace xwalk {
 namespace application {
 
+class ApplicationMemoryMonitor;
 class ApplicationService;
 class ApplicationServiceProvider;
 class ApplicationStorage;
@@ -51,6 +52,10 @@ class ApplicationSystem {
     return application_storage_.get();
   }
 
+  ApplicationMemoryMonitor* memory_monitor() {
+    return memory_monitor_.get();
+  }
+
   // Launches an application based on the given command line, there are
   // different ways to inform which application should be launched
   //
@@ -82,6 +87,7 @@ class ApplicationSystem {
   xwalk::RuntimeContext* runtime_context_;
   scoped_ptr<ApplicationStorage> application_storage_;
   scoped_ptr<ApplicationService> application_service_;
+  scoped_ptr<ApplicationMemoryMonitor> memory_monitor_;
 
   DISALLOW_COPY_AND_ASSIGN(ApplicationSystem);
 };
@@ -15,9 +15,9 @@ namespace application {
 ApplicationSystemLinux::ApplicationSystemLinux(RuntimeContext* runtime_context)
     : ApplicationSystem(runtime_context) {
 #if defined(SHARED_PROCESS_MODE)
-    service_provider_.reset(
-        new ApplicationServiceProviderLinux(application_service(),
-                                            dbus_manager().session_bus()));
+    service_provider_.reset(new ApplicationServiceProviderLinux(
+        application_service(), memory_monitor(), dbus_manager().session_bus(),
+        dbus_manager().method_dispatcher()));
 #endif
 }
 
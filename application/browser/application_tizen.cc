@@ -8,17 +8,23 @@
 #include <string>
 #include <vector>
 
+#include "base/bind.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/browser/storage_partition.h"
 #include "content/browser/screen_orientation/screen_orientation_dispatcher_host.h"
 #include "content/browser/screen_orientation/screen_orientation_provider.h"
+#include "net/cookies/cookie_monster.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
 
 #include "xwalk/runtime/browser/ui/native_app_window.h"
 #include "xwalk/runtime/browser/ui/native_app_window_tizen.h"
 #include "xwalk/runtime/common/xwalk_common_messages.h"
 
 #if defined(USE_OZONE)
-#include "content/public/browser/render_view_host.h"
 #include "ui/events/event.h"
 #include "ui/events/event_constants.h"
 #include "ui/events/keycodes/keyboard_codes_posix.h"
@@ -35,6 +41,20 @@ namespace widget_keys = application_widget_keys;
 
 namespace application {
 
+namespace {
+
+// The cookie changes are held back to be written in batches, commit them
+// before the suspended application gets killed.
+void FlushCookieStoreOnIOThread(
+    const scoped_refptr<net::URLRequestContextGetter>& getter) {
+  net::CookieMonster* cookie_monster =
+      getter->GetURLRequestContext()->cookie_store()->GetCookieMonster();
+  if (cookie_monster)
+    cookie_monster->FlushStore(base::Closure());
+}
+
+}  // namespace
+
 class ScreenOrientationProviderTizen :
     public content::ScreenOrientationProvider {
  public:
@@ -118,6 +138,11 @@ void ApplicationTizen::Suspend() {
 
   DCHECK(render_process_host_);
   render_process_host_->Send(new ViewMsg_SuspendJSEngine(true));
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&FlushCookieStoreOnIOThread,
+                 make_scoped_refptr(render_process_host_->GetStoragePartition()
+                                        ->GetURLRequestContext())));
 
   DCHECK(!runtimes_.empty());
   std::set<Runtime*>::iterator it = runtimes_.begin();
@@ -144,6 +169,15 @@ void ApplicationTizen::Resume() {
   is_suspended_ = false;
 }
 
+void ApplicationTizen::SetLocale(const std::string& locale) {
+  data()->SetManifestLocale(locale);
+  for (std::set<xwalk::Runtime*>::iterator it = runtimes_.begin();
+      it != runtimes_.end(); ++it) {
+    (*it)->web_contents()->GetRenderViewHost()->Send(new ViewMsg_LocaleChanged(
+        (*it)->web_contents()->GetRoutingID(), locale));
+  }
+}
+
 #if defined(USE_OZONE)
 void ApplicationTizen::WillProcessEvent(const ui::PlatformEvent& event) {}
 
@@ -26,6 +26,12 @@ class ApplicationTizen :  // NOLINT
   void Suspend();
   void Resume();
 
+  // Lets the application follow a change of the system locale without
+  // being reloaded: the localized manifest values are resolved for
+  // |locale| and the pages get a "languagechange" event. The app://
+  // resources are always looked up for the current system locale.
+  void SetLocale(const std::string& locale);
+
  private:
   // We enforce ApplicationService ownership.
   friend class ApplicationService;
@@ -11,13 +11,16 @@
 #include "dbus/bus.h"
 #include "dbus/message.h"
 #include "dbus/exported_object.h"
+#include "xwalk/application/browser/application_memory_monitor.h"
 #include "xwalk/application/browser/application_tizen.h"
 #include "xwalk/application/browser/linux/running_applications_manager.h"
+#include "xwalk/dbus/method_dispatcher.h"
 
 namespace {
 
 // D-Bus Interface implemented by objects that represent running
-// applications.
+// applications. Its methods are called by the launcher, they are dispatched
+// before the other calls waiting on the UI thread.
 //
 // Methods:
 //
@@ -28,6 +31,11 @@ namespace {
 // Properties:
 //
 //   readonly string AppID
+//
+//   readonly int32 MemoryPSS, MemoryUSS
+//   readonly int32 RendererPSS, ExtensionProcessPSS
+//     The memory used by the processes of the application in KB, updated
+//     every time it is sampled. They appear with the first sample.
 const char kRunningApplicationDBusInterface[] =
     "org.crosswalkproject.Running.Application1";
 
@@ -42,6 +50,7 @@ namespace application {
 
 RunningApplicationObject::RunningApplicationObject(
     scoped_refptr<dbus::Bus> bus,
+    MethodDispatcher* method_dispatcher,
     const std::string& app_id,
     const std::string& launcher_name,
     Application* application)
@@ -55,37 +64,40 @@ RunningApplicationObject::RunningApplicationObject(
       kRunningApplicationDBusInterface, "AppID",
       scoped_ptr<base::Value>(base::Value::CreateStringValue(app_id)));
 
-  dbus_object()->ExportMethod(
-      kRunningApplicationDBusInterface, "Terminate",
+  method_dispatcher->SetPolicy(kRunningApplicationDBusInterface, "",
+                               MethodDispatcher::PRIORITY);
+
+  method_dispatcher->ExportMethod(
+      dbus_object(), kRunningApplicationDBusInterface, "Terminate",
       base::Bind(&RunningApplicationObject::OnTerminate,
                  base::Unretained(this)),
       base::Bind(&RunningApplicationObject::OnExported,
                  base::Unretained(this)));
 
-  dbus_object()->ExportMethod(
-      kRunningApplicationDBusInterface, "GetEPChannel",
+  method_dispatcher->ExportMethod(
+      dbus_object(), kRunningApplicationDBusInterface, "GetEPChannel",
       base::Bind(&RunningApplicationObject::OnGetExtensionProcessChannel,
                  base::Unretained(this)),
       base::Bind(&RunningApplicationObject::OnExported,
                  base::Unretained(this)));
 
 #if defined(OS_TIZEN)
-  dbus_object()->ExportMethod(
-      kRunningApplicationDBusInterface, "Hide",
+  method_dispatcher->ExportMethod(
+      dbus_object(), kRunningApplicationDBusInterface, "Hide",
       base::Bind(&RunningApplicationObject::OnHide,
                  base::Unretained(this)),
       base::Bind(&RunningApplicationObject::OnExported,
                  base::Unretained(this)));
 
-  dbus_object()->ExportMethod(
-      kRunningApplicationDBusInterface, "Suspend",
+  method_dispatcher->ExportMethod(
+      dbus_object(), kRunningApplicationDBusInterface, "Suspend",
       base::Bind(&RunningApplicationObject::OnSuspend,
                  base::Unretained(this)),
       base::Bind(&RunningApplicationObject::OnExported,
                  base::Unretained(this)));
 
-  dbus_object()->ExportMethod(
-      kRunningApplicationDBusInterface, "Resume",
+  method_dispatcher->ExportMethod(
+      dbus_object(), kRunningApplicationDBusInterface, "Resume",
       base::Bind(&RunningApplicationObject::OnResume,
                  base::Unretained(this)),
       base::Bind(&RunningApplicationObject::OnExported,
@@ -252,6 +264,29 @@ void RunningApplicationObject::SendChannel(
   response_sender.Run(response.Pass());
 }
 
+void RunningApplicationObject::UpdateMemoryUsage(
+    const ApplicationMemoryUsage& usage) {
+  // A single PropertiesChanged for all of them.
+  properties()->BeginUpdate();
+  properties()->Set(
+      kRunningApplicationDBusInterface, "MemoryPSS",
+      scoped_ptr<base::Value>(base::Value::CreateIntegerValue(
+          static_cast<int>(usage.total.pss))));
+  properties()->Set(
+      kRunningApplicationDBusInterface, "MemoryUSS",
+      scoped_ptr<base::Value>(base::Value::CreateIntegerValue(
+          static_cast<int>(usage.total.uss))));
+  properties()->Set(
+      kRunningApplicationDBusInterface, "RendererPSS",
+      scoped_ptr<base::Value>(base::Value::CreateIntegerValue(
+          static_cast<int>(usage.renderer.pss))));
+  properties()->Set(
+      kRunningApplicationDBusInterface, "ExtensionProcessPSS",
+      scoped_ptr<base::Value>(base::Value::CreateIntegerValue(
+          static_cast<int>(usage.extension_process.pss))));
+  properties()->Commit();
+}
+
 void RunningApplicationObject::ExtensionProcessCreated(
     const IPC::ChannelHandle& handle) {
   ep_bp_channel_ = handle;
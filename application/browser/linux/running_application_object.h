@@ -17,8 +17,13 @@ class FileDescriptor;
 }
 
 namespace xwalk {
+
+class MethodDispatcher;
+
 namespace application {
 
+struct ApplicationMemoryUsage;
+
 // Represents the running application inside D-Bus hierarchy of
 // RunningApplicationsManager.
 //
@@ -28,6 +33,7 @@ namespace application {
 class RunningApplicationObject : public dbus::ManagedObject {
  public:
   RunningApplicationObject(scoped_refptr<dbus::Bus> bus,
+                           MethodDispatcher* method_dispatcher,
                            const std::string& app_id,
                            const std::string& launcher_name,
                            Application* application);
@@ -36,6 +42,9 @@ class RunningApplicationObject : public dbus::ManagedObject {
 
   void ExtensionProcessCreated(const IPC::ChannelHandle& handle);
 
+  // Updates the memory properties, see ApplicationMemoryMonitor.
+  void UpdateMemoryUsage(const ApplicationMemoryUsage& usage);
+
  private:
   void TerminateApplication();
 
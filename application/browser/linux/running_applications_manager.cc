@@ -11,6 +11,8 @@
 
 #include "xwalk/application/browser/linux/running_application_object.h"
 #include "xwalk/application/common/application_data.h"
+#include "xwalk/dbus/method_dispatcher.h"
+#include "xwalk/runtime/browser/runtime_metrics.h"
 
 namespace {
 
@@ -19,7 +21,20 @@ namespace {
 // Methods:
 //
 //   Launch(string app_id) -> ObjectPath
-//     Launches the application with 'app_id'.
+//     Launches the application with 'app_id'. Dispatched before the other
+//     calls waiting on the UI thread.
+//
+//   GetMetrics() -> string
+//     Returns the histograms of the runtime, see RuntimeMetrics.
+//
+// Signals:
+//
+//   ApplicationHibernated(string app_id)
+//   ApplicationResumed(string app_id)
+//   ApplicationEvicted(string app_id)
+//     An application hidden for long was hibernated to stay within the
+//     process budget, then shown again before being terminated, or about to
+//     be terminated. See ApplicationProcessManager.
 const char kRunningManagerDBusInterface[] =
     "org.crosswalkproject.Running.Manager1";
 
@@ -52,28 +67,48 @@ dbus::ObjectPath GetRunningPathForAppID(const std::string& app_id) {
 }
 
 RunningApplicationsManager::RunningApplicationsManager(
-    scoped_refptr<dbus::Bus> bus, ApplicationService* service)
+    scoped_refptr<dbus::Bus> bus, MethodDispatcher* method_dispatcher,
+    ApplicationService* service, ApplicationMemoryMonitor* memory_monitor)
     : weak_factory_(this),
+      method_dispatcher_(method_dispatcher),
       application_service_(service),
+      memory_monitor_(memory_monitor),
       adaptor_(bus, kRunningManagerDBusPath) {
   application_service_->AddObserver(this);
+  memory_monitor_->AddObserver(this);
+  application_service_->process_manager()->AddObserver(this);
 
-  adaptor_.manager_object()->ExportMethod(
-      kRunningManagerDBusInterface, "Launch",
+  // The launcher is waiting for it, and so is the user.
+  method_dispatcher_->SetPolicy(kRunningManagerDBusInterface, "Launch",
+                                MethodDispatcher::PRIORITY);
+
+  method_dispatcher_->ExportMethod(
+      adaptor_.manager_object(), kRunningManagerDBusInterface, "Launch",
       base::Bind(&RunningApplicationsManager::OnLaunch,
                  weak_factory_.GetWeakPtr()),
       base::Bind(&RunningApplicationsManager::OnExported,
                  weak_factory_.GetWeakPtr()));
 
-  adaptor_.manager_object()->ExportMethod(
-      kRunningManagerDBusInterface, "TerminateIfRunning",
+  method_dispatcher_->ExportMethod(
+      adaptor_.manager_object(), kRunningManagerDBusInterface,
+      "TerminateIfRunning",
       base::Bind(&RunningApplicationsManager::OnTerminateIfRunning,
                  weak_factory_.GetWeakPtr()),
       base::Bind(&RunningApplicationsManager::OnExported,
                  weak_factory_.GetWeakPtr()));
+
+  method_dispatcher_->ExportMethod(
+      adaptor_.manager_object(), kRunningManagerDBusInterface, "GetMetrics",
+      base::Bind(&RunningApplicationsManager::OnGetMetrics,
+                 weak_factory_.GetWeakPtr()),
+      base::Bind(&RunningApplicationsManager::OnExported,
+                 weak_factory_.GetWeakPtr()));
 }
 
-RunningApplicationsManager::~RunningApplicationsManager() {}
+RunningApplicationsManager::~RunningApplicationsManager() {
+  memory_monitor_->RemoveObserver(this);
+  application_service_->process_manager()->RemoveObserver(this);
+}
 
 RunningApplicationObject* RunningApplicationsManager::GetRunningApp(
     const std::string& app_id) {
@@ -185,6 +220,28 @@ void RunningApplicationsManager::OnTerminateIfRunning(
   response_sender.Run(response.Pass());
 }
 
+namespace {
+
+void SendMetrics(dbus::MethodCall* method_call,
+                 dbus::ExportedObject::ResponseSender response_sender,
+                 const std::string& json) {
+  scoped_ptr<dbus::Response> response =
+      dbus::Response::FromMethodCall(method_call);
+  dbus::MessageWriter writer(response.get());
+  writer.AppendString(json);
+  response_sender.Run(response.Pass());
+}
+
+}  // namespace
+
+void RunningApplicationsManager::OnGetMetrics(
+    dbus::MethodCall* method_call,
+    dbus::ExportedObject::ResponseSender response_sender) {
+  // The method call stays alive until the response is sent.
+  RuntimeMetrics::CollectAsJSON(
+      base::Bind(&SendMetrics, method_call, response_sender));
+}
+
 void RunningApplicationsManager::OnExported(
     const std::string& interface_name,
     const std::string& method_name,
@@ -202,11 +259,39 @@ void RunningApplicationsManager::WillDestroyApplication(Application* app) {
   adaptor_.RemoveManagedObject(path);
 }
 
+void RunningApplicationsManager::OnMemoryUsageSampled(
+    Application* app, const ApplicationMemoryUsage& usage) {
+  // Applications not launched through D-Bus have no object.
+  RunningApplicationObject* object = GetRunningApp(app->id());
+  if (object)
+    object->UpdateMemoryUsage(usage);
+}
+
+void RunningApplicationsManager::OnApplicationHibernated(Application* app) {
+  SendProcessBudgetSignal("ApplicationHibernated", app);
+}
+
+void RunningApplicationsManager::OnApplicationResumed(Application* app) {
+  SendProcessBudgetSignal("ApplicationResumed", app);
+}
+
+void RunningApplicationsManager::OnApplicationEvicted(Application* app) {
+  SendProcessBudgetSignal("ApplicationEvicted", app);
+}
+
+void RunningApplicationsManager::SendProcessBudgetSignal(
+    const std::string& signal_name, Application* app) {
+  dbus::Signal signal(kRunningManagerDBusInterface, signal_name);
+  dbus::MessageWriter writer(&signal);
+  writer.AppendString(app->id());
+  adaptor_.manager_object()->SendSignal(&signal);
+}
+
 dbus::ObjectPath RunningApplicationsManager::AddObject(
     const std::string& app_id, const std::string& launcher_name,
     Application* application) {
   scoped_ptr<RunningApplicationObject> running_application(
-      new RunningApplicationObject(adaptor_.bus(), app_id,
+      new RunningApplicationObject(adaptor_.bus(), method_dispatcher_, app_id,
                                    launcher_name, application));
 
   dbus::ObjectPath path = running_application->path();
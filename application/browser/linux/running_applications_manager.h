@@ -9,10 +9,15 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
+#include "xwalk/application/browser/application_memory_monitor.h"
+#include "xwalk/application/browser/application_process_manager.h"
 #include "xwalk/application/browser/application_service.h"
 #include "xwalk/dbus/object_manager_adaptor.h"
 
 namespace xwalk {
+
+class MethodDispatcher;
+
 namespace application {
 
 class RunningApplicationObject;
@@ -27,10 +32,14 @@ dbus::ObjectPath GetRunningPathForAppID(const std::string& app_id);
 // The exported object implements org.freedesktop.DBus.ObjectManager, and the
 // interface org.crosswalkproject.Installed.Manager1 (see .cc file for
 // description).
-class RunningApplicationsManager : public ApplicationService::Observer {
+class RunningApplicationsManager : public ApplicationService::Observer,
+                                   public ApplicationMemoryMonitor::Observer,
+                                   public ApplicationProcessManager::Observer {
  public:
   RunningApplicationsManager(scoped_refptr<dbus::Bus> bus,
-                             ApplicationService* service);
+                             MethodDispatcher* method_dispatcher,
+                             ApplicationService* service,
+                             ApplicationMemoryMonitor* memory_monitor);
   virtual ~RunningApplicationsManager();
 
   RunningApplicationObject* GetRunningApp(const std::string& app_id);
@@ -41,6 +50,8 @@ class RunningApplicationsManager : public ApplicationService::Observer {
                 dbus::ExportedObject::ResponseSender response_sender);
   void OnTerminateIfRunning(dbus::MethodCall* method_call,
       dbus::ExportedObject::ResponseSender response_sender);
+  void OnGetMetrics(dbus::MethodCall* method_call,
+                    dbus::ExportedObject::ResponseSender response_sender);
 
   void OnExported(const std::string& interface_name,
                   const std::string& method_name,
@@ -48,12 +59,26 @@ class RunningApplicationsManager : public ApplicationService::Observer {
 
   void virtual WillDestroyApplication(Application* app) OVERRIDE;
 
+  // ApplicationMemoryMonitor::Observer implementation.
+  virtual void OnMemoryUsageSampled(
+      Application* app, const ApplicationMemoryUsage& usage) OVERRIDE;
+
+  // ApplicationProcessManager::Observer implementation.
+  virtual void OnApplicationHibernated(Application* app) OVERRIDE;
+  virtual void OnApplicationResumed(Application* app) OVERRIDE;
+  virtual void OnApplicationEvicted(Application* app) OVERRIDE;
+
+  void SendProcessBudgetSignal(const std::string& signal_name,
+                               Application* app);
+
   dbus::ObjectPath AddObject(const std::string& app_id,
                              const std::string& launcher_name,
                              Application* application);
 
   base::WeakPtrFactory<RunningApplicationsManager> weak_factory_;
+  MethodDispatcher* method_dispatcher_;
   ApplicationService* application_service_;
+  ApplicationMemoryMonitor* memory_monitor_;
   dbus::ObjectManagerAdaptor adaptor_;
 };
 
@@ -0,0 +1,58 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/access_whitelist.h"
+
+namespace xwalk {
+namespace application {
+
+AccessWhitelist::AccessWhitelist()
+    : size_(0) {
+}
+
+AccessWhitelist::~AccessWhitelist() {
+}
+
+bool AccessWhitelist::AddEntry(const GURL& url, bool subdomains) {
+  int& rules = schemes_[url.scheme()][url.host()];
+  const int rule = subdomains ? HOST_SUBDOMAINS : HOST_EXACT;
+  if (rules & rule)
+    return false;
+  rules |= rule;
+  ++size_;
+  return true;
+}
+
+bool AccessWhitelist::IsAllowed(const GURL& url) const {
+  SchemeMap::const_iterator scheme = schemes_.find(url.scheme());
+  if (scheme == schemes_.end())
+    return false;
+  const HostMap& hosts = scheme->second;
+
+  // Both kinds of entries match their own host.
+  const std::string& host = url.host();
+  if (hosts.find(host) != hosts.end())
+    return true;
+
+  // Then every parent domain, as GURL::DomainIs() would match them. The
+  // trailing dot of a fully qualified host is ignored.
+  std::string domain = host;
+  if (!domain.empty() && domain[domain.size() - 1] == '.') {
+    domain.resize(domain.size() - 1);
+    HostMap::const_iterator it = hosts.find(domain);
+    if (it != hosts.end() && (it->second & HOST_SUBDOMAINS))
+      return true;
+  }
+
+  for (size_t dot = domain.find('.'); dot != std::string::npos;
+       dot = domain.find('.', dot + 1)) {
+    HostMap::const_iterator it = hosts.find(domain.substr(dot + 1));
+    if (it != hosts.end() && (it->second & HOST_SUBDOMAINS))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace application
+}  // namespace xwalk
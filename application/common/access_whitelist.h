@@ -0,0 +1,61 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_COMMON_ACCESS_WHITELIST_H_
+#define XWALK_APPLICATION_COMMON_ACCESS_WHITELIST_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "url/gurl.h"
+
+namespace xwalk {
+namespace application {
+
+// The WARP <access> and CSP origins an application is allowed to reach,
+// compiled so a lookup costs one hash probe per label of the requested host
+// instead of a comparison with every entry. Used by SecurityPolicy in the
+// browser and by the render process observer to short-circuit
+// WillSendRequest.
+//
+// As for the linear list it replaces, ports are not taken into account: an
+// entry matches any port of its scheme and host.
+class AccessWhitelist {
+ public:
+  AccessWhitelist();
+  ~AccessWhitelist();
+
+  // Returns false if the same entry was already added.
+  bool AddEntry(const GURL& url, bool subdomains);
+
+  // Whether |url| has the scheme of an entry and either the very same host,
+  // or a host inside the domain of an entry allowing subdomains.
+  bool IsAllowed(const GURL& url) const;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  enum HostRule {
+    HOST_EXACT = 1 << 0,
+    HOST_SUBDOMAINS = 1 << 1
+  };
+
+  // Host to a combination of HostRule flags.
+  typedef base::hash_map<std::string, int> HostMap;
+  // Few schemes are ever used, a small ordered map is enough.
+  typedef std::map<std::string, HostMap> SchemeMap;
+
+  SchemeMap schemes_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(AccessWhitelist);
+};
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_COMMON_ACCESS_WHITELIST_H_
@@ -0,0 +1,53 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/access_whitelist.h"
+
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+const int kEntryCount = 500;
+const int kLookupCount = 100000;
+
+}  // namespace
+
+TEST(AccessWhitelistPerfTest, Lookup) {
+  AccessWhitelist whitelist;
+  for (int i = 0; i < kEntryCount; ++i) {
+    whitelist.AddEntry(
+        GURL(base::StringPrintf("http://host%d.example.com", i)), i % 2 == 0);
+  }
+
+  // Half of the requests are denied, they are the worst case of the lookup.
+  std::vector<GURL> urls;
+  for (int i = 0; i < kEntryCount * 2; ++i) {
+    urls.push_back(GURL(base::StringPrintf(
+        "http://cdn.host%d.example.com/script.js", i)));
+  }
+
+  int allowed = 0;
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kLookupCount; ++i) {
+    if (whitelist.IsAllowed(urls[i % urls.size()]))
+      ++allowed;
+  }
+  perf_test::PrintResult(
+      "access_whitelist_lookup", "",
+      base::StringPrintf("%d_entries", kEntryCount),
+      timer.Elapsed().InMicroseconds() / static_cast<double>(kLookupCount),
+      "us", true);
+  EXPECT_EQ(kLookupCount / 4, allowed);
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,69 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/access_whitelist.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace xwalk {
+namespace application {
+
+TEST(AccessWhitelistTest, ExactHost) {
+  AccessWhitelist whitelist;
+  EXPECT_TRUE(whitelist.empty());
+  EXPECT_TRUE(whitelist.AddEntry(GURL("http://example.com"), false));
+  EXPECT_FALSE(whitelist.AddEntry(GURL("http://example.com/path"), false));
+  EXPECT_EQ(1u, whitelist.size());
+
+  EXPECT_TRUE(whitelist.IsAllowed(GURL("http://example.com/index.html")));
+  // Ports are ignored, as by the linear matching this replaced.
+  EXPECT_TRUE(whitelist.IsAllowed(GURL("http://example.com:8080/")));
+  EXPECT_FALSE(whitelist.IsAllowed(GURL("https://example.com/")));
+  EXPECT_FALSE(whitelist.IsAllowed(GURL("http://www.example.com/")));
+  EXPECT_FALSE(whitelist.IsAllowed(GURL("http://example.org/")));
+}
+
+TEST(AccessWhitelistTest, Subdomains) {
+  AccessWhitelist whitelist;
+  EXPECT_TRUE(whitelist.AddEntry(GURL("https://example.com"), true));
+  // The same host may be listed both ways.
+  EXPECT_TRUE(whitelist.AddEntry(GURL("https://example.com"), false));
+  EXPECT_EQ(2u, whitelist.size());
+
+  EXPECT_TRUE(whitelist.IsAllowed(GURL("https://example.com/")));
+  EXPECT_TRUE(whitelist.IsAllowed(GURL("https://a.b.example.com/")));
+  EXPECT_TRUE(whitelist.IsAllowed(GURL("https://www.example.com./")));
+  EXPECT_FALSE(whitelist.IsAllowed(GURL("https://badexample.com/")));
+  EXPECT_FALSE(whitelist.IsAllowed(GURL("https://example.com.evil.org/")));
+  EXPECT_FALSE(whitelist.IsAllowed(GURL("http://www.example.com/")));
+}
+
+TEST(AccessWhitelistTest, MatchesDomainIs) {
+  const char* entries[] = {
+    "http://intel.com", "http://01.org", "https://tizen.org",
+  };
+  const char* urls[] = {
+    "http://intel.com/", "http://www.intel.com/", "http://intel.com./",
+    "http://xintel.com/", "http://download.01.org/", "https://tizen.org/",
+    "http://tizen.org/", "https://wiki.tizen.org:443/", "http://org/",
+  };
+
+  AccessWhitelist whitelist;
+  for (size_t i = 0; i < arraysize(entries); ++i)
+    whitelist.AddEntry(GURL(entries[i]), true);
+
+  for (size_t i = 0; i < arraysize(urls); ++i) {
+    const GURL url(urls[i]);
+    bool expected = false;
+    for (size_t j = 0; j < arraysize(entries); ++j) {
+      const GURL policy(entries[j]);
+      expected |= url.scheme() == policy.scheme() &&
+          url.DomainIs(policy.host().c_str());
+    }
+    EXPECT_EQ(expected, whitelist.IsAllowed(url)) << urls[i];
+  }
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,306 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/application_archive.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/threading/thread_restrictions.h"
+#include "third_party/zlib/zlib.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+const uint32 kEndOfCentralDirectorySignature = 0x06054b50;
+const uint32 kCentralDirectoryHeaderSignature = 0x02014b50;
+const uint32 kLocalFileHeaderSignature = 0x04034b50;
+
+const size_t kEndOfCentralDirectorySize = 22;
+const size_t kCentralDirectoryHeaderSize = 46;
+const size_t kLocalFileHeaderSize = 30;
+const size_t kMaxCommentSize = 0xffff;
+
+const uint16 kMethodStored = 0;
+const uint16 kMethodDeflated = 8;
+const uint16 kFlagEncrypted = 1;
+
+// What's inflated before the requested range of deflated entries goes
+// through a buffer of that size.
+const int kSkipBufferSize = 4096;
+
+uint16 ReadUInt16(const uint8* data) {
+  return data[0] | (data[1] << 8);
+}
+
+uint32 ReadUInt32(const uint8* data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) |
+      (static_cast<uint32>(data[3]) << 24);
+}
+
+}  // namespace
+
+ApplicationArchive::EntryReader::EntryReader(
+    const ApplicationArchive* archive,
+    const uint8* content,
+    uint32 content_size,
+    int64 offset,
+    int64 length)
+    : archive_(archive),
+      content_(content),
+      content_size_(content_size),
+      position_(offset),
+      remaining_(length) {
+}
+
+ApplicationArchive::EntryReader::~EntryReader() {
+  if (stream_)
+    inflateEnd(stream_.get());
+}
+
+int ApplicationArchive::EntryReader::Read(char* buffer, int size) {
+  base::ThreadRestrictions::AssertIOAllowed();
+  if (!remaining_ || size <= 0)
+    return 0;
+  size = static_cast<int>(std::min<int64>(size, remaining_));
+
+  if (stream_) {
+    size = Inflate(buffer, size);
+    if (size < 0)
+      return -1;
+  } else {
+    memcpy(buffer, content_ + position_, size);
+    position_ += size;
+  }
+  remaining_ -= size;
+  return size;
+}
+
+bool ApplicationArchive::EntryReader::StartInflating(int64 offset) {
+  stream_.reset(new z_stream());
+  // Zip entries are raw deflate streams, without zlib header.
+  if (inflateInit2(stream_.get(), -MAX_WBITS) != Z_OK) {
+    stream_.reset();
+    return false;
+  }
+  stream_->next_in = const_cast<Bytef*>(content_);
+  stream_->avail_in = content_size_;
+
+  char skipped[kSkipBufferSize];
+  while (offset > 0) {
+    const int result =
+        Inflate(skipped, static_cast<int>(std::min<int64>(offset,
+                                                          kSkipBufferSize)));
+    if (result < 0)
+      return false;
+    offset -= result;
+  }
+  return true;
+}
+
+int ApplicationArchive::EntryReader::Inflate(char* buffer, int size) {
+  stream_->next_out = reinterpret_cast<Bytef*>(buffer);
+  stream_->avail_out = size;
+  const int result = inflate(stream_.get(), Z_SYNC_FLUSH);
+  const int inflated = size - stream_->avail_out;
+  // The entry ending before its recorded size is corrupted as well.
+  if ((result != Z_OK && result != Z_STREAM_END) || !inflated)
+    return -1;
+  return inflated;
+}
+
+ApplicationArchive::ApplicationArchive(const base::FilePath& path)
+    : path_(path),
+      opened_(false),
+      valid_(false),
+      base_offset_(0) {
+}
+
+ApplicationArchive::~ApplicationArchive() {
+}
+
+bool ApplicationArchive::Open() {
+  base::ThreadRestrictions::AssertIOAllowed();
+  base::AutoLock lock(lock_);
+  if (opened_)
+    return valid_;
+  opened_ = true;
+
+  if (!base::PathExists(path_))
+    return false;
+  if (!file_.Initialize(path_)) {
+    LOG(ERROR) << "Can't map the application archive " << path_.value();
+    return false;
+  }
+  valid_ = ReadCentralDirectory();
+  if (!valid_) {
+    LOG(ERROR) << "Invalid application archive " << path_.value();
+    entries_.clear();
+  }
+  return valid_;
+}
+
+bool ApplicationArchive::HasEntry(const std::string& name) const {
+  base::AutoLock lock(lock_);
+  return entries_.find(name) != entries_.end();
+}
+
+bool ApplicationArchive::ReadEntry(const std::string& name,
+                                   std::string* data) const {
+  return ReadEntryRange(name, 0, -1, data);
+}
+
+bool ApplicationArchive::GetEntrySize(const std::string& name,
+                                      int64* size) const {
+  base::AutoLock lock(lock_);
+  EntryMap::const_iterator it = entries_.find(name);
+  if (it == entries_.end())
+    return false;
+  *size = it->second.uncompressed_size;
+  return true;
+}
+
+bool ApplicationArchive::ReadEntryRange(const std::string& name,
+                                        int64 offset,
+                                        int64 length,
+                                        std::string* data) const {
+  scoped_ptr<EntryReader> reader(OpenEntry(name, offset, length));
+  if (!reader)
+    return false;
+
+  data->resize(reader->remaining());
+  size_t read = 0;
+  while (reader->remaining()) {
+    const int result = reader->Read(
+        &(*data)[read],
+        static_cast<int>(std::min<int64>(reader->remaining(), kint32max)));
+    if (result <= 0)
+      return false;
+    read += result;
+  }
+  return true;
+}
+
+scoped_ptr<ApplicationArchive::EntryReader> ApplicationArchive::OpenEntry(
+    const std::string& name, int64 offset, int64 length) const {
+  base::ThreadRestrictions::AssertIOAllowed();
+  Entry entry;
+  {
+    base::AutoLock lock(lock_);
+    EntryMap::const_iterator it = entries_.find(name);
+    if (it == entries_.end())
+      return scoped_ptr<EntryReader>();
+    entry = it->second;
+  }
+  if (offset < 0 || offset > entry.uncompressed_size)
+    return scoped_ptr<EntryReader>();
+  if (length < 0 || offset + length > entry.uncompressed_size)
+    length = entry.uncompressed_size - offset;
+
+  // The mapping doesn't change once opened, no need to lock from here.
+  const uint8* file_data = file_.data();
+  const size_t file_size = file_.length();
+  size_t data_offset = base_offset_ + entry.local_header_offset;
+  if (data_offset + kLocalFileHeaderSize > file_size ||
+      ReadUInt32(file_data + data_offset) != kLocalFileHeaderSignature)
+    return scoped_ptr<EntryReader>();
+  data_offset += kLocalFileHeaderSize +
+      ReadUInt16(file_data + data_offset + 26) +
+      ReadUInt16(file_data + data_offset + 28);
+  if (data_offset + entry.compressed_size > file_size)
+    return scoped_ptr<EntryReader>();
+  if (entry.method == kMethodStored &&
+      entry.compressed_size != entry.uncompressed_size)
+    return scoped_ptr<EntryReader>();
+
+  scoped_ptr<EntryReader> reader(new EntryReader(
+      this, file_data + data_offset, entry.compressed_size, offset, length));
+  if (entry.method == kMethodDeflated && !reader->StartInflating(offset))
+    return scoped_ptr<EntryReader>();
+  return reader.Pass();
+}
+
+size_t ApplicationArchive::entry_count() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+bool ApplicationArchive::is_opened() const {
+  base::AutoLock lock(lock_);
+  return opened_;
+}
+
+bool ApplicationArchive::is_valid() const {
+  base::AutoLock lock(lock_);
+  return valid_;
+}
+
+bool ApplicationArchive::ReadCentralDirectory() {
+  lock_.AssertAcquired();
+  const uint8* data = file_.data();
+  const size_t size = file_.length();
+  if (size < kEndOfCentralDirectorySize)
+    return false;
+
+  // The end of central directory record is followed by a comment of up to
+  // 64 KB, look for its signature backwards.
+  size_t end_offset = size - kEndOfCentralDirectorySize;
+  const size_t min_end_offset =
+      end_offset > kMaxCommentSize ? end_offset - kMaxCommentSize : 0;
+  while (ReadUInt32(data + end_offset) != kEndOfCentralDirectorySignature) {
+    if (end_offset == min_end_offset)
+      return false;
+    --end_offset;
+  }
+
+  const uint16 entry_count = ReadUInt16(data + end_offset + 10);
+  const uint32 directory_size = ReadUInt32(data + end_offset + 12);
+  const uint32 directory_offset = ReadUInt32(data + end_offset + 16);
+  if (static_cast<uint64>(directory_offset) + directory_size > end_offset)
+    return false;
+  // Whatever comes before the zip content (e.g. the XPK header) shifts all
+  // the offsets stored in the archive.
+  base_offset_ = end_offset - directory_size - directory_offset;
+
+  size_t offset = base_offset_ + directory_offset;
+  for (uint16 i = 0; i < entry_count; ++i) {
+    if (offset + kCentralDirectoryHeaderSize > end_offset ||
+        ReadUInt32(data + offset) != kCentralDirectoryHeaderSignature)
+      return false;
+    const uint8* header = data + offset;
+    const uint16 name_length = ReadUInt16(header + 28);
+    const size_t header_size = kCentralDirectoryHeaderSize + name_length +
+        ReadUInt16(header + 30) + ReadUInt16(header + 32);
+    if (offset + header_size > end_offset)
+      return false;
+    offset += header_size;
+
+    std::string name(
+        reinterpret_cast<const char*>(header + kCentralDirectoryHeaderSize),
+        name_length);
+    if (name.empty() || name[name.size() - 1] == '/')
+      continue;
+
+    Entry entry;
+    entry.method = ReadUInt16(header + 10);
+    entry.compressed_size = ReadUInt32(header + 20);
+    entry.uncompressed_size = ReadUInt32(header + 24);
+    entry.local_header_offset = ReadUInt32(header + 42);
+    if (ReadUInt16(header + 8) & kFlagEncrypted ||
+        (entry.method != kMethodStored && entry.method != kMethodDeflated)) {
+      LOG(WARNING) << "Unsupported archive entry " << name;
+      continue;
+    }
+    entries_[name] = entry;
+  }
+  return true;
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,140 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_COMMON_APPLICATION_ARCHIVE_H_
+#define XWALK_APPLICATION_COMMON_APPLICATION_ARCHIVE_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+
+struct z_stream_s;
+
+namespace xwalk {
+namespace application {
+
+// Read-only access to the entries of a packaged application (XPK or WGT)
+// kept as is on disk. The file is memory-mapped and its zip central
+// directory indexed once, entries are then read without any further
+// open() or seek. Stored entries are copied straight from the mapping,
+// deflated ones are inflated on the fly. Big entries, typically media, are
+// best read through an EntryReader, which never holds them in memory as a
+// whole.
+//
+// Open() and ReadEntry() block and must be called on a thread allowing IO.
+// Everything is thread-safe.
+class ApplicationArchive
+    : public base::RefCountedThreadSafe<ApplicationArchive> {
+ public:
+  // Reads a range of an entry sequentially, a chunk at a time. Keeps the
+  // archive alive. Read() blocks like ReadEntry(), a reader can be used from
+  // any thread but only from one at a time.
+  class EntryReader {
+   public:
+    ~EntryReader();
+
+    // Copies up to |size| bytes of the range into |buffer|. Returns the
+    // number of bytes copied, 0 once the whole range was read, or -1 if the
+    // entry is corrupted.
+    int Read(char* buffer, int size);
+
+    // Bytes of the range left to read.
+    int64 remaining() const { return remaining_; }
+
+   private:
+    friend class ApplicationArchive;
+
+    EntryReader(const ApplicationArchive* archive,
+                const uint8* content,
+                uint32 content_size,
+                int64 offset,
+                int64 length);
+
+    // Sets up the inflation of a deflated entry and skips the bytes before
+    // the range, which can't be located otherwise.
+    bool StartInflating(int64 offset);
+    int Inflate(char* buffer, int size);
+
+    scoped_refptr<const ApplicationArchive> archive_;
+    // The entry data in the mapping, as stored in the archive.
+    const uint8* content_;
+    uint32 content_size_;
+    // Position in |content_| of the next byte of stored entries.
+    int64 position_;
+    int64 remaining_;
+    // NULL for stored entries.
+    scoped_ptr<z_stream_s> stream_;
+
+    DISALLOW_COPY_AND_ASSIGN(EntryReader);
+  };
+
+  explicit ApplicationArchive(const base::FilePath& path);
+
+  // Maps the archive and reads its central directory. Only the first call
+  // does any work, returns false if the file doesn't exist or isn't a valid
+  // zip archive.
+  bool Open();
+
+  // |name| is the path of the entry in the archive, with '/' separators.
+  bool HasEntry(const std::string& name) const;
+  bool ReadEntry(const std::string& name, std::string* data) const;
+  bool GetEntrySize(const std::string& name, int64* size) const;
+  // Reads |length| bytes of the uncompressed entry from |offset|, or up to
+  // its end if |length| is negative. For stored entries, typically media,
+  // only that part is copied.
+  bool ReadEntryRange(const std::string& name,
+                      int64 offset,
+                      int64 length,
+                      std::string* data) const;
+  // Same range as ReadEntryRange(), to be read through the returned reader.
+  // Returns NULL if there's no such entry, if the range is out of its bounds
+  // or if the entry is corrupted.
+  scoped_ptr<EntryReader> OpenEntry(const std::string& name,
+                                    int64 offset,
+                                    int64 length) const;
+
+  const base::FilePath& path() const { return path_; }
+  size_t entry_count() const;
+  // Whether Open() was called, and whether it succeeded.
+  bool is_opened() const;
+  bool is_valid() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<ApplicationArchive>;
+  ~ApplicationArchive();
+
+  struct Entry {
+    uint16 method;
+    uint32 compressed_size;
+    uint32 uncompressed_size;
+    uint32 local_header_offset;
+  };
+  typedef base::hash_map<std::string, Entry> EntryMap;
+
+  bool ReadCentralDirectory();
+
+  const base::FilePath path_;
+
+  mutable base::Lock lock_;
+  bool opened_;
+  bool valid_;
+  base::MemoryMappedFile file_;
+  // Offset of the zip content in the file, non zero for XPK packages which
+  // start with their signature header.
+  size_t base_offset_;
+  EntryMap entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ApplicationArchive);
+};
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_COMMON_APPLICATION_ARCHIVE_H_
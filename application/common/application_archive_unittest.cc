@@ -0,0 +1,134 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/application_archive.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/path_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/zlib/google/zip.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+base::FilePath GetTestPackagePath(const std::string& name) {
+  base::FilePath path;
+  PathService::Get(base::DIR_SOURCE_ROOT, &path);
+  return path.AppendASCII("xwalk")
+      .AppendASCII("application")
+      .AppendASCII("test")
+      .AppendASCII("unpacker")
+      .AppendASCII(name);
+}
+
+}  // namespace
+
+TEST(ApplicationArchiveTest, ReadXPKEntries) {
+  scoped_refptr<ApplicationArchive> archive(
+      new ApplicationArchive(GetTestPackagePath("good.xpk")));
+  ASSERT_TRUE(archive->Open());
+  EXPECT_TRUE(archive->is_valid());
+  EXPECT_EQ(2u, archive->entry_count());
+  EXPECT_TRUE(archive->HasEntry("manifest.json"));
+
+  std::string manifest;
+  EXPECT_TRUE(archive->ReadEntry("manifest.json", &manifest));
+  EXPECT_NE(std::string::npos, manifest.find("\"name\""));
+  EXPECT_FALSE(archive->ReadEntry("missing.html", &manifest));
+}
+
+TEST(ApplicationArchiveTest, SameContentAsExtracted) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath content_dir = temp_dir.path().AppendASCII("content");
+  ASSERT_TRUE(base::CreateDirectory(content_dir.AppendASCII("js")));
+  const std::string script(4096, 'x');
+  ASSERT_EQ(static_cast<int>(script.size()),
+            base::WriteFile(content_dir.AppendASCII("js")
+                                .AppendASCII("main.js"),
+                            script.data(), script.size()));
+  base::FilePath zip_path = temp_dir.path().AppendASCII("app.wgt");
+  ASSERT_TRUE(zip::Zip(content_dir, zip_path, false));
+
+  scoped_refptr<ApplicationArchive> archive(new ApplicationArchive(zip_path));
+  ASSERT_TRUE(archive->Open());
+  // Directories aren't entries.
+  EXPECT_FALSE(archive->HasEntry("js/"));
+  std::string data;
+  EXPECT_TRUE(archive->ReadEntry("js/main.js", &data));
+  EXPECT_EQ(script, data);
+
+  int64 size = 0;
+  EXPECT_TRUE(archive->GetEntrySize("js/main.js", &size));
+  EXPECT_EQ(static_cast<int64>(script.size()), size);
+  EXPECT_TRUE(archive->ReadEntryRange("js/main.js", 100, 10, &data));
+  EXPECT_EQ(script.substr(100, 10), data);
+  EXPECT_TRUE(archive->ReadEntryRange("js/main.js", 4000, 1000, &data));
+  EXPECT_EQ(script.substr(4000), data);
+  EXPECT_FALSE(archive->ReadEntryRange("js/main.js", 5000, 10, &data));
+}
+
+// Entries are read a chunk at a time, from anywhere in the entry.
+TEST(ApplicationArchiveTest, ReadEntryInChunks) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath content_dir = temp_dir.path().AppendASCII("content");
+  ASSERT_TRUE(base::CreateDirectory(content_dir));
+  std::string video;
+  for (int i = 0; i < 100000; ++i)
+    video.append(1, static_cast<char>(i % 251));
+  ASSERT_EQ(static_cast<int>(video.size()),
+            base::WriteFile(content_dir.AppendASCII("video.webm"),
+                            video.data(), video.size()));
+  base::FilePath zip_path = temp_dir.path().AppendASCII("app.wgt");
+  ASSERT_TRUE(zip::Zip(content_dir, zip_path, false));
+
+  scoped_refptr<ApplicationArchive> archive(new ApplicationArchive(zip_path));
+  ASSERT_TRUE(archive->Open());
+
+  scoped_ptr<ApplicationArchive::EntryReader> reader(
+      archive->OpenEntry("video.webm", 0, -1));
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(static_cast<int64>(video.size()), reader->remaining());
+  std::string data;
+  char buffer[1000];
+  int result;
+  while ((result = reader->Read(buffer, sizeof(buffer))) > 0)
+    data.append(buffer, result);
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(0, reader->remaining());
+  EXPECT_EQ(video, data);
+
+  // The bytes before the range are skipped.
+  reader = archive->OpenEntry("video.webm", 50000, 3000);
+  ASSERT_TRUE(reader);
+  data.clear();
+  while ((result = reader->Read(buffer, sizeof(buffer))) > 0)
+    data.append(buffer, result);
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(video.substr(50000, 3000), data);
+
+  EXPECT_FALSE(archive->OpenEntry("video.webm", 100001, 10));
+  EXPECT_FALSE(archive->OpenEntry("missing.webm", 0, -1));
+}
+
+TEST(ApplicationArchiveTest, InvalidArchive) {
+  scoped_refptr<ApplicationArchive> archive(
+      new ApplicationArchive(GetTestPackagePath("bad_zip.xpk")));
+  EXPECT_FALSE(archive->Open());
+  EXPECT_TRUE(archive->is_opened());
+  EXPECT_FALSE(archive->is_valid());
+
+  scoped_refptr<ApplicationArchive> missing(
+      new ApplicationArchive(GetTestPackagePath("missing.xpk")));
+  EXPECT_FALSE(missing->Open());
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -102,6 +102,18 @@ GURL ApplicationData::GetBaseURLFromApplicationId(
 ApplicationData::ManifestData* ApplicationData::GetManifestData(
         const std::string& key) const {
   DCHECK(finished_parsing_manifest_ || thread_checker_.CalledOnValidThread());
+  if (IsLazyManifestKey(key)) {
+    base::AutoLock lock(lazy_parsing_lock_);
+    base::string16 error;
+    if (!lazy_manifest_registry_->ParseLazyManifestData(
+            make_scoped_refptr(const_cast<ApplicationData*>(this)),
+            key, &error)) {
+      LOG(ERROR) << "Failed to parse \"" << key << "\" in the manifest: "
+                 << base::UTF16ToUTF8(error);
+    }
+  }
+
+  base::AutoLock lock(manifest_data_lock_);
   ManifestDataMap::const_iterator iter = manifest_data_.find(key);
   if (iter != manifest_data_.end())
     return iter->second.get();
@@ -110,10 +122,47 @@ ApplicationData::ManifestData* ApplicationData::GetManifestData(
 
 void ApplicationData::SetManifestData(const std::string& key,
                                       ApplicationData::ManifestData* data) {
-  DCHECK(!finished_parsing_manifest_ && thread_checker_.CalledOnValidThread());
+  DCHECK(finished_parsing_manifest_ || thread_checker_.CalledOnValidThread());
+  base::AutoLock lock(manifest_data_lock_);
   manifest_data_[key] = linked_ptr<ManifestData>(data);
 }
 
+bool ApplicationData::ParseLazyManifestData(base::string16* error) {
+  base::AutoLock lock(lazy_parsing_lock_);
+  std::vector<std::string> keys;
+  {
+    base::AutoLock data_lock(manifest_data_lock_);
+    keys.assign(lazy_manifest_keys_.begin(), lazy_manifest_keys_.end());
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!lazy_manifest_registry_->ParseLazyManifestData(this, keys[i], error))
+      return false;
+  }
+  return true;
+}
+
+void ApplicationData::AddLazyManifestKeys(
+    ManifestHandlerRegistry* registry,
+    const std::vector<std::string>& keys) {
+  DCHECK(!finished_parsing_manifest_);
+  base::AutoLock lock(manifest_data_lock_);
+  lazy_manifest_registry_ = registry;
+  lazy_manifest_keys_.insert(keys.begin(), keys.end());
+}
+
+void ApplicationData::RemoveLazyManifestKeys(
+    const std::vector<std::string>& keys) {
+  base::AutoLock lock(manifest_data_lock_);
+  for (size_t i = 0; i < keys.size(); ++i)
+    lazy_manifest_keys_.erase(keys[i]);
+}
+
+bool ApplicationData::IsLazyManifestKey(const std::string& key) const {
+  base::AutoLock lock(manifest_data_lock_);
+  return lazy_manifest_keys_.find(key) != lazy_manifest_keys_.end();
+}
+
 Manifest::SourceType ApplicationData::GetSourceType() const {
   return manifest_->GetSourceType();
 }
@@ -141,6 +190,7 @@ ApplicationData::ApplicationData(const base::FilePath& path,
                      scoped_ptr<xwalk::application::Manifest> manifest)
     : manifest_version_(0),
       manifest_(manifest.release()),
+      lazy_manifest_registry_(NULL),
       finished_parsing_manifest_(false) {
   DCHECK(path.empty() || path.IsAbsolute());
   path_ = path;
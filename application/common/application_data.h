@@ -35,6 +35,8 @@ class Version;
 namespace xwalk {
 namespace application {
 
+class ManifestHandlerRegistry;
+
 class ApplicationData : public base::RefCountedThreadSafe<ApplicationData> {
  public:
   struct ManifestData;
@@ -85,14 +87,19 @@ class ApplicationData : public base::RefCountedThreadSafe<ApplicationData> {
   static GURL GetBaseURLFromApplicationId(const std::string& application_id);
 
   // Get the manifest data associated with the key, or NULL if there is none.
-  // Can only be called after InitValue is finished.
+  // Can only be called after InitValue is finished. Parses the data first if
+  // its handler parses lazily.
   ManifestData* GetManifestData(const std::string& key) const;
 
   // Sets |data| to be associated with the key. Takes ownership of |data|.
-  // Can only be called before InitValue is finished. Not thread-safe;
-  // all SetManifestData calls should be on only one thread.
+  // Can only be called before InitValue is finished, or by the lazy manifest
+  // handlers.
   void SetManifestData(const std::string& key, ManifestData* data);
 
+  // Parses the manifest data left to the lazy handlers now. Used at install
+  // time, so that invalid data fails the install as it would at load time.
+  bool ParseLazyManifestData(base::string16* error);
+
   // Accessors:
 
   const base::FilePath& Path() const { return path_; }
@@ -110,6 +117,12 @@ class ApplicationData : public base::RefCountedThreadSafe<ApplicationData> {
     return manifest_.get();
   }
 
+  // Makes the localized values of the manifest resolved for |locale| from
+  // now on. The manifest data already parsed keeps its values.
+  void SetManifestLocale(const std::string& locale) {
+    manifest_->SetSystemLocale(locale);
+  }
+
   const base::Time& install_time() const { return install_time_; }
 
   // App-related.
@@ -133,6 +146,7 @@ class ApplicationData : public base::RefCountedThreadSafe<ApplicationData> {
  private:
   friend class base::RefCountedThreadSafe<ApplicationData>;
   friend class ApplicationStorageImpl;
+  friend class ManifestHandlerRegistry;
 
   ApplicationData(const base::FilePath& path,
             scoped_ptr<Manifest> manifest);
@@ -150,6 +164,12 @@ class ApplicationData : public base::RefCountedThreadSafe<ApplicationData> {
   bool LoadVersion(base::string16* error);
   bool LoadDescription(base::string16* error);
 
+  // Makes GetManifestData of |keys| call |registry| to parse them first.
+  void AddLazyManifestKeys(ManifestHandlerRegistry* registry,
+                           const std::vector<std::string>& keys);
+  void RemoveLazyManifestKeys(const std::vector<std::string>& keys);
+  bool IsLazyManifestKey(const std::string& key) const;
+
   // The application's human-readable name. Name is used for display purpose. It
   // might be wrapped with unicode bidi control characters so that it is
   // displayed correctly in RTL context.
@@ -196,6 +216,17 @@ class ApplicationData : public base::RefCountedThreadSafe<ApplicationData> {
   // Stored parsed manifest data.
   ManifestDataMap manifest_data_;
 
+  // The keys of the manifest data not parsed yet, and the registry of their
+  // handlers.
+  std::set<std::string> lazy_manifest_keys_;
+  ManifestHandlerRegistry* lazy_manifest_registry_;
+
+  // Guards |manifest_data_| and |lazy_manifest_keys_| once the application
+  // is shared between threads.
+  mutable base::Lock manifest_data_lock_;
+  // Held while a lazy handler parses, the handlers don't run concurrently.
+  mutable base::Lock lazy_parsing_lock_;
+
   // Set to true at the end of InitValue when initialization is finished.
   bool finished_parsing_manifest_;
 
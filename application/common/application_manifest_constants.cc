@@ -44,6 +44,7 @@ const char kLaunchScreenReadyWhen[] =
 const char kPermissionsKey[] = "permissions";
 const char kXWalkVersionKey[] = "xwalk_version";
 const char kXWalkDescriptionKey[] = "xwalk_description";
+const char kXWalkDownloadsKey[] = "xwalk_downloads";
 const char kXWalkHostsKey[] = "xwalk_hosts";
 const char kXWalkLaunchScreen[] = "xwalk_launch_screen";
 const char kXWalkLaunchScreenDefault[] = "xwalk_launch_screen.default";
@@ -59,6 +60,8 @@ const char kXWalkLaunchScreenPortrait[] =
     "xwalk_launch_screen.portrait";
 const char kXWalkLaunchScreenReadyWhen[] =
     "xwalk_launch_screen.ready_when";
+const char kXWalkNaClKey[] = "xwalk_nacl";
+const char kXWalkPrefetchKey[] = "xwalk_prefetch";
 
 #if defined(OS_TIZEN)
 const char kTizenAppIdKey[] = "tizen_app_id";
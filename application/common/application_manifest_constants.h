@@ -42,6 +42,7 @@ namespace application_manifest_keys {
   extern const char kPermissionsKey[];
   extern const char kXWalkVersionKey[];
   extern const char kXWalkDescriptionKey[];
+  extern const char kXWalkDownloadsKey[];
   extern const char kXWalkHostsKey[];
   extern const char kXWalkLaunchScreen[];
   extern const char kXWalkLaunchScreenDefault[];
@@ -51,6 +52,8 @@ namespace application_manifest_keys {
   extern const char kXWalkLaunchScreenLandscape[];
   extern const char kXWalkLaunchScreenPortrait[];
   extern const char kXWalkLaunchScreenReadyWhen[];
+  extern const char kXWalkNaClKey[];
+  extern const char kXWalkPrefetchKey[];
 
 #if defined(OS_TIZEN)
   extern const char kTizenAppIdKey[];
@@ -0,0 +1,137 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/application_resource_index.h"
+
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/files/file_enumerator.h"
+#include "base/threading/thread_restrictions.h"
+#include "net/base/mime_util.h"
+#include "xwalk/application/common/application_resource.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+const base::FilePath::CharType kLocaleDirectory[] =
+    FILE_PATH_LITERAL("locales");
+
+// Rebuilds |path| from its components, so "a//b" and "a/b" give the same key.
+// Returns false for paths with "." or ".." components, those are resolved on
+// the file system by ApplicationResource.
+bool GetCanonicalRelativePath(const base::FilePath& path,
+                              base::FilePath* canonical) {
+  std::vector<base::FilePath::StringType> components;
+  path.GetComponents(&components);
+  if (components.empty())
+    return false;
+
+  base::FilePath result;
+  for (size_t i = 0; i < components.size(); ++i) {
+    if (components[i] == base::FilePath::kCurrentDirectory ||
+        components[i] == base::FilePath::kParentDirectory)
+      return false;
+    result = result.Append(components[i]);
+  }
+  *canonical = result;
+  return true;
+}
+
+}  // namespace
+
+ApplicationResourceIndex::ApplicationResourceIndex(
+    const base::FilePath& application_root)
+    : application_root_(application_root),
+      is_built_(false) {
+}
+
+ApplicationResourceIndex::~ApplicationResourceIndex() {
+}
+
+void ApplicationResourceIndex::Build() {
+  base::ThreadRestrictions::AssertIOAllowed();
+
+  EntryMap entries;
+  const base::FilePath root = base::MakeAbsoluteFilePath(application_root_);
+  if (!root.empty()) {
+    base::FileEnumerator iter(root, true, base::FileEnumerator::FILES);
+    for (base::FilePath path = iter.Next(); !path.empty();
+         path = iter.Next()) {
+      base::FilePath relative_path;
+      if (!root.AppendRelativePath(path, &relative_path))
+        continue;
+
+      Entry entry;
+      entry.file_path = path;
+      entry.file_size = iter.GetInfo().GetSize();
+      if (base::IsLink(path)) {
+        // Resolved the same way ApplicationResource does.
+        entry.file_path = ApplicationResource::GetFilePath(
+            root, relative_path,
+            ApplicationResource::SYMLINKS_MUST_RESOLVE_WITHIN_ROOT);
+        if (entry.file_path.empty())
+          continue;
+      }
+      net::GetMimeTypeFromFile(entry.file_path, &entry.mime_type);
+      entries[relative_path.value()] = entry;
+    }
+  }
+
+  base::AutoLock lock(lock_);
+  entries_.swap(entries);
+  is_built_ = true;
+}
+
+bool ApplicationResourceIndex::Lookup(const base::FilePath& relative_path,
+                                      const std::list<std::string>& locales,
+                                      base::FilePath* file_path,
+                                      std::string* mime_type,
+                                      int64* file_size) const {
+  base::FilePath canonical_path;
+  if (!GetCanonicalRelativePath(relative_path, &canonical_path))
+    return false;
+
+  base::AutoLock lock(lock_);
+  if (!is_built_)
+    return false;
+
+  for (std::list<std::string>::const_iterator it = locales.begin();
+       it != locales.end(); ++it) {
+    if (LookupEntry(base::FilePath(kLocaleDirectory).AppendASCII(*it)
+                        .Append(canonical_path),
+                    file_path, mime_type, file_size))
+      return true;
+  }
+  return LookupEntry(canonical_path, file_path, mime_type, file_size);
+}
+
+bool ApplicationResourceIndex::is_built() const {
+  base::AutoLock lock(lock_);
+  return is_built_;
+}
+
+size_t ApplicationResourceIndex::size() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+bool ApplicationResourceIndex::LookupEntry(const base::FilePath& relative_path,
+                                           base::FilePath* file_path,
+                                           std::string* mime_type,
+                                           int64* file_size) const {
+  lock_.AssertAcquired();
+  EntryMap::const_iterator it = entries_.find(relative_path.value());
+  if (it == entries_.end())
+    return false;
+  *file_path = it->second.file_path;
+  *mime_type = it->second.mime_type;
+  *file_size = it->second.file_size;
+  return true;
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,75 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_COMMON_APPLICATION_RESOURCE_INDEX_H_
+#define XWALK_APPLICATION_COMMON_APPLICATION_RESOURCE_INDEX_H_
+
+#include <list>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+
+namespace xwalk {
+namespace application {
+
+// Resolved locations of all the resources of an installed application, so
+// app:// requests can be mapped to a file without touching the file system.
+// Built once from a thread allowing IO, then looked up from any thread.
+//
+// Lookups follow the same rules as ApplicationResource::GetFilePath(): the
+// locale specific versions first, and no symlink escaping the root. A miss
+// doesn't mean the resource doesn't exist (e.g. the index isn't built yet or
+// the path isn't in its canonical form), callers should fallback to
+// ApplicationResource in that case.
+class ApplicationResourceIndex
+    : public base::RefCountedThreadSafe<ApplicationResourceIndex> {
+ public:
+  explicit ApplicationResourceIndex(const base::FilePath& application_root);
+
+  // Walks the application directory. Must be called on a thread allowing IO.
+  void Build();
+
+  // |file_size| is the size the file had when the index was built.
+  bool Lookup(const base::FilePath& relative_path,
+              const std::list<std::string>& locales,
+              base::FilePath* file_path,
+              std::string* mime_type,
+              int64* file_size) const;
+
+  bool is_built() const;
+  size_t size() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<ApplicationResourceIndex>;
+  ~ApplicationResourceIndex();
+
+  struct Entry {
+    base::FilePath file_path;
+    std::string mime_type;
+    int64 file_size;
+  };
+  typedef base::hash_map<base::FilePath::StringType, Entry> EntryMap;
+
+  bool LookupEntry(const base::FilePath& relative_path,
+                   base::FilePath* file_path,
+                   std::string* mime_type,
+                   int64* file_size) const;
+
+  const base::FilePath application_root_;
+
+  mutable base::Lock lock_;
+  EntryMap entries_;
+  bool is_built_;
+
+  DISALLOW_COPY_AND_ASSIGN(ApplicationResourceIndex);
+};
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_COMMON_APPLICATION_RESOURCE_INDEX_H_
@@ -0,0 +1,92 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/application_resource_index.h"
+
+#include <list>
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace xwalk {
+namespace application {
+
+class ApplicationResourceIndexTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    root_ = base::MakeAbsoluteFilePath(temp_dir_.path());
+    CreateFile(base::FilePath(FILE_PATH_LITERAL("index.html")));
+    CreateFile(base::FilePath(FILE_PATH_LITERAL("js/main.js")));
+    CreateFile(base::FilePath(FILE_PATH_LITERAL("locales/en/index.html")));
+    index_ = new ApplicationResourceIndex(root_);
+  }
+
+  void CreateFile(const base::FilePath& relative_path) {
+    base::FilePath path = root_.Append(relative_path);
+    ASSERT_TRUE(base::CreateDirectory(path.DirName()));
+    ASSERT_EQ(1, base::WriteFile(path, "a", 1));
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath root_;
+  scoped_refptr<ApplicationResourceIndex> index_;
+};
+
+TEST_F(ApplicationResourceIndexTest, Lookup) {
+  std::list<std::string> locales;
+  base::FilePath file_path;
+  std::string mime_type;
+  int64 file_size = 0;
+  const base::FilePath main_js(FILE_PATH_LITERAL("js/main.js"));
+
+  // Nothing is found before the index is built.
+  EXPECT_FALSE(index_->Lookup(main_js, locales, &file_path, &mime_type,
+                              &file_size));
+
+  index_->Build();
+  EXPECT_TRUE(index_->is_built());
+  EXPECT_EQ(3u, index_->size());
+
+  EXPECT_TRUE(index_->Lookup(main_js, locales, &file_path, &mime_type,
+                             &file_size));
+  EXPECT_EQ(root_.Append(main_js), file_path);
+  EXPECT_EQ("application/javascript", mime_type);
+  EXPECT_EQ(1, file_size);
+
+  EXPECT_TRUE(index_->Lookup(base::FilePath(FILE_PATH_LITERAL("js//main.js")),
+                             locales, &file_path, &mime_type, &file_size));
+  EXPECT_FALSE(index_->Lookup(base::FilePath(FILE_PATH_LITERAL("missing.js")),
+                              locales, &file_path, &mime_type, &file_size));
+  EXPECT_FALSE(index_->Lookup(
+      base::FilePath(FILE_PATH_LITERAL("js/../index.html")),
+      locales, &file_path, &mime_type, &file_size));
+}
+
+TEST_F(ApplicationResourceIndexTest, LocaleSpecificResource) {
+  index_->Build();
+  const base::FilePath index_html(FILE_PATH_LITERAL("index.html"));
+  std::list<std::string> locales;
+  locales.push_back("en-us");
+  locales.push_back("en");
+  base::FilePath file_path;
+  std::string mime_type;
+  int64 file_size = 0;
+  EXPECT_TRUE(index_->Lookup(index_html, locales, &file_path, &mime_type,
+                             &file_size));
+  EXPECT_EQ(root_.Append(FILE_PATH_LITERAL("locales/en/index.html")),
+            file_path);
+  EXPECT_EQ("text/html", mime_type);
+
+  locales.clear();
+  locales.push_back("fr");
+  EXPECT_TRUE(index_->Lookup(index_html, locales, &file_path, &mime_type,
+                             &file_size));
+  EXPECT_EQ(root_.Append(index_html), file_path);
+}
+
+}  // namespace application
+}  // namespace xwalk
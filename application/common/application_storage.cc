@@ -4,6 +4,10 @@
 
 #include "xwalk/application/common/application_storage.h"
 
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/task_runner.h"
+
 #if defined(OS_TIZEN)
 #include "xwalk/application/common/application_storage_impl_tizen.h"
 #else
@@ -14,11 +18,46 @@ namespace xwalk {
 namespace application {
 
 ApplicationStorage::ApplicationStorage(const base::FilePath& path)
-    : impl_(new ApplicationStorageImpl(path)) {
-  impl_->Init();
+    : impl_(new ApplicationStorageImpl(path)),
+      mode_(READ_WRITE),
+      init_done_(true, false) {
+  InitImpl();
+}
+
+ApplicationStorage::ApplicationStorage(const base::FilePath& path,
+                                       OpenMode mode)
+    : impl_(new ApplicationStorageImpl(path)),
+      mode_(mode),
+      init_done_(true, false) {
+  InitImpl();
+}
+
+ApplicationStorage::ApplicationStorage(
+    const base::FilePath& path,
+    const scoped_refptr<base::TaskRunner>& init_task_runner)
+    : impl_(new ApplicationStorageImpl(path)),
+      mode_(READ_WRITE),
+      init_done_(true, false) {
+  // Unretained is safe, the destructor waits for the initialization.
+  init_task_runner->PostTask(
+      FROM_HERE,
+      base::Bind(&ApplicationStorage::InitImpl, base::Unretained(this)));
 }
 
 ApplicationStorage::~ApplicationStorage() {
+  WaitForInit();
+}
+
+void ApplicationStorage::InitImpl() {
+  if (mode_ == READ_ONLY)
+    impl_->InitReadOnly();
+  else
+    impl_->Init();
+  init_done_.Signal();
+}
+
+void ApplicationStorage::WaitForInit() const {
+  init_done_.Wait();
 }
 
 bool ApplicationStorage::AddApplication(
@@ -33,27 +72,39 @@ bool ApplicationStorage::AddApplication(
 }
 
 bool ApplicationStorage::RemoveApplication(const std::string& id) {
+  WaitForInit();
   return impl_->RemoveApplication(id);
 }
 
 bool ApplicationStorage::UpdateApplication(
     scoped_refptr<ApplicationData> app_data) {
+  WaitForInit();
   return impl_->UpdateApplication(app_data.get(), base::Time::Now());
 }
 
 bool ApplicationStorage::Contains(const std::string& app_id) const {
+  WaitForInit();
   return impl_->ContainsApplication(app_id);
 }
 
 scoped_refptr<ApplicationData> ApplicationStorage::GetApplicationData(
     const std::string& app_id) const {
+  WaitForInit();
   return impl_->GetApplicationData(app_id);
 }
 
 bool ApplicationStorage::GetInstalledApplicationIDs(
     std::vector<std::string>& app_ids) const {  // NOLINT
+  WaitForInit();
   return impl_->GetInstalledApplicationIDs(app_ids);
 }
 
+bool ApplicationStorage::GetApplicationsData(
+    const std::vector<std::string>& app_ids,
+    ApplicationData::ApplicationDataMap& applications) const {  // NOLINT
+  WaitForInit();
+  return impl_->GetApplicationsData(app_ids, applications);
+}
+
 }  // namespace application
 }  // namespace xwalk
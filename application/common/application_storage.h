@@ -10,14 +10,32 @@
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/synchronization/waitable_event.h"
 #include "xwalk/application/common/application_data.h"
 
+namespace base {
+class TaskRunner;
+}
+
 namespace xwalk {
 namespace application {
 
 class ApplicationStorage {
  public:
+  enum OpenMode {
+    READ_WRITE,
+    // For the processes which only query the applications, see
+    // ApplicationStorageImpl::InitReadOnly().
+    READ_ONLY
+  };
+
   explicit ApplicationStorage(const base::FilePath& path);
+  ApplicationStorage(const base::FilePath& path, OpenMode mode);
+  // Opens the database, and migrates it if needed, on |init_task_runner| so
+  // the caller can do other work meanwhile. The methods below block until it
+  // is done.
+  ApplicationStorage(const base::FilePath& path,
+                     const scoped_refptr<base::TaskRunner>& init_task_runner);
   ~ApplicationStorage();
 
   bool AddApplication(scoped_refptr<ApplicationData> app_data);
@@ -34,8 +52,19 @@ class ApplicationStorage {
   bool GetInstalledApplicationIDs(
       std::vector<std::string>& app_ids) const;  // NOLINT
 
+  // Bulk alternative to GetApplicationData(), prefer it when loading many
+  // applications.
+  bool GetApplicationsData(
+      const std::vector<std::string>& app_ids,
+      ApplicationData::ApplicationDataMap& applications) const;  // NOLINT
+
  private:
+  void InitImpl();
+  void WaitForInit() const;
+
   scoped_ptr<class ApplicationStorageImpl> impl_;
+  OpenMode mode_;
+  mutable base::WaitableEvent init_done_;
   DISALLOW_COPY_AND_ASSIGN(ApplicationStorage);
 };
 
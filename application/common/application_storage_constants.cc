@@ -39,6 +39,13 @@ const char kGetAllRowsFromAppTableOp[] =
     "LEFT JOIN stored_permissions as C "
     "ON A.id = C.id";
 
+// The list of ids, e.g. "(?,?,?)", is appended by the caller.
+const char kGetRowsFromAppTableByIDsOp[] =
+    "SELECT A.id, A.manifest, A.path, A.install_time, "
+    "C.permission_names FROM applications as A "
+    "LEFT JOIN stored_permissions as C "
+    "ON A.id = C.id WHERE A.id IN ";
+
 extern const char kGetAllIDsFromAppTableOp[] =
     "SELECT id FROM applications";
 
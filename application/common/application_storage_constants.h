@@ -18,6 +18,7 @@ namespace application_storage_constants {
   extern const char kCreatePermissionTableOp[];
   extern const char kGetRowFromAppTableOp[];
   extern const char kGetAllRowsFromAppTableOp[];
+  extern const char kGetRowsFromAppTableByIDsOp[];
   extern const char kGetAllIDsFromAppTableOp[];
   extern const char kSetApplicationWithBindOp[];
   extern const char kUpdateApplicationWithBindOp[];
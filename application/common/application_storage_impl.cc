@@ -4,6 +4,7 @@
 
 #include "xwalk/application/common/application_storage_impl.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -32,6 +33,13 @@ const char kPermissionSeparator = '^';
 // should migrate all data from JSON DB to SQLite applications table.
 static const int kVersionNumber = 1;
 
+// Keeps GetApplicationsData() queries under SQLITE_MAX_VARIABLE_NUMBER.
+static const size_t kMaxIDsPerQuery = 500;
+
+// How long a connection waits for the write lock held by another process,
+// e.g. xwalkctl installing while the runtime updates the permissions.
+static const int kBusyTimeoutMs = 5000;
+
 namespace {
 
 const std::string StoredPermissionStr[] = {
@@ -103,6 +111,19 @@ StoredPermissionMap ToPermissionMap(const std::string& str) {
   return map;
 }
 
+// The journal mode is stored in the database file, so the readers opened
+// with InitReadOnly() use it as well. It stays "delete" on file systems
+// which don't support the shared memory index of the log.
+bool EnableWriteAheadLog(sql::Connection* db) {
+  sql::Statement statement(db->GetUniqueStatement("PRAGMA journal_mode=WAL"));
+  return statement.Step() && statement.ColumnString(0) == "wal";
+}
+
+bool SetBusyTimeout(sql::Connection* db) {
+  return db->Execute(
+      base::StringPrintf("PRAGMA busy_timeout=%d", kBusyTimeoutMs).c_str());
+}
+
 bool InitPermissionsTable(sql::Connection* db) {
   sql::Transaction transaction(db);
   transaction.Begin();
@@ -117,7 +138,8 @@ bool InitPermissionsTable(sql::Connection* db) {
 
 ApplicationStorageImpl::ApplicationStorageImpl(const base::FilePath& path)
     : data_path_(path),
-      db_initialized_(false) {
+      db_initialized_(false),
+      read_only_(false) {
   // Ensure the parent directory for database file is created before reading
   // from it.
   if (!base::PathExists(path) && !base::CreateDirectory(path))
@@ -177,6 +199,11 @@ bool ApplicationStorageImpl::Init() {
     LOG(ERROR) << "Unable to open applications DB.";
     return false;
   }
+  if (!SetBusyTimeout(sqlite_db.get()))
+    LOG(WARNING) << "Unable to set the busy timeout of applications DB.";
+  if (!EnableWriteAheadLog(sqlite_db.get()))
+    LOG(WARNING) << "Unable to enable the write-ahead log of applications DB, "
+                    "readers will be blocked by the writers.";
   sqlite_db->Preload();
 
   if (!meta_table_.Init(sqlite_db.get(), kVersionNumber, kVersionNumber) ||
@@ -225,12 +252,68 @@ bool ApplicationStorageImpl::Init() {
   return db_initialized_;
 }
 
+bool ApplicationStorageImpl::InitReadOnly() {
+  // The first open creates, or migrates, the database.
+  const base::FilePath db_path = GetDBPath(data_path_);
+  if (!base::PathExists(db_path))
+    return Init();
+
+  scoped_ptr<sql::Connection> sqlite_db(new sql::Connection);
+  if (!sqlite_db->Open(db_path)) {
+    LOG(ERROR) << "Unable to open applications DB.";
+    return false;
+  }
+  if (!SetBusyTimeout(sqlite_db.get()))
+    LOG(WARNING) << "Unable to set the busy timeout of applications DB.";
+
+  if (!sql::MetaTable::DoesTableExist(sqlite_db.get()) ||
+      !meta_table_.Init(sqlite_db.get(), kVersionNumber, kVersionNumber) ||
+      meta_table_.GetVersionNumber() != kVersionNumber) {
+    LOG(ERROR) << "Unable to read the META table.";
+    return false;
+  }
+
+  if (!sqlite_db->DoesTableExist(db_fields::kAppTableName) ||
+      !sqlite_db->DoesTableExist(db_fields::kPermissionTableName)) {
+    LOG(ERROR) << "The applications DB is missing its tables.";
+    return false;
+  }
+
+  sqlite_db_.reset(sqlite_db.release());
+  read_only_ = true;
+  db_initialized_ = true;
+
+  return db_initialized_;
+}
+
+ApplicationStorageImpl::CachedApplication::CachedApplication()
+    : install_time(0) {}
+
+ApplicationStorageImpl::CachedApplication::~CachedApplication() {}
+
 scoped_refptr<ApplicationData> ApplicationStorageImpl::ExtractApplicationData(
     const sql::Statement& smt) {
   std::string id = smt.ColumnString(0);
+  std::string manifest_str = smt.ColumnString(1);
+  std::string path = smt.ColumnString(2);
+  double install_time = smt.ColumnDouble(3);
+  std::string permissions = smt.ColumnString(4);
+
+  ApplicationCache::iterator it = application_cache_.find(id);
+  if (it != application_cache_.end()) {
+    const CachedApplication& cached = it->second;
+    // The data given out may have been changed in memory since (e.g. session
+    // permissions), only reuse it if it still matches the row.
+    if (cached.manifest == manifest_str && cached.path == path &&
+        cached.install_time == install_time &&
+        cached.permissions == permissions &&
+        cached.data->Path() == cached.data_path &&
+        cached.data->permission_map_ == ToPermissionMap(permissions))
+      return cached.data;
+    application_cache_.erase(it);
+  }
 
   int error_code;
-  std::string manifest_str = smt.ColumnString(1);
   JSONStringValueSerializer serializer(&manifest_str);
   std::string error_msg;
   scoped_ptr<base::DictionaryValue> manifest(
@@ -243,8 +326,6 @@ scoped_refptr<ApplicationData> ApplicationStorageImpl::ExtractApplicationData(
                << error_msg;
     return NULL;
   }
-  std::string path = smt.ColumnString(2);
-  double install_time = smt.ColumnDouble(3);
 
   std::string error;
   scoped_refptr<ApplicationData> app_data =
@@ -261,7 +342,15 @@ scoped_refptr<ApplicationData> ApplicationStorageImpl::ExtractApplicationData(
 
   app_data->install_time_ = base::Time::FromDoubleT(install_time);
 
-  app_data->permission_map_ = ToPermissionMap(smt.ColumnString(4));
+  app_data->permission_map_ = ToPermissionMap(permissions);
+
+  CachedApplication& cached = application_cache_[id];
+  cached.manifest = manifest_str;
+  cached.path = path;
+  cached.install_time = install_time;
+  cached.permissions = permissions;
+  cached.data = app_data;
+  cached.data_path = app_data->Path();
 
   return app_data;
 }
@@ -273,8 +362,8 @@ scoped_refptr<ApplicationData> ApplicationStorageImpl::GetApplicationData(
     return NULL;
   }
 
-  sql::Statement smt(sqlite_db_->GetUniqueStatement(
-      db_fields::kGetRowFromAppTableOp));
+  sql::Statement smt(sqlite_db_->GetCachedStatement(
+      SQL_FROM_HERE, db_fields::kGetRowFromAppTableOp));
   smt.BindString(0, app_id);
   if (!smt.is_valid())
     return NULL;
@@ -285,6 +374,46 @@ scoped_refptr<ApplicationData> ApplicationStorageImpl::GetApplicationData(
   return ExtractApplicationData(smt);
 }
 
+bool ApplicationStorageImpl::GetApplicationsData(
+    const std::vector<std::string>& ids,
+    ApplicationData::ApplicationDataMap& applications) {  // NOLINT
+  if (!db_initialized_) {
+    LOG(ERROR) << "The database hasn't been initilized.";
+    return false;
+  }
+
+  for (size_t begin = 0; begin < ids.size(); begin += kMaxIDsPerQuery) {
+    size_t count = std::min(kMaxIDsPerQuery, ids.size() - begin);
+
+    // Only placeholders are added to the query, the ids themselves are bound.
+    std::string query(db_fields::kGetRowsFromAppTableByIDsOp);
+    query += "(?";
+    for (size_t i = 1; i < count; ++i)
+      query += ",?";
+    query += ")";
+
+    sql::Statement smt(sqlite_db_->GetUniqueStatement(query.c_str()));
+    if (!smt.is_valid())
+      return false;
+    for (size_t i = 0; i < count; ++i)
+      smt.BindString(i, ids[begin + i]);
+
+    while (smt.Step()) {
+      scoped_refptr<ApplicationData> data = ExtractApplicationData(smt);
+      if (!data) {
+        LOG(ERROR) << "Failed to obtain ApplicationData from SQL query";
+        return false;
+      }
+      applications[data->ID()] = data;
+    }
+
+    if (!smt.Succeeded())
+      return false;
+  }
+
+  return true;
+}
+
 bool ApplicationStorageImpl::GetInstalledApplications(
     ApplicationData::ApplicationDataMap& applications) {  // NOLINT
   if (!db_initialized_) {
@@ -292,8 +421,8 @@ bool ApplicationStorageImpl::GetInstalledApplications(
     return false;
   }
 
-  sql::Statement smt(sqlite_db_->GetUniqueStatement(
-      db_fields::kGetAllRowsFromAppTableOp));
+  sql::Statement smt(sqlite_db_->GetCachedStatement(
+      SQL_FROM_HERE, db_fields::kGetAllRowsFromAppTableOp));
   if (!smt.is_valid())
     return false;
 
@@ -318,8 +447,8 @@ bool ApplicationStorageImpl::GetInstalledApplicationIDs(
     return false;
   }
 
-  sql::Statement smt(sqlite_db_->GetUniqueStatement(
-      db_fields::kGetAllIDsFromAppTableOp));
+  sql::Statement smt(sqlite_db_->GetCachedStatement(
+      SQL_FROM_HERE, db_fields::kGetAllIDsFromAppTableOp));
   if (!smt.is_valid())
     return false;
 
@@ -337,25 +466,35 @@ bool ApplicationStorageImpl::GetInstalledApplicationIDs(
 
 bool ApplicationStorageImpl::AddApplication(const ApplicationData* application,
                                             const base::Time& install_time) {
+  if (read_only_) {
+    LOG(ERROR) << "The database has been opened read-only.";
+    return false;
+  }
+
   if (!db_initialized_) {
     LOG(ERROR) << "The database hasn't been initilized.";
     return false;
   }
 
-  return (SetApplicationValue(
-      application, install_time, db_fields::kSetApplicationWithBindOp) &&
+  return (SetApplicationValue(application, install_time, SQL_FROM_HERE,
+                              db_fields::kSetApplicationWithBindOp) &&
           SetPermissions(application->ID(), application->permission_map_));
 }
 
 bool ApplicationStorageImpl::UpdateApplication(
     ApplicationData* application, const base::Time& install_time) {
+  if (read_only_) {
+    LOG(ERROR) << "The database has been opened read-only.";
+    return false;
+  }
+
   if (!db_initialized_) {
     LOG(ERROR) << "The database hasn't been initilized.";
     return false;
   }
 
-  if (SetApplicationValue(
-          application, install_time, db_fields::kUpdateApplicationWithBindOp) &&
+  if (SetApplicationValue(application, install_time, SQL_FROM_HERE,
+                          db_fields::kUpdateApplicationWithBindOp) &&
       UpdatePermissions(application->ID(), application->permission_map_)) {
     return true;
   }
@@ -364,6 +503,11 @@ bool ApplicationStorageImpl::UpdateApplication(
 }
 
 bool ApplicationStorageImpl::RemoveApplication(const std::string& id) {
+  if (read_only_) {
+    LOG(ERROR) << "The database has been opened read-only.";
+    return false;
+  }
+
   if (!db_initialized_) {
     LOG(ERROR) << "The database hasn't been initilized.";
     return false;
@@ -373,8 +517,10 @@ bool ApplicationStorageImpl::RemoveApplication(const std::string& id) {
   if (!transaction.Begin())
     return false;
 
-  sql::Statement smt(sqlite_db_->GetUniqueStatement(
-      db_fields::kDeleteApplicationWithBindOp));
+  application_cache_.erase(id);
+
+  sql::Statement smt(sqlite_db_->GetCachedStatement(
+      SQL_FROM_HERE, db_fields::kDeleteApplicationWithBindOp));
   smt.BindString(0, id);
   if (!smt.Run()) {
     LOG(ERROR) << "Could not delete application "
@@ -392,7 +538,8 @@ bool ApplicationStorageImpl::ContainsApplication(const std::string& app_id) {
 bool ApplicationStorageImpl::SetApplicationValue(
     const ApplicationData* application,
     const base::Time& install_time,
-    const std::string& operation) {
+    const sql::StatementID& statement_id,
+    const char* operation) {
   if (!application) {
     LOG(ERROR) << "A value is needed when inserting/updating in DB.";
     return false;
@@ -409,7 +556,7 @@ bool ApplicationStorageImpl::SetApplicationValue(
   if (!transaction.Begin())
     return false;
 
-  sql::Statement smt(sqlite_db_->GetUniqueStatement(operation.c_str()));
+  sql::Statement smt(sqlite_db_->GetCachedStatement(statement_id, operation));
   if (!smt.is_valid()) {
     LOG(ERROR) << "Unable to insert/update application info in DB.";
     return false;
@@ -433,7 +580,7 @@ bool ApplicationStorageImpl::SetPermissions(const std::string& id,
     LOG(ERROR) << "Database is not initialized.";
     return false;
   }
-  return SetPermissionsValue(id, permissions,
+  return SetPermissionsValue(id, permissions, SQL_FROM_HERE,
       db_fields::kInsertPermissionsWithBindOp);
 }
 
@@ -446,7 +593,7 @@ bool ApplicationStorageImpl::UpdatePermissions(const std::string& id,
   if (permissions.empty())
     return RevokePermissions(id);
 
-  return SetPermissionsValue(id, permissions,
+  return SetPermissionsValue(id, permissions, SQL_FROM_HERE,
       db_fields::kUpdatePermissionsWithBindOp);
 }
 
@@ -455,8 +602,8 @@ bool ApplicationStorageImpl::RevokePermissions(const std::string& id) {
   if (!transaction.Begin())
     return false;
 
-  sql::Statement statement(sqlite_db_->GetUniqueStatement(
-      db_fields::kDeletePermissionsWithBindOp));
+  sql::Statement statement(sqlite_db_->GetCachedStatement(
+      SQL_FROM_HERE, db_fields::kDeletePermissionsWithBindOp));
   statement.BindString(0, id);
 
   if (!statement.Run()) {
@@ -470,15 +617,16 @@ bool ApplicationStorageImpl::RevokePermissions(const std::string& id) {
 bool ApplicationStorageImpl::SetPermissionsValue(
     const std::string& id,
     const StoredPermissionMap& permissions,
-    const std::string& operation) {
+    const sql::StatementID& statement_id,
+    const char* operation) {
   sql::Transaction transaction(sqlite_db_.get());
   std::string permission_str = ToString(permissions);
 
   if (!transaction.Begin())
     return false;
 
-  sql::Statement statement(sqlite_db_->GetUniqueStatement(
-      operation.c_str()));
+  sql::Statement statement(sqlite_db_->GetCachedStatement(
+      statement_id, operation));
   statement.BindString(0, permission_str);
   statement.BindString(1, id);
   if (!statement.Run()) {
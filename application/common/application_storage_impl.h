@@ -5,6 +5,7 @@
 #ifndef XWALK_APPLICATION_COMMON_APPLICATION_STORAGE_IMPL_H_
 #define XWALK_APPLICATION_COMMON_APPLICATION_STORAGE_IMPL_H_
 
+#include <map>
 #include <set>
 #include <string>
 #include <utility>
@@ -19,6 +20,16 @@ namespace xwalk {
 namespace application {
 
 // The Sqlite backend implementation of ApplicationStorage.
+//
+// The runtime, xwalkctl and xwalk-pkg-helper each open their own connection
+// to the same database file, which uses the write-ahead log: readers never
+// block, nor are blocked by, the writer and see the last committed state. An
+// application and its permissions are written in one transaction each, so a
+// reader may see an application before its permissions only between the two.
+// Writers are serialized by SQLite, a writer waits up to a few seconds for
+// the lock held by another process before failing. Every process needs write
+// access to the database directory, the readers included, for the log index.
+// An instance itself is not thread safe.
 class ApplicationStorageImpl {
  public:
   static const base::FilePath::CharType kDBFileName[];
@@ -32,8 +43,18 @@ class ApplicationStorageImpl {
   bool UpdateApplication(ApplicationData* application,
                          const base::Time& install_time);
   bool Init();
+  // Opens an existing database without creating, migrating or preloading it,
+  // for the processes which only query it, e.g. to launch or list the
+  // applications. The methods modifying the database fail then. Falls back to
+  // Init() when the database has to be created first.
+  bool InitReadOnly();
 
   scoped_refptr<ApplicationData> GetApplicationData(const std::string& id);
+  // Loads the applications of |ids| with as few queries as possible, ids
+  // that are not installed are skipped.
+  bool GetApplicationsData(
+      const std::vector<std::string>& ids,
+      ApplicationData::ApplicationDataMap& applications);  // NOLINT
   bool GetInstalledApplications(
       ApplicationData::ApplicationDataMap& applications);  // NOLINT
 
@@ -44,23 +65,46 @@ class ApplicationStorageImpl {
   scoped_refptr<ApplicationData> ExtractApplicationData(
       const sql::Statement& smt);
   bool UpgradeToVersion1(const base::FilePath& v0_file);
+  // |statement_id| identifies |operation| in the statement cache of the
+  // connection, callers pass SQL_FROM_HERE.
   bool SetApplicationValue(const ApplicationData* application,
                            const base::Time& install_time,
-                           const std::string& operation);
+                           const sql::StatementID& statement_id,
+                           const char* operation);
   // Permissions helper functions
   bool SetPermissionsValue(const std::string& id,
                            const StoredPermissionMap& permissions,
-                           const std::string& operation);
+                           const sql::StatementID& statement_id,
+                           const char* operation);
   bool SetPermissions(const std::string& id,
                       const StoredPermissionMap& permissions);
   bool UpdatePermissions(const std::string& id,
                          const StoredPermissionMap& permissions);
   bool RevokePermissions(const std::string& id);
 
+  // Applications parsed by ExtractApplicationData(), along with the row they
+  // were built from. The row is still read from the database on every
+  // access, so changes made by other processes are seen, but the JSON and
+  // manifest handlers parsing is skipped while it didn't change.
+  struct CachedApplication {
+    CachedApplication();
+    ~CachedApplication();
+
+    std::string manifest;
+    std::string path;
+    double install_time;
+    std::string permissions;
+    scoped_refptr<ApplicationData> data;
+    base::FilePath data_path;
+  };
+  typedef std::map<std::string, CachedApplication> ApplicationCache;
+  ApplicationCache application_cache_;
+
   scoped_ptr<sql::Connection> sqlite_db_;
   sql::MetaTable meta_table_;
   base::FilePath data_path_;
   bool db_initialized_;
+  bool read_only_;
 };
 
 }  // namespace application
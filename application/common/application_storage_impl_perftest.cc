@@ -0,0 +1,152 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/application_storage_impl.h"
+
+#include <string>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_vector.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/simple_thread.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "xwalk/application/common/application_manifest_constants.h"
+#include "xwalk/application/common/id_util.h"
+
+namespace xwalk {
+
+namespace keys = application_manifest_keys;
+
+namespace application {
+
+namespace {
+
+// Lists and loads the installed applications through its own read-only
+// connection, as xwalkctl and the launcher do.
+class StorageReader : public base::DelegateSimpleThread::Delegate {
+ public:
+  StorageReader(const base::FilePath& path, int iterations)
+      : path_(path),
+        iterations_(iterations),
+        failures_(0) {
+  }
+
+  virtual void Run() OVERRIDE {
+    ApplicationStorageImpl storage(path_);
+    if (!storage.InitReadOnly()) {
+      failures_ = iterations_;
+      return;
+    }
+    for (int i = 0; i < iterations_; ++i) {
+      std::vector<std::string> ids;
+      ApplicationData::ApplicationDataMap applications;
+      if (!storage.GetInstalledApplicationIDs(ids) ||
+          !storage.GetApplicationsData(ids, applications))
+        ++failures_;
+    }
+  }
+
+  int failures() const { return failures_; }
+
+ private:
+  base::FilePath path_;
+  int iterations_;
+  int failures_;
+};
+
+}  // namespace
+
+class ApplicationStoragePerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    storage_.reset(new ApplicationStorageImpl(temp_dir_.path()));
+    ASSERT_TRUE(storage_->Init());
+  }
+
+  // Installs |count| applications and returns their ids.
+  void InstallApplications(int count, std::vector<std::string>* ids) {
+    base::DictionaryValue manifest;
+    manifest.SetString(keys::kNameKey, "no name");
+    manifest.SetString(keys::kXWalkVersionKey, "0");
+    for (int i = 0; i < count; ++i) {
+      std::string error;
+      scoped_refptr<ApplicationData> application =
+          ApplicationData::Create(base::FilePath(),
+                                  Manifest::INTERNAL,
+                                  manifest,
+                                  GenerateId(base::IntToString(i)),
+                                  &error);
+      ASSERT_TRUE(application);
+      ASSERT_TRUE(storage_->AddApplication(application.get(),
+                                           base::Time::FromDoubleT(0)));
+      ids->push_back(application->ID());
+    }
+  }
+
+  base::ScopedTempDir temp_dir_;
+  scoped_ptr<ApplicationStorageImpl> storage_;
+};
+
+TEST_F(ApplicationStoragePerfTest, GetApplicationsData) {
+  const int kApplicationCount = 1200;
+  std::vector<std::string> ids;
+  base::ElapsedTimer install_timer;
+  InstallApplications(kApplicationCount, &ids);
+  perf_test::PrintResult("application_storage", "", "install",
+                         install_timer.Elapsed().InMillisecondsF(), "ms",
+                         true);
+
+  base::ElapsedTimer single_timer;
+  for (size_t i = 0; i < ids.size(); ++i)
+    EXPECT_TRUE(storage_->GetApplicationData(ids[i]));
+  perf_test::PrintResult("application_storage", "", "load_one_by_one",
+                         single_timer.Elapsed().InMillisecondsF(), "ms",
+                         true);
+
+  base::ElapsedTimer bulk_timer;
+  ApplicationData::ApplicationDataMap applications;
+  EXPECT_TRUE(storage_->GetApplicationsData(ids, applications));
+  perf_test::PrintResult("application_storage", "", "load_bulk",
+                         bulk_timer.Elapsed().InMillisecondsF(), "ms", true);
+  EXPECT_EQ(ids.size(), applications.size());
+}
+
+TEST_F(ApplicationStoragePerfTest, ConcurrentReadersAndWriter) {
+  const int kReaderCount = 4;
+  const int kIterations = 200;
+  const int kApplicationCount = 100;
+
+  ScopedVector<StorageReader> readers;
+  ScopedVector<base::DelegateSimpleThread> threads;
+  for (int i = 0; i < kReaderCount; ++i) {
+    readers.push_back(new StorageReader(temp_dir_.path(), kIterations));
+    threads.push_back(new base::DelegateSimpleThread(
+        readers.back(), "StorageReader" + base::IntToString(i)));
+  }
+
+  base::ElapsedTimer timer;
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i]->Start();
+  std::vector<std::string> ids;
+  InstallApplications(kApplicationCount, &ids);
+  base::TimeDelta write_time = timer.Elapsed();
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i]->Join();
+  base::TimeDelta total_time = timer.Elapsed();
+
+  for (size_t i = 0; i < readers.size(); ++i)
+    EXPECT_EQ(0, readers[i]->failures());
+  perf_test::PrintResult("application_storage", "", "install_with_readers",
+                         write_time.InMillisecondsF(), "ms", true);
+  perf_test::PrintResult("application_storage", "", "readers",
+                         total_time.InMillisecondsF(), "ms", true);
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -29,6 +29,10 @@ bool ApplicationStorageImpl::Init() {
   return true;
 }
 
+bool ApplicationStorageImpl::InitReadOnly() {
+  return Init();
+}
+
 namespace {
 
 ail_cb_ret_e appinfo_get_exec_cb(const ail_appinfo_h appinfo, void *user_data) {
@@ -100,6 +104,18 @@ scoped_refptr<ApplicationData> ApplicationStorageImpl::GetApplicationData(
   return LoadApplication(app_path, app_id, Manifest::INTERNAL, &error_str);
 }
 
+bool ApplicationStorageImpl::GetApplicationsData(
+    const std::vector<std::string>& ids,
+    ApplicationData::ApplicationDataMap& applications) {  // NOLINT
+  // Each application is loaded from its own package, there is no bulk query.
+  for (size_t i = 0; i < ids.size(); ++i) {
+    scoped_refptr<ApplicationData> data = GetApplicationData(ids[i]);
+    if (data)
+      applications[ids[i]] = data;
+  }
+  return true;
+}
+
 namespace {
 
 ail_cb_ret_e appinfo_get_app_id_cb(
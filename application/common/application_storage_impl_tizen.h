@@ -31,8 +31,13 @@ class ApplicationStorageImpl {
   bool UpdateApplication(ApplicationData* application,
                          const base::Time& install_time);
   bool Init();
+  // The package manager databases are only queried, the same as Init().
+  bool InitReadOnly();
 
   scoped_refptr<ApplicationData> GetApplicationData(const std::string& id);
+  bool GetApplicationsData(
+      const std::vector<std::string>& ids,
+      ApplicationData::ApplicationDataMap& applications);  // NOLINT
 
   bool GetInstalledApplicationIDs(
       std::vector<std::string>& app_ids);  // NOLINT
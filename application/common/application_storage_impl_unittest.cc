@@ -7,11 +7,15 @@
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/json/json_file_value_serializer.h"
-#include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/path_service.h"
+#include "base/stl_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/threading/simple_thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "xwalk/application/common/application_storage.h"
 #include "xwalk/application/common/application_manifest_constants.h"
+#include "xwalk/application/common/id_util.h"
 
 namespace xwalk {
 
@@ -19,6 +23,43 @@ namespace keys = application_manifest_keys;
 
 namespace application {
 
+namespace {
+
+// Lists and loads the installed applications through its own read-only
+// connection, as xwalkctl and the launcher do, counting the failed queries.
+class StorageReader : public base::DelegateSimpleThread::Delegate {
+ public:
+  StorageReader(const base::FilePath& path, int iterations)
+      : path_(path),
+        iterations_(iterations),
+        failures_(0) {
+  }
+
+  virtual void Run() OVERRIDE {
+    ApplicationStorageImpl storage(path_);
+    if (!storage.InitReadOnly()) {
+      failures_ = iterations_;
+      return;
+    }
+    for (int i = 0; i < iterations_; ++i) {
+      std::vector<std::string> ids;
+      ApplicationData::ApplicationDataMap applications;
+      if (!storage.GetInstalledApplicationIDs(ids) ||
+          !storage.GetApplicationsData(ids, applications))
+        ++failures_;
+    }
+  }
+
+  int failures() const { return failures_; }
+
+ private:
+  base::FilePath path_;
+  int iterations_;
+  int failures_;
+};
+
+}  // namespace
+
 class ApplicationStorageImplTest : public testing::Test {
  public:
   void TestInit() {
@@ -185,5 +226,163 @@ TEST_F(ApplicationStorageImplTest, SetPermission) {
       applications[application->ID()]->GetPermission("permission") == ALLOW);
 }
 
+TEST_F(ApplicationStorageImplTest, ReuseParsedApplication) {
+  TestInit();
+  base::DictionaryValue manifest;
+  manifest.SetString(keys::kNameKey, "no name");
+  manifest.SetString(keys::kXWalkVersionKey, "0");
+  manifest.SetString("a", "b");
+  std::string error;
+  scoped_refptr<ApplicationData> application =
+      ApplicationData::Create(base::FilePath(),
+                              Manifest::INTERNAL,
+                              manifest,
+                              "",
+                              &error);
+  ASSERT_TRUE(error.empty());
+  ASSERT_TRUE(application);
+  EXPECT_TRUE(app_storage_impl_->AddApplication(application.get(),
+                                                base::Time::FromDoubleT(0)));
+
+  // The stored row didn't change, so the parsed data is given back.
+  scoped_refptr<ApplicationData> first =
+      app_storage_impl_->GetApplicationData(application->ID());
+  ASSERT_TRUE(first);
+  EXPECT_EQ(first.get(),
+            app_storage_impl_->GetApplicationData(application->ID()).get());
+
+  // Changes done in memory aren't kept once the data is loaded again.
+  EXPECT_TRUE(first->SetPermission("permission", ALLOW));
+  scoped_refptr<ApplicationData> second =
+      app_storage_impl_->GetApplicationData(application->ID());
+  ASSERT_TRUE(second);
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_EQ(UNDEFINED_STORED_PERM, second->GetPermission("permission"));
+
+  manifest.SetString("a", "c");
+  scoped_refptr<ApplicationData> new_application =
+      ApplicationData::Create(base::FilePath(),
+                              Manifest::INTERNAL,
+                              manifest,
+                              "",
+                              &error);
+  ASSERT_TRUE(new_application);
+  EXPECT_TRUE(app_storage_impl_->UpdateApplication(new_application.get(),
+                                                   base::Time::FromDoubleT(0)));
+  scoped_refptr<ApplicationData> updated =
+      app_storage_impl_->GetApplicationData(application->ID());
+  ASSERT_TRUE(updated);
+  EXPECT_NE(second.get(), updated.get());
+  EXPECT_TRUE(updated->GetManifest()->value()->Equals(
+      new_application->GetManifest()->value()));
+}
+
+TEST_F(ApplicationStorageImplTest, GetApplicationsData) {
+  TestInit();
+  // One more than a bulk query worth of applications.
+  const int kApplicationCount = 501;
+
+  base::DictionaryValue manifest;
+  manifest.SetString(keys::kNameKey, "no name");
+  manifest.SetString(keys::kXWalkVersionKey, "0");
+  std::vector<std::string> ids;
+  for (int i = 0; i < kApplicationCount; ++i) {
+    std::string error;
+    scoped_refptr<ApplicationData> application =
+        ApplicationData::Create(base::FilePath(),
+                                Manifest::INTERNAL,
+                                manifest,
+                                GenerateId(base::IntToString(i)),
+                                &error);
+    ASSERT_TRUE(application);
+    ASSERT_TRUE(app_storage_impl_->AddApplication(application.get(),
+                                                  base::Time::FromDoubleT(0)));
+    ids.push_back(application->ID());
+  }
+  ids.push_back(GenerateId("not installed"));
+
+  ApplicationData::ApplicationDataMap applications;
+  ASSERT_TRUE(app_storage_impl_->GetApplicationsData(ids, applications));
+  EXPECT_EQ(static_cast<size_t>(kApplicationCount), applications.size());
+  EXPECT_TRUE(applications[ids[0]]);
+  EXPECT_TRUE(applications[ids[kApplicationCount - 1]]);
+  EXPECT_FALSE(ContainsKey(applications, ids.back()));
+}
+
+TEST_F(ApplicationStorageImplTest, ReadOnlyRejectsWrites) {
+  TestInit();
+  ApplicationStorageImpl reader(temp_dir_.path());
+  ASSERT_TRUE(reader.InitReadOnly());
+
+  base::DictionaryValue manifest;
+  manifest.SetString(keys::kNameKey, "no name");
+  manifest.SetString(keys::kXWalkVersionKey, "0");
+  std::string error;
+  scoped_refptr<ApplicationData> application =
+      ApplicationData::Create(base::FilePath(),
+                              Manifest::INTERNAL,
+                              manifest,
+                              "",
+                              &error);
+  ASSERT_TRUE(application);
+  EXPECT_FALSE(reader.AddApplication(application.get(), base::Time::Now()));
+  EXPECT_TRUE(app_storage_impl_->AddApplication(application.get(),
+                                                base::Time::Now()));
+  // The write of the other connection is seen at once.
+  EXPECT_TRUE(reader.ContainsApplication(application->ID()));
+  EXPECT_FALSE(reader.RemoveApplication(application->ID()));
+}
+
+TEST_F(ApplicationStorageImplTest, ConcurrentReadersAndWriter) {
+  TestInit();
+  const int kReaderCount = 4;
+  const int kIterations = 20;
+  const int kApplicationCount = 20;
+
+  ScopedVector<StorageReader> readers;
+  ScopedVector<base::DelegateSimpleThread> threads;
+  for (int i = 0; i < kReaderCount; ++i) {
+    readers.push_back(new StorageReader(temp_dir_.path(), kIterations));
+    threads.push_back(new base::DelegateSimpleThread(
+        readers.back(), "StorageReader" + base::IntToString(i)));
+  }
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i]->Start();
+
+  // Installs, updates and uninstalls meanwhile, as xwalkctl would. Nothing
+  // returns before the readers are joined.
+  base::DictionaryValue manifest;
+  manifest.SetString(keys::kNameKey, "no name");
+  manifest.SetString(keys::kXWalkVersionKey, "0");
+  for (int i = 0; i < kApplicationCount; ++i) {
+    std::string error;
+    scoped_refptr<ApplicationData> application =
+        ApplicationData::Create(base::FilePath(),
+                                Manifest::INTERNAL,
+                                manifest,
+                                GenerateId(base::IntToString(i)),
+                                &error);
+    EXPECT_TRUE(application);
+    if (!application)
+      continue;
+    EXPECT_TRUE(app_storage_impl_->AddApplication(application.get(),
+                                                  base::Time::Now()));
+    EXPECT_TRUE(app_storage_impl_->UpdateApplication(application.get(),
+                                                     base::Time::Now()));
+    if (i % 2)
+      EXPECT_TRUE(app_storage_impl_->RemoveApplication(application->ID()));
+  }
+
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i]->Join();
+
+  for (size_t i = 0; i < readers.size(); ++i)
+    EXPECT_EQ(0, readers[i]->failures());
+
+  std::vector<std::string> ids;
+  ASSERT_TRUE(app_storage_impl_->GetInstalledApplicationIDs(ids));
+  EXPECT_EQ(static_cast<size_t>(kApplicationCount / 2), ids.size());
+}
+
 }  // namespace application
 }  // namespace xwalk
@@ -19,6 +19,8 @@ const char kGeneratedMainDocumentFilename[] =
     "_generated_main_document.html";
 const base::FilePath::CharType kCookieDatabaseFilename[] =
     FILE_PATH_LITERAL("ApplicationCookies");
+const base::FilePath::CharType kPackedResourcesFilename[] =
+    FILE_PATH_LITERAL("resources.pak");
 
 }  // namespace application
 }  // namespace xwalk
@@ -28,6 +28,10 @@ extern const char kGeneratedMainDocumentFilename[];
 // The name of cookies database file.
 extern const base::FilePath::CharType kCookieDatabaseFilename[];
 
+// The name of the original package kept in the application directory when
+// its resources are served from the archive instead of extracted files.
+extern const base::FilePath::CharType kPackedResourcesFilename[];
+
 }  // namespace application
 }  // namespace xwalk
 
@@ -6,47 +6,57 @@
 
 #include "base/files/file_path.h"
 #include "base/strings/string_util.h"
-#include "base/strings/string_number_conversions.h"
 #include "crypto/sha2.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 #include "xwalk/application/common/manifest_handlers/tizen_application_handler.h"
 
-#if defined(OS_TIZEN)
-#include "third_party/re2/re2/re2.h"
-#endif
-
 namespace xwalk {
 namespace application {
 namespace {
 #if defined(OS_TIZEN)
-const char kWGTAppIdPattern[] = "\\A([0-9a-zA-Z]{10})[.][0-9a-zA-Z]{1,52}\\z";
-const char kXPKAppIdPattern[] = "\\Axwalk[.]([a-p]{32})\\z";
-const std::string kAppIdPrefix("xwalk.");
+// The WGT ids are "<10 alphanumerics package id>.<1 to 52 alphanumerics>",
+// the XPK ids "xwalk.<32 characters of the id alphabet>".
+const size_t kWGTPackageIdSize = 10;
+const size_t kWGTMaxNameSize = 52;
+const char kAppIdPrefix[] = "xwalk.";
+const size_t kAppIdPrefixSize = arraysize(kAppIdPrefix) - 1;
 #endif
 const size_t kIdSize = 16;
-}  // namespace
 
-// Converts a normal hexadecimal string into the alphabet used by applications.
-// We use the characters 'a'-'p' instead of '0'-'f' to avoid ever having a
-// completely numeric host, since some software interprets that as an IP
-// address.
-static void ConvertHexadecimalToIDAlphabet(std::string* id) {
-  for (size_t i = 0; i < id->size(); ++i) {
-    int val;
-    if (base::HexStringToInt(base::StringPiece(
-            id->begin() + i, id->begin() + i + 1), &val)) {
-      (*id)[i] = val + 'a';
-    } else {
-      (*id)[i] = 'a';
-    }
+// Whether |id| only has characters of the id alphabet, in any case.
+bool IsIDAlphabet(const std::string& id, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    char c = ToLowerASCII(id[i]);
+    if (c < 'a' || c > 'p')
+      return false;
   }
+  return true;
 }
 
+#if defined(OS_TIZEN)
+bool IsAlphanumeric(const std::string& id, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    if (!IsAsciiDigit(id[i]) && !IsAsciiAlpha(id[i]))
+      return false;
+  }
+  return true;
+}
+#endif
+
+}  // namespace
+
+// Encodes the hash with the alphabet used by applications, one character per
+// nibble. We use the characters 'a'-'p' instead of '0'-'f' to avoid ever
+// having a completely numeric host, since some software interprets that as
+// an IP address.
 std::string GenerateId(const std::string& input) {
   uint8 hash[kIdSize];
   crypto::SHA256HashString(input, hash, sizeof(hash));
-  std::string output = StringToLowerASCII(base::HexEncode(hash, sizeof(hash)));
-  ConvertHexadecimalToIDAlphabet(&output);
+  std::string output(kIdSize * 2, 'a');
+  for (size_t i = 0; i < kIdSize; ++i) {
+    output[i * 2] += hash[i] >> 4;
+    output[i * 2 + 1] += hash[i] & 0xf;
+  }
 
 #if defined(OS_TIZEN)
   return kAppIdPrefix + output;
@@ -64,11 +74,23 @@ std::string GenerateIdForPath(const base::FilePath& path) {
 
 #if defined(OS_TIZEN)
 bool IsValidWGTID(const std::string& id) {
-  return RE2::FullMatch(id, kWGTAppIdPattern);
+  return id.size() > kWGTPackageIdSize + 1 &&
+      id.size() <= kWGTPackageIdSize + 1 + kWGTMaxNameSize &&
+      id[kWGTPackageIdSize] == '.' &&
+      IsAlphanumeric(id, 0, kWGTPackageIdSize) &&
+      IsAlphanumeric(id, kWGTPackageIdSize + 1, id.size());
 }
 
 bool IsValidXPKID(const std::string& id) {
-  return RE2::FullMatch(id, kXPKAppIdPattern);
+  // Unlike the ids of the other platforms, only in lowercase.
+  if (id.size() != kAppIdPrefixSize + kIdSize * 2 ||
+      id.compare(0, kAppIdPrefixSize, kAppIdPrefix) != 0)
+    return false;
+  for (size_t i = kAppIdPrefixSize; i < id.size(); ++i) {
+    if (id[i] < 'a' || id[i] > 'p')
+      return false;
+  }
+  return true;
 }
 #endif
 
@@ -80,30 +102,19 @@ bool IsValidApplicationID(const std::string& id) {
   return false;
 #endif
 
-  std::string temp = StringToLowerASCII(id);
-  // Verify that the id is legal.
-  if (temp.size() != (kIdSize * 2))
-    return false;
-
   // We only support lowercase IDs, because IDs can be used as URL components
   // (where GURL will lowercase it).
-  for (size_t i = 0; i < temp.size(); ++i)
-    if (temp[i] < 'a' || temp[i] > 'p')
-      return false;
-
-  return true;
+  return id.size() == kIdSize * 2 && IsIDAlphabet(id, 0, id.size());
 }
 
 #if defined(OS_TIZEN)
 std::string GetPackageIdFromAppId(const std::string& app_id) {
-  std::string package_id;
-  if (RE2::FullMatch(app_id, kWGTAppIdPattern, &package_id) ||
-      RE2::FullMatch(app_id, kXPKAppIdPattern, &package_id)) {
-    return package_id;
-  } else {
-    LOG(ERROR) << "Cannot get package_id from invalid app id";
-    return app_id;
-  }
+  if (IsValidWGTID(app_id))
+    return app_id.substr(0, kWGTPackageIdSize);
+  if (IsValidXPKID(app_id))
+    return app_id.substr(kAppIdPrefixSize);
+  LOG(ERROR) << "Cannot get package_id from invalid app id";
+  return app_id;
 }
 #endif
 
@@ -52,5 +52,22 @@ TEST(IDUtilTest, IsValidApplicationID) {
   EXPECT_FALSE(IsValidApplicationID("abcdefghijklmnopabcdefghijklmno0"));
 }
 
+#if defined(OS_TIZEN)
+TEST(IDUtilTest, TizenApplicationID) {
+  EXPECT_TRUE(IsValidWGTID("ab3DEfgh1j.Name1"));
+  EXPECT_FALSE(IsValidWGTID("ab3DEfgh1j."));
+  EXPECT_FALSE(IsValidWGTID("ab3DEfgh1.Name1"));
+  EXPECT_FALSE(IsValidWGTID("ab3DEfgh1j.Na_me"));
+  EXPECT_FALSE(IsValidWGTID("ab3DEfgh1j." + std::string(53, 'a')));
+  EXPECT_TRUE(IsValidXPKID("xwalk.abcdefghijklmnopabcdefghijklmnop"));
+  EXPECT_FALSE(IsValidXPKID("xwalk.ABCDEFGHIJKLMNOPABCDEFGHIJKLMNOP"));
+  EXPECT_FALSE(IsValidXPKID("xwalkxabcdefghijklmnopabcdefghijklmnop"));
+
+  EXPECT_EQ("ab3DEfgh1j", GetPackageIdFromAppId("ab3DEfgh1j.Name1"));
+  EXPECT_EQ("abcdefghijklmnopabcdefghijklmnop",
+            GetPackageIdFromAppId("xwalk.abcdefghijklmnopabcdefghijklmnop"));
+}
+#endif
+
 }  // namespace application
 }  // namespace xwalk
@@ -4,11 +4,19 @@
 
 #include "xwalk/application/common/installer/package.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "base/callback.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/path_service.h"
-#include "third_party/zlib/google/zip.h"
+#include "base/synchronization/lock.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
+#include "third_party/zlib/google/zip_reader.h"
 #include "xwalk/application/common/id_util.h"
 #include "xwalk/application/common/installer/wgt_package.h"
 #include "xwalk/application/common/installer/xpk_package.h"
@@ -16,10 +24,137 @@
 namespace xwalk {
 namespace application {
 
+namespace {
+
+// Inflating doesn't need much memory, but every worker keeps its own file
+// and zlib state, so don't spawn more of them on low memory devices.
+const int kMaxExtractionWorkers = 8;
+const int kMemoryPerExtractionWorkerMB = 128;
+
+int GetExtractionWorkerCount(size_t entry_count) {
+  int workers = std::min(base::SysInfo::NumberOfProcessors(),
+                         kMaxExtractionWorkers);
+  workers = std::min(workers, static_cast<int>(
+      base::SysInfo::AmountOfPhysicalMemoryMB() /
+      kMemoryPerExtractionWorkerMB));
+  return std::max(1, std::min(workers, static_cast<int>(entry_count)));
+}
+
+// State shared by the shards of an extraction.
+class ParallelExtraction {
+ public:
+  static const int kNoFailure = -1;
+
+  ParallelExtraction(const base::FilePath& source_path,
+                     const base::FilePath& target_dir,
+                     int64 total_size,
+                     const Package::ExtractProgressCallback& progress)
+      : source_path_(source_path),
+        target_dir_(target_dir),
+        total_size_(total_size),
+        extracted_size_(0),
+        failed_entry_(kNoFailure),
+        progress_(progress) {}
+
+  const base::FilePath& source_path() const { return source_path_; }
+  const base::FilePath& target_dir() const { return target_dir_; }
+
+  // Entries after a failed one are skipped, but the ones before still run,
+  // so the failure reported is always the first one in the package order,
+  // as if the extraction was serial.
+  bool ShouldExtract(int index) {
+    base::AutoLock lock(lock_);
+    return failed_entry_ == kNoFailure || index < failed_entry_;
+  }
+
+  void OnEntryFailed(int index) {
+    base::AutoLock lock(lock_);
+    if (failed_entry_ == kNoFailure || index < failed_entry_)
+      failed_entry_ = index;
+  }
+
+  // Progress is run on the extracting thread, one call at a time.
+  void OnEntryExtracted(int64 size) {
+    base::AutoLock lock(lock_);
+    extracted_size_ += size;
+    if (!progress_.is_null())
+      progress_.Run(extracted_size_, total_size_);
+  }
+
+  int failed_entry() const { return failed_entry_; }
+
+ private:
+  const base::FilePath source_path_;
+  const base::FilePath target_dir_;
+  const int64 total_size_;
+  int64 extracted_size_;
+  int failed_entry_;
+  Package::ExtractProgressCallback progress_;
+  base::Lock lock_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelExtraction);
+};
+
+// Extracts a set of entries with its own reader, minizip handles can't be
+// shared between threads.
+class ExtractionShard : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit ExtractionShard(ParallelExtraction* extraction)
+      : extraction_(extraction) {}
+
+  void AddEntry(int index) { entries_.push_back(index); }
+  // The reader only moves forward.
+  void SortEntries() { std::sort(entries_.begin(), entries_.end()); }
+
+  virtual void Run() OVERRIDE {
+    if (entries_.empty())
+      return;
+
+    zip::ZipReader reader;
+    if (!reader.Open(extraction_->source_path())) {
+      extraction_->OnEntryFailed(entries_.front());
+      return;
+    }
+
+    int current = 0;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      const int index = entries_[i];
+      if (!extraction_->ShouldExtract(index))
+        return;
+      for (; current < index; ++current) {
+        if (!reader.AdvanceToNextEntry()) {
+          extraction_->OnEntryFailed(index);
+          return;
+        }
+      }
+      if (!reader.OpenCurrentEntryInZip() ||
+          reader.current_entry_info()->is_unsafe() ||
+          !reader.ExtractCurrentEntryIntoDirectory(
+              extraction_->target_dir())) {
+        extraction_->OnEntryFailed(index);
+        return;
+      }
+      extraction_->OnEntryExtracted(
+          reader.current_entry_info()->original_size());
+    }
+  }
+
+ private:
+  ParallelExtraction* extraction_;
+  std::vector<int> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ExtractionShard);
+};
+
+}  // namespace
+
+const int64 Package::kParallelExtractionThreshold = 16 * 1024 * 1024;
+
 Package::Package(const base::FilePath& source_path)
     : source_path_(source_path),
       is_extracted_(false),
-      is_valid_(false) {
+      is_valid_(false),
+      extraction_mode_(EXTRACT_AUTO) {
 }
 
 Package::~Package() {
@@ -53,7 +188,7 @@ bool Package::Extract(base::FilePath* target_path) {
     return false;
   }
 
-  if (!zip::Unzip(source_path_, temp_dir_.path())) {
+  if (!ExtractToDirectory(temp_dir_.path(), ExtractProgressCallback())) {
     LOG(ERROR) << "An error occurred during package extraction";
     return false;
   }
@@ -64,6 +199,81 @@ bool Package::Extract(base::FilePath* target_path) {
   return true;
 }
 
+bool Package::ExtractToDirectory(const base::FilePath& target_dir,
+                                 const ExtractProgressCallback& progress) {
+  // The sizes come from the central directory, no entry data is read.
+  std::vector<int64> entry_sizes;
+  int64 total_size = 0;
+  {
+    zip::ZipReader reader;
+    if (!reader.Open(source_path_)) {
+      LOG(ERROR) << "Can't open the package " << source_path_.value();
+      return false;
+    }
+    entry_sizes.reserve(reader.num_entries());
+    while (reader.HasMore()) {
+      if (!reader.OpenCurrentEntryInZip()) {
+        LOG(ERROR) << "Can't read a package entry";
+        return false;
+      }
+      entry_sizes.push_back(reader.current_entry_info()->original_size());
+      total_size += entry_sizes.back();
+      if (!reader.AdvanceToNextEntry())
+        return false;
+    }
+  }
+
+  int workers = 1;
+  if (extraction_mode_ != EXTRACT_SERIAL &&
+      (extraction_mode_ == EXTRACT_PARALLEL ||
+       total_size >= kParallelExtractionThreshold))
+    workers = GetExtractionWorkerCount(entry_sizes.size());
+
+  ParallelExtraction extraction(source_path_, target_dir, total_size,
+                                progress);
+  if (workers <= 1) {
+    ExtractionShard shard(&extraction);
+    for (size_t i = 0; i < entry_sizes.size(); ++i)
+      shard.AddEntry(i);
+    shard.Run();
+  } else {
+    // Largest entries first, each one to the least loaded shard, so the
+    // assignment only depends on the package.
+    std::vector<std::pair<int64, int> > by_size;
+    for (size_t i = 0; i < entry_sizes.size(); ++i)
+      by_size.push_back(
+          std::make_pair(-entry_sizes[i], static_cast<int>(i)));
+    std::sort(by_size.begin(), by_size.end());
+
+    ScopedVector<ExtractionShard> shards;
+    std::vector<int64> loads(workers, 0);
+    for (int i = 0; i < workers; ++i)
+      shards.push_back(new ExtractionShard(&extraction));
+    for (size_t i = 0; i < by_size.size(); ++i) {
+      size_t shard = std::min_element(loads.begin(), loads.end()) -
+          loads.begin();
+      loads[shard] -= by_size[i].first;
+      shards[shard]->AddEntry(by_size[i].second);
+    }
+
+    base::DelegateSimpleThreadPool pool("PackageExtraction", workers);
+    pool.Start();
+    for (size_t i = 0; i < shards.size(); ++i) {
+      shards[i]->SortEntries();
+      pool.AddWork(shards[i]);
+    }
+    pool.JoinAll();
+  }
+
+  if (extraction.failed_entry() != ParallelExtraction::kNoFailure) {
+    LOG(ERROR) << "Can't extract the entry " << extraction.failed_entry()
+               << " of " << source_path_.value();
+    return false;
+  }
+
+  return true;
+}
+
 // Create a temporary directory to decompress the zipped package file.
 // As the package information might already exists under data_path,
 // it's safer to extract the XPK/WGT file into a temporary directory first.
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 
+#include "base/basictypes.h"
+#include "base/callback_forward.h"
 #include "base/files/file_path.h"
 #include "base/files/scoped_file.h"
 #include "base/files/scoped_temp_dir.h"
@@ -27,6 +29,22 @@ class Package {
     XPK
   };
 
+  enum ExtractionMode {
+    // Parallel for packages bigger than kParallelExtractionThreshold.
+    EXTRACT_AUTO,
+    EXTRACT_SERIAL,
+    EXTRACT_PARALLEL
+  };
+
+  // Uncompressed size from which the entries are inflated by a pool of
+  // threads, bounded by the number of cores and the amount of memory.
+  static const int64 kParallelExtractionThreshold;
+
+  // Called after each extracted entry with the number of uncompressed bytes
+  // written so far and the total uncompressed size of the package.
+  typedef base::Callback<void(int64 extracted, int64 total)>
+      ExtractProgressCallback;
+
   virtual ~Package();
   bool IsValid() const { return is_valid_; }
   const std::string& Id() const { return id_; }
@@ -36,6 +54,15 @@ class Package {
   // The function will unzip the XPK/WGT file and return the target path where
   // to decompress by the parameter |target_path|.
   virtual bool Extract(base::FilePath* target_path);
+  // Inflates the package entries straight into |target_dir|, which must
+  // exist. Unlike Extract() nothing is staged in the temporary directory, so
+  // when |target_dir| is on the same file system as the final location of
+  // the application the content only needs to be renamed afterwards.
+  // |progress| can be null, and is run on the extracting threads.
+  virtual bool ExtractToDirectory(const base::FilePath& target_dir,
+                                  const ExtractProgressCallback& progress);
+  bool is_extracted() const { return is_extracted_; }
+  void set_extraction_mode(ExtractionMode mode) { extraction_mode_ = mode; }
 
  protected:
   explicit Package(const base::FilePath& source_path);
@@ -50,6 +77,7 @@ class Package {
   // Represent if the package has been extracted.
   bool is_extracted_;
   Type type_;
+  ExtractionMode extraction_mode_;
 };
 
 }  // namespace application
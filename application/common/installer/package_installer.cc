@@ -5,22 +5,30 @@
 #include "xwalk/application/common/installer/package_installer.h"
 
 #include <sys/types.h>
+#if defined(OS_POSIX)
+#include <unistd.h>
+#endif
 #include <algorithm>
 #include <map>
 #include <string>
 
+#include "base/bind.h"
 #include "base/file_util.h"
 #include "base/files/file_enumerator.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/logging.h"
 #include "base/path_service.h"
 #include "base/command_line.h"
 #include "base/process/launch.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/timer/elapsed_timer.h"
 #include "base/version.h"
 #include "xwalk/application/common/application_data.h"
 #include "xwalk/application/common/application_file_util.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 #include "xwalk/application/common/permission_policy_manager.h"
 #include "xwalk/application/common/application_storage.h"
+#include "xwalk/application/common/constants.h"
 #include "xwalk/application/common/id_util.h"
 #include "xwalk/application/common/installer/tizen/packageinfo_constants.h"
 #include "xwalk/runtime/common/xwalk_paths.h"
@@ -50,13 +58,129 @@ bool CopyDirectoryContents(const base::FilePath& from,
   return true;
 }
 
+void OnExtractProgress(int64* extracted_size, int64 extracted, int64 total) {
+  *extracted_size = extracted;
+  VLOG(1) << "Extracted " << extracted << " of " << total << " bytes.";
+}
+
+// Unpacks |package| into a new directory under |data_dir|, so moving it to
+// the application directory afterwards is a rename rather than a copy. The
+// directory is removed by |staging_dir| unless it's taken over.
+bool ExtractPackage(Package* package, const base::FilePath& data_dir,
+                    base::ScopedTempDir* staging_dir) {
+  if (!staging_dir->CreateUniqueTempDirUnderPath(data_dir))
+    return false;
+
+  base::ElapsedTimer timer;
+  int64 extracted_size = 0;
+  if (!package->ExtractToDirectory(
+          staging_dir->path(),
+          base::Bind(&OnExtractProgress, &extracted_size))) {
+    LOG(ERROR) << "An error occurred during package extraction";
+    return false;
+  }
+
+  const double seconds = timer.Elapsed().InSecondsF();
+  LOG(INFO) << "Extracted " << extracted_size << " bytes in " << seconds
+            << "s (" << (seconds > 0 ? extracted_size / seconds / 1024 : 0)
+            << " KB/s).";
+  return true;
+}
+
+// Replaces the extracted resources in |app_dir| by a copy of |package_path|.
+// The manifest and messages files are still read from the directory when the
+// application is loaded, they are kept.
+bool PackResources(const base::FilePath& package_path,
+                   const base::FilePath& app_dir) {
+  if (!base::CopyFile(package_path, app_dir.Append(kPackedResourcesFilename)))
+    return false;
+
+  base::FileEnumerator iter(app_dir, false,
+      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = iter.Next(); !path.empty(); path = iter.Next()) {
+    const base::FilePath::StringType name = path.BaseName().value();
+    if (name == kPackedResourcesFilename || name == kManifestXpkFilename ||
+        name == kManifestWgtFilename || name == kMessagesFilename)
+      continue;
+    if (!base::DeleteFile(path, true))
+      return false;
+  }
+  return true;
+}
+
 const base::FilePath::CharType kApplicationsDir[] =
     FILE_PATH_LITERAL("applications");
 
 }  // namespace
 
+namespace internal {
+
+bool LinkOrCopyFile(const base::FilePath& from, const base::FilePath& to) {
+#if defined(OS_POSIX)
+  if (!link(from.value().c_str(), to.value().c_str()))
+    return true;
+#endif
+  return base::CopyFile(from, to);
+}
+
+bool BuildUpdatedDirectory(const base::FilePath& new_dir,
+                           const base::FilePath& installed_dir,
+                           const base::FilePath& staging_dir) {
+  if (!base::CreateDirectory(staging_dir))
+    return false;
+
+  int64 reused_size = 0;
+  int64 written_size = 0;
+  base::FileEnumerator iter(new_dir, true,
+      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath path = iter.Next(); !path.empty(); path = iter.Next()) {
+    base::FilePath relative_path;
+    if (!new_dir.AppendRelativePath(path, &relative_path))
+      return false;
+    const base::FilePath target = staging_dir.Append(relative_path);
+    if (iter.GetInfo().IsDirectory()) {
+      if (!base::CreateDirectory(target))
+        return false;
+      continue;
+    }
+
+    const int64 size = iter.GetInfo().GetSize();
+    const base::FilePath installed = installed_dir.Append(relative_path);
+    int64 installed_size;
+    if (base::GetFileSize(installed, &installed_size) &&
+        installed_size == size &&
+        base::ContentsEqual(path, installed)) {
+      if (!LinkOrCopyFile(installed, target))
+        return false;
+      reused_size += size;
+    } else {
+      if (!base::Move(path, target))
+        return false;
+      written_size += size;
+    }
+  }
+
+  LOG(INFO) << "Updated application content: " << written_size
+            << " bytes written, " << reused_size << " bytes unchanged.";
+  return true;
+}
+
+bool RestoreDirectory(const base::FilePath& app_dir,
+                      const base::FilePath& backup_dir) {
+  if (!base::DeleteFile(app_dir, true) || !base::Move(backup_dir, app_dir)) {
+    LOG(ERROR) << "Fail to roll back " << app_dir.value()
+               << ", the previous content is left at "
+               << backup_dir.value() << ".";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+
 PackageInstaller::PackageInstaller(ApplicationStorage* storage)
-    : storage_(storage) {
+    : storage_(storage),
+      keep_packed_(false) {
 }
 
 PackageInstaller::~PackageInstaller() {
@@ -103,9 +227,21 @@ bool PackageInstaller::Install(const base::FilePath& path, std::string* id) {
   std::string app_id;
   base::FilePath unpacked_dir;
   scoped_ptr<Package> package;
+  // Any failure before the content is moved in place removes it.
+  base::ScopedTempDir staging_dir;
   if (!base::DirectoryExists(path)) {
     package = Package::Create(path);
-    package->Extract(&unpacked_dir);
+    if (!package)
+      return false;
+    if (package->is_extracted()) {
+      // Already unpacked when opened (WGT), just reuse it.
+      if (!package->Extract(&unpacked_dir))
+        return false;
+    } else {
+      if (!ExtractPackage(package.get(), data_dir, &staging_dir))
+        return false;
+      unpacked_dir = staging_dir.path();
+    }
     app_id = package->Id();
   } else {
     unpacked_dir = path;
@@ -120,6 +256,14 @@ bool PackageInstaller::Install(const base::FilePath& path, std::string* id) {
     return false;
   }
 
+  // The data parsed lazily wouldn't fail the load, check it now.
+  base::string16 parse_error;
+  if (!app_data->ParseLazyManifestData(&parse_error)) {
+    LOG(ERROR) << "Error during application installation: "
+               << base::UTF16ToUTF8(parse_error);
+    return false;
+  }
+
   // FIXME: Probably should be removed, as we should not handle permissions
   // inside XWalk.
   PermissionPolicyManager permission_policy_handler;
@@ -148,6 +292,8 @@ bool PackageInstaller::Install(const base::FilePath& path, std::string* id) {
   } else {
     if (!base::Move(unpacked_dir, app_dir))
       return false;
+    if (!staging_dir.path().empty())
+      ignore_result(staging_dir.Take());
   }
 
   app_data->SetPath(app_dir);
@@ -167,6 +313,15 @@ bool PackageInstaller::Install(const base::FilePath& path, std::string* id) {
     return false;
   }
 
+  if (keep_packed_ && package && !PackResources(path, app_dir)) {
+    LOG(ERROR) << "Application with id " << app_data->ID()
+               << " couldn't be kept packed";
+    PlatformUninstall(app_data);
+    storage_->RemoveApplication(app_data->ID());
+    base::DeleteFile(app_dir, true);
+    return false;
+  }
+
   LOG(INFO) << "Installed application with id: " << app_data->ID()
             << "to" << app_dir.MaybeAsASCII() << " successfully.";
   *id = app_data->ID();
@@ -219,6 +374,13 @@ bool PackageInstaller::Update(const std::string& app_id,
     return false;
   }
 
+  base::string16 parse_error;
+  if (!new_app_data->ParseLazyManifestData(&parse_error)) {
+    LOG(ERROR) << "An error occurred during application updating: "
+               << base::UTF16ToUTF8(parse_error);
+    return false;
+  }
+
   scoped_refptr<ApplicationData> old_app_data =
       storage_->GetApplicationData(app_id);
   if (!old_app_data) {
@@ -244,10 +406,28 @@ bool PackageInstaller::Update(const std::string& app_id,
   const base::FilePath& app_dir = old_app_data->Path();
   const base::FilePath tmp_dir(app_dir.value()
                                + FILE_PATH_LITERAL(".tmp"));
+  const base::FilePath new_dir(app_dir.value()
+                               + FILE_PATH_LITERAL(".new"));
+
+  // The new content is assembled next to the installed one, reusing the
+  // files that didn't change, then both directories are swapped.
+  base::DeleteFile(new_dir, true);
+  if (!internal::BuildUpdatedDirectory(unpacked_dir, app_dir, new_dir)) {
+    LOG(ERROR) << "Fail to prepare the updated application content.";
+    base::DeleteFile(new_dir, true);
+    return false;
+  }
 
-  if (!base::Move(app_dir, tmp_dir) ||
-      !base::Move(unpacked_dir, app_dir))
+  if (!base::Move(app_dir, tmp_dir)) {
+    base::DeleteFile(new_dir, true);
     return false;
+  }
+  if (!base::Move(new_dir, app_dir)) {
+    LOG(ERROR) << "Fail to replace the application content.";
+    base::DeleteFile(new_dir, true);
+    internal::RestoreDirectory(app_dir, tmp_dir);
+    return false;
+  }
 
   new_app_data = LoadApplication(app_dir,
                                     app_id,
@@ -256,34 +436,37 @@ bool PackageInstaller::Update(const std::string& app_id,
                                     &error);
   if (!new_app_data) {
     LOG(ERROR) << "Error during loading new package: " << error;
-    base::DeleteFile(app_dir, true);
-    base::Move(tmp_dir, app_dir);
+    internal::RestoreDirectory(app_dir, tmp_dir);
     return false;
   }
 
   if (!storage_->UpdateApplication(new_app_data)) {
     LOG(ERROR) << "Fail to update application, roll back to the old one.";
-    base::DeleteFile(app_dir, true);
-    base::Move(tmp_dir, app_dir);
+    internal::RestoreDirectory(app_dir, tmp_dir);
     return false;
   }
 
   if (!PlatformUpdate(new_app_data)) {
     LOG(ERROR) << "Fail to update application, roll back to the old one.";
-    base::DeleteFile(app_dir, true);
     if (!storage_->UpdateApplication(old_app_data)) {
       LOG(ERROR) << "Fail to revert old application info, "
                  << "remove the application as a last resort.";
       storage_->RemoveApplication(old_app_data->ID());
+      base::DeleteFile(app_dir, true);
       base::DeleteFile(tmp_dir, true);
       return false;
     }
-    base::Move(tmp_dir, app_dir);
+    internal::RestoreDirectory(app_dir, tmp_dir);
     return false;
   }
 
   base::DeleteFile(tmp_dir, true);
 
+  // The update is complete at this point, the extracted files just stay if
+  // they can't be packed.
+  if (keep_packed_ && !PackResources(path, app_dir))
+    LOG(WARNING) << "Updated application " << app_id << " is not packed.";
+
   return true;
 }
 
@@ -25,6 +25,11 @@ class PackageInstaller {
   bool Uninstall(const std::string& id);
   bool Update(const std::string& id, const base::FilePath& path);
 
+  // When set, packages are kept as is in the application directory and their
+  // resources served from the archive, only the manifest and messages stay
+  // extracted.
+  void set_keep_packed(bool keep_packed) { keep_packed_ = keep_packed; }
+
  protected:
   explicit PackageInstaller(ApplicationStorage* storage);
   // Those to be overriden to implement platform specific logic.
@@ -33,8 +38,30 @@ class PackageInstaller {
   virtual bool PlatformUpdate(ApplicationData* updated_data);
 
   ApplicationStorage* storage_;
+  bool keep_packed_;
 };
 
+// Helpers used by PackageInstaller::Update(), exposed for testing.
+namespace internal {
+
+// Hard links |from| as |to| when possible, so identical resources don't get
+// written again, copies it otherwise.
+bool LinkOrCopyFile(const base::FilePath& from, const base::FilePath& to);
+
+// Fills |staging_dir| with the content of |new_dir|. Files whose content is
+// the same as in |installed_dir| are linked from there, only the ones that
+// changed are moved in from |new_dir|.
+bool BuildUpdatedDirectory(const base::FilePath& new_dir,
+                           const base::FilePath& installed_dir,
+                           const base::FilePath& staging_dir);
+
+// Replaces |app_dir| with |backup_dir|. Returns false, and logs where the
+// previous content is left, when it can't be put back.
+bool RestoreDirectory(const base::FilePath& app_dir,
+                      const base::FilePath& backup_dir);
+
+}  // namespace internal
+
 }  // namespace application
 }  // namespace xwalk
 
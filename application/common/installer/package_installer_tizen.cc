@@ -4,6 +4,7 @@
 
 #include "xwalk/application/common/installer/package_installer_tizen.h"
 
+#include <sys/socket.h>
 #include <sys/types.h>
 #include <pwd.h>
 #include <unistd.h>
@@ -14,18 +15,25 @@
 
 #include "base/file_util.h"
 #include "base/files/file_enumerator.h"
+#include "base/files/scoped_file.h"
 #include "base/logging.h"
 #include "base/path_service.h"
+#include "base/posix/eintr_wrapper.h"
 #include "base/command_line.h"
+#include "base/process/kill.h"
 #include "base/process/launch.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
 #include "third_party/libxml/chromium/libxml_utils.h"
 #include "xwalk/application/common/application_data.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 #include "xwalk/application/common/manifest_handlers/tizen_application_handler.h"
 #include "xwalk/application/common/manifest_handlers/tizen_metadata_handler.h"
+#include "xwalk/application/common/manifest_handlers/tizen_splash_screen_handler.h"
 #include "xwalk/application/common/application_storage.h"
 #include "xwalk/application/common/installer/tizen/packageinfo_constants.h"
 #include "xwalk/application/common/id_util.h"
+#include "xwalk/application/common/splash_screen_cache_tizen.h"
 #include "xwalk/runtime/common/xwalk_paths.h"
 
 namespace info = xwalk::application_packageinfo_constants;
@@ -36,6 +44,11 @@ namespace widget_keys = xwalk::application_widget_keys;
 
 const base::FilePath kPkgHelper("/usr/bin/xwalk-pkg-helper");
 
+// Must match xwalk_package_helper.cc.
+const char kPkgHelperBatchSwitch[] = "--batch";
+const char kPkgHelperBatchGreeting[] = "xwalk-pkg-helper-batch: 1";
+const char kPkgHelperResultPrefix[] = "xwalk-pkg-helper-result: ";
+
 const base::FilePath kXWalkLauncherBinary("/usr/bin/xwalk-launcher");
 
 const base::FilePath kDefaultIcon(
@@ -160,13 +173,202 @@ bool CreateAppSymbolicLink(const base::FilePath& app_dir,
   return true;
 }
 
+// Decodes the splash screen now rather than while the application starts.
+// Launching still works without the cache, so failures are not fatal.
+void CacheSplashScreen(xwalk::application::ApplicationData* application) {
+  xwalk::application::TizenSplashScreenInfo* info =
+      static_cast<xwalk::application::TizenSplashScreenInfo*>(
+      application->GetManifestData(widget_keys::kTizenSplashScreenKey));
+  if (!info || info->src().empty())
+    return;
+
+  base::FilePath image = application->Path().AppendASCII(info->src());
+  if (!xwalk::application::WriteSplashScreenCache(image))
+    LOG(WARNING) << "Could not cache the splash screen '"
+                 << image.value() << "'.";
+}
+
 }  // namespace
 
 namespace xwalk {
 namespace application {
 
+// The helper in batch mode, reading the commands from a socket mapped to
+// its standard input and writing their output and results to it.
+class PackageInstallerTizen::PkgHelperProcess {
+ public:
+  enum Result {
+    // The helper has no batch mode, the command wasn't sent.
+    RESULT_NO_BATCH_MODE,
+    // The helper went away with the command, which may have been run.
+    RESULT_FAILED,
+    // |success| is set to the result of the command.
+    RESULT_DONE
+  };
+
+  PkgHelperProcess()
+      : process_(base::kNullProcessHandle),
+        has_batch_mode_(true) {}
+
+  ~PkgHelperProcess() {
+    Shutdown();
+  }
+
+  Result Run(const std::vector<std::string>& args,
+             bool* success,
+             std::string* output) {
+    if (!has_batch_mode_)
+      return RESULT_NO_BATCH_MODE;
+    if (process_ == base::kNullProcessHandle && !Start())
+      return has_batch_mode_ ? RESULT_FAILED : RESULT_NO_BATCH_MODE;
+
+    // The number of arguments, then each of them as its length and its
+    // bytes: the arguments are taken from the package, no separator they
+    // contain can split them or start another command.
+    std::string command = base::Uint64ToString(args.size()) + "\n";
+    for (size_t i = 0; i < args.size(); ++i)
+      command += base::Uint64ToString(args[i].size()) + ":" + args[i];
+    if (!WriteAll(command)) {
+      Shutdown();
+      return RESULT_FAILED;
+    }
+
+    output->clear();
+    std::string line;
+    while (ReadLine(&line)) {
+      if (StartsWithASCII(line, kPkgHelperResultPrefix, true)) {
+        *success = line.substr(strlen(kPkgHelperResultPrefix)) == "0";
+        return RESULT_DONE;
+      }
+      output->append(line + "\n");
+    }
+    Shutdown();
+    return RESULT_FAILED;
+  }
+
+ private:
+  // Returns false if the helper could not be started, |has_batch_mode_| is
+  // reset if it doesn't greet as a batch one.
+  bool Start() {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+      PLOG(ERROR) << "Could not create the socket of the helper.";
+      return false;
+    }
+    socket_.reset(fds[0]);
+    base::ScopedFD child_socket(fds[1]);
+
+    base::FileHandleMappingVector fds_to_remap;
+    fds_to_remap.push_back(std::make_pair(fds[1], STDIN_FILENO));
+    fds_to_remap.push_back(std::make_pair(fds[1], STDOUT_FILENO));
+    base::LaunchOptions options;
+    options.fds_to_remap = &fds_to_remap;
+
+    CommandLine cmdline(kPkgHelper);
+    cmdline.AppendSwitch(kPkgHelperBatchSwitch);
+    if (!base::LaunchProcess(cmdline, options, &process_)) {
+      process_ = base::kNullProcessHandle;
+      socket_.reset();
+      return false;
+    }
+
+    // Older helpers print their usage and exit.
+    std::string greeting;
+    if (!ReadLine(&greeting) || greeting != kPkgHelperBatchGreeting) {
+      has_batch_mode_ = false;
+      Shutdown();
+      return false;
+    }
+    return true;
+  }
+
+  void Shutdown() {
+    if (process_ == base::kNullProcessHandle)
+      return;
+
+    // The helper exits once its input is closed.
+    socket_.reset();
+    buffer_.clear();
+    int exit_code;
+    base::WaitForExitCode(process_, &exit_code);
+    base::CloseProcessHandle(process_);
+    process_ = base::kNullProcessHandle;
+  }
+
+  bool WriteAll(const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+      ssize_t rv = HANDLE_EINTR(send(socket_.get(), data.data() + written,
+                                     data.size() - written, MSG_NOSIGNAL));
+      if (rv <= 0)
+        return false;
+      written += rv;
+    }
+    return true;
+  }
+
+  bool ReadLine(std::string* line) {
+    size_t end;
+    while ((end = buffer_.find('\n')) == std::string::npos) {
+      char data[256];
+      ssize_t rv = HANDLE_EINTR(read(socket_.get(), data, sizeof(data)));
+      if (rv <= 0)
+        return false;
+      buffer_.append(data, rv);
+    }
+    line->assign(buffer_, 0, end);
+    buffer_.erase(0, end + 1);
+    return true;
+  }
+
+  base::ProcessHandle process_;
+  bool has_batch_mode_;
+  base::ScopedFD socket_;
+  std::string buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(PkgHelperProcess);
+};
+
 PackageInstallerTizen::PackageInstallerTizen(ApplicationStorage* storage)
-    : PackageInstaller(storage) {
+    : PackageInstaller(storage),
+      pkg_helper_(new PkgHelperProcess) {
+}
+
+PackageInstallerTizen::~PackageInstallerTizen() {
+}
+
+bool PackageInstallerTizen::RunPkgHelper(const std::vector<std::string>& args,
+                                         std::string* output) {
+  bool success = false;
+  switch (pkg_helper_->Run(args, &success, output)) {
+    case PkgHelperProcess::RESULT_DONE:
+      if (!success)
+        LOG(ERROR) << "The installation helper failed: " << *output;
+      return success;
+    case PkgHelperProcess::RESULT_FAILED:
+      // Running the command again could apply it twice.
+      LOG(ERROR) << "The installation helper exited while running a command.";
+      return false;
+    case PkgHelperProcess::RESULT_NO_BATCH_MODE:
+      break;
+  }
+
+  // Older helpers have no batch mode.
+  CommandLine cmdline(kPkgHelper);
+  for (size_t i = 0; i < args.size(); ++i)
+    cmdline.AppendArg(args[i]);
+
+  int exit_code;
+  if (!base::GetAppOutputWithExitCode(cmdline, output, &exit_code)) {
+    LOG(ERROR) << "Could not launch the installation helper process.";
+    return false;
+  }
+  if (exit_code != 0) {
+    LOG(ERROR) << "The installation helper failed: "
+               << *output << " (" << exit_code << ")";
+    return false;
+  }
+  return true;
 }
 
 bool PackageInstallerTizen::PlatformInstall(ApplicationData* app_data) {
@@ -200,26 +402,18 @@ bool PackageInstallerTizen::PlatformInstall(ApplicationData* app_data) {
   base::FilePath icon =
       icon_name.empty() ? kDefaultIcon : app_dir.AppendASCII(icon_name);
 
-  CommandLine cmdline(kPkgHelper);
-  cmdline.AppendSwitch("--install");
-  cmdline.AppendArg(app_id);
-  cmdline.AppendArgPath(xml_path);
-  cmdline.AppendArgPath(icon);
-
-  int exit_code;
+  std::vector<std::string> args;
+  args.push_back("--install");
+  args.push_back(app_id);
+  args.push_back(xml_path.value());
+  args.push_back(icon.value());
   std::string output;
-
-  if (!base::GetAppOutputWithExitCode(cmdline, &output, &exit_code)) {
-    LOG(ERROR) << "Could not launch the installation helper process.";
-    return false;
-  }
-
-  if (exit_code != 0) {
-    LOG(ERROR) << "Could not install application: "
-               << output << " (" << exit_code << ")";
+  if (!RunPkgHelper(args, &output)) {
+    LOG(ERROR) << "Could not install application " << app_id;
     return false;
   }
 
+  CacheSplashScreen(app_data);
   app_dir_cleaner.Dismiss();
 
   return true;
@@ -231,21 +425,12 @@ bool PackageInstallerTizen::PlatformUninstall(ApplicationData* app_data) {
   base::FilePath data_dir;
   CHECK(PathService::Get(xwalk::DIR_DATA_PATH, &data_dir));
 
-  CommandLine cmdline(kPkgHelper);
-  cmdline.AppendSwitch("--uninstall");
-  cmdline.AppendArg(app_id);
-
-  int exit_code;
+  std::vector<std::string> args;
+  args.push_back("--uninstall");
+  args.push_back(app_id);
   std::string output;
-
-  if (!base::GetAppOutputWithExitCode(cmdline, &output, &exit_code)) {
-    LOG(ERROR) << "Could not launch installer helper";
-    result = false;
-  }
-
-  if (exit_code != 0) {
-    LOG(ERROR) << "Could not uninstall application: "
-               << output << " (" << exit_code << ")";
+  if (!RunPkgHelper(args, &output)) {
+    LOG(ERROR) << "Could not uninstall application " << app_id;
     result = false;
   }
 
@@ -296,29 +481,21 @@ bool PackageInstallerTizen::PlatformUpdate(ApplicationData* app_data) {
   base::FilePath icon =
       icon_name.empty() ? kDefaultIcon : app_dir.AppendASCII(icon_name);
 
-  CommandLine cmdline(kPkgHelper);
-  cmdline.AppendSwitch("--update");
-  cmdline.AppendArg(app_id);
-  cmdline.AppendArgPath(new_xml_path);
-  cmdline.AppendArgPath(icon);
-
-  int exit_code;
+  std::vector<std::string> args;
+  args.push_back("--update");
+  args.push_back(app_id);
+  args.push_back(new_xml_path.value());
+  args.push_back(icon.value());
   std::string output;
-
-  if (!base::GetAppOutputWithExitCode(cmdline, &output, &exit_code)) {
-    LOG(ERROR) << "Could not launch installer helper";
-    return false;
-  }
-
-  if (exit_code != 0) {
-    LOG(ERROR) << "Could not update application: "
-               << output << " (" << exit_code << ")";
+  if (!RunPkgHelper(args, &output)) {
+    LOG(ERROR) << "Could not update application " << app_id;
     return false;
   }
 
   base::FilePath old_xml_path = data_dir.AppendASCII(info::kAppDir).AppendASCII(
       app_id + std::string(info::kXmlExtension));
   base::Move(new_xml_path, old_xml_path);
+  CacheSplashScreen(app_data);
   app_dir_cleaner.Dismiss();
   return true;
 }
@@ -6,7 +6,9 @@
 #define XWALK_APPLICATION_COMMON_INSTALLER_PACKAGE_INSTALLER_TIZEN_H_
 
 #include <string>
+#include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "xwalk/application/common/installer/package_installer.h"
 
 namespace xwalk {
@@ -15,11 +17,24 @@ namespace application {
 class PackageInstallerTizen : public PackageInstaller {
  public:
   explicit PackageInstallerTizen(ApplicationStorage* storage);
+  virtual ~PackageInstallerTizen();
 
  private:
+  class PkgHelperProcess;
+
   virtual bool PlatformInstall(ApplicationData* data) OVERRIDE;
   virtual bool PlatformUninstall(ApplicationData* data) OVERRIDE;
   virtual bool PlatformUpdate(ApplicationData* data) OVERRIDE;
+
+  // Runs the installation helper with |args|. It is started once and kept
+  // for all the operations of this installer, installing many applications
+  // doesn't spawn it for each of them.
+  bool RunPkgHelper(const std::vector<std::string>& args,
+                    std::string* output);
+
+  scoped_ptr<PkgHelperProcess> pkg_helper_;
+
+  DISALLOW_COPY_AND_ASSIGN(PackageInstallerTizen);
 };
 
 }  // namespace application
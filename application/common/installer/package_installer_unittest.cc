@@ -0,0 +1,126 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/installer/package_installer.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+bool WriteString(const base::FilePath& path, const std::string& data) {
+  return base::WriteFile(path, data.data(), data.size()) ==
+      static_cast<int>(data.size());
+}
+
+std::string ReadString(const base::FilePath& path) {
+  std::string data;
+  base::ReadFileToString(path, &data);
+  return data;
+}
+
+}  // namespace
+
+class PackageInstallerTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    installed_dir_ = temp_dir_.path().AppendASCII("app");
+    new_dir_ = temp_dir_.path().AppendASCII("extracted");
+    staging_dir_ = temp_dir_.path().AppendASCII("app.new");
+    ASSERT_TRUE(base::CreateDirectory(installed_dir_));
+    ASSERT_TRUE(base::CreateDirectory(new_dir_));
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath installed_dir_;
+  base::FilePath new_dir_;
+  base::FilePath staging_dir_;
+};
+
+TEST_F(PackageInstallerTest, LinkOrCopyFile) {
+  const base::FilePath from = installed_dir_.AppendASCII("index.html");
+  const base::FilePath to = new_dir_.AppendASCII("index.html");
+  ASSERT_TRUE(WriteString(from, "unchanged"));
+
+  EXPECT_TRUE(internal::LinkOrCopyFile(from, to));
+  EXPECT_EQ("unchanged", ReadString(to));
+
+#if defined(OS_POSIX)
+  // A hard link shares the content with the original file.
+  ASSERT_TRUE(WriteString(from, "rewritten"));
+  EXPECT_EQ("rewritten", ReadString(to));
+#endif
+}
+
+TEST_F(PackageInstallerTest, LinkOrCopyFileFallsBackToCopy) {
+  const base::FilePath from = installed_dir_.AppendASCII("index.html");
+  const base::FilePath to = new_dir_.AppendASCII("index.html");
+  ASSERT_TRUE(WriteString(from, "unchanged"));
+  // Linking fails over an existing file, the copy replaces it.
+  ASSERT_TRUE(WriteString(to, "stale"));
+
+  EXPECT_TRUE(internal::LinkOrCopyFile(from, to));
+  EXPECT_EQ("unchanged", ReadString(to));
+
+  ASSERT_TRUE(WriteString(from, "rewritten"));
+  EXPECT_EQ("unchanged", ReadString(to));
+}
+
+TEST_F(PackageInstallerTest, BuildUpdatedDirectory) {
+  ASSERT_TRUE(WriteString(installed_dir_.AppendASCII("same.js"), "same"));
+  ASSERT_TRUE(WriteString(installed_dir_.AppendASCII("changed.js"), "old"));
+  ASSERT_TRUE(WriteString(installed_dir_.AppendASCII("removed.js"), "gone"));
+
+  ASSERT_TRUE(WriteString(new_dir_.AppendASCII("same.js"), "same"));
+  ASSERT_TRUE(WriteString(new_dir_.AppendASCII("changed.js"), "new"));
+  ASSERT_TRUE(base::CreateDirectory(new_dir_.AppendASCII("images")));
+  ASSERT_TRUE(WriteString(
+      new_dir_.AppendASCII("images").AppendASCII("added.png"), "added"));
+
+  EXPECT_TRUE(internal::BuildUpdatedDirectory(
+      new_dir_, installed_dir_, staging_dir_));
+
+  EXPECT_EQ("same", ReadString(staging_dir_.AppendASCII("same.js")));
+  EXPECT_EQ("new", ReadString(staging_dir_.AppendASCII("changed.js")));
+  EXPECT_EQ("added", ReadString(
+      staging_dir_.AppendASCII("images").AppendASCII("added.png")));
+  EXPECT_FALSE(base::PathExists(staging_dir_.AppendASCII("removed.js")));
+
+  // Only the changed files are moved out of the extracted package, the
+  // unchanged ones come from the installed tree.
+  EXPECT_TRUE(base::PathExists(new_dir_.AppendASCII("same.js")));
+  EXPECT_FALSE(base::PathExists(new_dir_.AppendASCII("changed.js")));
+
+  // The installed tree is left untouched for a rollback.
+  EXPECT_EQ("old", ReadString(installed_dir_.AppendASCII("changed.js")));
+  EXPECT_EQ("gone", ReadString(installed_dir_.AppendASCII("removed.js")));
+}
+
+TEST_F(PackageInstallerTest, RestoreDirectory) {
+  const base::FilePath backup_dir = temp_dir_.path().AppendASCII("app.tmp");
+  ASSERT_TRUE(base::Move(installed_dir_, backup_dir));
+  ASSERT_TRUE(base::CreateDirectory(installed_dir_));
+  ASSERT_TRUE(WriteString(installed_dir_.AppendASCII("index.html"), "new"));
+  ASSERT_TRUE(WriteString(backup_dir.AppendASCII("index.html"), "old"));
+
+  EXPECT_TRUE(internal::RestoreDirectory(installed_dir_, backup_dir));
+  EXPECT_EQ("old", ReadString(installed_dir_.AppendASCII("index.html")));
+  EXPECT_FALSE(base::PathExists(backup_dir));
+}
+
+TEST_F(PackageInstallerTest, RestoreDirectoryFailure) {
+  // Nothing to roll back to, which has to be reported.
+  const base::FilePath backup_dir = temp_dir_.path().AppendASCII("app.tmp");
+  EXPECT_FALSE(internal::RestoreDirectory(installed_dir_, backup_dir));
+}
+
+}  // namespace application
+}  // namespace xwalk
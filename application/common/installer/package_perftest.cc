@@ -0,0 +1,84 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/installer/package.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "third_party/zlib/google/zip.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+const int kEntryCount = 64;
+const int kEntrySize = 1024 * 1024;
+
+// The zip content doesn't need a manifest or a signature to be extracted.
+class RawPackage : public Package {
+ public:
+  explicit RawPackage(const base::FilePath& path) : Package(path) {}
+};
+
+}  // namespace
+
+class PackagePerfTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    base::FilePath content_dir = temp_dir_.path().AppendASCII("content");
+    ASSERT_TRUE(base::CreateDirectory(content_dir));
+
+    // Somewhat compressible, like typical game assets and scripts.
+    std::string data;
+    data.reserve(kEntrySize);
+    for (int i = 0; data.size() < static_cast<size_t>(kEntrySize); ++i)
+      data += base::StringPrintf("var value%d = %d;\n", i, i * 7919 % 65536);
+    data.resize(kEntrySize);
+
+    for (int i = 0; i < kEntryCount; ++i) {
+      base::FilePath file = content_dir.AppendASCII(
+          base::StringPrintf("file%d.js", i));
+      ASSERT_EQ(kEntrySize,
+                base::WriteFile(file, data.data(), data.size()));
+    }
+
+    package_path_ = temp_dir_.path().AppendASCII("package.zip");
+    ASSERT_TRUE(zip::Zip(content_dir, package_path_, false));
+  }
+
+  void RunExtraction(Package::ExtractionMode mode, const std::string& name) {
+    base::ScopedTempDir target_dir;
+    ASSERT_TRUE(target_dir.CreateUniqueTempDir());
+    RawPackage package(package_path_);
+    package.set_extraction_mode(mode);
+
+    base::ElapsedTimer timer;
+    EXPECT_TRUE(package.ExtractToDirectory(
+        target_dir.path(), Package::ExtractProgressCallback()));
+    perf_test::PrintResult("package_extract", "", name,
+                           timer.Elapsed().InMillisecondsF(), "ms", true);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath package_path_;
+};
+
+TEST_F(PackagePerfTest, Serial) {
+  RunExtraction(Package::EXTRACT_SERIAL, "serial");
+}
+
+TEST_F(PackagePerfTest, Parallel) {
+  RunExtraction(Package::EXTRACT_PARALLEL, "parallel");
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -4,6 +4,7 @@
 
 #include "xwalk/application/common/installer/package.h"
 
+#include "base/bind.h"
 #include "base/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/path_service.h"
@@ -12,6 +13,17 @@
 namespace xwalk {
 namespace application {
 
+namespace {
+
+void CountProgress(int* calls, int64* last_extracted, int64* last_total,
+                   int64 extracted, int64 total) {
+  ++*calls;
+  *last_extracted = extracted;
+  *last_total = total;
+}
+
+}  // namespace
+
 // As of now only XPK unit tests are present
 class PackageTest : public testing::Test {
  public:
@@ -42,6 +54,45 @@ TEST_F(PackageTest, Good) {
   EXPECT_TRUE(temp_dir_.Set(path));
 }
 
+TEST_F(PackageTest, ExtractToDirectory) {
+  SetupPackage("good.xpk");
+  ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  int calls = 0;
+  int64 extracted = 0;
+  int64 total = 0;
+  EXPECT_TRUE(package_->ExtractToDirectory(
+      temp_dir_.path(),
+      base::Bind(&CountProgress, &calls, &extracted, &total)));
+  EXPECT_FALSE(package_->is_extracted());
+  EXPECT_GT(calls, 0);
+  EXPECT_GT(total, 0);
+  EXPECT_EQ(total, extracted);
+  EXPECT_FALSE(base::IsDirectoryEmpty(temp_dir_.path()));
+}
+
+TEST_F(PackageTest, ParallelExtractToDirectory) {
+  SetupPackage("good.xpk");
+  ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  package_->set_extraction_mode(Package::EXTRACT_PARALLEL);
+  int calls = 0;
+  int64 extracted = 0;
+  int64 total = 0;
+  EXPECT_TRUE(package_->ExtractToDirectory(
+      temp_dir_.path(),
+      base::Bind(&CountProgress, &calls, &extracted, &total)));
+  EXPECT_GT(calls, 0);
+  EXPECT_EQ(total, extracted);
+  EXPECT_TRUE(base::PathExists(temp_dir_.path().AppendASCII("manifest.json")));
+}
+
+TEST_F(PackageTest, BadSignatureExtractToDirectory) {
+  SetupPackage("bad_signature.xpk");
+  ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  EXPECT_FALSE(package_->ExtractToDirectory(
+      temp_dir_.path(), Package::ExtractProgressCallback()));
+  EXPECT_TRUE(base::IsDirectoryEmpty(temp_dir_.path()));
+}
+
 TEST_F(PackageTest, BadMagicString) {
   SetupPackage("bad_magic.xpk");
   base::FilePath path;
@@ -94,6 +94,10 @@ class SignatureData {
     return reference_hash_map_;
   }
 
+  const ReferenceHashMap& reference_hash_map() const {
+    return reference_hash_map_;
+  }
+
   void set_reference_hash_map(const ReferenceHashMap& reference_hash_map) {
     reference_hash_map_ = reference_hash_map;
   }
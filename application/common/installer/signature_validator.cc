@@ -0,0 +1,234 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/installer/signature_validator.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/base64.h"
+#include "base/file_util.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
+#include "crypto/sha2.h"
+#include "net/base/escape.h"
+#include "xwalk/application/common/installer/signature_data.h"
+#include "xwalk/application/common/installer/signature_parser.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+const char kDigestMethodSha1[] = "http://www.w3.org/2000/09/xmldsig#sha1";
+const char kDigestMethodSha256[] = "http://www.w3.org/2001/04/xmlenc#sha256";
+
+const char kAuthorSignatureFile[] = "author-signature.xml";
+const char kDistributorSignaturePrefix[] = "signature";
+const char kSignatureFileExtension[] = ".xml";
+
+const int kMaxValidationWorkers = 8;
+
+struct Reference {
+  Reference(const std::string& uri, const ReferenceData& data)
+      : uri(uri), data(&data), valid(false) {}
+
+  std::string uri;
+  const ReferenceData* data;
+  bool valid;
+};
+
+bool ComputeDigest(const std::string& method, const base::StringPiece& content,
+                   std::string* digest) {
+  if (method == kDigestMethodSha256) {
+    *digest = crypto::SHA256HashString(content);
+    return true;
+  }
+  if (method == kDigestMethodSha1) {
+    *digest = base::SHA1HashString(content.as_string());
+    return true;
+  }
+  LOG(ERROR) << "Unsupported digest method: " << method;
+  return false;
+}
+
+bool ValidateReference(const base::FilePath& widget_path,
+                       const Reference& reference) {
+  std::string expected;
+  if (!base::Base64Decode(reference.data->digest_value, &expected))
+    return false;
+
+  const base::FilePath relative_path = base::FilePath::FromUTF8Unsafe(
+      net::UnescapeURLComponent(reference.uri,
+                                net::UnescapeRule::SPACES |
+                                net::UnescapeRule::URL_SPECIAL_CHARS));
+  if (relative_path.IsAbsolute() || relative_path.ReferencesParent())
+    return false;
+  const base::FilePath path = widget_path.Append(relative_path);
+
+  int64 size;
+  if (!base::GetFileSize(path, &size))
+    return false;
+
+  std::string digest;
+  if (!size) {
+    // Empty files can't be mapped.
+    if (!ComputeDigest(reference.data->digest_method, base::StringPiece(),
+                       &digest))
+      return false;
+  } else {
+    base::MemoryMappedFile file;
+    if (!file.Initialize(path))
+      return false;
+    if (!ComputeDigest(reference.data->digest_method,
+                       base::StringPiece(
+                           reinterpret_cast<const char*>(file.data()),
+                           file.length()),
+                       &digest))
+      return false;
+  }
+
+  return digest == expected;
+}
+
+// Hands out the references one at a time to the workers, so big and small
+// files balance out between them.
+class ReferenceQueue {
+ public:
+  ReferenceQueue(const base::FilePath& widget_path,
+                 std::vector<Reference>* references)
+      : widget_path_(widget_path),
+        references_(references),
+        next_(0) {}
+
+  const base::FilePath& widget_path() const { return widget_path_; }
+
+  Reference* Next() {
+    base::AutoLock lock(lock_);
+    if (next_ == references_->size())
+      return NULL;
+    return &(*references_)[next_++];
+  }
+
+ private:
+  const base::FilePath widget_path_;
+  std::vector<Reference>* references_;
+  size_t next_;
+  base::Lock lock_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReferenceQueue);
+};
+
+class ValidationWorker : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit ValidationWorker(ReferenceQueue* queue) : queue_(queue) {}
+
+  virtual void Run() OVERRIDE {
+    while (Reference* reference = queue_->Next())
+      reference->valid = ValidateReference(queue_->widget_path(), *reference);
+  }
+
+ private:
+  ReferenceQueue* queue_;
+
+  DISALLOW_COPY_AND_ASSIGN(ValidationWorker);
+};
+
+// Returns the number of the signature named |file_name|, -1 for the author
+// signature, or false if it isn't a signature file.
+bool GetSignatureNumber(const std::string& file_name, int* number) {
+  if (file_name == kAuthorSignatureFile) {
+    *number = -1;
+    return true;
+  }
+  if (!StartsWithASCII(file_name, kDistributorSignaturePrefix, true) ||
+      !EndsWith(file_name, kSignatureFileExtension, true))
+    return false;
+  const size_t prefix_length = arraysize(kDistributorSignaturePrefix) - 1;
+  const size_t length = file_name.size() - prefix_length -
+      (arraysize(kSignatureFileExtension) - 1);
+  return base::StringToInt(file_name.substr(prefix_length, length), number) &&
+      *number > 0;
+}
+
+}  // namespace
+
+// static
+bool SignatureValidator::ValidateReferences(const base::FilePath& widget_path,
+                                            const SignatureData& data) {
+  const ReferenceHashMap& hash_map = data.reference_hash_map();
+  std::vector<Reference> references;
+  references.reserve(hash_map.size());
+  for (ReferenceHashMap::const_iterator it = hash_map.begin();
+       it != hash_map.end(); ++it) {
+    // Same-document references, like the signature properties, aren't files.
+    if (StartsWithASCII(it->first, "#", true))
+      continue;
+    references.push_back(Reference(it->first, it->second));
+  }
+  if (references.empty())
+    return true;
+
+  ReferenceQueue queue(widget_path, &references);
+  const int workers = std::min(
+      std::min(base::SysInfo::NumberOfProcessors(), kMaxValidationWorkers),
+      static_cast<int>(references.size()));
+  if (workers <= 1) {
+    ValidationWorker(&queue).Run();
+  } else {
+    ScopedVector<ValidationWorker> delegates;
+    base::DelegateSimpleThreadPool pool("SignatureValidation", workers);
+    pool.Start();
+    for (int i = 0; i < workers; ++i) {
+      delegates.push_back(new ValidationWorker(&queue));
+      pool.AddWork(delegates.back());
+    }
+    pool.JoinAll();
+  }
+
+  // Reported in the reference order, whatever thread finished first.
+  for (size_t i = 0; i < references.size(); ++i) {
+    if (!references[i].valid) {
+      LOG(ERROR) << "Invalid digest for the reference: " << references[i].uri;
+      return false;
+    }
+  }
+  return true;
+}
+
+// static
+bool SignatureValidator::ValidateSignatures(const base::FilePath& widget_path) {
+  base::FileEnumerator signatures(widget_path, false,
+                                  base::FileEnumerator::FILES,
+                                  FILE_PATH_LITERAL("*.xml"));
+  for (base::FilePath path = signatures.Next(); !path.empty();
+       path = signatures.Next()) {
+    int number;
+    if (!GetSignatureNumber(path.BaseName().MaybeAsASCII(), &number))
+      continue;
+
+    scoped_ptr<SignatureData> data =
+        SignatureParser::CreateSignatureData(path, number);
+    if (!data) {
+      LOG(ERROR) << "Unable to parse the signature: " << path.value();
+      return false;
+    }
+    if (!ValidateReferences(widget_path, *data))
+      return false;
+  }
+  return true;
+}
+
+}  // namespace application
+}  // namespace xwalk
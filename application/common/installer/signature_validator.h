@@ -0,0 +1,37 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_COMMON_INSTALLER_SIGNATURE_VALIDATOR_H_
+#define XWALK_APPLICATION_COMMON_INSTALLER_SIGNATURE_VALIDATOR_H_
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+
+namespace xwalk {
+namespace application {
+
+class SignatureData;
+
+class SignatureValidator {
+ public:
+  // Checks the digest of every file referenced by |data| against the content
+  // of the widget unpacked in |widget_path|. The files are memory-mapped and
+  // hashed by a pool of threads, bounded by the number of cores. Runs on the
+  // extracted content, so nothing is inflated a second time.
+  static bool ValidateReferences(const base::FilePath& widget_path,
+                                 const SignatureData& data);
+
+  // Parses the author and distributor signatures found at the root of the
+  // widget unpacked in |widget_path| and validates their references. A widget
+  // without any signature file is valid.
+  static bool ValidateSignatures(const base::FilePath& widget_path);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SignatureValidator);
+};
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_COMMON_INSTALLER_SIGNATURE_VALIDATOR_H_
@@ -0,0 +1,155 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/installer/signature_validator.h"
+
+#include <string>
+
+#include "base/base64.h"
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "crypto/sha2.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "xwalk/application/common/installer/signature_data.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+const char kDigestMethodSha256[] = "http://www.w3.org/2001/04/xmlenc#sha256";
+
+}  // namespace
+
+class SignatureValidatorTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    data_.reset(new SignatureData("author-signature.xml", -1));
+  }
+
+  void AddFile(const std::string& uri, const std::string& content) {
+    base::FilePath path = temp_dir_.path().AppendASCII(uri);
+    ASSERT_TRUE(base::CreateDirectory(path.DirName()));
+    ASSERT_EQ(static_cast<int>(content.size()),
+              base::WriteFile(path, content.data(), content.size()));
+
+    ReferenceData reference;
+    reference.digest_method = kDigestMethodSha256;
+    base::Base64Encode(crypto::SHA256HashString(content),
+                       &reference.digest_value);
+    data_->reference_hash_map()[uri] = reference;
+  }
+
+  // Writes a signature file named |file_name| holding the references added
+  // so far, plus the one to the signature properties.
+  void WriteSignature(const std::string& file_name) {
+    std::string references =
+        "<Reference URI=\"#prop\">"
+        "<DigestMethod Algorithm=\"" + std::string(kDigestMethodSha256) +
+        "\"/><DigestValue>AAAA</DigestValue></Reference>";
+    const ReferenceHashMap& hash_map = data_->reference_hash_map();
+    for (ReferenceHashMap::const_iterator it = hash_map.begin();
+         it != hash_map.end(); ++it) {
+      references += base::StringPrintf(
+          "<Reference URI=\"%s\"><DigestMethod Algorithm=\"%s\"/>"
+          "<DigestValue>%s</DigestValue></Reference>",
+          it->first.c_str(), it->second.digest_method.c_str(),
+          it->second.digest_value.c_str());
+    }
+    const std::string content =
+        "<Signature xmlns=\"http://www.w3.org/2000/09/xmldsig#\">"
+        "<SignedInfo>"
+        "<CanonicalizationMethod "
+        "Algorithm=\"http://www.w3.org/2006/12/xml-c14n11\"/>"
+        "<SignatureMethod "
+        "Algorithm=\"http://www.w3.org/2001/04/xmldsig-more#rsa-sha256\"/>" +
+        references +
+        "</SignedInfo>"
+        "<SignatureValue>AAAA</SignatureValue>"
+        "<Object Id=\"prop\"><SignatureProperties>"
+        "<SignatureProperty Id=\"profile\" Target=\"#DistributorSignature\">"
+        "<Profile URI=\"http://www.w3.org/ns/widgets-digsig#profile\"/>"
+        "</SignatureProperty>"
+        "</SignatureProperties></Object>"
+        "</Signature>";
+    ASSERT_EQ(static_cast<int>(content.size()),
+              base::WriteFile(temp_dir_.path().AppendASCII(file_name),
+                              content.data(), content.size()));
+  }
+
+  base::ScopedTempDir temp_dir_;
+  scoped_ptr<SignatureData> data_;
+};
+
+TEST_F(SignatureValidatorTest, ValidReferences) {
+  for (int i = 0; i < 32; ++i) {
+    AddFile(base::StringPrintf("dir/file%d.js", i),
+            std::string(i * 1024, 'a' + i % 26));
+  }
+  EXPECT_TRUE(SignatureValidator::ValidateReferences(temp_dir_.path(),
+                                                     *data_));
+}
+
+TEST_F(SignatureValidatorTest, ModifiedFile) {
+  AddFile("index.html", "<html></html>");
+  AddFile("main.js", "var a = 1;");
+  std::string modified("var a = 2;");
+  ASSERT_EQ(static_cast<int>(modified.size()),
+            base::WriteFile(temp_dir_.path().AppendASCII("main.js"),
+                            modified.data(), modified.size()));
+  EXPECT_FALSE(SignatureValidator::ValidateReferences(temp_dir_.path(),
+                                                      *data_));
+}
+
+TEST_F(SignatureValidatorTest, MissingFile) {
+  AddFile("index.html", "<html></html>");
+  ASSERT_TRUE(base::DeleteFile(temp_dir_.path().AppendASCII("index.html"),
+                               false));
+  EXPECT_FALSE(SignatureValidator::ValidateReferences(temp_dir_.path(),
+                                                      *data_));
+}
+
+TEST_F(SignatureValidatorTest, ReferenceOutsideWidget) {
+  AddFile("index.html", "<html></html>");
+  data_->reference_hash_map()["../index.html"] =
+      data_->reference_hash_map()["index.html"];
+  EXPECT_FALSE(SignatureValidator::ValidateReferences(temp_dir_.path(),
+                                                      *data_));
+}
+
+TEST_F(SignatureValidatorTest, UnsignedWidget) {
+  AddFile("index.html", "<html></html>");
+  AddFile("config.xml", "<widget/>");
+  EXPECT_TRUE(SignatureValidator::ValidateSignatures(temp_dir_.path()));
+}
+
+TEST_F(SignatureValidatorTest, SignedWidget) {
+  AddFile("index.html", "<html></html>");
+  AddFile("main.js", "var a = 1;");
+  WriteSignature("author-signature.xml");
+  WriteSignature("signature1.xml");
+  EXPECT_TRUE(SignatureValidator::ValidateSignatures(temp_dir_.path()));
+
+  std::string modified("var a = 2;");
+  ASSERT_EQ(static_cast<int>(modified.size()),
+            base::WriteFile(temp_dir_.path().AppendASCII("main.js"),
+                            modified.data(), modified.size()));
+  EXPECT_FALSE(SignatureValidator::ValidateSignatures(temp_dir_.path()));
+}
+
+TEST_F(SignatureValidatorTest, MalformedSignature) {
+  AddFile("index.html", "<html></html>");
+  AddFile("signature2.xml", "<Signature/>");
+  EXPECT_FALSE(SignatureValidator::ValidateSignatures(temp_dir_.path()));
+
+  // Only the author and numbered distributor signatures are parsed.
+  ASSERT_TRUE(base::Move(temp_dir_.path().AppendASCII("signature2.xml"),
+                         temp_dir_.path().AppendASCII("signature.xml")));
+  EXPECT_TRUE(SignatureValidator::ValidateSignatures(temp_dir_.path()));
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -8,6 +8,7 @@
 #include "base/files/scoped_file.h"
 #include "third_party/libxml/chromium/libxml_utils.h"
 #include "xwalk/application/common/id_util.h"
+#include "xwalk/application/common/installer/signature_validator.h"
 
 namespace xwalk {
 namespace application {
@@ -61,6 +62,11 @@ WGTPackage::WGTPackage(const base::FilePath& path)
     id_ = GenerateId(value);
 #endif
 
+  if (!SignatureValidator::ValidateSignatures(extracted_path)) {
+    LOG(ERROR) << "WGT package signature validation failed.";
+    return;
+  }
+
   is_valid_ = true;
 
   scoped_ptr<base::ScopedFILE> file(
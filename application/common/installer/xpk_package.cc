@@ -80,10 +80,11 @@ bool XPKPackage::VerifySignature() {
                            &key_.front(),
                            key_.size()))
     return false;
-  unsigned char buf[1 << 12];
+  // Large reads, the package is hashed in a single sequential pass.
+  std::vector<uint8> buf(1 << 16);
   size_t len = 0;
-  while ((len = fread(buf, 1, sizeof(buf), file_->get())) > 0)
-    verifier.VerifyUpdate(buf, len);
+  while ((len = fread(&buf.front(), 1, buf.size(), file_->get())) > 0)
+    verifier.VerifyUpdate(&buf.front(), len);
   if (!verifier.VerifyFinal())
     return false;
 
@@ -104,5 +105,15 @@ bool XPKPackage::Extract(base::FilePath* target_path) {
   return Package::Extract(target_path);
 }
 
+bool XPKPackage::ExtractToDirectory(const base::FilePath& target_dir,
+                                    const ExtractProgressCallback& progress) {
+  if (!IsValid()) {
+    LOG(ERROR) << "The XPK file is not valid.";
+    return false;
+  }
+
+  return Package::ExtractToDirectory(target_dir, progress);
+}
+
 }  // namespace application
 }  // namespace xwalk
@@ -30,6 +30,9 @@ class XPKPackage : public Package {
   virtual ~XPKPackage();
   explicit XPKPackage(const base::FilePath& path);
   virtual bool Extract(base::FilePath* target_path) OVERRIDE;
+  virtual bool ExtractToDirectory(
+      const base::FilePath& target_dir,
+      const ExtractProgressCallback& progress) OVERRIDE;
 
  private:
   // verify the signature in the xpk package
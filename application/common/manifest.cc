@@ -134,33 +134,25 @@ bool Manifest::GetString(
   if (!CanAccessPath(path))
     return false;
 
-  if (i18n_data_->Get(path, NULL)) {
-    List::const_iterator it = user_agent_locales_->begin();
-    for (; it != user_agent_locales_->end(); ++it) {
-      if (i18n_data_->GetString(GetLocalizedKey(path, *it), out_value))
-        return true;
-    }
-    return false;
+  LocalizedStringMap::const_iterator it = localized_strings_.find(path);
+  if (it != localized_strings_.end()) {
+    *out_value = it->second;
+    return true;
   }
+  // Not localized for any of the user agent locales.
+  if (localized_paths_.count(path))
+    return false;
 
   return data_->GetString(path, out_value);
 }
 
 bool Manifest::GetString(
     const std::string& path, base::string16* out_value) const {
-  if (!CanAccessPath(path))
-    return false;
-
-  if (i18n_data_->Get(path, NULL)) {
-    List::const_iterator it = user_agent_locales_->begin();
-    for (; it != user_agent_locales_->end(); ++it) {
-      if (i18n_data_->GetString(GetLocalizedKey(path, *it), out_value))
-        return true;
-    }
+  std::string value;
+  if (!GetString(path, &value))
     return false;
-  }
-
-  return data_->GetString(path, out_value);
+  *out_value = base::UTF8ToUTF16(value);
+  return true;
 }
 
 bool Manifest::GetDictionary(
@@ -199,7 +191,22 @@ void Manifest::SetSystemLocale(const std::string& locale) {
   list_for_expand->push_back(kLocaleUnlocalized);
   list_for_expand->push_back(kLocaleAuto);
   list_for_expand->push_back(kLocaleFirstOne);
-  user_agent_locales_ = ExpandUserAgentLocalesList(list_for_expand);
+  scoped_ptr<List> user_agent_locales =
+      ExpandUserAgentLocalesList(list_for_expand);
+
+  LocalizedStringMap localized_strings;
+  for (std::set<std::string>::const_iterator path = localized_paths_.begin();
+       path != localized_paths_.end(); ++path) {
+    for (List::const_iterator it = user_agent_locales->begin();
+         it != user_agent_locales->end(); ++it) {
+      std::string value;
+      if (i18n_data_->GetString(GetLocalizedKey(*path, *it), &value)) {
+        localized_strings[*path] = value;
+        break;
+      }
+    }
+  }
+  localized_strings_.swap(localized_strings);
 }
 
 void Manifest::ParseWGTI18n() {
@@ -262,8 +269,9 @@ bool Manifest::ParseWGTI18nEachElement(base::Value* value,
 
   base::DictionaryValue::Iterator iter(*dict);
   while (!iter.IsAtEnd()) {
-    std::string locale_key(
-        GetLocalizedKey(path + kPathConnectSymbol + iter.key(), xml_lang));
+    std::string localized_path(path + kPathConnectSymbol + iter.key());
+    localized_paths_.insert(localized_path);
+    std::string locale_key(GetLocalizedKey(localized_path, xml_lang));
     if (!i18n_data_->Get(locale_key, NULL))
       i18n_data_->Set(locale_key, iter.value().DeepCopy());
 
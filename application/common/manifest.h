@@ -5,12 +5,12 @@
 #ifndef XWALK_APPLICATION_COMMON_MANIFEST_H_
 #define XWALK_APPLICATION_COMMON_MANIFEST_H_
 
-#include <list>
 #include <map>
 #include <string>
 #include <set>
 #include <vector>
 
+#include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/string16.h"
 #include "base/values.h"
@@ -99,10 +99,13 @@ class Manifest {
     return default_locale_;
   }
 
-  // Update user agent locale when system locale is changed.
+  // Update user agent locale when system locale is changed. The localized
+  // strings are resolved for the new locale at once.
   void SetSystemLocale(const std::string& locale);
 
  private:
+  typedef base::hash_map<std::string, std::string> LocalizedStringMap;
+
   void ParseWGTI18n();
   void ParseWGTI18nEachPath(const std::string& path);
   bool ParseWGTI18nEachElement(base::Value* value,
@@ -125,9 +128,15 @@ class Manifest {
   // The underlying dictionary representation of the manifest.
   scoped_ptr<base::DictionaryValue> data_;
   scoped_ptr<base::DictionaryValue> i18n_data_;
+  // The paths of i18n_data_ having localized values, e.g.
+  // "widget.name.#text".
+  std::set<std::string> localized_paths_;
+  // Their values for the user agent locales, GetString() doesn't go through
+  // the locales at every call. The paths without value for these locales
+  // aren't there.
+  LocalizedStringMap localized_strings_;
 
   std::string default_locale_;
-  scoped_ptr<std::list<std::string> > user_agent_locales_;
 
   Type type_;
 
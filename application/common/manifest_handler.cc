@@ -6,7 +6,9 @@
 
 #include <set>
 
+#include "base/logging.h"
 #include "base/stl_util.h"
+#include "base/strings/utf_string_conversions.h"
 #include "xwalk/application/common/manifest_handlers/csp_handler.h"
 #if defined(OS_TIZEN)
 #include "xwalk/application/common/manifest_handlers/navigation_handler.h"
@@ -15,7 +17,9 @@
 #include "xwalk/application/common/manifest_handlers/tizen_setting_handler.h"
 #include "xwalk/application/common/manifest_handlers/tizen_splash_screen_handler.h"
 #endif
+#include "xwalk/application/common/manifest_handlers/nacl_handler.h"
 #include "xwalk/application/common/manifest_handlers/permissions_handler.h"
+#include "xwalk/application/common/manifest_handlers/prefetch_handler.h"
 #include "xwalk/application/common/manifest_handlers/warp_handler.h"
 #include "xwalk/application/common/manifest_handlers/widget_handler.h"
 
@@ -39,6 +43,10 @@ bool ManifestHandler::AlwaysValidateForType(Manifest::Type type) const {
   return false;
 }
 
+bool ManifestHandler::ParseLazily() const {
+  return false;
+}
+
 std::vector<std::string> ManifestHandler::PrerequisiteKeys() const {
   return std::vector<std::string>();
 }
@@ -54,6 +62,7 @@ ManifestHandlerRegistry::ManifestHandlerRegistry(
   }
 
   ReorderHandlersGivenDependencies();
+  FindLazyHandlers();
 }
 
 ManifestHandlerRegistry::~ManifestHandlerRegistry() {
@@ -96,7 +105,9 @@ ManifestHandlerRegistry::GetInstanceForXPK() {
   // FIXME: Add manifest handlers here like this:
   // handlers.push_back(new xxxHandler);
   handlers.push_back(new CSPHandler(Package::XPK));
+  handlers.push_back(new NaClHandler);
   handlers.push_back(new PermissionsHandler);
+  handlers.push_back(new PrefetchHandler);
   xpk_registry_ = new ManifestHandlerRegistry(handlers);
   return xpk_registry_;
 }
@@ -114,10 +125,13 @@ bool ManifestHandlerRegistry::ParseAppManifest(
   for (ManifestHandlerMap::iterator iter = handlers_.begin();
        iter != handlers_.end(); ++iter) {
     ManifestHandler* handler = iter->second;
-    if (application->GetManifest()->HasPath(iter->first) ||
-        handler->AlwaysParseForType(application->GetType())) {
+    if (!application->GetManifest()->HasPath(iter->first) &&
+        !handler->AlwaysParseForType(application->GetType()))
+      continue;
+    if (ContainsKey(lazy_handlers_, handler))
+      application->AddLazyManifestKeys(this, handler->Keys());
+    else
       handlers_by_order[order_map_[handler]] = handler;
-    }
   }
   for (std::map<int, ManifestHandler*>::iterator iter =
            handlers_by_order.begin();
@@ -128,6 +142,28 @@ bool ManifestHandlerRegistry::ParseAppManifest(
   return true;
 }
 
+bool ManifestHandlerRegistry::ParseLazyManifestData(
+    scoped_refptr<ApplicationData> application,
+    const std::string& key,
+    base::string16* error) {
+  if (!application->IsLazyManifestKey(key))
+    return true;
+  ManifestHandlerMap::const_iterator iter = handlers_.find(key);
+  DCHECK(iter != handlers_.end());
+  ManifestHandler* handler = iter->second;
+
+  const std::vector<std::string>& prerequisites = handler->PrerequisiteKeys();
+  for (size_t i = 0; i < prerequisites.size(); ++i) {
+    if (!ParseLazyManifestData(application, prerequisites[i], error))
+      return false;
+  }
+
+  // Parsed only once, even if it fails.
+  const bool parsed = handler->Parse(application, error);
+  application->RemoveLazyManifestKeys(handler->Keys());
+  return parsed;
+}
+
 bool ManifestHandlerRegistry::ValidateAppManifest(
     scoped_refptr<const ApplicationData> application,
     std::string* error,
@@ -200,5 +236,30 @@ void ManifestHandlerRegistry::ReorderHandlersGivenDependencies() {
                                    << "circular dependencies!";
 }
 
+void ManifestHandlerRegistry::FindLazyHandlers() {
+  std::map<int, ManifestHandler*> handlers_by_order;
+  for (ManifestHandlerOrderMap::const_iterator iter = order_map_.begin();
+       iter != order_map_.end(); ++iter) {
+    handlers_by_order[iter->second] = iter->first;
+  }
+
+  // The dependent handlers come last, the handlers they depend on are
+  // parsed at load time if they are.
+  std::set<ManifestHandler*> eager_handlers;
+  for (std::map<int, ManifestHandler*>::reverse_iterator iter =
+           handlers_by_order.rbegin();
+       iter != handlers_by_order.rend(); ++iter) {
+    ManifestHandler* handler = iter->second;
+    if (handler->ParseLazily() && !ContainsKey(eager_handlers, handler)) {
+      lazy_handlers_.insert(handler);
+      continue;
+    }
+    const std::vector<std::string>& prerequisites =
+        handler->PrerequisiteKeys();
+    for (size_t i = 0; i < prerequisites.size(); ++i)
+      eager_handlers.insert(handlers_[prerequisites[i]]);
+  }
+}
+
 }  // namespace application
 }  // namespace xwalk
@@ -6,6 +6,7 @@
 #define XWALK_APPLICATION_COMMON_MANIFEST_HANDLER_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,14 @@ class ManifestHandler {
   // Same as AlwaysParseForType, but for Validate instead of Parse.
   virtual bool AlwaysValidateForType(Manifest::Type type) const;
 
+  // If true, Parse is only called on the first GetManifestData of one of our
+  // keys instead of when the application is loaded, for the data which isn't
+  // needed to launch the application. Parse errors are then logged and leave
+  // the data unset. Ignored if a handler parsed at load time depends on our
+  // keys. Parse must declare all the keys it reads the data of in
+  // PrerequisiteKeys. Defaults to false.
+  virtual bool ParseLazily() const;
+
   // The list of keys that, if present, should be parsed before calling our
   // Parse (typically, because our Parse needs to read those keys).
   // Defaults to empty.
@@ -64,6 +73,14 @@ class ManifestHandlerRegistry {
                            std::string* error,
                            std::vector<InstallWarning>* warnings);
 
+  // Calls the lazy handler of |key| if it hasn't parsed |application| yet,
+  // after the lazy handlers of its prerequisite keys. Returns false and sets
+  // |error| if one of them fails. Called by ApplicationData on the first
+  // GetManifestData of |key|, and at install time.
+  bool ParseLazyManifestData(scoped_refptr<ApplicationData> application,
+                             const std::string& key,
+                             base::string16* error);
+
  private:
   friend class ScopedTestingManifestHandlerRegistry;
   explicit ManifestHandlerRegistry(
@@ -75,6 +92,10 @@ class ManifestHandlerRegistry {
 
   void ReorderHandlersGivenDependencies();
 
+  // Collects the lazy handlers which no handler parsed at load time depends
+  // on.
+  void FindLazyHandlers();
+
   // Sets a new global registry, for testing purposes.
   static void SetInstanceForTesting(ManifestHandlerRegistry* registry,
                                     Package::Type package_type);
@@ -90,6 +111,9 @@ class ManifestHandlerRegistry {
   // Handlers are executed in order; lowest order first.
   ManifestHandlerOrderMap order_map_;
 
+  // The handlers parsing on the first access to their data.
+  std::set<ManifestHandler*> lazy_handlers_;
+
   static ManifestHandlerRegistry* xpk_registry_;
   static ManifestHandlerRegistry* widget_registry_;
 };
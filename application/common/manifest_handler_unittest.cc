@@ -145,6 +145,34 @@ class ManifestHandlerTest : public testing::Test {
     }
   };
 
+  class LazyTestManifestHandler : public TestManifestHandler {
+   public:
+    LazyTestManifestHandler(const std::string& name,
+                            const std::vector<std::string>& keys,
+                            const std::vector<std::string>& prereqs,
+                            ParsingWatcher* watcher)
+        : TestManifestHandler(name, keys, prereqs, watcher) {
+    }
+
+    virtual bool ParseLazily() const OVERRIDE {
+      return true;
+    }
+  };
+
+  class LazyFailingTestManifestHandler : public FailingTestManifestHandler {
+   public:
+    LazyFailingTestManifestHandler(const std::string& name,
+                                   const std::vector<std::string>& keys,
+                                   const std::vector<std::string>& prereqs,
+                                   ParsingWatcher* watcher)
+        : FailingTestManifestHandler(name, keys, prereqs, watcher) {
+    }
+
+    virtual bool ParseLazily() const OVERRIDE {
+      return true;
+    }
+  };
+
   class TestManifestValidator : public ManifestHandler {
    public:
     TestManifestValidator(bool return_value,
@@ -234,6 +262,98 @@ TEST_F(ManifestHandlerTest, DependentHandlers) {
   EXPECT_TRUE(watcher.ParsedBefore("C.D", "C.EZ"));
 }
 
+TEST_F(ManifestHandlerTest, LazyHandlers) {
+  std::vector<ManifestHandler*> handlers;
+  ParsingWatcher watcher;
+  std::vector<std::string> prereqs;
+  handlers.push_back(
+      new TestManifestHandler("A", SingleKey("a"), prereqs, &watcher));
+  handlers.push_back(
+      new LazyTestManifestHandler("M", SingleKey("m"), prereqs, &watcher));
+  handlers.push_back(
+      new LazyTestManifestHandler("N", SingleKey("n"), prereqs, &watcher));
+  prereqs.push_back("m");
+  handlers.push_back(
+      new LazyTestManifestHandler("L", SingleKey("l"), prereqs, &watcher));
+  prereqs.clear();
+  prereqs.push_back("n");
+  handlers.push_back(
+      new TestManifestHandler("P", SingleKey("p"), prereqs, &watcher));
+  ScopedTestingManifestHandlerRegistry registry(handlers);
+
+  base::DictionaryValue manifest;
+  manifest.SetString("name", "no name");
+  manifest.SetString("version", "0");
+  manifest.SetInteger("manifest_version", 2);
+  manifest.SetInteger("a", 1);
+  manifest.SetInteger("l", 2);
+  manifest.SetInteger("m", 3);
+  manifest.SetInteger("n", 4);
+  manifest.SetInteger("p", 5);
+  std::string error;
+  scoped_refptr<ApplicationData> application = ApplicationData::Create(
+      base::FilePath(),
+      Manifest::INVALID_TYPE,
+      manifest,
+      "",
+      &error);
+  ASSERT_TRUE(application.get());
+  // N is parsed at load time, P depends on it.
+  ASSERT_EQ(3u, watcher.parsed_names().size());
+  EXPECT_TRUE(watcher.ParsedBefore("N", "P"));
+
+  // Parses M first, L depends on it.
+  application->GetManifestData("l");
+  ASSERT_EQ(5u, watcher.parsed_names().size());
+  EXPECT_EQ("M", watcher.parsed_names()[3]);
+  EXPECT_EQ("L", watcher.parsed_names()[4]);
+
+  application->GetManifestData("l");
+  application->GetManifestData("m");
+  EXPECT_EQ(5u, watcher.parsed_names().size());
+}
+
+TEST_F(ManifestHandlerTest, FailingLazyHandlers) {
+  std::vector<ManifestHandler*> handlers;
+  ParsingWatcher watcher;
+  std::vector<std::string> prereqs;
+  handlers.push_back(
+      new LazyFailingTestManifestHandler("M", SingleKey("m"), prereqs,
+                                         &watcher));
+  prereqs.push_back("m");
+  handlers.push_back(
+      new LazyTestManifestHandler("L", SingleKey("l"), prereqs, &watcher));
+  ScopedTestingManifestHandlerRegistry registry(handlers);
+
+  base::DictionaryValue manifest;
+  manifest.SetString("name", "no name");
+  manifest.SetString("version", "0");
+  manifest.SetInteger("manifest_version", 2);
+  manifest.SetInteger("l", 1);
+  manifest.SetInteger("m", 2);
+  std::string error;
+  scoped_refptr<ApplicationData> application = ApplicationData::Create(
+      base::FilePath(),
+      Manifest::INVALID_TYPE,
+      manifest,
+      "",
+      &error);
+  // The lazy handlers don't fail the load.
+  ASSERT_TRUE(application.get());
+
+  // But they do when parsed at install time, L isn't parsed as M fails.
+  base::string16 parse_error;
+  EXPECT_FALSE(application->ParseLazyManifestData(&parse_error));
+  EXPECT_EQ(base::ASCIIToUTF16("M"), parse_error);
+  EXPECT_TRUE(watcher.parsed_names().empty());
+
+  // M is only parsed once.
+  EXPECT_FALSE(application->GetManifestData("m"));
+  EXPECT_TRUE(application->ParseLazyManifestData(&parse_error));
+  ASSERT_EQ(1u, watcher.parsed_names().size());
+  EXPECT_EQ("L", watcher.parsed_names()[0]);
+}
+
 TEST_F(ManifestHandlerTest, FailingHandlers) {
   scoped_ptr<ScopedTestingManifestHandlerRegistry> registry(
       new ScopedTestingManifestHandlerRegistry(
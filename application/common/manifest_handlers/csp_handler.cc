@@ -6,6 +6,7 @@
 
 #include "base/strings/utf_string_conversions.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 
 namespace xwalk {
@@ -21,6 +22,19 @@ CSPInfo::CSPInfo() {
 CSPInfo::~CSPInfo() {
 }
 
+void CSPInfo::SetDirective(const std::string& directive_name,
+                           const std::vector<std::string>& directive_value) {
+  policies_[directive_name] = directive_value;
+  policy_string_.clear();
+  std::map<std::string, std::vector<std::string> >::const_iterator it =
+      policies_.begin();
+  for (; it != policies_.end(); ++it) {
+    policy_string_.append(
+        it->first + value_separator +
+        JoinString(it->second, value_separator) + directive_separator);
+  }
+}
+
 CSPHandler::CSPHandler(Package::Type type)
     : package_type_(type) {
 }
@@ -20,14 +20,18 @@ class CSPInfo : public ApplicationData::ManifestData {
   virtual ~CSPInfo();
 
   void SetDirective(const std::string& directive_name,
-                    const std::vector<std::string>& directive_value) {
-    policies_[directive_name] = directive_value;
-  }
+                    const std::vector<std::string>& directive_value);
   const std::map<std::string, std::vector<std::string> >&
       GetDirectives() const { return policies_; }
 
+  // The directives as the value of a Content-Security-Policy header, e.g.
+  // "default-src 'self';script-src 'self';". Built when the directives are
+  // set, so that serving a resource doesn't serialize them again.
+  const std::string& GetPolicyString() const { return policy_string_; }
+
  private:
   std::map<std::string, std::vector<std::string> > policies_;
+  std::string policy_string_;
 };
 
 class CSPHandler : public ManifestHandler {
@@ -68,6 +68,17 @@ TEST_F(CSPHandlerTest, CSP) {
   EXPECT_STREQ((it->second)[0].c_str(), "'self'");
 }
 
+TEST_F(CSPHandlerTest, PolicyString) {
+  manifest.SetString(keys::kNameKey, "no name");
+  manifest.SetString(keys::kXWalkVersionKey, "0");
+  manifest.SetString(keys::kCSPKey,
+                     "script-src 'self'  https://a.com;default-src 'none'");
+  scoped_refptr<ApplicationData> application = CreateApplication();
+  EXPECT_TRUE(application.get());
+  EXPECT_EQ("default-src 'none';script-src 'self' https://a.com;",
+            GetCSPInfo(application)->GetPolicyString());
+}
+
 #if defined(OS_TIZEN)
 TEST_F(CSPHandlerTest, WGTEmptyCSP) {
   manifest.SetString(widget_keys::kNameKey, "no name");
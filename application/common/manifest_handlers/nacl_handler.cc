@@ -0,0 +1,53 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/manifest_handlers/nacl_handler.h"
+
+#include "base/strings/utf_string_conversions.h"
+#include "xwalk/application/common/application_manifest_constants.h"
+
+namespace xwalk {
+
+namespace keys = application_manifest_keys;
+
+namespace application {
+
+NaClInfo::NaClInfo(bool is_portable)
+    : is_portable_(is_portable) {
+}
+
+NaClInfo::~NaClInfo() {
+}
+
+NaClHandler::NaClHandler() {
+}
+
+NaClHandler::~NaClHandler() {
+}
+
+bool NaClHandler::Parse(scoped_refptr<ApplicationData> application,
+                        base::string16* error) {
+  std::string kind;
+  if (!application->GetManifest()->GetString(keys::kXWalkNaClKey, &kind) ||
+      (kind != "nacl" && kind != "pnacl")) {
+    *error = base::ASCIIToUTF16(
+        "The value of xwalk_nacl must be \"nacl\" or \"pnacl\".");
+    return false;
+  }
+
+  application->SetManifestData(keys::kXWalkNaClKey,
+                               new NaClInfo(kind == "pnacl"));
+  return true;
+}
+
+bool NaClHandler::ParseLazily() const {
+  return true;
+}
+
+std::vector<std::string> NaClHandler::Keys() const {
+  return std::vector<std::string>(1, keys::kXWalkNaClKey);
+}
+
+}  // namespace application
+}  // namespace xwalk
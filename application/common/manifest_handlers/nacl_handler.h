@@ -0,0 +1,52 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_COMMON_MANIFEST_HANDLERS_NACL_HANDLER_H_
+#define XWALK_APPLICATION_COMMON_MANIFEST_HANDLERS_NACL_HANDLER_H_
+
+#include <string>
+#include <vector>
+
+#include "xwalk/application/common/application_data.h"
+#include "xwalk/application/common/manifest_handler.h"
+
+namespace xwalk {
+namespace application {
+
+// The kind of Native Client modules the application embeds, so what they
+// need is warmed up while the start page loads, e.g.
+//   "xwalk_nacl": "pnacl"
+// "nacl" for modules compiled for the device, "pnacl" for portable ones,
+// which also need the translator.
+class NaClInfo : public ApplicationData::ManifestData {
+ public:
+  explicit NaClInfo(bool is_portable);
+  virtual ~NaClInfo();
+
+  bool is_portable() const { return is_portable_; }
+
+ private:
+  bool is_portable_;
+
+  DISALLOW_COPY_AND_ASSIGN(NaClInfo);
+};
+
+class NaClHandler : public ManifestHandler {
+ public:
+  NaClHandler();
+  virtual ~NaClHandler();
+
+  virtual bool Parse(scoped_refptr<ApplicationData> application,
+                     base::string16* error) OVERRIDE;
+  virtual bool ParseLazily() const OVERRIDE;
+  virtual std::vector<std::string> Keys() const OVERRIDE;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(NaClHandler);
+};
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_COMMON_MANIFEST_HANDLERS_NACL_HANDLER_H_
@@ -0,0 +1,66 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/manifest_handlers/nacl_handler.h"
+
+#include "xwalk/application/common/application_manifest_constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace xwalk {
+
+namespace keys = application_manifest_keys;
+
+namespace application {
+
+class NaClHandlerTest: public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    manifest.SetString(keys::kNameKey, "no name");
+    manifest.SetString(keys::kXWalkVersionKey, "0");
+  }
+
+  scoped_refptr<ApplicationData> CreateApplication() {
+    std::string error;
+    return ApplicationData::Create(
+        base::FilePath(), Manifest::INVALID_TYPE, manifest, "", &error);
+  }
+
+  const NaClInfo* GetNaClInfo(scoped_refptr<ApplicationData> application) {
+    return static_cast<NaClInfo*>(
+        application->GetManifestData(keys::kXWalkNaClKey));
+  }
+
+  base::DictionaryValue manifest;
+};
+
+TEST_F(NaClHandlerTest, NoNaCl) {
+  scoped_refptr<ApplicationData> application = CreateApplication();
+  EXPECT_TRUE(application.get());
+  EXPECT_FALSE(GetNaClInfo(application));
+}
+
+TEST_F(NaClHandlerTest, NaClKinds) {
+  manifest.SetString(keys::kXWalkNaClKey, "nacl");
+  scoped_refptr<ApplicationData> application = CreateApplication();
+  ASSERT_TRUE(application.get());
+  ASSERT_TRUE(GetNaClInfo(application));
+  EXPECT_FALSE(GetNaClInfo(application)->is_portable());
+
+  manifest.SetString(keys::kXWalkNaClKey, "pnacl");
+  application = CreateApplication();
+  ASSERT_TRUE(application.get());
+  ASSERT_TRUE(GetNaClInfo(application));
+  EXPECT_TRUE(GetNaClInfo(application)->is_portable());
+}
+
+TEST_F(NaClHandlerTest, InvalidNaCl) {
+  manifest.SetString(keys::kXWalkNaClKey, "asm.js");
+  EXPECT_FALSE(CreateApplication().get());
+
+  manifest.SetBoolean(keys::kXWalkNaClKey, true);
+  EXPECT_FALSE(CreateApplication().get());
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,73 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/manifest_handlers/prefetch_handler.h"
+
+#include "base/logging.h"
+#include "base/strings/utf_string_conversions.h"
+#include "xwalk/application/common/application_manifest_constants.h"
+
+namespace xwalk {
+
+namespace keys = application_manifest_keys;
+
+namespace application {
+
+const size_t PrefetchHandler::kMaxURLs = 128;
+
+PrefetchInfo::PrefetchInfo() {
+}
+
+PrefetchInfo::~PrefetchInfo() {
+}
+
+PrefetchHandler::PrefetchHandler() {
+}
+
+PrefetchHandler::~PrefetchHandler() {
+}
+
+bool PrefetchHandler::Parse(scoped_refptr<ApplicationData> application,
+                            base::string16* error) {
+  const base::ListValue* urls = NULL;
+  if (!application->GetManifest()->GetList(keys::kXWalkPrefetchKey, &urls) ||
+      !urls) {
+    *error = base::ASCIIToUTF16("Invalid value of xwalk_prefetch.");
+    return false;
+  }
+
+  scoped_ptr<PrefetchInfo> prefetch_info(new PrefetchInfo);
+  for (size_t i = 0; i < urls->GetSize(); ++i) {
+    std::string spec;
+    GURL url;
+    if (urls->GetString(i, &spec))
+      url = GURL(spec);
+    if (!url.is_valid() || !url.SchemeIsHTTPOrHTTPS()) {
+      *error = base::ASCIIToUTF16(
+          "The urls of xwalk_prefetch must be absolute http(s) urls.");
+      return false;
+    }
+    if (i == kMaxURLs) {
+      LOG(WARNING) << "Only the first " << kMaxURLs
+                   << " urls of xwalk_prefetch are prefetched.";
+      break;
+    }
+    prefetch_info->AddURL(url);
+  }
+  application->SetManifestData(keys::kXWalkPrefetchKey,
+                               prefetch_info.release());
+
+  return true;
+}
+
+bool PrefetchHandler::ParseLazily() const {
+  return true;
+}
+
+std::vector<std::string> PrefetchHandler::Keys() const {
+  return std::vector<std::string>(1, keys::kXWalkPrefetchKey);
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,56 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_COMMON_MANIFEST_HANDLERS_PREFETCH_HANDLER_H_
+#define XWALK_APPLICATION_COMMON_MANIFEST_HANDLERS_PREFETCH_HANDLER_H_
+
+#include <string>
+#include <vector>
+
+#include "url/gurl.h"
+#include "xwalk/application/common/application_data.h"
+#include "xwalk/application/common/manifest_handler.h"
+
+namespace xwalk {
+namespace application {
+
+// The http(s) urls the application wants in the HTTP cache, fetched in the
+// background after it is launched, e.g.
+//   "xwalk_prefetch": ["http://example.com/app.js",
+//                      "http://example.com/data.json"]
+class PrefetchInfo : public ApplicationData::ManifestData {
+ public:
+  PrefetchInfo();
+  virtual ~PrefetchInfo();
+
+  const std::vector<GURL>& urls() const { return urls_; }
+  void AddURL(const GURL& url) { urls_.push_back(url); }
+
+ private:
+  std::vector<GURL> urls_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrefetchInfo);
+};
+
+class PrefetchHandler : public ManifestHandler {
+ public:
+  // More urls than this are ignored.
+  static const size_t kMaxURLs;
+
+  PrefetchHandler();
+  virtual ~PrefetchHandler();
+
+  virtual bool Parse(scoped_refptr<ApplicationData> application,
+                     base::string16* error) OVERRIDE;
+  virtual bool ParseLazily() const OVERRIDE;
+  virtual std::vector<std::string> Keys() const OVERRIDE;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(PrefetchHandler);
+};
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_COMMON_MANIFEST_HANDLERS_PREFETCH_HANDLER_H_
@@ -0,0 +1,70 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/manifest_handlers/prefetch_handler.h"
+
+#include "xwalk/application/common/application_manifest_constants.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace xwalk {
+
+namespace keys = application_manifest_keys;
+
+namespace application {
+
+class PrefetchHandlerTest: public testing::Test {
+ public:
+  virtual void SetUp() OVERRIDE {
+    manifest.SetString(keys::kNameKey, "no name");
+    manifest.SetString(keys::kXWalkVersionKey, "0");
+  }
+
+  scoped_refptr<ApplicationData> CreateApplication() {
+    std::string error;
+    return ApplicationData::Create(
+        base::FilePath(), Manifest::INVALID_TYPE, manifest, "", &error);
+  }
+
+  const PrefetchInfo* GetPrefetchInfo(
+      scoped_refptr<ApplicationData> application) {
+    return static_cast<PrefetchInfo*>(
+        application->GetManifestData(keys::kXWalkPrefetchKey));
+  }
+
+  base::DictionaryValue manifest;
+};
+
+TEST_F(PrefetchHandlerTest, NoPrefetch) {
+  scoped_refptr<ApplicationData> application = CreateApplication();
+  EXPECT_TRUE(application.get());
+  EXPECT_FALSE(GetPrefetchInfo(application));
+}
+
+TEST_F(PrefetchHandlerTest, PrefetchURLs) {
+  base::ListValue* urls = new base::ListValue;
+  urls->AppendString("http://example.com/app.js");
+  urls->AppendString("https://example.com/data.json");
+  manifest.Set(keys::kXWalkPrefetchKey, urls);
+  scoped_refptr<ApplicationData> application = CreateApplication();
+  EXPECT_TRUE(application.get());
+
+  const PrefetchInfo* info = GetPrefetchInfo(application);
+  ASSERT_TRUE(info);
+  ASSERT_EQ(2u, info->urls().size());
+  EXPECT_EQ(GURL("http://example.com/app.js"), info->urls()[0]);
+  EXPECT_EQ(GURL("https://example.com/data.json"), info->urls()[1]);
+}
+
+TEST_F(PrefetchHandlerTest, InvalidPrefetch) {
+  manifest.SetString(keys::kXWalkPrefetchKey, "http://example.com/app.js");
+  EXPECT_FALSE(CreateApplication().get());
+
+  base::ListValue* urls = new base::ListValue;
+  urls->AppendString("app.js");
+  manifest.Set(keys::kXWalkPrefetchKey, urls);
+  EXPECT_FALSE(CreateApplication().get());
+}
+
+}  // namespace application
+}  // namespace xwalk
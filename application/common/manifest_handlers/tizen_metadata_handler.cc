@@ -98,6 +98,10 @@ bool TizenMetaDataHandler::Parse(scoped_refptr<ApplicationData> application,
   return true;
 }
 
+bool TizenMetaDataHandler::ParseLazily() const {
+  return true;
+}
+
 std::vector<std::string> TizenMetaDataHandler::Keys() const {
   return std::vector<std::string>(1, keys::kTizenMetaDataKey);
 }
@@ -38,6 +38,7 @@ class TizenMetaDataHandler : public ManifestHandler {
 
   virtual bool Parse(scoped_refptr<ApplicationData> application,
                      base::string16* error) OVERRIDE;
+  virtual bool ParseLazily() const OVERRIDE;
   virtual std::vector<std::string> Keys() const OVERRIDE;
 
  private:
@@ -56,6 +56,10 @@ bool TizenSettingHandler::Validate(
   return true;
 }
 
+bool TizenSettingHandler::ParseLazily() const {
+  return true;
+}
+
 std::vector<std::string> TizenSettingHandler::Keys() const {
   return std::vector<std::string>(1, keys::kTizenSettingKey);
 }
@@ -37,6 +37,7 @@ class TizenSettingHandler : public ManifestHandler {
   virtual bool Validate(scoped_refptr<const ApplicationData> application,
                         std::string* error,
                         std::vector<InstallWarning>* warnings) const OVERRIDE;
+  virtual bool ParseLazily() const OVERRIDE;
   virtual std::vector<std::string> Keys() const OVERRIDE;
 
  private:
@@ -67,6 +67,10 @@ bool TizenSplashScreenHandler::Validate(
   return true;
 }
 
+bool TizenSplashScreenHandler::ParseLazily() const {
+  return true;
+}
+
 std::vector<std::string> TizenSplashScreenHandler::Keys() const {
   return std::vector<std::string>(1, keys::kTizenSplashScreenKey);
 }
@@ -18,6 +18,7 @@
 
 namespace errors = xwalk::application_manifest_errors;
 namespace keys = xwalk::application_manifest_keys;
+namespace widget_keys = xwalk::application_widget_keys;
 
 namespace xwalk {
 namespace application {
@@ -114,6 +115,35 @@ TEST_F(ManifestTest, ApplicationTypes) {
       &manifest, keys::kLaunchWebURLKey, NULL);
 }
 
+// Verifies that the localized strings follow the system locale.
+TEST_F(ManifestTest, LocalizedStrings) {
+  scoped_ptr<base::ListValue> names(new base::ListValue);
+  base::DictionaryValue* name = new base::DictionaryValue;
+  name->SetString("#text", "unlocalized name");
+  names->Append(name);
+  name = new base::DictionaryValue;
+  name->SetString("#text", "zh-CN name");
+  name->SetString(widget_keys::kXmlLangKey, "zh-CN");
+  names->Append(name);
+
+  scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue());
+  value->Set("widget.name", names.release());
+  Manifest manifest(Manifest::COMMAND_LINE, value.Pass());
+
+  std::string result;
+  manifest.SetSystemLocale("zh-cn");
+  EXPECT_TRUE(manifest.GetString(widget_keys::kNameKey, &result));
+  EXPECT_EQ("zh-CN name", result);
+
+  manifest.SetSystemLocale("fr-fr");
+  base::string16 result16;
+  EXPECT_TRUE(manifest.GetString(widget_keys::kNameKey, &result16));
+  EXPECT_EQ(base::ASCIIToUTF16("unlocalized name"), result16);
+
+  // No element has a short name.
+  EXPECT_FALSE(manifest.GetString("widget.name.@short", &result));
+}
+
 }  // namespace application
 }  // namespace xwalk
 
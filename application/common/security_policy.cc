@@ -6,9 +6,13 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
 #include "content/public/browser/render_process_host.h"
 #include "xwalk/application/browser/application.h"
+#include "xwalk/application/common/access_whitelist.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 #include "xwalk/application/common/constants.h"
 #include "xwalk/application/common/manifest_handlers/csp_handler.h"
@@ -57,56 +61,109 @@ CSPInfo* GetDefaultCSPInfo() {
 
 }  // namespace
 
-SecurityPolicy::WhitelistEntry::WhitelistEntry(const GURL& url, bool subdomains)
-  : url(url),
-    subdomains(subdomains) {
-}
+class SecurityPolicy::Rules : public base::RefCountedThreadSafe<Rules> {
+ public:
+  explicit Rules(const std::string& app_id)
+      : app_id_(app_id) {
+  }
+
+  bool IsAccessAllowed(const GURL& url) const {
+    // Accessing own resources is always allowed.
+    if (url.SchemeIs(application::kApplicationScheme) &&
+        url.host() == app_id_)
+      return true;
+
+    return whitelist_.IsAllowed(url);
+  }
+
+  AccessWhitelist* whitelist() { return &whitelist_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<Rules>;
+  ~Rules() {}
+
+  const std::string app_id_;
+  AccessWhitelist whitelist_;
+
+  DISALLOW_COPY_AND_ASSIGN(Rules);
+};
+
+namespace {
+
+// The enabled policies by render process, looked up from any thread.
+struct RegisteredPolicies {
+  base::Lock lock;
+  std::map<int, scoped_refptr<SecurityPolicy::Rules> > rules;
+};
+
+base::LazyInstance<RegisteredPolicies> g_registered_policies =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
 
 SecurityPolicy::SecurityPolicy(Application* app)
   : app_(app),
-    enabled_(false) {
+    enabled_(false),
+    rules_(new Rules(app->id())),
+    registered_(false),
+    render_process_id_(0) {
 }
 
 SecurityPolicy::~SecurityPolicy() {
+  if (!registered_ || !enabled_)
+    return;
+  RegisteredPolicies& policies = g_registered_policies.Get();
+  base::AutoLock lock(policies.lock);
+  policies.rules.erase(render_process_id_);
 }
 
 bool SecurityPolicy::IsAccessAllowed(const GURL& url) const {
   if (!enabled_)
     return true;
+  return rules_->IsAccessAllowed(url);
+}
 
-  // Accessing own resources is always allowed.
-  if (url.SchemeIs(application::kApplicationScheme) &&
-      url.host() == app_->id())
-    return true;
+void SecurityPolicy::Enforce() {
+}
 
-  for (std::vector<WhitelistEntry>::const_iterator it =
-      whitelist_entries_.begin(); it != whitelist_entries_.end(); ++it) {
-    const GURL& policy = it->url;
-    bool subdomains = it->subdomains;
-    bool is_host_matched = subdomains ?
-        url.DomainIs(policy.host().c_str()) : url.host() == policy.host();
-    if (url.scheme() == policy.scheme() && is_host_matched)
-      return true;
-  }
-  return false;
+void SecurityPolicy::Register() {
+  DCHECK(app_->render_process_host());
+  DCHECK(!registered_);
+  registered_ = true;
+  // A disabled policy allows everything, as no policy does.
+  if (!enabled_)
+    return;
+  render_process_id_ = app_->render_process_host()->GetID();
+  RegisteredPolicies& policies = g_registered_policies.Get();
+  base::AutoLock lock(policies.lock);
+  policies.rules[render_process_id_] = rules_;
 }
 
-void SecurityPolicy::Enforce() {
+// static
+bool SecurityPolicy::IsAccessAllowedForProcess(int render_process_id,
+                                               const GURL& url) {
+  scoped_refptr<Rules> rules;
+  {
+    RegisteredPolicies& policies = g_registered_policies.Get();
+    base::AutoLock lock(policies.lock);
+    std::map<int, scoped_refptr<Rules> >::const_iterator it =
+        policies.rules.find(render_process_id);
+    if (it == policies.rules.end())
+      return true;
+    rules = it->second;
+  }
+  return rules->IsAccessAllowed(url);
 }
 
 void SecurityPolicy::AddWhitelistEntry(const GURL& url, bool subdomains) {
   GURL app_url = app_->data()->URL();
   DCHECK(app_->render_process_host());
-  WhitelistEntry entry = WhitelistEntry(url, subdomains);
-
-  std::vector<WhitelistEntry>::iterator it =
-      std::find(whitelist_entries_.begin(), whitelist_entries_.end(), entry);
-  if (it != whitelist_entries_.end())
+  DCHECK(!registered_);
+  if (!rules_->whitelist()->AddEntry(url, subdomains))
     return;
 
   app_->render_process_host()->Send(new ViewMsg_SetAccessWhiteList(
       app_url, url, subdomains));
-  whitelist_entries_.push_back(entry);
 }
 
 SecurityPolicyWARP::SecurityPolicyWARP(Application* app)
@@ -5,8 +5,7 @@
 #ifndef XWALK_APPLICATION_COMMON_SECURITY_POLICY_H_
 #define XWALK_APPLICATION_COMMON_SECURITY_POLICY_H_
 
-#include <vector>
-
+#include "base/memory/ref_counted.h"
 #include "url/gurl.h"
 
 namespace xwalk {
@@ -31,22 +30,32 @@ class SecurityPolicy {
 
   virtual void Enforce() = 0;
 
- protected:
-  struct WhitelistEntry {
-    WhitelistEntry(const GURL& url, bool subdomains);
-    GURL url;
-    bool subdomains;
-
-    bool operator==(const WhitelistEntry& o) const {
-      return o.url == url && o.subdomains == subdomains;
-    }
-  };
+  // Makes the enforced policy checkable by IsAccessAllowedForProcess(), for
+  // the render process of the application. The policy can't change anymore
+  // then, it is unregistered when destroyed.
+  void Register();
+
+  // Same as IsAccessAllowed() for the application running in
+  // |render_process_id|, but callable from any thread, e.g. from the IO
+  // thread when a window is opened, without a hop to the UI thread.
+  // Everything is allowed to a process without a registered policy.
+  static bool IsAccessAllowedForProcess(int render_process_id,
+                                        const GURL& url);
 
+  // The compiled whitelist, shared read-only with the other threads once
+  // registered.
+  class Rules;
+
+ protected:
   void AddWhitelistEntry(const GURL& url, bool subdomains);
 
-  std::vector<WhitelistEntry> whitelist_entries_;
   Application* app_;
   bool enabled_;
+
+ private:
+  scoped_refptr<Rules> rules_;
+  bool registered_;
+  int render_process_id_;
 };
 
 class SecurityPolicyWARP : public SecurityPolicy {
@@ -0,0 +1,136 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/common/splash_screen_cache_tizen.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+
+namespace xwalk {
+namespace application {
+
+namespace {
+
+const base::FilePath::CharType kCacheExtension[] =
+    FILE_PATH_LITERAL(".xwalksplash");
+
+const uint32 kCacheMagic = 0x58575350;  // "XWSP"
+const uint32 kCacheVersion = 1;
+
+// Followed by height * width * 4 bytes of pixels. Its size keeps them
+// aligned.
+struct CacheHeader {
+  uint32 magic;
+  uint32 version;
+  int32 width;
+  int32 height;
+  // Of the image the cache was made from.
+  int64 image_size;
+  int64 image_last_modified;
+};
+
+bool FillHeader(const base::FilePath& image_path, CacheHeader* header) {
+  base::File::Info info;
+  if (!base::GetFileInfo(image_path, &info))
+    return false;
+
+  header->magic = kCacheMagic;
+  header->version = kCacheVersion;
+  header->image_size = info.size;
+  header->image_last_modified = info.last_modified.ToInternalValue();
+  return true;
+}
+
+}  // namespace
+
+base::FilePath GetSplashScreenCachePath(const base::FilePath& image_path) {
+  return image_path.AddExtension(kCacheExtension);
+}
+
+bool WriteSplashScreenCache(const base::FilePath& image_path) {
+  CacheHeader header;
+  std::string data;
+  if (!FillHeader(image_path, &header) ||
+      !base::ReadFileToString(image_path, &data))
+    return false;
+
+  const unsigned char* encoded =
+      reinterpret_cast<const unsigned char*>(data.data());
+  SkBitmap bitmap;
+  std::string extension = StringToLowerASCII(image_path.Extension());
+  if (extension == ".png") {
+    if (!gfx::PNGCodec::Decode(encoded, data.size(), &bitmap))
+      return false;
+  } else if (extension == ".jpg" || extension == ".jpeg") {
+    scoped_ptr<SkBitmap> decoded(
+        gfx::JPEGCodec::Decode(encoded, data.size()));
+    if (!decoded)
+      return false;
+    bitmap = *decoded;
+  } else {
+    return false;
+  }
+
+  // Both codecs decode to premultiplied N32 pixels.
+  if (bitmap.config() != SkBitmap::kARGB_8888_Config)
+    return false;
+
+  header.width = bitmap.width();
+  header.height = bitmap.height();
+  std::string cache(reinterpret_cast<const char*>(&header), sizeof(header));
+  SkAutoLockPixels lock(bitmap);
+  for (int y = 0; y < bitmap.height(); ++y) {
+    cache.append(reinterpret_cast<const char*>(bitmap.getAddr32(0, y)),
+                 bitmap.width() * 4);
+  }
+
+  base::FilePath cache_path = GetSplashScreenCachePath(image_path);
+  if (base::WriteFile(cache_path, cache.data(), cache.size()) !=
+      static_cast<int>(cache.size())) {
+    base::DeleteFile(cache_path, false);
+    return false;
+  }
+  return true;
+}
+
+bool MapSplashScreenCache(const base::FilePath& image_path,
+                          base::MemoryMappedFile* file,
+                          SkBitmap* bitmap) {
+  CacheHeader expected;
+  if (!FillHeader(image_path, &expected) ||
+      !file->Initialize(GetSplashScreenCachePath(image_path)) ||
+      file->length() < sizeof(CacheHeader))
+    return false;
+
+  CacheHeader header;
+  memcpy(&header, file->data(), sizeof(header));
+  if (header.magic != expected.magic ||
+      header.version != expected.version ||
+      header.image_size != expected.image_size ||
+      header.image_last_modified != expected.image_last_modified ||
+      header.width <= 0 || header.height <= 0 ||
+      (file->length() - sizeof(header)) / 4 / header.width <
+          static_cast<size_t>(header.height)) {
+    LOG(WARNING) << "Ignoring the stale splash screen cache of "
+                 << image_path.MaybeAsASCII();
+    return false;
+  }
+
+  bitmap->setConfig(SkBitmap::kARGB_8888_Config, header.width,
+                    header.height);
+  // The pixels are never written, the mapping is read-only.
+  bitmap->setPixels(const_cast<uint8*>(file->data() + sizeof(header)));
+  bitmap->setImmutable();
+  return true;
+}
+
+}  // namespace application
+}  // namespace xwalk
@@ -0,0 +1,38 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_APPLICATION_COMMON_SPLASH_SCREEN_CACHE_TIZEN_H_
+#define XWALK_APPLICATION_COMMON_SPLASH_SCREEN_CACHE_TIZEN_H_
+
+#include "base/files/file_path.h"
+
+class SkBitmap;
+
+namespace base {
+class MemoryMappedFile;
+}
+
+namespace xwalk {
+namespace application {
+
+// The splash screen of a Tizen application is decoded when it is installed
+// and stored next to the image as raw N32 premultiplied pixels, so it can
+// be mapped and shown at launch without decoding it again.
+base::FilePath GetSplashScreenCachePath(const base::FilePath& image_path);
+
+// Decodes the PNG or JPEG |image_path| into its cache. Returns false if the
+// image can't be decoded or the cache written.
+bool WriteSplashScreenCache(const base::FilePath& image_path);
+
+// Maps the cache of |image_path| into |file| and points |bitmap| at its
+// pixels, which stay valid as long as |file|. Fails if there is no cache or
+// it doesn't match the image anymore.
+bool MapSplashScreenCache(const base::FilePath& image_path,
+                          base::MemoryMappedFile* file,
+                          SkBitmap* bitmap);
+
+}  // namespace application
+}  // namespace xwalk
+
+#endif  // XWALK_APPLICATION_COMMON_SPLASH_SCREEN_CACHE_TIZEN_H_
@@ -9,5 +9,41 @@ var application = requireNative('application');
 
 // Exported methods.
 exports.getManifest = function(callback) {
+  // Read from the state published by the native side, the callback is still
+  // called asynchronously. The object is shared by every reader, so the
+  // caller gets a copy of its own.
+  var state = extension.getPublishedState();
+  if (state && state.manifest) {
+    var manifest = JSON.parse(JSON.stringify(state.manifest));
+    setTimeout(function() { callback(manifest); }, 0);
+    return;
+  }
+
   internal.postMessage('getManifest', [], callback);
 };
+
+// Calls back with the memory the application costs, in KB, as last sampled
+// by the runtime: the proportional (pss) and unique (uss) set sizes of its
+// renderer and extensionProcess, their total, and the ageMs of the sample.
+// Calls back with null if no sample was taken yet.
+exports.getMemoryUsage = function(callback) {
+  internal.postMessage('getMemoryUsage', [], callback);
+};
+
+// Calls back with the network statistics of the application: the number of
+// requests, failures, cache hits and bytes read, and the average duration of
+// the dns, connect, ssl, timeToFirstByte and download phases.
+exports.getNetworkStats = function(callback) {
+  internal.postMessage('getNetworkStats', [], callback);
+};
+
+exports.resetNetworkStats = function() {
+  internal.postMessage('resetNetworkStats', []);
+};
+
+// Calls back with the number of "xwalk_prefetch" urls of the manifest which
+// were fetched into the HTTP cache after the launch, and of those which
+// failed to be, once they all have been tried.
+exports.waitForPrefetch = function(callback) {
+  internal.postMessage('waitForPrefetch', [], callback);
+};
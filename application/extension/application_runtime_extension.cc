@@ -11,34 +11,86 @@
 #include "grit/xwalk_application_resources.h"
 #include "ui/base/resource/resource_bundle.h"
 #include "xwalk/application/browser/application.h"
+#include "xwalk/application/browser/application_memory_monitor.h"
+#include "xwalk/application/browser/application_service.h"
 #include "xwalk/application/common/application_data.h"
 #include "xwalk/runtime/browser/runtime.h"
+#include "xwalk/runtime/browser/runtime_network_stats.h"
 
 using content::BrowserThread;
 
+namespace {
+
+void PostPrefetchResult(
+    const xwalk::extensions::XWalkExtensionFunctionInfo::PostResultCallback&
+        post_result_cb,
+    int fetched,
+    int failed) {
+  base::DictionaryValue* result = new base::DictionaryValue;
+  result->SetInteger("fetched", fetched);
+  result->SetInteger("failed", failed);
+
+  scoped_ptr<base::ListValue> results(new base::ListValue());
+  results->Append(result);
+  post_result_cb.Run(results.Pass());
+}
+
+}  // namespace
+
 namespace xwalk {
 namespace application {
 
 ApplicationRuntimeExtension::ApplicationRuntimeExtension(
-    Application* application)
-  : application_(application) {
+    ApplicationService* service, ApplicationMemoryMonitor* memory_monitor,
+    int render_process_id)
+  : service_(service),
+    memory_monitor_(memory_monitor),
+    render_process_id_(render_process_id) {
   set_name("xwalk.app.runtime");
   set_javascript_api(ResourceBundle::GetSharedInstance().GetRawDataResource(
       IDR_XWALK_APPLICATION_RUNTIME_API).as_string());
 }
 
 XWalkExtensionInstance* ApplicationRuntimeExtension::CreateInstance() {
-  return new AppRuntimeExtensionInstance(application_);
+  Application* application =
+      service_->GetApplicationByRenderHostID(render_process_id_);
+  if (!application)
+    return NULL;
+  return new AppRuntimeExtensionInstance(application, memory_monitor_);
 }
 
 AppRuntimeExtensionInstance::AppRuntimeExtensionInstance(
-    Application* application)
+    Application* application, ApplicationMemoryMonitor* memory_monitor)
   : application_(application),
+    memory_monitor_(memory_monitor),
     handler_(this) {
   handler_.Register(
       "getManifest",
       base::Bind(&AppRuntimeExtensionInstance::OnGetManifest,
                  base::Unretained(this)));
+  handler_.Register(
+      "getMemoryUsage",
+      base::Bind(&AppRuntimeExtensionInstance::OnGetMemoryUsage,
+                 base::Unretained(this)));
+  handler_.Register(
+      "getNetworkStats",
+      base::Bind(&AppRuntimeExtensionInstance::OnGetNetworkStats,
+                 base::Unretained(this)));
+  handler_.Register(
+      "resetNetworkStats",
+      base::Bind(&AppRuntimeExtensionInstance::OnResetNetworkStats,
+                 base::Unretained(this)));
+  handler_.Register(
+      "waitForPrefetch",
+      base::Bind(&AppRuntimeExtensionInstance::OnWaitForPrefetch,
+                 base::Unretained(this)));
+
+  // Lets getManifest() answer without a round trip, the manifest of a
+  // running application doesn't change.
+  scoped_ptr<base::DictionaryValue> state(new base::DictionaryValue);
+  state->Set("manifest",
+             application_->data()->GetManifest()->value()->DeepCopy());
+  PublishStateToJS(state.PassAs<base::Value>());
 }
 
 void AppRuntimeExtensionInstance::HandleMessage(scoped_ptr<base::Value> msg) {
@@ -60,5 +112,40 @@ void AppRuntimeExtensionInstance::OnGetManifest(
   info->PostResult(results.Pass());
 }
 
+void AppRuntimeExtensionInstance::OnGetMemoryUsage(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  ApplicationMemoryUsage usage;
+  scoped_ptr<base::ListValue> results(new base::ListValue());
+  if (memory_monitor_->GetMemoryUsage(application_->id(), &usage))
+    results->Append(usage.ToValue().release());
+  else
+    // Not sampled yet, or not supported on this platform.
+    results->Append(base::Value::CreateNullValue());
+  info->PostResult(results.Pass());
+}
+
+void AppRuntimeExtensionInstance::OnGetNetworkStats(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  scoped_ptr<base::ListValue> results(new base::ListValue());
+  results->Append(
+      RuntimeNetworkStats::GetInstance()->GetStats(application_->id())
+          .release());
+  info->PostResult(results.Pass());
+}
+
+void AppRuntimeExtensionInstance::OnResetNetworkStats(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  RuntimeNetworkStats::GetInstance()->Reset(application_->id());
+}
+
+void AppRuntimeExtensionInstance::OnWaitForPrefetch(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // The reply is dropped if this instance is gone by then.
+  application_->WaitForPrefetch(
+      base::Bind(&PostPrefetchResult, info->post_result_cb()));
+}
+
 }  // namespace application
 }  // namespace xwalk
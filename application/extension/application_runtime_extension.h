@@ -13,33 +13,47 @@
 namespace xwalk {
 namespace application {
 class Application;
+class ApplicationMemoryMonitor;
+class ApplicationService;
 
 using extensions::XWalkExtension;
 using extensions::XWalkExtensionFunctionHandler;
 using extensions::XWalkExtensionFunctionInfo;
 using extensions::XWalkExtensionInstance;
 
+// The application is looked up when an instance is created, the render
+// process may have been started before the application was launched.
 class ApplicationRuntimeExtension : public XWalkExtension {
  public:
-  explicit ApplicationRuntimeExtension(Application* application);
+  ApplicationRuntimeExtension(ApplicationService* service,
+                              ApplicationMemoryMonitor* memory_monitor,
+                              int render_process_id);
 
   // XWalkExtension implementation.
   virtual XWalkExtensionInstance* CreateInstance() OVERRIDE;
 
  private:
-  Application* application_;
+  ApplicationService* service_;
+  ApplicationMemoryMonitor* memory_monitor_;
+  int render_process_id_;
 };
 
 class AppRuntimeExtensionInstance : public XWalkExtensionInstance {
  public:
-  explicit AppRuntimeExtensionInstance(Application* application);
+  AppRuntimeExtensionInstance(Application* application,
+                              ApplicationMemoryMonitor* memory_monitor);
 
   virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE;
 
  private:
   void OnGetManifest(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnGetMemoryUsage(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnGetNetworkStats(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnResetNetworkStats(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnWaitForPrefetch(scoped_ptr<XWalkExtensionFunctionInfo> info);
 
   Application* application_;
+  ApplicationMemoryMonitor* memory_monitor_;
 
   XWalkExtensionFunctionHandler handler_;
 };
@@ -21,21 +21,30 @@ var widgetStringInfo = {
   "height"      : zero
 };
 
+// The widget attributes don't change while the application runs, they are
+// fetched with the first one that is read.
+var widgetInfo = null;
+
+function getWidgetInfo() {
+  if (!widgetInfo) {
+    widgetInfo = Object.freeze(
+        extension.internal.sendSyncMessage({ cmd: 'GetWidgetInfo' }) || {});
+  }
+  return widgetInfo;
+}
+
 function defineReadOnlyProperty(object, key, value) {
   Object.defineProperty(object, key, {
     configurable: false,
     enumerable: true,
     get: function() {
-      if (key == "width") {
-        value = window.innerWidth;
-      } else if (key == "height") {
-        value = window.innerHeight;
-      } else if (value == empty) {
-        value = extension.internal.sendSyncMessage(
-            { cmd: 'GetWidgetInfo', widgetKey: key });
-      }
+      if (key == "width")
+        return window.innerWidth;
+      if (key == "height")
+        return window.innerHeight;
 
-      return value;
+      var info = getWidgetInfo();
+      return info.hasOwnProperty(key) ? info[key] : value;
     }
   });
 }
@@ -125,21 +134,18 @@ var WidgetStorage = function() {
   }
 
   this.clear = function() {
-    var itemKey;
     var result = extension.internal.sendSyncMessage({
         cmd: 'ClearAllItems' });
 
     if (!result)
       return;
 
-    for (var i = _keyList.length-1; i >= 0; --i) {
-      // if the itemKey is still in DB(e.g. readonly),
-      // we should keep it in JS side.
-      var exists = extension.internal.sendSyncMessage({
-          cmd: 'KeyExists',
-          preferencesItemKey: _keyList[i] });
+    // The read only items are still in DB, we should keep them in JS side.
+    var remaining = extension.internal.sendSyncMessage({
+        cmd: 'GetAllItems' });
 
-      if (!exists) {
+    for (var i = _keyList.length-1; i >= 0; --i) {
+      if (!remaining.hasOwnProperty(_keyList[i])) {
         delete this[_keyList[i]];
         delete _itemStorage[_keyList[i]];
         _keyList.splice(i, 1);
@@ -15,6 +15,7 @@
 #include "grit/xwalk_application_resources.h"
 #include "ui/base/resource/resource_bundle.h"
 #include "xwalk/application/browser/application.h"
+#include "xwalk/application/browser/application_service.h"
 #include "xwalk/application/common/application_data.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 #include "xwalk/application/common/manifest_handlers/widget_handler.h"
@@ -28,7 +29,6 @@ using content::BrowserThread;
 
 namespace {
 const char kCommandKey[] = "cmd";
-const char kWidgetAttributeKey[] = "widgetKey";
 const char kPreferencesItemKey[] = "preferencesItemKey";
 const char kPreferencesItemValue[] = "preferencesItemValue";
 }
@@ -39,15 +39,20 @@ namespace application {
 namespace widget_keys = xwalk::application_widget_keys;
 
 ApplicationWidgetExtension::ApplicationWidgetExtension(
-    Application* application)
-  : application_(application) {
+    ApplicationService* service, int render_process_id)
+  : service_(service),
+    render_process_id_(render_process_id) {
   set_name("widget");
   set_javascript_api(ResourceBundle::GetSharedInstance().GetRawDataResource(
       IDR_XWALK_APPLICATION_WIDGET_API).as_string());
 }
 
 XWalkExtensionInstance* ApplicationWidgetExtension::CreateInstance() {
-  return new AppWidgetExtensionInstance(application_);
+  Application* application =
+      service_->GetApplicationByRenderHostID(render_process_id_);
+  if (!application)
+    return NULL;
+  return new AppWidgetExtensionInstance(application);
 }
 
 AppWidgetExtensionInstance::AppWidgetExtensionInstance(
@@ -104,25 +109,26 @@ void AppWidgetExtensionInstance::HandleSyncMessage(
   SendSyncReplyToJS(result.Pass());
 }
 
-scoped_ptr<base::StringValue> AppWidgetExtensionInstance::GetWidgetInfo(
+scoped_ptr<base::DictionaryValue> AppWidgetExtensionInstance::GetWidgetInfo(
     scoped_ptr<base::Value> msg) {
-  scoped_ptr<base::StringValue> result(base::Value::CreateStringValue(""));
-  std::string key;
-  std::string value;
-  base::DictionaryValue* dict;
-
-  if (!msg->GetAsDictionary(&dict) ||
-      !dict->GetString(kWidgetAttributeKey, &key)) {
-    LOG(ERROR) << "Fail to get widget attribute key.";
-    return result.Pass();
-  }
-
+  scoped_ptr<base::DictionaryValue> result(new base::DictionaryValue);
   WidgetInfo* info =
       static_cast<WidgetInfo*>(
       application_->data()->GetManifestData(widget_keys::kWidgetKey));
   base::DictionaryValue* widget_info = info->GetWidgetInfo();
-  widget_info->GetString(key, &value);
-  result.reset(base::Value::CreateStringValue(value));
+  if (!widget_info) {
+    LOG(ERROR) << "Fail to get parsed widget information.";
+    return result.Pass();
+  }
+
+  // The attributes don't change while the application runs, they are all
+  // sent at once and cached by the renderer.
+  for (base::DictionaryValue::Iterator it(*widget_info); !it.IsAtEnd();
+       it.Advance()) {
+    std::string value;
+    if (it.value().GetAsString(&value))
+      result->SetStringWithoutPathExpansion(it.key(), value);
+  }
   return result.Pass();
 }
 
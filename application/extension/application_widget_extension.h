@@ -13,21 +13,26 @@
 namespace xwalk {
 namespace application {
 class Application;
+class ApplicationService;
 
 using extensions::XWalkExtension;
 using extensions::XWalkExtensionFunctionHandler;
 using extensions::XWalkExtensionFunctionInfo;
 using extensions::XWalkExtensionInstance;
 
+// The application is looked up when an instance is created, the render
+// process may have been started before the application was launched.
 class ApplicationWidgetExtension : public XWalkExtension {
  public:
-  explicit ApplicationWidgetExtension(Application* application);
+  ApplicationWidgetExtension(ApplicationService* service,
+                             int render_process_id);
 
   // XWalkExtension implementation.
   virtual XWalkExtensionInstance* CreateInstance() OVERRIDE;
 
  private:
-  Application* application_;
+  ApplicationService* service_;
+  int render_process_id_;
 };
 
 class AppWidgetExtensionInstance : public XWalkExtensionInstance {
@@ -39,7 +44,8 @@ class AppWidgetExtensionInstance : public XWalkExtensionInstance {
   virtual void HandleSyncMessage(scoped_ptr<base::Value> msg) OVERRIDE;
 
  private:
-  scoped_ptr<base::StringValue> GetWidgetInfo(scoped_ptr<base::Value> msg);
+  scoped_ptr<base::DictionaryValue> GetWidgetInfo(
+      scoped_ptr<base::Value> msg);
   scoped_ptr<base::FundamentalValue> SetPreferencesItem(
       scoped_ptr<base::Value> mgs);
   scoped_ptr<base::FundamentalValue> RemovePreferencesItem(
@@ -6,6 +6,7 @@
 
 #include <string>
 
+#include "base/bind.h"
 #include "base/file_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "sql/statement.h"
@@ -30,33 +31,19 @@ const char kCreateStorageTableOp[] =
     "value TEXT NOT NULL,"
     "read_only INTEGER )";
 
-const char kClearStorageTableWithBindOp[] =
-    "DELETE FROM widget_storage WHERE read_only = ? ";
-
-const char kInsertItemWithBindOp[] =
-    "INSERT INTO widget_storage (value, read_only, key) "
+const char kSetItemWithBindOp[] =
+    "INSERT OR REPLACE INTO widget_storage (key, value, read_only) "
     "VALUES(?,?,?)";
 
-const char kUpdateItemWithBindOp[] =
-    "UPDATE widget_storage SET value = ? , read_only = ? "
-    "WHERE key = ?";
-
 const char kRemoveItemWithBindOp[] =
     "DELETE FROM widget_storage WHERE key = ?";
 
-const char kSelectTableLength[] =
-    "SELECT count(*) FROM widget_storage ";
-
-const char kSelectCountWithBindOp[] =
-    "SELECT count(*) FROM widget_storage "
-    "WHERE key = ?";
-
 const char kSelectAllItem[] =
-    "SELECT key, value FROM widget_storage ";
+    "SELECT key, value, read_only FROM widget_storage ";
+
+// Long enough to batch the items a script sets in a row.
+const int kCommitDelayMs = 500;
 
-const char kSelectReadOnlyWithBindOp[] =
-    "SELECT read_only FROM widget_storage "
-    "WHERE key = ?";
 }  // namespace
 
 namespace xwalk {
@@ -65,8 +52,8 @@ namespace application {
 AppWidgetStorage::AppWidgetStorage(Application* application,
                                    const base::FilePath& data_dir)
     : application_(application),
-      db_initialized_(false),
-      data_path_(data_dir) {
+      data_path_(data_dir),
+      db_initialized_(false) {
   sqlite_db_.reset(new sql::Connection);
 
   if (!Init()) {
@@ -76,6 +63,8 @@ AppWidgetStorage::AppWidgetStorage(Application* application,
 }
 
 AppWidgetStorage::~AppWidgetStorage() {
+  if (db_initialized_)
+    Commit();
 }
 
 bool AppWidgetStorage::Init() {
@@ -92,6 +81,15 @@ bool AppWidgetStorage::Init() {
   return db_initialized_;
 }
 
+bool AppWidgetStorage::LoadEntries() {
+  entries_.clear();
+  sql::Statement stmt(sqlite_db_->GetUniqueStatement(kSelectAllItem));
+  while (stmt.Step())
+    entries_[stmt.ColumnString(0)] =
+        Entry(stmt.ColumnString(1), stmt.ColumnBool(2));
+  return stmt.Succeeded();
+}
+
 bool AppWidgetStorage::SaveConfigInfoItem(base::DictionaryValue* dict) {
   DCHECK(dict);
   std::string key;
@@ -140,6 +138,8 @@ bool AppWidgetStorage::SaveConfigInfoInDB() {
 
 bool AppWidgetStorage::InitStorageTable() {
   if (sqlite_db_->DoesTableExist(kStorageTableName)) {
+    if (!LoadEntries())
+      return false;
     db_initialized_ = (sqlite_db_ && sqlite_db_->is_open());
     return true;
   }
@@ -153,47 +153,19 @@ bool AppWidgetStorage::InitStorageTable() {
 
   db_initialized_ = (sqlite_db_ && sqlite_db_->is_open());
   SaveConfigInfoInDB();
-
-  return true;
+  // The preferences of the config file are written at once, they are
+  // only saved when the table is created.
+  commit_timer_.Stop();
+  return Commit();
 }
 
 bool AppWidgetStorage::EntryExists(const std::string& key) const {
-  sql::Transaction transaction(sqlite_db_.get());
-  if (!transaction.Begin())
-    return false;
-
-  sql::Statement stmt(sqlite_db_->GetUniqueStatement(
-      kSelectCountWithBindOp));
-  stmt.BindString(0, key);
-  if (!stmt.Step()) {
-    LOG(ERROR) << "An error occured when selecting count from DB.";
-    return false;
-  }
-
-  if (!transaction.Commit())
-    return false;
-
-  int exist = stmt.ColumnInt(0);
-  return exist > 0;
+  return entries_.find(key) != entries_.end();
 }
 
-bool AppWidgetStorage::IsReadOnly(const std::string& key) {
-  sql::Transaction transaction(sqlite_db_.get());
-  if (!transaction.Begin())
-    return true;
-
-  sql::Statement stmt(sqlite_db_->GetUniqueStatement(
-      kSelectReadOnlyWithBindOp));
-  stmt.BindString(0, key);
-  if (!stmt.Step()) {
-    LOG(ERROR) << "An error occured when selecting count from DB.";
-    return true;
-  }
-
-  if (!transaction.Commit())
-    return true;
-
-  return stmt.ColumnBool(0);
+bool AppWidgetStorage::IsReadOnly(const std::string& key) const {
+  EntryMap::const_iterator it = entries_.find(key);
+  return it == entries_.end() || it->second.read_only;
 }
 
 bool AppWidgetStorage::AddEntry(const std::string& key,
@@ -202,31 +174,15 @@ bool AppWidgetStorage::AddEntry(const std::string& key,
   if (!db_initialized_ && !Init())
     return false;
 
-  std::string operation;
-  if (!EntryExists(key)) {
-    operation = kInsertItemWithBindOp;
-  } else if (!IsReadOnly(key)) {
-    operation = kUpdateItemWithBindOp;
-  } else {
+  if (EntryExists(key) && IsReadOnly(key)) {
     LOG(ERROR) << "Could not set read only item " << key;
     return false;
   }
 
-  sql::Transaction transaction(sqlite_db_.get());
-  if (!transaction.Begin())
-    return false;
-
-  sql::Statement stmt(sqlite_db_->GetUniqueStatement(
-    operation.c_str()));
-  stmt.BindString(0, value);
-  stmt.BindBool(1, read_only);
-  stmt.BindString(2, key);
-  if (!stmt.Run()) {
-    LOG(ERROR) << "An error occured when set item into DB.";
-    return false;
-  }
-
-  return transaction.Commit();
+  entries_[key] = Entry(value, read_only);
+  dirty_keys_.insert(key);
+  ScheduleCommit();
+  return true;
 }
 
 bool AppWidgetStorage::RemoveEntry(const std::string& key) {
@@ -238,58 +194,83 @@ bool AppWidgetStorage::RemoveEntry(const std::string& key) {
     return false;
   }
 
-  sql::Transaction transaction(sqlite_db_.get());
-  if (!transaction.Begin())
-    return false;
-
-  sql::Statement stmt(sqlite_db_->GetUniqueStatement(
-      kRemoveItemWithBindOp));
-  stmt.BindString(0, key);
-
-  if (!stmt.Run()) {
-    LOG(ERROR) << "An error occured when removing item into DB.";
-    return false;
-  }
-
-  return transaction.Commit();
+  entries_.erase(key);
+  dirty_keys_.insert(key);
+  ScheduleCommit();
+  return true;
 }
 
 bool AppWidgetStorage::Clear() {
   if (!db_initialized_ && !Init())
     return false;
 
-  sql::Transaction transaction(sqlite_db_.get());
-  transaction.Begin();
-
-  sql::Statement stmt(sqlite_db_->GetUniqueStatement(
-      kClearStorageTableWithBindOp));
-  stmt.BindBool(0, false);
-
-  if (!stmt.Run()) {
-    LOG(ERROR) << "An error occured when removing item into DB.";
-    return false;
+  for (EntryMap::iterator it = entries_.begin(); it != entries_.end();) {
+    if (it->second.read_only) {
+      ++it;
+      continue;
+    }
+    dirty_keys_.insert(it->first);
+    entries_.erase(it++);
   }
-
-  return transaction.Commit();
+  ScheduleCommit();
+  return true;
 }
 
 bool AppWidgetStorage::GetAllEntries(base::DictionaryValue* result) {
-  std::string key;
-  std::string value;
   DCHECK(result);
 
   if (!db_initialized_ && !Init())
     return false;
 
-  sql::Statement stmt(sqlite_db_->GetUniqueStatement(kSelectAllItem));
-  while (stmt.Step()) {
-    key = stmt.ColumnString(0);
-    value = stmt.ColumnString(1);
-    result->SetString(key, value);
-  }
+  for (EntryMap::const_iterator it = entries_.begin();
+       it != entries_.end(); ++it)
+    result->SetString(it->first, it->second.value);
 
   return true;
 }
 
+void AppWidgetStorage::ScheduleCommit() {
+  if (dirty_keys_.empty() || commit_timer_.IsRunning())
+    return;
+  commit_timer_.Start(FROM_HERE,
+                      base::TimeDelta::FromMilliseconds(kCommitDelayMs),
+                      base::Bind(base::IgnoreResult(&AppWidgetStorage::Commit),
+                                 base::Unretained(this)));
+}
+
+bool AppWidgetStorage::Commit() {
+  if (dirty_keys_.empty())
+    return true;
+
+  sql::Transaction transaction(sqlite_db_.get());
+  if (!transaction.Begin())
+    return false;
+
+  for (std::set<std::string>::const_iterator it = dirty_keys_.begin();
+       it != dirty_keys_.end(); ++it) {
+    EntryMap::const_iterator entry = entries_.find(*it);
+    sql::Statement stmt;
+    if (entry != entries_.end()) {
+      stmt.Assign(sqlite_db_->GetCachedStatement(
+          SQL_FROM_HERE, kSetItemWithBindOp));
+      stmt.BindString(0, *it);
+      stmt.BindString(1, entry->second.value);
+      stmt.BindBool(2, entry->second.read_only);
+    } else {
+      stmt.Assign(sqlite_db_->GetCachedStatement(
+          SQL_FROM_HERE, kRemoveItemWithBindOp));
+      stmt.BindString(0, *it);
+    }
+    if (!stmt.Run()) {
+      LOG(ERROR) << "An error occured when writing item " << *it
+                 << " into DB.";
+      return false;
+    }
+  }
+  dirty_keys_.clear();
+
+  return transaction.Commit();
+}
+
 }  // namespace application
 }  // namespace xwalk
@@ -6,16 +6,23 @@
 #define XWALK_APPLICATION_EXTENSION_APPLICATION_WIDGET_STORAGE_H_
 
 #include <map>
+#include <set>
 #include <string>
 
 #include "base/values.h"
 #include "base/files/file_path.h"
+#include "base/timer/timer.h"
 #include "sql/connection.h"
 #include "xwalk/application/browser/application.h"
 
 namespace xwalk {
 namespace application {
 
+// The widget.preferences of an application. The whole table is loaded at
+// Init() and the entries are served from memory. The changes are written
+// back in one transaction a little later, so a script setting many items in
+// a row doesn't wait for the disk on each of them, and the last ones are
+// written when the storage is destroyed.
 class AppWidgetStorage {
  public:
   AppWidgetStorage(Application* application,
@@ -33,16 +40,34 @@ class AppWidgetStorage {
   bool EntryExists(const std::string& key) const;
 
  private:
+  struct Entry {
+    Entry() : read_only(false) {}
+    Entry(const std::string& value, bool read_only)
+        : value(value), read_only(read_only) {}
+
+    std::string value;
+    bool read_only;
+  };
+  typedef std::map<std::string, Entry> EntryMap;
+
   bool Init();
-  bool IsReadOnly(const std::string& key);
+  bool IsReadOnly(const std::string& key) const;
   bool InitStorageTable();
+  bool LoadEntries();
   bool SaveConfigInfoInDB();
   bool SaveConfigInfoItem(base::DictionaryValue* dict);
+  void ScheduleCommit();
+  // Writes the entries of |dirty_keys_|, or deletes them when they are no
+  // longer in |entries_|.
+  bool Commit();
 
   Application* application_;
   scoped_ptr<sql::Connection> sqlite_db_;
   base::FilePath data_path_;
   bool db_initialized_;
+  EntryMap entries_;
+  std::set<std::string> dirty_keys_;
+  base::OneShotTimer<AppWidgetStorage> commit_timer_;
 };
 
 }  // namespace application
@@ -0,0 +1,75 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/test/test_utils.h"
+#include "xwalk/application/browser/application.h"
+#include "xwalk/application/browser/application_process_manager.h"
+#include "xwalk/application/browser/application_service.h"
+#include "xwalk/application/test/application_browsertest.h"
+#include "xwalk/application/test/application_testapi.h"
+#include "xwalk/runtime/browser/runtime.h"
+#include "xwalk/test/base/xwalk_test_utils.h"
+
+using xwalk::application::Application;
+using xwalk::application::ApplicationProcessManager;
+using xwalk::application::ApplicationService;
+using xwalk::application::ApplicationSession;
+
+class ApplicationSessionTest : public ApplicationBrowserTest {
+};
+
+// The navigation history saved when an application is evicted is restored
+// by its next launch, instead of loading the start page.
+IN_PROC_BROWSER_TEST_F(ApplicationSessionTest, RestoresSavedSession) {
+  ApplicationService* service = application_sevice();
+  const base::FilePath app_path =
+      test_data_dir_.Append(FILE_PATH_LITERAL("dummy_app1"));
+  Application* app = service->Launch(app_path);
+  ASSERT_TRUE(app);
+  test_runner_->WaitForTestNotification();
+  EXPECT_EQ(test_runner_->GetTestsResult(), ApiTestRunner::PASS);
+  ASSERT_EQ(1u, app->runtimes().size());
+
+  xwalk::Runtime* runtime = *app->runtimes().begin();
+  GURL::Replacements replacements;
+  const std::string ref = "second";
+  replacements.SetRefStr(ref);
+  const GURL second_url =
+      runtime->web_contents()->GetURL().ReplaceComponents(replacements);
+  xwalk_test_utils::NavigateToURL(runtime, second_url);
+
+  scoped_ptr<ApplicationSession> session = app->SaveSession();
+  ASSERT_TRUE(session);
+  EXPECT_EQ(2u, session->entries.size());
+  EXPECT_EQ(1, session->selected_entry);
+
+  const std::string app_id = app->id();
+  ApplicationProcessManager* process_manager = service->process_manager();
+  process_manager->SaveSession(app_id, session.Pass());
+  app->Terminate();
+  content::RunAllPendingInMessageLoop();
+  ASSERT_FALSE(service->GetApplicationByID(app_id));
+
+  app = service->Launch(app_path);
+  ASSERT_TRUE(app);
+  test_runner_->PostResultToNotificationCallback();
+  test_runner_->WaitForTestNotification();
+  EXPECT_EQ(test_runner_->GetTestsResult(), ApiTestRunner::PASS);
+
+  // The session is only restored once.
+  EXPECT_FALSE(process_manager->TakeSavedSession(app_id));
+
+  ASSERT_EQ(1u, app->runtimes().size());
+  const content::NavigationController& controller =
+      (*app->runtimes().begin())->web_contents()->GetController();
+  EXPECT_EQ(2, controller.GetEntryCount());
+  EXPECT_EQ(1, controller.GetLastCommittedEntryIndex());
+  EXPECT_EQ(second_url, controller.GetLastCommittedEntry()->GetURL());
+
+  app->Terminate();
+  content::RunAllPendingInMessageLoop();
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/public/browser/render_process_host.h"
+#include "content/public/test/test_utils.h"
+#include "xwalk/application/browser/application.h"
+#include "xwalk/application/browser/application_service.h"
+#include "xwalk/application/test/application_browsertest.h"
+#include "xwalk/application/test/application_testapi.h"
+
+using xwalk::application::Application;
+using xwalk::application::ApplicationService;
+
+namespace {
+
+size_t GetRenderProcessHostCount() {
+  size_t count = 0;
+  for (content::RenderProcessHost::iterator it =
+           content::RenderProcessHost::AllHostsIterator();
+       !it.IsAtEnd(); it.Advance())
+    ++count;
+  return count;
+}
+
+}  // namespace
+
+class ApplicationSpareProcessTest : public ApplicationBrowserTest {
+};
+
+// The render process started while the application data is loaded is the
+// one the application runs in.
+IN_PROC_BROWSER_TEST_F(ApplicationSpareProcessTest, UsesSpareProcess) {
+  ApplicationService* service = application_sevice();
+  const size_t host_count = GetRenderProcessHostCount();
+
+  Application* app = service->Launch(
+      test_data_dir_.Append(FILE_PATH_LITERAL("dummy_app1")));
+  ASSERT_TRUE(app);
+  test_runner_->WaitForTestNotification();
+  EXPECT_EQ(test_runner_->GetTestsResult(), ApiTestRunner::PASS);
+
+  content::RunAllPendingInMessageLoop();
+  EXPECT_EQ(host_count + 1, GetRenderProcessHostCount());
+  EXPECT_EQ(app->id(),
+            service->GetApplicationIDByRenderHostID(
+                app->GetRenderProcessHostID()));
+
+  app->Terminate();
+  content::RunAllPendingInMessageLoop();
+}
+
+// The spare render process doesn't outlive a failed launch.
+IN_PROC_BROWSER_TEST_F(ApplicationSpareProcessTest, DiscardsSpareProcess) {
+  const size_t host_count = GetRenderProcessHostCount();
+
+  EXPECT_FALSE(application_sevice()->Launch(
+      test_data_dir_.Append(FILE_PATH_LITERAL("bad"))));
+
+  content::RunAllPendingInMessageLoop();
+  EXPECT_EQ(host_count, GetRenderProcessHostCount());
+}
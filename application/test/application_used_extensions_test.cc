@@ -0,0 +1,33 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/application/test/application_browsertest.h"
+#include "xwalk/application/test/application_testapi.h"
+
+using xwalk::application::Application;
+
+class ApplicationUsedExtensionsTest : public ApplicationBrowserTest {
+};
+
+IN_PROC_BROWSER_TEST_F(ApplicationUsedExtensionsTest, ListedInPermissions) {
+  Application* app = application_sevice()->Launch(
+      test_data_dir_.Append(FILE_PATH_LITERAL("used_extensions")));
+  ASSERT_TRUE(app);
+  EXPECT_TRUE(app->UseExtension("xwalk.experimental.native_file_system"));
+  EXPECT_FALSE(app->UseExtension("xwalk.experimental.raw_socket"));
+  EXPECT_TRUE(app->UseExtension("xwalk.app.test"));
+
+  test_runner_->WaitForTestNotification();
+  EXPECT_EQ(test_runner_->GetTestsResult(), ApiTestRunner::PASS);
+}
+
+IN_PROC_BROWSER_TEST_F(ApplicationUsedExtensionsTest, NoPermissions) {
+  Application* app = application_sevice()->Launch(
+      test_data_dir_.Append(FILE_PATH_LITERAL("all_extensions")));
+  ASSERT_TRUE(app);
+  EXPECT_TRUE(app->UseExtension("xwalk.experimental.raw_socket"));
+
+  test_runner_->WaitForTestNotification();
+  EXPECT_EQ(test_runner_->GetTestsResult(), ApiTestRunner::PASS);
+}
@@ -3,7 +3,10 @@
 // found in the LICENSE file.
 
 #include "base/at_exit.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
 #include "base/message_loop/message_loop.h"
+#include "base/strings/utf_string_conversions.h"
 #include "xwalk/application/tools/linux/xwalk_extension_process_launcher.h"
 #include "xwalk/extensions/extension_process/xwalk_extension_process.h"
 
@@ -22,6 +25,15 @@ XWalkExtensionProcessLauncher::~XWalkExtensionProcessLauncher() {
 
 void XWalkExtensionProcessLauncher::CleanUp() {
   extension_process_.reset();
+  preloaded_libraries_.clear();
+}
+
+void XWalkExtensionProcessLauncher::PreloadExtensions(
+    const base::FilePath& path) {
+  message_loop()->PostTask(
+      FROM_HERE,
+      base::Bind(&XWalkExtensionProcessLauncher::LoadExtensionLibraries,
+                 base::Unretained(this), path));
 }
 
 void XWalkExtensionProcessLauncher::Launch(
@@ -38,3 +50,17 @@ void XWalkExtensionProcessLauncher::StartExtensionProcess(
   extension_process_.reset(new xwalk::extensions::XWalkExtensionProcess(
       IPC::ChannelHandle(channel_id, base::FileDescriptor(channel_fd, true))));
 }
+
+void XWalkExtensionProcessLauncher::LoadExtensionLibraries(
+    const base::FilePath& path) {
+  base::FileEnumerator libraries(
+      path, false, base::FileEnumerator::FILES,
+      base::UTF16ToUTF8(base::GetNativeLibraryName(base::UTF8ToUTF16("*"))));
+  for (base::FilePath library_path = libraries.Next();
+       !library_path.empty(); library_path = libraries.Next()) {
+    scoped_ptr<base::ScopedNativeLibrary> library(
+        new base::ScopedNativeLibrary(library_path));
+    if (library->is_valid())
+      preloaded_libraries_.push_back(library.release());
+  }
+}
@@ -7,10 +7,13 @@
 
 #include <string>
 
+#include "base/memory/scoped_vector.h"
+#include "base/scoped_native_library.h"
 #include "base/threading/thread.h"
 
 namespace base {
 class AtExitManager;
+class FilePath;
 }
 
 namespace xwalk {
@@ -27,15 +30,25 @@ class XWalkExtensionProcessLauncher: public base::Thread {
   // Implement base::Thread.
   virtual void CleanUp() OVERRIDE;
 
+  // Loads the external extension libraries found in |path| while the
+  // runtime is still launching the application, so the Extension Process
+  // finds them already mapped. Will be called in launcher's main thread,
+  // before Launch().
+  void PreloadExtensions(const base::FilePath& path);
+
   // Will be called in launcher's main thread.
   void Launch(const std::string& channel_id, int channel_fd);
 
   bool is_started() const { return is_started_; }
 
  private:
+  void LoadExtensionLibraries(const base::FilePath& path);
   void StartExtensionProcess(const std::string& channel_id, int channel_fd);
 
   bool is_started_;
+  // Keeps the preloaded libraries mapped until the Extension Process, which
+  // loads them again, goes away.
+  ScopedVector<base::ScopedNativeLibrary> preloaded_libraries_;
   scoped_ptr<base::AtExitManager> exit_manager_;
   scoped_ptr<xwalk::extensions::XWalkExtensionProcess> extension_process_;
 };
@@ -18,6 +18,8 @@
 #include "xwalk/application/tools/linux/dbus_connection.h"
 #include "xwalk/application/tools/linux/xwalk_extension_process_launcher.h"
 #if defined(OS_TIZEN)
+#include "base/files/file_path.h"
+#include "build/build_config.h"
 #include "url/gurl.h"
 #include "xwalk/application/tools/linux/xwalk_launcher_tizen.h"
 #include "xwalk/application/tools/linux/xwalk_tizen_user.h"
@@ -29,6 +31,17 @@ static const char* xwalk_running_manager_iface =
     "org.crosswalkproject.Running.Manager1";
 static const char* xwalk_running_app_iface =
     "org.crosswalkproject.Running.Application1";
+#if defined(OS_TIZEN)
+// Same as the runtime default, see
+// XWalkBrowserMainParts::RegisterExternalExtensions().
+#if defined(ARCH_CPU_64_BITS)
+static const char* xwalk_tizen_extensions_path =
+    "/usr/lib64/tizen-extensions-crosswalk";
+#else
+static const char* xwalk_tizen_extensions_path =
+    "/usr/lib/tizen-extensions-crosswalk";
+#endif
+#endif
 
 static char* application_object_path;
 
@@ -36,6 +49,8 @@ static GMainLoop* mainloop;
 static GDBusConnection* g_connection;
 static GDBusObjectManager* g_running_apps_manager;
 static XWalkExtensionProcessLauncher* ep_launcher = NULL;
+static gboolean ep_channel_call_pending = FALSE;
+static gboolean ep_channel_call_again = FALSE;
 
 static int g_argc;
 static char** g_argv;
@@ -96,30 +111,60 @@ static void on_app_properties_changed(GDBusProxy* proxy,
   }
 }
 
-static gboolean init_extension_process_channel(GDBusProxy* app_proxy) {
-  if (ep_launcher->is_started())
-    return FALSE;
+static void request_extension_process_channel(GDBusProxy* app_proxy);
+
+static void on_extension_process_channel(GObject* source, GAsyncResult* res,
+                                         gpointer user_data) {
+  GDBusProxy* app_proxy = G_DBUS_PROXY(source);
+  ep_channel_call_pending = FALSE;
 
   // Get the client socket file descriptor from fd_list. The reply will
   // contains an index to the list.
-  GUnixFDList* fd_list;
-  GVariant* res = g_dbus_proxy_call_with_unix_fd_list_sync(
-      app_proxy, "GetEPChannel", NULL, G_DBUS_CALL_FLAGS_NONE,
-      -1, NULL, &fd_list, NULL, NULL);
-  if (!res || g_variant_n_children(res) != 2)
-    return FALSE;
+  GUnixFDList* fd_list = NULL;
+  GVariant* res_variant = g_dbus_proxy_call_with_unix_fd_list_finish(
+      app_proxy, &fd_list, res, NULL);
+  if (!res_variant || g_variant_n_children(res_variant) != 2) {
+    // The channel was not created yet, or it was signaled while this call
+    // was in flight.
+    if (res_variant)
+      g_variant_unref(res_variant);
+    if (fd_list)
+      g_object_unref(fd_list);
+    if (ep_channel_call_again) {
+      ep_channel_call_again = FALSE;
+      request_extension_process_channel(app_proxy);
+    }
+    return;
+  }
 
-  const gchar* channel_id =
-      g_variant_get_string(g_variant_get_child_value(res, 0), NULL);
-  if (!channel_id || !strlen(channel_id))
-    return FALSE;
+  const gchar* channel_id = NULL;
+  gint32 client_fd_idx;
+  g_variant_get(res_variant, "(&sh)", &channel_id, &client_fd_idx);
+  if (channel_id && strlen(channel_id)) {
+    int client_fd = g_unix_fd_list_get(fd_list, client_fd_idx, NULL);
+    ep_launcher->Launch(channel_id, client_fd);
+  }
 
-  gint32 client_fd_idx =
-      g_variant_get_handle(g_variant_get_child_value(res, 1));
-  int client_fd = g_unix_fd_list_get(fd_list, client_fd_idx, NULL);
+  g_variant_unref(res_variant);
+  g_object_unref(fd_list);
+}
 
-  ep_launcher->Launch(channel_id, client_fd);
-  return TRUE;
+// Asks for the Extension Process channel without blocking the main loop, the
+// Extension Process is started as soon as the reply brings it. The runtime
+// hands the channel out only once, so there is one call in flight at most.
+static void request_extension_process_channel(GDBusProxy* app_proxy) {
+  if (ep_launcher->is_started())
+    return;
+
+  if (ep_channel_call_pending) {
+    ep_channel_call_again = TRUE;
+    return;
+  }
+
+  ep_channel_call_pending = TRUE;
+  g_dbus_proxy_call_with_unix_fd_list(
+      app_proxy, "GetEPChannel", NULL, G_DBUS_CALL_FLAGS_NONE,
+      -1, NULL, NULL, on_extension_process_channel, NULL);
 }
 
 static void on_app_signal(GDBusProxy* proxy,
@@ -128,7 +173,7 @@ static void on_app_signal(GDBusProxy* proxy,
                           GVariant* parameters,
                           gpointer user_data) {
   if (!strcmp(signal_name, "EPChannelCreated")) {
-    init_extension_process_channel(proxy);
+    request_extension_process_channel(proxy);
   } else {
     fprintf(stderr, "Unkown signal received: %s\n", signal_name);
   }
@@ -171,66 +216,95 @@ static int query_application_running(const char* app_id) {
   return is_running ? 0 : 1;
 }
 
-static void launch_application(const char* appid_or_url,
-                               gboolean fullscreen) {
-  ep_launcher = new XWalkExtensionProcessLauncher();
+static void on_app_proxy_created(GObject* source, GAsyncResult* res,
+                                 gpointer user_data) {
   GError* error = NULL;
-  g_signal_connect(g_running_apps_manager, "object-removed",
-                   G_CALLBACK(object_removed), NULL);
-
-  GDBusProxy* running_proxy = g_dbus_proxy_new_sync(
-      g_connection,
-      G_DBUS_PROXY_FLAGS_NONE, NULL, xwalk_service_name,
-      xwalk_running_path, xwalk_running_manager_iface, NULL, &error);
-  if (!running_proxy) {
-    g_print("Couldn't create proxy for '%s': %s\n", xwalk_running_manager_iface,
+  GDBusProxy* app_proxy = g_dbus_proxy_new_finish(res, &error);
+  if (!app_proxy) {
+    g_print("Couldn't create proxy for '%s': %s\n", xwalk_running_app_iface,
             error->message);
     g_error_free(error);
     exit(1);
   }
 
-  unsigned int launcher_pid = getpid();
+  g_signal_connect(app_proxy, "g-properties-changed",
+                   G_CALLBACK(on_app_properties_changed), NULL);
+  g_signal_connect(app_proxy, "g-signal", G_CALLBACK(on_app_signal), NULL);
 
-  GVariant* result  = g_dbus_proxy_call_sync(running_proxy, "Launch",
-      g_variant_new("(sub)", appid_or_url, launcher_pid, fullscreen),
-      G_DBUS_CALL_FLAGS_NONE, -1, NULL, &error);
+#if defined(OS_TIZEN)
+  const char* appid_or_url = reinterpret_cast<const char*>(user_data);
+  char name[128];
+  snprintf(name, sizeof(name), "xwalk-%s", appid_or_url);
+
+  if (xwalk_appcore_init(g_argc, g_argv, name, app_proxy)) {
+    fprintf(stderr, "Failed to initialize appcore");
+    exit(1);
+  }
+#endif
+
+  // The channel may have been signaled before the proxy was listening.
+  request_extension_process_channel(app_proxy);
+}
+
+static void on_application_launched(GObject* source, GAsyncResult* res,
+                                    gpointer user_data) {
+  GError* error = NULL;
+  GVariant* result = g_dbus_proxy_call_finish(G_DBUS_PROXY(source), res,
+                                              &error);
   if (!result) {
     fprintf(stderr, "Couldn't call 'Launch' method: %s\n", error->message);
     exit(1);
   }
 
   g_variant_get(result, "(o)", &application_object_path);
+  g_variant_unref(result);
   fprintf(stderr, "Application launched with path '%s'\n",
           application_object_path);
 
-  GDBusProxy* app_proxy = g_dbus_proxy_new_sync(
+  // The properties are only followed through their change signals, so they
+  // are not loaded.
+  g_dbus_proxy_new(
       g_connection,
-      G_DBUS_PROXY_FLAGS_NONE, NULL, xwalk_service_name,
-      application_object_path, xwalk_running_app_iface, NULL, &error);
-  if (!app_proxy) {
-    g_print("Couldn't create proxy for '%s': %s\n", xwalk_running_app_iface,
+      G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES, NULL, xwalk_service_name,
+      application_object_path, xwalk_running_app_iface, NULL,
+      on_app_proxy_created, user_data);
+}
+
+// Every call to the runtime is asynchronous, so the launcher keeps handling
+// the signals of the application while the next reply is on its way.
+static void launch_application(const char* appid_or_url,
+                               gboolean fullscreen) {
+  ep_launcher = new XWalkExtensionProcessLauncher();
+#if defined(OS_TIZEN)
+  // Overlaps loading the device APIs with the start of the render process.
+  ep_launcher->PreloadExtensions(base::FilePath(xwalk_tizen_extensions_path));
+#endif
+  GError* error = NULL;
+  g_signal_connect(g_running_apps_manager, "object-removed",
+                   G_CALLBACK(object_removed), NULL);
+
+  // The manager has neither properties nor signals, its proxy costs no round
+  // trip to the runtime.
+  GDBusProxy* running_proxy = g_dbus_proxy_new_sync(
+      g_connection,
+      static_cast<GDBusProxyFlags>(G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES |
+                                   G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS),
+      NULL, xwalk_service_name, xwalk_running_path,
+      xwalk_running_manager_iface, NULL, &error);
+  if (!running_proxy) {
+    g_print("Couldn't create proxy for '%s': %s\n", xwalk_running_manager_iface,
             error->message);
     g_error_free(error);
     exit(1);
   }
 
-  g_signal_connect(app_proxy, "g-properties-changed",
-                   G_CALLBACK(on_app_properties_changed), NULL);
+  unsigned int launcher_pid = getpid();
 
   mainloop = g_main_loop_new(NULL, FALSE);
-  g_signal_connect(app_proxy, "g-signal", G_CALLBACK(on_app_signal), NULL);
-
-#if defined(OS_TIZEN)
-  char name[128];
-  snprintf(name, sizeof(name), "xwalk-%s", appid_or_url);
-
-  if (xwalk_appcore_init(g_argc, g_argv, name, app_proxy)) {
-    fprintf(stderr, "Failed to initialize appcore");
-    exit(1);
-  }
-#endif
-
-  init_extension_process_channel(app_proxy);
+  g_dbus_proxy_call(running_proxy, "Launch",
+      g_variant_new("(sub)", appid_or_url, launcher_pid, fullscreen),
+      G_DBUS_CALL_FLAGS_NONE, -1, NULL, on_application_launched,
+      const_cast<char*>(appid_or_url));
   g_main_loop_run(mainloop);
 }
 
@@ -10,9 +10,16 @@
 #include <gio/gio.h>
 #include <locale.h>
 
+#include <string>
+#include <vector>
+
 #include "base/at_exit.h"
+#include "base/file_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/time/time.h"
 
 #include "dbus/bus.h"
 #include "dbus/message.h"
@@ -31,14 +38,30 @@ using xwalk::application::ApplicationData;
 using xwalk::application::ApplicationStorage;
 using xwalk::application::PackageInstaller;
 
-static char* install_path;
-static char* uninstall_appid;
+static char** install_paths;
+static char* install_list;
+static char** uninstall_appids;
+static gboolean keep_packed;
 
 static GOptionEntry entries[] = {
-  { "install", 'i', 0, G_OPTION_ARG_STRING, &install_path,
+  // Can be repeated, the applications are then installed by the same
+  // process, which is faster than running xwalkctl for each of them.
+  { "install", 'i', 0, G_OPTION_ARG_FILENAME_ARRAY, &install_paths,
     "Path of the application to be installed/updated", "PATH" },
-  { "uninstall", 'u', 0, G_OPTION_ARG_STRING, &uninstall_appid,
+  // For provisioning devices with many applications.
+  { "install-list", 'l', 0, G_OPTION_ARG_FILENAME, &install_list,
+    "File listing the paths of the applications to be installed/updated, "
+    "one per line", "FILE" },
+  // Can be repeated as well, the running applications are then terminated
+  // through the same D-Bus connection.
+  { "uninstall", 'u', 0, G_OPTION_ARG_STRING_ARRAY, &uninstall_appids,
     "Uninstall the application with this appid", "APPID" },
+#if !defined(OS_TIZEN)
+  // Tizen reads the splash screens and icons from the application directory.
+  { "packed", 'p', 0, G_OPTION_ARG_NONE, &keep_packed,
+    "Serve the installed application from its package, without extracting "
+    "its resources", NULL },
+#endif
   { NULL }
 };
 
@@ -52,13 +75,17 @@ const dbus::ObjectPath kRunningManagerDBusPath("/running1");
 
 }  // namespace
 
-static void TerminateIfRunning(const std::string& app_id) {
+static scoped_refptr<dbus::Bus> CreateBus() {
   dbus::Bus::Options options;
 #if defined(OS_TIZEN_MOBILE)
   options.bus_type = dbus::Bus::CUSTOM_ADDRESS;
   options.address.assign("unix:path=/run/user/app/dbus/user_bus_socket");
 #endif
-  scoped_refptr<dbus::Bus> bus(new dbus::Bus(options));
+  return new dbus::Bus(options);
+}
+
+static void TerminateIfRunning(const scoped_refptr<dbus::Bus>& bus,
+                               const std::string& app_id) {
   dbus::ObjectProxy* app_proxy =
       bus->GetObjectProxy(xwalk_service_name, kRunningManagerDBusPath);
   if (!app_proxy)
@@ -73,16 +100,72 @@ static void TerminateIfRunning(const std::string& app_id) {
 }
 #endif
 
+// Reads the paths listed in |list_path|, skipping the empty lines and the
+// comments, starting with '#'.
+static bool ReadInstallList(const base::FilePath& list_path,
+                            std::vector<base::FilePath>* paths) {
+  std::string content;
+  if (!base::ReadFileToString(list_path, &content)) {
+    g_print("Failed to read %s\n", list_path.value().c_str());
+    return false;
+  }
+  std::vector<std::string> lines;
+  base::SplitString(content, '\n', &lines);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    std::string line;
+    base::TrimWhitespaceASCII(lines[i], base::TRIM_ALL, &line);
+    if (!line.empty() && line[0] != '#')
+      paths->push_back(base::FilePath(line));
+  }
+  return true;
+}
+
+// Installs or updates each of |paths|, printing the status and the time it
+// took for each one. Returns false if any failed, the next ones are still
+// installed.
+static bool InstallApplications(const std::vector<base::FilePath>& paths,
+                                ApplicationStorage* storage,
+                                PackageInstaller* installer) {
+  size_t failures = 0;
+  base::TimeTicks batch_start = base::TimeTicks::Now();
+  for (size_t i = 0; i < paths.size(); ++i) {
+    base::TimeTicks start = base::TimeTicks::Now();
+    std::string app_id;
+    bool installed = installer->Install(paths[i], &app_id);
+    if (!installed && storage->Contains(app_id)) {
+      g_print("trying to update %s\n", app_id.c_str());
+      installed = installer->Update(app_id, paths[i]);
+    }
+    if (!installed)
+      ++failures;
+    if (paths.size() > 1) {
+      g_print("%s %s %s (%" G_GINT64_FORMAT " ms)\n",
+              installed ? "OK" : "FAILED", app_id.c_str(),
+              paths[i].value().c_str(),
+              (base::TimeTicks::Now() - start).InMilliseconds());
+    }
+  }
+  if (paths.size() > 1) {
+    g_print("%" G_GSIZE_FORMAT " installed, %" G_GSIZE_FORMAT " failed in %"
+            G_GINT64_FORMAT " ms\n",
+            paths.size() - failures, failures,
+            (base::TimeTicks::Now() - batch_start).InMilliseconds());
+  }
+  return failures == 0;
+}
+
 bool list_applications(ApplicationStorage* storage) {
   std::vector<std::string> app_ids;
   if (!storage->GetInstalledApplicationIDs(app_ids))
     return false;
 
+  ApplicationData::ApplicationDataMap applications;
+  storage->GetApplicationsData(app_ids, applications);
+
   g_print("Application ID                       Application Name\n");
   g_print("-----------------------------------------------------\n");
   for (unsigned i = 0; i < app_ids.size(); ++i) {
-    scoped_refptr<ApplicationData> app_data =
-        storage->GetApplicationData(app_ids.at(i));
+    scoped_refptr<ApplicationData> app_data = applications[app_ids.at(i)];
     if (!app_data) {
       g_print("Failed to obtain app data for xwalk id: %s\n",
               app_ids.at(i).c_str());
@@ -122,23 +205,42 @@ int main(int argc, char* argv[]) {
   base::FilePath data_path;
   xwalk::RegisterPathProvider();
   PathService::Get(xwalk::DIR_DATA_PATH, &data_path);
-  scoped_ptr<ApplicationStorage> storage(new ApplicationStorage(data_path));
+  // Listing only reads the database, it doesn't need to create or migrate it.
+  ApplicationStorage::OpenMode mode =
+      (install_paths || install_list || uninstall_appids) ?
+      ApplicationStorage::READ_WRITE : ApplicationStorage::READ_ONLY;
+  scoped_ptr<ApplicationStorage> storage(
+      new ApplicationStorage(data_path, mode));
   scoped_ptr<PackageInstaller> installer =
       PackageInstaller::Create(storage.get());
-
-  if (install_path) {
-    std::string app_id;
-    const base::FilePath& path = base::FilePath(install_path);
-    success = installer->Install(path, &app_id);
-    if (!success && storage->Contains(app_id)) {
-      g_print("trying to update %s\n", app_id.c_str());
-      success = installer->Update(app_id, path);
+  installer->set_keep_packed(keep_packed);
+
+  if (install_paths || install_list) {
+    std::vector<base::FilePath> paths;
+    success = true;
+    if (install_paths) {
+      for (char** install_path = install_paths; *install_path; ++install_path)
+        paths.push_back(base::FilePath(*install_path));
+      g_strfreev(install_paths);
+    }
+    if (install_list) {
+      success = ReadInstallList(base::FilePath(install_list), &paths);
+      g_free(install_list);
     }
-  } else if (uninstall_appid) {
+    success = InstallApplications(paths, storage.get(), installer.get()) &&
+        success;
+  } else if (uninstall_appids) {
 #if defined(SHARED_PROCESS_MODE)
-    TerminateIfRunning(uninstall_appid);
+    scoped_refptr<dbus::Bus> bus = CreateBus();
 #endif
-    success = installer->Uninstall(uninstall_appid);
+    success = true;
+    for (char** app_id = uninstall_appids; *app_id; ++app_id) {
+#if defined(SHARED_PROCESS_MODE)
+      TerminateIfRunning(bus, *app_id);
+#endif
+      success = installer->Uninstall(*app_id) && success;
+    }
+    g_strfreev(uninstall_appids);
   } else {
     success = list_applications(storage.get());
   }
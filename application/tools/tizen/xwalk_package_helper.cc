@@ -8,50 +8,127 @@
 // be called by Crosswalk (now running as a normal user) so all the activities
 // that required 'root' access are done by a small code base.
 
+#include <string>
+#include <vector>
+
 #include "base/files/file_path.h"
 #include "base/file_util.h"
 #include "xwalk/application/tools/tizen/xwalk_package_installer_helper.h"
 
 namespace {
 
+// Written once the batch mode starts, the commands follow.
+const char kBatchGreeting[] = "xwalk-pkg-helper-batch: 1";
+// Starts the answer to each command of the batch mode.
+const char kBatchResultPrefix[] = "xwalk-pkg-helper-result: ";
+
+// Bounds of the commands of the batch mode, beyond what RunCommand() takes.
+const size_t kMaxBatchArgs = 8;
+const size_t kMaxBatchArgLength = 64 * 1024;
+
 int usage(const char* program) {
   fprintf(stdout, "%s - Crosswalk Tizen Application Installation helper\n\n",
           basename(program));
   fprintf(stdout, "Usage: \n"
           "\t%s --install <appid> <xml> <icon>\n"
-          "\t%s --uninstall <appid>\n",
-          "\t%s --update <appid> <xml> <icon>\n",
-          program, program);
+          "\t%s --uninstall <appid>\n"
+          "\t%s --update <appid> <xml> <icon>\n"
+          "\t%s --batch\n",
+          program, program, program, program);
   return 1;
 }
 
+// Runs one of the commands above, given as its arguments. Returns false if
+// they are invalid, |result| is set otherwise.
+bool RunCommand(const std::vector<std::string>& args, bool* result) {
+  if (args.size() < 2)
+    return false;
+
+  PackageInstallerHelper helper(args[1]);
+  if (args[0] == "--install") {
+    if (args.size() != 4)
+      return false;
+    *result = helper.InstallApplication(args[2], args[3]);
+  } else if (args[0] == "--uninstall") {
+    if (args.size() != 2)
+      return false;
+    *result = helper.UninstallApplication();
+  } else if (args[0] == "--update") {
+    if (args.size() != 4)
+      return false;
+    *result = helper.UpdateApplication(args[2], args[3]);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Reads the decimal number ended by |terminator| from the standard input.
+// Returns false if there is none or it is over |max|.
+bool ReadNumber(char terminator, size_t max, size_t* number) {
+  *number = 0;
+  int digits = 0;
+  int c;
+  while ((c = getc(stdin)) != EOF && c != terminator) {
+    if (c < '0' || c > '9' || ++digits > 9)
+      return false;
+    *number = *number * 10 + (c - '0');
+  }
+  return c == terminator && digits > 0 && *number <= max;
+}
+
+// Reads a command of the batch mode: its number of arguments followed by a
+// new line, then each argument as its length followed by a colon, and its
+// bytes. Nothing in the arguments is taken as a separator.
+bool ReadCommand(std::vector<std::string>* args) {
+  size_t count;
+  if (!ReadNumber('\n', kMaxBatchArgs, &count))
+    return false;
+  args->resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    size_t length;
+    if (!ReadNumber(':', kMaxBatchArgLength, &length))
+      return false;
+    std::string& arg = (*args)[i];
+    arg.resize(length);
+    if (length && fread(&arg[0], 1, length, stdin) != length)
+      return false;
+  }
+  return true;
+}
+
+// Greets with |kBatchGreeting| and runs the commands read from the standard
+// input until it is closed. Each of them is answered with a line made of
+// |kBatchResultPrefix| and 0 on success, 1 otherwise. This lets an installer
+// of many applications spawn the helper only once. A malformed command ends
+// the batch, the input isn't in sync with the commands anymore.
+int RunBatch() {
+  fprintf(stdout, "%s\n", kBatchGreeting);
+  fflush(stdout);
+
+  std::vector<std::string> args;
+  while (ReadCommand(&args)) {
+    bool result = false;
+    if (!RunCommand(args, &result))
+      fprintf(stdout, "Invalid command\n");
+    fprintf(stdout, "%s%d\n", kBatchResultPrefix, result ? 0 : 1);
+    fflush(stdout);
+  }
+  return feof(stdin) ? 0 : 1;
+}
+
 }  // namespace
 
 int main(int argc, char *argv[]) {
-  bool result = false;
+  if (argc == 2 && !strcmp(argv[1], "--batch"))
+    return RunBatch();
 
   if (argc <= 2)
     return usage(argv[0]);
 
-  PackageInstallerHelper helper(argv[2]);
-  if (!strcmp(argv[1], "--install")) {
-    if (argc != 5)
-      return usage(argv[0]);
-
-    result = helper.InstallApplication(argv[3], argv[4]);
-  } else if (!strcmp(argv[1], "--uninstall")) {
-    if (argc != 3)
-      return usage(argv[0]);
-
-    result = helper.UninstallApplication();
-  } else if (!strcmp(argv[1], "--update")) {
-    if (argc != 5)
-      return usage(argv[0]);
-
-    result = helper.UpdateApplication(argv[3], argv[4]);
-  } else {
+  bool result = false;
+  if (!RunCommand(std::vector<std::string>(argv + 1, argv + argc), &result))
     return usage(argv[0]);
-  }
 
   // Convetion is to return 0 on success.
   return result ? 0 : 1;
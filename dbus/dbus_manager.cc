@@ -8,12 +8,15 @@
 #include "base/bind.h"
 #include "base/threading/thread.h"
 #include "dbus/bus.h"
+#include "xwalk/dbus/method_dispatcher.h"
 
 namespace xwalk {
 
 DBusManager::DBusManager() {}
 
 DBusManager::~DBusManager() {
+  // Joins its dedicated threads while their responses can still be sent.
+  method_dispatcher_.reset();
   if (session_bus_.get())
     session_bus_->ShutdownOnDBusThreadAndBlock();
 }
@@ -34,4 +37,10 @@ scoped_refptr<dbus::Bus> DBusManager::session_bus() {
   return session_bus_;
 }
 
+MethodDispatcher* DBusManager::method_dispatcher() {
+  if (!method_dispatcher_)
+    method_dispatcher_.reset(new MethodDispatcher);
+  return method_dispatcher_.get();
+}
+
 }  // namespace xwalk
@@ -20,6 +20,8 @@ class Bus;
 
 namespace xwalk {
 
+class MethodDispatcher;
+
 // Holds a DBus thread and a session bus connection, that should be shared by
 // all users of DBus inside Crosswalk.
 class DBusManager {
@@ -29,11 +31,16 @@ class DBusManager {
 
   scoped_refptr<dbus::Bus> session_bus();
 
+  // Dispatches the methods exported on the session bus by the policies of
+  // their interfaces, see MethodDispatcher.
+  MethodDispatcher* method_dispatcher();
+
  private:
   void OnNameOwned(const std::string& service_name, bool success);
 
   scoped_ptr<base::Thread> dbus_thread_;
   scoped_refptr<dbus::Bus> session_bus_;
+  scoped_ptr<MethodDispatcher> method_dispatcher_;
 };
 
 }  // namespace xwalk
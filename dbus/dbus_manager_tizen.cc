@@ -9,12 +9,15 @@
 #include "base/strings/stringprintf.h"
 #include "base/threading/thread.h"
 #include "dbus/bus.h"
+#include "xwalk/dbus/method_dispatcher.h"
 
 namespace xwalk {
 
 DBusManager::DBusManager() {}
 
 DBusManager::~DBusManager() {
+  // Joins its dedicated threads while their responses can still be sent.
+  method_dispatcher_.reset();
   if (session_bus_)
     session_bus_->ShutdownOnDBusThreadAndBlock();
 }
@@ -36,4 +39,10 @@ scoped_refptr<dbus::Bus> DBusManager::session_bus() {
   return session_bus_;
 }
 
+MethodDispatcher* DBusManager::method_dispatcher() {
+  if (!method_dispatcher_)
+    method_dispatcher_.reset(new MethodDispatcher);
+  return method_dispatcher_.get();
+}
+
 }  // namespace xwalk
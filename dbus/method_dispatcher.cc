@@ -0,0 +1,137 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/dbus/method_dispatcher.h"
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/single_thread_task_runner.h"
+#include "base/threading/thread.h"
+
+namespace {
+
+void PostMethodCall(
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+    const dbus::ExportedObject::MethodCallCallback& callback,
+    dbus::MethodCall* method_call,
+    dbus::ExportedObject::ResponseSender response_sender) {
+  task_runner->PostTask(FROM_HERE,
+                        base::Bind(callback, method_call, response_sender));
+}
+
+}  // namespace
+
+namespace xwalk {
+
+MethodDispatcher::MethodDispatcher()
+    : weak_factory_(this) {
+}
+
+MethodDispatcher::~MethodDispatcher() {
+  // The queued calls are dropped, their clients get an error once they time
+  // out.
+}
+
+void MethodDispatcher::SetPolicy(const std::string& interface_name,
+                                 const std::string& method_name,
+                                 Policy policy) {
+  std::string key = interface_name;
+  if (!method_name.empty())
+    key += "." + method_name;
+  policies_[key] = policy;
+}
+
+MethodDispatcher::Policy MethodDispatcher::GetPolicy(
+    const std::string& interface_name,
+    const std::string& method_name) const {
+  std::map<std::string, Policy>::const_iterator it =
+      policies_.find(interface_name + "." + method_name);
+  if (it != policies_.end())
+    return it->second;
+  it = policies_.find(interface_name);
+  if (it != policies_.end())
+    return it->second;
+  return QUEUED;
+}
+
+void MethodDispatcher::ExportMethod(
+    dbus::ExportedObject* object,
+    const std::string& interface_name,
+    const std::string& method_name,
+    const dbus::ExportedObject::MethodCallCallback& method_call_callback,
+    const dbus::ExportedObject::OnExportedCallback& on_exported_callback) {
+  object->ExportMethod(
+      interface_name, method_name,
+      WrapMethodCallCallback(interface_name, method_name,
+                             method_call_callback),
+      on_exported_callback);
+}
+
+dbus::ExportedObject::MethodCallCallback
+MethodDispatcher::WrapMethodCallCallback(
+    const std::string& interface_name,
+    const std::string& method_name,
+    const dbus::ExportedObject::MethodCallCallback& method_call_callback) {
+  switch (GetPolicy(interface_name, method_name)) {
+    case PRIORITY:
+      return method_call_callback;
+    case QUEUED:
+      return base::Bind(&MethodDispatcher::QueueCall,
+                        weak_factory_.GetWeakPtr(),
+                        method_call_callback);
+    case DEDICATED_THREAD:
+      return base::Bind(&PostMethodCall,
+                        GetDedicatedTaskRunner(interface_name),
+                        method_call_callback);
+  }
+  NOTREACHED();
+  return method_call_callback;
+}
+
+void MethodDispatcher::QueueCall(
+    const dbus::ExportedObject::MethodCallCallback& callback,
+    dbus::MethodCall* method_call,
+    dbus::ExportedObject::ResponseSender response_sender) {
+  QueuedCall call;
+  call.callback = callback;
+  call.method_call = method_call;
+  call.response_sender = response_sender;
+  queued_calls_.push_back(call);
+  if (queued_calls_.size() > 1)
+    return;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&MethodDispatcher::RunNextQueuedCall,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void MethodDispatcher::RunNextQueuedCall() {
+  QueuedCall call = queued_calls_.front();
+  queued_calls_.pop_front();
+  // The priority calls which reached the origin thread while this one was
+  // queued run before the next one.
+  if (!queued_calls_.empty()) {
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&MethodDispatcher::RunNextQueuedCall,
+                   weak_factory_.GetWeakPtr()));
+  }
+  call.callback.Run(call.method_call, call.response_sender);
+}
+
+scoped_refptr<base::SingleThreadTaskRunner>
+MethodDispatcher::GetDedicatedTaskRunner(const std::string& interface_name) {
+  ThreadMap::iterator it = dedicated_threads_by_interface_.find(interface_name);
+  if (it != dedicated_threads_by_interface_.end())
+    return it->second->message_loop_proxy();
+
+  base::Thread* thread =
+      new base::Thread("Crosswalk D-Bus " + interface_name);
+  thread->Start();
+  dedicated_threads_.push_back(thread);
+  dedicated_threads_by_interface_[interface_name] = thread;
+  return thread->message_loop_proxy();
+}
+
+}  // namespace xwalk
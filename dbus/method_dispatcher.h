@@ -0,0 +1,107 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_DBUS_METHOD_DISPATCHER_H_
+#define XWALK_DBUS_METHOD_DISPATCHER_H_
+
+#include <deque>
+#include <map>
+#include <string>
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
+#include "dbus/exported_object.h"
+
+namespace base {
+class SingleThreadTaskRunner;
+class Thread;
+}
+
+namespace xwalk {
+
+// Dispatches the calls to the methods exported through it according to the
+// policy of their interface or method. dbus::ExportedObject runs all the
+// handlers on the origin thread of the bus, in the order the calls arrived,
+// so a slow handler delays every call behind it, e.g. the Launch() of the
+// launcher.
+//
+// The handlers may always reply later, from any thread: the response sender
+// posts the response to the D-Bus thread. The method call stays alive until
+// the response is sent.
+//
+// Lives on the origin thread of the bus.
+class MethodDispatcher {
+ public:
+  enum Policy {
+    // Run as soon as the call reaches the origin thread. For the calls a
+    // user is waiting for, e.g. launching an application.
+    PRIORITY,
+    // Queued on the origin thread, one call runs per task so that the
+    // priority calls arriving meanwhile run first. The default.
+    QUEUED,
+    // Run on a thread dedicated to the interface, for the slow handlers.
+    // They must not use the objects of the origin thread.
+    DEDICATED_THREAD,
+  };
+
+  MethodDispatcher();
+  ~MethodDispatcher();
+
+  // Sets the policy of |method_name| in |interface_name|, or of all its
+  // methods if |method_name| is empty. Applies to the methods exported
+  // afterwards.
+  void SetPolicy(const std::string& interface_name,
+                 const std::string& method_name,
+                 Policy policy);
+  Policy GetPolicy(const std::string& interface_name,
+                   const std::string& method_name) const;
+
+  // Same as dbus::ExportedObject::ExportMethod(), |method_call_callback|
+  // being dispatched according to the policy of the method.
+  void ExportMethod(
+      dbus::ExportedObject* object,
+      const std::string& interface_name,
+      const std::string& method_name,
+      const dbus::ExportedObject::MethodCallCallback& method_call_callback,
+      const dbus::ExportedObject::OnExportedCallback& on_exported_callback);
+
+  // The callback to export instead of |method_call_callback|.
+  dbus::ExportedObject::MethodCallCallback WrapMethodCallCallback(
+      const std::string& interface_name,
+      const std::string& method_name,
+      const dbus::ExportedObject::MethodCallCallback& method_call_callback);
+
+ private:
+  struct QueuedCall {
+    dbus::ExportedObject::MethodCallCallback callback;
+    dbus::MethodCall* method_call;
+    dbus::ExportedObject::ResponseSender response_sender;
+  };
+
+  void QueueCall(const dbus::ExportedObject::MethodCallCallback& callback,
+                 dbus::MethodCall* method_call,
+                 dbus::ExportedObject::ResponseSender response_sender);
+  void RunNextQueuedCall();
+
+  scoped_refptr<base::SingleThreadTaskRunner> GetDedicatedTaskRunner(
+      const std::string& interface_name);
+
+  // Keyed by "<interface>" and "<interface>.<method>".
+  std::map<std::string, Policy> policies_;
+
+  std::deque<QueuedCall> queued_calls_;
+
+  // Stopped with the dispatcher, the handlers still running finish first.
+  ScopedVector<base::Thread> dedicated_threads_;
+  typedef std::map<std::string, base::Thread*> ThreadMap;
+  ThreadMap dedicated_threads_by_interface_;
+
+  base::WeakPtrFactory<MethodDispatcher> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(MethodDispatcher);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_DBUS_METHOD_DISPATCHER_H_
@@ -0,0 +1,113 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/dbus/method_dispatcher.h"
+
+#include <string>
+#include <vector>
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/run_loop.h"
+#include "base/threading/platform_thread.h"
+#include "dbus/message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::MethodDispatcher;
+
+namespace {
+
+const char kTestInterface[] = "org.crosswalkproject.test_service.Interface1";
+
+void IgnoreResponse(scoped_ptr<dbus::Response> response) {}
+
+void RecordCall(std::vector<std::string>* calls,
+                dbus::MethodCall* method_call,
+                dbus::ExportedObject::ResponseSender response_sender) {
+  calls->push_back(method_call->GetMember());
+}
+
+void RunCall(const dbus::ExportedObject::MethodCallCallback& callback,
+             dbus::MethodCall* method_call) {
+  callback.Run(method_call, base::Bind(&IgnoreResponse));
+}
+
+void RecordThread(base::PlatformThreadId* thread_id,
+                  scoped_refptr<base::MessageLoopProxy> reply_loop,
+                  const base::Closure& quit_closure,
+                  dbus::MethodCall* method_call,
+                  dbus::ExportedObject::ResponseSender response_sender) {
+  *thread_id = base::PlatformThread::CurrentId();
+  response_sender.Run(dbus::Response::FromMethodCall(method_call));
+  reply_loop->PostTask(FROM_HERE, quit_closure);
+}
+
+}  // namespace
+
+TEST(MethodDispatcherTest, DefaultPolicy) {
+  MethodDispatcher dispatcher;
+  EXPECT_EQ(MethodDispatcher::QUEUED,
+            dispatcher.GetPolicy(kTestInterface, "Install"));
+
+  dispatcher.SetPolicy(kTestInterface, "", MethodDispatcher::DEDICATED_THREAD);
+  dispatcher.SetPolicy(kTestInterface, "Launch", MethodDispatcher::PRIORITY);
+  EXPECT_EQ(MethodDispatcher::DEDICATED_THREAD,
+            dispatcher.GetPolicy(kTestInterface, "Install"));
+  EXPECT_EQ(MethodDispatcher::PRIORITY,
+            dispatcher.GetPolicy(kTestInterface, "Launch"));
+}
+
+// A priority call arriving after queued ones runs first.
+TEST(MethodDispatcherTest, PriorityCallRunsBeforeQueuedCalls) {
+  base::MessageLoop message_loop;
+  MethodDispatcher dispatcher;
+  dispatcher.SetPolicy(kTestInterface, "Launch", MethodDispatcher::PRIORITY);
+
+  std::vector<std::string> calls;
+  dbus::ExportedObject::MethodCallCallback install =
+      dispatcher.WrapMethodCallCallback(
+          kTestInterface, "Install", base::Bind(&RecordCall, &calls));
+  dbus::ExportedObject::MethodCallCallback launch =
+      dispatcher.WrapMethodCallCallback(
+          kTestInterface, "Launch", base::Bind(&RecordCall, &calls));
+
+  dbus::MethodCall install_call1(kTestInterface, "Install");
+  dbus::MethodCall install_call2(kTestInterface, "Install");
+  dbus::MethodCall launch_call(kTestInterface, "Launch");
+  // The order in which dbus::ExportedObject posts the calls.
+  message_loop.PostTask(FROM_HERE,
+                        base::Bind(&RunCall, install, &install_call1));
+  message_loop.PostTask(FROM_HERE,
+                        base::Bind(&RunCall, install, &install_call2));
+  message_loop.PostTask(FROM_HERE,
+                        base::Bind(&RunCall, launch, &launch_call));
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_EQ(3u, calls.size());
+  EXPECT_EQ("Launch", calls[0]);
+  EXPECT_EQ("Install", calls[1]);
+  EXPECT_EQ("Install", calls[2]);
+}
+
+TEST(MethodDispatcherTest, DedicatedThread) {
+  base::MessageLoop message_loop;
+  base::RunLoop run_loop;
+  MethodDispatcher dispatcher;
+  dispatcher.SetPolicy(kTestInterface, "", MethodDispatcher::DEDICATED_THREAD);
+
+  base::PlatformThreadId thread_id = base::PlatformThread::CurrentId();
+  dbus::ExportedObject::MethodCallCallback install =
+      dispatcher.WrapMethodCallCallback(
+          kTestInterface, "Install",
+          base::Bind(&RecordThread, &thread_id,
+                     base::MessageLoopProxy::current(),
+                     run_loop.QuitClosure()));
+
+  dbus::MethodCall install_call(kTestInterface, "Install");
+  install_call.SetSerial(1);
+  RunCall(install, &install_call);
+  run_loop.Run();
+
+  EXPECT_NE(base::PlatformThread::CurrentId(), thread_id);
+}
@@ -13,6 +13,10 @@ namespace {
 
 const char kDBusObjectManagerInterface[] = "org.freedesktop.DBus.ObjectManager";
 
+// Long enough to gather the objects added by a burst of launches, short
+// enough for the clients not to notice.
+const int kSignalDelayMs = 50;
+
 }  // namespace
 
 namespace dbus {
@@ -34,6 +38,7 @@ ObjectManagerAdaptor::ObjectManagerAdaptor(scoped_refptr<Bus> bus,
 
 ObjectManagerAdaptor::~ObjectManagerAdaptor() {
   RemoveAllManagedObjects();
+  SendPendingSignals();
   bus_->UnregisterExportedObject(manager_path_);
 }
 
@@ -85,6 +90,8 @@ ManagedObject* ObjectManagerAdaptor::GetManagedObject(const ObjectPath& path) {
 void ObjectManagerAdaptor::OnGetManagedObjects(
     MethodCall* method_call,
     ExportedObject::ResponseSender response_sender) {
+  SendPendingSignals();
+
   scoped_ptr<Response> response =
       Response::FromMethodCall(method_call);
   MessageWriter writer(response.get());
@@ -138,12 +145,15 @@ void ObjectManagerAdaptor::EmitInterfacesAdded(const ManagedObject* object) {
   if (!is_exported_)
     return;
 
-  Signal interfaces_added(kDBusObjectManagerInterface, "InterfacesAdded");
-  MessageWriter writer(&interfaces_added);
-
-  writer.AppendObjectPath(object->path());
-  object->AppendAllPropertiesToWriter(&writer);
-  manager_object_->SendSignal(&interfaces_added);
+  PendingSignal pending;
+  pending.added = true;
+  pending.path = object->path();
+  pending_signals_.push_back(pending);
+  if (!signal_timer_.IsRunning()) {
+    signal_timer_.Start(FROM_HERE,
+                        base::TimeDelta::FromMilliseconds(kSignalDelayMs),
+                        this, &ObjectManagerAdaptor::SendPendingSignals);
+  }
 }
 
 void ObjectManagerAdaptor::EmitInterfacesRemoved(const ManagedObject* object) {
@@ -151,12 +161,54 @@ void ObjectManagerAdaptor::EmitInterfacesRemoved(const ManagedObject* object) {
   if (!is_exported_)
     return;
 
-  Signal interfaces_removed(kDBusObjectManagerInterface, "InterfacesRemoved");
-  MessageWriter writer(&interfaces_removed);
+  // The clients don't know about the object yet if its InterfacesAdded is
+  // still pending, nothing needs to be sent then.
+  for (std::vector<PendingSignal>::reverse_iterator it =
+           pending_signals_.rbegin(); it != pending_signals_.rend(); ++it) {
+    if (it->path != object->path())
+      continue;
+    if (it->added) {
+      pending_signals_.erase((it + 1).base());
+      return;
+    }
+    break;
+  }
 
-  writer.AppendObjectPath(object->path());
-  object->AppendInterfacesToWriter(&writer);
-  manager_object_->SendSignal(&interfaces_removed);
+  PendingSignal pending;
+  pending.added = false;
+  pending.path = object->path();
+  pending.interfaces = object->interfaces();
+  pending_signals_.push_back(pending);
+  if (!signal_timer_.IsRunning()) {
+    signal_timer_.Start(FROM_HERE,
+                        base::TimeDelta::FromMilliseconds(kSignalDelayMs),
+                        this, &ObjectManagerAdaptor::SendPendingSignals);
+  }
+}
+
+void ObjectManagerAdaptor::SendPendingSignals() {
+  signal_timer_.Stop();
+  for (size_t i = 0; i < pending_signals_.size(); ++i) {
+    const PendingSignal& pending = pending_signals_[i];
+    if (pending.added) {
+      // Removing the object would have dropped the signal.
+      ManagedObject* object = GetManagedObject(pending.path);
+      DCHECK(object);
+      Signal interfaces_added(kDBusObjectManagerInterface, "InterfacesAdded");
+      MessageWriter writer(&interfaces_added);
+      writer.AppendObjectPath(pending.path);
+      object->AppendAllPropertiesToWriter(&writer);
+      manager_object_->SendSignal(&interfaces_added);
+    } else {
+      Signal interfaces_removed(kDBusObjectManagerInterface,
+                                "InterfacesRemoved");
+      MessageWriter writer(&interfaces_removed);
+      writer.AppendObjectPath(pending.path);
+      writer.AppendArrayOfStrings(pending.interfaces);
+      manager_object_->SendSignal(&interfaces_removed);
+    }
+  }
+  pending_signals_.clear();
 }
 
 ManagedObject::ManagedObject(scoped_refptr<Bus> bus, const ObjectPath& path)
@@ -190,4 +242,8 @@ void ManagedObject::AppendInterfacesToWriter(MessageWriter* writer) const {
   writer->AppendArrayOfStrings(properties_.interfaces());
 }
 
+std::vector<std::string> ManagedObject::interfaces() const {
+  return properties_.interfaces();
+}
+
 }  // namespace dbus
@@ -6,9 +6,11 @@
 #define XWALK_DBUS_OBJECT_MANAGER_ADAPTOR_H_
 
 #include <string>
+#include <vector>
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 #include "dbus/exported_object.h"
 #include "xwalk/dbus/property_exporter.h"
 
@@ -22,6 +24,11 @@ class ManagedObject;
 //
 // It takes care of creating the manager object, so if more interfaces will be
 // exported at that path, use manager_object().
+//
+// The signals are sent after a short delay, so when many objects come and go
+// at once, e.g. applications launched together, an object removed before its
+// InterfacesAdded was sent isn't signaled at all. The pending signals are
+// sent before replying to GetManagedObjects, so clients get them in order.
 class ObjectManagerAdaptor {
  public:
   ObjectManagerAdaptor(scoped_refptr<Bus> bus, const ObjectPath& manager_path);
@@ -45,6 +52,7 @@ class ObjectManagerAdaptor {
   void RemoveAllManagedObjects();
   void EmitInterfacesAdded(const ManagedObject* object);
   void EmitInterfacesRemoved(const ManagedObject* object);
+  void SendPendingSignals();
 
   base::WeakPtrFactory<ObjectManagerAdaptor> weak_factory_;
 
@@ -57,6 +65,16 @@ class ObjectManagerAdaptor {
   ScopedVector<ManagedObject> managed_objects_;
   bool is_exported_;
 
+  struct PendingSignal {
+    bool added;
+    ObjectPath path;
+    // Only for InterfacesRemoved, the object is gone when it is sent. The
+    // properties for InterfacesAdded are read when it is sent.
+    std::vector<std::string> interfaces;
+  };
+  std::vector<PendingSignal> pending_signals_;
+  base::OneShotTimer<ObjectManagerAdaptor> signal_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(ObjectManagerAdaptor);
 };
 
@@ -70,6 +88,7 @@ class ManagedObject {
   ObjectPath path() const;
   void AppendAllPropertiesToWriter(MessageWriter* writer) const;
   void AppendInterfacesToWriter(MessageWriter* writer) const;
+  std::vector<std::string> interfaces() const;
 
   ExportedObject* dbus_object() { return dbus_object_; }
   PropertyExporter* properties() { return &properties_; }
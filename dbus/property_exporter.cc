@@ -21,7 +21,9 @@ namespace dbus {
 
 PropertyExporter::PropertyExporter(ExportedObject* object,
                                    const ObjectPath& path)
-    : path_(path),
+    : update_depth_(0),
+      object_(object),
+      path_(path),
       weak_factory_(this) {
   CHECK(object);
   object->ExportMethod(
@@ -58,9 +60,33 @@ void PropertyExporter::Set(const std::string& interface,
     interfaces_[interface] = dict;
   }
 
+  const base::Value* old_value = NULL;
+  if (dict->Get(property, &old_value) && old_value->Equals(value.get()))
+    return;
   dict->Set(property, value.release());
 
-  // TODO(cmarcelo): Emit PropertyChanged signal.
+  std::set<std::string>& changed = changed_properties_[interface];
+  changed.insert(property);
+  if (update_depth_ > 0)
+    return;
+
+  EmitPropertiesChanged(interface, changed);
+  changed_properties_.clear();
+}
+
+void PropertyExporter::BeginUpdate() {
+  ++update_depth_;
+}
+
+void PropertyExporter::Commit() {
+  DCHECK_GT(update_depth_, 0);
+  if (--update_depth_ > 0)
+    return;
+
+  ChangedPropertiesMap::const_iterator it = changed_properties_.begin();
+  for (; it != changed_properties_.end(); ++it)
+    EmitPropertiesChanged(it->first, it->second);
+  changed_properties_.clear();
 }
 
 namespace {
@@ -195,6 +221,36 @@ void PropertyExporter::OnGetAll(
   response_sender.Run(response.Pass());
 }
 
+void PropertyExporter::EmitPropertiesChanged(
+    const std::string& interface,
+    const std::set<std::string>& properties) {
+  const base::DictionaryValue* dict = interfaces_[interface];
+
+  Signal signal(kPropertiesInterface, kPropertiesChanged);
+  MessageWriter writer(&signal);
+  writer.AppendString(interface);
+
+  MessageWriter dict_writer(NULL);
+  writer.OpenArray("{sv}", &dict_writer);
+  std::set<std::string>::const_iterator it = properties.begin();
+  for (; it != properties.end(); ++it) {
+    const base::Value* value = NULL;
+    if (!dict->Get(*it, &value))
+      continue;
+    MessageWriter entry_writer(NULL);
+    dict_writer.OpenDictEntry(&entry_writer);
+    entry_writer.AppendString(*it);
+    AppendVariantOfValue(&entry_writer, *value);
+    dict_writer.CloseContainer(&entry_writer);
+  }
+  writer.CloseContainer(&dict_writer);
+
+  // No property is invalidated, the new values are always sent.
+  writer.AppendArrayOfStrings(std::vector<std::string>());
+
+  object_->SendSignal(&signal);
+}
+
 void PropertyExporter::OnExported(const std::string& interface_name,
                                   const std::string& method_name,
                                   bool success) {
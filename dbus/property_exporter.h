@@ -6,6 +6,7 @@
 #define XWALK_DBUS_PROPERTY_EXPORTER_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include "base/memory/scoped_ptr.h"
@@ -30,10 +31,18 @@ class PropertyExporter {
   PropertyExporter(dbus::ExportedObject* object, const dbus::ObjectPath& path);
   ~PropertyExporter();
 
+  // Emits PropertiesChanged for |property| if its value changed, unless an
+  // update is in progress.
   void Set(const std::string& interface,
            const std::string& property,
            scoped_ptr<base::Value>);
 
+  // The properties changed between BeginUpdate() and Commit() are signaled
+  // by a single PropertiesChanged per interface on Commit(). Updates can be
+  // nested, only the outermost Commit() emits the signals.
+  void BeginUpdate();
+  void Commit();
+
   // TODO(cmarcelo): We need some callback to indicate when all the methods
   // were exported.
 
@@ -51,9 +60,19 @@ class PropertyExporter {
                   const std::string& method_name,
                   bool success);
 
+  void EmitPropertiesChanged(const std::string& interface,
+                             const std::set<std::string>& properties);
+
   typedef std::map<std::string, base::DictionaryValue*> InterfacesMap;
   InterfacesMap interfaces_;
 
+  // Properties changed during the current update, by interface.
+  typedef std::map<std::string, std::set<std::string> > ChangedPropertiesMap;
+  ChangedPropertiesMap changed_properties_;
+  int update_depth_;
+
+  dbus::ExportedObject* object_;
+
   dbus::ObjectPath path_;
   base::WeakPtrFactory<PropertyExporter> weak_factory_;
 };
@@ -41,6 +41,8 @@ class ExportObjectWithPropertiesService {
     properties_->Set(kTestInterface, property, v.Pass());
   }
 
+  dbus::PropertyExporter* properties() { return properties_.get(); }
+
  private:
   void OnOwnershipCallback(const std::string& service_name, bool success) {
     ASSERT_TRUE(success)
@@ -76,6 +78,11 @@ class GetPropertyClient : public dbus::TestClient {
         new Properties(object_proxy_,
                        base::Bind(&GetPropertyClient::OnPropertyChanged,
                                   base::Unretained(this))));
+  }
+
+  // The signals are left out by default, so the updates can only come from
+  // the replies to Get() and GetAll().
+  void ConnectSignals() {
     properties_->ConnectSignals();
   }
 
@@ -205,3 +212,46 @@ TEST(PropertyExporterTest, GetAll) {
   ASSERT_EQ(test_client.properties()->property.value(), "Pass");
   ASSERT_EQ(test_client.properties()->other_property.value(), "Pass");
 }
+
+// Changes are signaled without the client asking for them.
+TEST(PropertyExporterTest, SignalOnChange) {
+  base::MessageLoop message_loop;
+  ExportObjectWithPropertiesService test_service;
+  GetPropertyClient test_client(&message_loop);
+  test_client.ConnectSignals();
+
+  // Will run message loop until service is initialized.
+  test_service.Initialize(base::Bind(&base::MessageLoop::Quit,
+                                     base::Unretained(&message_loop)));
+  message_loop.Run();
+
+  test_service.SetStringProperty("Property", "Pass");
+  test_client.WaitForUpdates(1);
+
+  ASSERT_EQ(test_client.properties()->property.value(), "Pass");
+}
+
+// Changes made during an update are signaled together on Commit().
+TEST(PropertyExporterTest, BatchedUpdate) {
+  base::MessageLoop message_loop;
+  ExportObjectWithPropertiesService test_service;
+  GetPropertyClient test_client(&message_loop);
+  test_client.ConnectSignals();
+
+  // Will run message loop until service is initialized.
+  test_service.Initialize(base::Bind(&base::MessageLoop::Quit,
+                                     base::Unretained(&message_loop)));
+  message_loop.Run();
+
+  test_service.properties()->BeginUpdate();
+  test_service.SetStringProperty("Property", "Fail");
+  test_service.SetStringProperty("Property", "Pass");
+  test_service.SetStringProperty("OtherProperty", "Pass");
+  test_service.properties()->Commit();
+
+  // One update per property of the single signal.
+  test_client.WaitForUpdates(2);
+
+  ASSERT_EQ(test_client.properties()->property.value(), "Pass");
+  ASSERT_EQ(test_client.properties()->other_property.value(), "Pass");
+}
@@ -10,6 +10,8 @@
       ],
       'sources': [
         'dbus_manager.h',
+        'method_dispatcher.cc',
+        'method_dispatcher.h',
         'object_manager_adaptor.cc',
         'object_manager_adaptor.h',
         'property_exporter.cc',
@@ -45,6 +47,7 @@
         'test_client.cc',
         'test_client.h',
         'dbus_manager_unittest.cc',
+        'method_dispatcher_unittest.cc',
         'property_exporter_unittest.cc',
       ],
     },
@@ -28,12 +28,16 @@ function _isFunction(fn) {
 var NativeFileSystem = function() {
 };
 
+// The isolated file systems requested, by virtual root.
+var _file_system_ids = {};
+
 var requestNativeFileSystem = function(path, success, error) {
   var msg = new Object();
   msg.data = new Object();
   msg.data.virtual_root = path;
   msg.cmd = "requestNativeFileSystem";
   function get_file_system_id_success(data) {
+    _file_system_ids[path] = data.file_system_id;
     var fs = IsolatedFileSystem.getIsolatedFileSystem(data.file_system_id);
     success(fs);
   }
@@ -44,10 +48,146 @@ var getDirectoryList = function() {
   extension.internal.sendSyncMessage("get");
 }
 
+// Must match kMaxChunkSize in native_file_system_extension.cc.
+var CHUNK_SIZE = 1024 * 1024;
+
+// The requests below take paths relative to |virtualRoot| and return
+// promises. They are done natively, in one message whatever the number of
+// files involved, except for the reads and writes which are sent in chunks.
+var sendRequest = function(cmd, virtualRoot, path, args) {
+  var msg = args || new Object();
+  msg.cmd = cmd;
+  msg.virtual_root = String(virtualRoot);
+  msg.path = String(path);
+  return extension.internal.sendRequest(msg).then(function(reply) {
+    if (reply && reply.error)
+      throw new Error(reply.errorMessage);
+    return reply;
+  });
+}
+
+// Resolves with the entries of the directory, each one an object with
+// name, isDirectory, size and lastModified properties.
+var listDirectory = function(virtualRoot, path) {
+  return sendRequest("listDirectory", virtualRoot, path).then(
+      function(reply) {
+        return reply.entries;
+      });
+}
+
+// Files and directories are copied, and moved, along with their content.
+var copy = function(virtualRoot, path, destination) {
+  return sendRequest("copy", virtualRoot, path,
+                     { destination: String(destination) });
+}
+
+var move = function(virtualRoot, path, destination) {
+  return sendRequest("move", virtualRoot, path,
+                     { destination: String(destination) });
+}
+
+// Calls |onChunk| with each ArrayBuffer read and its offset in the file, then
+// resolves with the size of the file.
+var readFile = function(virtualRoot, path, onChunk) {
+  var readFrom = function(offset) {
+    return sendRequest("read", virtualRoot, path,
+                       { offset: offset, size: CHUNK_SIZE }).then(
+        function(chunk) {
+          if (chunk.byteLength)
+            onChunk(chunk, offset);
+          if (chunk.byteLength < CHUNK_SIZE)
+            return offset + chunk.byteLength;
+          return readFrom(offset + chunk.byteLength);
+        });
+  };
+  return readFrom(0);
+}
+
+// Resolves with the whole content of the file in an ArrayBuffer. Once the
+// native file system of |virtualRoot| was requested, the renderer opens the
+// file itself and reads it at once, which suits large media files or
+// datasets. Otherwise the file is read in chunks and assembled. The buffer is
+// a copy, later writes to the file don't change it.
+var mapFile = function(virtualRoot, path) {
+  var file_system_id = _file_system_ids[virtualRoot];
+  if (file_system_id !== undefined) {
+    var relative_path = String(path).replace(/^\/+/, "");
+    var buffer = IsolatedFileSystem.mapFile(file_system_id, relative_path);
+    // Same native promises as sendRequest(), |Promise| is the one of
+    // requestNativeFileSystem().
+    if (buffer)
+      return window.Promise.resolve(buffer);
+  }
+
+  var chunks = [];
+  return readFile(virtualRoot, path, function(chunk, offset) {
+    chunks.push(chunk);
+  }).then(function(size) {
+    var data = new Uint8Array(size);
+    var offset = 0;
+    for (var i = 0; i < chunks.length; ++i) {
+      data.set(new Uint8Array(chunks[i]), offset);
+      offset += chunks[i].byteLength;
+    }
+    return data.buffer;
+  });
+}
+
+// Replaces the content of the file with |data|, an ArrayBuffer. With |sync|
+// the promise is only resolved once the content is on the disk, the last
+// chunk is synced.
+var writeFile = function(virtualRoot, path, data, sync) {
+  var writeFrom = function(offset) {
+    var end = Math.min(offset + CHUNK_SIZE, data.byteLength);
+    return sendRequest("write", virtualRoot, path,
+                       { offset: offset, data: data.slice(offset, end),
+                         sync: Boolean(sync) && end == data.byteLength }).then(
+        function() {
+          if (end < data.byteLength)
+            return writeFrom(end);
+          return end;
+        });
+  };
+  return writeFrom(0);
+}
+
+var _watchers = {};
+var _next_watch_id = 0;
+
+// Calls |callback| when entries are added to, removed from or changed in the
+// directory |path|, or with true when it can no longer be watched. Resolves
+// with the id to give to unwatch().
+var watch = function(virtualRoot, path, callback) {
+  var watchId = _next_watch_id++;
+  _watchers[watchId] = callback;
+  return sendRequest("watch", virtualRoot, path, { watch_id: watchId }).then(
+      function() {
+        return watchId;
+      },
+      function(e) {
+        delete _watchers[watchId];
+        throw e;
+      });
+}
+
+var unwatch = function(watchId) {
+  delete _watchers[watchId];
+  return extension.internal.sendRequest(
+      { cmd: "unwatch", watch_id: watchId });
+}
+
 NativeFileSystem.prototype = new Object();
 NativeFileSystem.prototype.constructor = NativeFileSystem;
 NativeFileSystem.prototype.requestNativeFileSystem = requestNativeFileSystem;
 NativeFileSystem.prototype.getDirectoryList = getDirectoryList;
+NativeFileSystem.prototype.listDirectory = listDirectory;
+NativeFileSystem.prototype.copy = copy;
+NativeFileSystem.prototype.move = move;
+NativeFileSystem.prototype.readFile = readFile;
+NativeFileSystem.prototype.mapFile = mapFile;
+NativeFileSystem.prototype.writeFile = writeFile;
+NativeFileSystem.prototype.watch = watch;
+NativeFileSystem.prototype.unwatch = unwatch;
 
 exports = new NativeFileSystem();
 
@@ -71,6 +211,11 @@ extension.setMessageListener(function(msgStr) {
   switch (msgObj.cmd) {
     case "requestNativeFileSystem_ret":
       handlePromise(msgObj);
+      break;
+    case "watch_event":
+      if (_isFunction(_watchers[msgObj.data.watch_id]))
+        _watchers[msgObj.data.watch_id](msgObj.data.error);
+      break;
     default:
       break;
   }
@@ -7,8 +7,17 @@
 #include <algorithm>
 #include <map>
 
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/files/file.h"
+#include "base/files/file_enumerator.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/sequenced_task_runner.h"
+#include "base/stl_util.h"
+#include "base/task_runner_util.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/child_process_security_policy.h"
 #include "grit/xwalk_resources.h"
@@ -19,8 +28,120 @@
 namespace xwalk {
 namespace experimental {
 
+namespace {
+
+// The largest chunk a read request returns, the API reads the files in
+// chunks of this size.
+const int kMaxChunkSize = 1024 * 1024;
+
+// Returns an empty path if |path| is not within |virtual_root|.
+base::FilePath ResolvePath(const std::string& virtual_root,
+                           const std::string& path) {
+  std::string real_path =
+      VirtualRootProvider::GetInstance()->GetRealPath(virtual_root);
+  if (real_path.empty())
+    return base::FilePath();
+
+  base::FilePath relative_path = base::FilePath::FromUTF8Unsafe(
+      path.substr(std::min(path.find_first_not_of('/'), path.size())));
+  if (relative_path.IsAbsolute() || relative_path.ReferencesParent())
+    return base::FilePath();
+  return base::FilePath::FromUTF8Unsafe(real_path).Append(relative_path);
+}
+
+scoped_ptr<base::Value> CreateReply(bool error,
+                                    const std::string& error_message) {
+  scoped_ptr<base::DictionaryValue> reply(new base::DictionaryValue);
+  reply->SetBoolean("error", error);
+  if (error)
+    reply->SetString("errorMessage", error_message);
+  return reply.PassAs<base::Value>();
+}
+
+scoped_ptr<base::Value> ListDirectory(const base::FilePath& path) {
+  if (!base::DirectoryExists(path))
+    return CreateReply(true, "Not a directory.");
+
+  // The enumerator stats the entries as it reads them, they are all sent
+  // along with their names.
+  scoped_ptr<base::ListValue> entries(new base::ListValue);
+  base::FileEnumerator enumerator(
+      path, false,
+      base::FileEnumerator::FILES | base::FileEnumerator::DIRECTORIES);
+  for (base::FilePath name = enumerator.Next(); !name.empty();
+       name = enumerator.Next()) {
+    base::FileEnumerator::FileInfo info = enumerator.GetInfo();
+    base::DictionaryValue* entry = new base::DictionaryValue;
+    entry->SetString("name", info.GetName().AsUTF8Unsafe());
+    entry->SetBoolean("isDirectory", info.IsDirectory());
+    entry->SetDouble("size", static_cast<double>(info.GetSize()));
+    entry->SetDouble("lastModified", info.GetLastModifiedTime().ToJsTime());
+    entries->Append(entry);
+  }
+
+  scoped_ptr<base::Value> reply(CreateReply(false, std::string()));
+  static_cast<base::DictionaryValue*>(reply.get())->Set(
+      "entries", entries.release());
+  return reply.Pass();
+}
+
+scoped_ptr<base::Value> CopyEntry(const base::FilePath& from,
+                                  const base::FilePath& to) {
+  bool copied = base::DirectoryExists(from) ?
+      base::CopyDirectory(from, to, true) : base::CopyFile(from, to);
+  return CreateReply(!copied, "Copy failed.");
+}
+
+scoped_ptr<base::Value> MoveEntry(const base::FilePath& from,
+                                  const base::FilePath& to) {
+  return CreateReply(!base::Move(from, to), "Move failed.");
+}
+
+// Replies with the bytes read, which are fewer than |size| at the end of the
+// file.
+scoped_ptr<base::Value> ReadChunk(const base::FilePath& path,
+                                  int64 offset,
+                                  int size) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return CreateReply(true, "Unable to open the file.");
+
+  scoped_ptr<char[]> buffer(new char[size]);
+  int bytes_read = file.Read(offset, buffer.get(), size);
+  if (bytes_read < 0)
+    return CreateReply(true, "Unable to read the file.");
+  return scoped_ptr<base::Value>(
+      new base::BinaryValue(buffer.Pass(), bytes_read));
+}
+
+// The file is truncated by the write at offset 0. The data is left to the
+// page cache unless |sync|, then it is on the disk once replied.
+scoped_ptr<base::Value> WriteChunk(const base::FilePath& path,
+                                   int64 offset,
+                                   bool sync,
+                                   scoped_ptr<base::Value> data) {
+  const base::BinaryValue* binary =
+      static_cast<const base::BinaryValue*>(data.get());
+  uint32 flags = base::File::FLAG_WRITE |
+      (offset ? base::File::FLAG_OPEN : base::File::FLAG_CREATE_ALWAYS);
+  base::File file(path, flags);
+  if (!file.IsValid())
+    return CreateReply(true, "Unable to open the file.");
+
+  int size = static_cast<int>(binary->GetSize());
+  if (file.Write(offset, binary->GetBuffer(), size) != size)
+    return CreateReply(true, "Unable to write the file.");
+  if (sync && !file.Flush())
+    return CreateReply(true, "Unable to sync the file.");
+  return CreateReply(false, std::string());
+}
+
+}  // namespace
+
 NativeFileSystemExtension::NativeFileSystemExtension(
-    content::RenderProcessHost* host) {
+    content::RenderProcessHost* host,
+    base::SequencedWorkerPool* file_pool)
+    : file_pool_(file_pool) {
   host_ = host;
   set_name("xwalk.experimental.native_file_system");
   set_javascript_api(
@@ -31,15 +152,25 @@ NativeFileSystemExtension::NativeFileSystemExtension(
 NativeFileSystemExtension::~NativeFileSystemExtension() {}
 
 XWalkExtensionInstance* NativeFileSystemExtension::CreateInstance() {
-  return new NativeFileSystemInstance(host_);
+  return new NativeFileSystemInstance(host_, file_pool_.get());
 }
 
 NativeFileSystemInstance::NativeFileSystemInstance(
-    content::RenderProcessHost* host)
+    content::RenderProcessHost* host,
+    base::SequencedWorkerPool* file_pool)
     : handler_(this),
-      host_(host) {
+      host_(host),
+      weak_factory_(this) {
+  file_task_runner_ = file_pool->GetSequencedTaskRunnerWithShutdownBehavior(
+      file_pool->GetSequenceToken(),
+      base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  watchers_ = new FileSystemWatchers(
+      base::Bind(&NativeFileSystemInstance::OnPathChanged,
+                 weak_factory_.GetWeakPtr()));
 }
 
+NativeFileSystemInstance::~NativeFileSystemInstance() {}
+
 void NativeFileSystemInstance::HandleMessage(scoped_ptr<base::Value> msg) {
   base::DictionaryValue* msg_value = NULL;
   if (!msg->GetAsDictionary(&msg_value) || NULL == msg_value) {
@@ -63,14 +194,8 @@ void NativeFileSystemInstance::HandleMessage(scoped_ptr<base::Value> msg) {
     return;
   }
 
-  std::string upper_virtual_root_string = virtual_root_string;
-  std::transform(upper_virtual_root_string.begin(),
-      upper_virtual_root_string.end(),
-      upper_virtual_root_string.begin(),
-      ::toupper);
   std::string real_path =
-      VirtualRootProvider::GetInstance()->GetRealPath(
-          upper_virtual_root_string);
+      VirtualRootProvider::GetInstance()->GetRealPath(virtual_root_string);
   if (real_path.empty()) {
     const scoped_ptr<base::DictionaryValue> res(new base::DictionaryValue());
     res->SetString("_promise_id", promise_id_string);
@@ -92,6 +217,160 @@ void NativeFileSystemInstance::HandleMessage(scoped_ptr<base::Value> msg) {
   checker->DoTask();
 }
 
+void NativeFileSystemInstance::HandleRequest(int request_id,
+                                             scoped_ptr<base::Value> msg) {
+  base::DictionaryValue* dict = NULL;
+  std::string cmd;
+  if (!msg->GetAsDictionary(&dict) || !dict->GetString("cmd", &cmd)) {
+    OnRequestDone(request_id, CreateReply(true, "Invalid request."));
+    return;
+  }
+
+  int watch_id = 0;
+  if (cmd == "unwatch") {
+    if (dict->GetInteger("watch_id", &watch_id)) {
+      content::BrowserThread::PostTask(
+          content::BrowserThread::IO, FROM_HERE,
+          base::Bind(&FileSystemWatchers::Unwatch, watchers_, watch_id));
+    }
+    OnRequestDone(request_id, CreateReply(false, std::string()));
+    return;
+  }
+
+  std::string virtual_root;
+  std::string path_string;
+  if (!dict->GetString("virtual_root", &virtual_root) ||
+      !dict->GetString("path", &path_string)) {
+    OnRequestDone(request_id, CreateReply(true, "Invalid request."));
+    return;
+  }
+
+  base::FilePath path = ResolvePath(virtual_root, path_string);
+  if (path.empty()) {
+    OnRequestDone(request_id, CreateReply(true, "Invalid path."));
+    return;
+  }
+
+  if (cmd == "watch") {
+    if (!dict->GetInteger("watch_id", &watch_id)) {
+      OnRequestDone(request_id, CreateReply(true, "Invalid watch id."));
+      return;
+    }
+    base::PostTaskAndReplyWithResult(
+        content::BrowserThread::GetMessageLoopProxyForThread(
+            content::BrowserThread::IO).get(),
+        FROM_HERE,
+        base::Bind(&FileSystemWatchers::Watch, watchers_, watch_id, path),
+        base::Bind(&NativeFileSystemInstance::OnRequestDone,
+                   weak_factory_.GetWeakPtr(), request_id));
+    return;
+  }
+
+  base::Callback<scoped_ptr<base::Value>()> task;
+  if (cmd == "listDirectory") {
+    task = base::Bind(&ListDirectory, path);
+  } else if (cmd == "copy" || cmd == "move") {
+    std::string destination_string;
+    dict->GetString("destination", &destination_string);
+    base::FilePath destination = ResolvePath(virtual_root, destination_string);
+    if (destination.empty()) {
+      OnRequestDone(request_id, CreateReply(true, "Invalid destination."));
+      return;
+    }
+    task = base::Bind(cmd == "copy" ? &CopyEntry : &MoveEntry,
+                      path, destination);
+  } else if (cmd == "read" || cmd == "write") {
+    double offset = 0;
+    dict->GetDouble("offset", &offset);
+    if (offset < 0) {
+      OnRequestDone(request_id, CreateReply(true, "Invalid offset."));
+      return;
+    }
+    if (cmd == "read") {
+      int size = kMaxChunkSize;
+      dict->GetInteger("size", &size);
+      task = base::Bind(&ReadChunk, path, static_cast<int64>(offset),
+                        std::max(0, std::min(size, kMaxChunkSize)));
+    } else {
+      scoped_ptr<base::Value> data;
+      if (!dict->RemoveWithoutPathExpansion("data", &data) ||
+          !data->IsType(base::Value::TYPE_BINARY)) {
+        OnRequestDone(request_id, CreateReply(true, "Invalid data."));
+        return;
+      }
+      bool sync = false;
+      dict->GetBoolean("sync", &sync);
+      task = base::Bind(&WriteChunk, path, static_cast<int64>(offset), sync,
+                        base::Passed(&data));
+    }
+  } else {
+    OnRequestDone(request_id, CreateReply(true, "Invalid cmd: " + cmd));
+    return;
+  }
+
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE, task,
+      base::Bind(&NativeFileSystemInstance::OnRequestDone,
+                 weak_factory_.GetWeakPtr(), request_id));
+}
+
+void NativeFileSystemInstance::OnRequestDone(int request_id,
+                                             scoped_ptr<base::Value> reply) {
+  SendReplyToJS(request_id, reply.Pass());
+}
+
+void NativeFileSystemInstance::OnPathChanged(int watch_id, bool error) {
+  const scoped_ptr<base::DictionaryValue> res(new base::DictionaryValue());
+  res->SetString("cmd", "watch_event");
+  res->SetInteger("data.watch_id", watch_id);
+  res->SetBoolean("data.error", error);
+  std::string msg_string;
+  base::JSONWriter::Write(res.get(), &msg_string);
+  PostMessageToJS(scoped_ptr<base::Value>(new base::StringValue(msg_string)));
+}
+
+FileSystemWatchers::FileSystemWatchers(const ChangeCallback& callback)
+    : callback_runner_(base::MessageLoopProxy::current()),
+      callback_(callback) {
+}
+
+FileSystemWatchers::~FileSystemWatchers() {
+  STLDeleteValues(&watchers_);
+}
+
+scoped_ptr<base::Value> FileSystemWatchers::Watch(int watch_id,
+                                                  const base::FilePath& path) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::IO));
+  if (watchers_.count(watch_id))
+    return CreateReply(true, "The watch id is in use.");
+
+  scoped_ptr<base::FilePathWatcher> watcher(new base::FilePathWatcher);
+  // Only the entries of |path| are watched, recursive watches aren't
+  // supported on all the platforms.
+  if (!watcher->Watch(path, false,
+                      base::Bind(&FileSystemWatchers::OnPathChanged,
+                                 base::Unretained(this), watch_id)))
+    return CreateReply(true, "Unable to watch the path.");
+  watchers_[watch_id] = watcher.release();
+  return CreateReply(false, std::string());
+}
+
+void FileSystemWatchers::Unwatch(int watch_id) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::IO));
+  WatcherMap::iterator it = watchers_.find(watch_id);
+  if (it == watchers_.end())
+    return;
+  delete it->second;
+  watchers_.erase(it);
+}
+
+void FileSystemWatchers::OnPathChanged(int watch_id,
+                                       const base::FilePath& path,
+                                       bool error) {
+  callback_runner_->PostTask(FROM_HERE,
+                             base::Bind(callback_, watch_id, error));
+}
+
 FileSystemChecker::FileSystemChecker(
     int process_id,
     const std::string& path,
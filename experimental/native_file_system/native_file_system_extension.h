@@ -5,13 +5,23 @@
 #ifndef XWALK_EXPERIMENTAL_NATIVE_FILE_SYSTEM_NATIVE_FILE_SYSTEM_EXTENSION_H_
 #define XWALK_EXPERIMENTAL_NATIVE_FILE_SYSTEM_NATIVE_FILE_SYSTEM_EXTENSION_H_
 
+#include <map>
 #include <string>
 
+#include "base/files/file_path_watcher.h"
+#include "base/memory/weak_ptr.h"
 #include "base/values.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_process_host.h"
 #include "xwalk/extensions/browser/xwalk_extension_function_handler.h"
 #include "xwalk/extensions/common/xwalk_extension.h"
 
+namespace base {
+class SequencedTaskRunner;
+class SequencedWorkerPool;
+class SingleThreadTaskRunner;
+}
+
 namespace xwalk {
 namespace experimental {
 
@@ -22,7 +32,11 @@ using extensions::XWalkExtensionInstance;
 
 class NativeFileSystemExtension : public XWalkExtension {
  public:
-  explicit NativeFileSystemExtension(content::RenderProcessHost* host);
+  // The file requests of the instances are run on |file_pool|, shared by
+  // the render processes so the bulk I/O of an application doesn't compete
+  // with the other tasks of the blocking pool.
+  NativeFileSystemExtension(content::RenderProcessHost* host,
+                            base::SequencedWorkerPool* file_pool);
   virtual ~NativeFileSystemExtension();
 
   // XWalkExtension implementation.
@@ -30,18 +44,70 @@ class NativeFileSystemExtension : public XWalkExtension {
 
  private:
   content::RenderProcessHost* host_;
+  scoped_refptr<base::SequencedWorkerPool> file_pool_;
+};
+
+// Watches paths within the virtual roots for the instance which created it,
+// so the applications can update what they know about the files rather than
+// rescanning the directories. Watch() and Unwatch() are called on the IO
+// thread, the changes are reported on the thread which created it.
+class FileSystemWatchers
+    : public base::RefCountedThreadSafe<
+          FileSystemWatchers, content::BrowserThread::DeleteOnIOThread> {
+ public:
+  typedef base::Callback<void(int watch_id, bool error)> ChangeCallback;
+
+  explicit FileSystemWatchers(const ChangeCallback& callback);
+
+  // Replies with whether the watch started, to be sent to JS.
+  scoped_ptr<base::Value> Watch(int watch_id, const base::FilePath& path);
+  void Unwatch(int watch_id);
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::IO>;
+  friend class base::DeleteHelper<FileSystemWatchers>;
+  ~FileSystemWatchers();
+
+  void OnPathChanged(int watch_id, const base::FilePath& path, bool error);
+
+  typedef std::map<int, base::FilePathWatcher*> WatcherMap;
+  WatcherMap watchers_;
+  scoped_refptr<base::SingleThreadTaskRunner> callback_runner_;
+  ChangeCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileSystemWatchers);
 };
 
+// Besides registering the isolated file systems used through the FileSystem
+// API, serves the requests which would take a round trip per file with it:
+// listing a directory along with the stat of its entries, copying and moving
+// whole trees, and reading or writing files in large binary chunks. Their
+// paths are relative to a virtual root, the requests of an instance are run
+// in order, one at a time, on the file pool: an application reading or
+// writing a big file holds a single thread, one chunk at a time, and the
+// requests of the others are interleaved with its chunks. The changes to the
+// entries of the watched directories are posted as "watch_event" messages.
 class NativeFileSystemInstance : public XWalkExtensionInstance {
  public:
-  explicit NativeFileSystemInstance(content::RenderProcessHost* host);
+  NativeFileSystemInstance(content::RenderProcessHost* host,
+                           base::SequencedWorkerPool* file_pool);
+  virtual ~NativeFileSystemInstance();
 
   // XWalkExtensionInstance implementation.
   virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE;
+  virtual void HandleRequest(int request_id,
+                             scoped_ptr<base::Value> msg) OVERRIDE;
 
  private:
+  void OnRequestDone(int request_id, scoped_ptr<base::Value> reply);
+  void OnPathChanged(int watch_id, bool error);
+
   XWalkExtensionFunctionHandler handler_;
   content::RenderProcessHost* host_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  scoped_refptr<FileSystemWatchers> watchers_;
+  base::WeakPtrFactory<NativeFileSystemInstance> weak_factory_;
 };
 
 class FileSystemChecker
@@ -9,6 +9,7 @@
 
 #include "base/lazy_instance.h"
 #include "base/macros.h"
+#include "base/strings/string_util.h"
 
 namespace {
 
@@ -20,8 +21,14 @@ VirtualRootProvider* VirtualRootProvider::GetInstance() {
   return g_lazy_instance.Pointer();
 }
 
-std::string VirtualRootProvider::GetRealPath(const std::string& virtual_root) {
-  return virtual_root_map_[virtual_root].AsUTF8Unsafe();
+std::string VirtualRootProvider::GetRealPath(
+    const std::string& virtual_root) const {
+  // Looked up without operator[], which used to add the unknown roots.
+  std::map<std::string, base::FilePath>::const_iterator it =
+      virtual_root_map_.find(StringToUpperASCII(virtual_root));
+  if (it == virtual_root_map_.end())
+    return std::string();
+  return it->second.AsUTF8Unsafe();
 }
 
 VirtualRootProvider::~VirtualRootProvider() {}
@@ -20,7 +20,10 @@ struct DefaultLazyInstanceTraits;
 class VirtualRootProvider {
  public:
   static VirtualRootProvider* GetInstance();
-  std::string GetRealPath(const std::string& virtual_root);
+  // |virtual_root| is case insensitive, e.g. "documents" or "DOCUMENTS".
+  // Returns an empty string for unknown roots. The roots are resolved once,
+  // when the provider is created, so this can be called from any thread.
+  std::string GetRealPath(const std::string& virtual_root) const;
 #if defined(OS_LINUX)
   static void SetTesting(bool test);
 #endif
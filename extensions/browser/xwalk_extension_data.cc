@@ -4,17 +4,19 @@
 
 #include "xwalk/extensions/browser/xwalk_extension_data.h"
 
-#include "content/public/browser/browser_thread.h"
-#include "xwalk/extensions/browser/xwalk_extension_process_host.h"
+#include "base/threading/thread.h"
 #include "xwalk/extensions/common/xwalk_extension_server.h"
 
-using content::BrowserThread;
-
 namespace xwalk {
 namespace extensions {
 
+XWalkExtensionData::IsolatedServer::IsolatedServer() : server(NULL) {}
+
+XWalkExtensionData::IsolatedServer::~IsolatedServer() {}
+
 XWalkExtensionData::XWalkExtensionData()
     : in_process_message_filter_(NULL),
+      extension_process_host_(NULL),
       extension_thread_(NULL),
       render_process_host_(NULL) {}
 
@@ -29,11 +31,21 @@ XWalkExtensionData::~XWalkExtensionData() {
   extension_thread_->message_loop()->DeleteSoon(
       FROM_HERE, in_process_extension_thread_server_.release());
 
-  if (extension_process_host_) {
-    BrowserThread::DeleteSoon(
-        BrowserThread::IO, FROM_HERE, extension_process_host_.release());
+  IsolatedServerVector::iterator it = isolated_servers_.begin();
+  for (; it != isolated_servers_.end(); ++it) {
+    it->server->Invalidate();
+    it->task_runner->DeleteSoon(FROM_HERE, it->server);
   }
 }
 
+void XWalkExtensionData::AddIsolatedServer(
+    scoped_ptr<XWalkExtensionServer> server,
+    scoped_refptr<base::SequencedTaskRunner> task_runner) {
+  IsolatedServer isolated;
+  isolated.server = server.release();
+  isolated.task_runner = task_runner;
+  isolated_servers_.push_back(isolated);
+}
+
 }  // namespace extensions
 }  // namespace xwalk
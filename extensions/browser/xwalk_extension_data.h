@@ -5,7 +5,11 @@
 #ifndef XWALK_EXTENSIONS_BROWSER_XWALK_EXTENSION_DATA_H_
 #define XWALK_EXTENSIONS_BROWSER_XWALK_EXTENSION_DATA_H_
 
+#include <vector>
+
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/sequenced_task_runner.h"
 
 namespace base {
 class Thread;
@@ -28,9 +32,24 @@ class XWalkExtensionServer;
 // to the extension process.
 class XWalkExtensionData {
  public:
+  // A server for a single extension that asked not to share the extension
+  // thread, see XWalkExtension::ExecutionModel.
+  struct IsolatedServer {
+    IsolatedServer();
+    ~IsolatedServer();
+
+    XWalkExtensionServer* server;
+    scoped_refptr<base::SequencedTaskRunner> task_runner;
+  };
+  typedef std::vector<IsolatedServer> IsolatedServerVector;
+
   XWalkExtensionData();
   ~XWalkExtensionData();
 
+  XWalkExtensionServer* in_process_extension_thread_server() {
+    return in_process_extension_thread_server_.get();
+  }
+
   XWalkExtensionServer* in_process_ui_thread_server() {
     return in_process_ui_thread_server_.get();
   }
@@ -39,8 +58,12 @@ class XWalkExtensionData {
     return in_process_message_filter_;
   }
 
-  scoped_ptr<XWalkExtensionProcessHost> extension_process_host() {
-    return extension_process_host_.Pass();
+  const IsolatedServerVector& isolated_servers() const {
+    return isolated_servers_;
+  }
+
+  XWalkExtensionProcessHost* extension_process_host() {
+    return extension_process_host_;
   }
 
   content::RenderProcessHost* render_process_host() {
@@ -57,14 +80,21 @@ class XWalkExtensionData {
     in_process_ui_thread_server_.reset(server.release());
   }
 
+  // |server| is deleted on |task_runner|.
+  void AddIsolatedServer(
+      scoped_ptr<XWalkExtensionServer> server,
+      scoped_refptr<base::SequencedTaskRunner> task_runner);
+
   // We don't take the ownership of the filter because filters are owned by
   // the IPC Channel they are filtering.
   void set_in_process_message_filter(ExtensionServerMessageFilter* filter) {
     in_process_message_filter_ = filter;
   }
 
-  void set_extension_process_host(scoped_ptr<XWalkExtensionProcessHost> host) {
-    extension_process_host_.reset(host.release());
+  // The host may be shared with other render processes, it is owned by the
+  // XWalkExtensionService.
+  void set_extension_process_host(XWalkExtensionProcessHost* host) {
+    extension_process_host_ = host;
   }
 
   void set_extension_thread(base::Thread* thread) {
@@ -79,12 +109,13 @@ class XWalkExtensionData {
   // Extension servers living on their respective threads.
   scoped_ptr<XWalkExtensionServer> in_process_extension_thread_server_;
   scoped_ptr<XWalkExtensionServer> in_process_ui_thread_server_;
+  IsolatedServerVector isolated_servers_;
 
   // This object lives on the IO-thread.
   ExtensionServerMessageFilter* in_process_message_filter_;
 
   // This object lives on the IO-thread.
-  scoped_ptr<XWalkExtensionProcessHost> extension_process_host_;
+  XWalkExtensionProcessHost* extension_process_host_;
 
   base::Thread* extension_thread_;
 
@@ -16,7 +16,21 @@ XWalkExtensionFunctionInfo::XWalkExtensionFunctionInfo(
     const PostResultCallback& post_result_cb)
   : name_(name),
     arguments_(arguments.Pass()),
-    post_result_cb_(post_result_cb) {}
+    post_result_cb_(post_result_cb),
+    post_partial_result_cb_(post_result_cb),
+    cancellation_token_(new XWalkExtensionCancellationToken) {}
+
+XWalkExtensionFunctionInfo::XWalkExtensionFunctionInfo(
+    const std::string& name,
+    scoped_ptr<base::ListValue> arguments,
+    const PostResultCallback& post_result_cb,
+    const PostResultCallback& post_partial_result_cb,
+    scoped_refptr<XWalkExtensionCancellationToken> cancellation_token)
+  : name_(name),
+    arguments_(arguments.Pass()),
+    post_result_cb_(post_result_cb),
+    post_partial_result_cb_(post_partial_result_cb),
+    cancellation_token_(cancellation_token) {}
 
 XWalkExtensionFunctionInfo::~XWalkExtensionFunctionInfo() {}
 
@@ -28,8 +42,22 @@ XWalkExtensionFunctionHandler::XWalkExtensionFunctionHandler(
 XWalkExtensionFunctionHandler::~XWalkExtensionFunctionHandler() {}
 
 void XWalkExtensionFunctionHandler::HandleMessage(scoped_ptr<base::Value> msg) {
-  base::ListValue* args;
-  if (!msg->GetAsList(&args) || args->GetSize() < 2) {
+  // Calls come as [function_name, callback_id, [arguments...]].
+  base::ListValue* envelope;
+  if (!msg->GetAsList(&envelope)) {
+    LOG(WARNING) << "The message is not a list.";
+    return;
+  }
+
+  // And cancellations as [callback_id].
+  int cancelled_callback_id;
+  if (envelope->GetSize() == 1 &&
+      envelope->GetInteger(0, &cancelled_callback_id)) {
+    CancelCall(cancelled_callback_id);
+    return;
+  }
+
+  if (envelope->GetSize() != 3) {
     // FIXME(tmpsantos): This warning could be better if the Context had a
     // pointer to the Extension. We could tell what extension sent the
     // invalid message.
@@ -37,37 +65,53 @@ void XWalkExtensionFunctionHandler::HandleMessage(scoped_ptr<base::Value> msg) {
     return;
   }
 
-  // The first parameter stands for the function signature.
   std::string function_name;
-  if (!args->GetString(0, &function_name)) {
+  if (!envelope->GetString(0, &function_name)) {
     LOG(WARNING) << "The function name is not a string.";
     return;
   }
 
-  // The second parameter stands for callback id, the remaining
-  // ones are the function arguments.
-  std::string callback_id;
-  if (!args->GetString(1, &callback_id)) {
-    LOG(WARNING) << "The callback id is not a string.";
+  // Zero stands for no callback.
+  int callback_id;
+  if (!envelope->GetInteger(1, &callback_id)) {
+    LOG(WARNING) << "The callback id is not an integer.";
     return;
   }
 
-  // We reuse args to pass the extra arguments to the handler, so remove
-  // function_name and callback_id from it.
-  args->Remove(0, NULL);
-  args->Remove(0, NULL);
+  // Removing the last element doesn't shift the list, and the arguments are
+  // handed over to the handler as they are.
+  scoped_ptr<base::Value> args;
+  if (!envelope->Remove(2, &args) || !args->IsType(base::Value::TYPE_LIST)) {
+    LOG(WARNING) << "The function arguments are not a list.";
+    return;
+  }
+
+  scoped_refptr<XWalkExtensionCancellationToken> cancellation_token(
+      new XWalkExtensionCancellationToken);
+  if (callback_id)
+    pending_calls_[callback_id] = cancellation_token;
 
   scoped_ptr<XWalkExtensionFunctionInfo> info(
       new XWalkExtensionFunctionInfo(
           function_name,
-          make_scoped_ptr(static_cast<base::ListValue*>(msg.release())),
+          make_scoped_ptr(static_cast<base::ListValue*>(args.release())),
+          base::Bind(&XWalkExtensionFunctionHandler::DispatchResult,
+                     weak_factory_.GetWeakPtr(),
+                     base::MessageLoopProxy::current(),
+                     callback_id,
+                     cancellation_token,
+                     false),
           base::Bind(&XWalkExtensionFunctionHandler::DispatchResult,
                      weak_factory_.GetWeakPtr(),
                      base::MessageLoopProxy::current(),
-                     callback_id)));
+                     callback_id,
+                     cancellation_token,
+                     true),
+          cancellation_token));
 
   if (!HandleFunction(info.Pass())) {
     DLOG(WARNING) << "Function not registered: " << function_name;
+    pending_calls_.erase(callback_id);
     return;
   }
 }
@@ -87,7 +131,9 @@ bool XWalkExtensionFunctionHandler::HandleFunction(
 void XWalkExtensionFunctionHandler::DispatchResult(
     const base::WeakPtr<XWalkExtensionFunctionHandler>& handler,
     scoped_refptr<base::MessageLoopProxy> client_task_runner,
-    const std::string& callback_id,
+    int callback_id,
+    scoped_refptr<XWalkExtensionCancellationToken> cancellation_token,
+    bool partial,
     scoped_ptr<base::ListValue> result) {
   DCHECK(result);
 
@@ -97,23 +143,50 @@ void XWalkExtensionFunctionHandler::DispatchResult(
                    handler,
                    client_task_runner,
                    callback_id,
+                   cancellation_token,
+                   partial,
                    base::Passed(&result)));
     return;
   }
 
-  if (callback_id.empty()) {
+  // The JavaScript side already forgot about the call.
+  if (cancellation_token->IsCancelled())
+    return;
+
+  if (!callback_id) {
     DLOG(WARNING) << "Sending a reply with an empty callback id has no"
         "practical effect. This code can be optimized by not creating "
         "and not posting the result.";
     return;
   }
 
-  // Prepend the callback id to the list, so the handlers
-  // on the JavaScript side know which callback should be evoked.
-  result->Insert(0, new base::StringValue(callback_id));
+  // Replies go as [callback_id, [results...]], so the handlers on the
+  // JavaScript side know which callback should be evoked. Wrapping the
+  // results saves shifting them.
+  scoped_ptr<base::ListValue> reply(new base::ListValue);
+  reply->AppendInteger(callback_id);
+  reply->Append(result.release());
+  if (partial)
+    reply->AppendBoolean(true);
+
+  if (!handler)
+    return;
+  // The callback id may already be reused by a newer call.
+  if (!partial) {
+    PendingCallMap::iterator it = handler->pending_calls_.find(callback_id);
+    if (it != handler->pending_calls_.end() &&
+        it->second.get() == cancellation_token.get())
+      handler->pending_calls_.erase(it);
+  }
+  handler->PostMessageToInstance(reply.PassAs<base::Value>());
+}
 
-  if (handler)
-    handler->PostMessageToInstance(result.PassAs<base::Value>());
+void XWalkExtensionFunctionHandler::CancelCall(int callback_id) {
+  PendingCallMap::iterator it = pending_calls_.find(callback_id);
+  if (it == pending_calls_.end())
+    return;
+  it->second->Cancel();
+  pending_calls_.erase(it);
 }
 
 void XWalkExtensionFunctionHandler::PostMessageToInstance(
@@ -8,8 +8,11 @@
 #include <map>
 #include <string>
 #include "base/bind.h"
+#include "base/containers/hash_tables.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/synchronization/cancellation_flag.h"
 #include "base/values.h"
 
 namespace xwalk {
@@ -17,6 +20,28 @@ namespace extensions {
 
 class XWalkExtensionInstance;
 
+// Set once the JavaScript side isn't interested anymore in the results of a
+// call, e.g. a stream of results was cancelled. Long running functions can
+// check it from any thread to stop early, the results they post afterwards
+// are dropped.
+class XWalkExtensionCancellationToken
+    : public base::RefCountedThreadSafe<XWalkExtensionCancellationToken> {
+ public:
+  XWalkExtensionCancellationToken() {}
+
+  // Must be called on the thread the token was created on.
+  void Cancel() { flag_.Set(); }
+  bool IsCancelled() const { return flag_.IsSet(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<XWalkExtensionCancellationToken>;
+  ~XWalkExtensionCancellationToken() {}
+
+  base::CancellationFlag flag_;
+
+  DISALLOW_COPY_AND_ASSIGN(XWalkExtensionCancellationToken);
+};
+
 // This struct is passed to the function handler, usually assigned to the
 // signature of a method in JavaScript. The struct can be safely passed around.
 class XWalkExtensionFunctionInfo {
@@ -24,9 +49,16 @@ class XWalkExtensionFunctionInfo {
   typedef base::Callback<void(scoped_ptr<base::ListValue> result)>
       PostResultCallback;
 
+  // Partial results are posted like the last one.
   XWalkExtensionFunctionInfo(const std::string& name,
                              scoped_ptr<base::ListValue> arguments,
                              const PostResultCallback& post_result_cb);
+  XWalkExtensionFunctionInfo(
+      const std::string& name,
+      scoped_ptr<base::ListValue> arguments,
+      const PostResultCallback& post_result_cb,
+      const PostResultCallback& post_partial_result_cb,
+      scoped_refptr<XWalkExtensionCancellationToken> cancellation_token);
 
   ~XWalkExtensionFunctionInfo();
 
@@ -39,7 +71,21 @@ class XWalkExtensionFunctionInfo {
     post_result_cb_.Run(result.Pass());
   };
 
-  std::string name() const {
+  // Streams a result without ending the call, for functions producing their
+  // results over time, e.g. file scans or sensor reads. Many partial results
+  // can be posted, the call ends with the PostResult() of the last one. Can
+  // be called from any thread.
+  void PostPartialResult(scoped_ptr<base::ListValue> result) const {
+    post_partial_result_cb_.Run(result.Pass());
+  };
+
+  // Whether the JavaScript side cancelled the call. Can be called from any
+  // thread.
+  bool IsCancelled() const {
+    return cancellation_token_->IsCancelled();
+  }
+
+  const std::string& name() const {
     return name_;
   }
 
@@ -51,11 +97,21 @@ class XWalkExtensionFunctionInfo {
     return post_result_cb_;
   }
 
+  PostResultCallback post_partial_result_cb() const {
+    return post_partial_result_cb_;
+  }
+
+  scoped_refptr<XWalkExtensionCancellationToken> cancellation_token() const {
+    return cancellation_token_;
+  }
+
  private:
   std::string name_;
   scoped_ptr<base::ListValue> arguments_;
 
   PostResultCallback post_result_cb_;
+  PostResultCallback post_partial_result_cb_;
+  scoped_refptr<XWalkExtensionCancellationToken> cancellation_token_;
 
   DISALLOW_COPY_AND_ASSIGN(XWalkExtensionFunctionInfo);
 };
@@ -73,7 +129,14 @@ class XWalkExtensionFunctionHandler {
   ~XWalkExtensionFunctionHandler();
 
   // Converts a raw message from the renderer to a XWalkExtensionFunctionInfo
-  // data structure and invokes HandleFunction().
+  // data structure and invokes HandleFunction(). The message is the envelope
+  // built by postMessage() of the internal JavaScript API:
+  // [function_name, callback_id, [arguments...]], with an integer
+  // |callback_id| that is zero when no reply is expected. The replies go as
+  // [callback_id, [results...]], followed by true for partial results.
+  //
+  // A call still waiting for its last result is cancelled with a
+  // [callback_id] message, sent by cancelCall() of the internal API.
   void HandleMessage(scoped_ptr<base::Value> msg);
 
   // Executes the handler associated to the |name| tag of the |info| argument
@@ -87,7 +150,8 @@ class XWalkExtensionFunctionHandler {
   // contains the list of parameters ready to be used as input for
   // Params::Create() generated from the IDL description of the API. The reply,
   // if necessary, should be posted back using the PostResult() method of the
-  // XWalkExtensionFunctionInfo provided.
+  // XWalkExtensionFunctionInfo provided, preceded by PostPartialResult() for
+  // functions streaming their results.
   //
   // The signature of a function handler should be like the following:
   //
@@ -106,14 +170,24 @@ class XWalkExtensionFunctionHandler {
   static void DispatchResult(
       const base::WeakPtr<XWalkExtensionFunctionHandler>& handler,
       scoped_refptr<base::MessageLoopProxy> client_task_runner,
-      const std::string& callback_id,
+      int callback_id,
+      scoped_refptr<XWalkExtensionCancellationToken> cancellation_token,
+      bool partial,
       scoped_ptr<base::ListValue> result);
 
+  void CancelCall(int callback_id);
   void PostMessageToInstance(scoped_ptr<base::Value> msg);
 
-  typedef std::map<std::string, FunctionHandler> FunctionHandlerMap;
+  // Looked up for every message, a hash table keeps that cheap for objects
+  // with many functions.
+  typedef base::hash_map<std::string, FunctionHandler> FunctionHandlerMap;
   FunctionHandlerMap handlers_;
 
+  // The calls waiting for their last result, by callback id.
+  typedef std::map<int, scoped_refptr<XWalkExtensionCancellationToken> >
+      PendingCallMap;
+  PendingCallMap pending_calls_;
+
   XWalkExtensionInstance* instance_;
   base::WeakPtrFactory<XWalkExtensionFunctionHandler> weak_factory_;
 
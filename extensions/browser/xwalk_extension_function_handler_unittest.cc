@@ -112,7 +112,8 @@ TEST(XWalkExtensionFunctionHandlerTest, PostingResultAfterDeletingTheHandler) {
 
   scoped_ptr<base::ListValue> msg(new base::ListValue);
   msg->AppendString("storeFunctionInfo");  // Function name.
-  msg->AppendString("id");  // Callback ID.
+  msg->AppendInteger(1);  // Callback ID.
+  msg->Append(new base::ListValue);  // Arguments.
 
   handler->HandleMessage(msg.PassAs<base::Value>());
   handler.reset();
@@ -123,3 +124,76 @@ TEST(XWalkExtensionFunctionHandlerTest, PostingResultAfterDeletingTheHandler) {
   info->PostResult(make_scoped_ptr(new base::ListValue));
   delete info;
 }
+
+TEST(XWalkExtensionFunctionHandlerTest, HandleMessageEnvelope) {
+  XWalkExtensionFunctionHandler handler(NULL);
+
+  XWalkExtensionFunctionInfo* info = NULL;
+  handler.Register("storeFunctionInfo", base::Bind(&StoreFunctionInfo, &info));
+
+  scoped_ptr<base::ListValue> args(new base::ListValue);
+  args->AppendString(kTestString);
+
+  scoped_ptr<base::ListValue> msg(new base::ListValue);
+  msg->AppendString("storeFunctionInfo");
+  msg->AppendInteger(0);
+  msg->Append(args.release());
+  handler.HandleMessage(msg.PassAs<base::Value>());
+
+  // The handler gets the arguments list as it was sent.
+  ASSERT_TRUE(info);
+  std::string str;
+  ASSERT_EQ(1u, info->arguments()->GetSize());
+  EXPECT_TRUE(info->arguments()->GetString(0, &str));
+  EXPECT_EQ(str, kTestString);
+  delete info;
+  info = NULL;
+
+  // The old flat format with a string callback ID is refused.
+  msg.reset(new base::ListValue);
+  msg->AppendString("storeFunctionInfo");
+  msg->AppendString("1");
+  msg->AppendString(kTestString);
+  handler.HandleMessage(msg.PassAs<base::Value>());
+  EXPECT_FALSE(info);
+
+  // And so are arguments not wrapped in a list.
+  msg.reset(new base::ListValue);
+  msg->AppendString("storeFunctionInfo");
+  msg->AppendInteger(1);
+  msg->AppendString(kTestString);
+  handler.HandleMessage(msg.PassAs<base::Value>());
+  EXPECT_FALSE(info);
+}
+
+TEST(XWalkExtensionFunctionHandlerTest, CancelCall) {
+  XWalkExtensionFunctionHandler handler(NULL);
+
+  XWalkExtensionFunctionInfo* info = NULL;
+  handler.Register("storeFunctionInfo", base::Bind(&StoreFunctionInfo, &info));
+
+  scoped_ptr<base::ListValue> msg(new base::ListValue);
+  msg->AppendString("storeFunctionInfo");
+  msg->AppendInteger(1);
+  msg->Append(new base::ListValue);
+  handler.HandleMessage(msg.PassAs<base::Value>());
+  ASSERT_TRUE(info);
+  EXPECT_FALSE(info->IsCancelled());
+
+  // Cancelling another call has no effect.
+  msg.reset(new base::ListValue);
+  msg->AppendInteger(2);
+  handler.HandleMessage(msg.PassAs<base::Value>());
+  EXPECT_FALSE(info->IsCancelled());
+
+  msg.reset(new base::ListValue);
+  msg->AppendInteger(1);
+  handler.HandleMessage(msg.PassAs<base::Value>());
+  EXPECT_TRUE(info->IsCancelled());
+
+  // The results of a cancelled call never reach the instance, which would
+  // crash here.
+  info->PostPartialResult(make_scoped_ptr(new base::ListValue));
+  info->PostResult(make_scoped_ptr(new base::ListValue));
+  delete info;
+}
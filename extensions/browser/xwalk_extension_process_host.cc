@@ -5,12 +5,16 @@
 #include "xwalk/extensions/browser/xwalk_extension_process_host.h"
 
 #include <string>
+#include <vector>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/logging.h"
 #include "base/files/file_path.h"
+#include "base/metrics/histogram.h"
 #include "content/public/browser/browser_child_process_host.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/child_process_data.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/common/child_process_host.h"
 #include "content/public/common/process_type.h"
@@ -33,15 +37,18 @@ namespace extensions {
 class XWalkExtensionProcessHost::RenderProcessMessageFilter
     : public IPC::MessageFilter {
  public:
-  explicit RenderProcessMessageFilter(XWalkExtensionProcessHost* eph)
-      : eph_(eph) {}
+  RenderProcessMessageFilter(XWalkExtensionProcessHost* eph,
+                             content::RenderProcessHost* render_process_host)
+      : eph_(eph),
+        render_process_host_(render_process_host),
+        render_process_id_(render_process_host->GetID()) {}
 
   // This exists to fulfill the requirement for delayed reply handling, since it
   // needs to send a message back if the parameters couldn't be correctly read
   // from the original message received. See DispatchDealyReplyWithSendParams().
   bool Send(IPC::Message* message) {
     if (eph_)
-      return eph_->render_process_host_->Send(message);
+      return render_process_host_->Send(message);
     delete message;
     return false;
   }
@@ -53,6 +60,11 @@ class XWalkExtensionProcessHost::RenderProcessMessageFilter
  private:
   // IPC::ChannelProxy::MessageFilter implementation.
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    // Left on the channel once the Extension Process died, the host that
+    // replaced it answers instead.
+    if (!eph_)
+      return false;
+
     bool handled = true;
     IPC_BEGIN_MESSAGE_MAP(RenderProcessMessageFilter, message)
       IPC_MESSAGE_HANDLER_DELAY_REPLY(
@@ -66,12 +78,15 @@ class XWalkExtensionProcessHost::RenderProcessMessageFilter
   void OnGetExtensionProcessChannel(IPC::Message* reply) {
     scoped_ptr<IPC::Message> scoped_reply(reply);
     if (eph_)
-      eph_->OnGetExtensionProcessChannel(scoped_reply.Pass());
+      eph_->OnGetExtensionProcessChannel(render_process_id_,
+                                         scoped_reply.Pass());
   }
 
   virtual ~RenderProcessMessageFilter() {}
 
   XWalkExtensionProcessHost* eph_;
+  content::RenderProcessHost* render_process_host_;
+  int render_process_id_;
 };
 
 class ExtensionSandboxedProcessLauncherDelegate
@@ -110,19 +125,36 @@ bool XWalkExtensionProcessHost::Delegate::OnRegisterPermissions(
   return false;
 }
 
+XWalkExtensionProcessHost::RenderProcessState::RenderProcessState()
+    : render_process_host(NULL),
+      channel_handle(""),
+      is_channel_ready(false) {}
+
+XWalkExtensionProcessHost::RenderProcessState::~RenderProcessState() {}
+
 XWalkExtensionProcessHost::XWalkExtensionProcessHost(
     content::RenderProcessHost* render_process_host,
     const base::FilePath& external_extensions_path,
     XWalkExtensionProcessHost::Delegate* delegate,
     scoped_ptr<base::ValueMap> runtime_variables)
-    : ep_rp_channel_handle_(""),
-      render_process_host_(render_process_host),
-      render_process_message_filter_(new RenderProcessMessageFilter(this)),
+    : process_handle_(base::kNullProcessHandle),
+      first_render_process_id_(render_process_host->GetID()),
       external_extensions_path_(external_extensions_path),
-      is_extension_process_channel_ready_(false),
-      delegate_(delegate),
-      runtime_variables_(runtime_variables.Pass()) {
-  render_process_host_->GetChannel()->AddFilter(render_process_message_filter_);
+      delegate_(delegate) {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&XWalkExtensionProcessHost::StartProcess,
+      base::Unretained(this)));
+  RegisterExtensions(runtime_variables.Pass());
+  AddRenderProcess(render_process_host);
+}
+
+XWalkExtensionProcessHost::XWalkExtensionProcessHost(
+    const base::FilePath& external_extensions_path,
+    XWalkExtensionProcessHost::Delegate* delegate)
+    : process_handle_(base::kNullProcessHandle),
+      first_render_process_id_(content::ChildProcessHost::kInvalidUniqueID),
+      external_extensions_path_(external_extensions_path),
+      delegate_(delegate) {
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
       base::Bind(&XWalkExtensionProcessHost::StartProcess,
       base::Unretained(this)));
@@ -130,10 +162,94 @@ XWalkExtensionProcessHost::XWalkExtensionProcessHost(
 
 XWalkExtensionProcessHost::~XWalkExtensionProcessHost() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
-  render_process_message_filter_->Invalidate();
+  RenderProcessStateMap::iterator it = render_processes_.begin();
+  for (; it != render_processes_.end(); ++it)
+    it->second->filter->Invalidate();
   StopProcess();
 }
 
+void XWalkExtensionProcessHost::RegisterExtensions(
+    scoped_ptr<base::ValueMap> runtime_variables) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&XWalkExtensionProcessHost::RegisterExtensionsOnIO,
+      base::Unretained(this), base::Passed(&runtime_variables)));
+}
+
+void XWalkExtensionProcessHost::AddRenderProcess(
+    content::RenderProcessHost* render_process_host) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (first_render_process_id_ == content::ChildProcessHost::kInvalidUniqueID)
+    first_render_process_id_ = render_process_host->GetID();
+
+  scoped_refptr<RenderProcessMessageFilter> filter(
+      new RenderProcessMessageFilter(this, render_process_host));
+  render_process_host->GetChannel()->AddFilter(filter);
+
+  // Posted after RegisterExtensions(), so the Extension Process already got
+  // the extensions to register when it is asked for the new channel.
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&XWalkExtensionProcessHost::AddRenderProcessOnIO,
+      base::Unretained(this), render_process_host, filter,
+      base::TimeTicks::Now()));
+}
+
+void XWalkExtensionProcessHost::RemoveRenderProcess(int render_process_id) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&XWalkExtensionProcessHost::RemoveRenderProcessOnIO,
+      base::Unretained(this), render_process_id));
+}
+
+void XWalkExtensionProcessHost::ClearPermissionCache() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(base::IgnoreResult(&XWalkExtensionProcessHost::Send),
+      base::Unretained(this),
+      new XWalkExtensionProcessMsg_ClearPermissionCache));
+}
+
+void XWalkExtensionProcessHost::AddRenderProcessOnIO(
+    content::RenderProcessHost* render_process_host,
+    scoped_refptr<RenderProcessMessageFilter> filter,
+    base::TimeTicks attach_time) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  const int render_process_id = render_process_host->GetID();
+  linked_ptr<RenderProcessState>& state = render_processes_[render_process_id];
+
+  // The RP may have asked for the channel before this task got to run.
+  if (!state.get())
+    state.reset(new RenderProcessState);
+  state->render_process_host = render_process_host;
+  state->attach_time = attach_time;
+  state->filter = filter;
+
+  Send(new XWalkExtensionProcessMsg_CreateRenderProcessChannel(
+      render_process_id));
+}
+
+void XWalkExtensionProcessHost::RemoveRenderProcessOnIO(
+    int render_process_id) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  RenderProcessStateMap::iterator it =
+      render_processes_.find(render_process_id);
+  if (it == render_processes_.end())
+    return;
+
+  if (it->second->filter)
+    it->second->filter->Invalidate();
+  render_processes_.erase(it);
+
+  Send(new XWalkExtensionProcessMsg_CloseRenderProcessChannel(
+      render_process_id));
+}
+
+int XWalkExtensionProcessHost::GetAnyRenderProcessID() const {
+  if (render_processes_.empty())
+    return first_render_process_id_;
+  return render_processes_.begin()->first;
+}
+
 namespace {
 
 void ToListValue(base::ValueMap* vm, base::ListValue* lv) {
@@ -165,7 +281,7 @@ void XWalkExtensionProcessHost::StartProcess() {
         BrowserThread::UI, FROM_HERE,
         base::Bind(
             &XWalkExtensionProcessHost::Delegate::OnExtensionProcessCreated,
-            base::Unretained(delegate_), render_process_host_->GetID(),
+            base::Unretained(delegate_), first_render_process_id_,
             channel_handle));
 #else
     NOTIMPLEMENTED();
@@ -207,6 +323,12 @@ void XWalkExtensionProcessHost::StartProcess() {
         new ExtensionSandboxedProcessLauncherDelegate(process_->GetHost()),
         cmd_line.release());
 #endif  // #if defined(SHARED_PROCESS_MODE)
+}
+
+void XWalkExtensionProcessHost::RegisterExtensionsOnIO(
+    scoped_ptr<base::ValueMap> runtime_variables) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  runtime_variables_ = runtime_variables.Pass();
 
   base::ListValue runtime_variables_lv;
   ToListValue(&const_cast<base::ValueMap&>(*runtime_variables_),
@@ -216,6 +338,10 @@ void XWalkExtensionProcessHost::StartProcess() {
 }
 
 void XWalkExtensionProcessHost::StopProcess() {
+  {
+    base::AutoLock lock(process_handle_lock_);
+    process_handle_ = base::kNullProcessHandle;
+  }
   if (process_)
     process_.reset();
   if (channel_)
@@ -223,9 +349,12 @@ void XWalkExtensionProcessHost::StopProcess() {
 }
 
 void XWalkExtensionProcessHost::OnGetExtensionProcessChannel(
-    scoped_ptr<IPC::Message> reply) {
-  pending_reply_for_render_process_ = reply.Pass();
-  ReplyChannelHandleToRenderProcess();
+    int render_process_id, scoped_ptr<IPC::Message> reply) {
+  linked_ptr<RenderProcessState>& state = render_processes_[render_process_id];
+  if (!state.get())
+    state.reset(new RenderProcessState);
+  state->pending_reply = reply.Pass();
+  ReplyChannelHandleToRenderProcess(state.get());
 }
 
 bool XWalkExtensionProcessHost::OnMessageReceived(const IPC::Message& message) {
@@ -240,6 +369,12 @@ bool XWalkExtensionProcessHost::OnMessageReceived(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(
         XWalkExtensionProcessHostMsg_RegisterPermissions,
         OnRegisterPermissions)
+    IPC_MESSAGE_HANDLER(
+        XWalkExtensionProcessHostMsg_CheckAPIAccessControlAsync,
+        OnCheckAPIAccessControlAsync)
+    IPC_MESSAGE_HANDLER(
+        XWalkExtensionProcessHostMsg_RegisterPermissionsBatch,
+        OnRegisterPermissionsBatch)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
@@ -255,36 +390,68 @@ void XWalkExtensionProcessHost::OnChannelError() {
   // most likely have a pointer to us that needs to be invalidated.
 
   VLOG(1) << "\n\nExtensionProcess crashed";
-  if (delegate_)
-    delegate_->OnExtensionProcessDied(this, render_process_host_->GetID());
+  if (!delegate_)
+    return;
+
+  // A pre-warmed process died before being handed to any Render Process.
+  if (render_processes_.empty()) {
+    delegate_->OnExtensionProcessDied(
+        this, content::ChildProcessHost::kInvalidUniqueID);
+    return;
+  }
+
+  std::vector<int> render_process_ids;
+  RenderProcessStateMap::const_iterator it = render_processes_.begin();
+  for (; it != render_processes_.end(); ++it)
+    render_process_ids.push_back(it->first);
+
+  for (size_t i = 0; i < render_process_ids.size(); ++i)
+    delegate_->OnExtensionProcessDied(this, render_process_ids[i]);
 }
 
 void XWalkExtensionProcessHost::OnProcessLaunched() {
   VLOG(1) << "\n\nExtensionProcess was started!";
+  base::AutoLock lock(process_handle_lock_);
+  process_handle_ = process_->GetData().handle;
+}
+
+base::ProcessHandle XWalkExtensionProcessHost::GetProcessHandle() const {
+  base::AutoLock lock(process_handle_lock_);
+  return process_handle_;
 }
 
 void XWalkExtensionProcessHost::OnRenderChannelCreated(
-    const IPC::ChannelHandle& handle) {
-  is_extension_process_channel_ready_ = true;
-  ep_rp_channel_handle_ = handle;
-  ReplyChannelHandleToRenderProcess();
+    int render_process_id, const IPC::ChannelHandle& handle) {
+  RenderProcessStateMap::iterator it =
+      render_processes_.find(render_process_id);
+  // The RP may have gone away while the channel was being created.
+  if (it == render_processes_.end())
+    return;
+
+  it->second->is_channel_ready = true;
+  it->second->channel_handle = handle;
+  ReplyChannelHandleToRenderProcess(it->second.get());
 }
 
-void XWalkExtensionProcessHost::ReplyChannelHandleToRenderProcess() {
+void XWalkExtensionProcessHost::ReplyChannelHandleToRenderProcess(
+    RenderProcessState* state) {
   // Replying the channel handle to RP depends on two events:
   // - EP already notified EPH that new channel was created (for RP<->EP).
   // - RP already asked for the channel handle.
   //
   // The order for this events is not determined, so we call this function from
   // both, and the second execution will send the reply.
-  if (!is_extension_process_channel_ready_
-      || !pending_reply_for_render_process_)
+  if (!state->is_channel_ready || !state->pending_reply ||
+      !state->render_process_host)
     return;
 
   XWalkExtensionProcessHostMsg_GetExtensionProcessChannel::WriteReplyParams(
-      pending_reply_for_render_process_.get(), ep_rp_channel_handle_);
+      state->pending_reply.get(), state->channel_handle);
 
-  render_process_host_->Send(pending_reply_for_render_process_.release());
+  UMA_HISTOGRAM_TIMES("XWalk.ExtensionProcess.TimeToChannelReady",
+                      base::TimeTicks::Now() - state->attach_time);
+
+  state->render_process_host->Send(state->pending_reply.release());
 }
 
 void XWalkExtensionProcessHost::ReplyAccessControlToExtension(
@@ -299,7 +466,7 @@ void XWalkExtensionProcessHost::OnCheckAPIAccessControl(
     const std::string& extension_name,
     const std::string& api_name, IPC::Message* reply_msg) {
   CHECK(delegate_);
-  delegate_->OnCheckAPIAccessControl(render_process_host_->GetID(),
+  delegate_->OnCheckAPIAccessControl(GetAnyRenderProcessID(),
                                      extension_name, api_name,
       base::Bind(&XWalkExtensionProcessHost::ReplyAccessControlToExtension,
                  base::Unretained(this),
@@ -311,7 +478,41 @@ void XWalkExtensionProcessHost::OnRegisterPermissions(
     const std::string& perm_table, bool* result) {
   CHECK(delegate_);
   *result = delegate_->OnRegisterPermissions(
-      render_process_host_->GetID(), extension_name, perm_table);
+      GetAnyRenderProcessID(), extension_name, perm_table);
+}
+
+void XWalkExtensionProcessHost::OnCheckAPIAccessControlAsync(
+    int request_id, const std::string& extension_name,
+    const std::string& api_name) {
+  CHECK(delegate_);
+  delegate_->OnCheckAPIAccessControl(GetAnyRenderProcessID(),
+                                     extension_name, api_name,
+      base::Bind(&XWalkExtensionProcessHost::ReplyAsyncAccessControlToExtension,
+                 base::Unretained(this),
+                 request_id));
+}
+
+void XWalkExtensionProcessHost::ReplyAsyncAccessControlToExtension(
+    int request_id, RuntimePermission perm) {
+  Send(new XWalkExtensionProcessMsg_APIAccessControlChecked(request_id, perm));
+}
+
+void XWalkExtensionProcessHost::OnRegisterPermissionsBatch(
+    int request_id, const std::vector<std::string>& extension_names,
+    const std::vector<std::string>& perm_tables) {
+  CHECK(delegate_);
+  // A malformed batch is answered with no results, which fails all of its
+  // registrations.
+  std::vector<bool> results;
+  if (extension_names.size() == perm_tables.size()) {
+    int render_process_id = GetAnyRenderProcessID();
+    for (size_t i = 0; i < extension_names.size(); ++i) {
+      results.push_back(delegate_->OnRegisterPermissions(
+          render_process_id, extension_names[i], perm_tables[i]));
+    }
+  }
+  Send(new XWalkExtensionProcessMsg_PermissionsRegistered(request_id,
+                                                          results));
 }
 
 bool XWalkExtensionProcessHost::Send(IPC::Message* msg) {
@@ -5,11 +5,17 @@
 #ifndef XWALK_EXTENSIONS_BROWSER_XWALK_EXTENSION_PROCESS_HOST_H_
 #define XWALK_EXTENSIONS_BROWSER_XWALK_EXTENSION_PROCESS_HOST_H_
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
+#include "base/memory/linked_ptr.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_child_process_host_delegate.h"
 #include "ipc/ipc_channel_handle.h"
@@ -28,6 +34,10 @@ namespace extensions {
 // This class represents the browser side of the browser <-> extension process
 // communication channel. It has to run some operations in IO thread for
 // creating the extra process.
+//
+// A single Extension Process can serve several Render Processes (e.g. all the
+// renderers of the same application), each one gets its own channel to the
+// Extension Process but the external extensions are only loaded once.
 class XWalkExtensionProcessHost
     : public content::BrowserChildProcessHostDelegate,
       public IPC::Sender {
@@ -49,24 +59,79 @@ class XWalkExtensionProcessHost
     ~Delegate() {}
   };
 
+  // |render_process_host| is the first Render Process served by this
+  // Extension Process, others can be attached later by AddRenderProcess().
   XWalkExtensionProcessHost(content::RenderProcessHost* render_process_host,
                             const base::FilePath& external_extensions_path,
                             XWalkExtensionProcessHost::Delegate* delegate,
                             scoped_ptr<base::ValueMap> runtime_variables);
+
+  // Launches a pre-warmed Extension Process that is not serving any Render
+  // Process yet. RegisterExtensions() and AddRenderProcess() should be called
+  // once the process is handed to a Render Process.
+  XWalkExtensionProcessHost(const base::FilePath& external_extensions_path,
+                            XWalkExtensionProcessHost::Delegate* delegate);
   virtual ~XWalkExtensionProcessHost();
 
+  // Asks the Extension Process to load the external extensions. Must be called
+  // on the UI thread, before the first AddRenderProcess() of a pre-warmed
+  // host.
+  void RegisterExtensions(scoped_ptr<base::ValueMap> runtime_variables);
+
+  // Attaches and detaches Render Processes to this Extension Process. Must be
+  // called on the UI thread.
+  void AddRenderProcess(content::RenderProcessHost* render_process_host);
+  void RemoveRenderProcess(int render_process_id);
+
+  // Drops the access control decisions cached by the Extension Process. Must
+  // be called on the UI thread.
+  void ClearPermissionCache();
+
+  // The Extension Process, base::kNullProcessHandle until it is launched.
+  // Can be called on any thread.
+  base::ProcessHandle GetProcessHandle() const;
+
   // IPC::Sender implementation
   virtual bool Send(IPC::Message* msg) OVERRIDE;
 
  private:
   class RenderProcessMessageFilter;
 
+  // State of each Render Process attached to this Extension Process. Only
+  // accessed on the IO thread.
+  struct RenderProcessState {
+    RenderProcessState();
+    ~RenderProcessState();
+
+    content::RenderProcessHost* render_process_host;
+    // When the Render Process was attached, used to measure how long it
+    // waits for its channel.
+    base::TimeTicks attach_time;
+    scoped_refptr<RenderProcessMessageFilter> filter;
+    IPC::ChannelHandle channel_handle;
+    scoped_ptr<IPC::Message> pending_reply;
+    bool is_channel_ready;
+  };
+
   void StartProcess();
   void StopProcess();
 
+  void RegisterExtensionsOnIO(scoped_ptr<base::ValueMap> runtime_variables);
+
+  void AddRenderProcessOnIO(
+      content::RenderProcessHost* render_process_host,
+      scoped_refptr<RenderProcessMessageFilter> filter,
+      base::TimeTicks attach_time);
+  void RemoveRenderProcessOnIO(int render_process_id);
+
   // Handler for message from Render Process host, it is a synchronous message,
   // that will be replied only when the extension process channel is created.
-  void OnGetExtensionProcessChannel(scoped_ptr<IPC::Message> reply);
+  void OnGetExtensionProcessChannel(int render_process_id,
+                                    scoped_ptr<IPC::Message> reply);
+
+  // Permissions are per application, and all the Render Processes sharing an
+  // Extension Process belong to the same one, so any of them will do.
+  int GetAnyRenderProcessID() const;
 
   // content::BrowserChildProcessHostDelegate implementation.
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
@@ -74,9 +139,10 @@ class XWalkExtensionProcessHost
   virtual void OnProcessLaunched() OVERRIDE;
 
   // Message Handlers.
-  void OnRenderChannelCreated(const IPC::ChannelHandle& channel_id);
+  void OnRenderChannelCreated(int render_process_id,
+                              const IPC::ChannelHandle& channel_id);
 
-  void ReplyChannelHandleToRenderProcess();
+  void ReplyChannelHandleToRenderProcess(RenderProcessState* state);
 
   void OnCheckAPIAccessControl(const std::string& extension_name,
       const std::string& api_name, IPC::Message* reply_msg);
@@ -84,24 +150,36 @@ class XWalkExtensionProcessHost
       RuntimePermission perm);
   void OnRegisterPermissions(const std::string& extension_name,
       const std::string& perm_table, bool* result);
+  void OnCheckAPIAccessControlAsync(int request_id,
+      const std::string& extension_name, const std::string& api_name);
+  void ReplyAsyncAccessControlToExtension(int request_id,
+      RuntimePermission perm);
+  void OnRegisterPermissionsBatch(int request_id,
+      const std::vector<std::string>& extension_names,
+      const std::vector<std::string>& perm_tables);
 
   scoped_ptr<content::BrowserChildProcessHost> process_;
-  IPC::ChannelHandle ep_rp_channel_handle_;
-  content::RenderProcessHost* render_process_host_;
-  scoped_ptr<IPC::Message> pending_reply_for_render_process_;
 
-  // We use this filter to know when RP asked for the extension process channel.
-  // We keep the reference to invalidate the filter once we don't need it
-  // anymore.
+  // Copy of the handle of |process_|, which is only accessed on the IO
+  // thread.
+  mutable base::Lock process_handle_lock_;
+  base::ProcessHandle process_handle_;
+
+  // Render Process used to notify the launcher in shared process mode. Stays
+  // invalid for a pre-warmed host until it is handed to a Render Process.
+  int first_render_process_id_;
+
+  // For each RP we use a filter to know when it asked for the extension
+  // process channel. We keep the reference to invalidate the filter once we
+  // don't need it anymore.
   //
   // TODO(cmarcelo): Avoid having an extra filter, see if we can embed this
   // handling in the existing filter we have in ExtensionData struct.
-  scoped_refptr<RenderProcessMessageFilter> render_process_message_filter_;
+  typedef std::map<int, linked_ptr<RenderProcessState> > RenderProcessStateMap;
+  RenderProcessStateMap render_processes_;
 
   base::FilePath external_extensions_path_;
 
-  bool is_extension_process_channel_ready_;
-
   XWalkExtensionProcessHost::Delegate* delegate_;
 
   scoped_ptr<base::ValueMap> runtime_variables_;
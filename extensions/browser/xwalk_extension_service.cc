@@ -4,13 +4,16 @@
 
 #include "xwalk/extensions/browser/xwalk_extension_service.h"
 
-#include <set>
 #include <vector>
 #include "base/callback.h"
 #include "base/command_line.h"
+#include "base/containers/hash_tables.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
 #include "base/pickle.h"
 #include "base/scoped_native_library.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/notification_types.h"
 #include "content/public/browser/notification_service.h"
@@ -20,6 +23,7 @@
 #include "xwalk/extensions/browser/xwalk_extension_data.h"
 #include "xwalk/extensions/browser/xwalk_extension_process_host.h"
 #include "xwalk/extensions/common/xwalk_extension.h"
+#include "xwalk/extensions/common/xwalk_extension_catalog.h"
 #include "xwalk/extensions/common/xwalk_extension_messages.h"
 #include "xwalk/extensions/common/xwalk_extension_server.h"
 #include "xwalk/extensions/common/xwalk_extension_switches.h"
@@ -39,6 +43,43 @@ XWalkExtensionService::CreateExtensionsCallback
 
 base::FilePath g_external_extensions_path_for_testing_;
 
+// An Extension Process crashing more than this in a row isn't restarted
+// anymore. Crashes stop being in a row after the process ran long enough.
+const int kMaxExtensionProcessRestarts = 5;
+const int kCrashLoopResetSeconds = 60;
+// Doubled for each crash in a row.
+const int kExtensionProcessRestartDelayMs = 250;
+
+std::string GetExtensionProcessPoolKey(const base::ValueMap& variables) {
+  base::DictionaryValue dict;
+  base::ValueMap::const_iterator it = variables.begin();
+  for (; it != variables.end(); ++it)
+    dict.Set(it->first, it->second->DeepCopy());
+
+  std::string key;
+  base::JSONWriter::Write(&dict, &key);
+  return key;
+}
+
+scoped_ptr<base::ValueMap> GetRuntimeVariablesFromPoolKey(
+    const std::string& key) {
+  scoped_ptr<base::ValueMap> variables(new base::ValueMap);
+  scoped_ptr<base::Value> value(base::JSONReader::Read(key));
+  base::DictionaryValue* dict;
+  if (!value || !value->GetAsDictionary(&dict))
+    return variables.Pass();
+
+  for (base::DictionaryValue::Iterator it(*dict); !it.IsAtEnd(); it.Advance())
+    (*variables)[it.key()] = it.value().DeepCopy();
+  return variables.Pass();
+}
+
+void DispatchMessageToServer(base::WeakPtr<XWalkExtensionServer> server,
+                             scoped_ptr<IPC::Message> message) {
+  if (server)
+    server->OnMessageReceived(*message);
+}
+
 }  // namespace
 
 // This object intercepts messages destined to a XWalkExtensionServer and
@@ -46,18 +87,24 @@ base::FilePath g_external_extensions_path_for_testing_;
 // task runner. Like other filters, this filter will run in the IO-thread.
 //
 // In the case of in process extensions, we will pass the task runner of the
-// extension thread.
+// extension thread. Instances of the extensions not sharing that thread go to
+// their own server and task runner. The servers of the extensions running on
+// the IO thread get their messages posted too, so they never run from within
+// OnMessageReceived() and the channel is never reentered.
 class ExtensionServerMessageFilter : public IPC::MessageFilter,
                                      public IPC::Sender {
  public:
   ExtensionServerMessageFilter(
       scoped_refptr<base::SequencedTaskRunner> task_runner,
       XWalkExtensionServer* extension_thread_server,
-      XWalkExtensionServer* ui_thread_server)
+      XWalkExtensionServer* ui_thread_server,
+      const XWalkExtensionData::IsolatedServerVector& isolated_servers)
       : sender_(NULL),
+        renderer_process_handle_(base::kNullProcessHandle),
         task_runner_(task_runner),
         extension_thread_server_(extension_thread_server),
-        ui_thread_server_(ui_thread_server) {}
+        ui_thread_server_(ui_thread_server),
+        isolated_servers_(isolated_servers) {}
 
   // Tells the filter to stop dispatching messages to the server.
   void Invalidate() {
@@ -66,6 +113,7 @@ class ExtensionServerMessageFilter : public IPC::MessageFilter,
     task_runner_ = NULL;
     extension_thread_server_ = NULL;
     ui_thread_server_ = NULL;
+    isolated_servers_.clear();
   }
 
   // IPC::Sender implementation.
@@ -79,7 +127,10 @@ class ExtensionServerMessageFilter : public IPC::MessageFilter,
   }
 
  private:
-  virtual ~ExtensionServerMessageFilter() {}
+  virtual ~ExtensionServerMessageFilter() {
+    if (renderer_process_handle_ != base::kNullProcessHandle)
+      base::CloseProcessHandle(renderer_process_handle_);
+  }
 
   int64_t GetInstanceIDFromMessage(const IPC::Message& message) {
     PickleIterator iter;
@@ -96,46 +147,61 @@ class ExtensionServerMessageFilter : public IPC::MessageFilter,
     return instance_id;
   }
 
+  // Returns the server of |instance_id| and the task runner it lives on.
+  XWalkExtensionServer* GetServerForInstance(
+      int64_t instance_id, scoped_refptr<base::TaskRunner>* task_runner) {
+    InstanceServerMap::const_iterator it = instance_servers_.find(instance_id);
+    if (it == instance_servers_.end()) {
+      *task_runner =
+          BrowserThread::GetMessageLoopProxyForThread(BrowserThread::UI);
+      return ui_thread_server_;
+    }
+
+    if (it->second == kExtensionThreadServer) {
+      *task_runner = task_runner_;
+      return extension_thread_server_;
+    }
+
+    const XWalkExtensionData::IsolatedServer& entry =
+        isolated_servers_[it->second];
+    *task_runner = entry.task_runner;
+    return entry.server;
+  }
+
   void RouteMessageToServer(const IPC::Message& message) {
     int64_t id = GetInstanceIDFromMessage(message);
     DCHECK_NE(id, -1);
 
-    XWalkExtensionServer* server;
-    base::TaskRunner* task_runner;
-    scoped_refptr<base::TaskRunner> task_runner_ref;
-
-    if (ContainsKey(extension_thread_instances_ids_, id)) {
-      server = extension_thread_server_;
-      task_runner = task_runner_;
-    } else {
-      server = ui_thread_server_;
-      task_runner_ref =
-          BrowserThread::GetMessageLoopProxyForThread(BrowserThread::UI);
-      task_runner = task_runner_ref.get();
-    }
+    scoped_refptr<base::TaskRunner> task_runner;
+    XWalkExtensionServer* server = GetServerForInstance(id, &task_runner);
 
-    base::Closure closure = base::Bind(
-        base::IgnoreResult(&XWalkExtensionServer::OnMessageReceived),
-        server->AsWeakPtr(), message);
+    // The channel keeps |message|, so it is copied once here and the copy
+    // is then only moved until the server reads it.
+    scoped_ptr<IPC::Message> owned_message(new IPC::Message(message));
+    task_runner->PostTask(FROM_HERE,
+                          base::Bind(&DispatchMessageToServer,
+                                     server->AsWeakPtr(),
+                                     base::Passed(&owned_message)));
 
-    task_runner->PostTask(FROM_HERE, closure);
+    if (message.type() == XWalkExtensionServerMsg_DestroyInstance::ID)
+      instance_servers_.erase(id);
   }
 
   void OnCreateInstance(int64_t instance_id, std::string name) {
-    XWalkExtensionServer* server;
-    base::TaskRunner* task_runner;
-    scoped_refptr<base::TaskRunner> task_runner_ref;
-
-    if (extension_thread_server_->ContainsExtension(name)) {
-      extension_thread_instances_ids_.insert(instance_id);
-      server = extension_thread_server_;
-      task_runner = task_runner_;
-    } else {
-      server = ui_thread_server_;
-      task_runner_ref =
-          BrowserThread::GetMessageLoopProxyForThread(BrowserThread::UI);
-      task_runner = task_runner_ref.get();
+    bool isolated = false;
+    for (size_t i = 0; i < isolated_servers_.size(); ++i) {
+      if (isolated_servers_[i].server->ContainsExtension(name)) {
+        instance_servers_[instance_id] = i;
+        isolated = true;
+        break;
+      }
     }
+    if (!isolated && extension_thread_server_->ContainsExtension(name))
+      instance_servers_[instance_id] = kExtensionThreadServer;
+
+    scoped_refptr<base::TaskRunner> task_runner;
+    XWalkExtensionServer* server =
+        GetServerForInstance(instance_id, &task_runner);
 
     base::Closure closure = base::Bind(
         base::IgnoreResult(&XWalkExtensionServer::OnCreateInstance),
@@ -144,10 +210,46 @@ class ExtensionServerMessageFilter : public IPC::MessageFilter,
     task_runner->PostTask(FROM_HERE, closure);
   }
 
+  void OnCreateInstances(const std::vector<int64_t>& instance_ids,
+                         const std::vector<std::string>& names) {
+    if (instance_ids.size() != names.size()) {
+      LOG(WARNING) << "Got malformed instance batch.";
+      return;
+    }
+    for (size_t i = 0; i < instance_ids.size(); ++i)
+      OnCreateInstance(instance_ids[i], names[i]);
+  }
+
   void OnGetExtensions(
       std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>* reply) {
     extension_thread_server_->OnGetExtensions(reply);
     ui_thread_server_->OnGetExtensions(reply);
+    for (size_t i = 0; i < isolated_servers_.size(); ++i)
+      isolated_servers_[i].server->OnGetExtensions(reply);
+  }
+
+  void OnRequestExtensions() {
+    if (!sender_)
+      return;
+
+    // The extensions of the servers don't change once the filter is added.
+    std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams> extensions;
+    if (!catalog_) {
+      OnGetExtensions(&extensions);
+      catalog_ = XWalkExtensionCatalog::Create(extensions);
+    }
+    base::SharedMemoryHandle handle;
+    if (catalog_ &&
+        catalog_->ShareReadOnlyToProcess(renderer_process_handle_, &handle)) {
+      sender_->Send(new XWalkExtensionClientMsg_ExtensionCatalogShared(
+          handle, catalog_->size()));
+      return;
+    }
+
+    if (extensions.empty())
+      OnGetExtensions(&extensions);
+    sender_->Send(new XWalkExtensionClientMsg_ExtensionsRegistered(
+        extensions));
   }
 
   // IPC::ChannelProxy::MessageFilter implementation.
@@ -155,6 +257,12 @@ class ExtensionServerMessageFilter : public IPC::MessageFilter,
     sender_ = sender;
   }
 
+  virtual void OnChannelConnected(int32 peer_pid) OVERRIDE {
+    base::AutoLock l(lock_);
+    if (renderer_process_handle_ == base::kNullProcessHandle)
+      base::OpenProcessHandle(peer_pid, &renderer_process_handle_);
+  }
+
   virtual void OnFilterRemoved() OVERRIDE {
     sender_ = NULL;
   }
@@ -180,8 +288,12 @@ class ExtensionServerMessageFilter : public IPC::MessageFilter,
     IPC_BEGIN_MESSAGE_MAP(ExtensionServerMessageFilter, message)
       IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_CreateInstance,
                           OnCreateInstance)
+      IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_CreateInstances,
+                          OnCreateInstances)
       IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_GetExtensions,
                           OnGetExtensions)
+      IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_RequestExtensions,
+                          OnRequestExtensions)
       IPC_MESSAGE_UNHANDLED(handled = false)
     IPC_END_MESSAGE_MAP()
 
@@ -195,10 +307,19 @@ class ExtensionServerMessageFilter : public IPC::MessageFilter,
   base::Lock lock_;
 
   IPC::Sender* sender_;
+  base::ProcessHandle renderer_process_handle_;
+  scoped_refptr<XWalkExtensionCatalog> catalog_;
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
   XWalkExtensionServer* extension_thread_server_;
   XWalkExtensionServer* ui_thread_server_;
-  std::set<int64_t> extension_thread_instances_ids_;
+  XWalkExtensionData::IsolatedServerVector isolated_servers_;
+
+  // Instance ids mapped to the index of their server in |isolated_servers_|,
+  // or to kExtensionThreadServer. The instances of the UI thread server
+  // aren't in the map. Looked up for every message of an instance.
+  enum { kExtensionThreadServer = -1 };
+  typedef base::hash_map<int64_t, int> InstanceServerMap;
+  InstanceServerMap instance_servers_;
 };
 
 bool XWalkExtensionService::Delegate::RegisterPermissions(
@@ -208,9 +329,18 @@ bool XWalkExtensionService::Delegate::RegisterPermissions(
   return false;
 }
 
+XWalkExtensionService::ExtensionProcessEntry::ExtensionProcessEntry()
+    : host(NULL) {}
+
+XWalkExtensionService::ExtensionProcessEntry::~ExtensionProcessEntry() {}
+
+XWalkExtensionService::ExtensionProcessCrashes::ExtensionProcessCrashes()
+    : count(0) {}
+
 XWalkExtensionService::XWalkExtensionService(Delegate* delegate)
     : extension_thread_("XWalkExtensionThread"),
-      delegate_(delegate) {
+      delegate_(delegate),
+      spare_extension_process_host_(NULL) {
   if (!g_external_extensions_path_for_testing_.empty())
     external_extensions_path_ = g_external_extensions_path_for_testing_;
   registrar_.Add(this, content::NOTIFICATION_RENDERER_PROCESS_TERMINATED,
@@ -226,11 +356,29 @@ XWalkExtensionService::~XWalkExtensionService() {
   // extension thread.
   if (!extension_data_map_.empty())
     VLOG(1) << "The ExtensionData map is not empty!";
+
+  base::AutoLock l(extension_process_pool_lock_);
+  if (spare_extension_process_host_) {
+    BrowserThread::DeleteSoon(
+        BrowserThread::IO, FROM_HERE, spare_extension_process_host_);
+    spare_extension_process_host_ = NULL;
+  }
 }
 
 void XWalkExtensionService::RegisterExternalExtensionsForPath(
     const base::FilePath& path) {
   external_extensions_path_ = path;
+
+  {
+    // A spare launched for a previous path would load the wrong extensions.
+    base::AutoLock l(extension_process_pool_lock_);
+    if (spare_extension_process_host_) {
+      BrowserThread::DeleteSoon(
+          BrowserThread::IO, FROM_HERE, spare_extension_process_host_);
+      spare_extension_process_host_ = NULL;
+    }
+  }
+  PrewarmExtensionProcessHost();
 }
 
 void XWalkExtensionService::OnRenderProcessHostCreatedInternal(
@@ -333,6 +481,8 @@ void XWalkExtensionService::OnRenderProcessHostClosed(
   // This will cause the filter to be deleted in the IO-thread.
   host->GetChannel()->RemoveFilter(message_filter);
 
+  ReleaseExtensionProcessHost(data);
+
   extension_data_map_.erase(it);
   delete data;
 }
@@ -354,6 +504,60 @@ void RegisterExtensionsIntoServer(XWalkExtensionVector* extensions,
 
 }  // namespace
 
+scoped_refptr<base::SequencedTaskRunner>
+XWalkExtensionService::GetIsolatedTaskRunner(const XWalkExtension& extension) {
+  const std::string name = extension.name();
+  if (extension.execution_model() ==
+      XWalkExtension::EXECUTION_DEDICATED_THREAD) {
+    base::Thread* thread = dedicated_threads_.get(name);
+    if (!thread) {
+      thread = new base::Thread("XWalkExtensionThread_" + name);
+      // Same kind of loop as the shared extension thread.
+      base::Thread::Options options(base::MessageLoop::TYPE_IO, 0);
+      thread->StartWithOptions(options);
+      dedicated_threads_.set(name, make_scoped_ptr(thread));
+    }
+    return thread->message_loop_proxy();
+  }
+
+  if (extension.execution_model() == XWalkExtension::EXECUTION_IO_THREAD)
+    return BrowserThread::GetMessageLoopProxyForThread(BrowserThread::IO);
+
+  DCHECK_EQ(XWalkExtension::EXECUTION_SEQUENCED_POOL,
+            extension.execution_model());
+  base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+  return pool->GetSequencedTaskRunnerWithShutdownBehavior(
+      pool->GetNamedSequenceToken("XWalkExtension_" + name),
+      base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+}
+
+void XWalkExtensionService::CreateIsolatedExtensionServers(
+    IPC::ChannelProxy* channel, XWalkExtensionData* data,
+    XWalkExtensionVector* extensions) {
+  XWalkExtensionVector shared;
+  XWalkExtensionVector::iterator it = extensions->begin();
+  for (; it != extensions->end(); ++it) {
+    XWalkExtension* extension = *it;
+    if (extension->execution_model() ==
+        XWalkExtension::EXECUTION_SHARED_THREAD) {
+      shared.push_back(extension);
+      continue;
+    }
+
+    scoped_refptr<base::SequencedTaskRunner> task_runner =
+        GetIsolatedTaskRunner(*extension);
+    scoped_ptr<XWalkExtensionServer> server(new XWalkExtensionServer);
+    server->Initialize(channel);
+    const std::string name = extension->name();
+    if (!server->RegisterExtension(scoped_ptr<XWalkExtension>(extension))) {
+      LOG(WARNING) << "Couldn't register extension with name '"
+                   << name << "'\n";
+      continue;
+    }
+    data->AddIsolatedServer(server.Pass(), task_runner);
+  }
+  extensions->swap(shared);
+}
 
 void XWalkExtensionService::CreateInProcessExtensionServers(
     content::RenderProcessHost* host, XWalkExtensionData* data,
@@ -369,6 +573,7 @@ void XWalkExtensionService::CreateInProcessExtensionServers(
   extension_thread_server->Initialize(channel);
   ui_thread_server->Initialize(channel);
 
+  CreateIsolatedExtensionServers(channel, data, extension_thread_extensions);
   RegisterExtensionsIntoServer(extension_thread_extensions,
                                extension_thread_server.get());
   RegisterExtensionsIntoServer(ui_thread_extensions, ui_thread_server.get());
@@ -382,13 +587,15 @@ void XWalkExtensionService::CreateInProcessExtensionServers(
   if (!g_create_extension_thread_extensions_callback.is_null()) {
     XWalkExtensionVector extensions;
     g_create_extension_thread_extensions_callback.Run(&extensions);
+    CreateIsolatedExtensionServers(channel, data, &extensions);
     RegisterExtensionsIntoServer(&extensions, extension_thread_server.get());
   }
 
   ExtensionServerMessageFilter* message_filter =
       new ExtensionServerMessageFilter(extension_thread_.message_loop_proxy(),
                                        extension_thread_server.get(),
-                                       ui_thread_server.get());
+                                       ui_thread_server.get(),
+                                       data->isolated_servers());
 
   // The filter is owned by the IPC channel but we keep a reference to remove
   // it from the Channel later during a RenderProcess shutdown.
@@ -404,17 +611,171 @@ void XWalkExtensionService::CreateInProcessExtensionServers(
 void XWalkExtensionService::CreateExtensionProcessHost(
     content::RenderProcessHost* host, XWalkExtensionData* data,
     scoped_ptr<base::ValueMap> runtime_variables) {
-  data->set_extension_process_host(make_scoped_ptr(
-      new XWalkExtensionProcessHost(host, external_extensions_path_, this,
-                                    runtime_variables.Pass())));
+  const std::string key = GetExtensionProcessPoolKey(*runtime_variables);
+
+  bool used_spare = false;
+  {
+    base::AutoLock l(extension_process_pool_lock_);
+    ExtensionProcessEntry& entry = extension_process_pool_[key];
+    if (entry.host) {
+      entry.host->AddRenderProcess(host);
+    } else if (spare_extension_process_host_) {
+      entry.host = spare_extension_process_host_;
+      spare_extension_process_host_ = NULL;
+      entry.host->RegisterExtensions(runtime_variables.Pass());
+      entry.host->AddRenderProcess(host);
+      used_spare = true;
+    } else {
+      entry.host = new XWalkExtensionProcessHost(
+          host, external_extensions_path_, this, runtime_variables.Pass());
+    }
+    entry.render_process_ids.insert(host->GetID());
+    data->set_extension_process_host(entry.host);
+  }
+
+  // Launch the next spare once the current Render Process setup is done.
+  if (used_spare) {
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+        base::Bind(&XWalkExtensionService::PrewarmExtensionProcessHost,
+                   base::Unretained(this)));
+  }
+}
+
+void XWalkExtensionService::PrewarmExtensionProcessHost() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // In shared process mode the Extension Process is provided by the launcher.
+#if !defined(SHARED_PROCESS_MODE)
+  CommandLine* cmd_line = CommandLine::ForCurrentProcess();
+  if (cmd_line->HasSwitch(switches::kXWalkDisableExtensionProcess) ||
+      cmd_line->HasSwitch(switches::kXWalkDisableExtensionProcessPrewarm))
+    return;
+
+  base::AutoLock l(extension_process_pool_lock_);
+  if (spare_extension_process_host_)
+    return;
+  spare_extension_process_host_ =
+      new XWalkExtensionProcessHost(external_extensions_path_, this);
+#endif
+}
+
+void XWalkExtensionService::ReleaseExtensionProcessHost(
+    XWalkExtensionData* data) {
+  XWalkExtensionProcessHost* eph = data->extension_process_host();
+  if (!eph)
+    return;
+  data->set_extension_process_host(NULL);
+
+  const int render_process_id = data->render_process_host()->GetID();
+
+  base::AutoLock l(extension_process_pool_lock_);
+  ExtensionProcessPool::iterator it = extension_process_pool_.begin();
+  for (; it != extension_process_pool_.end(); ++it) {
+    if (it->second.host == eph)
+      break;
+  }
+
+  // The extension process died and the host is already gone.
+  if (it == extension_process_pool_.end())
+    return;
+
+  it->second.render_process_ids.erase(render_process_id);
+  if (!it->second.render_process_ids.empty()) {
+    eph->RemoveRenderProcess(render_process_id);
+    return;
+  }
+
+  extension_process_pool_.erase(it);
+  BrowserThread::DeleteSoon(BrowserThread::IO, FROM_HERE, eph);
+}
+
+void XWalkExtensionService::ScheduleExtensionProcessRestart(
+    const std::string& key, const std::set<int>& render_process_ids) {
+  // In shared process mode the Extension Process is provided by the launcher.
+#if !defined(SHARED_PROCESS_MODE)
+  ExtensionProcessCrashes& crashes = extension_process_crashes_[key];
+  const base::TimeTicks now = base::TimeTicks::Now();
+  if (now - crashes.last_crash >
+      base::TimeDelta::FromSeconds(kCrashLoopResetSeconds))
+    crashes.count = 0;
+  crashes.last_crash = now;
+  if (++crashes.count > kMaxExtensionProcessRestarts) {
+    LOG(WARNING) << "The Extension Process crashed "
+                 << kMaxExtensionProcessRestarts
+                 << " times in a row, it won't be restarted.";
+    return;
+  }
+
+  std::set<int>::const_iterator it = render_process_ids.begin();
+  for (; it != render_process_ids.end(); ++it)
+    restarting_render_processes_[*it] = key;
+
+  BrowserThread::PostDelayedTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&XWalkExtensionService::RestartExtensionProcessHost,
+                 base::Unretained(this), key),
+      base::TimeDelta::FromMilliseconds(
+          kExtensionProcessRestartDelayMs << (crashes.count - 1)));
+#endif
+}
+
+void XWalkExtensionService::RestartExtensionProcessHost(
+    const std::string& key) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  std::vector<int> render_process_ids;
+  {
+    base::AutoLock l(extension_process_pool_lock_);
+    std::map<int, std::string>::iterator it =
+        restarting_render_processes_.begin();
+    while (it != restarting_render_processes_.end()) {
+      if (it->second == key) {
+        render_process_ids.push_back(it->first);
+        restarting_render_processes_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < render_process_ids.size(); ++i) {
+    // The render process may have gone away in the meantime.
+    RenderProcessToExtensionDataMap::iterator it =
+        extension_data_map_.find(render_process_ids[i]);
+    if (it == extension_data_map_.end() ||
+        it->second->extension_process_host())
+      continue;
+
+    content::RenderProcessHost* host = it->second->render_process_host();
+    CreateExtensionProcessHost(host, it->second,
+                               GetRuntimeVariablesFromPoolKey(key));
+    // Asks the render process to connect to the new Extension Process.
+    host->Send(new XWalkExtensionClientMsg_ExtensionProcessRestarted);
+  }
 }
 
 void XWalkExtensionService::OnExtensionProcessDied(
     XWalkExtensionProcessHost* eph, int render_process_id) {
   // When this is called it means that XWalkExtensionProcessHost is about
-  // to be deleted. We should invalidate our reference to it so we avoid a
+  // to be deleted. We should invalidate our references to it so we avoid a
   // segfault when trying to delete it within
-  // XWalkExtensionService::OnRenderProcessHostClosed();
+  // XWalkExtensionService::ReleaseExtensionProcessHost(). This is called once
+  // for each render process sharing the extension process, the first call
+  // decides whether they get a new one.
+  bool restart = false;
+  {
+    base::AutoLock l(extension_process_pool_lock_);
+    if (spare_extension_process_host_ == eph)
+      spare_extension_process_host_ = NULL;
+
+    ExtensionProcessPool::iterator it = extension_process_pool_.begin();
+    for (; it != extension_process_pool_.end(); ++it) {
+      if (it->second.host == eph) {
+        ScheduleExtensionProcessRestart(it->first,
+                                        it->second.render_process_ids);
+        extension_process_pool_.erase(it);
+        break;
+      }
+    }
+    restart = restarting_render_processes_.count(render_process_id) > 0;
+  }
 
   RenderProcessToExtensionDataMap::iterator it =
       extension_data_map_.find(render_process_id);
@@ -424,9 +785,13 @@ void XWalkExtensionService::OnExtensionProcessDied(
 
   XWalkExtensionData* data = it->second;
 
-  XWalkExtensionProcessHost* stored_eph =
-      data->extension_process_host().release();
-  CHECK_EQ(stored_eph, eph);
+  CHECK_EQ(data->extension_process_host(), eph);
+  data->set_extension_process_host(NULL);
+
+  // The page keeps running with its in process extensions, the external
+  // ones come back with the new Extension Process.
+  if (restart)
+    return;
 
   content::RenderProcessHost* rph = data->render_process_host();
   if (rph) {
@@ -449,10 +814,79 @@ void XWalkExtensionService::OnRenderProcessDied(
 
   XWalkExtensionData* data = it->second;
 
+  ReleaseExtensionProcessHost(data);
+
   extension_data_map_.erase(it);
   delete data;
 }
 
+void XWalkExtensionService::OnPermissionsChanged(int render_process_id) {
+  RenderProcessToExtensionDataMap::iterator it =
+      extension_data_map_.find(render_process_id);
+  if (it == extension_data_map_.end())
+    return;
+
+  XWalkExtensionProcessHost* eph = it->second->extension_process_host();
+  if (eph)
+    eph->ClearPermissionCache();
+}
+
+base::ProcessHandle XWalkExtensionService::GetExtensionProcessHandle(
+    int render_process_id) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  RenderProcessToExtensionDataMap::iterator it =
+      extension_data_map_.find(render_process_id);
+  if (it == extension_data_map_.end() ||
+      !it->second->extension_process_host())
+    return base::kNullProcessHandle;
+  return it->second->extension_process_host()->GetProcessHandle();
+}
+
+namespace {
+
+void AddServerCounters(const XWalkExtensionServer* server,
+                       const std::string& extension_name,
+                       XWalkExtensionStats::Counters* counters,
+                       bool* found) {
+  XWalkExtensionStats::Counters server_counters;
+  if (!server ||
+      !server->stats().GetCounters(extension_name, &server_counters))
+    return;
+  counters->messages_to_native += server_counters.messages_to_native;
+  counters->messages_to_js += server_counters.messages_to_js;
+  counters->bytes_to_native += server_counters.bytes_to_native;
+  counters->bytes_to_js += server_counters.bytes_to_js;
+  counters->out_of_line_messages += server_counters.out_of_line_messages;
+  counters->sync_calls += server_counters.sync_calls;
+  counters->sync_blocking_time += server_counters.sync_blocking_time;
+  *found = true;
+}
+
+}  // namespace
+
+bool XWalkExtensionService::GetInProcessExtensionStats(
+    int render_process_id, const std::string& extension_name,
+    XWalkExtensionStats::Counters* counters) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  RenderProcessToExtensionDataMap::iterator it =
+      extension_data_map_.find(render_process_id);
+  if (it == extension_data_map_.end())
+    return false;
+
+  XWalkExtensionData* data = it->second;
+  bool found = false;
+  *counters = XWalkExtensionStats::Counters();
+  AddServerCounters(data->in_process_ui_thread_server(), extension_name,
+                    counters, &found);
+  AddServerCounters(data->in_process_extension_thread_server(),
+                    extension_name, counters, &found);
+  const XWalkExtensionData::IsolatedServerVector& isolated =
+      data->isolated_servers();
+  for (size_t i = 0; i < isolated.size(); ++i)
+    AddServerCounters(isolated[i].server, extension_name, counters, &found);
+  return found;
+}
+
 void XWalkExtensionService::OnExtensionProcessCreated(
       int render_process_id,
       const IPC::ChannelHandle channel_handle) {
@@ -7,19 +7,33 @@
 
 #include <stdint.h>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include "base/callback_forward.h"
 #include "base/containers/scoped_ptr_hash_map.h"
 #include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
 #include "xwalk/extensions/browser/xwalk_extension_process_host.h"
+#include "xwalk/extensions/common/xwalk_extension_stats.h"
 #include "xwalk/extensions/common/xwalk_extension_vector.h"
 
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace IPC {
+class ChannelProxy;
+}
+
 namespace content {
 class RenderProcessHost;
 class WebContents;
@@ -79,6 +93,24 @@ class XWalkExtensionService : public content::NotificationObserver,
   // XWalkContentBrowserClient::RenderProcessHostGone().
   void OnRenderProcessDied(content::RenderProcessHost* host);
 
+  // To be called when the permissions of the application running in the
+  // given Render Process change, so its Extension Process stops using the
+  // access control decisions it cached.
+  void OnPermissionsChanged(int render_process_id);
+
+  // The Extension Process serving the given Render Process,
+  // base::kNullProcessHandle if there is none or it is not launched yet.
+  // Must be called on the UI thread.
+  base::ProcessHandle GetExtensionProcessHandle(int render_process_id);
+
+  // Sums the counters of |extension_name| kept by the in process servers of
+  // the given Render Process. Returns false if none of them recorded
+  // anything for it. The Extension Process keeps the counters of the
+  // external extensions itself. Must be called on the UI thread.
+  bool GetInProcessExtensionStats(int render_process_id,
+                                  const std::string& extension_name,
+                                  XWalkExtensionStats::Counters* counters);
+
   typedef base::Callback<void(XWalkExtensionVector* extensions)>
       CreateExtensionsCallback;
 
@@ -119,19 +151,49 @@ class XWalkExtensionService : public content::NotificationObserver,
 
   void OnRenderProcessHostClosed(content::RenderProcessHost* host);
 
+  // Moves the extensions of |extensions| that don't use the shared extension
+  // thread to servers of their own, added to |data|.
+  void CreateIsolatedExtensionServers(IPC::ChannelProxy* channel,
+                                      XWalkExtensionData* data,
+                                      XWalkExtensionVector* extensions);
+  // Where the server of |extension| must live, by its execution model. The
+  // threads and sequences are shared by the render processes.
+  scoped_refptr<base::SequencedTaskRunner> GetIsolatedTaskRunner(
+      const XWalkExtension& extension);
+
   void CreateInProcessExtensionServers(
       content::RenderProcessHost* host,
       XWalkExtensionData* data,
       XWalkExtensionVector* ui_thread_extensions,
       XWalkExtensionVector* extension_thread_extensions);
 
+  // Render processes with the same runtime variables (i.e. of the same
+  // application) share a single Extension Process.
   void CreateExtensionProcessHost(content::RenderProcessHost* host,
       XWalkExtensionData* data, scoped_ptr<base::ValueMap> runtime_variables);
+  void ReleaseExtensionProcessHost(XWalkExtensionData* data);
+
+  // Keeps one Extension Process launched ahead of time, so the next Render
+  // Process doesn't wait for a whole process startup to get its channel.
+  void PrewarmExtensionProcessHost();
+
+  // Called with |extension_process_pool_lock_| held when the Extension
+  // Process of |key| died. Its render processes get a new one after a delay
+  // doubling with each crash in a row, unless it keeps crashing, in which
+  // case they are shut down.
+  void ScheduleExtensionProcessRestart(const std::string& key,
+                                       const std::set<int>& render_process_ids);
+  void RestartExtensionProcessHost(const std::string& key);
 
   // The server that handles in process extensions will live in the
   // extension_thread_.
   base::Thread extension_thread_;
 
+  // Threads of the extensions with EXECUTION_DEDICATED_THREAD, by extension
+  // name. Only used on the UI thread.
+  typedef base::ScopedPtrHashMap<std::string, base::Thread> DedicatedThreadMap;
+  DedicatedThreadMap dedicated_threads_;
+
   content::NotificationRegistrar registrar_;
 
   Delegate* delegate_;
@@ -141,6 +203,42 @@ class XWalkExtensionService : public content::NotificationObserver,
   typedef std::map<int, XWalkExtensionData*> RenderProcessToExtensionDataMap;
   RenderProcessToExtensionDataMap extension_data_map_;
 
+  struct ExtensionProcessEntry {
+    ExtensionProcessEntry();
+    ~ExtensionProcessEntry();
+
+    XWalkExtensionProcessHost* host;
+    std::set<int> render_process_ids;
+  };
+
+  // Keyed by the serialized runtime variables. The hosts are owned by this
+  // map and deleted on the IO thread once their last render process is gone,
+  // unless the extension process dies first, in which case content deletes
+  // them. Guarded by |extension_process_pool_lock_| since the death of an
+  // extension process is notified on the IO thread.
+  typedef std::map<std::string, ExtensionProcessEntry> ExtensionProcessPool;
+  ExtensionProcessPool extension_process_pool_;
+
+  // Launched but not yet serving any render process, also guarded by
+  // |extension_process_pool_lock_|.
+  XWalkExtensionProcessHost* spare_extension_process_host_;
+
+  // The crashes of the Extension Process of each pool key, counted until
+  // it runs long enough without crashing. Also guarded by
+  // |extension_process_pool_lock_|, like the render processes waiting for
+  // their Extension Process to be restarted, mapped to its pool key.
+  struct ExtensionProcessCrashes {
+    ExtensionProcessCrashes();
+
+    int count;
+    base::TimeTicks last_crash;
+  };
+  typedef std::map<std::string, ExtensionProcessCrashes> CrashMap;
+  CrashMap extension_process_crashes_;
+  std::map<int, std::string> restarting_render_processes_;
+
+  base::Lock extension_process_pool_lock_;
+
   DISALLOW_COPY_AND_ASSIGN(XWalkExtensionService);
 };
 
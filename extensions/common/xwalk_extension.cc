@@ -21,7 +21,22 @@ bool XWalkExtension::PermissionsDelegate::RegisterPermissions(
   return false;
 }
 
-XWalkExtension::XWalkExtension() : permissions_delegate_(NULL) {}
+void XWalkExtension::PermissionsDelegate::CheckAPIAccessControlAsync(
+    const std::string& extension_name, const std::string& api_name,
+    const PermissionResultCallback& callback) {
+  callback.Run(CheckAPIAccessControl(extension_name, api_name));
+}
+
+void XWalkExtension::PermissionsDelegate::RegisterPermissionsAsync(
+    const std::string& extension_name, const std::string& perm_table,
+    const PermissionResultCallback& callback) {
+  callback.Run(RegisterPermissions(extension_name, perm_table));
+}
+
+XWalkExtension::XWalkExtension()
+    : permissions_delegate_(NULL),
+      max_batch_size_(0),
+      execution_model_(EXECUTION_SHARED_THREAD) {}
 
 XWalkExtension::~XWalkExtension() {}
 
@@ -43,6 +58,28 @@ bool XWalkExtension::RegisterPermissions(const char* perm_table) const {
   return permissions_delegate_->RegisterPermissions(name(), perm_table);
 }
 
+void XWalkExtension::CheckAPIAccessControlAsync(
+    const char* api_name, const PermissionResultCallback& callback) const {
+  if (!permissions_delegate_) {
+    callback.Run(false);
+    return;
+  }
+
+  permissions_delegate_->CheckAPIAccessControlAsync(name(), api_name,
+                                                    callback);
+}
+
+void XWalkExtension::RegisterPermissionsAsync(
+    const char* perm_table, const PermissionResultCallback& callback) const {
+  if (!permissions_delegate_) {
+    callback.Run(false);
+    return;
+  }
+
+  permissions_delegate_->RegisterPermissionsAsync(name(), perm_table,
+                                                  callback);
+}
+
 XWalkExtensionInstance::XWalkExtensionInstance() {}
 
 XWalkExtensionInstance::~XWalkExtensionInstance() {}
@@ -57,10 +94,65 @@ void XWalkExtensionInstance::SetSendSyncReplyCallback(
   send_sync_reply_ = callback;
 }
 
+void XWalkExtensionInstance::SetPostBinaryMessageCallback(
+    const PostBinaryMessageCallback& callback) {
+  post_binary_message_ = callback;
+}
+
+void XWalkExtensionInstance::SetSendReplyCallback(
+    const SendReplyCallback& callback) {
+  send_reply_ = callback;
+}
+
+void XWalkExtensionInstance::SetPublishStateCallback(
+    const PublishStateCallback& callback) {
+  publish_state_ = callback;
+  if (pending_published_state_)
+    publish_state_.Run(pending_published_state_.Pass());
+}
+
+void XWalkExtensionInstance::PublishStateToJS(scoped_ptr<base::Value> state) {
+  if (publish_state_.is_null()) {
+    pending_published_state_ = state.Pass();
+    return;
+  }
+  publish_state_.Run(state.Pass());
+}
+
 void XWalkExtensionInstance::HandleSyncMessage(
     scoped_ptr<base::Value> msg) {
   LOG(FATAL) << "Sending sync message to extension which doesn't support it!";
 }
 
+void XWalkExtensionInstance::HandleRequest(int request_id,
+                                           scoped_ptr<base::Value> msg) {
+  {
+    base::AutoLock l(requests_handled_as_sync_lock_);
+    requests_handled_as_sync_.push_back(request_id);
+  }
+  HandleSyncMessage(msg.Pass());
+}
+
+void XWalkExtensionInstance::SendSyncReplyToJS(scoped_ptr<base::Value> reply) {
+  // A renderer blocked in a sync message can't send new requests, so the
+  // requests queued here always precede the pending sync message, if any.
+  int request_id = 0;
+  bool is_request = false;
+  {
+    base::AutoLock l(requests_handled_as_sync_lock_);
+    if (!requests_handled_as_sync_.empty()) {
+      request_id = requests_handled_as_sync_.front();
+      requests_handled_as_sync_.pop_front();
+      is_request = true;
+    }
+  }
+  if (is_request) {
+    SendReplyToJS(request_id, reply.Pass());
+    return;
+  }
+
+  send_sync_reply_.Run(reply.Pass());
+}
+
 }  // namespace extensions
 }  // namespace xwalk
@@ -5,9 +5,12 @@
 #ifndef XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_H_
 #define XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_H_
 
+#include <deque>
 #include <string>
 #include <vector>
 #include "base/callback.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "base/values.h"
 
 namespace xwalk {
@@ -32,6 +35,30 @@ class XWalkExtensionInstance;
 // XWalkExtensionInstance.
 class XWalkExtension {
  public:
+  // Where the browser process runs the instances of an extension registered
+  // for the extension thread. Extensions with slow handlers should not use
+  // the shared thread, they would delay the messages of the others.
+  enum ExecutionModel {
+    // The extension thread shared by every such extension.
+    EXECUTION_SHARED_THREAD,
+    // A thread of its own, with an IO message loop like the shared one.
+    EXECUTION_DEDICATED_THREAD,
+    // A sequence of the browser blocking pool. There is no message loop, so
+    // file descriptors can't be watched and batched messages to JS are sent
+    // right away.
+    EXECUTION_SEQUENCED_POOL,
+    // The browser IO thread, where the messages of the render process are
+    // received: they are handled in a task posted right away, and replied to
+    // without a thread hop. Only for handlers that are quick, e.g. getters
+    // of cached state. They must never block, IO is disallowed on that
+    // thread and every IPC of the browser waits for them.
+    EXECUTION_IO_THREAD
+  };
+
+  // Runs with the answer of a non-blocking permission request: whether the
+  // API is allowed, or whether the table was registered.
+  typedef base::Callback<void(bool result)> PermissionResultCallback;
+
   class PermissionsDelegate {
    public:
     // The delegate is responsible for caching the requests for the sake of
@@ -41,6 +68,14 @@ class XWalkExtension {
     virtual bool RegisterPermissions(const std::string& extension_name,
         const std::string& perm_table);
 
+    // Same without blocking the calling thread. The default implementations
+    // run |callback| right away with the answer of the blocking variants.
+    virtual void CheckAPIAccessControlAsync(const std::string& extension_name,
+        const std::string& api_name, const PermissionResultCallback& callback);
+    virtual void RegisterPermissionsAsync(const std::string& extension_name,
+        const std::string& perm_table,
+        const PermissionResultCallback& callback);
+
     ~PermissionsDelegate() {}
   };
 
@@ -62,6 +97,25 @@ class XWalkExtension {
 
   bool CheckAPIAccessControl(const char* api_name) const;
   bool RegisterPermissions(const char* perm_table) const;
+  void CheckAPIAccessControlAsync(
+      const char* api_name, const PermissionResultCallback& callback) const;
+  void RegisterPermissionsAsync(
+      const char* perm_table, const PermissionResultCallback& callback) const;
+
+  // Messages exchanged with instances of an extension that opted in for
+  // batching are queued and delivered in a single IPC message, either when
+  // an instance has |max_batch_size| messages pending or |max_batch_delay|
+  // has passed since the first one was queued. A zero delay flushes at the
+  // end of the current task. Batching is disabled when |max_batch_size| is
+  // lower than 2. The batched instances of a client or server share a queue,
+  // which keeps the order of their messages and is bounded on its own.
+  size_t max_batch_size() const { return max_batch_size_; }
+  base::TimeDelta max_batch_delay() const { return max_batch_delay_; }
+  bool is_batching_enabled() const { return max_batch_size_ > 1; }
+
+  // Ignored for extensions running on the UI thread or in the Extension
+  // Process.
+  ExecutionModel execution_model() const { return execution_model_; }
 
  protected:
   XWalkExtension();
@@ -72,6 +126,12 @@ class XWalkExtension {
   void set_entry_points(const std::vector<std::string>& entry_points) {
     entry_points_.AppendStrings(entry_points);
   }
+  void set_message_batching(size_t max_batch_size,
+                            base::TimeDelta max_batch_delay) {
+    max_batch_size_ = max_batch_size;
+    max_batch_delay_ = max_batch_delay;
+  }
+  void set_execution_model(ExecutionModel model) { execution_model_ = model; }
 
  private:
   // Name of extension, used for dispatching messages.
@@ -89,6 +149,11 @@ class XWalkExtension {
   // Permission check delegate for both in and out of process extensions.
   PermissionsDelegate* permissions_delegate_;
 
+  size_t max_batch_size_;
+  base::TimeDelta max_batch_delay_;
+
+  ExecutionModel execution_model_;
+
   DISALLOW_COPY_AND_ASSIGN(XWalkExtension);
 };
 
@@ -111,15 +176,33 @@ class XWalkExtensionInstance {
   // can be sent after HandleSyncMessage() function returns.
   virtual void HandleSyncMessage(scoped_ptr<base::Value> msg);
 
+  // Allow to handle requests sent from JavaScript code, which gets a Promise
+  // resolved when SendReplyToJS() is called with the same |request_id|. Many
+  // requests can be outstanding at the same time and the renderer doesn't
+  // block. The default implementation forwards the request to
+  // HandleSyncMessage(), and the next SendSyncReplyToJS() will answer the
+  // oldest request forwarded this way, so extensions that reply to their
+  // sync messages in order get the non-blocking behavior for free.
+  virtual void HandleRequest(int request_id, scoped_ptr<base::Value> msg);
+
   // Callbacks used by extension instance to communicate back to JS. These are
   // set by the extension system. Callbacks will take the ownership of the
   // message.
   typedef base::Callback<void(scoped_ptr<base::Value> msg)> PostMessageCallback;
   typedef base::Callback<void(scoped_ptr<base::Value> msg)>
       SendSyncReplyCallback;
+  typedef base::Callback<void(const char* data, size_t size)>
+      PostBinaryMessageCallback;
+  typedef base::Callback<void(int request_id, scoped_ptr<base::Value> reply)>
+      SendReplyCallback;
+  typedef base::Callback<void(scoped_ptr<base::Value> state)>
+      PublishStateCallback;
 
   void SetPostMessageCallback(const PostMessageCallback& callback);
   void SetSendSyncReplyCallback(const SendSyncReplyCallback& callback);
+  void SetPostBinaryMessageCallback(const PostBinaryMessageCallback& callback);
+  void SetSendReplyCallback(const SendReplyCallback& callback);
+  void SetPublishStateCallback(const PublishStateCallback& callback);
 
   // Function to be used by extensions Instances to post messages back to
   // JavaScript in the renderer process. This function will take the ownership
@@ -128,17 +211,47 @@ class XWalkExtensionInstance {
     post_message_.Run(msg.Pass());
   }
 
+  // Posts raw bytes that will be delivered to JavaScript as an ArrayBuffer.
+  // The data is copied before returning, so the caller keeps its ownership.
+  void PostBinaryMessageToJS(const char* data, size_t size) {
+    post_binary_message_.Run(data, size);
+  }
+
+  // Replaces the state JavaScript reads with 'extension.getPublishedState()'.
+  // It is kept as JSON in shared memory mapped by the renderer, so reading it
+  // costs no round trip, and the listener set with
+  // 'extension.setPublishedStateListener()' is told when it changes. Meant
+  // for state read often and changing rarely, e.g. the manifest of an
+  // application or the capabilities of a device. It can be published from
+  // the constructor, it then goes out once the instance is set up.
+  void PublishStateToJS(scoped_ptr<base::Value> state);
+
  protected:
   XWalkExtensionInstance();
 
-  // Unblocks the renderer waiting on a SyncMessage.
-  void SendSyncReplyToJS(scoped_ptr<base::Value> reply) {
-    send_sync_reply_.Run(reply.Pass());
+  // Unblocks the renderer waiting on a SyncMessage, or answers the oldest
+  // request forwarded by the default HandleRequest() implementation.
+  void SendSyncReplyToJS(scoped_ptr<base::Value> reply);
+
+  // Resolves the JavaScript Promise of the request |request_id|. It is fine to
+  // answer requests in any order.
+  void SendReplyToJS(int request_id, scoped_ptr<base::Value> reply) {
+    send_reply_.Run(request_id, reply.Pass());
   }
 
  private:
   PostMessageCallback post_message_;
   SendSyncReplyCallback send_sync_reply_;
+  PostBinaryMessageCallback post_binary_message_;
+  SendReplyCallback send_reply_;
+  PublishStateCallback publish_state_;
+  // Published before |publish_state_| was set.
+  scoped_ptr<base::Value> pending_published_state_;
+
+  // Requests waiting a reply through SendSyncReplyToJS(). Queued on the
+  // thread handling the messages, the reply may come from any other.
+  base::Lock requests_handled_as_sync_lock_;
+  std::deque<int> requests_handled_as_sync_;
 
   DISALLOW_COPY_AND_ASSIGN(XWalkExtensionInstance);
 };
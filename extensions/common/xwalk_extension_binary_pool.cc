@@ -0,0 +1,97 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/common/xwalk_extension_binary_pool.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/atomic_sequence_num.h"
+#include "base/logging.h"
+
+namespace xwalk {
+namespace extensions {
+
+namespace {
+
+base::StaticAtomicSequenceNumber g_next_pool_id;
+
+}  // namespace
+
+XWalkExtensionBinaryPool::XWalkExtensionBinaryPool(size_t slot_size,
+                                                   size_t slot_count)
+    : id_(g_next_pool_id.GetNext()),
+      slot_size_(slot_size),
+      slot_count_(slot_count) {
+  DCHECK_GT(slot_size_, 0u);
+  DCHECK_GT(slot_count_, 0u);
+}
+
+XWalkExtensionBinaryPool::~XWalkExtensionBinaryPool() {}
+
+bool XWalkExtensionBinaryPool::Initialize() {
+  base::SharedMemoryCreateOptions options;
+  options.size = mapped_size();
+  options.share_read_only = true;
+
+  if (!shared_memory_.Create(options) || !shared_memory_.Map(mapped_size())) {
+    LOG(WARNING) << "Can't create shared memory for binary message pool";
+    return false;
+  }
+
+  base::AutoLock l(lock_);
+  free_offsets_.reserve(slot_count_);
+  // Pushed in reverse so the first slots are handed out first.
+  for (size_t i = slot_count_; i > 0; --i)
+    free_offsets_.push_back((i - 1) * slot_size_);
+  return true;
+}
+
+bool XWalkExtensionBinaryPool::Acquire(const void* data, size_t size,
+                                       uint32_t* offset) {
+  if (size > slot_size_)
+    return false;
+
+  {
+    base::AutoLock l(lock_);
+    if (free_offsets_.empty())
+      return false;
+    *offset = free_offsets_.back();
+    free_offsets_.pop_back();
+  }
+
+  memcpy(static_cast<char*>(shared_memory_.memory()) + *offset, data, size);
+  return true;
+}
+
+void XWalkExtensionBinaryPool::Release(uint32_t offset) {
+  if (offset % slot_size_ || offset >= mapped_size()) {
+    LOG(WARNING) << "Ignoring release of invalid binary slot: " << offset;
+    return;
+  }
+
+  base::AutoLock l(lock_);
+  // A compromised or buggy renderer could release the same slot twice, which
+  // would hand it out to two messages at once.
+  if (std::find(free_offsets_.begin(), free_offsets_.end(), offset) !=
+      free_offsets_.end()) {
+    LOG(WARNING) << "Ignoring release of binary slot not in use: " << offset;
+    return;
+  }
+  free_offsets_.push_back(offset);
+}
+
+bool XWalkExtensionBinaryPool::ShareReadOnlyToProcess(
+    base::ProcessHandle process, base::SharedMemoryHandle* handle) {
+  return shared_memory_.ShareReadOnlyToProcess(process, handle);
+}
+
+size_t XWalkExtensionBinaryPool::free_slots() const {
+  base::AutoLock l(lock_);
+  return free_offsets_.size();
+}
+
+}  // namespace extensions
+}  // namespace xwalk
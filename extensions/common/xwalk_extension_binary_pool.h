@@ -0,0 +1,73 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_BINARY_POOL_H_
+#define XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_BINARY_POOL_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/process/process_handle.h"
+#include "base/synchronization/lock.h"
+
+namespace xwalk {
+namespace extensions {
+
+// A single shared memory segment, mapped once for the lifetime of the pool,
+// divided in fixed size slots. Binary messages are copied straight into a
+// free slot and only a small descriptor (buffer id, offset and length) goes
+// through the IPC channel. The receiving side hands the slot back once the
+// payload was consumed, so segments are recycled instead of being created and
+// mapped for every message.
+//
+// Acquire() and Release() can be called from any thread.
+class XWalkExtensionBinaryPool {
+ public:
+  XWalkExtensionBinaryPool(size_t slot_size, size_t slot_count);
+  ~XWalkExtensionBinaryPool();
+
+  // Creates and maps the backing segment. Must be called before any other
+  // method, returns false if the shared memory could not be allocated.
+  bool Initialize();
+
+  // Copies |size| bytes from |data| into a free slot and returns its offset
+  // in |offset|. Returns false if the payload doesn't fit in a slot or all the
+  // slots are in use, the caller is expected to fallback to the regular
+  // message path in that case.
+  bool Acquire(const void* data, size_t size, uint32_t* offset);
+
+  // Gives back a slot previously returned by Acquire(). Offsets that aren't
+  // a slot in use are ignored.
+  void Release(uint32_t offset);
+
+  // Creates a read-only handle of the segment valid in |process|.
+  bool ShareReadOnlyToProcess(base::ProcessHandle process,
+                              base::SharedMemoryHandle* handle);
+
+  // Unique in the process, used by the other side to tell pools apart when
+  // more than one server shares the same channel.
+  int id() const { return id_; }
+  size_t slot_size() const { return slot_size_; }
+  size_t mapped_size() const { return slot_size_ * slot_count_; }
+  size_t free_slots() const;
+
+ private:
+  const int id_;
+  const size_t slot_size_;
+  const size_t slot_count_;
+
+  base::SharedMemory shared_memory_;
+
+  mutable base::Lock lock_;
+  std::vector<uint32_t> free_offsets_;
+
+  DISALLOW_COPY_AND_ASSIGN(XWalkExtensionBinaryPool);
+};
+
+}  // namespace extensions
+}  // namespace xwalk
+
+#endif  // XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_BINARY_POOL_H_
@@ -0,0 +1,83 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/common/xwalk_extension_binary_pool.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::extensions::XWalkExtensionBinaryPool;
+
+namespace {
+
+const size_t kSlotSize = 64;
+const size_t kSlotCount = 2;
+
+}  // namespace
+
+TEST(XWalkExtensionBinaryPoolTest, AcquireAndRelease) {
+  XWalkExtensionBinaryPool pool(kSlotSize, kSlotCount);
+  ASSERT_TRUE(pool.Initialize());
+  EXPECT_EQ(kSlotCount, pool.free_slots());
+
+  const std::string data(kSlotSize, 'x');
+  uint32_t first;
+  uint32_t second;
+  uint32_t third;
+  EXPECT_TRUE(pool.Acquire(data.data(), data.size(), &first));
+  EXPECT_TRUE(pool.Acquire(data.data(), data.size(), &second));
+  EXPECT_NE(first, second);
+  EXPECT_EQ(0u, first % kSlotSize);
+  EXPECT_EQ(0u, second % kSlotSize);
+
+  // All slots are in flight.
+  EXPECT_FALSE(pool.Acquire(data.data(), data.size(), &third));
+
+  pool.Release(first);
+  EXPECT_EQ(1u, pool.free_slots());
+  EXPECT_TRUE(pool.Acquire(data.data(), data.size(), &third));
+  EXPECT_EQ(first, third);
+}
+
+TEST(XWalkExtensionBinaryPoolTest, RejectsOversizedAndInvalid) {
+  XWalkExtensionBinaryPool pool(kSlotSize, kSlotCount);
+  ASSERT_TRUE(pool.Initialize());
+
+  const std::string data(kSlotSize + 1, 'x');
+  uint32_t offset;
+  EXPECT_FALSE(pool.Acquire(data.data(), data.size(), &offset));
+
+  // Offsets not aligned to a slot or out of bounds are ignored.
+  uint32_t first;
+  EXPECT_TRUE(pool.Acquire(data.data(), kSlotSize, &first));
+  pool.Release(first + 1);
+  pool.Release(kSlotSize * kSlotCount);
+  EXPECT_EQ(kSlotCount - 1, pool.free_slots());
+}
+
+TEST(XWalkExtensionBinaryPoolTest, IgnoresDoubleRelease) {
+  XWalkExtensionBinaryPool pool(kSlotSize, kSlotCount);
+  ASSERT_TRUE(pool.Initialize());
+
+  const std::string data(kSlotSize, 'x');
+  uint32_t first;
+  uint32_t second;
+  EXPECT_TRUE(pool.Acquire(data.data(), data.size(), &first));
+  pool.Release(first);
+  pool.Release(first);
+  EXPECT_EQ(kSlotCount, pool.free_slots());
+
+  // The slot is handed out only once.
+  EXPECT_TRUE(pool.Acquire(data.data(), data.size(), &first));
+  EXPECT_TRUE(pool.Acquire(data.data(), data.size(), &second));
+  EXPECT_NE(first, second);
+  EXPECT_FALSE(pool.Acquire(data.data(), data.size(), &second));
+}
+
+TEST(XWalkExtensionBinaryPoolTest, UniqueIds) {
+  XWalkExtensionBinaryPool pool1(kSlotSize, kSlotCount);
+  XWalkExtensionBinaryPool pool2(kSlotSize, kSlotCount);
+  EXPECT_NE(pool1.id(), pool2.id());
+}
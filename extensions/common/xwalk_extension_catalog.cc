@@ -0,0 +1,163 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/common/xwalk_extension_catalog.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "xwalk/extensions/common/xwalk_extension_messages.h"
+
+namespace xwalk {
+namespace extensions {
+
+namespace {
+
+struct CatalogHeader {
+  uint32_t index_size;
+};
+
+}  // namespace
+
+XWalkExtensionCatalog::Entry::Entry()
+    : max_batch_size(1) {}
+
+XWalkExtensionCatalog::Entry::~Entry() {}
+
+XWalkExtensionCatalog::XWalkExtensionCatalog()
+    : size_(0) {}
+
+XWalkExtensionCatalog::~XWalkExtensionCatalog() {}
+
+// static
+scoped_refptr<XWalkExtensionCatalog> XWalkExtensionCatalog::Create(
+    const std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>&
+        extensions) {
+  // The offsets of the sources are relative to the end of the index, so the
+  // index is written before its size is known.
+  Pickle index;
+  uint32_t sources_size = 0;
+  index.WriteUInt32(extensions.size());
+  for (size_t i = 0; i < extensions.size(); ++i) {
+    const XWalkExtensionServerMsg_ExtensionRegisterParams& extension =
+        extensions[i];
+    index.WriteString(extension.name);
+    index.WriteUInt32(extension.entry_points.size());
+    for (size_t j = 0; j < extension.entry_points.size(); ++j)
+      index.WriteString(extension.entry_points[j]);
+    index.WriteUInt64(extension.max_batch_size);
+    index.WriteInt64(extension.max_batch_delay.ToInternalValue());
+    index.WriteUInt32(sources_size);
+    index.WriteUInt32(extension.js_api.size());
+    sources_size += extension.js_api.size();
+  }
+
+  scoped_refptr<XWalkExtensionCatalog> catalog(new XWalkExtensionCatalog);
+  base::SharedMemoryCreateOptions options;
+  options.size = sizeof(CatalogHeader) + index.size() + sources_size;
+  options.share_read_only = true;
+  catalog->shared_memory_.reset(new base::SharedMemory);
+  if (!catalog->shared_memory_->Create(options) ||
+      !catalog->shared_memory_->Map(options.size)) {
+    LOG(WARNING) << "Can't create shared memory for the extension catalog";
+    return NULL;
+  }
+  catalog->size_ = options.size;
+
+  char* memory = static_cast<char*>(catalog->shared_memory_->memory());
+  CatalogHeader header;
+  header.index_size = index.size();
+  memcpy(memory, &header, sizeof(header));
+  memcpy(memory + sizeof(header), index.data(), index.size());
+  char* sources = memory + sizeof(header) + index.size();
+  for (size_t i = 0; i < extensions.size(); ++i) {
+    const std::string& js_api = extensions[i].js_api;
+    memcpy(sources, js_api.data(), js_api.size());
+    sources += js_api.size();
+  }
+
+  if (!catalog->ParseIndex())
+    return NULL;
+  return catalog;
+}
+
+// static
+scoped_refptr<XWalkExtensionCatalog> XWalkExtensionCatalog::Open(
+    base::SharedMemoryHandle handle, size_t size) {
+  scoped_refptr<XWalkExtensionCatalog> catalog(new XWalkExtensionCatalog);
+  catalog->shared_memory_.reset(new base::SharedMemory(handle, true));
+  if (size < sizeof(CatalogHeader) || !catalog->shared_memory_->Map(size)) {
+    LOG(WARNING) << "Can't map the extension catalog";
+    return NULL;
+  }
+  catalog->size_ = size;
+
+  if (!catalog->ParseIndex()) {
+    LOG(WARNING) << "Got malformed extension catalog";
+    return NULL;
+  }
+  return catalog;
+}
+
+bool XWalkExtensionCatalog::ShareReadOnlyToProcess(
+    base::ProcessHandle process, base::SharedMemoryHandle* handle) {
+  return shared_memory_->ShareReadOnlyToProcess(process, handle);
+}
+
+bool XWalkExtensionCatalog::ParseIndex() {
+  const char* memory = static_cast<const char*>(shared_memory_->memory());
+  CatalogHeader header;
+  memcpy(&header, memory, sizeof(header));
+  if (header.index_size > size_ - sizeof(header))
+    return false;
+
+  const char* sources = memory + sizeof(header) + header.index_size;
+  const size_t sources_size = size_ - sizeof(header) - header.index_size;
+
+  // The Pickle reads the index in place.
+  Pickle index(memory + sizeof(header), header.index_size);
+  PickleIterator iter(index);
+  uint32_t count;
+  if (!iter.ReadUInt32(&count))
+    return false;
+
+  std::vector<Entry> entries;
+  for (uint32_t i = 0; i < count; ++i) {
+    Entry entry;
+    uint32_t entry_points_count;
+    if (!iter.ReadString(&entry.name) ||
+        !iter.ReadUInt32(&entry_points_count))
+      return false;
+    for (uint32_t j = 0; j < entry_points_count; ++j) {
+      std::string entry_point;
+      if (!iter.ReadString(&entry_point))
+        return false;
+      entry.entry_points.push_back(entry_point);
+    }
+
+    uint64_t max_batch_size;
+    int64_t max_batch_delay;
+    uint32_t offset;
+    uint32_t length;
+    if (!iter.ReadUInt64(&max_batch_size) ||
+        !iter.ReadInt64(&max_batch_delay) ||
+        !iter.ReadUInt32(&offset) ||
+        !iter.ReadUInt32(&length) ||
+        offset > sources_size || length > sources_size - offset)
+      return false;
+    entry.max_batch_size = max_batch_size;
+    entry.max_batch_delay =
+        base::TimeDelta::FromInternalValue(max_batch_delay);
+    entry.js_api = base::StringPiece(sources + offset, length);
+    entries.push_back(entry);
+  }
+
+  entries_.swap(entries);
+  return true;
+}
+
+}  // namespace extensions
+}  // namespace xwalk
@@ -0,0 +1,80 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_CATALOG_H_
+#define XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_CATALOG_H_
+
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/process/process_handle.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+
+struct XWalkExtensionServerMsg_ExtensionRegisterParams;
+
+namespace xwalk {
+namespace extensions {
+
+// The extensions of a server serialized once into a read-only shared memory
+// segment, mapped by every renderer instead of receiving its own copy of the
+// JavaScript APIs over IPC.
+//
+// The segment starts with a small index of the names, entry points and
+// batching parameters of the extensions, followed by their JS API sources.
+// The entries of an opened catalog point to the sources in the mapping.
+class XWalkExtensionCatalog
+    : public base::RefCountedThreadSafe<XWalkExtensionCatalog> {
+ public:
+  struct Entry {
+    Entry();
+    ~Entry();
+
+    std::string name;
+    std::vector<std::string> entry_points;
+    size_t max_batch_size;
+    base::TimeDelta max_batch_delay;
+    // Valid as long as the catalog is alive.
+    base::StringPiece js_api;
+  };
+
+  // Returns NULL if the shared memory can't be created.
+  static scoped_refptr<XWalkExtensionCatalog> Create(
+      const std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>&
+          extensions);
+
+  // Maps the catalog shared by the other side. Returns NULL if it can't be
+  // mapped or is malformed.
+  static scoped_refptr<XWalkExtensionCatalog> Open(
+      base::SharedMemoryHandle handle, size_t size);
+
+  bool ShareReadOnlyToProcess(base::ProcessHandle process,
+                              base::SharedMemoryHandle* handle);
+
+  const std::vector<Entry>& entries() const { return entries_; }
+  size_t size() const { return size_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<XWalkExtensionCatalog>;
+
+  XWalkExtensionCatalog();
+  ~XWalkExtensionCatalog();
+
+  // Reads the index of the mapped segment into |entries_|.
+  bool ParseIndex();
+
+  scoped_ptr<base::SharedMemory> shared_memory_;
+  size_t size_;
+  std::vector<Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(XWalkExtensionCatalog);
+};
+
+}  // namespace extensions
+}  // namespace xwalk
+
+#endif  // XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_CATALOG_H_
@@ -0,0 +1,64 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/common/xwalk_extension_catalog.h"
+
+#include <vector>
+
+#include "base/process/process_handle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "xwalk/extensions/common/xwalk_extension_messages.h"
+
+using xwalk::extensions::XWalkExtensionCatalog;
+
+namespace {
+
+std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>
+CreateExtensions() {
+  std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams> extensions(2);
+  extensions[0].name = "echo";
+  extensions[0].js_api = "exports.echo = function() {};";
+  extensions[0].max_batch_size = 1;
+  extensions[1].name = "tizen.time";
+  extensions[1].js_api = "exports.now = function() {};";
+  extensions[1].entry_points.push_back("tizen.TZDate");
+  extensions[1].max_batch_size = 16;
+  extensions[1].max_batch_delay = base::TimeDelta::FromMilliseconds(4);
+  return extensions;
+}
+
+}  // namespace
+
+TEST(XWalkExtensionCatalogTest, SharedCatalog) {
+  scoped_refptr<XWalkExtensionCatalog> catalog =
+      XWalkExtensionCatalog::Create(CreateExtensions());
+  ASSERT_TRUE(catalog);
+
+  base::SharedMemoryHandle handle;
+  ASSERT_TRUE(catalog->ShareReadOnlyToProcess(
+      base::GetCurrentProcessHandle(), &handle));
+  scoped_refptr<XWalkExtensionCatalog> opened =
+      XWalkExtensionCatalog::Open(handle, catalog->size());
+  ASSERT_TRUE(opened);
+
+  const std::vector<XWalkExtensionCatalog::Entry>& entries =
+      opened->entries();
+  ASSERT_EQ(2u, entries.size());
+  EXPECT_EQ("echo", entries[0].name);
+  EXPECT_EQ("exports.echo = function() {};", entries[0].js_api);
+  EXPECT_TRUE(entries[0].entry_points.empty());
+  EXPECT_EQ("tizen.time", entries[1].name);
+  EXPECT_EQ("exports.now = function() {};", entries[1].js_api);
+  ASSERT_EQ(1u, entries[1].entry_points.size());
+  EXPECT_EQ("tizen.TZDate", entries[1].entry_points[0]);
+  EXPECT_EQ(16u, entries[1].max_batch_size);
+  EXPECT_EQ(4, entries[1].max_batch_delay.InMilliseconds());
+}
+
+TEST(XWalkExtensionCatalogTest, EmptyCatalog) {
+  scoped_refptr<XWalkExtensionCatalog> catalog = XWalkExtensionCatalog::Create(
+      std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>());
+  ASSERT_TRUE(catalog);
+  EXPECT_TRUE(catalog->entries().empty());
+}
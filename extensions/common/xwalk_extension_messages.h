@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include "base/memory/shared_memory.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "ipc/ipc_channel_handle.h"
 #include "ipc/ipc_message_macros.h"
@@ -30,9 +31,22 @@ IPC_MESSAGE_CONTROL2(XWalkExtensionProcessMsg_RegisterExtensions,  // NOLINT(*)
                      base::FilePath /* extensions path */,
                      base::ListValue /* browser variables */)
 
+// An Extension Process can serve many Render Processes, each one gets its
+// own channel. Sent after XWalkExtensionProcessMsg_RegisterExtensions.
+IPC_MESSAGE_CONTROL1(XWalkExtensionProcessMsg_CreateRenderProcessChannel,  // NOLINT(*)
+                     int /* render process id */)
+
+IPC_MESSAGE_CONTROL1(XWalkExtensionProcessMsg_CloseRenderProcessChannel,  // NOLINT(*)
+                     int /* render process id */)
+
+// Sent when the permissions of the application served by the Extension
+// Process change, the decisions it cached are no longer valid.
+IPC_MESSAGE_CONTROL0(XWalkExtensionProcessMsg_ClearPermissionCache)  // NOLINT(*)
+
 // This implies that extensions are all loaded and Extension Process
-// is ready to be used.
-IPC_MESSAGE_CONTROL1(XWalkExtensionProcessHostMsg_RenderProcessChannelCreated, // NOLINT(*)
+// is ready to be used by the given Render Process.
+IPC_MESSAGE_CONTROL2(XWalkExtensionProcessHostMsg_RenderProcessChannelCreated, // NOLINT(*)
+                     int /* render process id */,
                      IPC::ChannelHandle /* channel id */)
 
 // Message from Render Process to Browser Process. This message needs
@@ -41,6 +55,11 @@ IPC_MESSAGE_CONTROL1(XWalkExtensionProcessHostMsg_RenderProcessChannelCreated, /
 IPC_SYNC_MESSAGE_CONTROL0_1(XWalkExtensionProcessHostMsg_GetExtensionProcessChannel,  // NOLINT(*)
                             IPC::ChannelHandle /* channel id */)
 
+// Message from Browser Process to a Render Process whose Extension Process
+// died and was launched again. The Render Process asks for the new channel
+// with the message above.
+IPC_MESSAGE_CONTROL0(XWalkExtensionClientMsg_ExtensionProcessRestarted)  // NOLINT(*)
+
 // Message from Extension Process to Browser Process
 IPC_ENUM_TRAITS_MAX_VALUE(xwalk::extensions::RuntimePermission,
                           xwalk::extensions::UNDEFINED_RUNTIME_PERM)
@@ -53,6 +72,26 @@ IPC_SYNC_MESSAGE_CONTROL2_1(XWalkExtensionProcessHostMsg_RegisterPermissions, //
                             std::string,
                             bool)
 
+// Non-blocking variants of the two above. Each request is answered by the
+// message below it, carrying the same request id. Permission tables are
+// sent in batches, those registered while the extensions are loading all
+// go in the same message.
+IPC_MESSAGE_CONTROL3(XWalkExtensionProcessHostMsg_CheckAPIAccessControlAsync, // NOLINT(*)
+                     int /* request id */,
+                     std::string /* extension name */,
+                     std::string /* api name */)
+IPC_MESSAGE_CONTROL2(XWalkExtensionProcessMsg_APIAccessControlChecked, // NOLINT(*)
+                     int /* request id */,
+                     xwalk::extensions::RuntimePermission)
+
+IPC_MESSAGE_CONTROL3(XWalkExtensionProcessHostMsg_RegisterPermissionsBatch, // NOLINT(*)
+                     int /* request id */,
+                     std::vector<std::string> /* extension names */,
+                     std::vector<std::string> /* permission tables */)
+IPC_MESSAGE_CONTROL2(XWalkExtensionProcessMsg_PermissionsRegistered, // NOLINT(*)
+                     int /* request id */,
+                     std::vector<bool> /* results */)
+
 // We use a separated message class for Client<->Server communication
 // to ease filtering.
 #undef IPC_MESSAGE_START
@@ -62,12 +101,20 @@ IPC_STRUCT_BEGIN(XWalkExtensionServerMsg_ExtensionRegisterParams)
   IPC_STRUCT_MEMBER(std::string, name)
   IPC_STRUCT_MEMBER(std::string, js_api)
   IPC_STRUCT_MEMBER(std::vector<std::string>, entry_points)
+  IPC_STRUCT_MEMBER(size_t, max_batch_size)
+  IPC_STRUCT_MEMBER(base::TimeDelta, max_batch_delay)
 IPC_STRUCT_END()
 
 IPC_MESSAGE_CONTROL2(XWalkExtensionServerMsg_CreateInstance,  // NOLINT(*)
                      int64_t /* instance id */,
                      std::string /* extension name */)
 
+// The instances created by the client since its last message, sent ahead of
+// the next one instead of a CreateInstance each.
+IPC_MESSAGE_CONTROL2(XWalkExtensionServerMsg_CreateInstances,  // NOLINT(*)
+                     std::vector<int64_t> /* instance ids */,
+                     std::vector<std::string> /* extension names */)
+
 IPC_MESSAGE_CONTROL2(XWalkExtensionServerMsg_PostMessageToNative,  // NOLINT(*)
                      int64_t /* instance id */,
                      base::ListValue /* contents */)
@@ -76,10 +123,93 @@ IPC_MESSAGE_CONTROL2(XWalkExtensionClientMsg_PostMessageToJS,  // NOLINT(*)
                      int64_t /* instance id */,
                      base::ListValue /* contents */)
 
+// Messages made of a single string, typically JSON. They are sent as is
+// instead of being converted to a base::Value and wrapped in a ListValue.
+IPC_MESSAGE_CONTROL2(XWalkExtensionServerMsg_PostStringMessageToNative,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     std::string /* message */)
+
+IPC_MESSAGE_CONTROL2(XWalkExtensionClientMsg_PostStringMessageToJS,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     std::string /* message */)
+
+// The bytes of an ArrayBuffer or typed array posted from JavaScript, handed
+// to the instance as a BinaryValue.
+IPC_MESSAGE_CONTROL2(XWalkExtensionServerMsg_PostBinaryMessageToNative,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     std::vector<char> /* message */)
+
+// Messages queued for instances of extensions with batching enabled. Batches
+// sent to native carry messages of a single instance, so they are routed like
+// regular messages: the client splits its queue in runs of one instance.
+// Batches sent to JS can mix instances, the id at each index of the vector is
+// the target of the message with the same index.
+IPC_MESSAGE_CONTROL2(XWalkExtensionServerMsg_PostMessageBatchToNative,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     base::ListValue /* contents */)
+
+IPC_MESSAGE_CONTROL2(XWalkExtensionClientMsg_PostMessageBatchToJS,  // NOLINT(*)
+                     std::vector<int64_t> /* instance ids */,
+                     base::ListValue /* contents */)
+
 IPC_MESSAGE_CONTROL2(XWalkExtensionClientMsg_PostOutOfLineMessageToJS,  // NOLINT(*)
                      base::SharedMemoryHandle /* message buffer */,
                      size_t /* buffer size */)
 
+// Carries a single big string or binary message in a shared memory segment
+// created for it. Unlike out of line messages it holds the bare payload, which
+// the renderer copies straight into V8 without building a base::Value.
+IPC_MESSAGE_CONTROL4(XWalkExtensionClientMsg_PostSharedMessageToJS,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     base::SharedMemoryHandle /* payload buffer */,
+                     uint32_t /* payload size */,
+                     bool /* is binary */)
+
+// Announces a binary message pool, a read-only segment that stays mapped for
+// the lifetime of the server. Sent once, before the first message using it.
+IPC_MESSAGE_CONTROL3(XWalkExtensionClientMsg_BinaryPoolCreated,  // NOLINT(*)
+                     int /* pool id */,
+                     base::SharedMemoryHandle /* pool buffer */,
+                     size_t /* buffer size */)
+
+IPC_MESSAGE_CONTROL4(XWalkExtensionClientMsg_PostBinaryMessageToJS,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     int /* pool id */,
+                     uint32_t /* offset */,
+                     uint32_t /* length */)
+
+// Announces the read-only segment holding the state published by an instance,
+// see XWalkExtensionPublishedState. Sent again with a bigger segment when the
+// state outgrows the previous one, which the client then unmaps.
+IPC_MESSAGE_CONTROL3(XWalkExtensionClientMsg_PublishedStateCreated,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     base::SharedMemoryHandle /* state buffer */,
+                     size_t /* buffer size */)
+
+// Sent after each publication, the state itself is read from the segment.
+IPC_MESSAGE_CONTROL2(XWalkExtensionClientMsg_PublishedStateChanged,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     uint32_t /* version */)
+
+// Gives back the pool slot used by a binary message so it can be reused. The
+// instance id is used for routing the message to the right server only.
+IPC_MESSAGE_CONTROL2(XWalkExtensionServerMsg_ReleaseBinaryMessage,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     uint32_t /* offset */)
+
+// Asynchronous replacement for XWalkExtensionServerMsg_SendSyncMessageToNative
+// that doesn't block the renderer. Many requests can be in flight for the same
+// instance, each reply carries the id of the request it answers.
+IPC_MESSAGE_CONTROL3(XWalkExtensionServerMsg_PostRequestToNative,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     int /* request id */,
+                     base::ListValue /* contents */)
+
+IPC_MESSAGE_CONTROL3(XWalkExtensionClientMsg_PostReplyToJS,  // NOLINT(*)
+                     int64_t /* instance id */,
+                     int /* request id */,
+                     base::ListValue /* contents */)
+
 IPC_SYNC_MESSAGE_CONTROL2_1(XWalkExtensionServerMsg_SendSyncMessageToNative,  // NOLINT(*)
                             int64_t /* instance id */,
                             base::ListValue /* input contents */,
@@ -88,6 +218,20 @@ IPC_SYNC_MESSAGE_CONTROL2_1(XWalkExtensionServerMsg_SendSyncMessageToNative,  //
 IPC_SYNC_MESSAGE_CONTROL0_1(XWalkExtensionServerMsg_GetExtensions,  // NOLINT(*)
                             std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams> /* output contents */) // NOLINT(*)
 
+// Asynchronous replacement for XWalkExtensionServerMsg_GetExtensions, so the
+// renderer doesn't block at startup. Answered by ExtensionsRegistered.
+IPC_MESSAGE_CONTROL0(XWalkExtensionServerMsg_RequestExtensions)  // NOLINT(*)
+
+IPC_MESSAGE_CONTROL1(XWalkExtensionClientMsg_ExtensionsRegistered,  // NOLINT(*)
+                     std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams> /* extensions */) // NOLINT(*)
+
+// Answers RequestExtensions with a read-only XWalkExtensionCatalog, mapped
+// instead of copying the JS APIs. ExtensionsRegistered is sent instead if
+// the catalog can't be shared.
+IPC_MESSAGE_CONTROL2(XWalkExtensionClientMsg_ExtensionCatalogShared,  // NOLINT(*)
+                     base::SharedMemoryHandle /* catalog handle */,
+                     size_t /* catalog size */)
+
 IPC_MESSAGE_CONTROL1(XWalkExtensionServerMsg_DestroyInstance,  // NOLINT(*)
                      int64_t /* instance id */)
 
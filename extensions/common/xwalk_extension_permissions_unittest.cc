@@ -0,0 +1,194 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "xwalk/extensions/common/xwalk_extension.h"
+#include "xwalk/extensions/common/xwalk_external_adapter.h"
+#include "xwalk/extensions/public/XW_Extension_Permissions.h"
+
+using xwalk::extensions::XWalkExtension;
+using xwalk::extensions::XWalkExtensionInstance;
+using xwalk::extensions::XWalkExternalAdapter;
+
+namespace {
+
+class TestExtension : public XWalkExtension {
+ public:
+  TestExtension() {
+    set_name("test");
+  }
+
+  virtual XWalkExtensionInstance* CreateInstance() OVERRIDE {
+    return NULL;
+  }
+};
+
+// Answers the blocking requests only, the non-blocking ones use the default
+// implementations.
+class BlockingPermissionsDelegate : public XWalkExtension::PermissionsDelegate {
+ public:
+  BlockingPermissionsDelegate() : allowed_(true) {}
+
+  virtual bool CheckAPIAccessControl(const std::string& extension_name,
+                                     const std::string& api_name) OVERRIDE {
+    requests_.push_back(extension_name + "." + api_name);
+    return allowed_;
+  }
+
+  virtual bool RegisterPermissions(const std::string& extension_name,
+                                   const std::string& perm_table) OVERRIDE {
+    requests_.push_back(extension_name + ":" + perm_table);
+    return allowed_;
+  }
+
+  void set_allowed(bool allowed) { allowed_ = allowed; }
+  const std::vector<std::string>& requests() const { return requests_; }
+
+ private:
+  bool allowed_;
+  std::vector<std::string> requests_;
+};
+
+// Holds the non-blocking requests until told to answer them.
+class AsyncPermissionsDelegate : public XWalkExtension::PermissionsDelegate {
+ public:
+  virtual bool CheckAPIAccessControl(const std::string& extension_name,
+                                     const std::string& api_name) OVERRIDE {
+    ADD_FAILURE() << "The blocking check shouldn't be used.";
+    return false;
+  }
+
+  virtual void CheckAPIAccessControlAsync(
+      const std::string& extension_name,
+      const std::string& api_name,
+      const XWalkExtension::PermissionResultCallback& callback) OVERRIDE {
+    callbacks_.push_back(callback);
+  }
+
+  virtual void RegisterPermissionsAsync(
+      const std::string& extension_name,
+      const std::string& perm_table,
+      const XWalkExtension::PermissionResultCallback& callback) OVERRIDE {
+    callbacks_.push_back(callback);
+  }
+
+  void Answer(size_t index, bool result) {
+    callbacks_[index].Run(result);
+  }
+
+  size_t pending() const { return callbacks_.size(); }
+
+ private:
+  std::vector<XWalkExtension::PermissionResultCallback> callbacks_;
+};
+
+// Records the answers, -1 until there is one.
+class ResultRecorder {
+ public:
+  ResultRecorder() : result_(-1), calls_(0) {}
+
+  XWalkExtension::PermissionResultCallback Callback() {
+    return base::Bind(&ResultRecorder::OnResult, base::Unretained(this));
+  }
+
+  int result() const { return result_; }
+  int calls() const { return calls_; }
+
+ private:
+  void OnResult(bool result) {
+    result_ = result;
+    ++calls_;
+  }
+
+  int result_;
+  int calls_;
+};
+
+void OnExternalPermissionResult(XW_Extension extension, int result,
+                                void* user_data) {
+  ++*static_cast<int*>(user_data);
+}
+
+}  // namespace
+
+TEST(XWalkExtensionPermissionsTest, AsyncWithoutDelegate) {
+  TestExtension extension;
+  ResultRecorder check;
+  extension.CheckAPIAccessControlAsync("api", check.Callback());
+  EXPECT_EQ(1, check.calls());
+  EXPECT_EQ(0, check.result());
+
+  ResultRecorder registration;
+  extension.RegisterPermissionsAsync("{}", registration.Callback());
+  EXPECT_EQ(1, registration.calls());
+  EXPECT_EQ(0, registration.result());
+}
+
+TEST(XWalkExtensionPermissionsTest, AsyncFallsBackToBlocking) {
+  TestExtension extension;
+  BlockingPermissionsDelegate delegate;
+  extension.set_permissions_delegate(&delegate);
+
+  ResultRecorder allowed;
+  extension.CheckAPIAccessControlAsync("api", allowed.Callback());
+  EXPECT_EQ(1, allowed.calls());
+  EXPECT_EQ(1, allowed.result());
+
+  delegate.set_allowed(false);
+  ResultRecorder denied;
+  extension.RegisterPermissionsAsync("{}", denied.Callback());
+  EXPECT_EQ(1, denied.calls());
+  EXPECT_EQ(0, denied.result());
+
+  ASSERT_EQ(2u, delegate.requests().size());
+  EXPECT_EQ("test.api", delegate.requests()[0]);
+  EXPECT_EQ("test:{}", delegate.requests()[1]);
+}
+
+TEST(XWalkExtensionPermissionsTest, AsyncAnsweredLater) {
+  TestExtension extension;
+  AsyncPermissionsDelegate delegate;
+  extension.set_permissions_delegate(&delegate);
+
+  ResultRecorder check;
+  ResultRecorder registration;
+  extension.CheckAPIAccessControlAsync("api", check.Callback());
+  extension.RegisterPermissionsAsync("{}", registration.Callback());
+  ASSERT_EQ(2u, delegate.pending());
+  EXPECT_EQ(0, check.calls());
+  EXPECT_EQ(0, registration.calls());
+
+  delegate.Answer(1, true);
+  EXPECT_EQ(0, check.calls());
+  EXPECT_EQ(1, registration.result());
+  delegate.Answer(0, false);
+  EXPECT_EQ(1, check.calls());
+  EXPECT_EQ(0, check.result());
+}
+
+TEST(XWalkExtensionPermissionsTest, ExternalInterface) {
+  const XW_Internal_PermissionsInterface_2* permissions =
+      static_cast<const XW_Internal_PermissionsInterface_2*>(
+          XWalkExternalAdapter::GetInterface(
+              XW_INTERNAL_PERMISSIONS_INTERFACE_2));
+  ASSERT_TRUE(permissions);
+  EXPECT_TRUE(permissions->CheckAPIAccessControlAsync);
+  EXPECT_TRUE(permissions->RegisterPermissionsAsync);
+  EXPECT_EQ(permissions, XWalkExternalAdapter::GetInterface(
+      XW_INTERNAL_PERMISSIONS_INTERFACE));
+  EXPECT_TRUE(XWalkExternalAdapter::GetInterface(
+      XW_INTERNAL_PERMISSIONS_INTERFACE_1));
+
+  // The callbacks of the calls for unknown extensions are never run.
+  int calls = 0;
+  permissions->CheckAPIAccessControlAsync(
+      0, "api", &OnExternalPermissionResult, &calls);
+  permissions->RegisterPermissionsAsync(
+      0, "{}", &OnExternalPermissionResult, &calls);
+  EXPECT_EQ(0, calls);
+}
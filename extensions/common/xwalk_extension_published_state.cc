@@ -0,0 +1,145 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/common/xwalk_extension_published_state.h"
+
+#include <string.h>
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/logging.h"
+#include "base/threading/platform_thread.h"
+
+namespace xwalk {
+namespace extensions {
+
+namespace {
+
+// A write only takes a memcpy, readers giving up after this many attempts
+// are racing with a writer publishing in a tight loop.
+const int kMaxReadAttempts = 64;
+
+}  // namespace
+
+struct XWalkExtensionPublishedState::Header {
+  base::subtle::Atomic32 sequence;
+  base::subtle::Atomic32 version;
+  uint32_t size;
+};
+
+XWalkExtensionPublishedState::XWalkExtensionPublishedState()
+    : read_only_(false) {}
+
+XWalkExtensionPublishedState::~XWalkExtensionPublishedState() {}
+
+bool XWalkExtensionPublishedState::Create(size_t capacity) {
+  base::SharedMemoryCreateOptions options;
+  options.size = sizeof(Header) + capacity;
+  options.share_read_only = true;
+
+  shared_memory_.reset(new base::SharedMemory);
+  read_only_ = false;
+  if (!shared_memory_->Create(options) || !shared_memory_->Map(options.size)) {
+    LOG(WARNING) << "Can't create shared memory for published state";
+    shared_memory_.reset();
+    return false;
+  }
+  memset(shared_memory_->memory(), 0, sizeof(Header));
+  return true;
+}
+
+bool XWalkExtensionPublishedState::Open(base::SharedMemoryHandle handle,
+                                        size_t mapped_size) {
+  if (mapped_size < sizeof(Header)) {
+    base::SharedMemory::CloseHandle(handle);
+    return false;
+  }
+
+  shared_memory_.reset(new base::SharedMemory(handle, true));
+  read_only_ = true;
+  if (!shared_memory_->Map(mapped_size)) {
+    shared_memory_.reset();
+    return false;
+  }
+  return true;
+}
+
+bool XWalkExtensionPublishedState::Write(const std::string& state,
+                                         uint32_t version) {
+  if (!shared_memory_ || read_only_ || state.size() > capacity())
+    return false;
+
+  Header* header = this->header();
+  base::subtle::Atomic32 sequence =
+      base::subtle::NoBarrier_Load(&header->sequence);
+  base::subtle::NoBarrier_Store(&header->sequence, sequence + 1);
+  base::subtle::MemoryBarrier();
+
+  header->size = state.size();
+  memcpy(data(), state.data(), state.size());
+  base::subtle::NoBarrier_Store(&header->version, version);
+
+  base::subtle::Release_Store(&header->sequence, sequence + 2);
+  return true;
+}
+
+bool XWalkExtensionPublishedState::Read(std::string* state,
+                                        uint32_t* version) const {
+  if (!shared_memory_)
+    return false;
+
+  Header* header = this->header();
+  for (int i = 0; i < kMaxReadAttempts; ++i) {
+    base::subtle::Atomic32 sequence =
+        base::subtle::Acquire_Load(&header->sequence);
+    if (sequence & 1) {
+      base::PlatformThread::YieldCurrentThread();
+      continue;
+    }
+
+    // The size is only trusted once the sequence is known to be unchanged.
+    size_t size = std::min<size_t>(header->size, capacity());
+    state->assign(data(), size);
+    *version = base::subtle::NoBarrier_Load(&header->version);
+    base::subtle::MemoryBarrier();
+
+    if (base::subtle::NoBarrier_Load(&header->sequence) == sequence)
+      return *version != 0;
+  }
+  return false;
+}
+
+uint32_t XWalkExtensionPublishedState::version() const {
+  if (!shared_memory_)
+    return 0;
+  return base::subtle::Acquire_Load(&header()->version);
+}
+
+bool XWalkExtensionPublishedState::ShareReadOnlyToProcess(
+    base::ProcessHandle process, base::SharedMemoryHandle* handle) {
+  return shared_memory_ &&
+         shared_memory_->ShareReadOnlyToProcess(process, handle);
+}
+
+size_t XWalkExtensionPublishedState::mapped_size() const {
+  return shared_memory_ ? shared_memory_->mapped_size() : 0;
+}
+
+size_t XWalkExtensionPublishedState::capacity() const {
+  if (mapped_size() < sizeof(Header))
+    return 0;
+  return mapped_size() - sizeof(Header);
+}
+
+XWalkExtensionPublishedState::Header*
+XWalkExtensionPublishedState::header() const {
+  return static_cast<Header*>(shared_memory_->memory());
+}
+
+char* XWalkExtensionPublishedState::data() const {
+  return static_cast<char*>(shared_memory_->memory()) + sizeof(Header);
+}
+
+}  // namespace extensions
+}  // namespace xwalk
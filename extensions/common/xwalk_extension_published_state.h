@@ -0,0 +1,69 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_PUBLISHED_STATE_H_
+#define XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_PUBLISHED_STATE_H_
+
+#include <stdint.h>
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/process/process_handle.h"
+
+namespace xwalk {
+namespace extensions {
+
+// A shared memory segment holding the latest state published by an extension
+// instance, typically JSON, so JavaScript can read read-mostly state without
+// a round trip to native. The server writes it, the client maps it read-only.
+//
+// Writes are guarded by a sequence counter: it is odd while a write is in
+// progress, and readers retry when it changed during their copy. The version
+// grows with each publication and tells the readers whether the state they
+// cached is still current without copying it.
+class XWalkExtensionPublishedState {
+ public:
+  XWalkExtensionPublishedState();
+  ~XWalkExtensionPublishedState();
+
+  // Creates and maps a segment able to hold |capacity| bytes of state.
+  bool Create(size_t capacity);
+
+  // Maps the read-only segment created by the other side.
+  bool Open(base::SharedMemoryHandle handle, size_t mapped_size);
+
+  // Replaces the state, returns false if it doesn't fit or the segment was
+  // opened read-only. There must be a single writer.
+  bool Write(const std::string& state, uint32_t version);
+
+  // Copies a consistent state. Returns false if nothing was written yet, or
+  // if writes kept on racing with the copy.
+  bool Read(std::string* state, uint32_t* version) const;
+
+  // The version of the state, 0 if nothing was written yet.
+  uint32_t version() const;
+
+  bool ShareReadOnlyToProcess(base::ProcessHandle process,
+                              base::SharedMemoryHandle* handle);
+
+  size_t capacity() const;
+  size_t mapped_size() const;
+
+ private:
+  struct Header;
+
+  Header* header() const;
+  char* data() const;
+
+  scoped_ptr<base::SharedMemory> shared_memory_;
+  bool read_only_;
+
+  DISALLOW_COPY_AND_ASSIGN(XWalkExtensionPublishedState);
+};
+
+}  // namespace extensions
+}  // namespace xwalk
+
+#endif  // XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_PUBLISHED_STATE_H_
@@ -0,0 +1,79 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/common/xwalk_extension_published_state.h"
+
+#include <string>
+
+#include "base/process/process_handle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::extensions::XWalkExtensionPublishedState;
+
+namespace {
+
+const size_t kCapacity = 64;
+
+}  // namespace
+
+TEST(XWalkExtensionPublishedStateTest, WriteAndRead) {
+  XWalkExtensionPublishedState state;
+  ASSERT_TRUE(state.Create(kCapacity));
+  EXPECT_LE(kCapacity, state.capacity());
+
+  // Nothing was published yet.
+  std::string data;
+  uint32_t version;
+  EXPECT_FALSE(state.Read(&data, &version));
+  EXPECT_EQ(0u, state.version());
+
+  EXPECT_TRUE(state.Write("{\"width\":100}", 1));
+  EXPECT_EQ(1u, state.version());
+  ASSERT_TRUE(state.Read(&data, &version));
+  EXPECT_EQ("{\"width\":100}", data);
+  EXPECT_EQ(1u, version);
+
+  // A smaller state replaces the whole previous one.
+  EXPECT_TRUE(state.Write("{}", 2));
+  ASSERT_TRUE(state.Read(&data, &version));
+  EXPECT_EQ("{}", data);
+  EXPECT_EQ(2u, version);
+}
+
+TEST(XWalkExtensionPublishedStateTest, StateTooBig) {
+  XWalkExtensionPublishedState state;
+  ASSERT_TRUE(state.Create(kCapacity));
+
+  EXPECT_TRUE(state.Write("{}", 1));
+  EXPECT_FALSE(state.Write(std::string(state.capacity() + 1, 'x'), 2));
+
+  // The previous state is left untouched.
+  std::string data;
+  uint32_t version;
+  ASSERT_TRUE(state.Read(&data, &version));
+  EXPECT_EQ("{}", data);
+  EXPECT_EQ(1u, version);
+}
+
+TEST(XWalkExtensionPublishedStateTest, ReadOnlyMapping) {
+  XWalkExtensionPublishedState writer;
+  ASSERT_TRUE(writer.Create(kCapacity));
+
+  base::SharedMemoryHandle handle;
+  ASSERT_TRUE(writer.ShareReadOnlyToProcess(base::GetCurrentProcessHandle(),
+                                            &handle));
+  XWalkExtensionPublishedState reader;
+  ASSERT_TRUE(reader.Open(handle, writer.mapped_size()));
+
+  // Writes are seen by the reader without any message.
+  EXPECT_TRUE(writer.Write("[1,2,3]", 7));
+  EXPECT_EQ(7u, reader.version());
+  std::string data;
+  uint32_t version;
+  ASSERT_TRUE(reader.Read(&data, &version));
+  EXPECT_EQ("[1,2,3]", data);
+  EXPECT_EQ(7u, version);
+
+  EXPECT_FALSE(reader.Write("[]", 8));
+}
@@ -4,17 +4,24 @@
 
 #include "xwalk/extensions/common/xwalk_extension_server.h"
 
+#include <algorithm>
+
+#include "base/debug/trace_event.h"
 #include "base/file_util.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
+#include "base/json/json_writer.h"
 #include "base/memory/shared_memory.h"
+#include "base/message_loop/message_loop_proxy.h"
 #include "base/strings/string16.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/stl_util.h"
 #include "content/public/browser/render_process_host.h"
 #include "ipc/ipc_message.h"
 #include "ipc/ipc_sender.h"
+#include "xwalk/extensions/common/xwalk_extension_binary_pool.h"
 #include "xwalk/extensions/common/xwalk_extension_messages.h"
+#include "xwalk/extensions/common/xwalk_extension_published_state.h"
 #include "xwalk/extensions/common/xwalk_external_extension.h"
 
 namespace xwalk {
@@ -23,30 +30,98 @@ namespace extensions {
 // Threshold to determine using shared memory or message
 const size_t kInlineMessageMaxSize = 256 * 1024;
 
+// Geometry of the binary message pool. Payloads bigger than a slot, or posted
+// while all slots are in flight, take the out of line message path.
+const size_t kBinaryPoolSlotSize = 2 * 1024 * 1024;
+const size_t kBinaryPoolSlotCount = 8;
+
+// Messages queued by the batched instances of a server before they are sent
+// anyway, whatever the settings of their extensions.
+const size_t kMaxQueuedMessagesToJS = 64;
+
+// Published states get segments with room to grow, so small changes don't
+// need a new one.
+const size_t kMinPublishedStateCapacity = 4 * 1024;
+
+// Reaches the server from the flushes posted by the batched instances, on
+// whatever thread they run, until the server is gone.
+class XWalkExtensionServer::FlushHandle
+    : public base::RefCountedThreadSafe<FlushHandle> {
+ public:
+  explicit FlushHandle(XWalkExtensionServer* server) : server_(server) {}
+
+  void Flush() {
+    base::AutoLock l(lock_);
+    if (server_)
+      server_->FlushQueuedMessages();
+  }
+
+  void Invalidate() {
+    base::AutoLock l(lock_);
+    server_ = NULL;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<FlushHandle>;
+  ~FlushHandle() {}
+
+  base::Lock lock_;
+  XWalkExtensionServer* server_;
+
+  DISALLOW_COPY_AND_ASSIGN(FlushHandle);
+};
+
 XWalkExtensionServer::XWalkExtensionServer()
     : sender_(NULL),
+      owns_extensions_(true),
+      extensions_owner_(NULL),
       renderer_process_handle_(base::kNullProcessHandle),
-      permissions_delegate_(NULL) {}
+      flush_handle_(new FlushHandle(this)),
+      binary_pool_failed_(false),
+      permissions_delegate_(NULL),
+      handled_message_size_(0) {}
+
+XWalkExtensionServer::PublishedState::PublishedState()
+    : version(0) {}
+
+XWalkExtensionServer::PublishedState::~PublishedState() {}
 
 XWalkExtensionServer::~XWalkExtensionServer() {
+  flush_handle_->Invalidate();
   DeleteInstanceMap();
-  STLDeleteValues(&extensions_);
+  if (owns_extensions_)
+    STLDeleteValues(&extensions_);
 }
 
 bool XWalkExtensionServer::OnMessageReceived(const IPC::Message& message) {
+  handled_message_size_ = message.size();
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(XWalkExtensionServer, message)
     IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_CreateInstance,
         OnCreateInstance)
+    IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_CreateInstances,
+        OnCreateInstances)
     IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_DestroyInstance,
         OnDestroyInstance)
     IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_PostMessageToNative,
         OnPostMessageToNative)
+    IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_PostStringMessageToNative,
+        OnPostStringMessageToNative)
+    IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_PostBinaryMessageToNative,
+        OnPostBinaryMessageToNative)
+    IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_PostMessageBatchToNative,
+        OnPostMessageBatchToNative)
     IPC_MESSAGE_HANDLER_DELAY_REPLY(
         XWalkExtensionServerMsg_SendSyncMessageToNative,
         OnSendSyncMessageToNative)
     IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_GetExtensions,
         OnGetExtensions)
+    IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_RequestExtensions,
+        OnRequestExtensions)
+    IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_ReleaseBinaryMessage,
+        OnReleaseBinaryMessage)
+    IPC_MESSAGE_HANDLER(XWalkExtensionServerMsg_PostRequestToNative,
+        OnPostRequestToNative)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
@@ -57,6 +132,17 @@ void XWalkExtensionServer::OnChannelConnected(int32 peer_pid) {
   CHECK(base::OpenProcessHandle(peer_pid, &renderer_process_handle_));
 }
 
+void XWalkExtensionServer::OnCreateInstances(
+    const std::vector<int64_t>& instance_ids,
+    const std::vector<std::string>& names) {
+  if (instance_ids.size() != names.size()) {
+    LOG(WARNING) << "Got malformed instance batch.";
+    return;
+  }
+  for (size_t i = 0; i < instance_ids.size(); ++i)
+    OnCreateInstance(instance_ids[i], names[i]);
+}
+
 void XWalkExtensionServer::OnCreateInstance(int64_t instance_id,
     std::string name) {
   ExtensionMap::const_iterator it = extensions_.find(name);
@@ -74,31 +160,56 @@ void XWalkExtensionServer::OnCreateInstance(int64_t instance_id,
     return;
   }
 
-  instance->SetPostMessageCallback(
-      base::Bind(&XWalkExtensionServer::PostMessageToJSCallback,
-                 base::Unretained(this), instance_id));
+  XWalkExtension* extension = it->second;
+  if (extension->is_batching_enabled()) {
+    instance->SetPostMessageCallback(
+        base::Bind(&XWalkExtensionServer::QueueMessageToJSCallback,
+                   base::Unretained(this), instance_id,
+                   extension->max_batch_size(),
+                   extension->max_batch_delay()));
+  } else {
+    instance->SetPostMessageCallback(
+        base::Bind(&XWalkExtensionServer::PostMessageToJSCallback,
+                   base::Unretained(this), instance_id));
+  }
 
   instance->SetSendSyncReplyCallback(
       base::Bind(&XWalkExtensionServer::SendSyncReplyToJSCallback,
                  base::Unretained(this), instance_id));
 
+  instance->SetPostBinaryMessageCallback(
+      base::Bind(&XWalkExtensionServer::PostBinaryMessageToJSCallback,
+                 base::Unretained(this), instance_id));
+
+  instance->SetSendReplyCallback(
+      base::Bind(&XWalkExtensionServer::SendReplyToJSCallback,
+                 base::Unretained(this), instance_id));
+
+  instance->SetPublishStateCallback(
+      base::Bind(&XWalkExtensionServer::PublishStateToJSCallback,
+                 base::Unretained(this), instance_id));
+
   InstanceExecutionData data;
   data.instance = instance;
   data.pending_reply = NULL;
+  data.messages_received = 0;
 
   instances_[instance_id] = data;
+  stats_.RegisterInstance(instance_id, name);
 }
 
 void XWalkExtensionServer::OnPostMessageToNative(int64_t instance_id,
     const base::ListValue& msg) {
-  InstanceMap::const_iterator it = instances_.find(instance_id);
+  TRACE_EVENT0(kExtensionTraceCategory, "XWalkExtensionServer::HandleMessage");
+  InstanceMap::iterator it = instances_.find(instance_id);
   if (it == instances_.end()) {
     LOG(WARNING) << "Can't PostMessage to invalid Extension instance id: "
                  << instance_id;
     return;
   }
 
-  const InstanceExecutionData& data = it->second;
+  InstanceExecutionData& data = it->second;
+  TraceMessagesReceived(instance_id, &data, 1);
 
   // The const_cast is needed to remove the only Value contained by the
   // ListValue (which is solely used as wrapper, since Value doesn't
@@ -111,6 +222,90 @@ void XWalkExtensionServer::OnPostMessageToNative(int64_t instance_id,
   data.instance->HandleMessage(value.Pass());
 }
 
+void XWalkExtensionServer::OnPostStringMessageToNative(int64_t instance_id,
+    const std::string& msg) {
+  TRACE_EVENT0(kExtensionTraceCategory, "XWalkExtensionServer::HandleMessage");
+  InstanceMap::iterator it = instances_.find(instance_id);
+  if (it == instances_.end()) {
+    LOG(WARNING) << "Can't PostMessage to invalid Extension instance id: "
+                 << instance_id;
+    return;
+  }
+
+  TraceMessagesReceived(instance_id, &it->second, 1);
+  it->second.instance->HandleMessage(
+      scoped_ptr<base::Value>(new base::StringValue(msg)));
+}
+
+void XWalkExtensionServer::OnPostBinaryMessageToNative(int64_t instance_id,
+    const std::vector<char>& msg) {
+  TRACE_EVENT0(kExtensionTraceCategory, "XWalkExtensionServer::HandleMessage");
+  InstanceMap::iterator it = instances_.find(instance_id);
+  if (it == instances_.end()) {
+    LOG(WARNING) << "Can't PostMessage to invalid Extension instance id: "
+                 << instance_id;
+    return;
+  }
+
+  TraceMessagesReceived(instance_id, &it->second, 1);
+  it->second.instance->HandleMessage(scoped_ptr<base::Value>(
+      base::BinaryValue::CreateWithCopiedBuffer(
+          msg.empty() ? NULL : &msg[0], msg.size())));
+}
+
+void XWalkExtensionServer::OnPostMessageBatchToNative(int64_t instance_id,
+    const base::ListValue& msgs) {
+  TRACE_EVENT1(kExtensionTraceCategory,
+               "XWalkExtensionServer::HandleMessageBatch",
+               "messages", msgs.GetSize());
+  InstanceMap::iterator it = instances_.find(instance_id);
+  if (it == instances_.end()) {
+    LOG(WARNING) << "Can't PostMessage to invalid Extension instance id: "
+                 << instance_id;
+    return;
+  }
+
+  TraceMessagesReceived(instance_id, &it->second, msgs.GetSize());
+
+  // See OnPostMessageToNative() about the const_cast.
+  base::ListValue* list = const_cast<base::ListValue*>(&msgs);
+  while (!list->empty()) {
+    scoped_ptr<base::Value> value;
+    list->Remove(0, &value);
+    it->second.instance->HandleMessage(value.Pass());
+  }
+}
+
+void XWalkExtensionServer::OnPostRequestToNative(int64_t instance_id,
+    int request_id, const base::ListValue& msg) {
+  TRACE_EVENT0(kExtensionTraceCategory, "XWalkExtensionServer::HandleRequest");
+  TRACE_EVENT_FLOW_STEP0(kExtensionTraceCategory, "XWalkExtension::Request",
+                         GetRequestFlowId(instance_id, request_id),
+                         "HandleRequest");
+  InstanceMap::const_iterator it = instances_.find(instance_id);
+  if (it == instances_.end()) {
+    LOG(WARNING) << "Can't send request to invalid Extension instance id: "
+                 << instance_id;
+    return;
+  }
+
+  stats_.RecordMessagesToNative(instance_id, 1, handled_message_size_);
+  // See OnPostMessageToNative() about the const_cast.
+  scoped_ptr<base::Value> value;
+  const_cast<base::ListValue*>(&msg)->Remove(0, &value);
+  it->second.instance->HandleRequest(request_id, value.Pass());
+}
+
+void XWalkExtensionServer::TraceMessagesReceived(
+    int64_t instance_id, InstanceExecutionData* data, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    TRACE_EVENT_FLOW_END0(
+        kExtensionTraceCategory, "XWalkExtension::PostMessage",
+        GetMessageFlowId(instance_id, data->messages_received++));
+  }
+  stats_.RecordMessagesToNative(instance_id, count, handled_message_size_);
+}
+
 void XWalkExtensionServer::Initialize(IPC::Sender* sender) {
   base::AutoLock l(sender_lock_);
   DCHECK(!sender_);
@@ -189,9 +384,31 @@ bool XWalkExtensionServer::RegisterExtension(
   std::string name = extension->name();
   extension_symbols_.insert(name);
   extensions_[name] = extension.release();
+  catalog_ = NULL;
   return true;
 }
 
+void XWalkExtensionServer::UseExtensionsFrom(
+    const XWalkExtensionServer& owner) {
+  DCHECK(extensions_.empty());
+  owns_extensions_ = false;
+  extensions_owner_ = &owner;
+  extensions_ = owner.extensions_;
+  extension_symbols_ = owner.extension_symbols_;
+}
+
+scoped_refptr<XWalkExtensionCatalog>
+XWalkExtensionServer::GetExtensionCatalog() const {
+  if (extensions_owner_)
+    return extensions_owner_->GetExtensionCatalog();
+  if (!catalog_) {
+    std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams> extensions;
+    OnGetExtensions(&extensions);
+    catalog_ = XWalkExtensionCatalog::Create(extensions);
+  }
+  return catalog_;
+}
+
 bool XWalkExtensionServer::ContainsExtension(
     const std::string& extension_name) const {
   return ContainsKey(extensions_, extension_name);
@@ -199,16 +416,119 @@ bool XWalkExtensionServer::ContainsExtension(
 
 void XWalkExtensionServer::PostMessageToJSCallback(
     int64_t instance_id, scoped_ptr<base::Value> msg) {
+  // Keep the ordering with messages queued by batched instances.
+  FlushQueuedMessages();
+
+  // Strings, typically JSON, skip the Value serialization. Big ones go in
+  // a shared memory segment of their own.
+  const base::StringValue* string_value;
+  if (msg->GetAsString(&string_value)) {
+    const std::string& payload = string_value->GetString();
+    if (payload.size() <= kInlineMessageMaxSize) {
+      stats_.RecordMessagesToJS(instance_id, 1, payload.size());
+      Send(new XWalkExtensionClientMsg_PostStringMessageToJS(instance_id,
+                                                             payload));
+      return;
+    }
+    if (PostSharedMessageToJS(instance_id, payload.data(), payload.size(),
+                              false))
+      return;
+  }
+
+  // So do BinaryValues, they take the path of PostBinaryMessageToJS().
+  if (msg->IsType(base::Value::TYPE_BINARY)) {
+    const base::BinaryValue* binary_value =
+        static_cast<const base::BinaryValue*>(msg.get());
+    if (PostBinaryPayloadToJS(instance_id, binary_value->GetBuffer(),
+                              binary_value->GetSize()))
+      return;
+  }
+
+  PostValueMessageToJS(instance_id, msg.Pass());
+}
+
+void XWalkExtensionServer::PostValueMessageToJS(
+    int64_t instance_id, scoped_ptr<base::Value> msg) {
   base::ListValue wrapped_msg;
   wrapped_msg.Append(msg.release());
 
-  scoped_ptr<IPC::Message> message(
-      new XWalkExtensionClientMsg_PostMessageToJS(instance_id, wrapped_msg));
+  SendMaybeOutOfLine(make_scoped_ptr<IPC::Message>(
+      new XWalkExtensionClientMsg_PostMessageToJS(instance_id, wrapped_msg)),
+      instance_id);
+}
+
+void XWalkExtensionServer::QueueMessageToJSCallback(
+    int64_t instance_id, size_t max_batch_size,
+    base::TimeDelta max_batch_delay, scoped_ptr<base::Value> msg) {
+  scoped_refptr<base::MessageLoopProxy> loop =
+      base::MessageLoopProxy::current();
+
+  bool flush_now = false;
+  {
+    base::AutoLock l(queue_lock_);
+    queued_instance_ids_.push_back(instance_id);
+    // The size of a batch isn't attributed to its instances.
+    stats_.RecordMessagesToJS(instance_id, 1, 0);
+    queued_messages_.Append(msg.release());
+    size_t& instance_count = queued_message_counts_[instance_id];
+    ++instance_count;
+
+    // Without a message loop to flush later, degrade to unbatched delivery.
+    // The queue is shared by the batched instances, each extension only
+    // bounds the messages of its own instances.
+    if (!loop || queued_instance_ids_.size() >= kMaxQueuedMessagesToJS ||
+        instance_count >= max_batch_size) {
+      flush_now = true;
+    } else {
+      base::TimeTicks deadline = base::TimeTicks::Now() + max_batch_delay;
+      if (queue_flush_deadline_.is_null() || deadline < queue_flush_deadline_) {
+        queue_flush_deadline_ = deadline;
+        // Instances post from the thread of their choice, the handle stays
+        // usable from any of them.
+        loop->PostDelayedTask(FROM_HERE,
+            base::Bind(&FlushHandle::Flush, flush_handle_),
+            max_batch_delay);
+      }
+    }
+  }
+
+  if (flush_now)
+    FlushQueuedMessages();
+}
+
+void XWalkExtensionServer::FlushQueuedMessages() {
+  std::vector<int64_t> instance_ids;
+  base::ListValue messages;
+  {
+    base::AutoLock l(queue_lock_);
+    if (queued_instance_ids_.empty())
+      return;
+    instance_ids.swap(queued_instance_ids_);
+    messages.Swap(&queued_messages_);
+    queued_message_counts_.clear();
+    queue_flush_deadline_ = base::TimeTicks();
+  }
+
+  SendMaybeOutOfLine(make_scoped_ptr<IPC::Message>(
+      new XWalkExtensionClientMsg_PostMessageBatchToJS(instance_ids,
+                                                       messages)), 0);
+}
+
+void XWalkExtensionServer::SendMaybeOutOfLine(
+    scoped_ptr<IPC::Message> message, int64_t instance_id) {
+  if (instance_id)
+    stats_.RecordMessagesToJS(instance_id, 1, message->size());
   if (message->size() <= kInlineMessageMaxSize) {
     Send(message.release());
     return;
   }
 
+  TRACE_EVENT1(kExtensionTraceCategory,
+               "XWalkExtensionServer::SendOutOfLine",
+               "size", message->size());
+  if (instance_id)
+    stats_.RecordOutOfLineMessage(instance_id);
+
   base::SharedMemoryCreateOptions options;
   options.size = message->size();
   options.share_read_only = true;
@@ -228,6 +548,101 @@ void XWalkExtensionServer::PostMessageToJSCallback(
                                                             message->size()));
 }
 
+XWalkExtensionBinaryPool* XWalkExtensionServer::GetBinaryPool() {
+  base::AutoLock l(binary_pool_lock_);
+  if (binary_pool_ || binary_pool_failed_)
+    return binary_pool_.get();
+
+  scoped_ptr<XWalkExtensionBinaryPool> pool(
+      new XWalkExtensionBinaryPool(kBinaryPoolSlotSize, kBinaryPoolSlotCount));
+
+  base::SharedMemoryHandle handle;
+  if (!pool->Initialize() ||
+      !pool->ShareReadOnlyToProcess(renderer_process_handle_, &handle)) {
+    binary_pool_failed_ = true;
+    return NULL;
+  }
+
+  // The announcement has to go out before releasing the lock, otherwise a
+  // message posted from another thread could reach the client first.
+  if (!Send(new XWalkExtensionClientMsg_BinaryPoolCreated(
+          pool->id(), handle, pool->mapped_size()))) {
+    binary_pool_failed_ = true;
+    return NULL;
+  }
+
+  binary_pool_ = pool.Pass();
+  return binary_pool_.get();
+}
+
+void XWalkExtensionServer::PostBinaryMessageToJSCallback(
+    int64_t instance_id, const char* data, size_t size) {
+  // Keep the ordering with messages queued by batched instances.
+  FlushQueuedMessages();
+
+  if (PostBinaryPayloadToJS(instance_id, data, size))
+    return;
+
+  // It still reaches JavaScript as an ArrayBuffer.
+  PostValueMessageToJS(instance_id, scoped_ptr<base::Value>(
+      base::BinaryValue::CreateWithCopiedBuffer(data, size)));
+}
+
+bool XWalkExtensionServer::PostBinaryPayloadToJS(
+    int64_t instance_id, const char* data, size_t size) {
+  XWalkExtensionBinaryPool* pool = GetBinaryPool();
+  uint32_t offset;
+  if (pool && pool->Acquire(data, size, &offset)) {
+    stats_.RecordMessagesToJS(instance_id, 1, size);
+    return Send(new XWalkExtensionClientMsg_PostBinaryMessageToJS(
+        instance_id, pool->id(), offset, size));
+  }
+
+  // The pool is exhausted or the payload is too big for a slot.
+  if (size > kInlineMessageMaxSize)
+    return PostSharedMessageToJS(instance_id, data, size, true);
+  return false;
+}
+
+bool XWalkExtensionServer::PostSharedMessageToJS(
+    int64_t instance_id, const char* data, size_t size, bool is_binary) {
+  TRACE_EVENT1(kExtensionTraceCategory,
+               "XWalkExtensionServer::PostSharedMessageToJS", "size", size);
+  if (size > kuint32max)
+    return false;
+
+  base::SharedMemory shared_memory;
+  if (!shared_memory.CreateAndMapAnonymous(size)) {
+    LOG(WARNING) << "Can't create shared memory to send message of size "
+                 << size;
+    return false;
+  }
+  memcpy(shared_memory.memory(), data, size);
+
+  // The segment belongs to the renderer from now on, ours is unmapped when
+  // |shared_memory| goes away.
+  base::SharedMemoryHandle handle;
+  if (!shared_memory.GiveToProcess(renderer_process_handle_, &handle))
+    return false;
+
+  stats_.RecordMessagesToJS(instance_id, 1, size);
+  stats_.RecordOutOfLineMessage(instance_id);
+  return Send(new XWalkExtensionClientMsg_PostSharedMessageToJS(
+      instance_id, handle, size, is_binary));
+}
+
+void XWalkExtensionServer::OnReleaseBinaryMessage(int64_t instance_id,
+                                                  uint32_t offset) {
+  base::AutoLock l(binary_pool_lock_);
+  if (!binary_pool_) {
+    LOG(WARNING) << "Got binary message release without a pool for instance: "
+                 << instance_id;
+    return;
+  }
+
+  binary_pool_->Release(offset);
+}
+
 void XWalkExtensionServer::SendSyncReplyToJSCallback(
     int64_t instance_id, scoped_ptr<base::Value> reply) {
 
@@ -245,6 +660,9 @@ void XWalkExtensionServer::SendSyncReplyToJSCallback(
     return;
   }
 
+  // Messages posted before the reply must reach JavaScript first.
+  FlushQueuedMessages();
+
   base::ListValue wrapped_reply;
   wrapped_reply.Append(reply.release());
 
@@ -259,6 +677,61 @@ void XWalkExtensionServer::SendSyncReplyToJSCallback(
   data.pending_reply = NULL;
 }
 
+void XWalkExtensionServer::SendReplyToJSCallback(
+    int64_t instance_id, int request_id, scoped_ptr<base::Value> reply) {
+  // Messages posted before the reply must reach JavaScript first.
+  FlushQueuedMessages();
+
+  base::ListValue wrapped_reply;
+  wrapped_reply.Append(reply.release());
+
+  TRACE_EVENT_FLOW_STEP0(kExtensionTraceCategory, "XWalkExtension::Request",
+                         GetRequestFlowId(instance_id, request_id),
+                         "SendReply");
+  SendMaybeOutOfLine(make_scoped_ptr<IPC::Message>(
+      new XWalkExtensionClientMsg_PostReplyToJS(instance_id, request_id,
+                                                wrapped_reply)),
+      instance_id);
+}
+
+void XWalkExtensionServer::PublishStateToJSCallback(
+    int64_t instance_id, scoped_ptr<base::Value> state) {
+  std::string json;
+  base::JSONWriter::Write(state.get(), &json);
+
+  // Messages posted before the change must reach JavaScript first.
+  FlushQueuedMessages();
+
+  base::AutoLock l(published_states_lock_);
+  PublishedState& published = published_states_[instance_id];
+  // Zero stands for nothing published.
+  if (!++published.version)
+    published.version = 1;
+
+  if (!published.segment || !published.segment->Write(json,
+                                                      published.version)) {
+    linked_ptr<XWalkExtensionPublishedState> segment(
+        new XWalkExtensionPublishedState);
+    base::SharedMemoryHandle handle;
+    if (!segment->Create(std::max(kMinPublishedStateCapacity,
+                                  2 * json.size())) ||
+        !segment->Write(json, published.version) ||
+        !segment->ShareReadOnlyToProcess(renderer_process_handle_, &handle)) {
+      LOG(WARNING) << "Can't publish the state of instance: " << instance_id;
+      return;
+    }
+
+    // Announced under the lock, so a publication from another thread can't
+    // reach the client ahead of the segment it was written to.
+    published.segment = segment;
+    Send(new XWalkExtensionClientMsg_PublishedStateCreated(
+        instance_id, handle, segment->mapped_size()));
+  }
+
+  Send(new XWalkExtensionClientMsg_PublishedStateChanged(instance_id,
+                                                         published.version));
+}
+
 void XWalkExtensionServer::DeleteInstanceMap() {
   InstanceMap::iterator it = instances_.begin();
   int pending_replies_left = 0;
@@ -303,6 +776,8 @@ bool XWalkExtensionServer::ValidateExtensionEntryPoints(
 
 void XWalkExtensionServer::OnSendSyncMessageToNative(int64_t instance_id,
     const base::ListValue& msg, IPC::Message* ipc_reply) {
+  TRACE_EVENT0(kExtensionTraceCategory,
+               "XWalkExtensionServer::HandleSyncMessage");
   InstanceMap::iterator it = instances_.find(instance_id);
   if (it == instances_.end()) {
     LOG(WARNING) << "Can't SendSyncMessage to invalid Extension instance id: "
@@ -318,6 +793,7 @@ void XWalkExtensionServer::OnSendSyncMessageToNative(int64_t instance_id,
   }
 
   data.pending_reply = ipc_reply;
+  stats_.RecordMessagesToNative(instance_id, 1, handled_message_size_);
 
   // The const_cast is needed to remove the only Value contained by the
   // ListValue (which is solely used as wrapper, since Value doesn't
@@ -340,22 +816,45 @@ void XWalkExtensionServer::OnDestroyInstance(int64_t instance_id) {
   }
 
   InstanceExecutionData& data = it->second;
+  stats_.UnregisterInstance(instance_id);
 
   delete data.instance;
   instances_.erase(it);
+  {
+    base::AutoLock l(published_states_lock_);
+    published_states_.erase(instance_id);
+  }
 
+  FlushQueuedMessages();
   Send(new XWalkExtensionClientMsg_InstanceDestroyed(instance_id));
 }
 
+void XWalkExtensionServer::OnRequestExtensions() {
+  scoped_refptr<XWalkExtensionCatalog> catalog = GetExtensionCatalog();
+  base::SharedMemoryHandle handle;
+  if (catalog &&
+      catalog->ShareReadOnlyToProcess(renderer_process_handle_, &handle)) {
+    Send(new XWalkExtensionClientMsg_ExtensionCatalogShared(handle,
+                                                            catalog->size()));
+    return;
+  }
+
+  std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams> extensions;
+  OnGetExtensions(&extensions);
+  Send(new XWalkExtensionClientMsg_ExtensionsRegistered(extensions));
+}
+
 void XWalkExtensionServer::OnGetExtensions(
-    std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>* reply) {
-  ExtensionMap::iterator it = extensions_.begin();
+    std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>* reply) const {
+  ExtensionMap::const_iterator it = extensions_.begin();
   for (; it != extensions_.end(); ++it) {
     XWalkExtensionServerMsg_ExtensionRegisterParams extension_parameters;
     XWalkExtension* extension = it->second;
 
     extension_parameters.name = extension->name();
     extension_parameters.js_api = extension->javascript_api();
+    extension_parameters.max_batch_size = extension->max_batch_size();
+    extension_parameters.max_batch_delay = extension->max_batch_delay();
 
     const base::ListValue& entry_points = extension->entry_points();
     base::ListValue::const_iterator entry_it = entry_points.begin();
@@ -416,7 +915,13 @@ std::vector<std::string> RegisterExternalExtensionsInDirectory(
     extension->set_runtime_variables(*runtime_variables);
     if (server->permissions_delegate())
       extension->set_permissions_delegate(server->permissions_delegate());
-    if (extension->Initialize()) {
+
+    // Libraries with a sidecar metadata file (e.g. libfoo.so.json) are only
+    // loaded once their extension is first used.
+    base::FilePath metadata_path =
+        extension_path.AddExtension(FILE_PATH_LITERAL("json"));
+    if (extension->InitializeFromMetadataFile(metadata_path) ||
+        extension->Initialize()) {
       registered_extensions.push_back(extension->name());
       server->RegisterExtension(extension.PassAs<XWalkExtension>());
     } else {
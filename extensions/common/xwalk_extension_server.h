@@ -11,13 +11,18 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/shared_memory.h"
 #include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_listener.h"
 #include "xwalk/extensions/common/xwalk_extension.h"
+#include "xwalk/extensions/common/xwalk_extension_catalog.h"
+#include "xwalk/extensions/common/xwalk_extension_stats.h"
 #include "xwalk/extensions/common/xwalk_external_extension.h"
 
 struct XWalkExtensionServerMsg_ExtensionRegisterParams;
@@ -37,7 +42,9 @@ class Sender;
 namespace xwalk {
 namespace extensions {
 
+class XWalkExtensionBinaryPool;
 class XWalkExtensionInstance;
+class XWalkExtensionPublishedState;
 
 // Manages the instances for a set of extensions. It communicates with one
 // XWalkExtensionClient by means of IPC channel.
@@ -66,6 +73,17 @@ class XWalkExtensionServer : public IPC::Listener,
   bool RegisterExtension(scoped_ptr<XWalkExtension> extension);
   bool ContainsExtension(const std::string& extension_name) const;
 
+  // Makes the extensions registered in |owner| available through this server
+  // too, without taking their ownership. Used to serve many Render Processes
+  // from the same Extension Process without loading the extensions again.
+  // |owner| must outlive this server.
+  void UseExtensionsFrom(const XWalkExtensionServer& owner);
+
+  // The extensions serialized for the clients. Built on the first call, and
+  // shared by the servers using the extensions of this one. NULL if the
+  // shared memory can't be created.
+  scoped_refptr<XWalkExtensionCatalog> GetExtensionCatalog() const;
+
   void Invalidate();
 
   void set_permissions_delegate(XWalkExtension::PermissionsDelegate* delegate) {
@@ -75,30 +93,96 @@ class XWalkExtensionServer : public IPC::Listener,
     return permissions_delegate_;
   }
 
+  const XWalkExtensionStats& stats() const { return stats_; }
+
   // These Message Handlers can be accessed by a message filter when
   // running on the browser process.
   void OnCreateInstance(int64_t instance_id, std::string name);
+  void OnCreateInstances(const std::vector<int64_t>& instance_ids,
+                         const std::vector<std::string>& names);
   void OnGetExtensions(
-      std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>* reply);
+      std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>* reply)
+      const;
 
  private:
   struct InstanceExecutionData {
     XWalkExtensionInstance* instance;
     IPC::Message* pending_reply;
+    // Messages received so far, numbered like the client does for tracing.
+    uint32_t messages_received;
   };
 
+  // Ends the trace flows of the next |count| messages of |instance_id| and
+  // records them, with the size of the IPC message being handled.
+  void TraceMessagesReceived(int64_t instance_id, InstanceExecutionData* data,
+                             size_t count);
+
   // Message Handlers
   void OnDestroyInstance(int64_t instance_id);
   void OnPostMessageToNative(int64_t instance_id, const base::ListValue& msg);
+  void OnPostStringMessageToNative(int64_t instance_id, const std::string& msg);
+  void OnPostBinaryMessageToNative(int64_t instance_id,
+                                   const std::vector<char>& msg);
+  void OnPostMessageBatchToNative(int64_t instance_id,
+                                  const base::ListValue& msgs);
   void OnSendSyncMessageToNative(int64_t instance_id,
       const base::ListValue& msg, IPC::Message* ipc_reply);
+  void OnReleaseBinaryMessage(int64_t instance_id, uint32_t offset);
+  void OnRequestExtensions();
+  void OnPostRequestToNative(int64_t instance_id, int request_id,
+                             const base::ListValue& msg);
 
   void PostMessageToJSCallback(int64_t instance_id,
                                scoped_ptr<base::Value> msg);
 
+  // Used instead of PostMessageToJSCallback() for instances of extensions
+  // with batching enabled.
+  void QueueMessageToJSCallback(int64_t instance_id, size_t max_batch_size,
+                                base::TimeDelta max_batch_delay,
+                                scoped_ptr<base::Value> msg);
+  void FlushQueuedMessages();
+
+  // Sends |message| inline or, if it is too big, through a shared memory
+  // segment created for it.
+  // |instance_id| is the instance the message is attributed to in the stats,
+  // 0 for none.
+  void SendMaybeOutOfLine(scoped_ptr<IPC::Message> message,
+                          int64_t instance_id);
+
+  void PostBinaryMessageToJSCallback(int64_t instance_id,
+                                     const char* data, size_t size);
+
+  // Sends |msg| wrapped in a ListValue, the path of values without a
+  // dedicated message.
+  void PostValueMessageToJS(int64_t instance_id, scoped_ptr<base::Value> msg);
+
+  // Sends a binary payload through the binary pool or, if it is big, a
+  // shared memory segment of its own. Returns false if neither was possible,
+  // the caller then falls back to a regular message.
+  bool PostBinaryPayloadToJS(int64_t instance_id, const char* data,
+                             size_t size);
+
+  // Sends a big string or binary payload in a shared memory segment of its
+  // own. Returns false if it couldn't, the caller then falls back to a
+  // regular message.
+  bool PostSharedMessageToJS(int64_t instance_id, const char* data,
+                             size_t size, bool is_binary);
+
+  // Lazily creates the binary pool and announces it to the client. Returns
+  // NULL if the pool couldn't be created.
+  XWalkExtensionBinaryPool* GetBinaryPool();
+
   void SendSyncReplyToJSCallback(int64_t instance_id,
                                  scoped_ptr<base::Value> reply);
 
+  void SendReplyToJSCallback(int64_t instance_id, int request_id,
+                             scoped_ptr<base::Value> reply);
+
+  // Writes |state| as JSON in the segment of the instance, which is replaced
+  // by a bigger one when it doesn't fit.
+  void PublishStateToJSCallback(int64_t instance_id,
+                                scoped_ptr<base::Value> state);
+
   void DeleteInstanceMap();
 
   bool ValidateExtensionEntryPoints(const base::ListValue& entry_points);
@@ -108,6 +192,9 @@ class XWalkExtensionServer : public IPC::Listener,
 
   typedef std::map<std::string, XWalkExtension*> ExtensionMap;
   ExtensionMap extensions_;
+  bool owns_extensions_;
+  const XWalkExtensionServer* extensions_owner_;
+  mutable scoped_refptr<XWalkExtensionCatalog> catalog_;
 
   typedef std::map<int64_t, InstanceExecutionData> InstanceMap;
   InstanceMap instances_;
@@ -118,7 +205,37 @@ class XWalkExtensionServer : public IPC::Listener,
 
   base::ProcessHandle renderer_process_handle_;
 
+  // Messages waiting for FlushQueuedMessages(), in the order they were
+  // posted, see XWalkExtension for the batching semantics.
+  class FlushHandle;
+  base::Lock queue_lock_;
+  std::vector<int64_t> queued_instance_ids_;
+  base::ListValue queued_messages_;
+  // How many of them each instance queued.
+  std::map<int64_t, size_t> queued_message_counts_;
+  base::TimeTicks queue_flush_deadline_;
+  scoped_refptr<FlushHandle> flush_handle_;
+
+  base::Lock binary_pool_lock_;
+  scoped_ptr<XWalkExtensionBinaryPool> binary_pool_;
+  bool binary_pool_failed_;
+
+  struct PublishedState {
+    PublishedState();
+    ~PublishedState();
+
+    linked_ptr<XWalkExtensionPublishedState> segment;
+    uint32_t version;
+  };
+  typedef std::map<int64_t, PublishedState> PublishedStateMap;
+  base::Lock published_states_lock_;
+  PublishedStateMap published_states_;
+
   XWalkExtension::PermissionsDelegate* permissions_delegate_;
+
+  XWalkExtensionStats stats_;
+  // Size of the IPC message OnMessageReceived() is dispatching.
+  size_t handled_message_size_;
 };
 
 std::vector<std::string> RegisterExternalExtensionsInDirectory(
@@ -4,10 +4,119 @@
 
 #include "xwalk/extensions/common/xwalk_extension_server.h"
 
+#include <string>
+#include <vector>
+
 #include "base/basictypes.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/values.h"
+#include "ipc/ipc_sender.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "xwalk/extensions/common/xwalk_extension.h"
+#include "xwalk/extensions/common/xwalk_extension_messages.h"
 
 using xwalk::extensions::ValidateExtensionNameForTesting;
+using xwalk::extensions::XWalkExtension;
+using xwalk::extensions::XWalkExtensionInstance;
+using xwalk::extensions::XWalkExtensionServer;
+
+namespace {
+
+class RecordingSender : public IPC::Sender {
+ public:
+  RecordingSender() : failing_type_(0) {}
+
+  virtual bool Send(IPC::Message* message) OVERRIDE {
+    messages_.push_back(message);
+    return message->type() != failing_type_;
+  }
+
+  // Sends of messages of |type| are recorded but reported as failed.
+  void set_failing_type(uint32 type) { failing_type_ = type; }
+
+  size_t CountMessages(uint32 type) const {
+    size_t count = 0;
+    for (size_t i = 0; i < messages_.size(); ++i) {
+      if (messages_[i]->type() == type)
+        ++count;
+    }
+    return count;
+  }
+
+  const ScopedVector<IPC::Message>& messages() const { return messages_; }
+
+ private:
+  uint32 failing_type_;
+  ScopedVector<IPC::Message> messages_;
+};
+
+class BatchingInstance : public XWalkExtensionInstance {
+ public:
+  virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE {}
+};
+
+class BatchingExtension : public XWalkExtension {
+ public:
+  BatchingExtension(const std::string& name, size_t max_batch_size) {
+    set_name(name);
+    set_javascript_api("");
+    set_message_batching(max_batch_size, base::TimeDelta());
+  }
+
+  virtual XWalkExtensionInstance* CreateInstance() OVERRIDE {
+    instances_.push_back(new BatchingInstance);
+    return instances_.back();
+  }
+
+  // Owned by the server.
+  std::vector<XWalkExtensionInstance*> instances_;
+};
+
+class XWalkExtensionServerBatchingTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    server_.Initialize(&sender_);
+    first_ = new BatchingExtension("first", 3);
+    second_ = new BatchingExtension("second", 3);
+    ASSERT_TRUE(server_.RegisterExtension(scoped_ptr<XWalkExtension>(first_)));
+    ASSERT_TRUE(
+        server_.RegisterExtension(scoped_ptr<XWalkExtension>(second_)));
+    server_.OnCreateInstance(1, "first");
+    server_.OnCreateInstance(2, "second");
+    ASSERT_EQ(1u, first_->instances_.size());
+    ASSERT_EQ(1u, second_->instances_.size());
+  }
+
+  void Post(XWalkExtensionInstance* instance, int value) {
+    instance->PostMessageToJS(
+        scoped_ptr<base::Value>(new base::FundamentalValue(value)));
+  }
+
+  // The instance ids and values of the batch |index| sent to the client.
+  void GetBatch(size_t index, std::vector<int64_t>* ids,
+                std::vector<int>* values) {
+    ASSERT_LT(index, sender_.messages().size());
+    XWalkExtensionClientMsg_PostMessageBatchToJS::Param param;
+    ASSERT_TRUE(XWalkExtensionClientMsg_PostMessageBatchToJS::Read(
+        sender_.messages()[index], &param));
+    *ids = param.a;
+    values->clear();
+    for (size_t i = 0; i < param.b.GetSize(); ++i) {
+      int value;
+      ASSERT_TRUE(param.b.GetInteger(i, &value));
+      values->push_back(value);
+    }
+  }
+
+  base::MessageLoop message_loop_;
+  RecordingSender sender_;
+  XWalkExtensionServer server_;
+  BatchingExtension* first_;
+  BatchingExtension* second_;
+};
+
+}  // namespace
 
 TEST(XWalkExtensionServerTest, ValidateExtensionName) {
   const std::string valid_names[] = {
@@ -42,3 +151,56 @@ TEST(XWalkExtensionServerTest, ValidateExtensionName) {
         << "Extension name should be invalid: " << invalid_names[i];
   }
 }
+
+TEST_F(XWalkExtensionServerBatchingTest, KeepsPostingOrder) {
+  Post(first_->instances_[0], 1);
+  Post(second_->instances_[0], 2);
+  Post(first_->instances_[0], 3);
+  EXPECT_TRUE(sender_.messages().empty());
+
+  base::MessageLoop::current()->RunUntilIdle();
+  ASSERT_EQ(1u, sender_.messages().size());
+  std::vector<int64_t> ids;
+  std::vector<int> values;
+  GetBatch(0, &ids, &values);
+  const int64_t expected_ids[] = { 1, 2, 1 };
+  const int expected_values[] = { 1, 2, 3 };
+  EXPECT_EQ(std::vector<int64_t>(expected_ids, expected_ids + 3), ids);
+  EXPECT_EQ(std::vector<int>(expected_values, expected_values + 3), values);
+}
+
+TEST_F(XWalkExtensionServerBatchingTest, BoundsBatchByInstance) {
+  // Four messages in the queue, but only the third of the first instance
+  // reaches the batch size of its extension.
+  Post(first_->instances_[0], 1);
+  Post(second_->instances_[0], 2);
+  Post(first_->instances_[0], 3);
+  Post(second_->instances_[0], 4);
+  EXPECT_TRUE(sender_.messages().empty());
+  Post(first_->instances_[0], 5);
+  ASSERT_EQ(1u, sender_.messages().size());
+
+  std::vector<int64_t> ids;
+  std::vector<int> values;
+  GetBatch(0, &ids, &values);
+  EXPECT_EQ(5u, ids.size());
+  EXPECT_EQ(5, values.back());
+}
+
+TEST_F(XWalkExtensionServerBatchingTest, BinaryPoolAnnounceFailure) {
+  sender_.set_failing_type(XWalkExtensionClientMsg_BinaryPoolCreated::ID);
+  const std::string data(16, 'x');
+  first_->instances_[0]->PostBinaryMessageToJS(data.data(), data.size());
+  first_->instances_[0]->PostBinaryMessageToJS(data.data(), data.size());
+  base::MessageLoop::current()->RunUntilIdle();
+
+  // The client never learnt about the pool, so it isn't announced again nor
+  // used, and the payloads take the regular message path instead. Each binary
+  // post flushes the messages queued before it.
+  EXPECT_EQ(1u, sender_.CountMessages(
+      XWalkExtensionClientMsg_BinaryPoolCreated::ID));
+  EXPECT_EQ(0u, sender_.CountMessages(
+      XWalkExtensionClientMsg_PostBinaryMessageToJS::ID));
+  EXPECT_EQ(2u, sender_.CountMessages(
+      XWalkExtensionClientMsg_PostMessageBatchToJS::ID));
+}
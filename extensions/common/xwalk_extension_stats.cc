@@ -0,0 +1,158 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/common/xwalk_extension_stats.h"
+
+#include "base/debug/trace_event.h"
+
+namespace xwalk {
+namespace extensions {
+
+const char kExtensionTraceCategory[] = "xwalk.extensions";
+
+uint64 GetMessageFlowId(int64_t instance_id, uint32_t sequence) {
+  return (static_cast<uint64>(instance_id) << 32) | sequence;
+}
+
+uint64 GetRequestFlowId(int64_t instance_id, int request_id) {
+  // The top bit keeps them apart from the message ids.
+  return (static_cast<uint64>(instance_id) << 32) |
+      static_cast<uint32_t>(request_id) | (GG_UINT64_C(1) << 63);
+}
+
+XWalkExtensionStats::Counters::Counters()
+    : messages_to_native(0),
+      messages_to_js(0),
+      bytes_to_native(0),
+      bytes_to_js(0),
+      out_of_line_messages(0),
+      sync_calls(0) {
+}
+
+XWalkExtensionStats::XWalkExtensionStats() {
+}
+
+XWalkExtensionStats::~XWalkExtensionStats() {
+}
+
+void XWalkExtensionStats::RegisterInstance(int64_t instance_id,
+                                           const std::string& extension_name) {
+  base::AutoLock lock(lock_);
+  instance_extensions_[instance_id] = extension_name;
+}
+
+void XWalkExtensionStats::UnregisterInstance(int64_t instance_id) {
+  base::AutoLock lock(lock_);
+  instance_extensions_.erase(instance_id);
+}
+
+void XWalkExtensionStats::RecordMessagesToNative(int64_t instance_id,
+                                                 size_t count, size_t bytes) {
+  base::AutoLock lock(lock_);
+  const std::string* extension_name;
+  Counters* counters = GetInstanceCounters(instance_id, &extension_name);
+  if (!counters)
+    return;
+  counters->messages_to_native += count;
+  counters->bytes_to_native += bytes;
+  PublishCounters(*extension_name, *counters, MESSAGES);
+  PublishCounters(*extension_name, *counters, BYTES);
+}
+
+void XWalkExtensionStats::RecordMessagesToJS(int64_t instance_id,
+                                             size_t count, size_t bytes) {
+  base::AutoLock lock(lock_);
+  const std::string* extension_name;
+  Counters* counters = GetInstanceCounters(instance_id, &extension_name);
+  if (!counters)
+    return;
+  counters->messages_to_js += count;
+  counters->bytes_to_js += bytes;
+  PublishCounters(*extension_name, *counters, MESSAGES);
+  PublishCounters(*extension_name, *counters, BYTES);
+}
+
+void XWalkExtensionStats::RecordOutOfLineMessage(int64_t instance_id) {
+  base::AutoLock lock(lock_);
+  const std::string* extension_name;
+  Counters* counters = GetInstanceCounters(instance_id, &extension_name);
+  if (!counters)
+    return;
+  ++counters->out_of_line_messages;
+  PublishCounters(*extension_name, *counters, OUT_OF_LINE);
+}
+
+void XWalkExtensionStats::RecordSyncCall(int64_t instance_id,
+                                         base::TimeDelta blocked) {
+  base::AutoLock lock(lock_);
+  const std::string* extension_name;
+  Counters* counters = GetInstanceCounters(instance_id, &extension_name);
+  if (!counters)
+    return;
+  ++counters->sync_calls;
+  counters->sync_blocking_time += blocked;
+  PublishCounters(*extension_name, *counters, SYNC_CALLS);
+}
+
+bool XWalkExtensionStats::GetCounters(const std::string& extension_name,
+                                      Counters* counters) const {
+  base::AutoLock lock(lock_);
+  std::map<std::string, Counters>::const_iterator it =
+      counters_.find(extension_name);
+  if (it == counters_.end())
+    return false;
+  *counters = it->second;
+  return true;
+}
+
+XWalkExtensionStats::Counters* XWalkExtensionStats::GetInstanceCounters(
+    int64_t instance_id, const std::string** extension_name) {
+  lock_.AssertAcquired();
+  std::map<int64_t, std::string>::const_iterator it =
+      instance_extensions_.find(instance_id);
+  if (it == instance_extensions_.end())
+    return NULL;
+  *extension_name = &it->second;
+  return &counters_[it->second];
+}
+
+// static
+void XWalkExtensionStats::PublishCounters(const std::string& extension_name,
+                                          const Counters& counters,
+                                          CounterGroup group) {
+  bool enabled;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(kExtensionTraceCategory, &enabled);
+  if (!enabled)
+    return;
+
+  switch (group) {
+    case MESSAGES:
+      TRACE_COPY_COUNTER2(kExtensionTraceCategory,
+                          (extension_name + " messages").c_str(),
+                          "toNative", counters.messages_to_native,
+                          "toJS", counters.messages_to_js);
+      break;
+    case BYTES:
+      TRACE_COPY_COUNTER2(kExtensionTraceCategory,
+                          (extension_name + " bytes").c_str(),
+                          "toNative", counters.bytes_to_native,
+                          "toJS", counters.bytes_to_js);
+      break;
+    case OUT_OF_LINE:
+      TRACE_COPY_COUNTER1(kExtensionTraceCategory,
+                          (extension_name + " out of line messages").c_str(),
+                          counters.out_of_line_messages);
+      break;
+    case SYNC_CALLS:
+      TRACE_COPY_COUNTER2(kExtensionTraceCategory,
+                          (extension_name + " sync calls").c_str(),
+                          "count", counters.sync_calls,
+                          "blockedMs",
+                          counters.sync_blocking_time.InMilliseconds());
+      break;
+  }
+}
+
+}  // namespace extensions
+}  // namespace xwalk
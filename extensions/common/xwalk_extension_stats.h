@@ -0,0 +1,94 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_STATS_H_
+#define XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_STATS_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace xwalk {
+namespace extensions {
+
+// Trace category of the extension messaging path.
+extern const char kExtensionTraceCategory[];
+
+// Ids linking the trace events of a message, or of a request and its reply,
+// from the Render Process to the instance. Both sides number the messages
+// of each instance in the order they go through the channel.
+uint64 GetMessageFlowId(int64_t instance_id, uint32_t sequence);
+uint64 GetRequestFlowId(int64_t instance_id, int request_id);
+
+// Per extension totals of the messages going through a XWalkExtensionServer
+// or a XWalkExtensionClient. Each update is published as a trace counter in
+// kExtensionTraceCategory, so chrome://tracing shows which extension uses
+// the channel the most. Instances are attributed to the extension they were
+// registered with, updates for unknown instances are dropped.
+//
+// Can be used from any thread.
+class XWalkExtensionStats {
+ public:
+  struct Counters {
+    Counters();
+
+    uint64 messages_to_native;
+    uint64 messages_to_js;
+    uint64 bytes_to_native;
+    uint64 bytes_to_js;
+    uint64 out_of_line_messages;
+    uint64 sync_calls;
+    base::TimeDelta sync_blocking_time;
+  };
+
+  XWalkExtensionStats();
+  ~XWalkExtensionStats();
+
+  void RegisterInstance(int64_t instance_id,
+                        const std::string& extension_name);
+  void UnregisterInstance(int64_t instance_id);
+
+  void RecordMessagesToNative(int64_t instance_id, size_t count,
+                              size_t bytes);
+  void RecordMessagesToJS(int64_t instance_id, size_t count, size_t bytes);
+  // Messages that didn't fit inline in the IPC channel.
+  void RecordOutOfLineMessage(int64_t instance_id);
+  // |blocked| is the time the caller waited for the reply.
+  void RecordSyncCall(int64_t instance_id, base::TimeDelta blocked);
+
+  // Returns false if nothing was recorded for |extension_name|.
+  bool GetCounters(const std::string& extension_name,
+                   Counters* counters) const;
+
+ private:
+  enum CounterGroup {
+    MESSAGES,
+    BYTES,
+    OUT_OF_LINE,
+    SYNC_CALLS
+  };
+
+  // Returns the counters of the extension of |instance_id| and its name in
+  // |extension_name|, NULL for unknown instances. |lock_| must be held.
+  Counters* GetInstanceCounters(int64_t instance_id,
+                                const std::string** extension_name);
+
+  static void PublishCounters(const std::string& extension_name,
+                              const Counters& counters, CounterGroup group);
+
+  mutable base::Lock lock_;
+  std::map<int64_t, std::string> instance_extensions_;
+  std::map<std::string, Counters> counters_;
+
+  DISALLOW_COPY_AND_ASSIGN(XWalkExtensionStats);
+};
+
+}  // namespace extensions
+}  // namespace xwalk
+
+#endif  // XWALK_EXTENSIONS_COMMON_XWALK_EXTENSION_STATS_H_
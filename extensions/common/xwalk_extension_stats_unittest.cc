@@ -0,0 +1,56 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/common/xwalk_extension_stats.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::extensions::XWalkExtensionStats;
+
+TEST(XWalkExtensionStatsTest, AggregatesPerExtension) {
+  XWalkExtensionStats stats;
+  stats.RegisterInstance(1, "echo");
+  stats.RegisterInstance(2, "echo");
+  stats.RegisterInstance(3, "other");
+
+  stats.RecordMessagesToNative(1, 1, 100);
+  stats.RecordMessagesToNative(2, 3, 50);
+  stats.RecordMessagesToJS(1, 1, 10);
+  stats.RecordOutOfLineMessage(2);
+  stats.RecordSyncCall(1, base::TimeDelta::FromMilliseconds(5));
+  stats.RecordSyncCall(2, base::TimeDelta::FromMilliseconds(7));
+  stats.RecordMessagesToJS(3, 1, 1);
+
+  XWalkExtensionStats::Counters counters;
+  ASSERT_TRUE(stats.GetCounters("echo", &counters));
+  EXPECT_EQ(4u, counters.messages_to_native);
+  EXPECT_EQ(150u, counters.bytes_to_native);
+  EXPECT_EQ(1u, counters.messages_to_js);
+  EXPECT_EQ(10u, counters.bytes_to_js);
+  EXPECT_EQ(1u, counters.out_of_line_messages);
+  EXPECT_EQ(2u, counters.sync_calls);
+  EXPECT_EQ(12, counters.sync_blocking_time.InMilliseconds());
+
+  ASSERT_TRUE(stats.GetCounters("other", &counters));
+  EXPECT_EQ(1u, counters.messages_to_js);
+  EXPECT_EQ(0u, counters.messages_to_native);
+}
+
+TEST(XWalkExtensionStatsTest, IgnoresUnknownInstances) {
+  XWalkExtensionStats stats;
+  stats.RegisterInstance(1, "echo");
+  stats.UnregisterInstance(1);
+  stats.RecordMessagesToNative(1, 1, 100);
+  stats.RecordMessagesToNative(2, 1, 100);
+
+  XWalkExtensionStats::Counters counters;
+  EXPECT_FALSE(stats.GetCounters("echo", &counters));
+}
+
+TEST(XWalkExtensionStatsTest, FlowIds) {
+  EXPECT_NE(xwalk::extensions::GetMessageFlowId(1, 2),
+            xwalk::extensions::GetMessageFlowId(2, 1));
+  EXPECT_NE(xwalk::extensions::GetMessageFlowId(1, 2),
+            xwalk::extensions::GetRequestFlowId(1, 2));
+}
@@ -26,4 +26,9 @@ const char kXWalkExtensionCmdPrefix[] = "xwalk-extension-cmd-prefix";
 // Disable XWalkExtensionSystem and all extensions
 const char kXWalkDisableExtensions[] = "disable-xwalk-extensions";
 
+// Don't keep a spare Extension Process launched ahead of the next Render
+// Process.
+const char kXWalkDisableExtensionProcessPrewarm[] =
+    "disable-extension-process-prewarm";
+
 }  // namespace switches
@@ -4,12 +4,24 @@
 
 #include "xwalk/extensions/common/xwalk_external_adapter.h"
 
+#include "base/bind.h"
 #include "base/logging.h"
 #include "base/stl_util.h"
+#include "base/threading/sequenced_worker_pool.h"
 
 namespace xwalk {
 namespace extensions {
 
+namespace {
+
+void RunPermissionResultCallback(XW_Extension xw,
+                                 XW_PermissionResultCallback callback,
+                                 void* user_data, bool result) {
+  callback(xw, result ? XW_OK : XW_ERROR, user_data);
+}
+
+}  // namespace
+
 XWalkExternalAdapter::XWalkExternalAdapter()
     : next_xw_extension_(1),
       next_xw_instance_(1) {}
@@ -32,6 +44,7 @@ void XWalkExternalAdapter::RegisterExtension(
     XWalkExternalExtension* extension) {
   XW_Extension xw_extension = extension->xw_extension_;
   CHECK(IsValidXWExtension(xw_extension));
+  base::AutoLock l(lock_);
   CHECK(!ContainsKey(extension_map_, xw_extension));
   extension_map_[xw_extension] = extension;
 }
@@ -40,6 +53,7 @@ void XWalkExternalAdapter::UnregisterExtension(
     XWalkExternalExtension* extension) {
   XW_Extension xw_extension = extension->xw_extension_;
   CHECK(IsValidXWExtension(xw_extension));
+  base::AutoLock l(lock_);
   CHECK(ContainsKey(extension_map_, xw_extension));
   extension_map_.erase(xw_extension);
 }
@@ -47,6 +61,7 @@ void XWalkExternalAdapter::UnregisterExtension(
 void XWalkExternalAdapter::RegisterInstance(XWalkExternalInstance* context) {
   XW_Instance xw_instance = context->xw_instance_;
   CHECK(IsValidXWInstance(xw_instance));
+  base::AutoLock l(lock_);
   CHECK(!ContainsKey(instance_map_, xw_instance));
   instance_map_[xw_instance] = context;
 }
@@ -54,10 +69,22 @@ void XWalkExternalAdapter::RegisterInstance(XWalkExternalInstance* context) {
 void XWalkExternalAdapter::UnregisterInstance(XWalkExternalInstance* context) {
   XW_Instance xw_instance = context->xw_instance_;
   CHECK(IsValidXWInstance(xw_instance));
+  base::AutoLock l(lock_);
   CHECK(ContainsKey(instance_map_, xw_instance));
   instance_map_.erase(xw_instance);
 }
 
+void XWalkExternalAdapter::EnableWorkerThreads(size_t max_threads) {
+  DCHECK(!worker_pool_);
+  worker_pool_ = new base::SequencedWorkerPool(max_threads,
+                                               "XWalkExtensionWorker");
+}
+
+void XWalkExternalAdapter::ShutdownWorkerThreads() {
+  if (worker_pool_)
+    worker_pool_->Shutdown();
+}
+
 const void* XWalkExternalAdapter::GetInterface(const char* name) {
   if (!strcmp(name, XW_CORE_INTERFACE_1)) {
     static const XW_CoreInterface_1 coreInterface1 = {
@@ -79,6 +106,16 @@ const void* XWalkExternalAdapter::GetInterface(const char* name) {
     return &messagingInterface1;
   }
 
+  if (!strcmp(name, XW_MESSAGING_INTERFACE_2)) {
+    static const XW_MessagingInterface_2 messagingInterface2 = {
+      MessagingRegister,
+      MessagingPostMessage,
+      MessagingRegisterBinaryMessageCallback,
+      MessagingPostBinaryMessage
+    };
+    return &messagingInterface2;
+  }
+
   if (!strcmp(name, XW_INTERNAL_SYNC_MESSAGING_INTERFACE_1)) {
     static const XW_Internal_SyncMessagingInterface_1
         syncMessagingInterface1 = {
@@ -110,6 +147,23 @@ const void* XWalkExternalAdapter::GetInterface(const char* name) {
     return &permissionsInterface1;
   }
 
+  if (!strcmp(name, XW_INTERNAL_PERMISSIONS_INTERFACE_2)) {
+    static const XW_Internal_PermissionsInterface_2 permissionsInterface2 = {
+      PermissionsCheckAPIAccessControl,
+      PermissionsRegisterPermissions,
+      PermissionsCheckAPIAccessControlAsync,
+      PermissionsRegisterPermissionsAsync
+    };
+    return &permissionsInterface2;
+  }
+
+  if (!strcmp(name, XW_INTERNAL_THREADING_INTERFACE_1)) {
+    static const XW_Internal_ThreadingInterface_1 threadingInterface1 = {
+      ThreadingUseWorkerThreads
+    };
+    return &threadingInterface1;
+  }
+
   LOG(WARNING) << "Interface '" << name << "' is not supported.";
   return NULL;
 }
@@ -125,6 +179,7 @@ bool XWalkExternalAdapter::IsValidXWInstance(XW_Instance xw_instance) {
 XWalkExternalExtension* XWalkExternalAdapter::GetExtension(
     XW_Extension xw_extension) {
   XWalkExternalAdapter* adapter = XWalkExternalAdapter::GetInstance();
+  base::AutoLock l(adapter->lock_);
   ExtensionMap::iterator it = adapter->extension_map_.find(xw_extension);
   if (it == adapter->extension_map_.end())
     return NULL;
@@ -134,6 +189,7 @@ XWalkExternalExtension* XWalkExternalAdapter::GetExtension(
 XWalkExternalInstance* XWalkExternalAdapter::GetInstance(
     XW_Instance xw_instance) {
   XWalkExternalAdapter* adapter = XWalkExternalAdapter::GetInstance();
+  base::AutoLock l(adapter->lock_);
   InstanceMap::iterator it = adapter->instance_map_.find(xw_instance);
   if (it == adapter->instance_map_.end())
     return NULL;
@@ -168,5 +224,31 @@ int XWalkExternalAdapter::PermissionsRegisterPermissions(XW_Extension xw,
   return ptr->RegisterPermissions(perm_table) ? XW_OK : XW_ERROR;
 }
 
+void XWalkExternalAdapter::PermissionsCheckAPIAccessControlAsync(
+    XW_Extension xw, const char* api_name,
+    XW_PermissionResultCallback callback, void* user_data) {
+  XWalkExtension* ptr = GetExtension(xw);
+  if (!ptr || !callback) {
+    LogInvalidCall(xw, "Extension", "Permissions",
+                   "CheckAPIAccessControlAsync");
+    return;
+  }
+  ptr->CheckAPIAccessControlAsync(api_name,
+      base::Bind(&RunPermissionResultCallback, xw, callback, user_data));
+}
+
+void XWalkExternalAdapter::PermissionsRegisterPermissionsAsync(
+    XW_Extension xw, const char* perm_table,
+    XW_PermissionResultCallback callback, void* user_data) {
+  XWalkExtension* ptr = GetExtension(xw);
+  if (!ptr || !callback) {
+    LogInvalidCall(xw, "Extension", "Permissions",
+                   "RegisterPermissionsAsync");
+    return;
+  }
+  ptr->RegisterPermissionsAsync(perm_table,
+      base::Bind(&RunPermissionResultCallback, xw, callback, user_data));
+}
+
 }  // namespace extensions
 }  // namespace xwalk
@@ -6,12 +6,15 @@
 #define XWALK_EXTENSIONS_COMMON_XWALK_EXTERNAL_ADAPTER_H_
 
 #include <map>
+#include "base/memory/ref_counted.h"
 #include "base/memory/singleton.h"
+#include "base/synchronization/lock.h"
 #include "xwalk/extensions/public/XW_Extension.h"
 #include "xwalk/extensions/public/XW_Extension_SyncMessage.h"
 #include "xwalk/extensions/public/XW_Extension_EntryPoints.h"
 #include "xwalk/extensions/public/XW_Extension_Permissions.h"
 #include "xwalk/extensions/public/XW_Extension_Runtime.h"
+#include "xwalk/extensions/public/XW_Extension_Threading.h"
 #include "xwalk/extensions/common/xwalk_external_extension.h"
 #include "xwalk/extensions/common/xwalk_external_instance.h"
 
@@ -19,6 +22,15 @@
 // GetInterface(). They dispatch the function to the appropriate
 // extension or instance.
 
+#define DEFINE_FUNCTION_0(TYPE, INTERFACE, NAME)                \
+  static void INTERFACE ## NAME(XW_ ## TYPE xw) {               \
+    XWalkExternal ## TYPE * ptr = Get ## TYPE(xw);              \
+    if (!ptr)                                                   \
+      LogInvalidCall(xw, #TYPE, #INTERFACE, #NAME);             \
+    else                                                        \
+      ptr->INTERFACE ## NAME();                                 \
+  }
+
 #define DEFINE_FUNCTION_1(TYPE, INTERFACE, NAME, ARG1)          \
   static void INTERFACE ## NAME(XW_ ## TYPE xw, ARG1 arg1) {    \
     XWalkExternal ## TYPE * ptr = Get ## TYPE(xw);              \
@@ -57,6 +69,10 @@
 
 template <typename T> struct DefaultSingletonTraits;
 
+namespace base {
+class SequencedWorkerPool;
+}
+
 namespace xwalk {
 namespace extensions {
 
@@ -84,6 +100,16 @@ class XWalkExternalAdapter {
   void RegisterInstance(XWalkExternalInstance* context);
   void UnregisterInstance(XWalkExternalInstance* context);
 
+  // Lets the extensions asking for it through XW_Internal_ThreadingInterface
+  // run their callbacks on a pool of |max_threads| threads. Only the
+  // Extension Process enables it, elsewhere the callbacks stay on the thread
+  // of their server.
+  void EnableWorkerThreads(size_t max_threads);
+  // Waits for the callbacks already running, drops the pending ones.
+  void ShutdownWorkerThreads();
+  // NULL unless worker threads are enabled.
+  base::SequencedWorkerPool* worker_pool() { return worker_pool_.get(); }
+
   // Returns the correct struct according to interface asked. This is
   // passed to external extensions in XW_Initialize() call.
   static const void* GetInterface(const char* name);
@@ -116,15 +142,26 @@ class XWalkExternalAdapter {
   DEFINE_FUNCTION_1(Extension, EntryPoints,
                     SetExtraJSEntryPoints, const char**);
 
-  // XW_Internal_PermissionsInterface_1 from XW_Extension_Permissions.h
+  // XW_Internal_PermissionsInterface_1 and
+  // XW_Internal_PermissionsInterface_2 from XW_Extension_Permissions.h
   static int PermissionsCheckAPIAccessControl(XW_Extension xw,
       const char* api_name);
   static int PermissionsRegisterPermissions(XW_Extension xw,
       const char* perm_table);
-
-  // XW_MessagingInterface_1 from XW_Extension.h.
+  static void PermissionsCheckAPIAccessControlAsync(XW_Extension xw,
+      const char* api_name, XW_PermissionResultCallback callback,
+      void* user_data);
+  static void PermissionsRegisterPermissionsAsync(XW_Extension xw,
+      const char* perm_table, XW_PermissionResultCallback callback,
+      void* user_data);
+
+  // XW_MessagingInterface_1 and XW_MessagingInterface_2 from XW_Extension.h.
   DEFINE_FUNCTION_1(Extension, Messaging, Register, XW_HandleMessageCallback);
   DEFINE_FUNCTION_1(Instance, Messaging, PostMessage, const char*);
+  DEFINE_FUNCTION_1(Extension, Messaging, RegisterBinaryMessageCallback,
+                    XW_HandleBinaryMessageCallback);
+  DEFINE_FUNCTION_2(Instance, Messaging, PostBinaryMessage,
+                    const void*, size_t);
 
   // XW_Internal_SyncMessaging_1 from XW_Extension_SyncMessage.h.
   DEFINE_FUNCTION_1(Extension, SyncMessaging, Register,
@@ -135,6 +172,13 @@ class XWalkExternalAdapter {
   DEFINE_FUNCTION_3(Extension, Runtime, GetStringVariable, const char *,
                     char*, size_t);
 
+  // XW_Internal_ThreadingInterface_1 from XW_Extension_Threading.h.
+  DEFINE_FUNCTION_0(Extension, Threading, UseWorkerThreads);
+
+  // Guards the maps, extensions using worker threads look their instances up
+  // from any thread.
+  base::Lock lock_;
+
   typedef std::map<XW_Extension, XWalkExternalExtension*> ExtensionMap;
   ExtensionMap extension_map_;
 
@@ -144,6 +188,8 @@ class XWalkExternalAdapter {
   XW_Extension next_xw_extension_;
   XW_Instance next_xw_instance_;
 
+  scoped_refptr<base::SequencedWorkerPool> worker_pool_;
+
   DISALLOW_COPY_AND_ASSIGN(XWalkExternalAdapter);
 };
 
@@ -6,7 +6,9 @@
 
 #include <string>
 #include <vector>
+#include "base/file_util.h"
 #include "base/files/file_path.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
@@ -22,8 +24,12 @@ XWalkExternalExtension::XWalkExternalExtension(const base::FilePath& path)
       destroyed_instance_callback_(NULL),
       shutdown_callback_(NULL),
       handle_msg_callback_(NULL),
+      handle_binary_msg_callback_(NULL),
       handle_sync_msg_callback_(NULL),
+      use_worker_threads_(false),
       initialized_(false),
+      has_metadata_(false),
+      load_failed_(false),
       library_path_(path) {
 }
 
@@ -75,7 +81,70 @@ bool XWalkExternalExtension::Initialize() {
   return true;
 }
 
+bool XWalkExternalExtension::InitializeFromMetadataFile(
+    const base::FilePath& metadata_path) {
+  std::string contents;
+  if (!base::ReadFileToString(metadata_path, &contents))
+    return false;
+
+  scoped_ptr<base::Value> value(base::JSONReader::Read(contents));
+  base::DictionaryValue* metadata;
+  if (!value || !value->GetAsDictionary(&metadata)) {
+    LOG(WARNING) << "Invalid extension metadata file '"
+                 << metadata_path.AsUTF8Unsafe() << "'.";
+    return false;
+  }
+
+  std::string name;
+  std::string jsapi_file;
+  if (!metadata->GetString("name", &name) ||
+      !metadata->GetString("jsapi", &jsapi_file)) {
+    LOG(WARNING) << "Extension metadata file '"
+                 << metadata_path.AsUTF8Unsafe()
+                 << "' must have both 'name' and 'jsapi'.";
+    return false;
+  }
+
+  std::string js_api;
+  base::FilePath jsapi_path = metadata_path.DirName().Append(
+      base::FilePath::FromUTF8Unsafe(jsapi_file));
+  if (!base::ReadFileToString(jsapi_path, &js_api)) {
+    LOG(WARNING) << "Can't read JavaScript API of extension '" << name
+                 << "' from '" << jsapi_path.AsUTF8Unsafe() << "'.";
+    return false;
+  }
+
+  std::vector<std::string> entries;
+  base::ListValue* entry_points;
+  if (metadata->GetList("entry_points", &entry_points)) {
+    for (size_t i = 0; i < entry_points->GetSize(); ++i) {
+      std::string entry;
+      if (entry_points->GetString(i, &entry))
+        entries.push_back(entry);
+    }
+  }
+
+  set_name(name);
+  set_javascript_api(js_api);
+  set_entry_points(entries);
+  has_metadata_ = true;
+  return true;
+}
+
 XWalkExtensionInstance* XWalkExternalExtension::CreateInstance() {
+  if (!initialized_) {
+    if (load_failed_)
+      return NULL;
+
+    const std::string advertised_name = name();
+    if (!Initialize() || name() != advertised_name) {
+      LOG(WARNING) << "Failed to load extension '" << advertised_name
+                   << "' from " << library_path_.AsUTF8Unsafe() << ".";
+      load_failed_ = true;
+      return NULL;
+    }
+  }
+
   XW_Instance xw_instance =
       XWalkExternalAdapter::GetInstance()->GetNextXWInstance();
   return new XWalkExternalInstance(this, xw_instance);
@@ -96,6 +165,9 @@ void XWalkExternalExtension::CoreSetExtensionName(const char* name) {
 
 void XWalkExternalExtension::CoreSetJavaScriptAPI(const char* js_api) {
   RETURN_IF_INITIALIZED("SetJavaScriptAPI from CoreInterface");
+  // The renderer already got the API from the metadata file.
+  if (has_metadata_)
+    return;
   set_javascript_api(std::string(js_api));
 }
 
@@ -119,16 +191,28 @@ void XWalkExternalExtension::MessagingRegister(
   handle_msg_callback_ = callback;
 }
 
+void XWalkExternalExtension::MessagingRegisterBinaryMessageCallback(
+    XW_HandleBinaryMessageCallback callback) {
+  RETURN_IF_INITIALIZED(
+      "RegisterBinaryMessageCallback from MessagingInterface");
+  handle_binary_msg_callback_ = callback;
+}
+
 void XWalkExternalExtension::SyncMessagingRegister(
     XW_HandleSyncMessageCallback callback) {
   RETURN_IF_INITIALIZED("Register from Internal_SyncMessagingInterface");
   handle_sync_msg_callback_ = callback;
 }
 
+void XWalkExternalExtension::ThreadingUseWorkerThreads() {
+  RETURN_IF_INITIALIZED("UseWorkerThreads from Internal_ThreadingInterface");
+  use_worker_threads_ = true;
+}
+
 void XWalkExternalExtension::EntryPointsSetExtraJSEntryPoints(
     const char** entry_points) {
   RETURN_IF_INITIALIZED("SetExtraJSEntryPoints from EntryPoints");
-  if (!entry_points)
+  if (!entry_points || has_metadata_)
     return;
 
   std::vector<std::string> entries;
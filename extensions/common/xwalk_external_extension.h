@@ -30,14 +30,33 @@ class XWalkExternalInstance;
 // library, and store the callbacks to call it back later. The associated
 // XW_Extension is used to identify this extension when calling the shared
 // library.
+//
+// The library may come with a sidecar metadata file (see
+// InitializeFromMetadataFile()) describing the extension, in which case it is
+// only loaded when the first instance is created.
 class XWalkExternalExtension : public XWalkExtension {
  public:
   explicit XWalkExternalExtension(const base::FilePath& path);
 
   virtual ~XWalkExternalExtension();
 
+  // Loads the library and calls its XW_Initialize().
   bool Initialize();
 
+  // Reads the name, JavaScript API and entry points of the extension from
+  // |metadata_path| without loading the library. The file is a JSON
+  // dictionary:
+  //
+  //   {
+  //     "name": "tizen.foo",
+  //     "jsapi": "foo_api.js",
+  //     "entry_points": ["tizen.FooBar"]
+  //   }
+  //
+  // where "jsapi" is relative to the metadata file and "entry_points" is
+  // optional. Returns false if the file doesn't exist or is invalid.
+  bool InitializeFromMetadataFile(const base::FilePath& metadata_path);
+
   void set_runtime_variables(const base::ValueMap& runtime_variables) {
     runtime_variables_ = runtime_variables;
   }
@@ -62,8 +81,10 @@ class XWalkExternalExtension : public XWalkExtension {
   void CoreRegisterShutdownCallback(XW_ShutdownCallback callback);
   void EntryPointsSetExtraJSEntryPoints(const char** entry_points);
 
-  // XW_MessagingInterface_1 (from XW_Extension.h) implementation.
+  // XW_MessagingInterface_2 (from XW_Extension.h) implementation.
   void MessagingRegister(XW_HandleMessageCallback callback);
+  void MessagingRegisterBinaryMessageCallback(
+      XW_HandleBinaryMessageCallback callback);
 
   // XW_Internal_SyncMessagingInterface_1 (from XW_Extension.h) implementation.
   void SyncMessagingRegister(XW_HandleSyncMessageCallback callback);
@@ -71,6 +92,10 @@ class XWalkExternalExtension : public XWalkExtension {
   // XW_Internal_BrowserInterface_1 (from XW_Browser.h) implementation.
   void RuntimeGetStringVariable(const char* key, char* value, size_t value_len);
 
+  // XW_Internal_ThreadingInterface_1 (from XW_Extension_Threading.h)
+  // implementation.
+  void ThreadingUseWorkerThreads();
+
   base::FilePath library_path_;
   base::ScopedNativeLibrary library_;
   XW_Extension xw_extension_;
@@ -79,10 +104,17 @@ class XWalkExternalExtension : public XWalkExtension {
   XW_DestroyedInstanceCallback destroyed_instance_callback_;
   XW_ShutdownCallback shutdown_callback_;
   XW_HandleMessageCallback handle_msg_callback_;
+  XW_HandleBinaryMessageCallback handle_binary_msg_callback_;
   XW_HandleSyncMessageCallback handle_sync_msg_callback_;
 
+  bool use_worker_threads_;
   bool initialized_;
 
+  // Set when the extension was described by its metadata file, the library
+  // is loaded on demand and must match the advertised name.
+  bool has_metadata_;
+  bool load_failed_;
+
   DISALLOW_COPY_AND_ASSIGN(XWalkExternalExtension);
 };
 
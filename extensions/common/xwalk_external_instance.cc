@@ -5,9 +5,15 @@
 #include "xwalk/extensions/common/xwalk_external_instance.h"
 
 #include <string>
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "xwalk/extensions/common/xwalk_external_extension.h"
 #include "xwalk/extensions/common/xwalk_external_adapter.h"
+#include "xwalk/extensions/common/xwalk_extension_stats.h"
 
 namespace xwalk {
 namespace extensions {
@@ -17,7 +23,18 @@ XWalkExternalInstance::XWalkExternalInstance(
     : xw_instance_(xw_instance),
       extension_(extension),
       instance_data_(NULL),
-      is_handling_sync_msg_(false) {
+      is_handling_sync_msg_(false),
+      weak_ptr_factory_(this) {
+  weak_this_ = weak_ptr_factory_.GetWeakPtr();
+  base::SequencedWorkerPool* pool =
+      XWalkExternalAdapter::GetInstance()->worker_pool();
+  if (extension_->use_worker_threads_ && pool &&
+      base::MessageLoopProxy::current()) {
+    owner_task_runner_ = base::MessageLoopProxy::current();
+    worker_task_runner_ = pool->GetSequencedTaskRunnerWithShutdownBehavior(
+        pool->GetSequenceToken(), base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  }
+
   XWalkExternalAdapter::GetInstance()->RegisterInstance(this);
   XW_CreatedInstanceCallback callback = extension_->created_instance_callback_;
   if (callback)
@@ -25,14 +42,58 @@ XWalkExternalInstance::XWalkExternalInstance(
 }
 
 XWalkExternalInstance::~XWalkExternalInstance() {
+  // The callbacks still pending must run before the extension forgets about
+  // the instance, and they use this object.
+  // Waiting is fine, the Extension Process thread doesn't restrict it.
+  base::WaitableEvent destroyed(false, false);
+  if (worker_task_runner_ &&
+      worker_task_runner_->PostTask(FROM_HERE,
+          base::Bind(&XWalkExternalInstance::RunDestroyedCallback,
+                     base::Unretained(this), &destroyed))) {
+    destroyed.Wait();
+  } else {
+    RunDestroyedCallback(NULL);
+  }
+  XWalkExternalAdapter::GetInstance()->UnregisterInstance(this);
+}
+
+void XWalkExternalInstance::RunDestroyedCallback(base::WaitableEvent* done) {
   XW_DestroyedInstanceCallback callback =
       extension_->destroyed_instance_callback_;
   if (callback)
     callback(xw_instance_);
-  XWalkExternalAdapter::GetInstance()->UnregisterInstance(this);
+  if (done)
+    done->Signal();
 }
 
 void XWalkExternalInstance::HandleMessage(scoped_ptr<base::Value> msg) {
+  if (worker_task_runner_) {
+    worker_task_runner_->PostTask(FROM_HERE,
+        base::Bind(&XWalkExternalInstance::RunMessageCallback,
+                   base::Unretained(this), base::Passed(&msg)));
+    return;
+  }
+  RunMessageCallback(msg.Pass());
+}
+
+void XWalkExternalInstance::RunMessageCallback(scoped_ptr<base::Value> msg) {
+  TRACE_EVENT1(kExtensionTraceCategory, "XWalkExternalInstance::HandleMessage",
+               "extension", TRACE_STR_COPY(extension_->name().c_str()));
+  if (msg->IsType(base::Value::TYPE_BINARY)) {
+    XW_HandleBinaryMessageCallback callback =
+        extension_->handle_binary_msg_callback_;
+    if (!callback) {
+      LOG(WARNING) << "Ignoring binary message sent for external extension '"
+                   << extension_->name() << "' which doesn't support it.";
+      return;
+    }
+
+    const base::BinaryValue* binary_msg =
+        static_cast<const base::BinaryValue*>(msg.get());
+    callback(xw_instance_, binary_msg->GetBuffer(), binary_msg->GetSize());
+    return;
+  }
+
   XW_HandleMessageCallback callback = extension_->handle_msg_callback_;
   if (!callback) {
     LOG(WARNING) << "Ignoring message sent for external extension '"
@@ -46,6 +107,20 @@ void XWalkExternalInstance::HandleMessage(scoped_ptr<base::Value> msg) {
 }
 
 void XWalkExternalInstance::HandleSyncMessage(scoped_ptr<base::Value> msg) {
+  if (worker_task_runner_) {
+    worker_task_runner_->PostTask(FROM_HERE,
+        base::Bind(&XWalkExternalInstance::RunSyncMessageCallback,
+                   base::Unretained(this), base::Passed(&msg)));
+    return;
+  }
+  RunSyncMessageCallback(msg.Pass());
+}
+
+void XWalkExternalInstance::RunSyncMessageCallback(
+    scoped_ptr<base::Value> msg) {
+  TRACE_EVENT1(kExtensionTraceCategory,
+               "XWalkExternalInstance::HandleSyncMessage",
+               "extension", TRACE_STR_COPY(extension_->name().c_str()));
   XW_HandleSyncMessageCallback callback = extension_->handle_sync_msg_callback_;
   if (!callback) {
     LOG(WARNING) << "Ignoring sync message sent for external extension '"
@@ -71,7 +146,23 @@ void XWalkExternalInstance::MessagingPostMessage(const char* msg) {
   PostMessageToJS(scoped_ptr<base::Value>(new base::StringValue(msg)));
 }
 
+void XWalkExternalInstance::MessagingPostBinaryMessage(const void* data,
+                                                       size_t size) {
+  PostBinaryMessageToJS(static_cast<const char*>(data), size);
+}
+
 void XWalkExternalInstance::SyncMessagingSetSyncReply(const char* reply) {
+  // The pending sync messages are tracked on the thread of the server.
+  if (owner_task_runner_ && !owner_task_runner_->BelongsToCurrentThread()) {
+    owner_task_runner_->PostTask(FROM_HERE,
+        base::Bind(&XWalkExternalInstance::SendSyncReply, weak_this_,
+                   std::string(reply)));
+    return;
+  }
+  SendSyncReply(reply);
+}
+
+void XWalkExternalInstance::SendSyncReply(const std::string& reply) {
   SendSyncReplyToJS(scoped_ptr<base::Value>(new base::StringValue(reply)));
 }
 
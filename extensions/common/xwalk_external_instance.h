@@ -6,10 +6,18 @@
 #define XWALK_EXTENSIONS_COMMON_XWALK_EXTERNAL_INSTANCE_H_
 
 #include <string>
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "xwalk/extensions/common/xwalk_extension.h"
 #include "xwalk/extensions/public/XW_Extension.h"
 #include "xwalk/extensions/public/XW_Extension_SyncMessage.h"
 
+namespace base {
+class SequencedTaskRunner;
+class SingleThreadTaskRunner;
+class WaitableEvent;
+}
+
 namespace xwalk {
 namespace extensions {
 
@@ -23,6 +31,11 @@ class XWalkExternalExtension;
 // library, and with XWalkExternalExtension to get the appropriate
 // callbacks. The associated XW_Instance is used to identify this context when
 // calling the shared library.
+//
+// When the extension uses worker threads (see XW_Extension_Threading.h), the
+// callbacks of the instance run in a sequence of its own on the worker pool of
+// XWalkExternalAdapter, the instance is still created and destroyed on the
+// thread of its server.
 class XWalkExternalInstance : public XWalkExtensionInstance {
  public:
   XWalkExternalInstance(XWalkExternalExtension* extension,
@@ -36,12 +49,21 @@ class XWalkExternalInstance : public XWalkExtensionInstance {
   virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE;
   virtual void HandleSyncMessage(scoped_ptr<base::Value> msg) OVERRIDE;
 
+  // Call the extension callbacks, on the worker sequence if there is one.
+  void RunMessageCallback(scoped_ptr<base::Value> msg);
+  void RunSyncMessageCallback(scoped_ptr<base::Value> msg);
+  // Signals |done|, if any, once the callback returned.
+  void RunDestroyedCallback(base::WaitableEvent* done);
+
+  void SendSyncReply(const std::string& reply);
+
   // XW_CoreInterface_1 (from XW_Extension.h) implementation.
   void CoreSetInstanceData(void* data);
   void* CoreGetInstanceData();
 
-  // XW_MessagingInterface_1 (from XW_Extension.h) implementation.
+  // XW_MessagingInterface_2 (from XW_Extension.h) implementation.
   void MessagingPostMessage(const char* msg);
+  void MessagingPostBinaryMessage(const void* data, size_t size);
 
   // XW_Internal_SyncMessagingInterface_1 (from XW_Extension_SyncMessage.h)
   // implementation.
@@ -53,6 +75,13 @@ class XWalkExternalInstance : public XWalkExtensionInstance {
   void* instance_data_;
   bool is_handling_sync_msg_;
 
+  // Set when the callbacks run on worker threads.
+  scoped_refptr<base::SequencedTaskRunner> worker_task_runner_;
+  // Where sync replies set from worker threads are sent from.
+  scoped_refptr<base::SingleThreadTaskRunner> owner_task_runner_;
+  base::WeakPtr<XWalkExternalInstance> weak_this_;
+  base::WeakPtrFactory<XWalkExternalInstance> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(XWalkExternalInstance);
 };
 
@@ -6,23 +6,37 @@
 
 #include <string>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/files/file_path.h"
 #include "base/message_loop/message_loop.h"
+#include "base/stl_util.h"
 #include "ipc/ipc_switches.h"
 #include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_sync_channel.h"
 #include "xwalk/extensions/common/xwalk_extension_messages.h"
+#include "xwalk/extensions/common/xwalk_external_adapter.h"
 
 namespace xwalk {
 namespace extensions {
 
+namespace {
+
+// Threads shared by the extensions asking for worker threads.
+const size_t kMaxExtensionWorkerThreads = 4;
+
+}  // namespace
+
 XWalkExtensionProcess::XWalkExtensionProcess(
     const IPC::ChannelHandle& channel_handle)
     : shutdown_event_(false, false),
-      io_thread_("XWalkExtensionProcess_IOThread") {
+      io_thread_("XWalkExtensionProcess_IOThread"),
+      next_permission_request_id_(1),
+      loading_extensions_(false) {
   io_thread_.StartWithOptions(
       base::Thread::Options(base::MessageLoop::TYPE_IO, 0));
+  XWalkExternalAdapter::GetInstance()->EnableWorkerThreads(
+      kMaxExtensionWorkerThreads);
 
   extensions_server_.set_permissions_delegate(this);
   CreateBrowserProcessChannel(channel_handle);
@@ -31,17 +45,41 @@ XWalkExtensionProcess::XWalkExtensionProcess(
 XWalkExtensionProcess::~XWalkExtensionProcess() {
   // FIXME(jeez): Move this to OnChannelClosing/Error/Disconnected when we have
   // our MessageFilter set.
-  extensions_server_.Invalidate();
+  RenderProcessConnectionMap::iterator it = render_process_connections_.begin();
+  for (; it != render_process_connections_.end(); ++it)
+    it->second->server->Invalidate();
 
   shutdown_event_.Signal();
   io_thread_.Stop();
+
+  // Servers must go away before the extensions they are sharing.
+  render_process_connections_.clear();
+  XWalkExternalAdapter::GetInstance()->ShutdownWorkerThreads();
 }
 
+XWalkExtensionProcess::RenderProcessConnection::RenderProcessConnection() {}
+
+XWalkExtensionProcess::RenderProcessConnection::~RenderProcessConnection() {}
+
+XWalkExtensionProcess::PermissionRequest::PermissionRequest() {}
+
+XWalkExtensionProcess::PermissionRequest::~PermissionRequest() {}
+
 bool XWalkExtensionProcess::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(XWalkExtensionProcess, message)
     IPC_MESSAGE_HANDLER(XWalkExtensionProcessMsg_RegisterExtensions,
                         OnRegisterExtensions)
+    IPC_MESSAGE_HANDLER(XWalkExtensionProcessMsg_CreateRenderProcessChannel,
+                        OnCreateRenderProcessChannel)
+    IPC_MESSAGE_HANDLER(XWalkExtensionProcessMsg_CloseRenderProcessChannel,
+                        OnCloseRenderProcessChannel)
+    IPC_MESSAGE_HANDLER(XWalkExtensionProcessMsg_ClearPermissionCache,
+                        OnClearPermissionCache)
+    IPC_MESSAGE_HANDLER(XWalkExtensionProcessMsg_APIAccessControlChecked,
+                        OnAPIAccessControlChecked)
+    IPC_MESSAGE_HANDLER(XWalkExtensionProcessMsg_PermissionsRegistered,
+                        OnPermissionsRegistered)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
@@ -72,10 +110,16 @@ void XWalkExtensionProcess::OnRegisterExtensions(
     ToValueMap(&const_cast<base::ListValue&>(browser_variables_lv),
           browser_variables.get());
 
+    // The tables registered without blocking from XW_Initialize() are sent
+    // in a single message once all the extensions are loaded.
+    {
+      base::AutoLock lock(permission_requests_lock_);
+      loading_extensions_ = true;
+    }
     RegisterExternalExtensionsInDirectory(&extensions_server_, path,
                                           browser_variables.Pass());
+    SendQueuedRegistrations();
   }
-  CreateRenderProcessChannel();
 }
 
 void XWalkExtensionProcess::CreateBrowserProcessChannel(
@@ -94,49 +138,87 @@ void XWalkExtensionProcess::CreateBrowserProcessChannel(
   }
 }
 
-void XWalkExtensionProcess::CreateRenderProcessChannel() {
+void XWalkExtensionProcess::OnCreateRenderProcessChannel(
+    int render_process_id) {
+  if (ContainsKey(render_process_connections_, render_process_id)) {
+    LOG(WARNING) << "Render Process " << render_process_id
+                 << " already has a channel to the Extension Process.";
+    return;
+  }
+
+  linked_ptr<RenderProcessConnection> connection(new RenderProcessConnection);
+  connection->server.reset(new XWalkExtensionServer);
+  connection->server->set_permissions_delegate(this);
+  connection->server->UseExtensionsFrom(extensions_server_);
+
   IPC::ChannelHandle handle(IPC::Channel::GenerateVerifiedChannelID(
       std::string()));
-  rp_channel_handle_ = handle;
 
-  render_process_channel_= IPC::SyncChannel::Create(rp_channel_handle_,
-      IPC::Channel::MODE_SERVER, &extensions_server_,
+  connection->channel = IPC::SyncChannel::Create(handle,
+      IPC::Channel::MODE_SERVER, connection->server.get(),
       io_thread_.message_loop_proxy(), true, &shutdown_event_);
 
 #if defined(OS_POSIX)
-    // On POSIX, pass the server-side file descriptor. We use
-    // TakeClientFileDescriptor() instead of GetClientFileDescriptor()
-    // since the client-side channel will take ownership of the fd.
-    rp_channel_handle_.socket =
-       base::FileDescriptor(render_process_channel_->TakeClientFileDescriptor(),
-          true);
+  // On POSIX, pass the server-side file descriptor. We use
+  // TakeClientFileDescriptor() instead of GetClientFileDescriptor()
+  // since the client-side channel will take ownership of the fd.
+  handle.socket = base::FileDescriptor(
+      connection->channel->TakeClientFileDescriptor(), true);
 #endif
 
-  extensions_server_.Initialize(render_process_channel_.get());
+  connection->server->Initialize(connection->channel.get());
+  render_process_connections_[render_process_id] = connection;
 
   browser_process_channel_->Send(
       new XWalkExtensionProcessHostMsg_RenderProcessChannelCreated(
-          rp_channel_handle_));
+          render_process_id, handle));
+}
+
+void XWalkExtensionProcess::OnCloseRenderProcessChannel(
+    int render_process_id) {
+  RenderProcessConnectionMap::iterator it =
+      render_process_connections_.find(render_process_id);
+  if (it == render_process_connections_.end())
+    return;
+
+  it->second->server->Invalidate();
+  render_process_connections_.erase(it);
+}
+
+void XWalkExtensionProcess::OnClearPermissionCache() {
+  base::AutoLock lock(permission_cache_lock_);
+  permission_cache_.clear();
 }
 
 bool XWalkExtensionProcess::CheckAPIAccessControl(
     const std::string& extension_name,
     const std::string& api_name) {
-  PermissionCacheType::iterator iter =
-      permission_cache_.find(extension_name + api_name);
-  if (iter != permission_cache_.end())
-    return iter->second;
-
+  const PermissionCacheType::key_type key(extension_name, api_name);
   RuntimePermission result = UNDEFINED_RUNTIME_PERM;
+  {
+    base::AutoLock lock(permission_cache_lock_);
+    PermissionCacheType::iterator iter = permission_cache_.find(key);
+    if (iter != permission_cache_.end())
+      result = iter->second;
+  }
+  if (result != UNDEFINED_RUNTIME_PERM)
+    return (result == ALLOW_SESSION || result == ALLOW_ALWAYS);
+
   browser_process_channel_->Send(
       new XWalkExtensionProcessHostMsg_CheckAPIAccessControl(
           extension_name, api_name, &result));
   DLOG(INFO) << extension_name << "." << api_name << "() --> " << result;
+  return CacheAPIAccessControl(key, result);
+}
+
+bool XWalkExtensionProcess::CacheAPIAccessControl(
+    const PermissionCacheType::key_type& key, RuntimePermission result) {
   if (result == ALLOW_SESSION ||
       result == ALLOW_ALWAYS ||
       result == DENY_SESSION ||
       result == DENY_ALWAYS) {
-    permission_cache_[extension_name+api_name] = result;
+    base::AutoLock lock(permission_cache_lock_);
+    permission_cache_[key] = result;
     return (result == ALLOW_SESSION || result == ALLOW_ALWAYS);
   }
 
@@ -154,5 +236,132 @@ bool XWalkExtensionProcess::RegisterPermissions(
   return result;
 }
 
+void XWalkExtensionProcess::CheckAPIAccessControlAsync(
+    const std::string& extension_name, const std::string& api_name,
+    const XWalkExtension::PermissionResultCallback& callback) {
+  const PermissionCacheType::key_type key(extension_name, api_name);
+  RuntimePermission cached = UNDEFINED_RUNTIME_PERM;
+  {
+    base::AutoLock lock(permission_cache_lock_);
+    PermissionCacheType::iterator iter = permission_cache_.find(key);
+    if (iter != permission_cache_.end())
+      cached = iter->second;
+  }
+  if (cached != UNDEFINED_RUNTIME_PERM) {
+    callback.Run(cached == ALLOW_SESSION || cached == ALLOW_ALWAYS);
+    return;
+  }
+
+  PermissionRequest request;
+  request.callback = callback;
+  request.task_runner = base::MessageLoopProxy::current();
+  int request_id;
+  {
+    base::AutoLock lock(permission_requests_lock_);
+    request_id = next_permission_request_id_++;
+    pending_checks_[request_id] = std::make_pair(key, request);
+  }
+
+  browser_process_channel_->Send(
+      new XWalkExtensionProcessHostMsg_CheckAPIAccessControlAsync(
+          request_id, extension_name, api_name));
+}
+
+void XWalkExtensionProcess::RegisterPermissionsAsync(
+    const std::string& extension_name, const std::string& perm_table,
+    const XWalkExtension::PermissionResultCallback& callback) {
+  PermissionRequest request;
+  request.callback = callback;
+  request.task_runner = base::MessageLoopProxy::current();
+  int request_id;
+  {
+    base::AutoLock lock(permission_requests_lock_);
+    if (loading_extensions_) {
+      queued_extension_names_.push_back(extension_name);
+      queued_perm_tables_.push_back(perm_table);
+      queued_registrations_.push_back(request);
+      return;
+    }
+    request_id = next_permission_request_id_++;
+    pending_registrations_[request_id].push_back(request);
+  }
+
+  browser_process_channel_->Send(
+      new XWalkExtensionProcessHostMsg_RegisterPermissionsBatch(
+          request_id, std::vector<std::string>(1, extension_name),
+          std::vector<std::string>(1, perm_table)));
+}
+
+void XWalkExtensionProcess::SendQueuedRegistrations() {
+  std::vector<std::string> extension_names;
+  std::vector<std::string> perm_tables;
+  int request_id;
+  {
+    base::AutoLock lock(permission_requests_lock_);
+    loading_extensions_ = false;
+    if (queued_registrations_.empty())
+      return;
+
+    request_id = next_permission_request_id_++;
+    pending_registrations_[request_id].swap(queued_registrations_);
+    extension_names.swap(queued_extension_names_);
+    perm_tables.swap(queued_perm_tables_);
+  }
+
+  browser_process_channel_->Send(
+      new XWalkExtensionProcessHostMsg_RegisterPermissionsBatch(
+          request_id, extension_names, perm_tables));
+}
+
+void XWalkExtensionProcess::OnAPIAccessControlChecked(
+    int request_id, RuntimePermission result) {
+  PendingCheckMap::value_type::second_type check;
+  {
+    base::AutoLock lock(permission_requests_lock_);
+    PendingCheckMap::iterator it = pending_checks_.find(request_id);
+    if (it == pending_checks_.end()) {
+      LOG(WARNING) << "Got answer for unknown permission request: "
+                   << request_id;
+      return;
+    }
+    check = it->second;
+    pending_checks_.erase(it);
+  }
+
+  RunPermissionRequest(check.second, CacheAPIAccessControl(check.first,
+                                                           result));
+}
+
+void XWalkExtensionProcess::OnPermissionsRegistered(
+    int request_id, const std::vector<bool>& results) {
+  std::vector<PermissionRequest> requests;
+  {
+    base::AutoLock lock(permission_requests_lock_);
+    PendingRegistrationMap::iterator it =
+        pending_registrations_.find(request_id);
+    if (it == pending_registrations_.end()) {
+      LOG(WARNING) << "Got answer for unknown permission request: "
+                   << request_id;
+      return;
+    }
+    requests.swap(it->second);
+    pending_registrations_.erase(it);
+  }
+
+  for (size_t i = 0; i < requests.size(); ++i)
+    RunPermissionRequest(requests[i], i < results.size() && results[i]);
+}
+
+// static
+void XWalkExtensionProcess::RunPermissionRequest(
+    const PermissionRequest& request, bool result) {
+  if (request.task_runner && !request.task_runner->BelongsToCurrentThread()) {
+    request.task_runner->PostTask(FROM_HERE,
+        base::Bind(request.callback, result));
+    return;
+  }
+  request.callback.Run(result);
+}
+
 }  // namespace extensions
 }  // namespace xwalk
@@ -7,8 +7,13 @@
 
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "base/memory/linked_ptr.h"
+#include "base/message_loop/message_loop_proxy.h"
 #include "base/values.h"
+#include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/thread.h"
 #include "ipc/ipc_channel_handle.h"
@@ -36,7 +41,9 @@ class XWalkExtensionRunner;
 // extension process communication channel, but also the extension side
 // of the extension <-> render process channel.
 // It will be responsible for handling the native side (instances) of
-// External extensions through its XWalkExtensionServer.
+// External extensions through its XWalkExtensionServers, one per Render
+// Process using this Extension Process. Extensions are loaded only once and
+// shared by all the servers.
 class XWalkExtensionProcess : public IPC::Listener,
                               public XWalkExtension::PermissionsDelegate {
  public:
@@ -48,6 +55,12 @@ class XWalkExtensionProcess : public IPC::Listener,
       const std::string& api_name) OVERRIDE;
   virtual bool RegisterPermissions(const std::string& extension_name,
       const std::string& perm_table) OVERRIDE;
+  virtual void CheckAPIAccessControlAsync(const std::string& extension_name,
+      const std::string& api_name,
+      const XWalkExtension::PermissionResultCallback& callback) OVERRIDE;
+  virtual void RegisterPermissionsAsync(const std::string& extension_name,
+      const std::string& perm_table,
+      const XWalkExtension::PermissionResultCallback& callback) OVERRIDE;
 
  private:
   // IPC::Listener implementation.
@@ -56,19 +69,75 @@ class XWalkExtensionProcess : public IPC::Listener,
   // Handlers for IPC messages from XWalkExtensionProcessHost.
   void OnRegisterExtensions(const base::FilePath& extension_path,
                             const base::ListValue& browser_variables);
+  void OnCreateRenderProcessChannel(int render_process_id);
+  void OnCloseRenderProcessChannel(int render_process_id);
+  void OnClearPermissionCache();
+  void OnAPIAccessControlChecked(int request_id, RuntimePermission result);
+  void OnPermissionsRegistered(int request_id,
+                               const std::vector<bool>& results);
 
   void CreateBrowserProcessChannel(const IPC::ChannelHandle& channel_handle);
 
-  void CreateRenderProcessChannel();
+  struct RenderProcessConnection {
+    RenderProcessConnection();
+    ~RenderProcessConnection();
+    // The channel is declared last so it is destroyed before the server it
+    // dispatches to.
+    scoped_ptr<XWalkExtensionServer> server;
+    scoped_ptr<IPC::SyncChannel> channel;
+  };
 
   base::WaitableEvent shutdown_event_;
   base::Thread io_thread_;
   scoped_ptr<IPC::SyncChannel> browser_process_channel_;
+
+  // Owns the loaded extensions, it is not connected to any Render Process.
   XWalkExtensionServer extensions_server_;
-  scoped_ptr<IPC::SyncChannel> render_process_channel_;
-  IPC::ChannelHandle rp_channel_handle_;
-  typedef std::map<std::string, RuntimePermission> PermissionCacheType;
+
+  typedef std::map<int, linked_ptr<RenderProcessConnection> >
+      RenderProcessConnectionMap;
+  RenderProcessConnectionMap render_process_connections_;
+
+  // The session and persistent decisions of the browser, keyed by extension
+  // and API name. Extensions may check their APIs from worker threads.
+  typedef std::map<std::pair<std::string, std::string>, RuntimePermission>
+      PermissionCacheType;
   PermissionCacheType permission_cache_;
+  base::Lock permission_cache_lock_;
+
+  // Returns whether the API is allowed by |result|, which is cached if it
+  // holds beyond this call.
+  bool CacheAPIAccessControl(const PermissionCacheType::key_type& key,
+                             RuntimePermission result);
+
+  // A non-blocking request waiting for the browser.
+  struct PermissionRequest {
+    PermissionRequest();
+    ~PermissionRequest();
+
+    XWalkExtension::PermissionResultCallback callback;
+    // The loop of the requesting thread, NULL if it has none: |callback|
+    // then runs on the thread receiving the answers.
+    scoped_refptr<base::MessageLoopProxy> task_runner;
+  };
+  static void RunPermissionRequest(const PermissionRequest& request,
+                                   bool result);
+
+  // Sends the permission tables registered while the extensions loaded.
+  void SendQueuedRegistrations();
+
+  base::Lock permission_requests_lock_;
+  int next_permission_request_id_;
+  typedef std::map<int, std::pair<PermissionCacheType::key_type,
+                                  PermissionRequest> > PendingCheckMap;
+  PendingCheckMap pending_checks_;
+  typedef std::map<int, std::vector<PermissionRequest> >
+      PendingRegistrationMap;
+  PendingRegistrationMap pending_registrations_;
+  bool loading_extensions_;
+  std::vector<std::string> queued_extension_names_;
+  std::vector<std::string> queued_perm_tables_;
+  std::vector<PermissionRequest> queued_registrations_;
 
   DISALLOW_COPY_AND_ASSIGN(XWalkExtensionProcess);
 };
@@ -28,10 +28,18 @@
         'common/android/xwalk_extension_android.h',
         'common/xwalk_extension.cc',
         'common/xwalk_extension.h',
+        'common/xwalk_extension_binary_pool.cc',
+        'common/xwalk_extension_binary_pool.h',
+        'common/xwalk_extension_catalog.cc',
+        'common/xwalk_extension_catalog.h',
         'common/xwalk_extension_messages.cc',
         'common/xwalk_extension_messages.h',
+        'common/xwalk_extension_published_state.cc',
+        'common/xwalk_extension_published_state.h',
         'common/xwalk_extension_server.cc',
         'common/xwalk_extension_server.h',
+        'common/xwalk_extension_stats.cc',
+        'common/xwalk_extension_stats.h',
         'common/xwalk_extension_switches.cc',
         'common/xwalk_extension_switches.h',
         'common/xwalk_extension_vector.h',
@@ -51,8 +59,11 @@
         'public/XW_Extension.h',
         'public/XW_Extension_Permissions.h',
         'public/XW_Extension_SyncMessage.h',
+        'public/XW_Extension_Threading.h',
         'renderer/xwalk_extension_client.cc',
         'renderer/xwalk_extension_client.h',
+        'renderer/xwalk_extension_code_cache.cc',
+        'renderer/xwalk_extension_code_cache.h',
         'renderer/xwalk_extension_module.cc',
         'renderer/xwalk_extension_module.h',
         'renderer/xwalk_extension_renderer_controller.cc',
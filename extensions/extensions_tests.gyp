@@ -11,7 +11,14 @@
       ],
       'sources': [
         'browser/xwalk_extension_function_handler_unittest.cc',
+        'common/xwalk_extension_binary_pool_unittest.cc',
+        'common/xwalk_extension_catalog_unittest.cc',
+        'common/xwalk_extension_permissions_unittest.cc',
+        'common/xwalk_extension_published_state_unittest.cc',
         'common/xwalk_extension_server_unittest.cc',
+        'common/xwalk_extension_stats_unittest.cc',
+        'renderer/xwalk_extension_client_unittest.cc',
+        'renderer/xwalk_extension_code_cache_unittest.cc',
       ],
     },
     {
@@ -60,5 +67,29 @@
         'test/xwalk_extensions_test_base.h',
       ],
     },
+    {
+      'target_name': 'xwalk_extensions_perftests',
+      'type': 'executable',
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../content/content.gyp:content_browser',
+        '../../content/content_shell_and_tests.gyp:test_support_content',
+        '../../testing/gtest.gyp:gtest',
+        '../../testing/perf/perf_test.gyp:perf_test',
+        '../test/base/base.gyp:xwalk_test_base',
+        '../xwalk.gyp:xwalk_runtime',
+        'extensions.gyp:xwalk_extensions',
+        'external_extension_sample.gyp:echo_extension',
+      ],
+      'defines': [
+        'HAS_OUT_OF_PROC_TEST_RUNNER',
+      ],
+      'sources': [
+        'test/extension_messaging_perftest.cc',
+        'test/lifecycle_tracker_perftest.cc',
+        'test/xwalk_extensions_test_base.cc',
+        'test/xwalk_extensions_test_base.h',
+      ],
+    },
   ],
 }
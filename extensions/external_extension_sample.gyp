@@ -110,5 +110,22 @@
         }],
       ],
     },
+    {
+      'target_name': 'worker_threads_extension',
+      'type': 'loadable_module',
+      'variables': {
+        'mac_strip': 0,
+      },
+      'sources': [
+        'test/worker_threads_extension.c',
+      ],
+      'conditions': [
+        ['OS=="win"', {
+          'product_dir': '<(PRODUCT_DIR)\\tests\\extension\\worker_threads_extension\\'
+        }, {
+          'product_dir': '<(PRODUCT_DIR)/tests/extension/worker_threads_extension/'
+        }],
+      ],
+    },
   ],
 }
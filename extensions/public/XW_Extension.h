@@ -33,6 +33,7 @@ extern "C" {
 #define XW_EXPORT __declspec(dllexport)
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 
@@ -154,10 +155,14 @@ typedef struct XW_CoreInterface_1 XW_CoreInterface;
 //
 
 #define XW_MESSAGING_INTERFACE_1 "XW_MessagingInterface_1"
-#define XW_MESSAGING_INTERFACE XW_MESSAGING_INTERFACE_1
+#define XW_MESSAGING_INTERFACE_2 "XW_MessagingInterface_2"
+#define XW_MESSAGING_INTERFACE XW_MESSAGING_INTERFACE_2
 
 typedef void (*XW_HandleMessageCallback)(XW_Instance instance,
                                          const char* message);
+typedef void (*XW_HandleBinaryMessageCallback)(XW_Instance instance,
+                                               const void* data,
+                                               size_t size);
 
 struct XW_MessagingInterface_1 {
   // Register a callback to be called when the JavaScript code associated
@@ -176,7 +181,32 @@ struct XW_MessagingInterface_1 {
   void (*PostMessage)(XW_Instance instance, const char* message);
 };
 
-typedef struct XW_MessagingInterface_1 XW_MessagingInterface;
+struct XW_MessagingInterface_2 {
+  // Same as in XW_MessagingInterface_1.
+  void (*Register)(XW_Extension extension,
+                   XW_HandleMessageCallback handle_message);
+  void (*PostMessage)(XW_Instance instance, const char* message);
+
+  // Register a callback to be called when the JavaScript code associated
+  // with the extension posts an ArrayBuffer (or a view of one). The data is
+  // only valid during the callback.
+  //
+  // This function should be called only during XW_Initialize().
+  void (*RegisterBinaryMessageCallback)(
+      XW_Extension extension,
+      XW_HandleBinaryMessageCallback handle_binary_message);
+
+  // Post a binary message to the web content associated with the instance.
+  // The message listener in JavaScript will receive an ArrayBuffer with a
+  // copy of the |size| bytes pointed by |data|, no string encoding happens.
+  //
+  // This function is thread-safe and can be called until the instance is
+  // destroyed.
+  void (*PostBinaryMessage)(XW_Instance instance,
+                            const void* data, size_t size);
+};
+
+typedef struct XW_MessagingInterface_2 XW_MessagingInterface;
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -18,8 +18,10 @@ extern "C" {
 
 #define XW_INTERNAL_PERMISSIONS_INTERFACE_1 \
     "XW_Internal_PermissionsInterface_1"
+#define XW_INTERNAL_PERMISSIONS_INTERFACE_2 \
+    "XW_Internal_PermissionsInterface_2"
 #define XW_INTERNAL_PERMISSIONS_INTERFACE \
-    XW_INTERNAL_PERMISSIONS_INTERFACE_1
+    XW_INTERNAL_PERMISSIONS_INTERFACE_2
 
 //
 // XW_INTERNAL_PERMISSIONS_INTERFACE: provides a way for extensions
@@ -31,7 +33,35 @@ struct XW_Internal_PermissionsInterface_1 {
   int (*RegisterPermissions)(XW_Extension extension, const char* perm_table);
 };
 
-typedef struct XW_Internal_PermissionsInterface_1
+// Called with XW_OK or XW_ERROR, like the return value of the blocking
+// variants, and the |user_data| given with the request.
+typedef void (*XW_PermissionResultCallback)(XW_Extension extension,
+                                            int result,
+                                            void* user_data);
+
+struct XW_Internal_PermissionsInterface_2 {
+  // Same as in XW_Internal_PermissionsInterface_1. They block the calling
+  // thread until the browser answers, which can take a while if the user is
+  // asked.
+  int (*CheckAPIAccessControl)(XW_Extension extension, const char* api_name);
+  int (*RegisterPermissions)(XW_Extension extension, const char* perm_table);
+
+  // Same without blocking. |callback| is invoked later on the calling thread
+  // if it runs a message loop, as the threads of the extension process do,
+  // on the main thread of the process otherwise. Tables registered from
+  // XW_Initialize() are sent to the browser together once all the extensions
+  // are loaded.
+  void (*CheckAPIAccessControlAsync)(XW_Extension extension,
+                                     const char* api_name,
+                                     XW_PermissionResultCallback callback,
+                                     void* user_data);
+  void (*RegisterPermissionsAsync)(XW_Extension extension,
+                                   const char* perm_table,
+                                   XW_PermissionResultCallback callback,
+                                   void* user_data);
+};
+
+typedef struct XW_Internal_PermissionsInterface_2
     XW_Internal_PermissionsInterface;
 
 #ifdef __cplusplus
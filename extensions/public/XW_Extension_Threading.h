@@ -0,0 +1,51 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_EXTENSIONS_PUBLIC_XW_EXTENSION_THREADING_H_
+#define XWALK_EXTENSIONS_PUBLIC_XW_EXTENSION_THREADING_H_
+
+// NOTE: This file and interfaces marked as internal are not considered stable
+// and can be modified in incompatible ways between Crosswalk versions.
+
+#ifndef XWALK_EXTENSIONS_PUBLIC_XW_EXTENSION_H_
+#error "You should include XW_Extension.h before this file"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define XW_INTERNAL_THREADING_INTERFACE_1 \
+    "XW_Internal_ThreadingInterface_1"
+#define XW_INTERNAL_THREADING_INTERFACE \
+    XW_INTERNAL_THREADING_INTERFACE_1
+
+//
+// XW_INTERNAL_THREADING_INTERFACE: lets extensions doing heavy work in their
+// callbacks run them on a pool of worker threads, so they don't delay the
+// other extensions sharing the process.
+//
+
+struct XW_Internal_ThreadingInterface_1 {
+  // After this call the message, binary message and sync message callbacks
+  // of the extension run on worker threads. The callbacks of one instance
+  // run one at a time, in the order the messages were sent, and the
+  // destroyed instance callback runs after all of them. Callbacks of
+  // different instances may run concurrently.
+  //
+  // PostMessage(), PostBinaryMessage() and SetSyncReply() can be called from
+  // any thread.
+  //
+  // This function should be called only during XW_Initialize().
+  void (*UseWorkerThreads)(XW_Extension extension);
+};
+
+typedef struct XW_Internal_ThreadingInterface_1
+    XW_Internal_ThreadingInterface;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // XWALK_EXTENSIONS_PUBLIC_XW_EXTENSION_THREADING_H_
@@ -4,22 +4,43 @@
 
 #include "xwalk/extensions/renderer/xwalk_extension_client.h"
 
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/message_loop/message_loop.h"
 #include "base/values.h"
 #include "base/stl_util.h"
 #include "ipc/ipc_sender.h"
+#include "xwalk/extensions/common/xwalk_extension_catalog.h"
 #include "xwalk/extensions/common/xwalk_extension_messages.h"
+#include "xwalk/extensions/common/xwalk_extension_published_state.h"
 
 namespace xwalk {
 namespace extensions {
 
+// Messages queued by the batched instances of a client before they are sent
+// anyway, whatever the settings of their extensions.
+const size_t kMaxPendingMessagesToNative = 64;
+
+// Bytes of messages to JS held while suspended. Past it they are handed over
+// anyway rather than growing the renderer without bound.
+const size_t kMaxSuspendedMessagesSize = 8 * 1024 * 1024;
+
+void XWalkExtensionClient::InstanceHandler::HandleStringMessageFromNative(
+    const char* data, size_t size) {
+  base::StringValue value(std::string(data, size));
+  HandleMessageFromNative(value);
+}
+
 XWalkExtensionClient::XWalkExtensionClient()
     : sender_(0),
-      next_instance_id_(1) {  // Zero is never used for a valid instance.
+      has_extension_apis_(false),
+      messages_to_js_suspended_(false),
+      suspended_messages_size_(0),
+      next_instance_id_(1),  // Zero is never used for a valid instance.
+      weak_ptr_factory_(this) {
 }
 
-XWalkExtensionClient::~XWalkExtensionClient() {
-  STLDeleteValues(&extension_apis_);
-}
+XWalkExtensionClient::~XWalkExtensionClient() {}
 
 bool XWalkExtensionClient::Send(IPC::Message* msg) {
   DCHECK(sender_);
@@ -31,30 +52,79 @@ int64_t XWalkExtensionClient::CreateInstance(
     const std::string& extension_name,
     InstanceHandler* handler) {
   CHECK(handler);
-  if (!Send(new XWalkExtensionServerMsg_CreateInstance(next_instance_id_,
-                                                       extension_name))) {
-    return 0;
+  // Sent with the next message to native, or at the end of the current task
+  // if there is none, see FlushPendingInstances().
+  if (pending_instance_ids_.empty()) {
+    base::MessageLoop::current()->PostTask(FROM_HERE,
+        base::Bind(&XWalkExtensionClient::FlushPendingInstances,
+                   weak_ptr_factory_.GetWeakPtr()));
   }
+  pending_instance_ids_.push_back(next_instance_id_);
+  pending_instance_names_.push_back(extension_name);
   handlers_[next_instance_id_] = handler;
+  instance_names_[next_instance_id_] = extension_name;
+  stats_.RegisterInstance(next_instance_id_, extension_name);
+
+  ExtensionAPIMap::const_iterator it = extension_apis_.find(extension_name);
+  if (it != extension_apis_.end() && it->second->max_batch_size > 1)
+    batched_instances_[next_instance_id_] = it->second.get();
+
   return next_instance_id_++;
 }
 
 bool XWalkExtensionClient::OnMessageReceived(const IPC::Message& message) {
+  if (messages_to_js_suspended_ &&
+      IPC_MESSAGE_CLASS(message) == XWalkExtensionClientServerMsgStart) {
+    suspended_messages_.push_back(make_linked_ptr(new IPC::Message(message)));
+    suspended_messages_size_ += message.size();
+    if (suspended_messages_size_ > kMaxSuspendedMessagesSize) {
+      LOG(WARNING) << "Too many extension messages held while suspended, "
+                   << "handing them over to JS.";
+      DeliverSuspendedMessages();
+    }
+    return true;
+  }
+
+  return HandleMessage(message);
+}
+
+bool XWalkExtensionClient::HandleMessage(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(XWalkExtensionClient, message)
     IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PostMessageToJS,
         OnPostMessageToJS)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PostStringMessageToJS,
+        OnPostStringMessageToJS)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PostMessageBatchToJS,
+        OnPostMessageBatchToJS)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PostReplyToJS,
+        OnPostReplyToJS)
     IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PostOutOfLineMessageToJS,
         OnPostOutOfLineMessageToJS)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PostSharedMessageToJS,
+        OnPostSharedMessageToJS)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_ExtensionsRegistered,
+        OnExtensionsRegistered)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_ExtensionCatalogShared,
+        OnExtensionCatalogShared)
     IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_InstanceDestroyed,
         OnInstanceDestroyed)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_BinaryPoolCreated,
+        OnBinaryPoolCreated)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PostBinaryMessageToJS,
+        OnPostBinaryMessageToJS)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PublishedStateCreated,
+        OnPublishedStateCreated)
+    IPC_MESSAGE_HANDLER(XWalkExtensionClientMsg_PublishedStateChanged,
+        OnPublishedStateChanged)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
 
   return handled;
 }
 
-XWalkExtensionClient::ExtensionCodePoints::ExtensionCodePoints() {
+XWalkExtensionClient::ExtensionCodePoints::ExtensionCodePoints()
+    : max_batch_size(0) {
 }
 
 XWalkExtensionClient::ExtensionCodePoints::~ExtensionCodePoints() {
@@ -78,6 +148,67 @@ void XWalkExtensionClient::OnPostMessageToJS(int64_t instance_id,
   it->second->HandleMessageFromNative(*value);
 }
 
+void XWalkExtensionClient::OnPostStringMessageToJS(int64_t instance_id,
+                                                   const std::string& msg) {
+  HandlerMap::const_iterator it = handlers_.find(instance_id);
+  if (it == handlers_.end()) {
+    LOG(WARNING) << "Can't PostMessage to invalid Extension instance id: "
+                 << instance_id;
+    return;
+  }
+
+  // See comment in DestroyInstance() about two step destruction.
+  if (!it->second)
+    return;
+
+  it->second->HandleStringMessageFromNative(msg.data(), msg.size());
+}
+
+void XWalkExtensionClient::OnPostMessageBatchToJS(
+    const std::vector<int64_t>& instance_ids, const base::ListValue& msgs) {
+  if (instance_ids.size() != msgs.GetSize()) {
+    LOG(WARNING) << "Got malformed message batch.";
+    return;
+  }
+
+  for (size_t i = 0; i < instance_ids.size(); ++i) {
+    HandlerMap::const_iterator it = handlers_.find(instance_ids[i]);
+    // See comment in DestroyInstance() about two step destruction.
+    if (it == handlers_.end() || !it->second)
+      continue;
+
+    const base::Value* value;
+    msgs.Get(i, &value);
+    it->second->HandleMessageFromNative(*value);
+  }
+}
+
+void XWalkExtensionClient::OnPostReplyToJS(int64_t instance_id,
+                                           int request_id,
+                                           const base::ListValue& reply) {
+  HandlerMap::const_iterator it = handlers_.find(instance_id);
+  if (it == handlers_.end()) {
+    LOG(WARNING) << "Can't send reply to invalid Extension instance id: "
+                 << instance_id;
+    return;
+  }
+
+  // See comment in DestroyInstance() about two step destruction.
+  if (!it->second)
+    return;
+
+  PendingRequestMap::iterator pending = pending_requests_.find(instance_id);
+  if (pending != pending_requests_.end())
+    pending->second.erase(request_id);
+
+  TRACE_EVENT0(kExtensionTraceCategory, "XWalkExtensionClient::HandleReply");
+  TRACE_EVENT_FLOW_END0(kExtensionTraceCategory, "XWalkExtension::Request",
+                        GetRequestFlowId(instance_id, request_id));
+  const base::Value* value;
+  reply.Get(0, &value);
+  it->second->HandleReplyFromNative(request_id, *value);
+}
+
 void XWalkExtensionClient::OnPostOutOfLineMessageToJS(
     base::SharedMemoryHandle handle, size_t size) {
   CHECK(base::SharedMemory::IsHandleValid(handle));
@@ -89,12 +220,108 @@ void XWalkExtensionClient::OnPostOutOfLineMessageToJS(
   OnMessageReceived(message);
 }
 
+void XWalkExtensionClient::OnPostSharedMessageToJS(
+    int64_t instance_id, base::SharedMemoryHandle handle, uint32_t size,
+    bool is_binary) {
+  CHECK(base::SharedMemory::IsHandleValid(handle));
+
+  // Unmapped and closed once the payload has been handed over.
+  base::SharedMemory shared_memory(handle, true);
+  if (!shared_memory.Map(size)) {
+    LOG(WARNING) << "Can't map shared message of size " << size;
+    return;
+  }
+
+  HandlerMap::const_iterator it = handlers_.find(instance_id);
+  // See comment in DestroyInstance() about two step destruction.
+  if (it == handlers_.end() || !it->second)
+    return;
+
+  const char* data = static_cast<const char*>(shared_memory.memory());
+  if (is_binary)
+    it->second->HandleBinaryMessageFromNative(data, size);
+  else
+    it->second->HandleStringMessageFromNative(data, size);
+}
+
+void XWalkExtensionClient::OnBinaryPoolCreated(
+    int pool_id, base::SharedMemoryHandle handle, size_t size) {
+  CHECK(base::SharedMemory::IsHandleValid(handle));
+
+  linked_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(handle, true));
+  if (!shared_memory->Map(size)) {
+    LOG(WARNING) << "Can't map binary message pool: " << pool_id;
+    return;
+  }
+  binary_pools_[pool_id] = shared_memory;
+}
+
+void XWalkExtensionClient::OnPostBinaryMessageToJS(
+    int64_t instance_id, int pool_id, uint32_t offset, uint32_t length) {
+  BinaryPoolMap::const_iterator pool = binary_pools_.find(pool_id);
+  if (pool == binary_pools_.end()) {
+    LOG(WARNING) << "Got binary message for invalid pool id: " << pool_id;
+    return;
+  }
+
+  base::SharedMemory* shared_memory = pool->second.get();
+  if (static_cast<size_t>(offset) + length > shared_memory->mapped_size()) {
+    LOG(WARNING) << "Got binary message out of the pool bounds.";
+    return;
+  }
+
+  HandlerMap::const_iterator it = handlers_.find(instance_id);
+  // See comment in DestroyInstance() about two step destruction.
+  if (it != handlers_.end() && it->second) {
+    it->second->HandleBinaryMessageFromNative(
+        static_cast<const char*>(shared_memory->memory()) + offset, length);
+  }
+
+  // The slot must go back to the server even if nobody consumed it.
+  Send(new XWalkExtensionServerMsg_ReleaseBinaryMessage(instance_id, offset));
+}
+
+void XWalkExtensionClient::OnPublishedStateCreated(
+    int64_t instance_id, base::SharedMemoryHandle handle, size_t size) {
+  CHECK(base::SharedMemory::IsHandleValid(handle));
+
+  // Replaces the segment the state outgrew, if any.
+  linked_ptr<XWalkExtensionPublishedState> state(
+      new XWalkExtensionPublishedState);
+  if (!state->Open(handle, size)) {
+    LOG(WARNING) << "Can't map published state of instance: " << instance_id;
+    return;
+  }
+  published_states_[instance_id] = state;
+}
+
+void XWalkExtensionClient::OnPublishedStateChanged(int64_t instance_id,
+                                                   uint32_t version) {
+  HandlerMap::const_iterator it = handlers_.find(instance_id);
+  // See comment in DestroyInstance() about two step destruction.
+  if (it == handlers_.end() || !it->second)
+    return;
+
+  it->second->HandlePublishedStateChanged(version);
+}
+
+const XWalkExtensionPublishedState* XWalkExtensionClient::GetPublishedState(
+    int64_t instance_id) const {
+  PublishedStateMap::const_iterator it = published_states_.find(instance_id);
+  if (it == published_states_.end())
+    return NULL;
+  return it->second.get();
+}
+
 void XWalkExtensionClient::DestroyInstance(int64_t instance_id) {
   HandlerMap::iterator it = handlers_.find(instance_id);
   if (it == handlers_.end() || !it->second) {
     LOG(WARNING) << "Can't Destroy invalid instance id: " << instance_id;
     return;
   }
+  FlushPendingMessages();
+  batched_instances_.erase(instance_id);
   Send(new XWalkExtensionServerMsg_DestroyInstance(instance_id));
 
   // Destruction happens in two steps, first we nullify the handler in our map,
@@ -117,6 +344,11 @@ void XWalkExtensionClient::OnInstanceDestroyed(int64_t instance_id) {
   // instances.
   DCHECK(!it->second);
   handlers_.erase(it);
+  instance_names_.erase(instance_id);
+  pending_requests_.erase(instance_id);
+  messages_posted_.erase(instance_id);
+  published_states_.erase(instance_id);
+  stats_.UnregisterInstance(instance_id);
 }
 
 namespace {
@@ -139,16 +371,159 @@ scoped_ptr<base::ListValue> WrapValueInList(scoped_ptr<base::Value> value) {
 
 void XWalkExtensionClient::PostMessageToNative(int64_t instance_id,
     scoped_ptr<base::Value> msg) {
+  BatchedInstanceMap::const_iterator it = batched_instances_.find(instance_id);
+  if (it != batched_instances_.end()) {
+    QueueMessageToNative(instance_id, it->second, msg.Pass());
+    return;
+  }
+
+  // Keep the ordering with messages queued by batched instances.
+  FlushPendingMessages();
+  TraceMessagePosted(instance_id);
   scoped_ptr<base::ListValue> list_msg = WrapValueInList(msg.Pass());
   Send(new XWalkExtensionServerMsg_PostMessageToNative(instance_id, *list_msg));
 }
 
+void XWalkExtensionClient::PostStringMessageToNative(int64_t instance_id,
+    const std::string& msg) {
+  BatchedInstanceMap::const_iterator it = batched_instances_.find(instance_id);
+  if (it != batched_instances_.end()) {
+    QueueMessageToNative(instance_id, it->second,
+                         scoped_ptr<base::Value>(new base::StringValue(msg)));
+    return;
+  }
+
+  // Keep the ordering with messages queued by batched instances.
+  FlushPendingMessages();
+  TraceMessagePosted(instance_id);
+  Send(new XWalkExtensionServerMsg_PostStringMessageToNative(instance_id,
+                                                             msg));
+}
+
+void XWalkExtensionClient::PostBinaryMessageToNative(int64_t instance_id,
+    const char* data, size_t size) {
+  BatchedInstanceMap::const_iterator it = batched_instances_.find(instance_id);
+  if (it != batched_instances_.end()) {
+    QueueMessageToNative(instance_id, it->second, scoped_ptr<base::Value>(
+        base::BinaryValue::CreateWithCopiedBuffer(data, size)));
+    return;
+  }
+
+  // Keep the ordering with messages queued by batched instances.
+  FlushPendingMessages();
+  TraceMessagePosted(instance_id);
+  Send(new XWalkExtensionServerMsg_PostBinaryMessageToNative(
+      instance_id, std::vector<char>(data, data + size)));
+}
+
+void XWalkExtensionClient::QueueMessageToNative(
+    int64_t instance_id, const ExtensionCodePoints* codepoints,
+    scoped_ptr<base::Value> msg) {
+  if (!msg)
+    return;
+
+  TraceMessagePosted(instance_id);
+  pending_message_instance_ids_.push_back(instance_id);
+  pending_messages_.Append(msg.release());
+  size_t& instance_count = pending_message_counts_[instance_id];
+  ++instance_count;
+
+  // The queue is shared by the batched instances, each extension only
+  // bounds the messages of its own instances.
+  if (pending_messages_.GetSize() >= kMaxPendingMessagesToNative ||
+      instance_count >= codepoints->max_batch_size) {
+    FlushPendingMessages();
+    return;
+  }
+
+  base::TimeTicks deadline =
+      base::TimeTicks::Now() + codepoints->max_batch_delay;
+  if (pending_flush_deadline_.is_null() || deadline < pending_flush_deadline_) {
+    pending_flush_deadline_ = deadline;
+    base::MessageLoop::current()->PostDelayedTask(FROM_HERE,
+        base::Bind(&XWalkExtensionClient::FlushPendingMessages,
+                   weak_ptr_factory_.GetWeakPtr()),
+        codepoints->max_batch_delay);
+  }
+}
+
+void XWalkExtensionClient::FlushPendingInstances() {
+  if (pending_instance_ids_.empty())
+    return;
+
+  std::vector<int64_t> instance_ids;
+  std::vector<std::string> names;
+  instance_ids.swap(pending_instance_ids_);
+  names.swap(pending_instance_names_);
+  Send(new XWalkExtensionServerMsg_CreateInstances(instance_ids, names));
+}
+
+void XWalkExtensionClient::FlushPendingMessages() {
+  // Every message to native goes after this point, so the server knows the
+  // instances before their first message.
+  FlushPendingInstances();
+
+  pending_flush_deadline_ = base::TimeTicks();
+  if (pending_message_instance_ids_.empty())
+    return;
+
+  std::vector<int64_t> instance_ids;
+  base::ListValue messages;
+  instance_ids.swap(pending_message_instance_ids_);
+  messages.Swap(&pending_messages_);
+  pending_message_counts_.clear();
+
+  // A batch is routed to the server of its instance, so the messages go in
+  // one batch per run of the same instance, in the order they were posted.
+  size_t begin = 0;
+  while (begin < instance_ids.size()) {
+    size_t end = begin + 1;
+    while (end < instance_ids.size() &&
+           instance_ids[end] == instance_ids[begin])
+      ++end;
+    base::ListValue batch;
+    for (size_t i = begin; i < end; ++i) {
+      scoped_ptr<base::Value> value;
+      messages.Remove(0, &value);
+      batch.Append(value.release());
+    }
+    Send(new XWalkExtensionServerMsg_PostMessageBatchToNative(
+        instance_ids[begin], batch));
+    begin = end;
+  }
+}
+
+void XWalkExtensionClient::TraceMessagePosted(int64_t instance_id) {
+  TRACE_EVENT_FLOW_BEGIN0(kExtensionTraceCategory,
+      "XWalkExtension::PostMessage",
+      GetMessageFlowId(instance_id, messages_posted_[instance_id]++));
+}
+
+void XWalkExtensionClient::PostRequestToNative(int64_t instance_id,
+    int request_id, scoped_ptr<base::Value> msg) {
+  // Keep the ordering with messages queued by batched instances.
+  FlushPendingMessages();
+  TRACE_EVENT_FLOW_BEGIN0(kExtensionTraceCategory, "XWalkExtension::Request",
+                          GetRequestFlowId(instance_id, request_id));
+  scoped_ptr<base::ListValue> list_msg = WrapValueInList(msg.Pass());
+  pending_requests_[instance_id].insert(request_id);
+  Send(new XWalkExtensionServerMsg_PostRequestToNative(
+      instance_id, request_id, *list_msg));
+}
+
 scoped_ptr<base::Value> XWalkExtensionClient::SendSyncMessageToNative(
     int64_t instance_id, scoped_ptr<base::Value> msg) {
+  TRACE_EVENT0(kExtensionTraceCategory,
+               "XWalkExtensionClient::SendSyncMessageToNative");
+  // Messages posted before must be handled before the sync one.
+  FlushPendingMessages();
   scoped_ptr<base::ListValue> wrapped_msg = WrapValueInList(msg.Pass());
   base::ListValue* wrapped_reply = new base::ListValue;
-  Send(new XWalkExtensionServerMsg_SendSyncMessageToNative(instance_id,
-      *wrapped_msg, wrapped_reply));
+  IPC::Message* message = new XWalkExtensionServerMsg_SendSyncMessageToNative(
+      instance_id, *wrapped_msg, wrapped_reply);
+  const base::TimeTicks start = base::TimeTicks::Now();
+  Send(message);
+  stats_.RecordSyncCall(instance_id, base::TimeTicks::Now() - start);
 
   scoped_ptr<base::Value> reply;
   wrapped_reply->Remove(0, &reply);
@@ -157,25 +532,151 @@ scoped_ptr<base::Value> XWalkExtensionClient::SendSyncMessageToNative(
 
 void XWalkExtensionClient::Initialize(IPC::Sender* sender) {
   sender_ = sender;
+  EnsureExtensionAPIs();
+}
+
+void XWalkExtensionClient::InitializeAsync(
+    IPC::Sender* sender, const base::Closure& extensions_ready_callback) {
+  sender_ = sender;
+  extensions_ready_callback_ = extensions_ready_callback;
+  Send(new XWalkExtensionServerMsg_RequestExtensions);
+}
 
+void XWalkExtensionClient::EnsureExtensionAPIs() {
+  if (has_extension_apis_)
+    return;
+
+  // The asynchronous answer, if any, is ignored when it comes.
   std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams> extensions;
   Send(new XWalkExtensionServerMsg_GetExtensions(&extensions));
+  RegisterExtensionAPIs(extensions);
+}
+
+void XWalkExtensionClient::Reconnect(IPC::Sender* sender) {
+  sender_ = sender;
+  // What the previous server shared went away with it.
+  binary_pools_.clear();
+  published_states_.clear();
+
+  pending_instance_ids_.clear();
+  pending_instance_names_.clear();
+  std::vector<int64_t> instance_ids;
+  HandlerMap::iterator it = handlers_.begin();
+  while (it != handlers_.end()) {
+    const int64_t instance_id = it->first;
+    // The confirmation of a destruction won't come anymore.
+    if (!it->second) {
+      instance_names_.erase(instance_id);
+      pending_requests_.erase(instance_id);
+      messages_posted_.erase(instance_id);
+      stats_.UnregisterInstance(instance_id);
+      handlers_.erase(it++);
+      continue;
+    }
+    pending_instance_ids_.push_back(instance_id);
+    pending_instance_names_.push_back(instance_names_[instance_id]);
+    instance_ids.push_back(instance_id);
+    ++it;
+  }
+
+  PendingRequestMap failed_requests;
+  failed_requests.swap(pending_requests_);
+  for (size_t i = 0; i < instance_ids.size(); ++i) {
+    // The handlers run JS, which may destroy other instances.
+    HandlerMap::const_iterator handler = handlers_.find(instance_ids[i]);
+    if (handler == handlers_.end() || !handler->second)
+      continue;
+    handler->second->HandleServerRestarted(failed_requests[instance_ids[i]]);
+  }
+}
+
+void XWalkExtensionClient::SuspendMessagesToJS() {
+  messages_to_js_suspended_ = true;
+}
+
+void XWalkExtensionClient::ResumeMessagesToJS() {
+  messages_to_js_suspended_ = false;
+  DeliverSuspendedMessages();
+}
 
-  if (extensions.empty())
+void XWalkExtensionClient::DeliverSuspendedMessages() {
+  std::vector<linked_ptr<IPC::Message> > messages;
+  messages.swap(suspended_messages_);
+  suspended_messages_size_ = 0;
+  for (size_t i = 0; i < messages.size(); ++i)
+    HandleMessage(*messages[i]);
+}
+
+void XWalkExtensionClient::OnExtensionsRegistered(
+    const std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>&
+        extensions) {
+  if (has_extension_apis_)
+    return;
+
+  RegisterExtensionAPIs(extensions);
+  NotifyExtensionsReady();
+}
+
+void XWalkExtensionClient::OnExtensionCatalogShared(
+    base::SharedMemoryHandle handle, size_t size) {
+  if (has_extension_apis_) {
+    base::SharedMemory::CloseHandle(handle);
     return;
+  }
+
+  scoped_refptr<XWalkExtensionCatalog> catalog =
+      XWalkExtensionCatalog::Open(handle, size);
+  if (catalog)
+    RegisterExtensionCatalog(catalog);
+  else
+    EnsureExtensionAPIs();
+  NotifyExtensionsReady();
+}
 
-  std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>::iterator it =
-      extensions.begin();
+void XWalkExtensionClient::NotifyExtensionsReady() {
+  if (!extensions_ready_callback_.is_null())
+    extensions_ready_callback_.Run();
+}
+
+void XWalkExtensionClient::RegisterExtensionAPIs(
+    const std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>&
+        extensions) {
+  has_extension_apis_ = true;
+
+  std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>::const_iterator
+      it = extensions.begin();
   for (; it != extensions.end(); ++it) {
     ExtensionCodePoints* codepoint = new ExtensionCodePoints;
-    codepoint->api = (*it).js_api;
+    codepoint->owned_api = (*it).js_api;
+    codepoint->api = codepoint->owned_api;
 
     codepoint->entry_points = (*it).entry_points;
+    codepoint->max_batch_size = (*it).max_batch_size;
+    codepoint->max_batch_delay = (*it).max_batch_delay;
 
     std::string name = (*it).name;
     extension_apis_[name] = codepoint;
   }
 }
 
+void XWalkExtensionClient::RegisterExtensionCatalog(
+    const scoped_refptr<XWalkExtensionCatalog>& catalog) {
+  has_extension_apis_ = true;
+
+  const std::vector<XWalkExtensionCatalog::Entry>& entries =
+      catalog->entries();
+  for (size_t i = 0; i < entries.size(); ++i) {
+    ExtensionCodePoints* codepoint = new ExtensionCodePoints;
+    codepoint->api = entries[i].js_api;
+    codepoint->catalog = catalog;
+
+    codepoint->entry_points = entries[i].entry_points;
+    codepoint->max_batch_size = entries[i].max_batch_size;
+    codepoint->max_batch_delay = entries[i].max_batch_delay;
+
+    extension_apis_[entries[i].name] = codepoint;
+  }
+}
+
 }  // namespace extensions
 }  // namespace xwalk
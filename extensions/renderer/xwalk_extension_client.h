@@ -7,13 +7,23 @@
 
 #include <stdint.h>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "base/callback.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/shared_memory.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "ipc/ipc_listener.h"
+#include "xwalk/extensions/common/xwalk_extension_stats.h"
+
+struct XWalkExtensionServerMsg_ExtensionRegisterParams;
 
 namespace base {
 class Value;
@@ -26,6 +36,9 @@ class Sender;
 namespace xwalk {
 namespace extensions {
 
+class XWalkExtensionCatalog;
+class XWalkExtensionPublishedState;
+
 // This class holds the JavaScript context of Extensions. It lives in the
 // Render Process and communicates directly with its associated
 // XWalkExtensionServer through an IPC channel.
@@ -37,6 +50,22 @@ class XWalkExtensionClient : public IPC::Listener {
  public:
   struct InstanceHandler {
     virtual void HandleMessageFromNative(const base::Value& msg) = 0;
+    // |data| is only valid during the call.
+    virtual void HandleBinaryMessageFromNative(const char* data,
+                                               size_t size) {}
+    // A message made of a single UTF-8 string, |data| is only valid during
+    // the call. Handed to HandleMessageFromNative() as a StringValue unless
+    // overridden.
+    virtual void HandleStringMessageFromNative(const char* data, size_t size);
+    virtual void HandleReplyFromNative(int request_id,
+                                       const base::Value& reply) {}
+    // The instance published a new state, readable through
+    // GetPublishedState().
+    virtual void HandlePublishedStateChanged(uint32_t version) {}
+    // The process serving the instance died and a new one took over, see
+    // Reconnect(). The requests in |failed_request_ids| won't get a reply.
+    virtual void HandleServerRestarted(
+        const std::set<int>& failed_request_ids) {}
    protected:
     ~InstanceHandler() {}
   };
@@ -49,41 +78,183 @@ class XWalkExtensionClient : public IPC::Listener {
   void DestroyInstance(int64_t instance_id);
 
   void PostMessageToNative(int64_t instance_id, scoped_ptr<base::Value> msg);
+  // Same as PostMessageToNative() with a StringValue, without building it
+  // unless the messages of the instance are batched.
+  void PostStringMessageToNative(int64_t instance_id, const std::string& msg);
+  // Same with a BinaryValue holding |size| bytes at |data|.
+  void PostBinaryMessageToNative(int64_t instance_id, const char* data,
+                                 size_t size);
   scoped_ptr<base::Value> SendSyncMessageToNative(int64_t instance_id,
       scoped_ptr<base::Value> msg);
 
+  // Non-blocking alternative to SendSyncMessageToNative(), the reply is given
+  // to InstanceHandler::HandleReplyFromNative() with the same |request_id|.
+  void PostRequestToNative(int64_t instance_id, int request_id,
+                           scoped_ptr<base::Value> msg);
+
+  // The state published by the instance in shared memory, NULL if it didn't
+  // publish any. See XWalkExtensionInstance::PublishStateToJS().
+  const XWalkExtensionPublishedState* GetPublishedState(
+      int64_t instance_id) const;
+
+  // Fetches the extensions served on the other side of |sender|, blocking
+  // until they arrive.
   void Initialize(IPC::Sender* sender);
 
+  // Same without blocking, |extensions_ready_callback| runs once they arrive.
+  // EnsureExtensionAPIs() fetches them synchronously if they are needed
+  // earlier.
+  void InitializeAsync(IPC::Sender* sender,
+                       const base::Closure& extensions_ready_callback);
+  void EnsureExtensionAPIs();
+  bool has_extension_apis() const { return has_extension_apis_; }
+
+  // Switches to |sender| once the server on the other side of the previous
+  // one is gone and another one serving the same extensions replaced it.
+  // The instances are created again in the new server along with the next
+  // message sent to it, their state is lost.
+  void Reconnect(IPC::Sender* sender);
+
+  // While suspended, the messages from the server are kept instead of being
+  // handed to the instances, so the JS of a hibernated page doesn't run.
+  // They are handed over in order on resume, or as soon as they take more
+  // than a few megabytes.
+  void SuspendMessagesToJS();
+  void ResumeMessagesToJS();
+
   // IPC::Listener Implementation.
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
 
-  struct ExtensionCodePoints {
+  // Immutable once the client is initialized. They are shared by the
+  // modules of every script context instead of being copied for each frame.
+  struct ExtensionCodePoints : public base::RefCounted<ExtensionCodePoints> {
     ExtensionCodePoints();
-    ~ExtensionCodePoints();
-    std::string api;
+    // Points into the mapping of |catalog| when the server shared it, or
+    // into |owned_api| when the APIs were copied over IPC.
+    base::StringPiece api;
+    scoped_refptr<XWalkExtensionCatalog> catalog;
+    std::string owned_api;
     std::vector<std::string> entry_points;
+    size_t max_batch_size;
+    base::TimeDelta max_batch_delay;
+
+   private:
+    friend class base::RefCounted<ExtensionCodePoints>;
+    ~ExtensionCodePoints();
   };
 
-  typedef std::map<std::string, ExtensionCodePoints*> ExtensionAPIMap;
+  typedef std::map<std::string, scoped_refptr<ExtensionCodePoints> >
+      ExtensionAPIMap;
 
   const ExtensionAPIMap& extension_apis() const { return extension_apis_; }
 
+  // Sync calls made through this client, only the client sees how long they
+  // block. The messages in both directions are counted by the server.
+  const XWalkExtensionStats& stats() const { return stats_; }
+
  private:
   bool Send(IPC::Message* msg);
 
+  // Dispatches |message| to its handler, suspended or not.
+  bool HandleMessage(const IPC::Message& message);
+  void DeliverSuspendedMessages();
+
+  void RegisterExtensionAPIs(
+      const std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>&
+          extensions);
+  void RegisterExtensionCatalog(
+      const scoped_refptr<XWalkExtensionCatalog>& catalog);
+  void NotifyExtensionsReady();
+
   // Message Handlers.
+  void OnExtensionsRegistered(
+      const std::vector<XWalkExtensionServerMsg_ExtensionRegisterParams>&
+          extensions);
+  void OnExtensionCatalogShared(base::SharedMemoryHandle handle, size_t size);
   void OnInstanceDestroyed(int64_t instance_id);
   void OnPostMessageToJS(int64_t instance_id, const base::ListValue& msg);
+  void OnPostStringMessageToJS(int64_t instance_id, const std::string& msg);
+  void OnPostMessageBatchToJS(const std::vector<int64_t>& instance_ids,
+                              const base::ListValue& msgs);
+  void OnPostReplyToJS(int64_t instance_id, int request_id,
+                       const base::ListValue& reply);
   void OnPostOutOfLineMessageToJS(base::SharedMemoryHandle handle,
                                   size_t size);
+  void OnPostSharedMessageToJS(int64_t instance_id,
+                               base::SharedMemoryHandle handle,
+                               uint32_t size, bool is_binary);
+  void OnBinaryPoolCreated(int pool_id, base::SharedMemoryHandle handle,
+                           size_t size);
+  void OnPostBinaryMessageToJS(int64_t instance_id, int pool_id,
+                               uint32_t offset, uint32_t length);
+  void OnPublishedStateCreated(int64_t instance_id,
+                               base::SharedMemoryHandle handle, size_t size);
+  void OnPublishedStateChanged(int64_t instance_id, uint32_t version);
+
+  // Queues messages of instances whose extension enabled batching, they are
+  // sent by FlushPendingMessages(). See XWalkExtension::max_batch_size().
+  void QueueMessageToNative(int64_t instance_id,
+                            const ExtensionCodePoints* codepoints,
+                            scoped_ptr<base::Value> msg);
+  void FlushPendingMessages();
+
+  // Sends the instances created since the last message to native in a
+  // single message. Called before any other message is sent.
+  void FlushPendingInstances();
+
+  // Starts the trace flow of the next message of |instance_id|, ended by the
+  // server when it hands the message over.
+  void TraceMessagePosted(int64_t instance_id);
 
   IPC::Sender* sender_;
   ExtensionAPIMap extension_apis_;
+  bool has_extension_apis_;
+  base::Closure extensions_ready_callback_;
 
   typedef std::map<int64_t, InstanceHandler*> HandlerMap;
   HandlerMap handlers_;
 
+  // Kept to create the instances again in a new server.
+  typedef std::map<int64_t, std::string> InstanceNameMap;
+  InstanceNameMap instance_names_;
+
+  // The requests of each instance still waiting for a reply.
+  typedef std::map<int64_t, std::set<int> > PendingRequestMap;
+  PendingRequestMap pending_requests_;
+
+  typedef std::map<int64_t, const ExtensionCodePoints*> BatchedInstanceMap;
+  BatchedInstanceMap batched_instances_;
+
+  // The messages queued by the batched instances, in the order they were
+  // posted, and how many of them each instance queued.
+  std::vector<int64_t> pending_message_instance_ids_;
+  base::ListValue pending_messages_;
+  std::map<int64_t, size_t> pending_message_counts_;
+  base::TimeTicks pending_flush_deadline_;
+
+  std::vector<int64_t> pending_instance_ids_;
+  std::vector<std::string> pending_instance_names_;
+
+  // Binary message pools announced by the servers on the other side of the
+  // channel, mapped for the lifetime of the client.
+  typedef std::map<int, linked_ptr<base::SharedMemory> > BinaryPoolMap;
+  BinaryPoolMap binary_pools_;
+
+  typedef std::map<int64_t, linked_ptr<XWalkExtensionPublishedState> >
+      PublishedStateMap;
+  PublishedStateMap published_states_;
+
+  bool messages_to_js_suspended_;
+  std::vector<linked_ptr<IPC::Message> > suspended_messages_;
+  size_t suspended_messages_size_;
+
   int64_t next_instance_id_;
+
+  XWalkExtensionStats stats_;
+  typedef std::map<int64_t, uint32_t> MessageCountMap;
+  MessageCountMap messages_posted_;
+
+  base::WeakPtrFactory<XWalkExtensionClient> weak_ptr_factory_;
 };
 
 }  // namespace extensions
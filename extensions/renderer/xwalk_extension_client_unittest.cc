@@ -0,0 +1,87 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/renderer/xwalk_extension_client.h"
+
+#include <string>
+#include <vector>
+
+#include "base/message_loop/message_loop.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "xwalk/extensions/common/xwalk_extension_messages.h"
+
+using xwalk::extensions::XWalkExtensionClient;
+
+namespace {
+
+class RecordingHandler : public XWalkExtensionClient::InstanceHandler {
+ public:
+  virtual void HandleMessageFromNative(const base::Value& msg) OVERRIDE {
+    std::string value;
+    ASSERT_TRUE(msg.GetAsString(&value));
+    messages_.push_back(value);
+  }
+
+  const std::vector<std::string>& messages() const { return messages_; }
+
+ private:
+  std::vector<std::string> messages_;
+};
+
+class XWalkExtensionClientSuspendTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    instance_id_ = client_.CreateInstance("test", &handler_);
+  }
+
+  void Receive(const std::string& msg) {
+    EXPECT_TRUE(client_.OnMessageReceived(
+        XWalkExtensionClientMsg_PostStringMessageToJS(instance_id_, msg)));
+  }
+
+  // CreateInstance() posts the task announcing the instance, never run.
+  base::MessageLoop message_loop_;
+  XWalkExtensionClient client_;
+  RecordingHandler handler_;
+  int64_t instance_id_;
+};
+
+}  // namespace
+
+TEST_F(XWalkExtensionClientSuspendTest, HoldsMessagesUntilResumed) {
+  client_.SuspendMessagesToJS();
+  Receive("first");
+  Receive("second");
+  EXPECT_TRUE(handler_.messages().empty());
+
+  client_.ResumeMessagesToJS();
+  ASSERT_EQ(2u, handler_.messages().size());
+  EXPECT_EQ("first", handler_.messages()[0]);
+  EXPECT_EQ("second", handler_.messages()[1]);
+
+  Receive("third");
+  EXPECT_EQ(3u, handler_.messages().size());
+}
+
+TEST_F(XWalkExtensionClientSuspendTest, HandsOverPastTheCap) {
+  client_.SuspendMessagesToJS();
+  const std::string big(1024 * 1024, 'x');
+  size_t received = 0;
+  while (handler_.messages().empty() && received < 64) {
+    Receive(big);
+    ++received;
+  }
+
+  // The held messages were handed over in order once they took too much
+  // memory, but the client is still suspended.
+  ASSERT_LT(received, 64u);
+  EXPECT_EQ(received, handler_.messages().size());
+  Receive("held");
+  EXPECT_EQ(received, handler_.messages().size());
+
+  client_.ResumeMessagesToJS();
+  ASSERT_EQ(received + 1, handler_.messages().size());
+  EXPECT_EQ("held", handler_.messages().back());
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/renderer/xwalk_extension_code_cache.h"
+
+#include "base/hash.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+
+namespace xwalk {
+namespace extensions {
+
+namespace {
+
+base::LazyInstance<XWalkExtensionCodeCache>::Leaky g_code_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+XWalkExtensionCodeCache::XWalkExtensionCodeCache()
+    : hits_(0),
+      misses_(0) {}
+
+XWalkExtensionCodeCache::~XWalkExtensionCodeCache() {}
+
+// static
+XWalkExtensionCodeCache* XWalkExtensionCodeCache::GetInstance() {
+  return g_code_cache.Pointer();
+}
+
+const std::string* XWalkExtensionCodeCache::Lookup(
+    const std::string& extension_name, const std::string& code) {
+  EntryMap::const_iterator it = entries_.find(extension_name);
+  bool hit = it != entries_.end() &&
+      it->second.source_length == code.size() &&
+      it->second.source_hash == base::Hash(code);
+
+  if (hit)
+    hits_++;
+  else
+    misses_++;
+
+  UMA_HISTOGRAM_BOOLEAN("XWalk.Extensions.CodeCacheHit", hit);
+  VLOG(1) << "Code cache " << (hit ? "hit" : "miss") << " for extension '"
+          << extension_name << "' (" << hits_ << " hits, " << misses_
+          << " misses).";
+
+  return hit ? &it->second.data : NULL;
+}
+
+void XWalkExtensionCodeCache::Store(const std::string& extension_name,
+                                    const std::string& code,
+                                    const uint8_t* data, int length) {
+  if (!data || length <= 0)
+    return;
+
+  Entry& entry = entries_[extension_name];
+  entry.source_hash = base::Hash(code);
+  entry.source_length = code.size();
+  entry.data.assign(reinterpret_cast<const char*>(data), length);
+}
+
+}  // namespace extensions
+}  // namespace xwalk
@@ -0,0 +1,61 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_EXTENSIONS_RENDERER_XWALK_EXTENSION_CODE_CACHE_H_
+#define XWALK_EXTENSIONS_RENDERER_XWALK_EXTENSION_CODE_CACHE_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+
+namespace xwalk {
+namespace extensions {
+
+// Keeps the data produced by V8 when compiling the JavaScript API of each
+// extension, so the following script contexts (other frames, iframes) of the
+// same Render Process can hand it back to V8 instead of compiling from
+// scratch. Entries are keyed by extension name and a hash of the source, so a
+// changed API never gets stale data.
+//
+// Only used from the render thread.
+class XWalkExtensionCodeCache {
+ public:
+  XWalkExtensionCodeCache();
+  ~XWalkExtensionCodeCache();
+
+  static XWalkExtensionCodeCache* GetInstance();
+
+  // Returns the cached data for |extension_name| if it was produced from
+  // |code|, NULL otherwise. The returned string is owned by the cache.
+  const std::string* Lookup(const std::string& extension_name,
+                            const std::string& code);
+
+  void Store(const std::string& extension_name, const std::string& code,
+             const uint8_t* data, int length);
+
+  int hits() const { return hits_; }
+  int misses() const { return misses_; }
+
+ private:
+  struct Entry {
+    uint32_t source_hash;
+    size_t source_length;
+    std::string data;
+  };
+
+  typedef std::map<std::string, Entry> EntryMap;
+  EntryMap entries_;
+
+  int hits_;
+  int misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(XWalkExtensionCodeCache);
+};
+
+}  // namespace extensions
+}  // namespace xwalk
+
+#endif  // XWALK_EXTENSIONS_RENDERER_XWALK_EXTENSION_CODE_CACHE_H_
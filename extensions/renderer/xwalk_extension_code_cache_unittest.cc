@@ -0,0 +1,48 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/renderer/xwalk_extension_code_cache.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::extensions::XWalkExtensionCodeCache;
+
+namespace {
+
+const uint8_t kData[] = { 1, 2, 3, 4 };
+
+}  // namespace
+
+TEST(XWalkExtensionCodeCacheTest, HitAfterStore) {
+  XWalkExtensionCodeCache cache;
+  const std::string code = "exports.foo = 1;";
+
+  EXPECT_EQ(NULL, cache.Lookup("foo", code));
+  cache.Store("foo", code, kData, sizeof(kData));
+
+  const std::string* data = cache.Lookup("foo", code);
+  ASSERT_TRUE(data);
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(kData), sizeof(kData)),
+            *data);
+  EXPECT_EQ(1, cache.hits());
+  EXPECT_EQ(1, cache.misses());
+}
+
+TEST(XWalkExtensionCodeCacheTest, MissOnChangedSource) {
+  XWalkExtensionCodeCache cache;
+  cache.Store("foo", "exports.foo = 1;", kData, sizeof(kData));
+
+  EXPECT_EQ(NULL, cache.Lookup("foo", "exports.foo = 2;"));
+  EXPECT_EQ(NULL, cache.Lookup("bar", "exports.foo = 1;"));
+  EXPECT_EQ(0, cache.hits());
+  EXPECT_EQ(2, cache.misses());
+}
+
+TEST(XWalkExtensionCodeCacheTest, IgnoresEmptyData) {
+  XWalkExtensionCodeCache cache;
+  cache.Store("foo", "exports.foo = 1;", NULL, 0);
+  EXPECT_EQ(NULL, cache.Lookup("foo", "exports.foo = 1;"));
+}
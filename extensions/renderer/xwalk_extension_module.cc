@@ -5,12 +5,23 @@
 
 #include "xwalk/extensions/renderer/xwalk_extension_module.h"
 
+#include <string.h>
+#include <map>
+#include <utility>
+
+#include "base/hash.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/values.h"
 #include "content/public/renderer/v8_value_converter.h"
+#include "third_party/WebKit/public/web/WebArrayBuffer.h"
+#include "third_party/WebKit/public/web/WebArrayBufferView.h"
 #include "third_party/WebKit/public/web/WebFrame.h"
 #include "third_party/WebKit/public/web/WebScopedMicrotaskSuppression.h"
+#include "xwalk/extensions/common/xwalk_extension_published_state.h"
+#include "xwalk/extensions/renderer/xwalk_extension_code_cache.h"
 #include "xwalk/extensions/renderer/xwalk_module_system.h"
 #include "xwalk/extensions/renderer/xwalk_v8_utils.h"
 
@@ -25,12 +36,15 @@ const char* kXWalkExtensionModule = "kXWalkExtensionModule";
 
 }  // namespace
 
-XWalkExtensionModule::XWalkExtensionModule(XWalkExtensionClient* client,
-                                           XWalkModuleSystem* module_system,
-                                           const std::string& extension_name,
-                                           const std::string& extension_code)
-    : extension_name_(extension_name),
-      extension_code_(extension_code),
+XWalkExtensionModule::XWalkExtensionModule(
+    XWalkExtensionClient* client,
+    XWalkModuleSystem* module_system,
+    const std::string& extension_name,
+    const XWalkExtensionClient::ExtensionCodePoints* codepoints)
+    : published_state_version_(0),
+      next_request_id_(1),
+      extension_name_(extension_name),
+      codepoints_(codepoints),
       converter_(content::V8ValueConverter::create()),
       client_(client),
       module_system_(module_system),
@@ -56,8 +70,20 @@ XWalkExtensionModule::XWalkExtensionModule(XWalkExtensionClient* client,
       v8::String::NewFromUtf8(isolate, "setMessageListener"),
       v8::FunctionTemplate::New(
           isolate, SetMessageListenerCallback, function_data));
+  object_template->Set(
+      v8::String::NewFromUtf8(isolate, "postRequest"),
+      v8::FunctionTemplate::New(isolate, PostRequestCallback, function_data));
+  object_template->Set(
+      v8::String::NewFromUtf8(isolate, "getPublishedState"),
+      v8::FunctionTemplate::New(
+          isolate, GetPublishedStateCallback, function_data));
+  object_template->Set(
+      v8::String::NewFromUtf8(isolate, "setPublishedStateListener"),
+      v8::FunctionTemplate::New(
+          isolate, SetPublishedStateListenerCallback, function_data));
 
   function_data_.Reset(isolate, function_data);
+  pending_requests_.Reset(isolate, v8::Object::New(isolate));
   object_template_.Reset(isolate, object_template);
 }
 
@@ -77,6 +103,9 @@ XWalkExtensionModule::~XWalkExtensionModule() {
   object_template_.Reset();
   function_data_.Reset();
   message_listener_.Reset();
+  published_state_.Reset();
+  published_state_listener_.Reset();
+  pending_requests_.Reset();
 
   if (instance_id_)
     client_->DestroyInstance(instance_id_);
@@ -101,7 +130,7 @@ std::string CodeToEnsureNamespace(const std::string& extension_name) {
 }
 
 // Wrap API code into a callable form that takes extension object as parameter.
-std::string WrapAPICode(const std::string& extension_code,
+std::string WrapAPICode(const base::StringPiece& extension_code,
                         const std::string& extension_name) {
   // We take care here to make sure that line numbering for api_code after
   // wrapping doesn't change, so that syntax errors point to the correct line.
@@ -110,32 +139,101 @@ std::string WrapAPICode(const std::string& extension_code,
       "extension.internal = {};"
       "extension.internal.sendSyncMessage = extension.sendSyncMessage;"
       "delete extension.sendSyncMessage;"
-      "var exports = {}; (function() {'use strict'; %s\n})();"
+      "var postRequest = extension.postRequest; delete extension.postRequest;"
+      "extension.internal.sendRequest = function(msg) {"
+      "  return new Promise(function(resolve, reject) {"
+      "    if (!postRequest(msg, function(reply, error) {"
+      "          if (error) reject(error); else resolve(reply);"
+      "        }))"
+      "      reject(new Error('Invalid request'));"
+      "  });"
+      "};"
+      "var exports = {}; (function() {'use strict'; %.*s\n})();"
       "%s = exports; });",
       CodeToEnsureNamespace(extension_name).c_str(),
-      extension_code.c_str(),
+      static_cast<int>(extension_code.size()), extension_code.data(),
       extension_name.c_str());
 }
 
-v8::Handle<v8::Value> RunString(const std::string& code,
-                                std::string* exception) {
-  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+// The API scripts compiled in each isolate, by extension. The following
+// script contexts of the render thread only bind and run them, as the
+// XWalkJSModules do with theirs.
+struct CompiledAPI {
+  uint32 code_hash;
+  v8::Persistent<v8::UnboundScript,
+                 v8::CopyablePersistentTraits<v8::UnboundScript> > script;
+};
+typedef std::map<std::pair<v8::Isolate*, std::string>, CompiledAPI>
+    CompiledAPIMap;
+base::LazyInstance<CompiledAPIMap>::Leaky g_compiled_apis =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Compiles |code| once per isolate, using the data cached from a previous
+// compilation of the same extension code, or produces that data if there is
+// none yet.
+v8::Local<v8::UnboundScript> CompileAPICode(v8::Isolate* isolate,
+                                            const std::string& extension_name,
+                                            const std::string& code) {
   v8::EscapableHandleScope handle_scope(isolate);
+  CompiledAPIMap& compiled_apis = g_compiled_apis.Get();
+  const CompiledAPIMap::key_type key(isolate, extension_name);
+  const uint32 code_hash = base::Hash(code);
+  CompiledAPIMap::const_iterator it = compiled_apis.find(key);
+  if (it != compiled_apis.end() && it->second.code_hash == code_hash) {
+    return handle_scope.Escape(
+        v8::Local<v8::UnboundScript>::New(isolate, it->second.script));
+  }
+
   v8::Handle<v8::String> v8_code(
       v8::String::NewFromUtf8(isolate, code.c_str()));
+  XWalkExtensionCodeCache* code_cache = XWalkExtensionCodeCache::GetInstance();
+  const std::string* cached = code_cache->Lookup(extension_name, code);
+
+  // The source takes ownership of the CachedData, but not of its buffer which
+  // stays in the cache.
+  v8::ScriptCompiler::CachedData* cached_data = NULL;
+  if (cached) {
+    cached_data = new v8::ScriptCompiler::CachedData(
+        reinterpret_cast<const uint8_t*>(cached->data()), cached->size());
+  }
+  v8::ScriptCompiler::Source source(v8_code, cached_data);
+
+  v8::Local<v8::UnboundScript> script(v8::ScriptCompiler::CompileUnbound(
+      isolate, &source,
+      cached ? v8::ScriptCompiler::kNoCompileOptions
+             : v8::ScriptCompiler::kProduceDataToCache));
+  if (script.IsEmpty())
+    return handle_scope.Escape(script);
+
+  const v8::ScriptCompiler::CachedData* produced = source.GetCachedData();
+  if (!cached && produced)
+    code_cache->Store(extension_name, code, produced->data, produced->length);
+
+  CompiledAPI& compiled_api = compiled_apis[key];
+  compiled_api.code_hash = code_hash;
+  compiled_api.script.Reset(isolate, script);
+  return handle_scope.Escape(script);
+}
+
+v8::Handle<v8::Value> RunString(const std::string& extension_name,
+                                const std::string& code,
+                                std::string* exception) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::EscapableHandleScope handle_scope(isolate);
 
   blink::WebScopedMicrotaskSuppression suppression;
   v8::TryCatch try_catch;
   try_catch.SetVerbose(true);
 
-  v8::Handle<v8::Script> script(v8::Script::Compile(v8_code));
-  if (try_catch.HasCaught()) {
+  v8::Local<v8::UnboundScript> script =
+      CompileAPICode(isolate, extension_name, code);
+  if (try_catch.HasCaught() || script.IsEmpty()) {
     *exception = ExceptionToString(try_catch);
     return handle_scope.Escape(
         v8::Local<v8::Primitive>(v8::Undefined(isolate)));
   }
 
-  v8::Local<v8::Value> result = script->Run();
+  v8::Local<v8::Value> result = script->BindToCurrentContext()->Run();
   if (try_catch.HasCaught()) {
     *exception = ExceptionToString(try_catch);
     return handle_scope.Escape(
@@ -147,15 +245,28 @@ v8::Handle<v8::Value> RunString(const std::string& code,
 
 }  // namespace
 
+// static
+void XWalkExtensionModule::PrepareExtensionCode(
+    const std::string& extension_name,
+    const base::StringPiece& extension_code) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+  // Errors are reported when a script context loads the code.
+  v8::TryCatch try_catch;
+  CompileAPICode(isolate, extension_name,
+                 WrapAPICode(extension_code, extension_name));
+}
+
 void XWalkExtensionModule::LoadExtensionCode(
     v8::Handle<v8::Context> context, v8::Handle<v8::Function> requireNative) {
   CHECK(!instance_id_);
   instance_id_ = client_->CreateInstance(extension_name_, this);
 
   std::string exception;
-  std::string wrapped_api_code = WrapAPICode(extension_code_, extension_name_);
+  std::string wrapped_api_code =
+      WrapAPICode(codepoints_->api, extension_name_);
   v8::Handle<v8::Value> result =
-      RunString(wrapped_api_code, &exception);
+      RunString(extension_name_, wrapped_api_code, &exception);
   if (!result->IsFunction()) {
     LOG(WARNING) << "Couldn't load JS API code for " << extension_name_
       << ": " << exception;
@@ -192,13 +303,163 @@ void XWalkExtensionModule::HandleMessageFromNative(const base::Value& msg) {
   v8::Handle<v8::Context> context = module_system_->GetV8Context();
   v8::Context::Scope context_scope(context);
 
-  v8::Handle<v8::Value> v8_value(converter_->ToV8Value(&msg, context));
+  DispatchMessageToListener(context, converter_->ToV8Value(&msg, context));
+}
+
+void XWalkExtensionModule::HandleBinaryMessageFromNative(const char* data,
+                                                         size_t size) {
+  if (message_listener_.IsEmpty())
+    return;
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+  v8::Handle<v8::Context> context = module_system_->GetV8Context();
+  v8::Context::Scope context_scope(context);
+
+  // The payload lives in a pool slot that is recycled as soon as we return,
+  // so it's copied straight into the ArrayBuffer backing store.
+  blink::WebArrayBuffer buffer = blink::WebArrayBuffer::create(size, 1);
+  memcpy(buffer.data(), data, size);
+  DispatchMessageToListener(context, buffer.toV8Value());
+}
+
+void XWalkExtensionModule::HandleStringMessageFromNative(const char* data,
+                                                         size_t size) {
+  if (message_listener_.IsEmpty())
+    return;
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+  v8::Handle<v8::Context> context = module_system_->GetV8Context();
+  v8::Context::Scope context_scope(context);
+
+  // Built straight from the IPC payload. It is not wrapped in an external
+  // string: Blink bindings assume the resources of external strings are
+  // their own. JSON is mostly ASCII, which needs no UTF-8 decoding.
+  v8::Handle<v8::String> value;
+  if (base::IsStringASCII(base::StringPiece(data, size))) {
+    value = v8::String::NewFromOneByte(
+        isolate, reinterpret_cast<const uint8_t*>(data),
+        v8::String::kNormalString, static_cast<int>(size));
+  } else {
+    value = v8::String::NewFromUtf8(
+        isolate, data, v8::String::kNormalString, static_cast<int>(size));
+  }
+  DispatchMessageToListener(context, value);
+}
+
+void XWalkExtensionModule::HandleReplyFromNative(int request_id,
+                                                 const base::Value& reply) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+  v8::Handle<v8::Context> context = module_system_->GetV8Context();
+  v8::Context::Scope context_scope(context);
+
+  v8::Handle<v8::Object> pending_requests =
+      v8::Local<v8::Object>::New(isolate, pending_requests_);
+  v8::Handle<v8::Value> callback = pending_requests->Get(request_id);
+  if (!callback->IsFunction()) {
+    LOG(WARNING) << "Got reply for unknown request id: " << request_id;
+    return;
+  }
+  pending_requests->Delete(request_id);
+
+  v8::Handle<v8::Value> v8_reply(converter_->ToV8Value(&reply, context));
+
+  blink::WebScopedMicrotaskSuppression suppression;
+  v8::TryCatch try_catch;
+  callback.As<v8::Function>()->Call(context->Global(), 1, &v8_reply);
+  if (try_catch.HasCaught())
+    LOG(WARNING) << "Exception when running request callback: "
+        << ExceptionToString(try_catch);
+}
+
+void XWalkExtensionModule::HandleServerRestarted(
+    const std::set<int>& failed_request_ids) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+  v8::Handle<v8::Context> context = module_system_->GetV8Context();
+  v8::Context::Scope context_scope(context);
+
+  // The new server publishes its own state, if any.
+  published_state_.Reset();
+
+  blink::WebScopedMicrotaskSuppression suppression;
+  v8::Handle<v8::Object> pending_requests =
+      v8::Local<v8::Object>::New(isolate, pending_requests_);
+  std::set<int>::const_iterator it = failed_request_ids.begin();
+  for (; it != failed_request_ids.end(); ++it) {
+    v8::Handle<v8::Value> callback = pending_requests->Get(*it);
+    if (!callback->IsFunction())
+      continue;
+    pending_requests->Delete(*it);
+
+    // Rejects the promise returned by 'extension.internal.sendRequest()'.
+    v8::Handle<v8::Value> args[] = {
+      v8::Undefined(isolate),
+      v8::Exception::Error(v8::String::NewFromUtf8(
+          isolate, "The extension process was restarted"))
+    };
+    v8::TryCatch try_catch;
+    callback.As<v8::Function>()->Call(context->Global(), arraysize(args),
+                                      args);
+    if (try_catch.HasCaught())
+      LOG(WARNING) << "Exception when running request callback: "
+          << ExceptionToString(try_catch);
+  }
+
+  // Lets the page restore the state the instance lost, e.g.
+  // window.addEventListener('extensionrestarted', function(e) {
+  //   if (e.detail.extension == 'foo') ... });
+  v8::TryCatch try_catch;
+  v8::Handle<v8::Script> script = v8::Script::Compile(v8::String::NewFromUtf8(
+      isolate,
+      "(function(name) {"
+      "  window.dispatchEvent(new CustomEvent('extensionrestarted',"
+      "                                       {detail: {extension: name}}));"
+      "})"));
+  v8::Handle<v8::Value> dispatch = script.IsEmpty() ?
+      v8::Handle<v8::Value>() : script->Run();
+  if (!dispatch.IsEmpty() && dispatch->IsFunction()) {
+    v8::Handle<v8::Value> name =
+        v8::String::NewFromUtf8(isolate, extension_name_.c_str());
+    dispatch.As<v8::Function>()->Call(context->Global(), 1, &name);
+  }
+  if (try_catch.HasCaught())
+    LOG(WARNING) << "Exception when dispatching extensionrestarted: "
+        << ExceptionToString(try_catch);
+}
+
+void XWalkExtensionModule::HandlePublishedStateChanged(uint32_t version) {
+  if (published_state_listener_.IsEmpty())
+    return;
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+  v8::Handle<v8::Context> context = module_system_->GetV8Context();
+  v8::Context::Scope context_scope(context);
+  v8::Handle<v8::Function> listener =
+      v8::Local<v8::Function>::New(isolate, published_state_listener_);
+
+  // The listener reads the new state with 'extension.getPublishedState()',
+  // it isn't parsed unless it does.
+  blink::WebScopedMicrotaskSuppression suppression;
+  v8::TryCatch try_catch;
+  listener->Call(context->Global(), 0, NULL);
+  if (try_catch.HasCaught())
+    LOG(WARNING) << "Exception when running published state listener: "
+        << ExceptionToString(try_catch);
+}
+
+void XWalkExtensionModule::DispatchMessageToListener(
+    v8::Handle<v8::Context> context, v8::Handle<v8::Value> value) {
+  v8::Isolate* isolate = context->GetIsolate();
   v8::Handle<v8::Function> message_listener =
-      v8::Local<v8::Function>::New(isolate, message_listener_);;
+      v8::Local<v8::Function>::New(isolate, message_listener_);
 
   blink::WebScopedMicrotaskSuppression suppression;
   v8::TryCatch try_catch;
-  message_listener->Call(context->Global(), 1, &v8_value);
+  message_listener->Call(context->Global(), 1, &value);
   if (try_catch.HasCaught())
     LOG(WARNING) << "Exception when running message listener: "
         << ExceptionToString(try_catch);
@@ -214,11 +475,44 @@ void XWalkExtensionModule::PostMessageCallback(
     return;
   }
 
+  CHECK(module->instance_id_);
+
+  // Strings, usually JSON, are encoded right into the IPC payload.
+  if (info[0]->IsString()) {
+    v8::Handle<v8::String> string = info[0].As<v8::String>();
+    std::string msg(string->Utf8Length(), '\0');
+    if (!msg.empty()) {
+      string->WriteUtf8(&msg[0], msg.size(), NULL,
+                        v8::String::NO_NULL_TERMINATION);
+    }
+    module->client_->PostStringMessageToNative(module->instance_id_, msg);
+    result.Set(true);
+    return;
+  }
+
+  // As are the bytes of ArrayBuffers and typed arrays, which arrive as a
+  // BinaryValue. Only the bytes in the range of a view are sent.
+  if (info[0]->IsArrayBuffer()) {
+    scoped_ptr<blink::WebArrayBuffer> buffer(
+        blink::WebArrayBuffer::createFromV8Value(info[0]));
+    module->client_->PostBinaryMessageToNative(module->instance_id_,
+        static_cast<const char*>(buffer->data()), buffer->byteLength());
+    result.Set(true);
+    return;
+  }
+  if (info[0]->IsArrayBufferView()) {
+    scoped_ptr<blink::WebArrayBufferView> view(
+        blink::WebArrayBufferView::createFromV8Value(info[0]));
+    module->client_->PostBinaryMessageToNative(module->instance_id_,
+        static_cast<const char*>(view->baseAddress()), view->byteLength());
+    result.Set(true);
+    return;
+  }
+
   v8::Handle<v8::Context> context = info.GetIsolate()->GetCurrentContext();
   scoped_ptr<base::Value> value(
       module->converter_->FromV8Value(info[0], context));
 
-  CHECK(module->instance_id_);
   module->client_->PostMessageToNative(module->instance_id_, value.Pass());
   result.Set(true);
 }
@@ -273,6 +567,103 @@ void XWalkExtensionModule::SetMessageListenerCallback(
   result.Set(true);
 }
 
+// static
+void XWalkExtensionModule::PostRequestCallback(
+    const v8::FunctionCallbackInfo<v8::Value>& info) {
+  v8::ReturnValue<v8::Value> result(info.GetReturnValue());
+  XWalkExtensionModule* module = GetExtensionModule(info);
+  if (!module || info.Length() != 2 || !info[1]->IsFunction()) {
+    result.Set(false);
+    return;
+  }
+
+  v8::Isolate* isolate = info.GetIsolate();
+  v8::Handle<v8::Context> context = isolate->GetCurrentContext();
+  scoped_ptr<base::Value> value(
+      module->converter_->FromV8Value(info[0], context));
+  if (!value) {
+    result.Set(false);
+    return;
+  }
+
+  int request_id = module->next_request_id_++;
+  v8::Handle<v8::Object> pending_requests =
+      v8::Local<v8::Object>::New(isolate, module->pending_requests_);
+  pending_requests->Set(request_id, info[1]);
+
+  CHECK(module->instance_id_);
+  module->client_->PostRequestToNative(module->instance_id_, request_id,
+                                       value.Pass());
+  result.Set(true);
+}
+
+// static
+void XWalkExtensionModule::GetPublishedStateCallback(
+    const v8::FunctionCallbackInfo<v8::Value>& info) {
+  v8::ReturnValue<v8::Value> result(info.GetReturnValue());
+  XWalkExtensionModule* module = GetExtensionModule(info);
+  if (!module)
+    return;
+
+  CHECK(module->instance_id_);
+  const XWalkExtensionPublishedState* state =
+      module->client_->GetPublishedState(module->instance_id_);
+  if (!state)
+    return;
+
+  // Checking the version only reads a word of the shared memory, the state
+  // is copied and parsed again only if it changed since the last read.
+  v8::Isolate* isolate = info.GetIsolate();
+  if (module->published_state_.IsEmpty() ||
+      state->version() != module->published_state_version_) {
+    std::string json;
+    uint32_t version;
+    if (!state->Read(&json, &version))
+      return;
+
+    v8::TryCatch try_catch;
+    v8::Handle<v8::Value> value = v8::JSON::Parse(v8::String::NewFromUtf8(
+        isolate, json.data(), v8::String::kNormalString, json.size()));
+    if (try_catch.HasCaught() || value.IsEmpty()) {
+      LOG(WARNING) << "Can't parse the published state of extension: "
+                   << module->extension_name_;
+      return;
+    }
+    module->published_state_.Reset(isolate, value);
+    module->published_state_version_ = version;
+  }
+
+  result.Set(v8::Local<v8::Value>::New(isolate, module->published_state_));
+}
+
+// static
+void XWalkExtensionModule::SetPublishedStateListenerCallback(
+    const v8::FunctionCallbackInfo<v8::Value>& info) {
+  v8::ReturnValue<v8::Value> result(info.GetReturnValue());
+  XWalkExtensionModule* module = GetExtensionModule(info);
+  if (!module || info.Length() != 1) {
+    result.Set(false);
+    return;
+  }
+
+  if (!info[0]->IsFunction() && !info[0]->IsUndefined()) {
+    LOG(WARNING) << "Trying to set published state listener with invalid "
+        "value.";
+    result.Set(false);
+    return;
+  }
+
+  v8::Isolate* isolate = info.GetIsolate();
+  if (info[0]->IsUndefined()) {
+    module->published_state_listener_.Reset();
+  } else {
+    module->published_state_listener_.Reset(isolate,
+                                            info[0].As<v8::Function>());
+  }
+
+  result.Set(true);
+}
+
 // static
 XWalkExtensionModule* XWalkExtensionModule::GetExtensionModule(
     const v8::FunctionCallbackInfo<v8::Value>& info) {
@@ -5,7 +5,9 @@
 #ifndef XWALK_EXTENSIONS_RENDERER_XWALK_EXTENSION_MODULE_H_
 #define XWALK_EXTENSIONS_RENDERER_XWALK_EXTENSION_MODULE_H_
 
+#include <set>
 #include <string>
+#include <vector>
 #include "xwalk/extensions/renderer/xwalk_extension_client.h"
 #include "xwalk/extensions/renderer/xwalk_module_system.h"
 
@@ -31,10 +33,11 @@ class XWalkModuleSystem;
 // there'll be a set of different modules per v8::Context.
 class XWalkExtensionModule : public XWalkExtensionClient::InstanceHandler {
  public:
-  XWalkExtensionModule(XWalkExtensionClient* client,
-                       XWalkModuleSystem* module_system,
-                       const std::string& extension_name,
-                       const std::string& extension_code);
+  XWalkExtensionModule(
+      XWalkExtensionClient* client,
+      XWalkModuleSystem* module_system,
+      const std::string& extension_name,
+      const XWalkExtensionClient::ExtensionCodePoints* codepoints);
   virtual ~XWalkExtensionModule();
 
   // TODO(cmarcelo): Make this return a v8::Handle<v8::Object>, and
@@ -42,11 +45,34 @@ class XWalkExtensionModule : public XWalkExtensionClient::InstanceHandler {
   void LoadExtensionCode(v8::Handle<v8::Context> context,
                          v8::Handle<v8::Function> requireNative);
 
+  // Compiles the API code of an extension ahead of its first script context,
+  // which then only runs it. The data produced by V8 is left in the
+  // XWalkExtensionCodeCache. Needs an entered context, any will do.
+  static void PrepareExtensionCode(const std::string& extension_name,
+                                   const base::StringPiece& extension_code);
+
   std::string extension_name() const { return extension_name_; }
+  const std::vector<std::string>& entry_points() const {
+    return codepoints_->entry_points;
+  }
 
  private:
   // XWalkExtensionClient::InstanceHandler implementation.
   virtual void HandleMessageFromNative(const base::Value& msg) OVERRIDE;
+  virtual void HandleBinaryMessageFromNative(const char* data,
+                                             size_t size) OVERRIDE;
+  virtual void HandleStringMessageFromNative(const char* data,
+                                             size_t size) OVERRIDE;
+  virtual void HandleReplyFromNative(int request_id,
+                                     const base::Value& reply) OVERRIDE;
+  virtual void HandlePublishedStateChanged(uint32_t version) OVERRIDE;
+  virtual void HandleServerRestarted(
+      const std::set<int>& failed_request_ids) OVERRIDE;
+
+  // Delivers a message that was already converted to the listener set with
+  // 'extension.setMessageListener()'.
+  void DispatchMessageToListener(v8::Handle<v8::Context> context,
+                                 v8::Handle<v8::Value> value);
 
   // Callbacks for JS functions available in 'extension' object.
   static void PostMessageCallback(
@@ -55,6 +81,12 @@ class XWalkExtensionModule : public XWalkExtensionClient::InstanceHandler {
       const v8::FunctionCallbackInfo<v8::Value>& info);
   static void SetMessageListenerCallback(
       const v8::FunctionCallbackInfo<v8::Value>& info);
+  static void PostRequestCallback(
+      const v8::FunctionCallbackInfo<v8::Value>& info);
+  static void GetPublishedStateCallback(
+      const v8::FunctionCallbackInfo<v8::Value>& info);
+  static void SetPublishedStateListenerCallback(
+      const v8::FunctionCallbackInfo<v8::Value>& info);
 
   static XWalkExtensionModule* GetExtensionModule(
       const v8::FunctionCallbackInfo<v8::Value>& info);
@@ -70,8 +102,21 @@ class XWalkExtensionModule : public XWalkExtensionClient::InstanceHandler {
   // This value is registered by using 'extension.setMessageListener()'.
   v8::Persistent<v8::Function> message_listener_;
 
+  // The state published by the instance, parsed at its first read since it
+  // changed, and the function registered with
+  // 'extension.setPublishedStateListener()'.
+  v8::Persistent<v8::Value> published_state_;
+  uint32_t published_state_version_;
+  v8::Persistent<v8::Function> published_state_listener_;
+
+  // Callbacks of the requests waiting for a reply, indexed by request id.
+  v8::Persistent<v8::Object> pending_requests_;
+  int next_request_id_;
+
   std::string extension_name_;
-  std::string extension_code_;
+
+  // Shared with the modules of the same extension in other contexts.
+  scoped_refptr<const XWalkExtensionClient::ExtensionCodePoints> codepoints_;
 
   // TODO(cmarcelo): Move to a single converter, since we always use same
   // parameters.
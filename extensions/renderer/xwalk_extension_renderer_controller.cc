@@ -4,7 +4,11 @@
 
 #include "xwalk/extensions/renderer/xwalk_extension_renderer_controller.h"
 
+#include <algorithm>
+
+#include "base/bind.h"
 #include "base/command_line.h"
+#include "base/message_loop/message_loop.h"
 #include "base/values.h"
 #include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/v8_value_converter.h"
@@ -35,7 +39,9 @@ const GURL kAboutBlankURL = GURL("about:blank");
 
 XWalkExtensionRendererController::XWalkExtensionRendererController(
     Delegate* delegate)
-    : shutdown_event_(false, false),
+    : extension_catalog_built_(false),
+      script_context_created_(false),
+      shutdown_event_(false, false),
       delegate_(delegate) {
   content::RenderThread* thread = content::RenderThread::Get();
   thread->AddObserver(this);
@@ -55,47 +61,11 @@ XWalkExtensionRendererController::~XWalkExtensionRendererController() {
   // content::RenderThread::Get()->RemoveObserver(this);
 }
 
-namespace {
-
-void CreateExtensionModules(XWalkExtensionClient* client,
-                            XWalkModuleSystem* module_system) {
-  const XWalkExtensionClient::ExtensionAPIMap& extensions =
-      client->extension_apis();
-  XWalkExtensionClient::ExtensionAPIMap::const_iterator it = extensions.begin();
-  for (; it != extensions.end(); ++it) {
-    XWalkExtensionClient::ExtensionCodePoints* codepoint = it->second;
-    if (codepoint->api.empty())
-      continue;
-    scoped_ptr<XWalkExtensionModule> module(
-        new XWalkExtensionModule(client, module_system,
-                                 it->first, codepoint->api));
-    module_system->RegisterExtensionModule(module.Pass(),
-                                           codepoint->entry_points);
-  }
-}
-
-#if defined(OS_TIZEN)
-void CreateExtensionModulesWithoutDeviceAPI(XWalkExtensionClient* client,
-                                            XWalkModuleSystem* module_system) {
-  const XWalkExtensionClient::ExtensionAPIMap& extensions =
-      client->extension_apis();
-  XWalkExtensionClient::ExtensionAPIMap::const_iterator it = extensions.begin();
-  for (; it != extensions.end(); ++it) {
-    XWalkExtensionClient::ExtensionCodePoints* codepoint = it->second;
-    if (codepoint->api.empty() || it->first.find("tizen") == 0)
-      continue;
-    scoped_ptr<XWalkExtensionModule> module(
-        new XWalkExtensionModule(client, module_system,
-                                 it->first, codepoint->api));
-    module_system->RegisterExtensionModule(module.Pass(),
-                                           codepoint->entry_points);
-  }
-}
-#endif
-}  // namespace
-
 void XWalkExtensionRendererController::DidCreateScriptContext(
     blink::WebFrame* frame, v8::Handle<v8::Context> context) {
+  script_context_created_ = true;
+  EnsureExtensionCatalog();
+
   XWalkModuleSystem* module_system = new XWalkModuleSystem(context);
   XWalkModuleSystem::SetModuleSystemInContext(
       scoped_ptr<XWalkModuleSystem>(module_system), context);
@@ -108,24 +78,14 @@ void XWalkExtensionRendererController::DidCreateScriptContext(
 
   delegate_->DidCreateModuleSystem(module_system);
 
-  CreateExtensionModules(in_browser_process_extensions_client_.get(),
-                         module_system);
-
-  if (external_extensions_client_) {
+  bool include_device_apis = true;
 #if defined(OS_TIZEN)
-    // On Tizen platform, only local pages can access to device APIs.
-    GURL url = static_cast<GURL>(frame->document().url());
-    if (!url.SchemeIs(xwalk::application::kApplicationScheme) &&
-        !url.SchemeIsFile())
-      CreateExtensionModulesWithoutDeviceAPI(external_extensions_client_.get(),
-                                             module_system);
-    else
-      CreateExtensionModules(external_extensions_client_.get(), module_system);
-#else
-    CreateExtensionModules(external_extensions_client_.get(),
-                           module_system);
+  // On Tizen platform, only local pages can access to device APIs.
+  GURL url = static_cast<GURL>(frame->document().url());
+  include_device_apis = url.SchemeIs(xwalk::application::kApplicationScheme) ||
+      url.SchemeIsFile();
 #endif
-  }
+  CreateExtensionModules(module_system, include_device_apis);
 
   module_system->Initialize();
 }
@@ -136,8 +96,24 @@ void XWalkExtensionRendererController::WillReleaseScriptContext(
   XWalkModuleSystem::ResetModuleSystemFromContext(context);
 }
 
+void XWalkExtensionRendererController::SuspendExtensionMessages() {
+  in_browser_process_extensions_client_->SuspendMessagesToJS();
+  if (external_extensions_client_)
+    external_extensions_client_->SuspendMessagesToJS();
+}
+
+void XWalkExtensionRendererController::ResumeExtensionMessages() {
+  in_browser_process_extensions_client_->ResumeMessagesToJS();
+  if (external_extensions_client_)
+    external_extensions_client_->ResumeMessagesToJS();
+}
+
 bool XWalkExtensionRendererController::OnControlMessageReceived(
     const IPC::Message& message) {
+  if (message.type() == XWalkExtensionClientMsg_ExtensionProcessRestarted::ID) {
+    OnExtensionProcessRestarted();
+    return true;
+  }
   return in_browser_process_extensions_client_->OnMessageReceived(message);
 }
 
@@ -148,23 +124,136 @@ void XWalkExtensionRendererController::OnRenderProcessShutdown() {
 void XWalkExtensionRendererController::SetupBrowserProcessClient(
     IPC::SyncChannel* browser_channel) {
   in_browser_process_extensions_client_.reset(new XWalkExtensionClient);
-  in_browser_process_extensions_client_->Initialize(browser_channel);
+  in_browser_process_extensions_client_->InitializeAsync(browser_channel,
+      base::Bind(&XWalkExtensionRendererController::OnClientExtensionsReady,
+                 base::Unretained(this)));
 }
 
 void XWalkExtensionRendererController::SetupExtensionProcessClient(
     IPC::SyncChannel* browser_channel) {
+  external_extensions_client_.reset(new XWalkExtensionClient);
+  ConnectToExtensionProcess(browser_channel);
+
+  external_extensions_client_->InitializeAsync(
+      extension_process_channel_.get(),
+      base::Bind(&XWalkExtensionRendererController::OnClientExtensionsReady,
+                 base::Unretained(this)));
+}
+
+void XWalkExtensionRendererController::ConnectToExtensionProcess(
+    IPC::SyncChannel* browser_channel) {
   IPC::ChannelHandle handle;
   browser_channel->Send(
       new XWalkExtensionProcessHostMsg_GetExtensionProcessChannel(&handle));
   // FIXME(cmarcelo): Need to account for failure in creating the channel.
 
-  external_extensions_client_.reset(new XWalkExtensionClient);
   extension_process_channel_ = IPC::SyncChannel::Create(handle,
       IPC::Channel::MODE_CLIENT, external_extensions_client_.get(),
       content::RenderThread::Get()->GetIOMessageLoopProxy(), true,
       &shutdown_event_);
+}
+
+void XWalkExtensionRendererController::OnExtensionProcessRestarted() {
+  if (!external_extensions_client_)
+    return;
+
+  // The new Extension Process loads the same extensions, the catalog and
+  // the modules created from it stay valid.
+  ConnectToExtensionProcess(content::RenderThread::Get()->GetChannel());
+  external_extensions_client_->Reconnect(extension_process_channel_.get());
+}
+
+XWalkExtensionRendererController::CatalogEntry::CatalogEntry()
+    : client(NULL),
+      is_device_api(false) {}
+
+XWalkExtensionRendererController::CatalogEntry::~CatalogEntry() {}
+
+namespace {
+
+template <typename Entry>
+void AddClientExtensionsToCatalog(XWalkExtensionClient* client,
+                                  bool is_external,
+                                  std::vector<Entry>* catalog) {
+  const XWalkExtensionClient::ExtensionAPIMap& extensions =
+      client->extension_apis();
+  XWalkExtensionClient::ExtensionAPIMap::const_iterator it = extensions.begin();
+  for (; it != extensions.end(); ++it) {
+    if (it->second->api.empty())
+      continue;
+    Entry entry;
+    entry.name = it->first;
+    entry.client = client;
+    entry.codepoints = it->second;
+    entry.is_device_api = is_external && it->first.find("tizen") == 0;
+    catalog->push_back(entry);
+  }
+}
+
+}  // namespace
 
-  external_extensions_client_->Initialize(extension_process_channel_.get());
+void XWalkExtensionRendererController::OnClientExtensionsReady() {
+  if (extension_catalog_built_ ||
+      !in_browser_process_extensions_client_->has_extension_apis())
+    return;
+  if (external_extensions_client_ &&
+      !external_extensions_client_->has_extension_apis())
+    return;
+
+  BuildExtensionCatalog();
+  base::MessageLoop::current()->PostTask(FROM_HERE,
+      base::Bind(&XWalkExtensionRendererController::PrepareExtensionCode,
+                 base::Unretained(this)));
+}
+
+void XWalkExtensionRendererController::EnsureExtensionCatalog() {
+  if (extension_catalog_built_)
+    return;
+
+  in_browser_process_extensions_client_->EnsureExtensionAPIs();
+  if (external_extensions_client_)
+    external_extensions_client_->EnsureExtensionAPIs();
+  BuildExtensionCatalog();
+}
+
+void XWalkExtensionRendererController::PrepareExtensionCode() {
+  if (script_context_created_)
+    return;
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+  v8::Handle<v8::Context> context = v8::Context::New(isolate);
+  v8::Context::Scope context_scope(context);
+
+  std::vector<CatalogEntry>::const_iterator it = extension_catalog_.begin();
+  for (; it != extension_catalog_.end(); ++it)
+    XWalkExtensionModule::PrepareExtensionCode(it->name, it->codepoints->api);
+}
+
+void XWalkExtensionRendererController::BuildExtensionCatalog() {
+  extension_catalog_built_ = true;
+  AddClientExtensionsToCatalog(in_browser_process_extensions_client_.get(),
+                               false, &extension_catalog_);
+  if (external_extensions_client_) {
+    AddClientExtensionsToCatalog(external_extensions_client_.get(),
+                                 true, &extension_catalog_);
+  }
+
+  // Stable, so in process extensions keep winning name conflicts.
+  std::stable_sort(extension_catalog_.begin(), extension_catalog_.end());
+}
+
+void XWalkExtensionRendererController::CreateExtensionModules(
+    XWalkModuleSystem* module_system, bool include_device_apis) {
+  std::vector<CatalogEntry>::const_iterator it = extension_catalog_.begin();
+  for (; it != extension_catalog_.end(); ++it) {
+    if (it->is_device_api && !include_device_apis)
+      continue;
+    scoped_ptr<XWalkExtensionModule> module(
+        new XWalkExtensionModule(it->client, module_system,
+                                 it->name, it->codepoints.get()));
+    module_system->RegisterExtensionModule(module.Pass());
+  }
 }
 
 
@@ -13,6 +13,7 @@
 #include "base/synchronization/waitable_event.h"
 #include "content/public/renderer/render_process_observer.h"
 #include "v8/include/v8.h"
+#include "xwalk/extensions/renderer/xwalk_extension_client.h"
 
 namespace content {
 class RenderView;
@@ -30,7 +31,6 @@ class WebFrame;
 namespace xwalk {
 namespace extensions {
 
-class XWalkExtensionClient;
 class XWalkModuleSystem;
 
 // Renderer controller for XWalk extensions keeps track of the extensions
@@ -56,6 +56,11 @@ class XWalkExtensionRendererController : public content::RenderProcessObserver {
   void WillReleaseScriptContext(blink::WebFrame* frame,
                                 v8::Handle<v8::Context> context);
 
+  // Keeps the messages posted by the extensions to JS while the application
+  // is hibernated, see XWalkExtensionClient::SuspendMessagesToJS().
+  void SuspendExtensionMessages();
+  void ResumeExtensionMessages();
+
   // RenderProcessObserver implementation.
   virtual bool OnControlMessageReceived(const IPC::Message& message) OVERRIDE;
   virtual void OnRenderProcessShutdown() OVERRIDE;
@@ -67,6 +72,45 @@ class XWalkExtensionRendererController : public content::RenderProcessObserver {
   // channel and plug the external_extensions_client_ into it.
   void SetupExtensionProcessClient(IPC::SyncChannel* browser_channel);
 
+  // Asks the browser for the handle of the channel to the Extension
+  // Process, blocking until it is ready.
+  void ConnectToExtensionProcess(IPC::SyncChannel* browser_channel);
+
+  // The Extension Process died and the browser launched a new one, the
+  // external_extensions_client_ moves to the channel to it.
+  void OnExtensionProcessRestarted();
+
+  // Collects the extensions of both clients, in name order, so every script
+  // context creates its modules from the same shared catalog. The clients
+  // fetch their extensions asynchronously, the catalog is built when both
+  // are done or, if that didn't happen yet, by the first script context.
+  void BuildExtensionCatalog();
+  void EnsureExtensionCatalog();
+  void OnClientExtensionsReady();
+
+  // Compiles the extension APIs once the catalog is built while no script
+  // context needed them yet, so the first one finds them in the code cache.
+  void PrepareExtensionCode();
+
+  void CreateExtensionModules(XWalkModuleSystem* module_system,
+                              bool include_device_apis);
+
+  struct CatalogEntry {
+    CatalogEntry();
+    ~CatalogEntry();
+    bool operator<(const CatalogEntry& other) const {
+      return name < other.name;
+    }
+
+    std::string name;
+    XWalkExtensionClient* client;
+    scoped_refptr<XWalkExtensionClient::ExtensionCodePoints> codepoints;
+    bool is_device_api;
+  };
+  std::vector<CatalogEntry> extension_catalog_;
+  bool extension_catalog_built_;
+  bool script_context_created_;
+
   scoped_ptr<XWalkExtensionClient> in_browser_process_extensions_client_;
   scoped_ptr<XWalkExtensionClient> external_extensions_client_;
 
@@ -2,26 +2,64 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-var callback_listeners = {};
-var callback_id = 0;
+// Calls are posted as [function_name, callback_id, [arguments...]] and
+// replies come back as [callback_id, [results...]]. Callback IDs are positive
+// integers, zero is sent when there is no callback. Functions streaming their
+// results send [callback_id, [results...], true] until the last reply, a
+// call is cancelled by posting [callback_id].
+//
+// The listeners are kept in an array. The low bits of a callback ID are the
+// index of its slot and the high bits count how many times the slot was
+// reused, so a late reply for a removed callback doesn't reach the one now
+// in its slot. Freed slots are reused first, the array only grows as large
+// as the most callbacks pending at once. Slot 0 is never used.
+var kSlotBits = 16;
+var kSlotMask = (1 << kSlotBits) - 1;
+// Keeps the IDs in the range of signed 32 bits integers of the native side.
+var kReuseMask = 0x7fff;
+var callback_listeners = [null];
+var callback_ids = [0];
+// Streaming listeners get every reply as listener(results, more).
+var callback_streaming = [false];
+var free_slots = [];
 var extension_object;
 
-function wrapCallback(args, callback) {
-  if (callback) {
-    var id = (callback_id++).toString();
-    callback_listeners[id] = callback;
-    args.unshift(id);
+function wrapCallback(callback, streaming) {
+  if (!callback)
+    return 0;
+
+  var slot;
+  var id;
+  if (free_slots.length > 0) {
+    slot = free_slots.pop();
+    var reuse = ((callback_ids[slot] >>> kSlotBits) + 1) & kReuseMask;
+    id = (reuse << kSlotBits) | slot;
   } else {
-    // The function name and the callback ID are prepended before
-    // the arguments. If there is no callback, an empty string is
-    // should be used. This will be sorted out by the InternalInstance
-    // message handler.
-    args.unshift("");
+    slot = callback_listeners.length;
+    if (slot > kSlotMask)
+      throw new Error('Too many pending callbacks');
+    id = slot;
   }
 
+  callback_listeners[slot] = callback;
+  callback_ids[slot] = id;
+  callback_streaming[slot] = !!streaming;
   return id;
 }
 
+// Returns 0 if |id| isn't pending.
+function findSlot(id) {
+  var slot = id & kSlotMask;
+  if (!slot || callback_ids[slot] !== id || !callback_listeners[slot])
+    return 0;
+  return slot;
+}
+
+function releaseSlot(slot) {
+  callback_listeners[slot] = null;
+  free_slots.push(slot);
+}
+
 exports.setupInternalExtension = function(extension_obj) {
   if (extension_object != null)
     return;
@@ -29,28 +67,62 @@ exports.setupInternalExtension = function(extension_obj) {
   extension_object = extension_obj;
 
   extension_object.setMessageListener(function(msg) {
-    var args = arguments[0];
-    var id = args.shift();
-    var listener = callback_listeners[id];
+    var id = msg[0];
+    var slot = findSlot(id);
+    if (!slot)
+      return;
 
-    if (listener !== undefined) {
-      if (!listener.apply(null, args))
-        delete callback_listeners[id];
+    var keep;
+    if (callback_streaming[slot]) {
+      keep = msg[2] === true;
+      callback_listeners[slot](msg[1], keep);
+    } else {
+      keep = callback_listeners[slot].apply(null, msg[1]);
     }
+
+    // The listener may have removed itself already.
+    if (!keep && findSlot(id) == slot)
+      releaseSlot(slot);
   });
 };
 
 exports.postMessage = function(function_name, args, callback) {
-  var id = wrapCallback(args, callback);
-  args.unshift(function_name);
-  extension_object.postMessage(args);
+  var id = wrapCallback(callback);
+  extension_object.postMessage([function_name, id, args]);
+
+  return id;
+};
+
+// Same as postMessage() for the functions streaming their results, the
+// callback is called as callback([results...], more) for every reply, with
+// |more| false for the last one.
+exports.postStreamingMessage = function(function_name, args, callback) {
+  var id = wrapCallback(callback, true);
+  extension_object.postMessage([function_name, id, args]);
 
   return id;
 };
 
 exports.removeCallback = function(id) {
-  if (!id in callback_listeners)
+  var slot = findSlot(id);
+  if (slot)
+    releaseSlot(slot);
+};
+
+// Removes the callback and tells the native function it can stop, the
+// results it still posts are dropped.
+exports.cancelCall = function(id) {
+  var slot = findSlot(id);
+  if (!slot)
     return;
+  releaseSlot(slot);
+  extension_object.postMessage([id]);
+};
 
-  delete callback_listeners[id];
+// Non-blocking replacement for extension.internal.sendSyncMessage(), returns a
+// Promise resolved with the reply of the native side. Many requests can be in
+// flight at the same time. Requests use the envelope of the calls, without a
+// callback.
+exports.sendRequest = function(function_name, args) {
+  return extension_object.internal.sendRequest([function_name, 0, args]);
 };
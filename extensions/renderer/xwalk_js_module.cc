@@ -4,7 +4,12 @@
 
 #include "xwalk/extensions/renderer/xwalk_js_module.h"
 
+#include <map>
+#include <utility>
+
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/strings/string_piece.h"
 #include "third_party/WebKit/public/web/WebScopedMicrotaskSuppression.h"
 #include "ui/base/resource/resource_bundle.h"
 #include "xwalk/extensions/renderer/xwalk_v8_utils.h"
@@ -12,16 +17,94 @@
 namespace xwalk {
 namespace extensions {
 
+namespace {
+
+const int kNoResource = -1;
+
+const char kWrapperPrefix[] =
+    "'use strict'; (function() { var exports = {}; (function(exports) {";
+const char kWrapperSuffix[] = "})(exports); return exports; })()";
+
+// The code of a resource, which stays mapped for the lifetime of the
+// process. V8 reads it there instead of in a copy of its own.
+class ResourceSource : public v8::String::ExternalAsciiStringResource {
+ public:
+  explicit ResourceSource(const base::StringPiece& data) : data_(data) {}
+
+  virtual const char* data() const OVERRIDE { return data_.data(); }
+  virtual size_t length() const OVERRIDE { return data_.size(); }
+
+ private:
+  base::StringPiece data_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceSource);
+};
+
+// The scripts compiled from resources, shared by the modules of all the
+// script contexts of the render thread.
+typedef v8::Persistent<v8::UnboundScript,
+                       v8::CopyablePersistentTraits<v8::UnboundScript> >
+    CompiledScript;
+typedef std::map<std::pair<v8::Isolate*, int>, CompiledScript>
+    CompiledResourceMap;
+base::LazyInstance<CompiledResourceMap>::Leaky g_compiled_resources =
+    LAZY_INSTANCE_INITIALIZER;
+
+bool IsASCII(const base::StringPiece& data) {
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (static_cast<unsigned char>(data[i]) >= 0x80)
+      return false;
+  }
+  return true;
+}
+
+v8::Local<v8::String> GetResourceCode(v8::Isolate* isolate,
+                                      int resource_id) {
+  base::StringPiece data =
+      ResourceBundle::GetSharedInstance().GetRawDataResource(resource_id);
+  // External strings are either Latin-1 or UTF-16, other UTF-8 sources are
+  // converted.
+  if (IsASCII(data))
+    return v8::String::NewExternal(isolate, new ResourceSource(data));
+  return v8::String::NewFromUtf8(isolate, data.data(),
+                                 v8::String::kNormalString, data.size());
+}
+
+v8::Local<v8::UnboundScript> CompileModule(v8::Isolate* isolate,
+                                           v8::Handle<v8::String> code,
+                                           std::string* error) {
+  v8::EscapableHandleScope handle_scope(isolate);
+  // The wrapped code is made of the pieces instead of a copy of them.
+  v8::Local<v8::String> wrapped_code = v8::String::Concat(
+      v8::String::Concat(v8::String::NewFromUtf8(isolate, kWrapperPrefix),
+                         code),
+      v8::String::NewFromUtf8(isolate, kWrapperSuffix));
+  v8::ScriptCompiler::Source source(wrapped_code);
+
+  blink::WebScopedMicrotaskSuppression suppression;
+  v8::TryCatch try_catch;
+  v8::Local<v8::UnboundScript> script =
+      v8::ScriptCompiler::CompileUnbound(isolate, &source);
+  if (try_catch.HasCaught()) {
+    *error = ExceptionToString(try_catch);
+    return handle_scope.Escape(v8::Local<v8::UnboundScript>());
+  }
+  return handle_scope.Escape(script);
+}
+
+}  // namespace
+
 scoped_ptr<XWalkNativeModule> CreateJSModuleFromResource(int resource_id) {
-  std::string js_api(
-      ResourceBundle::GetSharedInstance().GetRawDataResource(
-          resource_id).as_string());
-  scoped_ptr<XWalkNativeModule> module(new XWalkJSModule(js_api));
-  return module.Pass();
+  return scoped_ptr<XWalkNativeModule>(new XWalkJSModule(resource_id));
 }
 
 XWalkJSModule::XWalkJSModule(const std::string& js_code)
-    : js_code_(js_code) {
+    : resource_id_(kNoResource),
+      js_code_(js_code) {
+}
+
+XWalkJSModule::XWalkJSModule(int resource_id)
+    : resource_id_(resource_id) {
 }
 
 XWalkJSModule::~XWalkJSModule() {
@@ -32,16 +115,15 @@ v8::Handle<v8::Object> XWalkJSModule::NewInstance() {
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::EscapableHandleScope handle_scope(isolate);
 
-  if (compiled_script_.IsEmpty()) {
-    std::string compilation_error;
-    if (!Compile(isolate, &compilation_error)) {
-      LOG(WARNING) << "Error compiling JS module: " << compilation_error;
-      return handle_scope.Escape(v8::Local<v8::Object>());
-    }
+  std::string compilation_error;
+  v8::Local<v8::UnboundScript> unbound_script =
+      GetScript(isolate, &compilation_error);
+  if (unbound_script.IsEmpty()) {
+    LOG(WARNING) << "Error compiling JS module: " << compilation_error;
+    return handle_scope.Escape(v8::Local<v8::Object>());
   }
 
-  v8::Handle<v8::Script> script =
-      v8::Local<v8::Script>::New(isolate, compiled_script_);
+  v8::Local<v8::Script> script = unbound_script->BindToCurrentContext();
 
   blink::WebScopedMicrotaskSuppression suppression;
   v8::TryCatch try_catch;
@@ -55,24 +137,30 @@ v8::Handle<v8::Object> XWalkJSModule::NewInstance() {
   return handle_scope.Escape(result.As<v8::Object>());
 }
 
-bool XWalkJSModule::Compile(v8::Isolate* isolate, std::string* error) {
-  std::string wrapped_js_code =
-      "'use strict'; (function() { var exports = {}; (function(exports) {"
-      + js_code_ + "})(exports); return exports; })()";
-
-  v8::Handle<v8::String> v8_code(
-      v8::String::NewFromUtf8(isolate, wrapped_js_code.c_str()));
-
-  blink::WebScopedMicrotaskSuppression suppression;
-  v8::TryCatch try_catch;
-  v8::Handle<v8::Script> script(v8::Script::Compile(v8_code));
-  if (try_catch.HasCaught()) {
-    *error = "Error compiling JS module: " + ExceptionToString(try_catch);
-    return false;
+v8::Local<v8::UnboundScript> XWalkJSModule::GetScript(v8::Isolate* isolate,
+                                                      std::string* error) {
+  if (resource_id_ == kNoResource) {
+    if (compiled_script_.IsEmpty()) {
+      v8::Local<v8::UnboundScript> script = CompileModule(
+          isolate, v8::String::NewFromUtf8(isolate, js_code_.c_str()), error);
+      if (script.IsEmpty())
+        return script;
+      compiled_script_.Reset(isolate, script);
+    }
+    return v8::Local<v8::UnboundScript>::New(isolate, compiled_script_);
   }
 
-  compiled_script_.Reset(v8::Isolate::GetCurrent(), script);
-  return true;
+  CompiledResourceMap& compiled_resources = g_compiled_resources.Get();
+  const CompiledResourceMap::key_type key(isolate, resource_id_);
+  CompiledResourceMap::const_iterator it = compiled_resources.find(key);
+  if (it != compiled_resources.end())
+    return v8::Local<v8::UnboundScript>::New(isolate, it->second);
+
+  v8::Local<v8::UnboundScript> script =
+      CompileModule(isolate, GetResourceCode(isolate, resource_id_), error);
+  if (!script.IsEmpty())
+    compiled_resources[key].Reset(isolate, script);
+  return script;
 }
 
 }  // namespace extensions
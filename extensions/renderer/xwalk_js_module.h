@@ -21,16 +21,24 @@ scoped_ptr<XWalkNativeModule> CreateJSModuleFromResource(int resource_id);
 class XWalkJSModule : public XWalkNativeModule {
  public:
   explicit XWalkJSModule(const std::string& js_code);
+  // The code of |resource_id| isn't copied out of the resource bundle, and
+  // it is compiled once per isolate for all the modules created from it, so
+  // each new script context only runs it.
+  explicit XWalkJSModule(int resource_id);
   virtual ~XWalkJSModule();
 
  private:
   // XWalkNativeModule implementation.
   virtual v8::Handle<v8::Object> NewInstance() OVERRIDE;
 
-  bool Compile(v8::Isolate* isolate, std::string* error);
+  // Returns an empty handle if the code doesn't compile.
+  v8::Local<v8::UnboundScript> GetScript(v8::Isolate* isolate,
+                                         std::string* error);
 
+  int resource_id_;
+  // Only used when the module isn't made from a resource.
   std::string js_code_;
-  v8::Persistent<v8::Script> compiled_script_;
+  v8::Persistent<v8::UnboundScript> compiled_script_;
 };
 
 }  // namespace extensions
@@ -67,7 +67,8 @@ void RequireNativeCallback(const v8::FunctionCallbackInfo<v8::Value>& info) {
 
 }  // namespace
 
-XWalkModuleSystem::XWalkModuleSystem(v8::Handle<v8::Context> context) {
+XWalkModuleSystem::XWalkModuleSystem(v8::Handle<v8::Context> context)
+    : extension_modules_sorted_(true) {
   v8::Isolate* isolate = context->GetIsolate();
   v8_context_.Reset(isolate, context);
 
@@ -99,6 +100,7 @@ XWalkModuleSystem::~XWalkModuleSystem() {
   //     v8::Handle<v8::Object>::New(isolate, function_data_);
   // function_data->Delete(v8::String::New(kXWalkModuleSystem));
 
+  require_native_.Reset();
   require_native_template_.Reset();
   function_data_.Reset();
   v8_context_.Reset();
@@ -128,9 +130,9 @@ void XWalkModuleSystem::ResetModuleSystemFromContext(
 }
 
 void XWalkModuleSystem::RegisterExtensionModule(
-    scoped_ptr<XWalkExtensionModule> module,
-    const std::vector<std::string>& entry_points) {
-  const std::string& extension_name = module->extension_name();
+    scoped_ptr<XWalkExtensionModule> module) {
+  const std::string extension_name = module->extension_name();
+  const std::vector<std::string>& entry_points = module->entry_points();
   if (ContainsEntryPoint(extension_name)) {
     LOG(WARNING) << "Can't register Extension Module named for extension '"
                  << extension_name << "' in the Module System because name was "
@@ -149,8 +151,12 @@ void XWalkModuleSystem::RegisterExtensionModule(
     }
   }
 
+  if (!extension_modules_.empty() &&
+      extension_name < extension_modules_.back().name)
+    extension_modules_sorted_ = false;
+
   extension_modules_.push_back(
-      ExtensionModuleEntry(extension_name, module.release(), entry_points));
+      ExtensionModuleEntry(extension_name, module.release()));
 }
 
 void XWalkModuleSystem::RegisterNativeModule(
@@ -161,33 +167,46 @@ void XWalkModuleSystem::RegisterNativeModule(
 
 namespace {
 
+// Returns the object at |path|, creating the namespaces missing on the way.
+// Every namespace resolved is added to |namespaces|.
 v8::Handle<v8::Value> EnsureTargetObjectForTrampoline(
-    v8::Handle<v8::Context> context, const std::vector<std::string>& path,
+    v8::Handle<v8::Context> context, const std::string& path,
+    std::map<std::string, v8::Handle<v8::Object> >* namespaces,
     std::string* error) {
-  v8::Handle<v8::Object> object = context->Global();
-  v8::Isolate* isolate = context->GetIsolate();
-
-  std::vector<std::string>::const_iterator it = path.begin();
-  for (; it != path.end(); ++it) {
-    v8::Handle<v8::String> part =
-        v8::String::NewFromUtf8(isolate, it->c_str());
-    v8::Handle<v8::Value> value = object->Get(part);
-
-    if (value->IsUndefined()) {
-      v8::Handle<v8::Object> next_object = v8::Object::New(isolate);
-      object->Set(part, next_object);
-      object = next_object;
-      continue;
-    }
+  if (path.empty())
+    return context->Global();
+
+  std::map<std::string, v8::Handle<v8::Object> >::const_iterator it =
+      namespaces->find(path);
+  if (it != namespaces->end())
+    return it->second;
+
+  const size_t separator = path.rfind('.');
+  const std::string name =
+      separator == std::string::npos ? path : path.substr(separator + 1);
+  v8::Handle<v8::Value> parent = EnsureTargetObjectForTrampoline(
+      context,
+      separator == std::string::npos ? std::string()
+                                     : path.substr(0, separator),
+      namespaces, error);
+  if (parent->IsUndefined())
+    return parent;
 
-    if (!value->IsObject()) {
-      *error = "the property '" + *it + "' in the path is undefined";
-      return v8::Undefined(isolate);
-    }
+  v8::Isolate* isolate = context->GetIsolate();
+  v8::Handle<v8::Object> object = parent.As<v8::Object>();
+  v8::Handle<v8::String> part = v8::String::NewFromUtf8(isolate, name.c_str());
+  v8::Handle<v8::Value> value = object->Get(part);
 
-    object = value.As<v8::Object>();
+  if (value->IsUndefined()) {
+    value = v8::Object::New(isolate);
+    object->Set(part, value);
+  } else if (!value->IsObject()) {
+    *error = "the property '" + name + "' in the path is undefined";
+    return v8::Undefined(isolate);
   }
-  return object;
+
+  (*namespaces)[path] = value.As<v8::Object>();
+  return value;
 }
 
 v8::Handle<v8::Value> GetObjectForPath(v8::Handle<v8::Context> context,
@@ -218,26 +237,38 @@ v8::Handle<v8::Value> GetObjectForPath(v8::Handle<v8::Context> context,
 bool XWalkModuleSystem::SetTrampolineAccessorForEntryPoint(
     v8::Handle<v8::Context> context,
     const std::string& entry_point,
-    v8::Local<v8::External> user_data) {
-  std::vector<std::string> path;
-  base::SplitString(entry_point, '.', &path);
-  std::string basename = path.back();
-  path.pop_back();
+    v8::Local<v8::External> user_data,
+    NamespaceCache* namespaces) {
+  const size_t separator = entry_point.rfind('.');
+  const std::string holder_path = separator == std::string::npos ?
+      std::string() : entry_point.substr(0, separator);
+  const std::string basename = separator == std::string::npos ?
+      entry_point : entry_point.substr(separator + 1);
 
   std::string error;
   v8::Handle<v8::Value> value =
-      EnsureTargetObjectForTrampoline(context, path, &error);
+      EnsureTargetObjectForTrampoline(context, holder_path, namespaces, &error);
   if (value->IsUndefined()) {
     LOG(WARNING) << "Error installing trampoline for " << entry_point
                  << ": " << error << ".";
     return false;
   }
 
+  // The path of the holder is kept split in internalized strings, so
+  // RefetchHolder() can walk it without any conversion.
   v8::Isolate* isolate = context->GetIsolate();
+  std::vector<std::string> path;
+  if (!holder_path.empty())
+    base::SplitString(holder_path, '.', &path);
+  v8::Local<v8::Array> v8_path = v8::Array::New(isolate, path.size());
+  for (size_t i = 0; i < path.size(); ++i) {
+    v8_path->Set(i, v8::String::NewFromUtf8(
+        isolate, path[i].c_str(), v8::String::kInternalizedString));
+  }
+
   v8::Local<v8::Array> params = v8::Array::New(isolate);
-  v8::Local<v8::String> entry = v8::String::NewFromUtf8(isolate, entry_point.c_str());
   params->Set(v8::Integer::New(isolate, 0), user_data);
-  params->Set(v8::Integer::New(isolate, 1), entry);
+  params->Set(v8::Integer::New(isolate, 1), v8_path);
 
   // FIXME(cmarcelo): ensure that trampoline is readonly.
   value.As<v8::Object>()->SetAccessor(
@@ -269,20 +300,23 @@ bool XWalkModuleSystem::DeleteAccessorForEntryPoint(
 }
 
 bool XWalkModuleSystem::InstallTrampoline(v8::Handle<v8::Context> context,
-                                          ExtensionModuleEntry* entry) {
+                                          ExtensionModuleEntry* entry,
+                                          NamespaceCache* namespaces) {
   v8::Local<v8::External> entry_ptr = v8::External::New(context->GetIsolate(), entry);
   bool ret;
 
-  ret = SetTrampolineAccessorForEntryPoint(context, entry->name, entry_ptr);
+  ret = SetTrampolineAccessorForEntryPoint(context, entry->name, entry_ptr,
+                                           namespaces);
   if (!ret) {
     LOG(WARNING) << "Error installing trampoline for '"
                  << entry->name << "'.";
     return false;
   }
 
-  std::vector<std::string>::const_iterator it = entry->entry_points.begin();
-  for (; it != entry->entry_points.end(); ++it) {
-    ret = SetTrampolineAccessorForEntryPoint(context, *it, entry_ptr);
+  std::vector<std::string>::const_iterator it = entry->entry_points->begin();
+  for (; it != entry->entry_points->end(); ++it) {
+    ret = SetTrampolineAccessorForEntryPoint(context, *it, entry_ptr,
+                                             namespaces);
     if (!ret) {
       // TODO(vcgomes): Remove already added trampolines when it fails.
       LOG(WARNING) << "Error installing trampoline for '"
@@ -311,15 +345,19 @@ void XWalkModuleSystem::Initialize() {
       v8::Local<v8::FunctionTemplate>::New(isolate, require_native_template_);
   v8::Handle<v8::Function> require_native =
       require_native_template->GetFunction();
+  require_native_.Reset(isolate, require_native);
 
   MarkModulesWithTrampoline();
 
+  NamespaceCache namespaces;
   ExtensionModules::iterator it = extension_modules_.begin();
   for (; it != extension_modules_.end(); ++it) {
-    if (it->use_trampoline && InstallTrampoline(context, &*it))
+    if (it->use_trampoline && InstallTrampoline(context, &*it, &namespaces))
       continue;
     it->module->LoadExtensionCode(context, require_native);
     EnsureExtensionNamespaceIsReadOnly(context, it->name);
+    // The extension code may have replaced namespace objects.
+    namespaces.clear();
   }
 }
 
@@ -334,9 +372,9 @@ bool XWalkModuleSystem::ContainsEntryPoint(
     if (it->name == entry)
       return true;
 
-    std::vector<std::string>::iterator entry_it = std::find(
-        it->entry_points.begin(), it->entry_points.end(), entry);
-    if (entry_it != it->entry_points.end()) {
+    std::vector<std::string>::const_iterator entry_it = std::find(
+        it->entry_points->begin(), it->entry_points->end(), entry);
+    if (entry_it != it->entry_points->end()) {
       return true;
     }
   }
@@ -367,20 +405,16 @@ void XWalkModuleSystem::LoadExtensionForTrampoline(
 
   DeleteAccessorForEntryPoint(context, entry->name);
 
-  std::vector<std::string>::const_iterator it = entry->entry_points.begin();
-  for (; it != entry->entry_points.end(); ++it) {
+  std::vector<std::string>::const_iterator it = entry->entry_points->begin();
+  for (; it != entry->entry_points->end(); ++it) {
     DeleteAccessorForEntryPoint(context, *it);
   }
 
   XWalkModuleSystem* module_system = GetModuleSystemFromContext(context);
-  v8::Handle<v8::FunctionTemplate> require_native_template =
-        v8::Local<v8::FunctionTemplate>::New(
-            isolate,
-            module_system->require_native_template_);
-
   XWalkExtensionModule* module = entry->module;
   module->LoadExtensionCode(module_system->GetV8Context(),
-                            require_native_template->GetFunction());
+                            v8::Local<v8::Function>::New(
+                                isolate, module_system->require_native_));
 
   module_system->EnsureExtensionNamespaceIsReadOnly(context, entry->name);
 }
@@ -390,15 +424,17 @@ v8::Handle<v8::Value> XWalkModuleSystem::RefetchHolder(
     v8::Isolate* isolate,
     v8::Local<v8::Value> data) {
   v8::Local<v8::Array> params = data.As<v8::Array>();
-  const std::string entry_point = *v8::String::Utf8Value(
-      params->Get(v8::Integer::New(isolate, 1)).As<v8::String>());
+  v8::Local<v8::Array> path =
+      params->Get(v8::Integer::New(isolate, 1)).As<v8::Array>();
 
-  std::vector<std::string> path;
-  base::SplitString(entry_point, '.', &path);
-  path.pop_back();
-
-  std::string error;
-  return GetObjectForPath(isolate->GetCurrentContext(), path, &error);
+  v8::Handle<v8::Object> object = isolate->GetCurrentContext()->Global();
+  for (uint32_t i = 0; i < path->Length(); ++i) {
+    v8::Handle<v8::Value> value = object->Get(path->Get(i));
+    if (!value->IsObject())
+      return v8::Undefined(isolate);
+    object = value.As<v8::Object>();
+  }
+  return object;
 }
 
 // static
@@ -428,10 +464,9 @@ void XWalkModuleSystem::TrampolineSetterCallback(
 
 XWalkModuleSystem::ExtensionModuleEntry::ExtensionModuleEntry(
   const std::string& name,
-  XWalkExtensionModule* module,
-  const std::vector<std::string>& entry_points) :
+  XWalkExtensionModule* module) :
     name(name), module(module), use_trampoline(true),
-    entry_points(entry_points) {
+    entry_points(&module->entry_points()) {
 }
 
 XWalkModuleSystem::ExtensionModuleEntry::~ExtensionModuleEntry() {
@@ -457,7 +492,10 @@ bool XWalkModuleSystem::ExtensionModuleEntry::IsPrefix(
 // the first one won't be marked with trampoline, but the second one
 // will. So we'll only load code for "tizen" extension.
 void XWalkModuleSystem::MarkModulesWithTrampoline() {
-  std::sort(extension_modules_.begin(), extension_modules_.end());
+  if (!extension_modules_sorted_) {
+    std::sort(extension_modules_.begin(), extension_modules_.end());
+    extension_modules_sorted_ = true;
+  }
 
   ExtensionModules::iterator it = extension_modules_.begin();
   while (it != extension_modules_.end()) {
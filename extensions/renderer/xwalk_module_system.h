@@ -46,8 +46,9 @@ class XWalkModuleSystem {
       v8::Handle<v8::Context> context);
   static void ResetModuleSystemFromContext(v8::Handle<v8::Context> context);
 
-  void RegisterExtensionModule(scoped_ptr<XWalkExtensionModule> module,
-                               const std::vector<std::string>& entry_points);
+  // Modules registered in name order don't need to be sorted again when the
+  // module system is initialized.
+  void RegisterExtensionModule(scoped_ptr<XWalkExtensionModule> module);
 
   void RegisterNativeModule(const std::string& name,
                             scoped_ptr<XWalkNativeModule> module);
@@ -59,13 +60,13 @@ class XWalkModuleSystem {
 
  private:
   struct ExtensionModuleEntry {
-    ExtensionModuleEntry(const std::string& name, XWalkExtensionModule* module,
-                         const std::vector<std::string>& entry_points);
+    ExtensionModuleEntry(const std::string& name, XWalkExtensionModule* module);
     ~ExtensionModuleEntry();
     std::string name;
     XWalkExtensionModule* module;
     bool use_trampoline;
-    std::vector<std::string> entry_points;
+    // Owned by the extension code points the module refers to.
+    const std::vector<std::string>* entry_points;
     bool operator<(const ExtensionModuleEntry& other) const {
       return name < other.name;
     }
@@ -74,16 +75,22 @@ class XWalkModuleSystem {
                          const ExtensionModuleEntry& second);
   };
 
+  // Namespace objects resolved while installing trampolines, keyed by their
+  // path, e.g. "tizen.time". Entry points sharing namespaces walk them once.
+  typedef std::map<std::string, v8::Handle<v8::Object> > NamespaceCache;
+
   bool SetTrampolineAccessorForEntryPoint(
       v8::Handle<v8::Context> context,
       const std::string& entry_point,
-      v8::Local<v8::External> user_data);
+      v8::Local<v8::External> user_data,
+      NamespaceCache* namespaces);
 
   static bool DeleteAccessorForEntryPoint(v8::Handle<v8::Context> context,
                                           const std::string& entry_point);
 
   bool InstallTrampoline(v8::Handle<v8::Context> context,
-                         ExtensionModuleEntry* entry);
+                         ExtensionModuleEntry* entry,
+                         NamespaceCache* namespaces);
 
   static void TrampolineCallback(
       v8::Local<v8::String> property,
@@ -108,11 +115,14 @@ class XWalkModuleSystem {
 
   typedef std::vector<ExtensionModuleEntry> ExtensionModules;
   ExtensionModules extension_modules_;
+  bool extension_modules_sorted_;
 
   typedef std::map<std::string, XWalkNativeModule*> NativeModuleMap;
   NativeModuleMap native_modules_;
 
   v8::Persistent<v8::FunctionTemplate> require_native_template_;
+  // Instantiated once by Initialize(), shared by all extension modules.
+  v8::Persistent<v8::Function> require_native_;
 
   v8::Persistent<v8::Object> function_data_;
 
@@ -4,7 +4,12 @@
 
 #include "xwalk/extensions/renderer/xwalk_v8tools_module.h"
 
+#include <vector>
+
+#include "base/bind.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "content/public/renderer/render_view.h"
 #include "ipc/ipc_message.h"
 #include "third_party/WebKit/public/web/WebFrame.h"
@@ -33,6 +38,40 @@ void ForceSetPropertyCallback(const v8::FunctionCallbackInfo<v8::Value>& info) {
   info[0].As<v8::Object>()->ForceSet(info[1], info[2]);
 }
 
+// Destructors of the LifecycleTrackers collected by the GC. Rather than from
+// the weak callbacks themselves, which would need a context of their own to
+// enter, they are run in a single task once the GC is done.
+typedef std::vector<v8::Persistent<v8::Function>*> DestructorQueue;
+base::LazyInstance<DestructorQueue>::Leaky g_pending_destructors =
+    LAZY_INSTANCE_INITIALIZER;
+
+void RunPendingDestructors() {
+  DestructorQueue destructors;
+  destructors.swap(g_pending_destructors.Get());
+
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+  blink::WebScopedMicrotaskSuppression suppression;
+
+  for (DestructorQueue::iterator it = destructors.begin();
+       it != destructors.end(); ++it) {
+    v8::Local<v8::Function> function =
+        v8::Local<v8::Function>::New(isolate, **it);
+    (*it)->Reset();
+    delete *it;
+
+    // The context of the module system that created the destructor.
+    v8::Local<v8::Context> context = function->CreationContext();
+    v8::Context::Scope context_scope(context);
+
+    v8::TryCatch try_catch;
+    function->Call(context->Global(), 0, NULL);
+    if (try_catch.HasCaught())
+      LOG(WARNING) << "Exception when running LifecycleTracker destructor: "
+          << ExceptionToString(try_catch);
+  }
+}
+
 void LifecycleTrackerCleanup(
     const v8::WeakCallbackData<v8::Object, v8::Persistent<v8::Object> >& data) {
   v8::Isolate* isolate = data.GetIsolate();
@@ -42,24 +81,21 @@ void LifecycleTrackerCleanup(
   v8::Handle<v8::Value> function =
       tracker->Get(v8::String::NewFromUtf8(isolate, "destructor"));
 
+  data.GetParameter()->Reset();
+  delete data.GetParameter();
+
   if (function.IsEmpty() || !function->IsFunction()) {
     DLOG(WARNING) << "Destructor function not set for LifecycleTracker.";
-    data.GetParameter()->Reset();
-    delete data.GetParameter();
     return;
   }
 
-  v8::Handle<v8::Context> context = v8::Context::New(isolate);
-  blink::WebScopedMicrotaskSuppression suppression;
-
-  v8::TryCatch try_catch;
-  v8::Handle<v8::Function>::Cast(function)->Call(context->Global(), 0, NULL);
-  if (try_catch.HasCaught())
-    LOG(WARNING) << "Exception when running LifecycleTracker destructor: "
-        << ExceptionToString(try_catch);
-
-  data.GetParameter()->Reset();
-  delete data.GetParameter();
+  DestructorQueue& queue = g_pending_destructors.Get();
+  if (queue.empty()) {
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(&RunPendingDestructors));
+  }
+  queue.push_back(new v8::Persistent<v8::Function>(
+      isolate, v8::Handle<v8::Function>::Cast(function)));
 }
 
 void LifecycleTracker(const v8::FunctionCallbackInfo<v8::Value>& info) {
@@ -36,11 +36,11 @@ static void instance_destroyed(XW_Instance instance) {
 
 static void handle_message(XW_Instance instance, const char* message) {
   int size = atoi(message);
-  char* data = malloc(size + 1);
+  char* data = malloc(size);
   memset(data, 'p', size);
-  data[size] = '\0';
   printf("Instance %d created %d bytes of data chunk from native.\n", instance, size);
-  g_messaging->PostMessage(instance, data);
+  // Delivered as an ArrayBuffer, no string conversion involved.
+  g_messaging->PostBinaryMessage(instance, data, size);
   free(data);
 }
 
@@ -5,12 +5,14 @@
 #include "base/command_line.h"
 #include "base/native_library.h"
 #include "base/path_service.h"
+#include "base/strings/string_number_conversions.h"
 #include "xwalk/extensions/browser/xwalk_extension_service.h"
 #include "xwalk/extensions/common/xwalk_extension_switches.h"
 #include "xwalk/extensions/test/xwalk_extensions_test_base.h"
 #include "xwalk/runtime/browser/runtime.h"
 #include "xwalk/test/base/xwalk_test_utils.h"
 #include "content/public/test/browser_test_utils.h"
+#include "content/public/test/test_utils.h"
 
 using xwalk::extensions::XWalkExtensionService;
 
@@ -21,6 +23,24 @@ class CrashExtensionTest : public XWalkExtensionsTestBase {
         GetExternalExtensionTestPath(FILE_PATH_LITERAL("crash_extension")));
     XWalkExtensionsTestBase::SetUp();
   }
+
+  bool IsExtensionProcessDisabled() const {
+    CommandLine* cmd_line = CommandLine::ForCurrentProcess();
+    if (!cmd_line->HasSwitch(switches::kXWalkDisableExtensionProcess))
+      return false;
+    LOG(INFO) << "--disable-extension-process not supported by "
+                 "Extension Process restart tests. Skipping test.";
+    return true;
+  }
+
+  GURL GetCrashRestartURL(int crash_count) {
+    GURL url = GetExtensionsTestURL(
+        base::FilePath(), base::FilePath().AppendASCII("crash_restart.html"));
+    GURL::Replacements replacements;
+    const std::string ref = base::IntToString(crash_count);
+    replacements.SetRefStr(ref);
+    return url.ReplaceComponents(replacements);
+  }
 };
 
 IN_PROC_BROWSER_TEST_F(CrashExtensionTest, CrashExtensionProcessKeepBPAlive) {
@@ -40,3 +60,42 @@ IN_PROC_BROWSER_TEST_F(CrashExtensionTest, CrashExtensionProcessKeepBPAlive) {
 
   EXPECT_EQ(kPassString, title_watcher.WaitAndGetTitle());
 }
+
+// In shared process mode the Extension Process is provided by the launcher and
+// isn't restarted.
+#if !defined(SHARED_PROCESS_MODE)
+IN_PROC_BROWSER_TEST_F(CrashExtensionTest, RestartCrashedExtensionProcess) {
+  if (IsExtensionProcessDisabled())
+    return;
+
+  content::TitleWatcher title_watcher(runtime()->web_contents(), kPassString);
+  title_watcher.AlsoWaitForTitle(kFailString);
+  xwalk_test_utils::NavigateToURL(runtime(), GetCrashRestartURL(1));
+  EXPECT_EQ(kPassString, title_watcher.WaitAndGetTitle());
+}
+
+// The page checks that each restart in a row waits twice as long.
+IN_PROC_BROWSER_TEST_F(CrashExtensionTest, RestartBackoff) {
+  if (IsExtensionProcessDisabled())
+    return;
+
+  content::TitleWatcher title_watcher(runtime()->web_contents(), kPassString);
+  title_watcher.AlsoWaitForTitle(kFailString);
+  xwalk_test_utils::NavigateToURL(runtime(), GetCrashRestartURL(5));
+  EXPECT_EQ(kPassString, title_watcher.WaitAndGetTitle());
+}
+
+// Past five crashes in a row the render process is shut down instead.
+IN_PROC_BROWSER_TEST_F(CrashExtensionTest, RestartCutoff) {
+  if (IsExtensionProcessDisabled())
+    return;
+
+  xwalk_test_utils::NavigateToURL(runtime(), GetCrashRestartURL(6));
+  // The restarts take seconds, the page is loaded well before the last crash.
+  content::RenderProcessHostWatcher process_watcher(
+      runtime()->web_contents(),
+      content::RenderProcessHostWatcher::WATCH_FOR_PROCESS_EXIT);
+  process_watcher.Wait();
+  EXPECT_NE(kPassString, runtime()->web_contents()->GetTitle());
+}
+#endif
@@ -28,6 +28,11 @@ void handle_message(XW_Instance instance, const char* message) {
   g_messaging->PostMessage(instance, message);
 }
 
+void handle_binary_message(XW_Instance instance, const void* data,
+                           size_t size) {
+  g_messaging->PostBinaryMessage(instance, data, size);
+}
+
 void handle_sync_message(XW_Instance instance, const char* message) {
   g_sync_messaging->SetSyncReply(instance, message);
 }
@@ -62,6 +67,7 @@ int32_t XW_Initialize(XW_Extension extension, XW_GetInterface get_interface) {
 
   g_messaging = get_interface(XW_MESSAGING_INTERFACE);
   g_messaging->Register(extension, handle_message);
+  g_messaging->RegisterBinaryMessageCallback(extension, handle_binary_message);
 
   g_sync_messaging = get_interface(XW_INTERNAL_SYNC_MESSAGING_INTERFACE);
   g_sync_messaging->Register(extension, handle_sync_message);
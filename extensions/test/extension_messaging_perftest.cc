@@ -0,0 +1,183 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/format_macros.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "content/public/test/browser_test_utils.h"
+#include "content/public/test/test_utils.h"
+#include "testing/perf/perf_test.h"
+#include "xwalk/extensions/browser/xwalk_extension_service.h"
+#include "xwalk/extensions/common/xwalk_extension.h"
+#include "xwalk/extensions/test/xwalk_extensions_test_base.h"
+#include "xwalk/runtime/browser/runtime.h"
+#include "xwalk/test/base/xwalk_test_utils.h"
+
+using namespace xwalk::extensions;  // NOLINT
+
+namespace {
+
+const char kUIThreadEchoName[] = "bench_ui_thread";
+const char kExtensionThreadEchoName[] = "bench_extension_thread";
+// The external extension of extensions/test/echo_extension.c, running in
+// the Extension Process.
+const char kExternalEchoName[] = "echo";
+
+// Messages bigger than this, IPC header included, are moved out of the IPC
+// channel. See XWalkExtensionServer::kInlineMessageMaxSize.
+const size_t kInlineMessageMaxSize = 256 * 1024;
+
+const size_t kMinMessageSize = 16;
+const size_t kMaxMessageSize = 64 * 1024 * 1024;
+
+// Bytes echoed for each message size, so that small messages get enough
+// round trips to be measured and big ones don't take forever.
+const size_t kBytesPerMessageSize = 16 * 1024 * 1024;
+const int kMinIterations = 2;
+const int kMaxIterations = 500;
+
+// Same JavaScript API as echo_extension.c.
+class EchoInstance : public XWalkExtensionInstance {
+ public:
+  virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE {
+    PostMessageToJS(msg.Pass());
+  }
+
+  virtual void HandleSyncMessage(scoped_ptr<base::Value> msg) OVERRIDE {
+    SendSyncReplyToJS(msg.Pass());
+  }
+};
+
+class EchoExtension : public XWalkExtension {
+ public:
+  explicit EchoExtension(const char* name) {
+    set_name(name);
+    set_javascript_api(
+        "var echoListener = null;"
+        "extension.setMessageListener(function(msg) {"
+        "  if (echoListener instanceof Function) {"
+        "    echoListener(msg);"
+        "  };"
+        "});"
+        "exports.echo = function(msg, callback) {"
+        "  echoListener = callback;"
+        "  extension.postMessage(msg);"
+        "};"
+        "exports.syncEcho = function(msg) {"
+        "  return extension.internal.sendSyncMessage(msg);"
+        "};");
+  }
+
+  virtual XWalkExtensionInstance* CreateInstance() OVERRIDE {
+    return new EchoInstance;
+  }
+};
+
+// "16B", "4KB", "64MB"...
+std::string GetSizeLabel(size_t size) {
+  if (size >= 1024 * 1024)
+    return base::StringPrintf("%" PRIuS "MB", size / (1024 * 1024));
+  if (size >= 1024)
+    return base::StringPrintf("%" PRIuS "KB", size / 1024);
+  return base::StringPrintf("%" PRIuS "B", size);
+}
+
+}  // namespace
+
+// Measures the round trip latency and the throughput of extension messages
+// echoed by extensions on the UI thread, on the extension thread and in the
+// Extension Process. The results are printed in the format of the perf
+// dashboard, e.g.
+// RESULT round_trip_latency_ui_thread_async: 4KB_inline= 0.21 ms
+class ExtensionMessagingPerfTest : public XWalkExtensionsTestBase {
+ public:
+  virtual void SetUp() OVERRIDE {
+    XWalkExtensionService::SetExternalExtensionsPathForTesting(
+        GetExternalExtensionTestPath(FILE_PATH_LITERAL("echo_extension")));
+    XWalkExtensionsTestBase::SetUp();
+  }
+
+  virtual void CreateExtensionsForUIThread(
+      XWalkExtensionVector* extensions) OVERRIDE {
+    extensions->push_back(new EchoExtension(kUIThreadEchoName));
+  }
+
+  virtual void CreateExtensionsForExtensionThread(
+      XWalkExtensionVector* extensions) OVERRIDE {
+    extensions->push_back(new EchoExtension(kExtensionThreadEchoName));
+  }
+
+ protected:
+  void LoadBenchmarkPage() {
+    content::RunAllPendingInMessageLoop();
+    GURL url = GetExtensionsTestURL(base::FilePath(),
+        base::FilePath().AppendASCII("messaging_benchmark.html"));
+    content::TitleWatcher title_watcher(runtime()->web_contents(),
+                                        kPassString);
+    title_watcher.AlsoWaitForTitle(kFailString);
+    xwalk_test_utils::NavigateToURL(runtime(), url);
+    ASSERT_EQ(kPassString, title_watcher.WaitAndGetTitle());
+  }
+
+  // |mode| is one of "async", "sync" or "binary", see
+  // messaging_benchmark.html. |trace| names the extension in the results.
+  void RunBenchmark(const std::string& extension_name,
+                    const std::string& mode,
+                    const std::string& trace) {
+    for (size_t size = kMinMessageSize; size <= kMaxMessageSize; size *= 4) {
+      const int iterations = std::max(kMinIterations, std::min(kMaxIterations,
+          static_cast<int>(kBytesPerMessageSize / size)));
+
+      std::string result;
+      ASSERT_TRUE(content::ExecuteScriptAndExtractString(
+          runtime()->web_contents(),
+          base::StringPrintf("runBenchmark('%s', '%s', %" PRIuS ", %d);",
+                             extension_name.c_str(), mode.c_str(), size,
+                             iterations),
+          &result));
+
+      std::vector<std::string> values;
+      base::SplitString(result, ' ', &values);
+      double latency_ms;
+      double throughput;
+      ASSERT_EQ(2u, values.size()) << result;
+      ASSERT_TRUE(base::StringToDouble(values[0], &latency_ms));
+      ASSERT_TRUE(base::StringToDouble(values[1], &throughput));
+
+      const std::string size_trace = GetSizeLabel(size) +
+          (size < kInlineMessageMaxSize ? "_inline" : "_shm");
+      const std::string modifier = "_" + trace + "_" + mode;
+      perf_test::PrintResult("round_trip_latency", modifier, size_trace,
+                             latency_ms, "ms", true);
+      perf_test::PrintResult("throughput", modifier, size_trace,
+                             throughput, "MB/s", false);
+    }
+  }
+};
+
+IN_PROC_BROWSER_TEST_F(ExtensionMessagingPerfTest, UIThread) {
+  LoadBenchmarkPage();
+  RunBenchmark(kUIThreadEchoName, "async", "ui_thread");
+  RunBenchmark(kUIThreadEchoName, "sync", "ui_thread");
+  RunBenchmark(kUIThreadEchoName, "binary", "ui_thread");
+}
+
+IN_PROC_BROWSER_TEST_F(ExtensionMessagingPerfTest, ExtensionThread) {
+  LoadBenchmarkPage();
+  RunBenchmark(kExtensionThreadEchoName, "async", "extension_thread");
+  RunBenchmark(kExtensionThreadEchoName, "sync", "extension_thread");
+  RunBenchmark(kExtensionThreadEchoName, "binary", "extension_thread");
+}
+
+IN_PROC_BROWSER_TEST_F(ExtensionMessagingPerfTest, ExtensionProcess) {
+  LoadBenchmarkPage();
+  RunBenchmark(kExternalEchoName, "async", "extension_process");
+  RunBenchmark(kExternalEchoName, "sync", "extension_process");
+  RunBenchmark(kExternalEchoName, "binary", "extension_process");
+}
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/threading/platform_thread.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/test/browser_test_utils.h"
 #include "content/public/test/test_utils.h"
@@ -14,6 +15,9 @@ using namespace xwalk::extensions;  // NOLINT
 
 const char kInProcessExtensionThread[] = "in_process_extension_thread";
 const char kInProcessUIThread[] = "in_process_ui_thread";
+const char kDedicatedThread[] = "dedicated_thread";
+const char kSequencedPool[] = "sequenced_pool";
+const char kIOThread[] = "io_thread";
 
 class InProcessExtension;
 
@@ -88,3 +92,61 @@ IN_PROC_BROWSER_TEST_F(InProcessThreadsTest, InProcessThreads) {
 
   EXPECT_EQ(kPassString, title_watcher.WaitAndGetTitle());
 }
+
+class ThreadNameInstance : public XWalkExtensionInstance {
+ public:
+  virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE {
+    PostMessageToJS(scoped_ptr<base::Value>(
+        new base::StringValue(base::PlatformThread::GetName())));
+  }
+};
+
+// Replies to any message with the name of the thread handling it.
+class ThreadNameExtension : public XWalkExtension {
+ public:
+  ThreadNameExtension(const char* name, ExecutionModel model) {
+    set_name(name);
+    set_execution_model(model);
+    set_javascript_api(
+        "var listener = null;"
+        "extension.setMessageListener(function(msg) {"
+        "  listener(msg);"
+        "});"
+        "exports.getThreadName = function(callback) {"
+        "  listener = callback;"
+        "  extension.postMessage('');"
+        "};");
+  }
+
+  virtual XWalkExtensionInstance* CreateInstance() OVERRIDE {
+    return new ThreadNameInstance();
+  }
+};
+
+class InProcessExecutionModelTest : public XWalkExtensionsTestBase {
+ public:
+  virtual void CreateExtensionsForExtensionThread(
+      XWalkExtensionVector* extensions) OVERRIDE {
+    extensions->push_back(new ThreadNameExtension(
+        kInProcessExtensionThread, XWalkExtension::EXECUTION_SHARED_THREAD));
+    extensions->push_back(new ThreadNameExtension(
+        kDedicatedThread, XWalkExtension::EXECUTION_DEDICATED_THREAD));
+    extensions->push_back(new ThreadNameExtension(
+        kSequencedPool, XWalkExtension::EXECUTION_SEQUENCED_POOL));
+    extensions->push_back(new ThreadNameExtension(
+        kIOThread, XWalkExtension::EXECUTION_IO_THREAD));
+  }
+};
+
+IN_PROC_BROWSER_TEST_F(InProcessExecutionModelTest, ExecutionModels) {
+  content::RunAllPendingInMessageLoop();
+
+  content::TitleWatcher title_watcher(runtime()->web_contents(), kPassString);
+  title_watcher.AlsoWaitForTitle(kFailString);
+
+  GURL url = GetExtensionsTestURL(base::FilePath(),
+      base::FilePath().AppendASCII("execution_models.html"));
+  xwalk_test_utils::NavigateToURL(runtime(), url);
+
+  EXPECT_EQ(kPassString, title_watcher.WaitAndGetTitle());
+}
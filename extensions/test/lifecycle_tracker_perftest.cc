@@ -0,0 +1,73 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "content/public/test/browser_test_utils.h"
+#include "content/public/test/test_utils.h"
+#include "testing/perf/perf_test.h"
+#include "xwalk/extensions/common/xwalk_extension.h"
+#include "xwalk/extensions/test/xwalk_extensions_test_base.h"
+#include "xwalk/runtime/browser/runtime.h"
+#include "xwalk/test/base/xwalk_test_utils.h"
+
+using namespace xwalk::extensions;  // NOLINT
+
+namespace {
+
+class LifecycleTrackerInstance : public XWalkExtensionInstance {
+ public:
+  virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE {}
+};
+
+// Same JavaScript API as the test_v8tools extension of v8tools_module.cc.
+class LifecycleTrackerExtension : public XWalkExtension {
+ public:
+  LifecycleTrackerExtension() {
+    set_name("test_v8tools");
+    set_javascript_api(
+        "var v8tools = requireNative('v8tools');"
+        "exports.lifecycleTracker = function() {"
+        "  return v8tools.lifecycleTracker();"
+        "};");
+  }
+
+  virtual XWalkExtensionInstance* CreateInstance() OVERRIDE {
+    return new LifecycleTrackerInstance;
+  }
+};
+
+}  // namespace
+
+class LifecycleTrackerPerfTest : public XWalkExtensionsTestBase {
+ public:
+  virtual void CreateExtensionsForUIThread(
+      XWalkExtensionVector* extensions) OVERRIDE {
+    extensions->push_back(new LifecycleTrackerExtension);
+  }
+};
+
+// How long gc() blocks the page when many trackers are collected at once,
+// the way sysapps binding objects go away.
+IN_PROC_BROWSER_TEST_F(LifecycleTrackerPerfTest, GCPause) {
+  content::RunAllPendingInMessageLoop();
+  GURL url = GetExtensionsTestURL(base::FilePath(),
+      base::FilePath().AppendASCII("test_v8tools_gc.html"));
+
+  content::TitleWatcher title_watcher(runtime()->web_contents(), kPassString);
+  title_watcher.AlsoWaitForTitle(kFailString);
+  xwalk_test_utils::NavigateToURL(runtime(), url);
+  EXPECT_EQ(kPassString, title_watcher.WaitAndGetTitle());
+
+  std::string pause;
+  ASSERT_TRUE(content::ExecuteScriptAndExtractString(
+      runtime()->web_contents(),
+      "window.domAutomationController.send(String(gcPauseMs));",
+      &pause));
+  double pause_ms;
+  ASSERT_TRUE(base::StringToDouble(pause, &pause_ms));
+  perf_test::PrintResult("lifecycle_tracker_gc_pause", "", "5000_trackers",
+                         pause_ms, "ms", true);
+}
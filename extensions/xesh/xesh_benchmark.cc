@@ -0,0 +1,128 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/extensions/xesh/xesh_benchmark.h"
+
+#include <algorithm>
+#include "base/json/json_writer.h"
+#include "base/values.h"
+
+namespace {
+
+// xesh_now(), xesh_recordLatency() and xesh_finishBenchmark() are the
+// natives of XEShV8Runner.
+const char kPrelude[] =
+    "(function(global) {"
+    "  var pending = 0;"
+    "  var scriptDone = false;"
+    "  function maybeFinish() {"
+    "    if (scriptDone && pending == 0)"
+    "      xesh_finishBenchmark();"
+    "  }"
+    "  global.benchmark = function(name, iterations, fn, warmupIterations) {"
+    "    var warmup = warmupIterations || 0;"
+    "    for (var i = 0; i < warmup + iterations; ++i) {"
+    "      var start = xesh_now();"
+    "      fn();"
+    "      if (i >= warmup)"
+    "        xesh_recordLatency(name, xesh_now() - start);"
+    "    }"
+    "  };"
+    "  global.benchmarkAsync = function(name, iterations, fn,"
+    "                                   warmupIterations) {"
+    "    var warmup = warmupIterations || 0;"
+    "    var i = 0;"
+    "    pending++;"
+    "    function next() {"
+    "      if (i == warmup + iterations) {"
+    "        pending--;"
+    "        maybeFinish();"
+    "        return;"
+    "      }"
+    "      var start = xesh_now();"
+    "      var recorded = i++ >= warmup;"
+    "      fn(function() {"
+    "        if (recorded)"
+    "          xesh_recordLatency(name, xesh_now() - start);"
+    "        next();"
+    "      });"
+    "    }"
+    "    next();"
+    "  };"
+    "  global.xesh_scriptDone = function() {"
+    "    scriptDone = true;"
+    "    maybeFinish();"
+    "  };"
+    "})(this);";
+
+// |sorted| is not empty.
+double GetPercentile(const std::vector<double>& sorted, int percentile) {
+  size_t index = sorted.size() * percentile / 100;
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+base::ListValue* CreateHistogram(const std::vector<double>& sorted) {
+  base::ListValue* histogram = new base::ListValue;
+  size_t i = 0;
+  for (double up_to_us = 1; i < sorted.size(); up_to_us *= 2) {
+    int count = 0;
+    for (; i < sorted.size() && sorted[i] * 1000 <= up_to_us; ++i)
+      ++count;
+    base::DictionaryValue* bucket = new base::DictionaryValue;
+    bucket->SetDouble("upToUs", up_to_us);
+    bucket->SetInteger("count", count);
+    histogram->Append(bucket);
+  }
+  return histogram;
+}
+
+}  // namespace
+
+XEShBenchmark::XEShBenchmark() {
+}
+
+XEShBenchmark::~XEShBenchmark() {
+}
+
+// static
+const char* XEShBenchmark::GetPrelude() {
+  return kPrelude;
+}
+
+void XEShBenchmark::RecordLatency(const std::string& name,
+                                  double latency_ms) {
+  latencies_[name].push_back(latency_ms);
+}
+
+std::string XEShBenchmark::GetResultsAsJSON(
+    scoped_ptr<base::DictionaryValue> heap) const {
+  scoped_ptr<base::DictionaryValue> benchmarks(new base::DictionaryValue);
+  for (LatencyMap::const_iterator it = latencies_.begin();
+       it != latencies_.end(); ++it) {
+    std::vector<double> sorted(it->second);
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0;
+    for (size_t i = 0; i < sorted.size(); ++i)
+      total += sorted[i];
+
+    base::DictionaryValue* result = new base::DictionaryValue;
+    result->SetInteger("iterations", sorted.size());
+    result->SetDouble("minMs", sorted.front());
+    result->SetDouble("meanMs", total / sorted.size());
+    result->SetDouble("p50Ms", GetPercentile(sorted, 50));
+    result->SetDouble("p90Ms", GetPercentile(sorted, 90));
+    result->SetDouble("p99Ms", GetPercentile(sorted, 99));
+    result->SetDouble("maxMs", sorted.back());
+    result->Set("histogram", CreateHistogram(sorted));
+    // The names are often those of the APIs, e.g. "echo.syncEcho".
+    benchmarks->SetWithoutPathExpansion(it->first, result);
+  }
+
+  base::DictionaryValue results;
+  results.Set("benchmarks", benchmarks.release());
+  results.Set("heap", heap.release());
+  std::string json;
+  base::JSONWriter::Write(&results, &json);
+  return json;
+}
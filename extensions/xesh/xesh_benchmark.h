@@ -0,0 +1,56 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_EXTENSIONS_XESH_XESH_BENCHMARK_H_
+#define XWALK_EXTENSIONS_XESH_XESH_BENCHMARK_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+// The latencies recorded by the timing script of the benchmark mode of XESh,
+// where the script is run once and the results are printed as JSON instead
+// of starting the interactive shell. The script measures the extension APIs
+// with the functions defined by GetPrelude():
+//
+//   benchmark(name, iterations, fn[, warmupIterations])
+//     Calls fn() |iterations| times and records how long each call took.
+//   benchmarkAsync(name, iterations, fn[, warmupIterations])
+//     Same for APIs replying asynchronously: fn(done) calls done() once the
+//     reply arrived, the next iteration starts then.
+//
+// The results are printed once the script and all the asynchronous
+// benchmarks are done.
+class XEShBenchmark {
+ public:
+  XEShBenchmark();
+  ~XEShBenchmark();
+
+  // The JavaScript defining benchmark() and benchmarkAsync() on top of the
+  // native functions installed by XEShV8Runner.
+  static const char* GetPrelude();
+
+  void RecordLatency(const std::string& name, double latency_ms);
+
+  // {"benchmarks": {"<name>": {"iterations": 1000, "minMs": 0.02,
+  //   "meanMs": 0.03, "p50Ms": 0.03, "p90Ms": 0.04, "p99Ms": 0.09,
+  //   "maxMs": 0.31, "histogram": [{"upToUs": 1, "count": 0},
+  //   {"upToUs": 2, "count": 0}, ...]}, ...}, "heap": {...}}
+  // The buckets of the histograms double in size up to the slowest call.
+  std::string GetResultsAsJSON(scoped_ptr<base::DictionaryValue> heap) const;
+
+ private:
+  typedef std::map<std::string, std::vector<double> > LatencyMap;
+  LatencyMap latencies_;
+
+  DISALLOW_COPY_AND_ASSIGN(XEShBenchmark);
+};
+
+#endif  // XWALK_EXTENSIONS_XESH_XESH_BENCHMARK_H_
@@ -35,6 +35,10 @@ using xwalk::extensions::XWalkExtensionServer;
 // Specifies which file XESh will use as input.
 const char kInputFilePath[] = "input-file";
 
+// Runs the given timing script instead of the interactive shell and prints
+// its results as JSON to stdout, see XEShBenchmark.
+const char kBenchmark[] = "benchmark";
+
 namespace {
 
 inline void PrintInitialInfo() {
@@ -218,11 +222,26 @@ int main(int argc, char* argv[]) {
 
   InputWatcher input_watcher(&v8_runner, v8_thread.message_loop());
 
-  static_cast<base::MessageLoopForIO*>(io_thread.message_loop())->PostTask(
-      FROM_HERE, base::Bind(&InputWatcher::StartWatching,
-      base::Unretained(&input_watcher)));
+  CommandLine* cmd_line = CommandLine::ForCurrentProcess();
+  if (cmd_line->HasSwitch(kBenchmark)) {
+    std::string script;
+    if (!ReadFileToString(cmd_line->GetSwitchValuePath(kBenchmark),
+                          &script)) {
+      fprintf(stderr, "Couldn't read the benchmark script.\n");
+      return 1;
+    }
+    // XEShV8Runner exits once the benchmark is done.
+    v8_thread.message_loop()->PostTask(
+        FROM_HERE, base::Bind(&XEShV8Runner::RunBenchmark,
+        base::Unretained(&v8_runner), script));
+  } else {
+    static_cast<base::MessageLoopForIO*>(io_thread.message_loop())->PostTask(
+        FROM_HERE, base::Bind(&InputWatcher::StartWatching,
+        base::Unretained(&input_watcher)));
+
+    PrintPromptLine();
+  }
 
-  PrintPromptLine();
   base::RunLoop run_loop;
   run_loop.Run();
 
@@ -27,7 +27,26 @@ rm temp_test.js
 rm test_stdout
 rm test_stderr
 
-if [ "$RESULT" = "$EXPECTED" ]; then
+if [ "$RESULT" != "$EXPECTED" ]; then
+   echo -e "XESh Test: FAIL."
+   exit 1
+fi
+
+# The benchmark mode prints the results of both benchmarks as JSON.
+echo "benchmark(\"syncEcho\", 10, function() { echo.syncEcho(\"\"); });" > temp_benchmark.js
+echo "benchmarkAsync(\"echo\", 10, function(done) { echo.echo(\"\", done); });" >> temp_benchmark.js
+
+$BUILD_DIR/xesh --external-extensions-path=$BUILD_DIR/tests/extension/echo_extension --benchmark=temp_benchmark.js 1> test_stdout 2> test_stderr
+STATUS=$?
+
+RESULT=`cat test_stdout`
+
+rm temp_benchmark.js
+rm test_stdout
+rm test_stderr
+
+if [ $STATUS -eq 0 ] && [[ "$RESULT" == *'"syncEcho":{'* ]] \
+    && [[ "$RESULT" == *'"echo":{'* ]]; then
    echo -e "XESh Test: PASS."
    exit 0
 else
@@ -11,6 +11,8 @@
 #include <stdlib.h>
 #include "base/logging.h"
 #include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
 #include "xwalk/extensions/renderer/xwalk_extension_module.h"
 #include "xwalk/extensions/renderer/xwalk_module_system.h"
 #include "xwalk/extensions/renderer/xwalk_v8tools_module.h"
@@ -185,6 +187,97 @@ void XEShV8Runner::QuitCallback(v8::Local<v8::String> property,
   exit(0);
 }
 
+void XEShV8Runner::RunBenchmark(const std::string& script) {
+  RegisterBenchmarkFunctions();
+  ExecuteBenchmarkString(XEShBenchmark::GetPrelude());
+  ExecuteBenchmarkString(script);
+  // The results are printed now, unless asynchronous benchmarks are still
+  // waiting for replies from the extensions.
+  ExecuteBenchmarkString("xesh_scriptDone();");
+}
+
+void XEShV8Runner::ExecuteBenchmarkString(const std::string& statement) {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::TryCatch try_catch;
+  v8::Handle<v8::Script> script = v8::Script::Compile(
+      v8::String::NewFromUtf8(isolate, statement.c_str()),
+      v8::String::NewFromUtf8(isolate, "(xesh benchmark)"));
+  if (script.IsEmpty() || script->Run().IsEmpty()) {
+    fprintf(stderr, "%s", ReportException(&try_catch).c_str());
+    fflush(stderr);
+    exit(1);
+  }
+}
+
+void XEShV8Runner::RegisterBenchmarkFunctions() {
+  v8::Isolate* isolate = v8::Isolate::GetCurrent();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> context = GetV8Context();
+  v8::Local<v8::External> data = v8::External::New(isolate, this);
+
+  context->Global()->Set(
+      v8::String::NewFromUtf8(isolate, "xesh_now"),
+      v8::FunctionTemplate::New(isolate, NowCallback)->GetFunction());
+  context->Global()->Set(
+      v8::String::NewFromUtf8(isolate, "xesh_recordLatency"),
+      v8::FunctionTemplate::New(isolate, RecordLatencyCallback,
+                                data)->GetFunction());
+  context->Global()->Set(
+      v8::String::NewFromUtf8(isolate, "xesh_finishBenchmark"),
+      v8::FunctionTemplate::New(isolate, FinishBenchmarkCallback,
+                                data)->GetFunction());
+}
+
+scoped_ptr<base::DictionaryValue> XEShV8Runner::GetHeapStatistics() {
+  v8::HeapStatistics heap;
+  v8::Isolate::GetCurrent()->GetHeapStatistics(&heap);
+
+  scoped_ptr<base::DictionaryValue> result(new base::DictionaryValue);
+  result->SetDouble("totalHeapSize", heap.total_heap_size());
+  result->SetDouble("totalHeapSizeExecutable",
+                    heap.total_heap_size_executable());
+  result->SetDouble("totalPhysicalSize", heap.total_physical_size());
+  result->SetDouble("usedHeapSize", heap.used_heap_size());
+  result->SetDouble("heapSizeLimit", heap.heap_size_limit());
+  return result.Pass();
+}
+
+// static
+void XEShV8Runner::NowCallback(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  // In milliseconds, with the best resolution available.
+  double now = (base::TimeTicks::HighResNow() - base::TimeTicks())
+      .InMillisecondsF();
+  args.GetReturnValue().Set(now);
+}
+
+// static
+void XEShV8Runner::RecordLatencyCallback(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  XEShV8Runner* runner = static_cast<XEShV8Runner*>(
+      v8::Local<v8::External>::Cast(args.Data())->Value());
+  if (args.Length() < 2 || !args[1]->IsNumber())
+    return;
+  v8::String::Utf8Value name(args[0]);
+  runner->benchmark_.RecordLatency(ToCString(name), args[1]->NumberValue());
+}
+
+// static
+void XEShV8Runner::FinishBenchmarkCallback(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  XEShV8Runner* runner = static_cast<XEShV8Runner*>(
+      v8::Local<v8::External>::Cast(args.Data())->Value());
+  std::string results =
+      runner->benchmark_.GetResultsAsJSON(runner->GetHeapStatistics());
+  printf("%s\n", results.c_str());
+  fflush(stdout);
+  fflush(stderr);
+  exit(0);
+}
+
 void XEShV8Runner::CreateModuleSystem() {
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::HandleScope handle_scope(isolate);
@@ -210,14 +303,13 @@ void XEShV8Runner::CreateExtensionModules(XWalkModuleSystem* module_system) {
   XWalkExtensionClient::ExtensionAPIMap::const_iterator it =
       extensions.begin();
   for (; it != extensions.end(); ++it) {
-    XWalkExtensionClient::ExtensionCodePoints* codepoint = it->second;
+    XWalkExtensionClient::ExtensionCodePoints* codepoint = it->second.get();
     if (codepoint->api.empty())
       continue;
     scoped_ptr<XWalkExtensionModule> module(
         new XWalkExtensionModule(&client_, module_system, it->first,
-                                 codepoint->api));
-    module_system->RegisterExtensionModule(module.Pass(),
-                                           codepoint->entry_points);
+                                 codepoint));
+    module_system->RegisterExtensionModule(module.Pass());
   }
 }
 
@@ -15,6 +15,7 @@
 #include "base/threading/thread.h"
 #include "ipc/ipc_sync_channel.h"
 #include "xwalk/extensions/renderer/xwalk_extension_client.h"
+#include "xwalk/extensions/xesh/xesh_benchmark.h"
 
 namespace xwalk {
 namespace extensions {
@@ -43,6 +44,10 @@ class XEShV8Runner {
   // Executes a string within the current v8 context.
   std::string ExecuteString(std::string statement);
 
+  // Runs |script| in benchmark mode, see XEShBenchmark. Prints the results
+  // to stdout and exits once it is done, on error exits with status 1.
+  void RunBenchmark(const std::string& script);
+
   static const char* GetV8Version() {
     return v8::V8::GetVersion();
   }
@@ -61,11 +66,24 @@ class XEShV8Runner {
   static void QuitCallback(v8::Local<v8::String> property,
       const v8::PropertyCallbackInfo<v8::Value>& info);
 
+  void RegisterBenchmarkFunctions();
+  // Runs |statement|, on error prints the exception and exits.
+  void ExecuteBenchmarkString(const std::string& statement);
+  scoped_ptr<base::DictionaryValue> GetHeapStatistics();
+
+  static void NowCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void RecordLatencyCallback(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void FinishBenchmarkCallback(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
+
   XWalkExtensionClient client_;
   scoped_ptr<IPC::SyncChannel> client_channel_;
   base::WaitableEvent shutdown_event_;
 
   v8::Persistent<v8::Context> v8_context_;
+
+  XEShBenchmark benchmark_;
 };
 
 #endif  // XWALK_EXTENSIONS_XESH_XESH_V8_RUNNER_H_
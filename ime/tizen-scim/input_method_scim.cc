@@ -37,7 +37,7 @@ namespace ui {
 InputMethodSCIM::InputMethodSCIM(internal::InputMethodDelegate* delegate)
     : delegate_(NULL),
       text_input_client_(NULL),
-      scim_bridge_(new SCIMBridge()) {
+      scim_bridge_(new SCIMBridge(this)) {
   SetDelegate(delegate);
 }
 
@@ -169,4 +169,15 @@ ui::TextInputMode InputMethodSCIM::GetTextInputMode() const {
   return ui::TEXT_INPUT_MODE_DEFAULT;
 }
 
+void InputMethodSCIM::OnCommitText(const base::string16& text) {
+  // Replaces the composition text, if any.
+  if (text_input_client_)
+    text_input_client_->InsertText(text);
+}
+
+void InputMethodSCIM::OnHidePreedit() {
+  if (text_input_client_ && text_input_client_->HasCompositionText())
+    text_input_client_->ClearCompositionText();
+}
+
 }  // namespace ui
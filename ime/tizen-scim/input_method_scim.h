@@ -15,16 +15,17 @@
 #include "ui/base/ime/input_method.h"
 #include "ui/base/ime/input_method_observer.h"
 #include "ui/base/ui_base_export.h"
+#include "xwalk/ime/tizen-scim/scim_bridge.h"
 
 namespace ui {
 
 class InputMethodObserver;
 class KeyEvent;
 class TextInputClient;
-class SCIMBridge;
 
 // SCIM InputMethod implementation for minimum input support.
-class UI_BASE_EXPORT InputMethodSCIM : NON_EXPORTED_BASE(public InputMethod) {
+class UI_BASE_EXPORT InputMethodSCIM : NON_EXPORTED_BASE(public InputMethod),
+                                       public SCIMBridge::Delegate {
  public:
   explicit InputMethodSCIM(internal::InputMethodDelegate* delegate);
   virtual ~InputMethodSCIM();
@@ -59,6 +60,10 @@ class UI_BASE_EXPORT InputMethodSCIM : NON_EXPORTED_BASE(public InputMethod) {
 
 
  private:
+  // SCIMBridge::Delegate implementation.
+  virtual void OnCommitText(const base::string16& text) OVERRIDE;
+  virtual void OnHidePreedit() OVERRIDE;
+
   internal::InputMethodDelegate* delegate_;
   TextInputClient* text_input_client_;
   ObserverList<InputMethodObserver> observers_;
@@ -7,6 +7,9 @@
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_pump_libevent.h"
+#include "base/metrics/histogram.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "content/public/browser/browser_thread.h"
 #include "ui/base/x/x11_util.h"
 #include "ui/gfx/x/x11_types.h"
@@ -56,7 +59,7 @@ class SCIMBridgeImpl : base::MessageLoopForIO::Watcher {
 
 public:
 
-  SCIMBridgeImpl();
+  explicit SCIMBridgeImpl(SCIMBridge::Delegate* delegate);
   ~SCIMBridgeImpl();
 
   void Init();
@@ -86,6 +89,14 @@ private:
   void OnProcessKeyEvent(int context, const KeyEvent &key);
   void OnCommitString(int context, const WideString &wstr);
 
+  // The commits and preedit changes of one SCIM event are delivered to the
+  // delegate together, in a single task. A key event in between flushes
+  // them, so they keep their order with the keys.
+  void FlushPendingInput();
+  void DeliverInput(const base::string16& commit_text,
+                    bool hide_preedit,
+                    base::TimeTicks received_time);
+
   void SendXKeyEvent(const KeyEvent &key);
   void SetInputMethodActiveWindow();
 
@@ -95,6 +106,7 @@ private:
   void HandleScimEvent();
 
 private:
+  SCIMBridge::Delegate* delegate_;
   bool is_initialized_;
   std::string language_code_;
   String config_module_name_;
@@ -117,10 +129,16 @@ private:
   Window window_;
   Window root_window_;
 
+  // Accessed on the IO thread.
+  WideString pending_commit_;
+  bool pending_hide_preedit_;
+  base::TimeTicks pending_received_time_;
+
   DISALLOW_COPY_AND_ASSIGN(SCIMBridgeImpl);
 };
 
-SCIMBridge::SCIMBridge() : impl_(new SCIMBridgeImpl()) {
+SCIMBridge::SCIMBridge(Delegate* delegate)
+    : impl_(new SCIMBridgeImpl(delegate)) {
 }
 
 SCIMBridge::~SCIMBridge() {
@@ -158,15 +176,17 @@ void SCIMBridge::TextInputChanged(ui::TextInputType type) {
   }
 }
 
-SCIMBridgeImpl::SCIMBridgeImpl()
-  : is_initialized_(false),
+SCIMBridgeImpl::SCIMBridgeImpl(SCIMBridge::Delegate* delegate)
+  : delegate_(delegate),
+    is_initialized_(false),
     config_module_name_(kScimSimpleConfig),
     panel_client_id_(0),
     panel_client_fd_(-1),
     im_context_id_(getpid() % 50000),
     im_engine_instance_count_(0),
     display_(gfx::GetXDisplay()),
-    root_window_(GetX11RootWindow())
+    root_window_(GetX11RootWindow()),
+    pending_hide_preedit_(false)
 {
   // Create input system engine context data that would be sent to the daemon.
   // TODO: Add SCIM enums.
@@ -369,11 +389,14 @@ void SCIMBridgeImpl::OnResetKeyboardIse(int context) {
 }
 
 void SCIMBridgeImpl::OnHidePreeditString(int context) {
-  // TODO: implement
-  LOG(INFO) << "SCIMBridgeImpl::OnHidePreeditString - not implemented";
+  if (pending_received_time_.is_null())
+    pending_received_time_ = base::TimeTicks::Now();
+  pending_hide_preedit_ = true;
 }
 
 void SCIMBridgeImpl::OnProcessKeyEvent(int context, const KeyEvent &key) {
+  // What was committed before the key reaches the window ahead of it.
+  FlushPendingInput();
   content::BrowserThread::PostTask(content::BrowserThread::UI,
                           FROM_HERE,
                           base::Bind(&SCIMBridgeImpl::SendXKeyEvent,
@@ -381,8 +404,38 @@ void SCIMBridgeImpl::OnProcessKeyEvent(int context, const KeyEvent &key) {
 }
 
 void SCIMBridgeImpl::OnCommitString(int context, const WideString &wstr) {
-  // TODO: implement
-  LOG(INFO) << "SCIMBridgeImpl::OnCommitString - not implemented";
+  if (pending_received_time_.is_null())
+    pending_received_time_ = base::TimeTicks::Now();
+  pending_commit_ += wstr;
+}
+
+void SCIMBridgeImpl::FlushPendingInput() {
+  if (pending_received_time_.is_null())
+    return;
+
+  content::BrowserThread::PostTask(content::BrowserThread::UI,
+                          FROM_HERE,
+                          base::Bind(&SCIMBridgeImpl::DeliverInput,
+                                     base::Unretained(this),
+                                     base::WideToUTF16(pending_commit_),
+                                     pending_hide_preedit_,
+                                     pending_received_time_));
+  pending_commit_.clear();
+  pending_hide_preedit_ = false;
+  pending_received_time_ = base::TimeTicks();
+}
+
+void SCIMBridgeImpl::DeliverInput(const base::string16& commit_text,
+                                  bool hide_preedit,
+                                  base::TimeTicks received_time) {
+  if (hide_preedit)
+    delegate_->OnHidePreedit();
+  if (!commit_text.empty())
+    delegate_->OnCommitText(commit_text);
+  // From the SCIM event to the update of the text input client, the paint
+  // itself is asynchronous.
+  UMA_HISTOGRAM_TIMES("XWalk.IME.SCIMInputLatency",
+                      base::TimeTicks::Now() - received_time);
 }
 
 void SCIMBridgeImpl::SendXKeyEvent(const KeyEvent &key) {
@@ -422,6 +475,7 @@ void SCIMBridgeImpl::HandleScimEvent() {
         DisconnectPanelClient();
         InitPanelClient();
    }
+  FlushPendingInput();
 }
 
 void SCIMBridgeImpl::WatchSCIMFd() {
@@ -4,6 +4,7 @@
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/strings/string16.h"
 #include "ui/base/ime/text_input_type.h"
 
 #ifndef UI_BASE_IME_TIZEN_SCIM_BRIDGE_H_
@@ -16,7 +17,17 @@ class SCIMBridgeImpl;
 class SCIMBridge {
 
 public:
-  SCIMBridge();
+  // Receives the input of SCIM, on the UI thread.
+  class Delegate {
+   public:
+    virtual void OnCommitText(const base::string16& text) = 0;
+    virtual void OnHidePreedit() = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
+  explicit SCIMBridge(Delegate* delegate);
   ~SCIMBridge();
 
   void Init();
@@ -6,6 +6,8 @@ package org.xwalk.core;
 
 import android.webkit.WebResourceResponse;
 
+import java.util.List;
+
 import org.xwalk.core.internal.XWalkResourceClientInternal;
 import org.xwalk.core.internal.XWalkViewInternal;
 
@@ -126,6 +128,31 @@ public class XWalkResourceClient extends XWalkResourceClientInternal {
         }
     }
 
+    /**
+     * Notify the client of the resources the XWalkView started to load
+     * since the last call, at most once per frame. Calls onLoadStarted() for
+     * each of them by default, override it to handle them together, e.g. when
+     * only counting them.
+     * @param view the owner XWalkView instance.
+     * @param urls the urls of the resources, in the order they started to load.
+     * @since 2.2
+     */
+    public void onLoadStartedBatch(XWalkView view, List<String> urls) {
+        super.onLoadStartedBatch(view, urls);
+    }
+
+    /**
+     * @hide
+     */
+    @Override
+    public void onLoadStartedBatch(XWalkViewInternal view, List<String> urls) {
+        if (view instanceof XWalkView) {
+            onLoadStartedBatch((XWalkView) view, urls);
+        } else {
+            super.onLoadStartedBatch(view, urls);
+        }
+    }
+
     /**
      * Notify the client that the XWalkView completes to load the resource
      * specified by the given url.
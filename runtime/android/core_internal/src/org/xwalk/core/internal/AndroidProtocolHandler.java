@@ -5,8 +5,10 @@
 package org.xwalk.core.internal;
 
 import android.content.Context;
+import android.content.res.AssetFileDescriptor;
 import android.content.res.AssetManager;
 import android.net.Uri;
+import android.os.ParcelFileDescriptor;
 import android.util.Log;
 import android.util.TypedValue;
 
@@ -75,6 +77,62 @@ class AndroidProtocolHandler {
         return null;
     }
 
+    /**
+     * Open a file descriptor for an Android resource whose data is stored as
+     * is in a file, so the native side can read it without a JNI call per
+     * chunk. This is the case of uncompressed assets, which are a region of
+     * the APK, and of the content providers backed by files.
+     * @param context The context manager.
+     * @param url The url to load.
+     * @return {fd, offset, length}, the length being -1 when unknown, or null
+     *         if the resource can only be read with open(). The caller owns
+     *         the returned file descriptor.
+     */
+    @CalledByNative
+    public static long[] openFileDescriptor(Context context, String url) {
+        Uri uri = verifyUrl(url);
+        if (uri == null) {
+            return null;
+        }
+        AssetFileDescriptor afd = null;
+        try {
+            String path = uri.getPath();
+            if (uri.getScheme().equals(FILE_SCHEME)) {
+                if (path.startsWith(nativeGetAndroidAssetPath())) {
+                    afd = context.getAssets().openFd(getAssetPath(uri));
+                }
+            } else if (uri.getScheme().equals(CONTENT_SCHEME)) {
+                afd = context.getContentResolver().openAssetFileDescriptor(
+                        stripQueryParameters(uri), "r");
+            } else if (uri.getScheme().equals(APP_SCHEME)) {
+                // Same restrictions as in open().
+                if (!uri.getHost().equals(context.getPackageName().toLowerCase())) return null;
+                if (path.length() <= 1) return null;
+
+                afd = context.getAssets().openFd(getAssetPath(appUriToFileUri(uri)));
+            }
+            if (afd == null) return null;
+
+            // The descriptor is shared by the assets of the APK, the native
+            // side gets its own duplicate.
+            ParcelFileDescriptor pfd = ParcelFileDescriptor.dup(afd.getFileDescriptor());
+            return new long[] {
+                pfd.detachFd(), afd.getStartOffset(), afd.getDeclaredLength() };
+        } catch (Exception ex) {
+            // Compressed assets and providers without files throw here, they
+            // are read with open() instead.
+            return null;
+        } finally {
+            if (afd != null) {
+                try {
+                    afd.close();
+                } catch (IOException e) {
+                    Log.w(TAG, "Unable to close asset file descriptor: " + url);
+                }
+            }
+        }
+    }
+
     // Get the asset path of file:///android_asset/* url.
     public static String getAssetPath(Uri uri) {
         assert(uri.getScheme().equals(FILE_SCHEME));
@@ -214,7 +272,8 @@ class AndroidProtocolHandler {
     /**
      * Determine the mime type for an Android resource.
      * @param context The context manager.
-     * @param stream The opened input stream which to examine.
+     * @param stream The opened input stream which to examine, or null when the
+     *               resource was opened with openFileDescriptor().
      * @param url The url from which the stream was opened.
      * @return The mime type or null if the type is unknown.
      */
@@ -241,6 +300,10 @@ class AndroidProtocolHandler {
             Log.e(TAG, "Unable to get mime type" + url);
             return null;
         }
+        // Without a stream, the extension is all there is to go by.
+        if (stream == null) {
+            return URLConnection.guessContentTypeFromName(uri.getPath());
+        }
         // Fall back to sniffing the type from the stream.
         try {
             return URLConnection.guessContentTypeFromStream(stream);
@@ -266,6 +329,21 @@ class AndroidProtocolHandler {
         }
     }
 
+    /**
+     * Get the path of the APK holding the assets, indexed by the native side.
+     * @param context The context manager.
+     * @return The APK path.
+     */
+    @CalledByNative
+    public static String getApkPath(Context context) {
+        try {
+            return context.getApplicationInfo().sourceDir;
+        } catch (Exception ex) {
+            Log.e(TAG, "Unable to get the APK path");
+            return null;
+        }
+    }
+
     /**
      * Make sure the given string URL is correctly formed and parse it into a Uri.
      * @return a Uri instance, or null if the URL was invalid.
@@ -8,4 +8,11 @@ interface DownloadListener {
 
     public abstract void onDownloadStart(String url, String userAgent,
             String contentDisposition, String mimetype, long contentLength);
+
+    /**
+     * A download listed in the manifest with its SHA-256 digest was saved by the runtime
+     * instead of being passed to onDownloadStart().
+     * @param verified Whether the saved file has the expected digest.
+     */
+    public abstract void onDownloadFinished(String url, String path, boolean verified);
 }
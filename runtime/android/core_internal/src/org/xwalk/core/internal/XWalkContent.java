@@ -6,6 +6,7 @@
 package org.xwalk.core.internal;
 
 import android.app.Activity;
+import android.content.ComponentCallbacks2;
 import android.content.Context;
 import android.content.Intent;
 import android.content.SharedPreferences;
@@ -14,6 +15,7 @@ import android.os.Bundle;
 import android.text.TextUtils;
 import android.util.AttributeSet;
 import android.util.Log;
+import android.util.SparseArray;
 import android.view.ViewGroup;
 import android.webkit.ValueCallback;
 import android.webkit.WebResourceResponse;
@@ -58,6 +60,10 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
     private XWalkSettings mSettings;
     private XWalkGeolocationPermissions mGeolocationPermissions;
     private XWalkLaunchScreenManager mLaunchScreenManager;
+    // The callbacks of the scripts evaluated natively, by script id.
+    private final SparseArray<ValueCallback<String>> mScriptCallbacks =
+            new SparseArray<ValueCallback<String>>();
+    private int mNextScriptId = 1;
 
     long mXWalkContent;
     long mWebContents;
@@ -177,10 +183,12 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
             return;
         }
 
+        cancelPendingManifest();
         doLoadUrl(url, data);
     }
 
     public void reload(int mode) {
+        cancelPendingManifest();
         switch (mode) {
             case XWalkViewInternal.RELOAD_IGNORE_CACHE:
                 mContentViewCore.reloadIgnoringCache(true);
@@ -209,17 +217,30 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
     }
 
     public void evaluateJavascript(String script, ValueCallback<String> callback) {
-        final ValueCallback<String>  fCallback = callback;
-        ContentViewCore.JavaScriptCallback coreCallback = null;
-        if (fCallback != null) {
-            coreCallback = new ContentViewCore.JavaScriptCallback() {
-                @Override
-                public void handleJavaScriptResult(String jsonResult) {
-                    fCallback.onReceiveValue(jsonResult);
-                }
-            };
+        if (mXWalkContent == 0) {
+            // Nothing will run it, the callback must not wait forever.
+            if (callback != null) callback.onReceiveValue(null);
+            return;
+        }
+        // The scripts evaluated during the same task are sent in one batch, their
+        // results come back in one onJavascriptResults().
+        int id = mNextScriptId++;
+        if (!nativeEvaluateJavascript(mXWalkContent, id, script)) {
+            Log.w(TAG, "Too many scripts waiting to be evaluated, dropping one.");
+            if (callback != null) callback.onReceiveValue(null);
+            return;
+        }
+        if (callback != null) mScriptCallbacks.put(id, callback);
+    }
+
+    @CalledByNative
+    private void onJavascriptResults(int[] ids, String[] results) {
+        for (int i = 0; i < ids.length; ++i) {
+            ValueCallback<String> callback = mScriptCallbacks.get(ids[i]);
+            if (callback == null) continue;
+            mScriptCallbacks.remove(ids[i]);
+            callback.onReceiveValue(results[i]);
         }
-        mContentViewCore.evaluateJavaScript(script, coreCallback);
     }
 
     public void setUIClient(XWalkUIClientInternal client) {
@@ -275,6 +296,16 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
         nativeClearCache(mXWalkContent, includeDiskFiles);
     }
 
+    public void trimMemory(int level, boolean visible) {
+        if (mXWalkContent == 0) return;
+        // A visible view keeps its caches until memory is critically low, it
+        // would have to decode the images of the page again right away.
+        if (visible && level < ComponentCallbacks2.TRIM_MEMORY_RUNNING_CRITICAL) return;
+        boolean purgeScriptMemory = level == ComponentCallbacks2.TRIM_MEMORY_RUNNING_CRITICAL ||
+                level >= ComponentCallbacks2.TRIM_MEMORY_MODERATE;
+        nativeTrimMemory(mXWalkContent, purgeScriptMemory);
+    }
+
     public void clearHistory() {
         mContentViewCore.clearHistory();
     }
@@ -284,6 +315,7 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
     }
 
     public void goBack() {
+        cancelPendingManifest();
         mContentViewCore.goBack();
     }
 
@@ -292,10 +324,12 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
     }
 
     public void goForward() {
+        cancelPendingManifest();
         mContentViewCore.goForward();
     }
 
     void navigateTo(int offset)  {
+        cancelPendingManifest();
         mContentViewCore.goToOffset(offset);
     }
 
@@ -370,15 +404,7 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
             return;
         }
 
-        String content = data;
-        // If the data of manifest.json is not set, try to load it.
-        if (data == null || data.isEmpty()) {
-            try {
-                content = AndroidProtocolHandler.getUrlContent(mXWalkView.getActivity(), url);
-            } catch (IOException e) {
-                throw new RuntimeException("Failed to read the manifest: " + url);
-            }
-        }
+        cancelPendingManifest();
 
         // Calculate the base url of manifestUrl. Used by native side.
         // TODO(yongsheng): It's from runtime side. Need to find a better way
@@ -391,6 +417,19 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
             Log.w(TAG, "The url of manifest.json is probably not set correctly.");
         }
 
+        String content = data;
+        // If the data of manifest.json is not set, try to load it.
+        if (data == null || data.isEmpty()) {
+            // The manifests in the assets are read and parsed natively, off
+            // the UI thread.
+            if (nativeSetManifestFromUrl(mXWalkContent, baseUrl, url)) return;
+            try {
+                content = AndroidProtocolHandler.getUrlContent(mXWalkView.getActivity(), url);
+            } catch (IOException e) {
+                throw new RuntimeException("Failed to read the manifest: " + url);
+            }
+        }
+
         if (!nativeSetManifest(mXWalkContent, baseUrl, content)) {
             throw new RuntimeException("Failed to parse the manifest file: " + url);
         }
@@ -456,6 +495,22 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
         loadUrl(url, null);
     }
 
+    @CalledByNative
+    private void onManifestLoadFailed(String url) {
+        // The manifest is read asynchronously, the failure can't be thrown to the caller of
+        // loadAppFromManifest() anymore.
+        Log.e(TAG, "Failed to load the manifest: " + url);
+        mContentsClientBridge.onReceivedError(XWalkResourceClientInternal.ERROR_FILE,
+                "Failed to load the manifest", url);
+    }
+
+    // A navigation started after loadAppFromManifest() wins over the manifest still being
+    // read, which would load its start url otherwise.
+    private void cancelPendingManifest() {
+        if (mXWalkContent == 0) return;
+        nativeCancelPendingManifest(mXWalkContent);
+    }
+
     @CalledByNative
     public void onGetFullscreenFlagFromManifest(boolean enterFullscreen) {
         if (enterFullscreen) mContentsClientBridge.onToggleFullscreen(true);
@@ -519,6 +574,11 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
             return interceptedRequestData;
         }
 
+        @Override
+        public boolean shouldCacheInterceptedResponses() {
+            return mSettings.getInterceptedResponseCacheEnabled();
+        }
+
         @Override
         public boolean shouldBlockContentUrls() {
             return !mSettings.getAllowContentAccess();
@@ -563,7 +623,7 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
                             mGeolocationPermissions.deny(origin);
                         }
                     }
-                    nativeInvokeGeolocationCallback(mXWalkContent, allow, origin);
+                    nativeInvokeGeolocationCallback(mXWalkContent, allow, retain, origin);
                 }
             });
         }
@@ -573,13 +633,13 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
     private void onGeolocationPermissionsShowPrompt(String origin) {
         // Reject if geolocation is disabled, or the origin has a retained deny.
         if (!mSettings.getGeolocationEnabled()) {
-            nativeInvokeGeolocationCallback(mXWalkContent, false, origin);
+            nativeInvokeGeolocationCallback(mXWalkContent, false, false, origin);
             return;
         }
         // Allow if the origin has a retained allow.
         if (mGeolocationPermissions.hasOrigin(origin)) {
             nativeInvokeGeolocationCallback(mXWalkContent,
-                    mGeolocationPermissions.isOriginAllowed(origin),
+                    mGeolocationPermissions.isOriginAllowed(origin), true,
                     origin);
             return;
         }
@@ -651,13 +711,19 @@ class XWalkContent extends FrameLayout implements XWalkPreferencesInternal.KeyVa
             XWalkContentsIoThreadClient ioThreadClient,
             InterceptNavigationDelegate delegate);
     private native void nativeClearCache(long nativeXWalkContent, boolean includeDiskFiles);
+    private native void nativeTrimMemory(long nativeXWalkContent, boolean purgeScriptMemory);
     private native String nativeDevToolsAgentId(long nativeXWalkContent);
     private native String nativeGetVersion(long nativeXWalkContent);
     private native void nativeSetJsOnlineProperty(long nativeXWalkContent, boolean networkUp);
+    private native boolean nativeEvaluateJavascript(
+            long nativeXWalkContent, int id, String script);
     private native boolean nativeSetManifest(long nativeXWalkContent, String path, String manifest);
+    private native boolean nativeSetManifestFromUrl(
+            long nativeXWalkContent, String path, String url);
+    private native void nativeCancelPendingManifest(long nativeXWalkContent);
     private native int nativeGetRoutingID(long nativeXWalkContent);
     private native void nativeInvokeGeolocationCallback(
-            long nativeXWalkContent, boolean value, String requestingFrame);
+            long nativeXWalkContent, boolean value, boolean retained, String requestingFrame);
     private native byte[] nativeGetState(long nativeXWalkContent);
     private native boolean nativeSetState(long nativeXWalkContent, byte[] state);
 }
@@ -21,6 +21,8 @@ import android.webkit.ConsoleMessage;
 import android.webkit.ValueCallback;
 import android.webkit.WebResourceResponse;
 
+import java.util.List;
+
 import org.chromium.content.browser.ContentViewClient;
 import org.chromium.content.browser.ContentViewCore;
 import org.chromium.content.browser.WebContentsObserverAndroid;
@@ -52,6 +54,8 @@ abstract class XWalkContentsClient extends ContentViewClient {
 
         @Override
         public void didStopLoading(String url) {
+            // The posted callbacks of the page, e.g. its resource loads, go first.
+            mCallbackHelper.dispatchPendingCallbacks();
             onPageFinished(url);
         }
 
@@ -68,6 +72,7 @@ abstract class XWalkContentsClient extends ContentViewClient {
                 // the XWalkViewInternal does not notify the embedder of sub-frame failures.
                 return;
             }
+            mCallbackHelper.dispatchPendingCallbacks();
             onReceivedError(ErrorCodeConversionHelper.convertErrorCode(errorCode),
                     description, failingUrl);
         }
@@ -131,6 +136,8 @@ abstract class XWalkContentsClient extends ContentViewClient {
 
     public abstract void onResourceLoadStarted(String url);
 
+    public abstract void onResourceLoadStartedBatch(List<String> urls);
+
     public abstract void onResourceLoadFinished(String url);
 
     public abstract void onLoadResource(String url);
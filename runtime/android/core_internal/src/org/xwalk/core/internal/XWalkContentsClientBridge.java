@@ -23,6 +23,8 @@ import android.webkit.ConsoleMessage;
 import android.webkit.ValueCallback;
 import android.webkit.WebResourceResponse;
 
+import java.util.List;
+
 import org.chromium.base.CalledByNative;
 import org.chromium.base.JNINamespace;
 import org.chromium.base.ThreadUtils;
@@ -213,6 +215,13 @@ class XWalkContentsClientBridge extends XWalkContentsClient
         }
     }
 
+    @Override
+    public void onResourceLoadStartedBatch(List<String> urls) {
+        if (isOwnerActivityRunning()) {
+            mXWalkResourceClient.onLoadStartedBatch(mXWalkView, urls);
+        }
+    }
+
     @Override
     public void onResourceLoadFinished(String url) {
         if (isOwnerActivityRunning()) {
@@ -595,13 +604,21 @@ class XWalkContentsClientBridge extends XWalkContentsClient
         mNotificationService.updateNotificationIcon(notificationId, icon);
     }
 
+    @CalledByNative
+    private int getNotificationIconSize() {
+        android.content.res.Resources resources = mXWalkView.getContext().getResources();
+        return Math.max(
+                resources.getDimensionPixelSize(android.R.dimen.notification_large_icon_width),
+                resources.getDimensionPixelSize(android.R.dimen.notification_large_icon_height));
+    }
+
     @CalledByNative
     private void showNotification(String title, String message, String replaceId,
-            int notificationId, long delegate) {
+            Bitmap icon, int notificationId, long delegate) {
         // FIXME(wang16): use replaceId to replace exist notification. It happens when
         //                a notification with same name and tag fires.
         mNotificationService.showNotification(
-                title, message, replaceId, notificationId, delegate);
+                title, message, replaceId, icon, notificationId, delegate);
     }
 
     @CalledByNative
@@ -659,6 +676,13 @@ class XWalkContentsClientBridge extends XWalkContentsClient
     public void onDownloadStarted(String filename, String mimeType) {
     }
 
+    @CalledByNative
+    private void onDownloadFinished(String url, String path, boolean verified) {
+        if (mDownloadListener != null && isOwnerActivityRunning()) {
+            mDownloadListener.onDownloadFinished(url, path, verified);
+        }
+    }
+
     public void onDangerousDownload(String filename, int downloadId) {
     }
 
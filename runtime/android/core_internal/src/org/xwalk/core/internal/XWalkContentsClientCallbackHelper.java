@@ -9,6 +9,9 @@ import android.os.Looper;
 import android.os.Message;
 import android.util.Log;
 
+import java.util.ArrayList;
+import java.util.List;
+
 import org.chromium.content.browser.ContentViewCore;
 
 /**
@@ -16,6 +19,11 @@ import org.chromium.content.browser.ContentViewCore;
  *
  * Most callbacks do no go through here, but get forwarded to XWalkContentsClient directly. The
  * messages processed here may originate from the IO or UI thread.
+ *
+ * The per resource callbacks are gathered and called from a single message per frame, a page
+ * loading thousands of resources would flood the UI thread otherwise. All the callbacks posted
+ * here go through a single queue, and the callbacks made directly run it first, so the client
+ * still sees the callbacks in order.
  */
 class XWalkContentsClientCallbackHelper {
 
@@ -66,51 +74,57 @@ class XWalkContentsClientCallbackHelper {
         }
     }
 
-    private final static int MSG_ON_LOAD_RESOURCE = 1;
+    // The per resource callbacks gathered, in the order they were posted.
+    private static class ResourceEvents {
+        final List<Boolean> mIsLoadStarted = new ArrayList<Boolean>();
+        final List<String> mUrls = new ArrayList<String>();
+
+        void add(boolean isLoadStarted, String url) {
+            mIsLoadStarted.add(isLoadStarted);
+            mUrls.add(url);
+        }
+    }
+
+    private static class PendingCallback {
+        final int mWhat;
+        final Object mObj;
+
+        PendingCallback(int what, Object obj) {
+            mWhat = what;
+            mObj = obj;
+        }
+    }
+
+    private final static int MSG_ON_RESOURCE_EVENTS = 1;
     private final static int MSG_ON_PAGE_STARTED = 2;
     private final static int MSG_ON_DOWNLOAD_START = 3;
     private final static int MSG_ON_RECEIVED_LOGIN_REQUEST = 4;
     private final static int MSG_ON_RECEIVED_ERROR = 5;
-    private final static int MSG_ON_RESOURCE_LOAD_STARTED = 6;
+
+    // Looper messages running the pending callbacks, right away or once the per resource
+    // callbacks of a frame are gathered.
+    private final static int MSG_DISPATCH = 6;
+    private final static int MSG_DISPATCH_DELAYED = 7;
+
+    // One frame at 60 Hz.
+    private final static long RESOURCE_EVENTS_DELAY_MS = 16;
 
     private final XWalkContentsClient mContentsClient;
 
+    private final Object mLock = new Object();
+    // Guarded by mLock. A single queue keeps the callbacks in the order they were posted.
+    private List<PendingCallback> mPendingCallbacks = new ArrayList<PendingCallback>();
+    // Guarded by mLock, the last of mPendingCallbacks if it gathers per resource callbacks.
+    private ResourceEvents mGatheringResourceEvents;
+
     private final Handler mHandler = new Handler(Looper.getMainLooper()) {
         @Override
         public void handleMessage(Message msg) {
             switch(msg.what) {
-                case MSG_ON_LOAD_RESOURCE: {
-                    final String url = (String) msg.obj;
-                    mContentsClient.onLoadResource(url);
-                    break;
-                }
-                case MSG_ON_PAGE_STARTED: {
-                    final String url = (String) msg.obj;
-                    mContentsClient.onPageStarted(url);
-                    break;
-                }
-                case MSG_ON_DOWNLOAD_START: {
-                    DownloadInfo info = (DownloadInfo) msg.obj;
-                    mContentsClient.onDownloadStart(info.mUrl, info.mUserAgent,
-                            info.mContentDisposition, info.mMimeType, info.mContentLength);
-                    break;
-                }
-                case MSG_ON_RECEIVED_LOGIN_REQUEST: {
-                    LoginRequestInfo info = (LoginRequestInfo) msg.obj;
-                    mContentsClient.onReceivedLoginRequest(info.mRealm, info.mAccount, info.mArgs);
+                case MSG_DISPATCH:
+                case MSG_DISPATCH_DELAYED:
+                    dispatchPendingCallbacks();
                     break;
-                }
-                case MSG_ON_RECEIVED_ERROR: {
-                    OnReceivedErrorInfo info = (OnReceivedErrorInfo) msg.obj;
-                    mContentsClient.onReceivedError(info.mErrorCode, info.mDescription,
-                            info.mFailingUrl);
-                    break;
-                }
-                case MSG_ON_RESOURCE_LOAD_STARTED: {
-                    final String url = (String) msg.obj;
-                    mContentsClient.onResourceLoadStarted(url);
-                    break;
-                }
                 default:
                     throw new IllegalStateException(
                             "XWalkContentsClientCallbackHelper: unhandled message " + msg.what);
@@ -123,31 +137,125 @@ class XWalkContentsClientCallbackHelper {
     }
 
     public void postOnLoadResource(String url) {
-        mHandler.sendMessage(mHandler.obtainMessage(MSG_ON_LOAD_RESOURCE, url));
+        postResourceEvent(false, url);
     }
 
     public void postOnPageStarted(String url) {
-        mHandler.sendMessage(mHandler.obtainMessage(MSG_ON_PAGE_STARTED, url));
+        post(MSG_ON_PAGE_STARTED, url);
     }
 
     public void postOnDownloadStart(String url, String userAgent, String contentDisposition,
             String mimeType, long contentLength) {
         DownloadInfo info = new DownloadInfo(url, userAgent, contentDisposition, mimeType,
                 contentLength);
-        mHandler.sendMessage(mHandler.obtainMessage(MSG_ON_DOWNLOAD_START, info));
+        post(MSG_ON_DOWNLOAD_START, info);
     }
 
     public void postOnReceivedLoginRequest(String realm, String account, String args) {
         LoginRequestInfo info = new LoginRequestInfo(realm, account, args);
-        mHandler.sendMessage(mHandler.obtainMessage(MSG_ON_RECEIVED_LOGIN_REQUEST, info));
+        post(MSG_ON_RECEIVED_LOGIN_REQUEST, info);
     }
 
     public void postOnReceivedError(int errorCode, String description, String failingUrl) {
         OnReceivedErrorInfo info = new OnReceivedErrorInfo(errorCode, description, failingUrl);
-        mHandler.sendMessage(mHandler.obtainMessage(MSG_ON_RECEIVED_ERROR, info));
+        post(MSG_ON_RECEIVED_ERROR, info);
     }
 
     public void postOnResourceLoadStarted(String url) {
-        mHandler.sendMessage(mHandler.obtainMessage(MSG_ON_RESOURCE_LOAD_STARTED, url));
+        postResourceEvent(true, url);
+    }
+
+    /**
+     * Runs the callbacks posted so far. Called on the UI thread before a callback that
+     * doesn't go through here, so the client doesn't see it ahead of them.
+     */
+    public void dispatchPendingCallbacks() {
+        List<PendingCallback> callbacks;
+        synchronized (mLock) {
+            callbacks = mPendingCallbacks;
+            mPendingCallbacks = new ArrayList<PendingCallback>();
+            mGatheringResourceEvents = null;
+            mHandler.removeMessages(MSG_DISPATCH);
+            mHandler.removeMessages(MSG_DISPATCH_DELAYED);
+        }
+        for (PendingCallback callback : callbacks) {
+            dispatch(callback.mWhat, callback.mObj);
+        }
+    }
+
+    private void post(int what, Object obj) {
+        synchronized (mLock) {
+            mPendingCallbacks.add(new PendingCallback(what, obj));
+            mGatheringResourceEvents = null;
+            // The gathered per resource callbacks go first, without waiting for the frame.
+            mHandler.removeMessages(MSG_DISPATCH_DELAYED);
+            if (!mHandler.hasMessages(MSG_DISPATCH)) mHandler.sendEmptyMessage(MSG_DISPATCH);
+        }
+    }
+
+    private void postResourceEvent(boolean isLoadStarted, String url) {
+        synchronized (mLock) {
+            if (mGatheringResourceEvents == null) {
+                mGatheringResourceEvents = new ResourceEvents();
+                mPendingCallbacks.add(
+                        new PendingCallback(MSG_ON_RESOURCE_EVENTS, mGatheringResourceEvents));
+            }
+            mGatheringResourceEvents.add(isLoadStarted, url);
+            if (!mHandler.hasMessages(MSG_DISPATCH) &&
+                    !mHandler.hasMessages(MSG_DISPATCH_DELAYED)) {
+                mHandler.sendEmptyMessageDelayed(MSG_DISPATCH_DELAYED, RESOURCE_EVENTS_DELAY_MS);
+            }
+        }
+    }
+
+    private void dispatch(int what, Object obj) {
+        switch(what) {
+            case MSG_ON_RESOURCE_EVENTS: {
+                dispatchResourceEvents((ResourceEvents) obj);
+                break;
+            }
+            case MSG_ON_PAGE_STARTED: {
+                final String url = (String) obj;
+                mContentsClient.onPageStarted(url);
+                break;
+            }
+            case MSG_ON_DOWNLOAD_START: {
+                DownloadInfo info = (DownloadInfo) obj;
+                mContentsClient.onDownloadStart(info.mUrl, info.mUserAgent,
+                        info.mContentDisposition, info.mMimeType, info.mContentLength);
+                break;
+            }
+            case MSG_ON_RECEIVED_LOGIN_REQUEST: {
+                LoginRequestInfo info = (LoginRequestInfo) obj;
+                mContentsClient.onReceivedLoginRequest(info.mRealm, info.mAccount, info.mArgs);
+                break;
+            }
+            case MSG_ON_RECEIVED_ERROR: {
+                OnReceivedErrorInfo info = (OnReceivedErrorInfo) obj;
+                mContentsClient.onReceivedError(info.mErrorCode, info.mDescription,
+                        info.mFailingUrl);
+                break;
+            }
+            default:
+                throw new IllegalStateException(
+                        "XWalkContentsClientCallbackHelper: unhandled callback " + what);
+        }
+    }
+
+    // Consecutive load starts are delivered together, in order with the other callbacks.
+    private void dispatchResourceEvents(ResourceEvents events) {
+        int i = 0;
+        while (i < events.mUrls.size()) {
+            if (!events.mIsLoadStarted.get(i)) {
+                mContentsClient.onLoadResource(events.mUrls.get(i));
+                ++i;
+                continue;
+            }
+            int end = i + 1;
+            while (end < events.mUrls.size() && events.mIsLoadStarted.get(end)) ++end;
+            mContentsClient.onResourceLoadStartedBatch(
+                    new ArrayList<String>(events.mUrls.subList(i, end)));
+            i = end;
+        }
     }
 }
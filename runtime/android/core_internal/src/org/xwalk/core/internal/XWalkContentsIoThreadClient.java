@@ -18,6 +18,9 @@ interface XWalkContentsIoThreadClient {
     @CalledByNative
     public InterceptedRequestData shouldInterceptRequest(String url, boolean isMainFrame);
 
+    @CalledByNative
+    public boolean shouldCacheInterceptedResponses();
+
     @CalledByNative
     public boolean shouldBlockContentUrls();
 
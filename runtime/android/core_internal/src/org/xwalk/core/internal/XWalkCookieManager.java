@@ -4,17 +4,50 @@
 
 package org.xwalk.core.internal;
 
+import android.os.Handler;
+import android.os.Looper;
+import android.webkit.ValueCallback;
+
+import org.chromium.base.CalledByNative;
 import org.chromium.base.JNINamespace;
 
 /**
  * XWalkCookieManager manages cookies according to RFC2109 spec.
  *
- * Methods in this class are thread safe.
+ * Methods in this class are thread safe. The methods returning a value wait
+ * for the network stack, the variants taking a callback don't: the callback
+ * is invoked on the thread of the caller if it has a Looper, on the main
+ * thread otherwise. Prefer them on the UI thread.
  *
  * @hide
  */
 @JNINamespace("xwalk")
 public final class XWalkCookieManager {
+    /**
+     * Delivers a result from the network stack to the thread which asked for
+     * it. The native side sees it as an opaque object.
+     */
+    private static class CookieCallback<T> {
+        private final ValueCallback<T> mCallback;
+        private final Handler mHandler;
+
+        CookieCallback(ValueCallback<T> callback) {
+            mCallback = callback;
+            Looper looper = Looper.myLooper();
+            mHandler = new Handler(looper != null ? looper : Looper.getMainLooper());
+        }
+
+        void onResult(final T result) {
+            if (mCallback == null) return;
+            mHandler.post(new Runnable() {
+                @Override
+                public void run() {
+                    mCallback.onReceiveValue(result);
+                }
+            });
+        }
+    }
+
     /**
      * Control whether cookie is enabled or disabled
      * @param accept TRUE if accept cookie
@@ -54,6 +87,46 @@ public final class XWalkCookieManager {
         return cookie == null || cookie.trim().isEmpty() ? null : cookie;
     }
 
+    /**
+     * Asynchronous variant of {@link #setCookie(String, String)}.
+     * @param callback Receives whether the cookie was set, can be null.
+     */
+    public void setCookie(final String url, final String value,
+            ValueCallback<Boolean> callback) {
+        nativeSetCookieAsync(url, value, new CookieCallback<Boolean>(callback));
+    }
+
+    /**
+     * Asynchronous variant of {@link #getCookie(String)}.
+     * @param callback Receives the cookies, null if there are none.
+     */
+    public void getCookie(final String url, ValueCallback<String> callback) {
+        nativeGetCookieAsync(url, new CookieCallback<String>(callback));
+    }
+
+    /**
+     * Sets the cookies of many urls in a single request to the network stack.
+     * @param urls The url each cookie is set for
+     * @param values The set-cookie: values, as many as |urls|
+     * @param callback Receives the number of cookies set, can be null.
+     */
+    public void setCookies(final String[] urls, final String[] values,
+            ValueCallback<Integer> callback) {
+        if (urls.length != values.length) {
+            throw new IllegalArgumentException("Expected as many values as urls");
+        }
+        nativeSetCookiesAsync(urls, values, new CookieCallback<Integer>(callback));
+    }
+
+    /**
+     * Gets the cookies of many urls in a single request to the network stack.
+     * @param callback Receives the cookies of each url, in the same order.
+     *     Urls without cookies get null.
+     */
+    public void getCookies(final String[] urls, ValueCallback<String[]> callback) {
+        nativeGetCookiesAsync(urls, new CookieCallback<String[]>(callback));
+    }
+
     /**
      * Remove all session cookies, which are cookies without expiration date
      */
@@ -61,6 +134,14 @@ public final class XWalkCookieManager {
         nativeRemoveSessionCookie();
     }
 
+    /**
+     * Asynchronous variant of {@link #removeSessionCookie()}.
+     * @param callback Receives the number of cookies removed, can be null.
+     */
+    public void removeSessionCookie(ValueCallback<Integer> callback) {
+        nativeRemoveSessionCookieAsync(new CookieCallback<Integer>(callback));
+    }
+
     /**
      * Remove all cookies
      */
@@ -68,6 +149,14 @@ public final class XWalkCookieManager {
         nativeRemoveAllCookie();
     }
 
+    /**
+     * Asynchronous variant of {@link #removeAllCookie()}.
+     * @param callback Receives the number of cookies removed, can be null.
+     */
+    public void removeAllCookie(ValueCallback<Integer> callback) {
+        nativeRemoveAllCookieAsync(new CookieCallback<Integer>(callback));
+    }
+
     /**
      *  Return true if there are stored cookies.
      */
@@ -75,6 +164,13 @@ public final class XWalkCookieManager {
         return nativeHasCookies();
     }
 
+    /**
+     * Asynchronous variant of {@link #hasCookies()}.
+     */
+    public void hasCookies(ValueCallback<Boolean> callback) {
+        nativeHasCookiesAsync(new CookieCallback<Boolean>(callback));
+    }
+
     /**
      * Remove all expired cookies
      */
@@ -86,6 +182,20 @@ public final class XWalkCookieManager {
         nativeFlushCookieStore();
     }
 
+    /**
+     * Writes the cookies to the disk without waiting for it.
+     * @param callback Invoked once they are written, can be null.
+     */
+    public void flushCookieStore(final Runnable callback) {
+        nativeFlushCookieStoreAsync(new CookieCallback<Void>(
+                callback == null ? null : new ValueCallback<Void>() {
+                    @Override
+                    public void onReceiveValue(Void value) {
+                        callback.run();
+                    }
+                }));
+    }
+
     /**
      * Whether cookies are accepted for file scheme URLs.
      */
@@ -107,6 +217,41 @@ public final class XWalkCookieManager {
         nativeSetAcceptFileSchemeCookies(accept);
     }
 
+    @SuppressWarnings("unchecked")
+    @CalledByNative
+    private static void invokeBooleanCookieCallback(Object callback, boolean result) {
+        ((CookieCallback<Boolean>) callback).onResult(result);
+    }
+
+    @SuppressWarnings("unchecked")
+    @CalledByNative
+    private static void invokeIntCookieCallback(Object callback, int result) {
+        ((CookieCallback<Integer>) callback).onResult(result);
+    }
+
+    @SuppressWarnings("unchecked")
+    @CalledByNative
+    private static void invokeStringCookieCallback(Object callback, String result) {
+        // Return null if the string is empty to match getCookie().
+        ((CookieCallback<String>) callback).onResult(
+                result == null || result.trim().isEmpty() ? null : result);
+    }
+
+    @SuppressWarnings("unchecked")
+    @CalledByNative
+    private static void invokeStringsCookieCallback(Object callback, String[] result) {
+        for (int i = 0; i < result.length; ++i) {
+            if (result[i].trim().isEmpty()) result[i] = null;
+        }
+        ((CookieCallback<String[]>) callback).onResult(result);
+    }
+
+    @SuppressWarnings("unchecked")
+    @CalledByNative
+    private static void invokeCookieCallback(Object callback) {
+        ((CookieCallback<Void>) callback).onResult(null);
+    }
+
     private native void nativeSetAcceptCookie(boolean accept);
     private native boolean nativeAcceptCookie();
 
@@ -120,6 +265,15 @@ public final class XWalkCookieManager {
 
     private native boolean nativeHasCookies();
 
+    private native void nativeSetCookieAsync(String url, String value, Object callback);
+    private native void nativeGetCookieAsync(String url, Object callback);
+    private native void nativeSetCookiesAsync(String[] urls, String[] values, Object callback);
+    private native void nativeGetCookiesAsync(String[] urls, Object callback);
+    private native void nativeRemoveSessionCookieAsync(Object callback);
+    private native void nativeRemoveAllCookieAsync(Object callback);
+    private native void nativeFlushCookieStoreAsync(Object callback);
+    private native void nativeHasCookiesAsync(Object callback);
+
     private native boolean nativeAllowFileSchemeCookies();
     private native void nativeSetAcceptFileSchemeCookies(boolean accept);
 }
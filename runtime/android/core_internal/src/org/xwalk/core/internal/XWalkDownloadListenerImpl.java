@@ -70,6 +70,11 @@ class XWalkDownloadListenerImpl implements DownloadListener {
         }
     }
 
+    @Override
+    public void onDownloadFinished(String url, String path, boolean verified) {
+        popupMessages(verified ? DOWNLOAD_FINISHED_TOAST : DOWNLOAD_FAILED_TOAST);
+    }
+
     private String getFileName(String url, String contentDisposition, String mimetype) {
         String fileName = URLUtil.guessFileName(url, contentDisposition, mimetype);
         int extensionIndex = fileName.lastIndexOf(".");
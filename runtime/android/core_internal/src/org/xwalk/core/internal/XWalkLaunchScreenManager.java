@@ -7,6 +7,8 @@ package org.xwalk.core.internal;
 import java.lang.Runnable;
 import java.util.ArrayList;
 
+import android.animation.Animator;
+import android.animation.AnimatorListenerAdapter;
 import android.app.Activity;
 import android.app.Dialog;
 import android.content.BroadcastReceiver;
@@ -24,6 +26,7 @@ import android.graphics.Rect;
 import android.graphics.Shader.TileMode;
 import android.hardware.SensorManager;
 import android.os.Bundle;
+import android.os.SystemClock;
 import android.util.DisplayMetrics;
 import android.util.Log;
 import android.util.TypedValue;
@@ -54,6 +57,12 @@ public class XWalkLaunchScreenManager
     // and used by LaunchScreenExtension.
     private static String mIntentFilterStr;
 
+    private final static String TAG = "XWalkLaunchScreenManager";
+
+    // The launch screen fades out over the first frames of the application
+    // instead of disappearing at once.
+    private final static long FADE_OUT_DURATION_MS = 200;
+
     private final static String BORDER_MODE_REPEAT = "repeat";
     private final static String BORDER_MODE_STRETCH = "stretch";
     private final static String BORDER_MODE_ROUND = "round";
@@ -69,6 +78,7 @@ public class XWalkLaunchScreenManager
     private boolean mCustomHideLaunchScreen;
     private int mCurrentOrientation;
     private OrientationEventListener mOrientationListener;
+    private long mDisplayTime;
 
     private enum ReadyWhenType {
         FIRST_PAINT,
@@ -94,6 +104,7 @@ public class XWalkLaunchScreenManager
     public void displayLaunchScreen(String readyWhen, final String imageBorderList) {
         if (mXWalkView == null) return;
         setReadyWhen(readyWhen);
+        mDisplayTime = SystemClock.uptimeMillis();
 
         Runnable runnable = new Runnable() {
            public void run() {
@@ -157,6 +168,10 @@ public class XWalkLaunchScreenManager
 
     @Override
     public void onFirstFrameReceived() {
+        if (!mFirstFrameReceived && mDisplayTime != 0) {
+            Log.i(TAG, "First frame " + (SystemClock.uptimeMillis() - mDisplayTime) +
+                    " ms after the launch screen was displayed");
+        }
         mFirstFrameReceived = true;
         hideLaunchScreenWhenReady();
     }
@@ -577,11 +592,22 @@ public class XWalkLaunchScreenManager
     }
 
     private void performHideLaunchScreen() {
-        mLaunchScreenDialog.dismiss();
+        if (mLaunchScreenDialog == null) return;
+        final Dialog dialog = mLaunchScreenDialog;
         mLaunchScreenDialog = null;
         if (mReadyWhen == ReadyWhenType.CUSTOM) {
             mActivity.unregisterReceiver(mLaunchScreenReadyWhenReceiver);
         }
+
+        // The first frame is already on screen behind the dialog.
+        View decorView = dialog.getWindow().getDecorView();
+        decorView.animate().alpha(0).setDuration(FADE_OUT_DURATION_MS).setListener(
+                new AnimatorListenerAdapter() {
+                    @Override
+                    public void onAnimationEnd(Animator animation) {
+                        dialog.dismiss();
+                    }
+                });
     }
 
     private void setReadyWhen(String readyWhen) {
@@ -114,10 +114,20 @@ public class XWalkNotificationServiceImpl implements XWalkNotificationService {
             return;
         }
 
+        Notification.Builder builder = webNotification.mBuilder;
+        if (!setLargeIcon(builder, icon)) return;
+
+        doShowNotification(notificationId, 
+                VERSION.SDK_INT >= VERSION_CODES.JELLY_BEAN ? builder.build() : builder.getNotification());
+    }
+
+    // The icon is usually downscaled by the renderer already, it only needs to
+    // be scaled here when it is larger than both dimensions of a large icon.
+    private boolean setLargeIcon(Notification.Builder builder, Bitmap icon) {
         int originalWidth  = icon.getWidth();
         int originalHeight = icon.getHeight();
         if (originalWidth == 0 || originalHeight == 0) {
-            return;
+            return false;
         }
 
         int targetWidth = mContext.getResources().getDimensionPixelSize(
@@ -131,19 +141,17 @@ public class XWalkNotificationServiceImpl implements XWalkNotificationService {
             } else {
                 targetWidth = originalWidth * targetHeight / originalHeight;
             }
+            icon = Bitmap.createScaledBitmap(icon, targetWidth, targetHeight, true);
         }
 
-        Notification.Builder builder = webNotification.mBuilder;
-        builder.setLargeIcon(Bitmap.createScaledBitmap(icon, targetWidth, targetHeight, true));
-
-        doShowNotification(notificationId, 
-                VERSION.SDK_INT >= VERSION_CODES.JELLY_BEAN ? builder.build() : builder.getNotification());
+        builder.setLargeIcon(icon);
+        return true;
     }
 
     @Override
     @SuppressWarnings("deprecation")
     public void showNotification(String title, String message, String replaceId,
-            int notificationId, long delegate) {
+            Bitmap icon, int notificationId, long delegate) {
         Notification.Builder builder;
 
         if (!replaceId.isEmpty() && mExistReplaceIds.containsKey(replaceId)) {
@@ -174,6 +182,9 @@ public class XWalkNotificationServiceImpl implements XWalkNotificationService {
             iconRes = android.R.drawable.sym_def_app_icon;
         }
         builder.setSmallIcon(iconRes);
+        // The icon is known when it was already downloaded for a previous
+        // notification, which saves a second update of the notification.
+        if (icon != null) setLargeIcon(builder, icon);
 
         Context activity = mView.getActivity();
         String category = getCategoryFromNotificationId(notificationId);
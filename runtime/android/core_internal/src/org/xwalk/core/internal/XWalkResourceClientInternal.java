@@ -10,6 +10,8 @@ import android.content.DialogInterface;
 import android.view.View;
 import android.webkit.WebResourceResponse;
 
+import java.util.List;
+
 /**
  * This class notifies the embedder resource events/callbacks.
  */
@@ -114,6 +116,21 @@ public class XWalkResourceClientInternal {
     public void onLoadStarted(XWalkViewInternal view, String url) {
     }
 
+    /**
+     * Notify the client of the resources the XWalkViewInternal started to load
+     * since the last call, at most once per frame. Calls onLoadStarted() for
+     * each of them by default, override it to handle them together, e.g. when
+     * only counting them.
+     * @param view the owner XWalkViewInternal instance.
+     * @param urls the urls of the resources, in the order they started to load.
+     * @since 2.2
+     */
+    public void onLoadStartedBatch(XWalkViewInternal view, List<String> urls) {
+        for (String url : urls) {
+            onLoadStarted(view, url);
+        }
+    }
+
     /**
      * Notify the client that the XWalkViewInternal completes to load the resource
      * specified by the given url.
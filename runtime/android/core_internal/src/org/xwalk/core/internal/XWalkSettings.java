@@ -13,6 +13,7 @@ import android.os.Process;
 import android.webkit.WebSettings;
 
 import org.chromium.base.CalledByNative;
+import org.chromium.base.CommandLine;
 import org.chromium.base.JNINamespace;
 import org.chromium.base.ThreadUtils;
 
@@ -53,6 +54,7 @@ public class XWalkSettings {
     private boolean mBlockNetworkLoads;  // Default depends on permission of embedding APK.
     private boolean mAllowContentUrlAccess = true;
     private boolean mAllowFileUrlAccess = true;
+    private boolean mInterceptedResponseCacheEnabled = false;
     private boolean mShouldFocusFirstNode = true;
     private boolean mGeolocationEnabled = true;
     private String mUserAgent;
@@ -64,6 +66,23 @@ public class XWalkSettings {
     // client.
     private static boolean sAppCachePathIsSet = false;
 
+    // HTTP cache configuration of the process, passed on the command line when
+    // the runtime starts.
+    public static final String HTTP_CACHE_BACKEND_BLOCKFILE = "blockfile";
+    public static final String HTTP_CACHE_BACKEND_SIMPLE = "simple";
+    public static final String HTTP_CACHE_BACKEND_MEMORY = "memory";
+
+    // The kinds of resources an intercept pattern applies to, see
+    // addInterceptPattern().
+    public static final int INTERCEPT_MAIN_FRAME = 1 << 0;
+    public static final int INTERCEPT_SUB_FRAME = 1 << 1;
+    public static final int INTERCEPT_SUBRESOURCE = 1 << 2;
+    public static final int INTERCEPT_ALL_RESOURCES =
+            INTERCEPT_MAIN_FRAME | INTERCEPT_SUB_FRAME | INTERCEPT_SUBRESOURCE;
+    private static int sHttpCacheSize = 0;
+    private static String sHttpCacheBackend;
+    private static String[] sWarmCacheUrls;
+
     // The native side of this object.
     private long mNativeXWalkSettings = 0;
 
@@ -118,6 +137,8 @@ public class XWalkSettings {
             if (mNativeXWalkSettings == 0) return;
             if (mHandler == null) return;
             if (ThreadUtils.runningOnUiThread()) {
+                // The new value must be in effect for the next load started by
+                // the caller, e.g. right after setJavaScriptEnabled().
                 updateWebkitPreferencesOnUiThread();
             } else {
                 // We're being called on a background thread, so post a message.
@@ -257,6 +278,130 @@ public class XWalkSettings {
         }
     }
 
+    /**
+     * Keep the responses given by shouldInterceptRequest() in a memory cache
+     * shared by all the views enabling it, and serve the next requests for
+     * the same urls from there without asking the client again. Meant for
+     * applications bundling their resources, the client has to call
+     * {@link #invalidateInterceptedResponseCache} when a response changes.
+     * Disabled by default.
+     */
+    public void setInterceptedResponseCacheEnabled(boolean enabled) {
+        synchronized (mXWalkSettingsLock) {
+            mInterceptedResponseCacheEnabled = enabled;
+        }
+    }
+
+    /**
+     * Get whether the intercepted responses are cached.
+     */
+    public boolean getInterceptedResponseCacheEnabled() {
+        synchronized (mXWalkSettingsLock) {
+            return mInterceptedResponseCacheEnabled;
+        }
+    }
+
+    /**
+     * Drop the cached intercepted response for a url.
+     * @param url The url to invalidate, or null to drop all the responses.
+     */
+    public static void invalidateInterceptedResponseCache(String url) {
+        nativeInvalidateInterceptedResponseCache(url);
+    }
+
+    /**
+     * Only ask shouldInterceptRequest() about the requests matching one of the
+     * patterns added, the other ones are loaded without calling the client.
+     * Without patterns, the client is asked about every request.
+     * @param scheme The scheme to match, or null for any.
+     * @param host The host to match, or null for any. "*.example.com" also
+     *             matches the subdomains of example.com.
+     * @param pathPrefix The start of the path to match, or null for any.
+     * @param resourceTypes A combination of the INTERCEPT_ values.
+     */
+    public void addInterceptPattern(String scheme, String host, String pathPrefix,
+            int resourceTypes) {
+        synchronized (mXWalkSettingsLock) {
+            if (mNativeXWalkSettings == 0) return;
+            nativeAddInterceptPattern(mNativeXWalkSettings, scheme, host, pathPrefix,
+                    resourceTypes);
+        }
+    }
+
+    /**
+     * Remove the patterns added with addInterceptPattern(), the client is
+     * asked about every request again.
+     */
+    public void clearInterceptPatterns() {
+        synchronized (mXWalkSettingsLock) {
+            if (mNativeXWalkSettings == 0) return;
+            nativeClearInterceptPatterns(mNativeXWalkSettings);
+        }
+    }
+
+    /**
+     * Get the number of requests the clients of all the views weren't asked
+     * about since the process started, because no intercept pattern matched.
+     */
+    public static int getSkippedInterceptRequestCount() {
+        return nativeGetSkippedInterceptRequestCount();
+    }
+
+    /**
+     * Set the maximum size of the HTTP cache of the process. Must be called
+     * before the first XWalkView is created.
+     * @param bytes The size in bytes, or 0 to size it from the free space.
+     */
+    public static void setHttpCacheSize(int bytes) {
+        synchronized (sGlobalContentSettingsLock) {
+            sHttpCacheSize = Math.max(bytes, 0);
+        }
+    }
+
+    /**
+     * Set the backend of the HTTP cache of the process. The simple backend
+     * suits flash storage better, the memory one writes nothing to disk.
+     * Must be called before the first XWalkView is created.
+     * @param backend One of the HTTP_CACHE_BACKEND_ values, or null for the
+     *                default.
+     */
+    public static void setHttpCacheBackend(String backend) {
+        synchronized (sGlobalContentSettingsLock) {
+            sHttpCacheBackend = backend;
+        }
+    }
+
+    /**
+     * Set http(s) urls to fetch in the background when the runtime starts, so
+     * their responses are cached by the time they are used. Must be called
+     * before the first XWalkView is created.
+     */
+    public static void setWarmCacheUrls(String[] urls) {
+        synchronized (sGlobalContentSettingsLock) {
+            sWarmCacheUrls = urls == null ? null : urls.clone();
+        }
+    }
+
+    static void appendHttpCacheSwitches(CommandLine commandLine) {
+        synchronized (sGlobalContentSettingsLock) {
+            if (sHttpCacheSize > 0) {
+                commandLine.appendSwitchWithValue(
+                        "disk-cache-size", Integer.toString(sHttpCacheSize));
+            }
+            if (sHttpCacheBackend != null) {
+                commandLine.appendSwitchWithValue("http-cache-backend", sHttpCacheBackend);
+            }
+            if (sWarmCacheUrls != null && sWarmCacheUrls.length > 0) {
+                StringBuilder urls = new StringBuilder();
+                for (String url : sWarmCacheUrls) {
+                    if (urls.length() > 0) urls.append(',');
+                    urls.append(url);
+                }
+                commandLine.appendSwitchWithValue("warm-cache-urls", urls.toString());
+            }
+        }
+    }
+
     /**
      * See {@link android.webkit.WebSettings#setAllowContentAccess}.
      */
@@ -284,6 +429,15 @@ public class XWalkSettings {
         synchronized (mXWalkSettingsLock) {
             if (mGeolocationEnabled != flag) {
                 mGeolocationEnabled = flag;
+                // The native side answers from the decisions it was told.
+                mEventHandler.maybeRunOnUiThreadBlocking(new Runnable() {
+                    @Override
+                    public void run() {
+                        if (mNativeXWalkSettings != 0) {
+                            nativeClearGeolocationDecisions(mNativeXWalkSettings);
+                        }
+                    }
+                });
             }
         }
     }
@@ -662,9 +816,20 @@ public class XWalkSettings {
 
     private static native String nativeGetDefaultUserAgent();
 
+    private static native void nativeInvalidateInterceptedResponseCache(String url);
+
+    private native void nativeAddInterceptPattern(long nativeXWalkSettings, String scheme,
+            String host, String pathPrefix, int resourceTypes);
+
+    private native void nativeClearInterceptPatterns(long nativeXWalkSettings);
+
+    private static native int nativeGetSkippedInterceptRequestCount();
+
     private native void nativeUpdateEverythingLocked(long nativeXWalkSettings);
 
     private native void nativeUpdateUserAgent(long nativeXWalkSettings);
 
+    private native void nativeClearGeolocationDecisions(long nativeXWalkSettings);
+
     private native void nativeUpdateWebkitPreferences(long nativeXWalkSettings);
 }
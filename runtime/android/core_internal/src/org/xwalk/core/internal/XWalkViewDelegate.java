@@ -104,6 +104,7 @@ class XWalkViewDelegate {
         if (!CommandLine.isInitialized()) {
             CommandLine.init(readCommandLine(context.getApplicationContext()));
         }
+        XWalkSettings.appendHttpCacheSwitches(CommandLine.getInstance());
 
         // If context's applicationContext is not the same package with itself,
         // It's a cross package invoking, load core library from library apk.
@@ -185,6 +186,11 @@ class XWalkViewDelegate {
                 } catch (ProcessInitException e) {
                     throw new RuntimeException("Cannot initialize Crosswalk Core", e);
                 }
+                // The renderer runs in the browser process, so all the XWalkViews
+                // of the application share a single renderer and extension
+                // setup no matter how many of them are created. Running
+                // renderers in their own processes would need sandboxed
+                // services declared in the manifest of the embedder.
                 try {
                     BrowserStartupController.get(context).startBrowserProcessesSync(
                         BrowserStartupController.MAX_RENDERERS_SINGLE_PROCESS);
@@ -381,6 +381,9 @@ public class XWalkViewInternal extends android.widget.FrameLayout {
      *
      * It supports URL schemes like 'http:', 'https:' and 'file:'.
      * It can also load files from Android assets, e.g. 'file:///android_asset/'.
+     * A manifest.json in the assets is read and parsed asynchronously. If it can't be,
+     * XWalkResourceClientInternal.onReceivedLoadError() is called with its url. A load or a
+     * navigation started before it is read cancels it.
      * @param url the url for manifest.json.
      * @param content the content for manifest.json.
      * @since 1.0
@@ -581,6 +584,23 @@ public class XWalkViewInternal extends android.widget.FrameLayout {
         mIsHidden = false;
     }
 
+    /**
+     * Release the memory caches of the rendering engine, like decoded images and
+     * JavaScript code caches, when the system is running low on memory.
+     * Embedders are in charge of forwarding
+     * <a href="http://developer.android.com/reference/android/content/ComponentCallbacks2.html">
+     * android.content.ComponentCallbacks2.onTrimMemory()</a> of their activity to this method.
+     * A visible XWalkViewInternal only releases its caches when memory is critically low, call
+     * onHide() first for a view which isn't shown anymore.
+     * @param level passed from android.content.ComponentCallbacks2.onTrimMemory().
+     * @since 2.2
+     */
+    public void onTrimMemory(int level) {
+        if (mContent == null) return;
+        checkThreadSafety();
+        mContent.trimMemory(level, !mIsHidden);
+    }
+
     /**
      * Release internal resources occupied by this XWalkViewInternal.
      * It will be called when the container Activity get destroyed. It can also be explicitly
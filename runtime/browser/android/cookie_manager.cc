@@ -5,10 +5,13 @@
 #include "xwalk/runtime/browser/android/cookie_manager.h"
 
 #include <string>
+#include <vector>
 
 #include "android_webview/browser/scoped_allow_wait_for_legacy_web_view_api.h"
 #include "android_webview/native/aw_browser_dependency_factory.h"
+#include "base/android/jni_array.h"
 #include "base/android/jni_string.h"
+#include "base/android/scoped_java_ref.h"
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/lazy_instance.h"
@@ -25,8 +28,10 @@
 #include "net/url_request/url_request_context.h"
 #include "xwalk/runtime/browser/android/xwalk_cookie_access_policy.h"
 
+using base::android::AttachCurrentThread;
 using base::android::ConvertJavaStringToUTF8;
 using base::android::ConvertJavaStringToUTF16;
+using base::android::ScopedJavaGlobalRef;
 using content::BrowserThread;
 using net::CookieList;
 using net::CookieMonster;
@@ -34,12 +39,81 @@ using net::CookieMonster;
 // All functions on the CookieManager can be called from any thread, including
 // threads without a message loop. BrowserThread::FILE is used to call methods
 // on CookieMonster that needs to be called, and called back, on a chrome
-// thread.
+// thread. The asynchronous variants don't wait for the FILE thread, their
+// results are handed to a Java callback from there.
 
 namespace xwalk {
 
 namespace {
 
+typedef base::Callback<void(bool)> BooleanCookieCallback;
+typedef base::Callback<void(int)> IntCookieCallback;
+typedef base::Callback<void(const std::string&)> StringCookieCallback;
+typedef base::Callback<void(const std::vector<std::string>&)>
+    StringsCookieCallback;
+
+// Collects the results of the cookies of a batch, the cookie monster runs
+// the callbacks in the order of the requests.
+class SetCookiesBatch : public base::RefCounted<SetCookiesBatch> {
+ public:
+  SetCookiesBatch(size_t size, const IntCookieCallback& callback)
+      : pending_(size),
+        succeeded_(0),
+        callback_(callback) {}
+
+  void OnCookieSet(bool success) {
+    if (success)
+      ++succeeded_;
+    if (--pending_ == 0)
+      callback_.Run(succeeded_);
+  }
+
+ private:
+  friend class base::RefCounted<SetCookiesBatch>;
+  ~SetCookiesBatch() {}
+
+  size_t pending_;
+  int succeeded_;
+  IntCookieCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(SetCookiesBatch);
+};
+
+class GetCookiesBatch : public base::RefCounted<GetCookiesBatch> {
+ public:
+  GetCookiesBatch(size_t size, const StringsCookieCallback& callback)
+      : values_(size),
+        pending_(size),
+        callback_(callback) {}
+
+  void OnCookiesGot(size_t index, const std::string& value) {
+    values_[index] = value;
+    if (--pending_ == 0)
+      callback_.Run(values_);
+  }
+
+ private:
+  friend class base::RefCounted<GetCookiesBatch>;
+  ~GetCookiesBatch() {}
+
+  std::vector<std::string> values_;
+  size_t pending_;
+  StringsCookieCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(GetCookiesBatch);
+};
+
+void RunHasCookiesCallback(const BooleanCookieCallback& callback,
+                           const CookieList& cookies) {
+  callback.Run(!cookies.empty());
+}
+
+net::CookieOptions GetCookieOptions() {
+  net::CookieOptions options;
+  options.set_include_httponly();
+  return options;
+}
+
 class CookieManager {
  public:
   static CookieManager* GetInstance();
@@ -57,6 +131,24 @@ class CookieManager {
   void FlushCookieStore();
   bool HasCookies();
   bool AllowFileSchemeCookies();
+
+  // Asynchronous variants, the callbacks are run on the FILE thread.
+  void SetCookieAsync(const GURL& host,
+                      const std::string& cookie_value,
+                      const BooleanCookieCallback& callback);
+  void GetCookieAsync(const GURL& host, const StringCookieCallback& callback);
+  void RemoveSessionCookieAsync(const IntCookieCallback& callback);
+  void RemoveAllCookieAsync(const IntCookieCallback& callback);
+  void FlushCookieStoreAsync(const base::Closure& callback);
+  void HasCookiesAsync(const BooleanCookieCallback& callback);
+
+  // Batches handled in a single trip to the FILE thread. |callback| gets the
+  // number of cookies set, and the cookies of each host respectively.
+  void SetCookiesAsync(const std::vector<GURL>& hosts,
+                       const std::vector<std::string>& cookie_values,
+                       const IntCookieCallback& callback);
+  void GetCookiesAsync(const std::vector<GURL>& hosts,
+                       const StringsCookieCallback& callback);
   void SetAcceptFileSchemeCookies(bool accept);
 
  private:
@@ -95,6 +187,15 @@ class CookieManager {
                            bool* result,
                            const CookieList& cookies);
 
+  // Runs a closure on the FILE thread, without waiting for it.
+  void PostCookieTask(const base::Closure& task);
+
+  void SetCookiesAsyncHelper(const std::vector<GURL>& hosts,
+                             const std::vector<std::string>& cookie_values,
+                             const IntCookieCallback& callback);
+  void GetCookiesAsyncHelper(const std::vector<GURL>& hosts,
+                             const StringsCookieCallback& callback);
+
   scoped_refptr<net::CookieMonster> cookie_monster_;
 
   DISALLOW_COPY_AND_ASSIGN(CookieManager);
@@ -285,6 +386,101 @@ void CookieManager::HasCookiesCompleted(base::WaitableEvent* completion,
   completion->Signal();
 }
 
+void CookieManager::PostCookieTask(const base::Closure& task) {
+  DCHECK(cookie_monster_.get());
+  BrowserThread::PostTask(BrowserThread::FILE, FROM_HERE, task);
+}
+
+void CookieManager::SetCookieAsync(const GURL& host,
+                                   const std::string& cookie_value,
+                                   const BooleanCookieCallback& callback) {
+  PostCookieTask(base::Bind(&CookieMonster::SetCookieWithOptionsAsync,
+                            cookie_monster_, host, cookie_value,
+                            GetCookieOptions(), callback));
+}
+
+void CookieManager::GetCookieAsync(const GURL& host,
+                                   const StringCookieCallback& callback) {
+  PostCookieTask(base::Bind(&CookieMonster::GetCookiesWithOptionsAsync,
+                            cookie_monster_, host, GetCookieOptions(),
+                            callback));
+}
+
+void CookieManager::RemoveSessionCookieAsync(
+    const IntCookieCallback& callback) {
+  PostCookieTask(base::Bind(&CookieMonster::DeleteSessionCookiesAsync,
+                            cookie_monster_, callback));
+}
+
+void CookieManager::RemoveAllCookieAsync(const IntCookieCallback& callback) {
+  PostCookieTask(base::Bind(&CookieMonster::DeleteAllAsync,
+                            cookie_monster_, callback));
+}
+
+void CookieManager::FlushCookieStoreAsync(const base::Closure& callback) {
+  PostCookieTask(base::Bind(&CookieMonster::FlushStore,
+                            cookie_monster_, callback));
+}
+
+void CookieManager::HasCookiesAsync(const BooleanCookieCallback& callback) {
+  PostCookieTask(base::Bind(&CookieMonster::GetAllCookiesAsync,
+                            cookie_monster_,
+                            base::Bind(&RunHasCookiesCallback, callback)));
+}
+
+void CookieManager::SetCookiesAsync(
+    const std::vector<GURL>& hosts,
+    const std::vector<std::string>& cookie_values,
+    const IntCookieCallback& callback) {
+  DCHECK_EQ(hosts.size(), cookie_values.size());
+  PostCookieTask(base::Bind(&CookieManager::SetCookiesAsyncHelper,
+                            base::Unretained(this),
+                            hosts, cookie_values, callback));
+}
+
+void CookieManager::SetCookiesAsyncHelper(
+    const std::vector<GURL>& hosts,
+    const std::vector<std::string>& cookie_values,
+    const IntCookieCallback& callback) {
+  if (hosts.empty()) {
+    callback.Run(0);
+    return;
+  }
+
+  scoped_refptr<SetCookiesBatch> batch(
+      new SetCookiesBatch(hosts.size(), callback));
+  net::CookieOptions options = GetCookieOptions();
+  for (size_t i = 0; i < hosts.size(); ++i) {
+    cookie_monster_->SetCookieWithOptionsAsync(
+        hosts[i], cookie_values[i], options,
+        base::Bind(&SetCookiesBatch::OnCookieSet, batch));
+  }
+}
+
+void CookieManager::GetCookiesAsync(const std::vector<GURL>& hosts,
+                                    const StringsCookieCallback& callback) {
+  PostCookieTask(base::Bind(&CookieManager::GetCookiesAsyncHelper,
+                            base::Unretained(this), hosts, callback));
+}
+
+void CookieManager::GetCookiesAsyncHelper(
+    const std::vector<GURL>& hosts,
+    const StringsCookieCallback& callback) {
+  if (hosts.empty()) {
+    callback.Run(std::vector<std::string>());
+    return;
+  }
+
+  scoped_refptr<GetCookiesBatch> batch(
+      new GetCookiesBatch(hosts.size(), callback));
+  net::CookieOptions options = GetCookieOptions();
+  for (size_t i = 0; i < hosts.size(); ++i) {
+    cookie_monster_->GetCookiesWithOptionsAsync(
+        hosts[i], options,
+        base::Bind(&GetCookiesBatch::OnCookiesGot, batch, i));
+  }
+}
+
 bool CookieManager::AllowFileSchemeCookies() {
   return cookie_monster_->IsCookieableScheme(url::kFileScheme);
 }
@@ -300,6 +496,56 @@ void CookieManager::SetAcceptFileSchemeCookies(bool accept) {
   cookie_monster_->SetEnableFileScheme(accept);
 }
 
+// The Java callbacks are run on the FILE thread, XWalkCookieManager posts
+// them back to the thread of the caller.
+void RunBooleanCookieCallback(const ScopedJavaGlobalRef<jobject>& callback,
+                              bool result) {
+  Java_XWalkCookieManager_invokeBooleanCookieCallback(
+      AttachCurrentThread(), callback.obj(), result);
+}
+
+void RunIntCookieCallback(const ScopedJavaGlobalRef<jobject>& callback,
+                          int result) {
+  Java_XWalkCookieManager_invokeIntCookieCallback(
+      AttachCurrentThread(), callback.obj(), result);
+}
+
+void RunStringCookieCallback(const ScopedJavaGlobalRef<jobject>& callback,
+                             const std::string& result) {
+  JNIEnv* env = AttachCurrentThread();
+  Java_XWalkCookieManager_invokeStringCookieCallback(
+      env, callback.obj(),
+      base::android::ConvertUTF8ToJavaString(env, result).obj());
+}
+
+void RunStringsCookieCallback(const ScopedJavaGlobalRef<jobject>& callback,
+                              const std::vector<std::string>& result) {
+  JNIEnv* env = AttachCurrentThread();
+  Java_XWalkCookieManager_invokeStringsCookieCallback(
+      env, callback.obj(),
+      base::android::ToJavaArrayOfStrings(env, result).obj());
+}
+
+void RunCookieCallback(const ScopedJavaGlobalRef<jobject>& callback) {
+  Java_XWalkCookieManager_invokeCookieCallback(
+      AttachCurrentThread(), callback.obj());
+}
+
+ScopedJavaGlobalRef<jobject> WrapCallback(JNIEnv* env, jobject callback) {
+  ScopedJavaGlobalRef<jobject> global_callback;
+  global_callback.Reset(env, callback);
+  return global_callback;
+}
+
+std::vector<GURL> ToURLs(JNIEnv* env, jobjectArray urls) {
+  std::vector<base::string16> specs;
+  base::android::AppendJavaStringArrayToStringVector(env, urls, &specs);
+  std::vector<GURL> result;
+  for (size_t i = 0; i < specs.size(); ++i)
+    result.push_back(GURL(specs[i]));
+  return result;
+}
+
 }  // namespace
 
 static void SetAcceptCookie(JNIEnv* env, jobject obj, jboolean accept) {
@@ -354,6 +600,60 @@ static void SetAcceptFileSchemeCookies(JNIEnv* env, jobject obj,
   return CookieManager::GetInstance()->SetAcceptFileSchemeCookies(accept);
 }
 
+static void SetCookieAsync(JNIEnv* env, jobject obj, jstring url,
+                           jstring value, jobject callback) {
+  CookieManager::GetInstance()->SetCookieAsync(
+      GURL(ConvertJavaStringToUTF16(env, url)),
+      ConvertJavaStringToUTF8(env, value),
+      base::Bind(&RunBooleanCookieCallback, WrapCallback(env, callback)));
+}
+
+static void GetCookieAsync(JNIEnv* env, jobject obj, jstring url,
+                           jobject callback) {
+  CookieManager::GetInstance()->GetCookieAsync(
+      GURL(ConvertJavaStringToUTF16(env, url)),
+      base::Bind(&RunStringCookieCallback, WrapCallback(env, callback)));
+}
+
+static void SetCookiesAsync(JNIEnv* env, jobject obj, jobjectArray urls,
+                            jobjectArray values, jobject callback) {
+  std::vector<std::string> cookie_values;
+  base::android::AppendJavaStringArrayToStringVector(
+      env, values, &cookie_values);
+  CookieManager::GetInstance()->SetCookiesAsync(
+      ToURLs(env, urls), cookie_values,
+      base::Bind(&RunIntCookieCallback, WrapCallback(env, callback)));
+}
+
+static void GetCookiesAsync(JNIEnv* env, jobject obj, jobjectArray urls,
+                            jobject callback) {
+  CookieManager::GetInstance()->GetCookiesAsync(
+      ToURLs(env, urls),
+      base::Bind(&RunStringsCookieCallback, WrapCallback(env, callback)));
+}
+
+static void RemoveSessionCookieAsync(JNIEnv* env, jobject obj,
+                                     jobject callback) {
+  CookieManager::GetInstance()->RemoveSessionCookieAsync(
+      base::Bind(&RunIntCookieCallback, WrapCallback(env, callback)));
+}
+
+static void RemoveAllCookieAsync(JNIEnv* env, jobject obj, jobject callback) {
+  CookieManager::GetInstance()->RemoveAllCookieAsync(
+      base::Bind(&RunIntCookieCallback, WrapCallback(env, callback)));
+}
+
+static void FlushCookieStoreAsync(JNIEnv* env, jobject obj,
+                                  jobject callback) {
+  CookieManager::GetInstance()->FlushCookieStoreAsync(
+      base::Bind(&RunCookieCallback, WrapCallback(env, callback)));
+}
+
+static void HasCookiesAsync(JNIEnv* env, jobject obj, jobject callback) {
+  CookieManager::GetInstance()->HasCookiesAsync(
+      base::Bind(&RunBooleanCookieCallback, WrapCallback(env, callback)));
+}
+
 void SetCookieMonsterOnNetworkStackInit(net::CookieMonster* cookie_monster) {
   CookieManager::GetInstance()->SetCookieMonster(cookie_monster);
 }
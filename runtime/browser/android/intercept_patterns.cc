@@ -0,0 +1,118 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/intercept_patterns.h"
+
+#include "base/strings/string_util.h"
+#include "base/supports_user_data.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/web_contents.h"
+#include "url/gurl.h"
+
+using content::BrowserThread;
+
+namespace xwalk {
+
+namespace {
+
+const void* kInterceptPatternsUserDataKey = &kInterceptPatternsUserDataKey;
+
+class InterceptPatternsUserData : public base::SupportsUserData::Data {
+ public:
+  InterceptPatternsUserData() : patterns_(new InterceptPatterns) {}
+
+  InterceptPatterns* patterns() const { return patterns_.get(); }
+
+ private:
+  scoped_refptr<InterceptPatterns> patterns_;
+};
+
+int GetResourceTypeMask(ResourceType::Type type) {
+  if (type == ResourceType::MAIN_FRAME)
+    return InterceptPatterns::MAIN_FRAME;
+  if (type == ResourceType::SUB_FRAME)
+    return InterceptPatterns::SUB_FRAME;
+  return InterceptPatterns::SUBRESOURCE;
+}
+
+bool MatchesHost(const std::string& pattern, const std::string& host) {
+  if (pattern.empty() || pattern == host)
+    return true;
+  if (!StartsWithASCII(pattern, "*.", true))
+    return false;
+  // "*.example.com" matches "example.com" too.
+  const std::string domain = pattern.substr(2);
+  return host == domain || EndsWith(host, pattern.substr(1), false);
+}
+
+}  // namespace
+
+base::subtle::Atomic32 InterceptPatterns::skipped_request_count_ = 0;
+
+InterceptPatterns::InterceptPatterns() {
+}
+
+InterceptPatterns::~InterceptPatterns() {
+}
+
+// static
+scoped_refptr<InterceptPatterns> InterceptPatterns::FromWebContents(
+    content::WebContents* web_contents) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  InterceptPatternsUserData* data = static_cast<InterceptPatternsUserData*>(
+      web_contents->GetUserData(kInterceptPatternsUserDataKey));
+  if (!data) {
+    data = new InterceptPatternsUserData;
+    web_contents->SetUserData(kInterceptPatternsUserDataKey, data);
+  }
+  return make_scoped_refptr(data->patterns());
+}
+
+void InterceptPatterns::Add(const std::string& scheme,
+                            const std::string& host,
+                            const std::string& path_prefix,
+                            int resource_types) {
+  Pattern pattern;
+  pattern.scheme = StringToLowerASCII(scheme);
+  pattern.host = StringToLowerASCII(host);
+  pattern.path_prefix = path_prefix;
+  pattern.resource_types = resource_types;
+
+  base::AutoLock lock(lock_);
+  patterns_.push_back(pattern);
+}
+
+void InterceptPatterns::Clear() {
+  base::AutoLock lock(lock_);
+  patterns_.clear();
+}
+
+bool InterceptPatterns::Matches(const GURL& url,
+                                ResourceType::Type type) const {
+  const int type_mask = GetResourceTypeMask(type);
+  {
+    base::AutoLock lock(lock_);
+    if (patterns_.empty())
+      return true;
+
+    for (size_t i = 0; i < patterns_.size(); ++i) {
+      const Pattern& pattern = patterns_[i];
+      if ((pattern.resource_types & type_mask) &&
+          (pattern.scheme.empty() || url.SchemeIs(pattern.scheme.c_str())) &&
+          MatchesHost(pattern.host, url.host()) &&
+          StartsWithASCII(url.path(), pattern.path_prefix, true))
+        return true;
+    }
+  }
+
+  base::subtle::NoBarrier_AtomicIncrement(&skipped_request_count_, 1);
+  return false;
+}
+
+// static
+int InterceptPatterns::GetSkippedRequestCount() {
+  return base::subtle::NoBarrier_Load(&skipped_request_count_);
+}
+
+}  // namespace xwalk
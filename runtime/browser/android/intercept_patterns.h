@@ -0,0 +1,82 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_ANDROID_INTERCEPT_PATTERNS_H_
+#define XWALK_RUNTIME_BROWSER_ANDROID_INTERCEPT_PATTERNS_H_
+
+#include <string>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "webkit/common/resource_type.h"
+
+class GURL;
+
+namespace content {
+class WebContents;
+}
+
+namespace xwalk {
+
+// The requests a view asks shouldInterceptRequest() about, registered with
+// XWalkSettings.addInterceptPattern(). The other requests are loaded without
+// a JNI call. A view without patterns asks about all of its requests.
+//
+// Shared by the frames of a view, updated on the UI thread and matched on
+// the IO thread.
+class InterceptPatterns : public base::RefCountedThreadSafe<InterceptPatterns> {
+ public:
+  // The kinds of resources a pattern applies to, same values as the
+  // XWalkSettings.INTERCEPT_* constants.
+  enum ResourceTypeMask {
+    MAIN_FRAME = 1 << 0,
+    SUB_FRAME = 1 << 1,
+    SUBRESOURCE = 1 << 2,
+  };
+
+  InterceptPatterns();
+
+  // The patterns of |web_contents|, created with it.
+  static scoped_refptr<InterceptPatterns> FromWebContents(
+      content::WebContents* web_contents);
+
+  // An empty |scheme| or |host| matches any, a |host| starting with "*."
+  // also matches its subdomains. |path_prefix| is matched against the start
+  // of the path. |resource_types| is a combination of ResourceTypeMask.
+  void Add(const std::string& scheme, const std::string& host,
+           const std::string& path_prefix, int resource_types);
+  void Clear();
+
+  // Whether the client is to be asked about the request. Counts the
+  // requests it isn't asked about otherwise.
+  bool Matches(const GURL& url, ResourceType::Type type) const;
+
+  // The JNI calls avoided so far by all the views.
+  static int GetSkippedRequestCount();
+
+ private:
+  friend class base::RefCountedThreadSafe<InterceptPatterns>;
+  ~InterceptPatterns();
+
+  struct Pattern {
+    std::string scheme;
+    std::string host;
+    std::string path_prefix;
+    int resource_types;
+  };
+
+  mutable base::Lock lock_;
+  std::vector<Pattern> patterns_;
+
+  static base::subtle::Atomic32 skipped_request_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterceptPatterns);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_ANDROID_INTERCEPT_PATTERNS_H_
@@ -0,0 +1,89 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/intercept_patterns.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace xwalk {
+
+TEST(InterceptPatternsTest, NoPatternsMatchAll) {
+  scoped_refptr<InterceptPatterns> patterns(new InterceptPatterns);
+  const int skipped = InterceptPatterns::GetSkippedRequestCount();
+  EXPECT_TRUE(patterns->Matches(GURL("http://example.com/"),
+                                ResourceType::MAIN_FRAME));
+  EXPECT_TRUE(patterns->Matches(GURL("file:///android_asset/index.html"),
+                                ResourceType::IMAGE));
+  EXPECT_EQ(skipped, InterceptPatterns::GetSkippedRequestCount());
+
+  patterns->Add("http", "example.com", "", InterceptPatterns::MAIN_FRAME);
+  patterns->Clear();
+  EXPECT_TRUE(patterns->Matches(GURL("https://other.org/"),
+                                ResourceType::SCRIPT));
+}
+
+TEST(InterceptPatternsTest, MatchesSchemeHostAndPath) {
+  scoped_refptr<InterceptPatterns> patterns(new InterceptPatterns);
+  patterns->Add("HTTP", "Example.com", "/api/",
+                InterceptPatterns::SUBRESOURCE);
+
+  // The scheme and the host ignore case, the path doesn't.
+  EXPECT_TRUE(patterns->Matches(GURL("http://example.com/api/items"),
+                                ResourceType::XHR));
+  EXPECT_FALSE(patterns->Matches(GURL("http://example.com/API/items"),
+                                 ResourceType::XHR));
+  EXPECT_FALSE(patterns->Matches(GURL("https://example.com/api/items"),
+                                 ResourceType::XHR));
+  EXPECT_FALSE(patterns->Matches(GURL("http://www.example.com/api/items"),
+                                 ResourceType::XHR));
+  EXPECT_FALSE(patterns->Matches(GURL("http://example.com/"),
+                                 ResourceType::XHR));
+}
+
+TEST(InterceptPatternsTest, MatchesWildcardHosts) {
+  scoped_refptr<InterceptPatterns> patterns(new InterceptPatterns);
+  patterns->Add("", "*.example.com", "", InterceptPatterns::SUBRESOURCE);
+  patterns->Add("file", "", "/android_asset/",
+                InterceptPatterns::SUBRESOURCE);
+
+  EXPECT_TRUE(patterns->Matches(GURL("http://example.com/a.js"),
+                                ResourceType::SCRIPT));
+  EXPECT_TRUE(patterns->Matches(GURL("https://cdn.example.com/a.js"),
+                                ResourceType::SCRIPT));
+  EXPECT_TRUE(patterns->Matches(GURL("http://a.b.example.com/a.js"),
+                                ResourceType::SCRIPT));
+  EXPECT_FALSE(patterns->Matches(GURL("http://badexample.com/a.js"),
+                                 ResourceType::SCRIPT));
+  EXPECT_TRUE(patterns->Matches(GURL("file:///android_asset/a.png"),
+                                ResourceType::IMAGE));
+  EXPECT_FALSE(patterns->Matches(GURL("file:///sdcard/a.png"),
+                                 ResourceType::IMAGE));
+}
+
+TEST(InterceptPatternsTest, MatchesResourceTypes) {
+  scoped_refptr<InterceptPatterns> patterns(new InterceptPatterns);
+  patterns->Add("http", "example.com", "",
+                InterceptPatterns::MAIN_FRAME | InterceptPatterns::SUB_FRAME);
+
+  const GURL url("http://example.com/index.html");
+  EXPECT_TRUE(patterns->Matches(url, ResourceType::MAIN_FRAME));
+  EXPECT_TRUE(patterns->Matches(url, ResourceType::SUB_FRAME));
+  EXPECT_FALSE(patterns->Matches(url, ResourceType::STYLESHEET));
+  EXPECT_FALSE(patterns->Matches(url, ResourceType::IMAGE));
+}
+
+TEST(InterceptPatternsTest, CountsSkippedRequests) {
+  scoped_refptr<InterceptPatterns> patterns(new InterceptPatterns);
+  patterns->Add("http", "example.com", "", InterceptPatterns::MAIN_FRAME);
+
+  const int skipped = InterceptPatterns::GetSkippedRequestCount();
+  patterns->Matches(GURL("http://example.com/"), ResourceType::MAIN_FRAME);
+  EXPECT_EQ(skipped, InterceptPatterns::GetSkippedRequestCount());
+  patterns->Matches(GURL("http://other.org/"), ResourceType::MAIN_FRAME);
+  patterns->Matches(GURL("http://example.com/"), ResourceType::IMAGE);
+  EXPECT_EQ(skipped + 2, InterceptPatterns::GetSkippedRequestCount());
+}
+
+}  // namespace xwalk
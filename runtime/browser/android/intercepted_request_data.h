@@ -31,10 +31,17 @@ class InterceptedRequestData {
       net::URLRequest* request,
       net::NetworkDelegate* network_delegate) const = 0;
 
+  // Whether the response is to be stored in InterceptedResponseCache once
+  // read in full.
+  void set_cacheable(bool cacheable) { cacheable_ = cacheable; }
+  bool cacheable() const { return cacheable_; }
+
  protected:
-  InterceptedRequestData() {}
+  InterceptedRequestData() : cacheable_(false) {}
 
  private:
+  bool cacheable_;
+
   DISALLOW_COPY_AND_ASSIGN(InterceptedRequestData);
 };
 
@@ -9,11 +9,15 @@
 #include "base/android/jni_android.h"
 #include "base/android/jni_string.h"
 #include "jni/InterceptedRequestData_jni.h"
+#include "net/base/io_buffer.h"
 #include "net/url_request/url_request.h"
 #include "net/url_request/url_request_job.h"
+#include "url/gurl.h"
+#include "xwalk/runtime/browser/android/intercepted_response_cache.h"
 #include "xwalk/runtime/browser/android/net/android_protocol_handler.h"
 #include "xwalk/runtime/browser/android/net/android_stream_reader_url_request_job.h"
 #include "xwalk/runtime/browser/android/net/input_stream_impl.h"
+#include "xwalk/runtime/browser/android/net/memory_input_stream.h"
 #include "xwalk/runtime/browser/runtime_context.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
 
@@ -23,6 +27,83 @@ namespace xwalk {
 
 namespace {
 
+// Passes the reads of an intercepted response through, keeping a copy which
+// is put in InterceptedResponseCache when the end of the stream is reached.
+class CachingInputStream : public InputStream {
+ public:
+  CachingInputStream(scoped_ptr<InputStream> stream,
+                     const GURL& url,
+                     const std::string& mime_type,
+                     const std::string& charset)
+      : stream_(stream.Pass()),
+        url_(url),
+        mime_type_(mime_type),
+        charset_(charset),
+        caching_(true) {
+  }
+
+  virtual bool BytesAvailable(int* bytes_available) const OVERRIDE {
+    return stream_->BytesAvailable(bytes_available);
+  }
+
+  virtual bool Skip(int64_t n, int64_t* bytes_skipped) OVERRIDE {
+    if (!stream_->Skip(n, bytes_skipped))
+      return false;
+    // A range request, the copy would miss the skipped bytes.
+    if (*bytes_skipped > 0)
+      StopCaching();
+    return true;
+  }
+
+  virtual bool Read(net::IOBuffer* dest, int length, int* bytes_read) OVERRIDE {
+    if (!stream_->Read(dest, length, bytes_read)) {
+      StopCaching();
+      return false;
+    }
+    if (!caching_)
+      return true;
+
+    if (*bytes_read == 0) {
+      InterceptedResponseCache::GetInstance()->Put(
+          url_, new InterceptedResponse(mime_type_, charset_, &data_));
+      StopCaching();
+    } else if (data_.size() + *bytes_read >
+               InterceptedResponseCache::kMaxResponseSize) {
+      StopCaching();
+    } else {
+      data_.append(dest->data(), *bytes_read);
+    }
+    return true;
+  }
+
+ private:
+  void StopCaching() {
+    caching_ = false;
+    std::string().swap(data_);
+  }
+
+  scoped_ptr<InputStream> stream_;
+  const GURL url_;
+  const std::string mime_type_;
+  const std::string charset_;
+  bool caching_;
+  std::string data_;
+
+  DISALLOW_COPY_AND_ASSIGN(CachingInputStream);
+};
+
+net::URLRequestJob* CreateStreamReaderJob(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate,
+    scoped_ptr<AndroidStreamReaderURLRequestJob::Delegate> delegate) {
+  RuntimeContext* runtime_context =
+      XWalkRunner::GetInstance()->runtime_context();
+  std::string content_security_policy = runtime_context->GetCSPString();
+
+  return new AndroidStreamReaderURLRequestJob(
+      request, network_delegate, delegate.Pass(), content_security_policy);
+}
+
 class StreamReaderJobDelegateImpl
     : public AndroidStreamReaderURLRequestJob::Delegate {
  public:
@@ -35,7 +116,17 @@ class StreamReaderJobDelegateImpl
     virtual scoped_ptr<InputStream> OpenInputStream(
         JNIEnv* env,
         const GURL& url) OVERRIDE {
-      return intercepted_request_data_impl_->GetInputStream(env).Pass();
+      scoped_ptr<InputStream> stream =
+          intercepted_request_data_impl_->GetInputStream(env);
+      if (!stream || !intercepted_request_data_impl_->cacheable())
+        return stream.Pass();
+
+      std::string mime_type;
+      std::string charset;
+      intercepted_request_data_impl_->GetMimeType(env, &mime_type);
+      intercepted_request_data_impl_->GetCharset(env, &charset);
+      return make_scoped_ptr<InputStream>(
+          new CachingInputStream(stream.Pass(), url, mime_type, charset));
     }
 
     virtual void OnInputStreamOpenFailed(net::URLRequest* request,
@@ -66,6 +157,56 @@ class StreamReaderJobDelegateImpl
     const InterceptedRequestDataImpl* intercepted_request_data_impl_;
 };
 
+class CachedResponseJobDelegate
+    : public AndroidStreamReaderURLRequestJob::Delegate {
+ public:
+  explicit CachedResponseJobDelegate(
+      const scoped_refptr<InterceptedResponse>& response)
+      : response_(response) {
+    DCHECK(response_);
+  }
+
+  virtual scoped_ptr<InputStream> OpenInputStream(
+      JNIEnv* env,
+      const GURL& url) OVERRIDE {
+    return make_scoped_ptr<InputStream>(
+        new MemoryInputStream(response_->data()));
+  }
+
+  virtual void OnInputStreamOpenFailed(net::URLRequest* request,
+                                       bool* restart) OVERRIDE {
+    *restart = false;
+  }
+
+  virtual bool GetMimeType(JNIEnv* env,
+                           net::URLRequest* request,
+                           xwalk::InputStream* stream,
+                           std::string* mime_type) OVERRIDE {
+    if (response_->mime_type().empty())
+      return false;
+    *mime_type = response_->mime_type();
+    return true;
+  }
+
+  virtual bool GetCharset(JNIEnv* env,
+                          net::URLRequest* request,
+                          xwalk::InputStream* stream,
+                          std::string* charset) OVERRIDE {
+    if (response_->charset().empty())
+      return false;
+    *charset = response_->charset();
+    return true;
+  }
+
+  virtual bool GetPackageName(JNIEnv* env,
+                              std::string* name) OVERRIDE {
+    return false;
+  }
+
+ private:
+  scoped_refptr<InterceptedResponse> response_;
+};
+
 }  // namespace
 
 InterceptedRequestDataImpl::InterceptedRequestDataImpl(
@@ -120,14 +261,25 @@ net::URLRequestJob* InterceptedRequestDataImpl::CreateJobFor(
     net::NetworkDelegate* network_delegate) const {
   scoped_ptr<AndroidStreamReaderURLRequestJob::Delegate>
       stream_reader_job_delegate_impl(new StreamReaderJobDelegateImpl(this));
+  return CreateStreamReaderJob(
+      request, network_delegate, stream_reader_job_delegate_impl.Pass());
+}
 
-  RuntimeContext* runtime_context =
-      XWalkRunner::GetInstance()->runtime_context();
-  std::string content_security_policy = runtime_context->GetCSPString();
+CachedInterceptedRequestData::CachedInterceptedRequestData(
+    const scoped_refptr<InterceptedResponse>& response)
+    : response_(response) {
+}
 
-  return new AndroidStreamReaderURLRequestJob(
-      request, network_delegate, stream_reader_job_delegate_impl.Pass(),
-      content_security_policy);
+CachedInterceptedRequestData::~CachedInterceptedRequestData() {
+}
+
+net::URLRequestJob* CachedInterceptedRequestData::CreateJobFor(
+    net::URLRequest* request,
+    net::NetworkDelegate* network_delegate) const {
+  return CreateStreamReaderJob(
+      request, network_delegate,
+      make_scoped_ptr<AndroidStreamReaderURLRequestJob::Delegate>(
+          new CachedResponseJobDelegate(response_)));
 }
 
 }  // namespace xwalk
@@ -11,11 +11,13 @@
 
 #include "base/android/scoped_java_ref.h"
 #include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 
 namespace xwalk {
 
 class InputStream;
+class InterceptedResponse;
 
 class InterceptedRequestDataImpl : public InterceptedRequestData {
  public:
@@ -38,6 +40,23 @@ class InterceptedRequestDataImpl : public InterceptedRequestData {
   DISALLOW_COPY_AND_ASSIGN(InterceptedRequestDataImpl);
 };
 
+// Serves a response from InterceptedResponseCache, without calling into Java.
+class CachedInterceptedRequestData : public InterceptedRequestData {
+ public:
+  explicit CachedInterceptedRequestData(
+      const scoped_refptr<InterceptedResponse>& response);
+  virtual ~CachedInterceptedRequestData();
+
+  virtual net::URLRequestJob* CreateJobFor(
+      net::URLRequest* request,
+      net::NetworkDelegate* network_delegate) const OVERRIDE;
+
+ private:
+  scoped_refptr<InterceptedResponse> response_;
+
+  DISALLOW_COPY_AND_ASSIGN(CachedInterceptedRequestData);
+};
+
 bool RegisterInterceptedRequestData(JNIEnv* env);
 
 }  // namespace xwalk
@@ -0,0 +1,103 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/intercepted_response_cache.h"
+
+#include "base/logging.h"
+#include "url/gurl.h"
+
+namespace xwalk {
+
+namespace {
+
+base::LazyInstance<InterceptedResponseCache>::Leaky
+    g_intercepted_response_cache = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+InterceptedResponse::InterceptedResponse(const std::string& mime_type,
+                                         const std::string& charset,
+                                         std::string* data)
+    : mime_type_(mime_type),
+      charset_(charset),
+      data_(base::RefCountedString::TakeString(data)) {
+}
+
+InterceptedResponse::~InterceptedResponse() {
+}
+
+size_t InterceptedResponse::size() const {
+  return mime_type_.size() + charset_.size() + data_->size();
+}
+
+const size_t InterceptedResponseCache::kMaxSize;
+const size_t InterceptedResponseCache::kMaxResponseSize;
+
+InterceptedResponseCache::InterceptedResponseCache()
+    : responses_(ResponseMap::NO_AUTO_EVICT),
+      size_(0) {
+}
+
+InterceptedResponseCache::~InterceptedResponseCache() {
+}
+
+// static
+InterceptedResponseCache* InterceptedResponseCache::GetInstance() {
+  return g_intercepted_response_cache.Pointer();
+}
+
+scoped_refptr<InterceptedResponse> InterceptedResponseCache::Get(
+    const GURL& url) {
+  base::AutoLock lock(lock_);
+  ResponseMap::iterator it = responses_.Get(url.spec());
+  if (it == responses_.end())
+    return NULL;
+  return it->second;
+}
+
+void InterceptedResponseCache::Put(
+    const GURL& url,
+    const scoped_refptr<InterceptedResponse>& response) {
+  DCHECK(response);
+  if (response->size() > kMaxResponseSize)
+    return;
+
+  base::AutoLock lock(lock_);
+  ResponseMap::iterator it = responses_.Peek(url.spec());
+  if (it != responses_.end())
+    Erase(it);
+
+  while (size_ + response->size() > kMaxSize)
+    Erase(responses_.Peek(responses_.rbegin()->first));
+
+  responses_.Put(url.spec(), response);
+  size_ += response->size();
+}
+
+void InterceptedResponseCache::Remove(const GURL& url) {
+  base::AutoLock lock(lock_);
+  ResponseMap::iterator it = responses_.Peek(url.spec());
+  if (it != responses_.end())
+    Erase(it);
+}
+
+void InterceptedResponseCache::Clear() {
+  base::AutoLock lock(lock_);
+  responses_.Clear();
+  size_ = 0;
+}
+
+size_t InterceptedResponseCache::size() const {
+  base::AutoLock lock(lock_);
+  return size_;
+}
+
+void InterceptedResponseCache::Erase(ResponseMap::iterator it) {
+  lock_.AssertAcquired();
+  DCHECK_GE(size_, it->second->size());
+  size_ -= it->second->size();
+  responses_.Erase(it);
+}
+
+}  // namespace xwalk
@@ -0,0 +1,93 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_ANDROID_INTERCEPTED_RESPONSE_CACHE_H_
+#define XWALK_RUNTIME_BROWSER_ANDROID_INTERCEPTED_RESPONSE_CACHE_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/containers/mru_cache.h"
+#include "base/lazy_instance.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/synchronization/lock.h"
+
+class GURL;
+
+namespace xwalk {
+
+// A response given by the client to shouldInterceptRequest(), read in full.
+class InterceptedResponse
+    : public base::RefCountedThreadSafe<InterceptedResponse> {
+ public:
+  // Takes the content of |data|.
+  InterceptedResponse(const std::string& mime_type,
+                      const std::string& charset,
+                      std::string* data);
+
+  const std::string& mime_type() const { return mime_type_; }
+  const std::string& charset() const { return charset_; }
+  base::RefCountedMemory* data() const { return data_.get(); }
+
+  // The memory held by the response.
+  size_t size() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<InterceptedResponse>;
+  ~InterceptedResponse();
+
+  const std::string mime_type_;
+  const std::string charset_;
+  scoped_refptr<base::RefCountedString> data_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterceptedResponse);
+};
+
+// The intercepted responses of the views enabling
+// XWalkSettings.setInterceptedResponseCacheEnabled(), keyed by url and
+// shared between them, so a bundled application served through
+// shouldInterceptRequest() only goes to the client once per resource. The
+// least recently used responses are dropped past kMaxSize bytes. Can be used
+// from any thread.
+class InterceptedResponseCache {
+ public:
+  static const size_t kMaxSize = 8 * 1024 * 1024;
+  // Bigger responses aren't kept, they would evict too many others.
+  static const size_t kMaxResponseSize = kMaxSize / 8;
+
+  static InterceptedResponseCache* GetInstance();
+
+  // Returns NULL on a miss.
+  scoped_refptr<InterceptedResponse> Get(const GURL& url);
+  void Put(const GURL& url, const scoped_refptr<InterceptedResponse>& response);
+
+  // Invalidation, from XWalkSettings.invalidateInterceptedResponseCache().
+  void Remove(const GURL& url);
+  void Clear();
+
+  // The memory held by all the responses.
+  size_t size() const;
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<InterceptedResponseCache>;
+
+  typedef base::MRUCache<std::string, scoped_refptr<InterceptedResponse> >
+      ResponseMap;
+
+  InterceptedResponseCache();
+  ~InterceptedResponseCache();
+
+  void Erase(ResponseMap::iterator it);
+
+  mutable base::Lock lock_;
+  ResponseMap responses_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(InterceptedResponseCache);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_ANDROID_INTERCEPTED_RESPONSE_CACHE_H_
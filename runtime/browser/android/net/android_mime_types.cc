@@ -0,0 +1,61 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/net/android_mime_types.h"
+
+#include "base/files/file_path.h"
+#include "net/base/mime_util.h"
+#include "url/gurl.h"
+
+namespace xwalk {
+
+namespace {
+
+const size_t kDefaultMaxCachedMimeTypes = 512;
+
+}  // namespace
+
+bool GetWellKnownMimeTypeFromUrl(const GURL& url, std::string* mime_type) {
+  base::FilePath::StringType extension =
+      base::FilePath(url.path()).Extension();
+  if (extension.size() < 2)
+    return false;
+  return net::GetWellKnownMimeTypeFromExtension(extension.substr(1),
+                                                mime_type);
+}
+
+MimeTypeCache::MimeTypeCache()
+    : max_size_(kDefaultMaxCachedMimeTypes) {
+}
+
+MimeTypeCache::MimeTypeCache(size_t max_size)
+    : max_size_(max_size) {
+}
+
+MimeTypeCache::~MimeTypeCache() {
+}
+
+bool MimeTypeCache::Get(const std::string& url, std::string* mime_type) const {
+  base::AutoLock lock(lock_);
+  std::map<std::string, std::string>::const_iterator it =
+      mime_types_.find(url);
+  if (it == mime_types_.end())
+    return false;
+  *mime_type = it->second;
+  return true;
+}
+
+void MimeTypeCache::Set(const std::string& url, const std::string& mime_type) {
+  base::AutoLock lock(lock_);
+  if (mime_types_.size() >= max_size_)
+    mime_types_.clear();
+  mime_types_[url] = mime_type;
+}
+
+size_t MimeTypeCache::size() const {
+  base::AutoLock lock(lock_);
+  return mime_types_.size();
+}
+
+}  // namespace xwalk
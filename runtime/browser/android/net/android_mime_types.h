@@ -0,0 +1,50 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_ANDROID_NET_ANDROID_MIME_TYPES_H_
+#define XWALK_RUNTIME_BROWSER_ANDROID_NET_ANDROID_MIME_TYPES_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/synchronization/lock.h"
+
+class GURL;
+
+namespace xwalk {
+
+// Looks the extension of |url| up in the mime types built in net, which
+// unlike net::GetMimeTypeFromExtension() doesn't ask the platform through
+// JNI.
+bool GetWellKnownMimeTypeFromUrl(const GURL& url, std::string* mime_type);
+
+// The mime types resolved by the Java side, by url. The assets and the
+// resources don't change while the application runs, the content urls are
+// assumed not to either. Used on the IO thread and the workers reading the
+// streams. Dropped as a whole once it holds |max_size| urls.
+class MimeTypeCache {
+ public:
+  // Holds up to 512 urls.
+  MimeTypeCache();
+  explicit MimeTypeCache(size_t max_size);
+  ~MimeTypeCache();
+
+  bool Get(const std::string& url, std::string* mime_type) const;
+  void Set(const std::string& url, const std::string& mime_type);
+
+  size_t size() const;
+
+ private:
+  const size_t max_size_;
+
+  mutable base::Lock lock_;
+  std::map<std::string, std::string> mime_types_;
+
+  DISALLOW_COPY_AND_ASSIGN(MimeTypeCache);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_ANDROID_NET_ANDROID_MIME_TYPES_H_
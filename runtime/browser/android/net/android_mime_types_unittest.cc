@@ -0,0 +1,60 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/net/android_mime_types.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace xwalk {
+
+TEST(AndroidMimeTypesTest, WellKnownMimeTypes) {
+  std::string mime_type;
+  EXPECT_TRUE(GetWellKnownMimeTypeFromUrl(
+      GURL("file:///android_asset/www/index.html"), &mime_type));
+  EXPECT_EQ("text/html", mime_type);
+  EXPECT_TRUE(GetWellKnownMimeTypeFromUrl(
+      GURL("app://app-id/images/logo.png?v=2#top"), &mime_type));
+  EXPECT_EQ("image/png", mime_type);
+  EXPECT_TRUE(GetWellKnownMimeTypeFromUrl(
+      GURL("file:///android_res/raw/style.css"), &mime_type));
+  EXPECT_EQ("text/css", mime_type);
+
+  // Left to the Java side.
+  EXPECT_FALSE(GetWellKnownMimeTypeFromUrl(
+      GURL("content://org.xwalk.test/media/42"), &mime_type));
+  EXPECT_FALSE(GetWellKnownMimeTypeFromUrl(
+      GURL("file:///android_asset/www/data.unknownext"), &mime_type));
+  EXPECT_FALSE(GetWellKnownMimeTypeFromUrl(
+      GURL("file:///android_asset/www/trailing."), &mime_type));
+}
+
+TEST(AndroidMimeTypesTest, MimeTypeCache) {
+  MimeTypeCache cache(2);
+  std::string mime_type;
+  EXPECT_FALSE(cache.Get("content://a/1", &mime_type));
+
+  cache.Set("content://a/1", "image/jpeg");
+  cache.Set("content://a/2", "video/mp4");
+  EXPECT_TRUE(cache.Get("content://a/1", &mime_type));
+  EXPECT_EQ("image/jpeg", mime_type);
+  EXPECT_TRUE(cache.Get("content://a/2", &mime_type));
+  EXPECT_EQ("video/mp4", mime_type);
+
+  // Replacing an entry doesn't grow the cache.
+  cache.Set("content://a/2", "audio/mpeg");
+  EXPECT_TRUE(cache.Get("content://a/2", &mime_type));
+  EXPECT_EQ("audio/mpeg", mime_type);
+
+  // Dropped as a whole once full.
+  cache.Set("content://a/3", "text/plain");
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_FALSE(cache.Get("content://a/1", &mime_type));
+  EXPECT_TRUE(cache.Get("content://a/3", &mime_type));
+  EXPECT_EQ("text/plain", mime_type);
+}
+
+}  // namespace xwalk
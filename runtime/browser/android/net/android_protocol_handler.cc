@@ -9,9 +9,13 @@
 #include "base/android/jni_android.h"
 #include "base/android/jni_string.h"
 #include "base/android/jni_weak_ref.h"
+#include "base/files/file_path.h"
+#include "base/lazy_instance.h"
 #include "base/strings/string_util.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/common/url_constants.h"
 #include "jni/AndroidProtocolHandler_jni.h"
+#include "net/base/escape.h"
 #include "net/base/io_buffer.h"
 #include "net/base/mime_util.h"
 #include "net/base/net_errors.h"
@@ -21,7 +25,10 @@
 #include "net/url_request/url_request_intercepting_job_factory.h"
 #include "net/url_request/url_request_interceptor.h"
 #include "url/gurl.h"
+#include "xwalk/runtime/browser/android/net/android_mime_types.h"
 #include "xwalk/runtime/browser/android/net/android_stream_reader_url_request_job.h"
+#include "xwalk/runtime/browser/android/net/apk_asset_index.h"
+#include "xwalk/runtime/browser/android/net/file_descriptor_input_stream.h"
 #include "xwalk/runtime/browser/android/net/input_stream_impl.h"
 #include "xwalk/runtime/browser/android/net/url_constants.h"
 #include "xwalk/runtime/browser/runtime_context.h"
@@ -32,6 +39,7 @@ using base::android::ClearException;
 using base::android::ConvertUTF8ToJavaString;
 using base::android::ScopedJavaGlobalRef;
 using base::android::ScopedJavaLocalRef;
+using xwalk::ApkAssetIndex;
 using xwalk::InputStream;
 using xwalk::InputStreamImpl;
 
@@ -48,6 +56,10 @@ void ResetResourceContext(JavaObjectWeakGlobalRef* ref) {
   g_resource_context = ref;
 }
 
+// Where the web application lives in the assets for app:// urls, see
+// AndroidProtocolHandler.appUriToFileUri().
+const char kAppAssetDirectory[] = "www";
+
 void* kPreviouslyFailedKey = &kPreviouslyFailedKey;
 
 void MarkRequestAsFailed(net::URLRequest* request) {
@@ -85,6 +97,24 @@ class AndroidStreamReaderURLRequestJobDelegateImpl
                               std::string* name) OVERRIDE;
 
   virtual ~AndroidStreamReaderURLRequestJobDelegateImpl();
+
+ private:
+  // Returns a stream reading the file descriptor backing |url|, or NULL when
+  // the data can only be reached through a Java InputStream.
+  scoped_ptr<InputStream> OpenFileDescriptorInputStream(
+      JNIEnv* env,
+      const ScopedJavaLocalRef<jstring>& jurl);
+
+  // Returns a stream reading a stored asset straight from the APK, or NULL
+  // when the asset isn't in the index or is compressed. Sets |mime_type_|
+  // for all the indexed assets.
+  scoped_ptr<InputStream> OpenIndexedAsset(const GURL& url);
+
+  // Whether OpenInputStream() returned a FileDescriptorInputStream, which has
+  // no Java object to sniff the mime type from.
+  bool opened_file_descriptor_;
+  // The mime type found in the asset index, if any.
+  std::string mime_type_;
 };
 
 class AndroidRequestInterceptorBase : public net::URLRequestInterceptor {
@@ -138,10 +168,89 @@ static ScopedJavaLocalRef<jobject> GetResourceContext(JNIEnv* env) {
   return context;
 }
 
+void BuildApkAssetIndex(scoped_refptr<ApkAssetIndex> index) {
+  JNIEnv* env = AttachCurrentThread();
+  ScopedJavaLocalRef<jstring> apk_path =
+      xwalk::Java_AndroidProtocolHandler_getApkPath(
+          env,
+          GetResourceContext(env).obj());
+  if (ClearException(env) || apk_path.is_null())
+    return;
+  index->Build(
+      base::FilePath(base::android::ConvertJavaStringToUTF8(apk_path)));
+}
+
+// The index of the application APK assets, built in the background once the
+// first asset interceptor is created. Requests coming before this is done,
+// or while a testing resource context is set, go through AssetManager.
+class ApkAssetIndexHolder {
+ public:
+  ApkAssetIndexHolder()
+      : index_(new ApkAssetIndex()) {
+    content::BrowserThread::PostBlockingPoolTask(
+        FROM_HERE, base::Bind(&BuildApkAssetIndex, index_));
+  }
+
+  ApkAssetIndex* index() const { return index_.get(); }
+
+ private:
+  scoped_refptr<ApkAssetIndex> index_;
+};
+
+base::LazyInstance<ApkAssetIndexHolder>::Leaky g_apk_asset_index =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Maps file:///android_asset/ and app:// urls to a path in the assets, the
+// way AndroidProtocolHandler.getAssetPath() and appUriToFileUri() do.
+bool GetAssetPath(const GURL& url, std::string* asset_path) {
+  std::string path = net::UnescapeURLComponent(url.path(),
+      net::UnescapeRule::SPACES | net::UnescapeRule::URL_SPECIAL_CHARS);
+  if (url.SchemeIsFile()) {
+    if (!StartsWithASCII(path, xwalk::kAndroidAssetPath, true))
+      return false;
+    *asset_path = path.substr(strlen(xwalk::kAndroidAssetPath));
+    return true;
+  }
+  if (url.SchemeIs(xwalk::kAppScheme)) {
+    *asset_path = kAppAssetDirectory + path;
+    return true;
+  }
+  return false;
+}
+
+// Returns a stream reading a stored asset straight from the APK, or NULL
+// when the asset isn't in the index or is compressed. Sets |mime_type| for
+// all the indexed assets.
+scoped_ptr<InputStream> OpenIndexedAssetStream(const GURL& url,
+                                               std::string* mime_type) {
+  std::string asset_path;
+  if (g_resource_context || !GetAssetPath(url, &asset_path))
+    return scoped_ptr<InputStream>();
+
+  ApkAssetIndex* index = g_apk_asset_index.Get().index();
+  ApkAssetIndex::Entry entry;
+  if (!index->Lookup(asset_path, &entry))
+    return scoped_ptr<InputStream>();
+
+  *mime_type = entry.mime_type;
+  if (entry.is_compressed())
+    return scoped_ptr<InputStream>();
+
+  int fd = index->DuplicateApkFileDescriptor();
+  if (fd < 0)
+    return scoped_ptr<InputStream>();
+  return make_scoped_ptr<InputStream>(
+      new FileDescriptorInputStream(fd, entry.offset, entry.size));
+}
+
+base::LazyInstance<MimeTypeCache>::Leaky g_mime_type_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 // AndroidStreamReaderURLRequestJobDelegateImpl -------------------------------
 
 AndroidStreamReaderURLRequestJobDelegateImpl::
-    AndroidStreamReaderURLRequestJobDelegateImpl() {}
+    AndroidStreamReaderURLRequestJobDelegateImpl()
+    : opened_file_descriptor_(false) {}
 
 AndroidStreamReaderURLRequestJobDelegateImpl::
 ~AndroidStreamReaderURLRequestJobDelegateImpl() {
@@ -153,9 +262,25 @@ AndroidStreamReaderURLRequestJobDelegateImpl::OpenInputStream(
   DCHECK(url.is_valid());
   DCHECK(env);
 
-  // Open the input stream.
+  // Assets are resolved in the native index of the APK first, which reads
+  // the stored ones without calling into Java at all.
+  scoped_ptr<InputStream> asset_stream = OpenIndexedAsset(url);
+  opened_file_descriptor_ = asset_stream.get() != NULL;
+  if (asset_stream)
+    return asset_stream.Pass();
+
   ScopedJavaLocalRef<jstring> jurl =
       ConvertUTF8ToJavaString(env, url.spec());
+
+  // Uncompressed assets and file backed content are read from their file
+  // descriptor, which saves a JNI round trip for every chunk.
+  scoped_ptr<InputStream> fd_stream =
+      OpenFileDescriptorInputStream(env, jurl);
+  opened_file_descriptor_ = fd_stream.get() != NULL;
+  if (fd_stream)
+    return fd_stream.Pass();
+
+  // Otherwise open a Java input stream.
   ScopedJavaLocalRef<jobject> stream =
       xwalk::Java_AndroidProtocolHandler_open(
           env,
@@ -170,6 +295,35 @@ AndroidStreamReaderURLRequestJobDelegateImpl::OpenInputStream(
   return make_scoped_ptr<InputStream>(new InputStreamImpl(stream));
 }
 
+scoped_ptr<InputStream>
+AndroidStreamReaderURLRequestJobDelegateImpl::OpenFileDescriptorInputStream(
+    JNIEnv* env,
+    const ScopedJavaLocalRef<jstring>& jurl) {
+  ScopedJavaLocalRef<jlongArray> region =
+      xwalk::Java_AndroidProtocolHandler_openFileDescriptor(
+          env,
+          GetResourceContext(env).obj(),
+          jurl.obj());
+  if (ClearException(env) || region.is_null())
+    return scoped_ptr<InputStream>();
+
+  // {fd, offset, length}, see AndroidProtocolHandler.openFileDescriptor().
+  jlong values[3];
+  if (env->GetArrayLength(region.obj()) != arraysize(values)) {
+    NOTREACHED();
+    return scoped_ptr<InputStream>();
+  }
+  env->GetLongArrayRegion(region.obj(), 0, arraysize(values), values);
+  return make_scoped_ptr<InputStream>(new FileDescriptorInputStream(
+      static_cast<int>(values[0]), values[1], values[2]));
+}
+
+scoped_ptr<InputStream>
+AndroidStreamReaderURLRequestJobDelegateImpl::OpenIndexedAsset(
+    const GURL& url) {
+  return OpenIndexedAssetStream(url, &mime_type_);
+}
+
 void AndroidStreamReaderURLRequestJobDelegateImpl::OnInputStreamOpenFailed(
     net::URLRequest* request,
     bool* restart) {
@@ -187,21 +341,34 @@ bool AndroidStreamReaderURLRequestJobDelegateImpl::GetMimeType(
   DCHECK(request);
   DCHECK(mime_type);
 
+  if (!mime_type_.empty()) {
+    *mime_type = mime_type_;
+    return true;
+  }
+
+  const GURL& request_url = request->url();
+  if (GetWellKnownMimeTypeFromUrl(request_url, mime_type) ||
+      g_mime_type_cache.Get().Get(request_url.spec(), mime_type))
+    return true;
+
   // Query the mime type from the Java side. It is possible for the query to
   // fail, as the mime type cannot be determined for all supported schemes.
   ScopedJavaLocalRef<jstring> url =
-      ConvertUTF8ToJavaString(env, request->url().spec());
-  const InputStreamImpl* stream_impl =
-      InputStreamImpl::FromInputStream(stream);
+      ConvertUTF8ToJavaString(env, request_url.spec());
+  // The Java side guesses the type from the url alone without a stream.
+  jobject jstream = NULL;
+  if (!opened_file_descriptor_)
+    jstream = InputStreamImpl::FromInputStream(stream)->jobj();
   ScopedJavaLocalRef<jstring> returned_type =
       xwalk::Java_AndroidProtocolHandler_getMimeType(
           env,
           GetResourceContext(env).obj(),
-          stream_impl->jobj(), url.obj());
+          jstream, url.obj());
   if (ClearException(env) || returned_type.is_null())
     return false;
 
   *mime_type = base::android::ConvertJavaStringToUTF8(returned_type);
+  g_mime_type_cache.Get().Set(request_url.spec(), *mime_type);
   return true;
 }
 
@@ -327,16 +494,50 @@ CreateContentSchemeRequestInterceptor() {
 
 // static
 scoped_ptr<net::URLRequestInterceptor> CreateAssetFileRequestInterceptor() {
+  // Starts indexing the APK assets.
+  g_apk_asset_index.Get();
   return scoped_ptr<net::URLRequestInterceptor>(
       new AssetFileRequestInterceptor());
 }
 
 // static
 scoped_ptr<net::URLRequestInterceptor> CreateAppSchemeRequestInterceptor() {
+  // Starts indexing the APK assets.
+  g_apk_asset_index.Get();
   return make_scoped_ptr<net::URLRequestInterceptor>(
       new AppSchemeRequestInterceptor());
 }
 
+bool ReadAssetContent(const GURL& url, std::string* content) {
+  std::string asset_path;
+  if (!GetAssetPath(url, &asset_path))
+    return false;
+
+  std::string mime_type;
+  scoped_ptr<InputStream> stream = OpenIndexedAssetStream(url, &mime_type);
+  if (!stream) {
+    JNIEnv* env = AttachCurrentThread();
+    ScopedJavaLocalRef<jstring> jurl = ConvertUTF8ToJavaString(env, url.spec());
+    ScopedJavaLocalRef<jobject> java_stream =
+        xwalk::Java_AndroidProtocolHandler_open(
+            env, GetResourceContext(env).obj(), jurl.obj());
+    if (ClearException(env) || java_stream.is_null())
+      return false;
+    stream.reset(new InputStreamImpl(java_stream));
+  }
+
+  const int kBufferSize = 16 * 1024;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kBufferSize));
+  content->clear();
+  int bytes_read = 0;
+  do {
+    if (!stream->Read(buffer.get(), kBufferSize, &bytes_read))
+      return false;
+    content->append(buffer->data(), bytes_read);
+  } while (bytes_read > 0);
+  return true;
+}
+
 
 // Set a context object to be used for resolving resource queries. This can
 // be used to override the default application context and redirect all
@@ -5,9 +5,13 @@
 #ifndef XWALK_RUNTIME_BROWSER_ANDROID_NET_ANDROID_PROTOCOL_HANDLER_H_
 #define XWALK_RUNTIME_BROWSER_ANDROID_NET_ANDROID_PROTOCOL_HANDLER_H_
 
+#include <string>
+
 #include "base/android/jni_android.h"
 #include "base/memory/scoped_ptr.h"
 
+class GURL;
+
 namespace net {
 class URLRequestContext;
 class URLRequestInterceptor;
@@ -33,6 +37,10 @@ scoped_ptr<net::URLRequestInterceptor> CreateAssetFileRequestInterceptor();
 //    It's part of sysapps API, http://app-uri.sysapps.org.
 scoped_ptr<net::URLRequestInterceptor> CreateAppSchemeRequestInterceptor();
 
+// Reads the whole file:///android_asset/ or app:// |url| into |content|,
+// straight from the APK when the asset is stored there. Must be called on a
+// thread allowing IO. Returns false if the asset can't be read.
+bool ReadAssetContent(const GURL& url, std::string* content);
 
 bool RegisterAndroidProtocolHandler(JNIEnv* env);
 
@@ -17,9 +17,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/task_runner.h"
-#include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/thread.h"
-#include "content/public/browser/browser_thread.h"
 #include "net/base/io_buffer.h"
 #include "net/base/mime_util.h"
 #include "net/base/net_errors.h"
@@ -31,11 +29,11 @@
 #include "net/url_request/url_request_job_manager.h"
 #include "xwalk/runtime/browser/android/net/input_stream.h"
 #include "xwalk/runtime/browser/android/net/input_stream_reader.h"
+#include "xwalk/runtime/browser/android/net/stream_reader_thread_pool.h"
 #include "xwalk/runtime/browser/android/net/url_constants.h"
 
 using base::android::AttachCurrentThread;
 using base::PostTaskAndReplyWithResult;
-using content::BrowserThread;
 using xwalk::InputStream;
 using xwalk::InputStreamReader;
 
@@ -270,7 +268,9 @@ void AndroidStreamReaderURLRequestJob::OnReaderReadCompleted(int result) {
 }
 
 base::TaskRunner* AndroidStreamReaderURLRequestJob::GetWorkerThreadRunner() {
-  return static_cast<base::TaskRunner*>(BrowserThread::GetBlockingPool());
+  // Picked up for every task, so a priority change applies to the next read.
+  return StreamReaderThreadPool::GetInstance()->GetTaskRunner(
+      request()->priority());
 }
 
 bool AndroidStreamReaderURLRequestJob::ReadRawData(net::IOBuffer* dest,
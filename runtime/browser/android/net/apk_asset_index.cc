@@ -0,0 +1,246 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/net/apk_asset_index.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/threading/thread_restrictions.h"
+#include "net/base/mime_util.h"
+
+namespace xwalk {
+
+namespace {
+
+const char kAssetsDirectory[] = "assets/";
+
+// Zip format, see the APPNOTE.TXT of PKWARE. APKs don't use ZIP64.
+const uint32 kEndOfCentralDirectorySignature = 0x06054b50;
+const size_t kEndOfCentralDirectorySize = 22;
+const size_t kMaxCommentSize = 0xffff;
+const uint32 kCentralDirectoryEntrySignature = 0x02014b50;
+const size_t kCentralDirectoryEntrySize = 46;
+const uint32 kLocalHeaderSignature = 0x04034b50;
+const size_t kLocalHeaderSize = 30;
+const uint16 kMethodStored = 0;
+const uint16 kFlagEncrypted = 1 << 0;
+
+uint16 ReadUInt16(const char* data) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+  return bytes[0] | (bytes[1] << 8);
+}
+
+uint32 ReadUInt32(const char* data) {
+  return ReadUInt16(data) | (static_cast<uint32>(ReadUInt16(data + 2)) << 16);
+}
+
+bool ReadAt(int fd, int64 offset, size_t size, char* data) {
+  while (size > 0) {
+    ssize_t result = HANDLE_EINTR(pread(fd, data, size, offset));
+    if (result <= 0)
+      return false;
+    data += result;
+    offset += result;
+    size -= result;
+  }
+  return true;
+}
+
+// Stored data starts after the local header, whose extra field may differ
+// from the central directory one (zipalign pads it).
+bool GetStoredDataOffset(int fd, int64 local_header_offset, int64* offset) {
+  char header[kLocalHeaderSize];
+  if (!ReadAt(fd, local_header_offset, sizeof(header), header) ||
+      ReadUInt32(header) != kLocalHeaderSignature)
+    return false;
+  *offset = local_header_offset + kLocalHeaderSize +
+      ReadUInt16(header + 26) + ReadUInt16(header + 28);
+  return true;
+}
+
+typedef base::hash_map<std::string, ApkAssetIndex::Entry> AssetEntryMap;
+
+bool ReadAssetEntries(int fd, AssetEntryMap* entries) {
+  struct stat file_info;
+  if (fstat(fd, &file_info) < 0 ||
+      file_info.st_size < static_cast<off_t>(kEndOfCentralDirectorySize))
+    return false;
+  const int64 file_size = file_info.st_size;
+
+  // The end of central directory record is followed by a comment of up to
+  // 64 KiB, it is searched backwards from the end of the file.
+  const size_t tail_size = static_cast<size_t>(std::min<int64>(
+      file_size, kEndOfCentralDirectorySize + kMaxCommentSize));
+  std::vector<char> tail(tail_size);
+  if (!ReadAt(fd, file_size - tail_size, tail_size, &tail[0]))
+    return false;
+
+  size_t eocd = tail_size - kEndOfCentralDirectorySize + 1;
+  do {
+    --eocd;
+    if (ReadUInt32(&tail[eocd]) == kEndOfCentralDirectorySignature)
+      break;
+  } while (eocd > 0);
+  if (ReadUInt32(&tail[eocd]) != kEndOfCentralDirectorySignature)
+    return false;
+
+  const size_t entry_count = ReadUInt16(&tail[eocd + 10]);
+  const size_t directory_size = ReadUInt32(&tail[eocd + 12]);
+  const int64 directory_offset = ReadUInt32(&tail[eocd + 16]);
+  if (directory_offset + directory_size >
+      static_cast<uint64>(file_size - tail_size + eocd))
+    return false;
+
+  std::vector<char> directory(directory_size);
+  if (directory_size &&
+      !ReadAt(fd, directory_offset, directory_size, &directory[0]))
+    return false;
+
+  const size_t prefix_size = arraysize(kAssetsDirectory) - 1;
+  size_t position = 0;
+  for (size_t i = 0; i < entry_count; ++i) {
+    if (position + kCentralDirectoryEntrySize > directory_size)
+      return false;
+    const char* header = &directory[position];
+    if (ReadUInt32(header) != kCentralDirectoryEntrySignature)
+      return false;
+
+    const uint16 flags = ReadUInt16(header + 8);
+    const uint16 method = ReadUInt16(header + 10);
+    const int64 size = ReadUInt32(header + 24);
+    const size_t name_size = ReadUInt16(header + 28);
+    const size_t extra_size = ReadUInt16(header + 30);
+    const size_t comment_size = ReadUInt16(header + 32);
+    const int64 local_header_offset = ReadUInt32(header + 42);
+
+    const size_t name_position = position + kCentralDirectoryEntrySize;
+    position = name_position + name_size + extra_size + comment_size;
+    if (position > directory_size)
+      return false;
+
+    std::string name(&directory[name_position], name_size);
+    if (!StartsWithASCII(name, kAssetsDirectory, true) ||
+        name.size() == prefix_size || name[name.size() - 1] == '/' ||
+        (flags & kFlagEncrypted))
+      continue;
+
+    ApkAssetIndex::Entry entry;
+    entry.size = size;
+    if (method == kMethodStored &&
+        !GetStoredDataOffset(fd, local_header_offset, &entry.offset))
+      return false;
+    net::GetMimeTypeFromFile(base::FilePath(name), &entry.mime_type);
+    (*entries)[name.substr(prefix_size)] = entry;
+  }
+  return true;
+}
+
+// Rebuilds |path| from its components, so "a//b" and "a/b" give the same key
+// like File.getAbsolutePath() on the Java side. Returns false for paths with
+// "." or ".." components.
+bool GetCanonicalAssetPath(const std::string& path, std::string* canonical) {
+  std::vector<std::string> components;
+  base::SplitString(path, '/', &components);
+
+  std::string result;
+  for (size_t i = 0; i < components.size(); ++i) {
+    if (components[i].empty())
+      continue;
+    if (components[i] == "." || components[i] == "..")
+      return false;
+    if (!result.empty())
+      result += '/';
+    result += components[i];
+  }
+  if (result.empty())
+    return false;
+  canonical->swap(result);
+  return true;
+}
+
+}  // namespace
+
+ApkAssetIndex::Entry::Entry()
+    : offset(-1),
+      size(0) {
+}
+
+ApkAssetIndex::ApkAssetIndex()
+    : apk_fd_(-1),
+      is_built_(false) {
+}
+
+ApkAssetIndex::~ApkAssetIndex() {
+  if (apk_fd_ >= 0 && IGNORE_EINTR(close(apk_fd_)) < 0)
+    DPLOG(ERROR) << "close";
+}
+
+void ApkAssetIndex::Build(const base::FilePath& apk_path) {
+  base::ThreadRestrictions::AssertIOAllowed();
+
+  int fd = HANDLE_EINTR(open(apk_path.value().c_str(), O_RDONLY));
+  if (fd < 0) {
+    LOG(WARNING) << "Can't open " << apk_path.value() << " to index assets";
+    return;
+  }
+
+  EntryMap entries;
+  if (!ReadAssetEntries(fd, &entries)) {
+    LOG(WARNING) << "Can't read the central directory of "
+                 << apk_path.value();
+    IGNORE_EINTR(close(fd));
+    return;
+  }
+
+  base::AutoLock lock(lock_);
+  DCHECK(!is_built_);
+  apk_fd_ = fd;
+  entries_.swap(entries);
+  is_built_ = true;
+}
+
+bool ApkAssetIndex::Lookup(const std::string& asset_path,
+                           Entry* entry) const {
+  std::string canonical_path;
+  if (!GetCanonicalAssetPath(asset_path, &canonical_path))
+    return false;
+
+  base::AutoLock lock(lock_);
+  if (!is_built_)
+    return false;
+
+  EntryMap::const_iterator it = entries_.find(canonical_path);
+  if (it == entries_.end())
+    return false;
+  *entry = it->second;
+  return true;
+}
+
+int ApkAssetIndex::DuplicateApkFileDescriptor() const {
+  base::AutoLock lock(lock_);
+  if (apk_fd_ < 0)
+    return -1;
+  return dup(apk_fd_);
+}
+
+bool ApkAssetIndex::is_built() const {
+  base::AutoLock lock(lock_);
+  return is_built_;
+}
+
+size_t ApkAssetIndex::size() const {
+  base::AutoLock lock(lock_);
+  return entries_.size();
+}
+
+}  // namespace xwalk
@@ -0,0 +1,74 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_ANDROID_NET_APK_ASSET_INDEX_H_
+#define XWALK_RUNTIME_BROWSER_ANDROID_NET_APK_ASSET_INDEX_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+
+namespace xwalk {
+
+// The entries of the assets directory of the APK, read once from the zip
+// central directory, so file:///android_asset/ and app:// requests can be
+// resolved without calling AssetManager through JNI. Stored (uncompressed)
+// entries are read directly from the APK file; compressed ones still need
+// AssetManager to be inflated. Built once from a thread allowing IO, then
+// looked up from any thread.
+//
+// A miss doesn't mean the asset doesn't exist (e.g. the index isn't built
+// yet or the path isn't in its canonical form), callers should fallback to
+// AssetManager in that case.
+class ApkAssetIndex : public base::RefCountedThreadSafe<ApkAssetIndex> {
+ public:
+  struct Entry {
+    Entry();
+
+    bool is_compressed() const { return offset < 0; }
+
+    // Where the data of a stored entry starts in the APK, -1 if compressed.
+    int64 offset;
+    // The uncompressed size.
+    int64 size;
+    std::string mime_type;
+  };
+
+  ApkAssetIndex();
+
+  // Reads the central directory of the APK at |apk_path|. Must be called on
+  // a thread allowing IO. The index stays unbuilt if the APK can't be parsed.
+  void Build(const base::FilePath& apk_path);
+
+  // |asset_path| is relative to the assets directory, e.g. "www/index.html".
+  bool Lookup(const std::string& asset_path, Entry* entry) const;
+
+  // Returns a new descriptor of the APK file to read stored entries from,
+  // owned by the caller, or -1 on error.
+  int DuplicateApkFileDescriptor() const;
+
+  bool is_built() const;
+  size_t size() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<ApkAssetIndex>;
+  ~ApkAssetIndex();
+
+  typedef base::hash_map<std::string, Entry> EntryMap;
+
+  mutable base::Lock lock_;
+  int apk_fd_;
+  EntryMap entries_;
+  bool is_built_;
+
+  DISALLOW_COPY_AND_ASSIGN(ApkAssetIndex);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_ANDROID_NET_APK_ASSET_INDEX_H_
@@ -0,0 +1,189 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/net/apk_asset_index.h"
+
+#include <unistd.h>
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace xwalk {
+
+namespace {
+
+const uint16 kMethodStored = 0;
+const uint16 kMethodDeflated = 8;
+const uint16 kFlagEncrypted = 1;
+
+void AppendUInt16(uint16 value, std::string* data) {
+  data->append(1, static_cast<char>(value & 0xff));
+  data->append(1, static_cast<char>(value >> 8));
+}
+
+void AppendUInt32(uint32 value, std::string* data) {
+  AppendUInt16(value & 0xffff, data);
+  AppendUInt16(value >> 16, data);
+}
+
+// Writes zip archives the way APKs are laid out, the content of the
+// entries is never inflated by the index so it's kept as is.
+class ZipBuilder {
+ public:
+  ZipBuilder() : entry_count_(0) {}
+
+  // |local_extra_size| only pads the local header, as zipalign does.
+  void AddEntry(const std::string& name,
+                const std::string& content,
+                uint16 method,
+                uint16 flags,
+                size_t local_extra_size) {
+    const uint32 local_header_offset = data_.size();
+    AppendUInt32(0x04034b50, &data_);
+    AppendUInt16(10, &data_);  // Version needed.
+    AppendUInt16(flags, &data_);
+    AppendUInt16(method, &data_);
+    AppendUInt32(0, &data_);  // Time and date.
+    AppendUInt32(0, &data_);  // CRC-32, not checked.
+    AppendUInt32(content.size(), &data_);
+    AppendUInt32(content.size(), &data_);
+    AppendUInt16(name.size(), &data_);
+    AppendUInt16(local_extra_size, &data_);
+    data_.append(name);
+    data_.append(local_extra_size, '\0');
+    data_.append(content);
+
+    AppendUInt32(0x02014b50, &directory_);
+    AppendUInt16(10, &directory_);  // Version made by.
+    AppendUInt16(10, &directory_);  // Version needed.
+    AppendUInt16(flags, &directory_);
+    AppendUInt16(method, &directory_);
+    AppendUInt32(0, &directory_);  // Time and date.
+    AppendUInt32(0, &directory_);  // CRC-32.
+    AppendUInt32(content.size(), &directory_);
+    AppendUInt32(content.size(), &directory_);
+    AppendUInt16(name.size(), &directory_);
+    AppendUInt16(0, &directory_);  // Extra field.
+    AppendUInt16(0, &directory_);  // Comment.
+    AppendUInt16(0, &directory_);  // Disk number.
+    AppendUInt16(0, &directory_);  // Internal attributes.
+    AppendUInt32(0, &directory_);  // External attributes.
+    AppendUInt32(local_header_offset, &directory_);
+    directory_.append(name);
+    ++entry_count_;
+  }
+
+  std::string Build(const std::string& comment) const {
+    std::string zip = data_ + directory_;
+    AppendUInt32(0x06054b50, &zip);
+    AppendUInt16(0, &zip);  // Disk number.
+    AppendUInt16(0, &zip);  // Disk of the central directory.
+    AppendUInt16(entry_count_, &zip);
+    AppendUInt16(entry_count_, &zip);
+    AppendUInt32(directory_.size(), &zip);
+    AppendUInt32(data_.size(), &zip);
+    AppendUInt16(comment.size(), &zip);
+    zip.append(comment);
+    return zip;
+  }
+
+ private:
+  std::string data_;
+  std::string directory_;
+  uint16 entry_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZipBuilder);
+};
+
+class ApkAssetIndexTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    apk_path_ = temp_dir_.path().AppendASCII("test.apk");
+  }
+
+  void WriteApk(const std::string& data) {
+    ASSERT_EQ(static_cast<int>(data.size()),
+              base::WriteFile(apk_path_, data.data(), data.size()));
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath apk_path_;
+};
+
+}  // namespace
+
+TEST_F(ApkAssetIndexTest, IndexesAssets) {
+  const std::string html = "<html></html>";
+  ZipBuilder builder;
+  builder.AddEntry("classes.dex", "dex", kMethodDeflated, 0, 0);
+  builder.AddEntry("assets/www/", "", kMethodStored, 0, 0);
+  builder.AddEntry("assets/www/index.html", html, kMethodStored, 0, 3);
+  builder.AddEntry("assets/www/app.js", "deflated", kMethodDeflated, 0, 0);
+  builder.AddEntry("assets/secret.txt", "", kMethodStored, kFlagEncrypted, 0);
+  // Signed APKs may carry a comment after the central directory.
+  const std::string apk = builder.Build("signature");
+  WriteApk(apk);
+
+  scoped_refptr<ApkAssetIndex> index(new ApkAssetIndex);
+  index->Build(apk_path_);
+  ASSERT_TRUE(index->is_built());
+  // Directories, encrypted entries and what's outside assets/ are left out.
+  EXPECT_EQ(2u, index->size());
+
+  ApkAssetIndex::Entry entry;
+  ASSERT_TRUE(index->Lookup("www/index.html", &entry));
+  EXPECT_FALSE(entry.is_compressed());
+  EXPECT_EQ(static_cast<int64>(html.size()), entry.size);
+  EXPECT_EQ("text/html", entry.mime_type);
+  // The offset skips the padding of the local header.
+  EXPECT_EQ(html, apk.substr(entry.offset, entry.size));
+
+  ASSERT_TRUE(index->Lookup("www/app.js", &entry));
+  EXPECT_TRUE(entry.is_compressed());
+  EXPECT_EQ(8, entry.size);
+
+  // Paths are looked up in their canonical form.
+  EXPECT_TRUE(index->Lookup("/www//index.html", &entry));
+  EXPECT_FALSE(index->Lookup("www/../www/index.html", &entry));
+  EXPECT_FALSE(index->Lookup("www", &entry));
+  EXPECT_FALSE(index->Lookup("secret.txt", &entry));
+  EXPECT_FALSE(index->Lookup("../classes.dex", &entry));
+
+  int fd = index->DuplicateApkFileDescriptor();
+  EXPECT_GE(fd, 0);
+  close(fd);
+}
+
+TEST_F(ApkAssetIndexTest, InvalidApk) {
+  scoped_refptr<ApkAssetIndex> missing(new ApkAssetIndex);
+  missing->Build(apk_path_);
+  EXPECT_FALSE(missing->is_built());
+  EXPECT_EQ(-1, missing->DuplicateApkFileDescriptor());
+
+  ZipBuilder builder;
+  builder.AddEntry("assets/index.html", "<html></html>", kMethodStored, 0, 0);
+  std::string apk = builder.Build("");
+
+  // The central directory claims more than what's before its end record.
+  std::string truncated = apk;
+  truncated.erase(truncated.size() - 30, 8);
+  WriteApk(truncated);
+  scoped_refptr<ApkAssetIndex> index(new ApkAssetIndex);
+  index->Build(apk_path_);
+  EXPECT_FALSE(index->is_built());
+
+  ApkAssetIndex::Entry entry;
+  EXPECT_FALSE(index->Lookup("index.html", &entry));
+
+  WriteApk("Not a zip archive");
+  index = new ApkAssetIndex;
+  index->Build(apk_path_);
+  EXPECT_FALSE(index->is_built());
+}
+
+}  // namespace xwalk
@@ -0,0 +1,89 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/net/file_descriptor_input_stream.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+#include "base/posix/eintr_wrapper.h"
+#include "net/base/io_buffer.h"
+
+namespace xwalk {
+
+FileDescriptorInputStream::FileDescriptorInputStream(int fd,
+                                                     int64_t offset,
+                                                     int64_t length)
+    : fd_(fd),
+      position_(offset),
+      end_(length < 0 ? -1 : offset + length) {
+  DCHECK_GE(fd_, 0);
+  DCHECK_GE(offset, 0);
+}
+
+FileDescriptorInputStream::~FileDescriptorInputStream() {
+  if (IGNORE_EINTR(close(fd_)) < 0)
+    DPLOG(ERROR) << "close";
+}
+
+int64_t FileDescriptorInputStream::GetEnd() const {
+  if (end_ >= 0)
+    return end_;
+
+  struct stat file_info;
+  if (fstat(fd_, &file_info) < 0)
+    return -1;
+  return file_info.st_size;
+}
+
+bool FileDescriptorInputStream::BytesAvailable(int* bytes_available) const {
+  int64_t end = GetEnd();
+  if (end < 0)
+    return false;
+
+  *bytes_available = static_cast<int>(std::min<int64_t>(
+      std::max<int64_t>(end - position_, 0), std::numeric_limits<int>::max()));
+  return true;
+}
+
+bool FileDescriptorInputStream::Skip(int64_t n, int64_t* bytes_skipped) {
+  int64_t end = GetEnd();
+  if (end < 0 || n < 0)
+    return false;
+
+  // Like InputStream.skip(), stops at the end of the stream.
+  *bytes_skipped = std::min(n, std::max<int64_t>(end - position_, 0));
+  position_ += *bytes_skipped;
+  return true;
+}
+
+bool FileDescriptorInputStream::Read(net::IOBuffer* dest,
+                                     int length,
+                                     int* bytes_read) {
+  *bytes_read = 0;
+
+  int64_t read_size = length;
+  if (end_ >= 0)
+    read_size = std::min(read_size, std::max<int64_t>(end_ - position_, 0));
+
+  // Zero bytes read signals the end of the stream.
+  if (read_size == 0)
+    return true;
+
+  ssize_t result = HANDLE_EINTR(pread(fd_, dest->data(), read_size, position_));
+  if (result < 0) {
+    DPLOG(ERROR) << "pread";
+    return false;
+  }
+
+  position_ += result;
+  *bytes_read = static_cast<int>(result);
+  return true;
+}
+
+}  // namespace xwalk
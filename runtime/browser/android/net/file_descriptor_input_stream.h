@@ -0,0 +1,45 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_ANDROID_NET_FILE_DESCRIPTOR_INPUT_STREAM_H_
+#define XWALK_RUNTIME_BROWSER_ANDROID_NET_FILE_DESCRIPTOR_INPUT_STREAM_H_
+
+#include "base/compiler_specific.h"
+#include "xwalk/runtime/browser/android/net/input_stream.h"
+
+namespace xwalk {
+
+// Reads a region of a file descriptor with pread(), without going through
+// JNI for every chunk like InputStreamImpl does. Used when the data of an
+// Android URL is stored as is in a file, which is the case of uncompressed
+// APK assets, which share the fd of the APK, and of content providers backed
+// by files.
+class FileDescriptorInputStream : public InputStream {
+ public:
+  // Takes the ownership of |fd|. The stream starts at |offset| and is
+  // |length| bytes long, or goes up to the end of the file if |length| is
+  // negative.
+  FileDescriptorInputStream(int fd, int64_t offset, int64_t length);
+  virtual ~FileDescriptorInputStream();
+
+  // InputStream implementation.
+  virtual bool BytesAvailable(int* bytes_available) const OVERRIDE;
+  virtual bool Skip(int64_t n, int64_t* bytes_skipped) OVERRIDE;
+  virtual bool Read(net::IOBuffer* dest, int length, int* bytes_read) OVERRIDE;
+
+ private:
+  // Offset of the end of the stream in the file, or -1 on error.
+  int64_t GetEnd() const;
+
+  int fd_;
+  int64_t position_;
+  // Negative until the end of the file.
+  int64_t end_;
+
+  DISALLOW_COPY_AND_ASSIGN(FileDescriptorInputStream);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_ANDROID_NET_FILE_DESCRIPTOR_INPUT_STREAM_H_
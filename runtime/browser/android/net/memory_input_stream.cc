@@ -0,0 +1,52 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/net/memory_input_stream.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+#include "net/base/io_buffer.h"
+
+namespace xwalk {
+
+MemoryInputStream::MemoryInputStream(
+    const scoped_refptr<base::RefCountedMemory>& data)
+    : data_(data),
+      position_(0) {
+  DCHECK(data_);
+}
+
+MemoryInputStream::~MemoryInputStream() {
+}
+
+bool MemoryInputStream::BytesAvailable(int* bytes_available) const {
+  *bytes_available = static_cast<int>(std::min<size_t>(
+      data_->size() - position_, std::numeric_limits<int>::max()));
+  return true;
+}
+
+bool MemoryInputStream::Skip(int64_t n, int64_t* bytes_skipped) {
+  if (n < 0)
+    return false;
+  *bytes_skipped = std::min<int64_t>(n, data_->size() - position_);
+  position_ += *bytes_skipped;
+  return true;
+}
+
+bool MemoryInputStream::Read(net::IOBuffer* dest,
+                             int length,
+                             int* bytes_read) {
+  *bytes_read = static_cast<int>(
+      std::min<size_t>(std::max(length, 0), data_->size() - position_));
+  if (*bytes_read > 0)
+    memcpy(dest->data(), data_->front() + position_, *bytes_read);
+  position_ += *bytes_read;
+  return true;
+}
+
+}  // namespace xwalk
@@ -0,0 +1,35 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_ANDROID_NET_MEMORY_INPUT_STREAM_H_
+#define XWALK_RUNTIME_BROWSER_ANDROID_NET_MEMORY_INPUT_STREAM_H_
+
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "xwalk/runtime/browser/android/net/input_stream.h"
+
+namespace xwalk {
+
+// Reads a buffer already in memory, e.g. a cached intercepted response.
+class MemoryInputStream : public InputStream {
+ public:
+  explicit MemoryInputStream(const scoped_refptr<base::RefCountedMemory>& data);
+  virtual ~MemoryInputStream();
+
+  // InputStream implementation.
+  virtual bool BytesAvailable(int* bytes_available) const OVERRIDE;
+  virtual bool Skip(int64_t n, int64_t* bytes_skipped) OVERRIDE;
+  virtual bool Read(net::IOBuffer* dest, int length, int* bytes_read) OVERRIDE;
+
+ private:
+  scoped_refptr<base::RefCountedMemory> data_;
+  size_t position_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryInputStream);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_ANDROID_NET_MEMORY_INPUT_STREAM_H_
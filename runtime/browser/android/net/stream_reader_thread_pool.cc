@@ -0,0 +1,145 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/net/stream_reader_thread_pool.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task_runner.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
+
+namespace xwalk {
+
+namespace {
+
+// Enough to overlap the reads of a page load without starving the device.
+const int kDefaultThreadCount = 4;
+const int kMaxThreadCount = 16;
+
+size_t GetThreadCount() {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kStreamReaderThreads))
+    return kDefaultThreadCount;
+
+  const std::string value =
+      command_line.GetSwitchValueASCII(switches::kStreamReaderThreads);
+  int count;
+  if (!base::StringToInt(value, &count) || count < 1) {
+    LOG(WARNING) << "Invalid --" << switches::kStreamReaderThreads
+                 << " value: " << value;
+    return kDefaultThreadCount;
+  }
+  return std::min(count, kMaxThreadCount);
+}
+
+base::LazyInstance<StreamReaderThreadPool>::Leaky g_stream_reader_thread_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+class StreamReaderThreadPool::PriorityTaskRunner : public base::TaskRunner {
+ public:
+  PriorityTaskRunner(StreamReaderThreadPool* pool,
+                     net::RequestPriority priority)
+      : pool_(pool),
+        priority_(priority) {
+  }
+
+  // base::TaskRunner implementation.
+  virtual bool PostDelayedTask(const tracked_objects::Location& from_here,
+                               const base::Closure& task,
+                               base::TimeDelta delay) OVERRIDE {
+    if (delay == base::TimeDelta()) {
+      pool_->PostTask(from_here, priority_, task);
+      return true;
+    }
+    // Queued by priority only once the delay is over.
+    return pool_->pool_->PostDelayedTask(
+        from_here,
+        base::Bind(&StreamReaderThreadPool::PostTask, base::Unretained(pool_),
+                   from_here, priority_, task),
+        delay);
+  }
+
+  virtual bool RunsTasksOnCurrentThread() const OVERRIDE {
+    return pool_->pool_->RunsTasksOnCurrentThread();
+  }
+
+ private:
+  virtual ~PriorityTaskRunner() {}
+
+  // The pool is leaked, it outlives its runners.
+  StreamReaderThreadPool* pool_;
+  const net::RequestPriority priority_;
+
+  DISALLOW_COPY_AND_ASSIGN(PriorityTaskRunner);
+};
+
+StreamReaderThreadPool::StreamReaderThreadPool()
+    : thread_count_(GetThreadCount()),
+      pool_(new base::SequencedWorkerPool(thread_count_, "XWalkStreamReader")) {
+  for (int i = 0; i < kPriorityCount; ++i) {
+    task_runners_[i] = new PriorityTaskRunner(
+        this, static_cast<net::RequestPriority>(i));
+  }
+}
+
+StreamReaderThreadPool::~StreamReaderThreadPool() {
+  NOTREACHED();
+}
+
+// static
+StreamReaderThreadPool* StreamReaderThreadPool::GetInstance() {
+  return g_stream_reader_thread_pool.Pointer();
+}
+
+base::TaskRunner* StreamReaderThreadPool::GetTaskRunner(
+    net::RequestPriority priority) {
+  DCHECK_GE(priority, 0);
+  DCHECK_LT(priority, kPriorityCount);
+  return task_runners_[priority].get();
+}
+
+void StreamReaderThreadPool::PostTask(
+    const tracked_objects::Location& from_here,
+    net::RequestPriority priority,
+    const base::Closure& task) {
+  DCHECK_GE(priority, 0);
+  DCHECK_LT(priority, kPriorityCount);
+  {
+    base::AutoLock lock(lock_);
+    pending_tasks_[priority].push_back(task);
+  }
+  // The jobs may still be waiting for their reads when the browser shuts
+  // down, they are dropped with the IO thread.
+  pool_->PostWorkerTaskWithShutdownBehavior(
+      from_here,
+      base::Bind(&StreamReaderThreadPool::RunNextTask, base::Unretained(this)),
+      base::SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+}
+
+void StreamReaderThreadPool::RunNextTask() {
+  base::Closure task;
+  {
+    base::AutoLock lock(lock_);
+    for (int i = kPriorityCount - 1; i >= 0; --i) {
+      if (!pending_tasks_[i].empty()) {
+        task = pending_tasks_[i].front();
+        pending_tasks_[i].pop_front();
+        break;
+      }
+    }
+  }
+  // There is one RunNextTask() posted for every pending task.
+  DCHECK(!task.is_null());
+  task.Run();
+}
+
+}  // namespace xwalk
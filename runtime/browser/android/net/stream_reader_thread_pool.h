@@ -0,0 +1,70 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_ANDROID_NET_STREAM_READER_THREAD_POOL_H_
+#define XWALK_RUNTIME_BROWSER_ANDROID_NET_STREAM_READER_THREAD_POOL_H_
+
+#include <deque>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/lazy_instance.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "net/base/request_priority.h"
+
+namespace base {
+class SequencedWorkerPool;
+class TaskRunner;
+}
+
+namespace xwalk {
+
+// The threads opening and reading the streams of all the
+// AndroidStreamReaderURLRequestJob instances, apart from the browser blocking
+// pool so asset loads don't queue behind cache, cookie and download work.
+// Pending tasks run in the order of the priority of their request, then in
+// posting order, so render-blocking stylesheets and scripts are read before
+// images. The number of threads can be set with --stream-reader-threads.
+class StreamReaderThreadPool {
+ public:
+  static StreamReaderThreadPool* GetInstance();
+
+  // Returns a runner posting to the pool with |priority|. It lives as long
+  // as the process, no reference needs to be kept.
+  base::TaskRunner* GetTaskRunner(net::RequestPriority priority);
+
+  void PostTask(const tracked_objects::Location& from_here,
+                net::RequestPriority priority,
+                const base::Closure& task);
+
+  size_t thread_count() const { return thread_count_; }
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<StreamReaderThreadPool>;
+  class PriorityTaskRunner;
+
+  static const int kPriorityCount = net::MAXIMUM_PRIORITY + 1;
+
+  StreamReaderThreadPool();
+  ~StreamReaderThreadPool();
+
+  // Posted once for every task, runs the most urgent one pending.
+  void RunNextTask();
+
+  const size_t thread_count_;
+  scoped_refptr<base::SequencedWorkerPool> pool_;
+  scoped_refptr<PriorityTaskRunner> task_runners_[kPriorityCount];
+
+  base::Lock lock_;
+  // Indexed by net::RequestPriority.
+  std::deque<base::Closure> pending_tasks_[kPriorityCount];
+
+  DISALLOW_COPY_AND_ASSIGN(StreamReaderThreadPool);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_ANDROID_NET_STREAM_READER_THREAD_POOL_H_
@@ -4,7 +4,11 @@
 
 #include "xwalk/runtime/browser/android/net_disk_cache_remover.h"
 
+#include <vector>
+
+#include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/memory/ref_counted.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/web_contents.h"
@@ -17,60 +21,255 @@
 
 using content::BrowserThread;
 using disk_cache::Backend;
+using disk_cache::Entry;
 using net::CompletionCallback;
 using net::URLRequestContextGetter;
+using xwalk::HttpDiskCacheRemovalCallback;
+using xwalk::HttpDiskCacheRemovalCriteria;
 
 namespace {
-// Everything is called and accessed on the IO thread.
 
-void Noop(int rv) {
-  DCHECK(rv == net::OK);
-}
+// The number of entries examined before the IO thread is given back to the
+// other tasks, when they have to be examined one by one.
+const int kEntriesPerChunk = 32;
 
-void CallDoomAllEntries(Backend** backend, int rv) {
-  DCHECK(rv == net::OK);
-  (*backend)->DoomAllEntries(base::Bind(&Noop));
+// The http cache stores the headers, the body and the metadata of a
+// response in the first three streams of an entry.
+const int kHttpCacheStreams = 3;
+
+void RunRemovalCallback(const HttpDiskCacheRemovalCallback& callback,
+                        int entries_removed) {
+  if (callback.is_null())
+    return;
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                          base::Bind(callback, entries_removed));
 }
 
-void ClearHttpDiskCacheOfContext(URLRequestContextGetter* context_getter) {
-  typedef Backend* BackendPtr;  // Make line below easier to understand.
-  BackendPtr* backend_ptr = new BackendPtr(NULL);
-  CompletionCallback callback(base::Bind(&CallDoomAllEntries,
-                                         base::Owned(backend_ptr)));
+// Removes the entries matching the criteria from the disk caches of the
+// given contexts, one after the other. Deletes itself when done. Everything
+// is called and accessed on the IO thread.
+class HttpDiskCacheRemover {
+ public:
+  HttpDiskCacheRemover(
+      const std::vector<scoped_refptr<URLRequestContextGetter> >& getters,
+      const HttpDiskCacheRemovalCriteria& criteria,
+      const HttpDiskCacheRemovalCallback& progress_callback,
+      const HttpDiskCacheRemovalCallback& completion_callback)
+      : getters_(getters),
+        criteria_(criteria),
+        progress_callback_(progress_callback),
+        completion_callback_(completion_callback),
+        current_getter_(0),
+        backend_(NULL),
+        iter_(NULL),
+        entry_(NULL),
+        entry_count_before_(0),
+        entries_examined_(0),
+        entries_removed_(0) {
+  }
+
+  void Start() {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+    if (current_getter_ == getters_.size()) {
+      RunRemovalCallback(completion_callback_, entries_removed_);
+      delete this;
+      return;
+    }
+
+    backend_ = NULL;
+    net::HttpCache* cache = getters_[current_getter_]->
+        GetURLRequestContext()->http_transaction_factory()->GetCache();
+    if (!cache) {
+      OnContextDone();
+      return;
+    }
+    CompletionCallback callback(base::Bind(
+        &HttpDiskCacheRemover::OnBackendReady, base::Unretained(this)));
+    int rv = cache->GetBackend(&backend_, callback);
+    // If not net::ERR_IO_PENDING, then backend pointer is updated but
+    // callback is not called, so call it explicitly.
+    if (rv != net::ERR_IO_PENDING)
+      callback.Run(rv);
+  }
+
+ private:
+  void OnBackendReady(int rv) {
+    if (rv != net::OK || !backend_) {
+      OnContextDone();
+      return;
+    }
+
+    entry_count_before_ = backend_->GetEntryCount();
+    CompletionCallback callback(base::Bind(
+        &HttpDiskCacheRemover::OnEntriesDoomed, base::Unretained(this)));
+    if (criteria_.RemovesAllEntries()) {
+      rv = backend_->DoomAllEntries(callback);
+    } else if (!criteria_.larger_than) {
+      rv = backend_->DoomEntriesBetween(
+          base::Time(), criteria_.last_used_before, callback);
+    } else {
+      OpenNextEntry();
+      return;
+    }
+    if (rv != net::ERR_IO_PENDING)
+      callback.Run(rv);
+  }
+
+  void OnEntriesDoomed(int rv) {
+    DCHECK(rv == net::OK);
+    int entry_count = backend_->GetEntryCount();
+    if (entry_count_before_ > entry_count)
+      entries_removed_ += entry_count_before_ - entry_count;
+    OnContextDone();
+  }
+
+  void OpenNextEntry() {
+    CompletionCallback callback(base::Bind(
+        &HttpDiskCacheRemover::OnEntryOpened, base::Unretained(this)));
+    int rv = backend_->OpenNextEntry(&iter_, &entry_, callback);
+    if (rv != net::ERR_IO_PENDING)
+      callback.Run(rv);
+  }
+
+  void OnEntryOpened(int rv) {
+    if (rv != net::OK) {
+      backend_->EndEnumeration(&iter_);
+      OnContextDone();
+      return;
+    }
+
+    if (ShouldRemove(entry_)) {
+      entry_->Doom();
+      ++entries_removed_;
+    }
+    entry_->Close();
+    entry_ = NULL;
+
+    if (++entries_examined_ % kEntriesPerChunk) {
+      OpenNextEntry();
+      return;
+    }
+    RunRemovalCallback(progress_callback_, entries_removed_);
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&HttpDiskCacheRemover::OpenNextEntry,
+                   base::Unretained(this)));
+  }
+
+  bool ShouldRemove(Entry* entry) const {
+    if (!criteria_.last_used_before.is_null() &&
+        entry->GetLastUsed() < criteria_.last_used_before)
+      return true;
+    int64 size = 0;
+    for (int i = 0; i < kHttpCacheStreams; ++i)
+      size += entry->GetDataSize(i);
+    return size > criteria_.larger_than;
+  }
+
+  void OnContextDone() {
+    ++current_getter_;
+    if (current_getter_ < getters_.size())
+      RunRemovalCallback(progress_callback_, entries_removed_);
+    Start();
+  }
+
+  std::vector<scoped_refptr<URLRequestContextGetter> > getters_;
+  HttpDiskCacheRemovalCriteria criteria_;
+  HttpDiskCacheRemovalCallback progress_callback_;
+  HttpDiskCacheRemovalCallback completion_callback_;
 
-  int rv = context_getter->GetURLRequestContext()->
-    http_transaction_factory()->GetCache()->GetBackend(backend_ptr, callback);
+  size_t current_getter_;
+  Backend* backend_;
+  void* iter_;
+  Entry* entry_;
+  int entry_count_before_;
+  int entries_examined_;
+  int entries_removed_;
 
-  // If not net::ERR_IO_PENDING, then backend pointer is updated but callback
-  // is not called, so call it explicitly.
-  if (rv != net::ERR_IO_PENDING)
-    callback.Run(net::OK);
+  DISALLOW_COPY_AND_ASSIGN(HttpDiskCacheRemover);
+};
+
+void StartHttpDiskCacheRemover(
+    const std::vector<scoped_refptr<URLRequestContextGetter> >& getters,
+    const HttpDiskCacheRemovalCriteria& criteria,
+    const HttpDiskCacheRemovalCallback& progress_callback,
+    const HttpDiskCacheRemovalCallback& completion_callback) {
+  (new HttpDiskCacheRemover(getters, criteria, progress_callback,
+                            completion_callback))->Start();
 }
 
-void ClearHttpDiskCacheOnIoThread(
+void PostHttpDiskCacheRemoval(
     URLRequestContextGetter* main_context_getter,
-    URLRequestContextGetter* media_context_getter) {
-  ClearHttpDiskCacheOfContext(main_context_getter);
-  ClearHttpDiskCacheOfContext(media_context_getter);
+    URLRequestContextGetter* media_context_getter,
+    const HttpDiskCacheRemovalCriteria& criteria,
+    const HttpDiskCacheRemovalCallback& progress_callback,
+    const HttpDiskCacheRemovalCallback& completion_callback) {
+  // The media context is usually the main one, its cache is only cleared
+  // once then.
+  std::vector<scoped_refptr<URLRequestContextGetter> > getters;
+  getters.push_back(main_context_getter);
+  if (media_context_getter && media_context_getter != main_context_getter)
+    getters.push_back(media_context_getter);
+
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&StartHttpDiskCacheRemover, getters, criteria,
+                 progress_callback, completion_callback));
+}
+
+void EvictHttpDiskCacheEntries(content::BrowserContext* browser_context,
+                               base::TimeDelta max_age) {
+  HttpDiskCacheRemovalCriteria criteria;
+  criteria.last_used_before = base::Time::Now() - max_age;
+  PostHttpDiskCacheRemoval(browser_context->GetRequestContext(),
+                           browser_context->GetMediaRequestContext(),
+                           criteria, HttpDiskCacheRemovalCallback(),
+                           HttpDiskCacheRemovalCallback());
 }
 
 }  // namespace
 
 namespace xwalk {
 
+HttpDiskCacheRemovalCriteria::HttpDiskCacheRemovalCriteria()
+    : larger_than(0) {
+}
+
+bool HttpDiskCacheRemovalCriteria::RemovesAllEntries() const {
+  return last_used_before.is_null() && !larger_than;
+}
+
 void RemoveHttpDiskCache(content::BrowserContext* browser_context,
                         int renderer_child_id) {
-  URLRequestContextGetter* main_context_getter =
-      browser_context->GetRequestContextForRenderProcess(renderer_child_id);
-  URLRequestContextGetter* media_context_getter =
+  RemoveHttpDiskCacheEntries(browser_context, renderer_child_id,
+                             HttpDiskCacheRemovalCriteria(),
+                             HttpDiskCacheRemovalCallback(),
+                             HttpDiskCacheRemovalCallback());
+}
+
+void RemoveHttpDiskCacheEntries(
+    content::BrowserContext* browser_context,
+    int renderer_child_id,
+    const HttpDiskCacheRemovalCriteria& criteria,
+    const HttpDiskCacheRemovalCallback& progress_callback,
+    const HttpDiskCacheRemovalCallback& completion_callback) {
+  PostHttpDiskCacheRemoval(
+      browser_context->GetRequestContextForRenderProcess(renderer_child_id),
       browser_context->GetMediaRequestContextForRenderProcess(
-          renderer_child_id);
+          renderer_child_id),
+      criteria, progress_callback, completion_callback);
+}
 
-  BrowserThread::PostTask(
-      BrowserThread::IO, FROM_HERE,
-      base::Bind(&ClearHttpDiskCacheOnIoThread,
-                 base::Unretained(main_context_getter),
-                 base::Unretained(media_context_getter)));
+void ScheduleHttpDiskCacheEviction(content::BrowserContext* browser_context,
+                                   base::TimeDelta delay,
+                                   base::TimeDelta max_age) {
+  // The request contexts are only looked up then, not to create them during
+  // the startup.
+  BrowserThread::PostDelayedTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&EvictHttpDiskCacheEntries,
+                 base::Unretained(browser_context), max_age),
+      delay);
 }
 
 }  // namespace xwalk
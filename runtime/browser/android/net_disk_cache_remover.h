@@ -5,6 +5,10 @@
 #ifndef XWALK_RUNTIME_BROWSER_ANDROID_NET_DISK_CACHE_REMOVER_H_
 #define XWALK_RUNTIME_BROWSER_ANDROID_NET_DISK_CACHE_REMOVER_H_
 
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/time/time.h"
+
 namespace content {
 
 class BrowserContext;
@@ -13,11 +17,47 @@ class BrowserContext;
 
 namespace xwalk {
 
+// Selects the entries of the http disk cache to remove. An entry is removed
+// if it matches any of the set criteria, all of them are removed if none is.
+struct HttpDiskCacheRemovalCriteria {
+  HttpDiskCacheRemovalCriteria();
+
+  bool RemovesAllEntries() const;
+
+  // Entries last used before this time are removed. Ignored if null.
+  base::Time last_used_before;
+  // Entries holding more than this many bytes are removed. Ignored if 0.
+  int64 larger_than;
+};
+
+// Run on the UI thread with the number of entries removed so far. The
+// progress callback runs after each chunk of entries has been examined, the
+// completion callback once all of them have been.
+typedef base::Callback<void(int entries_removed)> HttpDiskCacheRemovalCallback;
+
 // Clear all http disk cache for this renderer. This method is asynchronous and
 // will noop if a previous call has not finished.
 void RemoveHttpDiskCache(content::BrowserContext* browser_context,
                         int renderer_child_id);
 
+// Removes the entries of the http disk cache of this renderer matching
+// |criteria|. When entries have to be examined one by one, this is done in
+// small chunks so the IO thread is not held for long. The callbacks can be
+// null.
+void RemoveHttpDiskCacheEntries(
+    content::BrowserContext* browser_context,
+    int renderer_child_id,
+    const HttpDiskCacheRemovalCriteria& criteria,
+    const HttpDiskCacheRemovalCallback& progress_callback,
+    const HttpDiskCacheRemovalCallback& completion_callback);
+
+// Removes the entries of the default http disk cache not used for |max_age|,
+// |delay| from now, so it happens after the startup of the application.
+// |browser_context| must outlive the delay.
+void ScheduleHttpDiskCacheEviction(content::BrowserContext* browser_context,
+                                   base::TimeDelta delay,
+                                   base::TimeDelta max_age);
+
 }  // namespace xwalk
 
 #endif  // XWALK_RUNTIME_BROWSER_ANDROID_NET_DISK_CACHE_REMOVER_H_
@@ -5,8 +5,11 @@
 #include "xwalk/runtime/browser/android/renderer_host/xwalk_render_view_host_ext.h"
 
 #include "base/android/scoped_java_ref.h"
-#include "base/callback.h"
+#include "base/bind.h"
+#include "base/json/json_writer.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/values.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/user_metrics.h"
@@ -18,10 +21,22 @@
 
 namespace xwalk {
 
+namespace {
+
+// The scripts queued or running at once. An embedder pushing scripts faster
+// than the page runs them gets its next ones rejected instead of growing the
+// queue, and the IPCs, without bound.
+const size_t kMaxPendingScripts = 256;
+
+const char kNullResult[] = "null";
+
+}  // namespace
+
 XWalkRenderViewHostExt::XWalkRenderViewHostExt(content::WebContents* contents)
     : content::WebContentsObserver(contents),
       has_new_hit_test_data_(false),
-      is_render_view_created_(false) {
+      is_render_view_created_(false),
+      weak_factory_(this) {
 }
 
 XWalkRenderViewHostExt::~XWalkRenderViewHostExt() {}
@@ -39,11 +54,60 @@ void XWalkRenderViewHostExt::DocumentHasImages(DocumentHasImagesResult result) {
                                        this_id));
 }
 
+void XWalkRenderViewHostExt::SetJavaScriptResultsCallback(
+    const JavaScriptResultsCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  javascript_results_callback_ = callback;
+}
+
+bool XWalkRenderViewHostExt::EvaluateJavaScript(
+    int id, const base::string16& script) {
+  DCHECK(CalledOnValidThread());
+  if (queued_scripts_.size() + running_script_ids_.size() >=
+      kMaxPendingScripts) {
+    return false;
+  }
+  queued_script_ids_.push_back(id);
+  queued_scripts_.push_back(script);
+  if (queued_scripts_.size() == 1) {
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&XWalkRenderViewHostExt::SendQueuedScripts,
+                   weak_factory_.GetWeakPtr()));
+  }
+  return true;
+}
+
+void XWalkRenderViewHostExt::SendQueuedScripts() {
+  DCHECK(CalledOnValidThread());
+  std::vector<int> ids;
+  std::vector<base::string16> scripts;
+  ids.swap(queued_script_ids_);
+  scripts.swap(queued_scripts_);
+  content::RenderViewHost* rvh = web_contents()->GetRenderViewHost();
+  if (!rvh || !rvh->IsRenderViewLive()) {
+    // Nothing would run them, their callbacks must not wait forever.
+    if (!javascript_results_callback_.is_null()) {
+      javascript_results_callback_.Run(
+          ids, std::vector<std::string>(ids.size(), kNullResult));
+    }
+    return;
+  }
+  running_script_ids_.insert(ids.begin(), ids.end());
+  Send(new XWalkViewMsg_ExecuteJavaScripts(web_contents()->GetRoutingID(),
+                                           ids, scripts));
+}
+
 void XWalkRenderViewHostExt::ClearCache() {
   DCHECK(CalledOnValidThread());
   Send(new XWalkViewMsg_ClearCache);
 }
 
+void XWalkRenderViewHostExt::TrimMemory(bool purge_script_memory) {
+  DCHECK(CalledOnValidThread());
+  Send(new XWalkViewMsg_TrimMemory(purge_script_memory));
+}
+
 bool XWalkRenderViewHostExt::HasNewHitTestData() const {
   return has_new_hit_test_data_;
 }
@@ -103,6 +167,13 @@ void XWalkRenderViewHostExt::RenderProcessGone(base::TerminationStatus status) {
       ++pending_req) {
     pending_req->second.Run(false);
   }
+
+  std::vector<int> ids(running_script_ids_.begin(), running_script_ids_.end());
+  running_script_ids_.clear();
+  if (!ids.empty() && !javascript_results_callback_.is_null()) {
+    javascript_results_callback_.Run(
+        ids, std::vector<std::string>(ids.size(), kNullResult));
+  }
 }
 
 void XWalkRenderViewHostExt::DidNavigateAnyFrame(
@@ -119,6 +190,8 @@ bool XWalkRenderViewHostExt::OnMessageReceived(const IPC::Message& message) {
   IPC_BEGIN_MESSAGE_MAP(XWalkRenderViewHostExt, message)
     IPC_MESSAGE_HANDLER(XWalkViewHostMsg_DocumentHasImagesResponse,
                         OnDocumentHasImagesResponse)
+    IPC_MESSAGE_HANDLER(XWalkViewHostMsg_JavaScriptResults,
+                        OnJavaScriptResults)
     IPC_MESSAGE_HANDLER(XWalkViewHostMsg_UpdateHitTestData,
                         OnUpdateHitTestData)
     IPC_MESSAGE_HANDLER(XWalkViewHostMsg_PageScaleFactorChanged,
@@ -142,6 +215,27 @@ void XWalkRenderViewHostExt::OnDocumentHasImagesResponse(int msg_id,
   }
 }
 
+void XWalkRenderViewHostExt::OnJavaScriptResults(
+    const std::vector<int>& ids,
+    const base::ListValue& results) {
+  DCHECK(CalledOnValidThread());
+  std::vector<int> answered_ids;
+  std::vector<std::string> json_results;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    // Already answered if the renderer was thought gone.
+    if (!running_script_ids_.erase(ids[i]))
+      continue;
+    std::string json = kNullResult;
+    const base::Value* result = NULL;
+    if (results.Get(i, &result))
+      base::JSONWriter::Write(result, &json);
+    answered_ids.push_back(ids[i]);
+    json_results.push_back(json);
+  }
+  if (!answered_ids.empty() && !javascript_results_callback_.is_null())
+    javascript_results_callback_.Run(answered_ids, json_results);
+}
+
 void XWalkRenderViewHostExt::OnUpdateHitTestData(
     const XWalkHitTestData& hit_test_data) {
   DCHECK(CalledOnValidThread());
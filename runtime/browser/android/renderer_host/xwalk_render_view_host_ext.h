@@ -6,15 +6,23 @@
 #define XWALK_RUNTIME_BROWSER_ANDROID_RENDERER_HOST_XWALK_RENDER_VIEW_HOST_EXT_H_
 
 #include <map>
+#include <set>
 #include <string>
+#include <vector>
 
-#include "base/callback_forward.h"
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/strings/string16.h"
 #include "base/threading/non_thread_safe.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "xwalk/runtime/common/android/xwalk_hit_test_data.h"
 
 class GURL;
 
+namespace base {
+class ListValue;
+}
+
 namespace content {
 struct FrameNavigateParams;
 struct LoadCommittedDetails;
@@ -36,9 +44,25 @@ class XWalkRenderViewHostExt : public content::WebContentsObserver,
   typedef base::Callback<void(bool)> DocumentHasImagesResult; // NOLINT *
   void DocumentHasImages(DocumentHasImagesResult result);
 
+  // Called with the JSON results of the scripts run by EvaluateJavaScript(),
+  // by script id. The results of a batch come in one call.
+  typedef base::Callback<void(const std::vector<int>&, // NOLINT *
+                              const std::vector<std::string>&)>
+      JavaScriptResultsCallback;
+  void SetJavaScriptResultsCallback(const JavaScriptResultsCallback& callback);
+
+  // Queues |script| to run in the main frame, |id| identifies its result.
+  // The scripts queued during the same task are sent in one IPC and run back
+  // to back in the renderer. Returns false, without queuing it, if too many
+  // scripts are already waiting for their results.
+  bool EvaluateJavaScript(int id, const base::string16& script);
+
   // Clear all WebCore memory cache (not only for this view).
   void ClearCache();
 
+  // Releases the renderer memory caches, see XWalkViewMsg_TrimMemory.
+  void TrimMemory(bool purge_script_memory);
+
   // Do a hit test at the view port coordinates and asynchronously update
   // |last_hit_test_data_|. |view_x| and |view_y| are in density independent
   // pixels used by WebKit::WebView.
@@ -78,6 +102,9 @@ class XWalkRenderViewHostExt : public content::WebContentsObserver,
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
 
   void OnDocumentHasImagesResponse(int msg_id, bool has_images);
+  void SendQueuedScripts();
+  void OnJavaScriptResults(const std::vector<int>& ids,
+                           const base::ListValue& results);
   void OnUpdateHitTestData(const XWalkHitTestData& hit_test_data);
   void OnPictureUpdated();
   void OnPageScaleFactorChanged(float page_scale_factor);
@@ -97,6 +124,15 @@ class XWalkRenderViewHostExt : public content::WebContentsObserver,
   std::string pending_match_patterns_;
   bool is_render_view_created_;
 
+  JavaScriptResultsCallback javascript_results_callback_;
+  // The scripts queued since the last batch was sent, and the ids of the
+  // ones sent whose results haven't come back yet.
+  std::vector<int> queued_script_ids_;
+  std::vector<base::string16> queued_scripts_;
+  std::set<int> running_script_ids_;
+
+  base::WeakPtrFactory<XWalkRenderViewHostExt> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(XWalkRenderViewHostExt);
 };
 
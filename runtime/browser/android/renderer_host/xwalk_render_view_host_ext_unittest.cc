@@ -0,0 +1,165 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/renderer_host/xwalk_render_view_host_ext.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/values.h"
+#include "content/public/browser/render_view_host.h"
+#include "content/public/test/mock_render_process_host.h"
+#include "content/public/test/test_renderer_host.h"
+#include "ipc/ipc_test_sink.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "xwalk/runtime/common/android/xwalk_render_view_messages.h"
+
+namespace xwalk {
+
+namespace {
+
+// Only the scripts queued or running, not the IPCs, are bounded.
+const int kMaxPendingScripts = 256;
+
+}  // namespace
+
+class XWalkRenderViewHostExtTest : public content::RenderViewHostTestHarness {
+ protected:
+  XWalkRenderViewHostExtTest() : results_calls_(0) {}
+
+  virtual void SetUp() OVERRIDE {
+    content::RenderViewHostTestHarness::SetUp();
+    NavigateAndCommit(GURL("http://example.com"));
+    ext_.reset(new XWalkRenderViewHostExt(web_contents()));
+    ext_->SetJavaScriptResultsCallback(
+        base::Bind(&XWalkRenderViewHostExtTest::OnJavaScriptResults,
+                   base::Unretained(this)));
+    process()->sink().ClearMessages();
+  }
+
+  virtual void TearDown() OVERRIDE {
+    ext_.reset();
+    content::RenderViewHostTestHarness::TearDown();
+  }
+
+  void OnJavaScriptResults(const std::vector<int>& ids,
+                           const std::vector<std::string>& results) {
+    ++results_calls_;
+    result_ids_.insert(result_ids_.end(), ids.begin(), ids.end());
+    results_.insert(results_.end(), results.begin(), results.end());
+  }
+
+  bool Evaluate(int id) {
+    return ext_->EvaluateJavaScript(
+        id, base::ASCIIToUTF16("window.value" + base::IntToString(id)));
+  }
+
+  // Returns the number of ExecuteJavaScripts sent, the ids of the last one
+  // in |ids|.
+  size_t GetSentBatches(std::vector<int>* ids) {
+    size_t batches = 0;
+    const IPC::TestSink& sink = process()->sink();
+    for (size_t i = 0; i < sink.message_count(); ++i) {
+      const IPC::Message* message = sink.GetMessageAt(i);
+      if (message->type() != XWalkViewMsg_ExecuteJavaScripts::ID)
+        continue;
+      XWalkViewMsg_ExecuteJavaScripts::Param param;
+      EXPECT_TRUE(XWalkViewMsg_ExecuteJavaScripts::Read(message, &param));
+      EXPECT_EQ(param.a.size(), param.b.size());
+      *ids = param.a;
+      ++batches;
+    }
+    return batches;
+  }
+
+  void ReceiveResults(const std::vector<int>& ids,
+                      const base::ListValue& results) {
+    static_cast<content::WebContentsObserver*>(ext_.get())->OnMessageReceived(
+        XWalkViewHostMsg_JavaScriptResults(rvh()->GetRoutingID(), ids,
+                                           results));
+  }
+
+  scoped_ptr<XWalkRenderViewHostExt> ext_;
+  int results_calls_;
+  std::vector<int> result_ids_;
+  std::vector<std::string> results_;
+};
+
+TEST_F(XWalkRenderViewHostExtTest, BatchesScriptsOfTheSameTask) {
+  EXPECT_TRUE(Evaluate(1));
+  EXPECT_TRUE(Evaluate(2));
+  EXPECT_TRUE(Evaluate(3));
+
+  // Nothing is sent before the task queuing them is over.
+  std::vector<int> ids;
+  EXPECT_EQ(0u, GetSentBatches(&ids));
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(1u, GetSentBatches(&ids));
+  ASSERT_EQ(3u, ids.size());
+  EXPECT_EQ(1, ids[0]);
+  EXPECT_EQ(2, ids[1]);
+  EXPECT_EQ(3, ids[2]);
+
+  base::ListValue results;
+  results.AppendInteger(1);
+  results.AppendString("two");
+  results.Append(base::Value::CreateNullValue());
+  ReceiveResults(ids, results);
+
+  // The results of the batch come back in one call.
+  EXPECT_EQ(1, results_calls_);
+  ASSERT_EQ(3u, results_.size());
+  EXPECT_EQ(ids, result_ids_);
+  EXPECT_EQ("1", results_[0]);
+  EXPECT_EQ("\"two\"", results_[1]);
+  EXPECT_EQ("null", results_[2]);
+}
+
+TEST_F(XWalkRenderViewHostExtTest, RejectsPastMaxPendingScripts) {
+  for (int id = 1; id <= kMaxPendingScripts; ++id)
+    EXPECT_TRUE(Evaluate(id));
+  EXPECT_FALSE(Evaluate(kMaxPendingScripts + 1));
+
+  // The scripts sent still count until their results come back.
+  base::RunLoop().RunUntilIdle();
+  std::vector<int> ids;
+  ASSERT_EQ(1u, GetSentBatches(&ids));
+  EXPECT_EQ(static_cast<size_t>(kMaxPendingScripts), ids.size());
+  EXPECT_FALSE(Evaluate(kMaxPendingScripts + 1));
+
+  base::ListValue results;
+  for (size_t i = 0; i < ids.size(); ++i)
+    results.AppendInteger(static_cast<int>(i));
+  ReceiveResults(ids, results);
+  EXPECT_EQ(static_cast<size_t>(kMaxPendingScripts), results_.size());
+  EXPECT_TRUE(Evaluate(kMaxPendingScripts + 1));
+}
+
+TEST_F(XWalkRenderViewHostExtTest, AnswersNullWhenTheRendererGoes) {
+  EXPECT_TRUE(Evaluate(1));
+  EXPECT_TRUE(Evaluate(2));
+  base::RunLoop().RunUntilIdle();
+  std::vector<int> ids;
+  ASSERT_EQ(1u, GetSentBatches(&ids));
+
+  static_cast<content::WebContentsObserver*>(ext_.get())->RenderProcessGone(
+      base::TERMINATION_STATUS_PROCESS_CRASHED);
+  EXPECT_EQ(1, results_calls_);
+  ASSERT_EQ(2u, results_.size());
+  EXPECT_EQ("null", results_[0]);
+  EXPECT_EQ("null", results_[1]);
+
+  // Late results aren't passed again.
+  base::ListValue results;
+  results.AppendInteger(1);
+  results.AppendInteger(2);
+  ReceiveResults(ids, results);
+  EXPECT_EQ(1, results_calls_);
+}
+
+}  // namespace xwalk
@@ -4,6 +4,7 @@
 
 #include "xwalk/runtime/browser/android/state_serializer.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -16,6 +17,7 @@
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/common/page_state.h"
+#include "third_party/zlib/zlib.h"
 
 // Reasons for not re-using TabNavigation under chrome/ as of 20121116:
 // * XwalkView has different requirements for fields to store since
@@ -38,10 +40,17 @@ namespace {
 // future if we ever decide to support restoring from older versions.
 const uint32 AW_STATE_VERSION = 20130814;
 
-}  // namespace
+// Written instead of AW_STATE_VERSION by WriteToState() when the state is
+// compressed, followed by the size of the pickle and its deflated data.
+const uint32 AW_COMPRESSED_STATE_VERSION = 20140601;
 
-bool WriteToPickle(const content::WebContents& web_contents,
-                   Pickle* pickle) {
+// The inflated pickle is only trusted up to this size.
+const uint32 kMaxUncompressedStateSize = 64 * 1024 * 1024;
+
+bool WriteEntriesToPickle(const content::WebContents& web_contents,
+                          int max_entries,
+                          size_t max_page_state_size,
+                          Pickle* pickle) {
   DCHECK(pickle);
 
   if (!internal::WriteHeaderToPickle(pickle))
@@ -55,14 +64,25 @@ bool WriteToPickle(const content::WebContents& web_contents,
   DCHECK_GE(selected_entry, -1);  // -1 is valid
   DCHECK(selected_entry < entry_count);
 
-  if (!pickle->WriteInt(entry_count))
+  int first_entry = 0;
+  int last_entry = entry_count;
+  if (max_entries > 0 && entry_count > max_entries) {
+    first_entry = std::max(0, selected_entry - max_entries + 1);
+    last_entry = first_entry + max_entries;
+  }
+
+  if (!pickle->WriteInt(last_entry - first_entry))
     return false;
 
-  if (!pickle->WriteInt(selected_entry))
+  if (!pickle->WriteInt(selected_entry == -1 ? -1
+                                             : selected_entry - first_entry))
     return false;
 
-  for (int i = 0; i < entry_count; ++i) {
+  for (int i = first_entry; i < last_entry; ++i) {
+    // The current entry is always restored as it was.
+    const size_t max_size = i == selected_entry ? 0 : max_page_state_size;
     if (!internal::WriteNavigationEntryToPickle(*controller.GetEntryAtIndex(i),
+                                                max_size,
                                                 pickle))
       return false;
   }
@@ -72,6 +92,90 @@ bool WriteToPickle(const content::WebContents& web_contents,
   return true;
 }
 
+}  // namespace
+
+bool WriteToPickle(const content::WebContents& web_contents,
+                   Pickle* pickle) {
+  return WriteEntriesToPickle(web_contents, 0, 0, pickle);
+}
+
+StateSerializerOptions::StateSerializerOptions()
+    : max_entries(0),
+      max_page_state_size(0),
+      compress(false) {
+}
+
+bool WriteToState(const content::WebContents& web_contents,
+                  const StateSerializerOptions& options,
+                  std::string* state) {
+  DCHECK(state);
+
+  Pickle pickle;
+  if (!WriteEntriesToPickle(web_contents, options.max_entries,
+                            options.max_page_state_size, &pickle))
+    return false;
+
+  if (!options.compress) {
+    state->assign(static_cast<const char*>(pickle.data()), pickle.size());
+    return true;
+  }
+
+  uLongf compressed_size = compressBound(pickle.size());
+  std::vector<Bytef> compressed(compressed_size);
+  if (compress2(&compressed[0], &compressed_size,
+                static_cast<const Bytef*>(pickle.data()), pickle.size(),
+                Z_BEST_SPEED) != Z_OK)
+    return false;
+
+  Pickle compressed_pickle;
+  if (!compressed_pickle.WriteUInt32(AW_COMPRESSED_STATE_VERSION) ||
+      !compressed_pickle.WriteUInt32(pickle.size()) ||
+      !compressed_pickle.WriteData(reinterpret_cast<const char*>(
+          &compressed[0]), compressed_size))
+    return false;
+
+  state->assign(static_cast<const char*>(compressed_pickle.data()),
+                compressed_pickle.size());
+  return true;
+}
+
+bool RestoreFromState(const char* data,
+                      size_t size,
+                      content::WebContents* web_contents) {
+  Pickle pickle(data, size);
+  PickleIterator iterator(pickle);
+
+  uint32 state_version = 0;
+  if (!iterator.ReadUInt32(&state_version))
+    return false;
+
+  if (state_version != AW_COMPRESSED_STATE_VERSION) {
+    PickleIterator pickle_iterator(pickle);
+    return RestoreFromPickle(&pickle_iterator, web_contents);
+  }
+
+  uint32 uncompressed_size = 0;
+  const char* compressed_data = NULL;
+  int compressed_size = 0;
+  if (!iterator.ReadUInt32(&uncompressed_size) ||
+      !iterator.ReadData(&compressed_data, &compressed_size))
+    return false;
+  if (!uncompressed_size || uncompressed_size > kMaxUncompressedStateSize)
+    return false;
+
+  std::vector<char> uncompressed(uncompressed_size);
+  uLongf inflated_size = uncompressed_size;
+  if (uncompress(reinterpret_cast<Bytef*>(&uncompressed[0]), &inflated_size,
+                 reinterpret_cast<const Bytef*>(compressed_data),
+                 compressed_size) != Z_OK ||
+      inflated_size != uncompressed_size)
+    return false;
+
+  Pickle uncompressed_pickle(&uncompressed[0], uncompressed.size());
+  PickleIterator uncompressed_iterator(uncompressed_pickle);
+  return RestoreFromPickle(&uncompressed_iterator, web_contents);
+}
+
 bool RestoreFromPickle(PickleIterator* iterator,
                        content::WebContents* web_contents) {
   DCHECK(iterator);
@@ -154,6 +258,12 @@ bool RestoreHeaderFromPickle(PickleIterator* iterator) {
 
 bool WriteNavigationEntryToPickle(const content::NavigationEntry& entry,
                                   Pickle* pickle) {
+  return WriteNavigationEntryToPickle(entry, 0, pickle);
+}
+
+bool WriteNavigationEntryToPickle(const content::NavigationEntry& entry,
+                                  size_t max_page_state_size,
+                                  Pickle* pickle) {
   if (!pickle->WriteString(entry.GetURL().spec()))
     return false;
 
@@ -169,8 +279,13 @@ bool WriteNavigationEntryToPickle(const content::NavigationEntry& entry,
   if (!pickle->WriteString16(entry.GetTitle()))
     return false;
 
-  if (!pickle->WriteString(entry.GetPageState().ToEncodedData()))
+  const std::string& page_state = entry.GetPageState().ToEncodedData();
+  if (max_page_state_size && page_state.size() > max_page_state_size) {
+    if (!pickle->WriteString(std::string()))
+      return false;
+  } else if (!pickle->WriteString(page_state)) {
     return false;
+  }
 
   if (!pickle->WriteBool(static_cast<int>(entry.GetHasPostData())))
     return false;
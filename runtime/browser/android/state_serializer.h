@@ -5,6 +5,9 @@
 #ifndef XWALK_RUNTIME_BROWSER_ANDROID_STATE_SERIALIZER_H_
 #define XWALK_RUNTIME_BROWSER_ANDROID_STATE_SERIALIZER_H_
 
+#include <string>
+
+#include "base/basictypes.h"
 #include "base/compiler_specific.h"
 
 class Pickle;
@@ -30,6 +33,33 @@ bool WriteToPickle(const content::WebContents& web_contents,
 bool RestoreFromPickle(PickleIterator* iterator,
                        content::WebContents* web_contents) WARN_UNUSED_RESULT;
 
+// How much of the navigation history WriteToState() keeps. Zero limits mean
+// no limit.
+struct StateSerializerOptions {
+  StateSerializerOptions();
+
+  // Only the entries closest to the current one are kept, preferring the
+  // back history.
+  int max_entries;
+  // The PageState (form data, scroll offsets...) of the entries other than
+  // the current one is dropped when it is larger, they are reloaded from
+  // their URL.
+  size_t max_page_state_size;
+  // Deflates the pickle.
+  bool compress;
+};
+
+// Same as WriteToPickle(), in the format read by RestoreFromState(). The
+// pickles written by WriteToPickle() can be restored as well.
+bool WriteToState(const content::WebContents& web_contents,
+                  const StateSerializerOptions& options,
+                  std::string* state) WARN_UNUSED_RESULT;
+
+// |web_contents| will not be modified if function returns false.
+bool RestoreFromState(const char* data,
+                      size_t size,
+                      content::WebContents* web_contents) WARN_UNUSED_RESULT;
+
 
 namespace internal {
 // Functions below are individual helper functiosn called by functions above.
@@ -39,6 +69,9 @@ bool WriteHeaderToPickle(Pickle* pickle) WARN_UNUSED_RESULT;
 bool RestoreHeaderFromPickle(PickleIterator* iterator) WARN_UNUSED_RESULT;
 bool WriteNavigationEntryToPickle(const content::NavigationEntry& entry,
                                   Pickle* pickle) WARN_UNUSED_RESULT;
+bool WriteNavigationEntryToPickle(const content::NavigationEntry& entry,
+                                  size_t max_page_state_size,
+                                  Pickle* pickle) WARN_UNUSED_RESULT;
 bool RestoreNavigationEntryFromPickle(
     PickleIterator* iterator,
     content::NavigationEntry* entry) WARN_UNUSED_RESULT;
@@ -7,27 +7,40 @@
 
 #include <algorithm>
 #include <cctype>
+#include <map>
 #include <string>
 #include <vector>
 
 #include "base/android/jni_array.h"
 #include "base/android/jni_string.h"
 #include "base/base_paths_android.h"
+#include "base/bind.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
+#include "base/lazy_instance.h"
+#include "base/memory/linked_ptr.h"
+#include "base/metrics/histogram.h"
 #include "base/path_service.h"
-#include "base/pickle.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner_util.h"
+#include "base/time/time.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/devtools_agent_host.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/web_contents.h"
+#include "content/public/common/child_process_host.h"
 #include "content/public/common/renderer_preferences.h"
 #include "content/public/common/url_constants.h"
 #include "components/navigation_interception/intercept_navigation_delegate.h"
+#include "crypto/sha2.h"
+#include "ipc/ipc_message.h"
 #include "xwalk/application/common/application_manifest_constants.h"
 #include "xwalk/application/common/manifest.h"
+#include "xwalk/runtime/browser/android/net/android_protocol_handler.h"
+#include "xwalk/runtime/browser/android/net/url_constants.h"
 #include "xwalk/runtime/browser/android/net_disk_cache_remover.h"
 #include "xwalk/runtime/browser/android/state_serializer.h"
 #include "xwalk/runtime/browser/android/xwalk_contents_client_bridge.h"
@@ -35,6 +48,7 @@
 #include "xwalk/runtime/browser/android/xwalk_contents_io_thread_client_impl.h"
 #include "xwalk/runtime/browser/android/xwalk_web_contents_delegate.h"
 #include "xwalk/runtime/browser/runtime_context.h"
+#include "xwalk/runtime/browser/runtime_download_digests.h"
 #include "xwalk/runtime/browser/runtime_resource_dispatcher_host_delegate_android.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
 #include "jni/XWalkContent_jni.h"
@@ -55,6 +69,11 @@ namespace {
 
 const void* kXWalkContentUserDataKey = &kXWalkContentUserDataKey;
 
+// Bounds what GetState() saves, it runs on the UI thread on every
+// onSaveInstanceState.
+const int kMaxSavedNavigationEntries = 50;
+const size_t kMaxSavedPageStateSize = 64 * 1024;
+
 class XWalkContentUserData : public base::SupportsUserData::Data {
  public:
   explicit XWalkContentUserData(XWalkContent* ptr) : content_(ptr) {}
@@ -104,6 +123,57 @@ bool ManifestGetString(const xwalk::application::Manifest& manifest,
   return false;
 }
 
+// The parsed manifests by the SHA-256 of their content, which keeps the keys
+// small. An application loads the same manifest in each of its XWalkViews
+// and again after being killed in the background, parsing it once per
+// process is enough. Used on the UI thread and the blocking pool.
+class ManifestCache {
+ public:
+  // Returns a copy of the dictionary |json| holds, NULL if it doesn't hold
+  // one.
+  scoped_ptr<base::DictionaryValue> Parse(const std::string& json) {
+    const std::string digest = crypto::SHA256HashString(json);
+    {
+      base::AutoLock lock(lock_);
+      ManifestMap::const_iterator it = manifests_.find(digest);
+      if (it != manifests_.end())
+        return make_scoped_ptr(it->second->DeepCopy());
+    }
+
+    scoped_ptr<base::Value> value(base::JSONReader::Read(json));
+    if (!value || !value->IsType(base::Value::TYPE_DICTIONARY))
+      return scoped_ptr<base::DictionaryValue>();
+    scoped_ptr<base::DictionaryValue> manifest(
+        static_cast<base::DictionaryValue*>(value.release()));
+
+    base::AutoLock lock(lock_);
+    if (manifests_.size() >= kMaxCachedManifests)
+      manifests_.clear();
+    manifests_[digest] = make_linked_ptr(manifest->DeepCopy());
+    return manifest.Pass();
+  }
+
+ private:
+  static const size_t kMaxCachedManifests = 4;
+
+  typedef std::map<std::string, linked_ptr<base::DictionaryValue> >
+      ManifestMap;
+
+  base::Lock lock_;
+  ManifestMap manifests_;
+};
+
+base::LazyInstance<ManifestCache>::Leaky g_manifest_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Runs on the blocking pool.
+scoped_ptr<base::DictionaryValue> ReadManifest(const GURL& url) {
+  std::string json;
+  if (!ReadAssetContent(url, &json))
+    return scoped_ptr<base::DictionaryValue>();
+  return g_manifest_cache.Get().Parse(json);
+}
+
 }  // namespace
 
 XWalkContent::XWalkContent(JNIEnv* env,
@@ -114,10 +184,22 @@ XWalkContent::XWalkContent(JNIEnv* env,
       web_contents_delegate_(
           new XWalkWebContentsDelegate(env, web_contents_delegate)),
       contents_client_bridge_(
-          new XWalkContentsClientBridge(env, contents_client_bridge)) {
+          new XWalkContentsClientBridge(env, contents_client_bridge)),
+      digests_render_process_id_(content::ChildProcessHost::kInvalidUniqueID),
+      digests_render_view_id_(MSG_ROUTING_NONE),
+      manifest_weak_factory_(this),
+      weak_factory_(this) {
 }
 
 XWalkContent::~XWalkContent() {
+  ClearDownloadDigests();
+}
+
+void XWalkContent::ClearDownloadDigests() {
+  RuntimeDownloadDigests::GetInstance()->ClearDigests(
+      digests_render_process_id_, digests_render_view_id_);
+  digests_render_process_id_ = content::ChildProcessHost::kInvalidUniqueID;
+  digests_render_view_id_ = MSG_ROUTING_NONE;
 }
 
 // static
@@ -148,6 +230,9 @@ jlong XWalkContent::GetWebContents(
 
     render_view_host_ext_.reset(
         new XWalkRenderViewHostExt(web_contents_.get()));
+    render_view_host_ext_->SetJavaScriptResultsCallback(
+        base::Bind(&XWalkContent::OnJavaScriptResults,
+                   weak_factory_.GetWeakPtr()));
   }
   return reinterpret_cast<intptr_t>(web_contents_.get());
 }
@@ -202,6 +287,13 @@ void XWalkContent::ClearCache(
   }
 }
 
+void XWalkContent::TrimMemory(JNIEnv* env,
+                              jobject obj,
+                              jboolean purge_script_memory) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  render_view_host_ext_->TrimMemory(purge_script_memory);
+}
+
 ScopedJavaLocalRef<jstring> XWalkContent::DevToolsAgentId(JNIEnv* env,
                                                           jobject obj) {
   content::RenderViewHost* rvh = web_contents_->GetRenderViewHost();
@@ -219,6 +311,30 @@ ScopedJavaLocalRef<jstring> XWalkContent::GetVersion(JNIEnv* env,
   return base::android::ConvertUTF8ToJavaString(env, XWALK_VERSION);
 }
 
+jboolean XWalkContent::EvaluateJavascript(JNIEnv* env,
+                                          jobject obj,
+                                          jint id,
+                                          jstring script) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  return render_view_host_ext_->EvaluateJavaScript(
+      id, base::android::ConvertJavaStringToUTF16(env, script));
+}
+
+void XWalkContent::OnJavaScriptResults(
+    const std::vector<int>& ids,
+    const std::vector<std::string>& results) {
+  JNIEnv* env = AttachCurrentThread();
+  ScopedJavaLocalRef<jobject> obj = java_ref_.get(env);
+  if (obj.is_null())
+    return;
+  ScopedJavaLocalRef<jintArray> ids_array =
+      base::android::ToJavaIntArray(env, &ids[0], ids.size());
+  ScopedJavaLocalRef<jobjectArray> results_array =
+      base::android::ToJavaArrayOfStrings(env, results);
+  Java_XWalkContent_onJavascriptResults(
+      env, obj.obj(), ids_array.obj(), results_array.obj());
+}
+
 void XWalkContent::SetJsOnlineProperty(JNIEnv* env,
                                        jobject obj,
                                        jboolean network_up) {
@@ -233,19 +349,70 @@ jboolean XWalkContent::SetManifest(JNIEnv* env,
   std::string json_input =
       base::android::ConvertJavaStringToUTF8(env, manifest_string);
 
-  base::Value* manifest_value = base::JSONReader::Read(json_input);
-  if (!manifest_value) return false;
-
-  base::DictionaryValue* manifest_dictionary;
-  manifest_value->GetAsDictionary(&manifest_dictionary);
+  scoped_ptr<base::DictionaryValue> manifest_dictionary =
+      g_manifest_cache.Get().Parse(json_input);
   if (!manifest_dictionary) return false;
 
-  scoped_ptr<base::DictionaryValue>
-      manifest_dictionary_ptr(manifest_dictionary);
+  ApplyManifest(path_str, manifest_dictionary.Pass());
+  return true;
+}
+
+jboolean XWalkContent::SetManifestFromUrl(JNIEnv* env,
+                                          jobject obj,
+                                          jstring path,
+                                          jstring url) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  std::string path_str = base::android::ConvertJavaStringToUTF8(env, path);
+  std::string url_str = base::android::ConvertJavaStringToUTF8(env, url);
+  GURL manifest_url(url_str);
+  bool is_asset = manifest_url.SchemeIs(kAppScheme) ||
+      (manifest_url.SchemeIsFile() &&
+       StartsWithASCII(manifest_url.path(), kAndroidAssetPath, true));
+  if (!is_asset)
+    return false;
+
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetBlockingPool(),
+      FROM_HERE,
+      base::Bind(&ReadManifest, manifest_url),
+      base::Bind(&XWalkContent::OnManifestRead,
+                 manifest_weak_factory_.GetWeakPtr(), path_str, url_str));
+  return true;
+}
+
+void XWalkContent::CancelPendingManifest(JNIEnv* env, jobject obj) {
+  manifest_weak_factory_.InvalidateWeakPtrs();
+}
+
+void XWalkContent::OnManifestRead(const std::string& path,
+                                  const std::string& url,
+                                  scoped_ptr<base::DictionaryValue> manifest) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (manifest) {
+    ApplyManifest(path, manifest.Pass());
+    return;
+  }
+
+  JNIEnv* env = AttachCurrentThread();
+  ScopedJavaLocalRef<jobject> obj = java_ref_.get(env);
+  if (obj.is_null())
+    return;
+  ScopedJavaLocalRef<jstring> url_buffer = ConvertUTF8ToJavaString(env, url);
+  Java_XWalkContent_onManifestLoadFailed(env, obj.obj(), url_buffer.obj());
+}
+
+void XWalkContent::ApplyManifest(
+    const std::string& path_str,
+    scoped_ptr<base::DictionaryValue> manifest_dictionary) {
+  JNIEnv* env = AttachCurrentThread();
+  ScopedJavaLocalRef<jobject> java_obj = java_ref_.get(env);
+  if (java_obj.is_null())
+    return;
+  jobject obj = java_obj.obj();
 
   xwalk::application::Manifest manifest(
       xwalk::application::Manifest::INVALID_TYPE,
-      manifest_dictionary_ptr.Pass());
+      manifest_dictionary.Pass());
 
   std::string url;
   if (manifest.GetString(keys::kStartURLKey, &url)) {
@@ -274,6 +441,30 @@ jboolean XWalkContent::SetManifest(JNIEnv* env,
   }
   render_view_host_ext_->SetOriginAccessWhitelist(url, match_patterns);
 
+  // "xwalk_downloads": [{"url": ..., "sha256": ...}, ...]
+  // Only the downloads of the last manifest are pre-approved.
+  RuntimeDownloadDigests* digests = RuntimeDownloadDigests::GetInstance();
+  ClearDownloadDigests();
+  digests_render_process_id_ = web_contents_->GetRenderProcessHost()->GetID();
+  digests_render_view_id_ = web_contents_->GetRenderViewHost()->GetRoutingID();
+  const base::ListValue* downloads = NULL;
+  if (manifest.GetList(keys::kXWalkDownloadsKey, &downloads)) {
+    for (size_t i = 0; i < downloads->GetSize(); ++i) {
+      const base::DictionaryValue* download = NULL;
+      std::string download_url;
+      std::string sha256;
+      if (!downloads->GetDictionary(i, &download) ||
+          !download->GetString("url", &download_url) ||
+          !download->GetString("sha256", &sha256) ||
+          !digests->AddDigest(digests_render_process_id_,
+                              digests_render_view_id_,
+                              GURL(url).Resolve(download_url), sha256)) {
+        LOG(WARNING) << "Invalid entry " << i << " of "
+                     << keys::kXWalkDownloadsKey << " in the manifest.";
+      }
+    }
+  }
+
   std::string csp;
   ManifestGetString(manifest, keys::kCSPKey, keys::kDeprecatedCSPKey, &csp);
   RuntimeContext* runtime_context =
@@ -362,7 +553,6 @@ jboolean XWalkContent::SetManifest(JNIEnv* env,
     // No need to display launch screen, load the url directly.
     Java_XWalkContent_onGetUrlFromManifest(env, obj, url_buffer.obj());
   }
-  return true;
 }
 
 jint XWalkContent::GetRoutingID(JNIEnv* env, jobject obj) {
@@ -376,26 +566,43 @@ base::android::ScopedJavaLocalRef<jbyteArray> XWalkContent::GetState(
   if (!web_contents_->GetController().GetEntryCount())
     return ScopedJavaLocalRef<jbyteArray>();
 
-  Pickle pickle;
-  if (!WriteToPickle(*web_contents_, &pickle)) {
+  StateSerializerOptions options;
+  options.max_entries = kMaxSavedNavigationEntries;
+  options.max_page_state_size = kMaxSavedPageStateSize;
+  options.compress = true;
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  std::string state;
+  if (!WriteToState(*web_contents_, options, &state))
     return ScopedJavaLocalRef<jbyteArray>();
-  } else {
-    return base::android::ToJavaByteArray(
-        env,
-        reinterpret_cast<const uint8*>(pickle.data()),
-        pickle.size());
-  }
+  UMA_HISTOGRAM_TIMES("XWalk.SavedState.WriteTime",
+                      base::TimeTicks::Now() - start);
+  UMA_HISTOGRAM_COUNTS("XWalk.SavedState.Size", state.size());
+
+  return base::android::ToJavaByteArray(
+      env, reinterpret_cast<const uint8*>(state.data()), state.size());
 }
 
 jboolean XWalkContent::SetState(JNIEnv* env, jobject obj, jbyteArray state) {
-  std::vector<uint8> state_vector;
-  base::android::JavaByteArrayToByteVector(env, state, &state_vector);
-
-  Pickle pickle(reinterpret_cast<const char*>(state_vector.begin()),
-                state_vector.size());
-  PickleIterator iterator(pickle);
-
-  return RestoreFromPickle(&iterator, web_contents_.get());
+  const jsize size = env->GetArrayLength(state);
+  if (!size)
+    return false;
+
+  // Reads the Java array in place rather than copying it into a vector first,
+  // it is only released once the restore is done.
+  jbyte* data = env->GetByteArrayElements(state, NULL);
+  if (!data)
+    return false;
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  bool restored = RestoreFromState(reinterpret_cast<const char*>(data), size,
+                                   web_contents_.get());
+  env->ReleaseByteArrayElements(state, data, JNI_ABORT);
+  if (restored) {
+    UMA_HISTOGRAM_TIMES("XWalk.SavedState.RestoreTime",
+                        base::TimeTicks::Now() - start);
+  }
+  return restored;
 }
 
 static jlong Init(JNIEnv* env, jobject obj, jobject web_contents_delegate,
@@ -443,6 +650,13 @@ void XWalkContent::ShowGeolocationPrompt(
     const GURL& requesting_frame,
     const base::Callback<void(bool)>& callback) { // NOLINT
   GURL origin = requesting_frame.GetOrigin();
+  std::map<GURL, bool>::const_iterator decision =
+      geolocation_decisions_.find(origin);
+  if (decision != geolocation_decisions_.end()) {
+    callback.Run(decision->second);
+    return;
+  }
+
   bool show_prompt = pending_geolocation_prompts_.empty();
   pending_geolocation_prompts_.push_back(OriginCallback(origin, callback));
   if (show_prompt) {
@@ -454,8 +668,11 @@ void XWalkContent::ShowGeolocationPrompt(
 void XWalkContent::InvokeGeolocationCallback(JNIEnv* env,
                                              jobject obj,
                                              jboolean value,
+                                             jboolean retained,
                                              jstring origin) {
   GURL callback_origin(base::android::ConvertJavaStringToUTF16(env, origin));
+  if (retained)
+    geolocation_decisions_[callback_origin.GetOrigin()] = value;
   if (callback_origin.GetOrigin() ==
       pending_geolocation_prompts_.front().first) {
     pending_geolocation_prompts_.front().second.Run(value);
@@ -467,6 +684,10 @@ void XWalkContent::InvokeGeolocationCallback(JNIEnv* env,
   }
 }
 
+void XWalkContent::ClearGeolocationDecisions() {
+  geolocation_decisions_.clear();
+}
+
 void XWalkContent::HideGeolocationPrompt(const GURL& origin) {
   bool removed_current_outstanding_callback = false;
   std::list<OriginCallback>::iterator it = pending_geolocation_prompts_.begin();
@@ -7,15 +7,23 @@
 #define XWALK_RUNTIME_BROWSER_ANDROID_XWALK_CONTENT_H_
 
 #include <list>
+#include <map>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "base/android/jni_weak_ref.h"
 #include "base/android/scoped_java_ref.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "xwalk/runtime/browser/android/renderer_host/xwalk_render_view_host_ext.h"
 
 using base::android::ScopedJavaLocalRef;
 
+namespace base {
+class DictionaryValue;
+}
+
 namespace content {
 class BrowserContext;
 class WebContents;
@@ -38,6 +46,7 @@ class XWalkContent {
   jlong GetWebContents(JNIEnv* env, jobject obj, jobject io_thread_client,
                       jobject delegate);
   void ClearCache(JNIEnv* env, jobject obj, jboolean include_disk_files);
+  void TrimMemory(JNIEnv* env, jobject obj, jboolean purge_script_memory);
   ScopedJavaLocalRef<jstring> DevToolsAgentId(JNIEnv* env, jobject obj);
   void Destroy(JNIEnv* env, jobject obj);
   ScopedJavaLocalRef<jstring> GetVersion(JNIEnv* env, jobject obj);
@@ -55,10 +64,27 @@ class XWalkContent {
   }
 
   void SetJsOnlineProperty(JNIEnv* env, jobject obj, jboolean network_up);
+  // Queues |script| to run in the page, see
+  // XWalkRenderViewHostExt::EvaluateJavaScript(). Its result is passed to
+  // onJavascriptResults() with |id|, along with the results of its batch.
+  jboolean EvaluateJavascript(JNIEnv* env,
+                              jobject obj,
+                              jint id,
+                              jstring script);
   jboolean SetManifest(JNIEnv* env,
                        jobject obj,
                        jstring path,
                        jstring manifest);
+  // Reads and parses the manifest at the asset |url| off the UI thread, then
+  // applies it as SetManifest() does. Returns false if |url| isn't an asset,
+  // onManifestLoadFailed() is called if it can't be read or parsed.
+  jboolean SetManifestFromUrl(JNIEnv* env,
+                              jobject obj,
+                              jstring path,
+                              jstring url);
+  // Drops the manifest SetManifestFromUrl() is still reading, e.g. when
+  // another page is loaded in the meantime.
+  void CancelPendingManifest(JNIEnv* env, jobject obj);
 
   // Geolocation API support
   void ShowGeolocationPrompt(const GURL& origin,
@@ -67,12 +93,26 @@ class XWalkContent {
   void InvokeGeolocationCallback(JNIEnv* env,
                                  jobject obj,
                                  jboolean value,
+                                 jboolean retained,
                                  jstring origin);
+  // Makes the next geolocation requests ask Java again, e.g. once the
+  // geolocation setting changed.
+  void ClearGeolocationDecisions();
 
  private:
   content::WebContents* CreateWebContents(JNIEnv* env, jobject io_thread_client,
                                           jobject delegate);
 
+  void OnJavaScriptResults(const std::vector<int>& ids,
+                           const std::vector<std::string>& results);
+  void OnManifestRead(const std::string& path,
+                      const std::string& url,
+                      scoped_ptr<base::DictionaryValue> manifest);
+  void ApplyManifest(const std::string& path,
+                     scoped_ptr<base::DictionaryValue> manifest);
+  // Drops the download digests of the manifest last applied.
+  void ClearDownloadDigests();
+
   JavaObjectWeakGlobalRef java_ref_;
   // TODO(guangzhen): The WebContentsDelegate need to take ownership of
   // WebContents as chrome content design. For xwalk, XWalkContent owns
@@ -91,6 +131,17 @@ class XWalkContent {
           OriginCallback;
   // The first element in the list is always the currently pending request.
   std::list<OriginCallback> pending_geolocation_prompts_;
+  // The decisions Java retained, by origin. The requests of these origins
+  // are answered without calling into Java.
+  std::map<GURL, bool> geolocation_decisions_;
+
+  // The view the download digests of the manifest were registered for.
+  int digests_render_process_id_;
+  int digests_render_view_id_;
+
+  // For the manifest being read, see CancelPendingManifest().
+  base::WeakPtrFactory<XWalkContent> manifest_weak_factory_;
+  base::WeakPtrFactory<XWalkContent> weak_factory_;
 };
 
 bool RegisterXWalkContent(JNIEnv* env);
@@ -10,6 +10,7 @@
 #include "base/android/jni_array.h"
 #include "base/android/jni_string.h"
 #include "base/callback.h"
+#include "base/files/file_path.h"
 #include "base/guid.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/desktop_notification_delegate.h"
@@ -41,22 +42,16 @@ namespace xwalk {
 
 namespace {
 
-void RunUpdateNotificationIconOnUIThread(
-    int notification_id,
-    content::RenderFrameHost* render_frame_host,
-    const SkBitmap& icon) {
-  XWalkContentsClientBridgeBase* bridge =
-      XWalkContentsClientBridgeBase::FromRenderFrameHost(render_frame_host);
-  if (bridge)
-    bridge->UpdateNotificationIcon(notification_id, icon);
-}
+const size_t kNotificationIconCacheSize = 8;
 
 }  // namespace
 
 static IDMap<content::DesktopNotificationDelegate> notifications_;
 
 XWalkContentsClientBridge::XWalkContentsClientBridge(JNIEnv* env, jobject obj)
-    : java_ref_(env, obj) {
+    : java_ref_(env, obj),
+      notification_icon_cache_(kNotificationIconCacheSize),
+      notification_icon_size_(0) {
   DCHECK(obj);
   Java_XWalkContentsClientBridge_setNativeContentsClientBridge(
       env, obj, reinterpret_cast<intptr_t>(this));
@@ -209,44 +204,95 @@ void XWalkContentsClientBridge::OnNotificationIconDownloaded(
     const GURL& icon_url,
     const std::vector<SkBitmap>& bitmaps,
     const std::vector<gfx::Size>& original_bitmap_sizes) {
-  if (bitmaps.empty() && http_status_code == 404) {
-    LOG(WARNING) << "Failed to download notification icon from "
-                 << icon_url.spec();
-  } else {
-    NotificationDownloadRequestIdMap::iterator iter =
-        downloading_icon_notifications_.find(id);
-    if (iter == downloading_icon_notifications_.end())
-      return;
-
-    int notification_id = iter->second.first;
-    content::RenderFrameHost* render_frame_host = iter->second.second;
-    // This will lead to a second call of ShowNotification for the
-    // same notification id to update the icon. On Android, when
-    // the notification which is already shown is fired again, it will
-    // silently update the content only.
-    BrowserThread::PostTask(
-        BrowserThread::UI,
-        FROM_HERE,
-        base::Bind(&RunUpdateNotificationIconOnUIThread,
-                   notification_id,
-                   render_frame_host,
-                   bitmaps[0]));
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  std::map<int, GURL>::iterator download = downloading_icons_.find(id);
+  if (download == downloading_icons_.end())
+    return;
+  GURL requested_url = download->second;
+  downloading_icons_.erase(download);
+  NotificationIconRequestMap::iterator iter =
+      notifications_waiting_for_icon_.find(requested_url);
+  if (iter == notifications_waiting_for_icon_.end())
+    return;
+  std::vector<int> notification_ids;
+  notification_ids.swap(iter->second);
+  notifications_waiting_for_icon_.erase(iter);
+
+  if (bitmaps.empty()) {
+    if (http_status_code == 404)
+      LOG(WARNING) << "Failed to download notification icon from "
+                   << icon_url.spec();
+    return;
   }
-  downloading_icon_notifications_.erase(id);
+
+  JNIEnv* env = AttachCurrentThread();
+  ScopedJavaLocalRef<jobject> jicon = gfx::ConvertToJavaBitmap(&bitmaps[0]);
+  if (jicon.is_null())
+    return;
+  base::android::ScopedJavaGlobalRef<jobject> cached_icon;
+  cached_icon.Reset(env, jicon.obj());
+  notification_icon_cache_.Put(requested_url, cached_icon);
+
+  // This will lead to a second call of ShowNotification for the
+  // same notification id to update the icon. On Android, when
+  // the notification which is already shown is fired again, it will
+  // silently update the content only.
+  for (size_t i = 0; i < notification_ids.size(); ++i)
+    ShowNotificationIcon(notification_ids[i], jicon.obj());
 }
 
 void XWalkContentsClientBridge::UpdateNotificationIcon(
     int notification_id, const SkBitmap& icon) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-  JNIEnv* env = AttachCurrentThread();
+  ScopedJavaLocalRef<jobject> jicon = gfx::ConvertToJavaBitmap(&icon);
+  ShowNotificationIcon(notification_id, jicon.obj());
+}
 
+void XWalkContentsClientBridge::ShowNotificationIcon(int notification_id,
+                                                     jobject icon) {
+  JNIEnv* env = AttachCurrentThread();
   ScopedJavaLocalRef<jobject> obj = java_ref_.get(env);
   if (obj.is_null())
     return;
 
-  ScopedJavaLocalRef<jobject> jicon = gfx::ConvertToJavaBitmap(&icon);
   Java_XWalkContentsClientBridge_updateNotificationIcon(
-      env, obj.obj(), notification_id, jicon.obj());
+      env, obj.obj(), notification_id, icon);
+}
+
+void XWalkContentsClientBridge::DownloadNotificationIcon(
+    const GURL& icon_url,
+    content::RenderFrameHost* render_frame_host,
+    int notification_id) {
+  NotificationIconRequestMap::iterator iter =
+      notifications_waiting_for_icon_.find(icon_url);
+  if (iter != notifications_waiting_for_icon_.end()) {
+    iter->second.push_back(notification_id);
+    return;
+  }
+
+  WebContents* web_contents =
+      WebContents::FromRenderFrameHost(render_frame_host);
+  if (!web_contents)
+    return;
+
+  if (!notification_icon_size_) {
+    JNIEnv* env = AttachCurrentThread();
+    ScopedJavaLocalRef<jobject> obj = java_ref_.get(env);
+    if (obj.is_null())
+      return;
+    notification_icon_size_ =
+        Java_XWalkContentsClientBridge_getNotificationIconSize(env, obj.obj());
+  }
+
+  int download_request_id = web_contents->DownloadImage(
+      icon_url,
+      false,
+      notification_icon_size_,
+      base::Bind(
+          &XWalkContentsClientBridge::OnNotificationIconDownloaded,
+          base::Unretained(this)));
+  downloading_icons_[download_request_id] = icon_url;
+  notifications_waiting_for_icon_[icon_url].push_back(notification_id);
 }
 
 static void CancelNotification(
@@ -281,32 +327,31 @@ void XWalkContentsClientBridge::ShowNotification(
   ScopedJavaLocalRef<jstring> jreplace_id(
     ConvertUTF16ToJavaString(env, params.replace_id));
 
+  // An icon used recently is shown with the notification right away.
+  ScopedJavaLocalRef<jobject> jicon;
+  bool needs_icon = false;
+  if (params.icon_url.is_valid()) {
+    NotificationIconCache::iterator icon =
+        notification_icon_cache_.Get(params.icon_url);
+    if (icon != notification_icon_cache_.end())
+      jicon.Reset(env, icon->second.obj());
+    else
+      needs_icon = true;
+  }
+
   int notification_id = notifications_.Add(delegate);
   Java_XWalkContentsClientBridge_showNotification(
       env, obj.obj(), jtitle.obj(), jbody.obj(),
-      jreplace_id.obj(), notification_id,
+      jreplace_id.obj(), jicon.obj(), notification_id,
       reinterpret_cast<intptr_t>(delegate));
 
   if (cancel_callback)
     *cancel_callback =
         base::Bind(&CancelNotification, java_ref_, notification_id, delegate);
 
-  if (params.icon_url.is_valid()) {
-    WebContents* web_contents =
-      WebContents::FromRenderFrameHost(render_frame_host);
-    if (web_contents) {
-      int download_request_id = web_contents->DownloadImage(
-          params.icon_url,
-          false,
-          0,
-          base::Bind(
-              &XWalkContentsClientBridge::OnNotificationIconDownloaded,
-              base::Unretained(this)));
-      NotificationDownloadRequestInfos info =
-          std::make_pair(notification_id, render_frame_host);
-      downloading_icon_notifications_[download_request_id] = info;
-    }
-  }
+  if (needs_icon)
+    DownloadNotificationIcon(params.icon_url, render_frame_host,
+                             notification_id);
 }
 
 void XWalkContentsClientBridge::OnWebLayoutPageScaleFactorChanged(
@@ -320,6 +365,21 @@ void XWalkContentsClientBridge::OnWebLayoutPageScaleFactorChanged(
       env, obj.obj(), page_scale_factor);
 }
 
+void XWalkContentsClientBridge::OnDownloadFinished(const GURL& url,
+                                                   const base::FilePath& path,
+                                                   bool verified) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  JNIEnv* env = AttachCurrentThread();
+  ScopedJavaLocalRef<jobject> obj = java_ref_.get(env);
+  if (obj.is_null())
+    return;
+  ScopedJavaLocalRef<jstring> jurl = ConvertUTF8ToJavaString(env, url.spec());
+  ScopedJavaLocalRef<jstring> jpath =
+      ConvertUTF8ToJavaString(env, path.value());
+  Java_XWalkContentsClientBridge_onDownloadFinished(
+      env, obj.obj(), jurl.obj(), jpath.obj(), verified);
+}
+
 void XWalkContentsClientBridge::ConfirmJsResult(JNIEnv* env,
                                                 jobject,
                                                 int id,
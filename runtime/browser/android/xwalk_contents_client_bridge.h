@@ -14,8 +14,10 @@
 #include "base/android/jni_weak_ref.h"
 #include "base/android/scoped_java_ref.h"
 #include "base/callback.h"
+#include "base/containers/mru_cache.h"
 #include "base/id_map.h"
 #include "content/public/browser/javascript_dialog_manager.h"
+#include "url/gurl.h"
 #include "xwalk/runtime/browser/android/xwalk_contents_client_bridge_base.h"
 
 namespace gfx {
@@ -74,6 +76,9 @@ class XWalkContentsClientBridge : public XWalkContentsClientBridgeBase {
   virtual void OnWebLayoutPageScaleFactorChanged(
       float page_scale_factor)
       OVERRIDE;
+  virtual void OnDownloadFinished(const GURL& url,
+                                  const base::FilePath& path,
+                                  bool verified) OVERRIDE;
 
   bool OnReceivedHttpAuthRequest(const base::android::JavaRef<jobject>& handler,
                                  const std::string& host,
@@ -110,11 +115,27 @@ class XWalkContentsClientBridge : public XWalkContentsClientBridgeBase {
   IDMap<content::JavaScriptDialogManager::DialogClosedCallback, IDMapOwnPointer>
       pending_js_dialog_callbacks_;
 
-  typedef std::pair<int, content::RenderFrameHost*>
-    NotificationDownloadRequestInfos;
-  typedef std::map<int, NotificationDownloadRequestInfos >
-    NotificationDownloadRequestIdMap;
-  NotificationDownloadRequestIdMap downloading_icon_notifications_;
+  void ShowNotificationIcon(int notification_id, jobject icon);
+  void DownloadNotificationIcon(const GURL& icon_url,
+                                content::RenderFrameHost* render_frame_host,
+                                int notification_id);
+
+  // The notifications waiting for each icon being downloaded, so an icon
+  // shared by several notifications is only downloaded once.
+  typedef std::map<GURL, std::vector<int> > NotificationIconRequestMap;
+  NotificationIconRequestMap notifications_waiting_for_icon_;
+  // Maps the image download ids to the requested icon URLs.
+  std::map<int, GURL> downloading_icons_;
+
+  // The Java bitmaps of the icons used recently, a page firing notifications
+  // with the same icon only has it downloaded and converted once.
+  typedef base::MRUCache<GURL, base::android::ScopedJavaGlobalRef<jobject> >
+      NotificationIconCache;
+  NotificationIconCache notification_icon_cache_;
+
+  // The largest dimension of the notification icons, in pixels. The icons
+  // are downscaled to it by the renderer as they are decoded.
+  int notification_icon_size_;
 };
 
 bool RegisterXWalkContentsClientBridge(JNIEnv* env);
@@ -12,6 +12,10 @@
 class GURL;
 class SkBitmap;
 
+namespace base {
+class FilePath;
+}
+
 namespace content {
 class DesktopNotificationDelegate;
 class RenderFrameHost;
@@ -75,6 +79,11 @@ class XWalkContentsClientBridgeBase {
       const SkBitmap& icon)
       = 0;
   virtual void OnWebLayoutPageScaleFactorChanged(float page_scale_factor) = 0;
+  // A download pre-approved by the manifest was saved to |path|, |verified|
+  // tells whether it has the expected digest.
+  virtual void OnDownloadFinished(const GURL& url,
+                                  const base::FilePath& path,
+                                  bool verified) = 0;
 };
 
 }  // namespace xwalk
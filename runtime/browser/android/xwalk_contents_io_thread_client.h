@@ -57,7 +57,7 @@ class XWalkContentsIoThreadClient {
 
   // This will attempt to fetch the XWalkContentsIoThreadClient for the given
   // |render_process_id|, |render_frame_id| pair.
-  // This method can be called from any thread.
+  // This method is called on the IO thread only.
   // An empty scoped_ptr is a valid return value.
   static scoped_ptr<XWalkContentsIoThreadClient> FromID(int render_process_id,
                                                         int render_frame_id);
@@ -67,11 +67,22 @@ class XWalkContentsIoThreadClient {
                               int parent_render_frame_id,
                               int child_render_frame_id);
 
+  // Whether ShouldInterceptRequest() is to be called for |request|, see
+  // XWalkSettings.addInterceptPattern(). Doesn't call into Java.
+  // This method is called on the IO thread only.
+  virtual bool MayInterceptRequest(const GURL& location,
+                                   const net::URLRequest* request) const = 0;
+
   // This method is called on the IO thread only.
   virtual scoped_ptr<InterceptedRequestData> ShouldInterceptRequest(
       const GURL& location,
       const net::URLRequest* request) = 0;
 
+  // Retrieve the InterceptedResponseCacheEnabled setting value of this
+  // XWalkContent.
+  // This method is called on the IO thread only.
+  virtual bool ShouldCacheInterceptedResponses() const = 0;
+
   // Retrieve the AllowContentAccess setting value of this XWalkContent.
   // This method is called on the IO thread only.
   virtual bool ShouldBlockContentUrls() const = 0;
@@ -4,16 +4,16 @@
 
 #include "xwalk/runtime/browser/android/xwalk_contents_io_thread_client_impl.h"
 
-#include <map>
 #include <string>
 #include <utility>
 
 #include "base/android/jni_string.h"
 #include "base/android/jni_weak_ref.h"
+#include "base/bind.h"
+#include "base/containers/hash_tables.h"
 #include "base/lazy_instance.h"
 #include "base/memory/linked_ptr.h"
 #include "base/memory/scoped_ptr.h"
-#include "base/synchronization/lock.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
@@ -24,6 +24,7 @@
 #include "jni/XWalkContentsIoThreadClient_jni.h"
 #include "net/url_request/url_request.h"
 #include "url/gurl.h"
+#include "xwalk/runtime/browser/android/intercept_patterns.h"
 #include "xwalk/runtime/browser/android/intercepted_request_data_impl.h"
 
 using base::android::AttachCurrentThread;
@@ -34,7 +35,6 @@ using base::LazyInstance;
 using content::BrowserThread;
 using content::RenderFrameHost;
 using content::WebContents;
-using std::map;
 using std::pair;
 
 namespace xwalk {
@@ -44,13 +44,14 @@ namespace {
 struct IoThreadClientData {
   bool pending_association;
   JavaObjectWeakGlobalRef io_thread_client;
+  scoped_refptr<InterceptPatterns> intercept_patterns;
 
   IoThreadClientData();
 };
 
 IoThreadClientData::IoThreadClientData() : pending_association(false) {}
 
-typedef map<pair<int, int>, IoThreadClientData>
+typedef base::hash_map<pair<int, int>, IoThreadClientData>
     RenderFrameHostToIoThreadClientType;
 
 static pair<int, int> GetRenderFrameHostIdPair(RenderFrameHost* rfh) {
@@ -58,6 +59,10 @@ static pair<int, int> GetRenderFrameHostIdPair(RenderFrameHost* rfh) {
 }
 
 // RfhToIoThreadClientMap -----------------------------------------------------
+// Owned by the IO thread, where all the lookups happen, so they don't take a
+// lock. The updates made on other threads are posted to the IO thread, the
+// tasks run before any request of the frame as they are queued ahead of the
+// IPC that creates it.
 class RfhToIoThreadClientMap {
  public:
   static RfhToIoThreadClientMap* GetInstance();
@@ -67,7 +72,6 @@ class RfhToIoThreadClientMap {
 
  private:
   static LazyInstance<RfhToIoThreadClientMap> g_instance_;
-  base::Lock map_lock_;
   RenderFrameHostToIoThreadClientType rfh_to_io_thread_client_;
 };
 
@@ -82,13 +86,18 @@ RfhToIoThreadClientMap* RfhToIoThreadClientMap::GetInstance() {
 
 void RfhToIoThreadClientMap::Set(pair<int, int> rfh_id,
                                  const IoThreadClientData& client) {
-  base::AutoLock lock(map_lock_);
+  if (!BrowserThread::CurrentlyOn(BrowserThread::IO)) {
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&RfhToIoThreadClientMap::Set,
+                   base::Unretained(this), rfh_id, client));
+    return;
+  }
   rfh_to_io_thread_client_[rfh_id] = client;
 }
 
 bool RfhToIoThreadClientMap::Get(
     pair<int, int> rfh_id, IoThreadClientData* client) {
-  base::AutoLock lock(map_lock_);
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   RenderFrameHostToIoThreadClientType::iterator iterator =
       rfh_to_io_thread_client_.find(rfh_id);
   if (iterator == rfh_to_io_thread_client_.end())
@@ -99,7 +108,12 @@ bool RfhToIoThreadClientMap::Get(
 }
 
 void RfhToIoThreadClientMap::Erase(pair<int, int> rfh_id) {
-  base::AutoLock lock(map_lock_);
+  if (!BrowserThread::CurrentlyOn(BrowserThread::IO)) {
+    BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+        base::Bind(&RfhToIoThreadClientMap::Erase,
+                   base::Unretained(this), rfh_id));
+    return;
+  }
   rfh_to_io_thread_client_.erase(rfh_id);
 }
 
@@ -116,13 +130,15 @@ class ClientMapEntryUpdater : public content::WebContentsObserver {
 
  private:
   JavaObjectWeakGlobalRef jdelegate_;
+  scoped_refptr<InterceptPatterns> intercept_patterns_;
 };
 
 ClientMapEntryUpdater::ClientMapEntryUpdater(JNIEnv* env,
                                              WebContents* web_contents,
                                              jobject jdelegate)
     : content::WebContentsObserver(web_contents),
-      jdelegate_(env, jdelegate) {
+      jdelegate_(env, jdelegate),
+      intercept_patterns_(InterceptPatterns::FromWebContents(web_contents)) {
   DCHECK(web_contents);
   DCHECK(jdelegate);
 
@@ -134,6 +150,7 @@ void ClientMapEntryUpdater::RenderFrameCreated(RenderFrameHost* rfh) {
   IoThreadClientData client_data;
   client_data.io_thread_client = jdelegate_;
   client_data.pending_association = false;
+  client_data.intercept_patterns = intercept_patterns_;
   RfhToIoThreadClientMap::GetInstance()->Set(
       GetRenderFrameHostIdPair(rfh), client_data);
 }
@@ -166,7 +183,8 @@ XWalkContentsIoThreadClient::FromID(int render_process_id,
   DCHECK(!client_data.pending_association || java_delegate.is_null());
   return scoped_ptr<XWalkContentsIoThreadClient>(
       new XWalkContentsIoThreadClientImpl(
-          client_data.pending_association, java_delegate));
+          client_data.pending_association, java_delegate,
+          client_data.intercept_patterns));
 }
 
 // static
@@ -206,9 +224,11 @@ void XWalkContentsIoThreadClientImpl::Associate(
 
 XWalkContentsIoThreadClientImpl::XWalkContentsIoThreadClientImpl(
     bool pending_association,
-    const JavaRef<jobject>& obj)
+    const JavaRef<jobject>& obj,
+    const scoped_refptr<InterceptPatterns>& intercept_patterns)
   : pending_association_(pending_association),
-    java_object_(obj) {
+    java_object_(obj),
+    intercept_patterns_(intercept_patterns) {
 }
 
 XWalkContentsIoThreadClientImpl::~XWalkContentsIoThreadClientImpl() {
@@ -231,6 +251,21 @@ XWalkContentsIoThreadClientImpl::GetCacheMode() const {
           env, java_object_.obj()));
 }
 
+bool XWalkContentsIoThreadClientImpl::MayInterceptRequest(
+    const GURL& location,
+    const net::URLRequest* request) const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (java_object_.is_null())
+    return false;
+  if (!intercept_patterns_)
+    return true;
+
+  const content::ResourceRequestInfo* info =
+      content::ResourceRequestInfo::ForRequest(request);
+  return intercept_patterns_->Matches(
+      location, info ? info->GetResourceType() : ResourceType::SUB_RESOURCE);
+}
+
 scoped_ptr<InterceptedRequestData>
 XWalkContentsIoThreadClientImpl::ShouldInterceptRequest(
     const GURL& location,
@@ -255,6 +290,16 @@ XWalkContentsIoThreadClientImpl::ShouldInterceptRequest(
       new InterceptedRequestDataImpl(ret));
 }
 
+bool XWalkContentsIoThreadClientImpl::ShouldCacheInterceptedResponses() const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (java_object_.is_null())
+    return false;
+
+  JNIEnv* env = AttachCurrentThread();
+  return Java_XWalkContentsIoThreadClient_shouldCacheInterceptedResponses(
+      env, java_object_.obj());
+}
+
 bool XWalkContentsIoThreadClientImpl::ShouldBlockContentUrls() const {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (java_object_.is_null())
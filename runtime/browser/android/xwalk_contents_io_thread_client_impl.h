@@ -12,6 +12,7 @@
 #include "base/android/scoped_java_ref.h"
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 
 class GURL;
@@ -26,6 +27,7 @@ class URLRequest;
 
 namespace xwalk {
 
+class InterceptPatterns;
 class InterceptedRequestData;
 
 class XWalkContentsIoThreadClientImpl : public XWalkContentsIoThreadClient {
@@ -40,18 +42,23 @@ class XWalkContentsIoThreadClientImpl : public XWalkContentsIoThreadClient {
                         const base::android::JavaRef<jobject>& jclient);
 
   // Either |pending_associate| is true or |jclient| holds a non-null
-  // Java object.
+  // Java object. |intercept_patterns| is NULL while pending.
   XWalkContentsIoThreadClientImpl(
       bool pending_associate,
-      const base::android::JavaRef<jobject>& jclient);
+      const base::android::JavaRef<jobject>& jclient,
+      const scoped_refptr<InterceptPatterns>& intercept_patterns);
   virtual ~XWalkContentsIoThreadClientImpl() OVERRIDE;
 
   // Implementation of XWalkContentsIoThreadClient.
   virtual bool PendingAssociation() const OVERRIDE;
   virtual CacheMode GetCacheMode() const OVERRIDE;
+  virtual bool MayInterceptRequest(
+      const GURL& location,
+      const net::URLRequest* request) const OVERRIDE;
   virtual scoped_ptr<InterceptedRequestData> ShouldInterceptRequest(
       const GURL& location,
       const net::URLRequest* request) OVERRIDE;
+  virtual bool ShouldCacheInterceptedResponses() const OVERRIDE;
   virtual bool ShouldBlockContentUrls() const OVERRIDE;
   virtual bool ShouldBlockFileUrls() const OVERRIDE;
   virtual bool ShouldBlockNetworkLoads() const OVERRIDE;
@@ -67,6 +74,7 @@ class XWalkContentsIoThreadClientImpl : public XWalkContentsIoThreadClient {
  private:
   bool pending_association_;
   base::android::ScopedJavaGlobalRef<jobject> java_object_;
+  scoped_refptr<InterceptPatterns> intercept_patterns_;
 
   DISALLOW_COPY_AND_ASSIGN(XWalkContentsIoThreadClientImpl);
 };
@@ -29,9 +29,20 @@ void XWalkDownloadResourceThrottle::WillStartRequest(bool* defer) {
 }
 
 void XWalkDownloadResourceThrottle::WillProcessResponse(bool* defer) {
-  content::DownloadControllerAndroid::Get()->CreateGETDownload(
-      render_process_id_, render_view_id_, request_id_);
+  // The digest is the one of the whole content, which a partial response
+  // doesn't have, so the platform downloads it all instead.
+  if (request_->GetResponseCode() == 200)
+    return;
+
+  if ("GET" == request_->method()) {
+    content::DownloadControllerAndroid::Get()->CreateGETDownload(
+        render_process_id_, render_view_id_, request_id_);
+  }
   controller()->Cancel();
 }
 
+const char* XWalkDownloadResourceThrottle::GetNameForLogging() const {
+  return "XWalkDownloadResourceThrottle";
+}
+
 }  // namespace xwalk
@@ -15,6 +15,9 @@ class URLRequest;
 
 namespace xwalk {
 
+// Lets the response of a download pre-approved by the manifest go on to the
+// runtime's download manager, which hashes it as it is written, instead of
+// the download being fetched again by the platform.
 class XWalkDownloadResourceThrottle : public content::ResourceThrottle {
  public:
   XWalkDownloadResourceThrottle(net::URLRequest* request,
@@ -25,6 +28,7 @@ class XWalkDownloadResourceThrottle : public content::ResourceThrottle {
 
   virtual void WillStartRequest(bool* defer) OVERRIDE;
   virtual void WillProcessResponse(bool* defer) OVERRIDE;
+  virtual const char* GetNameForLogging() const OVERRIDE;
 
  private:
   const net::URLRequest* request_;
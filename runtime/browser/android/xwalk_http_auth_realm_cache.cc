@@ -0,0 +1,110 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/xwalk_http_auth_realm_cache.h"
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+
+namespace xwalk {
+
+namespace {
+
+base::LazyInstance<XWalkHttpAuthRealmCache>::Leaky g_realm_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+XWalkHttpAuthRealmCache::Waiter::Waiter(const AnswerCallback& answer,
+                                        const AskCallback& ask)
+    : answer(answer),
+      ask(ask) {}
+
+XWalkHttpAuthRealmCache::Waiter::~Waiter() {}
+
+XWalkHttpAuthRealmCache::Realm::Realm()
+    : has_credentials(false),
+      asking(false) {}
+
+XWalkHttpAuthRealmCache::Realm::~Realm() {}
+
+XWalkHttpAuthRealmCache::XWalkHttpAuthRealmCache() {}
+
+XWalkHttpAuthRealmCache::~XWalkHttpAuthRealmCache() {}
+
+// static
+XWalkHttpAuthRealmCache* XWalkHttpAuthRealmCache::GetInstance() {
+  return g_realm_cache.Pointer();
+}
+
+// static
+std::string XWalkHttpAuthRealmCache::GetRealmKey(
+    const net::AuthChallengeInfo& auth_info) {
+  return (auth_info.is_proxy ? "proxy " : "server ") +
+      auth_info.challenger.ToString() + " " + auth_info.scheme + " " +
+      auth_info.realm;
+}
+
+XWalkHttpAuthRealmCache::Result XWalkHttpAuthRealmCache::Lookup(
+    const std::string& realm_key,
+    bool first_attempt,
+    net::AuthCredentials* credentials) {
+  Realm& realm = realms_[realm_key];
+  // The server rejected the cached credentials.
+  if (!first_attempt)
+    realm.has_credentials = false;
+
+  if (realm.has_credentials) {
+    *credentials = realm.credentials;
+    return ANSWERED;
+  }
+  if (realm.asking)
+    return WAITING;
+  realm.asking = true;
+  return ASK;
+}
+
+void XWalkHttpAuthRealmCache::Wait(const std::string& realm_key,
+                                   const AnswerCallback& answer,
+                                   const AskCallback& ask) {
+  RealmMap::iterator it = realms_.find(realm_key);
+  DCHECK(it != realms_.end() && it->second.asking);
+  it->second.waiting.push_back(Waiter(answer, ask));
+}
+
+void XWalkHttpAuthRealmCache::Answer(const std::string& realm_key,
+                                     const net::AuthCredentials* credentials) {
+  RealmMap::iterator it = realms_.find(realm_key);
+  DCHECK(it != realms_.end());
+  std::vector<Waiter> waiting;
+  waiting.swap(it->second.waiting);
+  if (credentials) {
+    it->second.asking = false;
+    it->second.has_credentials = true;
+    it->second.credentials = *credentials;
+  } else {
+    realms_.erase(it);
+  }
+
+  for (size_t i = 0; i < waiting.size(); ++i)
+    waiting[i].answer.Run(credentials);
+}
+
+void XWalkHttpAuthRealmCache::Abandon(const std::string& realm_key) {
+  RealmMap::iterator it = realms_.find(realm_key);
+  DCHECK(it != realms_.end());
+  Realm& realm = it->second;
+  realm.asking = false;
+  while (!realm.waiting.empty()) {
+    Waiter next = realm.waiting.front();
+    realm.waiting.erase(realm.waiting.begin());
+    if (next.ask.Run()) {
+      realm.asking = true;
+      return;
+    }
+  }
+  realms_.erase(it);
+}
+
+}  // namespace xwalk
@@ -0,0 +1,96 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_ANDROID_XWALK_HTTP_AUTH_REALM_CACHE_H_
+#define XWALK_RUNTIME_BROWSER_ANDROID_XWALK_HTTP_AUTH_REALM_CACHE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "net/base/auth.h"
+
+namespace xwalk {
+
+// The credentials the application answered with for each realm, and the
+// challenges waiting while it is asked, so that it is asked once per realm.
+// Only used on the IO thread.
+class XWalkHttpAuthRealmCache {
+ public:
+  // Run with the answer of the application, NULL if it cancelled.
+  typedef base::Callback<void(const net::AuthCredentials*)> AnswerCallback;
+  // Makes a waiting challenge ask the application in place of the one that
+  // went away. Returns false if it went away as well.
+  typedef base::Callback<bool()> AskCallback;
+
+  enum Result {
+    // The credentials of the realm are known.
+    ANSWERED,
+    // The application is being asked, Wait() gets its answer.
+    WAITING,
+    // The application has to be asked, Answer() tells its answer.
+    ASK,
+  };
+
+  XWalkHttpAuthRealmCache();
+  ~XWalkHttpAuthRealmCache();
+
+  static XWalkHttpAuthRealmCache* GetInstance();
+
+  // The challenger, scheme and realm of the challenge.
+  static std::string GetRealmKey(const net::AuthChallengeInfo& auth_info);
+
+  // |first_attempt| is false when the server rejected the credentials sent,
+  // the ones known for the realm are then dropped. |credentials| is set when
+  // ANSWERED is returned.
+  Result Lookup(const std::string& realm_key,
+                bool first_attempt,
+                net::AuthCredentials* credentials);
+
+  // Called for the challenge Lookup() returned WAITING to. |answer| is run
+  // with the answer of the application, unless the challenge asking went
+  // away, in which case |ask| may be run instead.
+  void Wait(const std::string& realm_key,
+            const AnswerCallback& answer,
+            const AskCallback& ask);
+
+  // Called for the challenge Lookup() returned ASK to with the answer of the
+  // application, NULL if it cancelled. The waiting challenges get the same.
+  void Answer(const std::string& realm_key,
+              const net::AuthCredentials* credentials);
+
+  // Called when the challenge Lookup() returned ASK to went away before the
+  // application answered. The next waiting challenge asks instead.
+  void Abandon(const std::string& realm_key);
+
+ private:
+  struct Waiter {
+    Waiter(const AnswerCallback& answer, const AskCallback& ask);
+    ~Waiter();
+
+    AnswerCallback answer;
+    AskCallback ask;
+  };
+
+  struct Realm {
+    Realm();
+    ~Realm();
+
+    bool has_credentials;
+    net::AuthCredentials credentials;
+    bool asking;
+    std::vector<Waiter> waiting;
+  };
+
+  typedef std::map<std::string, Realm> RealmMap;
+  RealmMap realms_;
+
+  DISALLOW_COPY_AND_ASSIGN(XWalkHttpAuthRealmCache);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_ANDROID_XWALK_HTTP_AUTH_REALM_CACHE_H_
@@ -0,0 +1,168 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/android/xwalk_http_auth_realm_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/strings/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace xwalk {
+
+namespace {
+
+const char kRealm[] = "server http://example.com:80 basic realm";
+const char kOtherRealm[] = "server http://example.com:80 basic other";
+
+// Records what a waiting challenge is told.
+class TestChallenge {
+ public:
+  TestChallenge() : answers_(0), cancels_(0), asks_(0), gone_(false) {}
+
+  XWalkHttpAuthRealmCache::AnswerCallback AnswerCallback() {
+    return base::Bind(&TestChallenge::OnAnswer, base::Unretained(this));
+  }
+
+  XWalkHttpAuthRealmCache::AskCallback AskCallback() {
+    return base::Bind(&TestChallenge::OnAsk, base::Unretained(this));
+  }
+
+  int answers() const { return answers_; }
+  int cancels() const { return cancels_; }
+  int asks() const { return asks_; }
+  const net::AuthCredentials& credentials() const { return credentials_; }
+  void set_gone(bool gone) { gone_ = gone; }
+
+ private:
+  void OnAnswer(const net::AuthCredentials* credentials) {
+    if (!credentials) {
+      ++cancels_;
+      return;
+    }
+    ++answers_;
+    credentials_ = *credentials;
+  }
+
+  bool OnAsk() {
+    if (gone_)
+      return false;
+    ++asks_;
+    return true;
+  }
+
+  int answers_;
+  int cancels_;
+  int asks_;
+  bool gone_;
+  net::AuthCredentials credentials_;
+};
+
+net::AuthCredentials MakeCredentials(const std::string& user,
+                                     const std::string& password) {
+  return net::AuthCredentials(base::ASCIIToUTF16(user),
+                              base::ASCIIToUTF16(password));
+}
+
+}  // namespace
+
+class XWalkHttpAuthRealmCacheTest : public testing::Test {
+ protected:
+  XWalkHttpAuthRealmCache::Result Lookup(const std::string& realm_key,
+                                         bool first_attempt) {
+    return cache_.Lookup(realm_key, first_attempt, &credentials_);
+  }
+
+  void Wait(const std::string& realm_key, TestChallenge* challenge) {
+    cache_.Wait(realm_key, challenge->AnswerCallback(),
+                challenge->AskCallback());
+  }
+
+  XWalkHttpAuthRealmCache cache_;
+  net::AuthCredentials credentials_;
+};
+
+TEST_F(XWalkHttpAuthRealmCacheTest, OnePromptAnswersWaiters) {
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ASK, Lookup(kRealm, true));
+
+  // The challenges arriving while the application is asked wait for it.
+  TestChallenge first;
+  TestChallenge second;
+  EXPECT_EQ(XWalkHttpAuthRealmCache::WAITING, Lookup(kRealm, true));
+  Wait(kRealm, &first);
+  EXPECT_EQ(XWalkHttpAuthRealmCache::WAITING, Lookup(kRealm, true));
+  Wait(kRealm, &second);
+  EXPECT_EQ(0, first.answers());
+
+  const net::AuthCredentials credentials = MakeCredentials("user", "secret");
+  cache_.Answer(kRealm, &credentials);
+  EXPECT_EQ(1, first.answers());
+  EXPECT_EQ(1, second.answers());
+  EXPECT_TRUE(credentials.Equals(first.credentials()));
+  EXPECT_TRUE(credentials.Equals(second.credentials()));
+  EXPECT_EQ(0, first.asks());
+
+  // The next ones are answered right away.
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ANSWERED, Lookup(kRealm, true));
+  EXPECT_TRUE(credentials.Equals(credentials_));
+
+  // Another realm is asked on its own.
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ASK, Lookup(kOtherRealm, true));
+}
+
+TEST_F(XWalkHttpAuthRealmCacheTest, CancelPropagates) {
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ASK, Lookup(kRealm, true));
+  TestChallenge waiting;
+  EXPECT_EQ(XWalkHttpAuthRealmCache::WAITING, Lookup(kRealm, true));
+  Wait(kRealm, &waiting);
+
+  cache_.Answer(kRealm, NULL);
+  EXPECT_EQ(1, waiting.cancels());
+  EXPECT_EQ(0, waiting.answers());
+
+  // Nothing is kept from a cancelled prompt, the next challenge asks again.
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ASK, Lookup(kRealm, true));
+}
+
+TEST_F(XWalkHttpAuthRealmCacheTest, RejectedCredentialsAreAskedAgain) {
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ASK, Lookup(kRealm, true));
+  const net::AuthCredentials wrong = MakeCredentials("user", "wrong");
+  cache_.Answer(kRealm, &wrong);
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ANSWERED, Lookup(kRealm, true));
+
+  // A second attempt means the server rejected what was sent.
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ASK, Lookup(kRealm, false));
+  EXPECT_EQ(XWalkHttpAuthRealmCache::WAITING, Lookup(kRealm, true));
+
+  const net::AuthCredentials right = MakeCredentials("user", "right");
+  cache_.Answer(kRealm, &right);
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ANSWERED, Lookup(kRealm, true));
+  EXPECT_TRUE(right.Equals(credentials_));
+}
+
+TEST_F(XWalkHttpAuthRealmCacheTest, AbandonedPromptIsTakenOver) {
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ASK, Lookup(kRealm, true));
+  TestChallenge gone;
+  TestChallenge next;
+  EXPECT_EQ(XWalkHttpAuthRealmCache::WAITING, Lookup(kRealm, true));
+  Wait(kRealm, &gone);
+  EXPECT_EQ(XWalkHttpAuthRealmCache::WAITING, Lookup(kRealm, true));
+  Wait(kRealm, &next);
+
+  // The asking challenge went away, the first waiting one still around
+  // asks in its place.
+  gone.set_gone(true);
+  cache_.Abandon(kRealm);
+  EXPECT_EQ(0, gone.asks());
+  EXPECT_EQ(1, next.asks());
+  EXPECT_EQ(XWalkHttpAuthRealmCache::WAITING, Lookup(kRealm, true));
+
+  // Without anyone left, the next challenge asks.
+  cache_.Abandon(kRealm);
+  EXPECT_EQ(XWalkHttpAuthRealmCache::ASK, Lookup(kRealm, true));
+}
+
+}  // namespace xwalk
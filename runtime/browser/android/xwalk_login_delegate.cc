@@ -5,6 +5,7 @@
 #include "xwalk/runtime/browser/android/xwalk_login_delegate.h"
 
 #include "base/android/jni_android.h"
+#include "base/command_line.h"
 #include "base/logging.h"
 #include "base/supports_user_data.h"
 #include "content/public/browser/browser_thread.h"
@@ -14,6 +15,8 @@
 #include "content/public/browser/web_contents.h"
 #include "net/base/auth.h"
 #include "net/url_request/url_request.h"
+#include "xwalk/runtime/browser/android/xwalk_http_auth_realm_cache.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
 
 using content::BrowserThread;
 using content::RenderFrameHost;
@@ -39,7 +42,8 @@ XWalkLoginDelegate::XWalkLoginDelegate(net::AuthChallengeInfo* auth_info,
     : auth_info_(auth_info),
       request_(request),
       render_process_id_(0),
-      render_frame_id_(0) {
+      render_frame_id_(0),
+      asking_for_realm_(false) {
     ResourceRequestInfo::GetRenderFrameForRequest(
         request, &render_process_id_, &render_frame_id_);
 
@@ -52,10 +56,18 @@ XWalkLoginDelegate::XWalkLoginDelegate(net::AuthChallengeInfo* auth_info,
       request->SetUserData(kAuthAttemptsKey, count);
     }
 
+    bool first_auth_attempt = count->auth_attempts_ == 0;
+    count->auth_attempts_++;
+    if (CommandLine::ForCurrentProcess()->HasSwitch(
+            switches::kCacheHttpAuthCredentials)) {
+      realm_key_ = XWalkHttpAuthRealmCache::GetRealmKey(*auth_info);
+      if (AnswerFromRealmOnIOThread(first_auth_attempt))
+        return;
+    }
+
     BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
         base::Bind(&XWalkLoginDelegate::HandleHttpAuthRequestOnUIThread,
-                   this, (count->auth_attempts_ == 0)));
-    count->auth_attempts_++;
+                   this, first_auth_attempt));
 }
 
 XWalkLoginDelegate::~XWalkLoginDelegate() {
@@ -102,6 +114,7 @@ void XWalkLoginDelegate::HandleHttpAuthRequestOnUIThread(
 
 void XWalkLoginDelegate::CancelOnIOThread() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  AnswerRealmOnIOThread(NULL);
   if (request_) {
     request_->CancelAuth();
     ResourceDispatcherHost::Get()->ClearLoginDelegateForRequest(request_);
@@ -113,8 +126,10 @@ void XWalkLoginDelegate::CancelOnIOThread() {
 void XWalkLoginDelegate::ProceedOnIOThread(const base::string16& user,
                                            const base::string16& password) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  net::AuthCredentials credentials(user, password);
+  AnswerRealmOnIOThread(&credentials);
   if (request_) {
-    request_->SetAuth(net::AuthCredentials(user, password));
+    request_->SetAuth(credentials);
     ResourceDispatcherHost::Get()->ClearLoginDelegateForRequest(request_);
     request_ = NULL;
   }
@@ -125,6 +140,67 @@ void XWalkLoginDelegate::OnRequestCancelled() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   request_ = NULL;
   DeleteAuthHandlerSoon();
+  if (!asking_for_realm_)
+    return;
+
+  // The next delegate still waiting for the credentials asks for them.
+  asking_for_realm_ = false;
+  XWalkHttpAuthRealmCache::GetInstance()->Abandon(realm_key_);
+}
+
+bool XWalkLoginDelegate::AnswerFromRealmOnIOThread(bool first_auth_attempt) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  net::AuthCredentials credentials;
+  XWalkHttpAuthRealmCache* cache = XWalkHttpAuthRealmCache::GetInstance();
+  switch (cache->Lookup(realm_key_, first_auth_attempt, &credentials)) {
+    case XWalkHttpAuthRealmCache::ANSWERED:
+      // Not from the constructor, the ResourceDispatcherHost doesn't know
+      // about this delegate yet.
+      BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+          base::Bind(&XWalkLoginDelegate::ProceedOnIOThread, this,
+                     credentials.username(), credentials.password()));
+      return true;
+    case XWalkHttpAuthRealmCache::WAITING:
+      cache->Wait(
+          realm_key_,
+          base::Bind(&XWalkLoginDelegate::OnRealmAnsweredOnIOThread, this),
+          base::Bind(&XWalkLoginDelegate::AskForRealmOnIOThread, this));
+      return true;
+    case XWalkHttpAuthRealmCache::ASK:
+      asking_for_realm_ = true;
+      return false;
+  }
+  NOTREACHED();
+  return false;
+}
+
+void XWalkLoginDelegate::AnswerRealmOnIOThread(
+    const net::AuthCredentials* credentials) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!asking_for_realm_)
+    return;
+  asking_for_realm_ = false;
+  XWalkHttpAuthRealmCache::GetInstance()->Answer(realm_key_, credentials);
+}
+
+void XWalkLoginDelegate::OnRealmAnsweredOnIOThread(
+    const net::AuthCredentials* credentials) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (credentials)
+    ProceedOnIOThread(credentials->username(), credentials->password());
+  else
+    CancelOnIOThread();
+}
+
+bool XWalkLoginDelegate::AskForRealmOnIOThread() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!request_)
+    return false;
+  asking_for_realm_ = true;
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&XWalkLoginDelegate::HandleHttpAuthRequestOnUIThread,
+                 this, true));
+  return true;
 }
 
 void XWalkLoginDelegate::DeleteAuthHandlerSoon() {
@@ -5,6 +5,8 @@
 #ifndef XWALK_RUNTIME_BROWSER_ANDROID_XWALK_LOGIN_DELEGATE_H_
 #define XWALK_RUNTIME_BROWSER_ANDROID_XWALK_LOGIN_DELEGATE_H_
 
+#include <string>
+
 #include "xwalk/runtime/browser/android/xwalk_http_auth_handler_base.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -13,6 +15,7 @@
 
 namespace net {
 class AuthChallengeInfo;
+class AuthCredentials;
 class URLRequest;
 }
 
@@ -39,11 +42,30 @@ class XWalkLoginDelegate
                          const base::string16& password);
   void DeleteAuthHandlerSoon();
 
+  // With switches::kCacheHttpAuthCredentials, answers the challenge with the
+  // credentials of its realm or waits for the delegate asking the
+  // application for them. Returns false if the application has to be asked.
+  bool AnswerFromRealmOnIOThread(bool first_auth_attempt);
+  // Passes the answer of the application to the delegates waiting for it,
+  // |credentials| is NULL if it cancelled.
+  void AnswerRealmOnIOThread(const net::AuthCredentials* credentials);
+  // Called on the waiting delegates with the answer of the application.
+  void OnRealmAnsweredOnIOThread(const net::AuthCredentials* credentials);
+  // Asks the application in place of a delegate that went away, returns false
+  // if this one has gone away as well.
+  bool AskForRealmOnIOThread();
+
   scoped_ptr<XWalkHttpAuthHandlerBase> xwalk_http_auth_handler_;
   scoped_refptr<net::AuthChallengeInfo> auth_info_;
   net::URLRequest* request_;
   int render_process_id_;
   int render_frame_id_;
+  // The challenger, scheme and realm of the challenge if the credentials are
+  // cached.
+  std::string realm_key_;
+  // Whether this delegate asks the application for the credentials of its
+  // realm.
+  bool asking_for_realm_;
 };
 
 }  // namespace xwalk
@@ -13,7 +13,8 @@
 #include "net/url_request/url_request_context.h"
 #include "net/url_request/url_request_context_getter.h"
 #include "net/url_request/url_request_job.h"
-#include "xwalk/runtime/browser/android/intercepted_request_data.h"
+#include "xwalk/runtime/browser/android/intercepted_request_data_impl.h"
+#include "xwalk/runtime/browser/android/intercepted_response_cache.h"
 #include "xwalk/runtime/browser/android/xwalk_contents_io_thread_client.h"
 
 using content::BrowserThread;
@@ -67,10 +68,25 @@ XWalkRequestInterceptor::QueryForInterceptedRequestData(
   scoped_ptr<XWalkContentsIoThreadClient> io_thread_client =
     XWalkContentsIoThreadClient::FromID(render_process_id, render_frame_id);
 
-  if (!io_thread_client.get())
+  if (!io_thread_client.get() ||
+      !io_thread_client->MayInterceptRequest(location, request))
     return scoped_ptr<InterceptedRequestData>();
 
-  return io_thread_client->ShouldInterceptRequest(location, request).Pass();
+  if (!io_thread_client->ShouldCacheInterceptedResponses())
+    return io_thread_client->ShouldInterceptRequest(location, request).Pass();
+
+  scoped_refptr<InterceptedResponse> cached_response =
+      InterceptedResponseCache::GetInstance()->Get(location);
+  if (cached_response) {
+    return make_scoped_ptr<InterceptedRequestData>(
+        new CachedInterceptedRequestData(cached_response));
+  }
+
+  scoped_ptr<InterceptedRequestData> intercepted_request_data =
+      io_thread_client->ShouldInterceptRequest(location, request);
+  if (intercepted_request_data)
+    intercepted_request_data->set_cacheable(true);
+  return intercepted_request_data.Pass();
 }
 
 net::URLRequestJob* XWalkRequestInterceptor::MaybeInterceptRequest(
@@ -17,6 +17,8 @@
 #include "jni/XWalkSettings_jni.h"
 #include "webkit/common/webpreferences.h"
 #include "xwalk/runtime/common/xwalk_content_client.h"
+#include "xwalk/runtime/browser/android/intercept_patterns.h"
+#include "xwalk/runtime/browser/android/intercepted_response_cache.h"
 #include "xwalk/runtime/browser/android/renderer_host/xwalk_render_view_host_ext.h"
 #include "xwalk/runtime/browser/android/xwalk_content.h"
 
@@ -87,10 +89,38 @@ struct XWalkSettings::FieldIds {
   jfieldID default_video_poster_url;
 };
 
+namespace {
+
+// Compares the preferences set by UpdateWebkitPreferences().
+bool HaveSettingsChanged(const WebPreferences& a, const WebPreferences& b) {
+  return a.allow_scripts_to_close_windows != b.allow_scripts_to_close_windows ||
+      a.loads_images_automatically != b.loads_images_automatically ||
+      a.images_enabled != b.images_enabled ||
+      a.javascript_enabled != b.javascript_enabled ||
+      a.allow_universal_access_from_file_urls !=
+          b.allow_universal_access_from_file_urls ||
+      a.allow_file_access_from_file_urls !=
+          b.allow_file_access_from_file_urls ||
+      a.javascript_can_open_windows_automatically !=
+          b.javascript_can_open_windows_automatically ||
+      a.supports_multiple_windows != b.supports_multiple_windows ||
+      a.application_cache_enabled != b.application_cache_enabled ||
+      a.local_storage_enabled != b.local_storage_enabled ||
+      a.databases_enabled != b.databases_enabled ||
+      a.double_tap_to_zoom_enabled != b.double_tap_to_zoom_enabled ||
+      a.use_wide_viewport != b.use_wide_viewport ||
+      a.user_gesture_required_for_media_playback !=
+          b.user_gesture_required_for_media_playback ||
+      a.default_video_poster_url != b.default_video_poster_url;
+}
+
+}  // namespace
+
 XWalkSettings::XWalkSettings(JNIEnv* env, jobject obj, jlong web_contents)
     : WebContentsObserver(
           reinterpret_cast<content::WebContents*>(web_contents)),
-      xwalk_settings_(env, obj) {
+      xwalk_settings_(env, obj),
+      intercept_patterns_(InterceptPatterns::FromWebContents(web_contents())) {
 }
 
 XWalkSettings::~XWalkSettings() {
@@ -157,7 +187,8 @@ void XWalkSettings::UpdateWebkitPreferences(JNIEnv* env, jobject obj) {
   content::RenderViewHost* render_view_host =
       web_contents()->GetRenderViewHost();
   if (!render_view_host) return;
-  WebPreferences prefs = render_view_host->GetWebkitPreferences();
+  const WebPreferences current_prefs = render_view_host->GetWebkitPreferences();
+  WebPreferences prefs = current_prefs;
 
   prefs.allow_scripts_to_close_windows =
       env->GetBooleanField(obj, field_ids_->allow_scripts_to_close_windows);
@@ -205,9 +236,36 @@ void XWalkSettings::UpdateWebkitPreferences(JNIEnv* env, jobject obj) {
   prefs.default_video_poster_url = str.obj() ?
       GURL(ConvertJavaStringToUTF8(str)) : GURL();
 
+  // Pushing the preferences makes the renderer recompute the styles of the
+  // page, skip it when none of the ones above changed.
+  if (!HaveSettingsChanged(current_prefs, prefs))
+    return;
+
   render_view_host->UpdateWebkitPreferences(prefs);
 }
 
+void XWalkSettings::AddInterceptPattern(JNIEnv* env, jobject obj,
+                                        jstring scheme, jstring host,
+                                        jstring path_prefix,
+                                        jint resource_types) {
+  using base::android::ConvertJavaStringToUTF8;
+  intercept_patterns_->Add(
+      scheme ? ConvertJavaStringToUTF8(env, scheme) : std::string(),
+      host ? ConvertJavaStringToUTF8(env, host) : std::string(),
+      path_prefix ? ConvertJavaStringToUTF8(env, path_prefix) : std::string(),
+      resource_types);
+}
+
+void XWalkSettings::ClearInterceptPatterns(JNIEnv* env, jobject obj) {
+  intercept_patterns_->Clear();
+}
+
+void XWalkSettings::ClearGeolocationDecisions(JNIEnv* env, jobject obj) {
+  XWalkContent* contents = XWalkContent::FromWebContents(web_contents());
+  if (contents)
+    contents->ClearGeolocationDecisions();
+}
+
 void XWalkSettings::RenderViewCreated(
     content::RenderViewHost* render_view_host) {
   // A single WebContents can normally have 0 to many RenderViewHost instances
@@ -236,6 +294,21 @@ static jstring GetDefaultUserAgent(JNIEnv* env, jclass clazz) {
       env, GetUserAgent()).Release();
 }
 
+static void InvalidateInterceptedResponseCache(JNIEnv* env,
+                                               jclass clazz,
+                                               jstring url) {
+  InterceptedResponseCache* cache = InterceptedResponseCache::GetInstance();
+  if (!url) {
+    cache->Clear();
+    return;
+  }
+  cache->Remove(GURL(base::android::ConvertJavaStringToUTF8(env, url)));
+}
+
+static jint GetSkippedInterceptRequestCount(JNIEnv* env, jclass clazz) {
+  return InterceptPatterns::GetSkippedRequestCount();
+}
+
 bool RegisterXWalkSettings(JNIEnv* env) {
   return RegisterNativesImpl(env) >= 0;
 }
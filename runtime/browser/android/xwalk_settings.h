@@ -9,11 +9,13 @@
 
 #include "base/android/jni_weak_ref.h"
 #include "base/android/scoped_java_ref.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "content/public/browser/web_contents_observer.h"
 
 namespace xwalk {
 
+class InterceptPatterns;
 class XWalkRenderViewHostExt;
 
 class XWalkSettings : public content::WebContentsObserver {
@@ -28,6 +30,11 @@ class XWalkSettings : public content::WebContentsObserver {
   void UpdateInitialPageScale(JNIEnv* env, jobject obj);
   void UpdateUserAgent(JNIEnv* env, jobject obj);
   void UpdateWebkitPreferences(JNIEnv* env, jobject obj);
+  void AddInterceptPattern(JNIEnv* env, jobject obj, jstring scheme,
+                           jstring host, jstring path_prefix,
+                           jint resource_types);
+  void ClearInterceptPatterns(JNIEnv* env, jobject obj);
+  void ClearGeolocationDecisions(JNIEnv* env, jobject obj);
 
  private:
   struct FieldIds;
@@ -44,6 +51,9 @@ class XWalkSettings : public content::WebContentsObserver {
   scoped_ptr<FieldIds> field_ids_;
 
   JavaObjectWeakGlobalRef xwalk_settings_;
+
+  // Taken on the UI thread, so the patterns can be updated from any thread.
+  scoped_refptr<InterceptPatterns> intercept_patterns_;
 };
 
 bool RegisterXWalkSettings(JNIEnv* env);
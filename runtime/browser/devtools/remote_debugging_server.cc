@@ -4,13 +4,32 @@
 
 #include "xwalk/runtime/browser/devtools/remote_debugging_server.h"
 
+#if defined(OS_POSIX)
+#include <unistd.h>
+#endif
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
 #include "xwalk/runtime/browser/devtools/xwalk_devtools_delegate.h"
 #include "xwalk/runtime/browser/runtime_context.h"
 #include "content/public/browser/devtools_http_handler.h"
 #include "net/socket/tcp_listen_socket.h"
+#if defined(OS_POSIX)
+#include "net/socket/unix_domain_socket_posix.h"
+#endif
 
 namespace xwalk {
 
+#if defined(OS_POSIX)
+namespace {
+
+bool CanUserConnect(uid_t uid, gid_t gid) {
+  return uid == geteuid();
+}
+
+}  // namespace
+#endif
+
 RemoteDebuggingServer::RemoteDebuggingServer(
     RuntimeContext* runtime_context,
     const std::string& ip,
@@ -23,6 +42,20 @@ RemoteDebuggingServer::RemoteDebuggingServer(
       base::FilePath());
 }
 
+#if defined(OS_POSIX)
+RemoteDebuggingServer::RemoteDebuggingServer(
+    RuntimeContext* runtime_context,
+    const base::FilePath& socket_path,
+    const std::string& frontend_url) {
+  devtools_http_handler_ = content::DevToolsHttpHandler::Start(
+      new net::UnixDomainSocketFactory(socket_path.value(),
+                                       base::Bind(&CanUserConnect)),
+      frontend_url,
+      new XWalkDevToolsDelegate(runtime_context),
+      base::FilePath());
+}
+#endif
+
 RemoteDebuggingServer::~RemoteDebuggingServer() {
   devtools_http_handler_->Stop();
 }
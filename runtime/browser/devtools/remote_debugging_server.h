@@ -9,6 +9,10 @@
 
 #include "base/basictypes.h"
 
+namespace base {
+class FilePath;
+}
+
 namespace content {
 class DevToolsHttpHandler;
 }
@@ -23,6 +27,13 @@ class RemoteDebuggingServer {
                         const std::string& ip,
                         int port,
                         const std::string& frontend_url);
+#if defined(OS_POSIX)
+  // Listens on the Unix socket at |socket_path| instead, only the processes
+  // of the same user are allowed to connect.
+  RemoteDebuggingServer(RuntimeContext* runtime_context,
+                        const base::FilePath& socket_path,
+                        const std::string& frontend_url);
+#endif
 
   virtual ~RemoteDebuggingServer();
 
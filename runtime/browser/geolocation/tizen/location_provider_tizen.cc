@@ -4,42 +4,90 @@
 
 #include "xwalk/runtime/browser/geolocation/tizen/location_provider_tizen.h"
 
+#include <math.h>
+#include <algorithm>
+
 #include "base/bind.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
 #include "base/time/time.h"
-#include "content/public/common/geoposition.h"
 
 namespace xwalk {
 
+namespace {
+
+// The update intervals of the location framework, in seconds, and the
+// distances under which updates are coalesced, in meters.
+const int kHighAccuracyInterval = 1;
+const double kHighAccuracyMinDistance = 5;
+const int kLowAccuracyInterval = 10;
+const double kLowAccuracyMinDistance = 50;
+
+// Coalesced positions are still reported after this long, so the page knows
+// the fix is alive.
+const int kMaxCoalescingSeconds = 30;
+
+const double kEarthRadiusMeters = 6371000;
+
+// The last position of any provider. The providers are recreated each time
+// the pages stop and start watching, they answer with this fix until the
+// location framework gives them a new one. Only used on the geolocation
+// thread.
+base::LazyInstance<content::Geoposition> g_cached_position =
+    LAZY_INSTANCE_INITIALIZER;
+
+double ToRadians(double degrees) {
+  return degrees * M_PI / 180;
+}
+
+// The great-circle distance between two positions.
+double DistanceInMeters(const content::Geoposition& a,
+                        const content::Geoposition& b) {
+  double delta_latitude = ToRadians(b.latitude - a.latitude);
+  double delta_longitude = ToRadians(b.longitude - a.longitude);
+  double h = sin(delta_latitude / 2) * sin(delta_latitude / 2) +
+      cos(ToRadians(a.latitude)) * cos(ToRadians(b.latitude)) *
+      sin(delta_longitude / 2) * sin(delta_longitude / 2);
+  return 2 * kEarthRadiusMeters * atan2(sqrt(h), sqrt(1 - h));
+}
+
+}  // namespace
+
 LocationProviderTizen::LocationProviderTizen()
   : manager_(NULL),
+    method_(LOCATIONS_METHOD_GPS),
+    high_accuracy_(false),
     geolocation_message_loop_(base::MessageLoop::current()),
-    is_permission_granted_(false) {}
+    is_permission_granted_(false) {
+  if (g_cached_position.Get().Validate())
+    last_position_ = g_cached_position.Get();
+}
 
 LocationProviderTizen::~LocationProviderTizen() {
   StopProvider();
 }
 
 bool LocationProviderTizen::StartProvider(bool high_accuracy) {
-  // Tizen location framework doesn't have API that could be used to set
-  // preferred accuracy. Accuracy would be provided by the framework when
-  // position is updated.
-  if (InitLocationManager() && is_permission_granted_)
+  high_accuracy_ = high_accuracy;
+  // FIXME(shalamov): Tizen location manager throws critical error when
+  // hybrid location method is used, so there is no hybrid tier.
+  location_method_e method =
+      high_accuracy ? LOCATIONS_METHOD_GPS : LOCATIONS_METHOD_WPS;
+  if (manager_ && method != method_)
+    DestroyLocationManager();
+
+  if (InitLocationManager(method) && is_permission_granted_)
     return location_manager_start(manager_) == LOCATIONS_ERROR_NONE;
 
   return false;
 }
 
 void LocationProviderTizen::StopProvider() {
-  if (manager_) {
-    location_manager_unset_position_updated_cb(manager_);
-    location_manager_stop(manager_);
-    location_manager_destroy(manager_);
-    manager_ = NULL;
-  } else {
+  if (manager_)
+    DestroyLocationManager();
+  else
     LOG(WARNING) << "Location manager not initialized.";
-  }
 }
 
 void LocationProviderTizen::GetPosition(content::Geoposition* position) {
@@ -53,28 +101,33 @@ void LocationProviderTizen::RequestRefresh() {
 void LocationProviderTizen::OnPermissionGranted() {
   is_permission_granted_ = true;
   if (manager_)
-    StartProvider(true);
+    StartProvider(high_accuracy_);
 }
 
-bool LocationProviderTizen::InitLocationManager() {
+bool LocationProviderTizen::InitLocationManager(location_method_e method) {
   if (manager_)
     return true;
 
-  // FIXME(shalamov): Tizen location manager throws critical error when
-  // hybrid location method is used. Using GPS until it is fixed.
-  int ret = location_manager_create(LOCATIONS_METHOD_GPS, &manager_);
+  int ret = location_manager_create(method, &manager_);
   if (ret != LOCATIONS_ERROR_NONE) {
     LOG(ERROR) << "Cannot create location manager.";
     manager_ = NULL;
     return false;
   }
+  method_ = method;
 
   ret = location_manager_set_service_state_changed_cb(manager_,
          &LocationProviderTizen::OnStateChanged,
          this);
+  if (ret == LOCATIONS_ERROR_NONE) {
+    ret = location_manager_set_position_updated_cb(manager_,
+        &LocationProviderTizen::OnPositionChanged,
+        high_accuracy_ ? kHighAccuracyInterval : kLowAccuracyInterval,
+        this);
+  }
 
   if (ret != LOCATIONS_ERROR_NONE) {
-    location_manager_unset_position_updated_cb(manager_);
+    location_manager_unset_service_state_changed_cb(manager_);
     location_manager_destroy(manager_);
     manager_ = NULL;
     return false;
@@ -83,51 +136,106 @@ bool LocationProviderTizen::InitLocationManager() {
   return true;
 }
 
-void LocationProviderTizen::NotifyLocationProvider() {
+void LocationProviderTizen::DestroyLocationManager() {
+  location_manager_unset_position_updated_cb(manager_);
+  location_manager_unset_service_state_changed_cb(manager_);
+  location_manager_stop(manager_);
+  location_manager_destroy(manager_);
+  manager_ = NULL;
+}
+
+void LocationProviderTizen::NotifyLocationProvider(double latitude,
+                                                   double longitude,
+                                                   double altitude,
+                                                   time_t timestamp) {
   DCHECK(manager_);
-  int ret;
   content::Geoposition pos;
-  time_t timestamp;
-  ret = location_manager_get_position(manager_,
-                                      &pos.altitude,
-                                      &pos.latitude,
-                                      &pos.longitude,
-                                      &timestamp);
+  pos.latitude = latitude;
+  pos.longitude = longitude;
+  pos.altitude = altitude;
   pos.timestamp = base::Time::FromTimeT(timestamp);
 
-  if (ret != LOCATIONS_ERROR_NONE) {
-    LOG(ERROR) << "Cannot retrieve position from location manager.";
-    return;
-  }
-
   location_accuracy_level_e level;
   double horizontal;
   double vertical;
-  ret = location_manager_get_accuracy(manager_,
-                                      &level,
-                                      &horizontal,
-                                      &vertical);
+  int ret = location_manager_get_accuracy(manager_,
+                                          &level,
+                                          &horizontal,
+                                          &vertical);
 
   if (ret != LOCATIONS_ERROR_NONE)
     LOG(ERROR) << "Cannot retrieve position accuracy from location manager.";
   else
     pos.accuracy = (horizontal / 2) + (vertical / 2);
 
-  last_position_ = pos;
   if (geolocation_message_loop_) {
-    base::Closure task = base::Bind(&LocationProviderTizen::NotifyCallback,
+    base::Closure task = base::Bind(&LocationProviderTizen::OnPositionUpdated,
                                     base::Unretained(this),
-                                    last_position_);
+                                    pos);
     geolocation_message_loop_->PostTask(FROM_HERE, task);
   }
 }
 
+void LocationProviderTizen::OnPositionUpdated(
+    const content::Geoposition& position) {
+  last_position_ = position;
+  if (position.Validate())
+    g_cached_position.Get() = position;
+
+  if (!ShouldReportPosition(position))
+    return;
+  last_reported_position_ = position;
+  NotifyCallback(position);
+}
+
+bool LocationProviderTizen::ShouldReportPosition(
+    const content::Geoposition& position) const {
+  if (!position.Validate() || !last_reported_position_.Validate())
+    return true;
+  if (position.accuracy < last_reported_position_.accuracy)
+    return true;
+  if (position.timestamp - last_reported_position_.timestamp >=
+      base::TimeDelta::FromSeconds(kMaxCoalescingSeconds))
+    return true;
+
+  // Moves within the accuracy of the fix are noise.
+  double min_distance = std::max(
+      high_accuracy_ ? kHighAccuracyMinDistance : kLowAccuracyMinDistance,
+      position.accuracy);
+  return DistanceInMeters(last_reported_position_, position) >= min_distance;
+}
+
 void LocationProviderTizen::OnStateChanged(location_service_state_e state,
                                            void* data) {
   DCHECK(data);
   LocationProviderTizen* impl = static_cast<LocationProviderTizen*>(data);
-  if (state == LOCATIONS_SERVICE_ENABLED)
-    impl->NotifyLocationProvider();
+  if (state != LOCATIONS_SERVICE_ENABLED)
+    return;
+
+  double altitude;
+  double latitude;
+  double longitude;
+  time_t timestamp;
+  int ret = location_manager_get_position(impl->manager_,
+                                          &altitude,
+                                          &latitude,
+                                          &longitude,
+                                          &timestamp);
+  if (ret != LOCATIONS_ERROR_NONE) {
+    LOG(ERROR) << "Cannot retrieve position from location manager.";
+    return;
+  }
+  impl->NotifyLocationProvider(latitude, longitude, altitude, timestamp);
+}
+
+void LocationProviderTizen::OnPositionChanged(double latitude,
+                                              double longitude,
+                                              double altitude,
+                                              time_t timestamp,
+                                              void* data) {
+  DCHECK(data);
+  static_cast<LocationProviderTizen*>(data)->NotifyLocationProvider(
+      latitude, longitude, altitude, timestamp);
 }
 
 }  // namespace xwalk
@@ -10,16 +10,23 @@
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
 #include "content/browser/geolocation/location_provider_base.h"
-
-namespace content {
-struct Geoposition;
-}
+#include "content/public/common/geoposition.h"
 
 namespace base {
 class MessageLoop;
 }
 
 namespace xwalk {
+
+// The system location provider on Tizen. The location method follows the
+// accuracy asked for: GPS for high accuracy, the cheaper WPS otherwise, so
+// pages not needing a precise fix don't keep the GPS on.
+//
+// Updates are coalesced: a position closer than the distance threshold of
+// the current method to the last reported one is kept for GetPosition() but
+// not reported, unless it is more accurate or the last report is getting
+// old. This avoids waking up the renderers for jitter below the accuracy of
+// the fix.
 class LocationProviderTizen : public content::LocationProviderBase {
  public:
   LocationProviderTizen();
@@ -33,13 +40,24 @@ class LocationProviderTizen : public content::LocationProviderBase {
   virtual void OnPermissionGranted() OVERRIDE;
 
  private:
-  bool InitLocationManager();
-  void NotifyLocationProvider();
+  bool InitLocationManager(location_method_e method);
+  void DestroyLocationManager();
+  // Called on the thread of the location framework.
+  void NotifyLocationProvider(double latitude, double longitude,
+                              double altitude, time_t timestamp);
+  void OnPositionUpdated(const content::Geoposition& position);
+  bool ShouldReportPosition(const content::Geoposition& position) const;
   static void OnStateChanged(location_service_state_e state, void *data);
+  static void OnPositionChanged(double latitude, double longitude,
+                                double altitude, time_t timestamp,
+                                void* data);
 
  private:
   location_manager_h manager_;
+  location_method_e method_;
+  bool high_accuracy_;
   content::Geoposition last_position_;
+  content::Geoposition last_reported_position_;
   base::MessageLoop* geolocation_message_loop_;
   bool is_permission_granted_;
   DISALLOW_COPY_AND_ASSIGN(LocationProviderTizen);
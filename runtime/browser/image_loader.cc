@@ -0,0 +1,86 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/image_loader.h"
+
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "base/task_runner_util.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "content/public/browser/browser_thread.h"
+#include "xwalk/runtime/browser/image_util.h"
+
+namespace xwalk {
+
+namespace {
+
+struct SharedImageLoader {
+  SharedImageLoader()
+      : loader(content::BrowserThread::GetBlockingPool()->
+                   GetTaskRunnerWithShutdownBehavior(
+                       base::SequencedWorkerPool::SKIP_ON_SHUTDOWN),
+               ImageLoader::kMaxCachedImages) {}
+
+  ImageLoader loader;
+};
+
+base::LazyInstance<SharedImageLoader>::Leaky g_shared_image_loader =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// static
+ImageLoader* ImageLoader::GetInstance() {
+  return &g_shared_image_loader.Get().loader;
+}
+
+ImageLoader::ImageLoader(
+    const scoped_refptr<base::TaskRunner>& decode_task_runner,
+    size_t max_cached_images)
+    : decode_task_runner_(decode_task_runner),
+      cache_(max_cached_images),
+      weak_factory_(this) {
+}
+
+ImageLoader::~ImageLoader() {
+}
+
+void ImageLoader::LoadImage(const base::FilePath& path,
+                            const LoadedCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  base::MRUCache<base::FilePath, gfx::Image>::iterator it = cache_.Get(path);
+  if (it != cache_.end()) {
+    callback.Run(it->second);
+    return;
+  }
+
+  std::vector<LoadedCallback>& callbacks = pending_[path];
+  callbacks.push_back(callback);
+  if (callbacks.size() > 1)
+    return;
+
+  base::PostTaskAndReplyWithResult(
+      decode_task_runner_.get(), FROM_HERE,
+      base::Bind(&xwalk_utils::DecodeImageFromFilePath, path),
+      base::Bind(&ImageLoader::OnImageDecoded,
+                 weak_factory_.GetWeakPtr(), path));
+}
+
+void ImageLoader::OnImageDecoded(const base::FilePath& path,
+                                 const SkBitmap& bitmap) {
+  DCHECK(CalledOnValidThread());
+  gfx::Image image;
+  if (!bitmap.isNull()) {
+    image = gfx::Image::CreateFrom1xBitmap(bitmap);
+    cache_.Put(path, image);
+  }
+
+  std::vector<LoadedCallback> callbacks;
+  callbacks.swap(pending_[path]);
+  pending_.erase(path);
+  for (size_t i = 0; i < callbacks.size(); ++i)
+    callbacks[i].Run(image);
+}
+
+}  // namespace xwalk
@@ -0,0 +1,66 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_IMAGE_LOADER_H_
+#define XWALK_RUNTIME_BROWSER_IMAGE_LOADER_H_
+
+#include <map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "ui/gfx/image/image.h"
+
+class SkBitmap;
+
+namespace base {
+class TaskRunner;
+}
+
+namespace xwalk {
+
+// Loads the icons of the windows from their files. The files are read and
+// decoded on |decode_task_runner|, and the most recently used images are kept
+// decoded, so the windows of the same application, which usually share an
+// icon, only decode it once. The loads of a file in progress are merged.
+//
+// Used on the UI thread.
+class ImageLoader : public base::NonThreadSafe {
+ public:
+  typedef base::Callback<void(const gfx::Image& image)> LoadedCallback;
+
+  static const size_t kMaxCachedImages = 16;
+
+  // The instance shared by the runtimes, which decodes on the blocking pool.
+  static ImageLoader* GetInstance();
+
+  ImageLoader(const scoped_refptr<base::TaskRunner>& decode_task_runner,
+              size_t max_cached_images);
+  ~ImageLoader();
+
+  // Runs |callback| with the image, an empty one if the file couldn't be
+  // decoded. |callback| is run before returning when the image is cached.
+  void LoadImage(const base::FilePath& path, const LoadedCallback& callback);
+
+  size_t cached_images() const { return cache_.size(); }
+
+ private:
+  void OnImageDecoded(const base::FilePath& path, const SkBitmap& bitmap);
+
+  scoped_refptr<base::TaskRunner> decode_task_runner_;
+  base::MRUCache<base::FilePath, gfx::Image> cache_;
+  // The callbacks waiting for the images being decoded.
+  std::map<base::FilePath, std::vector<LoadedCallback> > pending_;
+  base::WeakPtrFactory<ImageLoader> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImageLoader);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_IMAGE_LOADER_H_
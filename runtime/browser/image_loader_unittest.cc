@@ -0,0 +1,95 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/image_loader.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/codec/png_codec.h"
+
+using xwalk::ImageLoader;
+
+namespace {
+
+void StoreImage(std::vector<gfx::Image>* images, const gfx::Image& image) {
+  images->push_back(image);
+}
+
+}  // namespace
+
+class ImageLoaderTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+  base::FilePath WritePNG(const char* name, int size) {
+    SkBitmap bitmap;
+    bitmap.setConfig(SkBitmap::kARGB_8888_Config, size, size);
+    bitmap.allocPixels();
+    bitmap.eraseARGB(255, 0, 128, 255);
+    std::vector<unsigned char> data;
+    EXPECT_TRUE(gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &data));
+    base::FilePath path = temp_dir_.path().AppendASCII(name);
+    EXPECT_EQ(static_cast<int>(data.size()),
+              base::WriteFile(path, reinterpret_cast<const char*>(&data[0]),
+                              data.size()));
+    return path;
+  }
+
+  ImageLoader::LoadedCallback StoreIn(std::vector<gfx::Image>* images) {
+    return base::Bind(&StoreImage, base::Unretained(images));
+  }
+
+  base::MessageLoop message_loop_;
+  base::ScopedTempDir temp_dir_;
+};
+
+TEST_F(ImageLoaderTest, DecodesOnceAndCaches) {
+  ImageLoader loader(base::MessageLoopProxy::current(), 4);
+  base::FilePath path = WritePNG("icon.png", 48);
+
+  std::vector<gfx::Image> images;
+  loader.LoadImage(path, StoreIn(&images));
+  loader.LoadImage(path, StoreIn(&images));
+  EXPECT_TRUE(images.empty());
+
+  message_loop_.RunUntilIdle();
+  ASSERT_EQ(2u, images.size());
+  EXPECT_EQ(48, images[0].Width());
+  EXPECT_EQ(1u, loader.cached_images());
+
+  // Served from the cache, before returning.
+  loader.LoadImage(path, StoreIn(&images));
+  ASSERT_EQ(3u, images.size());
+  EXPECT_EQ(48, images[2].Height());
+}
+
+TEST_F(ImageLoaderTest, EvictsLeastRecentlyUsed) {
+  ImageLoader loader(base::MessageLoopProxy::current(), 1);
+  std::vector<gfx::Image> images;
+  loader.LoadImage(WritePNG("small.png", 16), StoreIn(&images));
+  loader.LoadImage(WritePNG("large.png", 64), StoreIn(&images));
+  message_loop_.RunUntilIdle();
+  ASSERT_EQ(2u, images.size());
+  EXPECT_EQ(1u, loader.cached_images());
+}
+
+TEST_F(ImageLoaderTest, DoesNotCacheFailures) {
+  ImageLoader loader(base::MessageLoopProxy::current(), 4);
+  std::vector<gfx::Image> images;
+  loader.LoadImage(temp_dir_.path().AppendASCII("missing.png"),
+                   StoreIn(&images));
+  message_loop_.RunUntilIdle();
+  ASSERT_EQ(1u, images.size());
+  EXPECT_TRUE(images[0].IsEmpty());
+  EXPECT_EQ(0u, loader.cached_images());
+}
@@ -8,8 +8,8 @@
 
 #include "base/file_util.h"
 #include "base/strings/string_util.h"
-#include "ui/gfx/image/image_skia.h"
-#include "ui/gfx/image/image_util.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
 #include "ui/gfx/size.h"
 
 #if defined(OS_WIN)
@@ -19,26 +19,39 @@
 namespace xwalk_utils {
 
 gfx::Image LoadImageFromFilePath(const base::FilePath& filename) {
+  SkBitmap bitmap = DecodeImageFromFilePath(filename);
+  if (bitmap.isNull())
+    return gfx::Image();
+  return gfx::Image::CreateFrom1xBitmap(bitmap);
+}
+
+SkBitmap DecodeImageFromFilePath(const base::FilePath& filename) {
   const base::FilePath::StringType kPNGFormat(FILE_PATH_LITERAL(".png"));
   const base::FilePath::StringType kICOFormat(FILE_PATH_LITERAL(".ico"));
   const base::FilePath::StringType kJPGFormat(FILE_PATH_LITERAL(".jpg"));
   const base::FilePath::StringType kJPEGFormat(FILE_PATH_LITERAL(".jpeg"));
 
+  SkBitmap bitmap;
   if (EndsWith(filename.value(), kPNGFormat, false)) {
     std::string contents;
     base::ReadFileToString(filename, &contents);
-    return gfx::Image::CreateFrom1xPNGBytes(
-        reinterpret_cast<const unsigned char*>(contents.data()),
-            contents.size());
+    if (!gfx::PNGCodec::Decode(
+            reinterpret_cast<const unsigned char*>(contents.data()),
+            contents.size(), &bitmap))
+      return SkBitmap();
+    return bitmap;
   }
 
   if (EndsWith(filename.value(), kJPGFormat, false) ||
       EndsWith(filename.value(), kJPEGFormat, false)) {
     std::string contents;
     base::ReadFileToString(filename, &contents);
-    return gfx::ImageFrom1xJPEGEncodedData(
+    scoped_ptr<SkBitmap> decoded(gfx::JPEGCodec::Decode(
         reinterpret_cast<const unsigned char*>(contents.data()),
-        contents.size());
+        contents.size()));
+    if (decoded)
+      bitmap = *decoded;
+    return bitmap;
   }
 
   if (EndsWith(filename.value(), kICOFormat, false)) {
@@ -50,28 +63,25 @@ gfx::Image LoadImageFromFilePath(const base::FilePath& filename) {
                                     0,
                                     LR_LOADTRANSPARENT | LR_LOADFROMFILE));
     if (icon == NULL)
-      return gfx::Image();
+      return bitmap;
 
-    gfx::Image image;
-    scoped_ptr<SkBitmap> bitmap(IconUtil::CreateSkBitmapFromHICON(icon));
-    if (bitmap.get()) {
-      gfx::ImageSkia image_skia = gfx::ImageSkia::CreateFrom1xBitmap(*bitmap);
-      image = gfx::Image(image_skia);
-    }
+    scoped_ptr<SkBitmap> decoded(IconUtil::CreateSkBitmapFromHICON(icon));
+    if (decoded.get())
+      bitmap = *decoded;
     DestroyIcon(icon);
 
-    return image;
+    return bitmap;
 #elif defined(USE_AURA) && defined(OS_LINUX)
     NOTIMPLEMENTED();
-    return gfx::Image();
+    return bitmap;
 #else
   NOTREACHED();
-  return gfx::Image();
+  return bitmap;
 #endif
   }
 
   LOG(INFO) << "Only support png and ico file format.";
-  return gfx::Image();
+  return bitmap;
 }
 
 }  // namespace xwalk_utils
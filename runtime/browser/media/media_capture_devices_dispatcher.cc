@@ -71,7 +71,9 @@ void XWalkMediaCaptureDevicesDispatcher::RunRequestMediaAccessPermission(
                scoped_ptr<content::MediaStreamUI>());
 }
 
-XWalkMediaCaptureDevicesDispatcher::XWalkMediaCaptureDevicesDispatcher() {}
+XWalkMediaCaptureDevicesDispatcher::XWalkMediaCaptureDevicesDispatcher()
+    : has_audio_devices_(false),
+      has_video_devices_(false) {}
 
 XWalkMediaCaptureDevicesDispatcher::~XWalkMediaCaptureDevicesDispatcher() {}
 
@@ -92,7 +94,14 @@ XWalkMediaCaptureDevicesDispatcher::GetAudioCaptureDevices() {
   if (!test_audio_devices_.empty())
     return test_audio_devices_;
 
-  return MediaCaptureDevices::GetInstance()->GetAudioCaptureDevices();
+  // A list read before the first enumeration is done may be empty, the end
+  // of the enumeration is reported as a change too.
+  if (!has_audio_devices_) {
+    audio_devices_ =
+        MediaCaptureDevices::GetInstance()->GetAudioCaptureDevices();
+    has_audio_devices_ = true;
+  }
+  return audio_devices_;
 }
 
 const MediaStreamDevices&
@@ -101,7 +110,12 @@ XWalkMediaCaptureDevicesDispatcher::GetVideoCaptureDevices() {
   if (!test_video_devices_.empty())
     return test_video_devices_;
 
-  return MediaCaptureDevices::GetInstance()->GetVideoCaptureDevices();
+  if (!has_video_devices_) {
+    video_devices_ =
+        MediaCaptureDevices::GetInstance()->GetVideoCaptureDevices();
+    has_video_devices_ = true;
+  }
+  return video_devices_;
 }
 
 void XWalkMediaCaptureDevicesDispatcher::GetRequestedDevice(
@@ -164,12 +178,14 @@ void XWalkMediaCaptureDevicesDispatcher::OnMediaRequestStateChanged(
 }
 
 void XWalkMediaCaptureDevicesDispatcher::NotifyAudioDevicesChangedOnUIThread() {
+  has_audio_devices_ = false;
   MediaStreamDevices devices = GetAudioCaptureDevices();
   FOR_EACH_OBSERVER(Observer, observers_,
                     OnUpdateAudioDevices(devices));
 }
 
 void XWalkMediaCaptureDevicesDispatcher::NotifyVideoDevicesChangedOnUIThread() {
+  has_video_devices_ = false;
   MediaStreamDevices devices = GetVideoCaptureDevices();
   FOR_EACH_OBSERVER(Observer, observers_,
                     OnUpdateVideoDevices(devices));
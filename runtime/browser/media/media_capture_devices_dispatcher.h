@@ -54,6 +54,9 @@ class XWalkMediaCaptureDevicesDispatcher : public content::MediaObserver {
   // on destruction.
   void AddObserver(Observer* observer);
   void RemoveObserver(Observer* observer);
+  // The device lists are copied once from MediaCaptureDevices and kept until
+  // the content layer reports a change, instead of being queried again for
+  // each media access request.
   const content::MediaStreamDevices& GetAudioCaptureDevices();
   const content::MediaStreamDevices& GetVideoCaptureDevices();
 
@@ -109,6 +112,13 @@ class XWalkMediaCaptureDevicesDispatcher : public content::MediaObserver {
       const content::MediaStreamDevice& device,
       content::MediaRequestState state);
 
+  // The devices last read from MediaCaptureDevices, valid while the
+  // has_*_devices_ flags are set.
+  content::MediaStreamDevices audio_devices_;
+  content::MediaStreamDevices video_devices_;
+  bool has_audio_devices_;
+  bool has_video_devices_;
+
   // Only for testing, a list of cached audio capture devices.
   content::MediaStreamDevices test_audio_devices_;
 
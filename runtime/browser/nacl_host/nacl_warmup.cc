@@ -0,0 +1,67 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/nacl_host/nacl_warmup.h"
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "components/nacl/browser/nacl_browser.h"
+#include "components/nacl/browser/nacl_browser_delegate.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace {
+
+const int kReadBufferSize = 1024 * 1024;
+
+// The translator files are only read once per browser process, they stay in
+// the page cache for the next launches.
+bool g_pnacl_files_read = false;
+
+// Reads the files of the translator so they are in the page cache when the
+// first translation needs them.
+void ReadPnaclFiles(const base::FilePath& pnacl_dir) {
+  scoped_ptr<char[]> buffer(new char[kReadBufferSize]);
+  base::FileEnumerator files(pnacl_dir, false, base::FileEnumerator::FILES);
+  for (base::FilePath path = files.Next(); !path.empty();
+       path = files.Next()) {
+    base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    while (file.IsValid() &&
+           file.ReadAtCurrentPos(buffer.get(), kReadBufferSize) > 0) {
+    }
+  }
+}
+
+void WarmUpNaClOnIOThread() {
+  // Loads the IRT and the validation cache, both are waited for before the
+  // loader of the first module can start. The translation cache is opened
+  // at startup, see XWalkBrowserMainParts.
+  nacl::NaClBrowser::GetInstance()->EnsureAllResourcesAvailable();
+}
+
+}  // namespace
+
+namespace xwalk {
+
+void WarmUpNaCl(bool is_portable) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+                          base::Bind(&WarmUpNaClOnIOThread));
+
+  if (!is_portable || g_pnacl_files_read)
+    return;
+  base::FilePath pnacl_dir;
+  if (!nacl::NaClBrowser::GetDelegate()->GetPnaclDirectory(&pnacl_dir))
+    return;
+  g_pnacl_files_read = true;
+  BrowserThread::PostBlockingPoolTask(FROM_HERE,
+                                      base::Bind(&ReadPnaclFiles, pnacl_dir));
+}
+
+}  // namespace xwalk
@@ -0,0 +1,20 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_NACL_HOST_NACL_WARMUP_H_
+#define XWALK_RUNTIME_BROWSER_NACL_HOST_NACL_WARMUP_H_
+
+namespace xwalk {
+
+// Prepares what the first Native Client module of an application waits for,
+// so it overlaps with the load of the page embedding it: the IRT and the
+// validation cache and, for portable modules, the translator files. The
+// loader process itself can only be launched for the manifest of an embed.
+// Must be called on the UI thread, the work happens on the IO thread and the
+// blocking pool.
+void WarmUpNaCl(bool is_portable);
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_NACL_HOST_NACL_WARMUP_H_
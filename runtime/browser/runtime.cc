@@ -7,12 +7,14 @@
 #include <string>
 #include <utility>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/message_loop/message_loop.h"
-#include "xwalk/runtime/browser/image_util.h"
+#include "xwalk/runtime/browser/image_loader.h"
 #include "xwalk/runtime/browser/media/media_capture_devices_dispatcher.h"
 #include "xwalk/runtime/browser/runtime_context.h"
 #include "xwalk/runtime/browser/runtime_file_select_helper.h"
+#include "xwalk/runtime/browser/runtime_startup_timeline.h"
 #include "xwalk/runtime/browser/ui/color_chooser.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
 #include "xwalk/runtime/common/xwalk_notification_types.h"
@@ -74,6 +76,7 @@ Runtime::Runtime(content::WebContents* web_contents, Observer* observer)
       window_(NULL),
       weak_ptr_factory_(this),
       fullscreen_options_(NO_FULLSCREEN),
+      opened_by_page_(false),
       observer_(observer) {
   web_contents_->SetDelegate(this);
   content::NotificationService::current()->Notify(
@@ -109,17 +112,10 @@ void Runtime::AttachWindow(const NativeAppWindow::CreateParams& params) {
   NativeAppWindow::CreateParams effective_params(params);
   ApplyWindowDefaultParams(&effective_params);
 
-  // Set the app icon if it is passed from command line.
-  CommandLine* command_line = CommandLine::ForCurrentProcess();
-  if (command_line->HasSwitch(switches::kAppIcon)) {
-    base::FilePath icon_file =
-        command_line->GetSwitchValuePath(switches::kAppIcon);
-    app_icon_ = xwalk_utils::LoadImageFromFilePath(icon_file);
-  } else {
-    // Otherwise, use the default icon for Crosswalk app.
-    ui::ResourceBundle& rb = ui::ResourceBundle::GetSharedInstance();
-    app_icon_ = rb.GetNativeImageNamed(IDR_XWALK_ICON_48);
-  }
+  // Use the default icon for Crosswalk app, until the one passed from
+  // command line, if any, is decoded.
+  ui::ResourceBundle& rb = ui::ResourceBundle::GetSharedInstance();
+  app_icon_ = rb.GetNativeImageNamed(IDR_XWALK_ICON_48);
 
   registrar_.Add(this,
         content::NOTIFICATION_WEB_CONTENTS_TITLE_UPDATED,
@@ -128,6 +124,13 @@ void Runtime::AttachWindow(const NativeAppWindow::CreateParams& params) {
   window_ = NativeAppWindow::Create(effective_params);
   if (!app_icon_.IsEmpty())
     window_->UpdateIcon(app_icon_);
+  CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kAppIcon)) {
+    // The icon is set right away when another window already decoded it.
+    ImageLoader::GetInstance()->LoadImage(
+        command_line->GetSwitchValuePath(switches::kAppIcon),
+        base::Bind(&Runtime::DidLoadAppIcon, weak_ptr_factory_.GetWeakPtr()));
+  }
   window_->Show();
 #if defined(OS_TIZEN_MOBILE)
   if (root_window_)
@@ -232,6 +235,7 @@ void Runtime::WebContentsCreated(
     const GURL& target_url,
     content::WebContents* new_contents) {
   Runtime* new_runtime = new Runtime(new_contents, observer_);
+  new_runtime->opened_by_page_ = true;
 #if defined(OS_TIZEN_MOBILE)
   new_runtime->SetRootWindow(root_window_);
 #endif
@@ -304,6 +308,21 @@ void Runtime::DidUpdateFaviconURL(const std::vector<FaviconURL>& candidates) {
           &Runtime::DidDownloadFavicon, weak_ptr_factory_.GetWeakPtr()));
 }
 
+void Runtime::DidFirstVisuallyNonEmptyPaint() {
+  RuntimeStartupTimeline::GetInstance()->Record(
+      RuntimeStartupTimeline::MILESTONE_FIRST_PAINT);
+#if !defined(OS_TIZEN_MOBILE)
+  // The next window opened by the page is shown in a frame or two. Not done
+  // before this one is painted to not delay it. The windows of Tizen Mobile
+  // have a root window as parent, they aren't pooled.
+  if (opened_by_page_) {
+    NativeAppWindow::CreateParams params;
+    params.bounds = gfx::Rect(0, 0, kDefaultWidth, kDefaultHeight);
+    NativeAppWindow::PrepareSpareWindow(params);
+  }
+#endif
+}
+
 void Runtime::DidDownloadFavicon(int id,
                                  int http_status_code,
                                  const GURL& image_url,
@@ -315,6 +334,14 @@ void Runtime::DidDownloadFavicon(int id,
   window_->UpdateIcon(app_icon_);
 }
 
+void Runtime::DidLoadAppIcon(const gfx::Image& image) {
+  if (image.IsEmpty())
+    return;
+  app_icon_ = image;
+  if (window_)
+    window_->UpdateIcon(app_icon_);
+}
+
 void Runtime::Observe(int type,
                       const content::NotificationSource& source,
                       const content::NotificationDetails& details) {
@@ -137,6 +137,7 @@ class Runtime : public content::WebContentsDelegate,
   // Overridden from content::WebContentsObserver.
   virtual void DidUpdateFaviconURL(
       const std::vector<content::FaviconURL>& candidates) OVERRIDE;
+  virtual void DidFirstVisuallyNonEmptyPaint() OVERRIDE;
 
   // Callback method for WebContents::DownloadImage.
   void DidDownloadFavicon(int id,
@@ -145,6 +146,9 @@ class Runtime : public content::WebContentsDelegate,
                           const std::vector<SkBitmap>& bitmaps,
                           const std::vector<gfx::Size>& sizes);
 
+  // Callback method for ImageLoader::LoadImage, with the --app-icon image.
+  void DidLoadAppIcon(const gfx::Image& image);
+
   // NotificationObserver
   virtual void Observe(int type,
                        const content::NotificationSource& source,
@@ -189,6 +193,10 @@ class Runtime : public content::WebContentsDelegate,
 
   unsigned int fullscreen_options_;
 
+  // Opened by the page of another runtime, e.g. with window.open(). Its
+  // application is likely to open more windows.
+  bool opened_by_page_;
+
   Observer* observer_;
 };
 
@@ -0,0 +1,145 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_cache_warmer.h"
+
+#include <algorithm>
+#include <string>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/load_flags.h"
+#include "net/base/net_errors.h"
+#include "net/url_request/url_fetcher.h"
+#include "net/url_request/url_fetcher_response_writer.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "net/url_request/url_request_status.h"
+
+using content::BrowserThread;
+
+namespace {
+
+// The cache keeps the response, the fetcher doesn't need to copy it.
+class DiscardingResponseWriter : public net::URLFetcherResponseWriter {
+ public:
+  DiscardingResponseWriter() {}
+  virtual ~DiscardingResponseWriter() {}
+
+  virtual int Initialize(const net::CompletionCallback& callback) OVERRIDE {
+    return net::OK;
+  }
+  virtual int Write(net::IOBuffer* buffer,
+                    int num_bytes,
+                    const net::CompletionCallback& callback) OVERRIDE {
+    return num_bytes;
+  }
+  virtual int Finish(const net::CompletionCallback& callback) OVERRIDE {
+    return net::OK;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(DiscardingResponseWriter);
+};
+
+}  // namespace
+
+namespace xwalk {
+
+// static
+void RuntimeCacheWarmer::Start(net::URLRequestContextGetter* context_getter,
+                               const std::vector<GURL>& urls,
+                               size_t max_fetches,
+                               const CompletionCallback& callback) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  RuntimeCacheWarmer* warmer = new RuntimeCacheWarmer(
+      context_getter, urls, std::max<size_t>(max_fetches, 1), callback);
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&RuntimeCacheWarmer::FetchNext, base::Unretained(warmer)));
+}
+
+// static
+std::vector<GURL> RuntimeCacheWarmer::ParseURLs(const std::string& value) {
+  std::vector<std::string> specs;
+  base::SplitString(value, ',', &specs);
+
+  std::vector<GURL> urls;
+  for (size_t i = 0; i < specs.size(); ++i) {
+    std::string spec;
+    base::TrimWhitespaceASCII(specs[i], base::TRIM_ALL, &spec);
+    if (spec.empty())
+      continue;
+    GURL url(spec);
+    if (!url.is_valid() || !url.SchemeIsHTTPOrHTTPS()) {
+      LOG(WARNING) << "Ignoring url to warm the cache with: " << spec;
+      continue;
+    }
+    urls.push_back(url);
+  }
+  return urls;
+}
+
+RuntimeCacheWarmer::RuntimeCacheWarmer(
+    net::URLRequestContextGetter* context_getter,
+    const std::vector<GURL>& urls,
+    size_t max_fetches,
+    const CompletionCallback& callback)
+    : context_getter_(context_getter),
+      urls_(urls),
+      max_fetches_(max_fetches),
+      callback_(callback),
+      next_url_(0),
+      fetched_(0),
+      failed_(0) {
+}
+
+RuntimeCacheWarmer::~RuntimeCacheWarmer() {
+}
+
+void RuntimeCacheWarmer::FetchNext() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  while (next_url_ < urls_.size() && fetchers_.size() < max_fetches_) {
+    net::URLFetcher* fetcher = net::URLFetcher::Create(
+        urls_[next_url_++], net::URLFetcher::GET, this);
+    fetcher->SetRequestContext(context_getter_.get());
+    // Only the cache entry matters, the application sets its own cookies.
+    fetcher->SetLoadFlags(net::LOAD_DO_NOT_SAVE_COOKIES);
+    fetcher->SaveResponseWithWriter(
+        scoped_ptr<net::URLFetcherResponseWriter>(
+            new DiscardingResponseWriter));
+    fetchers_.push_back(fetcher);
+    fetcher->Start();
+  }
+
+  if (!fetchers_.empty())
+    return;
+
+  if (!callback_.is_null()) {
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                            base::Bind(callback_, fetched_, failed_));
+  }
+  delete this;
+}
+
+void RuntimeCacheWarmer::OnURLFetchComplete(const net::URLFetcher* source) {
+  if (source->GetStatus().is_success() && source->GetResponseCode() < 400) {
+    ++fetched_;
+  } else {
+    ++failed_;
+    LOG(WARNING) << "Can't warm the cache with " << source->GetURL().spec()
+                 << ": " << source->GetStatus().error() << ", HTTP "
+                 << source->GetResponseCode();
+  }
+
+  ScopedVector<net::URLFetcher>::iterator it =
+      std::find(fetchers_.begin(), fetchers_.end(), source);
+  DCHECK(it != fetchers_.end());
+  fetchers_.erase(it);
+  FetchNext();
+}
+
+}  // namespace xwalk
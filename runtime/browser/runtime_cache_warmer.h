@@ -0,0 +1,73 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_CACHE_WARMER_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_CACHE_WARMER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
+#include "net/url_request/url_fetcher_delegate.h"
+#include "url/gurl.h"
+
+namespace net {
+class URLFetcher;
+class URLRequestContextGetter;
+}
+
+namespace xwalk {
+
+// Fetches a list of urls, a few at a time to stay out of the way of the
+// application, so their responses are in the HTTP cache by the time they are
+// needed, even offline. Used for --warm-cache-urls and for the
+// "xwalk_prefetch" list of the manifest. The bodies are dropped as they are
+// read, only the cache keeps them. Deletes itself once done.
+class RuntimeCacheWarmer : public net::URLFetcherDelegate {
+ public:
+  // Run on the UI thread once every url has been fetched.
+  typedef base::Callback<void(int fetched, int failed)> CompletionCallback;
+
+  // Must be called on the IO thread. The fetches start from a new task, so
+  // this can be called while |context_getter| is still building its context.
+  // At most |max_fetches| urls are fetched at the same time. |callback| can
+  // be null.
+  static void Start(net::URLRequestContextGetter* context_getter,
+                    const std::vector<GURL>& urls,
+                    size_t max_fetches,
+                    const CompletionCallback& callback);
+
+  // Parses the comma separated http(s) urls of --warm-cache-urls.
+  static std::vector<GURL> ParseURLs(const std::string& value);
+
+ private:
+  RuntimeCacheWarmer(net::URLRequestContextGetter* context_getter,
+                     const std::vector<GURL>& urls,
+                     size_t max_fetches,
+                     const CompletionCallback& callback);
+  virtual ~RuntimeCacheWarmer();
+
+  void FetchNext();
+
+  // net::URLFetcherDelegate implementation.
+  virtual void OnURLFetchComplete(const net::URLFetcher* source) OVERRIDE;
+
+  scoped_refptr<net::URLRequestContextGetter> context_getter_;
+  const std::vector<GURL> urls_;
+  const size_t max_fetches_;
+  CompletionCallback callback_;
+  size_t next_url_;
+  int fetched_;
+  int failed_;
+  ScopedVector<net::URLFetcher> fetchers_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeCacheWarmer);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_CACHE_WARMER_H_
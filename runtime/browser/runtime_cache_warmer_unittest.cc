@@ -0,0 +1,22 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_cache_warmer.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::RuntimeCacheWarmer;
+
+TEST(RuntimeCacheWarmerTest, ParseURLs) {
+  std::vector<GURL> urls = RuntimeCacheWarmer::ParseURLs(
+      "http://example.com/app.js, https://example.com/app.css,,"
+      "file:///etc/passwd,not a url,ftp://example.com/a");
+  ASSERT_EQ(2u, urls.size());
+  EXPECT_EQ(GURL("http://example.com/app.js"), urls[0]);
+  EXPECT_EQ(GURL("https://example.com/app.css"), urls[1]);
+
+  EXPECT_TRUE(RuntimeCacheWarmer::ParseURLs(std::string()).empty());
+}
@@ -8,10 +8,12 @@
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/command_line.h"
 #include "base/logging.h"
 #include "base/path_service.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "components/visitedlink/browser/visitedlink_master.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_process_host.h"
@@ -26,6 +28,7 @@
 #include "xwalk/application/common/constants.h"
 #include "xwalk/runtime/browser/runtime_download_manager_delegate.h"
 #include "xwalk/runtime/browser/runtime_geolocation_permission_context.h"
+#include "xwalk/runtime/browser/runtime_network_predictor.h"
 #include "xwalk/runtime/browser/runtime_url_request_context_getter.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
 #include "xwalk/runtime/common/xwalk_paths.h"
@@ -40,6 +43,13 @@ using content::DownloadManager;
 
 namespace xwalk {
 
+namespace {
+
+const base::FilePath::CharType kNetworkPredictorFilename[] =
+    FILE_PATH_LITERAL("Network Predictor");
+
+}  // namespace
+
 class RuntimeContext::RuntimeResourceContext : public content::ResourceContext {
  public:
   RuntimeResourceContext() : getter_(NULL) {}
@@ -98,6 +108,16 @@ void RuntimeContext::InitWhileIOAllowed() {
     PathService::OverrideAndCreateIfNeeded(
         xwalk::DIR_DATA_PATH, path, false, true);
   }
+
+  base::SequencedWorkerPool* blocking_pool = BrowserThread::GetBlockingPool();
+  network_predictor_ = new RuntimeNetworkPredictor(
+      GetPath().Append(kNetworkPredictorFilename),
+      blocking_pool->GetSequencedTaskRunnerWithShutdownBehavior(
+          blocking_pool->GetSequenceToken(),
+          base::SequencedWorkerPool::BLOCK_SHUTDOWN));
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&RuntimeNetworkPredictor::Load, network_predictor_));
 }
 
 base::FilePath RuntimeContext::GetPath() const {
@@ -206,7 +226,9 @@ net::URLRequestContextGetter* RuntimeContext::CreateRequestContext(
       GetPath(),
       BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::IO),
       BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::FILE),
-      protocol_handlers, request_interceptors.Pass());
+      protocol_handlers, request_interceptors.Pass(),
+      network_predictor_.get(),
+      NULL);
   resource_context_->set_url_request_context_getter(url_request_getter_.get());
   return url_request_getter_.get();
 }
@@ -232,13 +254,22 @@ net::URLRequestContextGetter*
           application::kApplicationScheme,
           application::CreateApplicationProtocolHandler(service)));
 
+  // The default partition is created at startup, before the applications
+  // get theirs.
+  RuntimeURLRequestContextGetter* shared_network_getter = NULL;
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kShareNetworkSession))
+    shared_network_getter = url_request_getter_.get();
+
   scoped_refptr<RuntimeURLRequestContextGetter>
   context_getter = new RuntimeURLRequestContextGetter(
       false, /* ignore_certificate_error = false */
       partition_path,
       BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::IO),
       BrowserThread::UnsafeGetMessageLoopForThread(BrowserThread::FILE),
-      protocol_handlers, request_interceptors.Pass());
+      protocol_handlers, request_interceptors.Pass(),
+      network_predictor_.get(),
+      shared_network_getter);
 
   context_getters_.insert(
       std::make_pair(partition_path.value(), context_getter));
@@ -266,8 +297,11 @@ std::string RuntimeContext::GetCSPString() const {
 }
 
 void RuntimeContext::InitVisitedLinkMaster() {
+  // The table is persisted in the "Visited Links" file of the data path, so
+  // the links visited in previous sessions are known without waiting for
+  // AddVisitedURLs(). It is only rebuilt when the file can't be loaded.
   visitedlink_master_.reset(
-      new visitedlink::VisitedLinkMaster(this, this, false));
+      new visitedlink::VisitedLinkMaster(this, this, true));
   visitedlink_master_->Init();
 }
 
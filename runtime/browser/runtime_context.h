@@ -35,6 +35,7 @@ class VisitedLinkMaster;
 namespace xwalk {
 
 class RuntimeDownloadManagerDelegate;
+class RuntimeNetworkPredictor;
 class RuntimeURLRequestContextGetter;
 
 class RuntimeContext
@@ -79,6 +80,12 @@ class RuntimeContext
       bool in_memory,
       content::ProtocolHandlerMap* protocol_handlers,
       content::URLRequestInterceptorScopedVector request_interceptors);
+  // Learns the origins used by the applications, to warm up the connections
+  // to them when they are launched.
+  RuntimeNetworkPredictor* network_predictor() const {
+    return network_predictor_.get();
+  }
+
 #if defined(OS_ANDROID)
   void SetCSPString(const std::string& csp);
   std::string GetCSPString() const;
@@ -104,6 +111,7 @@ class RuntimeContext
   scoped_ptr<RuntimeResourceContext> resource_context_;
   scoped_refptr<RuntimeDownloadManagerDelegate> download_manager_delegate_;
   scoped_refptr<RuntimeURLRequestContextGetter> url_request_getter_;
+  scoped_refptr<RuntimeNetworkPredictor> network_predictor_;
 #if defined(OS_ANDROID)
   std::string csp_;
   scoped_ptr<visitedlink::VisitedLinkMaster> visitedlink_master_;
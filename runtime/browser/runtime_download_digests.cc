@@ -0,0 +1,128 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_download_digests.h"
+
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/lazy_instance.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
+
+namespace xwalk {
+
+namespace {
+
+const int kHashBufferSize = 32 * 1024;
+
+base::LazyInstance<RuntimeDownloadDigests>::Leaky g_download_digests =
+    LAZY_INSTANCE_INITIALIZER;
+
+GURL StripRef(const GURL& url) {
+  if (!url.has_ref())
+    return url;
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  return url.ReplaceComponents(replacements);
+}
+
+}  // namespace
+
+RuntimeDownloadDigests::RuntimeDownloadDigests() {
+}
+
+RuntimeDownloadDigests::~RuntimeDownloadDigests() {
+}
+
+// static
+RuntimeDownloadDigests* RuntimeDownloadDigests::GetInstance() {
+  return g_download_digests.Pointer();
+}
+
+bool RuntimeDownloadDigests::AddDigest(int render_process_id,
+                                       int render_view_id,
+                                       const GURL& url,
+                                       const std::string& sha256) {
+  std::vector<uint8> bytes;
+  if (!url.SchemeIsHTTPOrHTTPS() || !base::HexStringToBytes(sha256, &bytes) ||
+      bytes.size() != crypto::kSHA256Length)
+    return false;
+
+  base::AutoLock lock(lock_);
+  digests_[ViewId(render_process_id, render_view_id)][StripRef(url)] =
+      StringToLowerASCII(sha256);
+  return true;
+}
+
+void RuntimeDownloadDigests::ClearDigests(int render_process_id,
+                                          int render_view_id) {
+  base::AutoLock lock(lock_);
+  digests_.erase(ViewId(render_process_id, render_view_id));
+}
+
+bool RuntimeDownloadDigests::HasDigest(int render_process_id,
+                                       int render_view_id,
+                                       const GURL& url) const {
+  std::string sha256;
+  return GetDigest(render_process_id, render_view_id, url, &sha256);
+}
+
+bool RuntimeDownloadDigests::GetDigest(int render_process_id,
+                                       int render_view_id,
+                                       const GURL& url,
+                                       std::string* sha256) const {
+  base::AutoLock lock(lock_);
+  std::map<ViewId, DigestMap>::const_iterator view =
+      digests_.find(ViewId(render_process_id, render_view_id));
+  if (view == digests_.end())
+    return false;
+  DigestMap::const_iterator it = view->second.find(StripRef(url));
+  if (it == view->second.end())
+    return false;
+  *sha256 = it->second;
+  return true;
+}
+
+bool RuntimeDownloadDigests::IsEmpty() const {
+  base::AutoLock lock(lock_);
+  return digests_.empty();
+}
+
+// static
+bool RuntimeDownloadDigests::Matches(const std::string& hash,
+                                     const std::string& sha256) {
+  if (hash.size() != crypto::kSHA256Length)
+    return false;
+  return LowerCaseEqualsASCII(base::HexEncode(hash.data(), hash.size()),
+                              sha256.c_str());
+}
+
+// static
+bool RuntimeDownloadDigests::HashFile(const base::FilePath& path,
+                                      std::string* hash) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return false;
+
+  scoped_ptr<crypto::SecureHash> sha256(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+  scoped_ptr<char[]> buffer(new char[kHashBufferSize]);
+  int bytes_read;
+  while ((bytes_read =
+              file.ReadAtCurrentPos(buffer.get(), kHashBufferSize)) > 0)
+    sha256->Update(buffer.get(), bytes_read);
+  if (bytes_read < 0)
+    return false;
+
+  hash->resize(crypto::kSHA256Length);
+  sha256->Finish(string_as_array(hash), hash->size());
+  return true;
+}
+
+}  // namespace xwalk
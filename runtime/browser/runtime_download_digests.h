@@ -0,0 +1,76 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_DOWNLOAD_DIGESTS_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_DOWNLOAD_DIGESTS_H_
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/synchronization/lock.h"
+#include "url/gurl.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace xwalk {
+
+// The SHA-256 digests the manifests expect of the content they download,
+// see "xwalk_downloads". These downloads are pre-approved: they continue
+// the response of the page's request instead of being fetched again by the
+// platform, and are hashed on the FILE thread as they are written so the
+// result is known once they complete.
+//
+// The digests are those of the manifest last applied to a view, and only
+// approve the downloads of that view. A view is named by the ids of its
+// render view host, which both the UI and IO threads know.
+//
+// Filled on the UI thread, looked up on the IO thread too.
+class RuntimeDownloadDigests {
+ public:
+  RuntimeDownloadDigests();
+  ~RuntimeDownloadDigests();
+
+  static RuntimeDownloadDigests* GetInstance();
+
+  // Returns false if |sha256| isn't a hex encoded SHA-256 digest, or |url|
+  // isn't HTTP(S).
+  bool AddDigest(int render_process_id,
+                 int render_view_id,
+                 const GURL& url,
+                 const std::string& sha256);
+  // Drops the digests of the view, e.g. when another manifest is applied.
+  void ClearDigests(int render_process_id, int render_view_id);
+  bool HasDigest(int render_process_id,
+                 int render_view_id,
+                 const GURL& url) const;
+  // The lowercase hex digest expected of |url|, false if none is.
+  bool GetDigest(int render_process_id,
+                 int render_view_id,
+                 const GURL& url,
+                 std::string* sha256) const;
+  bool IsEmpty() const;
+
+  // Whether the raw |hash| of a download is the hex encoded |sha256|.
+  static bool Matches(const std::string& hash, const std::string& sha256);
+  // The raw SHA-256 of the file at |path|. Blocks on file IO.
+  static bool HashFile(const base::FilePath& path, std::string* hash);
+
+ private:
+  typedef std::pair<int, int> ViewId;
+  // By URL without the fragment, which isn't sent.
+  typedef std::map<GURL, std::string> DigestMap;
+
+  mutable base::Lock lock_;
+  std::map<ViewId, DigestMap> digests_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeDownloadDigests);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_DOWNLOAD_DIGESTS_H_
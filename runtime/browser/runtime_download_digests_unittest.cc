@@ -0,0 +1,92 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_download_digests.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_util.h"
+#include "crypto/sha2.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::RuntimeDownloadDigests;
+
+namespace {
+
+const int kProcessId = 1;
+const int kViewId = 2;
+
+// SHA-256 of "abc".
+const char kAbcDigest[] =
+    "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD";
+
+}  // namespace
+
+TEST(RuntimeDownloadDigestsTest, AddDigest) {
+  RuntimeDownloadDigests digests;
+  EXPECT_TRUE(digests.IsEmpty());
+  EXPECT_FALSE(digests.AddDigest(kProcessId, kViewId,
+                                 GURL("http://example.com/pack.zip"), "ba78"));
+  EXPECT_FALSE(digests.AddDigest(kProcessId, kViewId,
+                                 GURL("http://example.com/pack.zip"),
+                                 std::string(64, 'x')));
+  EXPECT_FALSE(digests.AddDigest(kProcessId, kViewId, GURL(), kAbcDigest));
+  EXPECT_FALSE(digests.AddDigest(kProcessId, kViewId,
+                                 GURL("file:///sdcard/pack.zip"), kAbcDigest));
+  EXPECT_TRUE(digests.IsEmpty());
+
+  EXPECT_TRUE(digests.AddDigest(kProcessId, kViewId,
+                                GURL("http://example.com/pack.zip#v2"),
+                                kAbcDigest));
+  EXPECT_TRUE(digests.HasDigest(kProcessId, kViewId,
+                                GURL("http://example.com/pack.zip#v3")));
+  std::string digest;
+  EXPECT_TRUE(digests.GetDigest(kProcessId, kViewId,
+                                GURL("http://example.com/pack.zip"), &digest));
+  EXPECT_EQ(StringToLowerASCII(std::string(kAbcDigest)), digest);
+  EXPECT_FALSE(digests.GetDigest(kProcessId, kViewId,
+                                 GURL("http://example.com/other.zip"),
+                                 &digest));
+}
+
+TEST(RuntimeDownloadDigestsTest, ByView) {
+  RuntimeDownloadDigests digests;
+  const GURL url("http://example.com/pack.zip");
+  EXPECT_TRUE(digests.AddDigest(kProcessId, kViewId, url, kAbcDigest));
+  // Another view didn't list the download.
+  EXPECT_FALSE(digests.HasDigest(kProcessId, kViewId + 1, url));
+  EXPECT_FALSE(digests.HasDigest(kProcessId + 1, kViewId, url));
+
+  // The digests of a previous manifest don't approve anything anymore.
+  digests.ClearDigests(kProcessId, kViewId);
+  EXPECT_FALSE(digests.HasDigest(kProcessId, kViewId, url));
+  EXPECT_TRUE(digests.IsEmpty());
+}
+
+TEST(RuntimeDownloadDigestsTest, Matches) {
+  std::string hash = crypto::SHA256HashString("abc");
+  EXPECT_TRUE(RuntimeDownloadDigests::Matches(hash, kAbcDigest));
+  EXPECT_TRUE(RuntimeDownloadDigests::Matches(
+      hash, StringToLowerASCII(std::string(kAbcDigest))));
+  EXPECT_FALSE(RuntimeDownloadDigests::Matches(
+      crypto::SHA256HashString("abd"), kAbcDigest));
+  // No hash was generated.
+  EXPECT_FALSE(RuntimeDownloadDigests::Matches(std::string(), kAbcDigest));
+}
+
+TEST(RuntimeDownloadDigestsTest, HashFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.path().AppendASCII("pack.zip");
+  ASSERT_EQ(3, base::WriteFile(path, "abc", 3));
+
+  std::string hash;
+  EXPECT_TRUE(RuntimeDownloadDigests::HashFile(path, &hash));
+  EXPECT_TRUE(RuntimeDownloadDigests::Matches(hash, kAbcDigest));
+  EXPECT_FALSE(RuntimeDownloadDigests::HashFile(
+      temp_dir.path().AppendASCII("missing.zip"), &hash));
+}
@@ -16,18 +16,55 @@
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/sys_info.h"
+#include "base/task_runner_util.h"
 #include "content/public/browser/browser_context.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/download_manager.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_view_host.h"
 #include "content/public/browser/web_contents.h"
 #include "content/shell/common/shell_switches.h"
 #include "content/shell/browser/webkit_test_controller.h"
 #include "net/base/filename_util.h"
+#include "xwalk/runtime/browser/runtime_download_digests.h"
+
+#if defined(OS_ANDROID)
+#include "xwalk/runtime/browser/android/xwalk_contents_client_bridge_base.h"
+#endif  // defined(OS_ANDROID)
 
 using content::BrowserThread;
 
+namespace {
+
+// Enough to keep the link busy, few enough for each download to progress.
+const size_t kMaxRunningDownloads = 3;
+
+// Kept free for the rest of the system, full flash storage gets slow.
+const int64 kMinFreeDiskSpace = 50 * 1024 * 1024;
+
+// The digest the manifest of the view downloading |item| expects of it.
+bool GetDownloadDigest(content::DownloadItem* item, std::string* sha256) {
+  content::WebContents* web_contents = item->GetWebContents();
+  if (!web_contents)
+    return false;
+  return xwalk::RuntimeDownloadDigests::GetInstance()->GetDigest(
+      web_contents->GetRenderProcessHost()->GetID(),
+      web_contents->GetRenderViewHost()->GetRoutingID(),
+      item->GetURL(), sha256);
+}
+
+bool FileMatchesDigest(const base::FilePath& path, const std::string& sha256) {
+  std::string hash;
+  return xwalk::RuntimeDownloadDigests::HashFile(path, &hash) &&
+         xwalk::RuntimeDownloadDigests::Matches(hash, sha256);
+}
+
+}  // namespace
+
 namespace xwalk {
 
 RuntimeDownloadManagerDelegate::RuntimeDownloadManagerDelegate()
@@ -45,6 +82,12 @@ void RuntimeDownloadManagerDelegate::SetDownloadManager(
 }
 
 void RuntimeDownloadManagerDelegate::Shutdown() {
+  for (std::set<content::DownloadItem*>::iterator it =
+           running_downloads_.begin(); it != running_downloads_.end(); ++it)
+    (*it)->RemoveObserver(this);
+  running_downloads_.clear();
+  queued_downloads_.clear();
+  download_manager_ = NULL;
   Release();
 }
 
@@ -59,6 +102,8 @@ bool RuntimeDownloadManagerDelegate::DetermineDownloadTarget(
         Append(FILE_PATH_LITERAL("Downloads"));
   }
 
+  ScheduleDownload(download);
+
   if (!download->GetForcedFilePath().empty()) {
     callback.Run(download->GetForcedFilePath(),
                  content::DownloadItem::TARGET_DISPOSITION_OVERWRITE,
@@ -81,7 +126,7 @@ bool RuntimeDownloadManagerDelegate::DetermineDownloadTarget(
       base::Bind(
           &RuntimeDownloadManagerDelegate::GenerateFilename,
           this, download->GetId(), callback, generated_name,
-          default_download_path_));
+          default_download_path_, download->GetTotalBytes()));
   return true;
 }
 
@@ -97,15 +142,144 @@ void RuntimeDownloadManagerDelegate::GetNextId(
   callback.Run(next_id++);
 }
 
+bool RuntimeDownloadManagerDelegate::GenerateFileHash() {
+  // Hashing as the data is written spares reading a large download again
+  // once complete, it is only worth it if some download will be checked.
+  return !RuntimeDownloadDigests::GetInstance()->IsEmpty();
+}
+
+void RuntimeDownloadManagerDelegate::OnDownloadUpdated(
+    content::DownloadItem* item) {
+  if (item->GetState() == content::DownloadItem::COMPLETE)
+    VerifyDownload(item);
+  if (item->GetState() != content::DownloadItem::IN_PROGRESS)
+    StopTracking(item);
+}
+
+void RuntimeDownloadManagerDelegate::OnDownloadDestroyed(
+    content::DownloadItem* item) {
+  StopTracking(item);
+}
+
+void RuntimeDownloadManagerDelegate::ScheduleDownload(
+    content::DownloadItem* item) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (running_downloads_.count(item))
+    return;
+  if (running_downloads_.size() >= kMaxRunningDownloads) {
+    item->Pause();
+    queued_downloads_.push_back(item->GetId());
+    return;
+  }
+  running_downloads_.insert(item);
+  item->AddObserver(this);
+}
+
+void RuntimeDownloadManagerDelegate::StopTracking(
+    content::DownloadItem* item) {
+  if (!running_downloads_.erase(item))
+    return;
+  item->RemoveObserver(this);
+  ResumeQueuedDownloads();
+}
+
+void RuntimeDownloadManagerDelegate::VerifyDownload(
+    content::DownloadItem* item) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  std::string digest;
+  if (!GetDownloadDigest(item, &digest))
+    return;
+
+  if (RuntimeDownloadDigests::Matches(item->GetHash(), digest)) {
+    OnDownloadVerified(item->GetId(), true);
+    return;
+  }
+
+  // The hash made as the data was written only covers the part received
+  // since a resumption, and there is none if the digest became known once
+  // the download had started. The file is hashed again before it fails.
+  base::PostTaskAndReplyWithResult(
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::FILE).get(),
+      FROM_HERE,
+      base::Bind(&FileMatchesDigest, item->GetTargetFilePath(), digest),
+      base::Bind(&RuntimeDownloadManagerDelegate::OnDownloadVerified,
+                 this, item->GetId()));
+}
+
+void RuntimeDownloadManagerDelegate::OnDownloadVerified(uint32 download_id,
+                                                        bool verified) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  content::DownloadItem* item =
+      download_manager_ ? download_manager_->GetDownload(download_id) : NULL;
+  if (!item)
+    return;
+
+  UMA_HISTOGRAM_BOOLEAN("XWalk.Download.Verified", verified);
+  GURL url = item->GetURL();
+  base::FilePath target_path = item->GetTargetFilePath();
+  content::WebContents* web_contents = item->GetWebContents();
+  if (!verified) {
+    LOG(WARNING) << "The SHA-256 of " << url.spec()
+                 << " doesn't match the one of the manifest.";
+    // Nothing the manifest didn't expect is left in the downloads. Removing
+    // a complete item doesn't delete its file.
+    item->Remove();
+    BrowserThread::PostTask(
+        BrowserThread::FILE, FROM_HERE,
+        base::Bind(base::IgnoreResult(&base::DeleteFile), target_path, false));
+  }
+
+#if defined(OS_ANDROID)
+  XWalkContentsClientBridgeBase* bridge = web_contents ?
+      XWalkContentsClientBridgeBase::FromWebContents(web_contents) : NULL;
+  if (bridge)
+    bridge->OnDownloadFinished(url, target_path, verified);
+#endif
+}
+
+void RuntimeDownloadManagerDelegate::ResumeQueuedDownloads() {
+  while (running_downloads_.size() < kMaxRunningDownloads &&
+         !queued_downloads_.empty()) {
+    content::DownloadItem* item =
+        download_manager_->GetDownload(queued_downloads_.front());
+    queued_downloads_.pop_front();
+    // Cancelled or removed while queued.
+    if (!item || item->GetState() != content::DownloadItem::IN_PROGRESS)
+      continue;
+    running_downloads_.insert(item);
+    item->AddObserver(this);
+    if (item->IsPaused())
+      item->Resume();
+  }
+}
+
 void RuntimeDownloadManagerDelegate::GenerateFilename(
     uint32 download_id,
     const content::DownloadTargetCallback& callback,
     const base::FilePath& generated_name,
-    const base::FilePath& suggested_directory) {
+    const base::FilePath& suggested_directory,
+    int64 total_bytes) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
   if (!base::PathExists(suggested_directory))
     base::CreateDirectory(suggested_directory);
 
+  // The size is unknown without a Content-Length, the download may still
+  // fill the disk then.
+  if (total_bytes > 0 &&
+      base::SysInfo::AmountOfFreeDiskSpace(suggested_directory) <
+          total_bytes + kMinFreeDiskSpace) {
+    LOG(WARNING) << "Not enough disk space to download "
+                 << generated_name.value();
+    // An empty target path cancels the download.
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(callback, base::FilePath(),
+                   content::DownloadItem::TARGET_DISPOSITION_OVERWRITE,
+                   content::DOWNLOAD_DANGER_TYPE_NOT_DANGEROUS,
+                   base::FilePath()));
+    return;
+  }
+
   base::FilePath suggested_path(suggested_directory.Append(generated_name));
   BrowserThread::PostTask(
       BrowserThread::UI,
@@ -120,8 +294,11 @@ void RuntimeDownloadManagerDelegate::OnDownloadPathGenerated(
     const content::DownloadTargetCallback& callback,
     const base::FilePath& suggested_path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
-  if (suppress_prompting_) {
-    // Testing exit.
+  content::DownloadItem* item = download_manager_->GetDownload(download_id);
+  std::string digest;
+  bool pre_approved = item && GetDownloadDigest(item, &digest);
+  // Testing exit, and the content the application knows it downloads.
+  if (suppress_prompting_ || pre_approved) {
     callback.Run(suggested_path,
                  content::DownloadItem::TARGET_DISPOSITION_OVERWRITE,
                  content::DOWNLOAD_DANGER_TYPE_NOT_DANGEROUS,
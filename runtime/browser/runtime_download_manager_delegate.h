@@ -6,14 +6,25 @@
 #ifndef XWALK_RUNTIME_BROWSER_RUNTIME_DOWNLOAD_MANAGER_DELEGATE_H_
 #define XWALK_RUNTIME_BROWSER_RUNTIME_DOWNLOAD_MANAGER_DELEGATE_H_
 
+#include <deque>
+#include <set>
+
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
+#include "content/public/browser/download_item.h"
 #include "content/public/browser/download_manager_delegate.h"
 
 namespace xwalk {
 
+// Only a few downloads of the context run at once, the next ones are paused
+// until one of them is over, so an application fetching a lot of content
+// doesn't saturate the link. The free disk space is checked on the FILE
+// thread before a download gets its target. The downloads pre-approved by
+// a manifest, see RuntimeDownloadDigests, are saved without prompting and
+// their SHA-256 checked once complete. Those that don't match are removed.
 class RuntimeDownloadManagerDelegate
     : public content::DownloadManagerDelegate,
+      public content::DownloadItem::Observer,
       public base::RefCountedThreadSafe<RuntimeDownloadManagerDelegate> {
  public:
   RuntimeDownloadManagerDelegate();
@@ -28,6 +39,7 @@ class RuntimeDownloadManagerDelegate
       content::DownloadItem* item,
       const content::DownloadOpenDelayedCallback& callback) OVERRIDE;
   virtual void GetNextId(const content::DownloadIdCallback& callback) OVERRIDE;
+  virtual bool GenerateFileHash() OVERRIDE;
 
   // Inhibits prompting and sets the default download path.
   void SetDownloadBehaviorForTesting(
@@ -40,10 +52,25 @@ class RuntimeDownloadManagerDelegate
  private:
   friend class base::RefCountedThreadSafe<RuntimeDownloadManagerDelegate>;
 
+  // content::DownloadItem::Observer implementation.
+  virtual void OnDownloadUpdated(content::DownloadItem* item) OVERRIDE;
+  virtual void OnDownloadDestroyed(content::DownloadItem* item) OVERRIDE;
+
+  // Pauses |item| if too many downloads are running already.
+  void ScheduleDownload(content::DownloadItem* item);
+  void StopTracking(content::DownloadItem* item);
+  // Checks the completed |item| against the digest its URL is expected to
+  // have, if any, and reports the result to the embedder.
+  void VerifyDownload(content::DownloadItem* item);
+  // Removes the download and its file unless |verified|, then reports.
+  void OnDownloadVerified(uint32 download_id, bool verified);
+  void ResumeQueuedDownloads();
+
   void GenerateFilename(uint32 download_id,
                         const content::DownloadTargetCallback& callback,
                         const base::FilePath& generated_name,
-                        const base::FilePath& suggested_directory);
+                        const base::FilePath& suggested_directory,
+                        int64 total_bytes);
   void OnDownloadPathGenerated(uint32 download_id,
                                const content::DownloadTargetCallback& callback,
                                const base::FilePath& suggested_path);
@@ -55,6 +82,10 @@ class RuntimeDownloadManagerDelegate
   base::FilePath default_download_path_;
   bool suppress_prompting_;
 
+  std::set<content::DownloadItem*> running_downloads_;
+  // Paused by ScheduleDownload(), by id as the items may go away.
+  std::deque<uint32> queued_downloads_;
+
   DISALLOW_COPY_AND_ASSIGN(RuntimeDownloadManagerDelegate);
 };
 
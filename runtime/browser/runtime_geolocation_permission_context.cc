@@ -68,6 +68,16 @@ RuntimeGeolocationPermissionContext::RequestGeolocationPermissionOnUIThread(
   int render_process_id = web_contents->GetRenderProcessHost()->GetID();
   int render_view_id = web_contents->GetRenderViewHost()->GetRoutingID();
 
+  // Set before answering: the requester may forget the request, and the
+  // slot cancel_callback points to, as soon as the result callback runs.
+  if (cancel_callback) {
+     *cancel_callback = base::Bind(
+         CancelGeolocationPermissionRequest,
+         render_process_id,
+         render_view_id,
+         requesting_frame);
+  }
+
 #if defined(OS_ANDROID)
   XWalkContent* xwalk_content =
       XWalkContent::FromID(render_process_id, render_view_id);
@@ -104,14 +114,6 @@ RuntimeGeolocationPermissionContext::RequestGeolocationPermissionOnUIThread(
   result_callback.Run(has_geolocation_permission);
 #endif
 
-  if (cancel_callback) {
-     *cancel_callback = base::Bind(
-         CancelGeolocationPermissionRequest,
-         render_process_id,
-         render_view_id,
-         requesting_frame);
-  }
-
   // TODO(yongsheng): Handle this for other platforms.
 }
 
@@ -121,6 +123,13 @@ RuntimeGeolocationPermissionContext::RequestGeolocationPermission(
     const GURL& requesting_frame,
     base::Callback<void(bool)> result_callback,
     base::Closure* cancel_callback) {
+  // Content asks on the UI thread, the request is then handled right away.
+  // The cancel callback is set before the result callback may run.
+  if (content::BrowserThread::CurrentlyOn(content::BrowserThread::UI)) {
+    RequestGeolocationPermissionOnUIThread(
+        web_contents, requesting_frame, result_callback, cancel_callback);
+    return;
+  }
   content::BrowserThread::PostTask(
       content::BrowserThread::UI, FROM_HERE,
       base::Bind(
@@ -0,0 +1,178 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_http_server_properties_store.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_runner_util.h"
+#include "base/values.h"
+#include "net/base/host_port_pair.h"
+#include "net/http/http_server_properties_impl.h"
+
+namespace xwalk {
+
+namespace {
+
+const int kVersion = 1;
+const int kSaveIntervalSeconds = 60;
+
+const char kVersionKey[] = "version";
+const char kServersKey[] = "servers";
+const char kSupportsSpdyKey[] = "supports_spdy";
+const char kAlternateProtocolKey[] = "alternate_protocol";
+const char kPortKey[] = "port";
+const char kProtocolKey[] = "protocol";
+
+std::string ReadFile(const base::FilePath& path) {
+  std::string data;
+  if (base::PathExists(path) && !base::ReadFileToString(path, &data))
+    LOG(WARNING) << "Can't read " << path.value();
+  return data;
+}
+
+base::DictionaryValue* GetServer(base::DictionaryValue* servers,
+                                 const std::string& server) {
+  base::DictionaryValue* dict = NULL;
+  if (!servers->GetDictionaryWithoutPathExpansion(server, &dict)) {
+    dict = new base::DictionaryValue;
+    servers->SetWithoutPathExpansion(server, dict);
+  }
+  return dict;
+}
+
+}  // namespace
+
+RuntimeHttpServerPropertiesStore::RuntimeHttpServerPropertiesStore(
+    const base::FilePath& path,
+    net::HttpServerPropertiesImpl* properties,
+    const scoped_refptr<base::SequencedTaskRunner>& file_task_runner)
+    : properties_(properties),
+      file_task_runner_(file_task_runner),
+      writer_(path, file_task_runner.get()),
+      weak_factory_(this) {
+  DCHECK(properties_);
+}
+
+RuntimeHttpServerPropertiesStore::~RuntimeHttpServerPropertiesStore() {
+  SaveIfChanged();
+}
+
+void RuntimeHttpServerPropertiesStore::Load() {
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&ReadFile, writer_.path()),
+      base::Bind(&RuntimeHttpServerPropertiesStore::OnLoaded,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void RuntimeHttpServerPropertiesStore::OnLoaded(const std::string& data) {
+  Deserialize(data, properties_);
+  saved_data_ = data;
+  save_timer_.Start(FROM_HERE,
+                    base::TimeDelta::FromSeconds(kSaveIntervalSeconds),
+                    this, &RuntimeHttpServerPropertiesStore::SaveIfChanged);
+}
+
+void RuntimeHttpServerPropertiesStore::SaveIfChanged() {
+  // Don't overwrite the file before it has been read.
+  if (!save_timer_.IsRunning())
+    return;
+
+  std::string data = Serialize(*properties_);
+  if (data == saved_data_)
+    return;
+  writer_.WriteNow(data);
+  saved_data_.swap(data);
+}
+
+// static
+std::string RuntimeHttpServerPropertiesStore::Serialize(
+    const net::HttpServerPropertiesImpl& properties) {
+  base::DictionaryValue* servers = new base::DictionaryValue;
+
+  base::ListValue spdy_servers;
+  properties.GetSpdyServerList(&spdy_servers);
+  for (size_t i = 0; i < spdy_servers.GetSize(); ++i) {
+    std::string server;
+    if (spdy_servers.GetString(i, &server))
+      GetServer(servers, server)->SetBoolean(kSupportsSpdyKey, true);
+  }
+
+  const net::AlternateProtocolMap& alternate_protocols =
+      properties.alternate_protocol_map();
+  for (net::AlternateProtocolMap::const_iterator it =
+           alternate_protocols.begin();
+       it != alternate_protocols.end(); ++it) {
+    // Broken alternate protocols are tried again at the next launch.
+    if (!net::IsAlternateProtocolValid(it->second.protocol))
+      continue;
+    base::DictionaryValue* alternate_protocol = new base::DictionaryValue;
+    alternate_protocol->SetInteger(kPortKey, it->second.port);
+    alternate_protocol->SetString(
+        kProtocolKey, net::AlternateProtocolToString(it->second.protocol));
+    GetServer(servers, it->first.ToString())->Set(
+        kAlternateProtocolKey, alternate_protocol);
+  }
+
+  base::DictionaryValue root;
+  root.SetInteger(kVersionKey, kVersion);
+  root.Set(kServersKey, servers);
+
+  std::string data;
+  base::JSONWriter::Write(&root, &data);
+  return data;
+}
+
+// static
+void RuntimeHttpServerPropertiesStore::Deserialize(
+    const std::string& data,
+    net::HttpServerPropertiesImpl* properties) {
+  if (data.empty())
+    return;
+
+  scoped_ptr<base::Value> value(base::JSONReader::Read(data));
+  base::DictionaryValue* root;
+  int version;
+  base::DictionaryValue* servers;
+  if (!value || !value->GetAsDictionary(&root) ||
+      !root->GetInteger(kVersionKey, &version) || version != kVersion ||
+      !root->GetDictionary(kServersKey, &servers)) {
+    LOG(WARNING) << "Ignoring invalid HTTP server properties";
+    return;
+  }
+
+  for (base::DictionaryValue::Iterator it(*servers); !it.IsAtEnd();
+       it.Advance()) {
+    net::HostPortPair server = net::HostPortPair::FromString(it.key());
+    const base::DictionaryValue* dict;
+    if (server.host().empty() || !it.value().GetAsDictionary(&dict))
+      continue;
+
+    bool supports_spdy;
+    if (dict->GetBoolean(kSupportsSpdyKey, &supports_spdy) && supports_spdy)
+      properties->SetSupportsSpdy(server, true);
+
+    const base::DictionaryValue* alternate_protocol;
+    int port;
+    std::string protocol_name;
+    if (properties->HasAlternateProtocol(server) ||
+        !dict->GetDictionary(kAlternateProtocolKey, &alternate_protocol) ||
+        !alternate_protocol->GetInteger(kPortKey, &port) ||
+        !alternate_protocol->GetString(kProtocolKey, &protocol_name) ||
+        port <= 0 || port > kuint16max)
+      continue;
+    net::AlternateProtocol protocol =
+        net::AlternateProtocolFromString(protocol_name);
+    if (net::IsAlternateProtocolValid(protocol))
+      properties->SetAlternateProtocol(server, port, protocol);
+  }
+}
+
+}  // namespace xwalk
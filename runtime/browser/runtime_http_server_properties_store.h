@@ -0,0 +1,66 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_HTTP_SERVER_PROPERTIES_STORE_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_HTTP_SERVER_PROPERTIES_STORE_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace net {
+class HttpServerPropertiesImpl;
+}
+
+namespace xwalk {
+
+// Keeps what the network stack learns about the servers, whether they speak
+// SPDY and their alternate protocols (e.g. QUIC), in a JSON file of the
+// runtime context. It is restored at the next launch so the first
+// connections to known servers skip protocol discovery. Lives on the IO
+// thread, the file is read and written on |file_task_runner|.
+class RuntimeHttpServerPropertiesStore {
+ public:
+  RuntimeHttpServerPropertiesStore(
+      const base::FilePath& path,
+      net::HttpServerPropertiesImpl* properties,
+      const scoped_refptr<base::SequencedTaskRunner>& file_task_runner);
+  // Saves the last changes.
+  ~RuntimeHttpServerPropertiesStore();
+
+  // Reads the file in the background. Properties learnt in the meantime are
+  // kept over the saved ones.
+  void Load();
+
+  static std::string Serialize(const net::HttpServerPropertiesImpl& properties);
+  static void Deserialize(const std::string& data,
+                          net::HttpServerPropertiesImpl* properties);
+
+ private:
+  void OnLoaded(const std::string& data);
+  // HttpServerPropertiesImpl has no change notifications, it is compared
+  // with the last saved state from time to time instead.
+  void SaveIfChanged();
+
+  net::HttpServerPropertiesImpl* properties_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  base::ImportantFileWriter writer_;
+  std::string saved_data_;
+  base::RepeatingTimer<RuntimeHttpServerPropertiesStore> save_timer_;
+  base::WeakPtrFactory<RuntimeHttpServerPropertiesStore> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeHttpServerPropertiesStore);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_HTTP_SERVER_PROPERTIES_STORE_H_
@@ -0,0 +1,55 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_http_server_properties_store.h"
+
+#include <string>
+
+#include "net/base/host_port_pair.h"
+#include "net/http/http_server_properties_impl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::RuntimeHttpServerPropertiesStore;
+
+TEST(RuntimeHttpServerPropertiesStoreTest, RoundTrip) {
+  const net::HostPortPair spdy_server("api.example.com", 443);
+  const net::HostPortPair quic_server("www.example.com", 80);
+
+  net::HttpServerPropertiesImpl properties;
+  properties.SetSupportsSpdy(spdy_server, true);
+  properties.SetAlternateProtocol(quic_server, 443, net::QUIC);
+  const std::string data =
+      RuntimeHttpServerPropertiesStore::Serialize(properties);
+
+  net::HttpServerPropertiesImpl restored;
+  RuntimeHttpServerPropertiesStore::Deserialize(data, &restored);
+  EXPECT_TRUE(restored.SupportsSpdy(spdy_server));
+  EXPECT_FALSE(restored.SupportsSpdy(quic_server));
+  ASSERT_TRUE(restored.HasAlternateProtocol(quic_server));
+  EXPECT_EQ(443, restored.GetAlternateProtocol(quic_server).port);
+  EXPECT_EQ(net::QUIC, restored.GetAlternateProtocol(quic_server).protocol);
+  EXPECT_EQ(data, RuntimeHttpServerPropertiesStore::Serialize(restored));
+}
+
+TEST(RuntimeHttpServerPropertiesStoreTest, KeepsLiveProperties) {
+  const net::HostPortPair server("www.example.com", 80);
+
+  net::HttpServerPropertiesImpl saved;
+  saved.SetAlternateProtocol(server, 443, net::QUIC);
+  const std::string data = RuntimeHttpServerPropertiesStore::Serialize(saved);
+
+  net::HttpServerPropertiesImpl properties;
+  properties.SetAlternateProtocol(server, 8443, net::QUIC);
+  RuntimeHttpServerPropertiesStore::Deserialize(data, &properties);
+  EXPECT_EQ(8443, properties.GetAlternateProtocol(server).port);
+}
+
+TEST(RuntimeHttpServerPropertiesStoreTest, IgnoresInvalidData) {
+  net::HttpServerPropertiesImpl properties;
+  RuntimeHttpServerPropertiesStore::Deserialize("{]", &properties);
+  RuntimeHttpServerPropertiesStore::Deserialize(
+      "{\"version\": 0, \"servers\": {\"a.com:80\": {\"supports_spdy\": true}}}",
+      &properties);
+  EXPECT_FALSE(properties.SupportsSpdy(net::HostPortPair("a.com", 80)));
+}
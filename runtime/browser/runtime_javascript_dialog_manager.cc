@@ -6,8 +6,12 @@
 
 #include <string>
 
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/metrics/histogram.h"
 #include "content/public/browser/javascript_dialog_manager.h"
 #include "content/public/browser/web_contents.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
 
 #if defined(OS_ANDROID)
 #include "xwalk/runtime/browser/android/xwalk_contents_client_bridge.h"
@@ -15,7 +19,26 @@
 
 namespace xwalk {
 
-RuntimeJavaScriptDialogManager::RuntimeJavaScriptDialogManager() {
+namespace {
+
+// A dialog opened this soon after the same one was closed is most likely
+// shown by a loop rather than read by the user.
+const int kRepeatedDialogIntervalMs = 1000;
+
+// The repetitions shown before the next ones are suppressed.
+const int kMaxRepeatedDialogs = 2;
+
+}  // namespace
+
+RuntimeJavaScriptDialogManager::DialogState::DialogState()
+    : type(content::JAVASCRIPT_MESSAGE_TYPE_ALERT),
+      repeat_count(0) {
+}
+
+RuntimeJavaScriptDialogManager::RuntimeJavaScriptDialogManager()
+    : auto_answer_(CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kAutoAnswerJavaScriptDialogs)),
+      weak_factory_(this) {
 }
 
 RuntimeJavaScriptDialogManager::~RuntimeJavaScriptDialogManager() {
@@ -30,6 +53,33 @@ void RuntimeJavaScriptDialogManager::RunJavaScriptDialog(
     const base::string16& default_prompt_text,
     const DialogClosedCallback& callback,
     bool* did_suppress_message) {
+  if (auto_answer_) {
+    callback.Run(true, default_prompt_text);
+    return;
+  }
+
+  DialogState& state = dialog_states_[web_contents];
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (javascript_message_type == state.type &&
+      message_text == state.message_text &&
+      !state.closed_time.is_null() &&
+      now - state.closed_time <
+          base::TimeDelta::FromMilliseconds(kRepeatedDialogIntervalMs)) {
+    if (++state.repeat_count > kMaxRepeatedDialogs) {
+      // Answered as cancelled by the caller. A loop keeps on being
+      // suppressed as long as it spins.
+      state.closed_time = now;
+      *did_suppress_message = true;
+      UMA_HISTOGRAM_COUNTS_100("XWalk.JavaScriptDialog.Suppressed",
+                               state.repeat_count);
+      return;
+    }
+  } else {
+    state.repeat_count = 0;
+  }
+  state.type = javascript_message_type;
+  state.message_text = message_text;
+
 #if defined(OS_ANDROID)
   XWalkContentsClientBridgeBase* bridge =
       XWalkContentsClientBridgeBase::FromWebContents(web_contents);
@@ -37,7 +87,7 @@ void RuntimeJavaScriptDialogManager::RunJavaScriptDialog(
                               origin_url,
                               message_text,
                               default_prompt_text,
-                              callback);
+                              WrapCallback(web_contents, callback));
 #else
   NOTIMPLEMENTED();
 #endif
@@ -48,12 +98,17 @@ void RuntimeJavaScriptDialogManager::RunBeforeUnloadDialog(
     const base::string16& message_text,
     bool is_reload,
     const DialogClosedCallback& callback) {
+  if (auto_answer_) {
+    callback.Run(true, base::string16());
+    return;
+  }
+
 #if defined(OS_ANDROID)
   XWalkContentsClientBridgeBase* bridge =
       XWalkContentsClientBridgeBase::FromWebContents(web_contents);
   bridge->RunBeforeUnloadDialog(web_contents->GetURL(),
                                 message_text,
-                                callback);
+                                WrapCallback(web_contents, callback));
 #else
   NOTIMPLEMENTED();
 #endif
@@ -66,7 +121,36 @@ void RuntimeJavaScriptDialogManager::CancelActiveAndPendingDialogs(
 
 void RuntimeJavaScriptDialogManager::WebContentsDestroyed(
     content::WebContents* web_contents) {
-  NOTIMPLEMENTED();
+  dialog_states_.erase(web_contents);
+}
+
+content::JavaScriptDialogManager::DialogClosedCallback
+RuntimeJavaScriptDialogManager::WrapCallback(
+    content::WebContents* web_contents,
+    const DialogClosedCallback& callback) {
+  return base::Bind(&RuntimeJavaScriptDialogManager::OnDialogClosed,
+                    weak_factory_.GetWeakPtr(), web_contents,
+                    base::TimeTicks::Now(), callback);
+}
+
+// static
+void RuntimeJavaScriptDialogManager::OnDialogClosed(
+    base::WeakPtr<RuntimeJavaScriptDialogManager> manager,
+    content::WebContents* web_contents,
+    base::TimeTicks open_time,
+    const DialogClosedCallback& callback,
+    bool success,
+    const base::string16& user_input) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  UMA_HISTOGRAM_LONG_TIMES("XWalk.JavaScriptDialog.BlockedTime",
+                           now - open_time);
+  if (manager) {
+    std::map<content::WebContents*, DialogState>::iterator it =
+        manager->dialog_states_.find(web_contents);
+    if (it != manager->dialog_states_.end())
+      it->second.closed_time = now;
+  }
+  callback.Run(success, user_input);
 }
 
 }  // namespace xwalk
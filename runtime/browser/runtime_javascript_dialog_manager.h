@@ -5,12 +5,22 @@
 #ifndef XWALK_RUNTIME_BROWSER_RUNTIME_JAVASCRIPT_DIALOG_MANAGER_H_
 #define XWALK_RUNTIME_BROWSER_RUNTIME_JAVASCRIPT_DIALOG_MANAGER_H_
 
+#include <map>
 #include <string>
 
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "content/public/browser/javascript_dialog_manager.h"
 
 namespace xwalk {
 
+// The renderer is blocked until a dialog is answered. So that pages calling
+// alert() or confirm() in a loop don't keep the user behind modal dialogs, a
+// dialog repeating the previous one of its WebContents right after it was
+// closed is suppressed after a few times. With
+// --auto-answer-javascript-dialogs the dialogs are answered without being
+// shown. The time the renderers are blocked is recorded in
+// XWalk.JavaScriptDialog.BlockedTime.
 class RuntimeJavaScriptDialogManager : public content::JavaScriptDialogManager {
  public:
   explicit RuntimeJavaScriptDialogManager();
@@ -37,6 +47,35 @@ class RuntimeJavaScriptDialogManager : public content::JavaScriptDialogManager {
       content::WebContents* web_contents) OVERRIDE;
 
  private:
+  // The last dialog of a WebContents.
+  struct DialogState {
+    DialogState();
+
+    content::JavaScriptMessageType type;
+    base::string16 message_text;
+    base::TimeTicks closed_time;
+    // How many times in a row the dialog was repeated.
+    int repeat_count;
+  };
+
+  // Wraps |callback| to record when the dialog of |web_contents| opening
+  // now is answered.
+  DialogClosedCallback WrapCallback(content::WebContents* web_contents,
+                                    const DialogClosedCallback& callback);
+  // Runs |callback| even if |manager| is gone, the renderer would stay
+  // blocked otherwise.
+  static void OnDialogClosed(
+      base::WeakPtr<RuntimeJavaScriptDialogManager> manager,
+      content::WebContents* web_contents,
+      base::TimeTicks open_time,
+      const DialogClosedCallback& callback,
+      bool success,
+      const base::string16& user_input);
+
+  const bool auto_answer_;
+  std::map<content::WebContents*, DialogState> dialog_states_;
+  base::WeakPtrFactory<RuntimeJavaScriptDialogManager> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(RuntimeJavaScriptDialogManager);
 };
 
@@ -0,0 +1,69 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_metrics.h"
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram_base.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/strings/string_util.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/histogram_fetcher.h"
+
+namespace xwalk {
+
+namespace {
+
+const char* const kReportedPrefixes[] = { "XWalk.", "NaCl." };
+
+// The render processes are busy at worst, not gone, but a caller waiting
+// for the metrics shouldn't wait for long.
+const int kFetchTimeoutMs = 500;
+
+bool IsReported(const std::string& name) {
+  for (size_t i = 0; i < arraysize(kReportedPrefixes); ++i) {
+    if (StartsWithASCII(name, kReportedPrefixes[i], true))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+// static
+void RuntimeMetrics::CollectAsJSON(const MetricsCallback& callback) {
+  DCHECK(content::BrowserThread::CurrentlyOn(content::BrowserThread::UI));
+  content::FetchHistogramsAsynchronously(
+      base::MessageLoop::current(),
+      base::Bind(&RuntimeMetrics::OnHistogramsFetched, callback),
+      base::TimeDelta::FromMilliseconds(kFetchTimeoutMs));
+}
+
+// static
+std::string RuntimeMetrics::GetHistogramsAsJSON() {
+  base::StatisticsRecorder::Histograms histograms;
+  base::StatisticsRecorder::GetHistograms(&histograms);
+
+  std::string json = "[";
+  for (base::StatisticsRecorder::Histograms::const_iterator it =
+           histograms.begin(); it != histograms.end(); ++it) {
+    if (!IsReported((*it)->histogram_name()))
+      continue;
+    // WriteJSON() replaces the content of its output.
+    std::string histogram_json;
+    (*it)->WriteJSON(&histogram_json);
+    if (json.size() > 1)
+      json += ',';
+    json += histogram_json;
+  }
+  return json + "]";
+}
+
+// static
+void RuntimeMetrics::OnHistogramsFetched(const MetricsCallback& callback) {
+  callback.Run(GetHistogramsAsJSON());
+}
+
+}  // namespace xwalk
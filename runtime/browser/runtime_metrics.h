@@ -0,0 +1,42 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_METRICS_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_METRICS_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+
+namespace xwalk {
+
+// Collects the histograms of the runtime, those of the browser process and
+// those recorded in the render processes, e.g. the "NaCl." ones recorded
+// by the plugins through PepperUMAHost, so they can be read by the
+// operators of a fleet without patching the runtime. Only the "XWalk." and
+// "NaCl." histograms are reported.
+class RuntimeMetrics {
+ public:
+  typedef base::Callback<void(const std::string& json)> MetricsCallback;
+
+  // Runs |callback| on the calling thread with the histograms as a JSON list
+  // of {"name": ..., "count": ..., "sum": ..., "buckets": [{"low": ...,
+  // "high": ..., "count": ...}, ...]}. The render processes not answering
+  // in time are left out. Must be called on the UI thread.
+  static void CollectAsJSON(const MetricsCallback& callback);
+
+  // The histograms already known by the browser process, without asking
+  // the render processes.
+  static std::string GetHistogramsAsJSON();
+
+ private:
+  static void OnHistogramsFetched(const MetricsCallback& callback);
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(RuntimeMetrics);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_METRICS_H_
@@ -7,6 +7,8 @@
 #include "net/base/net_errors.h"
 #include "net/base/static_cookie_policy.h"
 #include "net/url_request/url_request.h"
+#include "xwalk/runtime/browser/runtime_network_predictor.h"
+#include "xwalk/runtime/browser/runtime_network_stats.h"
 
 #if defined(OS_ANDROID)
 #include "xwalk/runtime/browser/android/xwalk_cookie_access_policy.h"
@@ -14,7 +16,9 @@
 
 namespace xwalk {
 
-RuntimeNetworkDelegate::RuntimeNetworkDelegate() {
+RuntimeNetworkDelegate::RuntimeNetworkDelegate(
+    RuntimeNetworkPredictor* predictor)
+    : predictor_(predictor) {
 }
 
 RuntimeNetworkDelegate::~RuntimeNetworkDelegate() {
@@ -24,6 +28,8 @@ int RuntimeNetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
     GURL* new_url) {
+  if (predictor_)
+    predictor_->LearnFromRequest(*request);
   return net::OK;
 }
 
@@ -57,13 +63,17 @@ void RuntimeNetworkDelegate::OnResponseStarted(net::URLRequest* request) {
 
 void RuntimeNetworkDelegate::OnRawBytesRead(const net::URLRequest& request,
                                             int bytes_read) {
+  RuntimeNetworkStats::GetInstance()->OnRawBytesRead(request, bytes_read);
 }
 
 void RuntimeNetworkDelegate::OnCompleted(net::URLRequest* request,
                                          bool started) {
+  if (started)
+    RuntimeNetworkStats::GetInstance()->OnCompleted(*request);
 }
 
 void RuntimeNetworkDelegate::OnURLRequestDestroyed(net::URLRequest* request) {
+  RuntimeNetworkStats::GetInstance()->OnURLRequestDestroyed(*request);
 }
 
 void RuntimeNetworkDelegate::OnPACScriptError(int line_number,
@@ -9,13 +9,17 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/ref_counted.h"
 #include "net/base/network_delegate.h"
 
 namespace xwalk {
 
+class RuntimeNetworkPredictor;
+
 class RuntimeNetworkDelegate : public net::NetworkDelegate {
  public:
-  RuntimeNetworkDelegate();
+  // |predictor| learns from the requests, it can be NULL.
+  explicit RuntimeNetworkDelegate(RuntimeNetworkPredictor* predictor);
   virtual ~RuntimeNetworkDelegate();
 
  private:
@@ -61,6 +65,8 @@ class RuntimeNetworkDelegate : public net::NetworkDelegate {
       net::SocketStream* stream,
       const net::CompletionCallback& callback) OVERRIDE;
 
+  scoped_refptr<RuntimeNetworkPredictor> predictor_;
+
   DISALLOW_COPY_AND_ASSIGN(RuntimeNetworkDelegate);
 };
 
@@ -0,0 +1,267 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_network_predictor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_runner_util.h"
+#include "base/values.h"
+#include "net/base/address_list.h"
+#include "net/base/host_port_pair.h"
+#include "net/base/net_log.h"
+#include "net/dns/host_resolver.h"
+#include "net/http/http_network_session.h"
+#include "net/http/http_request_info.h"
+#include "net/http/http_stream_factory.h"
+#include "net/http/http_transaction_factory.h"
+#include "net/ssl/ssl_config_service.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "xwalk/application/common/constants.h"
+
+using content::BrowserThread;
+
+namespace xwalk {
+
+namespace {
+
+const int kVersion = 1;
+// Counts stop growing there, it is more than enough to rank the origins.
+const int kMaxUses = 1 << 20;
+
+const char kVersionKey[] = "version";
+const char kApplicationsKey[] = "applications";
+
+std::string ReadFile(const base::FilePath& path) {
+  std::string data;
+  if (base::PathExists(path) && !base::ReadFileToString(path, &data))
+    LOG(WARNING) << "Can't read " << path.value();
+  return data;
+}
+
+bool MoreUsed(const std::pair<std::string, int>& a,
+              const std::pair<std::string, int>& b) {
+  return a.second > b.second;
+}
+
+// Resolutions are fire and forget, their results land in the host cache.
+void OnResolved(net::AddressList* addresses, int result) {
+}
+
+}  // namespace
+
+const size_t RuntimeNetworkPredictor::kMaxOriginsPerApplication;
+const size_t RuntimeNetworkPredictor::kMaxPreconnectsPerLaunch;
+
+RuntimeNetworkPredictor::RuntimeNetworkPredictor(
+    const base::FilePath& path,
+    const scoped_refptr<base::SequencedTaskRunner>& file_task_runner)
+    : path_(path),
+      file_task_runner_(file_task_runner),
+      loaded_(false),
+      weak_factory_(this) {
+}
+
+RuntimeNetworkPredictor::~RuntimeNetworkPredictor() {
+  if (writer_ && writer_->HasPendingWrite())
+    writer_->DoScheduledWrite();
+}
+
+void RuntimeNetworkPredictor::Load() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  writer_.reset(new base::ImportantFileWriter(path_, file_task_runner_.get()));
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&ReadFile, path_),
+      base::Bind(&RuntimeNetworkPredictor::OnLoaded,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void RuntimeNetworkPredictor::OnLoaded(const std::string& data) {
+  Deserialize(data);
+  loaded_ = true;
+  writer_->ScheduleWrite(this);
+}
+
+void RuntimeNetworkPredictor::LearnFromRequest(
+    const net::URLRequest& request) {
+  const GURL& first_party = request.first_party_for_cookies();
+  if (first_party.SchemeIs(application::kApplicationScheme))
+    Learn(first_party.host(), request.url());
+}
+
+void RuntimeNetworkPredictor::Learn(const std::string& app_id,
+                                    const GURL& url) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (app_id.empty() || !url.SchemeIsHTTPOrHTTPS())
+    return;
+
+  AddUses(app_id, url.GetOrigin().spec(), 1);
+  if (loaded_)
+    writer_->ScheduleWrite(this);
+}
+
+void RuntimeNetworkPredictor::AddUses(const std::string& app_id,
+                                      const std::string& origin,
+                                      int uses) {
+  OriginMap& origins = applications_[app_id];
+  int& total = origins[origin];
+  total = std::min(total + uses, kMaxUses);
+
+  // Make room by forgetting the least used of the other origins.
+  if (origins.size() > kMaxOriginsPerApplication) {
+    OriginMap::iterator least_used = origins.end();
+    for (OriginMap::iterator it = origins.begin(); it != origins.end(); ++it) {
+      if (it->first != origin &&
+          (least_used == origins.end() || it->second < least_used->second))
+        least_used = it;
+    }
+    origins.erase(least_used);
+  }
+}
+
+void RuntimeNetworkPredictor::PredictLaunch(
+    const std::string& app_id,
+    const scoped_refptr<net::URLRequestContextGetter>& getter) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&RuntimeNetworkPredictor::Predict, this, app_id, getter));
+}
+
+void RuntimeNetworkPredictor::Predict(
+    const std::string& app_id,
+    const scoped_refptr<net::URLRequestContextGetter>& getter) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  std::vector<GURL> origins = GetOrigins(app_id);
+  if (origins.empty())
+    return;
+
+  net::URLRequestContext* context = getter->GetURLRequestContext();
+  for (size_t i = 0; i < origins.size(); ++i) {
+    if (i < kMaxPreconnectsPerLaunch)
+      Preconnect(context, origins[i]);
+    else
+      Resolve(context, origins[i]);
+  }
+}
+
+void RuntimeNetworkPredictor::Preconnect(net::URLRequestContext* context,
+                                         const GURL& origin) {
+  net::HttpTransactionFactory* factory = context->http_transaction_factory();
+  net::HttpNetworkSession* session = factory ? factory->GetSession() : NULL;
+  if (!session) {
+    Resolve(context, origin);
+    return;
+  }
+
+  net::HttpRequestInfo request_info;
+  request_info.url = origin;
+  request_info.method = "GET";
+  net::SSLConfig ssl_config;
+  context->ssl_config_service()->GetSSLConfig(&ssl_config);
+  // The stream factory resolves the host, goes through the proxies and does
+  // the TLS handshake, then leaves the socket idle in its pool.
+  session->http_stream_factory()->PreconnectStreams(
+      1, request_info, net::IDLE, ssl_config, ssl_config);
+}
+
+void RuntimeNetworkPredictor::Resolve(net::URLRequestContext* context,
+                                      const GURL& origin) {
+  net::HostResolver::RequestInfo info(net::HostPortPair::FromURL(origin));
+  info.set_is_speculative(true);
+  // Owned by the callback, which is dropped if the resolution completes
+  // synchronously or the resolver goes away first.
+  net::AddressList* addresses = new net::AddressList;
+  net::HostResolver::RequestHandle handle;
+  context->host_resolver()->Resolve(
+      info, net::IDLE, addresses,
+      base::Bind(&OnResolved, base::Owned(addresses)),
+      &handle, net::BoundNetLog());
+}
+
+std::vector<GURL> RuntimeNetworkPredictor::GetOrigins(
+    const std::string& app_id) const {
+  std::vector<GURL> result;
+  ApplicationMap::const_iterator app = applications_.find(app_id);
+  if (app == applications_.end())
+    return result;
+
+  std::vector<std::pair<std::string, int> > origins(app->second.begin(),
+                                                    app->second.end());
+  std::stable_sort(origins.begin(), origins.end(), MoreUsed);
+  for (size_t i = 0; i < origins.size(); ++i)
+    result.push_back(GURL(origins[i].first));
+  return result;
+}
+
+bool RuntimeNetworkPredictor::SerializeData(std::string* data) {
+  *data = Serialize();
+  return true;
+}
+
+std::string RuntimeNetworkPredictor::Serialize() const {
+  base::DictionaryValue* applications = new base::DictionaryValue;
+  for (ApplicationMap::const_iterator app = applications_.begin();
+       app != applications_.end(); ++app) {
+    base::DictionaryValue* origins = new base::DictionaryValue;
+    for (OriginMap::const_iterator it = app->second.begin();
+         it != app->second.end(); ++it)
+      origins->SetIntegerWithoutPathExpansion(it->first, it->second);
+    applications->SetWithoutPathExpansion(app->first, origins);
+  }
+
+  base::DictionaryValue root;
+  root.SetInteger(kVersionKey, kVersion);
+  root.Set(kApplicationsKey, applications);
+
+  std::string data;
+  base::JSONWriter::Write(&root, &data);
+  return data;
+}
+
+void RuntimeNetworkPredictor::Deserialize(const std::string& data) {
+  if (data.empty())
+    return;
+
+  scoped_ptr<base::Value> value(base::JSONReader::Read(data));
+  base::DictionaryValue* root;
+  int version;
+  base::DictionaryValue* applications;
+  if (!value || !value->GetAsDictionary(&root) ||
+      !root->GetInteger(kVersionKey, &version) || version != kVersion ||
+      !root->GetDictionary(kApplicationsKey, &applications)) {
+    LOG(WARNING) << "Ignoring invalid network predictor data";
+    return;
+  }
+
+  for (base::DictionaryValue::Iterator app(*applications); !app.IsAtEnd();
+       app.Advance()) {
+    const base::DictionaryValue* origins;
+    if (!app.value().GetAsDictionary(&origins))
+      continue;
+    for (base::DictionaryValue::Iterator it(*origins); !it.IsAtEnd();
+         it.Advance()) {
+      int uses;
+      GURL origin(it.key());
+      if (app.key().empty() || !it.value().GetAsInteger(&uses) ||
+          uses <= 0 || !origin.SchemeIsHTTPOrHTTPS())
+        continue;
+      // Added to the uses learnt since the launch, if any.
+      AddUses(app.key(), origin.GetOrigin().spec(), std::min(uses, kMaxUses));
+    }
+  }
+}
+
+}  // namespace xwalk
@@ -0,0 +1,113 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_NETWORK_PREDICTOR_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_NETWORK_PREDICTOR_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "content/public/browser/browser_thread.h"
+#include "url/gurl.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace net {
+class URLRequest;
+class URLRequestContext;
+class URLRequestContextGetter;
+}
+
+namespace xwalk {
+
+// Learns the remote origins the pages of each application load their
+// subresources from. When the application is launched again they are resolved
+// and connected to while its start page is still being loaded, so the first
+// requests to them don't wait for DNS, TCP and TLS round trips. Applications
+// are keyed by their id, the host of the app:// first party of the requests.
+// The learnt origins are kept in a JSON file of the runtime context.
+//
+// Lives on the IO thread, except PredictLaunch() which is called on the UI
+// thread.
+class RuntimeNetworkPredictor
+    : public base::RefCountedThreadSafe<
+          RuntimeNetworkPredictor,
+          content::BrowserThread::DeleteOnIOThread>,
+      public base::ImportantFileWriter::DataSerializer {
+ public:
+  // Most used origins remembered per application.
+  static const size_t kMaxOriginsPerApplication = 16;
+  // How many of them are preconnected at launch, the others are resolved.
+  static const size_t kMaxPreconnectsPerLaunch = 4;
+
+  RuntimeNetworkPredictor(
+      const base::FilePath& path,
+      const scoped_refptr<base::SequencedTaskRunner>& file_task_runner);
+
+  // Reads the file in the background. Origins learnt in the meantime are
+  // merged with the saved ones.
+  void Load();
+
+  // Records the origin of |request| if it was issued by an application page.
+  void LearnFromRequest(const net::URLRequest& request);
+  void Learn(const std::string& app_id, const GURL& url);
+
+  // Warms up the connections to the origins learnt for |app_id| in the
+  // network stack of |getter|.
+  void PredictLaunch(
+      const std::string& app_id,
+      const scoped_refptr<net::URLRequestContextGetter>& getter);
+
+  // The origins learnt for |app_id|, the most used first.
+  std::vector<GURL> GetOrigins(const std::string& app_id) const;
+
+  std::string Serialize() const;
+  void Deserialize(const std::string& data);
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::IO>;
+  friend class base::DeleteHelper<RuntimeNetworkPredictor>;
+
+  // Saves the pending changes.
+  virtual ~RuntimeNetworkPredictor();
+
+  // base::ImportantFileWriter::DataSerializer implementation.
+  virtual bool SerializeData(std::string* data) OVERRIDE;
+
+  void OnLoaded(const std::string& data);
+  // Adds |uses| to the count of |origin|, forgetting another origin of
+  // |app_id| if it has too many.
+  void AddUses(const std::string& app_id, const std::string& origin, int uses);
+  void Predict(const std::string& app_id,
+               const scoped_refptr<net::URLRequestContextGetter>& getter);
+  void Preconnect(net::URLRequestContext* context, const GURL& origin);
+  void Resolve(net::URLRequestContext* context, const GURL& origin);
+
+  // Origin to the number of requests made to it.
+  typedef std::map<std::string, int> OriginMap;
+  typedef std::map<std::string, OriginMap> ApplicationMap;
+
+  ApplicationMap applications_;
+  base::FilePath path_;
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  // Created on the IO thread by Load().
+  scoped_ptr<base::ImportantFileWriter> writer_;
+  bool loaded_;
+  base::WeakPtrFactory<RuntimeNetworkPredictor> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeNetworkPredictor);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_NETWORK_PREDICTOR_H_
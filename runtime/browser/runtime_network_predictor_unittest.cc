@@ -0,0 +1,97 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_network_predictor.h"
+
+#include <string>
+#include <vector>
+
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/strings/string_number_conversions.h"
+#include "content/public/test/test_browser_thread_bundle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::RuntimeNetworkPredictor;
+
+class RuntimeNetworkPredictorTest : public testing::Test {
+ protected:
+  RuntimeNetworkPredictorTest()
+      : thread_bundle_(content::TestBrowserThreadBundle::IO_MAINLOOP) {}
+
+  virtual void SetUp() OVERRIDE {
+    predictor_ = CreatePredictor();
+  }
+
+  scoped_refptr<RuntimeNetworkPredictor> CreatePredictor() {
+    return new RuntimeNetworkPredictor(base::FilePath(),
+                                       base::MessageLoopProxy::current());
+  }
+
+  content::TestBrowserThreadBundle thread_bundle_;
+  scoped_refptr<RuntimeNetworkPredictor> predictor_;
+};
+
+TEST_F(RuntimeNetworkPredictorTest, LearnsOriginsByUse) {
+  predictor_->Learn("app", GURL("https://cdn.example.com/a.js"));
+  predictor_->Learn("app", GURL("http://api.example.com:8080/q"));
+  predictor_->Learn("app", GURL("https://cdn.example.com/b.css"));
+  predictor_->Learn("other", GURL("https://other.example.com/"));
+
+  std::vector<GURL> origins = predictor_->GetOrigins("app");
+  ASSERT_EQ(2u, origins.size());
+  EXPECT_EQ(GURL("https://cdn.example.com/"), origins[0]);
+  EXPECT_EQ(GURL("http://api.example.com:8080/"), origins[1]);
+  EXPECT_EQ(1u, predictor_->GetOrigins("other").size());
+  EXPECT_TRUE(predictor_->GetOrigins("unknown").empty());
+}
+
+TEST_F(RuntimeNetworkPredictorTest, IgnoresLocalResources) {
+  predictor_->Learn("app", GURL("app://app/index.html"));
+  predictor_->Learn("app", GURL("file:///tmp/a.js"));
+  predictor_->Learn("", GURL("https://cdn.example.com/a.js"));
+  EXPECT_TRUE(predictor_->GetOrigins("app").empty());
+  EXPECT_TRUE(predictor_->GetOrigins("").empty());
+}
+
+TEST_F(RuntimeNetworkPredictorTest, KeepsMostUsedOrigins) {
+  const GURL popular("https://popular.example.com/");
+  predictor_->Learn("app", popular);
+  predictor_->Learn("app", popular);
+  for (size_t i = 0; i < 2 * RuntimeNetworkPredictor::kMaxOriginsPerApplication;
+       ++i) {
+    predictor_->Learn(
+        "app", GURL("https://host" + base::Uint64ToString(i) + ".com/"));
+  }
+
+  std::vector<GURL> origins = predictor_->GetOrigins("app");
+  EXPECT_EQ(RuntimeNetworkPredictor::kMaxOriginsPerApplication,
+            origins.size());
+  EXPECT_EQ(popular, origins[0]);
+}
+
+TEST_F(RuntimeNetworkPredictorTest, SerializeRoundTrip) {
+  predictor_->Learn("app", GURL("https://cdn.example.com/a.js"));
+  predictor_->Learn("app", GURL("https://cdn.example.com/b.js"));
+  predictor_->Learn("app", GURL("https://api.example.com/"));
+
+  scoped_refptr<RuntimeNetworkPredictor> restored = CreatePredictor();
+  restored->Learn("app", GURL("https://api.example.com/"));
+  restored->Learn("app", GURL("https://api.example.com/"));
+  restored->Deserialize(predictor_->Serialize());
+
+  // The saved uses are added to the ones learnt since the launch.
+  std::vector<GURL> origins = restored->GetOrigins("app");
+  ASSERT_EQ(2u, origins.size());
+  EXPECT_EQ(GURL("https://api.example.com/"), origins[0]);
+  EXPECT_EQ(GURL("https://cdn.example.com/"), origins[1]);
+}
+
+TEST_F(RuntimeNetworkPredictorTest, DeserializeInvalid) {
+  predictor_->Deserialize("not json");
+  predictor_->Deserialize("{\"version\":2,\"applications\":{}}");
+  predictor_->Deserialize(
+      "{\"version\":1,\"applications\":{\"app\":{\"ftp://a.com/\":3,"
+      "\"https://b.com/\":-1,\"https://c.com/\":\"x\"}}}");
+  EXPECT_TRUE(predictor_->GetOrigins("app").empty());
+}
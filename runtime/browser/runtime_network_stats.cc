@@ -0,0 +1,173 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_network_stats.h"
+
+#include "base/logging.h"
+#include "base/values.h"
+#include "net/base/load_timing_info.h"
+#include "net/url_request/url_request.h"
+#include "xwalk/application/common/constants.h"
+
+namespace xwalk {
+
+namespace {
+
+base::LazyInstance<RuntimeNetworkStats>::Leaky g_network_stats =
+    LAZY_INSTANCE_INITIALIZER;
+
+const char* const kPhaseNames[RuntimeNetworkStats::PHASE_COUNT] = {
+  "dns",
+  "connect",
+  "ssl",
+  "timeToFirstByte",
+  "download"
+};
+
+// The application which issued |request|, empty if none did.
+std::string GetApplicationId(const net::URLRequest& request) {
+  const GURL& first_party = request.first_party_for_cookies();
+  if (!first_party.SchemeIs(application::kApplicationScheme))
+    return std::string();
+  return first_party.host();
+}
+
+}  // namespace
+
+RuntimeNetworkStats::RequestMetrics::RequestMetrics()
+    : succeeded(false),
+      was_cached(false),
+      bytes_read(0) {
+  for (int i = 0; i < PHASE_COUNT; ++i)
+    measured[i] = false;
+}
+
+void RuntimeNetworkStats::RequestMetrics::SetPhase(Phase phase,
+                                                   base::TimeDelta duration) {
+  phases[phase] = duration;
+  measured[phase] = true;
+}
+
+RuntimeNetworkStats::ApplicationStats::ApplicationStats()
+    : requests(0),
+      failed_requests(0),
+      cache_hits(0),
+      bytes_read(0) {
+}
+
+// static
+RuntimeNetworkStats* RuntimeNetworkStats::GetInstance() {
+  return g_network_stats.Pointer();
+}
+
+RuntimeNetworkStats::RuntimeNetworkStats() {
+}
+
+RuntimeNetworkStats::~RuntimeNetworkStats() {
+}
+
+void RuntimeNetworkStats::OnRawBytesRead(const net::URLRequest& request,
+                                         int bytes_read) {
+  if (!GetApplicationId(request).empty())
+    bytes_read_[&request] += bytes_read;
+}
+
+void RuntimeNetworkStats::OnCompleted(const net::URLRequest& request) {
+  const std::string app_id = GetApplicationId(request);
+  if (app_id.empty())
+    return;
+
+  RequestMetrics metrics;
+  metrics.succeeded = request.status().is_success();
+  metrics.was_cached = request.was_cached();
+  std::map<const net::URLRequest*, int64>::iterator bytes =
+      bytes_read_.find(&request);
+  if (bytes != bytes_read_.end()) {
+    metrics.bytes_read = bytes->second;
+    bytes_read_.erase(bytes);
+  }
+
+  net::LoadTimingInfo timing;
+  request.GetLoadTimingInfo(&timing);
+  const net::LoadTimingInfo::ConnectTiming& connect = timing.connect_timing;
+  if (!connect.dns_start.is_null())
+    metrics.SetPhase(PHASE_DNS, connect.dns_end - connect.dns_start);
+  if (!connect.connect_start.is_null()) {
+    // The connect timing of LoadTimingInfo includes the TLS handshake.
+    const base::TimeTicks tcp_end =
+        connect.ssl_start.is_null() ? connect.connect_end : connect.ssl_start;
+    metrics.SetPhase(PHASE_CONNECT, tcp_end - connect.connect_start);
+  }
+  if (!connect.ssl_start.is_null())
+    metrics.SetPhase(PHASE_SSL, connect.ssl_end - connect.ssl_start);
+  if (!timing.send_start.is_null() && !timing.receive_headers_end.is_null()) {
+    metrics.SetPhase(PHASE_TIME_TO_FIRST_BYTE,
+                     timing.receive_headers_end - timing.send_start);
+  }
+  if (!timing.receive_headers_end.is_null()) {
+    metrics.SetPhase(PHASE_DOWNLOAD,
+                     base::TimeTicks::Now() - timing.receive_headers_end);
+  }
+
+  RecordRequest(app_id, metrics);
+}
+
+void RuntimeNetworkStats::OnURLRequestDestroyed(
+    const net::URLRequest& request) {
+  bytes_read_.erase(&request);
+}
+
+void RuntimeNetworkStats::RecordRequest(const std::string& app_id,
+                                        const RequestMetrics& metrics) {
+  base::AutoLock lock(lock_);
+  ApplicationStats& stats = applications_[app_id];
+  ++stats.requests;
+  if (!metrics.succeeded)
+    ++stats.failed_requests;
+  if (metrics.was_cached)
+    ++stats.cache_hits;
+  stats.bytes_read += metrics.bytes_read;
+  for (int i = 0; i < PHASE_COUNT; ++i) {
+    if (!metrics.measured[i])
+      continue;
+    ++stats.phases[i].count;
+    stats.phases[i].total += metrics.phases[i];
+  }
+}
+
+scoped_ptr<base::DictionaryValue> RuntimeNetworkStats::GetStats(
+    const std::string& app_id) const {
+  ApplicationStats stats;
+  {
+    base::AutoLock lock(lock_);
+    std::map<std::string, ApplicationStats>::const_iterator it =
+        applications_.find(app_id);
+    if (it != applications_.end())
+      stats = it->second;
+  }
+
+  scoped_ptr<base::DictionaryValue> result(new base::DictionaryValue);
+  result->SetInteger("requests", stats.requests);
+  result->SetInteger("failedRequests", stats.failed_requests);
+  result->SetInteger("cacheHits", stats.cache_hits);
+  // There is no 64 bits integer in base::Value.
+  result->SetDouble("bytesRead", static_cast<double>(stats.bytes_read));
+  for (int i = 0; i < PHASE_COUNT; ++i) {
+    const PhaseStats& phase = stats.phases[i];
+    base::DictionaryValue* phase_value = new base::DictionaryValue;
+    phase_value->SetInteger("count", phase.count);
+    phase_value->SetDouble(
+        "averageMs", phase.count ? phase.total.InMillisecondsF() / phase.count
+                                 : 0);
+    result->Set(kPhaseNames[i], phase_value);
+  }
+  return result.Pass();
+}
+
+void RuntimeNetworkStats::Reset(const std::string& app_id) {
+  base::AutoLock lock(lock_);
+  applications_.erase(app_id);
+}
+
+}  // namespace xwalk
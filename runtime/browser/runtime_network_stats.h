@@ -0,0 +1,110 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_NETWORK_STATS_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_NETWORK_STATS_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/lazy_instance.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace net {
+class URLRequest;
+}
+
+namespace xwalk {
+
+// Aggregates the timing of the network requests made by each application,
+// keyed by application id as for RuntimeNetworkPredictor, so field
+// deployments can report how the network performs on the devices. Fed by
+// RuntimeNetworkDelegate on the IO thread, read through the
+// xwalk.app.runtime.getNetworkStats() JS API from any thread.
+class RuntimeNetworkStats {
+ public:
+  enum Phase {
+    PHASE_DNS,
+    PHASE_CONNECT,
+    PHASE_SSL,
+    // From sending the request to receiving the response headers.
+    PHASE_TIME_TO_FIRST_BYTE,
+    // From the response headers to the completion of the request.
+    PHASE_DOWNLOAD,
+    PHASE_COUNT
+  };
+
+  // What is known about a completed request. Phases the request didn't go
+  // through, e.g. the connection of a reused socket, aren't measured.
+  struct RequestMetrics {
+    RequestMetrics();
+
+    void SetPhase(Phase phase, base::TimeDelta duration);
+
+    bool succeeded;
+    bool was_cached;
+    int64 bytes_read;
+    base::TimeDelta phases[PHASE_COUNT];
+    bool measured[PHASE_COUNT];
+  };
+
+  static RuntimeNetworkStats* GetInstance();
+
+  // RuntimeNetworkDelegate hooks, on the IO thread. Requests not issued by
+  // an application page are ignored.
+  void OnRawBytesRead(const net::URLRequest& request, int bytes_read);
+  void OnCompleted(const net::URLRequest& request);
+  void OnURLRequestDestroyed(const net::URLRequest& request);
+
+  void RecordRequest(const std::string& app_id,
+                     const RequestMetrics& metrics);
+
+  // The totals and average phase durations of |app_id|, e.g.
+  // {"requests": 3, "failedRequests": 0, "cacheHits": 1,
+  //  "bytesRead": 5120, "dns": {"count": 2, "averageMs": 42.5}, ...}
+  scoped_ptr<base::DictionaryValue> GetStats(const std::string& app_id) const;
+  void Reset(const std::string& app_id);
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<RuntimeNetworkStats>;
+
+  struct PhaseStats {
+    PhaseStats() : count(0) {}
+
+    int count;
+    base::TimeDelta total;
+  };
+
+  struct ApplicationStats {
+    ApplicationStats();
+
+    int requests;
+    int failed_requests;
+    int cache_hits;
+    int64 bytes_read;
+    PhaseStats phases[PHASE_COUNT];
+  };
+
+  RuntimeNetworkStats();
+  ~RuntimeNetworkStats();
+
+  // Bytes read by the requests in flight, IO thread only.
+  std::map<const net::URLRequest*, int64> bytes_read_;
+
+  mutable base::Lock lock_;
+  std::map<std::string, ApplicationStats> applications_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeNetworkStats);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_NETWORK_STATS_H_
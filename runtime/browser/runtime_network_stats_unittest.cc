@@ -0,0 +1,80 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_network_stats.h"
+
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::RuntimeNetworkStats;
+
+namespace {
+
+RuntimeNetworkStats::RequestMetrics MakeMetrics(bool cached, int64 bytes) {
+  RuntimeNetworkStats::RequestMetrics metrics;
+  metrics.succeeded = true;
+  metrics.was_cached = cached;
+  metrics.bytes_read = bytes;
+  return metrics;
+}
+
+}  // namespace
+
+class RuntimeNetworkStatsTest : public testing::Test {
+ protected:
+  virtual void TearDown() OVERRIDE {
+    stats()->Reset("app");
+    stats()->Reset("other");
+  }
+
+  RuntimeNetworkStats* stats() { return RuntimeNetworkStats::GetInstance(); }
+};
+
+TEST_F(RuntimeNetworkStatsTest, AggregatesPerApplication) {
+  RuntimeNetworkStats::RequestMetrics network = MakeMetrics(false, 1000);
+  network.SetPhase(RuntimeNetworkStats::PHASE_DNS,
+                   base::TimeDelta::FromMilliseconds(40));
+  network.SetPhase(RuntimeNetworkStats::PHASE_TIME_TO_FIRST_BYTE,
+                   base::TimeDelta::FromMilliseconds(100));
+  stats()->RecordRequest("app", network);
+
+  network.SetPhase(RuntimeNetworkStats::PHASE_DNS,
+                   base::TimeDelta::FromMilliseconds(20));
+  network.succeeded = false;
+  stats()->RecordRequest("app", network);
+
+  stats()->RecordRequest("app", MakeMetrics(true, 24));
+  stats()->RecordRequest("other", MakeMetrics(false, 1));
+
+  scoped_ptr<base::DictionaryValue> result = stats()->GetStats("app");
+  int value;
+  double number;
+  EXPECT_TRUE(result->GetInteger("requests", &value));
+  EXPECT_EQ(3, value);
+  EXPECT_TRUE(result->GetInteger("failedRequests", &value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(result->GetInteger("cacheHits", &value));
+  EXPECT_EQ(1, value);
+  EXPECT_TRUE(result->GetDouble("bytesRead", &number));
+  EXPECT_EQ(2024, number);
+
+  EXPECT_TRUE(result->GetInteger("dns.count", &value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(result->GetDouble("dns.averageMs", &number));
+  EXPECT_DOUBLE_EQ(30, number);
+  EXPECT_TRUE(result->GetInteger("timeToFirstByte.count", &value));
+  EXPECT_EQ(2, value);
+  EXPECT_TRUE(result->GetInteger("ssl.count", &value));
+  EXPECT_EQ(0, value);
+}
+
+TEST_F(RuntimeNetworkStatsTest, Reset) {
+  stats()->RecordRequest("app", MakeMetrics(false, 10));
+  stats()->Reset("app");
+
+  scoped_ptr<base::DictionaryValue> result = stats()->GetStats("app");
+  int requests;
+  EXPECT_TRUE(result->GetInteger("requests", &requests));
+  EXPECT_EQ(0, requests);
+}
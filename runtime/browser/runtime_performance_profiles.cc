@@ -0,0 +1,176 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_performance_profiles.h"
+
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/json/json_reader.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
+
+namespace xwalk {
+
+namespace {
+
+const char kDefaultProfile[] = "default";
+
+// The built-in profiles:
+// - "gpu-raster" rasterizes on the GPU and uploads the tiles without a
+//   copy, for GPUs known to handle it well.
+// - "low-memory" keeps the tiles within a small GPU memory budget and
+//   rasterizes on a single thread.
+// - "no-vsync" doesn't wait for vsync, for panels driven without it.
+const char kBuiltInProfiles[] =
+    "{"
+    "  \"gpu-raster\": {"
+    "    \"enable-gpu-rasterization\": true,"
+    "    \"enable-impl-side-painting\": true,"
+    "    \"enable-map-image\": true"
+    "  },"
+    "  \"low-memory\": {"
+    "    \"force-gpu-mem-available-mb\": \"64\","
+    "    \"num-raster-threads\": \"1\""
+    "  },"
+    "  \"no-vsync\": {"
+    "    \"disable-gpu-vsync\": true"
+    "  }"
+    "}";
+
+const char* const kDeviceModelPaths[] = {
+  "/proc/device-tree/model",
+  "/sys/devices/virtual/dmi/id/product_name",
+};
+
+}  // namespace
+
+RuntimePerformanceProfiles::RuntimePerformanceProfiles() {
+  scoped_ptr<base::Value> built_in(base::JSONReader::Read(kBuiltInProfiles));
+  base::DictionaryValue* dict = NULL;
+  CHECK(built_in && built_in->GetAsDictionary(&dict));
+  profiles_.MergeDictionary(dict);
+}
+
+RuntimePerformanceProfiles::~RuntimePerformanceProfiles() {}
+
+bool RuntimePerformanceProfiles::LoadFromJSON(const std::string& json,
+                                              std::string* error) {
+  scoped_ptr<base::Value> value(base::JSONReader::ReadAndReturnError(
+      json, base::JSON_PARSE_RFC, NULL, error));
+  base::DictionaryValue* dict = NULL;
+  if (!value || !value->GetAsDictionary(&dict)) {
+    if (error->empty())
+      *error = "The performance profiles must be a dictionary.";
+    return false;
+  }
+
+  base::DictionaryValue* profiles = NULL;
+  base::DictionaryValue* devices = NULL;
+  if ((dict->HasKey("profiles") && !dict->GetDictionary("profiles",
+                                                        &profiles)) ||
+      (dict->HasKey("devices") && !dict->GetDictionary("devices", &devices))) {
+    *error = "\"profiles\" and \"devices\" must be dictionaries.";
+    return false;
+  }
+
+  if (profiles) {
+    for (base::DictionaryValue::Iterator it(*profiles); !it.IsAtEnd();
+         it.Advance()) {
+      if (!it.value().IsType(base::Value::TYPE_DICTIONARY)) {
+        *error = "The profile \"" + it.key() + "\" must be a dictionary.";
+        return false;
+      }
+    }
+    // Replaces whole profiles: a profile of the file doesn't inherit the
+    // switches of the built-in profile it overrides.
+    for (base::DictionaryValue::Iterator it(*profiles); !it.IsAtEnd();
+         it.Advance())
+      profiles_.SetWithoutPathExpansion(it.key(), it.value().DeepCopy());
+  }
+  if (devices)
+    devices_.MergeDictionary(devices);
+  return true;
+}
+
+std::string RuntimePerformanceProfiles::GetProfileForDevice(
+    const std::string& model) const {
+  std::string profile;
+  if (!model.empty())
+    devices_.GetStringWithoutPathExpansion(model, &profile);
+  return profile;
+}
+
+bool RuntimePerformanceProfiles::Apply(const std::string& profile,
+                                       CommandLine* command_line) const {
+  if (profile == kDefaultProfile)
+    return true;
+
+  const base::DictionaryValue* switches = NULL;
+  if (!profiles_.GetDictionaryWithoutPathExpansion(profile, &switches))
+    return false;
+
+  for (base::DictionaryValue::Iterator it(*switches); !it.IsAtEnd();
+       it.Advance()) {
+    if (command_line->HasSwitch(it.key()))
+      continue;
+
+    bool enabled;
+    std::string value;
+    if (it.value().GetAsBoolean(&enabled)) {
+      if (enabled)
+        command_line->AppendSwitch(it.key());
+    } else if (it.value().GetAsString(&value)) {
+      command_line->AppendSwitchASCII(it.key(), value);
+    } else {
+      LOG(WARNING) << "Ignoring the switch " << it.key()
+                   << " of the performance profile " << profile;
+    }
+  }
+  return true;
+}
+
+// static
+std::string RuntimePerformanceProfiles::GetDeviceModel() {
+  for (size_t i = 0; i < arraysize(kDeviceModelPaths); ++i) {
+    std::string model;
+    if (!base::ReadFileToString(base::FilePath(kDeviceModelPaths[i]), &model))
+      continue;
+    // The device tree model ends with a NUL, the DMI name with a newline.
+    model.erase(model.find_last_not_of(std::string("\n\0", 2)) + 1);
+    if (!model.empty())
+      return model;
+  }
+  return std::string();
+}
+
+// static
+void RuntimePerformanceProfiles::ApplyFromCommandLine(
+    CommandLine* command_line) {
+  RuntimePerformanceProfiles profiles;
+  std::string profile =
+      command_line->GetSwitchValueASCII(switches::kPerformanceProfile);
+
+  base::FilePath path =
+      command_line->GetSwitchValuePath(switches::kPerformanceProfilesFile);
+  if (!path.empty()) {
+    std::string json;
+    std::string error;
+    if (!base::ReadFileToString(path, &json)) {
+      LOG(WARNING) << "Can't read the performance profiles from "
+                   << path.value();
+    } else if (!profiles.LoadFromJSON(json, &error)) {
+      LOG(WARNING) << "Invalid performance profiles in " << path.value()
+                   << ": " << error;
+    } else if (profile.empty()) {
+      profile = profiles.GetProfileForDevice(GetDeviceModel());
+    }
+  }
+
+  if (!profile.empty() && !profiles.Apply(profile, command_line))
+    LOG(WARNING) << "Unknown performance profile: " << profile;
+}
+
+}  // namespace xwalk
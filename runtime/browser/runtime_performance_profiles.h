@@ -0,0 +1,64 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_PERFORMANCE_PROFILES_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_PERFORMANCE_PROFILES_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/values.h"
+
+class CommandLine;
+
+namespace xwalk {
+
+// Named sets of GPU and compositor switches tuned for a kind of device, so
+// a fleet doesn't need its flags patched per board. A profile is picked by
+// --performance-profile, or by the model of the device in the "devices" of
+// --performance-profiles-file:
+//
+//   {"profiles": {"imx6": {"enable-gpu-rasterization": true,
+//                          "force-gpu-mem-available-mb": "96"}},
+//    "devices": {"Freescale i.MX6 Quad SABRE Smart Device Board": "imx6"}}
+//
+// A boolean true appends the switch, a string appends it with that value.
+// The profiles of the file replace the built-in ones of the same name, and
+// a device mapped to "default" is left alone.
+class RuntimePerformanceProfiles {
+ public:
+  RuntimePerformanceProfiles();
+  ~RuntimePerformanceProfiles();
+
+  // Adds the profiles and devices of |json|. Returns false and sets |error|
+  // if it is malformed, the profiles already loaded are kept then.
+  bool LoadFromJSON(const std::string& json, std::string* error);
+
+  // The profile of the device |model|, empty if there is none.
+  std::string GetProfileForDevice(const std::string& model) const;
+
+  // Appends the switches of |profile| missing from |command_line|, those
+  // already there were chosen on purpose and win. Returns false if there is
+  // no such profile.
+  bool Apply(const std::string& profile, CommandLine* command_line) const;
+
+  // Reads the model of the device from the device tree or the DMI tables.
+  // Blocks on file IO, returns an empty string if there is no model.
+  static std::string GetDeviceModel();
+
+  // Applies the profile selected by the switches of |command_line| to it.
+  // Called before the child processes start, their switches are copied from
+  // the browser's.
+  static void ApplyFromCommandLine(CommandLine* command_line);
+
+ private:
+  base::DictionaryValue profiles_;
+  base::DictionaryValue devices_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimePerformanceProfiles);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_PERFORMANCE_PROFILES_H_
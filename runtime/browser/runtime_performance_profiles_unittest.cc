@@ -0,0 +1,58 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_performance_profiles.h"
+
+#include <string>
+
+#include "base/command_line.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::RuntimePerformanceProfiles;
+
+TEST(RuntimePerformanceProfilesTest, ApplyBuiltInProfile) {
+  RuntimePerformanceProfiles profiles;
+  CommandLine command_line(CommandLine::NO_PROGRAM);
+  command_line.AppendSwitchASCII("num-raster-threads", "2");
+  ASSERT_TRUE(profiles.Apply("low-memory", &command_line));
+  EXPECT_EQ("64",
+            command_line.GetSwitchValueASCII("force-gpu-mem-available-mb"));
+  // The switches given on purpose win.
+  EXPECT_EQ("2", command_line.GetSwitchValueASCII("num-raster-threads"));
+
+  EXPECT_FALSE(profiles.Apply("unknown", &command_line));
+}
+
+TEST(RuntimePerformanceProfilesTest, LoadProfilesAndDevices) {
+  RuntimePerformanceProfiles profiles;
+  std::string error;
+  ASSERT_TRUE(profiles.LoadFromJSON(
+      "{\"profiles\": {\"gpu-raster\": {\"disable-gpu-vsync\": true}},"
+      " \"devices\": {\"Board A\": \"gpu-raster\", \"Board B\": \"default\"}}",
+      &error));
+  EXPECT_EQ("gpu-raster", profiles.GetProfileForDevice("Board A"));
+  EXPECT_EQ("default", profiles.GetProfileForDevice("Board B"));
+  EXPECT_EQ(std::string(), profiles.GetProfileForDevice("Board C"));
+
+  // The profile of the file replaces the built-in one.
+  CommandLine command_line(CommandLine::NO_PROGRAM);
+  ASSERT_TRUE(profiles.Apply("gpu-raster", &command_line));
+  EXPECT_TRUE(command_line.HasSwitch("disable-gpu-vsync"));
+  EXPECT_FALSE(command_line.HasSwitch("enable-gpu-rasterization"));
+
+  CommandLine default_command_line(CommandLine::NO_PROGRAM);
+  EXPECT_TRUE(profiles.Apply("default", &default_command_line));
+  EXPECT_TRUE(default_command_line.GetSwitches().empty());
+}
+
+TEST(RuntimePerformanceProfilesTest, RejectMalformedProfiles) {
+  RuntimePerformanceProfiles profiles;
+  std::string error;
+  EXPECT_FALSE(profiles.LoadFromJSON("[]", &error));
+  EXPECT_FALSE(error.empty());
+  error.clear();
+  EXPECT_FALSE(profiles.LoadFromJSON(
+      "{\"profiles\": {\"broken\": true}}", &error));
+  EXPECT_FALSE(error.empty());
+}
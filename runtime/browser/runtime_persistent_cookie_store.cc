@@ -0,0 +1,120 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_persistent_cookie_store.h"
+
+#include <utility>
+
+#include "base/logging.h"
+
+namespace xwalk {
+
+const int RuntimePersistentCookieStore::kDefaultCommitIntervalSeconds;
+const size_t RuntimePersistentCookieStore::kDefaultMaxPendingOperations;
+
+RuntimePersistentCookieStore::RuntimePersistentCookieStore(
+    net::CookieMonster::PersistentCookieStore* backend,
+    base::TimeDelta commit_interval,
+    size_t max_pending_operations)
+    : backend_(backend),
+      commit_interval_(commit_interval),
+      max_pending_operations_(max_pending_operations) {
+  DCHECK(backend_);
+  DCHECK_GT(max_pending_operations_, 0u);
+}
+
+RuntimePersistentCookieStore::~RuntimePersistentCookieStore() {
+  // The backend commits what it has when it is closed.
+  SendPendingOperations();
+}
+
+void RuntimePersistentCookieStore::Load(const LoadedCallback& loaded_callback) {
+  backend_->Load(loaded_callback);
+}
+
+void RuntimePersistentCookieStore::LoadCookiesForKey(
+    const std::string& key,
+    const LoadedCallback& loaded_callback) {
+  backend_->LoadCookiesForKey(key, loaded_callback);
+}
+
+void RuntimePersistentCookieStore::AddCookie(const net::CanonicalCookie& cc) {
+  AddOperation(COOKIE_ADD, cc);
+}
+
+void RuntimePersistentCookieStore::UpdateCookieAccessTime(
+    const net::CanonicalCookie& cc) {
+  AddOperation(COOKIE_UPDATE_ACCESS_TIME, cc);
+}
+
+void RuntimePersistentCookieStore::DeleteCookie(
+    const net::CanonicalCookie& cc) {
+  AddOperation(COOKIE_DELETE, cc);
+}
+
+void RuntimePersistentCookieStore::SetForceKeepSessionState() {
+  backend_->SetForceKeepSessionState();
+}
+
+void RuntimePersistentCookieStore::Flush(const base::Closure& callback) {
+  commit_timer_.Stop();
+  SendPendingOperations();
+  backend_->Flush(callback);
+}
+
+void RuntimePersistentCookieStore::AddOperation(
+    OperationType type, const net::CanonicalCookie& cc) {
+  const int64 key = cc.CreationDate().ToInternalValue();
+  OperationMap::iterator it = pending_.find(key);
+  if (it != pending_.end()) {
+    Operation& pending = it->second;
+    if (pending.type == COOKIE_ADD && type == COOKIE_DELETE) {
+      // The cookie never made it to the disk.
+      pending_.erase(it);
+      return;
+    }
+    if (pending.type != COOKIE_DELETE && type != COOKIE_ADD) {
+      // Only the last state of the cookie is written, an addition stays one.
+      if (pending.type != COOKIE_ADD)
+        pending.type = type;
+      pending.cookie = cc;
+      return;
+    }
+    // Anything after a deletion must reach the backend after it.
+    SendPendingOperations();
+  }
+
+  pending_.insert(std::make_pair(key, Operation(type, cc)));
+  if (pending_.size() >= max_pending_operations_) {
+    Commit();
+  } else if (!commit_timer_.IsRunning()) {
+    commit_timer_.Start(FROM_HERE, commit_interval_,
+                        this, &RuntimePersistentCookieStore::Commit);
+  }
+}
+
+void RuntimePersistentCookieStore::SendPendingOperations() {
+  for (OperationMap::const_iterator it = pending_.begin();
+       it != pending_.end(); ++it) {
+    const Operation& operation = it->second;
+    switch (operation.type) {
+      case COOKIE_ADD:
+        backend_->AddCookie(operation.cookie);
+        break;
+      case COOKIE_UPDATE_ACCESS_TIME:
+        backend_->UpdateCookieAccessTime(operation.cookie);
+        break;
+      case COOKIE_DELETE:
+        backend_->DeleteCookie(operation.cookie);
+        break;
+    }
+  }
+  pending_.clear();
+}
+
+void RuntimePersistentCookieStore::Commit() {
+  Flush(base::Closure());
+}
+
+}  // namespace xwalk
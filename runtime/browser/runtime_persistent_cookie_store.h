@@ -0,0 +1,88 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_PERSISTENT_COOKIE_STORE_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_PERSISTENT_COOKIE_STORE_H_
+
+#include <map>
+#include <string>
+
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_monster.h"
+
+namespace xwalk {
+
+// Holds back the changes the cookie monster makes before they reach the
+// store on disk, and hands them over in batches: every |commit_interval|, or
+// as soon as |max_pending_operations| are waiting. While they wait, changes
+// to the same cookie are merged, so a cookie an analytics script rewrites on
+// every event costs one write per batch instead of one per event, and one
+// added then deleted within a batch never hits the disk. Each batch is
+// committed at once by flushing the backing store.
+//
+// Used on the IO thread, like the cookie monster.
+class RuntimePersistentCookieStore
+    : public net::CookieMonster::PersistentCookieStore {
+ public:
+  static const int kDefaultCommitIntervalSeconds = 30;
+  static const size_t kDefaultMaxPendingOperations = 512;
+
+  RuntimePersistentCookieStore(
+      net::CookieMonster::PersistentCookieStore* backend,
+      base::TimeDelta commit_interval,
+      size_t max_pending_operations);
+
+  // net::CookieMonster::PersistentCookieStore implementation.
+  virtual void Load(const LoadedCallback& loaded_callback) OVERRIDE;
+  virtual void LoadCookiesForKey(
+      const std::string& key,
+      const LoadedCallback& loaded_callback) OVERRIDE;
+  virtual void AddCookie(const net::CanonicalCookie& cc) OVERRIDE;
+  virtual void UpdateCookieAccessTime(const net::CanonicalCookie& cc) OVERRIDE;
+  virtual void DeleteCookie(const net::CanonicalCookie& cc) OVERRIDE;
+  virtual void SetForceKeepSessionState() OVERRIDE;
+  // Commits the pending changes right away.
+  virtual void Flush(const base::Closure& callback) OVERRIDE;
+
+  size_t pending_operations() const { return pending_.size(); }
+
+ private:
+  enum OperationType {
+    COOKIE_ADD,
+    COOKIE_UPDATE_ACCESS_TIME,
+    COOKIE_DELETE
+  };
+
+  struct Operation {
+    Operation(OperationType type, const net::CanonicalCookie& cookie)
+        : type(type), cookie(cookie) {}
+
+    OperationType type;
+    net::CanonicalCookie cookie;
+  };
+
+  // Keyed by creation time, which is how the backend tells cookies apart.
+  typedef std::map<int64, Operation> OperationMap;
+
+  virtual ~RuntimePersistentCookieStore();
+
+  void AddOperation(OperationType type, const net::CanonicalCookie& cc);
+  // Hands the pending operations over to the backend.
+  void SendPendingOperations();
+  void Commit();
+
+  scoped_refptr<net::CookieMonster::PersistentCookieStore> backend_;
+  const base::TimeDelta commit_interval_;
+  const size_t max_pending_operations_;
+  OperationMap pending_;
+  base::OneShotTimer<RuntimePersistentCookieStore> commit_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimePersistentCookieStore);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_PERSISTENT_COOKIE_STORE_H_
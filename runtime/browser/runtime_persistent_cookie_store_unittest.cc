@@ -0,0 +1,128 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_persistent_cookie_store.h"
+
+#include <string>
+#include <vector>
+
+#include "base/message_loop/message_loop.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using xwalk::RuntimePersistentCookieStore;
+
+namespace {
+
+// Records the operations it receives as "<operation>:<value>".
+class FakeCookieStore : public net::CookieMonster::PersistentCookieStore {
+ public:
+  FakeCookieStore() : flushes_(0) {}
+
+  virtual void Load(const LoadedCallback& loaded_callback) OVERRIDE {}
+  virtual void LoadCookiesForKey(
+      const std::string& key,
+      const LoadedCallback& loaded_callback) OVERRIDE {}
+  virtual void AddCookie(const net::CanonicalCookie& cc) OVERRIDE {
+    operations_.push_back("add:" + cc.Value());
+  }
+  virtual void UpdateCookieAccessTime(
+      const net::CanonicalCookie& cc) OVERRIDE {
+    operations_.push_back("update:" + cc.Value());
+  }
+  virtual void DeleteCookie(const net::CanonicalCookie& cc) OVERRIDE {
+    operations_.push_back("delete:" + cc.Value());
+  }
+  virtual void SetForceKeepSessionState() OVERRIDE {}
+  virtual void Flush(const base::Closure& callback) OVERRIDE {
+    ++flushes_;
+  }
+
+  const std::vector<std::string>& operations() const { return operations_; }
+  int flushes() const { return flushes_; }
+
+ private:
+  virtual ~FakeCookieStore() {}
+
+  std::vector<std::string> operations_;
+  int flushes_;
+};
+
+net::CanonicalCookie MakeCookie(int64 creation, const std::string& value) {
+  base::Time time = base::Time::FromInternalValue(creation);
+  return net::CanonicalCookie(GURL("http://example.com/"), "name", value,
+                              "example.com", "/", time, base::Time(), time,
+                              false, false, net::COOKIE_PRIORITY_DEFAULT);
+}
+
+}  // namespace
+
+class RuntimePersistentCookieStoreTest : public testing::Test {
+ protected:
+  void CreateStore(base::TimeDelta commit_interval, size_t batch_size) {
+    backend_ = new FakeCookieStore;
+    store_ = new RuntimePersistentCookieStore(
+        backend_.get(), commit_interval, batch_size);
+  }
+
+  base::MessageLoop message_loop_;
+  scoped_refptr<FakeCookieStore> backend_;
+  scoped_refptr<RuntimePersistentCookieStore> store_;
+};
+
+TEST_F(RuntimePersistentCookieStoreTest, MergesChangesToACookie) {
+  CreateStore(base::TimeDelta::FromHours(1), 100);
+  store_->AddCookie(MakeCookie(1, "a"));
+  store_->UpdateCookieAccessTime(MakeCookie(1, "b"));
+  store_->UpdateCookieAccessTime(MakeCookie(2, "c"));
+  store_->UpdateCookieAccessTime(MakeCookie(2, "d"));
+  store_->AddCookie(MakeCookie(3, "e"));
+  store_->DeleteCookie(MakeCookie(3, "e"));
+  EXPECT_EQ(2u, store_->pending_operations());
+  EXPECT_TRUE(backend_->operations().empty());
+
+  store_->Flush(base::Closure());
+  ASSERT_EQ(2u, backend_->operations().size());
+  EXPECT_EQ("add:b", backend_->operations()[0]);
+  EXPECT_EQ("update:d", backend_->operations()[1]);
+  EXPECT_EQ(1, backend_->flushes());
+  EXPECT_EQ(0u, store_->pending_operations());
+}
+
+TEST_F(RuntimePersistentCookieStoreTest, KeepsOrderAfterDeletion) {
+  CreateStore(base::TimeDelta::FromHours(1), 100);
+  store_->DeleteCookie(MakeCookie(1, "a"));
+  store_->AddCookie(MakeCookie(1, "b"));
+  ASSERT_EQ(1u, backend_->operations().size());
+  EXPECT_EQ("delete:a", backend_->operations()[0]);
+
+  store_->Flush(base::Closure());
+  ASSERT_EQ(2u, backend_->operations().size());
+  EXPECT_EQ("add:b", backend_->operations()[1]);
+}
+
+TEST_F(RuntimePersistentCookieStoreTest, CommitsFullBatches) {
+  CreateStore(base::TimeDelta::FromHours(1), 2);
+  store_->AddCookie(MakeCookie(1, "a"));
+  EXPECT_EQ(0, backend_->flushes());
+  store_->AddCookie(MakeCookie(2, "b"));
+  EXPECT_EQ(2u, backend_->operations().size());
+  EXPECT_EQ(1, backend_->flushes());
+}
+
+TEST_F(RuntimePersistentCookieStoreTest, CommitsAfterInterval) {
+  CreateStore(base::TimeDelta(), 100);
+  store_->AddCookie(MakeCookie(1, "a"));
+  EXPECT_EQ(0, backend_->flushes());
+  message_loop_.RunUntilIdle();
+  EXPECT_EQ(1u, backend_->operations().size());
+  EXPECT_EQ(1, backend_->flushes());
+}
+
+TEST_F(RuntimePersistentCookieStoreTest, SendsPendingChangesOnDestruction) {
+  CreateStore(base::TimeDelta::FromHours(1), 100);
+  store_->AddCookie(MakeCookie(1, "a"));
+  store_ = NULL;
+  EXPECT_EQ(1u, backend_->operations().size());
+}
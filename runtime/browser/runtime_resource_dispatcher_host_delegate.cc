@@ -18,6 +18,7 @@
 #include "net/base/load_flags.h"
 #include "net/http/http_response_headers.h"
 #include "net/url_request/url_request.h"
+#include "xwalk/runtime/browser/runtime_resource_scheduler.h"
 
 namespace {
 base::LazyInstance<xwalk::RuntimeResourceDispatcherHostDelegate>
@@ -37,6 +38,7 @@ RuntimeResourceDispatcherHostDelegate::
 void RuntimeResourceDispatcherHostDelegate::ResourceDispatcherHostCreated() {
   content::ResourceDispatcherHost::Get()->SetDelegate(
       &g_runtime_resource_dispatcher_host_delegate.Get());
+  RuntimeResourceScheduler::GetInstance()->Init();
 }
 
 void RuntimeResourceDispatcherHostDelegate::RequestBeginning(
@@ -47,6 +49,8 @@ void RuntimeResourceDispatcherHostDelegate::RequestBeginning(
     int child_id,
     int route_id,
     ScopedVector<content::ResourceThrottle>* throttles) {
+  RuntimeResourceScheduler::GetInstance()->ScheduleRequest(
+      request, resource_type, child_id, throttles);
 }
 
 void RuntimeResourceDispatcherHostDelegate::DownloadStarting(
@@ -64,7 +68,9 @@ bool RuntimeResourceDispatcherHostDelegate::HandleExternalProtocol(
     const GURL& url,
     int child_id,
     int route_id) {
-  return true;
+  // Same as without any delegate, which was the case before the requests
+  // were scheduled: the unknown schemes fail like any other request.
+  return false;
 }
 
 }  // namespace xwalk
@@ -27,6 +27,7 @@
 #include "xwalk/runtime/browser/android/xwalk_contents_io_thread_client.h"
 #include "xwalk/runtime/browser/android/xwalk_download_resource_throttle.h"
 #include "xwalk/runtime/browser/android/xwalk_login_delegate.h"
+#include "xwalk/runtime/browser/runtime_download_digests.h"
 
 using content::BrowserThread;
 using navigation_interception::InterceptNavigationDelegate;
@@ -255,6 +256,15 @@ void RuntimeResourceDispatcherHostDelegateAndroid::DownloadStarting(
     bool is_content_initiated,
     bool must_download,
     ScopedVector<content::ResourceThrottle>* throttles) {
+  // Pre-approved by the manifest, the download continues this response and
+  // is verified as it is saved, see RuntimeDownloadManagerDelegate.
+  if (RuntimeDownloadDigests::GetInstance()->HasDigest(
+          child_id, route_id, request->url())) {
+    throttles->push_back(new XWalkDownloadResourceThrottle(
+        request, child_id, route_id, request_id));
+    return;
+  }
+
   GURL url(request->url());
   std::string user_agent;
   std::string content_disposition;
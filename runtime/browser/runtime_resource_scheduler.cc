@@ -0,0 +1,215 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_resource_scheduler.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/metrics/histogram.h"
+#include "base/time/time.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/notification_details.h"
+#include "content/public/browser/notification_service.h"
+#include "content/public/browser/notification_source.h"
+#include "content/public/browser/notification_types.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_widget_host.h"
+#include "content/public/browser/resource_controller.h"
+#include "content/public/browser/resource_throttle.h"
+#include "net/base/request_priority.h"
+#include "net/url_request/url_request.h"
+
+using content::BrowserThread;
+
+namespace xwalk {
+
+namespace {
+
+base::LazyInstance<RuntimeResourceScheduler>::Leaky
+    g_runtime_resource_scheduler = LAZY_INSTANCE_INITIALIZER;
+
+bool IsRenderBlocking(ResourceType::Type resource_type) {
+  return resource_type == ResourceType::MAIN_FRAME ||
+         resource_type == ResourceType::SUB_FRAME ||
+         resource_type == ResourceType::STYLESHEET ||
+         resource_type == ResourceType::SCRIPT ||
+         resource_type == ResourceType::FONT_RESOURCE;
+}
+
+// Nothing is waiting for them, they can be sent once the application is
+// visible again.
+bool IsDeferrable(ResourceType::Type resource_type) {
+  return resource_type == ResourceType::PREFETCH ||
+         resource_type == ResourceType::PING;
+}
+
+}  // namespace
+
+// Defers the request while its Render Process is in the background. The
+// request is cancelled with the process if it is never visible again.
+class RuntimeResourceScheduler::BackgroundThrottle
+    : public content::ResourceThrottle {
+ public:
+  BackgroundThrottle(RuntimeResourceScheduler* scheduler, int child_id)
+      : scheduler_(scheduler),
+        child_id_(child_id),
+        deferred_(false) {
+  }
+
+  virtual ~BackgroundThrottle() {
+    DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+    if (deferred_)
+      scheduler_->RemoveDeferredThrottle(child_id_, this);
+  }
+
+  // content::ResourceThrottle implementation.
+  virtual void WillStartRequest(bool* defer) OVERRIDE {
+    if (!scheduler_->IsProcessBackgrounded(child_id_))
+      return;
+    *defer = deferred_ = true;
+    defer_time_ = base::TimeTicks::Now();
+    scheduler_->AddDeferredThrottle(child_id_, this);
+  }
+
+  virtual const char* GetNameForLogging() const OVERRIDE {
+    return "RuntimeResourceScheduler::BackgroundThrottle";
+  }
+
+  // Called once the scheduler forgot about this throttle.
+  void Resume() {
+    deferred_ = false;
+    UMA_HISTOGRAM_LONG_TIMES("XWalk.ResourceScheduler.BackgroundDeferTime",
+                             base::TimeTicks::Now() - defer_time_);
+    controller()->Resume();
+  }
+
+ private:
+  RuntimeResourceScheduler* scheduler_;
+  int child_id_;
+  bool deferred_;
+  base::TimeTicks defer_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundThrottle);
+};
+
+RuntimeResourceScheduler::RuntimeResourceScheduler() {
+}
+
+RuntimeResourceScheduler::~RuntimeResourceScheduler() {
+}
+
+// static
+RuntimeResourceScheduler* RuntimeResourceScheduler::GetInstance() {
+  return g_runtime_resource_scheduler.Pointer();
+}
+
+void RuntimeResourceScheduler::Init() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  registrar_.Add(this, content::NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED,
+                 content::NotificationService::AllSources());
+  registrar_.Add(this, content::NOTIFICATION_RENDERER_PROCESS_TERMINATED,
+                 content::NotificationService::AllSources());
+  registrar_.Add(this, content::NOTIFICATION_RENDERER_PROCESS_CLOSED,
+                 content::NotificationService::AllSources());
+}
+
+void RuntimeResourceScheduler::ScheduleRequest(
+    net::URLRequest* request,
+    ResourceType::Type resource_type,
+    int child_id,
+    ScopedVector<content::ResourceThrottle>* throttles) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (!request->url().SchemeIsHTTPOrHTTPS())
+    return;
+
+  if (!IsProcessBackgrounded(child_id)) {
+    if (IsRenderBlocking(resource_type))
+      request->SetPriority(net::HIGHEST);
+    return;
+  }
+
+  // The main frame of an application loading in the background is still
+  // what it waits for.
+  if (resource_type != ResourceType::MAIN_FRAME)
+    request->SetPriority(net::IDLE);
+  // The process may be visible again by the time the request starts.
+  if (IsDeferrable(resource_type))
+    throttles->push_back(new BackgroundThrottle(this, child_id));
+}
+
+void RuntimeResourceScheduler::Observe(
+    int type,
+    const content::NotificationSource& source,
+    const content::NotificationDetails& details) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  content::RenderProcessHost* process = NULL;
+  bool backgrounded = false;
+  switch (type) {
+    case content::NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED:
+      process = content::Source<content::RenderWidgetHost>(source)->
+          GetProcess();
+      backgrounded = process->VisibleWidgetCount() == 0;
+      break;
+    case content::NOTIFICATION_RENDERER_PROCESS_TERMINATED:
+    case content::NOTIFICATION_RENDERER_PROCESS_CLOSED:
+      // Its requests are cancelled, only the id has to be forgotten.
+      process = content::Source<content::RenderProcessHost>(source).ptr();
+      break;
+    default:
+      NOTREACHED();
+      return;
+  }
+
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&RuntimeResourceScheduler::SetProcessBackgrounded,
+                 base::Unretained(this), process->GetID(), backgrounded));
+}
+
+void RuntimeResourceScheduler::SetProcessBackgrounded(int child_id,
+                                                      bool backgrounded) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (backgrounded) {
+    background_processes_.insert(child_id);
+    return;
+  }
+  if (!background_processes_.erase(child_id))
+    return;
+
+  // Resuming a request may complete it and destroy its throttle, they are
+  // forgotten first.
+  std::vector<BackgroundThrottle*> throttles;
+  std::pair<ThrottleMap::iterator, ThrottleMap::iterator> range =
+      deferred_throttles_.equal_range(child_id);
+  for (ThrottleMap::iterator it = range.first; it != range.second; ++it)
+    throttles.push_back(it->second);
+  deferred_throttles_.erase(range.first, range.second);
+
+  for (size_t i = 0; i < throttles.size(); ++i)
+    throttles[i]->Resume();
+}
+
+bool RuntimeResourceScheduler::IsProcessBackgrounded(int child_id) const {
+  return background_processes_.find(child_id) != background_processes_.end();
+}
+
+void RuntimeResourceScheduler::AddDeferredThrottle(
+    int child_id, BackgroundThrottle* throttle) {
+  deferred_throttles_.insert(std::make_pair(child_id, throttle));
+}
+
+void RuntimeResourceScheduler::RemoveDeferredThrottle(
+    int child_id, BackgroundThrottle* throttle) {
+  std::pair<ThrottleMap::iterator, ThrottleMap::iterator> range =
+      deferred_throttles_.equal_range(child_id);
+  for (ThrottleMap::iterator it = range.first; it != range.second; ++it) {
+    if (it->second == throttle) {
+      deferred_throttles_.erase(it);
+      return;
+    }
+  }
+}
+
+}  // namespace xwalk
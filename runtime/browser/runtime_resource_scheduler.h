@@ -0,0 +1,86 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_RESOURCE_SCHEDULER_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_RESOURCE_SCHEDULER_H_
+
+#include <map>
+#include <set>
+
+#include "base/lazy_instance.h"
+#include "base/memory/scoped_vector.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
+#include "webkit/common/resource_type.h"
+
+namespace content {
+class ResourceThrottle;
+}
+
+namespace net {
+class URLRequest;
+}
+
+namespace xwalk {
+
+// Orders the network requests of the applications sharing the browser
+// process by the visibility of their Render Processes, each application
+// running in its own one. While an application has no visible window:
+//  - its prefetches and pings (e.g. analytics beacons) are deferred until
+//    it is visible again,
+//  - its other remote requests get the lowest priority.
+// The render-blocking resources of the visible applications (frames,
+// stylesheets, scripts and fonts) get the highest priority.
+//
+// Only the http(s) requests are scheduled, app:// and file:// requests
+// don't compete for sockets and bandwidth.
+//
+// The visibility is followed on the UI thread, the requests are scheduled
+// on the IO thread.
+class RuntimeResourceScheduler : public content::NotificationObserver {
+ public:
+  static RuntimeResourceScheduler* GetInstance();
+
+  // Starts following the visibility of the Render Processes. UI thread.
+  void Init();
+
+  // Adjusts the priority of |request| and adds the throttle deferring it
+  // if needed. IO thread.
+  void ScheduleRequest(net::URLRequest* request,
+                       ResourceType::Type resource_type,
+                       int child_id,
+                       ScopedVector<content::ResourceThrottle>* throttles);
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<RuntimeResourceScheduler>;
+  class BackgroundThrottle;
+  typedef std::multimap<int, BackgroundThrottle*> ThrottleMap;
+
+  RuntimeResourceScheduler();
+  virtual ~RuntimeResourceScheduler();
+
+  // content::NotificationObserver implementation.
+  virtual void Observe(int type,
+                       const content::NotificationSource& source,
+                       const content::NotificationDetails& details) OVERRIDE;
+
+  // IO thread.
+  void SetProcessBackgrounded(int child_id, bool backgrounded);
+  bool IsProcessBackgrounded(int child_id) const;
+  void AddDeferredThrottle(int child_id, BackgroundThrottle* throttle);
+  void RemoveDeferredThrottle(int child_id, BackgroundThrottle* throttle);
+
+  content::NotificationRegistrar registrar_;
+
+  // The processes without any visible widget. IO thread.
+  std::set<int> background_processes_;
+  // The throttles deferring their requests, by process. IO thread.
+  ThrottleMap deferred_throttles_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeResourceScheduler);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_RESOURCE_SCHEDULER_H_
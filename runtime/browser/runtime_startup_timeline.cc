@@ -0,0 +1,151 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_startup_timeline.h"
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
+
+namespace xwalk {
+
+namespace {
+
+base::LazyInstance<RuntimeStartupTimeline>::Leaky g_startup_timeline =
+    LAZY_INSTANCE_INITIALIZER;
+
+const char* const kMilestoneNames[RuntimeStartupTimeline::MILESTONE_COUNT] = {
+  "externalExtensionsRegistered",
+  "naclStartupPosted",
+  "remoteDebuggingStarted",
+  "nativeWindowInitialized",
+  "applicationDataLoaded",
+  "applicationLaunched",
+  "renderProcessLaunch",
+  "extensionProcessChannelReady",
+  "firstScriptContext",
+  "firstPaint"
+};
+
+// The histograms are suffixed with the milestone names, capitalized.
+const char* const kHistogramNames[RuntimeStartupTimeline::MILESTONE_COUNT] = {
+  "XWalk.Startup.ExternalExtensionsRegistered",
+  "XWalk.Startup.NaClStartupPosted",
+  "XWalk.Startup.RemoteDebuggingStarted",
+  "XWalk.Startup.NativeWindowInitialized",
+  "XWalk.Startup.ApplicationDataLoaded",
+  "XWalk.Startup.ApplicationLaunched",
+  "XWalk.Startup.RenderProcessLaunch",
+  "XWalk.Startup.ExtensionProcessChannelReady",
+  "XWalk.Startup.FirstScriptContext",
+  "XWalk.Startup.FirstPaint"
+};
+
+// The trace dumps are written one after the other.
+const char kTraceSequenceName[] = "XWalkStartupTrace";
+
+}  // namespace
+
+// static
+RuntimeStartupTimeline* RuntimeStartupTimeline::GetInstance() {
+  return g_startup_timeline.Pointer();
+}
+
+RuntimeStartupTimeline::RuntimeStartupTimeline() {
+  for (int i = 0; i < MILESTONE_COUNT; ++i)
+    reached_[i] = false;
+}
+
+RuntimeStartupTimeline::~RuntimeStartupTimeline() {
+}
+
+void RuntimeStartupTimeline::Start() {
+  base::AutoLock lock(lock_);
+  if (!origin_.is_null())
+    return;
+  origin_ = base::TimeTicks::Now();
+  trace_path_ = CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+      switches::kXWalkStartupTrace);
+}
+
+void RuntimeStartupTimeline::Record(Milestone milestone) {
+  RecordAt(milestone, base::TimeTicks::Now());
+}
+
+void RuntimeStartupTimeline::RecordAt(Milestone milestone,
+                                      base::TimeTicks time) {
+  DCHECK_LT(milestone, MILESTONE_COUNT);
+  base::TimeDelta elapsed;
+  base::FilePath trace_path;
+  {
+    base::AutoLock lock(lock_);
+    if (origin_.is_null() || reached_[milestone])
+      return;
+    elapsed = time - origin_;
+    milestones_[milestone] = elapsed;
+    reached_[milestone] = true;
+    trace_path = trace_path_;
+  }
+
+  // Same as UMA_HISTOGRAM_MEDIUM_TIMES, which needs a constant name.
+  base::HistogramBase* histogram = base::Histogram::FactoryTimeGet(
+      kHistogramNames[milestone],
+      base::TimeDelta::FromMilliseconds(10),
+      base::TimeDelta::FromMinutes(3),
+      50,
+      base::HistogramBase::kUmaTargetedHistogramFlag);
+  histogram->AddTime(elapsed);
+
+  if (trace_path.empty())
+    return;
+
+  std::string data;
+  base::JSONWriter::WriteWithOptions(GetMilestones().get(),
+                                     base::JSONWriter::OPTIONS_PRETTY_PRINT,
+                                     &data);
+  content::BrowserThread::PostBlockingPoolSequencedTask(
+      kTraceSequenceName, FROM_HERE,
+      base::Bind(&RuntimeStartupTimeline::WriteTrace, trace_path, data));
+}
+
+scoped_ptr<base::DictionaryValue> RuntimeStartupTimeline::GetMilestones()
+    const {
+  scoped_ptr<base::DictionaryValue> result(new base::DictionaryValue);
+  base::AutoLock lock(lock_);
+  for (int i = 0; i < MILESTONE_COUNT; ++i) {
+    if (reached_[i])
+      result->SetDouble(kMilestoneNames[i], milestones_[i].InMillisecondsF());
+  }
+  return result.Pass();
+}
+
+void RuntimeStartupTimeline::SetOriginForTesting(base::TimeTicks origin) {
+  base::AutoLock lock(lock_);
+  origin_ = origin;
+}
+
+void RuntimeStartupTimeline::ResetForTesting() {
+  base::AutoLock lock(lock_);
+  origin_ = base::TimeTicks();
+  for (int i = 0; i < MILESTONE_COUNT; ++i)
+    reached_[i] = false;
+  trace_path_.clear();
+}
+
+// static
+void RuntimeStartupTimeline::WriteTrace(const base::FilePath& path,
+                                        const std::string& data) {
+  if (base::WriteFile(path, data.data(), data.size()) !=
+      static_cast<int>(data.size()))
+    LOG(WARNING) << "Failed to write the startup trace to "
+                 << path.AsUTF8Unsafe();
+}
+
+}  // namespace xwalk
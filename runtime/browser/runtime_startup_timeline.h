@@ -0,0 +1,84 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_STARTUP_TIMELINE_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_STARTUP_TIMELINE_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/lazy_instance.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace xwalk {
+
+// Timestamps the phases of a cold start, from the creation of
+// XWalkBrowserMainParts to the first paint of the application, so startup
+// regressions can be tracked. Each milestone is reported once as an
+// "XWalk.Startup.<milestone>" histogram and, with --xwalk-startup-trace, the
+// timeline is dumped as JSON to the given file every time it grows. Can be
+// used from any thread.
+class RuntimeStartupTimeline {
+ public:
+  enum Milestone {
+    MILESTONE_EXTERNAL_EXTENSIONS_REGISTERED,
+    MILESTONE_NACL_STARTUP_POSTED,
+    MILESTONE_REMOTE_DEBUGGING_STARTED,
+    MILESTONE_NATIVE_WINDOW_INITIALIZED,
+    // ApplicationStorage::GetApplicationData() or LoadApplication() returned.
+    MILESTONE_APPLICATION_DATA_LOADED,
+    MILESTONE_APPLICATION_LAUNCHED,
+    MILESTONE_RENDER_PROCESS_LAUNCH,
+    MILESTONE_EXTENSION_PROCESS_CHANNEL_READY,
+    // The renderer created the script context of a frame, the extensions
+    // are being injected.
+    MILESTONE_FIRST_SCRIPT_CONTEXT,
+    MILESTONE_FIRST_PAINT,
+    MILESTONE_COUNT
+  };
+
+  static RuntimeStartupTimeline* GetInstance();
+
+  // Reads --xwalk-startup-trace. The time of this call is the origin of the
+  // timeline.
+  void Start();
+
+  // Only the first occurrence of each milestone is recorded.
+  void Record(Milestone milestone);
+  void RecordAt(Milestone milestone, base::TimeTicks time);
+
+  // The milestones reached so far in milliseconds since the origin, e.g.
+  // {"nativeWindowInitialized": 52.1, "firstPaint": 410.7}.
+  scoped_ptr<base::DictionaryValue> GetMilestones() const;
+
+  void SetOriginForTesting(base::TimeTicks origin);
+  void ResetForTesting();
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<RuntimeStartupTimeline>;
+
+  RuntimeStartupTimeline();
+  ~RuntimeStartupTimeline();
+
+  static void WriteTrace(const base::FilePath& path, const std::string& data);
+
+  mutable base::Lock lock_;
+  base::TimeTicks origin_;
+  base::TimeDelta milestones_[MILESTONE_COUNT];
+  bool reached_[MILESTONE_COUNT];
+  base::FilePath trace_path_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeStartupTimeline);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_STARTUP_TIMELINE_H_
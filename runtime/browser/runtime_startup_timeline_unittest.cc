@@ -0,0 +1,63 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_startup_timeline.h"
+
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::RuntimeStartupTimeline;
+
+class RuntimeStartupTimelineTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    origin_ = base::TimeTicks::Now();
+    timeline()->SetOriginForTesting(origin_);
+  }
+
+  virtual void TearDown() OVERRIDE {
+    timeline()->ResetForTesting();
+  }
+
+  RuntimeStartupTimeline* timeline() {
+    return RuntimeStartupTimeline::GetInstance();
+  }
+
+  void RecordAfter(RuntimeStartupTimeline::Milestone milestone, int ms) {
+    timeline()->RecordAt(milestone,
+                         origin_ + base::TimeDelta::FromMilliseconds(ms));
+  }
+
+  base::TimeTicks origin_;
+};
+
+TEST_F(RuntimeStartupTimelineTest, RecordsTimeSinceOrigin) {
+  RecordAfter(RuntimeStartupTimeline::MILESTONE_NATIVE_WINDOW_INITIALIZED, 50);
+  RecordAfter(RuntimeStartupTimeline::MILESTONE_FIRST_PAINT, 400);
+
+  scoped_ptr<base::DictionaryValue> milestones = timeline()->GetMilestones();
+  EXPECT_EQ(2u, milestones->size());
+  double ms;
+  EXPECT_TRUE(milestones->GetDouble("nativeWindowInitialized", &ms));
+  EXPECT_DOUBLE_EQ(50, ms);
+  EXPECT_TRUE(milestones->GetDouble("firstPaint", &ms));
+  EXPECT_DOUBLE_EQ(400, ms);
+}
+
+TEST_F(RuntimeStartupTimelineTest, KeepsFirstOccurrence) {
+  RecordAfter(RuntimeStartupTimeline::MILESTONE_FIRST_SCRIPT_CONTEXT, 100);
+  RecordAfter(RuntimeStartupTimeline::MILESTONE_FIRST_SCRIPT_CONTEXT, 300);
+
+  scoped_ptr<base::DictionaryValue> milestones = timeline()->GetMilestones();
+  double ms;
+  EXPECT_TRUE(milestones->GetDouble("firstScriptContext", &ms));
+  EXPECT_DOUBLE_EQ(100, ms);
+}
+
+TEST_F(RuntimeStartupTimelineTest, IgnoresMilestonesBeforeStart) {
+  timeline()->ResetForTesting();
+  timeline()->Record(RuntimeStartupTimeline::MILESTONE_APPLICATION_LAUNCHED);
+
+  EXPECT_TRUE(timeline()->GetMilestones()->empty());
+}
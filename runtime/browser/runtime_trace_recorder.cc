@@ -0,0 +1,110 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/runtime_trace_recorder.h"
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/tracing_controller.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
+
+using content::BrowserThread;
+using content::TracingController;
+
+namespace xwalk {
+
+namespace {
+
+// The categories the devtools timeline records, plus the compositor, GPU
+// and V8 ones.
+const char kDefaultCategories[] =
+    "benchmark,blink.console,cc,gpu,input,renderer,toplevel,v8,"
+    "disabled-by-default-devtools.timeline,"
+    "disabled-by-default-devtools.timeline.frame";
+
+const int kDefaultDurationInSeconds = 10;
+
+void OnTraceWritten(const base::FilePath& path) {
+  LOG(INFO) << "Performance trace written to " << path.AsUTF8Unsafe();
+}
+
+}  // namespace
+
+// static
+scoped_ptr<RuntimeTraceRecorder> RuntimeTraceRecorder::CreateFromCommandLine(
+    const CommandLine& command_line) {
+  if (!command_line.HasSwitch(switches::kXWalkPerfTrace))
+    return scoped_ptr<RuntimeTraceRecorder>();
+
+  std::string categories = kDefaultCategories;
+  if (command_line.HasSwitch(switches::kXWalkPerfTraceCategories)) {
+    categories = command_line.GetSwitchValueASCII(
+        switches::kXWalkPerfTraceCategories);
+  }
+
+  int duration = kDefaultDurationInSeconds;
+  if (command_line.HasSwitch(switches::kXWalkPerfTraceDuration) &&
+      (!base::StringToInt(command_line.GetSwitchValueASCII(
+            switches::kXWalkPerfTraceDuration), &duration) ||
+       duration <= 0)) {
+    LOG(WARNING) << "Invalid performance trace duration, using "
+                 << kDefaultDurationInSeconds << " seconds.";
+    duration = kDefaultDurationInSeconds;
+  }
+
+  return make_scoped_ptr(new RuntimeTraceRecorder(
+      command_line.GetSwitchValuePath(switches::kXWalkPerfTrace),
+      categories,
+      base::TimeDelta::FromSeconds(duration)));
+}
+
+RuntimeTraceRecorder::RuntimeTraceRecorder(const base::FilePath& trace_path,
+                                           const std::string& categories,
+                                           base::TimeDelta duration)
+    : trace_path_(trace_path),
+      categories_(categories),
+      duration_(duration),
+      recording_(false),
+      weak_factory_(this) {
+}
+
+RuntimeTraceRecorder::~RuntimeTraceRecorder() {
+  // The trace is written asynchronously, it may not complete if the runtime
+  // is shutting down.
+  StopAndWrite();
+}
+
+void RuntimeTraceRecorder::Start() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (recording_ || trace_path_.empty())
+    return;
+  if (!TracingController::GetInstance()->EnableRecording(
+          categories_, TracingController::DEFAULT_OPTIONS,
+          TracingController::EnableRecordingDoneCallback())) {
+    LOG(WARNING) << "Failed to start recording the performance trace.";
+    return;
+  }
+  recording_ = true;
+  BrowserThread::PostDelayedTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&RuntimeTraceRecorder::StopAndWrite,
+                 weak_factory_.GetWeakPtr()),
+      duration_);
+}
+
+void RuntimeTraceRecorder::StopAndWrite() {
+  if (!recording_)
+    return;
+  recording_ = false;
+  if (!TracingController::GetInstance()->DisableRecording(
+          trace_path_, base::Bind(&OnTraceWritten))) {
+    LOG(WARNING) << "Failed to write the performance trace to "
+                 << trace_path_.AsUTF8Unsafe();
+  }
+}
+
+}  // namespace xwalk
@@ -0,0 +1,55 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_BROWSER_RUNTIME_TRACE_RECORDER_H_
+#define XWALK_RUNTIME_BROWSER_RUNTIME_TRACE_RECORDER_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+
+class CommandLine;
+
+namespace xwalk {
+
+// Records a performance trace of the runtime into a file, driven by
+// --xwalk-perf-trace, without the remote debugging server. No devtools
+// client is attached, so no screencast, DOM or page agent runs while the
+// trace is taken, which keeps the measurements close to production. The
+// file is in the trace event JSON format read by about:tracing.
+class RuntimeTraceRecorder {
+ public:
+  // Returns NULL if --xwalk-perf-trace is not on |command_line|.
+  static scoped_ptr<RuntimeTraceRecorder> CreateFromCommandLine(
+      const CommandLine& command_line);
+
+  RuntimeTraceRecorder(const base::FilePath& trace_path,
+                       const std::string& categories,
+                       base::TimeDelta duration);
+  ~RuntimeTraceRecorder();
+
+  // Starts recording, the trace is written after |duration|, or when the
+  // recorder is destroyed if it is shorter.
+  void Start();
+
+ private:
+  void StopAndWrite();
+
+  base::FilePath trace_path_;
+  std::string categories_;
+  base::TimeDelta duration_;
+  bool recording_;
+
+  base::WeakPtrFactory<RuntimeTraceRecorder> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuntimeTraceRecorder);
+};
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_BROWSER_RUNTIME_TRACE_RECORDER_H_
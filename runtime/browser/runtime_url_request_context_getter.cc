@@ -8,14 +8,15 @@
 #include <algorithm>
 #include <vector>
 
+#include "base/command_line.h"
 #include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/worker_pool.h"
+#include "content/browser/net/sqlite_persistent_cookie_store.h"
 #include "content/public/browser/browser_thread.h"
-#include "content/public/browser/cookie_store_factory.h"
 #include "content/public/common/content_switches.h"
 #include "content/public/common/url_constants.h"
 #include "net/cert/cert_verifier.h"
@@ -27,6 +28,8 @@
 #include "net/http/http_network_session.h"
 #include "net/http/http_server_properties_impl.h"
 #include "net/proxy/proxy_service.h"
+#include "net/socket/client_socket_pool_manager.h"
+#include "net/socket/next_proto.h"
 #include "net/ssl/default_server_bound_cert_store.h"
 #include "net/ssl/server_bound_cert_service.h"
 #include "net/ssl/ssl_config_service_defaults.h"
@@ -39,7 +42,12 @@
 #include "net/url_request/url_request_interceptor.h"
 #include "net/url_request/url_request_job_factory_impl.h"
 #include "xwalk/application/common/constants.h"
+#include "xwalk/runtime/browser/runtime_cache_warmer.h"
+#include "xwalk/runtime/browser/runtime_http_server_properties_store.h"
 #include "xwalk/runtime/browser/runtime_network_delegate.h"
+#include "xwalk/runtime/browser/runtime_network_predictor.h"
+#include "xwalk/runtime/browser/runtime_persistent_cookie_store.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
 
 #if defined(OS_ANDROID)
 #include "xwalk/runtime/browser/android/cookie_manager.h"
@@ -53,17 +61,173 @@ using content::BrowserThread;
 
 namespace xwalk {
 
+namespace {
+
+const char kBlockfileCacheBackend[] = "blockfile";
+const char kSimpleCacheBackend[] = "simple";
+const char kMemoryCacheBackend[] = "memory";
+
+const base::FilePath::CharType kHttpServerPropertiesFilename[] =
+    FILE_PATH_LITERAL("Network Properties");
+
+// Upper bounds of the socket pool limits, as allowed by
+// ClientSocketPoolManager.
+const int kMaxSocketsPerGroupLimit = 99;
+const int kMaxSocketsPerPoolLimit = 256;
+
+// Upper bounds of the cookie commit policy.
+const int kMaxCookieCommitIntervalSeconds = 3600;
+const int kMaxCookieCommitBatchSize = 4096;
+
+// Reads an integer switch in [|min|, |max|], leaving |value| untouched if the
+// switch isn't given or is invalid.
+void GetIntSwitch(const CommandLine& command_line,
+                  const char* name,
+                  int min,
+                  int max,
+                  int* value) {
+  if (!command_line.HasSwitch(name))
+    return;
+  const std::string string_value = command_line.GetSwitchValueASCII(name);
+  int result;
+  if (!base::StringToInt(string_value, &result) || result < min) {
+    LOG(WARNING) << "Invalid --" << name << " value: " << string_value;
+    return;
+  }
+  *value = std::min(result, max);
+}
+
+// SPDY/HTTP2, QUIC and socket pool limits from the command line.
+void ConfigureNetworkSession(net::HttpNetworkSession::Params* params) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  const bool spdy_enabled = !command_line.HasSwitch(switches::kDisableHttp2);
+  const bool quic_enabled = command_line.HasSwitch(switches::kEnableQuic);
+  params->next_protos =
+      net::NextProtosWithSpdyAndQuic(spdy_enabled, quic_enabled);
+  params->use_alternate_protocols = spdy_enabled || quic_enabled;
+  params->enable_quic = quic_enabled;
+
+  if (!command_line.HasSwitch(switches::kMaxSocketsPerGroup) &&
+      !command_line.HasSwitch(switches::kMaxSocketsPerPool))
+    return;
+
+  const net::HttpNetworkSession::SocketPoolType pool_type =
+      net::HttpNetworkSession::NORMAL_SOCKET_POOL;
+  const int current_per_group =
+      net::ClientSocketPoolManager::max_sockets_per_group(pool_type);
+  int per_pool = net::ClientSocketPoolManager::max_sockets_per_pool(pool_type);
+  GetIntSwitch(command_line, switches::kMaxSocketsPerPool,
+               1, kMaxSocketsPerPoolLimit, &per_pool);
+  int per_group = current_per_group;
+  GetIntSwitch(command_line, switches::kMaxSocketsPerGroup,
+               1, kMaxSocketsPerGroupLimit, &per_group);
+  per_group = std::min(per_group, per_pool);
+
+  // The pool limit can't go below the group one, set them in an order
+  // keeping that true.
+  if (per_pool >= current_per_group) {
+    net::ClientSocketPoolManager::set_max_sockets_per_pool(pool_type, per_pool);
+    net::ClientSocketPoolManager::set_max_sockets_per_group(
+        pool_type, per_group);
+  } else {
+    net::ClientSocketPoolManager::set_max_sockets_per_group(
+        pool_type, per_group);
+    net::ClientSocketPoolManager::set_max_sockets_per_pool(pool_type, per_pool);
+  }
+}
+
+// The HTTP cache configured with --disk-cache-size and --http-cache-backend.
+net::HttpCache::DefaultBackend* CreateMainBackend(
+    const base::FilePath& cache_path) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+
+  // 0 lets the backend size itself from the free disk space.
+  int max_size = 0;
+  if (command_line.HasSwitch(switches::kDiskCacheSize)) {
+    const std::string value =
+        command_line.GetSwitchValueASCII(switches::kDiskCacheSize);
+    if (!base::StringToInt(value, &max_size) || max_size < 0) {
+      LOG(WARNING) << "Invalid --" << switches::kDiskCacheSize << " value: "
+                   << value;
+      max_size = 0;
+    }
+  }
+
+  const std::string backend =
+      command_line.GetSwitchValueASCII(switches::kHttpCacheBackend);
+  if (backend == kMemoryCacheBackend)
+    return net::HttpCache::DefaultBackend::InMemory(max_size);
+
+  net::BackendType backend_type = net::CACHE_BACKEND_DEFAULT;
+  if (backend == kSimpleCacheBackend) {
+    backend_type = net::CACHE_BACKEND_SIMPLE;
+  } else if (backend == kBlockfileCacheBackend) {
+    backend_type = net::CACHE_BACKEND_BLOCKFILE;
+  } else if (!backend.empty()) {
+    LOG(WARNING) << "Unknown --" << switches::kHttpCacheBackend << " value: "
+                 << backend;
+  }
+  return new net::HttpCache::DefaultBackend(
+      net::DISK_CACHE,
+      backend_type,
+      cache_path,
+      max_size,
+      BrowserThread::GetMessageLoopProxyForThread(BrowserThread::CACHE));
+}
+
+#if !defined(OS_ANDROID)
+// What content::CreateCookieStore() does for PERSISTANT_SESSION_COOKIES, with
+// the writes to the database batched by a RuntimePersistentCookieStore as
+// set with --cookie-commit-interval and --cookie-commit-batch-size.
+net::CookieMonster* CreatePersistentCookieMonster(const base::FilePath& path) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  int commit_interval =
+      RuntimePersistentCookieStore::kDefaultCommitIntervalSeconds;
+  GetIntSwitch(command_line, switches::kCookieCommitInterval,
+               0, kMaxCookieCommitIntervalSeconds, &commit_interval);
+  int batch_size = RuntimePersistentCookieStore::kDefaultMaxPendingOperations;
+  GetIntSwitch(command_line, switches::kCookieCommitBatchSize,
+               1, kMaxCookieCommitBatchSize, &batch_size);
+
+  base::SequencedWorkerPool* blocking_pool = BrowserThread::GetBlockingPool();
+  scoped_refptr<content::SQLitePersistentCookieStore> database(
+      new content::SQLitePersistentCookieStore(
+          path,
+          BrowserThread::GetMessageLoopProxyForThread(BrowserThread::IO),
+          blocking_pool->GetSequencedTaskRunnerWithShutdownBehavior(
+              blocking_pool->GetSequenceToken(),
+              base::SequencedWorkerPool::BLOCK_SHUTDOWN),
+          false, /* restore_old_session_cookies */
+          NULL,
+          NULL));
+  net::CookieMonster* cookie_monster = new net::CookieMonster(
+      new RuntimePersistentCookieStore(
+          database.get(),
+          base::TimeDelta::FromSeconds(commit_interval),
+          batch_size),
+      NULL);
+  cookie_monster->SetPersistSessionCookies(true);
+  return cookie_monster;
+}
+#endif
+
+}  // namespace
+
 RuntimeURLRequestContextGetter::RuntimeURLRequestContextGetter(
     bool ignore_certificate_errors,
     const base::FilePath& base_path,
     base::MessageLoop* io_loop,
     base::MessageLoop* file_loop,
     content::ProtocolHandlerMap* protocol_handlers,
-    content::URLRequestInterceptorScopedVector request_interceptors)
+    content::URLRequestInterceptorScopedVector request_interceptors,
+    RuntimeNetworkPredictor* network_predictor,
+    RuntimeURLRequestContextGetter* shared_network_getter)
     : ignore_certificate_errors_(ignore_certificate_errors),
       base_path_(base_path),
       io_loop_(io_loop),
       file_loop_(file_loop),
+      network_predictor_(network_predictor),
+      shared_network_getter_(shared_network_getter),
       request_interceptors_(request_interceptors.Pass()) {
   // Must first be created on the UI thread.
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
@@ -73,9 +237,12 @@ RuntimeURLRequestContextGetter::RuntimeURLRequestContextGetter(
   // We must create the proxy config service on the UI loop on Linux because it
   // must synchronously run on the glib message loop. This will be passed to
   // the URLRequestContextStorage on the IO thread in GetURLRequestContext().
-  proxy_config_service_.reset(
-      net::ProxyService::CreateSystemProxyConfigService(
-          io_loop_->message_loop_proxy(), file_loop_));
+  // A context sharing the network stack of another uses its proxy service.
+  if (!shared_network_getter_) {
+    proxy_config_service_.reset(
+        net::ProxyService::CreateSystemProxyConfigService(
+            io_loop_->message_loop_proxy(), file_loop_));
+  }
 }
 
 RuntimeURLRequestContextGetter::~RuntimeURLRequestContextGetter() {
@@ -86,18 +253,21 @@ net::URLRequestContext* RuntimeURLRequestContextGetter::GetURLRequestContext() {
 
   if (!url_request_context_) {
     url_request_context_.reset(new net::URLRequestContext());
-    network_delegate_.reset(new RuntimeNetworkDelegate);
+    // The members set below override the ones of the shared context.
+    if (shared_network_getter_) {
+      url_request_context_->CopyFrom(
+          shared_network_getter_->GetURLRequestContext());
+    }
+    network_delegate_.reset(
+        new RuntimeNetworkDelegate(network_predictor_.get()));
     url_request_context_->set_network_delegate(network_delegate_.get());
     storage_.reset(
         new net::URLRequestContextStorage(url_request_context_.get()));
 #if defined(OS_ANDROID)
     storage_->set_cookie_store(xwalk::GetCookieMonster());
 #else
-    content::CookieStoreConfig cookie_config(base_path_.Append(
-        application::kCookieDatabaseFilename),
-        content::CookieStoreConfig::PERSISTANT_SESSION_COOKIES,
-        NULL, NULL);
-    net::CookieStore* cookie_store = content::CreateCookieStore(cookie_config);
+    net::CookieMonster* cookie_monster = CreatePersistentCookieMonster(
+        base_path_.Append(application::kCookieDatabaseFilename));
 
     std::vector<const char*> cookieable_schemes(
         net::CookieMonster::kDefaultCookieableSchemes,
@@ -106,70 +276,25 @@ net::URLRequestContext* RuntimeURLRequestContextGetter::GetURLRequestContext() {
     cookieable_schemes.push_back(application::kApplicationScheme);
     cookieable_schemes.push_back(content::kChromeDevToolsScheme);
 
-    cookie_store->GetCookieMonster()->SetCookieableSchemes(
+    cookie_monster->SetCookieableSchemes(
         &cookieable_schemes[0], cookieable_schemes.size());
-    storage_->set_cookie_store(cookie_store);
+    storage_->set_cookie_store(cookie_monster);
 #endif
-    storage_->set_server_bound_cert_service(new net::ServerBoundCertService(
-        new net::DefaultServerBoundCertStore(NULL),
-        base::WorkerPool::GetTaskRunner(true)));
     storage_->set_http_user_agent_settings(
         new net::StaticHttpUserAgentSettings("en-us,en", base::EmptyString()));
-
-    scoped_ptr<net::HostResolver> host_resolver(
-        net::HostResolver::CreateDefaultResolver(NULL));
-
-    storage_->set_cert_verifier(net::CertVerifier::CreateDefault());
-    storage_->set_transport_security_state(new net::TransportSecurityState);
-    storage_->set_proxy_service(
-        net::ProxyService::CreateUsingSystemProxyResolver(
-        proxy_config_service_.release(),
-        0,
-        NULL));
-    storage_->set_ssl_config_service(new net::SSLConfigServiceDefaults);
-    storage_->set_http_auth_handler_factory(
-        net::HttpAuthHandlerFactory::CreateDefault(host_resolver.get()));
-    storage_->set_http_server_properties(scoped_ptr<net::HttpServerProperties>(
-        new net::HttpServerPropertiesImpl));
-
     base::FilePath cache_path = base_path_.Append(FILE_PATH_LITERAL("Cache"));
     net::HttpCache::DefaultBackend* main_backend =
-        new net::HttpCache::DefaultBackend(
-            net::DISK_CACHE,
-            net::CACHE_BACKEND_DEFAULT,
-            cache_path,
-            0,
-            BrowserThread::GetMessageLoopProxyForThread(
-                BrowserThread::CACHE));
-
-    net::HttpNetworkSession::Params network_session_params;
-    network_session_params.cert_verifier =
-        url_request_context_->cert_verifier();
-    network_session_params.transport_security_state =
-        url_request_context_->transport_security_state();
-    network_session_params.server_bound_cert_service =
-        url_request_context_->server_bound_cert_service();
-    network_session_params.proxy_service =
-        url_request_context_->proxy_service();
-    network_session_params.ssl_config_service =
-        url_request_context_->ssl_config_service();
-    network_session_params.http_auth_handler_factory =
-        url_request_context_->http_auth_handler_factory();
-    network_session_params.network_delegate =
-        network_delegate_.get();
-    network_session_params.http_server_properties =
-        url_request_context_->http_server_properties();
-    network_session_params.ignore_certificate_errors =
-        ignore_certificate_errors_;
-
-    // Give |storage_| ownership at the end in case it's |mapped_host_resolver|.
-    storage_->set_host_resolver(host_resolver.Pass());
-    network_session_params.host_resolver =
-        url_request_context_->host_resolver();
-
-    net::HttpCache* main_cache = new net::HttpCache(
-        network_session_params, main_backend);
-    storage_->set_http_transaction_factory(main_cache);
+        CreateMainBackend(cache_path);
+
+    if (shared_network_getter_) {
+      net::HttpNetworkSession* network_session =
+          shared_network_getter_->GetURLRequestContext()->
+              http_transaction_factory()->GetSession();
+      storage_->set_http_transaction_factory(
+          new net::HttpCache(network_session, main_backend));
+    } else {
+      InitNetworkSession(main_backend);
+    }
 
 #if defined(OS_ANDROID)
     scoped_ptr<XWalkURLRequestJobFactory> job_factory_impl(
@@ -256,11 +381,81 @@ net::URLRequestContext* RuntimeURLRequestContextGetter::GetURLRequestContext() {
     request_interceptors_.weak_clear();
 
     storage_->set_job_factory(top_job_factory.release());
+
+    const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+    if (command_line.HasSwitch(switches::kWarmCacheUrls)) {
+      RuntimeCacheWarmer::Start(this, RuntimeCacheWarmer::ParseURLs(
+          command_line.GetSwitchValueASCII(switches::kWarmCacheUrls)),
+          1, RuntimeCacheWarmer::CompletionCallback());
+    }
   }
 
   return url_request_context_.get();
 }
 
+void RuntimeURLRequestContextGetter::InitNetworkSession(
+    net::HttpCache::DefaultBackend* main_backend) {
+  storage_->set_server_bound_cert_service(new net::ServerBoundCertService(
+      new net::DefaultServerBoundCertStore(NULL),
+      base::WorkerPool::GetTaskRunner(true)));
+
+  scoped_ptr<net::HostResolver> host_resolver(
+      net::HostResolver::CreateDefaultResolver(NULL));
+
+  storage_->set_cert_verifier(net::CertVerifier::CreateDefault());
+  storage_->set_transport_security_state(new net::TransportSecurityState);
+  storage_->set_proxy_service(
+      net::ProxyService::CreateUsingSystemProxyResolver(
+      proxy_config_service_.release(),
+      0,
+      NULL));
+  storage_->set_ssl_config_service(new net::SSLConfigServiceDefaults);
+  storage_->set_http_auth_handler_factory(
+      net::HttpAuthHandlerFactory::CreateDefault(host_resolver.get()));
+  net::HttpServerPropertiesImpl* http_server_properties =
+      new net::HttpServerPropertiesImpl;
+  storage_->set_http_server_properties(
+      scoped_ptr<net::HttpServerProperties>(http_server_properties));
+  base::SequencedWorkerPool* blocking_pool = BrowserThread::GetBlockingPool();
+  http_server_properties_store_.reset(new RuntimeHttpServerPropertiesStore(
+      base_path_.Append(kHttpServerPropertiesFilename),
+      http_server_properties,
+      blocking_pool->GetSequencedTaskRunnerWithShutdownBehavior(
+          blocking_pool->GetSequenceToken(),
+          base::SequencedWorkerPool::BLOCK_SHUTDOWN)));
+  http_server_properties_store_->Load();
+
+  net::HttpNetworkSession::Params network_session_params;
+  network_session_params.cert_verifier =
+      url_request_context_->cert_verifier();
+  network_session_params.transport_security_state =
+      url_request_context_->transport_security_state();
+  network_session_params.server_bound_cert_service =
+      url_request_context_->server_bound_cert_service();
+  network_session_params.proxy_service =
+      url_request_context_->proxy_service();
+  network_session_params.ssl_config_service =
+      url_request_context_->ssl_config_service();
+  network_session_params.http_auth_handler_factory =
+      url_request_context_->http_auth_handler_factory();
+  network_session_params.network_delegate =
+      network_delegate_.get();
+  network_session_params.http_server_properties =
+      url_request_context_->http_server_properties();
+  network_session_params.ignore_certificate_errors =
+      ignore_certificate_errors_;
+  ConfigureNetworkSession(&network_session_params);
+
+  // Give |storage_| ownership at the end in case it's |mapped_host_resolver|.
+  storage_->set_host_resolver(host_resolver.Pass());
+  network_session_params.host_resolver =
+      url_request_context_->host_resolver();
+
+  net::HttpCache* main_cache = new net::HttpCache(
+      network_session_params, main_backend);
+  storage_->set_http_transaction_factory(main_cache);
+}
+
 scoped_refptr<base::SingleThreadTaskRunner>
     RuntimeURLRequestContextGetter::GetNetworkTaskRunner() const {
   return BrowserThread::GetMessageLoopProxyForThread(BrowserThread::IO);
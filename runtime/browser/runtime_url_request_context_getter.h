@@ -10,6 +10,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "content/public/browser/content_browser_client.h"
+#include "net/http/http_cache.h"
 #include "net/url_request/url_request_context_getter.h"
 #include "net/url_request/url_request_job_factory.h"
 
@@ -28,15 +29,26 @@ class URLRequestJobFactory;
 
 namespace xwalk {
 
+class RuntimeHttpServerPropertiesStore;
+class RuntimeNetworkPredictor;
+
 class RuntimeURLRequestContextGetter : public net::URLRequestContextGetter {
  public:
+  // If |shared_network_getter| is given, the context keeps its own cookies,
+  // HTTP cache and protocol handlers, but uses the host resolver, proxy,
+  // certificate verifier and HttpNetworkSession of that context. The
+  // requests to the same servers then reuse the same sockets, SPDY sessions
+  // and TLS sessions. The HTTP auth cache and the server bound certificates
+  // are shared too.
   RuntimeURLRequestContextGetter(
       bool ignore_certificate_errors,
       const base::FilePath& base_path,
       base::MessageLoop* io_loop,
       base::MessageLoop* file_loop,
       content::ProtocolHandlerMap* protocol_handlers,
-      content::URLRequestInterceptorScopedVector request_interceptors);
+      content::URLRequestInterceptorScopedVector request_interceptors,
+      RuntimeNetworkPredictor* network_predictor,
+      RuntimeURLRequestContextGetter* shared_network_getter);
 
   // net::URLRequestContextGetter implementation.
   virtual net::URLRequestContext* GetURLRequestContext() OVERRIDE;
@@ -48,14 +60,22 @@ class RuntimeURLRequestContextGetter : public net::URLRequestContextGetter {
  private:
   virtual ~RuntimeURLRequestContextGetter();
 
+  // Creates the network stack of the context, when it doesn't share the one
+  // of |shared_network_getter_|.
+  void InitNetworkSession(net::HttpCache::DefaultBackend* main_backend);
+
   bool ignore_certificate_errors_;
   base::FilePath base_path_;
   base::MessageLoop* io_loop_;
   base::MessageLoop* file_loop_;
+  scoped_refptr<RuntimeNetworkPredictor> network_predictor_;
+  scoped_refptr<RuntimeURLRequestContextGetter> shared_network_getter_;
 
   scoped_ptr<net::ProxyConfigService> proxy_config_service_;
   scoped_ptr<net::NetworkDelegate> network_delegate_;
   scoped_ptr<net::URLRequestContextStorage> storage_;
+  // Saves the HttpServerProperties owned by |storage_|.
+  scoped_ptr<RuntimeHttpServerPropertiesStore> http_server_properties_store_;
   scoped_ptr<net::URLRequestContext> url_request_context_;
   content::ProtocolHandlerMap protocol_handlers_;
   content::URLRequestInterceptorScopedVector request_interceptors_;
@@ -7,12 +7,14 @@
 #include <string>
 
 #include "base/bind.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/utf_string_conversions.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/notification_types.h"
 #include "content/public/browser/render_process_host.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/speech_recognition_manager.h"
+#include "content/public/common/speech_recognition_result.h"
 
 using content::BrowserThread;
 using content::SpeechRecognitionManager;
@@ -58,18 +60,39 @@ void XWalkSpeechRecognitionManagerDelegate::CheckRecognitionIsAllowed(
     render_view_id = context.embedder_render_view_id;
   }
 
+  const std::pair<int, int> render_view(render_process_id, render_view_id);
+  if (allowed_render_views_.count(render_view)) {
+    callback.Run(false, true);
+    return;
+  }
+
   // Check that the render view type is appropriate, and whether or not we
   // need to request permission from the user.
+  // The recognition manager owns the delegate and outlives the sessions.
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-                          base::Bind(&CheckRenderViewType,
-                                     callback,
-                                     render_process_id,
-                                     render_view_id));
+      base::Bind(&CheckRenderViewType,
+                 base::Bind(
+                     &XWalkSpeechRecognitionManagerDelegate::
+                         OnRecognitionAllowed,
+                     base::Unretained(this), callback, render_view),
+                 render_process_id,
+                 render_view_id));
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnRecognitionAllowed(
+    base::Callback<void(bool ask_user, bool is_allowed)> callback,
+    const std::pair<int, int>& render_view,
+    bool ask_user,
+    bool is_allowed) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (is_allowed && !ask_user)
+    allowed_render_views_.insert(render_view);
+  callback.Run(ask_user, is_allowed);
 }
 
 content::SpeechRecognitionEventListener*
 XWalkSpeechRecognitionManagerDelegate::GetEventListener() {
-  return NULL;
+  return this;
 }
 
 bool XWalkSpeechRecognitionManagerDelegate::FilterProfanities(
@@ -79,6 +102,65 @@ bool XWalkSpeechRecognitionManagerDelegate::FilterProfanities(
   return rph == NULL;
 }
 
+void XWalkSpeechRecognitionManagerDelegate::OnRecognitionStart(
+    int session_id) {
+  session_times_[session_id].recognition_start = base::TimeTicks::Now();
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnAudioStart(int session_id) {
+  SessionTimesMap::iterator it = session_times_.find(session_id);
+  if (it == session_times_.end())
+    return;
+  // The cost of opening the audio input for each session.
+  UMA_HISTOGRAM_TIMES("XWalk.Speech.RecognitionStartToAudioStart",
+                      base::TimeTicks::Now() - it->second.recognition_start);
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnEnvironmentEstimationComplete(
+    int session_id) {
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnSoundStart(int session_id) {
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnSoundEnd(int session_id) {
+  SessionTimesMap::iterator it = session_times_.find(session_id);
+  if (it != session_times_.end())
+    it->second.sound_end = base::TimeTicks::Now();
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnAudioEnd(int session_id) {
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnRecognitionEnd(int session_id) {
+  session_times_.erase(session_id);
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnRecognitionResults(
+    int session_id, const content::SpeechRecognitionResults& results) {
+  SessionTimesMap::iterator it = session_times_.find(session_id);
+  if (it == session_times_.end() || it->second.sound_end.is_null())
+    return;
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (results[i].is_provisional)
+      continue;
+    UMA_HISTOGRAM_TIMES("XWalk.Speech.SoundEndToFinalResult",
+                        base::TimeTicks::Now() - it->second.sound_end);
+    // Only the first final result after the end of speech is measured.
+    it->second.sound_end = base::TimeTicks();
+    return;
+  }
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnRecognitionError(
+    int session_id, const content::SpeechRecognitionError& error) {
+}
+
+void XWalkSpeechRecognitionManagerDelegate::OnAudioLevelsChange(
+    int session_id, float volume, float noise_volume) {
+}
+
 // static.
 void XWalkSpeechRecognitionManagerDelegate::CheckRenderViewType(
     base::Callback<void(bool ask_user, bool is_allowed)> callback,
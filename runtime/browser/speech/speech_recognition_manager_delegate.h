@@ -5,8 +5,12 @@
 #ifndef XWALK_RUNTIME_BROWSER_SPEECH_SPEECH_RECOGNITION_MANAGER_DELEGATE_H_
 #define XWALK_RUNTIME_BROWSER_SPEECH_SPEECH_RECOGNITION_MANAGER_DELEGATE_H_
 
+#include <map>
+#include <set>
 #include <string>
+#include <utility>
 
+#include "base/time/time.h"
 #include "content/public/browser/speech_recognition_event_listener.h"
 #include "content/public/browser/speech_recognition_manager_delegate.h"
 #include "content/public/browser/speech_recognition_session_config.h"
@@ -15,8 +19,13 @@ namespace xwalk {
 
 // This is CrossWalk's implementation of the SpeechRecognitionManagerDelegate
 // interface.
+//
+// It also listens to the events of all the sessions to record how long
+// recognition takes, from the start of the session to the capture of audio
+// and from the end of speech to the final result.
 class XWalkSpeechRecognitionManagerDelegate
-    : public content::SpeechRecognitionManagerDelegate {
+    : public content::SpeechRecognitionManagerDelegate,
+      public content::SpeechRecognitionEventListener {
  public:
   XWalkSpeechRecognitionManagerDelegate();
   virtual ~XWalkSpeechRecognitionManagerDelegate();
@@ -31,7 +40,36 @@ class XWalkSpeechRecognitionManagerDelegate
   virtual content::SpeechRecognitionEventListener* GetEventListener() OVERRIDE;
   virtual bool FilterProfanities(int render_process_id) OVERRIDE;
 
+  // SpeechRecognitionEventListener methods.
+  virtual void OnRecognitionStart(int session_id) OVERRIDE;
+  virtual void OnAudioStart(int session_id) OVERRIDE;
+  virtual void OnEnvironmentEstimationComplete(int session_id) OVERRIDE;
+  virtual void OnSoundStart(int session_id) OVERRIDE;
+  virtual void OnSoundEnd(int session_id) OVERRIDE;
+  virtual void OnAudioEnd(int session_id) OVERRIDE;
+  virtual void OnRecognitionEnd(int session_id) OVERRIDE;
+  virtual void OnRecognitionResults(
+      int session_id,
+      const content::SpeechRecognitionResults& results) OVERRIDE;
+  virtual void OnRecognitionError(
+      int session_id,
+      const content::SpeechRecognitionError& error) OVERRIDE;
+  virtual void OnAudioLevelsChange(int session_id,
+                                   float volume,
+                                   float noise_volume) OVERRIDE;
+
  private:
+  struct SessionTimes {
+    base::TimeTicks recognition_start;
+    base::TimeTicks sound_end;
+  };
+
+  void OnRecognitionAllowed(
+      base::Callback<void(bool ask_user, bool is_allowed)> callback,
+      const std::pair<int, int>& render_view,
+      bool ask_user,
+      bool is_allowed);
+
   // Checks for VIEW_TYPE_TAB_CONTENTS host in the UI thread and notifies back
   // the result in the IO thread through |callback|.
   static void CheckRenderViewType(
@@ -39,6 +77,14 @@ class XWalkSpeechRecognitionManagerDelegate
       int render_process_id,
       int render_view_id);
 
+  // The render views already allowed to recognize speech. Views aren't
+  // reused once gone, so pages starting recognition again and again skip
+  // the check on the UI thread. Only used on the IO thread.
+  std::set<std::pair<int, int> > allowed_render_views_;
+
+  typedef std::map<int, SessionTimes> SessionTimesMap;
+  SessionTimesMap session_times_;
+
   DISALLOW_COPY_AND_ASSIGN(XWalkSpeechRecognitionManagerDelegate);
 };
 
@@ -4,24 +4,37 @@
 
 #include "xwalk/runtime/browser/storage_component.h"
 
+#include "base/threading/sequenced_worker_pool.h"
 #include "xwalk/runtime/common/xwalk_runtime_features.h"
 
 namespace xwalk {
 
+namespace {
+
+// An application holds at most one thread at a time, so two applications
+// doing bulk I/O at once still leave a thread to the others.
+const size_t kFilePoolThreads = 3;
+
+}  // namespace
+
 StorageComponent::StorageComponent()
-    : native_file_system_extension_(0) {
+    : native_file_system_extension_(0),
+      file_pool_(new base::SequencedWorkerPool(kFilePoolThreads,
+                                               "XWalkNativeFileSystem")) {
 }
 
 StorageComponent::~StorageComponent() {
   if (native_file_system_extension_) {
     delete native_file_system_extension_;
   }
+  file_pool_->Shutdown();
 }
 
 void StorageComponent::CreateExtensionThreadExtensions(
     content::RenderProcessHost* host,
     extensions::XWalkExtensionVector* extensions) {
-  extensions->push_back(new experimental::NativeFileSystemExtension(host));
+  extensions->push_back(
+      new experimental::NativeFileSystemExtension(host, file_pool_.get()));
 }
 
 }  // namespace xwalk
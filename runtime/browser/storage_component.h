@@ -5,9 +5,14 @@
 #ifndef XWALK_RUNTIME_BROWSER_STORAGE_COMPONENT_H_
 #define XWALK_RUNTIME_BROWSER_STORAGE_COMPONENT_H_
 
+#include "base/memory/ref_counted.h"
 #include "xwalk/runtime/browser/xwalk_component.h"
 #include "xwalk/experimental/native_file_system/native_file_system_extension.h"
 
+namespace base {
+class SequencedWorkerPool;
+}
+
 namespace xwalk {
 
 class StorageComponent : public XWalkComponent {
@@ -22,6 +27,10 @@ class StorageComponent : public XWalkComponent {
       extensions::XWalkExtensionVector* extensions) OVERRIDE;
 
   experimental::NativeFileSystemExtension* native_file_system_extension_;
+
+  // Runs the file requests of the native file system of all the
+  // applications, each one in its own sequence.
+  scoped_refptr<base::SequencedWorkerPool> file_pool_;
 };
 
 }  // namespace xwalk
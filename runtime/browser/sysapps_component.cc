@@ -4,15 +4,27 @@
 
 #include "xwalk/runtime/browser/sysapps_component.h"
 
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/storage_partition.h"
 #include "xwalk/runtime/common/xwalk_runtime_features.h"
 
 namespace xwalk {
 
+namespace {
+
+const base::FilePath::CharType kDownloadDirectory[] =
+    FILE_PATH_LITERAL("Downloader");
+
+}  // namespace
+
 SysAppsComponent::SysAppsComponent() {
   if (!XWalkRuntimeFeatures::isDeviceCapabilitiesAPIEnabled())
     manager_.DisableDeviceCapabilities();
   if (!XWalkRuntimeFeatures::isRawSocketsAPIEnabled())
     manager_.DisableRawSockets();
+  if (!XWalkRuntimeFeatures::isDownloaderAPIEnabled())
+    manager_.DisableDownloader();
 }
 
 SysAppsComponent::~SysAppsComponent() {}
@@ -26,7 +38,12 @@ void SysAppsComponent::CreateUIThreadExtensions(
 void SysAppsComponent::CreateExtensionThreadExtensions(
     content::RenderProcessHost* host,
     extensions::XWalkExtensionVector* extensions) {
-  manager_.CreateExtensionsForExtensionThread(extensions);
+  // The storage partition of an application is private to it.
+  manager_.CreateExtensionsForExtensionThread(
+      host->GetBrowserContext()->GetRequestContextForRenderProcess(
+          host->GetID()),
+      host->GetStoragePartition()->GetPath().Append(kDownloadDirectory),
+      extensions);
 }
 
 }  // namespace xwalk
@@ -9,6 +9,10 @@
 
 #include "base/logging.h"
 #include "content/public/browser/browser_thread.h"
+#include "xwalk/application/browser/application_service.h"
+#include "xwalk/application/browser/application_system.h"
+#include "xwalk/application/browser/application_tizen.h"
+#include "xwalk/runtime/browser/xwalk_runner.h"
 
 namespace xwalk {
 namespace {
@@ -95,6 +99,17 @@ void TizenLocaleListener::SetLocale(const std::string& locale) {
 
   LOG(INFO) << "Locale change from " << locale_ << " to " << locale;
   locale_ = locale;
+
+  // The running applications switch in place, reloading them all at once
+  // would be a storm of relaunches on a device running many of them.
+  application::ApplicationSystem* app_system =
+      XWalkRunner::GetInstance()->app_system();
+  if (!app_system)
+    return;
+  const ScopedVector<application::Application>& apps =
+      app_system->application_service()->active_applications();
+  for (size_t i = 0; i < apps.size(); ++i)
+    application::ToApplicationTizen(apps[i])->SetLocale(locale);
 }
 
 }  // namespace xwalk
@@ -12,10 +12,8 @@
 
 namespace xwalk {
 
-// FIXME: Do we need to watch system locale change
-// now (we do not keep the cache of the installed
-// apps anymore)? This class should probably be
-// removed.
+// Watches the system locale and makes the running applications follow its
+// changes, see ApplicationTizen::SetLocale().
 class TizenLocaleListener : public base::SimpleThread {
  public:
   TizenLocaleListener();
@@ -26,7 +24,7 @@ class TizenLocaleListener : public base::SimpleThread {
   // Get the latest application locale from system.
   // locale is a langtag defined in [BCP47]
   std::string GetLocale() const;
-  // Set the locale and apply this locale to all applications.
+  // Set the locale and apply this locale to all running applications.
   // Locale is a langtag defined in [BCP47].
   // This function will called by TizenLocaleListener when locale is changed.
   void SetLocale(const std::string& locale);
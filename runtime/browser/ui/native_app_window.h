@@ -66,6 +66,16 @@ class NativeAppWindow {
   // Initialize the platform-specific native app window.
   static NativeAppWindow* Create(const CreateParams& params);
 
+  // Creates a hidden window, handed out by the next Create() with the same
+  // default parameters instead of creating a new one. Windows without a
+  // parent, splash screen or size limits only, e.g. those of window.open().
+  // Their delegate and web contents are ignored. Closing such a window
+  // keeps it as the spare one if there is none. Only the Views windows are
+  // pooled, the others are cheap to create.
+  static void PrepareSpareWindow(const CreateParams& params);
+  // Destroys the spare window, at shutdown.
+  static void DestroySpareWindow();
+
   // Return a platform dependent identifier for this window.
   virtual gfx::NativeWindow GetNativeWindow() const = 0;
   // Returns true if the window has no frame.
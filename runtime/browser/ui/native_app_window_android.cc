@@ -12,4 +12,12 @@ void NativeAppWindow::Initialize() {
   NOTIMPLEMENTED();
 }
 
+// static
+void NativeAppWindow::PrepareSpareWindow(const CreateParams& params) {
+}
+
+// static
+void NativeAppWindow::DestroySpareWindow() {
+}
+
 }  // namespace xwalk
@@ -181,4 +181,12 @@ NativeAppWindow* NativeAppWindow::Create(
 void NativeAppWindow::Initialize() {
 }
 
+// static
+void NativeAppWindow::PrepareSpareWindow(const CreateParams& params) {
+}
+
+// static
+void NativeAppWindow::DestroySpareWindow() {
+}
+
 }  // namespace xwalk
@@ -4,9 +4,15 @@
 
 #include "xwalk/runtime/browser/ui/native_app_window_tizen.h"
 
+#include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "ui/aura/window.h"
+#include "ui/compositor/compositor.h"
+#include "ui/compositor/layer.h"
+#include "ui/compositor/layer_animator.h"
+#include "ui/compositor/scoped_layer_animation_settings.h"
+#include "ui/gfx/animation/tween.h"
 #include "ui/gfx/transform.h"
 #include "ui/gfx/rect.h"
 #include "ui/gfx/screen.h"
@@ -18,6 +24,8 @@
 
 namespace {
 
+const int kRotationAnimationMs = 250;
+
 static gfx::Display::Rotation ToDisplayRotation(gfx::Display display,
     blink::WebScreenOrientationType orientation) {
   gfx::Display::Rotation rot = gfx::Display::ROTATE_0;
@@ -58,6 +66,31 @@ static void SetWindowRotation(aura::Window* window, gfx::Display display) {
   indicator_widget_->SetDisplay(display);
 #endif
 
+  window->SetTransform(
+      xwalk::NativeAppWindowTizen::GetRotationTransform(display));
+  // The root window only follows the current transform of its layer, which
+  // is still the old one when the rotation is animated. The contents are
+  // given the bounds of the target transform right away instead.
+  window->SetBounds(xwalk::NativeAppWindowTizen::GetRotatedBounds(display));
+}
+
+}  // namespace.
+
+namespace xwalk {
+
+NativeAppWindowTizen::NativeAppWindowTizen(
+    const NativeAppWindow::CreateParams& create_params)
+    : NativeAppWindowViews(create_params),
+#if defined(OS_TIZEN_MOBILE)
+      indicator_widget_(new TizenSystemIndicatorWidget()),
+      indicator_container_(new WidgetContainerView(indicator_widget_)),
+#endif
+      orientation_lock_(blink::WebScreenOrientationLockAny),
+      rotation_compositor_(NULL) {}
+
+// static
+gfx::Transform NativeAppWindowTizen::GetRotationTransform(
+    const gfx::Display& display) {
   // As everything is calculated from the fixed position we do
   // not update the display bounds after rotation change.
   gfx::Transform rotate;
@@ -79,22 +112,17 @@ static void SetWindowRotation(aura::Window* window, gfx::Display display) {
       rotate.Rotate(180);
       break;
   }
-
-  window->SetTransform(rotate);
+  return rotate;
 }
 
-}  // namespace.
-
-namespace xwalk {
-
-NativeAppWindowTizen::NativeAppWindowTizen(
-    const NativeAppWindow::CreateParams& create_params)
-    : NativeAppWindowViews(create_params),
-#if defined(OS_TIZEN_MOBILE)
-      indicator_widget_(new TizenSystemIndicatorWidget()),
-      indicator_container_(new WidgetContainerView(indicator_widget_)),
-#endif
-      orientation_lock_(blink::WebScreenOrientationLockAny) {}
+// static
+gfx::Rect NativeAppWindowTizen::GetRotatedBounds(const gfx::Display& display) {
+  gfx::Size size = display.bounds().size();
+  if (display.rotation() == gfx::Display::ROTATE_90 ||
+      display.rotation() == gfx::Display::ROTATE_270)
+    size.SetSize(size.height(), size.width());
+  return gfx::Rect(size);
+}
 
 void NativeAppWindowTizen::Initialize() {
   NativeAppWindowViews::Initialize();
@@ -124,6 +152,7 @@ void NativeAppWindowTizen::Initialize() {
 NativeAppWindowTizen::~NativeAppWindowTizen() {
   if (SensorProvider::GetInstance())
     SensorProvider::GetInstance()->RemoveObserver(this);
+  StopObservingCompositor();
 }
 
 void NativeAppWindowTizen::LockOrientation(
@@ -164,13 +193,15 @@ void NativeAppWindowTizen::OnWindowDestroying(aura::Window* window) {
   // Must be removed here and not in the destructor, as the aura::Window is
   // already destroyed when our destructor runs.
   window->RemoveObserver(this);
+  StopObservingCompositor();
 }
 
 void NativeAppWindowTizen::OnWindowVisibilityChanging(
     aura::Window* window, bool visible) {
   if (!visible)
     return;
-  SetDisplayRotation(display_);
+  // Nothing was drawn at the old rotation.
+  SetDisplayRotation(display_, false);
 }
 
 blink::WebScreenOrientationType
@@ -225,15 +256,74 @@ void NativeAppWindowTizen::OnScreenOrientationChanged(
     return;
 
   display_.set_rotation(rot);
-  SetDisplayRotation(display_);
+  SetDisplayRotation(display_, true);
 }
 
-void NativeAppWindowTizen::SetDisplayRotation(gfx::Display display) {
+void NativeAppWindowTizen::SetDisplayRotation(gfx::Display display,
+                                              bool animate) {
   aura::Window* window = GetNativeWindow()->GetRootWindow();
   if (!window->IsVisible())
     return;
 
+  if (!animate) {
+    SetWindowRotation(window, display);
+    return;
+  }
+
+  // A rotation interrupting another one is traced as part of it.
+  StopObservingCompositor();
+  if (rotation_start_time_.is_null()) {
+    rotation_start_time_ = base::TimeTicks::Now();
+    TRACE_EVENT_ASYNC_BEGIN1("xwalk", "NativeAppWindowTizen::Rotate", this,
+                             "rotation", display.rotation());
+  }
+
+  // The transform is animated on the layer tree still showing the frame
+  // drawn at the old size, the contents get their new bounds right away and
+  // resize in the background. RenderWidgetHostViewAura holds the commits of
+  // the compositor until the renderer produced a frame at the new size.
+  ui::ScopedLayerAnimationSettings settings(window->layer()->GetAnimator());
+  settings.SetTransitionDuration(
+      base::TimeDelta::FromMilliseconds(kRotationAnimationMs));
+  settings.SetTweenType(gfx::Tween::EASE_OUT);
+  settings.SetPreemptionStrategy(
+      ui::LayerAnimator::IMMEDIATELY_ANIMATE_TO_NEW_TARGET);
+  settings.AddObserver(this);
   SetWindowRotation(window, display);
 }
 
+void NativeAppWindowTizen::OnImplicitAnimationsCompleted() {
+  // An aborted animation was replaced by the one of a newer rotation.
+  if (rotation_start_time_.is_null() ||
+      WasAnimationAbortedForProperty(ui::LayerAnimationElement::TRANSFORM))
+    return;
+  aura::Window* window = GetNativeWindow()->GetRootWindow();
+  ui::Compositor* compositor = window ? window->layer()->GetCompositor() : NULL;
+  if (!compositor) {
+    rotation_start_time_ = base::TimeTicks();
+    TRACE_EVENT_ASYNC_END0("xwalk", "NativeAppWindowTizen::Rotate", this);
+    return;
+  }
+  rotation_compositor_ = compositor;
+  rotation_compositor_->AddObserver(this);
+}
+
+void NativeAppWindowTizen::OnCompositingEnded(ui::Compositor* compositor) {
+  // The commits are held until the frame at the new size is ready, this is
+  // the first one drawn after the animation.
+  StopObservingCompositor();
+  TRACE_EVENT_ASYNC_END1("xwalk", "NativeAppWindowTizen::Rotate", this,
+                         "latencyMs",
+                         (base::TimeTicks::Now() - rotation_start_time_)
+                             .InMillisecondsF());
+  rotation_start_time_ = base::TimeTicks();
+}
+
+void NativeAppWindowTizen::StopObservingCompositor() {
+  if (!rotation_compositor_)
+    return;
+  rotation_compositor_->RemoveObserver(this);
+  rotation_compositor_ = NULL;
+}
+
 }  // namespace xwalk
@@ -6,6 +6,7 @@
 #define XWALK_RUNTIME_BROWSER_UI_NATIVE_APP_WINDOW_TIZEN_H_
 
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "content/browser/screen_orientation/screen_orientation_provider.h"
 #include "xwalk/runtime/browser/ui/screen_orientation.h"
 #include "xwalk/runtime/browser/ui/native_app_window_views.h"
@@ -13,6 +14,11 @@
 #include "xwalk/tizen/mobile/ui/tizen_system_indicator_widget.h"
 #include "xwalk/tizen/mobile/ui/widget_container_view.h"
 #include "ui/aura/window_observer.h"
+#include "ui/compositor/compositor_observer.h"
+#include "ui/compositor/layer_animation_observer.h"
+#include "ui/gfx/display.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/transform.h"
 
 namespace xwalk {
 
@@ -20,10 +26,17 @@ class SplashScreenTizen;
 
 // Tizen uses the Views native window but adds its own features like orientation
 // handling and integration with system indicator bar.
+//
+// The rotations of a visible window are animated by the compositor: the
+// frame drawn at the old size is rotated right away while the contents
+// resize, the "NativeAppWindowTizen::Rotate" trace event lasts until the
+// first frame at the new size is drawn.
 class NativeAppWindowTizen
     : public aura::WindowObserver,
       public NativeAppWindowViews,
-      public SensorProvider::Observer {
+      public SensorProvider::Observer,
+      public ui::ImplicitAnimationObserver,
+      public ui::CompositorObserver {
  public:
   explicit NativeAppWindowTizen(const NativeAppWindow::CreateParams& params);
   virtual ~NativeAppWindowTizen();
@@ -31,11 +44,16 @@ class NativeAppWindowTizen
   void LockOrientation(
       blink::WebScreenOrientationLockType orientations);
 
+  // The transform of the root window showing its contents rotated to
+  // |display|, and the bounds the contents have once rotated.
+  static gfx::Transform GetRotationTransform(const gfx::Display& display);
+  static gfx::Rect GetRotatedBounds(const gfx::Display& display);
+
  private:
   blink::WebScreenOrientationType FindNearestAllowedOrientation(
       blink::WebScreenOrientationType orientation) const;
 
-  void SetDisplayRotation(gfx::Display);
+  void SetDisplayRotation(gfx::Display display, bool animate);
 
   // SensorProvider::Observer overrides:
   virtual void OnScreenOrientationChanged(
@@ -57,6 +75,20 @@ class NativeAppWindowTizen
   virtual void ViewHierarchyChanged(
       const ViewHierarchyChangedDetails& details) OVERRIDE;
 
+  // ui::ImplicitAnimationObserver overrides:
+  virtual void OnImplicitAnimationsCompleted() OVERRIDE;
+
+  // ui::CompositorObserver overrides:
+  virtual void OnCompositingDidCommit(ui::Compositor* compositor) OVERRIDE {}
+  virtual void OnCompositingStarted(ui::Compositor* compositor,
+                                    base::TimeTicks start_time) OVERRIDE {}
+  virtual void OnCompositingEnded(ui::Compositor* compositor) OVERRIDE;
+  virtual void OnCompositingAborted(ui::Compositor* compositor) OVERRIDE {}
+  virtual void OnCompositingLockStateChanged(
+      ui::Compositor* compositor) OVERRIDE {}
+
+  void StopObservingCompositor();
+
 #if defined(OS_TIZEN_MOBILE)
   // The system indicator is implemented as a widget because it needs to
   // receive events and may also be an overlay on top of the rest of the
@@ -72,6 +104,11 @@ class NativeAppWindowTizen
   blink::WebScreenOrientationLockType orientation_lock_;
   scoped_ptr<SplashScreenTizen> splash_screen_;
 
+  // Set while a rotation is animated or waits for its first frame.
+  base::TimeTicks rotation_start_time_;
+  // Observed once the rotation animation completed.
+  ui::Compositor* rotation_compositor_;
+
   DISALLOW_COPY_AND_ASSIGN(NativeAppWindowTizen);
 };
 
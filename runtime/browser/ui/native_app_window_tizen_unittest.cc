@@ -0,0 +1,53 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/browser/ui/native_app_window_tizen.h"
+
+#include <cmath>
+
+#include "base/basictypes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gfx/display.h"
+#include "ui/gfx/rect.h"
+#include "ui/gfx/rect_f.h"
+#include "ui/gfx/size_conversions.h"
+#include "ui/gfx/transform.h"
+
+using xwalk::NativeAppWindowTizen;
+
+namespace {
+
+const gfx::Display::Rotation kRotations[] = {
+  gfx::Display::ROTATE_0,
+  gfx::Display::ROTATE_90,
+  gfx::Display::ROTATE_180,
+  gfx::Display::ROTATE_270,
+};
+
+}  // namespace
+
+TEST(NativeAppWindowTizenTest, RotatedBoundsFillTheDisplay) {
+  gfx::Display display(1, gfx::Rect(0, 0, 720, 1280));
+  for (size_t i = 0; i < arraysize(kRotations); ++i) {
+    display.set_rotation(kRotations[i]);
+    gfx::RectF bounds(NativeAppWindowTizen::GetRotatedBounds(display));
+    NativeAppWindowTizen::GetRotationTransform(display).TransformRect(&bounds);
+    // Transformed back to the screen, the contents cover it all.
+    EXPECT_EQ(display.bounds().size().ToString(),
+              gfx::ToRoundedSize(bounds.size()).ToString())
+        << "rotation: " << kRotations[i];
+    EXPECT_GE(1.0f, std::abs(bounds.x())) << "rotation: " << kRotations[i];
+    EXPECT_GE(1.0f, std::abs(bounds.y())) << "rotation: " << kRotations[i];
+  }
+}
+
+TEST(NativeAppWindowTizenTest, RotatedBoundsSwapInLandscape) {
+  gfx::Display display(1, gfx::Rect(0, 0, 720, 1280));
+  display.set_rotation(gfx::Display::ROTATE_90);
+  EXPECT_EQ("0,0 1280x720",
+            NativeAppWindowTizen::GetRotatedBounds(display).ToString());
+  display.set_rotation(gfx::Display::ROTATE_180);
+  EXPECT_EQ("0,0 720x1280",
+            NativeAppWindowTizen::GetRotatedBounds(display).ToString());
+}
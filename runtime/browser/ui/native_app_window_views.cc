@@ -4,6 +4,8 @@
 
 #include "xwalk/runtime/browser/ui/native_app_window_views.h"
 
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/web_contents.h"
 #include "ui/gfx/screen.h"
@@ -24,6 +26,39 @@
 
 namespace xwalk {
 
+namespace {
+
+// The hidden window handed out by the next NativeAppWindow::Create() with
+// default parameters.
+NativeAppWindowViews* g_spare_window = NULL;
+// The window being closed to become the spare one.
+NativeAppWindowViews* g_recycling_window = NULL;
+
+bool IsDefaultWindow(const NativeAppWindow::CreateParams& params) {
+  return (params.state == ui::SHOW_STATE_DEFAULT ||
+          params.state == ui::SHOW_STATE_NORMAL) &&
+         !params.parent &&
+         !params.net_wm_pid &&
+         params.splash_screen_path.empty() &&
+         params.resizable &&
+         params.minimum_size.IsEmpty() &&
+         params.maximum_size.IsEmpty();
+}
+
+NativeAppWindowViews* CreateViewsWindow(
+    const NativeAppWindow::CreateParams& create_params) {
+  NativeAppWindowViews* window;
+#if defined(OS_TIZEN)
+  window = new NativeAppWindowTizen(create_params);
+#else
+  window = new NativeAppWindowViews(create_params);
+#endif
+  window->Initialize();
+  return window;
+}
+
+}  // namespace
+
 NativeAppWindowViews::NativeAppWindowViews(
     const NativeAppWindow::CreateParams& create_params)
   : create_params_(create_params),
@@ -34,7 +69,8 @@ NativeAppWindowViews::NativeAppWindowViews(
     is_fullscreen_(false),
     minimum_size_(create_params.minimum_size),
     maximum_size_(create_params.maximum_size),
-    resizable_(create_params.resizable) {}
+    resizable_(create_params.resizable),
+    weak_ptr_factory_(this) {}
 
 NativeAppWindowViews::~NativeAppWindowViews() {}
 
@@ -148,7 +184,19 @@ void NativeAppWindowViews::FlashFrame(bool flash) {
 }
 
 void NativeAppWindowViews::Close() {
-  window_->Close();
+  if (g_recycling_window == this)
+    return;
+  if (!CanRecycle()) {
+    window_->Close();
+    return;
+  }
+  // The delegate is told later, as it would be by the widget.
+  g_recycling_window = this;
+  window_->Hide();
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&NativeAppWindowViews::Recycle,
+                 weak_ptr_factory_.GetWeakPtr()));
 }
 
 bool NativeAppWindowViews::IsActive() const {
@@ -167,6 +215,28 @@ bool NativeAppWindowViews::IsFullscreen() const {
   return is_fullscreen_;
 }
 
+bool NativeAppWindowViews::CanReuseFor(
+    const NativeAppWindow::CreateParams& params) const {
+  return IsDefaultWindow(params) &&
+         params.bounds.size() == create_params_.bounds.size();
+}
+
+void NativeAppWindowViews::Reuse(const NativeAppWindow::CreateParams& params) {
+  DCHECK(!delegate_);
+  create_params_ = params;
+  delegate_ = params.delegate;
+  web_contents_ = params.web_contents;
+  web_view_->SetWebContents(web_contents_);
+  // The widget still shows what the previous user of the window set.
+  window_->UpdateWindowTitle();
+  window_->UpdateWindowIcon();
+  if (window_->IsMaximized() || window_->IsMinimized())
+    window_->Restore();
+#if !defined(USE_OZONE)
+  window_->CenterWindow(create_params_.bounds.size());
+#endif
+}
+
 TopViewLayout* NativeAppWindowViews::top_view_layout() {
   return static_cast<TopViewLayout*>(GetLayoutManager());
 }
@@ -195,8 +265,13 @@ base::string16 NativeAppWindowViews::GetWindowTitle() const {
 }
 
 void NativeAppWindowViews::DeleteDelegate() {
+  if (g_spare_window == this)
+    g_spare_window = NULL;
+  if (g_recycling_window == this)
+    g_recycling_window = NULL;
   window_->RemoveObserver(this);
-  delegate_->OnWindowDestroyed();
+  if (delegate_)
+    delegate_->OnWindowDestroyed();
   delete this;
 }
 gfx::ImageSkia NativeAppWindowViews::GetWindowAppIcon() {
@@ -291,17 +366,51 @@ void NativeAppWindowViews::OnWidgetBoundsChanged(views::Widget* widget,
     const gfx::Rect& new_bounds) {
 }
 
+bool NativeAppWindowViews::CanRecycle() const {
+  // Only the windows of web contents are handed out.
+  return !g_spare_window && !g_recycling_window && !is_fullscreen_ &&
+         web_contents_ && IsDefaultWindow(create_params_);
+}
+
+void NativeAppWindowViews::Recycle() {
+  DCHECK_EQ(this, g_recycling_window);
+  g_recycling_window = NULL;
+  web_view_->SetWebContents(NULL);
+  NativeAppWindowDelegate* delegate = delegate_;
+  delegate_ = NULL;
+  web_contents_ = NULL;
+  title_.clear();
+  icon_ = gfx::Image();
+  g_spare_window = this;
+  delegate->OnWindowDestroyed();
+}
+
 // static
 NativeAppWindow* NativeAppWindow::Create(
     const NativeAppWindow::CreateParams& create_params) {
-  NativeAppWindowViews* window;
-#if defined(OS_TIZEN)
-  window = new NativeAppWindowTizen(create_params);
-#else
-  window = new NativeAppWindowViews(create_params);
-#endif
-  window->Initialize();
-  return window;
+  if (g_spare_window && g_spare_window->CanReuseFor(create_params)) {
+    NativeAppWindowViews* window = g_spare_window;
+    g_spare_window = NULL;
+    window->Reuse(create_params);
+    return window;
+  }
+  return CreateViewsWindow(create_params);
+}
+
+// static
+void NativeAppWindow::PrepareSpareWindow(const CreateParams& params) {
+  if (g_spare_window || !IsDefaultWindow(params))
+    return;
+  CreateParams spare_params(params);
+  spare_params.delegate = NULL;
+  spare_params.web_contents = NULL;
+  g_spare_window = CreateViewsWindow(spare_params);
+}
+
+// static
+void NativeAppWindow::DestroySpareWindow() {
+  if (g_spare_window)
+    g_spare_window->GetWidget()->CloseNow();
 }
 
 // static
@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "base/memory/weak_ptr.h"
 #include "xwalk/runtime/browser/ui/native_app_window.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/rect.h"
@@ -54,6 +55,12 @@ class NativeAppWindowViews : public NativeAppWindow,
   virtual views::Widget* GetWidget() OVERRIDE;
   virtual const views::Widget* GetWidget() const OVERRIDE;
 
+  // Whether this spare window can be handed out for a window created with
+  // |params|, see NativeAppWindow::PrepareSpareWindow().
+  bool CanReuseFor(const NativeAppWindow::CreateParams& params) const;
+  // Binds this spare window to the delegate and web contents of |params|.
+  void Reuse(const NativeAppWindow::CreateParams& params);
+
  protected:
   TopViewLayout* top_view_layout();
   const NativeAppWindow::CreateParams& create_params() const {
@@ -96,6 +103,10 @@ class NativeAppWindowViews : public NativeAppWindow,
   virtual void OnWidgetBoundsChanged(
       views::Widget* widget, const gfx::Rect& new_bounds) OVERRIDE;
 
+  // Closing keeps the window as the spare one when it can be reused.
+  bool CanRecycle() const;
+  void Recycle();
+
   NativeAppWindow::CreateParams create_params_;
 
   NativeAppWindowDelegate* delegate_;
@@ -111,6 +122,8 @@ class NativeAppWindowViews : public NativeAppWindow,
   gfx::Size maximum_size_;
   bool resizable_;
 
+  base::WeakPtrFactory<NativeAppWindowViews> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(NativeAppWindowViews);
 };
 
@@ -10,12 +10,22 @@
 #include "ui/gfx/canvas.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/views/widget/widget.h"
+#include "xwalk/application/common/splash_screen_cache_tizen.h"
 #include "xwalk/runtime/browser/image_util.h"
 
 namespace xwalk {
 
 namespace {
 const int kHideAnimationDuration = 1;  // second
+
+gfx::Image LoadSplashScreen(const base::FilePath& path,
+                            base::MemoryMappedFile* cache) {
+  SkBitmap bitmap;
+  if (xwalk::application::MapSplashScreenCache(path, cache, &bitmap))
+    return gfx::Image(gfx::ImageSkia(gfx::ImageSkiaRep(bitmap, 1.0f)));
+  return xwalk_utils::LoadImageFromFilePath(path);
+}
+
 }  // namespace
 
 class SplashScreenTizen::SplashScreenLayerDelegate : public ui::LayerDelegate {
@@ -69,7 +79,8 @@ void SplashScreenTizen::Start() {
     return;
 
   is_started = true;
-  gfx::Image image = xwalk_utils::LoadImageFromFilePath(splash_screen_image_);
+  gfx::Image image =
+      LoadSplashScreen(splash_screen_image_, &splash_screen_cache_);
   if (!image.IsEmpty()) {
     layer_delegate_->set_image(image);
     ui::Layer* top_layer = widget_host_->GetLayer();
@@ -97,11 +108,7 @@ void SplashScreenTizen::Stop() {
   layer_->SetOpacity(0.0f);
 }
 
-void SplashScreenTizen::DidFinishLoad(
-    int64 frame_id,
-    const GURL& validated_url,
-    bool is_main_frame,
-    content::RenderViewHost* render_view_host) {
+void SplashScreenTizen::DidFirstVisuallyNonEmptyPaint() {
   Stop();
 }
 
@@ -6,6 +6,7 @@
 #define XWALK_RUNTIME_BROWSER_UI_SPLASH_SCREEN_TIZEN_H_
 
 #include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "ui/compositor/layer_animation_observer.h"
 
@@ -24,6 +25,9 @@ class Widget;
 
 namespace xwalk {
 
+// Shows the splash screen of the application until the first visually
+// non-empty paint of its contents. The image is mapped from the cache
+// written at install time, and only decoded when there is none.
 class SplashScreenTizen : public content::WebContentsObserver,
                           public ui::ImplicitAnimationObserver {
  public:
@@ -36,11 +40,7 @@ class SplashScreenTizen : public content::WebContentsObserver,
   void Stop();
 
   // Overridden from content::WebContentsObserver.
-  virtual void DidFinishLoad(int64 frame_id,
-                             const GURL& validated_url,
-                             bool is_main_frame,
-                             content::RenderViewHost* render_view_host)
-                             OVERRIDE;
+  virtual void DidFirstVisuallyNonEmptyPaint() OVERRIDE;
 
   virtual void DidFailLoad(int64 frame_id,
                            const GURL& validated_url,
@@ -55,6 +55,8 @@ class SplashScreenTizen : public content::WebContentsObserver,
  private:
   views::Widget* widget_host_;
   base::FilePath splash_screen_image_;
+  // Backs the image when it comes from the cache, so must outlive it.
+  base::MemoryMappedFile splash_screen_cache_;
 
   scoped_ptr<ui::Layer> layer_;
   class SplashScreenLayerDelegate;
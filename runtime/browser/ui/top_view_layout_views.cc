@@ -4,12 +4,23 @@
 
 #include "xwalk/runtime/browser/ui/top_view_layout_views.h"
 
+#include "base/debug/trace_event.h"
 #include "ui/views/view.h"
 
 namespace xwalk {
 
+namespace {
+
+// A resize coming less than this after the previous one is part of a live
+// resize. Long enough for the drag events of a window manager, short
+// enough not to be noticed once the resize is over.
+const int kResizeSettleDelayMs = 100;
+
+}  // namespace
+
 TopViewLayout::TopViewLayout()
-    : top_view_(NULL),
+    : host_(NULL),
+      top_view_(NULL),
       content_view_(NULL),
       overlay_(false) {}
 
@@ -29,8 +40,9 @@ void TopViewLayout::Layout(views::View* host) {
   if (!host->has_children())
     return;
 
+  host_ = host;
   if (!top_view_) {
-    content_view_->SetBoundsRect(host->GetLocalBounds());
+    SetContentViewBounds(host->GetLocalBounds());
     return;
   }
 
@@ -49,7 +61,7 @@ void TopViewLayout::Layout(views::View* host) {
     content_view_bounds.Inset(0, 0, 0, 0);
   else
     content_view_bounds.Inset(0, top_view_bounds.height(), 0, 0);
-  content_view_->SetBoundsRect(content_view_bounds);
+  SetContentViewBounds(content_view_bounds);
 }
 
 gfx::Size TopViewLayout::GetPreferredSize(const views::View* host) const {
@@ -60,4 +72,36 @@ gfx::Size TopViewLayout::GetPreferredSize(const views::View* host) const {
   return rect.size();
 }
 
+void TopViewLayout::SetContentViewBounds(const gfx::Rect& bounds) {
+  if (bounds.size() == content_view_->size()) {
+    // Moving the content, e.g. when the indicator is shown, is cheap.
+    resize_timer_.Stop();
+    content_view_->SetBoundsRect(bounds);
+    return;
+  }
+
+  const base::TimeDelta settle_delay =
+      base::TimeDelta::FromMilliseconds(kResizeSettleDelayMs);
+  base::TimeTicks now = base::TimeTicks::Now();
+  bool live_resize = resize_timer_.IsRunning() ||
+      (!last_resize_time_.is_null() && now - last_resize_time_ < settle_delay);
+  last_resize_time_ = now;
+  if (live_resize && !content_view_->size().IsEmpty()) {
+    content_view_->SetPosition(bounds.origin());
+    resize_timer_.Start(FROM_HERE, settle_delay,
+                        this, &TopViewLayout::OnResizeSettled);
+    return;
+  }
+
+  TRACE_EVENT2("xwalk", "TopViewLayout::ResizeContentView",
+               "width", bounds.width(), "height", bounds.height());
+  content_view_->SetBoundsRect(bounds);
+}
+
+void TopViewLayout::OnResizeSettled() {
+  // No resize for |kResizeSettleDelayMs|, the content gets the final size.
+  last_resize_time_ = base::TimeTicks();
+  host_->Layout();
+}
+
 }  // namespace xwalk
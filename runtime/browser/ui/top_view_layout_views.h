@@ -7,8 +7,14 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "ui/views/layout/layout_manager.h"
 
+namespace gfx {
+class Rect;
+}
+
 namespace xwalk {
 
 // Layout manager that handle a main content view taking all the space and
@@ -17,6 +23,11 @@ namespace xwalk {
 //
 // This layout expects that the view it is managing have either one or two
 // children, and that the setter methods are called accordingly.
+//
+// Resizing the content view relayouts the whole web page, so during a live
+// resize, i.e. sizes changing faster than the renderer can follow, the
+// content view keeps its last size, letterboxed or clipped in the host,
+// until the size settles.
 class TopViewLayout : public views::LayoutManager {
  public:
   TopViewLayout();
@@ -46,10 +57,17 @@ class TopViewLayout : public views::LayoutManager {
   virtual gfx::Size GetPreferredSize(const views::View* host) const OVERRIDE;
 
  private:
+  void SetContentViewBounds(const gfx::Rect& bounds);
+  void OnResizeSettled();
+
+  views::View* host_;
   views::View* top_view_;
   views::View* content_view_;
   bool overlay_;
 
+  base::TimeTicks last_resize_time_;
+  base::OneShotTimer<TopViewLayout> resize_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(TopViewLayout);
 };
 
@@ -9,6 +9,8 @@
 #include "xwalk/application/browser/application.h"
 #include "xwalk/application/browser/application_service.h"
 #include "xwalk/application/browser/application_system.h"
+#include "xwalk/runtime/browser/runtime_startup_timeline.h"
+#include "xwalk/runtime/browser/xwalk_runner.h"
 
 #if defined(OS_LINUX)
 #include "xwalk/application/browser/application_system_linux.h"
@@ -24,6 +26,14 @@ XWalkAppExtensionBridge::XWalkAppExtensionBridge()
 
 XWalkAppExtensionBridge::~XWalkAppExtensionBridge() {}
 
+void XWalkAppExtensionBridge::SetApplicationSystem(
+    application::ApplicationSystem* app_system) {
+  app_system_ = app_system;
+  // The application system is destroyed before the bridge, with its
+  // observers list.
+  app_system_->application_service()->AddObserver(this);
+}
+
 void XWalkAppExtensionBridge::CheckAPIAccessControl(
     int render_process_id,
     const std::string& extension_name,
@@ -63,6 +73,8 @@ bool XWalkAppExtensionBridge::RegisterPermissions(
 void XWalkAppExtensionBridge::ExtensionProcessCreated(
     int render_process_id,
     const IPC::ChannelHandle& channel_handle) {
+  RuntimeStartupTimeline::GetInstance()->Record(
+      RuntimeStartupTimeline::MILESTONE_EXTENSION_PROCESS_CHANNEL_READY);
 #if defined(OS_LINUX)
   CHECK(app_system_);
   application::ApplicationService* service = app_system_->application_service();
@@ -79,4 +91,13 @@ void XWalkAppExtensionBridge::ExtensionProcessCreated(
 #endif
 }
 
+void XWalkAppExtensionBridge::DidChangePermissions(
+    application::Application* app) {
+  extensions::XWalkExtensionService* extension_service =
+      XWalkRunner::GetInstance()->extension_service();
+  if (!extension_service || !app->render_process_host())
+    return;
+  extension_service->OnPermissionsChanged(app->GetRenderProcessHostID());
+}
+
 }  // namespace xwalk
@@ -7,6 +7,7 @@
 
 #include <string>
 
+#include "xwalk/application/browser/application_service.h"
 #include "xwalk/application/browser/application_system.h"
 #include "xwalk/extensions/browser/xwalk_extension_service.h"
 #include "xwalk/extensions/common/xwalk_extension_permission_types.h"
@@ -21,14 +22,14 @@ namespace xwalk {
 // between application and extension takes place, just like a 'bridge'.
 // The class instance will be owned by xwalk_runner.
 class XWalkAppExtensionBridge
-    : public extensions::XWalkExtensionService::Delegate {
+    : public extensions::XWalkExtensionService::Delegate,
+      public application::ApplicationService::Observer {
  public:
   XWalkAppExtensionBridge();
   virtual ~XWalkAppExtensionBridge();
 
-  void SetApplicationSystem(application::ApplicationSystem* app_system) {
-    app_system_ = app_system;
-  }
+  void SetApplicationSystem(application::ApplicationSystem* app_system);
+
   // XWalkExtensionService::Delegate implementation
   virtual void CheckAPIAccessControl(
       int render_process_id,
@@ -44,6 +45,9 @@ class XWalkAppExtensionBridge
       const IPC::ChannelHandle& channel_handle) OVERRIDE;
 
  private:
+  // ApplicationService::Observer implementation.
+  virtual void DidChangePermissions(application::Application* app) OVERRIDE;
+
   application::ApplicationSystem* app_system_;
 
   DISALLOW_COPY_AND_ASSIGN(XWalkAppExtensionBridge);
@@ -17,6 +17,7 @@
 #include "cc/base/switches.h"
 #include "components/nacl/browser/nacl_browser.h"
 #include "components/nacl/browser/nacl_process_host.h"
+#include "components/nacl/browser/pnacl_host.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/common/content_switches.h"
 #include "content/public/common/main_function_params.h"
@@ -33,7 +34,10 @@
 #include "xwalk/runtime/browser/nacl_host/nacl_browser_delegate_impl.h"
 #include "xwalk/runtime/browser/runtime.h"
 #include "xwalk/runtime/browser/runtime_context.h"
+#include "xwalk/runtime/browser/runtime_performance_profiles.h"
+#include "xwalk/runtime/browser/runtime_startup_timeline.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
+#include "xwalk/runtime/common/pnacl_translation_cache.h"
 #include "xwalk/runtime/common/xwalk_runtime_features.h"
 #include "xwalk/runtime/common/xwalk_switches.h"
 
@@ -44,6 +48,15 @@
 
 namespace {
 
+#if !defined(DISABLE_NACL)
+void InitPnaclHost() {
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&pnacl::PnaclHost::Init,
+                 base::Unretained(pnacl::PnaclHost::GetInstance())));
+}
+#endif
+
 // FIXME: Compare with method in startup_browser_creator.cc.
 GURL GetURLFromCommandLine(const CommandLine& command_line) {
   const CommandLine::StringVector& args = command_line.GetArgs();
@@ -77,6 +90,7 @@ XWalkBrowserMainParts::XWalkBrowserMainParts(
       startup_url_(url::kAboutBlankURL),
       parameters_(parameters),
       run_default_message_loop_(true) {
+  RuntimeStartupTimeline::GetInstance()->Start();
 #if defined(OS_LINUX)
   // FIXME: We disable the setuid sandbox on Linux because we don't ship
   // the setuid binary. It is important to remember that the seccomp-bpf
@@ -119,6 +133,9 @@ void XWalkBrowserMainParts::PreMainMessageLoopStart() {
   }
   command_line->AppendSwitchASCII(switches::kJavaScriptFlags, js_flags);
 
+  // Before any child process starts, they get their switches from here.
+  RuntimePerformanceProfiles::ApplyFromCommandLine(command_line);
+
   startup_url_ = GetURLFromCommandLine(*command_line);
 }
 
@@ -182,12 +199,18 @@ void XWalkBrowserMainParts::RegisterExternalExtensions() {
 }
 
 void XWalkBrowserMainParts::PreMainMessageLoopRun() {
+  // Starts opening the application storage on the blocking pool, the steps
+  // below until the launch don't need it.
   xwalk_runner_->PreMainMessageLoopRun();
 
   extension_service_ = xwalk_runner_->extension_service();
 
-  if (extension_service_)
+  RuntimeStartupTimeline* timeline = RuntimeStartupTimeline::GetInstance();
+  if (extension_service_) {
     RegisterExternalExtensions();
+    timeline->Record(
+        RuntimeStartupTimeline::MILESTONE_EXTERNAL_EXTENSIONS_REGISTERED);
+  }
 
 #if !defined(DISABLE_NACL)
   NaClBrowserDelegateImpl* delegate = new NaClBrowserDelegateImpl();
@@ -197,6 +220,15 @@ void XWalkBrowserMainParts::PreMainMessageLoopRun() {
       content::BrowserThread::IO,
       FROM_HERE,
       base::Bind(nacl::NaClProcessHost::EarlyStartup));
+  // The translation cache is checked before it is opened on the IO thread.
+  // The first translation can only be requested once a page embedding a
+  // module is loaded, long after.
+  content::BrowserThread::PostBlockingPoolTaskAndReply(
+      FROM_HERE,
+      base::Bind(base::IgnoreResult(&xwalk::ValidatePnaclTranslationCache),
+                 xwalk_runner_->runtime_context()->GetPath()),
+      base::Bind(&InitPnaclHost));
+  timeline->Record(RuntimeStartupTimeline::MILESTONE_NACL_STARTUP_POSTED);
 #endif
 
   CommandLine* command_line = CommandLine::ForCurrentProcess();
@@ -209,10 +241,25 @@ void XWalkBrowserMainParts::PreMainMessageLoopRun() {
       remote_debugging_server_.reset(
           new RemoteDebuggingServer(xwalk_runner_->runtime_context(),
               local_ip, port, std::string()));
+      timeline->Record(
+          RuntimeStartupTimeline::MILESTONE_REMOTE_DEBUGGING_STARTED);
     }
   }
+#if defined(OS_POSIX)
+  if (!remote_debugging_server_ &&
+      command_line->HasSwitch(switches::kRemoteDebuggingSocket)) {
+    remote_debugging_server_.reset(new RemoteDebuggingServer(
+        xwalk_runner_->runtime_context(),
+        command_line->GetSwitchValuePath(switches::kRemoteDebuggingSocket),
+        std::string()));
+    timeline->Record(
+        RuntimeStartupTimeline::MILESTONE_REMOTE_DEBUGGING_STARTED);
+  }
+#endif
 
   NativeAppWindow::Initialize();
+  timeline->Record(
+      RuntimeStartupTimeline::MILESTONE_NATIVE_WINDOW_INITIALIZED);
 
   if (command_line->HasSwitch(switches::kListFeaturesFlags)) {
     XWalkRuntimeFeatures::GetInstance()->DumpFeaturesFlags();
@@ -241,6 +288,7 @@ bool XWalkBrowserMainParts::MainMessageLoopRun(int* result_code) {
 }
 
 void XWalkBrowserMainParts::PostMainMessageLoopRun() {
+  NativeAppWindow::DestroySpareWindow();
   xwalk_runner_->PostMainMessageLoopRun();
 }
 
@@ -33,12 +33,18 @@
 #include "xwalk/extensions/common/xwalk_extension.h"
 #include "xwalk/extensions/common/xwalk_extension_switches.h"
 #include "xwalk/runtime/browser/android/cookie_manager.h"
+#include "xwalk/runtime/browser/android/net_disk_cache_remover.h"
 #include "xwalk/runtime/browser/runtime_context.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
 #include "xwalk/runtime/common/xwalk_runtime_features.h"
 
 namespace {
 
+// The http disk cache entries not used for this many days are removed once
+// the application has started.
+const int kHttpDiskCacheMaxAgeInDays = 30;
+const int kHttpDiskCacheEvictionDelayInSeconds = 60;
+
 base::StringPiece PlatformResourceProvider(int key) {
   if (key == IDR_DIR_HEADER_HTML) {
     base::StringPiece html_data =
@@ -148,6 +154,11 @@ void XWalkBrowserMainPartsAndroid::PreMainMessageLoopRun() {
   cookie_store_ = content::CreateCookieStore(cookie_config);
   cookie_store_->GetCookieMonster()->SetPersistSessionCookies(true);
   SetCookieMonsterOnNetworkStackInit(cookie_store_->GetCookieMonster());
+
+  ScheduleHttpDiskCacheEviction(
+      xwalk_runner_->runtime_context(),
+      base::TimeDelta::FromSeconds(kHttpDiskCacheEvictionDelayInSeconds),
+      base::TimeDelta::FromDays(kHttpDiskCacheMaxAgeInDays));
 }
 
 void XWalkBrowserMainPartsAndroid::PostMainMessageLoopRun() {
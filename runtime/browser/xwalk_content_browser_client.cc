@@ -36,6 +36,8 @@
 #include "xwalk/runtime/browser/renderer_host/pepper/xwalk_browser_pepper_host_factory.h"
 #include "xwalk/runtime/browser/runtime_context.h"
 #include "xwalk/runtime/browser/runtime_quota_permission_context.h"
+#include "xwalk/runtime/browser/runtime_resource_dispatcher_host_delegate.h"
+#include "xwalk/runtime/browser/runtime_startup_timeline.h"
 #include "xwalk/runtime/browser/speech/speech_recognition_manager_delegate.h"
 #include "xwalk/runtime/browser/xwalk_render_message_filter.h"
 #include "xwalk/runtime/browser/xwalk_runner.h"
@@ -54,6 +56,7 @@
 #include "xwalk/application/browser/application_system.h"
 #include "xwalk/application/browser/application_service.h"
 #include "xwalk/application/browser/application.h"
+#include "xwalk/application/common/security_policy.h"
 #endif
 
 #if defined(OS_MACOSX)
@@ -139,8 +142,9 @@ XWalkContentBrowserClient::CreateRequestContextForStoragePartition(
 void XWalkContentBrowserClient::AppendExtraCommandLineSwitches(
     CommandLine* command_line, int child_process_id) {
   CommandLine* browser_process_cmd_line = CommandLine::ForCurrentProcess();
-  const int extra_switches_count = 1;
+  const int extra_switches_count = 2;
   const char* extra_switches[extra_switches_count] = {
+    switches::kSuppressSubframeErrorPages,
     switches::kXWalkDisableExtensionProcess
   };
 
@@ -183,8 +187,10 @@ void XWalkContentBrowserClient::RenderProcessWillLaunch(
       host->GetBrowserContext()->GetPath(),
       context));
 #endif
+  RuntimeStartupTimeline::GetInstance()->Record(
+      RuntimeStartupTimeline::MILESTONE_RENDER_PROCESS_LAUNCH);
   xwalk_runner_->OnRenderProcessWillLaunch(host);
-  host->AddFilter(new XWalkRenderMessageFilter);
+  host->AddFilter(new XWalkRenderMessageFilter(host->GetID()));
 }
 
 content::MediaObserver* XWalkContentBrowserClient::GetMediaObserver() {
@@ -343,12 +349,14 @@ content::BrowserPpapiHost*
   return NULL;
 }
 
-#if defined(OS_ANDROID)
 void XWalkContentBrowserClient::ResourceDispatcherHostCreated() {
+#if defined(OS_ANDROID)
   RuntimeResourceDispatcherHostDelegateAndroid::
   ResourceDispatcherHostCreated();
-}
+#else
+  RuntimeResourceDispatcherHostDelegate::ResourceDispatcherHostCreated();
 #endif
+}
 
 content::SpeechRecognitionManagerDelegate*
     XWalkContentBrowserClient::GetSpeechRecognitionManagerDelegate() {
@@ -371,13 +379,10 @@ bool XWalkContentBrowserClient::CanCreateWindow(const GURL& opener_url,
                              int opener_id,
                              bool* no_javascript_access) {
   *no_javascript_access = false;
-  application::Application* app = xwalk_runner_->app_system()->
-      application_service()->GetApplicationByRenderHostID(render_process_id);
-  if (!app)
-    // If it's not a request from an application, always enable this action.
-    return true;
-
-  if (app->CanRequestURL(target_url)) {
+  // Called on the IO thread, the applications live on the UI thread. A
+  // request not coming from an application is always allowed.
+  if (application::SecurityPolicy::IsAccessAllowedForProcess(
+          render_process_id, target_url)) {
     LOG(INFO) << "[ALLOW] CreateWindow: " << target_url.spec();
     return true;
   }
@@ -135,9 +135,7 @@ class XWalkContentBrowserClient : public content::ContentBrowserClient {
   virtual content::BrowserPpapiHost* GetExternalBrowserPpapiHost(
       int plugin_process_id) OVERRIDE;
 
-#if defined(OS_ANDROID)
-  virtual void ResourceDispatcherHostCreated();
-#endif
+  virtual void ResourceDispatcherHostCreated() OVERRIDE;
 
   virtual void GetStoragePartitionConfigForSite(
       content::BrowserContext* browser_context,
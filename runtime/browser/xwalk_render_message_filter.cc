@@ -4,30 +4,73 @@
 
 #include "xwalk/runtime/browser/xwalk_render_message_filter.h"
 
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "content/public/browser/child_process_security_policy.h"
+#include "webkit/browser/fileapi/isolated_context.h"
 #include "xwalk/runtime/common/xwalk_common_messages.h"
 #include "xwalk/runtime/browser/runtime_platform_util.h"
+#include "xwalk/runtime/browser/runtime_startup_timeline.h"
 
 namespace xwalk {
 
-XWalkRenderMessageFilter::XWalkRenderMessageFilter()
-    : BrowserMessageFilter(ViewMsgStart) {
+XWalkRenderMessageFilter::XWalkRenderMessageFilter(int render_process_id)
+    : BrowserMessageFilter(ViewMsgStart),
+      render_process_id_(render_process_id) {
+}
+
+void XWalkRenderMessageFilter::OverrideThreadForMessage(
+    const IPC::Message& message,
+    content::BrowserThread::ID* thread) {
+  if (message.type() == ViewHostMsg_OpenIsolatedFile::ID)
+    *thread = content::BrowserThread::FILE;
 }
 
 bool XWalkRenderMessageFilter::OnMessageReceived(
     const IPC::Message& message) {
   bool handled = true;
-#if defined(OS_TIZEN)
   IPC_BEGIN_MESSAGE_MAP(XWalkRenderMessageFilter, message)
+    IPC_MESSAGE_HANDLER(ViewHostMsg_DidCreateFirstScriptContext,
+                        OnDidCreateFirstScriptContext)
+    IPC_MESSAGE_HANDLER(ViewHostMsg_OpenIsolatedFile, OnOpenIsolatedFile)
+#if defined(OS_TIZEN)
     IPC_MESSAGE_HANDLER(ViewMsg_OpenLinkExternal, OnOpenLinkExternal)
+#endif
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
-#else
-  handled = false;
-#endif
 
   return handled;
 }
 
+void XWalkRenderMessageFilter::OnDidCreateFirstScriptContext() {
+  RuntimeStartupTimeline::GetInstance()->Record(
+      RuntimeStartupTimeline::MILESTONE_FIRST_SCRIPT_CONTEXT);
+}
+
+void XWalkRenderMessageFilter::OnOpenIsolatedFile(
+    const std::string& filesystem_id,
+    const base::FilePath& path,
+    IPC::PlatformFileForTransit* file) {
+  *file = IPC::InvalidPlatformFileForTransit();
+  if (!content::ChildProcessSecurityPolicy::GetInstance()->CanReadFileSystem(
+          render_process_id_, filesystem_id))
+    return;
+
+  base::FilePath root;
+  if (!fileapi::IsolatedContext::GetInstance()->GetRegisteredPath(
+          filesystem_id, &root))
+    return;
+  if (path.IsAbsolute() || path.ReferencesParent())
+    return;
+
+  base::File opened(root.Append(path),
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!opened.IsValid())
+    return;
+  *file = IPC::GetFileHandleForProcess(opened.TakePlatformFile(),
+                                       PeerHandle(), true);
+}
+
 #if defined(OS_TIZEN)
 void XWalkRenderMessageFilter::OnOpenLinkExternal(const GURL& url) {
   LOG(INFO) << "OpenLinkExternal: " << url.spec();
@@ -4,23 +4,39 @@
 #ifndef XWALK_RUNTIME_BROWSER_XWALK_RENDER_MESSAGE_FILTER_H_
 #define XWALK_RUNTIME_BROWSER_XWALK_RENDER_MESSAGE_FILTER_H_
 
+#include <string>
+
 #include "content/public/browser/browser_message_filter.h"
+#include "ipc/ipc_platform_file.h"
 #include "url/gurl.h"
 
+namespace base {
+class FilePath;
+}
+
 namespace xwalk {
 // XWalkBrowserMessageFilter response to recieve and send message between
 // browser process and renderer process.
 class XWalkRenderMessageFilter : public content::BrowserMessageFilter {
  public:
-  XWalkRenderMessageFilter();
+  explicit XWalkRenderMessageFilter(int render_process_id);
+  virtual void OverrideThreadForMessage(
+      const IPC::Message& message,
+      content::BrowserThread::ID* thread) OVERRIDE;
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
 
  private:
+  void OnDidCreateFirstScriptContext();
+  void OnOpenIsolatedFile(const std::string& filesystem_id,
+                          const base::FilePath& path,
+                          IPC::PlatformFileForTransit* file);
 #if defined(OS_TIZEN)
   void OnOpenLinkExternal(const GURL& url);
 #endif
   virtual ~XWalkRenderMessageFilter() {}
 
+  int render_process_id_;
+
   DISALLOW_COPY_AND_ASSIGN(XWalkRenderMessageFilter);
 };
 }  // namespace xwalk
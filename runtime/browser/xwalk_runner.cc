@@ -12,9 +12,11 @@
 #include "xwalk/application/browser/application_service.h"
 #include "xwalk/application/browser/application_system.h"
 #include "xwalk/extensions/browser/xwalk_extension_service.h"
+#include "xwalk/extensions/common/xwalk_extension.h"
 #include "xwalk/extensions/common/xwalk_extension_switches.h"
 #include "xwalk/runtime/browser/application_component.h"
 #include "xwalk/runtime/browser/runtime_context.h"
+#include "xwalk/runtime/browser/runtime_trace_recorder.h"
 #include "xwalk/runtime/browser/storage_component.h"
 #include "xwalk/runtime/browser/sysapps_component.h"
 #include "xwalk/runtime/browser/xwalk_app_extension_bridge.h"
@@ -67,10 +69,14 @@ application::ApplicationSystem* XWalkRunner::app_system() {
 }
 
 void XWalkRunner::PreMainMessageLoopRun() {
+  CommandLine* cmd_line = CommandLine::ForCurrentProcess();
+  trace_recorder_ = RuntimeTraceRecorder::CreateFromCommandLine(*cmd_line);
+  if (trace_recorder_)
+    trace_recorder_->Start();
+
   runtime_context_.reset(new RuntimeContext);
   app_extension_bridge_.reset(new XWalkAppExtensionBridge());
 
-  CommandLine* cmd_line = CommandLine::ForCurrentProcess();
   if (!cmd_line->HasSwitch(switches::kXWalkDisableExtensions))
     extension_service_.reset(new extensions::XWalkExtensionService(
         app_extension_bridge_.get()));
@@ -83,6 +89,7 @@ void XWalkRunner::PostMainMessageLoopRun() {
   DestroyComponents();
   extension_service_.reset();
   runtime_context_.reset();
+  trace_recorder_.reset();
 }
 
 void XWalkRunner::CreateComponents() {
@@ -126,11 +133,33 @@ scoped_ptr<StorageComponent> XWalkRunner::CreateStorageComponent() {
 void XWalkRunner::InitializeRuntimeVariablesForExtensions(
     const content::RenderProcessHost* host,
     base::ValueMap* variables) {
+  const std::string app_id = app_system()->application_service()->
+      GetApplicationIDByRenderHostID(host->GetID());
+
+  if (!app_id.empty())
+    (*variables)["app_id"] = base::Value::CreateStringValue(app_id);
+}
+
+void XWalkRunner::RemoveUnusedExtensions(
+    const content::RenderProcessHost* host,
+    extensions::XWalkExtensionVector* extensions) {
   application::Application* app = app_system()->application_service()->
       GetApplicationByRenderHostID(host->GetID());
+  if (!app)
+    return;
 
-  if (app)
-    (*variables)["app_id"] = base::Value::CreateStringValue(app->id());
+  extensions::XWalkExtensionVector used;
+  extensions::XWalkExtensionVector::iterator it = extensions->begin();
+  for (; it != extensions->end(); ++it) {
+    if (app->UseExtension((*it)->name())) {
+      used.push_back(*it);
+    } else {
+      VLOG(1) << "Application " << app->id() << " doesn't use extension "
+              << (*it)->name();
+      delete *it;
+    }
+  }
+  extensions->swap(used);
 }
 
 void XWalkRunner::OnRenderProcessWillLaunch(content::RenderProcessHost* host) {
@@ -156,6 +185,9 @@ void XWalkRunner::OnRenderProcessWillLaunch(content::RenderProcessHost* host) {
   main_parts->CreateInternalExtensionsForExtensionThread(
       host, &extension_thread_extensions);
 
+  RemoveUnusedExtensions(host, &ui_thread_extensions);
+  RemoveUnusedExtensions(host, &extension_thread_extensions);
+
   scoped_ptr<base::ValueMap> runtime_variables(new base::ValueMap);
   InitializeRuntimeVariablesForExtensions(host, runtime_variables.get());
   extension_service_->OnRenderProcessWillLaunch(
@@ -11,6 +11,7 @@
 #include "base/memory/scoped_vector.h"
 #include "base/values.h"
 
+#include "xwalk/extensions/common/xwalk_extension_vector.h"
 #include "xwalk/runtime/browser/storage_component.h"
 
 namespace content {
@@ -23,6 +24,7 @@ class XWalkTestSuiteInitializer;
 namespace xwalk {
 
 class RuntimeContext;
+class RuntimeTraceRecorder;
 class ApplicationComponent;
 class SysAppsComponent;
 class XWalkComponent;
@@ -124,6 +126,7 @@ class XWalkRunner {
   scoped_ptr<RuntimeContext> runtime_context_;
   scoped_ptr<extensions::XWalkExtensionService> extension_service_;
   scoped_ptr<XWalkAppExtensionBridge> app_extension_bridge_;
+  scoped_ptr<RuntimeTraceRecorder> trace_recorder_;
 
   // XWalkRunner uses the XWalkComponent interface to be able to handle
   // different subsystems and call them in specific situations, e.g. when
@@ -138,6 +141,13 @@ class XWalkRunner {
       const content::RenderProcessHost* host,
       base::ValueMap* runtime_variables);
 
+  // Deletes the extensions of |extensions| the application running in
+  // |host| doesn't use, so its render process gets neither their API nor
+  // their servers. Spare render processes, started before the application
+  // is launched, keep all of them.
+  void RemoveUnusedExtensions(const content::RenderProcessHost* host,
+                              extensions::XWalkExtensionVector* extensions);
+
   DISALLOW_COPY_AND_ASSIGN(XWalkRunner);
 };
 
@@ -201,6 +201,35 @@ IN_PROC_BROWSER_TEST_F(XWalkRuntimeTest, GetWindowTitle) {
 }
 #endif
 
+#if !defined(OS_MACOSX) && !defined(OS_TIZEN_MOBILE)
+IN_PROC_BROWSER_TEST_F(XWalkRuntimeTest, RecycledWindowIsReset) {
+  GURL url = xwalk_test_utils::GetTestURL(
+      base::FilePath(), base::FilePath().AppendASCII("title.html"));
+  Runtime* first = Runtime::CreateWithDefaultWindow(
+      GetRuntimeContext(), url, runtime_registry());
+  base::string16 title = base::ASCIIToUTF16("Dummy Title");
+  content::TitleWatcher title_watcher(first->web_contents(), title);
+  EXPECT_EQ(title, title_watcher.WaitAndGetTitle());
+  NativeAppWindow* window = first->window();
+  EXPECT_EQ(title, window->GetNativeWindow()->title());
+
+  // Closing the window keeps it around for the next runtime.
+  size_t len = runtimes().size();
+  window->Close();
+  content::RunAllPendingInMessageLoop();
+  EXPECT_EQ(len - 1, runtimes().size());
+
+  Runtime* second = Runtime::CreateWithDefaultWindow(
+      GetRuntimeContext(), GURL("about:blank"), runtime_registry());
+  EXPECT_EQ(window, second->window());
+  EXPECT_TRUE(window->GetNativeWindow()->title().empty());
+
+  second->Close();
+  content::RunAllPendingInMessageLoop();
+  EXPECT_EQ(len - 1, runtimes().size());
+}
+#endif
+
 IN_PROC_BROWSER_TEST_F(XWalkRuntimeTest, OpenLinkInNewRuntime) {
   size_t len = runtimes().size();
   GURL url = xwalk_test_utils::GetTestURL(
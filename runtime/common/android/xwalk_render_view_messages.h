@@ -4,6 +4,10 @@
 
 // Multiply-included file, no traditional include guard.
 #include <string>
+#include <vector>
+
+#include "base/strings/string16.h"
+#include "base/values.h"
 
 #include "xwalk/runtime/common/android/xwalk_hit_test_data.h"
 #include "content/public/common/common_param_traits.h"
@@ -40,6 +44,12 @@ IPC_STRUCT_TRAITS_END()
 // Tells the renderer to drop all WebCore memory cache.
 IPC_MESSAGE_CONTROL0(XWalkViewMsg_ClearCache) // NOLINT(*)
 
+// Tells the renderer the system is low on memory. The WebCore memory cache,
+// which holds the decoded images, is dropped and, if |purge_script_memory|
+// is set, V8 is asked to release as much memory as it can too.
+IPC_MESSAGE_CONTROL1(XWalkViewMsg_TrimMemory, // NOLINT(*)
+                     bool /* purge_script_memory */)
+
 // Request for the renderer to determine if the document contains any image
 // elements.  The id should be passed in the response message so the response
 // can be associated with the request.
@@ -53,6 +63,12 @@ IPC_MESSAGE_ROUTED2(XWalkViewMsg_DoHitTest, // NOLINT(*)
                     int /* view_x */,
                     int /* view_y */)
 
+// Runs |scripts| in the main frame, one after the other. The results are
+// sent back in one XWalkViewHostMsg_JavaScriptResults.
+IPC_MESSAGE_ROUTED2(XWalkViewMsg_ExecuteJavaScripts, // NOLINT(*)
+                    std::vector<int> /* ids */,
+                    std::vector<base::string16> /* scripts */)
+
 // Enables receiving pictures from the renderer on every new frame.
 IPC_MESSAGE_ROUTED1(XWalkViewMsg_EnableCapturePictureCallback, // NOLINT(*)
                     bool /* enable */)
@@ -93,6 +109,12 @@ IPC_MESSAGE_ROUTED2(XWalkViewHostMsg_DocumentHasImagesResponse, // NOLINT(*)
                     int, /* id */
                     bool /* has_images */)
 
+// Response to XWalkViewMsg_ExecuteJavaScripts, |results| has the value of
+// each script, null if it threw or the value can't be converted.
+IPC_MESSAGE_ROUTED2(XWalkViewHostMsg_JavaScriptResults, // NOLINT(*)
+                    std::vector<int> /* ids */,
+                    base::ListValue /* results */)
+
 // Response to XWalkViewMsg_DoHitTest.
 IPC_MESSAGE_ROUTED1(XWalkViewHostMsg_UpdateHitTestData, // NOLINT(*)
                     xwalk::XWalkHitTestData)
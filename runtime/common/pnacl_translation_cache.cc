@@ -0,0 +1,54 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/common/pnacl_translation_cache.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+
+namespace xwalk {
+
+namespace {
+
+// Appended by the PnaclHost to the cache directory of the NaCl delegate.
+const base::FilePath::CharType kTranslationCacheDirectoryName[] =
+    FILE_PATH_LITERAL("PnaclTranslationCache");
+// Kept out of the cache directory, which belongs to the backend.
+const base::FilePath::CharType kVersionFileName[] =
+    FILE_PATH_LITERAL("PnaclTranslationCacheVersion");
+
+// The bound of the backend plus some slack for its index.
+const int64 kMaxCacheSize = 64 * 1024 * 1024;
+
+}  // namespace
+
+bool ValidatePnaclTranslationCache(const base::FilePath& data_path) {
+  base::FilePath cache_dir = data_path.Append(kTranslationCacheDirectoryName);
+  base::FilePath version_file = data_path.Append(kVersionFileName);
+
+  std::string version;
+  if (base::ReadFileToString(version_file, &version) &&
+      version == XWALK_VERSION &&
+      base::ComputeDirectorySize(cache_dir) <= kMaxCacheSize)
+    return true;
+
+  if (base::PathExists(cache_dir)) {
+    LOG(INFO) << "Dropping the PNaCl translation cache of version "
+              << (version.empty() ? "unknown" : version);
+    if (!base::DeleteFile(cache_dir, true)) {
+      LOG(WARNING) << "Failed to delete " << cache_dir.value();
+      return false;
+    }
+  }
+  if (!base::CreateDirectory(data_path) ||
+      base::WriteFile(version_file, XWALK_VERSION,
+                      arraysize(XWALK_VERSION) - 1) < 0)
+    LOG(WARNING) << "Failed to write " << version_file.value();
+  return false;
+}
+
+}  // namespace xwalk
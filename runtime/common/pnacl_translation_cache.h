@@ -0,0 +1,30 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_RUNTIME_COMMON_PNACL_TRANSLATION_CACHE_H_
+#define XWALK_RUNTIME_COMMON_PNACL_TRANSLATION_CACHE_H_
+
+namespace base {
+class FilePath;
+}
+
+namespace xwalk {
+
+// The translations of the portable Native Client modules are kept by the
+// PnaclHost in a disk cache under the data path, so relaunching an
+// application doesn't translate its pexe again. The cache is bounded by its
+// backend, which evicts the oldest entries past 50MB.
+//
+// The entries are keyed by the URL and the headers of the pexe, not by the
+// version of the translator, so the cache is dropped when the runtime is
+// updated. It is also dropped when it outgrew the bound of the backend, e.g.
+// when the index was lost in a crash and the entries are orphaned.
+//
+// Returns whether the existing cache was kept. Must be called before the
+// cache is opened, blocks on file IO.
+bool ValidatePnaclTranslationCache(const base::FilePath& data_path);
+
+}  // namespace xwalk
+
+#endif  // XWALK_RUNTIME_COMMON_PNACL_TRANSLATION_CACHE_H_
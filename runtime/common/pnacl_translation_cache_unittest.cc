@@ -0,0 +1,61 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/runtime/common/pnacl_translation_cache.h"
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::ValidatePnaclTranslationCache;
+
+namespace {
+
+const char kEntry[] = "translation";
+
+class PnaclTranslationCacheTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    cache_dir_ = temp_dir_.path().AppendASCII("PnaclTranslationCache");
+  }
+
+  void WriteEntry() {
+    ASSERT_TRUE(base::CreateDirectory(cache_dir_));
+    ASSERT_EQ(static_cast<int>(arraysize(kEntry)),
+              base::WriteFile(cache_dir_.AppendASCII("data_0"),
+                              kEntry, arraysize(kEntry)));
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath cache_dir_;
+};
+
+}  // namespace
+
+TEST_F(PnaclTranslationCacheTest, KeepsCacheOfSameVersion) {
+  EXPECT_FALSE(ValidatePnaclTranslationCache(temp_dir_.path()));
+  WriteEntry();
+  EXPECT_TRUE(ValidatePnaclTranslationCache(temp_dir_.path()));
+  EXPECT_TRUE(base::PathExists(cache_dir_.AppendASCII("data_0")));
+}
+
+TEST_F(PnaclTranslationCacheTest, DropsCacheOfOtherVersion) {
+  const char kOldVersion[] = "1.0.0.0";
+  ASSERT_TRUE(base::WriteFile(
+      temp_dir_.path().AppendASCII("PnaclTranslationCacheVersion"),
+      kOldVersion, arraysize(kOldVersion) - 1) > 0);
+  WriteEntry();
+
+  EXPECT_FALSE(ValidatePnaclTranslationCache(temp_dir_.path()));
+  EXPECT_FALSE(base::PathExists(cache_dir_));
+  EXPECT_TRUE(ValidatePnaclTranslationCache(temp_dir_.path()));
+}
+
+TEST_F(PnaclTranslationCacheTest, DropsCacheWithoutVersion) {
+  WriteEntry();
+  EXPECT_FALSE(ValidatePnaclTranslationCache(temp_dir_.path()));
+  EXPECT_FALSE(base::PathExists(cache_dir_));
+}
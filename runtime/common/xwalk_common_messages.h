@@ -44,7 +44,23 @@ IPC_MESSAGE_CONTROL1(ViewMsg_SuspendJSEngine,  // NOLINT
 
 IPC_MESSAGE_ROUTED1(ViewMsg_HWKeyPressed, int /*keycode*/)  // NOLINT
 
+// Sent when the system locale changed while the application runs.
+IPC_MESSAGE_ROUTED1(ViewMsg_LocaleChanged,  // NOLINT
+                    std::string /* BCP47 locale */)
+
 // These are messages sent from the renderer to the browser process.
+
+// Sent once per render process, when the first script context is created.
+IPC_MESSAGE_CONTROL0(ViewHostMsg_DidCreateFirstScriptContext)  // NOLINT
+
+// Opens read-only a file of an isolated file system the renderer can read,
+// so its content can be read by the renderer instead of through the browser. The file
+// is invalid if access is denied or it can't be opened.
+IPC_SYNC_MESSAGE_CONTROL2_1(ViewHostMsg_OpenIsolatedFile,  // NOLINT
+                            std::string /* file system id */,
+                            base::FilePath /* path in the file system */,
+                            IPC::PlatformFileForTransit /* file */)
+
 #if defined(OS_TIZEN)
 IPC_MESSAGE_CONTROL1(ViewMsg_OpenLinkExternal,  // NOLINT
                      GURL /* target link */)
@@ -4,12 +4,16 @@
 
 #include "xwalk/runtime/common/xwalk_localized_error.h"
 
+#include <map>
+
 #include "base/i18n/rtl.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "chrome/common/net/net_error_info.h"
 #include "grit/xwalk_resources.h"
@@ -199,6 +203,28 @@ const LocalizedErrorMap* FindErrorMapInArray(const LocalizedErrorMap* maps,
   return NULL;
 }
 
+// The locale of a process doesn't change, the strings are loaded from the
+// resources once and then only copied.
+struct ErrorDetailsCache {
+  base::Lock lock;
+  std::map<unsigned int, base::string16> details;
+};
+
+base::LazyInstance<ErrorDetailsCache>::Leaky g_error_details_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+base::string16 GetCachedErrorDetails(unsigned int resource_id) {
+  ErrorDetailsCache& cache = g_error_details_cache.Get();
+  base::AutoLock lock(cache.lock);
+  std::map<unsigned int, base::string16>::iterator it =
+      cache.details.find(resource_id);
+  if (it == cache.details.end()) {
+    it = cache.details.insert(std::make_pair(
+        resource_id, l10n_util::GetStringUTF16(resource_id))).first;
+  }
+  return it->second;
+}
+
 const LocalizedErrorMap* LookupErrorMap(const std::string& error_domain,
                                         int error_code, bool is_post) {
   if (error_domain == net::kErrorDomain) {
@@ -235,7 +261,7 @@ base::string16 LocalizedError::GetErrorDetails(const blink::WebURLError& error,
   const LocalizedErrorMap* error_map =
       LookupErrorMap(error.domain.utf8(), error.reason, is_post);
   if (error_map)
-    return l10n_util::GetStringUTF16(error_map->details_resource_id);
+    return GetCachedErrorDetails(error_map->details_resource_id);
   else
-    return l10n_util::GetStringUTF16(IDS_ERRORPAGES_DETAILS_UNKNOWN);
+    return GetCachedErrorDetails(IDS_ERRORPAGES_DETAILS_UNKNOWN);
 }
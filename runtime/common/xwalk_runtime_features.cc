@@ -4,8 +4,6 @@
 
 #include "xwalk/runtime/common/xwalk_runtime_features.h"
 
-#include <algorithm>
-#include <functional>
 #include <iostream> // NOLINT
 
 #include "base/logging.h"
@@ -13,14 +11,8 @@
 
 namespace xwalk {
 
-struct MatchRuntimeFeature
-  : std::unary_function<XWalkRuntimeFeatures::RuntimeFeature, bool> {
-  explicit MatchRuntimeFeature(const std::string& name) : name(name) {}
-  bool operator()(const XWalkRuntimeFeatures::RuntimeFeature& entry) const {
-    return entry.name == name;
-  }
-  const std::string name;
-};
+COMPILE_ASSERT(XWalkRuntimeFeatures::RuntimeFeatureCount <= 32,
+               too_many_runtime_features_for_the_bitset);
 
 XWalkRuntimeFeatures::RuntimeFeature::RuntimeFeature() {}
 
@@ -30,44 +22,53 @@ XWalkRuntimeFeatures* XWalkRuntimeFeatures::GetInstance() {
 }
 
 XWalkRuntimeFeatures::XWalkRuntimeFeatures()
-  : command_line_(0)
+  : enabled_features_(0)
+  , command_line_(0)
   , initialized_(false) {}
 
 void XWalkRuntimeFeatures::Initialize(const CommandLine* cmd) {
   command_line_ = cmd;
   initialized_ = true;
   runtime_features_.clear();
+  enabled_features_ = 0;
   if (cmd->HasSwitch(switches::kExperimentalFeatures))
     experimental_features_enabled_ = true;
   else
     experimental_features_enabled_ = false;
   // Add new features here with the following parameters :
+  // - Id of the feature, its bit in the enabled features
   // - Name of the feature
   // - Name of the command line switch which will be used after the
   // --enable/--disable
   // - Description of the feature
   // - Status of the feature : experimental which is turned off by default or
   // stable which is turned on by default
-  AddFeature("SysApps", "sysapps",
+  AddFeature(SysAppsFeature, "SysApps", "sysapps",
              "Master switch for the SysApps category of APIs", Stable);
-  AddFeature("RawSocketsAPI", "raw-sockets",
+  AddFeature(RawSocketsAPIFeature, "RawSocketsAPI", "raw-sockets",
              "JavaScript support for using TCP and UDP sockets", Stable);
-  AddFeature("DeviceCapabilitiesAPI", "device-capabilities",
+  AddFeature(DeviceCapabilitiesAPIFeature, "DeviceCapabilitiesAPI",
+             "device-capabilities",
              "JavaScript support for peeking at device capabilities", Stable);
-  AddFeature("StorageAPI", "storage",
+  AddFeature(StorageAPIFeature, "StorageAPI", "storage",
              "JavaScript support to file system beyond W3C spec", Stable);
-  AddFeature("DialogAPI", "dialog",
+  AddFeature(DownloaderAPIFeature, "DownloaderAPI", "downloader",
+             "JavaScript support for resumable, segmented downloads to files",
+             Experimental);
+  AddFeature(DialogAPIFeature, "DialogAPI", "dialog",
              "JavaScript support to create open/save native dialogs"
              , Experimental);
 }
 
 XWalkRuntimeFeatures::~XWalkRuntimeFeatures() {}
 
-void XWalkRuntimeFeatures::AddFeature(const char* name,
-                                 const char* command_line_switch,
-                                 const char* description,
-                                 RuntimeFeatureStatus status) {
+void XWalkRuntimeFeatures::AddFeature(RuntimeFeatureId id,
+                                      const char* name,
+                                      const char* command_line_switch,
+                                      const char* description,
+                                      RuntimeFeatureStatus status) {
   RuntimeFeature feature;
+  feature.id = id;
   feature.name = name;
   feature.description = description;
   feature.command_line_switch = command_line_switch;
@@ -85,6 +86,8 @@ void XWalkRuntimeFeatures::AddFeature(const char* name,
     feature.enabled = (status == Stable);
   }
 
+  if (feature.enabled)
+    enabled_features_ |= 1u << id;
   runtime_features_.push_back(feature);
 }
 
@@ -129,17 +132,9 @@ void XWalkRuntimeFeatures::DumpFeaturesFlags() {
   std::cout << output << std::endl;
 }
 
-bool XWalkRuntimeFeatures::isFeatureEnabled(const char* name) const {
+bool XWalkRuntimeFeatures::isFeatureEnabled(RuntimeFeatureId id) const {
   CHECK(initialized_);
-  if (experimental_features_enabled_)
-    return true;
-
-  RuntimeFeaturesList::const_iterator it = std::find_if(
-    runtime_features_.begin(), runtime_features_.end(),
-      MatchRuntimeFeature(name));
-  if (it == runtime_features_.end())
-    return false;
-  return (*it).enabled;
+  return (enabled_features_ & (1u << id)) != 0;
 }
 
 }  // namespace xwalk
@@ -5,6 +5,7 @@
 #ifndef XWALK_RUNTIME_COMMON_XWALK_RUNTIME_FEATURES_H_
 #define XWALK_RUNTIME_COMMON_XWALK_RUNTIME_FEATURES_H_
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -14,16 +15,29 @@
 namespace xwalk {
 
 #define DECLARE_RUNTIME_FEATURE(NAME) static bool is ##NAME## Enabled() \
-  { return GetInstance()->isFeatureEnabled( #NAME ); }
+  { return GetInstance()->isFeatureEnabled(NAME ##Feature); }
 
 class XWalkRuntimeFeatures {
  public:
-  // Declare new features here and and define them in xwalk_runtime_features.cc.
+  // The bits of the enabled features, resolved once by Initialize().
+  enum RuntimeFeatureId {
+    SysAppsFeature,
+    RawSocketsAPIFeature,
+    DeviceCapabilitiesAPIFeature,
+    StorageAPIFeature,
+    DialogAPIFeature,
+    DownloaderAPIFeature,
+    RuntimeFeatureCount
+  };
+
+  // Declare new features here, add them to RuntimeFeatureId and define them
+  // in xwalk_runtime_features.cc.
   DECLARE_RUNTIME_FEATURE(SysApps);
   DECLARE_RUNTIME_FEATURE(RawSocketsAPI);
   DECLARE_RUNTIME_FEATURE(DeviceCapabilitiesAPI);
   DECLARE_RUNTIME_FEATURE(StorageAPI);
   DECLARE_RUNTIME_FEATURE(DialogAPI);
+  DECLARE_RUNTIME_FEATURE(DownloaderAPI);
 
   void Initialize(const CommandLine* cmd);
   void DumpFeaturesFlags();
@@ -36,6 +50,7 @@ class XWalkRuntimeFeatures {
 
 
   struct RuntimeFeature {
+    RuntimeFeatureId id;
     std::string name;
     std::string description;
     std::string command_line_switch;
@@ -48,11 +63,14 @@ class XWalkRuntimeFeatures {
   friend struct DefaultSingletonTraits<XWalkRuntimeFeatures>;
   XWalkRuntimeFeatures();
   ~XWalkRuntimeFeatures();
-  void AddFeature(const char* name, const char* command_line_switch,
-                  const char* description, RuntimeFeatureStatus status);
-  bool isFeatureEnabled(const char* name) const;
+  void AddFeature(RuntimeFeatureId id, const char* name,
+                  const char* command_line_switch, const char* description,
+                  RuntimeFeatureStatus status);
+  bool isFeatureEnabled(RuntimeFeatureId id) const;
   typedef std::vector<RuntimeFeature> RuntimeFeaturesList;
   RuntimeFeaturesList runtime_features_;
+  // Immutable once initialized, so queries are a lock-free bit test.
+  uint32_t enabled_features_;
   const CommandLine* command_line_;
   bool initialized_;
   bool experimental_features_enabled_;
@@ -9,18 +9,99 @@ namespace switches {
 // Specifies the icon file for the app window.
 const char kAppIcon[] = "app-icon";
 
+// Answers the JavaScript dialogs without showing them, for kiosks and
+// headless devices where nobody could: alerts are dismissed, confirms and
+// beforeunload dialogs accepted, prompts return their default text.
+const char kAutoAnswerJavaScriptDialogs[] = "auto-answer-javascript-dialogs";
+
+// Makes the credentials the application answered an HTTP authentication
+// challenge with answer the next challenges of the same realm, without
+// asking the application again. They are only kept in memory.
+const char kCacheHttpAuthCredentials[] = "cache-http-auth-credentials";
+
+// Specifies how many cookie changes can wait for the next commit to the
+// cookie database before it is done right away.
+const char kCookieCommitBatchSize[] = "cookie-commit-batch-size";
+
+// Specifies how long in seconds the cookie changes are held back before
+// being committed to the cookie database.
+const char kCookieCommitInterval[] = "cookie-commit-interval";
+
+// Disables the negotiation of SPDY/HTTP2, connections then use HTTP/1.1.
+const char kDisableHttp2[] = "disable-http2";
+
 // Disables the usage of Portable Native Client.
 const char kDisablePnacl[] = "disable-pnacl";
 
+// Specifies the maximum size of the HTTP cache in bytes. The default is
+// computed from the free space of the disk.
+const char kDiskCacheSize[] = "disk-cache-size";
+
+// Enables QUIC, used with the servers advertising it as alternate protocol.
+const char kEnableQuic[] = "enable-quic";
+
 // Enable all the experimental features in XWalk.
 const char kExperimentalFeatures[] = "enable-xwalk-experimental-features";
 
 // Specifies the window whether launched with fullscreen mode.
 const char kFullscreen[] = "fullscreen";
 
+// Specifies the backend of the HTTP cache: "blockfile", "simple", which does
+// fewer and smaller writes on flash storage, or "memory" to keep nothing on
+// disk, e.g. for kiosk or ephemeral sessions.
+const char kHttpCacheBackend[] = "http-cache-backend";
+
 // List the command lines feature flags.
 const char kListFeaturesFlags[] = "list-features-flags";
 
+// Specify how many running applications may have a render process, and an
+// Extension Process, at once. Past that the applications hidden for the
+// longest time are hibernated, then terminated a while later, so the limit
+// is soft, see ApplicationProcessManager.
+const char kMaxExtensionProcesses[] = "max-extension-processes";
+const char kMaxRenderProcesses[] = "max-render-processes";
+
+// Specify the maximum number of connections to a single server, and in
+// total, of the normal socket pool.
+const char kMaxSocketsPerGroup[] = "max-sockets-per-group";
+const char kMaxSocketsPerPool[] = "max-sockets-per-pool";
+
+// Applies a set of GPU and compositor switches tuned for a kind of device,
+// see RuntimePerformanceProfiles for the built-in ones.
+const char kPerformanceProfile[] = "performance-profile";
+
+// JSON file defining more performance profiles and which profile each
+// device model gets when --performance-profile isn't given.
+const char kPerformanceProfilesFile[] = "performance-profiles-file";
+
+// Specifies the path of a Unix socket the remote debugging server listens
+// on, only the user running the runtime can connect. Unlike
+// --remote-debugging-port, the devices in the network can't.
+const char kRemoteDebuggingSocket[] = "remote-debugging-socket";
+
+// Lets the applications, each having its own storage partition, share the
+// host resolver, socket pools and TLS sessions of the runtime, while their
+// cookies, storage and HTTP caches stay apart.
+const char kShareNetworkSession[] = "share-network-session";
+
+// Specifies the number of threads reading the Android assets, resources and
+// content providers. Defaults to 4.
+const char kStreamReaderThreads[] = "stream-reader-threads";
+
+// Leaves the navigation errors of subframes without an error description,
+// for applications running offline whose ads or analytics iframes keep on
+// failing.
+const char kSuppressSubframeErrorPages[] = "suppress-subframe-error-pages";
+
+// Comma separated list of http(s) urls fetched in the background at startup,
+// so their responses are in the HTTP cache when the application needs them.
+const char kWarmCacheUrls[] = "warm-cache-urls";
+
+// Specifies how many installed applications have their render process kept
+// started, so they launch faster. Meant for the service mode runtime, where
+// the runtime outlives the applications.
+const char kWarmRenderProcesses[] = "warm-render-processes";
+
 const char kXWalkAllowExternalExtensionsForRemoteSources[] =
     "allow-external-extensions-for-remote-sources";
 
@@ -28,4 +109,16 @@ const char kXWalkAllowExternalExtensionsForRemoteSources[] =
 // state, e.g. cache, localStorage etc.
 const char kXWalkDataPath[] = "data-path";
 
+// Specifies a file where a performance trace of the runtime is recorded,
+// without the remote debugging server, see RuntimeTraceRecorder. The trace
+// categories, which default to the timeline ones, and the duration in
+// seconds, 10 by default, can be given too.
+const char kXWalkPerfTrace[] = "xwalk-perf-trace";
+const char kXWalkPerfTraceCategories[] = "xwalk-perf-trace-categories";
+const char kXWalkPerfTraceDuration[] = "xwalk-perf-trace-duration";
+
+// Specifies a file where the timeline of the startup is written as JSON, see
+// RuntimeStartupTimeline.
+const char kXWalkStartupTrace[] = "xwalk-startup-trace";
+
 }  // namespace switches
@@ -9,12 +9,36 @@
 namespace switches {
 
 extern const char kAppIcon[];
+extern const char kAutoAnswerJavaScriptDialogs[];
+extern const char kCacheHttpAuthCredentials[];
+extern const char kCookieCommitBatchSize[];
+extern const char kCookieCommitInterval[];
+extern const char kDisableHttp2[];
 extern const char kDisablePnacl[];
+extern const char kDiskCacheSize[];
+extern const char kEnableQuic[];
 extern const char kExperimentalFeatures[];
 extern const char kFullscreen[];
+extern const char kHttpCacheBackend[];
 extern const char kListFeaturesFlags[];
+extern const char kMaxExtensionProcesses[];
+extern const char kMaxRenderProcesses[];
+extern const char kMaxSocketsPerGroup[];
+extern const char kMaxSocketsPerPool[];
+extern const char kPerformanceProfile[];
+extern const char kPerformanceProfilesFile[];
+extern const char kRemoteDebuggingSocket[];
+extern const char kShareNetworkSession[];
+extern const char kStreamReaderThreads[];
+extern const char kSuppressSubframeErrorPages[];
+extern const char kWarmCacheUrls[];
+extern const char kWarmRenderProcesses[];
 extern const char kXWalkAllowExternalExtensionsForRemoteSources[];
 extern const char kXWalkDataPath[];
+extern const char kXWalkPerfTrace[];
+extern const char kXWalkPerfTraceCategories[];
+extern const char kXWalkPerfTraceDuration[];
+extern const char kXWalkStartupTrace[];
 
 }  // namespace switches
 
@@ -12,6 +12,7 @@
 #include "third_party/WebKit/public/web/WebCache.h"
 #include "third_party/WebKit/public/web/WebNetworkStateNotifier.h"
 #include "third_party/WebKit/public/web/WebSecurityPolicy.h"
+#include "v8/include/v8.h"
 #include "xwalk/runtime/browser/android/net/url_constants.h"
 #include "xwalk/runtime/common/android/xwalk_render_view_messages.h"
 
@@ -30,6 +31,7 @@ bool XWalkRenderProcessObserver::OnControlMessageReceived(
   IPC_BEGIN_MESSAGE_MAP(XWalkRenderProcessObserver, message)
     IPC_MESSAGE_HANDLER(XWalkViewMsg_SetJsOnlineProperty, OnSetJsOnlineProperty)
     IPC_MESSAGE_HANDLER(XWalkViewMsg_ClearCache, OnClearCache);
+    IPC_MESSAGE_HANDLER(XWalkViewMsg_TrimMemory, OnTrimMemory)
     IPC_MESSAGE_HANDLER(XWalkViewMsg_SetOriginAccessWhitelist,
                         OnSetOriginAccessWhitelist)
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -51,6 +53,14 @@ void XWalkRenderProcessObserver::OnClearCache() {
     blink::WebCache::clear();
 }
 
+void XWalkRenderProcessObserver::OnTrimMemory(bool purge_script_memory) {
+  if (!webkit_initialized_)
+    return;
+  blink::WebCache::clear();
+  if (purge_script_memory)
+    v8::Isolate::GetCurrent()->LowMemoryNotification();
+}
+
 void XWalkRenderProcessObserver::OnSetOriginAccessWhitelist(
     std::string base_url,
     std::string match_patterns) {
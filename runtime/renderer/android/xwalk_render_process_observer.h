@@ -27,6 +27,7 @@ class XWalkRenderProcessObserver : public content::RenderProcessObserver {
  private:
   void OnSetJsOnlineProperty(bool network_up);
   void OnClearCache();
+  void OnTrimMemory(bool purge_script_memory);
   void OnSetOriginAccessWhitelist(std::string base_url,
                                   std::string match_patterns);
 
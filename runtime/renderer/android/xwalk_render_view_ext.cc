@@ -4,36 +4,52 @@
 
 #include "xwalk/runtime/renderer/android/xwalk_render_view_ext.h"
 
+#include <math.h>
 #include <string>
+#include <vector>
 
 #include "base/bind.h"
+#include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/string_piece.h"
+#include "base/values.h"
 #include "content/public/common/url_constants.h"
 #include "content/public/renderer/android_content_detection_prefixes.h"
 #include "content/public/renderer/document_state.h"
 #include "content/public/renderer/render_view.h"
+#include "content/public/renderer/v8_value_converter.h"
 #include "skia/ext/refptr.h"
 #include "third_party/WebKit/public/platform/WebSize.h"
 #include "third_party/WebKit/public/platform/WebURL.h"
-#include "third_party/WebKit/public/platform/WebVector.h"
 #include "third_party/WebKit/public/web/WebDataSource.h"
 #include "third_party/WebKit/public/web/WebDocument.h"
 #include "third_party/WebKit/public/web/WebElement.h"
 #include "third_party/WebKit/public/web/WebElementCollection.h"
 #include "third_party/WebKit/public/web/WebHitTestResult.h"
+#include "third_party/WebKit/public/web/WebInputEvent.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
 #include "third_party/WebKit/public/web/WebNode.h"
 #include "third_party/WebKit/public/web/WebNodeList.h"
+#include "third_party/WebKit/public/web/WebScriptSource.h"
 #include "third_party/WebKit/public/web/WebSecurityOrigin.h"
 #include "third_party/WebKit/public/web/WebView.h"
 #include "third_party/skia/include/core/SkPicture.h"
-#include "xwalk/runtime/common/android/xwalk_hit_test_data.h"
+#include "v8/include/v8.h"
 #include "xwalk/runtime/common/android/xwalk_render_view_messages.h"
 
 namespace xwalk {
 
 namespace {
 
+// Relative changes of the page scale factor sent right away. During a pinch
+// the scale changes every frame and each change ends in a JNI call, the
+// smaller ones wait for the end of the gesture.
+const float kMinPageScaleDelta = 0.05f;
+
+// How long smaller changes wait when no gesture is going to end, e.g. during
+// the animation of a double tap zoom.
+const int kPageScaleFlushDelayMs = 100;
+
 GURL GetAbsoluteUrl(const blink::WebNode& node,
                     const base::string16& url_fragment) {
   return GURL(node.document().completeURL(url_fragment));
@@ -128,7 +144,14 @@ void PopulateHitTestData(const GURL& absolute_link_url,
 }  // namespace
 
 XWalkRenderViewExt::XWalkRenderViewExt(content::RenderView* render_view)
-    : content::RenderViewObserver(render_view), page_scale_factor_(0.0f) {
+    : content::RenderViewObserver(render_view),
+      page_scale_factor_(0.0f),
+      in_pinch_(false),
+      frame_generation_(0),
+      has_last_hit_test_(false),
+      last_hit_test_x_(0),
+      last_hit_test_y_(0),
+      last_hit_test_generation_(0) {
 }
 
 XWalkRenderViewExt::~XWalkRenderViewExt() {
@@ -144,6 +167,7 @@ bool XWalkRenderViewExt::OnMessageReceived(const IPC::Message& message) {
   IPC_BEGIN_MESSAGE_MAP(XWalkRenderViewExt, message)
     IPC_MESSAGE_HANDLER(XWalkViewMsg_DocumentHasImages,
                         OnDocumentHasImagesRequest)
+    IPC_MESSAGE_HANDLER(XWalkViewMsg_ExecuteJavaScripts, OnExecuteJavaScripts)
     IPC_MESSAGE_HANDLER(XWalkViewMsg_DoHitTest, OnDoHitTest)
     IPC_MESSAGE_HANDLER(XWalkViewMsg_SetTextZoomLevel, OnSetTextZoomLevel)
     IPC_MESSAGE_HANDLER(XWalkViewMsg_ResetScrollAndScaleState,
@@ -155,21 +179,57 @@ bool XWalkRenderViewExt::OnMessageReceived(const IPC::Message& message) {
 }
 
 void XWalkRenderViewExt::OnDocumentHasImagesRequest(int id) {
+  TRACE_EVENT0("xwalk", "XWalkRenderViewExt::OnDocumentHasImagesRequest");
+  base::TimeTicks start_time = base::TimeTicks::Now();
   bool hasImages = false;
   if (render_view()) {
     blink::WebView* webview = render_view()->GetWebView();
     if (webview) {
-      blink::WebVector<blink::WebElement> images;
-      webview->mainFrame()->document().images(images);
-      hasImages = !images.isEmpty();
+      // The collection is live, finding its first item stops the walk of
+      // the DOM at the first image instead of collecting all of them.
+      blink::WebElementCollection images =
+          webview->mainFrame()->document().getElementsByTagName("img");
+      hasImages = !images.firstItem().isNull();
     }
   }
+  UMA_HISTOGRAM_TIMES("XWalk.DocumentHasImages.Time",
+                      base::TimeTicks::Now() - start_time);
   Send(new XWalkViewHostMsg_DocumentHasImagesResponse(routing_id(), id,
                                                    hasImages));
 }
 
+void XWalkRenderViewExt::OnExecuteJavaScripts(
+    const std::vector<int>& ids,
+    const std::vector<base::string16>& scripts) {
+  TRACE_EVENT1("xwalk", "XWalkRenderViewExt::OnExecuteJavaScripts",
+               "count", scripts.size());
+  base::ListValue results;
+  blink::WebView* webview = render_view()->GetWebView();
+  if (webview) {
+    blink::WebFrame* frame = webview->mainFrame();
+    v8::Isolate* isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope handle_scope(isolate);
+    v8::Handle<v8::Context> context = frame->mainWorldScriptContext();
+    v8::Context::Scope context_scope(context);
+    scoped_ptr<content::V8ValueConverter> converter(
+        content::V8ValueConverter::create());
+    converter->SetDateAllowed(true);
+    converter->SetRegExpAllowed(true);
+    for (size_t i = 0; i < scripts.size(); ++i) {
+      v8::Handle<v8::Value> result = frame->executeScriptAndReturnValue(
+          blink::WebScriptSource(scripts[i]));
+      base::Value* value = NULL;
+      if (!result.IsEmpty())
+        value = converter->FromV8Value(result, context);
+      results.Append(value ? value : base::Value::CreateNullValue());
+    }
+  }
+  Send(new XWalkViewHostMsg_JavaScriptResults(routing_id(), ids, results));
+}
+
 void XWalkRenderViewExt::DidCommitProvisionalLoad(blink::WebLocalFrame* frame,
                                                   bool is_new_navigation) {
+  ++frame_generation_;
   content::DocumentState* document_state =
       content::DocumentState::FromDataSource(frame->dataSource());
   if (document_state->can_load_local_resources()) {
@@ -179,17 +239,54 @@ void XWalkRenderViewExt::DidCommitProvisionalLoad(blink::WebLocalFrame* frame,
 }
 
 void XWalkRenderViewExt::DidCommitCompositorFrame() {
+  ++frame_generation_;
   UpdatePageScaleFactor();
 }
 
+void XWalkRenderViewExt::DidHandleGestureEvent(
+    const blink::WebGestureEvent& event) {
+  if (event.type == blink::WebInputEvent::GesturePinchBegin) {
+    in_pinch_ = true;
+  } else if (event.type == blink::WebInputEvent::GesturePinchEnd) {
+    in_pinch_ = false;
+    SendPageScaleFactor();
+  }
+}
+
 void XWalkRenderViewExt::UpdatePageScaleFactor() {
-  if (page_scale_factor_ != render_view()->GetWebView()->pageScaleFactor()) {
-    page_scale_factor_ = render_view()->GetWebView()->pageScaleFactor();
-    Send(new XWalkViewHostMsg_PageScaleFactorChanged(routing_id(),
-                                                  page_scale_factor_));
+  float page_scale_factor = render_view()->GetWebView()->pageScaleFactor();
+  if (page_scale_factor == page_scale_factor_) {
+    page_scale_timer_.Stop();
+    return;
+  }
+
+  if (page_scale_factor_ == 0.0f ||
+      fabs(page_scale_factor - page_scale_factor_) >=
+          page_scale_factor_ * kMinPageScaleDelta) {
+    SendPageScaleFactor();
+    return;
+  }
+
+  if (!in_pinch_ && !page_scale_timer_.IsRunning()) {
+    page_scale_timer_.Start(FROM_HERE,
+        base::TimeDelta::FromMilliseconds(kPageScaleFlushDelayMs),
+        this, &XWalkRenderViewExt::SendPageScaleFactor);
   }
 }
 
+void XWalkRenderViewExt::SendPageScaleFactor() {
+  page_scale_timer_.Stop();
+  if (!render_view() || !render_view()->GetWebView())
+    return;
+
+  float page_scale_factor = render_view()->GetWebView()->pageScaleFactor();
+  if (page_scale_factor == page_scale_factor_)
+    return;
+  page_scale_factor_ = page_scale_factor;
+  Send(new XWalkViewHostMsg_PageScaleFactorChanged(routing_id(),
+                                                   page_scale_factor_));
+}
+
 void XWalkRenderViewExt::FocusedNodeChanged(const blink::WebNode& node) {
   if (node.isNull() || !node.isElementNode() || !render_view())
     return;
@@ -223,6 +320,19 @@ void XWalkRenderViewExt::OnDoHitTest(int view_x, int view_y) {
   if (!render_view() || !render_view()->GetWebView())
     return;
 
+  TRACE_EVENT0("xwalk", "XWalkRenderViewExt::OnDoHitTest");
+  bool cache_hit = has_last_hit_test_ &&
+                   last_hit_test_x_ == view_x &&
+                   last_hit_test_y_ == view_y &&
+                   last_hit_test_generation_ == frame_generation_;
+  UMA_HISTOGRAM_BOOLEAN("XWalk.HitTest.CacheHit", cache_hit);
+  if (cache_hit) {
+    Send(new XWalkViewHostMsg_UpdateHitTestData(routing_id(),
+                                                last_hit_test_data_));
+    return;
+  }
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
   const blink::WebHitTestResult result =
       render_view()->GetWebView()->hitTestResultAt(
           blink::WebPoint(view_x, view_y));
@@ -237,6 +347,14 @@ void XWalkRenderViewExt::OnDoHitTest(int view_x, int view_y) {
                       result.absoluteImageURL(),
                       result.isContentEditable(),
                       &data);
+  UMA_HISTOGRAM_TIMES("XWalk.HitTest.Time",
+                      base::TimeTicks::Now() - start_time);
+
+  has_last_hit_test_ = true;
+  last_hit_test_x_ = view_x;
+  last_hit_test_y_ = view_y;
+  last_hit_test_generation_ = frame_generation_;
+  last_hit_test_data_ = data;
   Send(new XWalkViewHostMsg_UpdateHitTestData(routing_id(), data));
 }
 
@@ -5,13 +5,19 @@
 #ifndef XWALK_RUNTIME_RENDERER_ANDROID_XWALK_RENDER_VIEW_EXT_H_
 #define XWALK_RUNTIME_RENDERER_ANDROID_XWALK_RENDER_VIEW_EXT_H_
 
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/strings/string16.h"
+#include "base/timer/timer.h"
 #include "content/public/renderer/render_view_observer.h"
 #include "third_party/WebKit/public/web/WebPermissionClient.h"
+#include "xwalk/runtime/common/android/xwalk_hit_test_data.h"
 
 namespace blink {
 
+class WebGestureEvent;
 class WebNode;
 class WebURL;
 
@@ -36,9 +42,16 @@ class XWalkRenderViewExt : public content::RenderViewObserver {
                                         bool is_new_navigation) OVERRIDE;
   virtual void FocusedNodeChanged(const blink::WebNode& node) OVERRIDE;
   virtual void DidCommitCompositorFrame() OVERRIDE;
+  virtual void DidHandleGestureEvent(
+      const blink::WebGestureEvent& event) OVERRIDE;
 
   void OnDocumentHasImagesRequest(int id);
 
+  // Runs the batch in a single task, the page doesn't get to run anything
+  // in between the scripts.
+  void OnExecuteJavaScripts(const std::vector<int>& ids,
+                            const std::vector<base::string16>& scripts);
+
   void OnDoHitTest(int view_x, int view_y);
 
   void OnSetTextZoomLevel(double zoom_level);
@@ -47,11 +60,29 @@ class XWalkRenderViewExt : public content::RenderViewObserver {
 
   void OnSetInitialPageScale(double page_scale_factor);
 
+  // Sends the page scale factor if it changed significantly since it was
+  // last sent. Smaller changes are sent once the pinch ends, or after a
+  // short delay if no pinch is in progress.
   void UpdatePageScaleFactor();
+  void SendPageScaleFactor();
 
   bool capture_picture_enabled_;
 
+  // Bumped whenever what is under a point may have changed: on each load
+  // and each committed compositor frame. A hit test at the same point in
+  // the same generation answers with |last_hit_test_data_|, the browser
+  // asks again for the same long press, e.g. for the focus node href.
+  uint32 frame_generation_;
+  bool has_last_hit_test_;
+  int last_hit_test_x_;
+  int last_hit_test_y_;
+  uint32 last_hit_test_generation_;
+  XWalkHitTestData last_hit_test_data_;
+
+  // The last page scale factor sent to the browser.
   float page_scale_factor_;
+  bool in_pinch_;
+  base::OneShotTimer<XWalkRenderViewExt> page_scale_timer_;
 
   DISALLOW_COPY_AND_ASSIGN(XWalkRenderViewExt);
 };
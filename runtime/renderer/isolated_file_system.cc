@@ -2,16 +2,22 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <limits>
 #include <string>
 
 #include "xwalk/runtime/renderer/isolated_file_system.h"
 
+#include "base/files/file.h"
+#include "base/files/file_path.h"
 #include "base/logging.h"
+#include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
 #include "content/public/renderer/v8_value_converter.h"
 #include "third_party/WebKit/public/platform/WebFileSystem.h"
 #include "third_party/WebKit/public/platform/WebFileSystemType.h"
 #include "third_party/WebKit/public/platform/WebString.h"
+#include "third_party/WebKit/public/web/WebArrayBuffer.h"
 #include "third_party/WebKit/public/web/WebDataSource.h"
 #include "third_party/WebKit/public/web/WebDOMError.h"
 #include "third_party/WebKit/public/web/WebDOMFileSystem.h"
@@ -22,6 +28,7 @@
 #include "webkit/common/fileapi/file_system_types.h"
 #include "webkit/common/fileapi/file_system_util.h"
 #include "xwalk/extensions/renderer/xwalk_module_system.h"
+#include "xwalk/runtime/common/xwalk_common_messages.h"
 
 using content::RenderView;
 using blink::WebFrame;
@@ -77,6 +84,57 @@ void IsolatedFileSystem::GetIsolatedFileSystem(
       root).toV8Value(isolate->GetCurrentContext()->Global(), isolate));
 }
 
+void IsolatedFileSystem::MapFile(
+    const v8::FunctionCallbackInfo<v8::Value>& info) {
+#if defined(OS_POSIX)
+  if (info.Length() != 2 || !info[0]->IsString() || !info[1]->IsString())
+    return;
+
+  IPC::PlatformFileForTransit transit_file;
+  content::RenderThread::Get()->Send(new ViewHostMsg_OpenIsolatedFile(
+      std::string(*v8::String::Utf8Value(info[0])),
+      base::FilePath::FromUTF8Unsafe(*v8::String::Utf8Value(info[1])),
+      &transit_file));
+  base::File file(IPC::PlatformFileForTransitToPlatformFile(transit_file));
+  if (!file.IsValid())
+    return;
+
+  v8::Isolate* isolate = info.GetIsolate();
+  base::File::Info file_info;
+  if (!file.GetInfo(&file_info) || file_info.is_directory ||
+      file_info.size < 0 ||
+      static_cast<uint64_t>(file_info.size) >
+          std::numeric_limits<size_t>::max())
+    return;
+  if (!file_info.size) {
+    info.GetReturnValue().Set(v8::ArrayBuffer::New(isolate, 0));
+    return;
+  }
+
+  // Allocated by Blink, which only takes the ArrayBuffers it allocated, e.g.
+  // for Blobs, XHRs or WebGL. Read at once rather than mapped, so that a file
+  // truncated later doesn't fault in the page.
+  size_t size = static_cast<size_t>(file_info.size);
+  if (size > std::numeric_limits<unsigned>::max())
+    return;
+  blink::WebArrayBuffer buffer = blink::WebArrayBuffer::create(size, 1);
+  if (buffer.isNull())
+    return;
+  char* data = static_cast<char*>(buffer.data());
+  size_t read = 0;
+  while (read < size) {
+    int rv = file.Read(read, data + read,
+                       std::min(size - read, static_cast<size_t>(
+                           std::numeric_limits<int>::max())));
+    if (rv <= 0)
+      return;
+    read += rv;
+  }
+  info.GetReturnValue().Set(buffer.toV8Value(
+      isolate->GetCurrentContext()->Global(), isolate));
+#endif
+}
+
 IsolatedFileSystem::IsolatedFileSystem() {
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::HandleScope handle_scope(isolate);
@@ -93,6 +151,12 @@ IsolatedFileSystem::IsolatedFileSystem() {
       v8::FunctionTemplate::New(isolate,
                                 &IsolatedFileSystem::GetIsolatedFileSystem,
                                 function_data));
+  object_template->Set(
+      isolate,
+      "mapFile",
+      v8::FunctionTemplate::New(isolate,
+                                &IsolatedFileSystem::MapFile,
+                                function_data));
 
   function_data_.Reset(isolate, function_data);
   object_template_.Reset(isolate, object_template);
@@ -20,6 +20,11 @@ class IsolatedFileSystem: public xwalk::extensions::XWalkNativeModule {
  private:
   virtual v8::Handle<v8::Object> NewInstance() OVERRIDE;
   static void GetIsolatedFileSystem(const v8::FunctionCallbackInfo<v8::Value>&);
+  // mapFile(file_system_id, path) returns an ArrayBuffer backed by a private
+  // mapping of the file, whose pages are read from the page cache on demand
+  // instead of being copied through the browser. Writes to the buffer stay
+  // in the renderer. Returns undefined if the file can't be mapped.
+  static void MapFile(const v8::FunctionCallbackInfo<v8::Value>& info);
 
   v8::Persistent<v8::ObjectTemplate> object_template_;
   v8::Persistent<v8::Object> function_data_;
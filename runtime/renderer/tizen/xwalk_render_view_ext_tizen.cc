@@ -7,6 +7,7 @@
 #include <string>
 
 #include "base/bind.h"
+#include "base/json/string_escape.h"
 #include "base/strings/utf_string_conversions.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_view.h"
@@ -38,6 +39,19 @@ std::string GenerateEventJs(const std::string& name) {
 
   return result;
 }
+
+// Same as the "languagechange" event of the HTML spec, plus the new locale.
+std::string GenerateLocaleChangeEventJs(const std::string& locale) {
+  return
+    "var event = new Event('languagechange');"
+    "Object.defineProperty(event, 'locale', {"
+    "  enumerable: false,"
+    "  configurable: false,"
+    "  writable: false,"
+    "  value: " + base::GetQuotedJSONString(locale) +
+    "});"
+    "window.dispatchEvent(event);";
+}
 }  // namespace
 
 namespace xwalk {
@@ -63,6 +77,8 @@ bool XWalkRenderViewExtTizen::OnMessageReceived(const IPC::Message& message) {
   IPC_BEGIN_MESSAGE_MAP(XWalkRenderViewExtTizen, message)
     IPC_MESSAGE_HANDLER(ViewMsg_HWKeyPressed,
                         OnHWKeyPressed)
+    IPC_MESSAGE_HANDLER(ViewMsg_LocaleChanged,
+                        OnLocaleChanged)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
@@ -87,4 +103,11 @@ void XWalkRenderViewExtTizen::OnHWKeyPressed(int keycode) {
   web_frame->executeScript(source);
 }
 
+void XWalkRenderViewExtTizen::OnLocaleChanged(const std::string& locale) {
+  content::RenderFrame* render_frame = render_view_->GetMainRenderFrame();
+  blink::WebFrame* web_frame = render_frame->GetWebFrame();
+  web_frame->executeScript(blink::WebScriptSource(
+      base::UTF8ToUTF16(GenerateLocaleChangeEventJs(locale))));
+}
+
 }  // namespace xwalk
@@ -5,6 +5,8 @@
 #ifndef XWALK_RUNTIME_RENDERER_TIZEN_XWALK_RENDER_VIEW_EXT_TIZEN_H_
 #define XWALK_RUNTIME_RENDERER_TIZEN_XWALK_RENDER_VIEW_EXT_TIZEN_H_
 
+#include <string>
+
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "content/public/renderer/render_view_observer.h"
@@ -23,6 +25,7 @@ class XWalkRenderViewExtTizen : public content::RenderViewObserver {
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
 
   void OnHWKeyPressed(int keycode);
+  void OnLocaleChanged(const std::string& locale);
 
   content::RenderView* render_view_;
   DISALLOW_COPY_AND_ASSIGN(XWalkRenderViewExtTizen);
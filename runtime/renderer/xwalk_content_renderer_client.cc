@@ -17,12 +17,15 @@
 #include "third_party/WebKit/public/platform/WebString.h"
 #include "third_party/WebKit/public/platform/WebURLRequest.h"
 #include "third_party/WebKit/public/web/WebDocument.h"
+#include "third_party/WebKit/public/web/WebFrame.h"
 #include "third_party/WebKit/public/web/WebSecurityPolicy.h"
 #include "xwalk/application/common/constants.h"
 #include "xwalk/application/renderer/application_native_module.h"
 #include "xwalk/extensions/common/xwalk_extension_switches.h"
 #include "xwalk/extensions/renderer/xwalk_js_module.h"
+#include "xwalk/runtime/common/xwalk_common_messages.h"
 #include "xwalk/runtime/common/xwalk_localized_error.h"
+#include "xwalk/runtime/common/xwalk_switches.h"
 #include "xwalk/runtime/renderer/isolated_file_system.h"
 #include "xwalk/runtime/renderer/pepper/pepper_helper.h"
 
@@ -31,12 +34,6 @@
 #include "xwalk/runtime/renderer/android/xwalk_permission_client.h"
 #include "xwalk/runtime/renderer/android/xwalk_render_process_observer.h"
 #include "xwalk/runtime/renderer/android/xwalk_render_view_ext.h"
-#else
-#include "third_party/WebKit/public/web/WebFrame.h"
-#endif
-
-#if defined(OS_TIZEN)
-#include "xwalk/runtime/common/xwalk_common_messages.h"
 #endif
 
 #if defined(OS_TIZEN_MOBILE)
@@ -96,7 +93,8 @@ XWalkContentRendererClient* XWalkContentRendererClient::Get() {
   return g_renderer_client;
 }
 
-XWalkContentRendererClient::XWalkContentRendererClient() {
+XWalkContentRendererClient::XWalkContentRendererClient()
+    : created_script_context_(false) {
   DCHECK(!g_renderer_client);
   g_renderer_client = this;
 }
@@ -119,6 +117,10 @@ void XWalkContentRendererClient::RenderThreadStarted() {
   content::RenderThread* thread = content::RenderThread::Get();
   xwalk_render_process_observer_.reset(new XWalkRenderProcessObserver);
   thread->AddObserver(xwalk_render_process_observer_.get());
+#if !defined(OS_ANDROID)
+  xwalk_render_process_observer_->set_extension_controller(
+      extension_controller_.get());
+#endif
 #if defined(OS_ANDROID)
   blink::WebString content_scheme(
       base::ASCIIToUTF16(xwalk::kContentScheme));
@@ -155,10 +157,11 @@ void XWalkContentRendererClient::DidCreateScriptContext(
     int extension_group, int world_id) {
   if (extension_controller_)
     extension_controller_->DidCreateScriptContext(frame, context);
-#if !defined(OS_ANDROID)
-  xwalk_render_process_observer_->DidCreateScriptContext(
-      frame, context, extension_group, world_id);
-#endif
+  if (!created_script_context_) {
+    created_script_context_ = true;
+    content::RenderThread::Get()->Send(
+        new ViewHostMsg_DidCreateFirstScriptContext);
+  }
 }
 
 void XWalkContentRendererClient::DidCreateModuleSystem(
@@ -232,6 +235,7 @@ bool XWalkContentRendererClient::WillSendRequest(blink::WebFrame* frame,
         origin_url != first_party_for_cookies &&
         !first_party_for_cookies.is_empty() &&
         first_party_for_cookies.GetOrigin() != app_url.GetOrigin() &&
+        !xwalk_render_process_observer_->IsAccessAllowed(url) &&
         !blink::WebSecurityOrigin::create(app_url).canRequest(url)) {
       LOG(INFO) << "[BLOCK] allow-navigation: " << url.spec();
       content::RenderThread::Get()->Send(new ViewMsg_OpenLinkExternal(url));
@@ -243,6 +247,8 @@ bool XWalkContentRendererClient::WillSendRequest(blink::WebFrame* frame,
 #endif
   // if under WARP mode.
   if (url.GetOrigin() == app_url.GetOrigin() ||
+      (origin_url.GetOrigin() == app_url.GetOrigin() &&
+       xwalk_render_process_observer_->IsAccessAllowed(url)) ||
       frame->document().securityOrigin().canRequest(url)) {
     LOG(INFO) << "[PASS] " << origin_url.spec() << " request " << url.spec();
     return false;
@@ -268,6 +274,10 @@ void XWalkContentRendererClient::GetNavigationErrorStrings(
     const blink::WebURLError& error,
     std::string* error_html,
     base::string16* error_description) {
+  if (frame->parent() && CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kSuppressSubframeErrorPages))
+    return;
+
   bool is_post = EqualsASCII(failed_request.httpMethod(), "POST");
 
   // TODO(guangzhen): Check whether error_html is needed in xwalk runtime.
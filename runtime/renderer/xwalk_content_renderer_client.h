@@ -70,6 +70,9 @@ class XWalkContentRendererClient
       extension_controller_;
 
   scoped_ptr<XWalkRenderProcessObserver> xwalk_render_process_observer_;
+  // Whether the browser was told about the first script context, see
+  // RuntimeStartupTimeline.
+  bool created_script_context_;
 #if defined(OS_ANDROID)
   scoped_ptr<visitedlink::VisitedLinkSlave> visited_link_slave_;
 #endif
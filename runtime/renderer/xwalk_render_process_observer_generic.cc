@@ -9,43 +9,37 @@
 #include "content/renderer/render_thread_impl.h"
 #include "content/renderer/renderer_webkitplatformsupport_impl.h"
 #include "ipc/ipc_message_macros.h"
+#include "third_party/WebKit/public/web/WebCache.h"
 #include "third_party/WebKit/public/web/WebSecurityPolicy.h"
 #include "third_party/WebKit/public/platform/WebString.h"
+#include "v8/include/v8.h"
+#include "xwalk/extensions/renderer/xwalk_extension_renderer_controller.h"
 #include "xwalk/runtime/common/xwalk_common_messages.h"
 
 
 namespace xwalk {
-namespace {
-struct AccessWhitelistItem {
-  AccessWhitelistItem(
-      const GURL& source, const GURL& dest, bool allow_subdomains);
-  GURL source_;
-  GURL dest_;
-  bool allow_subdomains_;
-};
-
-AccessWhitelistItem::AccessWhitelistItem(
+
+XWalkRenderProcessObserver::AccessWhitelistEntry::AccessWhitelistEntry(
     const GURL& source, const GURL& dest, bool allow_subdomains)
-    : source_(source),
-      dest_(dest),
-      allow_subdomains_(allow_subdomains) {
+    : source(source),
+      dest(dest),
+      allow_subdomains(allow_subdomains) {
 }
 
-std::vector<AccessWhitelistItem> access_whitelist;
-
-void AddAccessWhiteListEntry(
-    const GURL& source, const GURL& dest, bool allow_subdomains) {
+// static
+void XWalkRenderProcessObserver::AddOriginAccessWhitelistEntry(
+    const AccessWhitelistEntry& entry) {
   blink::WebSecurityPolicy::addOriginAccessWhitelistEntry(
-      source.GetOrigin(),
-      blink::WebString::fromUTF8(dest.scheme()),
-      blink::WebString::fromUTF8(dest.HostNoBrackets()),
-      allow_subdomains);
+      entry.source.GetOrigin(),
+      blink::WebString::fromUTF8(entry.dest.scheme()),
+      blink::WebString::fromUTF8(entry.dest.HostNoBrackets()),
+      entry.allow_subdomains);
 }
-}  // namespace
 
 XWalkRenderProcessObserver::XWalkRenderProcessObserver()
     : is_webkit_initialized_(false),
       is_suspended_(false),
+      extension_controller_(NULL),
       security_mode_(application::SecurityPolicy::NoSecurity) {
 }
 
@@ -66,30 +60,27 @@ bool XWalkRenderProcessObserver::OnControlMessageReceived(
 
 void XWalkRenderProcessObserver::WebKitInitialized() {
   is_webkit_initialized_ = true;
+  for (size_t i = 0; i < pending_whitelist_entries_.size(); ++i)
+    AddOriginAccessWhitelistEntry(pending_whitelist_entries_[i]);
+  pending_whitelist_entries_.clear();
 }
 
 void XWalkRenderProcessObserver::OnRenderProcessShutdown() {
   is_webkit_initialized_ = false;
 }
 
-void XWalkRenderProcessObserver::DidCreateScriptContext(
-    blink::WebFrame* frame, v8::Handle<v8::Context> context,
-    int extension_group, int world_id) {
-  for (std::vector<AccessWhitelistItem>::iterator it = access_whitelist.begin();
-       it != access_whitelist.end(); ++it)
-    AddAccessWhiteListEntry(it->source_, it->dest_, it->allow_subdomains_);
-
-  access_whitelist.clear();
-}
-
 void XWalkRenderProcessObserver::OnSetAccessWhiteList(const GURL& source,
                                                       const GURL& dest,
                                                       bool allow_subdomains) {
+  // WebKit would keep the duplicates, and check them all on every request.
+  if (!access_whitelist_.AddEntry(dest, allow_subdomains))
+    return;
+
+  AccessWhitelistEntry entry(source, dest, allow_subdomains);
   if (is_webkit_initialized_)
-    AddAccessWhiteListEntry(source, dest, allow_subdomains);
+    AddOriginAccessWhitelistEntry(entry);
   else
-    access_whitelist.push_back(
-        AccessWhitelistItem(source, dest, allow_subdomains));
+    pending_whitelist_entries_.push_back(entry);
 }
 
 void XWalkRenderProcessObserver::OnEnableSecurityMode(
@@ -103,11 +94,23 @@ void XWalkRenderProcessObserver::OnSuspendJSEngine(bool is_suspend) {
     return;
   content::RenderThreadImpl* thread = content::RenderThreadImpl::current();
   thread->EnsureWebKitInitialized();
-  if (is_suspend)
-    thread->webkit_platform_support()->SuspendSharedTimer();
-  else
-    thread->webkit_platform_support()->ResumeSharedTimer();
   is_suspended_ = is_suspend;
+  if (!is_suspend) {
+    // The messages the extensions posted in the meantime go first.
+    if (extension_controller_)
+      extension_controller_->ResumeExtensionMessages();
+    thread->webkit_platform_support()->ResumeSharedTimer();
+    return;
+  }
+
+  thread->webkit_platform_support()->SuspendSharedTimer();
+  if (extension_controller_)
+    extension_controller_->SuspendExtensionMessages();
+  // Hibernated applications give back what they can rebuild when resumed:
+  // the decoded resources and the slack of the V8 heap. The compositor
+  // releases the tiles and GPU resources of the hidden views itself.
+  blink::WebCache::clear();
+  v8::Isolate::GetCurrent()->LowMemoryNotification();
 }
 
 }  // namespace xwalk
@@ -6,19 +6,20 @@
 #define XWALK_RUNTIME_RENDERER_XWALK_RENDER_PROCESS_OBSERVER_GENERIC_H_
 
 #include <string>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "content/public/renderer/render_process_observer.h"
 #include "url/gurl.h"
-#include "v8/include/v8.h"
+#include "xwalk/application/common/access_whitelist.h"
 #include "xwalk/application/common/security_policy.h"
 
-namespace blink {
-class WebFrame;
-}  // namespace blink
-
 namespace xwalk {
 
+namespace extensions {
+class XWalkExtensionRendererController;
+}
+
 // FIXME: Using filename "xwalk_render_process_observer_generic.cc(h)" temporary
 // , due to the conflict filename with Android port.
 // A RenderViewObserver implementation used for handling XWalkView
@@ -28,10 +29,6 @@ class XWalkRenderProcessObserver : public content::RenderProcessObserver {
   XWalkRenderProcessObserver();
   virtual ~XWalkRenderProcessObserver();
 
-  void DidCreateScriptContext(
-      blink::WebFrame* frame,  v8::Handle<v8::Context> context,
-      int extension_group, int world_id);
-
   // content::RenderProcessObserver implementation.
   virtual bool OnControlMessageReceived(const IPC::Message& message) OVERRIDE;
   virtual void WebKitInitialized() OVERRIDE;
@@ -46,6 +43,19 @@ class XWalkRenderProcessObserver : public content::RenderProcessObserver {
 
   const GURL& app_url() const { return app_url_; }
 
+  // Its messages to JS are held while the application is hibernated. NULL
+  // when the extensions are disabled.
+  void set_extension_controller(
+      extensions::XWalkExtensionRendererController* controller) {
+    extension_controller_ = controller;
+  }
+
+  // Whether the application was granted access to |url|, without going
+  // through the origin access lists of WebKit.
+  bool IsAccessAllowed(const GURL& url) const {
+    return access_whitelist_.IsAllowed(url);
+  }
+
  private:
   void OnSetAccessWhiteList(
       const GURL& source, const GURL& dest, bool allow_subdomains);
@@ -53,10 +63,26 @@ class XWalkRenderProcessObserver : public content::RenderProcessObserver {
       const GURL& url, application::SecurityPolicy::SecurityMode mode);
   void OnSuspendJSEngine(bool is_pause);
 
+  // The origin access lists of WebKit are process wide, each entry is added
+  // once, when it arrives or when WebKit is initialized, whatever the number
+  // of frames.
+  struct AccessWhitelistEntry {
+    AccessWhitelistEntry(const GURL& source, const GURL& dest,
+                         bool allow_subdomains);
+    GURL source;
+    GURL dest;
+    bool allow_subdomains;
+  };
+  static void AddOriginAccessWhitelistEntry(const AccessWhitelistEntry& entry);
+
   bool is_webkit_initialized_;
   bool is_suspended_;
+  extensions::XWalkExtensionRendererController* extension_controller_;
   application::SecurityPolicy::SecurityMode security_mode_;
   GURL app_url_;
+  application::AccessWhitelist access_whitelist_;
+  // Received before WebKit was initialized.
+  std::vector<AccessWhitelistEntry> pending_whitelist_entries_;
 };
 }  // namespace xwalk
 
@@ -25,7 +25,7 @@ class BindingObject {
   BindingObject() : handler_(NULL) {}
   virtual ~BindingObject() {}
 
-  bool HandleFunction(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  virtual bool HandleFunction(scoped_ptr<XWalkExtensionFunctionInfo> info) {
     return handler_.HandleFunction(info.Pass());
   }
 
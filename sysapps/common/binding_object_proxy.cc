@@ -0,0 +1,92 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/common/binding_object_proxy.h"
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/time/time.h"
+
+namespace xwalk {
+namespace sysapps {
+
+// Owns the object on its thread and keeps track of how long calls waited
+// to reach it.
+class BindingObjectProxy::Core {
+ public:
+  Core() : calls_(0) {}
+
+  ~Core() {
+    if (calls_) {
+      VLOG(1) << calls_ << " calls forwarded, average delay "
+          << (total_delay_ / calls_).InMicroseconds() << " us, max "
+          << max_delay_.InMicroseconds() << " us";
+    }
+  }
+
+  void Create(const ObjectFactory& factory) {
+    object_.reset(factory.Run());
+  }
+
+  void set_object(scoped_ptr<BindingObject> object) {
+    object_ = object.Pass();
+  }
+
+  void HandleFunction(base::TimeTicks posted_time,
+                      scoped_ptr<XWalkExtensionFunctionInfo> info) {
+    const base::TimeDelta delay = base::TimeTicks::Now() - posted_time;
+    total_delay_ += delay;
+    if (delay > max_delay_)
+      max_delay_ = delay;
+    ++calls_;
+
+    const std::string name = info->name();
+    if (!object_ || !object_->HandleFunction(info.Pass()))
+      DLOG(WARNING) << "Function not registered: " << name;
+  }
+
+ private:
+  scoped_ptr<BindingObject> object_;
+
+  int64 calls_;
+  base::TimeDelta total_delay_;
+  base::TimeDelta max_delay_;
+
+  DISALLOW_COPY_AND_ASSIGN(Core);
+};
+
+BindingObjectProxy::BindingObjectProxy(
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+    const ObjectFactory& factory)
+    : task_runner_(task_runner),
+      core_(new Core) {
+  task_runner_->PostTask(FROM_HERE,
+      base::Bind(&Core::Create, base::Unretained(core_), factory));
+}
+
+BindingObjectProxy::BindingObjectProxy(
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+    scoped_ptr<BindingObject> object)
+    : task_runner_(task_runner),
+      core_(new Core) {
+  core_->set_object(object.Pass());
+}
+
+BindingObjectProxy::~BindingObjectProxy() {
+  // Runs after every call already forwarded.
+  task_runner_->DeleteSoon(FROM_HERE, core_);
+}
+
+bool BindingObjectProxy::HandleFunction(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  // Whether the function exists is only known on the other thread.
+  task_runner_->PostTask(FROM_HERE,
+      base::Bind(&Core::HandleFunction, base::Unretained(core_),
+                 base::TimeTicks::Now(), base::Passed(&info)));
+  return true;
+}
+
+}  // namespace sysapps
+}  // namespace xwalk
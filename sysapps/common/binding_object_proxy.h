@@ -0,0 +1,53 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_SYSAPPS_COMMON_BINDING_OBJECT_PROXY_H_
+#define XWALK_SYSAPPS_COMMON_BINDING_OBJECT_PROXY_H_
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/single_thread_task_runner.h"
+#include "xwalk/sysapps/common/binding_object.h"
+
+namespace xwalk {
+namespace sysapps {
+
+// Stands in the BindingObjectStore for a BindingObject living on another
+// thread, so a busy object doesn't hold back the thread of the extension.
+// Function calls are forwarded in order to |task_runner|, and the object is
+// created and destroyed there as well. Replies and events need no proxying,
+// PostResult() can be called from any thread.
+class BindingObjectProxy : public BindingObject {
+ public:
+  typedef base::Callback<BindingObject*()> ObjectFactory;
+
+  // Runs |factory| on |task_runner| to create the object.
+  BindingObjectProxy(scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+                     const ObjectFactory& factory);
+
+  // Takes an object created on |task_runner|. Can be called from any thread.
+  BindingObjectProxy(scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+                     scoped_ptr<BindingObject> object);
+
+  virtual ~BindingObjectProxy();
+
+  // BindingObject implementation.
+  virtual bool HandleFunction(
+      scoped_ptr<XWalkExtensionFunctionInfo> info) OVERRIDE;
+
+ private:
+  class Core;
+
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+  // Only used on |task_runner_|, where it is deleted.
+  Core* core_;
+
+  DISALLOW_COPY_AND_ASSIGN(BindingObjectProxy);
+};
+
+}  // namespace sysapps
+}  // namespace xwalk
+
+#endif  // XWALK_SYSAPPS_COMMON_BINDING_OBJECT_PROXY_H_
@@ -0,0 +1,87 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/common/binding_object_proxy.h"
+
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::extensions::XWalkExtensionFunctionInfo;
+using xwalk::sysapps::BindingObject;
+using xwalk::sysapps::BindingObjectProxy;
+
+namespace {
+
+void DummyCallback(scoped_ptr<base::ListValue> result) {}
+
+scoped_ptr<XWalkExtensionFunctionInfo> CreateFunctionInfo(
+    const std::string& name) {
+  return make_scoped_ptr(new XWalkExtensionFunctionInfo(
+      name,
+      make_scoped_ptr(new base::ListValue),
+      base::Bind(&DummyCallback)));
+}
+
+// Checks everything happens on |thread_id|.
+class ThreadBoundObject : public BindingObject {
+ public:
+  static BindingObject* Create(base::PlatformThreadId thread_id) {
+    return new ThreadBoundObject(thread_id);
+  }
+
+  explicit ThreadBoundObject(base::PlatformThreadId thread_id)
+      : thread_id_(thread_id) {
+    EXPECT_EQ(thread_id_, base::PlatformThread::CurrentId());
+    instance_count_++;
+
+    handler_.Register("test",
+        base::Bind(&ThreadBoundObject::OnTest, base::Unretained(this)));
+  }
+
+  virtual ~ThreadBoundObject() {
+    EXPECT_EQ(thread_id_, base::PlatformThread::CurrentId());
+    instance_count_--;
+  }
+
+  static int instance_count() { return instance_count_; }
+  static int call_count() { return call_count_; }
+
+ private:
+  void OnTest(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+    EXPECT_EQ(thread_id_, base::PlatformThread::CurrentId());
+    call_count_++;
+  }
+
+  base::PlatformThreadId thread_id_;
+
+  static int instance_count_;
+  static int call_count_;
+};
+
+int ThreadBoundObject::instance_count_ = 0;
+int ThreadBoundObject::call_count_ = 0;
+
+}  // namespace
+
+TEST(XWalkSysAppsBindingObjectProxyTest, ForwardsToThread) {
+  base::Thread thread("BindingObjectProxyTest");
+  ASSERT_TRUE(thread.Start());
+
+  scoped_ptr<BindingObject> proxy(new BindingObjectProxy(
+      thread.message_loop_proxy(),
+      base::Bind(&ThreadBoundObject::Create, thread.thread_id())));
+
+  EXPECT_TRUE(proxy->HandleFunction(CreateFunctionInfo("test")));
+  EXPECT_TRUE(proxy->HandleFunction(CreateFunctionInfo("test")));
+  // Unknown functions are only noticed on the thread of the object.
+  EXPECT_TRUE(proxy->HandleFunction(CreateFunctionInfo("unknown")));
+  proxy.reset();
+
+  // Runs whatever was posted before stopping.
+  thread.Stop();
+  EXPECT_EQ(2, ThreadBoundObject::call_count());
+  EXPECT_EQ(0, ThreadBoundObject::instance_count());
+}
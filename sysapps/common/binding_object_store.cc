@@ -12,8 +12,17 @@ using namespace xwalk::jsapi::common; // NOLINT
 namespace xwalk {
 namespace sysapps {
 
+namespace {
+
+// Handles are reused by the JavaScript side, so only a buggy or malicious
+// page would get anywhere near this many live objects.
+const int kMaxObjectHandle = 1 << 20;
+
+}  // namespace
+
 BindingObjectStore::BindingObjectStore(XWalkExtensionFunctionHandler* handler)
-    : objects_deleter_(&objects_) {
+    : objects_deleter_(&objects_),
+      native_objects_deleter_(&native_objects_) {
   handler->Register("JSObjectCollected",
       base::Bind(&BindingObjectStore::OnJSObjectCollected,
                  base::Unretained(this)));
@@ -24,18 +33,55 @@ BindingObjectStore::BindingObjectStore(XWalkExtensionFunctionHandler* handler)
 
 BindingObjectStore::~BindingObjectStore() {}
 
-void BindingObjectStore::AddBindingObject(const std::string& id,
+void BindingObjectStore::AddBindingObject(int id,
                                           scoped_ptr<BindingObject> obj) {
-  if (ContainsKey(objects_, id)) {
+  if (id >= kMaxObjectHandle) {
+    LOG(WARNING) << "The object ID " << id << " is out of range.";
+    return;
+  }
+
+  if (GetBindingObject(id)) {
     LOG(WARNING) << "The object with the ID " << id << " already exists.";
     return;
   }
 
+  if (id < 0) {
+    native_objects_[id] = obj.release();
+    return;
+  }
+
+  if (static_cast<size_t>(id) >= objects_.size())
+    objects_.resize(id + 1, NULL);
   objects_[id] = obj.release();
 }
 
-bool BindingObjectStore::HasObjectForTesting(const std::string& id) const {
-  return ContainsKey(objects_, id);
+bool BindingObjectStore::HasObjectForTesting(int id) const {
+  return GetBindingObject(id) != NULL;
+}
+
+BindingObject* BindingObjectStore::GetBindingObject(int id) const {
+  if (id >= 0)
+    return static_cast<size_t>(id) < objects_.size() ? objects_[id] : NULL;
+
+  BindingObjectMap::const_iterator it = native_objects_.find(id);
+  return it != native_objects_.end() ? it->second : NULL;
+}
+
+scoped_ptr<BindingObject> BindingObjectStore::RemoveBindingObject(int id) {
+  BindingObject* obj = NULL;
+  if (id >= 0) {
+    if (static_cast<size_t>(id) < objects_.size()) {
+      obj = objects_[id];
+      objects_[id] = NULL;
+    }
+  } else {
+    BindingObjectMap::iterator it = native_objects_.find(id);
+    if (it != native_objects_.end()) {
+      obj = it->second;
+      native_objects_.erase(it);
+    }
+  }
+  return make_scoped_ptr(obj);
 }
 
 void BindingObjectStore::OnJSObjectCollected(
@@ -48,15 +94,10 @@ void BindingObjectStore::OnJSObjectCollected(
     return;
   }
 
-  BindingObjectMap::iterator it = objects_.find(params->object_id);
-  if (it == objects_.end()) {
+  if (!RemoveBindingObject(params->object_id)) {
     LOG(WARNING) << "Attempt to destroy inexistent object with the ID "
         << params->object_id;
-    return;
   }
-
-  delete it->second;
-  objects_.erase(it);
 }
 
 void BindingObjectStore::OnPostMessageToObject(
@@ -69,8 +110,8 @@ void BindingObjectStore::OnPostMessageToObject(
     return;
   }
 
-  BindingObjectMap::iterator it = objects_.find(params->object_id);
-  if (it == objects_.end())
+  BindingObject* obj = GetBindingObject(params->object_id);
+  if (!obj)
     return;
 
   if (!params->arguments->IsType(base::Value::TYPE_LIST)) {
@@ -86,9 +127,11 @@ void BindingObjectStore::OnPostMessageToObject(
       new XWalkExtensionFunctionInfo(
           params->name,
           new_args.Pass(),
-          info->post_result_cb()));
+          info->post_result_cb(),
+          info->post_partial_result_cb(),
+          info->cancellation_token()));
 
-  if (!it->second->HandleFunction(new_info.Pass())) {
+  if (!obj->HandleFunction(new_info.Pass())) {
     LOG(WARNING) << "The object with the ID " << params->object_id << " has no "
         "handler for the function " << params->name << ".";
     return;
@@ -5,8 +5,8 @@
 #ifndef XWALK_SYSAPPS_COMMON_BINDING_OBJECT_STORE_H_
 #define XWALK_SYSAPPS_COMMON_BINDING_OBJECT_STORE_H_
 
-#include <map>
-#include <string>
+#include <vector>
+#include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/stl_util.h"
 #include "xwalk/extensions/browser/xwalk_extension_function_handler.h"
@@ -24,23 +24,37 @@ using extensions::XWalkExtensionFunctionInfo;
 // the JavaScript context. It handles the dispatching of messages to the
 // destination object based on a unique identifier associated to every
 // BindingObject. This class owns the BindingObjects it is managing.
+//
+// The identifiers are integer handles. The ones allocated by getUniqueId() in
+// the JavaScript side are small non-negative integers, reused once the object
+// is collected, and index a slot vector. Objects created by the native side
+// (like accepted TCP connections) use negative handles and are kept in a hash
+// table instead, so both can be allocated without talking to each other.
 class BindingObjectStore {
  public:
   explicit BindingObjectStore(XWalkExtensionFunctionHandler* handler);
   virtual ~BindingObjectStore();
 
-  void AddBindingObject(const std::string& id, scoped_ptr<BindingObject> obj);
-  bool HasObjectForTesting(const std::string& id) const;
+  void AddBindingObject(int id, scoped_ptr<BindingObject> obj);
+  bool HasObjectForTesting(int id) const;
 
  private:
+  BindingObject* GetBindingObject(int id) const;
+  scoped_ptr<BindingObject> RemoveBindingObject(int id);
+
   // This method is invoked every time a JavaScript Binding object is collected
   // by the garbage collector, so we can also destroy the native counterpart.
   void OnJSObjectCollected(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnPostMessageToObject(scoped_ptr<XWalkExtensionFunctionInfo> info);
 
-  typedef std::map<std::string, BindingObject*> BindingObjectMap;
-  BindingObjectMap objects_;
-  STLValueDeleter<BindingObjectMap> objects_deleter_;
+  // Indexed by handle, NULL for free slots.
+  typedef std::vector<BindingObject*> BindingObjectSlots;
+  BindingObjectSlots objects_;
+  STLElementDeleter<BindingObjectSlots> objects_deleter_;
+
+  typedef base::hash_map<int, BindingObject*> BindingObjectMap;
+  BindingObjectMap native_objects_;
+  STLValueDeleter<BindingObjectMap> native_objects_deleter_;
 };
 
 }  // namespace sysapps
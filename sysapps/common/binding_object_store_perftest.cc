@@ -0,0 +1,90 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/common/binding_object_store.h"
+
+#include <vector>
+
+#include "base/memory/scoped_vector.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "xwalk/extensions/browser/xwalk_extension_function_handler.h"
+
+using xwalk::extensions::XWalkExtensionFunctionHandler;
+using xwalk::extensions::XWalkExtensionFunctionInfo;
+using xwalk::sysapps::BindingObject;
+using xwalk::sysapps::BindingObjectStore;
+
+namespace {
+
+void DummyCallback(scoped_ptr<base::ListValue> result) {}
+
+scoped_ptr<XWalkExtensionFunctionInfo> CreatePostMessageToObjectInfo(
+    int object_id) {
+  scoped_ptr<base::ListValue> arguments(new base::ListValue);
+  arguments->AppendInteger(object_id);
+  arguments->AppendString("test");
+  arguments->Append(new base::ListValue);
+
+  return make_scoped_ptr(new XWalkExtensionFunctionInfo(
+      "postMessageToObject",
+      arguments.Pass(),
+      base::Bind(&DummyCallback)));
+}
+
+class CountingBindingObject : public BindingObject {
+ public:
+  CountingBindingObject() : call_count_(0) {
+    handler_.Register("test", base::Bind(&CountingBindingObject::OnTest,
+                                         base::Unretained(this)));
+  }
+
+  int call_count() const { return call_count_; }
+
+ private:
+  void OnTest(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+    ++call_count_;
+  }
+
+  int call_count_;
+};
+
+}  // namespace
+
+TEST(BindingObjectStorePerfTest, Dispatch) {
+  const int kObjectCount = 1000;
+  const int kMessageCount = 100000;
+
+  XWalkExtensionFunctionHandler handler(NULL);
+  scoped_ptr<BindingObjectStore> store(new BindingObjectStore(&handler));
+
+  std::vector<CountingBindingObject*> objects;
+  for (int i = 0; i < kObjectCount; ++i) {
+    objects.push_back(new CountingBindingObject());
+    store->AddBindingObject(i, scoped_ptr<BindingObject>(objects.back()));
+  }
+
+  // Creating the messages is not what is being measured.
+  ScopedVector<XWalkExtensionFunctionInfo> messages;
+  for (int i = 0; i < kMessageCount; ++i) {
+    messages.push_back(
+        CreatePostMessageToObjectInfo(i % kObjectCount).release());
+  }
+
+  base::ElapsedTimer timer;
+  for (int i = 0; i < kMessageCount; ++i) {
+    handler.HandleFunction(make_scoped_ptr(messages[i]));
+    messages[i] = NULL;
+  }
+  perf_test::PrintResult(
+      "binding_object_store_dispatch", "",
+      base::StringPrintf("%d_objects", kObjectCount),
+      timer.Elapsed().InMicroseconds() / static_cast<double>(kMessageCount),
+      "us", true);
+
+  for (int i = 0; i < kObjectCount; ++i)
+    EXPECT_EQ(kMessageCount / kObjectCount, objects[i]->call_count());
+}
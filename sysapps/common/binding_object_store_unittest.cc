@@ -19,9 +19,9 @@ const char kTestString[] = "crosswalk1234567890";
 void DummyCallback(scoped_ptr<base::ListValue> result) {}
 
 scoped_ptr<XWalkExtensionFunctionInfo> CreateFunctionInfo(
-    const std::string& name, const std::string& str_argument) {
+    const std::string& name, int int_argument) {
   scoped_ptr<base::ListValue> arguments(new base::ListValue);
-  arguments->AppendString(str_argument);
+  arguments->AppendInteger(int_argument);
 
   return make_scoped_ptr(new XWalkExtensionFunctionInfo(
       name,
@@ -29,6 +29,22 @@ scoped_ptr<XWalkExtensionFunctionInfo> CreateFunctionInfo(
       base::Bind(&DummyCallback)));
 }
 
+scoped_ptr<XWalkExtensionFunctionInfo> CreatePostMessageToObjectInfo(
+    int object_id) {
+  scoped_ptr<base::ListValue> arguments(new base::ListValue);
+  arguments->AppendInteger(object_id);
+  arguments->AppendString("test");
+
+  base::ListValue* target_arguments(new base::ListValue());
+  target_arguments->AppendString(kTestString);
+  arguments->Append(target_arguments);
+
+  return make_scoped_ptr(new XWalkExtensionFunctionInfo(
+      "postMessageToObject",
+      arguments.Pass(),
+      base::Bind(&DummyCallback)));
+}
+
 class BindingObjectTest : public BindingObject {
  public:
   static scoped_ptr<BindingObject> Create() {
@@ -78,20 +94,20 @@ TEST(XWalkSysAppsBindingObjectStoreTest, AddBindingObject) {
       new XWalkExtensionFunctionHandler(NULL));
   scoped_ptr<BindingObjectStore> store(new BindingObjectStore(handler.get()));
 
-  EXPECT_FALSE(store->HasObjectForTesting("foobar1"));
-  EXPECT_FALSE(store->HasObjectForTesting("foobar2"));
-  EXPECT_FALSE(store->HasObjectForTesting("foobar3"));
-  EXPECT_FALSE(store->HasObjectForTesting("foobar4"));
+  EXPECT_FALSE(store->HasObjectForTesting(1));
+  EXPECT_FALSE(store->HasObjectForTesting(2));
+  EXPECT_FALSE(store->HasObjectForTesting(3));
+  EXPECT_FALSE(store->HasObjectForTesting(4));
 
-  store->AddBindingObject("foobar1", BindingObjectTest::Create());
-  store->AddBindingObject("foobar2", BindingObjectTest::Create());
-  store->AddBindingObject("foobar3", BindingObjectTest::Create());
-  store->AddBindingObject("foobar4", BindingObjectTest::Create());
+  store->AddBindingObject(1, BindingObjectTest::Create());
+  store->AddBindingObject(2, BindingObjectTest::Create());
+  store->AddBindingObject(3, BindingObjectTest::Create());
+  store->AddBindingObject(4, BindingObjectTest::Create());
 
-  EXPECT_TRUE(store->HasObjectForTesting("foobar1"));
-  EXPECT_TRUE(store->HasObjectForTesting("foobar2"));
-  EXPECT_TRUE(store->HasObjectForTesting("foobar3"));
-  EXPECT_TRUE(store->HasObjectForTesting("foobar4"));
+  EXPECT_TRUE(store->HasObjectForTesting(1));
+  EXPECT_TRUE(store->HasObjectForTesting(2));
+  EXPECT_TRUE(store->HasObjectForTesting(3));
+  EXPECT_TRUE(store->HasObjectForTesting(4));
 
   EXPECT_EQ(BindingObjectTest::instance_count(), 4);
 
@@ -102,10 +118,10 @@ TEST(XWalkSysAppsBindingObjectStoreTest, AddBindingObject) {
   // Same ID, should discard the object. If this is happening in
   // real life, there is something wrong with the code (and that is
   // why we print a warning).
-  store->AddBindingObject("foobar1", BindingObjectTest::Create());
-  store->AddBindingObject("foobar1", BindingObjectTest::Create());
-  store->AddBindingObject("foobar1", BindingObjectTest::Create());
-  store->AddBindingObject("foobar1", BindingObjectTest::Create());
+  store->AddBindingObject(1, BindingObjectTest::Create());
+  store->AddBindingObject(1, BindingObjectTest::Create());
+  store->AddBindingObject(1, BindingObjectTest::Create());
+  store->AddBindingObject(1, BindingObjectTest::Create());
   EXPECT_EQ(BindingObjectTest::instance_count(), 1);
 
   store.reset();
@@ -116,24 +132,24 @@ TEST(XWalkSysAppsBindingObjectStoreTest, OnJSObjectCollected) {
   XWalkExtensionFunctionHandler handler(NULL);
   scoped_ptr<BindingObjectStore> store(new BindingObjectStore(&handler));
 
-  store->AddBindingObject("foobar1", BindingObjectTest::Create());
-  store->AddBindingObject("foobar2", BindingObjectTest::Create());
-  store->AddBindingObject("foobar3", BindingObjectTest::Create());
-  store->AddBindingObject("foobar4", BindingObjectTest::Create());
+  store->AddBindingObject(1, BindingObjectTest::Create());
+  store->AddBindingObject(2, BindingObjectTest::Create());
+  store->AddBindingObject(3, BindingObjectTest::Create());
+  store->AddBindingObject(4, BindingObjectTest::Create());
   EXPECT_EQ(BindingObjectTest::instance_count(), 4);
 
   EXPECT_TRUE(handler.HandleFunction(
-          CreateFunctionInfo("JSObjectCollected", "foobar1")));
+          CreateFunctionInfo("JSObjectCollected", 1)));
   EXPECT_EQ(BindingObjectTest::instance_count(), 3);
 
   EXPECT_TRUE(handler.HandleFunction(
-          CreateFunctionInfo("JSObjectCollected", "foobar2")));
+          CreateFunctionInfo("JSObjectCollected", 2)));
   EXPECT_EQ(BindingObjectTest::instance_count(), 2);
 
   // Attempt to destroy an object that doesn't exist
   // on the store.
   EXPECT_TRUE(handler.HandleFunction(
-          CreateFunctionInfo("JSObjectCollected", "foobar2")));
+          CreateFunctionInfo("JSObjectCollected", 2)));
   EXPECT_EQ(BindingObjectTest::instance_count(), 2);
 
   store.reset();
@@ -149,15 +165,15 @@ TEST(XWalkSysAppsBindingObjectStoreTest, OnPostMessageToObject) {
   scoped_ptr<BindingObject> binding_object_ptr1(binding_object1);
   scoped_ptr<BindingObject> binding_object_ptr2(binding_object2);
 
-  store->AddBindingObject("foobar1", binding_object_ptr1.Pass());
-  store->AddBindingObject("foobar2", binding_object_ptr2.Pass());
+  store->AddBindingObject(1, binding_object_ptr1.Pass());
+  store->AddBindingObject(2, binding_object_ptr2.Pass());
   EXPECT_EQ(BindingObjectTest::instance_count(), 2);
 
   for (unsigned i = 0; i < 1000; ++i) {
     scoped_ptr<base::ListValue> arguments(new base::ListValue);
 
     // Object ID.
-    arguments->AppendString("foobar1");
+    arguments->AppendInteger(1);
 
     // Function name on the target object.
     arguments->AppendString("test");
@@ -182,3 +198,41 @@ TEST(XWalkSysAppsBindingObjectStoreTest, OnPostMessageToObject) {
   store.reset();
   EXPECT_EQ(BindingObjectTest::instance_count(), 0);
 }
+
+TEST(XWalkSysAppsBindingObjectStoreTest, NativeHandles) {
+  XWalkExtensionFunctionHandler handler(NULL);
+  scoped_ptr<BindingObjectStore> store(new BindingObjectStore(&handler));
+
+  // Negative handles are allocated by the native side and live next to
+  // the ones of the same absolute value.
+  BindingObjectTest* native_object(new BindingObjectTest());
+  store->AddBindingObject(-1, scoped_ptr<BindingObject>(native_object));
+  store->AddBindingObject(1, BindingObjectTest::Create());
+  store->AddBindingObject(-1, BindingObjectTest::Create());
+  EXPECT_EQ(BindingObjectTest::instance_count(), 2);
+  EXPECT_TRUE(store->HasObjectForTesting(-1));
+  EXPECT_TRUE(store->HasObjectForTesting(1));
+  EXPECT_FALSE(store->HasObjectForTesting(0));
+
+  EXPECT_TRUE(handler.HandleFunction(CreatePostMessageToObjectInfo(-1)));
+  EXPECT_EQ(native_object->call_count(), 1);
+
+  EXPECT_TRUE(handler.HandleFunction(
+          CreateFunctionInfo("JSObjectCollected", -1)));
+  EXPECT_FALSE(store->HasObjectForTesting(-1));
+  EXPECT_EQ(BindingObjectTest::instance_count(), 1);
+
+  // Handles are reused once the object is collected.
+  EXPECT_TRUE(handler.HandleFunction(
+          CreateFunctionInfo("JSObjectCollected", 1)));
+  store->AddBindingObject(1, BindingObjectTest::Create());
+  EXPECT_TRUE(store->HasObjectForTesting(1));
+
+  // Huge handles are refused instead of growing the store.
+  store->AddBindingObject(1 << 30, BindingObjectTest::Create());
+  EXPECT_FALSE(store->HasObjectForTesting(1 << 30));
+  EXPECT_EQ(BindingObjectTest::instance_count(), 1);
+
+  store.reset();
+  EXPECT_EQ(BindingObjectTest::instance_count(), 0);
+}
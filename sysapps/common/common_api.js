@@ -7,10 +7,22 @@
 var internal;
 var v8tools;
 
+// Object IDs are small integers, so the native BindingObjectStore can use
+// them as indexes. The ones of collected objects are reused, keeping them
+// dense.
 var unique_id = 0;
+var released_ids = [];
 
 function getUniqueId() {
-  return (unique_id++).toString();
+  if (released_ids.length)
+    return released_ids.pop();
+  return unique_id++;
+}
+
+function releaseUniqueId(object_id) {
+  // Negative IDs are allocated by the native side.
+  if (object_id >= 0)
+    released_ids.push(object_id);
 }
 
 function wrapPromiseAsCallback(promise) {
@@ -22,6 +34,72 @@ function wrapPromiseAsCallback(promise) {
   };
 };
 
+// Returned by the methods added with _addMethodWithStream(), follows the
+// async iterator protocol: next() returns a Promise fulfilled with
+// {value: data, done: false} for each result streamed by the native side,
+// then with {value: undefined, done: true}, or rejected with the error
+// ending the stream. cancel() tells the native function to stop, the pending
+// and later next() calls are then done.
+var ResultStream = function(Promise) {
+  this._Promise = Promise;
+  this._id = 0;
+  this._results = [];
+  this._reads = [];
+  this._done = false;
+  this._error = null;
+};
+
+ResultStream.prototype = {
+  next: function() {
+    var promise = new this._Promise();
+    if (this._results.length)
+      promise.fulfill({ value: this._results.shift(), done: false });
+    else if (this._error)
+      promise.reject(this._error);
+    else if (this._done)
+      promise.fulfill({ value: undefined, done: true });
+    else
+      this._reads.push(promise);
+    return promise;
+  },
+  cancel: function() {
+    if (this._done)
+      return;
+    internal.cancelCall(this._id);
+    this._finish(null);
+  },
+  // Replies are [data, error], the last one may come without data.
+  _onReply: function(results, more) {
+    if (this._done)
+      return;
+    if (results.length && results[0] !== null && results[0] !== undefined) {
+      if (this._reads.length)
+        this._reads.shift().fulfill({ value: results[0], done: false });
+      else
+        this._results.push(results[0]);
+    }
+    if (results[1] || !more)
+      this._finish(results[1] || null);
+  },
+  _finish: function(error) {
+    this._done = true;
+    this._error = error;
+    var read;
+    while (read = this._reads.shift()) {
+      if (error)
+        read.reject(error);
+      else
+        read.fulfill({ value: undefined, done: true });
+    }
+  },
+};
+
+if (typeof Symbol == "function" && Symbol.asyncIterator) {
+  ResultStream.prototype[Symbol.asyncIterator] = function() {
+    return this;
+  };
+}
+
 // The BindingObject is responsible for bridging between the JavaScript
 // implementation and the native code. It keeps a unique ID for each
 // instance of a given object that is used by the BindingObjectStore to
@@ -55,6 +133,11 @@ function wrapPromiseAsCallback(promise) {
 //     |reject()| and be passed as parameter to it, otherwise we |fullfill()|
 //     is invoked with |data|.
 //
+// _addMethodWithStream(name, promise):
+//     Same for native functions streaming their results, the method returns
+//     a ResultStream. Each partial reply from the native side has a |data|
+//     parameter, an |error| ends the stream.
+//
 var BindingObjectPrototype = function() {
   function postMessage(name, args, callback) {
     return internal.postMessage("postMessageToObject",
@@ -92,6 +175,19 @@ var BindingObjectPrototype = function() {
     });
   };
 
+  function addMethodWithStream(name, Promise) {
+    Object.defineProperty(this, name, {
+      value: function() {
+        var stream = new ResultStream(Promise);
+        var args = Array.prototype.slice.call(arguments);
+        stream._id = internal.postStreamingMessage("postMessageToObject",
+            [this._id, name, args], stream._onReply.bind(stream));
+        return stream;
+      },
+      enumerable: isEnumerable(name),
+    });
+  };
+
   function registerLifecycleTracker() {
     Object.defineProperty(this, "_tracker", {
       value: v8tools.lifecycleTracker(),
@@ -100,6 +196,9 @@ var BindingObjectPrototype = function() {
     var object_id = this._id;
     this._tracker.destructor = function() {
       internal.postMessage("JSObjectCollected", [object_id]);
+      // Messages are handled in order, so the native object is gone by the
+      // time the ID is used again.
+      releaseUniqueId(object_id);
     };
   }
 
@@ -113,6 +212,9 @@ var BindingObjectPrototype = function() {
     "_addMethodWithPromise" : {
       value: addMethodWithPromise,
     },
+    "_addMethodWithStream" : {
+      value: addMethodWithStream,
+    },
     "_registerLifecycleTracker" : {
       value: registerLifecycleTracker,
     },
@@ -134,18 +236,27 @@ var BindingObject = function(object_id) {
 // The following interface will be always publicly available for every object
 // using this prototype and they behave just like the specified:
 //
-// addEventListener(type, listener)
+// addEventListener(type, listener, options?)
 // removeEventListener(type, listener)
 // dispatchEvent(event)
 //
+// The optional |options| of addEventListener() limit how often high frequency
+// events are delivered: {delivery: "coalesce"} only dispatches the latest
+// event of each interval, {delivery: "batch"} dispatches all the events of
+// an interval at once, and {maxRate: N} sets the interval to 1/N second
+// (coalescing if there is no delivery policy). The interval is about a frame
+// by default. Only the options of the first listener of a type are used.
+//
 // The following method is available for internal usage only:
 //
-// _addEvent(event_name, EventSynthesizer?):
+// _addEvent(event_name, EventSynthesizer?, batched?):
 //     Convenience function for declaring the events available for the
 //     EventTarget. It will also declare a functional on[type] EventHandler.
 //     The optional EventSynthesizer, if supplied, will be used for create
 //     the event, if not supplied, a default MessageEvent is created (the data
-//     is simply associated to event.data).
+//     is simply associated to event.data). If |batched| is true, the native
+//     side sends an array of event data at once, and each element is
+//     dispatched as an event of its own.
 //
 // Important considerations:
 //    - Objects with message listeners attached are never going to be collected
@@ -161,7 +272,7 @@ var EventTargetPrototype = function() {
       this.data = data;
   };
 
-  function addEvent(type, event) {
+  function addEvent(type, event, batched) {
     Object.defineProperty(this, "_on" + type, {
       writable : true,
     });
@@ -188,6 +299,9 @@ var EventTargetPrototype = function() {
       this._event_synthesizers[type] = event;
     else
       this._event_synthesizers[type] = DefaultEvent;
+
+    if (batched)
+      this._batched_events[type] = true;
   };
 
   function dispatchEvent(event) {
@@ -202,6 +316,16 @@ var EventTargetPrototype = function() {
   };
 
   function dispatchEventFromExtension(type, data) {
+    if (this._batched_events[type]) {
+      for (var i = 0; i < data.length; ++i)
+        this._dispatchSingleEventFromExtension(type, data[i]);
+      return;
+    }
+
+    this._dispatchSingleEventFromExtension(type, data);
+  };
+
+  function dispatchSingleEventFromExtension(type, data) {
     var listeners = this._event_listeners[type];
 
     for (var i in listeners)
@@ -211,14 +335,34 @@ var EventTargetPrototype = function() {
   // We need a reference to the calling object because
   // this function is called by the renderer process with
   // "this" equals to the global object.
-  function makeCallbackListener(obj, type) {
+  function makeCallbackListener(obj, type, batch) {
     return function(data) {
-      obj._dispatchEventFromExtension(type, data);
+      if (!batch) {
+        obj._dispatchEventFromExtension(type, data);
+        return true;
+      }
+
+      for (var i = 0; i < data.length; ++i)
+        obj._dispatchEventFromExtension(type, data[i]);
       return true;
     };
   };
 
-  function addEventListener(type, listener) {
+  // Returns the options understood by the native side, or null.
+  function deliveryOptions(options) {
+    if (!(options instanceof Object))
+      return null;
+
+    var delivery = {};
+    if (options.delivery == "coalesce" || options.delivery == "batch")
+      delivery.delivery = options.delivery;
+    var max_rate = Math.floor(options.maxRate);
+    if (max_rate > 0)
+      delivery.maxRate = max_rate;
+    return delivery;
+  };
+
+  function addEventListener(type, listener, options) {
     if (!(listener instanceof Function))
       return;
 
@@ -231,8 +375,13 @@ var EventTargetPrototype = function() {
         listeners.push(listener);
     } else {
       this._event_listeners[type] = [listener];
-      var id = this._postMessage("addEventListener",
-          [type], makeCallbackListener(this, type));
+      var args = [type];
+      var delivery = deliveryOptions(options);
+      if (delivery)
+        args.push(delivery);
+      var id = this._postMessage("addEventListener", args,
+          makeCallbackListener(this, type,
+                               delivery && delivery.delivery == "batch"));
       this._callback_listeners_id[type] = id;
     }
   };
@@ -266,6 +415,9 @@ var EventTargetPrototype = function() {
     "_dispatchEventFromExtension" : {
       value : dispatchEventFromExtension,
     },
+    "_dispatchSingleEventFromExtension" : {
+      value : dispatchSingleEventFromExtension,
+    },
     "addEventListener" : {
       value : addEventListener,
       enumerable : true,
@@ -292,6 +444,9 @@ var EventTarget = function(object_id) {
     "_event_synthesizers": {
       value: {},
     },
+    "_batched_events": {
+      value: {},
+    },
   });
 };
 
@@ -41,6 +41,10 @@ SysAppsTestExtension::SysAppsTestExtension() {
     "  this._addMethod('fireTestEvent', true);"
     "  this._addMethodWithPromise('makeFulfilledPromise', Promise);"
     "  this._addMethodWithPromise('makeRejectedPromise', Promise);"
+    "  this._addMethodWithStream('makeStream', Promise);"
+    "  this._addMethodWithStream('makeRejectedStream', Promise);"
+    "  this._addMethodWithStream('makePendingStream', Promise);"
+    "  this._addMethod('isPendingStreamCancelled', true);"
     "  this._addEvent('test');"
     "  this._registerLifecycleTracker();"
     "};"
@@ -75,8 +79,8 @@ void SysAppsTestExtensionInstance::HandleMessage(scoped_ptr<base::Value> msg) {
 
 void SysAppsTestExtensionInstance::OnSysAppsTestObjectContructor(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
-  std::string object_id;
-  ASSERT_TRUE(info->arguments()->GetString(0, &object_id));
+  int object_id;
+  ASSERT_TRUE(info->arguments()->GetInteger(0, &object_id));
 
   scoped_ptr<BindingObject> obj(new SysAppsTestObject);
   store_.AddBindingObject(object_id, obj.Pass());
@@ -84,8 +88,8 @@ void SysAppsTestExtensionInstance::OnSysAppsTestObjectContructor(
 
 void SysAppsTestExtensionInstance::OnHasObject(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
-  std::string object_id;
-  ASSERT_TRUE(info->arguments()->GetString(0, &object_id));
+  int object_id;
+  ASSERT_TRUE(info->arguments()->GetInteger(0, &object_id));
 
   scoped_ptr<base::ListValue> result(new base::ListValue());
   result->AppendBoolean(store_.HasObjectForTesting(object_id));
@@ -106,6 +110,18 @@ SysAppsTestObject::SysAppsTestObject() : is_test_event_active_(false) {
   handler_.Register("makeRejectedPromise",
       base::Bind(&SysAppsTestObject::OnMakeRejectedPromise,
                  base::Unretained(this)));
+  handler_.Register("makeStream",
+      base::Bind(&SysAppsTestObject::OnMakeStream,
+                 base::Unretained(this)));
+  handler_.Register("makeRejectedStream",
+      base::Bind(&SysAppsTestObject::OnMakeRejectedStream,
+                 base::Unretained(this)));
+  handler_.Register("makePendingStream",
+      base::Bind(&SysAppsTestObject::OnMakePendingStream,
+                 base::Unretained(this)));
+  handler_.Register("isPendingStreamCancelled",
+      base::Bind(&SysAppsTestObject::OnIsPendingStreamCancelled,
+                 base::Unretained(this)));
 }
 
 void SysAppsTestObject::StartEvent(const std::string& type) {
@@ -154,6 +170,65 @@ void SysAppsTestObject::OnMakeRejectedPromise(
   info->PostResult(result.Pass());
 }
 
+void SysAppsTestObject::OnMakeStream(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  int count;
+  ASSERT_TRUE(info->arguments()->GetInteger(0, &count));
+
+  for (int i = 0; i < count; ++i) {
+    scoped_ptr<base::ListValue> result(new base::ListValue());
+    result->AppendInteger(i);  // Data.
+    result->AppendString("");  // Error, empty == no error.
+
+    info->PostPartialResult(result.Pass());
+  }
+
+  // The last reply ends the stream without data.
+  info->PostResult(make_scoped_ptr(new base::ListValue()));
+}
+
+void SysAppsTestObject::OnMakeRejectedStream(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  scoped_ptr<base::ListValue> result(new base::ListValue());
+  result->AppendString("Lorem ipsum");  // Data.
+  result->AppendString("");  // Error, empty == no error.
+  info->PostPartialResult(result.Pass());
+
+  result.reset(new base::ListValue());
+  result->AppendString("");  // Data.
+  result->AppendString("Lorem ipsum");  // Error, !empty == error.
+  info->PostResult(result.Pass());
+}
+
+void SysAppsTestObject::OnMakePendingStream(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  scoped_ptr<base::ListValue> result(new base::ListValue());
+  result->AppendString("Lorem ipsum");  // Data.
+  result->AppendString("");  // Error, empty == no error.
+  info->PostPartialResult(result.Pass());
+
+  // Never ends on its own, JavaScript is expected to cancel it.
+  pending_stream_ = info.Pass();
+}
+
+void SysAppsTestObject::OnIsPendingStreamCancelled(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  ASSERT_TRUE(pending_stream_);
+  bool is_cancelled = pending_stream_->IsCancelled();
+
+  // Dropped by the function handler, the stream is already done on the
+  // JavaScript side.
+  scoped_ptr<base::ListValue> result(new base::ListValue());
+  result->AppendString("Lorem ipsum");  // Data.
+  result->AppendString("");  // Error, empty == no error.
+  pending_stream_->PostResult(result.Pass());
+  pending_stream_.reset();
+
+  result.reset(new base::ListValue());
+  result->AppendBoolean(is_cancelled);
+  info->PostResult(result.Pass());
+}
+
 class SysAppsCommonTest : public InProcessBrowserTest {
  public:
   virtual void SetUp() {
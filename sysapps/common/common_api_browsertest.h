@@ -53,8 +53,13 @@ class SysAppsTestObject : public EventTarget {
   void OnFireTestEvent(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnMakeFulfilledPromise(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnMakeRejectedPromise(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnMakeStream(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnMakeRejectedStream(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnMakePendingStream(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnIsPendingStreamCancelled(scoped_ptr<XWalkExtensionFunctionInfo> info);
 
   bool is_test_event_active_;
+  scoped_ptr<XWalkExtensionFunctionInfo> pending_stream_;
 };
 
 #endif  // XWALK_SYSAPPS_COMMON_COMMON_API_BROWSERTEST_H_
@@ -4,14 +4,30 @@
 
 #include "xwalk/sysapps/common/event_target.h"
 
-#include "xwalk/sysapps/common/common.h"
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/time/default_tick_clock.h"
 
 using namespace xwalk::jsapi::common; // NOLINT
 
 namespace xwalk {
 namespace sysapps {
 
-EventTarget::EventTarget() {
+namespace {
+
+// The deliveries per second when the listener asks for a policy but not a
+// rate, close to the frame rate of the renderer.
+const int kDefaultMaxRate = 60;
+
+}  // namespace
+
+EventTarget::Event::Event()
+    : delivery(DELIVERY_POLICY_NONE) {}
+
+EventTarget::Event::~Event() {}
+
+EventTarget::EventTarget()
+    : clock_(new base::DefaultTickClock) {
   handler_.Register("addEventListener",
       base::Bind(&EventTarget::OnAddEventListener, base::Unretained(this)));
   handler_.Register("removeEventListener",
@@ -30,13 +46,70 @@ void EventTarget::DispatchEvent(const std::string& type,
   if (it == events_.end())
     return;
 
-  it->second.Run(data.Pass());
+  Event* event = it->second.get();
+  if (event->delivery == DELIVERY_POLICY_NONE) {
+    event->post_result_cb.Run(data.Pass());
+    return;
+  }
+
+  if (event->delivery == DELIVERY_POLICY_COALESCE) {
+    event->pending = data.Pass();
+  } else {
+    if (!event->pending)
+      event->pending.reset(new base::ListValue);
+    // The listener takes the first element of the results as event data.
+    scoped_ptr<base::Value> value;
+    if (!data->Remove(0, &value))
+      value.reset(base::Value::CreateNullValue());
+    event->pending->Append(value.release());
+  }
+
+  if (event->flush_timer->IsRunning())
+    return;
+
+  base::TimeDelta wait =
+      event->last_delivery + event->min_interval - clock_->NowTicks();
+  if (event->last_delivery.is_null() || wait <= base::TimeDelta()) {
+    FlushEvent(type);
+    return;
+  }
+
+  event->flush_timer->Start(FROM_HERE, wait,
+      base::Bind(&EventTarget::FlushEvent, base::Unretained(this), type));
+}
+
+void EventTarget::FlushEvent(const std::string& type) {
+  EventMap::iterator it = events_.find(type);
+  if (it == events_.end())
+    return;
+
+  Event* event = it->second.get();
+  if (!event->pending)
+    return;
+
+  event->last_delivery = clock_->NowTicks();
+  if (event->delivery == DELIVERY_POLICY_COALESCE) {
+    event->post_result_cb.Run(event->pending.Pass());
+    return;
+  }
+
+  scoped_ptr<base::ListValue> data(new base::ListValue);
+  data->Append(event->pending.release());
+  event->post_result_cb.Run(data.Pass());
 }
 
 bool EventTarget::IsEventActive(const std::string& type) const {
   return events_.find(type) != events_.end();
 }
 
+void EventTarget::SetTickClockForTesting(scoped_ptr<base::TickClock> clock) {
+  clock_ = clock.Pass();
+}
+
+scoped_ptr<base::Timer> EventTarget::CreateFlushTimer() {
+  return make_scoped_ptr(new base::Timer(false, false));
+}
+
 void EventTarget::OnAddEventListener(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
   scoped_ptr<AddEventListener::Params>
@@ -54,7 +127,21 @@ void EventTarget::OnAddEventListener(
     return;
   }
 
-  events_[params->type] = info->post_result_cb();
+  linked_ptr<Event> event(new Event);
+  event->post_result_cb = info->post_result_cb();
+  event->flush_timer = CreateFlushTimer();
+  if (params->options) {
+    event->delivery = params->options->delivery;
+    int max_rate = kDefaultMaxRate;
+    if (params->options->max_rate && *params->options->max_rate > 0) {
+      max_rate = *params->options->max_rate;
+      if (event->delivery == DELIVERY_POLICY_NONE)
+        event->delivery = DELIVERY_POLICY_COALESCE;
+    }
+    event->min_interval = base::TimeDelta::FromSeconds(1) / max_rate;
+  }
+
+  events_[params->type] = event;
   StartEvent(params->type);
 }
 
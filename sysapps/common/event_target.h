@@ -7,7 +7,13 @@
 
 #include <map>
 #include <string>
+#include "base/memory/linked_ptr.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/time/tick_clock.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "xwalk/sysapps/common/binding_object.h"
+#include "xwalk/sysapps/common/common.h"
 
 namespace xwalk {
 namespace sysapps {
@@ -34,19 +40,45 @@ class EventTarget : public BindingObject {
   // object and invoke its listeners. The message is only sent if there is at
   // least one listener, so it is safe to call this method without concerning
   // about performance issues.
+  //
+  // The listeners may ask for a delivery policy when they are added, that
+  // keeps high frequency events from flooding the renderer with more than it
+  // can paint: the latest event or all of them are then sent at most once per
+  // interval, about a frame by default. The first event after a quiet
+  // interval is sent right away. The options of the first listener of a
+  // type are used.
   void DispatchEvent(const std::string& type);
   void DispatchEvent(const std::string& type, scoped_ptr<base::ListValue> data);
 
   bool IsEventActive(const std::string& type) const;
 
+  // Tests drive the deliveries with a mock clock and mock timers.
+  void SetTickClockForTesting(scoped_ptr<base::TickClock> clock);
+  virtual scoped_ptr<base::Timer> CreateFlushTimer();
+
  private:
   void OnAddEventListener(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnRemoveEventListener(scoped_ptr<XWalkExtensionFunctionInfo> info);
 
-  typedef std::map<std::string,
-      XWalkExtensionFunctionInfo::PostResultCallback> EventMap;
+  struct Event {
+    Event();
+    ~Event();
+
+    XWalkExtensionFunctionInfo::PostResultCallback post_result_cb;
+    jsapi::common::DeliveryPolicy delivery;
+    base::TimeDelta min_interval;
+    base::TimeTicks last_delivery;
+    // The latest event data when coalescing, the list of them when batching.
+    scoped_ptr<base::ListValue> pending;
+    scoped_ptr<base::Timer> flush_timer;
+  };
+
+  void FlushEvent(const std::string& type);
+
+  typedef std::map<std::string, linked_ptr<Event> > EventMap;
 
   EventMap events_;
+  scoped_ptr<base::TickClock> clock_;
 };
 
 }  // namespace sysapps
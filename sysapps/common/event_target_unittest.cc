@@ -4,6 +4,8 @@
 
 #include "xwalk/sysapps/common/event_target.h"
 
+#include "base/test/simple_test_tick_clock.h"
+#include "base/timer/mock_timer.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "xwalk/extensions/browser/xwalk_extension_function_handler.h"
 
@@ -36,11 +38,38 @@ void DispatchResult(int* message_count, scoped_ptr<base::ListValue> result) {
   (*message_count)++;
 }
 
+scoped_ptr<XWalkExtensionFunctionInfo> CreateAddEventListenerInfo(
+    const std::string& type,
+    const std::string& delivery,
+    const XWalkExtensionFunctionInfo::PostResultCallback& callback) {
+  scoped_ptr<base::ListValue> arguments(new base::ListValue);
+  arguments->AppendString(type);
+  base::DictionaryValue* options = new base::DictionaryValue;
+  options->SetString("delivery", delivery);
+  options->SetInteger("maxRate", 50);
+  arguments->Append(options);
+
+  return make_scoped_ptr(new XWalkExtensionFunctionInfo(
+      "addEventListener", arguments.Pass(), callback));
+}
+
+void StoreResult(int* message_count, scoped_ptr<base::ListValue>* last_result,
+                 scoped_ptr<base::ListValue> result) {
+  *last_result = result.Pass();
+  (*message_count)++;
+}
+
 class EventTargetTest : public EventTarget {
  public:
   EventTargetTest()
       : event1_count_(0),
-        event2_count_(0) {}
+        event2_count_(0),
+        clock_(new base::SimpleTestTickClock),
+        flush_timer_(NULL) {
+    // A null last delivery time means there was none.
+    clock_->Advance(base::TimeDelta::FromSeconds(1));
+    SetTickClockForTesting(scoped_ptr<base::TickClock>(clock_));
+  }
 
   void InjectEvent(const std::string& type) {
     scoped_ptr<base::ListValue> data(new base::ListValue());
@@ -49,6 +78,13 @@ class EventTargetTest : public EventTarget {
     DispatchEvent(type, data.Pass());
   }
 
+  void InjectEvent(const std::string& type, int value) {
+    scoped_ptr<base::ListValue> data(new base::ListValue());
+    data->AppendInteger(value);
+
+    DispatchEvent(type, data.Pass());
+  }
+
   bool is_event1_active() const {
     return event1_count_ == 1;
   }
@@ -57,7 +93,16 @@ class EventTargetTest : public EventTarget {
     return event2_count_ == 1;
   }
 
+  base::SimpleTestTickClock* clock() { return clock_; }
+  // The timer of the last event type listened to.
+  base::MockTimer* flush_timer() { return flush_timer_; }
+
  private:
+  virtual scoped_ptr<base::Timer> CreateFlushTimer() OVERRIDE {
+    flush_timer_ = new base::MockTimer(false, false);
+    return scoped_ptr<base::Timer>(flush_timer_);
+  }
+
   virtual void StartEvent(const std::string& type) OVERRIDE {
     if (type == "event1")
       event1_count_++;
@@ -84,6 +129,8 @@ class EventTargetTest : public EventTarget {
 
   int event1_count_;
   int event2_count_;
+  base::SimpleTestTickClock* clock_;
+  base::MockTimer* flush_timer_;
 };
 
 }  // namespace
@@ -162,3 +209,72 @@ TEST(XWalkSysAppsEventTargetTest, DispatchEvent) {
     EXPECT_EQ(message_count, i + 1);
   }
 }
+
+TEST(XWalkSysAppsEventTargetTest, CoalesceEvents) {
+  scoped_ptr<EventTargetTest> target(new EventTargetTest());
+
+  int message_count = 0;
+  scoped_ptr<base::ListValue> last_result;
+  EXPECT_TRUE(target->HandleFunction(CreateAddEventListenerInfo(
+      "event1", "coalesce",
+      base::Bind(&StoreResult, &message_count, &last_result))));
+
+  // The first event goes right away, only the latest of the others follows
+  // once the interval is over, 20ms at 50 per second.
+  for (int i = 1; i <= 10; ++i)
+    target->InjectEvent("event1", i);
+  EXPECT_EQ(1, message_count);
+  ASSERT_TRUE(target->flush_timer()->IsRunning());
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(20),
+            target->flush_timer()->GetCurrentDelay());
+
+  target->clock()->Advance(base::TimeDelta::FromMilliseconds(20));
+  target->flush_timer()->Fire();
+  EXPECT_EQ(2, message_count);
+  int value;
+  ASSERT_TRUE(last_result->GetInteger(0, &value));
+  EXPECT_EQ(10, value);
+
+  // Only what's left of the interval is waited for.
+  target->clock()->Advance(base::TimeDelta::FromMilliseconds(5));
+  target->InjectEvent("event1", 11);
+  EXPECT_EQ(2, message_count);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(15),
+            target->flush_timer()->GetCurrentDelay());
+  target->clock()->Advance(base::TimeDelta::FromMilliseconds(15));
+  target->flush_timer()->Fire();
+  EXPECT_EQ(3, message_count);
+
+  // After a quiet interval, the next event goes right away again.
+  target->clock()->Advance(base::TimeDelta::FromMilliseconds(40));
+  target->InjectEvent("event1", 12);
+  EXPECT_EQ(4, message_count);
+  EXPECT_FALSE(target->flush_timer()->IsRunning());
+  ASSERT_TRUE(last_result->GetInteger(0, &value));
+  EXPECT_EQ(12, value);
+}
+
+TEST(XWalkSysAppsEventTargetTest, BatchEvents) {
+  scoped_ptr<EventTargetTest> target(new EventTargetTest());
+
+  int message_count = 0;
+  scoped_ptr<base::ListValue> last_result;
+  EXPECT_TRUE(target->HandleFunction(CreateAddEventListenerInfo(
+      "event1", "batch",
+      base::Bind(&StoreResult, &message_count, &last_result))));
+
+  for (int i = 1; i <= 10; ++i)
+    target->InjectEvent("event1", i);
+  EXPECT_EQ(1, message_count);
+  ASSERT_TRUE(target->flush_timer()->IsRunning());
+
+  target->clock()->Advance(base::TimeDelta::FromMilliseconds(20));
+  target->flush_timer()->Fire();
+  EXPECT_EQ(2, message_count);
+  base::ListValue* batch;
+  ASSERT_TRUE(last_result->GetList(0, &batch));
+  ASSERT_EQ(9u, batch->GetSize());
+  int value;
+  ASSERT_TRUE(batch->GetInteger(8, &value));
+  EXPECT_EQ(10, value);
+}
@@ -5,17 +5,49 @@
 #include "xwalk/sysapps/common/sysapps_manager.h"
 
 #include "base/basictypes.h"
+#include "base/lazy_instance.h"
+#include "base/threading/thread.h"
 #include "xwalk/sysapps/device_capabilities/cpu_info_provider.h"
 #include "xwalk/sysapps/device_capabilities/device_capabilities_extension.h"
+#include "xwalk/sysapps/device_capabilities/device_capabilities_snapshot.h"
 #include "xwalk/sysapps/device_capabilities/display_info_provider.h"
 #include "xwalk/sysapps/device_capabilities/memory_info_provider.h"
+#include "xwalk/sysapps/downloader/downloader_extension.h"
 #include "xwalk/sysapps/raw_socket/raw_socket_extension.h"
 
 namespace xwalk {
 namespace sysapps {
 
+namespace {
+
+class SocketThread : public base::Thread {
+ public:
+  SocketThread() : base::Thread("XWalkSysAppsSocketThread") {
+    CHECK(StartWithOptions(base::Thread::Options(base::MessageLoop::TYPE_IO,
+                                                 0)));
+  }
+};
+
+// Never stopped, the sockets left at exit go away with the process.
+base::LazyInstance<SocketThread>::Leaky g_socket_thread =
+    LAZY_INSTANCE_INITIALIZER;
+
+class FileThread : public base::Thread {
+ public:
+  FileThread() : base::Thread("XWalkSysAppsFileThread") {
+    CHECK(Start());
+  }
+};
+
+// Never stopped either, the downloads save their state as they go.
+base::LazyInstance<FileThread>::Leaky g_file_thread =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 SysAppsManager::SysAppsManager()
     : device_capabilities_enabled_(true),
+      downloader_enabled_(true),
       raw_sockets_enabled_(true) {}
 
 SysAppsManager::~SysAppsManager() {}
@@ -24,6 +56,10 @@ void SysAppsManager::DisableDeviceCapabilities() {
   device_capabilities_enabled_ = false;
 }
 
+void SysAppsManager::DisableDownloader() {
+  downloader_enabled_ = false;
+}
+
 void SysAppsManager::DisableRawSockets() {
   raw_sockets_enabled_ = false;
 }
@@ -39,7 +75,13 @@ void SysAppsManager::CreateExtensionsForUIThread(
 }
 
 void SysAppsManager::CreateExtensionsForExtensionThread(
+    net::URLRequestContextGetter* request_context_getter,
+    const base::FilePath& download_root,
     XWalkExtensionVector* extensions) {
+  if (downloader_enabled_ && request_context_getter) {
+    extensions->push_back(
+        new DownloaderExtension(request_context_getter, download_root));
+  }
   if (raw_sockets_enabled_)
     extensions->push_back(new RawSocketExtension());
 }
@@ -51,6 +93,13 @@ CPUInfoProvider* SysAppsManager::GetCPUInfoProvider() {
   return &provider;
 }
 
+// static
+DeviceCapabilitiesSnapshot* SysAppsManager::GetDeviceCapabilitiesSnapshot() {
+  CR_DEFINE_STATIC_LOCAL(DeviceCapabilitiesSnapshot, snapshot, ());
+
+  return &snapshot;
+}
+
 // static
 DisplayInfoProvider* SysAppsManager::GetDisplayInfoProvider() {
   CR_DEFINE_STATIC_LOCAL(DisplayInfoProvider, provider, ());
@@ -65,5 +114,17 @@ MemoryInfoProvider* SysAppsManager::GetMemoryInfoProvider() {
   return &provider;
 }
 
+// static
+scoped_refptr<base::SingleThreadTaskRunner>
+SysAppsManager::GetSocketTaskRunner() {
+  return g_socket_thread.Get().message_loop_proxy();
+}
+
+// static
+scoped_refptr<base::SingleThreadTaskRunner>
+SysAppsManager::GetFileTaskRunner() {
+  return g_file_thread.Get().message_loop_proxy();
+}
+
 }  // namespace sysapps
 }  // namespace xwalk
@@ -5,8 +5,15 @@
 #ifndef XWALK_SYSAPPS_COMMON_SYSAPPS_MANAGER_H_
 #define XWALK_SYSAPPS_COMMON_SYSAPPS_MANAGER_H_
 
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/single_thread_task_runner.h"
 #include "xwalk/extensions/common/xwalk_extension_vector.h"
 
+namespace net {
+class URLRequestContextGetter;
+}
+
 namespace xwalk {
 namespace sysapps {
 
@@ -14,6 +21,7 @@ using extensions::XWalkExtensionVector;
 
 class AVCodecsProvider;
 class CPUInfoProvider;
+class DeviceCapabilitiesSnapshot;
 class DisplayInfoProvider;
 class MemoryInfoProvider;
 class StorageInfoProvider;
@@ -28,10 +36,16 @@ class SysAppsManager {
   ~SysAppsManager();
 
   void DisableDeviceCapabilities();
+  void DisableDownloader();
   void DisableRawSockets();
 
   void CreateExtensionsForUIThread(XWalkExtensionVector* extensions);
-  void CreateExtensionsForExtensionThread(XWalkExtensionVector* extensions);
+  // The Downloader API is only created with a |request_context_getter|, its
+  // files are saved under |download_root|.
+  void CreateExtensionsForExtensionThread(
+      net::URLRequestContextGetter* request_context_getter,
+      const base::FilePath& download_root,
+      XWalkExtensionVector* extensions);
 
   static AVCodecsProvider* GetAVCodecsProvider();
   static CPUInfoProvider* GetCPUInfoProvider();
@@ -39,8 +53,20 @@ class SysAppsManager {
   static MemoryInfoProvider* GetMemoryInfoProvider();
   static StorageInfoProvider* GetStorageInfoProvider();
 
+  // Cached results of the providers above, see DeviceCapabilitiesSnapshot.
+  static DeviceCapabilitiesSnapshot* GetDeviceCapabilitiesSnapshot();
+
+  // Thread where the sockets of the Raw Socket API do their I/O. Shared by
+  // every instance, so a busy socket only delays other sockets and not the
+  // other extensions.
+  static scoped_refptr<base::SingleThreadTaskRunner> GetSocketTaskRunner();
+
+  // Thread where the downloads of the Downloader API write their files.
+  static scoped_refptr<base::SingleThreadTaskRunner> GetFileTaskRunner();
+
  private:
   bool device_capabilities_enabled_;
+  bool downloader_enabled_;
   bool raw_sockets_enabled_;
 };
 
@@ -56,7 +56,8 @@ class DummyExtension : public XWalkExtension {
 int CountExtensions(SysAppsManager* manager) {
   XWalkExtensionVector extensions;
   STLElementDeleter<XWalkExtensionVector> deleter(&extensions);
-  manager->CreateExtensionsForExtensionThread(&extensions);
+  manager->CreateExtensionsForExtensionThread(NULL, base::FilePath(),
+                                              &extensions);
   manager->CreateExtensionsForUIThread(&extensions);
   return extensions.size();
 }
@@ -86,7 +87,8 @@ TEST_F(XWalkSysAppsManagerTest, DoesNotReplaceExtensions) {
   extensions.push_back(extension_ptr);
 
   SysAppsManager manager;
-  manager.CreateExtensionsForExtensionThread(&extensions);
+  manager.CreateExtensionsForExtensionThread(NULL, base::FilePath(),
+                                             &extensions);
   EXPECT_GE(extensions.size(), 1u);
 
   manager.CreateExtensionsForUIThread(&extensions);
@@ -1,10 +1,11 @@
-// Copyright (c 2013 Intel Corporation. All rights reserved.
+// Copyright (c) 2013 Intel Corporation. All rights reserved.
 // Copyright (c) 2013 The Chromium Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
 #include "xwalk/sysapps/device_capabilities/av_codecs_provider_ffmpeg.h"
 
+#include <map>
 #include <set>
 #include <string>
 
@@ -23,6 +24,7 @@ AVCodecsProviderFFmpeg::AVCodecsProviderFFmpeg() {
   PathService::Get(content::DIR_MEDIA_LIBS, &media_path);
   media::InitializeMediaLibrary(media_path);
   media::FFmpegGlue::InitializeFFmpeg();
+  ReadCodecRegistry();
 }
 
 AVCodecsProviderFFmpeg::~AVCodecsProviderFFmpeg() {}
@@ -30,32 +32,60 @@ AVCodecsProviderFFmpeg::~AVCodecsProviderFFmpeg() {}
 scoped_ptr<SystemAVCodecs> AVCodecsProviderFFmpeg::GetSupportedCodecs() const {
   scoped_ptr<SystemAVCodecs> av_codecs(new SystemAVCodecs);
 
-  // Get a list of supported codecs.
+  for (size_t i = 0; i < audio_formats_.size(); ++i) {
+    linked_ptr<AudioCodec> audio_codec(new AudioCodec);
+    audio_codec->format = audio_formats_[i];
+    av_codecs->audio_codecs.push_back(audio_codec);
+  }
+
+  for (size_t i = 0; i < video_formats_.size(); ++i) {
+    linked_ptr<VideoCodec> video_codec(new VideoCodec);
+    video_codec->format = video_formats_[i].format;
+    // The media pipeline only decodes in software on desktop Linux, Windows
+    // and Mac.
+    video_codec->hw_accel = false;
+    video_codec->encode = video_formats_[i].encode;
+    av_codecs->video_codecs.push_back(video_codec);
+  }
+
+  return av_codecs.Pass();
+}
+
+void AVCodecsProviderFFmpeg::ReadCodecRegistry() {
+  // The decoders and encoders of a format are registered separately under
+  // the same name, each format is reported once.
+  std::set<std::string> audio_seen;
+  std::map<std::string, size_t> video_seen;
+
   AVCodec* codec = NULL;
   while ((codec = av_codec_next(codec))) {
     if (codec->type == AVMEDIA_TYPE_AUDIO) {
       // Ensure the codec is supported by converting an FFmpeg audio codec ID
       // into its corresponding supported codec id.
-      if (media::CodecIDToAudioCodec(codec->id)) {
-        linked_ptr<AudioCodec> audio_codec(new AudioCodec);
-        audio_codec->format = std::string(codec->name);
-        av_codecs->audio_codecs.push_back(audio_codec);
-      }
+      if (media::CodecIDToAudioCodec(codec->id) &&
+          audio_seen.insert(codec->name).second)
+        audio_formats_.push_back(codec->name);
     } else if (codec->type == AVMEDIA_TYPE_VIDEO) {
       // Ensure the codec is supported by converting an FFmpeg video codec ID
       // into its corresponding supported codec id.
-      if (media::CodecIDToVideoCodec(codec->id)) {
-        linked_ptr<VideoCodec> video_codec(new VideoCodec);
-        video_codec->format = std::string(codec->name);
-        // FIXME(qjia7): find how to get hwAccel value
-        video_codec->hw_accel = false;
-        video_codec->encode = av_codec_is_encoder(codec) != 0;
-        av_codecs->video_codecs.push_back(video_codec);
+      if (!media::CodecIDToVideoCodec(codec->id))
+        continue;
+
+      bool encode = av_codec_is_encoder(codec) != 0;
+      std::map<std::string, size_t>::iterator it =
+          video_seen.find(codec->name);
+      if (it != video_seen.end()) {
+        video_formats_[it->second].encode |= encode;
+        continue;
       }
+
+      video_seen[codec->name] = video_formats_.size();
+      VideoFormat video_format;
+      video_format.format = codec->name;
+      video_format.encode = encode;
+      video_formats_.push_back(video_format);
     }
   }
-
-  return av_codecs.Pass();
 }
 
 }  // namespace sysapps
@@ -6,11 +6,16 @@
 #ifndef XWALK_SYSAPPS_DEVICE_CAPABILITIES_AV_CODECS_PROVIDER_FFMPEG_H_
 #define XWALK_SYSAPPS_DEVICE_CAPABILITIES_AV_CODECS_PROVIDER_FFMPEG_H_
 
+#include <string>
+#include <vector>
+
 #include "xwalk/sysapps/device_capabilities/av_codecs_provider.h"
 
 namespace xwalk {
 namespace sysapps {
 
+// The codecs are read from the registry of FFmpeg once, when the provider is
+// created, it doesn't change while the process runs.
 class AVCodecsProviderFFmpeg : public AVCodecsProvider {
  public:
   AVCodecsProviderFFmpeg();
@@ -19,6 +24,16 @@ class AVCodecsProviderFFmpeg : public AVCodecsProvider {
   virtual scoped_ptr<SystemAVCodecs> GetSupportedCodecs() const OVERRIDE;
 
  private:
+  struct VideoFormat {
+    std::string format;
+    bool encode;
+  };
+
+  void ReadCodecRegistry();
+
+  std::vector<std::string> audio_formats_;
+  std::vector<VideoFormat> video_formats_;
+
   DISALLOW_COPY_AND_ASSIGN(AVCodecsProviderFFmpeg);
 };
 
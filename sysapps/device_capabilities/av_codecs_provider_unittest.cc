@@ -5,6 +5,8 @@
 
 #include "xwalk/sysapps/device_capabilities/av_codecs_provider.h"
 
+#include <set>
+#include <string>
 #include <vector>
 
 #include "media/base/media.h"
@@ -30,6 +32,10 @@ TEST(XWalkSysAppsDeviceCapabilitiesTest, AVCodecsProvider) {
     EXPECT_FALSE(audio_codecs[i]->format.empty());
 
   std::vector<linked_ptr<VideoCodec> > video_codecs = info->video_codecs;
-  for (size_t i = 0; i < video_codecs.size(); ++i)
+  std::set<std::string> video_formats;
+  for (size_t i = 0; i < video_codecs.size(); ++i) {
     EXPECT_FALSE(video_codecs[i]->format.empty());
+    // Decoders and encoders of the same format are reported together.
+    EXPECT_TRUE(video_formats.insert(video_codecs[i]->format).second);
+  }
 }
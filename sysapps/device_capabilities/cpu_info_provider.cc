@@ -4,27 +4,209 @@
 
 #include "xwalk/sysapps/device_capabilities/cpu_info_provider.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "base/sys_info.h"
 
 namespace xwalk {
 namespace sysapps {
 
+namespace {
+
+const int kDefaultSamplingIntervalMs = 1000;
+const int kMinSamplingIntervalMs = 100;
+const int kMaxSamplingIntervalMs = 60000;
+
+const size_t kMaxSamples = 60;
+
+// Changes of the whole CPU utilization smaller than this are not notified.
+const double kMinUsageChange = 0.01;
+
+// user, nice, system, idle, iowait, irq, softirq and steal. Guest times are
+// already accounted in user and nice.
+const size_t kProcStatTimeFields = 8;
+const size_t kProcStatIdleField = 3;
+const size_t kProcStatIOWaitField = 4;
+
+}  // namespace
+
 CPUInfoProvider::CPUInfoProvider()
     : number_of_processors_(base::SysInfo::NumberOfProcessors()),
-      processor_architecture_(base::SysInfo::OperatingSystemArchitecture()) {
+      processor_architecture_(base::SysInfo::OperatingSystemArchitecture()),
+      last_notified_load_(-1),
+      sampling_interval_(
+          base::TimeDelta::FromMilliseconds(kDefaultSamplingIntervalMs)) {
 }
 
 CPUInfoProvider::~CPUInfoProvider() {}
 
-scoped_ptr<SystemCPU> CPUInfoProvider::cpu_info() const {
+scoped_ptr<SystemCPU> CPUInfoProvider::cpu_info() {
   scoped_ptr<SystemCPU> info(new SystemCPU);
 
   info->num_of_processors = number_of_processors_;
   info->arch_name = processor_architecture_;
-  info->load = GetCPULoad();
+
+  // While sampling, a new snapshot would only measure the time since the
+  // last sample.
+  CPUUsage usage;
+  if (timer_.IsRunning() && !samples_.empty())
+    info->load = samples_.back()->load;
+  else if (UpdateUsage(&usage))
+    info->load = usage.load;
+  else
+    info->load = GetCPULoad();
 
   return info.Pass();
 }
 
+std::vector<linked_ptr<CPUUsage> > CPUInfoProvider::cpu_usage_history() const {
+  return std::vector<linked_ptr<CPUUsage> >(samples_.begin(), samples_.end());
+}
+
+void CPUInfoProvider::AddObserver(Observer* observer) {
+  bool should_start_sampling = !observer_list_.might_have_observers();
+
+  observer_list_.AddObserver(observer);
+
+  if (should_start_sampling)
+    StartSampling();
+}
+
+void CPUInfoProvider::RemoveObserver(Observer* observer) {
+  observer_list_.RemoveObserver(observer);
+
+  if (!observer_list_.might_have_observers())
+    StopSampling();
+}
+
+bool CPUInfoProvider::HasObserver(Observer* observer) const {
+  return observer_list_.HasObserver(observer);
+}
+
+void CPUInfoProvider::SetSamplingInterval(base::TimeDelta interval) {
+  sampling_interval_ = std::min(
+      std::max(interval,
+               base::TimeDelta::FromMilliseconds(kMinSamplingIntervalMs)),
+      base::TimeDelta::FromMilliseconds(kMaxSamplingIntervalMs));
+
+  if (timer_.IsRunning()) {
+    timer_.Start(FROM_HERE, sampling_interval_,
+                 this, &CPUInfoProvider::Sample);
+  }
+}
+
+// static
+bool CPUInfoProvider::ParseProcStat(const std::string& contents,
+                                    std::vector<CPUTimes>* times) {
+  times->clear();
+
+  std::vector<std::string> lines;
+  base::SplitString(contents, '\n', &lines);
+
+  for (size_t i = 0; i < lines.size(); ++i) {
+    // The "cpu" lines come first, the whole CPU and then "cpuN" per core.
+    if (!StartsWithASCII(lines[i], "cpu", true))
+      break;
+
+    std::vector<std::string> fields;
+    base::SplitStringAlongWhitespace(lines[i], &fields);
+    if (fields.size() < kProcStatTimeFields + 1)
+      return false;
+
+    CPUTimes cpu_times;
+    uint64 idle = 0;
+    for (size_t field = 0; field < kProcStatTimeFields; ++field) {
+      uint64 value;
+      if (!base::StringToUint64(fields[field + 1], &value))
+        return false;
+
+      cpu_times.total += value;
+      if (field == kProcStatIdleField || field == kProcStatIOWaitField)
+        idle += value;
+    }
+    cpu_times.busy = cpu_times.total - idle;
+    times->push_back(cpu_times);
+  }
+
+  return !times->empty();
+}
+
+// static
+double CPUInfoProvider::GetUsage(const CPUTimes& before,
+                                 const CPUTimes& after) {
+  // The counters can go backwards when a core is brought back online.
+  if (after.total <= before.total || after.busy < before.busy)
+    return 0;
+
+  double usage = static_cast<double>(after.busy - before.busy) /
+      (after.total - before.total);
+  return std::min(usage, 1.0);
+}
+
+void CPUInfoProvider::StartSampling() {
+  samples_.clear();
+  last_notified_load_ = -1;
+
+  // The first sample needs a snapshot to compare with.
+  GetCPUTimes(&last_times_);
+  timer_.Start(FROM_HERE, sampling_interval_, this, &CPUInfoProvider::Sample);
+}
+
+void CPUInfoProvider::StopSampling() {
+  timer_.Stop();
+  samples_.clear();
+}
+
+void CPUInfoProvider::Sample() {
+  linked_ptr<CPUUsage> usage(new CPUUsage);
+  if (!UpdateUsage(usage.get()))
+    return;
+
+  if (samples_.size() == kMaxSamples)
+    samples_.pop_front();
+  samples_.push_back(usage);
+
+  if (last_notified_load_ >= 0 &&
+      std::fabs(usage->load - last_notified_load_) < kMinUsageChange) {
+    return;
+  }
+
+  last_notified_load_ = usage->load;
+  FOR_EACH_OBSERVER(Observer, observer_list_, OnCPUUsageChanged(*usage));
+}
+
+bool CPUInfoProvider::UpdateUsage(CPUUsage* usage) {
+  std::vector<CPUTimes> times;
+  if (!GetCPUTimes(&times))
+    return false;
+
+  // Nothing to compare with, or the cores changed and the per core counters
+  // can't be matched up.
+  if (last_times_.size() != times.size()) {
+    last_times_.swap(times);
+    return false;
+  }
+
+  // Not a single tick elapsed, keep measuring from the previous snapshot.
+  if (times[0].total <= last_times_[0].total)
+    return false;
+
+  std::vector<CPUTimes> last_times;
+  last_times.swap(last_times_);
+  last_times_ = times;
+
+  usage->timestamp = base::Time::Now().ToJsTime();
+  usage->load = GetUsage(last_times[0], times[0]);
+  usage->core_loads.clear();
+  for (size_t i = 1; i < times.size(); ++i)
+    usage->core_loads.push_back(GetUsage(last_times[i], times[i]));
+
+  return true;
+}
+
 }  // namespace sysapps
 }  // namespace xwalk
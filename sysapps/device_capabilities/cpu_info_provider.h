@@ -5,34 +5,106 @@
 #ifndef XWALK_SYSAPPS_DEVICE_CAPABILITIES_CPU_INFO_PROVIDER_H_
 #define XWALK_SYSAPPS_DEVICE_CAPABILITIES_CPU_INFO_PROVIDER_H_
 
+#include <deque>
 #include <string>
+#include <vector>
 
+#include "base/basictypes.h"
+#include "base/memory/linked_ptr.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/observer_list.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "xwalk/sysapps/device_capabilities/device_capabilities.h"
 
 namespace xwalk {
 namespace sysapps {
 
+using jsapi::device_capabilities::CPUUsage;
 using jsapi::device_capabilities::SystemCPU;
 
+// Besides the static CPU information, this samples the utilization of the
+// CPU, as a whole and per core, while there are observers. The samples are
+// taken every sampling_interval() and the last ones are kept for
+// cpu_usage_history().
 class CPUInfoProvider {
  public:
   CPUInfoProvider();
   ~CPUInfoProvider();
 
-  scoped_ptr<SystemCPU> cpu_info() const;
+  // Time spent by a CPU, in ticks since boot.
+  struct CPUTimes {
+    CPUTimes() : busy(0), total(0) {}
+
+    uint64 busy;
+    uint64 total;
+  };
+
+  class Observer {
+   public:
+    Observer() {}
+    virtual ~Observer() {}
+
+    // Called when the utilization of the whole CPU changed noticeably.
+    virtual void OnCPUUsageChanged(const CPUUsage& usage) = 0;
+  };
+
+  // The load is the current utilization when it can be measured.
+  scoped_ptr<SystemCPU> cpu_info();
+
+  // Oldest first, empty when nobody observes the provider.
+  std::vector<linked_ptr<CPUUsage> > cpu_usage_history() const;
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+  bool HasObserver(Observer* observer) const;
+
+  // Shared by every observer, the last one set wins. Clamped to a sensible
+  // range.
+  void SetSamplingInterval(base::TimeDelta interval);
+  base::TimeDelta sampling_interval() const { return sampling_interval_; }
+
+  // Parses the contents of /proc/stat into |times|, the whole CPU first and
+  // then each core.
+  static bool ParseProcStat(const std::string& contents,
+                            std::vector<CPUTimes>* times);
+
+  // Utilization between two snapshots, from 0 to 1.
+  static double GetUsage(const CPUTimes& before, const CPUTimes& after);
 
  private:
+  void StartSampling();
+  void StopSampling();
+  void Sample();
+
+  // Takes a new snapshot and measures the utilization since the previous one.
+  // Returns false if it can't be measured on this platform or if there was
+  // no previous snapshot.
+  bool UpdateUsage(CPUUsage* usage);
+
+  // Per platform. Whole CPU first.
+  bool GetCPUTimes(std::vector<CPUTimes>* times) const;
+
   // This is calculated from the average number of tasks in the
   // OS task queue divided by the number of CPUs in a 1 minute
   // window. The spec is not strict about how to calculate this,
   // so we use getloadavg(), which is avaliable on Linux, Mac and
-  // Android (via /proc/loadavg).
+  // Android (via /proc/loadavg). Used when the utilization can't be
+  // measured.
   double GetCPULoad() const;
 
   int number_of_processors_;
   std::string processor_architecture_;
 
+  std::vector<CPUTimes> last_times_;
+  // Ring buffer of the last samples.
+  std::deque<linked_ptr<CPUUsage> > samples_;
+  double last_notified_load_;
+
+  base::TimeDelta sampling_interval_;
+  base::RepeatingTimer<CPUInfoProvider> timer_;
+  ObserverList<Observer> observer_list_;
+
   DISALLOW_COPY_AND_ASSIGN(CPUInfoProvider);
 };
 
@@ -14,12 +14,21 @@
 namespace {
 
 const char kProcLoadavg[] = "/proc/loadavg";
+const char kProcStat[] = "/proc/stat";
 
 }  // namespace
 
 namespace xwalk {
 namespace sysapps {
 
+bool CPUInfoProvider::GetCPUTimes(std::vector<CPUTimes>* times) const {
+  std::string contents;
+  if (!base::ReadFileToString(base::FilePath(kProcStat), &contents))
+    return false;
+
+  return ParseProcStat(contents, times);
+}
+
 double CPUInfoProvider::GetCPULoad() const {
   // Bionic doesn't have a getloadavg() implementation.
   const base::FilePath proc_loadavg(kProcLoadavg);
@@ -5,11 +5,27 @@
 #include "xwalk/sysapps/device_capabilities/cpu_info_provider.h"
 
 #include <stdlib.h>
+#include <string>
+#include "base/file_util.h"
 #include "base/sys_info.h"
 
+namespace {
+
+const char kProcStat[] = "/proc/stat";
+
+}  // namespace
+
 namespace xwalk {
 namespace sysapps {
 
+bool CPUInfoProvider::GetCPUTimes(std::vector<CPUTimes>* times) const {
+  std::string contents;
+  if (!base::ReadFileToString(base::FilePath(kProcStat), &contents))
+    return false;
+
+  return ParseProcStat(contents, times);
+}
+
 double CPUInfoProvider::GetCPULoad() const {
   double load;
   getloadavg(&load, 1);
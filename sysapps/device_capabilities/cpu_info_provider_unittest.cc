@@ -4,6 +4,8 @@
 
 #include "xwalk/sysapps/device_capabilities/cpu_info_provider.h"
 
+#include <vector>
+
 #include "testing/gtest/include/gtest/gtest.h"
 #include "xwalk/sysapps/device_capabilities/device_capabilities.h"
 
@@ -26,3 +28,58 @@ TEST(XWalkSysAppsDeviceCapabilitiesTest, CPUInfoProvider) {
     EXPECT_LE(info->load, 1);
   }
 }
+
+TEST(XWalkSysAppsDeviceCapabilitiesTest, CPUInfoProviderParseProcStat) {
+  const char kProcStat[] =
+      "cpu  400 0 100 1400 100 0 0 0 0 0\n"
+      "cpu0 300 0 50 600 50 0 0 0 0 0\n"
+      "cpu1 100 0 50 800 50 0 0 0 0 0\n"
+      "intr 12345 0 0\n"
+      "ctxt 6789\n";
+
+  std::vector<CPUInfoProvider::CPUTimes> times;
+  ASSERT_TRUE(CPUInfoProvider::ParseProcStat(kProcStat, &times));
+  ASSERT_EQ(3u, times.size());
+
+  // Idle and I/O wait times are not busy.
+  EXPECT_EQ(500u, times[0].busy);
+  EXPECT_EQ(2000u, times[0].total);
+  EXPECT_EQ(350u, times[1].busy);
+  EXPECT_EQ(1000u, times[1].total);
+  EXPECT_EQ(150u, times[2].busy);
+  EXPECT_EQ(1000u, times[2].total);
+
+  EXPECT_FALSE(CPUInfoProvider::ParseProcStat("cpu 1 2 3\n", &times));
+  EXPECT_FALSE(CPUInfoProvider::ParseProcStat("intr 1 2 3\n", &times));
+}
+
+TEST(XWalkSysAppsDeviceCapabilitiesTest, CPUInfoProviderGetUsage) {
+  CPUInfoProvider::CPUTimes before;
+  before.busy = 100;
+  before.total = 1000;
+
+  CPUInfoProvider::CPUTimes after;
+  after.busy = 175;
+  after.total = 1100;
+  EXPECT_DOUBLE_EQ(0.75, CPUInfoProvider::GetUsage(before, after));
+
+  // No time elapsed, or counters reset by a core going offline.
+  EXPECT_EQ(0, CPUInfoProvider::GetUsage(after, after));
+  EXPECT_EQ(0, CPUInfoProvider::GetUsage(after, before));
+}
+
+TEST(XWalkSysAppsDeviceCapabilitiesTest, CPUInfoProviderSamplingInterval) {
+  CPUInfoProvider provider;
+
+  provider.SetSamplingInterval(base::TimeDelta::FromMilliseconds(500));
+  EXPECT_EQ(500, provider.sampling_interval().InMilliseconds());
+
+  provider.SetSamplingInterval(base::TimeDelta());
+  EXPECT_LT(0, provider.sampling_interval().InMilliseconds());
+
+  provider.SetSamplingInterval(base::TimeDelta::FromDays(1));
+  EXPECT_GT(base::TimeDelta::FromDays(1), provider.sampling_interval());
+
+  // Nothing is sampled without observers.
+  EXPECT_TRUE(provider.cpu_usage_history().empty());
+}
@@ -9,6 +9,11 @@
 namespace xwalk {
 namespace sysapps {
 
+bool CPUInfoProvider::GetCPUTimes(std::vector<CPUTimes>* times) const {
+  NOTIMPLEMENTED();
+  return false;
+}
+
 double CPUInfoProvider::GetCPULoad() const {
   NOTIMPLEMENTED();
   return 0;
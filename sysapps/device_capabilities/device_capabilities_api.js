@@ -20,16 +20,22 @@ var DeviceCapabilities = function() {
 
   internal.postMessage("deviceCapabilitiesConstructor", [this._id]);
 
+  this._addEvent("cpuusagechange");
   this._addEvent("displayconnect");
   this._addEvent("displaydisconnect");
+  this._addEvent("memorypressure");
   this._addEvent("storageattach");
   this._addEvent("storagedetach");
 
   this._addMethodWithPromise("getAVCodecs", Promise);
   this._addMethodWithPromise("getCPUInfo", Promise);
+  this._addMethodWithPromise("getCPUUsageHistory", Promise);
   this._addMethodWithPromise("getDisplayInfo", Promise);
   this._addMethodWithPromise("getMemoryInfo", Promise);
   this._addMethodWithPromise("getStorageInfo", Promise);
+
+  // The interval between two samples of "cpuusagechange", in milliseconds.
+  this._addMethod("setCPUSamplingInterval");
 };
 
 DeviceCapabilities.prototype = new common.EventTargetPrototype();
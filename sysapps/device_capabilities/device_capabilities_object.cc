@@ -9,6 +9,7 @@
 #include "xwalk/sysapps/common/sysapps_manager.h"
 #include "xwalk/sysapps/device_capabilities/av_codecs_provider.h"
 #include "xwalk/sysapps/device_capabilities/cpu_info_provider.h"
+#include "xwalk/sysapps/device_capabilities/device_capabilities_snapshot.h"
 #include "xwalk/sysapps/device_capabilities/display_info_provider.h"
 #include "xwalk/sysapps/device_capabilities/memory_info_provider.h"
 #include "xwalk/sysapps/device_capabilities/storage_info_provider.h"
@@ -25,6 +26,12 @@ DeviceCapabilitiesObject::DeviceCapabilitiesObject() {
   handler_.Register("getCPUInfo",
                     base::Bind(&DeviceCapabilitiesObject::OnGetCPUInfo,
                                base::Unretained(this)));
+  handler_.Register("getCPUUsageHistory",
+                    base::Bind(&DeviceCapabilitiesObject::OnGetCPUUsageHistory,
+                               base::Unretained(this)));
+  handler_.Register("setCPUSamplingInterval",
+      base::Bind(&DeviceCapabilitiesObject::OnSetCPUSamplingInterval,
+                 base::Unretained(this)));
   handler_.Register("getDisplayInfo",
                     base::Bind(&DeviceCapabilitiesObject::OnGetDisplayInfo,
                                base::Unretained(this)));
@@ -37,6 +44,12 @@ DeviceCapabilitiesObject::DeviceCapabilitiesObject() {
 }
 
 DeviceCapabilitiesObject::~DeviceCapabilitiesObject() {
+  if (SysAppsManager::GetCPUInfoProvider()->HasObserver(this))
+    SysAppsManager::GetCPUInfoProvider()->RemoveObserver(this);
+
+  if (SysAppsManager::GetMemoryInfoProvider()->HasObserver(this))
+    SysAppsManager::GetMemoryInfoProvider()->RemoveObserver(this);
+
   if (SysAppsManager::GetStorageInfoProvider()->HasObserver(this))
     SysAppsManager::GetStorageInfoProvider()->RemoveObserver(this);
 
@@ -45,7 +58,13 @@ DeviceCapabilitiesObject::~DeviceCapabilitiesObject() {
 }
 
 void DeviceCapabilitiesObject::StartEvent(const std::string& type) {
-  if (type == "storageattach" || type == "storagedetach") {
+  if (type == "cpuusagechange") {
+    if (!SysAppsManager::GetCPUInfoProvider()->HasObserver(this))
+      SysAppsManager::GetCPUInfoProvider()->AddObserver(this);
+  } else if (type == "memorypressure") {
+    if (!SysAppsManager::GetMemoryInfoProvider()->HasObserver(this))
+      SysAppsManager::GetMemoryInfoProvider()->AddObserver(this);
+  } else if (type == "storageattach" || type == "storagedetach") {
     if (!SysAppsManager::GetStorageInfoProvider()->HasObserver(this))
       SysAppsManager::GetStorageInfoProvider()->AddObserver(this);
   } else if (type == "displayconnect" || type == "displaydisconnect") {
@@ -55,7 +74,11 @@ void DeviceCapabilitiesObject::StartEvent(const std::string& type) {
 }
 
 void DeviceCapabilitiesObject::StopEvent(const std::string& type) {
-  if (type == "storageattach" || type == "storagedetach") {
+  if (type == "cpuusagechange") {
+    SysAppsManager::GetCPUInfoProvider()->RemoveObserver(this);
+  } else if (type == "memorypressure") {
+    SysAppsManager::GetMemoryInfoProvider()->RemoveObserver(this);
+  } else if (type == "storageattach" || type == "storagedetach") {
     if (!IsEventActive("storageattach") && !IsEventActive("storagedetach"))
       SysAppsManager::GetStorageInfoProvider()->RemoveObserver(this);
   } else if (type == "displayconnect" || type == "displaydisconnect") {
@@ -64,6 +87,13 @@ void DeviceCapabilitiesObject::StopEvent(const std::string& type) {
   }
 }
 
+void DeviceCapabilitiesObject::OnCPUUsageChanged(const CPUUsage& usage) {
+  scoped_ptr<base::ListValue> eventData(new base::ListValue);
+  eventData->Append(usage.ToValue().release());
+
+  DispatchEvent("cpuusagechange", eventData.Pass());
+}
+
 void DeviceCapabilitiesObject::OnDisplayConnected(const DisplayUnit& display) {
   scoped_ptr<base::ListValue> eventData(new base::ListValue);
   eventData->Append(display.ToValue().release());
@@ -79,6 +109,14 @@ void DeviceCapabilitiesObject::OnDisplayDisconnected(
   DispatchEvent("displaydisconnect", eventData.Pass());
 }
 
+void DeviceCapabilitiesObject::OnMemoryPressure(
+    const MemoryPressure& pressure) {
+  scoped_ptr<base::ListValue> eventData(new base::ListValue);
+  eventData->Append(pressure.ToValue().release());
+
+  DispatchEvent("memorypressure", eventData.Pass());
+}
+
 void DeviceCapabilitiesObject::OnStorageAttached(const StorageUnit& storage) {
   scoped_ptr<base::ListValue> eventData(new base::ListValue);
   eventData->Append(storage.ToValue().release());
@@ -95,9 +133,10 @@ void DeviceCapabilitiesObject::OnStorageDetached(const StorageUnit& storage) {
 
 void DeviceCapabilitiesObject::OnGetAVCodecs(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
-  scoped_ptr<SystemAVCodecs> av_codecs(
-      SysAppsManager::GetAVCodecsProvider()->GetSupportedCodecs());
-  info->PostResult(GetAVCodecs::Results::Create(*av_codecs, std::string()));
+  DeviceCapabilitiesSnapshot* snapshot(
+      SysAppsManager::GetDeviceCapabilitiesSnapshot());
+  info->PostResult(GetAVCodecs::Results::Create(snapshot->av_codecs(),
+                                                std::string()));
 }
 
 void DeviceCapabilitiesObject::OnGetCPUInfo(
@@ -107,11 +146,32 @@ void DeviceCapabilitiesObject::OnGetCPUInfo(
   info->PostResult(GetCPUInfo::Results::Create(*cpu_info, std::string()));
 }
 
+void DeviceCapabilitiesObject::OnGetCPUUsageHistory(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  info->PostResult(GetCPUUsageHistory::Results::Create(
+      SysAppsManager::GetCPUInfoProvider()->cpu_usage_history(),
+      std::string()));
+}
+
+void DeviceCapabilitiesObject::OnSetCPUSamplingInterval(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  scoped_ptr<SetCPUSamplingInterval::Params>
+      params(SetCPUSamplingInterval::Params::Create(*info->arguments()));
+
+  if (!params) {
+    LOG(WARNING) << "Malformed parameters passed to " << info->name();
+    return;
+  }
+
+  SysAppsManager::GetCPUInfoProvider()->SetSamplingInterval(
+      base::TimeDelta::FromMilliseconds(params->interval));
+}
+
 void DeviceCapabilitiesObject::OnGetDisplayInfo(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
-  DisplayInfoProvider* provider(SysAppsManager::GetDisplayInfoProvider());
-  scoped_ptr<SystemDisplay> display_info(provider->display_info());
-  info->PostResult(GetDisplayInfo::Results::Create(*display_info,
+  DeviceCapabilitiesSnapshot* snapshot(
+      SysAppsManager::GetDeviceCapabilitiesSnapshot());
+  info->PostResult(GetDisplayInfo::Results::Create(snapshot->display_info(),
                                                    std::string()));
 }
 
@@ -135,9 +195,9 @@ void DeviceCapabilitiesObject::OnGetStorageInfo(
     return;
   }
 
-  scoped_ptr<SystemStorage> storage_info(provider->storage_info());
   info->PostResult(GetStorageInfo::Results::Create(
-      *storage_info, std::string()));
+      SysAppsManager::GetDeviceCapabilitiesSnapshot()->storage_info(),
+      std::string()));
 }
 
 }  // namespace sysapps
@@ -7,14 +7,18 @@
 
 #include <string>
 #include "xwalk/sysapps/common/event_target.h"
+#include "xwalk/sysapps/device_capabilities/cpu_info_provider.h"
 #include "xwalk/sysapps/device_capabilities/display_info_provider.h"
+#include "xwalk/sysapps/device_capabilities/memory_info_provider.h"
 #include "xwalk/sysapps/device_capabilities/storage_info_provider.h"
 
 namespace xwalk {
 namespace sysapps {
 
 class DeviceCapabilitiesObject : public EventTarget,
+                                 public CPUInfoProvider::Observer,
                                  public DisplayInfoProvider::Observer,
+                                 public MemoryInfoProvider::Observer,
                                  public StorageInfoProvider::Observer {
  public:
   DeviceCapabilitiesObject();
@@ -24,10 +28,16 @@ class DeviceCapabilitiesObject : public EventTarget,
   virtual void StartEvent(const std::string& type) OVERRIDE;
   virtual void StopEvent(const std::string& type) OVERRIDE;
 
+  // CPUInfoProvider::Observer implementation.
+  virtual void OnCPUUsageChanged(const CPUUsage& usage) OVERRIDE;
+
   // DisplayInfoProvider::Observer implementation.
   virtual void OnDisplayConnected(const DisplayUnit& display) OVERRIDE;
   virtual void OnDisplayDisconnected(const DisplayUnit& display) OVERRIDE;
 
+  // MemoryInfoProvider::Observer implementation.
+  virtual void OnMemoryPressure(const MemoryPressure& pressure) OVERRIDE;
+
   // StorageInfoProvider::Observer implementation.
   virtual void OnStorageAttached(const StorageUnit& storage) OVERRIDE;
   virtual void OnStorageDetached(const StorageUnit& storage) OVERRIDE;
@@ -35,6 +45,8 @@ class DeviceCapabilitiesObject : public EventTarget,
  private:
   void OnGetAVCodecs(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnGetCPUInfo(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnGetCPUUsageHistory(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnSetCPUSamplingInterval(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnGetDisplayInfo(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnGetMemoryInfo(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnGetStorageInfo(scoped_ptr<XWalkExtensionFunctionInfo> info);
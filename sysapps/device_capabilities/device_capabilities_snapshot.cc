@@ -0,0 +1,79 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/device_capabilities/device_capabilities_snapshot.h"
+
+#include "xwalk/sysapps/common/sysapps_manager.h"
+#include "xwalk/sysapps/device_capabilities/av_codecs_provider.h"
+
+namespace xwalk {
+namespace sysapps {
+
+DeviceCapabilitiesSnapshot::DeviceCapabilitiesSnapshot() {}
+
+DeviceCapabilitiesSnapshot::~DeviceCapabilitiesSnapshot() {
+  if (SysAppsManager::GetStorageInfoProvider()->HasObserver(this))
+    SysAppsManager::GetStorageInfoProvider()->RemoveObserver(this);
+
+  if (SysAppsManager::GetDisplayInfoProvider()->HasObserver(this))
+    SysAppsManager::GetDisplayInfoProvider()->RemoveObserver(this);
+}
+
+const SystemAVCodecs& DeviceCapabilitiesSnapshot::av_codecs() {
+  if (!av_codecs_)
+    av_codecs_ = SysAppsManager::GetAVCodecsProvider()->GetSupportedCodecs();
+
+  return *av_codecs_;
+}
+
+const SystemDisplay& DeviceCapabilitiesSnapshot::display_info() {
+  if (!display_info_) {
+    DisplayInfoProvider* provider(SysAppsManager::GetDisplayInfoProvider());
+    // Observing first, so no change gets lost.
+    if (!provider->HasObserver(this))
+      provider->AddObserver(this);
+    display_info_ = provider->display_info();
+  }
+
+  return *display_info_;
+}
+
+const SystemStorage& DeviceCapabilitiesSnapshot::storage_info() {
+  if (!storage_info_) {
+    StorageInfoProvider* provider(SysAppsManager::GetStorageInfoProvider());
+    DCHECK(provider->IsInitialized());
+    if (!provider->HasObserver(this))
+      provider->AddObserver(this);
+    storage_info_ = provider->storage_info();
+  }
+
+  return *storage_info_;
+}
+
+void DeviceCapabilitiesSnapshot::OnDisplayConnected(
+    const DisplayUnit& display) {
+  display_info_.reset();
+}
+
+void DeviceCapabilitiesSnapshot::OnDisplayDisconnected(
+    const DisplayUnit& display) {
+  display_info_.reset();
+}
+
+void DeviceCapabilitiesSnapshot::OnDisplayChanged(const DisplayUnit& display) {
+  display_info_.reset();
+}
+
+void DeviceCapabilitiesSnapshot::OnStorageAttached(
+    const StorageUnit& storage) {
+  storage_info_.reset();
+}
+
+void DeviceCapabilitiesSnapshot::OnStorageDetached(
+    const StorageUnit& storage) {
+  storage_info_.reset();
+}
+
+}  // namespace sysapps
+}  // namespace xwalk
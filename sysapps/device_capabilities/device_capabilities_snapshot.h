@@ -0,0 +1,59 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_SYSAPPS_DEVICE_CAPABILITIES_DEVICE_CAPABILITIES_SNAPSHOT_H_
+#define XWALK_SYSAPPS_DEVICE_CAPABILITIES_DEVICE_CAPABILITIES_SNAPSHOT_H_
+
+#include "base/memory/scoped_ptr.h"
+#include "xwalk/sysapps/device_capabilities/device_capabilities.h"
+#include "xwalk/sysapps/device_capabilities/display_info_provider.h"
+#include "xwalk/sysapps/device_capabilities/storage_info_provider.h"
+
+namespace xwalk {
+namespace sysapps {
+
+using jsapi::device_capabilities::SystemAVCodecs;
+
+// Process-wide cache of the capabilities that only change with hardware
+// events, shared by every DeviceCapabilitiesObject. The codecs never change,
+// the displays and storages are invalidated by the notifications of their
+// providers, which keep monitoring once something was cached. The CPU and
+// memory providers already cache their static parts and the rest, load and
+// available memory, has to be measured on every call.
+//
+// Like the providers, this lives on the thread of the Device Capabilities
+// extension.
+class DeviceCapabilitiesSnapshot : public DisplayInfoProvider::Observer,
+                                   public StorageInfoProvider::Observer {
+ public:
+  DeviceCapabilitiesSnapshot();
+  virtual ~DeviceCapabilitiesSnapshot();
+
+  const SystemAVCodecs& av_codecs();
+  const SystemDisplay& display_info();
+
+  // The storage provider must be initialized.
+  const SystemStorage& storage_info();
+
+  // DisplayInfoProvider::Observer implementation.
+  virtual void OnDisplayConnected(const DisplayUnit& display) OVERRIDE;
+  virtual void OnDisplayDisconnected(const DisplayUnit& display) OVERRIDE;
+  virtual void OnDisplayChanged(const DisplayUnit& display) OVERRIDE;
+
+  // StorageInfoProvider::Observer implementation.
+  virtual void OnStorageAttached(const StorageUnit& storage) OVERRIDE;
+  virtual void OnStorageDetached(const StorageUnit& storage) OVERRIDE;
+
+ private:
+  scoped_ptr<SystemAVCodecs> av_codecs_;
+  scoped_ptr<SystemDisplay> display_info_;
+  scoped_ptr<SystemStorage> storage_info_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeviceCapabilitiesSnapshot);
+};
+
+}  // namespace sysapps
+}  // namespace xwalk
+
+#endif  // XWALK_SYSAPPS_DEVICE_CAPABILITIES_DEVICE_CAPABILITIES_SNAPSHOT_H_
@@ -0,0 +1,56 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/device_capabilities/device_capabilities_snapshot.h"
+
+#include <vector>
+
+#include "base/message_loop/message_loop.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/base/layout.h"
+#include "ui/gfx/screen.h"
+#include "xwalk/sysapps/common/sysapps_manager.h"
+
+#if defined(USE_AURA)
+#include "ui/views/widget/desktop_aura/desktop_screen.h"
+#endif
+
+using xwalk::jsapi::device_capabilities::DisplayUnit;
+using xwalk::jsapi::device_capabilities::SystemAVCodecs;
+using xwalk::jsapi::device_capabilities::SystemDisplay;
+using xwalk::sysapps::DeviceCapabilitiesSnapshot;
+using xwalk::sysapps::SysAppsManager;
+
+TEST(XWalkSysAppsDeviceCapabilitiesTest, DeviceCapabilitiesSnapshot) {
+  base::MessageLoop message_loop(base::MessageLoop::TYPE_UI);
+
+#if defined(USE_AURA)
+  std::vector<ui::ScaleFactor> supported_scale_factors;
+  supported_scale_factors.push_back(ui::SCALE_FACTOR_200P);
+  ui::SetSupportedScaleFactors(supported_scale_factors);
+
+  gfx::Screen::SetScreenInstance(
+      gfx::SCREEN_TYPE_NATIVE, views::CreateDesktopScreen());
+#endif
+
+  DeviceCapabilitiesSnapshot snapshot;
+
+  // The same results are handed out until something changes.
+  const SystemAVCodecs* av_codecs = &snapshot.av_codecs();
+  EXPECT_EQ(av_codecs, &snapshot.av_codecs());
+
+  const SystemDisplay* display_info = &snapshot.display_info();
+  EXPECT_EQ(display_info->displays.size(),
+            snapshot.display_info().displays.size());
+  EXPECT_EQ(display_info, &snapshot.display_info());
+  EXPECT_TRUE(
+      SysAppsManager::GetDisplayInfoProvider()->HasObserver(&snapshot));
+
+  // A display event invalidates the cached displays, the next query runs
+  // the provider again.
+  DisplayUnit display;
+  snapshot.OnDisplayConnected(display);
+  const SystemDisplay& new_display_info = snapshot.display_info();
+  EXPECT_EQ(display_info->displays.size(), new_display_info.displays.size());
+}
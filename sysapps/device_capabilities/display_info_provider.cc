@@ -19,6 +19,9 @@ namespace {
 // ChromiumOS. See display_info_provider_chromeos.cc.
 const float kDpi96 = 96;
 
+// One frame at 60 Hz.
+const int kDisplayChangeDelayMs = 16;
+
 linked_ptr<DisplayUnit> makeDisplayUnit(const gfx::Display& display) {
   gfx::Screen* screen = gfx::Screen::GetNativeScreen();
   const int64 primary_display_id = screen->GetPrimaryDisplay().id();
@@ -103,18 +106,49 @@ void DisplayInfoProvider::StartDisplayMonitoring() {
 void DisplayInfoProvider::StopDisplayMonitoring() {
   gfx::Screen* screen = gfx::Screen::GetNativeScreen();
   screen->RemoveObserver(this);
+  change_timer_.Stop();
+  pending_changes_.clear();
+}
+
+void DisplayInfoProvider::OnDisplayMetricsChanged(const gfx::Display& display,
+                                                  uint32_t metrics) {
+  pending_changes_[display.id()] = display;
+  if (!change_timer_.IsRunning()) {
+    change_timer_.Start(
+        FROM_HERE, base::TimeDelta::FromMilliseconds(kDisplayChangeDelayMs),
+        this, &DisplayInfoProvider::NotifyPendingChanges);
+  }
 }
 
 void DisplayInfoProvider::OnDisplayAdded(const gfx::Display& display) {
+  NotifyPendingChanges();
+  // Built once, FOR_EACH_OBSERVER evaluates its arguments for each observer.
+  linked_ptr<DisplayUnit> display_unit = makeDisplayUnit(display);
   FOR_EACH_OBSERVER(Observer,
                     observer_list_,
-                    OnDisplayConnected(*makeDisplayUnit(display)));
+                    OnDisplayConnected(*display_unit));
 }
 
 void DisplayInfoProvider::OnDisplayRemoved(const gfx::Display& display) {
+  pending_changes_.erase(display.id());
+  NotifyPendingChanges();
+  linked_ptr<DisplayUnit> display_unit = makeDisplayUnit(display);
   FOR_EACH_OBSERVER(Observer,
                     observer_list_,
-                    OnDisplayDisconnected(*makeDisplayUnit(display)));
+                    OnDisplayDisconnected(*display_unit));
+}
+
+void DisplayInfoProvider::NotifyPendingChanges() {
+  change_timer_.Stop();
+  std::map<int64, gfx::Display> changes;
+  changes.swap(pending_changes_);
+  for (std::map<int64, gfx::Display>::const_iterator it = changes.begin();
+       it != changes.end(); ++it) {
+    linked_ptr<DisplayUnit> display_unit = makeDisplayUnit(it->second);
+    FOR_EACH_OBSERVER(Observer,
+                      observer_list_,
+                      OnDisplayChanged(*display_unit));
+  }
 }
 
 }  // namespace sysapps
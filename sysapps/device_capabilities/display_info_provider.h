@@ -6,8 +6,12 @@
 #ifndef XWALK_SYSAPPS_DEVICE_CAPABILITIES_DISPLAY_INFO_PROVIDER_H_
 #define XWALK_SYSAPPS_DEVICE_CAPABILITIES_DISPLAY_INFO_PROVIDER_H_
 
+#include <map>
+
 #include "base/memory/scoped_ptr.h"
 #include "base/observer_list.h"
+#include "base/timer/timer.h"
+#include "ui/gfx/display.h"
 #include "ui/gfx/display_observer.h"
 #include "xwalk/sysapps/device_capabilities/device_capabilities.h"
 
@@ -31,6 +35,11 @@ class DisplayInfoProvider : public gfx::DisplayObserver {
 
     virtual void OnDisplayConnected(const DisplayUnit& display) = 0;
     virtual void OnDisplayDisconnected(const DisplayUnit& display) = 0;
+    // Bounds, work area or scale factor changes. There is no event for
+    // them in the API, only caches are interested. A rotation changes the
+    // bounds and the work area one after the other, the changes of a frame
+    // are notified once.
+    virtual void OnDisplayChanged(const DisplayUnit& display) {}
   };
 
   void AddObserver(Observer* observer);
@@ -43,11 +52,17 @@ class DisplayInfoProvider : public gfx::DisplayObserver {
 
   // gfx::DisplayObserver implementation.
   virtual void OnDisplayMetricsChanged(const gfx::Display& display,
-                                       uint32_t metrics) OVERRIDE {}
+                                       uint32_t metrics) OVERRIDE;
   virtual void OnDisplayAdded(const gfx::Display& display) OVERRIDE;
   virtual void OnDisplayRemoved(const gfx::Display& display) OVERRIDE;
 
+  // Sent before the displays are added or removed too, to keep the order.
+  void NotifyPendingChanges();
+
   ObserverList<Observer> observer_list_;
+  // The last state of each changed display, by id.
+  std::map<int64, gfx::Display> pending_changes_;
+  base::OneShotTimer<DisplayInfoProvider> change_timer_;
 
   DISALLOW_COPY_AND_ASSIGN(DisplayInfoProvider);
 };
@@ -5,13 +5,27 @@
 
 #include "xwalk/sysapps/device_capabilities/memory_info_provider.h"
 
+#include "base/bind.h"
 #include "base/sys_info.h"
 
 namespace xwalk {
 namespace sysapps {
 
+using namespace jsapi::device_capabilities; // NOLINT
+
+namespace {
+
+const int kPollingIntervalMs = 1000;
+
+// Fractions of the physical memory still available.
+const double kModeratePressureRatio = 0.2;
+const double kCriticalPressureRatio = 0.1;
+
+}  // namespace
+
 MemoryInfoProvider::MemoryInfoProvider()
-  : amount_of_physical_memory_(base::SysInfo::AmountOfPhysicalMemory()) {}
+  : amount_of_physical_memory_(base::SysInfo::AmountOfPhysicalMemory()),
+    last_level_(MEMORY_PRESSURE_LEVEL_NONE) {}
 
 MemoryInfoProvider::~MemoryInfoProvider() {}
 
@@ -24,5 +38,81 @@ scoped_ptr<SystemMemory> MemoryInfoProvider::memory_info() const {
   return info.Pass();
 }
 
+void MemoryInfoProvider::AddObserver(Observer* observer) {
+  bool should_start_monitoring = !observer_list_.might_have_observers();
+
+  observer_list_.AddObserver(observer);
+
+  if (should_start_monitoring)
+    StartMemoryMonitoring();
+}
+
+void MemoryInfoProvider::RemoveObserver(Observer* observer) {
+  observer_list_.RemoveObserver(observer);
+
+  if (!observer_list_.might_have_observers())
+    StopMemoryMonitoring();
+}
+
+bool MemoryInfoProvider::HasObserver(Observer* observer) const {
+  return observer_list_.HasObserver(observer);
+}
+
+// static
+MemoryPressureLevel MemoryInfoProvider::GetPressureLevel(
+    double available_ratio) {
+  if (available_ratio < kCriticalPressureRatio)
+    return MEMORY_PRESSURE_LEVEL_CRITICAL;
+  if (available_ratio < kModeratePressureRatio)
+    return MEMORY_PRESSURE_LEVEL_MODERATE;
+  return MEMORY_PRESSURE_LEVEL_NONE;
+}
+
+void MemoryInfoProvider::StartMemoryMonitoring() {
+  last_level_ = MEMORY_PRESSURE_LEVEL_NONE;
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&MemoryInfoProvider::OnSystemMemoryPressure,
+                 base::Unretained(this))));
+  timer_.Start(FROM_HERE,
+               base::TimeDelta::FromMilliseconds(kPollingIntervalMs),
+               this, &MemoryInfoProvider::CheckMemoryPressure);
+}
+
+void MemoryInfoProvider::StopMemoryMonitoring() {
+  timer_.Stop();
+  memory_pressure_listener_.reset();
+}
+
+void MemoryInfoProvider::CheckMemoryPressure() {
+  if (amount_of_physical_memory_ <= 0)
+    return;
+
+  MemoryPressureLevel level = GetPressureLevel(
+      base::SysInfo::AmountOfAvailablePhysicalMemory() /
+      amount_of_physical_memory_);
+
+  bool should_notify = level > last_level_;
+  last_level_ = level;
+
+  if (should_notify)
+    NotifyMemoryPressure(level);
+}
+
+void MemoryInfoProvider::OnSystemMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  // The system knows better, always tell.
+  NotifyMemoryPressure(
+      level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL ?
+          MEMORY_PRESSURE_LEVEL_CRITICAL : MEMORY_PRESSURE_LEVEL_MODERATE);
+}
+
+void MemoryInfoProvider::NotifyMemoryPressure(MemoryPressureLevel level) {
+  MemoryPressure pressure;
+  pressure.level = ToString(level);
+  pressure.avail_capacity = base::SysInfo::AmountOfAvailablePhysicalMemory();
+
+  FOR_EACH_OBSERVER(Observer, observer_list_, OnMemoryPressure(pressure));
+}
+
 }  // namespace sysapps
 }  // namespace xwalk
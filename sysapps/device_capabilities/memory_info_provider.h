@@ -6,14 +6,22 @@
 #ifndef XWALK_SYSAPPS_DEVICE_CAPABILITIES_MEMORY_INFO_PROVIDER_H_
 #define XWALK_SYSAPPS_DEVICE_CAPABILITIES_MEMORY_INFO_PROVIDER_H_
 
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/observer_list.h"
+#include "base/timer/timer.h"
 #include "xwalk/sysapps/device_capabilities/device_capabilities.h"
 
 namespace xwalk {
 namespace sysapps {
 
+using jsapi::device_capabilities::MemoryPressure;
+using jsapi::device_capabilities::MemoryPressureLevel;
 using jsapi::device_capabilities::SystemMemory;
 
+// While there are observers, the available memory is polled, which reads
+// /proc/meminfo on Linux and Tizen, and the memory pressure signals of the
+// system are listened to, which come from onTrimMemory() on Android.
 class MemoryInfoProvider {
  public:
   MemoryInfoProvider();
@@ -21,9 +29,41 @@ class MemoryInfoProvider {
 
   scoped_ptr<SystemMemory> memory_info() const;
 
+  class Observer {
+   public:
+    Observer() {}
+    virtual ~Observer() {}
+
+    virtual void OnMemoryPressure(const MemoryPressure& pressure) = 0;
+  };
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+  bool HasObserver(Observer* observer) const;
+
+  // Level for a given ratio of available memory, NONE when there is no
+  // pressure.
+  static MemoryPressureLevel GetPressureLevel(double available_ratio);
+
  private:
+  void StartMemoryMonitoring();
+  void StopMemoryMonitoring();
+
+  void CheckMemoryPressure();
+  void OnSystemMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+  void NotifyMemoryPressure(MemoryPressureLevel level);
+
   double amount_of_physical_memory_;
 
+  // Polling only notifies when the level goes up, not over and over while
+  // the memory stays low.
+  MemoryPressureLevel last_level_;
+
+  base::RepeatingTimer<MemoryInfoProvider> timer_;
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  ObserverList<Observer> observer_list_;
+
   DISALLOW_COPY_AND_ASSIGN(MemoryInfoProvider);
 };
 
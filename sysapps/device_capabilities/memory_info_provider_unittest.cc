@@ -18,3 +18,18 @@ TEST(XWalkSysAppsDeviceCapabilitiesTest, MemoryInfoProvider) {
   EXPECT_GE(info->capacity, 0);
   EXPECT_GE(info->capacity, info->avail_capacity);
 }
+
+TEST(XWalkSysAppsDeviceCapabilitiesTest, MemoryInfoProviderPressureLevel) {
+  using namespace xwalk::jsapi::device_capabilities; // NOLINT
+
+  EXPECT_EQ(MEMORY_PRESSURE_LEVEL_NONE,
+            MemoryInfoProvider::GetPressureLevel(0.5));
+  EXPECT_EQ(MEMORY_PRESSURE_LEVEL_MODERATE,
+            MemoryInfoProvider::GetPressureLevel(0.15));
+  EXPECT_EQ(MEMORY_PRESSURE_LEVEL_CRITICAL,
+            MemoryInfoProvider::GetPressureLevel(0.05));
+
+  // Levels are ordered, so a rise in pressure can be told apart.
+  EXPECT_LT(MEMORY_PRESSURE_LEVEL_NONE, MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_LT(MEMORY_PRESSURE_LEVEL_MODERATE, MEMORY_PRESSURE_LEVEL_CRITICAL);
+}
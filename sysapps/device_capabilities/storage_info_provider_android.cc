@@ -4,18 +4,68 @@
 
 #include "xwalk/sysapps/device_capabilities/storage_info_provider_android.h"
 
+#include <sys/statvfs.h>
+
+#include <stdlib.h>
+
+#include "base/logging.h"
+
+using namespace xwalk::jsapi::device_capabilities; // NOLINT
+
+namespace {
+
+const int kCapacityRefreshSeconds = 60;
+
+}  // namespace
+
 namespace xwalk {
 namespace sysapps {
 
 StorageInfoProviderAndroid::StorageInfoProviderAndroid() {
+  Unit internal;
+  internal.id = "internal";
+  internal.name = "Internal storage";
+  internal.type = ToString(STORAGE_UNIT_TYPE_FIXED);
+  internal.path = base::FilePath("/data");
+  internal.capacity = 0;
+  units_.push_back(internal);
+
+  // Set by the zygote to the mount point of the SD card, or of its
+  // emulation on the internal storage.
+  const char* external_storage = getenv("EXTERNAL_STORAGE");
+  if (external_storage && *external_storage) {
+    Unit external;
+    external.id = "external";
+    external.name = "External storage";
+    external.type = ToString(STORAGE_UNIT_TYPE_REMOVABLE);
+    external.path = base::FilePath(external_storage);
+    external.capacity = 0;
+    units_.push_back(external);
+  }
+
   MarkInitialized();
 }
 
 StorageInfoProviderAndroid::~StorageInfoProviderAndroid() {}
 
 scoped_ptr<SystemStorage> StorageInfoProviderAndroid::storage_info() const {
-  NOTIMPLEMENTED();
-  return make_scoped_ptr(new SystemStorage);
+  RefreshCapacities();
+
+  scoped_ptr<SystemStorage> info(new SystemStorage);
+  for (size_t i = 0; i < units_.size(); ++i) {
+    // Not mounted when the last refresh happened.
+    if (!units_[i].capacity)
+      continue;
+
+    linked_ptr<StorageUnit> storage_unit(make_linked_ptr(new StorageUnit));
+    storage_unit->id = units_[i].id;
+    storage_unit->name = units_[i].name;
+    storage_unit->type = units_[i].type;
+    storage_unit->capacity = units_[i].capacity;
+    info->storages.push_back(storage_unit);
+  }
+
+  return info.Pass();
 }
 
 void StorageInfoProviderAndroid::StartStorageMonitoring() {
@@ -26,5 +76,24 @@ void StorageInfoProviderAndroid::StopStorageMonitoring() {
   NOTIMPLEMENTED();
 }
 
+void StorageInfoProviderAndroid::RefreshCapacities() const {
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!last_refresh_time_.is_null() &&
+      now - last_refresh_time_ <
+          base::TimeDelta::FromSeconds(kCapacityRefreshSeconds))
+    return;
+  last_refresh_time_ = now;
+
+  for (size_t i = 0; i < units_.size(); ++i) {
+    struct statvfs stats;
+    if (statvfs(units_[i].path.value().c_str(), &stats) != 0) {
+      units_[i].capacity = 0;
+      continue;
+    }
+    units_[i].capacity =
+        static_cast<double>(stats.f_blocks) * stats.f_frsize;
+  }
+}
+
 }  // namespace sysapps
 }  // namespace xwalk
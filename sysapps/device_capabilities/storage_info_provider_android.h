@@ -5,11 +5,19 @@
 #ifndef XWALK_SYSAPPS_DEVICE_CAPABILITIES_STORAGE_INFO_PROVIDER_ANDROID_H_
 #define XWALK_SYSAPPS_DEVICE_CAPABILITIES_STORAGE_INFO_PROVIDER_ANDROID_H_
 
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/time/time.h"
 #include "xwalk/sysapps/device_capabilities/storage_info_provider.h"
 
 namespace xwalk {
 namespace sysapps {
 
+// Reports the internal storage and, if any, the primary external storage.
+// Android has no udev and the media intents only reach Java, so attaching
+// and detaching aren't monitored.
 class StorageInfoProviderAndroid : public StorageInfoProvider {
  public:
   StorageInfoProviderAndroid();
@@ -21,6 +29,21 @@ class StorageInfoProviderAndroid : public StorageInfoProvider {
   // StorageInfoProvider implementation.
   virtual void StartStorageMonitoring() OVERRIDE;
   virtual void StopStorageMonitoring() OVERRIDE;
+
+  struct Unit {
+    std::string id;
+    std::string name;
+    std::string type;
+    base::FilePath path;
+    double capacity;
+  };
+
+  // statvfs() is called at most once per refresh period, so querying the
+  // capabilities often stays cheap.
+  void RefreshCapacities() const;
+
+  mutable std::vector<Unit> units_;
+  mutable base::TimeTicks last_refresh_time_;
 };
 
 }  // namespace sysapps
@@ -0,0 +1,705 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/downloader/download_object.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/file_util.h"
+#include "base/files/file.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task_runner_util.h"
+#include "base/values.h"
+#include "net/base/file_stream.h"
+#include "net/base/io_buffer.h"
+#include "net/base/load_flags.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_response_headers.h"
+#include "net/url_request/url_fetcher.h"
+#include "net/url_request/url_fetcher_delegate.h"
+#include "net/url_request/url_fetcher_response_writer.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "net/url_request/url_request_status.h"
+#include "xwalk/sysapps/downloader/download.h"
+
+using namespace xwalk::jsapi::download; // NOLINT
+
+namespace {
+
+const int kDefaultSegments = 4;
+const int kMaxSegments = 8;
+
+// A segment failing with a network error is retried after 1, 2, 4, 8 and 16
+// seconds, the count starts over whenever it receives something.
+const int kMaxRetries = 5;
+
+// The bandwidth cap is enforced in ticks of this length.
+const int kWriteBudgetTickMs = 100;
+
+const int kProgressIntervalMs = 250;
+
+std::string ReadFile(const base::FilePath& path) {
+  std::string data;
+  base::ReadFileToString(path, &data);
+  return data;
+}
+
+// Weak ETags can't be used in If-Range, the Last-Modified date is used then.
+std::string GetValidator(const net::HttpResponseHeaders& headers) {
+  std::string etag;
+  if (headers.EnumerateHeader(NULL, "ETag", &etag) &&
+      !StartsWithASCII(etag, "W/", true))
+    return etag;
+
+  std::string last_modified;
+  headers.EnumerateHeader(NULL, "Last-Modified", &last_modified);
+  return last_modified;
+}
+
+}  // namespace
+
+namespace xwalk {
+namespace sysapps {
+
+const base::FilePath::CharType DownloadObject::kStateFileExtension[] =
+    FILE_PATH_LITERAL("xwalkdownload");
+
+// Fetches one range of the resource.
+class DownloadObject::Segment : public net::URLFetcherDelegate {
+ public:
+  Segment(DownloadObject* download, size_t index)
+      : download_(download),
+        index_(index),
+        writer_(NULL),
+        retries_(0),
+        needs_restart_(false) {}
+
+  virtual ~Segment() {
+    Stop();
+  }
+
+  DownloadSegment& range() { return download_->state_->segments()[index_]; }
+
+  void Start();
+  void Stop();
+
+  // Called by the writer of the response, checks that it is the range which
+  // was asked for. Returns a net error to abort the request.
+  int CheckResponse();
+  void DidWrite(int bytes);
+
+  int TakeWriteBudget(int bytes) {
+    return download_->TakeWriteBudget(this, bytes);
+  }
+  void WriteBudgetAvailable();
+
+  // The file is created again by the first request of a download.
+  bool TruncatesFile() {
+    return index_ == 0 && download_->state_->segments().size() == 1 &&
+        range().next_offset() == 0;
+  }
+
+ private:
+  // net::URLFetcherDelegate implementation.
+  virtual void OnURLFetchComplete(const net::URLFetcher* source) OVERRIDE;
+
+  DownloadObject* download_;
+  size_t index_;
+  scoped_ptr<net::URLFetcher> fetcher_;
+  // Owned by |fetcher_|.
+  SegmentWriter* writer_;
+  int retries_;
+  bool needs_restart_;
+  std::string error_;
+  base::OneShotTimer<Segment> retry_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(Segment);
+};
+
+// Writes the body of a response in the file, at the offset of the segment.
+// Writes are held back while the bandwidth cap is reached, which is how it
+// is enforced: the network stack stops reading until they complete.
+class DownloadObject::SegmentWriter : public net::URLFetcherResponseWriter {
+ public:
+  SegmentWriter(Segment* segment,
+                const base::FilePath& path,
+                scoped_refptr<base::SingleThreadTaskRunner> file_task_runner)
+      : segment_(segment),
+        path_(path),
+        file_task_runner_(file_task_runner),
+        response_checked_(false),
+        pending_size_(0) {}
+
+  virtual ~SegmentWriter() {}
+
+  // net::URLFetcherResponseWriter implementation.
+  virtual int Initialize(const net::CompletionCallback& callback) OVERRIDE;
+  virtual int Write(net::IOBuffer* buffer,
+                    int num_bytes,
+                    const net::CompletionCallback& callback) OVERRIDE;
+  virtual int Finish(const net::CompletionCallback& callback) OVERRIDE;
+
+  void ResumeWrite();
+
+ private:
+  void OnOpened(int result);
+  void OnSeeked(int64 result);
+  // Returns the size given to Write() once |pending_| is written.
+  int DoWrite();
+  void OnFileWritten(int result);
+  void RunCallback(int result);
+
+  Segment* segment_;
+  base::FilePath path_;
+  scoped_refptr<base::SingleThreadTaskRunner> file_task_runner_;
+  scoped_ptr<net::FileStream> file_;
+  int64 offset_;
+  bool response_checked_;
+  scoped_refptr<net::DrainableIOBuffer> pending_;
+  int pending_size_;
+  net::CompletionCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentWriter);
+};
+
+void DownloadObject::Segment::Start() {
+  DownloadSegment& segment = range();
+  DCHECK(!segment.IsComplete());
+  needs_restart_ = false;
+  error_.clear();
+
+  fetcher_.reset(net::URLFetcher::Create(download_->url_,
+                                         net::URLFetcher::GET,
+                                         this));
+  fetcher_->SetRequestContext(download_->request_context_getter_.get());
+  // The downloaded file is the cache.
+  fetcher_->SetLoadFlags(net::LOAD_DISABLE_CACHE);
+  fetcher_->SetAutomaticallyRetryOnNetworkChanges(1);
+
+  // Even the first request asks for a range, so the server tells the size
+  // of the resource and whether it supports ranges.
+  std::string range_header = "Range: bytes=" +
+      base::Int64ToString(segment.next_offset()) + "-";
+  if (segment.has_length())
+    range_header += base::Int64ToString(segment.offset + segment.length - 1);
+  fetcher_->AddExtraRequestHeader(range_header);
+  const std::string& validator = download_->state_->validator();
+  if (segment.next_offset() > 0 && !validator.empty())
+    fetcher_->AddExtraRequestHeader("If-Range: " + validator);
+
+  writer_ = new SegmentWriter(this, download_->path_,
+                              download_->file_task_runner_);
+  fetcher_->SaveResponseWithWriter(
+      scoped_ptr<net::URLFetcherResponseWriter>(writer_));
+  fetcher_->Start();
+}
+
+void DownloadObject::Segment::Stop() {
+  retry_timer_.Stop();
+  download_->CancelWriteBudgetRequest(this);
+  writer_ = NULL;
+  fetcher_.reset();
+}
+
+int DownloadObject::Segment::CheckResponse() {
+  DownloadState* state = download_->state_.get();
+  net::HttpResponseHeaders* headers = fetcher_->GetResponseHeaders();
+  if (!headers) {
+    error_ = "Invalid response";
+    return net::ERR_FAILED;
+  }
+
+  bool size_known = state->has_total_size();
+  int response_code = fetcher_->GetResponseCode();
+  if (response_code == 200) {
+    // Either ranges are not supported or the resource changed since the
+    // download started, it can only be downloaded again in one piece.
+    if (!TruncatesFile()) {
+      needs_restart_ = true;
+      return net::ERR_ABORTED;
+    }
+    state->SetTotalSize(headers->GetContentLength(), 1);
+  } else if (response_code == 206) {
+    int64 first, last, length;
+    if (!headers->GetContentRange(&first, &last, &length) ||
+        first != range().next_offset()) {
+      error_ = "Invalid range in the response";
+      return net::ERR_FAILED;
+    }
+    if (!size_known) {
+      state->SetTotalSize(length, download_->max_segments_);
+    } else if (length != state->total_size()) {
+      needs_restart_ = true;
+      return net::ERR_ABORTED;
+    }
+  } else {
+    error_ = "HTTP error " + base::IntToString(response_code);
+    return net::ERR_FAILED;
+  }
+
+  if (!size_known)
+    state->set_validator(GetValidator(*headers));
+  if (!size_known && state->has_total_size())
+    download_->OnTotalSizeKnown();
+  return net::OK;
+}
+
+void DownloadObject::Segment::DidWrite(int bytes) {
+  range().received += bytes;
+  retries_ = 0;
+  download_->OnBytesWritten();
+}
+
+void DownloadObject::Segment::WriteBudgetAvailable() {
+  if (writer_)
+    writer_->ResumeWrite();
+}
+
+void DownloadObject::Segment::OnURLFetchComplete(
+    const net::URLFetcher* source) {
+  net::URLRequestStatus status = source->GetStatus();
+  Stop();
+
+  if (needs_restart_) {
+    // Deletes this segment.
+    base::MessageLoop::current()->PostTask(FROM_HERE,
+        base::Bind(&DownloadObject::Restart,
+                   download_->weak_factory_.GetWeakPtr()));
+    return;
+  }
+
+  DownloadSegment& segment = range();
+  // Without a size, the resource is complete when the response is.
+  if (!segment.has_length() && status.is_success())
+    download_->state_->SetTotalSize(segment.received, 1);
+
+  if (range().IsComplete()) {
+    download_->OnSegmentComplete();
+    return;
+  }
+
+  if (!error_.empty()) {
+    download_->OnSegmentFailed(error_);
+    return;
+  }
+
+  // A response which ended early is retried like a network error.
+  if (++retries_ > kMaxRetries) {
+    download_->OnSegmentFailed(status.is_success() ?
+        "Incomplete response" : net::ErrorToString(status.error()));
+    return;
+  }
+  retry_timer_.Start(FROM_HERE,
+                     base::TimeDelta::FromSeconds(1 << (retries_ - 1)),
+                     this, &Segment::Start);
+}
+
+int DownloadObject::SegmentWriter::Initialize(
+    const net::CompletionCallback& callback) {
+  offset_ = segment_->range().next_offset();
+  int flags = base::File::FLAG_WRITE | base::File::FLAG_ASYNC;
+  flags |= segment_->TruncatesFile() ?
+      base::File::FLAG_CREATE_ALWAYS : base::File::FLAG_OPEN_ALWAYS;
+
+  file_.reset(new net::FileStream(file_task_runner_));
+  int rv = file_->Open(path_, flags,
+                       base::Bind(&SegmentWriter::OnOpened,
+                                  base::Unretained(this)));
+  if (rv == net::ERR_IO_PENDING)
+    callback_ = callback;
+  return rv;
+}
+
+void DownloadObject::SegmentWriter::OnOpened(int result) {
+  if (result != net::OK || !offset_) {
+    RunCallback(result);
+    return;
+  }
+
+  int64 rv = file_->Seek(net::FROM_BEGIN, offset_,
+                         base::Bind(&SegmentWriter::OnSeeked,
+                                    base::Unretained(this)));
+  if (rv != net::ERR_IO_PENDING)
+    OnSeeked(rv);
+}
+
+void DownloadObject::SegmentWriter::OnSeeked(int64 result) {
+  RunCallback(result < 0 ? static_cast<int>(result) : net::OK);
+}
+
+int DownloadObject::SegmentWriter::Write(
+    net::IOBuffer* buffer,
+    int num_bytes,
+    const net::CompletionCallback& callback) {
+  if (!response_checked_) {
+    response_checked_ = true;
+    int rv = segment_->CheckResponse();
+    if (rv != net::OK)
+      return rv;
+  }
+
+  // The first request asks for everything up to the end, the rest of the
+  // response isn't needed once the resource has been split.
+  const DownloadSegment& range = segment_->range();
+  int64 size = num_bytes;
+  if (range.has_length())
+    size = std::min(size, range.length - range.received);
+  if (size <= 0)
+    return net::ERR_ABORTED;
+
+  pending_ = new net::DrainableIOBuffer(buffer, static_cast<int>(size));
+  pending_size_ = num_bytes;
+  int rv = DoWrite();
+  if (rv == net::ERR_IO_PENDING)
+    callback_ = callback;
+  return rv;
+}
+
+int DownloadObject::SegmentWriter::Finish(
+    const net::CompletionCallback& callback) {
+  // The file is closed with the writer.
+  return net::OK;
+}
+
+void DownloadObject::SegmentWriter::ResumeWrite() {
+  int rv = DoWrite();
+  if (rv != net::ERR_IO_PENDING)
+    RunCallback(rv);
+}
+
+int DownloadObject::SegmentWriter::DoWrite() {
+  while (pending_->BytesRemaining() > 0) {
+    int bytes = segment_->TakeWriteBudget(pending_->BytesRemaining());
+    if (!bytes)
+      return net::ERR_IO_PENDING;
+
+    int rv = file_->Write(pending_.get(), bytes,
+                          base::Bind(&SegmentWriter::OnFileWritten,
+                                     base::Unretained(this)));
+    if (rv < 0)
+      return rv;
+    pending_->DidConsume(rv);
+    segment_->DidWrite(rv);
+  }
+
+  pending_ = NULL;
+  return pending_size_;
+}
+
+void DownloadObject::SegmentWriter::OnFileWritten(int result) {
+  if (result < 0) {
+    RunCallback(result);
+    return;
+  }
+
+  pending_->DidConsume(result);
+  segment_->DidWrite(result);
+  ResumeWrite();
+}
+
+void DownloadObject::SegmentWriter::RunCallback(int result) {
+  net::CompletionCallback callback = callback_;
+  callback_.Reset();
+  callback.Run(result);
+}
+
+DownloadObject::DownloadObject(
+    net::URLRequestContextGetter* request_context_getter,
+    scoped_refptr<base::SingleThreadTaskRunner> file_task_runner,
+    const base::FilePath& download_root)
+    : request_context_getter_(request_context_getter),
+      file_task_runner_(file_task_runner),
+      download_root_(download_root),
+      status_(STATUS_LOADING),
+      start_requested_(false),
+      max_segments_(kDefaultSegments),
+      max_bytes_per_tick_(0),
+      write_budget_(0),
+      weak_factory_(this) {
+  handler_.Register("init",
+      base::Bind(&DownloadObject::OnInit, base::Unretained(this)));
+  handler_.Register("start",
+      base::Bind(&DownloadObject::OnStart, base::Unretained(this)));
+  handler_.Register("pause",
+      base::Bind(&DownloadObject::OnPause, base::Unretained(this)));
+  handler_.Register("cancel",
+      base::Bind(&DownloadObject::OnCancel, base::Unretained(this)));
+}
+
+// static
+bool DownloadObject::ResolvePath(const base::FilePath& download_root,
+                                 const std::string& path,
+                                 base::FilePath* resolved) {
+  base::FilePath relative = base::FilePath::FromUTF8Unsafe(path);
+  if (relative.empty() || relative.IsAbsolute())
+    return false;
+  std::vector<base::FilePath::StringType> components;
+  relative.GetComponents(&components);
+  for (size_t i = 0; i < components.size(); ++i) {
+    if (components[i] == base::FilePath::kCurrentDirectory ||
+        components[i] == base::FilePath::kParentDirectory)
+      return false;
+  }
+
+  *resolved = download_root.Append(relative);
+  return download_root.IsParent(*resolved);
+}
+
+DownloadObject::~DownloadObject() {
+  // The segments use the members declared after them.
+  segments_.clear();
+  if (state_writer_ && state_writer_->HasPendingWrite())
+    state_writer_->DoScheduledWrite();
+}
+
+void DownloadObject::OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  scoped_ptr<Init::Params> params(Init::Params::Create(*info->arguments()));
+  if (!params) {
+    LOG(WARNING) << "Malformed parameters passed to " << info->name();
+    Fail("Invalid parameters");
+    return;
+  }
+
+  url_ = GURL(params->url);
+  if (!url_.is_valid() || !url_.SchemeIsHTTPOrHTTPS()) {
+    Fail("Only http and https URLs can be downloaded");
+    return;
+  }
+
+  if (!ResolvePath(download_root_, params->path, &path_)) {
+    Fail("The path must name a file relative to the download directory");
+    return;
+  }
+  state_path_ = path_.AddExtension(kStateFileExtension);
+
+  if (params->options && params->options->segments)
+    max_segments_ = std::max(1, std::min(*params->options->segments,
+                                         kMaxSegments));
+  if (params->options && params->options->max_bytes_per_second &&
+      *params->options->max_bytes_per_second > 0) {
+    max_bytes_per_tick_ = std::max<int64>(1, static_cast<int64>(
+        *params->options->max_bytes_per_second * kWriteBudgetTickMs / 1000));
+  }
+
+  state_writer_.reset(
+      new base::ImportantFileWriter(state_path_, file_task_runner_.get()));
+  file_task_runner_->PostTask(FROM_HERE,
+      base::Bind(base::IgnoreResult(&base::CreateDirectory), path_.DirName()));
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(),
+      FROM_HERE,
+      base::Bind(&ReadFile, state_path_),
+      base::Bind(&DownloadObject::OnStateLoaded,
+                 weak_factory_.GetWeakPtr()));
+}
+
+void DownloadObject::OnStart(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (status_ == STATUS_LOADING) {
+    start_requested_ = true;
+    return;
+  }
+
+  // A failed download can be started again, it resumes.
+  if (state_ && (status_ == STATUS_IDLE || status_ == STATUS_FAILED))
+    StartSegments();
+}
+
+void DownloadObject::OnPause(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  start_requested_ = false;
+  if (status_ != STATUS_RUNNING)
+    return;
+
+  StopSegments();
+  status_ = STATUS_IDLE;
+  if (state_writer_->HasPendingWrite())
+    state_writer_->DoScheduledWrite();
+  DispatchProgress(true);
+}
+
+void DownloadObject::OnCancel(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (!state_writer_ || status_ == STATUS_COMPLETE)
+    return;
+
+  // The saved state isn't needed anymore if it is still being read.
+  weak_factory_.InvalidateWeakPtrs();
+  start_requested_ = false;
+  StopSegments();
+  DeleteFiles(true);
+  state_.reset(new DownloadState(url_));
+  status_ = STATUS_IDLE;
+}
+
+bool DownloadObject::SerializeData(std::string* data) {
+  base::JSONWriter::Write(state_->ToValue().get(), data);
+  return true;
+}
+
+void DownloadObject::OnStateLoaded(const std::string& data) {
+  scoped_ptr<base::Value> value(base::JSONReader::Read(data));
+  if (value)
+    state_ = DownloadState::FromValue(*value, url_);
+  if (!state_)
+    state_.reset(new DownloadState(url_));
+
+  status_ = STATUS_IDLE;
+  DispatchProgress(true);
+  if (start_requested_)
+    StartSegments();
+}
+
+void DownloadObject::StartSegments() {
+  status_ = STATUS_RUNNING;
+  start_requested_ = false;
+  write_budget_ = max_bytes_per_tick_;
+
+  segments_.clear();
+  for (size_t i = 0; i < state_->segments().size(); ++i)
+    segments_.push_back(new Segment(this, i));
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    if (!segments_[i]->range().IsComplete())
+      segments_[i]->Start();
+  }
+
+  if (state_->IsComplete())
+    OnSegmentComplete();
+}
+
+void DownloadObject::StopSegments() {
+  for (size_t i = 0; i < segments_.size(); ++i)
+    segments_[i]->Stop();
+  budget_timer_.Stop();
+}
+
+void DownloadObject::OnTotalSizeKnown() {
+  for (size_t i = segments_.size(); i < state_->segments().size(); ++i) {
+    segments_.push_back(new Segment(this, i));
+    segments_.back()->Start();
+  }
+  state_writer_->ScheduleWrite(this);
+}
+
+void DownloadObject::OnBytesWritten() {
+  state_writer_->ScheduleWrite(this);
+  DispatchProgress(false);
+}
+
+void DownloadObject::OnSegmentComplete() {
+  if (!state_->IsComplete())
+    return;
+
+  status_ = STATUS_COMPLETE;
+  budget_timer_.Stop();
+  DispatchProgress(true);
+  DeleteFiles(false);
+  DispatchEvent("complete");
+}
+
+void DownloadObject::OnSegmentFailed(const std::string& message) {
+  LOG(WARNING) << "Failed to download " << url_.spec() << ": " << message;
+  Fail(message);
+}
+
+void DownloadObject::Restart() {
+  if (status_ != STATUS_RUNNING)
+    return;
+
+  LOG(WARNING) << "Downloading " << url_.spec() << " again, the resource "
+               << "changed or the server doesn't support ranges.";
+  StopSegments();
+  state_.reset(new DownloadState(url_));
+  StartSegments();
+}
+
+int DownloadObject::TakeWriteBudget(Segment* segment, int bytes) {
+  if (!max_bytes_per_tick_)
+    return bytes;
+
+  if (!budget_timer_.IsRunning()) {
+    budget_timer_.Start(FROM_HERE,
+                        base::TimeDelta::FromMilliseconds(kWriteBudgetTickMs),
+                        this, &DownloadObject::RefillWriteBudget);
+  }
+
+  if (write_budget_ <= 0) {
+    if (std::find(waiting_segments_.begin(), waiting_segments_.end(),
+                  segment) == waiting_segments_.end())
+      waiting_segments_.push_back(segment);
+    return 0;
+  }
+
+  int granted = static_cast<int>(std::min<int64>(bytes, write_budget_));
+  write_budget_ -= granted;
+  return granted;
+}
+
+void DownloadObject::CancelWriteBudgetRequest(Segment* segment) {
+  waiting_segments_.erase(std::remove(waiting_segments_.begin(),
+                                      waiting_segments_.end(),
+                                      segment),
+                          waiting_segments_.end());
+}
+
+void DownloadObject::RefillWriteBudget() {
+  write_budget_ = max_bytes_per_tick_;
+
+  // The first segments to wait are the first to write again.
+  std::vector<Segment*> waiting_segments;
+  waiting_segments.swap(waiting_segments_);
+  for (size_t i = 0; i < waiting_segments.size(); ++i)
+    waiting_segments[i]->WriteBudgetAvailable();
+
+  if (waiting_segments_.empty() && waiting_segments.empty())
+    budget_timer_.Stop();
+}
+
+void DownloadObject::DispatchProgress(bool force) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (!force && now - last_progress_time_ <
+      base::TimeDelta::FromMilliseconds(kProgressIntervalMs))
+    return;
+  last_progress_time_ = now;
+
+  base::DictionaryValue* progress = new base::DictionaryValue;
+  progress->SetDouble("received", static_cast<double>(state_->received()));
+  progress->SetDouble("total", static_cast<double>(state_->total_size()));
+
+  scoped_ptr<base::ListValue> data(new base::ListValue);
+  data->Append(progress);
+  DispatchEvent("progress", data.Pass());
+}
+
+void DownloadObject::Fail(const std::string& message) {
+  status_ = STATUS_FAILED;
+  StopSegments();
+  // What was downloaded is kept, starting again resumes.
+  if (state_writer_ && state_writer_->HasPendingWrite())
+    state_writer_->DoScheduledWrite();
+
+  scoped_ptr<base::ListValue> data(new base::ListValue);
+  data->AppendString(message);
+  DispatchEvent("error", data.Pass());
+}
+
+void DownloadObject::DeleteFiles(bool delete_download) {
+  // Posted after the pending write, which would recreate the state file.
+  if (state_writer_->HasPendingWrite())
+    state_writer_->DoScheduledWrite();
+  file_task_runner_->PostTask(FROM_HERE,
+      base::Bind(base::IgnoreResult(&base::DeleteFile), state_path_, false));
+  if (delete_download) {
+    file_task_runner_->PostTask(FROM_HERE,
+        base::Bind(base::IgnoreResult(&base::DeleteFile), path_, false));
+  }
+}
+
+}  // namespace sysapps
+}  // namespace xwalk
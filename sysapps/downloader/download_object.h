@@ -0,0 +1,143 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_SYSAPPS_DOWNLOADER_DOWNLOAD_OBJECT_H_
+#define XWALK_SYSAPPS_DOWNLOADER_DOWNLOAD_OBJECT_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/important_file_writer.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
+#include "base/single_thread_task_runner.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "url/gurl.h"
+#include "xwalk/sysapps/common/event_target.h"
+#include "xwalk/sysapps/downloader/download_state.h"
+
+namespace net {
+class URLRequestContextGetter;
+}
+
+namespace xwalk {
+namespace sysapps {
+
+// Downloads a resource to a file with several concurrent range requests,
+// saving its progress next to the file so it resumes after a pause or a
+// restart of the application instead of starting over.
+//
+// The first request asks for the whole resource. If the server answers with
+// its size and supports ranges, the rest of the resource is split into
+// segments fetched in parallel, each written at its offset as it arrives, so
+// nothing is buffered in memory beyond what the network stack reads. An
+// optional bandwidth cap is shared by the segments.
+//
+// The files are saved under the download root of the application, pages
+// only name them relative to it.
+//
+// Lives on the network thread of the request context.
+class DownloadObject : public EventTarget,
+                       public base::ImportantFileWriter::DataSerializer {
+ public:
+  DownloadObject(net::URLRequestContextGetter* request_context_getter,
+                 scoped_refptr<base::SingleThreadTaskRunner> file_task_runner,
+                 const base::FilePath& download_root);
+  virtual ~DownloadObject();
+
+  // The state is saved in a file of the same name with this extension,
+  // which is deleted once the download is complete.
+  static const base::FilePath::CharType kStateFileExtension[];
+
+  // The file |path| names under |download_root|. Returns false if |path| is
+  // empty, absolute or leaves |download_root|.
+  static bool ResolvePath(const base::FilePath& download_root,
+                          const std::string& path,
+                          base::FilePath* resolved);
+
+ private:
+  class Segment;
+  class SegmentWriter;
+  friend class Segment;
+  friend class SegmentWriter;
+
+  enum Status {
+    STATUS_LOADING,
+    STATUS_IDLE,
+    STATUS_RUNNING,
+    STATUS_COMPLETE,
+    STATUS_FAILED
+  };
+
+  // JavaScript function handlers.
+  void OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnStart(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnPause(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnCancel(scoped_ptr<XWalkExtensionFunctionInfo> info);
+
+  // base::ImportantFileWriter::DataSerializer implementation.
+  virtual bool SerializeData(std::string* data) OVERRIDE;
+
+  void OnStateLoaded(const std::string& data);
+
+  // Starts a request for every segment not complete yet.
+  void StartSegments();
+  void StopSegments();
+
+  // Called by the segments.
+  void OnTotalSizeKnown();
+  void OnBytesWritten();
+  void OnSegmentComplete();
+  void OnSegmentFailed(const std::string& message);
+  // The resource changed since the download started, or the server ignored
+  // the range of a resumed request. Everything is downloaded again.
+  void Restart();
+
+  // Bandwidth cap. Returns how many of |bytes| can be written now, 0 when
+  // the segment has to wait for WriteBudgetAvailable().
+  int TakeWriteBudget(Segment* segment, int bytes);
+  void CancelWriteBudgetRequest(Segment* segment);
+  void RefillWriteBudget();
+
+  void DispatchProgress(bool force);
+  void Fail(const std::string& message);
+  void DeleteFiles(bool delete_download);
+
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
+  scoped_refptr<base::SingleThreadTaskRunner> file_task_runner_;
+  base::FilePath download_root_;
+
+  Status status_;
+  bool start_requested_;
+
+  base::FilePath path_;
+  base::FilePath state_path_;
+  GURL url_;
+  int max_segments_;
+  scoped_ptr<DownloadState> state_;
+  ScopedVector<Segment> segments_;
+  scoped_ptr<base::ImportantFileWriter> state_writer_;
+
+  // Bytes which can still be written in the current tick, unused when
+  // |max_bytes_per_tick_| is 0.
+  int64 max_bytes_per_tick_;
+  int64 write_budget_;
+  std::vector<Segment*> waiting_segments_;
+  base::RepeatingTimer<DownloadObject> budget_timer_;
+
+  base::TimeTicks last_progress_time_;
+
+  base::WeakPtrFactory<DownloadObject> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(DownloadObject);
+};
+
+}  // namespace sysapps
+}  // namespace xwalk
+
+#endif  // XWALK_SYSAPPS_DOWNLOADER_DOWNLOAD_OBJECT_H_
@@ -0,0 +1,113 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/downloader/download_object.h"
+
+#include <string>
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/run_loop.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "xwalk/extensions/browser/xwalk_extension_function_handler.h"
+
+using xwalk::extensions::XWalkExtensionFunctionInfo;
+using xwalk::sysapps::DownloadObject;
+
+namespace {
+
+const char kUrl[] = "http://example.com/pack.zip";
+
+void DummyCallback(scoped_ptr<base::ListValue> result) {}
+
+void StoreError(std::string* error, scoped_ptr<base::ListValue> result) {
+  result->GetString(0, error);
+}
+
+scoped_ptr<XWalkExtensionFunctionInfo> CreateInitInfo(
+    const std::string& path) {
+  scoped_ptr<base::ListValue> arguments(new base::ListValue);
+  arguments->AppendString(kUrl);
+  arguments->AppendString(path);
+  return make_scoped_ptr(new XWalkExtensionFunctionInfo(
+      "init", arguments.Pass(), base::Bind(&DummyCallback)));
+}
+
+scoped_ptr<XWalkExtensionFunctionInfo> CreateFunctionInfo(
+    const std::string& name,
+    const XWalkExtensionFunctionInfo::PostResultCallback& callback) {
+  scoped_ptr<base::ListValue> arguments(new base::ListValue);
+  if (name == "addEventListener")
+    arguments->AppendString("error");
+  return make_scoped_ptr(new XWalkExtensionFunctionInfo(
+      name, arguments.Pass(), callback));
+}
+
+}  // namespace
+
+TEST(XWalkSysAppsDownloadObjectTest, ResolvePath) {
+  base::FilePath root(FILE_PATH_LITERAL("/data/app/Downloader"));
+  base::FilePath resolved;
+  EXPECT_TRUE(DownloadObject::ResolvePath(root, "pack.zip", &resolved));
+  EXPECT_EQ(root.AppendASCII("pack.zip"), resolved);
+  EXPECT_TRUE(DownloadObject::ResolvePath(root, "packs/level1.zip",
+                                          &resolved));
+  EXPECT_EQ(root.AppendASCII("packs").AppendASCII("level1.zip"), resolved);
+
+  EXPECT_FALSE(DownloadObject::ResolvePath(root, "", &resolved));
+  EXPECT_FALSE(DownloadObject::ResolvePath(root, "/etc/passwd", &resolved));
+  EXPECT_FALSE(DownloadObject::ResolvePath(root, "../pack.zip", &resolved));
+  EXPECT_FALSE(DownloadObject::ResolvePath(root, "packs/../../pack.zip",
+                                           &resolved));
+  EXPECT_FALSE(DownloadObject::ResolvePath(root, ".", &resolved));
+  EXPECT_FALSE(DownloadObject::ResolvePath(root, "packs/./pack.zip",
+                                           &resolved));
+}
+
+TEST(XWalkSysAppsDownloadObjectTest, RejectsPathOutsideRoot) {
+  base::MessageLoop message_loop;
+  base::ScopedTempDir root;
+  ASSERT_TRUE(root.CreateUniqueTempDir());
+  base::FilePath outside = root.path().DirName().AppendASCII("pack.zip");
+
+  DownloadObject download(NULL, base::MessageLoopProxy::current(),
+                          root.path());
+  std::string error;
+  download.HandleFunction(
+      CreateFunctionInfo("addEventListener", base::Bind(&StoreError, &error)));
+  download.HandleFunction(CreateInitInfo(outside.AsUTF8Unsafe()));
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(base::PathExists(outside.AddExtension(
+      DownloadObject::kStateFileExtension)));
+}
+
+TEST(XWalkSysAppsDownloadObjectTest, CancelDeletesFiles) {
+  base::MessageLoop message_loop;
+  base::ScopedTempDir root;
+  ASSERT_TRUE(root.CreateUniqueTempDir());
+  base::FilePath path = root.path().AppendASCII("packs").AppendASCII("a.zip");
+  base::FilePath state_path =
+      path.AddExtension(DownloadObject::kStateFileExtension);
+
+  DownloadObject download(NULL, base::MessageLoopProxy::current(),
+                          root.path());
+  download.HandleFunction(CreateInitInfo("packs/a.zip"));
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(base::DirectoryExists(path.DirName()));
+
+  // What a previous run of the download left.
+  ASSERT_EQ(3, base::WriteFile(path, "abc", 3));
+  ASSERT_EQ(2, base::WriteFile(state_path, "{}", 2));
+
+  download.HandleFunction(
+      CreateFunctionInfo("cancel", base::Bind(&DummyCallback)));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(path));
+  EXPECT_FALSE(base::PathExists(state_path));
+}
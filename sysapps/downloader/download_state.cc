@@ -0,0 +1,156 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/downloader/download_state.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "base/values.h"
+
+namespace {
+
+const char kUrlKey[] = "url";
+const char kTotalSizeKey[] = "totalSize";
+const char kValidatorKey[] = "validator";
+const char kSegmentsKey[] = "segments";
+
+// The sizes are stored as doubles, which hold integers up to 2^53 exactly.
+bool GetSize(const base::ListValue& list, size_t index, int64* size) {
+  double value;
+  if (!list.GetDouble(index, &value))
+    return false;
+  *size = static_cast<int64>(value);
+  return *size == value;
+}
+
+}  // namespace
+
+namespace xwalk {
+namespace sysapps {
+
+const int64 DownloadState::kMinSegmentSize = 1024 * 1024;
+
+DownloadSegment::DownloadSegment(int64 offset, int64 length)
+    : offset(offset),
+      length(length),
+      received(0) {
+}
+
+DownloadState::DownloadState(const GURL& url)
+    : url_(url),
+      total_size_(-1) {
+  segments_.push_back(DownloadSegment(0, -1));
+}
+
+DownloadState::~DownloadState() {
+}
+
+// static
+scoped_ptr<DownloadState> DownloadState::FromValue(const base::Value& value,
+                                                   const GURL& url) {
+  const base::DictionaryValue* dict;
+  std::string spec;
+  double total_size;
+  const base::ListValue* segments;
+  if (!value.GetAsDictionary(&dict) ||
+      !dict->GetString(kUrlKey, &spec) || GURL(spec) != url ||
+      !dict->GetDouble(kTotalSizeKey, &total_size) ||
+      !dict->GetList(kSegmentsKey, &segments) || segments->empty())
+    return scoped_ptr<DownloadState>();
+
+  scoped_ptr<DownloadState> state(new DownloadState(url));
+  state->total_size_ = static_cast<int64>(total_size);
+  dict->GetString(kValidatorKey, &state->validator_);
+
+  // The segments must cover the resource, one after the other.
+  state->segments_.clear();
+  int64 next_offset = 0;
+  for (size_t i = 0; i < segments->GetSize(); ++i) {
+    const base::ListValue* segment;
+    int64 offset, length, received;
+    if (!segments->GetList(i, &segment) ||
+        !GetSize(*segment, 0, &offset) || offset != next_offset ||
+        !GetSize(*segment, 1, &length) ||
+        !GetSize(*segment, 2, &received) || received < 0 ||
+        (length >= 0 && received > length))
+      return scoped_ptr<DownloadState>();
+
+    DownloadSegment result(offset, length);
+    result.received = received;
+    state->segments_.push_back(result);
+    next_offset = offset + length;
+  }
+
+  bool consistent = state->has_total_size() ?
+      next_offset == state->total_size_ :
+      segments->GetSize() == 1 && !state->segments_[0].has_length();
+  if (!consistent)
+    return scoped_ptr<DownloadState>();
+  return state.Pass();
+}
+
+scoped_ptr<base::DictionaryValue> DownloadState::ToValue() const {
+  scoped_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+  dict->SetString(kUrlKey, url_.spec());
+  dict->SetDouble(kTotalSizeKey, static_cast<double>(total_size_));
+  dict->SetString(kValidatorKey, validator_);
+
+  base::ListValue* segments = new base::ListValue;
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    base::ListValue* segment = new base::ListValue;
+    segment->AppendDouble(static_cast<double>(segments_[i].offset));
+    segment->AppendDouble(static_cast<double>(segments_[i].length));
+    segment->AppendDouble(static_cast<double>(segments_[i].received));
+    segments->Append(segment);
+  }
+  dict->Set(kSegmentsKey, segments);
+  return dict.Pass();
+}
+
+void DownloadState::SetTotalSize(int64 total_size, int max_segments) {
+  DCHECK(!segments_.empty());
+  DownloadSegment first = segments_[0];
+  first.offset = 0;
+  segments_.clear();
+  total_size_ = std::max<int64>(total_size, -1);
+
+  if (!has_total_size()) {
+    first.length = -1;
+    segments_.push_back(first);
+    return;
+  }
+
+  int64 count = std::max(1, max_segments);
+  count = std::max<int64>(1, std::min(count, total_size_ / kMinSegmentSize));
+  const int64 segment_size = total_size_ / count;
+
+  // The last segment gets the rest of the division.
+  first.length = count == 1 ? total_size_ : segment_size;
+  first.received = std::min(first.received, first.length);
+  segments_.push_back(first);
+  for (int64 i = 1; i < count; ++i) {
+    int64 offset = i * segment_size;
+    int64 length = i == count - 1 ? total_size_ - offset : segment_size;
+    segments_.push_back(DownloadSegment(offset, length));
+  }
+}
+
+int64 DownloadState::received() const {
+  int64 received = 0;
+  for (size_t i = 0; i < segments_.size(); ++i)
+    received += segments_[i].received;
+  return received;
+}
+
+bool DownloadState::IsComplete() const {
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    if (!segments_[i].IsComplete())
+      return false;
+  }
+  return true;
+}
+
+}  // namespace sysapps
+}  // namespace xwalk
@@ -0,0 +1,88 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_SYSAPPS_DOWNLOADER_DOWNLOAD_STATE_H_
+#define XWALK_SYSAPPS_DOWNLOADER_DOWNLOAD_STATE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "url/gurl.h"
+
+namespace base {
+class DictionaryValue;
+class Value;
+}
+
+namespace xwalk {
+namespace sysapps {
+
+// A byte range of the downloaded resource, fetched by its own request.
+struct DownloadSegment {
+  DownloadSegment(int64 offset, int64 length);
+
+  bool has_length() const { return length >= 0; }
+  bool IsComplete() const { return has_length() && received >= length; }
+  // The first byte not received yet.
+  int64 next_offset() const { return offset + received; }
+
+  int64 offset;
+  // -1 until the size of the resource is known, the download then has a
+  // single segment.
+  int64 length;
+  int64 received;
+};
+
+// What is known of a download, persisted with the downloaded file so an
+// interrupted download resumes where it stopped instead of starting over.
+class DownloadState {
+ public:
+  // Segments are never smaller than this, small resources are downloaded
+  // with a single request.
+  static const int64 kMinSegmentSize;
+
+  explicit DownloadState(const GURL& url);
+  ~DownloadState();
+
+  // Returns NULL if |value| is not a consistent state of a download of
+  // |url|.
+  static scoped_ptr<DownloadState> FromValue(const base::Value& value,
+                                             const GURL& url);
+  scoped_ptr<base::DictionaryValue> ToValue() const;
+
+  // Splits the resource into at most |max_segments| segments once its size
+  // is known. The first segment keeps what it has received already. A
+  // negative |total_size| leaves a single segment of unknown length.
+  void SetTotalSize(int64 total_size, int max_segments);
+
+  int64 received() const;
+  bool IsComplete() const;
+
+  const GURL& url() const { return url_; }
+  int64 total_size() const { return total_size_; }
+  bool has_total_size() const { return total_size_ >= 0; }
+
+  // The ETag, or the Last-Modified date, of the resource, sent in If-Range
+  // when resuming so a resource which has changed is downloaded again.
+  const std::string& validator() const { return validator_; }
+  void set_validator(const std::string& validator) { validator_ = validator; }
+
+  std::vector<DownloadSegment>& segments() { return segments_; }
+  const std::vector<DownloadSegment>& segments() const { return segments_; }
+
+ private:
+  GURL url_;
+  int64 total_size_;
+  std::string validator_;
+  std::vector<DownloadSegment> segments_;
+
+  DISALLOW_COPY_AND_ASSIGN(DownloadState);
+};
+
+}  // namespace sysapps
+}  // namespace xwalk
+
+#endif  // XWALK_SYSAPPS_DOWNLOADER_DOWNLOAD_STATE_H_
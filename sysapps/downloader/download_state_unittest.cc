@@ -0,0 +1,87 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/downloader/download_state.h"
+
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using xwalk::sysapps::DownloadSegment;
+using xwalk::sysapps::DownloadState;
+
+namespace {
+
+const char kUrl[] = "http://example.com/file.zip";
+
+}  // namespace
+
+TEST(XWalkSysAppsDownloadStateTest, StartsWithSingleSegment) {
+  DownloadState state((GURL(kUrl)));
+  ASSERT_EQ(1u, state.segments().size());
+  EXPECT_FALSE(state.has_total_size());
+  EXPECT_FALSE(state.segments()[0].has_length());
+  EXPECT_FALSE(state.IsComplete());
+}
+
+TEST(XWalkSysAppsDownloadStateTest, SplitsResource) {
+  const int64 size = 10 * DownloadState::kMinSegmentSize + 3;
+  DownloadState state((GURL(kUrl)));
+  state.segments()[0].received = 100;
+  state.SetTotalSize(size, 4);
+
+  const std::vector<DownloadSegment>& segments = state.segments();
+  ASSERT_EQ(4u, segments.size());
+  EXPECT_EQ(100, segments[0].received);
+  int64 offset = 0;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    EXPECT_EQ(offset, segments[i].offset);
+    offset += segments[i].length;
+  }
+  EXPECT_EQ(size, offset);
+  EXPECT_EQ(100, state.received());
+}
+
+TEST(XWalkSysAppsDownloadStateTest, KeepsSmallResourcesInOneSegment) {
+  DownloadState state((GURL(kUrl)));
+  state.SetTotalSize(DownloadState::kMinSegmentSize + 1, 8);
+  ASSERT_EQ(1u, state.segments().size());
+  EXPECT_EQ(DownloadState::kMinSegmentSize + 1, state.segments()[0].length);
+
+  state.segments()[0].received = state.segments()[0].length;
+  EXPECT_TRUE(state.IsComplete());
+}
+
+TEST(XWalkSysAppsDownloadStateTest, RoundTripsThroughValue) {
+  const GURL url(kUrl);
+  DownloadState state(url);
+  state.set_validator("\"etag\"");
+  state.SetTotalSize(4 * DownloadState::kMinSegmentSize, 2);
+  state.segments()[1].received = 42;
+
+  scoped_ptr<DownloadState> copy(
+      DownloadState::FromValue(*state.ToValue(), url));
+  ASSERT_TRUE(copy);
+  EXPECT_EQ(state.total_size(), copy->total_size());
+  EXPECT_EQ("\"etag\"", copy->validator());
+  ASSERT_EQ(2u, copy->segments().size());
+  EXPECT_EQ(state.segments()[1].offset, copy->segments()[1].offset);
+  EXPECT_EQ(42, copy->segments()[1].received);
+}
+
+TEST(XWalkSysAppsDownloadStateTest, RejectsInconsistentValue) {
+  const GURL url(kUrl);
+  DownloadState state(url);
+  state.SetTotalSize(4 * DownloadState::kMinSegmentSize, 2);
+  scoped_ptr<base::DictionaryValue> value(state.ToValue());
+
+  // Saved for another resource.
+  EXPECT_FALSE(DownloadState::FromValue(*value, GURL("http://example.com/")));
+
+  // The segments don't cover the resource anymore.
+  value->SetDouble("totalSize", 5 * DownloadState::kMinSegmentSize);
+  EXPECT_FALSE(DownloadState::FromValue(*value, url));
+
+  base::StringValue not_a_dictionary("garbage");
+  EXPECT_FALSE(DownloadState::FromValue(not_a_dictionary, url));
+}
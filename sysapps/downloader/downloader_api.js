@@ -0,0 +1,115 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Downloads a resource to a file with parallel range requests, resuming
+// where a previous download of the same URL to the same path stopped.
+
+var v8tools = requireNative('v8tools');
+
+var internal = requireNative('internal');
+internal.setupInternalExtension(extension);
+
+var common = requireNative('sysapps_common');
+common.setupSysAppsCommon(internal, v8tools);
+
+// The ProgressObserver is a proxy object that subscribes to the
+// |progress| event of the download, which cannot subscribe to its own
+// events without leaking.
+//
+var ProgressObserver = function(object_id) {
+  common.BindingObject.call(this, object_id);
+  common.EventTarget.call(this);
+
+  this._addEvent("progress");
+  this.received = 0;
+  this.total = -1;
+
+  var that = this;
+  this.onprogress = function(event) {
+    that.received = event.data.received;
+    that.total = event.data.total;
+  };
+
+  this.destructor = function() {
+    this.onprogress = null;
+  };
+};
+
+ProgressObserver.prototype = new common.EventTargetPrototype();
+
+// Download interface.
+//
+// |path| names the file relative to the download directory of the
+// application, it can't leave it.
+//
+// |options| can have |segments|, the number of parallel requests, and
+// |maxBytesPerSecond|, a bandwidth cap. |total| is -1 until the size of the
+// resource is known.
+//
+var Download = function(url, path, options) {
+  common.BindingObject.call(this, common.getUniqueId());
+  common.EventTarget.call(this);
+
+  internal.postMessage("DownloadConstructor", [this._id]);
+
+  options = options || {};
+
+  this._addMethod("start");
+  this._addMethod("pause");
+  this._addMethod("cancel");
+
+  function ProgressEvent(type, data) {
+    this.type = type;
+    this.received = data.received;
+    this.total = data.total;
+  }
+
+  this._addEvent("progress", ProgressEvent);
+  this._addEvent("complete");
+  this._addEvent("error");
+
+  Object.defineProperties(this, {
+    "_progressObserver": {
+      value: new ProgressObserver(this._id),
+    },
+    "_progressObserverDeleter": {
+      value: v8tools.lifecycleTracker(),
+    },
+    "url": {
+      value: url,
+      enumerable: true,
+    },
+    "path": {
+      value: path,
+      enumerable: true,
+    },
+    "received": {
+      get: function() { return this._progressObserver.received; },
+      enumerable: true,
+    },
+    "total": {
+      get: function() { return this._progressObserver.total; },
+      enumerable: true,
+    },
+  });
+
+  var watcher = this._progressObserver;
+  this._progressObserverDeleter.destructor = function() {
+    watcher.destructor();
+  };
+
+  // This is needed, otherwise events like "error" can get fired before
+  // we give the user a chance to register a listener.
+  function delayedInitialization(obj) {
+    obj._postMessage("init", [url, path, options]);
+  };
+
+  this._registerLifecycleTracker();
+  setTimeout(delayedInitialization, 0, this);
+};
+
+Download.prototype = new common.EventTargetPrototype();
+Download.prototype.constructor = Download;
+
+exports.Download = Download;
@@ -0,0 +1,84 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/sysapps/downloader/downloader_extension.h"
+
+#include "grit/xwalk_sysapps_resources.h"
+#include "net/url_request/url_request_context_getter.h"
+#include "ui/base/resource/resource_bundle.h"
+#include "xwalk/sysapps/common/binding_object_proxy.h"
+#include "xwalk/sysapps/common/sysapps_manager.h"
+#include "xwalk/sysapps/downloader/download_object.h"
+#include "xwalk/sysapps/downloader/downloader.h"
+
+using namespace xwalk::jsapi::downloader; // NOLINT
+
+namespace xwalk {
+namespace sysapps {
+
+namespace {
+
+BindingObject* CreateDownloadObject(
+    scoped_refptr<net::URLRequestContextGetter> request_context_getter,
+    const base::FilePath& download_root) {
+  return new DownloadObject(request_context_getter.get(),
+                            SysAppsManager::GetFileTaskRunner(),
+                            download_root);
+}
+
+}  // namespace
+
+DownloaderExtension::DownloaderExtension(
+    net::URLRequestContextGetter* request_context_getter,
+    const base::FilePath& download_root)
+    : request_context_getter_(request_context_getter),
+      download_root_(download_root) {
+  set_name("xwalk.experimental.downloader");
+  set_javascript_api(ResourceBundle::GetSharedInstance().GetRawDataResource(
+      IDR_XWALK_SYSAPPS_DOWNLOADER_API).as_string());
+}
+
+DownloaderExtension::~DownloaderExtension() {}
+
+XWalkExtensionInstance* DownloaderExtension::CreateInstance() {
+  return new DownloaderInstance(request_context_getter_.get(), download_root_);
+}
+
+DownloaderInstance::DownloaderInstance(
+    net::URLRequestContextGetter* request_context_getter,
+    const base::FilePath& download_root)
+  : handler_(this),
+    store_(&handler_),
+    request_context_getter_(request_context_getter),
+    download_root_(download_root) {
+  handler_.Register("DownloadConstructor",
+      base::Bind(&DownloaderInstance::OnDownloadConstructor,
+                 base::Unretained(this)));
+}
+
+DownloaderInstance::~DownloaderInstance() {}
+
+void DownloaderInstance::HandleMessage(scoped_ptr<base::Value> msg) {
+  handler_.HandleMessage(msg.Pass());
+}
+
+void DownloaderInstance::OnDownloadConstructor(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  scoped_ptr<DownloadConstructor::Params>
+      params(DownloadConstructor::Params::Create(*info->arguments()));
+
+  if (!params) {
+    LOG(WARNING) << "Malformed parameters passed to " << info->name();
+    return;
+  }
+
+  scoped_ptr<BindingObject> obj(new BindingObjectProxy(
+      request_context_getter_->GetNetworkTaskRunner(),
+      base::Bind(&CreateDownloadObject, request_context_getter_,
+                 download_root_)));
+  store_.AddBindingObject(params->object_id, obj.Pass());
+}
+
+}  // namespace sysapps
+}  // namespace xwalk
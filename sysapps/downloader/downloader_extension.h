@@ -0,0 +1,63 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_SYSAPPS_DOWNLOADER_DOWNLOADER_EXTENSION_H_
+#define XWALK_SYSAPPS_DOWNLOADER_DOWNLOADER_EXTENSION_H_
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "xwalk/sysapps/common/binding_object_store.h"
+
+namespace net {
+class URLRequestContextGetter;
+}
+
+namespace xwalk {
+namespace sysapps {
+
+using extensions::XWalkExtension;
+using extensions::XWalkExtensionFunctionHandler;
+using extensions::XWalkExtensionFunctionInfo;
+using extensions::XWalkExtensionInstance;
+
+class DownloaderExtension : public XWalkExtension {
+ public:
+  // The downloads are made with the cookies and the proxy settings of
+  // |request_context_getter|, and saved under |download_root|.
+  DownloaderExtension(net::URLRequestContextGetter* request_context_getter,
+                      const base::FilePath& download_root);
+  virtual ~DownloaderExtension();
+
+  // XWalkExtension implementation.
+  virtual XWalkExtensionInstance* CreateInstance() OVERRIDE;
+
+ private:
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
+  base::FilePath download_root_;
+};
+
+// The download objects live on the network thread of the request context,
+// only proxies of them are kept in the store.
+class DownloaderInstance : public XWalkExtensionInstance {
+ public:
+  DownloaderInstance(net::URLRequestContextGetter* request_context_getter,
+                     const base::FilePath& download_root);
+  virtual ~DownloaderInstance();
+
+  // XWalkExtensionInstance implementation.
+  virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE;
+
+ private:
+  void OnDownloadConstructor(scoped_ptr<XWalkExtensionFunctionInfo> info);
+
+  XWalkExtensionFunctionHandler handler_;
+  BindingObjectStore store_;
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
+  base::FilePath download_root_;
+};
+
+}  // namespace sysapps
+}  // namespace xwalk
+
+#endif  // XWALK_SYSAPPS_DOWNLOADER_DOWNLOADER_EXTENSION_H_
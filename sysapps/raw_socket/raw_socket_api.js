@@ -37,6 +37,62 @@ var ReadyStateObserver = function(object_id, initial_state) {
 
 ReadyStateObserver.prototype = new common.EventTargetPrototype();
 
+// Same as ReadyStateObserver, keeps up with the bytes the native side has
+// written so far, which bufferedAmount is computed from.
+//
+var WriteObserver = function(object_id) {
+  common.BindingObject.call(this, object_id);
+  common.EventTarget.call(this);
+
+  this._addEvent("written");
+  this.bytesWritten = 0;
+
+  var that = this;
+  this.onwritten = function(event) {
+    that.bytesWritten = event.data;
+  };
+
+  this.destructor = function() {
+    this.onwritten = null;
+  };
+};
+
+WriteObserver.prototype = new common.EventTargetPrototype();
+
+// Keep in sync with tcp_socket_object.cc.
+var kHighWatermark = 1024 * 1024;
+
+function isBinary(data) {
+  return data instanceof ArrayBuffer ||
+      (data instanceof Object && data.buffer instanceof ArrayBuffer);
+};
+
+function getByteLength(data) {
+  if (isBinary(data))
+    return data.byteLength;
+
+  // Strings are sent UTF-8 encoded. Lone surrogates can't be encoded and end
+  // up replaced by U+FFFD on the native side, which takes 3 bytes.
+  var length = 0;
+  for (var i = 0; i < data.length; ++i) {
+    var c = data.charCodeAt(i);
+    if (c < 0x80) {
+      length += 1;
+    } else if (c < 0x800) {
+      length += 2;
+    } else if (c >= 0xD800 && c <= 0xDBFF && i + 1 < data.length &&
+               data.charCodeAt(i + 1) >= 0xDC00 &&
+               data.charCodeAt(i + 1) <= 0xDFFF) {
+      length += 4;
+      ++i;
+    } else {
+      length += 3;
+    }
+  }
+
+  return length;
+};
+
 // TCPSocket interface.
 //
 // TODO(tmpsantos): We are currently not throwing any exceptions
@@ -45,10 +101,12 @@ ReadyStateObserver.prototype = new common.EventTargetPrototype();
 // TODO(tmpsantos): TCPOptions argument is being ignored by now.
 //
 var TCPSocket = function(remoteAddress, remotePort, options, object_id) {
-  common.BindingObject.call(this, object_id ? object_id : common.getUniqueId());
+  var is_accepted = object_id != undefined;
+  common.BindingObject.call(
+      this, is_accepted ? object_id : common.getUniqueId());
   common.EventTarget.call(this);
 
-  if (object_id == undefined)
+  if (!is_accepted)
     internal.postMessage("TCPSocketConstructor", [this._id]);
 
   options = options || {};
@@ -69,6 +127,8 @@ var TCPSocket = function(remoteAddress, remotePort, options, object_id) {
   this._addMethod("suspend");
   this._addMethod("resume");
   this._addMethod("_sendString");
+  this._addMethod("_sendArrayBuffer");
+  this._addMethod("_received");
 
   this._addEvent("drain");
   this._addEvent("open");
@@ -76,15 +136,21 @@ var TCPSocket = function(remoteAddress, remotePort, options, object_id) {
   this._addEvent("error");
   this._addEvent("data");
 
+  // ArrayBuffers and views of them are handed to the native side as binary
+  // values, which are written to the socket without being copied again.
   function sendWrapper(data) {
-    this._sendString(data);
-
-    // FIXME(tmpsantos): The spec says that send() should always
-    // return if you can keep sending data. This can only be
-    // verified in the native implementation, which makes this
-    // call sync. We are returning always true here to keep the
-    // implementation async.
-    return true;
+    if (isBinary(data)) {
+      this._sendArrayBuffer(data);
+    } else {
+      data = String(data);
+      this._sendString(data);
+    }
+
+    this._bytesSent += getByteLength(data);
+
+    // The native side queues everything, false tells the caller to wait
+    // for "drain" before sending more.
+    return this.bufferedAmount < kHighWatermark;
   };
 
   function closeWrapper(data) {
@@ -106,11 +172,28 @@ var TCPSocket = function(remoteAddress, remotePort, options, object_id) {
   Object.defineProperties(this, {
     "_readyStateObserver": {
       value: new ReadyStateObserver(
-          this._id, object_id ? "open" : "opening"),
+          this._id, is_accepted ? "open" : "opening"),
     },
     "_readyStateObserverDeleter": {
       value: v8tools.lifecycleTracker(),
     },
+    "_writeObserver": {
+      value: new WriteObserver(this._id),
+    },
+    "_bytesSent": {
+      value: 0,
+      writable: true,
+    },
+    // Tells the native side how much was handed to the "data" listeners, it
+    // stops reading from the socket when this falls too far behind.
+    "_dispatchEventFromExtension": {
+      value: function(type, data) {
+        TCPSocket.prototype._dispatchEventFromExtension.call(this, type, data);
+        if (type == "data" &&
+            this._readyStateObserver.readyState != "closed")
+          this._received(data.byteLength);
+      },
+    },
     "send": {
       value: sendWrapper,
       enumerable: true,
@@ -148,7 +231,14 @@ var TCPSocket = function(remoteAddress, remotePort, options, object_id) {
       enumerable: true,
     },
     "bufferedAmount": {
-      value: 0,
+      get: function() {
+        return this._bytesSent - this._writeObserver.bytesWritten;
+      },
+      enumerable: true,
+    },
+    // send() returns false once bufferedAmount reaches it.
+    "highWaterMark": {
+      value: kHighWatermark,
       enumerable: true,
     },
     "readyState": {
@@ -158,8 +248,10 @@ var TCPSocket = function(remoteAddress, remotePort, options, object_id) {
   });
 
   var watcher = this._readyStateObserver;
+  var writeWatcher = this._writeObserver;
   this._readyStateObserverDeleter.destructor = function() {
     watcher.destructor();
+    writeWatcher.destructor();
   };
 
   // This is needed, otherwise events like "error" can get fired before
@@ -196,6 +288,8 @@ var TCPServerSocket = function(options) {
     options.addressReuse = true;
   if (!options.useSecureTransport)
     options.useSecureTransport = false;
+  if (!options.backlog)
+    options.backlog = 128;
 
   this._addMethod("_close");
   this._addMethod("suspend");
@@ -213,7 +307,8 @@ var TCPServerSocket = function(options) {
   }
 
   this._addEvent("open");
-  this._addEvent("connect", ConnectEvent);
+  // Connections accepted together come in a single batch.
+  this._addEvent("connect", ConnectEvent, true);
   this._addEvent("error");
   this._addEvent("connecterror");
 
@@ -248,6 +343,10 @@ var TCPServerSocket = function(options) {
       value: options.addressReuse,
       enumerable: true,
     },
+    "backlog": {
+      value: options.backlog,
+      enumerable: true,
+    },
     "readyState": {
       get: function() { return this._readyStateObserver.readyState; },
       enumerable: true,
@@ -302,18 +401,22 @@ var UDPSocket = function(options) {
   this._addMethod("joinMulticast");
   this._addMethod("leaveMulticast");
   this._addMethod("_sendString");
+  this._addMethod("_sendMany");
 
   function MessageEvent(type, data) {
     this.type = type;
     this.data = data.data;
     this.remotePort = data.remotePort;
     this.remoteAddress = data.remoteAddress;
+    // Only with the "timestamps" option.
+    this.timestamp = data.timestamp;
   }
 
   this._addEvent("open");
   this._addEvent("drain");
   this._addEvent("error");
-  this._addEvent("message", MessageEvent);
+  // Datagrams read together come in a single batch.
+  this._addEvent("message", MessageEvent, true);
 
   function sendWrapper(data, remoteAddress, remotePort) {
     this._sendString(data, remoteAddress, remotePort);
@@ -326,6 +429,15 @@ var UDPSocket = function(options) {
     return true;
   };
 
+  // |datagrams| is an array of {data, remoteAddress, remotePort}, |data|
+  // being a string or an ArrayBuffer (or a view of one) as for send().
+  function sendManyWrapper(datagrams) {
+    this._sendMany(datagrams);
+
+    // See sendWrapper().
+    return true;
+  };
+
   function closeWrapper(data) {
     if (this._readyStateObserver.readyState == "closed")
       return;
@@ -345,6 +457,10 @@ var UDPSocket = function(options) {
       value: sendWrapper,
       enumerable: true,
     },
+    "sendMany": {
+      value: sendManyWrapper,
+      enumerable: true,
+    },
     "close": {
       value: closeWrapper,
       enumerable: true,
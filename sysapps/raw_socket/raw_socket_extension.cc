@@ -4,8 +4,10 @@
 
 #include "xwalk/sysapps/raw_socket/raw_socket_extension.h"
 
+#include "base/message_loop/message_loop_proxy.h"
 #include "grit/xwalk_sysapps_resources.h"
 #include "ui/base/resource/resource_bundle.h"
+#include "xwalk/sysapps/common/sysapps_manager.h"
 #include "xwalk/sysapps/raw_socket/raw_socket.h"
 #include "xwalk/sysapps/raw_socket/tcp_server_socket_object.h"
 #include "xwalk/sysapps/raw_socket/tcp_socket_object.h"
@@ -16,6 +18,23 @@ using namespace xwalk::jsapi::raw_socket; // NOLINT
 namespace xwalk {
 namespace sysapps {
 
+namespace {
+
+BindingObject* CreateTCPServerSocketObject(
+    const RawSocketInstance::AddBindingObjectCallback& add_object_callback) {
+  return new TCPServerSocketObject(add_object_callback);
+}
+
+BindingObject* CreateTCPSocketObject() {
+  return new TCPSocketObject;
+}
+
+BindingObject* CreateUDPSocketObject() {
+  return new UDPSocketObject;
+}
+
+}  // namespace
+
 RawSocketExtension::RawSocketExtension() {
   set_name("xwalk.experimental.raw_socket");
   set_javascript_api(ResourceBundle::GetSharedInstance().GetRawDataResource(
@@ -30,7 +49,9 @@ XWalkExtensionInstance* RawSocketExtension::CreateInstance() {
 
 RawSocketInstance::RawSocketInstance()
   : handler_(this),
-    store_(&handler_) {
+    store_(&handler_),
+    socket_task_runner_(SysAppsManager::GetSocketTaskRunner()),
+    weak_factory_(this) {
   handler_.Register("TCPServerSocketConstructor",
       base::Bind(&RawSocketInstance::OnTCPServerSocketConstructor,
                  base::Unretained(this)));
@@ -42,15 +63,38 @@ RawSocketInstance::RawSocketInstance()
                  base::Unretained(this)));
 }
 
+RawSocketInstance::~RawSocketInstance() {}
+
 void RawSocketInstance::HandleMessage(scoped_ptr<base::Value> msg) {
   handler_.HandleMessage(msg.Pass());
 }
 
-void RawSocketInstance::AddBindingObject(const std::string& object_id,
+void RawSocketInstance::AddBindingObject(int object_id,
                                          scoped_ptr<BindingObject> obj) {
   store_.AddBindingObject(object_id, obj.Pass());
 }
 
+// static
+void RawSocketInstance::PostAddBindingObject(
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+    base::WeakPtr<RawSocketInstance> instance,
+    int object_id,
+    scoped_ptr<BindingObject> obj) {
+  // Dropped with the task if the instance is gone, which is fine as long
+  // as |obj| can be deleted from any thread, as proxies can.
+  task_runner->PostTask(FROM_HERE,
+      base::Bind(&RawSocketInstance::AddBindingObject, instance, object_id,
+                 base::Passed(&obj)));
+}
+
+void RawSocketInstance::AddSocketObject(
+    int object_id,
+    const BindingObjectProxy::ObjectFactory& factory) {
+  scoped_ptr<BindingObject> obj(
+      new BindingObjectProxy(socket_task_runner_, factory));
+  store_.AddBindingObject(object_id, obj.Pass());
+}
+
 void RawSocketInstance::OnTCPServerSocketConstructor(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
   scoped_ptr<TCPServerSocketConstructor::Params>
@@ -61,8 +105,12 @@ void RawSocketInstance::OnTCPServerSocketConstructor(
     return;
   }
 
-  scoped_ptr<BindingObject> obj(new TCPServerSocketObject(this));
-  store_.AddBindingObject(params->object_id, obj.Pass());
+  // Accepted connections are proxied and added from the socket thread.
+  AddSocketObject(params->object_id, base::Bind(
+      &CreateTCPServerSocketObject,
+      base::Bind(&RawSocketInstance::PostAddBindingObject,
+                 base::MessageLoopProxy::current(),
+                 weak_factory_.GetWeakPtr())));
 }
 
 void RawSocketInstance::OnTCPSocketConstructor(
@@ -75,8 +123,7 @@ void RawSocketInstance::OnTCPSocketConstructor(
     return;
   }
 
-  scoped_ptr<BindingObject> obj(new TCPSocketObject);
-  store_.AddBindingObject(params->object_id, obj.Pass());
+  AddSocketObject(params->object_id, base::Bind(&CreateTCPSocketObject));
 }
 
 void RawSocketInstance::OnUDPSocketConstructor(
@@ -89,8 +136,7 @@ void RawSocketInstance::OnUDPSocketConstructor(
     return;
   }
 
-  scoped_ptr<BindingObject> obj(new UDPSocketObject);
-  store_.AddBindingObject(params->object_id, obj.Pass());
+  AddSocketObject(params->object_id, base::Bind(&CreateUDPSocketObject));
 }
 
 }  // namespace sysapps
@@ -6,7 +6,10 @@
 #define XWALK_SYSAPPS_RAW_SOCKET_RAW_SOCKET_EXTENSION_H_
 
 #include <string>
+#include "base/memory/weak_ptr.h"
+#include "base/single_thread_task_runner.h"
 #include "base/values.h"
+#include "xwalk/sysapps/common/binding_object_proxy.h"
 #include "xwalk/sysapps/common/binding_object_store.h"
 
 namespace xwalk {
@@ -26,17 +29,32 @@ class RawSocketExtension : public XWalkExtension {
   virtual XWalkExtensionInstance* CreateInstance() OVERRIDE;
 };
 
+// The socket objects live on the socket thread of SysAppsManager, only
+// proxies of them are kept in the store.
 class RawSocketInstance : public XWalkExtensionInstance {
  public:
+  // Adds an object to the store from any thread.
+  typedef base::Callback<void(int object_id, scoped_ptr<BindingObject> obj)>
+      AddBindingObjectCallback;
+
   RawSocketInstance();
+  virtual ~RawSocketInstance();
 
   // XWalkExtensionInstance implementation.
   virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE;
 
-  void AddBindingObject(const std::string& object_id,
-                        scoped_ptr<BindingObject> obj);
+  void AddBindingObject(int object_id, scoped_ptr<BindingObject> obj);
 
  private:
+  static void PostAddBindingObject(
+      scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+      base::WeakPtr<RawSocketInstance> instance,
+      int object_id,
+      scoped_ptr<BindingObject> obj);
+
+  void AddSocketObject(int object_id,
+                       const BindingObjectProxy::ObjectFactory& factory);
+
   void OnTCPServerSocketConstructor(
       scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnTCPSocketConstructor(scoped_ptr<XWalkExtensionFunctionInfo> info);
@@ -44,6 +62,9 @@ class RawSocketInstance : public XWalkExtensionInstance {
 
   XWalkExtensionFunctionHandler handler_;
   BindingObjectStore store_;
+  scoped_refptr<base::SingleThreadTaskRunner> socket_task_runner_;
+
+  base::WeakPtrFactory<RawSocketInstance> weak_factory_;
 };
 
 }  // namespace sysapps
@@ -4,15 +4,28 @@
 
 #include "xwalk/sysapps/raw_socket/raw_socket_object.h"
 
+#include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/values.h"
 
 namespace xwalk {
 namespace sysapps {
 
+RawSocketObject::Stats::Stats()
+    : bytes_read(0),
+      bytes_written(0),
+      writes(0) {}
+
 RawSocketObject::RawSocketObject() {}
 
-RawSocketObject::~RawSocketObject() {}
+RawSocketObject::~RawSocketObject() {
+  VLOG(1) << "Socket read " << stats_.bytes_read << " bytes, wrote "
+      << stats_.bytes_written << " bytes in " << stats_.writes
+      << " writes, average write latency "
+      << (stats_.writes ?
+          (stats_.total_write_latency / stats_.writes).InMicroseconds() : 0)
+      << " us, max " << stats_.max_write_latency.InMicroseconds() << " us";
+}
 
 void RawSocketObject::setReadyState(ReadyState state) {
   scoped_ptr<base::ListValue> eventData(new base::ListValue);
@@ -21,5 +34,18 @@ void RawSocketObject::setReadyState(ReadyState state) {
   DispatchEvent("readystate", eventData.Pass());
 }
 
+void RawSocketObject::RecordRead(int bytes) {
+  stats_.bytes_read += bytes;
+}
+
+void RawSocketObject::RecordWrite(int bytes, base::TimeTicks start_time) {
+  const base::TimeDelta latency = base::TimeTicks::Now() - start_time;
+  stats_.bytes_written += bytes;
+  ++stats_.writes;
+  stats_.total_write_latency += latency;
+  if (latency > stats_.max_write_latency)
+    stats_.max_write_latency = latency;
+}
+
 }  // namespace sysapps
 }  // namespace xwalk
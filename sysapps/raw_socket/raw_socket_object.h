@@ -5,6 +5,7 @@
 #ifndef XWALK_SYSAPPS_RAW_SOCKET_RAW_SOCKET_OBJECT_H_
 #define XWALK_SYSAPPS_RAW_SOCKET_RAW_SOCKET_OBJECT_H_
 
+#include "base/time/time.h"
 #include "xwalk/sysapps/raw_socket/raw_socket.h"
 #include "xwalk/sysapps/common/event_target.h"
 
@@ -16,12 +17,32 @@ namespace sysapps {
 // Base class for the objects of the RawSocket API.
 class RawSocketObject : public EventTarget {
  public:
+  // Logged when the socket goes away.
+  struct Stats {
+    Stats();
+
+    int64 bytes_read;
+    int64 bytes_written;
+    int64 writes;
+    // From issuing a write on the socket to its completion.
+    base::TimeDelta total_write_latency;
+    base::TimeDelta max_write_latency;
+  };
+
   virtual ~RawSocketObject();
 
+  const Stats& stats() const { return stats_; }
+
  protected:
   RawSocketObject();
 
   void setReadyState(ReadyState state);
+
+  void RecordRead(int bytes);
+  void RecordWrite(int bytes, base::TimeTicks start_time);
+
+ private:
+  Stats stats_;
 };
 
 }  // namespace sysapps
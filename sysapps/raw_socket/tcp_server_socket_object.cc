@@ -5,12 +5,17 @@
 #include "xwalk/sysapps/raw_socket/tcp_server_socket_object.h"
 
 #include <string.h>
-#include "base/guid.h"
+#include <algorithm>
+#include "base/bind.h"
+#include "base/atomic_sequence_num.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_util.h"
 #include "net/socket/stream_socket.h"
+#include "xwalk/sysapps/common/binding_object_proxy.h"
 #include "xwalk/sysapps/common/binding_object_store.h"
 #include "xwalk/sysapps/raw_socket/tcp_server_socket.h"
 #include "xwalk/sysapps/raw_socket/tcp_socket.h"
@@ -19,13 +24,35 @@
 using namespace xwalk::jsapi::tcp_server_socket; // NOLINT
 using namespace xwalk::jsapi::raw_socket; // NOLINT
 
+namespace {
+
+const int kMaxBacklog = 1024;
+
+// Connections dispatched in a single "connect" event at most, the rest is
+// accepted after yielding to the message loop.
+const size_t kMaxAcceptBatchSize = 32;
+
+// Errors like running out of file descriptors would otherwise be retried
+// right away, over and over.
+const int kAcceptRetryDelayMs = 100;
+
+// Accepted connections are created by the native side, so they take
+// negative handles, which never clash with the ones allocated by JavaScript.
+base::StaticAtomicSequenceNumber g_next_connection_id;
+
+}  // namespace
+
 namespace xwalk {
 namespace sysapps {
 
-TCPServerSocketObject::TCPServerSocketObject(RawSocketInstance* instance)
+TCPServerSocketObject::TCPServerSocketObject(
+    const RawSocketInstance::AddBindingObjectCallback& add_object_callback)
   : is_suspended_(false),
     is_accepting_(false),
-    instance_(instance) {
+    has_accept_pending_(false),
+    connections_(new base::ListValue),
+    add_object_callback_(add_object_callback),
+    weak_factory_(this) {
   handler_.Register("init",
       base::Bind(&TCPServerSocketObject::OnInit, base::Unretained(this)));
   handler_.Register("_close",
@@ -39,9 +66,90 @@ TCPServerSocketObject::TCPServerSocketObject(RawSocketInstance* instance)
 TCPServerSocketObject::~TCPServerSocketObject() {}
 
 void TCPServerSocketObject::DoAccept() {
-  socket_->Accept(&accepted_socket_,
-                  base::Bind(&TCPServerSocketObject::OnAccept,
-                             base::Unretained(this)));
+  while (socket_ && !has_accept_pending_ && !is_suspended_) {
+    int ret = socket_->Accept(&accepted_socket_,
+                              base::Bind(&TCPServerSocketObject::OnAccept,
+                                         base::Unretained(this)));
+
+    if (ret == net::ERR_IO_PENDING) {
+      has_accept_pending_ = true;
+      break;
+    }
+
+    if (!DidAccept(ret))
+      break;
+
+    if (connections_->GetSize() >= kMaxAcceptBatchSize) {
+      base::MessageLoop::current()->PostTask(
+          FROM_HERE, base::Bind(&TCPServerSocketObject::DoAccept,
+                                weak_factory_.GetWeakPtr()));
+      break;
+    }
+  }
+
+  DispatchConnections();
+}
+
+bool TCPServerSocketObject::DidAccept(int status) {
+  if (status != net::OK) {
+    LOG(WARNING) << "Failed to accept a connection: "
+        << net::ErrorToString(status);
+    DispatchEvent("connecterror");
+
+    has_accept_pending_ = true;
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE, base::Bind(&TCPServerSocketObject::OnAcceptRetry,
+                              weak_factory_.GetWeakPtr()),
+        base::TimeDelta::FromMilliseconds(kAcceptRetryDelayMs));
+    return false;
+  }
+
+  if (!is_accepting_) {
+    // The spec is not really clear about what to do when we get a incoming
+    // connection but nobody is listening. We are just closing the socket in
+    // this case.
+    accepted_socket_.reset();
+    return true;
+  }
+
+  net::IPEndPoint local_address;
+  accepted_socket_->GetLocalAddress(&local_address);
+
+  jsapi::tcp_socket::TCPOptions options;
+  options.local_address = local_address.ToStringWithoutPort();
+  options.local_port = local_address.port();
+  options.address_reuse = false;
+  options.no_delay = true;
+  options.use_secure_transport = false;
+
+  int object_id = -(g_next_connection_id.GetNext() + 1);
+  scoped_ptr<BindingObject> obj(new TCPSocketObject(accepted_socket_.Pass()));
+  scoped_ptr<BindingObject> proxy(new BindingObjectProxy(
+      base::MessageLoopProxy::current(), obj.Pass()));
+  add_object_callback_.Run(object_id, proxy.Pass());
+
+  base::ListValue* connection = new base::ListValue;
+  connection->AppendInteger(object_id);
+  connection->Append(options.ToValue().release());
+  connections_->Append(connection);
+  return true;
+}
+
+void TCPServerSocketObject::DispatchConnections() {
+  // Connections accepted right before suspend() wait for resume().
+  if (connections_->empty() || is_suspended_)
+    return;
+
+  scoped_ptr<base::ListValue> eventData(new base::ListValue);
+  eventData->Append(connections_.release());
+  connections_.reset(new base::ListValue);
+
+  DispatchEvent("connect", eventData.Pass());
+}
+
+void TCPServerSocketObject::OnAcceptRetry() {
+  has_accept_pending_ = false;
+  DoAccept();
 }
 
 void TCPServerSocketObject::StartEvent(const std::string& type) {
@@ -74,8 +182,10 @@ void TCPServerSocketObject::OnInit(
 
   socket_.reset(new net::TCPServerSocket(NULL, net::NetLog::Source()));
   net::IPEndPoint address(ip_number, params->options.local_port);
+  const int backlog =
+      std::min(std::max(params->options.backlog, 1), kMaxBacklog);
 
-  if (socket_->Listen(address, 5) != net::OK) {
+  if (socket_->Listen(address, backlog) != net::OK) {
     LOG(WARNING) << "Failed to listen on " << params->options.local_address
         << " port " << params->options.local_port;
     setReadyState(READY_STATE_CLOSED);
@@ -92,6 +202,7 @@ void TCPServerSocketObject::OnClose(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
   if (socket_)
     socket_.reset();
+  has_accept_pending_ = false;
 
   setReadyState(READY_STATE_CLOSED);
   DispatchEvent("close");
@@ -104,41 +215,19 @@ void TCPServerSocketObject::OnSuspend(
 
 void TCPServerSocketObject::OnResume(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (!is_suspended_)
+    return;
+
   is_suspended_ = false;
+  DoAccept();
 }
 
 void TCPServerSocketObject::OnAccept(int status) {
-  if (is_accepting_ && !is_suspended_) {
-    net::IPEndPoint local_address;
-    accepted_socket_->GetLocalAddress(&local_address);
-
-    jsapi::tcp_socket::TCPOptions options;
-    options.local_address = local_address.ToStringWithoutPort();
-    options.local_port = local_address.port();
-    options.address_reuse = false;
-    options.no_delay = true;
-    options.use_secure_transport = false;
-
-    std::string object_id = base::GenerateGUID();
-    scoped_ptr<BindingObject> obj(new TCPSocketObject(accepted_socket_.Pass()));
-    instance_->AddBindingObject(object_id, obj.Pass());
-
-    scoped_ptr<base::ListValue> dataList(new base::ListValue);
-    dataList->AppendString(object_id);
-    dataList->Append(options.ToValue().release());
-
-    scoped_ptr<base::ListValue> eventData(new base::ListValue);
-    eventData->Append(dataList.release());
-
-    DispatchEvent("connect", eventData.Pass());
-  } else {
-    // The spec is not really clear about what to do when we get a incoming
-    // connection but nobody is listening. We are just closing the socket in
-    // this case.
-    accepted_socket_.reset();
-  }
-
-  DoAccept();
+  has_accept_pending_ = false;
+  if (DidAccept(status))
+    DoAccept();
+  else
+    DispatchConnections();
 }
 
 }  // namespace sysapps
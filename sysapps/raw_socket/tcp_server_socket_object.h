@@ -6,6 +6,8 @@
 #define XWALK_SYSAPPS_RAW_SOCKET_TCP_SERVER_SOCKET_OBJECT_H_
 
 #include <string>
+#include "base/memory/weak_ptr.h"
+#include "base/values.h"
 #include "net/socket/tcp_server_socket.h"
 #include "xwalk/sysapps/common/event_target.h"
 #include "xwalk/sysapps/raw_socket/raw_socket_extension.h"
@@ -18,11 +20,19 @@ class BindingObjectStore;
 
 class TCPServerSocketObject : public RawSocketObject {
  public:
-  explicit TCPServerSocketObject(RawSocketInstance* instance);
+  explicit TCPServerSocketObject(
+      const RawSocketInstance::AddBindingObjectCallback& add_object_callback);
   virtual ~TCPServerSocketObject();
 
  private:
+  // Accepts every connection already waiting, up to a batch size, and
+  // dispatches them together in a single "connect" event. Nothing is
+  // accepted while suspended, connections wait in the listen backlog.
   void DoAccept();
+  // Returns false if accepting should pause.
+  bool DidAccept(int status);
+  void DispatchConnections();
+  void OnAcceptRetry();
 
   // EventTarget implementation.
   virtual void StartEvent(const std::string& type) OVERRIDE;
@@ -39,11 +49,15 @@ class TCPServerSocketObject : public RawSocketObject {
 
   bool is_suspended_;
   bool is_accepting_;
+  bool has_accept_pending_;
 
   scoped_ptr<net::TCPServerSocket> socket_;
   scoped_ptr<net::StreamSocket> accepted_socket_;
+  scoped_ptr<base::ListValue> connections_;
 
-  RawSocketInstance* instance_;
+  RawSocketInstance::AddBindingObjectCallback add_object_callback_;
+
+  base::WeakPtrFactory<TCPServerSocketObject> weak_factory_;
 };
 
 }  // namespace sysapps
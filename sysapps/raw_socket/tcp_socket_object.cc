@@ -5,7 +5,9 @@
 #include "xwalk/sysapps/raw_socket/tcp_socket_object.h"
 
 #include <string.h>
+#include <algorithm>
 #include "base/logging.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_util.h"
 #include "xwalk/sysapps/raw_socket/tcp_socket.h"
@@ -15,7 +17,41 @@ using namespace xwalk::jsapi::raw_socket; // NOLINT
 
 namespace {
 
-const unsigned kBufferSize = 4096;
+const int kMinReadSize = 4096;
+const int kMaxReadSize = 64 * 1024;
+
+// Upper bounds of a "data" event.
+const int kMaxReadBatchSize = 256 * 1024;
+const int kMaxReadBatchDelayMs = 4;
+
+// Reading stops when JavaScript is this much behind.
+const int64 kReceiveHighWatermark = 1024 * 1024;
+
+// Keep in sync with raw_socket_api.js.
+const int64 kHighWatermark = 1024 * 1024;
+const int64 kLowWatermark = 256 * 1024;
+
+// Sends smaller than this are copied together in a single write, bigger ones
+// are written straight from the buffer they arrived in.
+const int kGatherThreshold = 16 * 1024;
+const int kMaxGatherSize = 64 * 1024;
+
+// Lends the bytes of an ArrayBuffer deserialized from the IPC message to the
+// socket, without copying them.
+class BinaryIOBuffer : public net::IOBuffer {
+ public:
+  explicit BinaryIOBuffer(scoped_ptr<base::BinaryValue> value)
+      : net::IOBuffer(value->GetBuffer()),
+        value_(value.Pass()) {}
+
+ private:
+  virtual ~BinaryIOBuffer() {
+    // The memory belongs to |value_|.
+    data_ = NULL;
+  }
+
+  scoped_ptr<base::BinaryValue> value_;
+};
 
 }  // namespace
 
@@ -24,10 +60,16 @@ namespace sysapps {
 
 TCPSocketObject::TCPSocketObject()
     : has_write_pending_(false),
+      has_read_pending_(false),
       is_suspended_(false),
       is_half_closed_(false),
-      read_buffer_(new net::IOBuffer(kBufferSize)),
-      write_buffer_(new net::IOBuffer(kBufferSize)),
+      is_closed_(false),
+      needs_drain_(false),
+      read_buffer_(new net::GrowableIOBuffer),
+      read_size_(kMinReadSize),
+      received_amount_(0),
+      buffered_amount_(0),
+      bytes_written_(0),
       resolver_(net::HostResolver::CreateDefaultResolver(NULL)),
       single_resolver_(new net::SingleRequestHostResolver(resolver_.get())) {
   RegisterHandlers();
@@ -35,10 +77,16 @@ TCPSocketObject::TCPSocketObject()
 
 TCPSocketObject::TCPSocketObject(scoped_ptr<net::StreamSocket> socket)
     : has_write_pending_(false),
+      has_read_pending_(false),
       is_suspended_(false),
       is_half_closed_(false),
-      read_buffer_(new net::IOBuffer(kBufferSize)),
-      write_buffer_(new net::IOBuffer(kBufferSize)),
+      is_closed_(false),
+      needs_drain_(false),
+      read_buffer_(new net::GrowableIOBuffer),
+      read_size_(kMinReadSize),
+      received_amount_(0),
+      buffered_amount_(0),
+      bytes_written_(0),
       socket_(socket.release()) {
   RegisterHandlers();
 }
@@ -58,19 +106,106 @@ void TCPSocketObject::RegisterHandlers() {
       base::Bind(&TCPSocketObject::OnResume, base::Unretained(this)));
   handler_.Register("_sendString",
       base::Bind(&TCPSocketObject::OnSendString, base::Unretained(this)));
+  handler_.Register("_sendArrayBuffer",
+      base::Bind(&TCPSocketObject::OnSendArrayBuffer, base::Unretained(this)));
+  handler_.Register("_received",
+      base::Bind(&TCPSocketObject::OnReceived, base::Unretained(this)));
 }
 
 void TCPSocketObject::DoRead() {
-  if (!socket_->IsConnected())
+  while (socket_->IsConnected() && CanRead()) {
+    if (read_buffer_->RemainingCapacity() < read_size_)
+      read_buffer_->SetCapacity(read_buffer_->offset() + read_size_);
+
+    int ret = socket_->Read(read_buffer_.get(),
+                            read_size_,
+                            base::Bind(&TCPSocketObject::OnRead,
+                                       base::Unretained(this)));
+
+    if (ret == net::ERR_IO_PENDING) {
+      has_read_pending_ = true;
+      ScheduleReadFlush();
+      return;
+    }
+
+    if (!DidRead(ret))
+      return;
+  }
+
+  // Stopped by the flow control, what was read so far is still sent.
+  FlushReadBatch();
+}
+
+bool TCPSocketObject::CanRead() const {
+  return !is_suspended_ && received_amount_ < kReceiveHighWatermark;
+}
+
+void TCPSocketObject::MaybeResumeReading() {
+  if (is_closed_ || !socket_.get() || has_read_pending_ || !CanRead())
+    return;
+
+  DoRead();
+}
+
+bool TCPSocketObject::DidRead(int status) {
+  if (status <= 0) {
+    FlushReadBatch();
+    is_closed_ = true;
+    setReadyState(READY_STATE_CLOSED);
+    // No data means the other side has disconnected the socket.
+    DispatchEvent(status == 0 ? "close" : "error");
+    return false;
+  }
+
+  if (status == read_size_ && read_size_ < kMaxReadSize)
+    read_size_ *= 2;
+  else if (status < read_size_ / 4 && read_size_ > kMinReadSize)
+    read_size_ /= 2;
+
+  RecordRead(status);
+  read_buffer_->set_offset(read_buffer_->offset() + status);
+  if (read_buffer_->offset() >= kMaxReadBatchSize)
+    FlushReadBatch();
+
+  return true;
+}
+
+void TCPSocketObject::ScheduleReadFlush() {
+  if (!read_buffer_->offset())
+    return;
+
+  // A read size that never grew means light traffic, nothing is worth
+  // holding the data back for.
+  if (read_size_ == kMinReadSize) {
+    FlushReadBatch();
+    return;
+  }
+
+  if (!flush_timer_.IsRunning()) {
+    flush_timer_.Start(FROM_HERE,
+                       base::TimeDelta::FromMilliseconds(kMaxReadBatchDelayMs),
+                       this, &TCPSocketObject::FlushReadBatch);
+  }
+}
+
+void TCPSocketObject::FlushReadBatch() {
+  flush_timer_.Stop();
+
+  // Kept until resume() while suspended.
+  const int size = read_buffer_->offset();
+  if (!size || is_suspended_ || is_closed_)
     return;
+  read_buffer_->set_offset(0);
 
-  int ret = socket_->Read(read_buffer_,
-                          kBufferSize,
-                          base::Bind(&TCPSocketObject::OnRead,
-                                     base::Unretained(this)));
+  // Nobody would report the data as consumed.
+  if (!IsEventActive("data"))
+    return;
 
-  if (ret > 0)
-    OnRead(ret);
+  scoped_ptr<base::ListValue> eventData(new base::ListValue);
+  eventData->Append(base::BinaryValue::CreateWithCopiedBuffer(
+      read_buffer_->StartOfBuffer(), size));
+  DispatchEvent("data", eventData.Pass());
+  received_amount_ += size;
 }
 
 void TCPSocketObject::OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info) {
@@ -82,6 +217,7 @@ void TCPSocketObject::OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info) {
   scoped_ptr<Init::Params> params(Init::Params::Create(*info->arguments()));
   if (!params) {
     LOG(WARNING) << "Malformed parameters passed to " << info->name();
+    is_closed_ = true;
     setReadyState(READY_STATE_CLOSED);
     DispatchEvent("error");
     return;
@@ -101,9 +237,21 @@ void TCPSocketObject::OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info) {
 }
 
 void TCPSocketObject::OnClose(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (is_closed_)
+    return;
+
   if (socket_.get())
     socket_->Disconnect();
 
+  // Whatever was read or queued is dropped, nothing is dispatched after
+  // "close".
+  is_closed_ = true;
+  flush_timer_.Stop();
+  read_buffer_->set_offset(0);
+  write_queue_.clear();
+  buffered_amount_ = 0;
+  needs_drain_ = false;
+
   setReadyState(READY_STATE_CLOSED);
   DispatchEvent("close");
 }
@@ -117,19 +265,40 @@ void TCPSocketObject::OnHalfClose(scoped_ptr<XWalkExtensionFunctionInfo> info) {
 }
 
 void TCPSocketObject::OnSuspend(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (is_closed_)
+    return;
+
   is_suspended_ = true;
 }
 
 void TCPSocketObject::OnResume(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (is_closed_ || !is_suspended_)
+    return;
+
   is_suspended_ = false;
+  FlushReadBatch();
+  MaybeResumeReading();
 }
 
-void TCPSocketObject::OnSendString(
-    scoped_ptr<XWalkExtensionFunctionInfo> info) {
-  if (is_half_closed_ || has_write_pending_)
+void TCPSocketObject::OnReceived(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (is_closed_)
     return;
 
-  if (!socket_.get() || !socket_->IsConnected())
+  double bytes = 0;
+  if (!info->arguments()->GetDouble(0, &bytes)) {
+    LOG(WARNING) << "Malformed parameters passed to " << info->name();
+    return;
+  }
+
+  received_amount_ =
+      std::max<int64>(0, received_amount_ - static_cast<int64>(bytes));
+  MaybeResumeReading();
+}
+
+void TCPSocketObject::OnSendString(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (is_closed_ || is_half_closed_ || !socket_.get() ||
+      !socket_->IsConnected())
     return;
 
   scoped_ptr<SendDOMString::Params>
@@ -140,24 +309,129 @@ void TCPSocketObject::OnSendString(
     return;
   }
 
-  if (params->data.size() > kBufferSize) {
-    LOG(WARNING) << "Write data bigger than the write buffer.";
+  QueueWrite(new net::StringIOBuffer(params->data), params->data.size());
+}
+
+void TCPSocketObject::OnSendArrayBuffer(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (is_closed_ || is_half_closed_ || !socket_.get() ||
+      !socket_->IsConnected())
+    return;
+
+  // Taken out of the arguments instead of going through the generated
+  // Params, which would copy the payload in a std::string.
+  scoped_ptr<base::Value> value;
+  if (!info->arguments()->Remove(0, &value) ||
+      !value->IsType(base::Value::TYPE_BINARY)) {
+    LOG(WARNING) << "Malformed parameters passed to " << info->name();
     return;
   }
 
-  memcpy(write_buffer_->data(), params->data.data(), params->data.size());
+  scoped_ptr<base::BinaryValue> binary(
+      static_cast<base::BinaryValue*>(value.release()));
+  const int size = binary->GetSize();
+  if (!size)
+    return;
 
-  int ret = socket_->Write(write_buffer_,
-                           params->data.size(),
-                           base::Bind(&TCPSocketObject::OnWrite,
-                                      base::Unretained(this)));
+  QueueWrite(new BinaryIOBuffer(binary.Pass()), size);
+}
 
-  if (ret == net::ERR_IO_PENDING)
-    has_write_pending_ = true;
-  else if (ret == static_cast<int>(params->data.size()))
+void TCPSocketObject::QueueWrite(net::IOBuffer* buffer, int size) {
+  if (!size)
     return;
-  else
-    socket_->Disconnect();
+
+  write_queue_.push_back(new net::DrainableIOBuffer(buffer, size));
+  buffered_amount_ += size;
+  if (buffered_amount_ >= kHighWatermark)
+    needs_drain_ = true;
+
+  bool did_write = false;
+  if (DoWrite(&did_write) && did_write)
+    NotifyWritten();
+}
+
+bool TCPSocketObject::DoWrite(bool* did_write) {
+  *did_write = false;
+  while (!has_write_pending_ && !write_queue_.empty()) {
+    scoped_refptr<net::IOBuffer> buffer = write_queue_.front();
+    int size = write_queue_.front()->BytesRemaining();
+
+    if (size < kGatherThreshold && write_queue_.size() > 1) {
+      size = 0;
+      for (size_t i = 0; i < write_queue_.size() && size < kMaxGatherSize; ++i)
+        size += std::min(write_queue_[i]->BytesRemaining(),
+                         kMaxGatherSize - size);
+
+      buffer = new net::IOBuffer(size);
+      int offset = 0;
+      for (size_t i = 0; offset < size; ++i) {
+        const int length =
+            std::min(write_queue_[i]->BytesRemaining(), size - offset);
+        memcpy(buffer->data() + offset, write_queue_[i]->data(), length);
+        offset += length;
+      }
+    }
+
+    write_start_time_ = base::TimeTicks::Now();
+    int ret = socket_->Write(buffer.get(),
+                             size,
+                             base::Bind(&TCPSocketObject::OnWrite,
+                                        base::Unretained(this)));
+
+    if (ret == net::ERR_IO_PENDING) {
+      has_write_pending_ = true;
+      break;
+    }
+
+    if (ret < 0) {
+      OnWriteError();
+      return false;
+    }
+
+    DidWrite(ret);
+    *did_write = true;
+  }
+
+  return true;
+}
+
+void TCPSocketObject::DidWrite(int bytes) {
+  RecordWrite(bytes, write_start_time_);
+  buffered_amount_ -= bytes;
+  bytes_written_ += bytes;
+
+  while (bytes > 0) {
+    net::DrainableIOBuffer* buffer = write_queue_.front().get();
+    const int consumed = std::min(bytes, buffer->BytesRemaining());
+    buffer->DidConsume(consumed);
+    bytes -= consumed;
+    if (!buffer->BytesRemaining())
+      write_queue_.pop_front();
+  }
+}
+
+void TCPSocketObject::NotifyWritten() {
+  // The JavaScript side computes bufferedAmount out of this.
+  scoped_ptr<base::ListValue> eventData(new base::ListValue);
+  eventData->AppendDouble(static_cast<double>(bytes_written_));
+  DispatchEvent("written", eventData.Pass());
+
+  if (needs_drain_ && buffered_amount_ <= kLowWatermark) {
+    needs_drain_ = false;
+    DispatchEvent("drain");
+  }
+}
+
+void TCPSocketObject::OnWriteError() {
+  socket_->Disconnect();
+  is_closed_ = true;
+  flush_timer_.Stop();
+  read_buffer_->set_offset(0);
+  write_queue_.clear();
+  buffered_amount_ = 0;
+  needs_drain_ = false;
+  setReadyState(READY_STATE_CLOSED);
+  DispatchEvent("error");
 }
 
 void TCPSocketObject::OnConnect(int status) {
@@ -170,40 +444,43 @@ void TCPSocketObject::OnConnect(int status) {
     DispatchEvent("open");
     DoRead();
   } else {
+    is_closed_ = true;
     setReadyState(READY_STATE_CLOSED);
     DispatchEvent("error");
   }
 }
 
 void TCPSocketObject::OnRead(int status) {
-  scoped_ptr<base::ListValue> eventData(new base::ListValue);
+  has_read_pending_ = false;
+  if (DidRead(status))
+    DoRead();
+}
 
-  // No data means the other side has
-  // disconnected the socket.
-  if (status == 0) {
-    setReadyState(READY_STATE_CLOSED);
-    DispatchEvent("close", eventData.Pass());
+void TCPSocketObject::OnWrite(int status) {
+  has_write_pending_ = false;
+
+  if (status < 0) {
+    OnWriteError();
     return;
   }
 
-  scoped_ptr<base::Value> data(base::BinaryValue::CreateWithCopiedBuffer(
-      static_cast<char*>(read_buffer_->data()), status));
-
-  eventData->Append(data.release());
+  DidWrite(status);
 
-  if (!is_suspended_)
-    DispatchEvent("data", eventData.Pass());
-
-  DoRead();
-}
+  // The socket is already closed and "error" dispatched if this fails.
+  bool did_write = false;
+  if (!DoWrite(&did_write))
+    return;
 
-void TCPSocketObject::OnWrite(int status) {
-  has_write_pending_ = false;
-  DispatchEvent("drain");
+  NotifyWritten();
 }
 
 void TCPSocketObject::OnResolved(int status) {
+  // Closed while resolving.
+  if (is_closed_)
+    return;
+
   if (status != net::OK) {
+    is_closed_ = true;
     setReadyState(READY_STATE_CLOSED);
     DispatchEvent("error");
     return;
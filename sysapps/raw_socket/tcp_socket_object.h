@@ -5,7 +5,9 @@
 #ifndef XWALK_SYSAPPS_RAW_SOCKET_TCP_SOCKET_OBJECT_H_
 #define XWALK_SYSAPPS_RAW_SOCKET_TCP_SOCKET_OBJECT_H_
 
+#include <deque>
 #include <string>
+#include "base/timer/timer.h"
 #include "net/dns/single_request_host_resolver.h"
 #include "net/base/io_buffer.h"
 #include "net/socket/tcp_client_socket.h"
@@ -22,7 +24,33 @@ class TCPSocketObject : public RawSocketObject {
 
  private:
   void RegisterHandlers();
+
+  // Reads are gathered in |read_buffer_| and dispatched as a single "data"
+  // event once the socket has nothing more to read right away, or, under
+  // sustained load, after a short delay or when the batch is full.
+  //
+  // Reading stops while suspended or while JavaScript hasn't consumed more
+  // than a high watermark of the data dispatched, so the TCP window of the
+  // kernel throttles the peer instead of data piling up or being dropped.
   void DoRead();
+  bool CanRead() const;
+  void MaybeResumeReading();
+  // Returns false when the socket can't be read anymore.
+  bool DidRead(int status);
+  void ScheduleReadFlush();
+  void FlushReadBatch();
+
+  // Sends are queued without any size limit, JavaScript is told to hold
+  // back by send() returning false once the buffered amount goes over a high
+  // watermark, and "drain" is dispatched when it gets back under a low one.
+  void QueueWrite(net::IOBuffer* buffer, int size);
+  // Returns false if the write failed, in which case the socket is already
+  // closed and "error" dispatched. |did_write| tells whether anything was
+  // written synchronously.
+  bool DoWrite(bool* did_write);
+  void DidWrite(int bytes);
+  void NotifyWritten();
+  void OnWriteError();
 
   // JavaScript function handlers.
   void OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info);
@@ -31,6 +59,8 @@ class TCPSocketObject : public RawSocketObject {
   void OnSuspend(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnResume(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnSendString(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnSendArrayBuffer(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnReceived(scoped_ptr<XWalkExtensionFunctionInfo> info);
 
   // net::TCPClientSocket callbacks.
   void OnConnect(int status);
@@ -41,11 +71,24 @@ class TCPSocketObject : public RawSocketObject {
   void OnResolved(int status);
 
   bool has_write_pending_;
+  bool has_read_pending_;
   bool is_suspended_;
   bool is_half_closed_;
+  // Set once "close" or "error" is dispatched, the messages still coming
+  // from JavaScript are dropped from then on.
+  bool is_closed_;
+  bool needs_drain_;
 
-  scoped_refptr<net::IOBuffer> read_buffer_;
-  scoped_refptr<net::IOBuffer> write_buffer_;
+  scoped_refptr<net::GrowableIOBuffer> read_buffer_;
+  // Grows while reads fill it completely and shrinks back when they don't.
+  int read_size_;
+  base::OneShotTimer<TCPSocketObject> flush_timer_;
+  // Dispatched to JavaScript but not reported as consumed yet.
+  int64 received_amount_;
+  std::deque<scoped_refptr<net::DrainableIOBuffer> > write_queue_;
+  int64 buffered_amount_;
+  int64 bytes_written_;
+  base::TimeTicks write_start_time_;
   scoped_ptr<net::StreamSocket> socket_;
 
   scoped_ptr<net::HostResolver> resolver_;
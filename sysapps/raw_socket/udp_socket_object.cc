@@ -6,7 +6,10 @@
 
 #include <string.h>
 
+#include <string>
+
 #include "base/logging.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
 #include "xwalk/sysapps/raw_socket/udp_socket.h"
 
@@ -16,6 +19,12 @@ using namespace xwalk::jsapi::raw_socket; // NOLINT
 namespace {
 
 const unsigned kBufferSize = 4096;
+const int kMaxDatagramSize = 65507;
+
+// Upper bounds of a "message" batch.
+const size_t kMaxMessageBatchSize = 64;
+const int kMaxMessageBatchBytes = 256 * 1024;
+const int kMaxMessageBatchDelayMs = 4;
 
 }  // namespace
 
@@ -26,9 +35,17 @@ UDPSocketObject::UDPSocketObject()
     : has_write_pending_(false),
       is_suspended_(false),
       is_reading_(false),
+      has_read_pending_(false),
+      has_timestamps_(false),
+      receive_buffer_size_(0),
+      send_buffer_size_(0),
       resolver_(net::HostResolver::CreateDefaultResolver(NULL)),
       read_buffer_(new net::IOBuffer(kBufferSize)),
+      read_buffer_size_(kBufferSize),
       write_buffer_(new net::IOBuffer(kBufferSize)),
+      message_batch_(new base::ListValue),
+      message_batch_bytes_(0),
+      last_message_batch_size_(0),
       single_resolver_(new net::SingleRequestHostResolver(resolver_.get())) {
   handler_.Register("init",
       base::Bind(&UDPSocketObject::OnInit, base::Unretained(this)));
@@ -44,6 +61,8 @@ UDPSocketObject::UDPSocketObject()
       base::Bind(&UDPSocketObject::OnLeaveMulticast, base::Unretained(this)));
   handler_.Register("_sendString",
       base::Bind(&UDPSocketObject::OnSendString, base::Unretained(this)));
+  handler_.Register("_sendMany",
+      base::Bind(&UDPSocketObject::OnSendMany, base::Unretained(this)));
 }
 
 UDPSocketObject::~UDPSocketObject() {}
@@ -54,14 +73,107 @@ void UDPSocketObject::DoRead() {
 
   is_reading_ = true;
 
-  int ret = socket_->RecvFrom(read_buffer_,
-                              kBufferSize,
-                              &from_,
-                              base::Bind(&UDPSocketObject::OnRead,
-                                         base::Unretained(this)));
+  while (socket_->is_connected() && !is_suspended_) {
+    int ret = socket_->RecvFrom(read_buffer_,
+                                read_buffer_size_,
+                                &from_,
+                                base::Bind(&UDPSocketObject::OnRead,
+                                           base::Unretained(this)));
+
+    if (ret == net::ERR_IO_PENDING) {
+      has_read_pending_ = true;
+      ScheduleMessageFlush();
+      return;
+    }
+
+    if (!DidRead(ret))
+      return;
+  }
+
+  FlushMessageBatch();
+}
+
+bool UDPSocketObject::DidRead(int status) {
+  if (status == net::ERR_MSG_TOO_BIG && read_buffer_size_ < kMaxDatagramSize) {
+    // The datagram is lost, but the next ones will fit.
+    read_buffer_size_ = kMaxDatagramSize;
+    read_buffer_ = new net::IOBuffer(read_buffer_size_);
+    return true;
+  }
+
+  // No data means the other side has
+  // disconnected the socket.
+  if (status <= 0) {
+    FlushMessageBatch();
+    setReadyState(READY_STATE_CLOSED);
+    DispatchEvent(status == 0 ? "close" : "error");
+    return false;
+  }
+
+  RecordRead(status);
+
+  // Built by hand, UDPMessageEvent would copy the payload once more in a
+  // std::string.
+  base::DictionaryValue* message = new base::DictionaryValue;
+  message->Set("data", base::BinaryValue::CreateWithCopiedBuffer(
+      read_buffer_->data(), status));
+  message->SetString("remoteAddress", from_.ToStringWithoutPort());
+  message->SetInteger("remotePort", from_.port());
+  // Taken when the datagram is read, the kernel timestamps of
+  // SO_TIMESTAMPNS aren't reachable through net::UDPSocket. Good enough to
+  // measure the latency, the batch delay isn't included.
+  if (has_timestamps_)
+    message->SetDouble("timestamp", base::Time::Now().ToJsTime());
+  message_batch_->Append(message);
+  message_batch_bytes_ += status;
+
+  if (message_batch_->GetSize() >= kMaxMessageBatchSize ||
+      message_batch_bytes_ >= kMaxMessageBatchBytes)
+    FlushMessageBatch();
+
+  return true;
+}
+
+void UDPSocketObject::ScheduleMessageFlush() {
+  if (message_batch_->empty())
+    return;
+
+  // Datagrams coming one at a time aren't held back.
+  if (last_message_batch_size_ <= 1) {
+    FlushMessageBatch();
+    return;
+  }
 
-  if (ret > 0)
-    OnRead(ret);
+  if (!flush_timer_.IsRunning()) {
+    flush_timer_.Start(
+        FROM_HERE, base::TimeDelta::FromMilliseconds(kMaxMessageBatchDelayMs),
+        this, &UDPSocketObject::FlushMessageBatch);
+  }
+}
+
+void UDPSocketObject::FlushMessageBatch() {
+  flush_timer_.Stop();
+
+  // Kept until resume() while suspended.
+  if (!socket_ || message_batch_->empty() || is_suspended_)
+    return;
+  last_message_batch_size_ = message_batch_->GetSize();
+
+  scoped_ptr<base::ListValue> eventData(new base::ListValue);
+  eventData->Append(message_batch_.release());
+  message_batch_.reset(new base::ListValue);
+  message_batch_bytes_ = 0;
+
+  DispatchEvent("message", eventData.Pass());
+}
+
+void UDPSocketObject::SetBufferSizes() {
+  if (receive_buffer_size_ > 0 &&
+      !socket_->SetReceiveBufferSize(receive_buffer_size_))
+    LOG(WARNING) << "Can't set the receive buffer size.";
+  if (send_buffer_size_ > 0 &&
+      !socket_->SetSendBufferSize(send_buffer_size_))
+    LOG(WARNING) << "Can't set the send buffer size.";
 }
 
 void UDPSocketObject::OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info) {
@@ -83,6 +195,24 @@ void UDPSocketObject::OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info) {
     return;
   }
 
+  // The multicast options can only be set before the socket is open.
+  socket_->SetMulticastLoopbackMode(params->options->loopback);
+  if (params->options->multicast_ttl &&
+      socket_->SetMulticastTimeToLive(*params->options->multicast_ttl) !=
+          net::OK) {
+    LOG(WARNING) << "Invalid multicast TTL "
+                 << *params->options->multicast_ttl;
+    setReadyState(READY_STATE_CLOSED);
+    DispatchEvent("error");
+    return;
+  }
+  if (params->options->receive_buffer_size)
+    receive_buffer_size_ = *params->options->receive_buffer_size;
+  if (params->options->send_buffer_size)
+    send_buffer_size_ = *params->options->send_buffer_size;
+  if (params->options->timestamps)
+    has_timestamps_ = *params->options->timestamps;
+
   if (!params->options->local_address.empty()) {
     net::IPAddressNumber ip_number;
     if (!net::ParseIPLiteralToNumber(params->options->local_address,
@@ -104,6 +234,7 @@ void UDPSocketObject::OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info) {
       return;
     }
 
+    SetBufferSizes();
     DoRead();
     OnConnectionOpen(net::OK);
     return;
@@ -132,22 +263,69 @@ void UDPSocketObject::OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info) {
 
 void UDPSocketObject::OnClose(scoped_ptr<XWalkExtensionFunctionInfo> info) {
   socket_.reset();
+
+  // Nothing is dispatched once closed, what was held back or queued is
+  // dropped.
+  flush_timer_.Stop();
+  message_batch_->Clear();
+  message_batch_bytes_ = 0;
+  send_queue_.clear();
 }
 
 void UDPSocketObject::OnSuspend(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (!socket_)
+    return;
+
   is_suspended_ = true;
 }
 
 void UDPSocketObject::OnResume(scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (!is_suspended_)
+    return;
+
   is_suspended_ = false;
+  if (!socket_)
+    return;
+
+  FlushMessageBatch();
+  if (is_reading_ && !has_read_pending_)
+    DoRead();
 }
 
 void UDPSocketObject::OnJoinMulticast(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  scoped_ptr<JoinMulticast::Params>
+      params(JoinMulticast::Params::Create(*info->arguments()));
+  if (!params) {
+    LOG(WARNING) << "Malformed parameters passed to " << info->name();
+    return;
+  }
+
+  net::IPAddressNumber group;
+  if (!socket_ ||
+      !net::ParseIPLiteralToNumber(params->multicast_group_address, &group) ||
+      socket_->JoinGroup(group) != net::OK) {
+    LOG(WARNING) << "Can't join the multicast group "
+                 << params->multicast_group_address;
+  }
 }
 
 void UDPSocketObject::OnLeaveMulticast(
     scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  scoped_ptr<LeaveMulticast::Params>
+      params(LeaveMulticast::Params::Create(*info->arguments()));
+  if (!params) {
+    LOG(WARNING) << "Malformed parameters passed to " << info->name();
+    return;
+  }
+
+  net::IPAddressNumber group;
+  if (!socket_ ||
+      !net::ParseIPLiteralToNumber(params->multicast_group_address, &group) ||
+      socket_->LeaveGroup(group) != net::OK) {
+    LOG(WARNING) << "Can't leave the multicast group "
+                 << params->multicast_group_address;
+  }
 }
 
 void UDPSocketObject::OnSendString(
@@ -192,38 +370,141 @@ void UDPSocketObject::OnSendString(
     has_write_pending_ = true;
 }
 
-void UDPSocketObject::OnRead(int status) {
-  // No data means the other side has
-  // disconnected the socket.
-  if (status == 0) {
-    setReadyState(READY_STATE_CLOSED);
-    DispatchEvent("close");
+void UDPSocketObject::OnSendMany(
+    scoped_ptr<XWalkExtensionFunctionInfo> info) {
+  if (!socket_ || has_write_pending_)
+    return;
+
+  scoped_ptr<SendMany::Params>
+      params(SendMany::Params::Create(*info->arguments()));
+  if (!params) {
+    LOG(WARNING) << "Malformed parameters passed to " << info->name();
     return;
   }
 
-  scoped_ptr<base::Value> data(base::BinaryValue::CreateWithCopiedBuffer(
-      static_cast<char*>(read_buffer_->data()), status));
+  for (size_t i = 0; i < params->datagrams.size(); ++i) {
+    const UDPDatagram& datagram = *params->datagrams[i];
+    // Strings are sent UTF-8 encoded, ArrayBuffers and their views come as
+    // binary values.
+    std::string string_data;
+    const char* data = NULL;
+    size_t size = 0;
+    if (datagram.data->GetAsString(&string_data)) {
+      data = string_data.data();
+      size = string_data.size();
+    } else if (datagram.data->IsType(base::Value::TYPE_BINARY)) {
+      const base::BinaryValue* binary =
+          static_cast<const base::BinaryValue*>(datagram.data.get());
+      data = binary->GetBuffer();
+      size = binary->GetSize();
+    } else {
+      LOG(WARNING) << "Datagram data is neither a string nor an ArrayBuffer.";
+      continue;
+    }
 
-  UDPMessageEvent event;
-  event.data = std::string(read_buffer_->data(), status);
-  event.remote_port = from_.port();
-  event.remote_address = from_.ToStringWithoutPort();
+    if (size > static_cast<size_t>(kMaxDatagramSize)) {
+      LOG(WARNING) << "Datagram bigger than the maximum UDP payload.";
+      continue;
+    }
 
-  scoped_ptr<base::ListValue> eventData(new base::ListValue);
-  eventData->Append(event.ToValue().release());
+    QueuedDatagram queued;
+    if (datagram.remote_address) {
+      net::IPAddressNumber ip_number;
+      if (!net::ParseIPLiteralToNumber(*datagram.remote_address,
+                                       &ip_number)) {
+        LOG(WARNING) << "Invalid IP address " << *datagram.remote_address;
+        continue;
+      }
+      queued.address = net::IPEndPoint(
+          ip_number, datagram.remote_port ? *datagram.remote_port : 0);
+    } else if (!addresses_.empty()) {
+      queued.address = addresses_[0];
+    } else {
+      LOG(WARNING) << "No remote address to send the datagram to.";
+      continue;
+    }
 
-  if (!is_suspended_)
-    DispatchEvent("message", eventData.Pass());
+    queued.buffer = new net::IOBufferWithSize(size);
+    memcpy(queued.buffer->data(), data, size);
+    send_queue_.push_back(queued);
+  }
+
+  if (send_queue_.empty())
+    return;
 
-  DoRead();
+  if (!socket_->is_connected()) {
+    // See OnSend().
+    if (is_reading_ ||
+        socket_->Connect(send_queue_.front().address) != net::OK) {
+      send_queue_.clear();
+      setReadyState(READY_STATE_CLOSED);
+      DispatchEvent("error");
+      return;
+    }
+    SetBufferSizes();
+  }
+
+  SendQueuedDatagrams();
+
+  if (!is_reading_ && socket_ && socket_->is_connected())
+    DoRead();
+}
+
+void UDPSocketObject::SendQueuedDatagrams() {
+  // net::UDPSocket has no sendmmsg(), the gain is in having a single
+  // message from the renderer for all the datagrams.
+  while (!send_queue_.empty()) {
+    const QueuedDatagram& queued = send_queue_.front();
+    write_start_time_ = base::TimeTicks::Now();
+    int ret = socket_->SendTo(
+        queued.buffer,
+        queued.buffer->size(),
+        queued.address,
+        base::Bind(&UDPSocketObject::OnWrite, base::Unretained(this)));
+
+    if (ret == net::ERR_IO_PENDING) {
+      has_write_pending_ = true;
+      send_queue_.pop_front();
+      return;
+    }
+
+    if (ret != queued.buffer->size()) {
+      send_queue_.clear();
+      socket_->Close();
+      setReadyState(READY_STATE_CLOSED);
+      DispatchEvent("close");
+      return;
+    }
+
+    RecordWrite(ret, write_start_time_);
+    send_queue_.pop_front();
+  }
+
+  DispatchEvent("drain");
+}
+
+void UDPSocketObject::OnRead(int status) {
+  has_read_pending_ = false;
+  if (DidRead(status))
+    DoRead();
 }
 
 void UDPSocketObject::OnWrite(int status) {
   has_write_pending_ = false;
+  if (status > 0)
+    RecordWrite(status, write_start_time_);
+  if (!send_queue_.empty()) {
+    SendQueuedDatagrams();
+    return;
+  }
   DispatchEvent("drain");
 }
 
 void UDPSocketObject::OnConnectionOpen(int status) {
+  // Closed while resolving.
+  if (!socket_)
+    return;
+
   if (status != net::OK) {
     setReadyState(READY_STATE_CLOSED);
     DispatchEvent("error");
@@ -235,6 +516,9 @@ void UDPSocketObject::OnConnectionOpen(int status) {
 }
 
 void UDPSocketObject::OnSend(int status) {
+  if (!socket_)
+    return;
+
   if (status != net::OK || addresses_.empty()) {
     setReadyState(READY_STATE_CLOSED);
     DispatchEvent("error");
@@ -249,8 +533,10 @@ void UDPSocketObject::OnSend(int status) {
       DispatchEvent("error");
       return;
     }
+    SetBufferSizes();
   }
 
+  write_start_time_ = base::TimeTicks::Now();
   int ret = socket_->SendTo(
       write_buffer_,
       write_buffer_size_,
@@ -261,6 +547,7 @@ void UDPSocketObject::OnSend(int status) {
     has_write_pending_ = true;
   } else if (ret == write_buffer_size_) {
     has_write_pending_ = false;
+    RecordWrite(ret, write_start_time_);
   } else {
     socket_->Close();
     setReadyState(READY_STATE_CLOSED);
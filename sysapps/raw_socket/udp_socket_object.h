@@ -5,8 +5,11 @@
 #ifndef XWALK_SYSAPPS_RAW_SOCKET_UDP_SOCKET_OBJECT_H_
 #define XWALK_SYSAPPS_RAW_SOCKET_UDP_SOCKET_OBJECT_H_
 
+#include <deque>
 #include <string>
 
+#include "base/timer/timer.h"
+#include "base/values.h"
 #include "net/base/address_list.h"
 #include "net/base/io_buffer.h"
 #include "net/dns/single_request_host_resolver.h"
@@ -22,7 +25,17 @@ class UDPSocketObject : public RawSocketObject {
   virtual ~UDPSocketObject();
 
  private:
+  // Datagrams available right away are read in a row, like recvmmsg()
+  // would, and dispatched together in a single "message" batch. Nothing is
+  // read while suspended, the datagrams wait in the socket buffer of the
+  // kernel.
   void DoRead();
+  // Returns false when the socket can't be read anymore.
+  bool DidRead(int status);
+  void ScheduleMessageFlush();
+  void FlushMessageBatch();
+  // Once the socket is open, applies the buffer sizes given to init().
+  void SetBufferSizes();
 
   // JavaScript function handlers.
   void OnInit(scoped_ptr<XWalkExtensionFunctionInfo> info);
@@ -32,6 +45,11 @@ class UDPSocketObject : public RawSocketObject {
   void OnJoinMulticast(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnLeaveMulticast(scoped_ptr<XWalkExtensionFunctionInfo> info);
   void OnSendString(scoped_ptr<XWalkExtensionFunctionInfo> info);
+  void OnSendMany(scoped_ptr<XWalkExtensionFunctionInfo> info);
+
+  // Sends the datagrams queued by sendMany() until the socket would block,
+  // "drain" is dispatched once all are sent.
+  void SendQueuedDatagrams();
 
   // net::UDPSocket callbacks.
   void OnRead(int status);
@@ -44,12 +62,32 @@ class UDPSocketObject : public RawSocketObject {
   bool has_write_pending_;
   bool is_suspended_;
   bool is_reading_;
+  bool has_read_pending_;
+  bool has_timestamps_;
+  // 0 keeps the default of the kernel.
+  int receive_buffer_size_;
+  int send_buffer_size_;
 
   scoped_refptr<net::IOBuffer> read_buffer_;
+  // Starts small and grows to the largest datagram once one gets truncated.
+  int read_buffer_size_;
   scoped_refptr<net::IOBuffer> write_buffer_;
+
+  scoped_ptr<base::ListValue> message_batch_;
+  int message_batch_bytes_;
+  // Size of the last batch dispatched, to tell sustained load apart.
+  size_t last_message_batch_size_;
+  base::OneShotTimer<UDPSocketObject> flush_timer_;
   scoped_ptr<net::UDPSocket> socket_;
 
   unsigned write_buffer_size_;
+  base::TimeTicks write_start_time_;
+
+  struct QueuedDatagram {
+    scoped_refptr<net::IOBufferWithSize> buffer;
+    net::IPEndPoint address;
+  };
+  std::deque<QueuedDatagram> send_queue_;
 
   scoped_ptr<net::HostResolver> resolver_;
   scoped_ptr<net::SingleRequestHostResolver> single_resolver_;
@@ -21,6 +21,8 @@
       ],
       'sources': [
         'common/binding_object.h',
+        'common/binding_object_proxy.cc',
+        'common/binding_object_proxy.h',
         'common/binding_object_store.cc',
         'common/binding_object_store.h',
         'common/common.idl',
@@ -46,6 +48,8 @@
         'device_capabilities/device_capabilities_extension.h',
         'device_capabilities/device_capabilities_object.cc',
         'device_capabilities/device_capabilities_object.h',
+        'device_capabilities/device_capabilities_snapshot.cc',
+        'device_capabilities/device_capabilities_snapshot.h',
         'device_capabilities/display_info_provider.cc',
         'device_capabilities/display_info_provider.h',
         'device_capabilities/display_info_provider_android.cc',
@@ -55,6 +59,14 @@
         'device_capabilities/storage_info_provider.h',
         'device_capabilities/storage_info_provider_android.cc',
         'device_capabilities/storage_info_provider_android.h',
+        'downloader/download.idl',
+        'downloader/download_object.cc',
+        'downloader/download_object.h',
+        'downloader/download_state.cc',
+        'downloader/download_state.h',
+        'downloader/downloader.idl',
+        'downloader/downloader_extension.cc',
+        'downloader/downloader_extension.h',
         'raw_socket/raw_socket.idl',
         'raw_socket/raw_socket_extension.cc',
         'raw_socket/raw_socket_extension.h',
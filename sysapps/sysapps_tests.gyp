@@ -6,20 +6,25 @@
       'dependencies': [
         '../../base/base.gyp:base',
         '../../base/base.gyp:run_all_unittests',
+        '../../base/base.gyp:test_support_base',
         '../../content/content_shell_and_tests.gyp:test_support_content',
         '../../testing/gtest.gyp:gtest',
         '../extensions/extensions.gyp:xwalk_extensions',
         'sysapps.gyp:sysapps',
       ],
       'sources': [
+        'common/binding_object_proxy_unittest.cc',
         'common/binding_object_store_unittest.cc',
         'common/event_target_unittest.cc',
         'common/sysapps_manager_unittest.cc',
         'device_capabilities/av_codecs_provider_unittest.cc',
         'device_capabilities/cpu_info_provider_unittest.cc',
+        'device_capabilities/device_capabilities_snapshot_unittest.cc',
         'device_capabilities/display_info_provider_unittest.cc',
         'device_capabilities/memory_info_provider_unittest.cc',
         'device_capabilities/storage_info_provider_unittest.cc',
+        'downloader/download_object_unittest.cc',
+        'downloader/download_state_unittest.cc',
       ],
       'conditions': [
         ['OS=="linux"', {
@@ -39,6 +44,21 @@
         }],
       ],
     },
+    {
+      'target_name': 'xwalk_sysapps_perftests',
+      'type': 'executable',
+      'dependencies': [
+        '../../base/base.gyp:base',
+        '../../base/base.gyp:test_support_perf',
+        '../../testing/gtest.gyp:gtest',
+        '../../testing/perf/perf_test.gyp:perf_test',
+        '../extensions/extensions.gyp:xwalk_extensions',
+        'sysapps.gyp:sysapps',
+      ],
+      'sources': [
+        'common/binding_object_store_perftest.cc',
+      ],
+    },
     {
       'target_name': 'xwalk_sysapps_browsertest',
       'type': 'executable',
@@ -11,6 +11,7 @@ import org.chromium.base.test.util.Feature;
 import android.test.MoreAsserts;
 import android.test.suitebuilder.annotation.MediumTest;
 import android.util.Pair;
+import android.webkit.ValueCallback;
 
 import org.chromium.content.browser.test.util.Criteria;
 import org.chromium.content.browser.test.util.CriteriaHelper;
@@ -22,6 +23,8 @@ import java.util.Date;
 import java.util.HashSet;
 import java.util.List;
 import java.util.Set;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
 
 import org.xwalk.core.XWalkView;
 import org.xwalk.core.internal.XWalkCookieManager;
@@ -34,6 +37,24 @@ public class CookieManagerTest extends XWalkViewTestBase {
 
     private XWalkCookieManager mCookieManager = null;
 
+    private static class TestValueCallback<T> implements ValueCallback<T> {
+        private final CountDownLatch mLatch = new CountDownLatch(1);
+        private T mValue;
+
+        @Override
+        public void onReceiveValue(T value) {
+            mValue = value;
+            mLatch.countDown();
+        }
+
+        public T waitForValue() throws InterruptedException {
+            assertTrue(mLatch.await(WAIT_TIMEOUT_SECONDS, TimeUnit.SECONDS));
+            return mValue;
+        }
+    }
+
+    private static final long WAIT_TIMEOUT_SECONDS = 5;
+
     @Override
     public void setUp() throws Exception {
         super.setUp();
@@ -233,4 +254,54 @@ public class CookieManagerTest extends XWalkViewTestBase {
             }
         }));
     }
+
+    @MediumTest
+    @Feature({"AsyncCookies"})
+    public void testBatchedAsyncCookies() throws InterruptedException {
+        mCookieManager.setAcceptCookie(true);
+        TestValueCallback<Integer> removed = new TestValueCallback<Integer>();
+        mCookieManager.removeAllCookie(removed);
+        removed.waitForValue();
+
+        TestValueCallback<Boolean> hasCookies = new TestValueCallback<Boolean>();
+        mCookieManager.hasCookies(hasCookies);
+        assertFalse(hasCookies.waitForValue());
+
+        final String url1 = "http://www.example.com";
+        final String url2 = "http://www.example.org";
+        TestValueCallback<Integer> set = new TestValueCallback<Integer>();
+        mCookieManager.setCookies(new String[] { url1, url2 },
+                new String[] { "name=one", "name=two" }, set);
+        assertEquals(Integer.valueOf(2), set.waitForValue());
+
+        TestValueCallback<String[]> cookies = new TestValueCallback<String[]>();
+        mCookieManager.getCookies(
+                new String[] { url1, url2, "http://www.example.net" }, cookies);
+        MoreAsserts.assertEquals(new String[] { "name=one", "name=two", null },
+                cookies.waitForValue());
+
+        TestValueCallback<Boolean> cookieSet = new TestValueCallback<Boolean>();
+        mCookieManager.setCookie(url1, "other=three", cookieSet);
+        assertTrue(cookieSet.waitForValue());
+        TestValueCallback<String> cookie = new TestValueCallback<String>();
+        mCookieManager.getCookie(url1, cookie);
+        assertEquals("name=one; other=three", cookie.waitForValue());
+
+        final CountDownLatch flushed = new CountDownLatch(1);
+        mCookieManager.flushCookieStore(new Runnable() {
+            @Override
+            public void run() {
+                flushed.countDown();
+            }
+        });
+        assertTrue(flushed.await(WAIT_TIMEOUT_SECONDS, TimeUnit.SECONDS));
+
+        mCookieManager.removeAllCookie(null);
+        assertTrue(CriteriaHelper.pollForCriteria(new Criteria() {
+            @Override
+            public boolean isSatisfied() {
+                return !mCookieManager.hasCookies();
+            }
+        }));
+    }
 }
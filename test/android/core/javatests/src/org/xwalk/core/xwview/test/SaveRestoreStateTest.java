@@ -22,6 +22,7 @@ import org.xwalk.core.XWalkView;
 import org.xwalk.core.internal.XWalkClient;
 import org.xwalk.core.xwview.test.util.CommonResources;
 
+import java.util.Arrays;
 import java.util.concurrent.Callable;
 
 public class SaveRestoreStateTest extends XWalkViewTestBase {
@@ -157,6 +158,43 @@ public class SaveRestoreStateTest extends XWalkViewTestBase {
         assertFalse(result);
     }
 
+    @SmallTest
+    @Feature({"SaveRestoreState"})
+    public void testRestoreSavedStateTwice() throws Throwable {
+        setServerResponseAndLoad(NUM_NAVIGATIONS);
+        // The saved state is handed to the native side without a copy, it has
+        // to be left intact for the next restore.
+        boolean result = runTestOnUiThreadAndGetResult(new Callable<Boolean>() {
+            @Override
+            public Boolean call() throws Exception {
+                Bundle bundle = new Bundle();
+                if (!mXWalkView.saveState(bundle)) return false;
+                byte[] saved = bundle.getByteArray("XWALKVIEW_STATE").clone();
+                if (!mRestoreXWalkView.restoreState(bundle)) return false;
+                if (!Arrays.equals(
+                        saved, bundle.getByteArray("XWALKVIEW_STATE"))) {
+                    return false;
+                }
+                return mRestoreXWalkView.restoreState(bundle);
+            }
+        });
+        assertTrue(result);
+    }
+
+    @SmallTest
+    @Feature({"SaveRestoreState"})
+    public void testRestoreFromEmptyStateFails() throws Throwable {
+        final Bundle emptyState = new Bundle();
+        emptyState.putByteArray("XWALKVIEW_STATE", new byte[0]);
+        boolean result = runTestOnUiThreadAndGetResult(new Callable<Boolean>() {
+            @Override
+            public Boolean call() throws Exception {
+                return mXWalkView.restoreState(emptyState);
+            }
+        });
+        assertFalse(result);
+    }
+
     @SmallTest
     @Feature({"SaveRestoreState"})
     public void testSaveStateForNoNavigationFails() throws Throwable {
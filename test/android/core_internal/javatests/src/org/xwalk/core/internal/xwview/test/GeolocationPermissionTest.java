@@ -73,6 +73,58 @@ public class GeolocationPermissionTest extends XWalkViewInternalTestBase {
         });
     }
 
+    @SmallTest
+    @Feature({"GeolocationPermission"})
+    public void testGeolocationPermissionRetained() throws Throwable {
+        class TestWebChromeClient extends XWalkWebChromeClient {
+            public TestWebChromeClient() {
+                super(getXWalkView());
+            }
+
+            private int mCalledCount = 0;
+
+            @Override
+            public void onGeolocationPermissionsShowPrompt(String origin,
+                    XWalkGeolocationPermissions.Callback callback) {
+                callback.invoke(origin, true, true);
+                mCalledCount++;
+            }
+
+            public int getCalledCount() {
+                return mCalledCount;
+            }
+        }
+        final TestWebChromeClient testWebChromeClient = new TestWebChromeClient();
+        getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                getXWalkView().setXWalkWebChromeClient(testWebChromeClient);
+            }
+        });
+        loadAssetFileAndWaitForTitle("geolocation_permission.html");
+        assertEquals("Allowed", getTitleOnUiThread());
+
+        // The retained decision answers the next request without a prompt.
+        loadAssetFileAndWaitForTitle("geolocation_permission.html");
+        assertEquals("Allowed", getTitleOnUiThread());
+        getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                assertEquals(1, testWebChromeClient.getCalledCount());
+            }
+        });
+
+        // Disabling geolocation drops the retained decisions.
+        getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                getXWalkView().getSettings().setGeolocationEnabled(false);
+            }
+        });
+        loadAssetFileAndWaitForTitle("geolocation_permission.html");
+        assertEquals("Denied", getTitleOnUiThread());
+    }
+
     // This is not used now. Need a TODO to follow up this.
     // TODO(hengzhi): how to verify it automaticly.
     // @SmallTest
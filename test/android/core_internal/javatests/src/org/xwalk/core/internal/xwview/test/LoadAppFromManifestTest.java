@@ -0,0 +1,82 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+package org.xwalk.core.internal.xwview.test;
+
+import android.test.suitebuilder.annotation.SmallTest;
+
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.TimeoutException;
+
+import org.chromium.base.test.util.Feature;
+import org.chromium.content.browser.test.util.CallbackHelper;
+import org.chromium.content.browser.test.util.TestCallbackHelperContainer;
+import org.xwalk.core.internal.XWalkResourceClientInternal;
+
+/**
+ * Test suite for loadAppFromManifest() with the manifests read from the assets.
+ */
+public class LoadAppFromManifestTest extends XWalkViewInternalTestBase {
+    private static final String MANIFEST_URL = "file:///android_asset/manifest.json";
+
+    private void loadAppFromManifestAsync(final String url) throws Exception {
+        getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                getXWalkView().loadAppFromManifest(url, null);
+            }
+        });
+    }
+
+    @SmallTest
+    @Feature({"LoadAppFromManifest"})
+    public void testLoadAppFromAssetManifest() throws Throwable {
+        CallbackHelper pageFinishedHelper = mTestHelperBridge.getOnPageFinishedHelper();
+        int currentCallCount = pageFinishedHelper.getCallCount();
+        loadAppFromManifestAsync(MANIFEST_URL);
+        pageFinishedHelper.waitForCallback(currentCallCount, 1, WAIT_TIMEOUT_SECONDS,
+                TimeUnit.SECONDS);
+        assertEquals("Crosswalk Sample Application", getTitleOnUiThread());
+    }
+
+    @SmallTest
+    @Feature({"LoadAppFromManifest"})
+    public void testMissingManifestReportsError() throws Throwable {
+        final String url = "file:///android_asset/missing_manifest.json";
+        TestCallbackHelperContainer.OnReceivedErrorHelper errorHelper =
+                mTestHelperBridge.getOnReceivedErrorHelper();
+        int currentCallCount = errorHelper.getCallCount();
+        loadAppFromManifestAsync(url);
+        errorHelper.waitForCallback(currentCallCount);
+        assertEquals(XWalkResourceClientInternal.ERROR_FILE, errorHelper.getErrorCode());
+        assertEquals(url, errorHelper.getFailingUrl());
+    }
+
+    @SmallTest
+    @Feature({"LoadAppFromManifest"})
+    public void testLoadCancelsPendingManifest() throws Throwable {
+        final String title = "Loaded Meanwhile";
+        CallbackHelper pageFinishedHelper = mTestHelperBridge.getOnPageFinishedHelper();
+        int currentCallCount = pageFinishedHelper.getCallCount();
+        getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                getXWalkView().loadAppFromManifest(MANIFEST_URL, null);
+                getXWalkView().load(null,
+                        "<html><head><title>" + title + "</title></head></html>");
+            }
+        });
+        pageFinishedHelper.waitForCallback(currentCallCount, 1, WAIT_TIMEOUT_SECONDS,
+                TimeUnit.SECONDS);
+        // The start url of the manifest would replace the page once read otherwise.
+        currentCallCount = pageFinishedHelper.getCallCount();
+        try {
+            pageFinishedHelper.waitForCallback(currentCallCount, 1, 2, TimeUnit.SECONDS);
+            fail("The manifest was applied after another page was loaded.");
+        } catch (TimeoutException e) {
+            // Expected.
+        }
+        assertEquals(title, getTitleOnUiThread());
+    }
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+package org.xwalk.core.internal.xwview.test;
+
+import android.test.suitebuilder.annotation.SmallTest;
+
+import java.util.ArrayList;
+import java.util.List;
+
+import org.chromium.base.test.util.Feature;
+import org.xwalk.core.internal.XWalkViewInternal;
+
+/**
+ * Test suite for the order of the per resource callbacks, which are gathered before they
+ * are delivered, with the callbacks made directly.
+ */
+public class ResourceCallbackOrderTest extends XWalkViewInternalTestBase {
+    class OrderRecordingResourceClient extends TestXWalkResourceClientBase {
+        // Only touched on the UI thread.
+        final List<String> mEvents = new ArrayList<String>();
+
+        public OrderRecordingResourceClient() {
+            super(mTestHelperBridge);
+        }
+
+        @Override
+        public void onLoadStarted(XWalkViewInternal view, String url) {
+            mEvents.add("started:" + url);
+            super.onLoadStarted(view, url);
+        }
+
+        @Override
+        public void onLoadFinished(XWalkViewInternal view, String url) {
+            mEvents.add("finished:" + url);
+        }
+    }
+
+    @SmallTest
+    @Feature({"ResourceCallbackOrder"})
+    public void testLoadStartedBeforeLoadFinished() throws Throwable {
+        final String url = "file:///android_asset/www/index.html";
+        final OrderRecordingResourceClient client = new OrderRecordingResourceClient();
+        setResourceClient(client);
+
+        loadUrlSync(url);
+        getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                int started = client.mEvents.indexOf("started:" + url);
+                int finished = client.mEvents.indexOf("finished:" + url);
+                assertTrue(started >= 0);
+                assertTrue(finished > started);
+            }
+        });
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+package org.xwalk.core.internal.xwview.test;
+
+import android.test.suitebuilder.annotation.SmallTest;
+
+import java.util.concurrent.TimeUnit;
+
+import org.chromium.base.test.util.Feature;
+import org.chromium.content.browser.test.util.CallbackHelper;
+import org.xwalk.core.internal.XWalkSettings;
+
+/**
+ * Test suite for setJavaScriptEnabled() called on the UI thread.
+ */
+public class SetJavaScriptEnabledTest extends XWalkViewInternalTestBase {
+    private static final String STATIC_TITLE = "Static";
+    private static final String SCRIPT_TITLE = "Script";
+    private static final String PAGE = "<html><head><title>" + STATIC_TITLE + "</title>"
+            + "<script>document.title = '" + SCRIPT_TITLE + "';</script></head></html>";
+
+    // The setting and the load are done in the same task of the UI thread, so the page
+    // only sees the new value if the setter synced it before returning.
+    private String loadWithJavaScriptEnabled(final boolean enabled) throws Exception {
+        final XWalkSettings settings = getXWalkSettingsOnUiThreadByContent(getXWalkView());
+        CallbackHelper pageFinishedHelper = mTestHelperBridge.getOnPageFinishedHelper();
+        int currentCallCount = pageFinishedHelper.getCallCount();
+        getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                settings.setJavaScriptEnabled(enabled);
+                getXWalkView().load(null, PAGE);
+            }
+        });
+        pageFinishedHelper.waitForCallback(currentCallCount, 1, WAIT_TIMEOUT_SECONDS,
+                TimeUnit.SECONDS);
+        return getTitleOnUiThread();
+    }
+
+    @SmallTest
+    @Feature({"XWalkViewInternal", "Preferences"})
+    public void testSettingAppliesToNextLoad() throws Throwable {
+        assertEquals(STATIC_TITLE, loadWithJavaScriptEnabled(false));
+        assertEquals(SCRIPT_TITLE, loadWithJavaScriptEnabled(true));
+        assertEquals(STATIC_TITLE, loadWithJavaScriptEnabled(false));
+    }
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/bind.h"
+#include "base/strings/stringprintf.h"
+#include "xwalk/application/browser/application.h"
+#include "xwalk/extensions/browser/xwalk_extension_service.h"
+#include "xwalk/extensions/common/xwalk_extension.h"
+#include "xwalk/runtime/browser/runtime.h"
+#include "xwalk/test/perf/xwalk_perf_test.h"
+
+using xwalk::Runtime;
+using xwalk::application::Application;
+using namespace xwalk::extensions;  // NOLINT
+
+namespace {
+
+// The application of test/data/perf_app.
+const char kPerfApp[] = "perf_app";
+
+const char kEchoExtensionName[] = "perf_echo";
+
+const int kAnimatedBoxes = 500;
+const int kFrames = 120;
+const int kEchoes = 200;
+const int kEchoSize = 1024;
+// Same order of magnitude as extensions/test/bulk_data_transmission.
+const int kBulkEchoes = 20;
+const int kBulkEchoSize = 1024 * 1024;
+
+class EchoInstance : public XWalkExtensionInstance {
+ public:
+  virtual void HandleMessage(scoped_ptr<base::Value> msg) OVERRIDE {
+    PostMessageToJS(msg.Pass());
+  }
+};
+
+class EchoExtension : public XWalkExtension {
+ public:
+  EchoExtension() {
+    set_name(kEchoExtensionName);
+    set_javascript_api(
+        "var echoListener = null;"
+        "extension.setMessageListener(function(msg) {"
+        "  if (echoListener instanceof Function) {"
+        "    echoListener(msg);"
+        "  };"
+        "});"
+        "exports.echo = function(msg, callback) {"
+        "  echoListener = callback;"
+        "  extension.postMessage(msg);"
+        "};");
+  }
+
+  virtual XWalkExtensionInstance* CreateInstance() OVERRIDE {
+    return new EchoInstance;
+  }
+};
+
+}  // namespace
+
+// Measures the runtime itself with test/data/perf_app: what a launch costs,
+// how smoothly it animates and what its extension messaging goes through.
+class RuntimePerfTest : public XWalkPerfTest {
+ public:
+  virtual void SetUp() OVERRIDE {
+    XWalkExtensionService::SetCreateExtensionThreadExtensionsCallbackForTesting(
+        base::Bind(&RuntimePerfTest::CreateExtensions,
+                   base::Unretained(this)));
+    XWalkPerfTest::SetUp();
+  }
+
+ protected:
+  void Startup() {
+    Application* app = LaunchApp(base::FilePath().AppendASCII(kPerfApp));
+    ASSERT_TRUE(app);
+    RecordMemory(app);
+    TerminateApp(app);
+  }
+
+  void Animation() {
+    Application* app = LaunchApp(base::FilePath().AppendASCII(kPerfApp));
+    ASSERT_TRUE(app);
+    Runtime* runtime = *app->runtimes().begin();
+    RunScript(runtime, base::StringPrintf("addBoxes(%d);", kAnimatedBoxes));
+    RecordFrameTimes(runtime, kFrames);
+    RecordMemory(app);
+    TerminateApp(app);
+  }
+
+  void ExtensionMessaging() {
+    Application* app = LaunchApp(base::FilePath().AppendASCII(kPerfApp));
+    ASSERT_TRUE(app);
+    RunScript(*app->runtimes().begin(),
+              base::StringPrintf("runEchoes(%d, %d);", kEchoes, kEchoSize));
+    RecordExtensionStats(app, kEchoExtensionName);
+    TerminateApp(app);
+  }
+
+  void BulkExtensionMessaging() {
+    Application* app = LaunchApp(base::FilePath().AppendASCII(kPerfApp));
+    ASSERT_TRUE(app);
+    RunScript(*app->runtimes().begin(),
+              base::StringPrintf("runEchoes(%d, %d);",
+                                 kBulkEchoes, kBulkEchoSize));
+    RecordExtensionStats(app, kEchoExtensionName);
+    RecordMemory(app);
+    TerminateApp(app);
+  }
+
+ private:
+  void CreateExtensions(XWalkExtensionVector* extensions) {
+    extensions->push_back(new EchoExtension);
+  }
+};
+
+IN_PROC_BROWSER_TEST_F(RuntimePerfTest, Startup) {
+  RunScenario(kPerfApp, base::Bind(&RuntimePerfTest::Startup,
+                                   base::Unretained(this)));
+}
+
+IN_PROC_BROWSER_TEST_F(RuntimePerfTest, Animation) {
+  RunScenario(kPerfApp, base::Bind(&RuntimePerfTest::Animation,
+                                   base::Unretained(this)));
+}
+
+IN_PROC_BROWSER_TEST_F(RuntimePerfTest, ExtensionMessaging) {
+  RunScenario(kPerfApp, base::Bind(&RuntimePerfTest::ExtensionMessaging,
+                                   base::Unretained(this)));
+}
+
+IN_PROC_BROWSER_TEST_F(RuntimePerfTest, BulkExtensionMessaging) {
+  RunScenario(kPerfApp, base::Bind(&RuntimePerfTest::BulkExtensionMessaging,
+                                   base::Unretained(this)));
+}
@@ -0,0 +1,324 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "xwalk/test/perf/xwalk_perf_test.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/process/process_handle.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread_restrictions.h"
+#include "base/time/time.h"
+#include "content/public/browser/browser_child_process_host_iterator.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/child_process_data.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/tracing_controller.h"
+#include "content/public/browser/web_contents.h"
+#include "content/public/common/process_type.h"
+#include "content/public/test/browser_test_utils.h"
+#include "content/public/test/test_utils.h"
+#include "testing/perf/perf_test.h"
+#include "xwalk/application/browser/application.h"
+#include "xwalk/application/browser/application_memory_monitor.h"
+#include "xwalk/application/browser/application_service.h"
+#include "xwalk/application/browser/application_system.h"
+#include "xwalk/extensions/browser/xwalk_extension_service.h"
+#include "xwalk/extensions/common/xwalk_extension_stats.h"
+#include "xwalk/runtime/browser/runtime.h"
+#include "xwalk/runtime/browser/xwalk_runner.h"
+#include "xwalk/test/base/xwalk_test_utils.h"
+
+using content::BrowserThread;
+using xwalk::Runtime;
+using xwalk::application::Application;
+using xwalk::application::ApplicationMemoryMonitor;
+using xwalk::application::ApplicationService;
+using xwalk::application::ProcessMemoryUsage;
+using xwalk::extensions::XWalkExtensionStats;
+
+namespace {
+
+const char kPerfWarmupRuns[] = "perf-warmup-runs";
+const char kPerfRuns[] = "perf-runs";
+const char kPerfTrace[] = "perf-trace";
+const char kPerfTraceCategories[] = "perf-trace-categories";
+
+const int kDefaultWarmupRuns = 1;
+const int kDefaultRuns = 5;
+const char kDefaultTraceCategories[] = "*";
+
+// Sends the durations of the next |frames| animation frames, in ms and
+// separated by spaces.
+const char kFrameTimesScript[] =
+    "(function(frames) {"
+    "  var times = [];"
+    "  var last = 0;"
+    "  function tick(now) {"
+    "    if (last)"
+    "      times.push(now - last);"
+    "    last = now;"
+    "    if (times.length < frames)"
+    "      window.requestAnimationFrame(tick);"
+    "    else"
+    "      window.domAutomationController.send(times.join(' '));"
+    "  }"
+    "  window.requestAnimationFrame(tick);"
+    "})(%d);";
+
+int GetRunsSwitch(const char* name, int default_value) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  int value;
+  if (!command_line.HasSwitch(name) ||
+      !base::StringToInt(command_line.GetSwitchValueASCII(name), &value) ||
+      value < 0)
+    return default_value;
+  return value;
+}
+
+// The proportional set size of |pid| in KB, -1 if it is unknown.
+int64 GetProportionalSetSizeKB(base::ProcessId pid) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  ProcessMemoryUsage usage;
+  if (!ApplicationMemoryMonitor::GetProcessMemoryUsage(pid, &usage))
+    return -1;
+  return usage.pss;
+}
+
+struct ChildProcess {
+  int type;
+  base::ProcessId pid;
+};
+
+// Must be called on the IO thread.
+void GetChildProcesses(std::vector<ChildProcess>* processes) {
+  for (content::BrowserChildProcessHostIterator it; !it.Done(); ++it) {
+    ChildProcess process;
+    process.type = it.GetData().process_type;
+    process.pid = base::GetProcId(it.GetData().handle);
+    processes->push_back(process);
+  }
+}
+
+std::string GetChildProcessName(int type) {
+  // The Extension Process is the only one of xwalk, see
+  // XWalkExtensionProcessHost.
+  if (type == content::PROCESS_TYPE_CONTENT_END)
+    return "extension_process";
+  if (type == content::PROCESS_TYPE_GPU)
+    return "gpu";
+  return "other";
+}
+
+void QuitOnTraceWritten(base::RunLoop* run_loop, const base::FilePath& path) {
+  run_loop->Quit();
+}
+
+}  // namespace
+
+XWalkPerfTest::XWalkPerfTest()
+    : warmup_runs_(GetRunsSwitch(kPerfWarmupRuns, kDefaultWarmupRuns)),
+      runs_(GetRunsSwitch(kPerfRuns, kDefaultRuns)),
+      recording_(false) {
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  trace_path_ = command_line.GetSwitchValuePath(kPerfTrace);
+  trace_categories_ = command_line.HasSwitch(kPerfTraceCategories) ?
+      command_line.GetSwitchValueASCII(kPerfTraceCategories) :
+      std::string(kDefaultTraceCategories);
+}
+
+XWalkPerfTest::~XWalkPerfTest() {
+}
+
+void XWalkPerfTest::RunScenario(const std::string& trace,
+                                const Scenario& scenario) {
+  measurements_.clear();
+
+  recording_ = false;
+  for (int i = 0; i < warmup_runs_ && !testing::Test::HasFatalFailure(); ++i)
+    scenario.Run();
+
+  if (!trace_path_.empty())
+    StartTracing();
+  recording_ = true;
+  for (int i = 0; i < runs_ && !testing::Test::HasFatalFailure(); ++i)
+    scenario.Run();
+  recording_ = false;
+  if (!trace_path_.empty())
+    StopTracing();
+
+  if (!testing::Test::HasFatalFailure())
+    PrintResults(trace);
+}
+
+void XWalkPerfTest::RecordValue(const std::string& measurement,
+                                const std::string& units,
+                                double value) {
+  if (!recording_)
+    return;
+  Measurement& entry = measurements_[measurement];
+  DCHECK(entry.units.empty() || entry.units == units);
+  entry.units = units;
+  entry.values.push_back(value);
+}
+
+Application* XWalkPerfTest::LaunchApp(const base::FilePath& path) {
+  const base::TimeTicks start = base::TimeTicks::Now();
+  Application* app = application_service()->Launch(
+      xwalk_test_utils::GetTestFilePath(path, base::FilePath()));
+  if (!app || app->runtimes().empty()) {
+    ADD_FAILURE() << "Failed to launch " << path.AsUTF8Unsafe();
+    return NULL;
+  }
+
+  Runtime* main_runtime = *app->runtimes().begin();
+  content::WaitForLoadStop(main_runtime->web_contents());
+  RecordValue("startup_time", "ms",
+              (base::TimeTicks::Now() - start).InMillisecondsF());
+  return app;
+}
+
+void XWalkPerfTest::TerminateApp(Application* app) {
+  app->Terminate();
+  content::RunAllPendingInMessageLoop();
+}
+
+std::string XWalkPerfTest::RunScript(Runtime* runtime,
+                                     const std::string& script) {
+  std::string result;
+  EXPECT_TRUE(content::ExecuteScriptAndExtractString(
+      runtime->web_contents(), script, &result)) << script;
+  return result;
+}
+
+void XWalkPerfTest::RecordFrameTimes(Runtime* runtime, int frames) {
+  const std::string result = RunScript(
+      runtime, base::StringPrintf(kFrameTimesScript, frames));
+
+  std::vector<std::string> values;
+  base::SplitString(result, ' ', &values);
+  double total = 0;
+  double max = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    double frame_time;
+    if (!base::StringToDouble(values[i], &frame_time)) {
+      ADD_FAILURE() << "Bad frame times: " << result;
+      return;
+    }
+    total += frame_time;
+    max = std::max(max, frame_time);
+  }
+  if (values.empty())
+    return;
+  RecordValue("frame_time", "ms", total / values.size());
+  RecordValue("frame_time_max", "ms", max);
+}
+
+void XWalkPerfTest::RecordMemory(Application* app) {
+#if defined(OS_LINUX)
+  RecordValue("pss_browser", "KB",
+              GetProportionalSetSizeKB(base::GetCurrentProcId()));
+
+  content::RenderProcessHost* rph = app->render_process_host();
+  if (rph && rph->GetHandle()) {
+    RecordValue("pss_renderer", "KB",
+                GetProportionalSetSizeKB(base::GetProcId(rph->GetHandle())));
+  }
+
+  std::vector<ChildProcess> processes;
+  base::RunLoop run_loop;
+  BrowserThread::PostTaskAndReply(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&GetChildProcesses, &processes),
+      run_loop.QuitClosure());
+  run_loop.Run();
+
+  // Processes of the same type, e.g. the Extension Processes of several
+  // applications, are added up.
+  std::map<std::string, int64> pss_by_name;
+  for (size_t i = 0; i < processes.size(); ++i) {
+    const int64 pss = GetProportionalSetSizeKB(processes[i].pid);
+    if (pss >= 0)
+      pss_by_name[GetChildProcessName(processes[i].type)] += pss;
+  }
+  for (std::map<std::string, int64>::const_iterator it = pss_by_name.begin();
+       it != pss_by_name.end(); ++it)
+    RecordValue("pss_" + it->first, "KB", it->second);
+#else
+  LOG(WARNING) << "The memory usage is only measured on Linux.";
+#endif
+}
+
+void XWalkPerfTest::RecordExtensionStats(Application* app,
+                                         const std::string& extension_name) {
+  XWalkExtensionStats::Counters counters;
+  if (!xwalk::XWalkRunner::GetInstance()->extension_service()->
+          GetInProcessExtensionStats(app->GetRenderProcessHostID(),
+                                     extension_name, &counters)) {
+    ADD_FAILURE() << "No stats for the extension " << extension_name;
+    return;
+  }
+
+  RecordValue("extension_messages_to_native", "count",
+              counters.messages_to_native);
+  RecordValue("extension_messages_to_js", "count", counters.messages_to_js);
+  RecordValue("extension_bytes_to_native", "bytes", counters.bytes_to_native);
+  RecordValue("extension_bytes_to_js", "bytes", counters.bytes_to_js);
+  RecordValue("extension_sync_calls", "count", counters.sync_calls);
+  RecordValue("extension_sync_blocking_time", "ms",
+              counters.sync_blocking_time.InMillisecondsF());
+}
+
+ApplicationService* XWalkPerfTest::application_service() const {
+  return xwalk::XWalkRunner::GetInstance()->app_system()
+      ->application_service();
+}
+
+void XWalkPerfTest::StartTracing() {
+  base::RunLoop run_loop;
+  content::TracingController::GetInstance()->EnableRecording(
+      trace_categories_, content::TracingController::DEFAULT_OPTIONS,
+      run_loop.QuitClosure());
+  run_loop.Run();
+}
+
+void XWalkPerfTest::StopTracing() {
+  base::RunLoop run_loop;
+  if (!content::TracingController::GetInstance()->DisableRecording(
+          trace_path_, base::Bind(&QuitOnTraceWritten, &run_loop))) {
+    LOG(WARNING) << "Failed to write the trace to "
+                 << trace_path_.AsUTF8Unsafe();
+    return;
+  }
+  run_loop.Run();
+}
+
+void XWalkPerfTest::PrintResults(const std::string& trace) {
+  for (MeasurementMap::const_iterator it = measurements_.begin();
+       it != measurements_.end(); ++it) {
+    const std::vector<double>& values = it->second.values;
+    if (values.empty())
+      continue;
+
+    double mean = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+      mean += values[i];
+    mean /= values.size();
+    double variance = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+      variance += (values[i] - mean) * (values[i] - mean);
+    variance /= values.size();
+
+    perf_test::PrintResultMeanAndError(
+        it->first, std::string(), trace,
+        base::StringPrintf("%.2f,%.2f", mean, std::sqrt(variance)),
+        it->second.units, true);
+  }
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2014 Intel Corporation. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef XWALK_TEST_PERF_XWALK_PERF_TEST_H_
+#define XWALK_TEST_PERF_XWALK_PERF_TEST_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "xwalk/test/base/in_process_browser_test.h"
+
+namespace xwalk {
+class Runtime;
+namespace application {
+class Application;
+class ApplicationService;
+}
+}
+
+// Base class for the tests of xwalk_perftests. A test runs its scenarios
+// through RunScenario(), which repeats them and prints the mean and the
+// standard deviation of every value recorded in the format of the perf
+// dashboard, e.g.
+// RESULT startup_time: dummy_app= {152.3,4.1} ms
+//
+// The repetitions are controlled from the command line:
+//   --perf-warmup-runs=N  runs not recorded, to warm the caches (default 1).
+//   --perf-runs=N         recorded runs (default 5).
+//   --perf-trace=<file>   records a trace of the recorded runs, to be opened
+//                         with chrome://tracing.
+//   --perf-trace-categories=<filter>  the categories traced (default "*").
+class XWalkPerfTest : public InProcessBrowserTest {
+ public:
+  typedef base::Callback<void(void)> Scenario;
+
+  XWalkPerfTest();
+  virtual ~XWalkPerfTest();
+
+ protected:
+  // Runs the warm-up runs then the recorded runs of |scenario|, which
+  // records its values with the helpers below. The results are printed for
+  // |trace|. Stops at the first fatal failure.
+  void RunScenario(const std::string& trace, const Scenario& scenario);
+
+  // Dropped during the warm-up runs.
+  void RecordValue(const std::string& measurement, const std::string& units,
+                   double value);
+
+  // Launches the unpacked application of |path|, relative to test/data, and
+  // waits for its main document to be loaded. Records the time it took as
+  // "startup_time". Returns NULL on failure.
+  xwalk::application::Application* LaunchApp(const base::FilePath& path);
+  // Terminates |app| and waits for its render process to go away, so the
+  // next run starts from the same state.
+  void TerminateApp(xwalk::application::Application* app);
+
+  // Runs |script| in |runtime| and returns the string it sent with
+  // domAutomationController.send(). This is how the applications of
+  // test/data/perf expose their scenarios.
+  std::string RunScript(xwalk::Runtime* runtime, const std::string& script);
+
+  // Waits for |frames| animation frames of |runtime| and records their
+  // mean and maximum durations as "frame_time" and "frame_time_max".
+  void RecordFrameTimes(xwalk::Runtime* runtime, int frames);
+
+  // Records the proportional set size of the browser process, of the
+  // render process of |app| and of the other child processes (Extension
+  // Process, GPU process) as "pss_<process>", in KB. Only supported on
+  // Linux.
+  void RecordMemory(xwalk::application::Application* app);
+
+  // Records the counters of |extension_name| kept by the in process servers
+  // of the render process of |app|, see XWalkExtensionStats.
+  void RecordExtensionStats(xwalk::application::Application* app,
+                            const std::string& extension_name);
+
+  xwalk::application::ApplicationService* application_service() const;
+
+ private:
+  struct Measurement {
+    std::string units;
+    std::vector<double> values;
+  };
+  typedef std::map<std::string, Measurement> MeasurementMap;
+
+  void StartTracing();
+  void StopTracing();
+  void PrintResults(const std::string& trace);
+
+  int warmup_runs_;
+  int runs_;
+  base::FilePath trace_path_;
+  std::string trace_categories_;
+
+  bool recording_;
+  MeasurementMap measurements_;
+};
+
+#endif  // XWALK_TEST_PERF_XWALK_PERF_TEST_H_
@@ -4,63 +4,163 @@
 
 #include "xwalk/tizen/browser/audio_session_manager.h"
 
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/sequenced_task_runner.h"
+#include "base/threading/sequenced_worker_pool.h"
+#include "base/time/time.h"
+#include "content/public/browser/browser_thread.h"
 #include "xwalk/tizen/browser/browser_mediaplayer_manager.h"
 
+using content::BrowserThread;
+
 namespace tizen {
 
 AudioSessionManager::AudioSessionManager(
-    BrowserMediaPlayerManager* manager,
-    MediaPlayerID player_id,
+    const base::WeakPtr<BrowserMediaPlayerManager>& manager,
     int process_id)
-    : event_type_(ASM_EVENT_NONE),
-      manager_(manager),
-      handle_(-1),
+    : manager_(manager),
       process_id_(process_id),
-      player_id_(player_id) {
+      playing_(false),
+      handle_(-1),
+      registered_(false) {
+  base::SequencedWorkerPool* pool = BrowserThread::GetBlockingPool();
+  task_runner_ = pool->GetSequencedTaskRunnerWithShutdownBehavior(
+      pool->GetSequenceToken(),
+      base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
 }
 
 AudioSessionManager::~AudioSessionManager() {
-  UnregisterAudioSessionManager();
 }
 
-bool AudioSessionManager::RegisterAudioSessionManager(
-    ASM_sound_events_t event_type,
-    ASM_sound_cb_t notify_callback,
-    void* callback_data) {
-  int error = 0;
-  event_type_ = event_type;
+void AudioSessionManager::Register() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  task_runner_->PostTask(
+      FROM_HERE, base::Bind(&AudioSessionManager::RegisterOnWorker, this));
+}
+
+void AudioSessionManager::Unregister() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  playing_players_.clear();
+  UpdateSoundState();
+  task_runner_->PostTask(
+      FROM_HERE, base::Bind(&AudioSessionManager::UnregisterOnWorker, this));
+}
+
+void AudioSessionManager::SetPlayerPlaying(MediaPlayerID player_id,
+                                           bool playing) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (playing)
+    playing_players_.insert(player_id);
+  else
+    playing_players_.erase(player_id);
+  UpdateSoundState();
+}
+
+void AudioSessionManager::RemovePlayer(MediaPlayerID player_id) {
+  SetPlayerPlaying(player_id, false);
+}
+
+void AudioSessionManager::UpdateSoundState() {
+  bool playing = !playing_players_.empty();
+  if (playing == playing_)
+    return;
 
-  if (!ASM_register_sound(process_id_, &handle_,
-      event_type_, ASM_STATE_NONE,
-      notify_callback, callback_data,
-      ASM_RESOURCE_NONE, &error)) {
+  playing_ = playing;
+  task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&AudioSessionManager::SetSoundStateOnWorker, this,
+                 playing ? ASM_STATE_PLAYING : ASM_STATE_PAUSE));
+}
+
+void AudioSessionManager::RegisterOnWorker() {
+  int error = 0;
+  base::TimeTicks start = base::TimeTicks::Now();
+  registered_ = ASM_register_sound(process_id_, &handle_,
+      ASM_EVENT_SHARE_MMPLAYER, ASM_STATE_NONE,
+      &AudioSessionManager::OnSoundEvent, this,
+      ASM_RESOURCE_NONE, &error);
+  UMA_HISTOGRAM_TIMES("XWalk.AudioSession.RegisterTime",
+                      base::TimeTicks::Now() - start);
+  if (!registered_) {
     LOG(ERROR) << "Register audio session manager failed. errcode=" << error;
-    return false;
+    return;
   }
 
-  return true;
+  SetSoundStateOnWorker(ASM_STATE_PAUSE);
 }
 
-bool AudioSessionManager::UnregisterAudioSessionManager() {
+void AudioSessionManager::UnregisterOnWorker() {
+  if (!registered_)
+    return;
+
   int error = 0;
-  if (!ASM_unregister_sound(handle_, event_type_, &error)) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  bool ok = ASM_unregister_sound(handle_, ASM_EVENT_SHARE_MMPLAYER, &error);
+  UMA_HISTOGRAM_TIMES("XWalk.AudioSession.UnregisterTime",
+                      base::TimeTicks::Now() - start);
+  if (!ok)
     LOG(ERROR) << "Unregister audio session manager failed. errcode=" << error;
-    return false;
-  }
-
-  return true;
+  registered_ = false;
 }
 
-bool AudioSessionManager::SetSoundState(ASM_sound_states_t state) {
+void AudioSessionManager::SetSoundStateOnWorker(ASM_sound_states_t state) {
+  if (!registered_)
+    return;
+
   int error = 0;
-  if (!ASM_set_sound_state(handle_, event_type_, state,
-      ASM_RESOURCE_NONE, &error)) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  bool ok = ASM_set_sound_state(handle_, ASM_EVENT_SHARE_MMPLAYER, state,
+                                ASM_RESOURCE_NONE, &error);
+  UMA_HISTOGRAM_TIMES("XWalk.AudioSession.SetSoundStateTime",
+                      base::TimeTicks::Now() - start);
+  if (!ok)
     LOG(ERROR) << "Set sound state =" << state << "failed. errcode=" << error;
-    return false;
+}
+
+// static
+ASM_cb_result_t AudioSessionManager::OnSoundEvent(
+    int handle,
+    ASM_event_sources_t event_source,
+    ASM_sound_commands_t command,
+    unsigned int sound_status,
+    void* callback_data) {
+  AudioSessionManager* session =
+      static_cast<AudioSessionManager*>(callback_data);
+
+  if (command == ASM_COMMAND_STOP || command == ASM_COMMAND_PAUSE) {
+    switch (event_source) {
+      case ASM_EVENT_SOURCE_CALL_START:
+      case ASM_EVENT_SOURCE_ALARM_START:
+      case ASM_EVENT_SOURCE_MEDIA:
+      case ASM_EVENT_SOURCE_EMERGENCY_START:
+      case ASM_EVENT_SOURCE_OTHER_PLAYER_APP:
+      case ASM_EVENT_SOURCE_RESOURCE_CONFLICT:
+        BrowserThread::PostTask(
+            BrowserThread::UI, FROM_HERE,
+            base::Bind(&BrowserMediaPlayerManager::OnAudioSessionInterrupted,
+                       session->manager_));
+        return ASM_CB_RES_PAUSE;
+      default:
+        return ASM_CB_RES_NONE;
+    }
+  }
+
+  if (command == ASM_COMMAND_PLAY || command == ASM_COMMAND_RESUME) {
+    switch (event_source) {
+      case ASM_EVENT_SOURCE_ALARM_END:
+        BrowserThread::PostTask(
+            BrowserThread::UI, FROM_HERE,
+            base::Bind(&BrowserMediaPlayerManager::OnAudioSessionResumed,
+                       session->manager_));
+        return ASM_CB_RES_PLAYING;
+      default:
+        return ASM_CB_RES_NONE;
+    }
   }
 
-  return true;
+  return ASM_CB_RES_NONE;
 }
 
 }  // namespace tizen
@@ -6,42 +6,80 @@
 #define XWALK_TIZEN_BROWSER_AUDIO_SESSION_MANAGER_H_
 
 #include <audio-session-manager.h>
+
+#include <set>
+
 #include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
 
 namespace tizen {
 class BrowserMediaPlayerManager;
 
 typedef int MediaPlayerID;
 
-// This class manages communication between MediaPlayer and Audio
-// Session Manager. It also defines Media Session policy and update
-// the sound state to ASM server.
-class AudioSessionManager {
+// This class manages communication between the media players of a render
+// view and Audio Session Manager. All the players share one session, which
+// is registered once and whose sound state only changes when the first
+// player starts or the last one stops playing, so pages playing many short
+// sounds don't call the ASM server for each of them. It also defines Media
+// Session policy.
+//
+// The ASM calls can block on the server: they are made in order on a
+// worker thread and their latency is recorded in the XWalk.AudioSession.*
+// histograms. Everything else happens on the UI thread.
+class AudioSessionManager
+    : public base::RefCountedThreadSafe<AudioSessionManager> {
  public:
   AudioSessionManager(
-      BrowserMediaPlayerManager* manager,
-      MediaPlayerID player_id,
+      const base::WeakPtr<BrowserMediaPlayerManager>& manager,
       int process_id);
-  ~AudioSessionManager();
 
   //  Register to ASM server
-  bool RegisterAudioSessionManager(ASM_sound_events_t, ASM_sound_cb_t, void*);
+  void Register();
   //  Unregister to ASM server
-  bool UnregisterAudioSessionManager();
+  void Unregister();
 
-  bool SetSoundState(ASM_sound_states_t);
-  MediaPlayerID player_id() const { return player_id_; }
+  // Reference counts the playing players.
+  void SetPlayerPlaying(MediaPlayerID player_id, bool playing);
+  void RemovePlayer(MediaPlayerID player_id);
 
-  BrowserMediaPlayerManager* media_player_manager() {
-    return manager_;
+  const std::set<MediaPlayerID>& playing_players() const {
+    return playing_players_;
   }
 
  private:
-  ASM_sound_events_t event_type_;
-  BrowserMediaPlayerManager*  manager_;
-  int handle_;
+  friend class base::RefCountedThreadSafe<AudioSessionManager>;
+  ~AudioSessionManager();
+
+  void UpdateSoundState();
+
+  // Run on |task_runner_|.
+  void RegisterOnWorker();
+  void UnregisterOnWorker();
+  void SetSoundStateOnWorker(ASM_sound_states_t state);
+
+  // Run by the ASM library on its own thread.
+  static ASM_cb_result_t OnSoundEvent(int handle,
+                                      ASM_event_sources_t event_source,
+                                      ASM_sound_commands_t command,
+                                      unsigned int sound_status,
+                                      void* callback_data);
+
+  base::WeakPtr<BrowserMediaPlayerManager> manager_;
   int process_id_;
-  MediaPlayerID player_id_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+
+  std::set<MediaPlayerID> playing_players_;
+  bool playing_;
+
+  // Accessed on |task_runner_|.
+  int handle_;
+  bool registered_;
 
   DISALLOW_COPY_AND_ASSIGN(AudioSessionManager);
 };
@@ -5,6 +5,9 @@
 
 #include "xwalk/tizen/browser/browser_mediaplayer_manager.h"
 
+#include <algorithm>
+
+#include "base/metrics/histogram.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/web_contents.h"
 #include "xwalk/tizen/browser/audio_session_manager_init.h"
@@ -15,10 +18,13 @@ namespace tizen {
 BrowserMediaPlayerManager::BrowserMediaPlayerManager(
     content::RenderViewHost* render_view_host)
     : WebContentsObserver(content::WebContents::FromRenderViewHost(
-          render_view_host)) {
+          render_view_host)),
+      weak_ptr_factory_(this) {
 }
 
-BrowserMediaPlayerManager::~BrowserMediaPlayerManager() {}
+BrowserMediaPlayerManager::~BrowserMediaPlayerManager() {
+  OnDestroyAllMediaPlayers();
+}
 
 BrowserMediaPlayerManager* BrowserMediaPlayerManager::Create(
     content::RenderViewHost* render_view_host) {
@@ -31,6 +37,8 @@ bool BrowserMediaPlayerManager::OnMessageReceived(const IPC::Message& msg) {
     IPC_MESSAGE_HANDLER(MediaPlayerHostMsg_MediaPlayerInitialize, OnInitialize)
     IPC_MESSAGE_HANDLER(MediaPlayerHostMsg_MediaPlayerStarted, OnStart)
     IPC_MESSAGE_HANDLER(MediaPlayerHostMsg_MediaPlayerPaused, OnPause)
+    IPC_MESSAGE_HANDLER(MediaPlayerHostMsg_MediaPlayerStatistics,
+                        OnStatistics)
     IPC_MESSAGE_HANDLER(MediaPlayerHostMsg_DestroyMediaPlayer, OnDestroyPlayer)
     IPC_MESSAGE_HANDLER(MediaPlayerHostMsg_DestroyAllMediaPlayers,
                         OnDestroyAllMediaPlayers)
@@ -42,61 +50,26 @@ bool BrowserMediaPlayerManager::OnMessageReceived(const IPC::Message& msg) {
 
 AudioSessionManager* BrowserMediaPlayerManager::GetAudioSessionManager(
     MediaPlayerID player_id) {
-  for (ScopedVector<AudioSessionManager>::iterator it =
-      audio_session_managers_.begin(); it != audio_session_managers_.end();
-      ++it) {
-    if ((*it)->player_id() == player_id)
-      return *it;
-  }
-
-  return NULL;
+  // The players of the view share a single session.
+  return audio_session_.get();
 }
 
-ASM_cb_result_t BrowserMediaPlayerManager::AudioSessionEventPause(
-    ASM_event_sources_t event_source,
-    MediaPlayerID player_id) {
-  switch (event_source) {
-    case ASM_EVENT_SOURCE_CALL_START:
-    case ASM_EVENT_SOURCE_ALARM_START:
-    case ASM_EVENT_SOURCE_MEDIA:
-    case ASM_EVENT_SOURCE_EMERGENCY_START:
-    case ASM_EVENT_SOURCE_OTHER_PLAYER_APP:
-    case ASM_EVENT_SOURCE_RESOURCE_CONFLICT:
-      Send(new MediaPlayerMsg_MediaPlayerPause(routing_id(), player_id));
-      return ASM_CB_RES_PAUSE;
-    default:
-      return ASM_CB_RES_NONE;
-    }
-}
+void BrowserMediaPlayerManager::OnAudioSessionInterrupted() {
+  if (!audio_session_)
+    return;
 
-ASM_cb_result_t BrowserMediaPlayerManager::AudioSessionEventPlay(
-    ASM_event_sources_t event_source,
-    MediaPlayerID player_id) {
-  switch (event_source) {
-    case ASM_EVENT_SOURCE_ALARM_END:
-      Send(new MediaPlayerMsg_MediaPlayerPlay(routing_id(), player_id));
-      return ASM_CB_RES_PLAYING;
-    default:
-      return ASM_CB_RES_NONE;
-  }
+  const std::set<MediaPlayerID>& players = audio_session_->playing_players();
+  for (std::set<MediaPlayerID>::const_iterator it = players.begin();
+       it != players.end(); ++it)
+    Send(new MediaPlayerMsg_MediaPlayerPause(routing_id(), *it));
+  interrupted_players_.insert(players.begin(), players.end());
 }
 
-static ASM_cb_result_t AudioSessionNotifyCallback(
-    int handle,
-    ASM_event_sources_t event_source,
-    ASM_sound_commands_t command,
-    unsigned int sound_status,
-    void* callback_data) {
-  AudioSessionManager* data =
-      static_cast<AudioSessionManager*>(callback_data);
-
-  BrowserMediaPlayerManager* manager = data->media_player_manager();
-  if (command == ASM_COMMAND_STOP || command == ASM_COMMAND_PAUSE)
-    return manager->AudioSessionEventPause(event_source, data->player_id());
-  if (command == ASM_COMMAND_PLAY || command == ASM_COMMAND_RESUME)
-    return manager->AudioSessionEventPlay(event_source, data->player_id());
-
-  return ASM_CB_RES_NONE;
+void BrowserMediaPlayerManager::OnAudioSessionResumed() {
+  for (std::set<MediaPlayerID>::const_iterator it =
+       interrupted_players_.begin(); it != interrupted_players_.end(); ++it)
+    Send(new MediaPlayerMsg_MediaPlayerPlay(routing_id(), *it));
+  interrupted_players_.clear();
 }
 
 void BrowserMediaPlayerManager::OnInitialize(
@@ -110,55 +83,53 @@ void BrowserMediaPlayerManager::OnInitialize(
     return;
   }
 
-  RemoveAudioSessionManager(player_id);
-  AudioSessionManager* session_manager =
-      new AudioSessionManager(this, player_id, process_id);
-
-  session_manager->RegisterAudioSessionManager(
-      ASM_EVENT_SHARE_MMPLAYER,
-      AudioSessionNotifyCallback,
-      session_manager);
-  session_manager->SetSoundState(ASM_STATE_PAUSE);
-
-  AddAudioSessionManager(session_manager);
+  // The players of the view share the session of the first one.
+  if (!audio_session_) {
+    audio_session_ = new AudioSessionManager(weak_ptr_factory_.GetWeakPtr(),
+                                             process_id);
+    audio_session_->Register();
+  }
+  audio_session_->RemovePlayer(player_id);
+  interrupted_players_.erase(player_id);
 }
 
 void BrowserMediaPlayerManager::OnDestroyAllMediaPlayers() {
-  audio_session_managers_.clear();
+  interrupted_players_.clear();
+  if (!audio_session_)
+    return;
+  audio_session_->Unregister();
+  audio_session_ = NULL;
 }
 
 void BrowserMediaPlayerManager::OnDestroyPlayer(MediaPlayerID player_id) {
-  RemoveAudioSessionManager(player_id);
+  interrupted_players_.erase(player_id);
+  if (audio_session_)
+    audio_session_->RemovePlayer(player_id);
 }
 
 void BrowserMediaPlayerManager::OnPause(MediaPlayerID player_id) {
-  AudioSessionManager* session_manager = GetAudioSessionManager(player_id);
-  if (session_manager)
-    session_manager->SetSoundState(ASM_STATE_PAUSE);
+  if (audio_session_)
+    audio_session_->SetPlayerPlaying(player_id, false);
 }
 
 void BrowserMediaPlayerManager::OnStart(MediaPlayerID player_id) {
-  AudioSessionManager* session_manager = GetAudioSessionManager(player_id);
-  if (session_manager)
-    session_manager->SetSoundState(ASM_STATE_PLAYING);
+  interrupted_players_.erase(player_id);
+  if (audio_session_)
+    audio_session_->SetPlayerPlaying(player_id, true);
 }
 
-void BrowserMediaPlayerManager::AddAudioSessionManager(
-    AudioSessionManager* session_manager) {
-  DCHECK(!GetAudioSessionManager(session_manager->player_id()));
-  audio_session_managers_.push_back(session_manager);
-}
+void BrowserMediaPlayerManager::OnStatistics(MediaPlayerID player_id,
+                                             unsigned decoded_frames,
+                                             unsigned dropped_frames) {
+  if (!decoded_frames)
+    return;
 
-void BrowserMediaPlayerManager::RemoveAudioSessionManager(
-    MediaPlayerID player_id) {
-  for (ScopedVector<AudioSessionManager>::iterator it =
-      audio_session_managers_.begin(); it != audio_session_managers_.end();
-      ++it) {
-    if ((*it)->player_id() == player_id) {
-      audio_session_managers_.erase(it);
-      break;
-    }
-  }
+  UMA_HISTOGRAM_COUNTS("XWalk.MediaPlayer.DecodedFrames", decoded_frames);
+  // Both counts come from the renderer, the product would overflow 32 bits.
+  const int64 percent =
+      static_cast<int64>(dropped_frames) * 100 / decoded_frames;
+  UMA_HISTOGRAM_PERCENTAGE("XWalk.MediaPlayer.DroppedFramesPercent",
+                           static_cast<int>(std::min<int64>(100, percent)));
 }
 
 }  // namespace tizen
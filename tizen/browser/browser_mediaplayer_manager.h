@@ -6,19 +6,21 @@
 #ifndef XWALK_TIZEN_BROWSER_BROWSER_MEDIAPLAYER_MANAGER_H_
 #define XWALK_TIZEN_BROWSER_BROWSER_MEDIAPLAYER_MANAGER_H_
 
-#include "base/memory/scoped_ptr.h"
-#include "base/memory/scoped_vector.h"
+#include <set>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "url/gurl.h"
 #include "xwalk/tizen/browser/audio_session_manager.h"
 
 namespace tizen {
 
-// This class manages all AudioSessionManager objects in the browser
-// process. It receives control operations from the render process, and
-// forwards them to corresponding AudioSessionManager object. Callbacks
-// from AudioSessionManager objects are converted to IPCs and then sent
-// to the render process.
+// This class manages the audio session of the media players of a render
+// view in the browser process. It receives control operations from the
+// render process, and forwards them to the AudioSessionManager shared by
+// the players. Callbacks from the AudioSessionManager are converted to
+// IPCs and then sent to the render process.
 class CONTENT_EXPORT BrowserMediaPlayerManager
     : public content::WebContentsObserver {
  public:
@@ -33,10 +35,11 @@ class CONTENT_EXPORT BrowserMediaPlayerManager
   virtual AudioSessionManager* GetAudioSessionManager(
       MediaPlayerID player_id) OVERRIDE;
 
-  ASM_cb_result_t AudioSessionEventPause(
-      ASM_event_sources_t eventSource, MediaPlayerID player_id);
-  ASM_cb_result_t AudioSessionEventPlay(
-      ASM_event_sources_t eventSource, MediaPlayerID player_id);
+  // The sound server paused the session, the playing players are paused.
+  void OnAudioSessionInterrupted();
+  // The sound server resumed the session, the players paused by it play
+  // again.
+  void OnAudioSessionResumed();
 
  protected:
   explicit BrowserMediaPlayerManager(content::RenderViewHost* render_view_host);
@@ -48,14 +51,14 @@ class CONTENT_EXPORT BrowserMediaPlayerManager
   virtual void OnDestroyPlayer(MediaPlayerID player_id);
   virtual void OnPause(MediaPlayerID player_id);
   virtual void OnStart(MediaPlayerID player_id);
+  virtual void OnStatistics(MediaPlayerID player_id,
+                            unsigned decoded_frames,
+                            unsigned dropped_frames);
 
-  // Adds a audio session manager for the given player to the list.
-  void AddAudioSessionManager(AudioSessionManager* session_manager);
-
-  // Removes the audio session manager of given |player_id|.
-  void RemoveAudioSessionManager(MediaPlayerID player_id);
+  scoped_refptr<AudioSessionManager> audio_session_;
+  std::set<MediaPlayerID> interrupted_players_;
 
-  ScopedVector<AudioSessionManager> audio_session_managers_;
+  base::WeakPtrFactory<BrowserMediaPlayerManager> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(BrowserMediaPlayerManager);
 };
@@ -48,3 +48,9 @@ IPC_MESSAGE_ROUTED1(MediaPlayerHostMsg_MediaPlayerPaused,  // NOLINT(*)
 // The player started playing.
 IPC_MESSAGE_ROUTED1(MediaPlayerHostMsg_MediaPlayerStarted,  // NOLINT(*)
                     int /* player_id */)
+
+// The video frames decoded and dropped by the player since the last report.
+IPC_MESSAGE_ROUTED3(MediaPlayerHostMsg_MediaPlayerStatistics,  // NOLINT(*)
+                    int /* player_id */,
+                    unsigned /* decoded_frames */,
+                    unsigned /* dropped_frames */)
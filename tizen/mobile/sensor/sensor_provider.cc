@@ -21,6 +21,12 @@ SensorProvider* SensorProvider::GetInstance() {
   return instance_.get();
 }
 
+SensorProvider::Request::Request()
+    : linear_acceleration(false),
+      orientation(false),
+      interval_ms(0) {
+}
+
 SensorProvider::SensorProvider()
     : last_orientation_(blink::WebScreenOrientationUndefined) {
 }
@@ -30,44 +36,77 @@ SensorProvider::~SensorProvider() {
 }
 
 void SensorProvider::AddObserver(Observer* observer) {
-  observers_.insert(observer);
+  if (observers_.find(observer) == observers_.end())
+    observers_[observer] = Request();
 }
 
 void SensorProvider::RemoveObserver(Observer* observer) {
-  observers_.erase(observer);
+  if (observers_.erase(observer))
+    UpdateRequest();
+}
+
+void SensorProvider::SetRequest(Observer* observer, const Request& request) {
+  ObserverMap::iterator it = observers_.find(observer);
+  DCHECK(it != observers_.end());
+  it->second = request;
+  UpdateRequest();
+}
+
+void SensorProvider::UpdateRequest() {
+  Request request;
+  for (ObserverMap::iterator it = observers_.begin();
+       it != observers_.end(); ++it) {
+    const Request& observer_request = it->second;
+    request.linear_acceleration |= observer_request.linear_acceleration;
+    request.orientation |= observer_request.orientation;
+    if (observer_request.interval_ms > 0 &&
+        (!request.interval_ms ||
+         observer_request.interval_ms < request.interval_ms))
+      request.interval_ms = observer_request.interval_ms;
+  }
+
+  if (request.linear_acceleration == request_.linear_acceleration &&
+      request.orientation == request_.orientation &&
+      request.interval_ms == request_.interval_ms)
+    return;
+  request_ = request;
+  OnRequestChanged();
 }
 
 void SensorProvider::OnScreenOrientationChanged(
     blink::WebScreenOrientationType orientation) {
   last_orientation_ = orientation;
 
-  std::set<Observer*>::iterator it;
+  ObserverMap::iterator it;
   for (it = observers_.begin(); it != observers_.end(); ++it)
-    (*it)->OnScreenOrientationChanged(orientation);
+    it->first->OnScreenOrientationChanged(orientation);
 }
 
 void SensorProvider::OnOrientationChanged(float alpha,
                                           float beta,
                                           float gamma) {
-  std::set<Observer*>::iterator it;
+  ObserverMap::iterator it;
   for (it = observers_.begin(); it != observers_.end(); ++it)
-    (*it)->OnOrientationChanged(alpha, beta, gamma);
+    it->first->OnOrientationChanged(alpha, beta, gamma);
 }
 
 void SensorProvider::OnAccelerationChanged(
+    int64 timestamp_us,
     float raw_x, float raw_y, float raw_z,
     float x, float y, float z) {
-  std::set<Observer*>::iterator it;
+  ObserverMap::iterator it;
   for (it = observers_.begin(); it != observers_.end(); ++it)
-    (*it)->OnAccelerationChanged(raw_x, raw_y, raw_z, x, y, z);
+    it->first->OnAccelerationChanged(timestamp_us,
+                                     raw_x, raw_y, raw_z, x, y, z);
 }
 
-void SensorProvider::OnRotationRateChanged(float alpha,
+void SensorProvider::OnRotationRateChanged(int64 timestamp_us,
+                                           float alpha,
                                            float beta,
                                            float gamma) {
-  std::set<Observer*>::iterator it;
+  ObserverMap::iterator it;
   for (it = observers_.begin(); it != observers_.end(); ++it)
-    (*it)->OnRotationRateChanged(alpha, beta, gamma);
+    it->first->OnRotationRateChanged(timestamp_us, alpha, beta, gamma);
 }
 
 scoped_ptr<SensorProvider> SensorProvider::instance_;
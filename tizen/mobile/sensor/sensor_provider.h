@@ -5,8 +5,9 @@
 #ifndef XWALK_TIZEN_MOBILE_SENSOR_SENSOR_PROVIDER_H_
 #define XWALK_TIZEN_MOBILE_SENSOR_SENSOR_PROVIDER_H_
 
-#include <set>
+#include <map>
 
+#include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
 #include "ui/gfx/display.h"
 #include "third_party/WebKit/public/platform/WebScreenOrientationType.h"
@@ -26,13 +27,34 @@ class SensorProvider {
         blink::WebScreenOrientationType orientation) {}
 
     virtual void OnOrientationChanged(float alpha, float beta, float gamma) {}
-    virtual void OnAccelerationChanged(float raw_x, float raw_y, float raw_z,
+
+    // Every sample reported by the platform is delivered in order, with its
+    // timestamp in microseconds. The acceleration without gravity is NaN
+    // unless asked for, and only set on the last sample of a batch.
+    virtual void OnAccelerationChanged(int64 timestamp_us,
+                                       float raw_x, float raw_y, float raw_z,
                                        float x, float y, float z) {}
-    virtual void OnRotationRateChanged(float alpha, float beta, float gamma) {}
+    virtual void OnRotationRateChanged(int64 timestamp_us,
+                                       float alpha, float beta, float gamma) {}
+  };
+
+  // What an observer needs from the sensors. Derived data costs extra calls
+  // to the sensor framework, it is only read when some observer asks for
+  // it, and the samples come at the shortest interval asked for.
+  struct Request {
+    Request();
+
+    bool linear_acceleration;
+    bool orientation;
+    // 0 leaves the rate of the platform.
+    int interval_ms;
   };
 
+  // Observers are added with an empty request.
   virtual void AddObserver(Observer* observer);
   virtual void RemoveObserver(Observer* observer);
+  // Replaces the request of |observer|, which must have been added.
+  void SetRequest(Observer* observer, const Request& request);
 
   virtual blink::WebScreenOrientationType GetScreenOrientation() const {
     return last_orientation_;
@@ -50,14 +72,25 @@ class SensorProvider {
       blink::WebScreenOrientationType orientation);
 
   virtual void OnOrientationChanged(float alpha, float beta, float gamma);
-  virtual void OnAccelerationChanged(float raw_x, float raw_y, float raw_z,
+  virtual void OnAccelerationChanged(int64 timestamp_us,
+                                     float raw_x, float raw_y, float raw_z,
                                      float x, float y, float z);
-  virtual void OnRotationRateChanged(float alpha, float beta, float gamma);
+  virtual void OnRotationRateChanged(int64 timestamp_us,
+                                     float alpha, float beta, float gamma);
 
-  std::set<Observer*> observers_;
+  // The requests of all the observers combined.
+  const Request& request() const { return request_; }
+  virtual void OnRequestChanged() {}
+
+  typedef std::map<Observer*, Request> ObserverMap;
+  ObserverMap observers_;
   blink::WebScreenOrientationType last_orientation_;
 
  private:
+  void UpdateRequest();
+
+  Request request_;
+
   static scoped_ptr<SensorProvider> instance_;
 
   DISALLOW_COPY_AND_ASSIGN(SensorProvider);
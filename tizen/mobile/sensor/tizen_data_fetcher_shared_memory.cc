@@ -2,15 +2,18 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include <math.h>
-
 #include "xwalk/tizen/mobile/sensor/tizen_data_fetcher_shared_memory.h"
 
+#include <cmath>
+
+#include "content/browser/device_sensors/inertial_sensor_consts.h"
+
 namespace xwalk {
 
 TizenDataFetcherSharedMemory::TizenDataFetcherSharedMemory()
     : motion_buffer_(NULL),
-      orientation_buffer_(NULL) {
+      orientation_buffer_(NULL),
+      last_acceleration_timestamp_us_(0) {
 }
 
 TizenDataFetcherSharedMemory::~TizenDataFetcherSharedMemory() {
@@ -19,27 +22,34 @@ TizenDataFetcherSharedMemory::~TizenDataFetcherSharedMemory() {
 }
 
 void TizenDataFetcherSharedMemory::OnAccelerationChanged(
+    int64 timestamp_us,
     float raw_x, float raw_y, float raw_z,
     float x, float y, float z) {
   if (!motion_buffer_)
     return;
 
   motion_buffer_->seqlock.WriteBegin();
+  if (last_acceleration_timestamp_us_ &&
+      timestamp_us > last_acceleration_timestamp_us_) {
+    motion_buffer_->data.interval =
+        (timestamp_us - last_acceleration_timestamp_us_) / 1000.0;
+  }
+  last_acceleration_timestamp_us_ = timestamp_us;
   motion_buffer_->data.accelerationIncludingGravityX = raw_x;
   motion_buffer_->data.hasAccelerationIncludingGravityX = true;
   motion_buffer_->data.accelerationIncludingGravityY = raw_y;
   motion_buffer_->data.hasAccelerationIncludingGravityY = true;
   motion_buffer_->data.accelerationIncludingGravityZ = raw_z;
   motion_buffer_->data.hasAccelerationIncludingGravityZ = true;
-  if (x != FP_NAN) {
+  if (!std::isnan(x)) {
     motion_buffer_->data.accelerationX = x;
     motion_buffer_->data.hasAccelerationX = true;
   }
-  if (y != FP_NAN) {
+  if (!std::isnan(y)) {
     motion_buffer_->data.accelerationY = y;
     motion_buffer_->data.hasAccelerationY = true;
   }
-  if (z != FP_NAN) {
+  if (!std::isnan(z)) {
     motion_buffer_->data.accelerationZ = z;
     motion_buffer_->data.hasAccelerationZ = true;
   }
@@ -64,7 +74,8 @@ void TizenDataFetcherSharedMemory::OnOrientationChanged(float alpha,
   orientation_buffer_->seqlock.WriteEnd();
 }
 
-void TizenDataFetcherSharedMemory::OnRotationRateChanged(float alpha,
+void TizenDataFetcherSharedMemory::OnRotationRateChanged(int64 timestamp_us,
+                                                         float alpha,
                                                          float beta,
                                                          float gamma) {
   if (!motion_buffer_)
@@ -102,6 +113,7 @@ bool TizenDataFetcherSharedMemory::Start(content::ConsumerType type,
 
   if (!started && SensorProvider::GetInstance())
     SensorProvider::GetInstance()->AddObserver(this);
+  UpdateSensorRequest();
 
   return true;
 }
@@ -114,6 +126,7 @@ bool TizenDataFetcherSharedMemory::Stop(content::ConsumerType type) {
         motion_buffer_->data.allAvailableSensorsAreActive = false;
         motion_buffer_->seqlock.WriteEnd();
         motion_buffer_ = NULL;
+        last_acceleration_timestamp_us_ = 0;
       }
       break;
     case content::CONSUMER_TYPE_ORIENTATION:
@@ -132,8 +145,22 @@ bool TizenDataFetcherSharedMemory::Stop(content::ConsumerType type) {
   if (!motion_buffer_ && !orientation_buffer_ &&
       SensorProvider::GetInstance())
     SensorProvider::GetInstance()->RemoveObserver(this);
+  else
+    UpdateSensorRequest();
 
   return true;
 }
 
+void TizenDataFetcherSharedMemory::UpdateSensorRequest() {
+  SensorProvider* sensor = SensorProvider::GetInstance();
+  if (!sensor)
+    return;
+
+  SensorProvider::Request request;
+  request.linear_acceleration = motion_buffer_ != NULL;
+  request.orientation = orientation_buffer_ != NULL;
+  request.interval_ms = content::kInertialSensorIntervalMillis;
+  sensor->SetRequest(this, request);
+}
+
 }  // namespace xwalk
@@ -12,6 +12,14 @@ namespace xwalk {
 
 // This class receives sensor data from SensorProvider, and put them into
 // a block of memory which is shared between xwalk and renderer processes.
+// The renderer polls the latest values, every sample is still written in
+// order so the interval between samples is the one of the platform.
+//
+// There is one buffer per consumer type, allocated by content and mapped
+// read-only by every renderer listening to it, so a sample costs a single
+// write whatever the number of listening applications. Its layout is fixed
+// by content and read by blink, which is why it holds the latest sample
+// rather than a ring of them.
 class TizenDataFetcherSharedMemory : public content::DataFetcherSharedMemory,
                                      public SensorProvider::Observer {
  public:
@@ -27,14 +35,20 @@ class TizenDataFetcherSharedMemory : public content::DataFetcherSharedMemory,
   virtual void OnOrientationChanged(float alpha,
                                     float beta,
                                     float roll) OVERRIDE;
-  virtual void OnAccelerationChanged(float raw_x, float raw_y, float raw_z,
+  virtual void OnAccelerationChanged(int64 timestamp_us,
+                                     float raw_x, float raw_y, float raw_z,
                                      float x, float y, float z) OVERRIDE;
-  virtual void OnRotationRateChanged(float alpha,
+  virtual void OnRotationRateChanged(int64 timestamp_us,
+                                     float alpha,
                                      float beta,
                                      float roll) OVERRIDE;
 
+  // Asks only for the derived data of the attached consumers.
+  void UpdateSensorRequest();
+
   content::DeviceMotionHardwareBuffer* motion_buffer_;
   content::DeviceOrientationHardwareBuffer* orientation_buffer_;
+  int64 last_acceleration_timestamp_us_;
 
   DISALLOW_COPY_AND_ASSIGN(TizenDataFetcherSharedMemory);
 };
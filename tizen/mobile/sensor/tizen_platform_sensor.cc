@@ -12,6 +12,9 @@
 
 namespace  {
 
+// How long a rotation check has to stand before the screen rotates.
+const int kRotationSettleTimeMs = 400;
+
 // Make the class depend on gfx::Display to avoid the hack below:
 
 #if defined(OS_TIZEN_MOBILE)
@@ -49,7 +52,9 @@ namespace xwalk {
 TizenPlatformSensor::TizenPlatformSensor()
     : auto_rotation_enabled_(true),
       accel_handle_(-1),
-      gyro_handle_(-1) {
+      gyro_handle_(-1),
+      interval_ms_(0),
+      pending_orientation_(blink::WebScreenOrientationUndefined) {
 }
 
 TizenPlatformSensor::~TizenPlatformSensor() {
@@ -113,6 +118,7 @@ bool TizenPlatformSensor::Initialize() {
 }
 
 void TizenPlatformSensor::Finish() {
+  rotation_timer_.Stop();
   if (accel_handle_ >= 0) {
     sf_stop(accel_handle_);
     sf_unregister_event(accel_handle_, ACCELEROMETER_EVENT_ROTATION_CHECK);
@@ -133,34 +139,73 @@ void TizenPlatformSensor::Finish() {
       OnAutoRotationEnabledChanged);
 }
 
+void TizenPlatformSensor::OnRequestChanged() {
+  if (request().interval_ms == interval_ms_)
+    return;
+  interval_ms_ = request().interval_ms;
+
+  // Without a condition the events come at the default rate of the
+  // platform.
+  event_condition_t condition;
+  condition.cond_op = CONDITION_EQUAL;
+  condition.cond_value1 = interval_ms_;
+  event_condition_t* event_condition = interval_ms_ ? &condition : NULL;
+
+  if (accel_handle_ >= 0 &&
+      sf_change_event_condition(accel_handle_,
+          ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME, event_condition) < 0)
+    LOG(WARNING) << "Can't change the interval of the accelerometer events";
+  if (gyro_handle_ >= 0 &&
+      sf_change_event_condition(gyro_handle_,
+          GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME, event_condition) < 0)
+    LOG(WARNING) << "Can't change the interval of the gyroscope events";
+}
+
 void TizenPlatformSensor::OnEventReceived(unsigned int event_type,
                                           sensor_event_data_t* event_data,
                                           void* udata) {
   TizenPlatformSensor* self = reinterpret_cast<TizenPlatformSensor*>(udata);
 
-  sensor_data_t* data =
+  // The data events carry every sample taken since the previous event.
+  const sensor_data_t* samples =
       reinterpret_cast<sensor_data_t*>(event_data->event_data);
-  size_t last = event_data->event_data_size / sizeof(sensor_data_t) - 1;
+  size_t count = event_data->event_data_size / sizeof(sensor_data_t);
 
   switch (event_type) {
     case ACCELEROMETER_EVENT_ROTATION_CHECK: {
       if (!self->auto_rotation_enabled_)
         return;
       int value = *reinterpret_cast<int*>(event_data->event_data);
-      self->OnScreenOrientationChanged(ToScreenOrientation(value));
+      self->ScheduleScreenOrientationChange(ToScreenOrientation(value));
       break;
     }
     case ACCELEROMETER_EVENT_RAW_DATA_REPORT_ON_TIME: {
+      if (!count)
+        return;
+
+      // The derived data sets are only computed on request, and only match
+      // the last sample.
       sensor_data_t linear;
-      linear.values[0] = linear.values[1] = linear.values[2] = FP_NAN;
-      sf_get_data(self->accel_handle_,
-          ACCELEROMETER_LINEAR_ACCELERATION_DATA_SET, &linear);
-      self->OnAccelerationChanged(
-          data[last].values[0], data[last].values[1], data[last].values[2],
-          linear.values[0], linear.values[1], linear.values[2]);
+      linear.values[0] = linear.values[1] = linear.values[2] = NAN;
+      if (self->request().linear_acceleration) {
+        sf_get_data(self->accel_handle_,
+            ACCELEROMETER_LINEAR_ACCELERATION_DATA_SET, &linear);
+      }
+
+      for (size_t i = 0; i < count; ++i) {
+        const sensor_data_t& sample = samples[i];
+        bool last = i == count - 1;
+        self->OnAccelerationChanged(
+            sample.time_stamp,
+            sample.values[0], sample.values[1], sample.values[2],
+            last ? linear.values[0] : NAN,
+            last ? linear.values[1] : NAN,
+            last ? linear.values[2] : NAN);
+      }
 
       sensor_data_t orient;
-      if (sf_get_data(self->accel_handle_,
+      if (self->request().orientation &&
+          sf_get_data(self->accel_handle_,
               ACCELEROMETER_ORIENTATION_DATA_SET, &orient) >= 0) {
         self->OnOrientationChanged(
             orient.values[0], orient.values[1], orient.values[2]);
@@ -168,17 +213,43 @@ void TizenPlatformSensor::OnEventReceived(unsigned int event_type,
       break;
     }
     case GYROSCOPE_EVENT_RAW_DATA_REPORT_ON_TIME: {
-      self->OnRotationRateChanged(
-          data[last].values[0], data[last].values[1], data[last].values[2]);
+      for (size_t i = 0; i < count; ++i) {
+        self->OnRotationRateChanged(samples[i].time_stamp,
+            samples[i].values[0], samples[i].values[1], samples[i].values[2]);
+      }
+      break;
     }
   }
 }
 
+void TizenPlatformSensor::ScheduleScreenOrientationChange(
+    blink::WebScreenOrientationType orientation) {
+  if (orientation == GetScreenOrientation()) {
+    // Back to the current orientation before the change was applied.
+    rotation_timer_.Stop();
+    return;
+  }
+
+  if (rotation_timer_.IsRunning() && orientation == pending_orientation_)
+    return;
+
+  pending_orientation_ = orientation;
+  rotation_timer_.Start(
+      FROM_HERE, base::TimeDelta::FromMilliseconds(kRotationSettleTimeMs),
+      this, &TizenPlatformSensor::ApplyPendingScreenOrientation);
+}
+
+void TizenPlatformSensor::ApplyPendingScreenOrientation() {
+  OnScreenOrientationChanged(pending_orientation_);
+}
+
 void TizenPlatformSensor::OnAutoRotationEnabledChanged(
     keynode_t* node, void* udata) {
   TizenPlatformSensor* self = reinterpret_cast<TizenPlatformSensor*>(udata);
 
   self->auto_rotation_enabled_ = (vconf_keynode_get_bool(node) != 0);
+  // The user asked for it, it is applied right away.
+  self->rotation_timer_.Stop();
 
   unsigned long value;  // NOLINT
   if (!self->auto_rotation_enabled_) {
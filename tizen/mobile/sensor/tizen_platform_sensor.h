@@ -20,6 +20,7 @@
 #include <vconf.h>
 
 #include "base/native_library.h"
+#include "base/timer/timer.h"
 #include "xwalk/tizen/mobile/sensor/sensor_provider.h"
 
 namespace xwalk {
@@ -33,9 +34,22 @@ class TizenPlatformSensor : public SensorProvider {
   virtual void Finish() OVERRIDE;
 
  private:
+  // SensorProvider implementation.
+  virtual void OnRequestChanged() OVERRIDE;
+
+  // The rotation checks of the accelerometer flip back and forth when the
+  // device is held near 45 degrees. A new orientation is only applied once
+  // it has been reported for a while without being contradicted.
+  void ScheduleScreenOrientationChange(
+      blink::WebScreenOrientationType orientation);
+  void ApplyPendingScreenOrientation();
+
   bool auto_rotation_enabled_;
   int accel_handle_;
   int gyro_handle_;
+  int interval_ms_;
+  blink::WebScreenOrientationType pending_orientation_;
+  base::OneShotTimer<TizenPlatformSensor> rotation_timer_;
 
   static void OnEventReceived(unsigned int event_type,
       sensor_event_data_t* event_data, void* udata);
@@ -83,6 +83,11 @@ struct IPCDataEvMouseMove {
     event_flags(EVAS_EVENT_FLAG_NONE) {}
 };
 
+// Damaged area of the shared memory, sent with OP_UPDATE.
+struct IPCDataUpdate {
+  int x, w, y, h;
+};
+
 enum Instruction {
   DLT_ZERO,
   DLT_ONE,
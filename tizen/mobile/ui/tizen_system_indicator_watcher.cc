@@ -9,6 +9,8 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+
 #include "base/file_util.h"
 #include "base/files/file_path.h"
 #include "base/message_loop/message_loop.h"
@@ -17,6 +19,7 @@
 #include "base/strings/string_tokenizer.h"
 #include "base/environment.h"
 #include "ui/gfx/image/image_skia.h"
+#include "ui/gfx/rect_conversions.h"
 #include "ui/gfx/screen.h"
 
 using content::BrowserThread;
@@ -27,6 +30,15 @@ const char kServicePortrait[] = "elm_indicator_portrait";
 const char kServiceLandscape[] = "elm_indicator_landscape";
 const char kServiceNumber[] = "0";
 
+// Large enough for most of the messages, grown when needed.
+const size_t kInitialPayloadSize = 1024;
+
+// Each of the 6 fields of a header takes at most 4 bytes.
+const size_t kMaxHeaderSize = 24;
+
+// The indicator is not repainted more often than the display refreshes.
+const int kMinRepaintIntervalMs = 16;
+
 // Environment variable format is x, y, width, height.
 const char kTizenSystemIndicatorGeometryVar[] = "ILLUME_IND";
 
@@ -73,6 +85,8 @@ TizenSystemIndicatorWatcher::TizenSystemIndicatorWatcher(
     height_(-1),
     alpha_(-1),
     updated_(false),
+    repaint_scheduled_(false),
+    payload_(kInitialPayloadSize),
     weak_ptr_factory_(this) {
   memset(&current_msg_header_, 0, sizeof(current_msg_header_));
   SetSizeFromEnvVar();
@@ -318,21 +332,16 @@ bool TizenSystemIndicatorWatcher::GetHeader() {
 
   if (header_size == 0)
     return true;
+  DCHECK_LE(header_size, kMaxHeaderSize);
 
-  scoped_ptr<unsigned char[]> header_payload(new unsigned char[header_size]);
-
-  if (!header_payload) {
-    PLOG(ERROR) << "Failed to allocate memory for header_payload";
-    return false;
-  }
-
-  if (!ReadSafe(fd_, header_payload.get(), header_size)) {
+  uint8_t header_payload[kMaxHeaderSize];
+  if (!ReadSafe(fd_, header_payload, header_size)) {
     PLOG(ERROR) << "Failed to read header_payload";
     return false;
   }
 
   struct EcoreIPCMsgHeader next_msg_header;
-  HeaderParser parser(header_instructions, header_payload.get(),
+  HeaderParser parser(header_instructions, header_payload,
                       &current_msg_header_, &next_msg_header);
   parser.Parse();
 
@@ -391,8 +400,19 @@ bool TizenSystemIndicatorWatcher::OnResize(const uint8_t* payload,
   return true;
 }
 
-bool TizenSystemIndicatorWatcher::OnUpdate() {
+bool TizenSystemIndicatorWatcher::OnUpdate(const uint8_t* payload,
+                                           size_t size) {
   updated_ = true;
+  gfx::Rect bounds(width_, height_);
+  if (size < sizeof(IPCDataUpdate)) {
+    damage_ = bounds;
+    return true;
+  }
+
+  IPCDataUpdate update;
+  memcpy(&update, payload, sizeof(update));
+  damage_.Union(gfx::Rect(update.x, update.y, update.w, update.h));
+  damage_.Intersect(bounds);
   return true;
 }
 
@@ -407,15 +427,33 @@ bool TizenSystemIndicatorWatcher::OnUpdateDone() {
     return false;
   }
 
-  BrowserThread::PostTask(
-      BrowserThread::UI, FROM_HERE,
-      base::Bind(&TizenSystemIndicatorWatcher::UpdateIndicatorImage,
-                 weak_ptr_factory_.GetWeakPtr()));
-
   updated_ = false;
+  if (damage_.IsEmpty() || repaint_scheduled_)
+    return true;
+
+  repaint_scheduled_ = true;
+  base::TimeDelta delay = std::max(
+      base::TimeDelta(),
+      last_repaint_ + base::TimeDelta::FromMilliseconds(kMinRepaintIntervalMs)
+          - base::TimeTicks::Now());
+  BrowserThread::PostDelayedTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&TizenSystemIndicatorWatcher::FlushDamage,
+                 weak_ptr_factory_.GetWeakPtr()),
+      delay);
   return true;
 }
 
+void TizenSystemIndicatorWatcher::FlushDamage() {
+  repaint_scheduled_ = false;
+  last_repaint_ = base::TimeTicks::Now();
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&TizenSystemIndicatorWatcher::RepaintIndicator,
+                 weak_ptr_factory_.GetWeakPtr(), damage_));
+  damage_ = gfx::Rect();
+}
+
 bool TizenSystemIndicatorWatcher::OnShmRef(const uint8_t* payload,
                                            size_t size) {
   if (size <= 1)
@@ -434,13 +472,11 @@ bool TizenSystemIndicatorWatcher::ProcessPayload() {
   PlugOperation op_code = PlugOperation(current_msg_header_.minor);
   size_t payload_size = current_msg_header_.size;
 
-  scoped_ptr<unsigned char[]> payload(new unsigned char[1024]);
-  if (!payload) {
-    PLOG(ERROR) << "Could not allocate memory to payload";
-    return false;
-  }
+  if (payload_.size() < payload_size)
+    payload_.resize(payload_size);
+  uint8_t* payload = &payload_[0];
 
-  if (!ReadSafe(fd_, payload.get(), payload_size)) {
+  if (!ReadSafe(fd_, payload, payload_size)) {
     PLOG(ERROR) << "Failed to read op payload";
     return false;
   }
@@ -448,13 +484,11 @@ bool TizenSystemIndicatorWatcher::ProcessPayload() {
   bool ok = false;
   switch (op_code) {
     case OP_RESIZE:
-      ok = OnResize(payload.get(), payload_size);
+      ok = OnResize(payload, payload_size);
       break;
 
     case OP_UPDATE:
-      // We are always updating the entire area, so we ignore the
-      // x, y, w, h passed on the payload.
-      ok = OnUpdate();
+      ok = OnUpdate(payload, payload_size);
       break;
 
     case OP_UPDATE_DONE:
@@ -462,7 +496,7 @@ bool TizenSystemIndicatorWatcher::ProcessPayload() {
       break;
 
     case OP_SHM_REF:
-      ok = OnShmRef(payload.get(), payload_size);
+      ok = OnShmRef(payload, payload_size);
       break;
 
     case OP_SHOW:
@@ -497,15 +531,25 @@ bool TizenSystemIndicatorWatcher::ProcessPayload() {
 }
 
 void TizenSystemIndicatorWatcher::UpdateIndicatorImage() {
-  SkBitmap bitmap;
-
-  bitmap.setConfig(SkBitmap::kARGB_8888_Config, width_, height_);
-  bitmap.setPixels(shared_memory_->memory());
+  bitmap_.setConfig(SkBitmap::kARGB_8888_Config, width_, height_);
+  bitmap_.setPixels(shared_memory_->memory());
 
-  gfx::ImageSkia img_skia;
-  img_skia.AddRepresentation(gfx::ImageSkiaRep(bitmap,
+  image_ = gfx::ImageSkia();
+  image_.AddRepresentation(gfx::ImageSkiaRep(bitmap_,
       display_.device_scale_factor()));
-  client_->OnImageUpdated(img_skia);
+  client_->OnImageUpdated(image_);
+}
+
+void TizenSystemIndicatorWatcher::RepaintIndicator(const gfx::Rect& damage) {
+  if (image_.isNull()) {
+    UpdateIndicatorImage();
+    return;
+  }
+
+  // The pixels were written in place, the image shares them.
+  bitmap_.notifyPixelsChanged();
+  client_->OnImageDamaged(gfx::ToEnclosingRect(
+      gfx::ScaleRect(damage, 1.0f / display_.device_scale_factor())));
 }
 
 void TizenSystemIndicatorWatcher::SetSizeFromEnvVar() {
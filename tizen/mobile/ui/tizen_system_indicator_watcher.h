@@ -11,9 +11,14 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/shared_memory.h"
 #include "base/memory/weak_ptr.h"
+#include <vector>
+
 #include "base/message_loop/message_pump_libevent.h"
+#include "base/time/time.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/gfx/display.h"
 #include "ui/gfx/image/image_skia.h"
+#include "ui/gfx/rect.h"
 #include "ui/gfx/size.h"
 #include "xwalk/tizen/mobile/ui/tizen_plug_message_writer.h"
 
@@ -22,11 +27,19 @@ namespace xwalk {
 // Implementation of the socket protocol for sharing memory used by Elementary
 // "Plugs" in EFL. This class implements the low level protocol and is used by
 // TizenSystemIndicator to update its image.
+//
+// The image wraps the shared memory without copying it. The areas damaged
+// by OP_UPDATE are accumulated and only them are repainted, at most once
+// per frame.
 class TizenSystemIndicatorWatcher : public base::MessagePumpLibevent::Watcher {
  public:
   class WatcherClient {
    public:
+    // Called when the indicator is resized, |img_skia| stays backed by the
+    // shared memory until the next call.
     virtual void OnImageUpdated(const gfx::ImageSkia& img_skia) = 0;
+    // Called when the area |damage| of the image, in DIPs, was updated.
+    virtual void OnImageDamaged(const gfx::Rect& damage) = 0;
 
    protected:
     virtual ~WatcherClient() {}
@@ -57,11 +70,13 @@ class TizenSystemIndicatorWatcher : public base::MessagePumpLibevent::Watcher {
   bool GetHeader();
   bool MapSharedMemory();
   bool OnResize(const uint8_t* payload, size_t size);
-  bool OnUpdate();
+  bool OnUpdate(const uint8_t* payload, size_t size);
   bool OnUpdateDone();
   bool OnShmRef(const uint8_t* payload, size_t size);
   bool ProcessPayload();
+  void FlushDamage();
   void UpdateIndicatorImage();
+  void RepaintIndicator(const gfx::Rect& damage);
   void SetSizeFromEnvVar();
   void ResizeIndicator();
 
@@ -80,6 +95,15 @@ class TizenSystemIndicatorWatcher : public base::MessagePumpLibevent::Watcher {
   int height_;
   int alpha_;
   bool updated_;
+  // Accessed on the IO thread, in pixels.
+  gfx::Rect damage_;
+  bool repaint_scheduled_;
+  base::TimeTicks last_repaint_;
+  // Reused for the payload of every message.
+  std::vector<uint8_t> payload_;
+  // Accessed on the UI thread, share the pixels of |shared_memory_|.
+  SkBitmap bitmap_;
+  gfx::ImageSkia image_;
   std::string shm_name_;
   std::string service_name_;
   struct EcoreIPCMsgHeader current_msg_header_;
@@ -43,6 +43,12 @@ void TizenSystemIndicatorWidget::OnImageUpdated(
   SetBounds(indicator_bounds);
 }
 
+void TizenSystemIndicatorWidget::OnImageDamaged(const gfx::Rect& damage) {
+  // The image is drawn at the origin of the view, so only the damaged area
+  // has to be rasterized again.
+  indicator_->SchedulePaintInRect(damage);
+}
+
 void TizenSystemIndicatorWidget::SetDisplay(const gfx::Display& display) {
   indicator_->SetImage(0);
 
@@ -25,6 +25,7 @@ class TizenSystemIndicatorWidget : public views::Widget,
 
   // TizenSystemIndicatorWatcher::WatcherClient implementation.
   virtual void OnImageUpdated(const gfx::ImageSkia& img_skia) OVERRIDE;
+  virtual void OnImageDamaged(const gfx::Rect& damage) OVERRIDE;
 
   // Apply new display configuration.
   void SetDisplay(const gfx::Display& display);
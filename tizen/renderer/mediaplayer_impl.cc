@@ -17,7 +17,9 @@ MediaPlayerImpl::MediaPlayerImpl(
     RendererMediaPlayerManager* manager,
     const content::WebMediaPlayerParams& params)
     : WebMediaPlayerImpl(frame, client, delegate, params),
-      manager_(manager) {
+      manager_(manager),
+      reported_decoded_frames_(0),
+      reported_dropped_frames_(0) {
   DCHECK(manager_);
 
   player_id_ = manager_->RegisterMediaPlayer(this);
@@ -25,6 +27,7 @@ MediaPlayerImpl::MediaPlayerImpl(
 
 MediaPlayerImpl::~MediaPlayerImpl() {
   if (manager_) {
+    ReportStatistics();
     manager_->DestroyPlayer(player_id_);
     manager_->UnregisterMediaPlayer(player_id_);
   }
@@ -61,6 +64,29 @@ void MediaPlayerImpl::pause() {
   if (manager_)
     manager_->Pause(player_id_);
   WebMediaPlayerImpl::pause();
+  ReportStatistics();
+}
+
+void MediaPlayerImpl::ReportStatistics() {
+  if (!manager_)
+    return;
+
+  unsigned decoded_frames = decodedFrameCount();
+  unsigned dropped_frames = droppedFrameCount();
+  // The counters restart with a new load.
+  if (decoded_frames < reported_decoded_frames_ ||
+      dropped_frames < reported_dropped_frames_) {
+    reported_decoded_frames_ = 0;
+    reported_dropped_frames_ = 0;
+  }
+  if (decoded_frames == reported_decoded_frames_)
+    return;
+
+  manager_->ReportStatistics(player_id_,
+                             decoded_frames - reported_decoded_frames_,
+                             dropped_frames - reported_dropped_frames_);
+  reported_decoded_frames_ = decoded_frames;
+  reported_dropped_frames_ = dropped_frames;
 }
 
 }  // namespace tizen
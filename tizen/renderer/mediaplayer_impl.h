@@ -45,6 +45,10 @@ class MediaPlayerImpl : public content::WebMediaPlayerImpl {
  private:
   void InitializeMediaPlayer(const blink::WebURL& url);
 
+  // Sends the frames decoded and dropped since the last report, when the
+  // playback is paused or the player goes away.
+  void ReportStatistics();
+
   // Manager for managing this object and for delegating method calls on
   // Render Thread.
   RendererMediaPlayerManager* manager_;
@@ -52,6 +56,9 @@ class MediaPlayerImpl : public content::WebMediaPlayerImpl {
   // Player ID assigned by the |manager_|.
   MediaPlayerID player_id_;
 
+  unsigned reported_decoded_frames_;
+  unsigned reported_dropped_frames_;
+
   DISALLOW_COPY_AND_ASSIGN(MediaPlayerImpl);
 };
 
@@ -53,6 +53,13 @@ void RendererMediaPlayerManager::Pause(MediaPlayerID player_id) {
   Send(new MediaPlayerHostMsg_MediaPlayerPaused(routing_id(), player_id));
 }
 
+void RendererMediaPlayerManager::ReportStatistics(MediaPlayerID player_id,
+                                                  unsigned decoded_frames,
+                                                  unsigned dropped_frames) {
+  Send(new MediaPlayerHostMsg_MediaPlayerStatistics(
+      routing_id(), player_id, decoded_frames, dropped_frames));
+}
+
 void RendererMediaPlayerManager::DestroyPlayer(MediaPlayerID player_id) {
   Send(new MediaPlayerHostMsg_DestroyMediaPlayer(routing_id(), player_id));
 }
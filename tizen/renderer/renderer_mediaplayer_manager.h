@@ -39,6 +39,11 @@ class RendererMediaPlayerManager : public content::RenderViewObserver {
   // Pausees the player.
   void Pause(MediaPlayerID player_id);
 
+  // Reports the playback statistics of the player since the last report.
+  void ReportStatistics(MediaPlayerID player_id,
+                        unsigned decoded_frames,
+                        unsigned dropped_frames);
+
   // Destroy the player in the browser process
   void DestroyPlayer(MediaPlayerID player_id);
 
@@ -44,12 +44,14 @@
         '../content/content.gyp:content_renderer',
         '../content/content.gyp:content_utility',
         '../content/content.gyp:content_worker',
+        '../crypto/crypto.gyp:crypto',
         '../ipc/ipc.gyp:ipc',
         '../media/media.gyp:media',
         '../net/net.gyp:net',
         '../net/net.gyp:net_resources',
         '../skia/skia.gyp:skia',
         '../third_party/WebKit/public/blink.gyp:blink',
+        '../third_party/zlib/zlib.gyp:zlib',
         '../ui/base/ui_base.gyp:ui_base',
         '../ui/gl/gl.gyp:gl',
         '../ui/shell_dialogs/shell_dialogs.gyp:shell_dialogs',
@@ -85,18 +87,32 @@
         'runtime/app/xwalk_main_delegate.h',
         'runtime/browser/android/cookie_manager.cc',
         'runtime/browser/android/cookie_manager.h',
+        'runtime/browser/android/intercept_patterns.cc',
+        'runtime/browser/android/intercept_patterns.h',
         'runtime/browser/android/intercepted_request_data.h',
         'runtime/browser/android/intercepted_request_data_impl.cc',
         'runtime/browser/android/intercepted_request_data_impl.h',
+        'runtime/browser/android/intercepted_response_cache.cc',
+        'runtime/browser/android/intercepted_response_cache.h',
+        'runtime/browser/android/net/android_mime_types.cc',
+        'runtime/browser/android/net/android_mime_types.h',
         'runtime/browser/android/net/android_protocol_handler.cc',
         'runtime/browser/android/net/android_protocol_handler.h',
         'runtime/browser/android/net/android_stream_reader_url_request_job.cc',
         'runtime/browser/android/net/android_stream_reader_url_request_job.h',
+        'runtime/browser/android/net/apk_asset_index.cc',
+        'runtime/browser/android/net/apk_asset_index.h',
+        'runtime/browser/android/net/file_descriptor_input_stream.cc',
+        'runtime/browser/android/net/file_descriptor_input_stream.h',
         'runtime/browser/android/net/input_stream.h',
         'runtime/browser/android/net/input_stream_impl.cc',
         'runtime/browser/android/net/input_stream_impl.h',
         'runtime/browser/android/net/input_stream_reader.cc',
         'runtime/browser/android/net/input_stream_reader.h',
+        'runtime/browser/android/net/memory_input_stream.cc',
+        'runtime/browser/android/net/memory_input_stream.h',
+        'runtime/browser/android/net/stream_reader_thread_pool.cc',
+        'runtime/browser/android/net/stream_reader_thread_pool.h',
         'runtime/browser/android/net/url_constants.cc',
         'runtime/browser/android/net/url_constants.h',
         'runtime/browser/android/net/xwalk_url_request_job_factory.cc',
@@ -126,6 +142,8 @@
         'runtime/browser/android/xwalk_http_auth_handler.h',
         'runtime/browser/android/xwalk_http_auth_handler_base.cc',
         'runtime/browser/android/xwalk_http_auth_handler_base.h',
+        'runtime/browser/android/xwalk_http_auth_realm_cache.cc',
+        'runtime/browser/android/xwalk_http_auth_realm_cache.h',
         'runtime/browser/android/xwalk_login_delegate.cc',
         'runtime/browser/android/xwalk_login_delegate.h',
         'runtime/browser/android/xwalk_path_helper.cc',
@@ -149,6 +167,8 @@
         'runtime/browser/geolocation/tizen/location_provider_tizen.h',
         'runtime/browser/geolocation/xwalk_access_token_store.cc',
         'runtime/browser/geolocation/xwalk_access_token_store.h',
+        'runtime/browser/image_loader.cc',
+        'runtime/browser/image_loader.h',
         'runtime/browser/image_util.cc',
         'runtime/browser/image_util.h',
         'runtime/browser/media/media_capture_devices_dispatcher.cc',
@@ -157,18 +177,34 @@
         'runtime/browser/renderer_host/pepper/xwalk_browser_pepper_host_factory.h',
         'runtime/browser/runtime.cc',
         'runtime/browser/runtime.h',
+        'runtime/browser/runtime_cache_warmer.cc',
+        'runtime/browser/runtime_cache_warmer.h',
         'runtime/browser/runtime_context.cc',
         'runtime/browser/runtime_context.h',
+        'runtime/browser/runtime_download_digests.cc',
+        'runtime/browser/runtime_download_digests.h',
         'runtime/browser/runtime_download_manager_delegate.cc',
         'runtime/browser/runtime_download_manager_delegate.h',
         'runtime/browser/runtime_file_select_helper.cc',
         'runtime/browser/runtime_file_select_helper.h',
         'runtime/browser/runtime_geolocation_permission_context.cc',
         'runtime/browser/runtime_geolocation_permission_context.h',
+        'runtime/browser/runtime_http_server_properties_store.cc',
+        'runtime/browser/runtime_http_server_properties_store.h',
         'runtime/browser/runtime_javascript_dialog_manager.cc',
         'runtime/browser/runtime_javascript_dialog_manager.h',
+        'runtime/browser/runtime_metrics.cc',
+        'runtime/browser/runtime_metrics.h',
         'runtime/browser/runtime_network_delegate.cc',
         'runtime/browser/runtime_network_delegate.h',
+        'runtime/browser/runtime_network_predictor.cc',
+        'runtime/browser/runtime_network_predictor.h',
+        'runtime/browser/runtime_network_stats.cc',
+        'runtime/browser/runtime_network_stats.h',
+        'runtime/browser/runtime_performance_profiles.cc',
+        'runtime/browser/runtime_performance_profiles.h',
+        'runtime/browser/runtime_persistent_cookie_store.cc',
+        'runtime/browser/runtime_persistent_cookie_store.h',
         'runtime/browser/runtime_platform_util.h',
         'runtime/browser/runtime_platform_util_android.cc',
         'runtime/browser/runtime_platform_util_aura.cc',
@@ -182,8 +218,14 @@
         'runtime/browser/runtime_resource_dispatcher_host_delegate.h',
         'runtime/browser/runtime_resource_dispatcher_host_delegate_android.cc',
         'runtime/browser/runtime_resource_dispatcher_host_delegate_android.h',
+        'runtime/browser/runtime_resource_scheduler.cc',
+        'runtime/browser/runtime_resource_scheduler.h',
         'runtime/browser/runtime_select_file_policy.cc',
         'runtime/browser/runtime_select_file_policy.h',
+        'runtime/browser/runtime_startup_timeline.cc',
+        'runtime/browser/runtime_startup_timeline.h',
+        'runtime/browser/runtime_trace_recorder.cc',
+        'runtime/browser/runtime_trace_recorder.h',
         'runtime/browser/runtime_url_request_context_getter.cc',
         'runtime/browser/runtime_url_request_context_getter.h',
         'runtime/browser/speech/speech_recognition_manager_delegate.cc',
@@ -247,6 +289,8 @@
         'runtime/common/android/xwalk_render_view_messages.h',
         'runtime/common/paths_mac.h',
         'runtime/common/paths_mac.mm',
+        'runtime/common/pnacl_translation_cache.cc',
+        'runtime/common/pnacl_translation_cache.h',
         'runtime/common/xwalk_common_messages.cc',
         'runtime/common/xwalk_common_messages.h',
         'runtime/common/xwalk_common_message_generator.cc',
@@ -398,6 +442,8 @@
                   'sources': [
                     'runtime/browser/nacl_host/nacl_browser_delegate_impl.cc',
                     'runtime/browser/nacl_host/nacl_browser_delegate_impl.h',
+                    'runtime/browser/nacl_host/nacl_warmup.cc',
+                    'runtime/browser/nacl_host/nacl_warmup.h',
                   ],
                   'dependencies': [
                     '../components/nacl.gyp:nacl',